@@ -42,6 +42,38 @@ if (ZOM_DISABLE_GLOB_CTOR)
   endif ()
 endif ()
 
+if (ZOM_ENABLE_FAST_STRING_HASH)
+  message(STATUS "Enable fast string hash")
+  add_compile_definitions(ZC_FAST_STRING_HASH=1)
+endif ()
+
+if (ZOM_ENABLE_HEAP_ALLOCATOR)
+  message(STATUS "Enable pluggable heap allocator")
+  add_compile_definitions(ZC_HEAP_ALLOCATOR=1)
+endif ()
+
+if (ZOM_ENABLE_FRAME_POINTERS)
+  message(STATUS "Enable frame pointers")
+  if (NOT MSVC)
+    add_compile_options(-fno-omit-frame-pointer)
+    add_compile_definitions(ZC_USE_FRAME_POINTERS=1)
+  endif ()
+endif ()
+
+if (ZOM_WITH_JEMALLOC)
+  find_library(ZOM_JEMALLOC_LIBRARY jemalloc REQUIRED)
+  message(STATUS "Offer jemalloc heap allocator: ${ZOM_JEMALLOC_LIBRARY}")
+  add_compile_definitions(ZC_HAS_JEMALLOC=1)
+  link_libraries(${ZOM_JEMALLOC_LIBRARY})
+endif ()
+
+if (ZOM_WITH_MIMALLOC)
+  find_library(ZOM_MIMALLOC_LIBRARY mimalloc REQUIRED)
+  message(STATUS "Offer mimalloc heap allocator: ${ZOM_MIMALLOC_LIBRARY}")
+  add_compile_definitions(ZC_HAS_MIMALLOC=1)
+  link_libraries(${ZOM_MIMALLOC_LIBRARY})
+endif ()
+
 if (ZOM_ENABLE_UNITTESTS)
   message(STATUS "Enable Unitttests")
   enable_testing()
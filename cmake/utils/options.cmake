@@ -12,4 +12,16 @@ option(ZOM_DISABLE_GLOB_CTOR
 option(BUILD_STATIC_LIB "Build ZOM as a static library" ON)
 option(BUILD_CLI "Build ZOM CLI" ON)
 option(ZOM_ENABLE_UNITTESTS "Enable ZOM unittests" ON)
-option(ZOM_ENABLE_COVERAGE "Enable coverage reporting" OFF)
\ No newline at end of file
+option(ZOM_ENABLE_COVERAGE "Enable coverage reporting" OFF)
+option(ZOM_ENABLE_PERFORMANCE_TESTS "Enable ZOM performance benchmarks" OFF)
+option(ZOM_ENABLE_FAST_STRING_HASH
+       "Hash strings in zc::hashCode() with zc::fastHash64() instead of murmur2"
+       OFF)
+option(ZOM_ENABLE_HEAP_ALLOCATOR
+       "Route zc::heap() and heap arrays through the zc::HeapAllocator chosen at startup"
+       OFF)
+option(ZOM_ENABLE_FRAME_POINTERS
+       "Build with frame pointers and take exception stack traces by walking them"
+       OFF)
+option(ZOM_WITH_JEMALLOC "Offer jemalloc as a zc::HeapAllocator" OFF)
+option(ZOM_WITH_MIMALLOC "Offer mimalloc as a zc::HeapAllocator" OFF)
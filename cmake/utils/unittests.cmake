@@ -170,13 +170,14 @@ function(add_regression_test TEST_NAME SOURCE_FILE ISSUE_NUMBER)
 endfunction()
 
 # Function to add a performance test
-# Usage: add_performance_test(test_name executable_target)
+# Usage: add_performance_test(test_name executable_target [ARGS ...])
 function(add_performance_test TEST_NAME EXECUTABLE_TARGET)
+  cmake_parse_arguments(PERFORMANCE "" "" "ARGS" ${ARGN})
   set(TEST_FULL_NAME "performance-${TEST_NAME}")
 
   add_test(
     NAME ${TEST_FULL_NAME}
-    COMMAND ${EXECUTABLE_TARGET}
+    COMMAND ${EXECUTABLE_TARGET} ${PERFORMANCE_ARGS}
   )
 
   set_tests_properties(${TEST_FULL_NAME} PROPERTIES
@@ -208,6 +209,33 @@ function(add_lit_ast_tests_from_directory DIRECTORY_PATH)
   endforeach()
 endfunction()
 
+# Function to run all .zom files in a directory as one test, in a single zomc process
+# Usage: add_batch_language_test(test_name directory_path)
+function(add_batch_language_test TEST_NAME DIRECTORY_PATH)
+  file(GLOB_RECURSE ZOM_FILES "${DIRECTORY_PATH}/*.zom")
+  set(TEST_FULL_NAME "batch-${TEST_NAME}")
+
+  add_test(
+    NAME ${TEST_FULL_NAME}
+    COMMAND ${CMAKE_BINARY_DIR}/products/zomlang/utils/zomc/zomc test ${ZOM_FILES}
+    WORKING_DIRECTORY ${CMAKE_SOURCE_DIR}
+  )
+
+  set(TEST_ENV "")
+  if(ZOM_ENABLE_COVERAGE)
+    set(TEST_ENV
+      "LLVM_PROFILE_FILE=${CMAKE_BINARY_DIR}/coverage/${TEST_FULL_NAME}.profraw"
+      "ZC_CLEAN_SHUTDOWN=1"
+    )
+  endif()
+
+  set_tests_properties(${TEST_FULL_NAME} PROPERTIES
+    LABELS "ast;filecheck;specification"
+    TIMEOUT 60
+    ENVIRONMENT "${TEST_ENV}"
+  )
+endfunction()
+
 # Function to discover and add all *-test.cc files in a directory as ztest unit tests
 # Usage: add_ztest_unit_tests_from_directory(directory_path [LIBRARIES ...])
 function(add_ztest_unit_tests_from_directory DIRECTORY_PATH)
@@ -135,6 +135,12 @@ private:
 struct alignas(void*) PromiseArena {
   // Space in which a chain of promises may be allocated. See PromiseDisposer.
   byte bytes[1024];
+
+  static PromiseArena* allocate();
+  static void free(PromiseArena* arena) noexcept;
+  // Each thread keeps a bounded free list of arenas (unless ZC_PROMISE_ARENA_POOL is 0), so that
+  // starting a promise chain usually doesn't call into the heap. An arena may be freed by a
+  // different thread than allocated it; it then goes on that thread's list. free() ignores null.
 };
 
 class Event : private AsyncObject {
@@ -348,9 +354,8 @@ public:
 
   static void dispose(PromiseArenaMember* node) {
     PromiseArena* arena = node->arena;
-    // Defer the `delete` to protect against exception in `destroy()`.
-    // Reminder: `delete` automatically ignores null pointers
-    ZC_DEFER(delete arena);
+    // Defer freeing the arena to protect against exception in `destroy()`.
+    ZC_DEFER(PromiseArena::free(arena));
     node->destroy();
   }
 
@@ -367,7 +372,7 @@ public:
       // NOTE: As in appendPromise() (below), we don't implement exception-safety because it causes
       //   code bloat and these constructors probably don't throw. Instead this function is
       //   noexcept, so if a constructor does throw, it'll crash rather than leak memory.
-      auto* arena = new PromiseArena;
+      auto* arena = PromiseArena::allocate();
       ptr = reinterpret_cast<T*>(arena + 1) - 1;
       ctor(*ptr, zc::fwd<Params>(params)...);
       ptr->arena = arena;
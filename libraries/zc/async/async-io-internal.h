@@ -56,8 +56,8 @@ public:
   bool shouldAllowParse(const struct sockaddr* addr, uint addrlen);
 
 private:
-  Vector<CidrRange> allowCidrs;
-  Vector<CidrRange> denyCidrs;
+  CidrSet allowCidrs;
+  CidrSet denyCidrs;
   bool allowUnix;
   bool allowAbstractUnix;
   bool allowPublic = false;
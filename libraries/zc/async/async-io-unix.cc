@@ -54,11 +54,14 @@
 #include "zc/async/async-io-internal.h"
 #include "zc/async/async-io.h"
 #include "zc/async/async-unix.h"
+#include "zc/async/worker-pool.h"
 #include "zc/core/debug.h"
 #include "zc/core/filesystem.h"
 #include "zc/core/io.h"
+#include "zc/core/map.h"
 #include "zc/core/miniposix.h"
 #include "zc/core/thread.h"
+#include "zc/core/vector.h"
 
 #if __linux__
 #include <sys/sendfile.h>
@@ -144,15 +147,311 @@ private:
 
 // =======================================================================================
 
+#if ZC_USE_EPOLL
+
+Maybe<UnixEventPort::IoUring&> ringFor(UnixEventPort& eventPort, int fd) {
+  // Returns the event port's io_uring if `fd` is to do its I/O through it, which TCP sockets do
+  // once UnixEventPort::enableIoUring() has been called.
+
+  ZC_IF_SOME(ring, eventPort.getIoUring()) {
+    int domain = 0;
+    socklen_t length = sizeof(domain);
+    if (::getsockopt(fd, SOL_SOCKET, SO_DOMAIN, &domain, &length) == 0 &&
+        (domain == AF_INET || domain == AF_INET6)) {
+      return ring;
+    }
+  }
+  return zc::none;
+}
+
+class RingReader final : public UnixEventPort::IoUring::Operation {
+  // Reads a socket through the io_uring. A recv is only started when a read finds nothing left
+  // over from the last one, and what it receives waits here until read. So a read can be
+  // cancelled at any point without losing data: the next one picks up where it left off.
+
+public:
+  RingReader(UnixEventPort::IoUring& ring, int fd) : ring(ring), fd(fd) {}
+  ~RingReader() noexcept(false) {
+    ring.cancel(*this);
+    ZC_IF_SOME(c, chunk) { ring.releaseBuffer(c.buffer); }
+  }
+
+  Promise<size_t> read(byte* buffer, size_t minBytes, size_t maxBytes, size_t alreadyRead) {
+    for (;;) {
+      ZC_IF_SOME(c, chunk) {
+        size_t n = zc::min(maxBytes, c.remaining.size());
+        memcpy(buffer, c.remaining.begin(), n);
+        c.remaining = c.remaining.slice(n);
+        if (c.remaining.size() == 0) {
+          ring.releaseBuffer(c.buffer);
+          chunk = zc::none;
+        }
+        buffer += n;
+        maxBytes -= n;
+        minBytes -= zc::min(minBytes, n);
+        alreadyRead += n;
+      }
+
+      if (maxBytes == 0 || (minBytes == 0 && alreadyRead > 0) || atEnd) return alreadyRead;
+      if (chunk != zc::none) continue;
+
+      ZC_IF_SOME(e, error) {
+        int copy = e;
+        error = zc::none;
+        ZC_FAIL_SYSCALL("recv()", copy) { break; }
+        return alreadyRead;
+      }
+
+      if (starved) {
+        // Every ring buffer was taken when we last tried. Read straight into the caller's buffer
+        // instead, and only wait for the socket to become readable if that comes up empty.
+        ssize_t n;
+        ZC_NONBLOCKING_SYSCALL(n = ::read(fd, buffer, maxBytes)) {
+          // Error, with exceptions disabled. Treat it as EOF.
+          n = 0;
+          break;
+        }
+        if (n == 0) {
+          atEnd = true;
+          continue;
+        } else if (n > 0) {
+          starved = false;
+          buffer += n;
+          maxBytes -= n;
+          minBytes -= zc::min(minBytes, size_t(n));
+          alreadyRead += n;
+          continue;
+        }
+        if (!isInFlight()) {
+          polling = true;
+          ring.pollIn(fd, *this);
+        }
+      } else if (!isInFlight()) {
+        ring.recv(fd, *this);
+      }
+
+      auto paf = newPromiseAndFulfiller<void>();
+      waiter = zc::mv(paf.fulfiller);
+      return paf.promise.then([this, buffer, minBytes, maxBytes, alreadyRead]() {
+        return read(buffer, minBytes, maxBytes, alreadyRead);
+      });
+    }
+  }
+
+  void complete(int result, uint flags) override {
+    if (polling) {
+      // Readable (or broken); the next read() finds out which.
+      polling = false;
+    } else if (result > 0) {
+      auto buffer = ring.takeBuffer(flags, result);
+      chunk = Chunk{buffer, buffer};
+    } else if (result == 0) {
+      atEnd = true;
+    } else if (result == -ENOBUFS) {
+      starved = true;
+    } else if (result != -EINTR && result != -EAGAIN) {
+      error = -result;
+    }
+
+    ZC_IF_SOME(w, waiter) {
+      w->fulfill();
+      waiter = zc::none;
+    }
+  }
+
+private:
+  UnixEventPort::IoUring& ring;
+  int fd;
+
+  struct Chunk {
+    ArrayPtr<byte> buffer;
+    ArrayPtr<byte> remaining;
+  };
+  Maybe<Chunk> chunk;
+  // What the last recv brought in, and hasn't been read yet.
+
+  bool atEnd = false;
+  bool starved = false;
+  bool polling = false;
+  Maybe<int> error;
+
+  Maybe<Own<PromiseFulfiller<void>>> waiter;
+};
+
+class RingWrite final : public UnixEventPort::IoUring::Operation {
+  // Adapter for a write through the io_uring: a sendmsg() of all the pieces, followed by more for
+  // whatever the kernel didn't take.
+
+public:
+  RingWrite(PromiseFulfiller<void>& fulfiller, UnixEventPort::IoUring& ring, int fd,
+            ArrayPtr<const byte> firstPiece, ArrayPtr<const ArrayPtr<const byte>> morePieces)
+      : fulfiller(fulfiller),
+        ring(ring),
+        fd(fd),
+        iov(heapArray<struct iovec>(1 + morePieces.size())) {
+    // sendmsg() isn't const-correct.
+    iov[0].iov_base = const_cast<byte*>(firstPiece.begin());
+    iov[0].iov_len = firstPiece.size();
+    for (auto i : zc::indices(morePieces)) {
+      iov[i + 1].iov_base = const_cast<byte*>(morePieces[i].begin());
+      iov[i + 1].iov_len = morePieces[i].size();
+    }
+    send();
+  }
+
+  ~RingWrite() noexcept(false) {
+    // The kernel may still be reading the pieces, which belong to the caller.
+    ring.cancelAndWait(*this);
+  }
+
+  void complete(int result, uint flags) override {
+    if (result < 0) {
+      if (result == -EINTR || result == -EAGAIN) {
+        send();
+      } else {
+        fulfiller.rejectIfThrows([&]() { ZC_FAIL_SYSCALL("sendmsg()", -result); });
+      }
+      return;
+    }
+
+    size_t n = result;
+    while (next < iov.size() && n >= iov[next].iov_len) {
+      n -= iov[next].iov_len;
+      ++next;
+    }
+    if (next == iov.size()) {
+      fulfiller.fulfill();
+    } else {
+      iov[next].iov_base = reinterpret_cast<byte*>(iov[next].iov_base) + n;
+      iov[next].iov_len -= n;
+      send();
+    }
+  }
+
+private:
+  PromiseFulfiller<void>& fulfiller;
+  UnixEventPort::IoUring& ring;
+  int fd;
+  Array<struct iovec> iov;
+  size_t next = 0;
+  struct msghdr message;
+
+  void send() {
+    memset(&message, 0, sizeof(message));
+    message.msg_iov = iov.begin() + next;
+    message.msg_iovlen = zc::min(iov.size() - next, zc::miniposix::iovMax());
+    ring.sendmsg(fd, message, *this);
+  }
+};
+
+class RingAcceptor final : public UnixEventPort::IoUring::Operation {
+  // Accepts connections on a listen socket with a multishot accept through the io_uring. The
+  // accept keeps going between calls to accept(), so connections that arrive in the meantime wait
+  // here rather than in the kernel's backlog.
+
+public:
+  RingAcceptor(UnixEventPort::IoUring& ring, int fd) : ring(ring), fd(fd) {}
+  ~RingAcceptor() noexcept(false) { ring.cancel(*this); }
+
+  Promise<OwnFd> accept() {
+    if (first < accepted.size()) {
+      OwnFd result = zc::mv(accepted[first++]);
+      if (first == accepted.size()) {
+        accepted.clear();
+        first = 0;
+      }
+      return zc::mv(result);
+    }
+
+    ZC_IF_SOME(e, error) {
+      int copy = e;
+      error = zc::none;
+      ZC_FAIL_SYSCALL("accept", copy);
+    }
+
+    if (!isInFlight()) ring.acceptMultishot(fd, *this);
+
+    auto paf = newPromiseAndFulfiller<void>();
+    waiter = zc::mv(paf.fulfiller);
+    return paf.promise.then([this]() { return accept(); });
+  }
+
+  void complete(int result, uint flags) override {
+    if (result >= 0) {
+      accepted.add(result);
+    } else {
+      switch (-result) {
+        case EAGAIN:
+        case EINTR:
+        case ENETDOWN:
+        case EPROTO:
+        case EHOSTDOWN:
+        case EHOSTUNREACH:
+        case ENETUNREACH:
+        case ECONNABORTED:
+        case ETIMEDOUT:
+          // The connection broke before we got to it. See FdConnectionReceiver::acceptImpl().
+          // If this ended the multishot accept, the next accept() starts another.
+          break;
+        default:
+          error = -result;
+          break;
+      }
+    }
+
+    ZC_IF_SOME(w, waiter) {
+      w->fulfill();
+      waiter = zc::none;
+    }
+  }
+
+private:
+  UnixEventPort::IoUring& ring;
+  int fd;
+  Vector<OwnFd> accepted;
+  size_t first = 0;
+  Maybe<int> error;
+  Maybe<Own<PromiseFulfiller<void>>> waiter;
+};
+
+#endif  // ZC_USE_EPOLL
+
+// =======================================================================================
+
 class AsyncStreamFd : public OwnedFileDescriptor, public AsyncCapabilityStream {
 public:
   AsyncStreamFd(UnixEventPort& eventPort, int fd, uint flags, uint observerFlags)
       : OwnedFileDescriptor(fd, flags),
         eventPort(eventPort),
-        observer(eventPort, fd, observerFlags) {}
-  virtual ~AsyncStreamFd() noexcept(false) {}
+#if ZC_USE_EPOLL
+        ring(observerFlags == UnixEventPort::FdObserver::OBSERVE_READ_WRITE
+                 ? ringFor(eventPort, fd)
+                 : zc::none),
+        // Reads through the ring don't need readiness events, and would be woken by them for
+        // nothing.
+        observer(eventPort, fd,
+                 ring == zc::none ? observerFlags
+                                  : static_cast<uint>(UnixEventPort::FdObserver::OBSERVE_WRITE)) {
+    ZC_IF_SOME(r, ring) { reader = heap<RingReader>(r, fd); }
+    else { combineLimit = eventPort.getWriteCombiningLimit(); }
+  }
+#else
+        observer(eventPort, fd, observerFlags),
+        combineLimit(eventPort.getWriteCombiningLimit()) {
+  }
+#endif
+  virtual ~AsyncStreamFd() noexcept(false) {
+    if (flushQueued && flushesInFlight == 1 && combined.size() > 0) {
+      // The callers of these writes were told they were done, so make one attempt to get them
+      // out. Only if nothing written earlier is still going out, though, or they'd be out of order.
+      ssize_t n ZC_UNUSED = ::write(fd, combined.begin(), combined.size());
+    }
+  }
 
   Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+#if ZC_USE_EPOLL
+    ZC_IF_SOME(r, reader) { return r->read(reinterpret_cast<byte*>(buffer), minBytes, maxBytes, 0); }
+#endif
     return tryReadInternal(buffer, minBytes, maxBytes, nullptr, 0, {0, 0}).then([](ReadResult r) {
       return r.byteCount;
     });
@@ -183,6 +482,11 @@ public:
   }
 
   Promise<void> write(ArrayPtr<const byte> buffer) override {
+#if ZC_USE_EPOLL
+    ZC_IF_SOME(r, ring) { return writeThroughRing(r, buffer, nullptr); }
+#endif
+    if (combineLimit > 0) return writeCombined(buffer, nullptr);
+
     ssize_t n;
     ZC_NONBLOCKING_SYSCALL(n = ::write(fd, buffer.begin(), buffer.size())) {
       // Error.
@@ -217,6 +521,8 @@ public:
   Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override {
     if (pieces.size() == 0) {
       return writeInternal(nullptr, nullptr, nullptr);
+    } else if (combineLimit > 0) {
+      return writeCombined(pieces[0], pieces.slice(1, pieces.size()));
     } else {
       return writeInternal(pieces[0], pieces.slice(1, pieces.size()), nullptr);
     }
@@ -225,22 +531,26 @@ public:
   Promise<void> writeWithFds(ArrayPtr<const byte> data,
                              ArrayPtr<const ArrayPtr<const byte>> moreData,
                              ArrayPtr<const int> fds) override {
-    return writeInternal(data, moreData, fds);
+    return writeAfterCombined(data, moreData, fds);
   }
 
   Promise<void> writeWithStreams(ArrayPtr<const byte> data,
                                  ArrayPtr<const ArrayPtr<const byte>> moreData,
                                  Array<Own<AsyncCapabilityStream>> streams) override {
     auto fds = ZC_MAP(stream, streams) { return downcast<AsyncStreamFd>(*stream).fd; };
-    auto promise = writeInternal(data, moreData, fds);
+    auto promise = writeAfterCombined(data, moreData, fds);
     return promise.attach(zc::mv(fds), zc::mv(streams));
   }
 
   Maybe<Promise<uint64_t>> tryPumpFrom(AsyncInputStream& input,
                                        uint64_t amount = zc::maxValue) override {
+    // The optimized pumps write to the fd directly, which would jump ahead of combined writes.
+    if (flushesInFlight > 0) return zc::none;
+
 #if __linux__ && !__ANDROID__
     ZC_IF_SOME(sock, zc::dynamicDowncastIfAvailable<AsyncStreamFd>(input)) {
-      return pumpFromOther(sock, amount);
+      // splice() would skip over whatever the input's ring has already received.
+      if (!sock.readsThroughRing()) return pumpFromOther(sock, amount);
     }
 #endif
 
@@ -478,6 +788,12 @@ public:
   }
 
   void shutdownWrite() override {
+    if (flushesInFlight > 0) {
+      // Combined writes are still to go out; the last flush shuts down instead.
+      shutdownQueued = true;
+      return;
+    }
+
     // There's no legitimate way to get an AsyncStreamFd that isn't a socket through the
     // UnixAsyncIoProvider interface.
     ZC_SYSCALL(shutdown(fd, SHUT_WR));
@@ -496,6 +812,12 @@ public:
   }
 
   void setsockopt(int level, int option, const void* value, uint length) override {
+#ifdef TCP_ULP
+    // Writes that have completed but are still buffered would go out through the new layer
+    // (kernel TLS, say) rather than ahead of it.
+    ZC_REQUIRE(!(level == IPPROTO_TCP && option == TCP_ULP && combineLimit > 0),
+               "can't attach a TCP ULP to a stream that combines writes");
+#endif
     ZC_SYSCALL(::setsockopt(fd, level, option, value, length));
   }
 
@@ -515,6 +837,8 @@ public:
 
   void registerAncillaryMessageHandler(
       zc::Function<void(zc::ArrayPtr<AncillaryMessage>)> fn) override {
+    ZC_REQUIRE(!readsThroughRing(),
+               "can't receive ancillary messages on a stream that reads through io_uring");
     ancillaryMsgCallback = zc::mv(fn);
   }
 
@@ -541,18 +865,143 @@ public:
     }
   }
 
+  bool readsThroughRing() const {
+#if ZC_USE_EPOLL
+    return reader != zc::none;
+#else
+    return false;
+#endif
+  }
+
 private:
   UnixEventPort& eventPort;
+#if ZC_USE_EPOLL
+  Maybe<UnixEventPort::IoUring&> ring;
+  // Set if this stream does its I/O through io_uring; see UnixEventPort::enableIoUring().
+#endif
   UnixEventPort::FdObserver observer;
+#if ZC_USE_EPOLL
+  Maybe<Own<RingReader>> reader;
+#endif
   Maybe<ForkedPromise<void>> writeDisconnectedPromise;
   Maybe<Function<void(ArrayPtr<AncillaryMessage>)>> ancillaryMsgCallback;
 
+  size_t combineLimit = 0;
+  // Nonzero if this stream combines small writes; see UnixEventPort::enableWriteCombining().
+
+  Vector<byte> combined;
+  // Small writes that have completed as far as their callers know, but haven't been written yet.
+
+  bool flushQueued = false;
+  // Whether a flush of `combined` is waiting for the end of the turn.
+
+  uint flushesInFlight = 0;
+  Maybe<ForkedPromise<void>> flushing;
+  // Flushes that haven't finished, and the most recent one, which waits for the ones before it.
+  // A failed flush leaves its exception in `combineError` rather than rejecting.
+
+  Maybe<Exception> combineError;
+  bool shutdownQueued = false;
+
+  Promise<void> writeCombined(ArrayPtr<const byte> firstPiece,
+                              ArrayPtr<const ArrayPtr<const byte>> morePieces) {
+    ZC_IF_SOME(e, combineError) { return zc::cp(e); }
+
+    size_t total = firstPiece.size();
+    for (auto& piece : morePieces) total += piece.size();
+
+    if (combined.size() + total <= combineLimit) {
+      combined.addAll(firstPiece);
+      for (auto& piece : morePieces) combined.addAll(piece);
+      if (!flushQueued && total > 0) queueFlush();
+      return zc::READY_NOW;
+    }
+
+    // Too big to buffer. Write it together with what's buffered, once earlier flushes are done.
+    // The flush that's queued, if any, will find nothing left to write.
+    auto buffered = combined.releaseAsArray();
+    return whenFlushed().then([this, buffered = zc::mv(buffered), firstPiece,
+                               morePieces]() mutable -> Promise<void> {
+      ZC_IF_SOME(e, combineError) { return zc::cp(e); }
+      if (buffered.size() == 0) return writeInternal(firstPiece, morePieces, nullptr);
+
+      auto pieces = heapArrayBuilder<ArrayPtr<const byte>>(morePieces.size() + 1);
+      pieces.add(firstPiece);
+      pieces.addAll(morePieces);
+      auto piecesArray = pieces.finish();
+      auto promise = writeInternal(buffered, piecesArray, nullptr);
+      return promise.attach(zc::mv(buffered), zc::mv(piecesArray));
+    });
+  }
+
+  Promise<void> writeAfterCombined(ArrayPtr<const byte> data,
+                                   ArrayPtr<const ArrayPtr<const byte>> moreData,
+                                   ArrayPtr<const int> fds) {
+    if (flushesInFlight == 0) return writeInternal(data, moreData, fds);
+
+    // Not merged with the combined writes, so that any FDs stay attached to the first byte of
+    // `data`.
+    return whenFlushed().then([this, data, moreData, fds]() -> Promise<void> {
+      ZC_IF_SOME(e, combineError) { return zc::cp(e); }
+      return writeInternal(data, moreData, fds);
+    });
+  }
+
+  Promise<void> whenFlushed() {
+    if (flushesInFlight == 0) return zc::READY_NOW;
+    return ZC_ASSERT_NONNULL(flushing).addBranch();
+  }
+
+  void queueFlush() {
+    auto previous = whenFlushed();
+    flushQueued = true;
+    ++flushesInFlight;
+    flushing = previous
+                   .then([this]() { return evalLast([this]() { return flushCombined(); }); })
+                   .catch_([this](Exception&& e) {
+                     if (combineError == zc::none) combineError = zc::mv(e);
+                   })
+                   .then([this]() {
+                     if (--flushesInFlight == 0 && shutdownQueued) {
+                       shutdownQueued = false;
+                       ZC_SYSCALL(shutdown(fd, SHUT_WR));
+                     }
+                   })
+                   .fork();
+  }
+
+  Promise<void> flushCombined() {
+    flushQueued = false;
+    ZC_IF_SOME(e, combineError) { return zc::cp(e); }
+    auto buffered = combined.releaseAsArray();
+    auto promise = writeInternal(buffered, nullptr, nullptr);
+    return promise.attach(zc::mv(buffered));
+  }
+
+#if ZC_USE_EPOLL
+  Promise<void> writeThroughRing(UnixEventPort::IoUring& ring, ArrayPtr<const byte> firstPiece,
+                                 ArrayPtr<const ArrayPtr<const byte>> morePieces) {
+    size_t total = firstPiece.size();
+    for (auto& piece : morePieces) total += piece.size();
+    if (total == 0) return zc::READY_NOW;
+    return newAdaptedPromise<void, RingWrite>(ring, fd, firstPiece, morePieces);
+  }
+#endif
+
   Promise<ReadResult> tryReadInternal(void* buffer, size_t minBytes, size_t maxBytes,
                                       OwnFd* fdBuffer, size_t maxFds, ReadResult alreadyRead) {
     // `alreadyRead` is the number of bytes we have already received via previous reads -- minBytes,
     // maxBytes, and buffer have already been adjusted to account for them, but this count must
     // be included in the final return value.
 
+#if ZC_USE_EPOLL
+    ZC_IF_SOME(r, reader) {
+      // TCP sockets carry no file descriptors, so there are none to receive.
+      return r->read(reinterpret_cast<byte*>(buffer), minBytes, maxBytes, alreadyRead.byteCount)
+          .then([capCount = alreadyRead.capCount](size_t n) { return ReadResult{n, capCount}; });
+    }
+#endif
+
     ssize_t n;
     if (maxFds == 0 && ancillaryMsgCallback == zc::none) {
       ZC_NONBLOCKING_SYSCALL(n = ::read(fd, buffer, maxBytes)) {
@@ -738,6 +1187,12 @@ private:
   Promise<void> writeInternal(ArrayPtr<const byte> firstPiece,
                               ArrayPtr<const ArrayPtr<const byte>> morePieces,
                               ArrayPtr<const int> fds) {
+#if ZC_USE_EPOLL
+    if (fds.size() == 0) {
+      ZC_IF_SOME(r, ring) { return writeThroughRing(r, firstPiece, morePieces); }
+    }
+#endif
+
     const size_t iovmax = zc::miniposix::iovMax();
     // If there are more than IOV_MAX pieces, we'll only write the first IOV_MAX for now, and
     // then we'll loop later.
@@ -872,6 +1327,8 @@ constexpr size_t AsyncStreamFd::MAX_SPLICE_LEN;
 
 // =======================================================================================
 
+class DnsCache;
+
 class SocketAddress {
 public:
   SocketAddress(const void* sockaddr, uint len) : addrlen(len) {
@@ -975,13 +1432,15 @@ public:
     }
   }
 
-  static Promise<Array<SocketAddress>> lookupHost(LowLevelAsyncIoProvider& lowLevel,
-                                                  zc::String host, zc::String service,
-                                                  uint portHint, _::NetworkFilter& filter);
-  // Perform a DNS lookup.
+  static Promise<Array<SocketAddress>> lookupHost(DnsCache& dnsCache, zc::String host,
+                                                  zc::String service, uint portHint);
+  // Perform a DNS lookup, or reuse a recent one.
+
+  static Array<SocketAddress> lookupHostBlocking(StringPtr host, StringPtr service, uint portHint);
+  // Calls getaddrinfo().
 
-  static Promise<Array<SocketAddress>> parse(LowLevelAsyncIoProvider& lowLevel, StringPtr str,
-                                             uint portHint, _::NetworkFilter& filter) {
+  static Promise<Array<SocketAddress>> parse(DnsCache& dnsCache, StringPtr str, uint portHint,
+                                             _::NetworkFilter& filter) {
     // TODO(someday):  Allow commas in `str`.
 
     SocketAddress result;
@@ -1076,8 +1535,7 @@ public:
       port = strtoul(portText.cStr(), &endptr, 0);
       if (portText.size() == 0 || *endptr != '\0') {
         // Not a number.  Maybe it's a service name.  Fall back to DNS.
-        return lookupHost(lowLevel, zc::heapString(addrPart), zc::heapString(portText), portHint,
-                          filter);
+        return lookupHost(dnsCache, zc::heapString(addrPart), zc::heapString(portText), portHint);
       }
       ZC_REQUIRE(port < 65536, "Port number too large.");
     }
@@ -1144,7 +1602,7 @@ public:
       }
     }
 
-    return lookupHost(lowLevel, zc::heapString(addrPart), nullptr, port, filter);
+    return lookupHost(dnsCache, zc::heapString(addrPart), nullptr, port);
   }
 
   static SocketAddress getLocalAddress(int sockfd) {
@@ -1183,115 +1641,181 @@ private:
     struct sockaddr_storage storage;
   } addr;
 
-  struct LookupParams;
-};
-
-struct SocketAddress::LookupParams {
-  zc::String host;
-  zc::String service;
 };
 
-Promise<Array<SocketAddress>> SocketAddress::lookupHost(LowLevelAsyncIoProvider& lowLevel,
-                                                        zc::String host, zc::String service,
-                                                        uint portHint, _::NetworkFilter& filter) {
-  // This shitty function spawns a thread to run getaddrinfo().  Unfortunately, getaddrinfo() is
-  // the only cross-platform DNS API and it is blocking.
+Array<SocketAddress> SocketAddress::lookupHostBlocking(StringPtr host, StringPtr service,
+                                                       uint portHint) {
+  // getaddrinfo() can return multiple copies of the same address for several reasons.
+  // A major one is that we don't give it a socket type (SOCK_STREAM vs. SOCK_DGRAM), so
+  // it may return two copies of the same address, one for each type, unless it explicitly
+  // knows that the service name given is specific to one type.  But we can't tell it a type,
+  // because we don't actually know which one the user wants, and if we specify SOCK_STREAM
+  // while the user specified a UDP service name then they'll get a resolution error which
+  // is lame.  (At least, I think that's how it works.)
   //
-  // TODO(perf):  Use a thread pool?  Maybe zc::Thread should use a thread pool automatically?
-  //   Maybe use the various platform-specific asynchronous DNS libraries?  Please do not implement
-  //   a custom DNS resolver...
-
-  auto paf = newPromiseAndCrossThreadFulfiller<Array<SocketAddress>>();
-  LookupParams params = {zc::mv(host), zc::mv(service)};
-
-  auto thread = heap<Thread>(
-      [fulfiller = zc::mv(paf.fulfiller), params = zc::mv(params), portHint]() mutable {
-        // getaddrinfo() can return multiple copies of the same address for several reasons.
-        // A major one is that we don't give it a socket type (SOCK_STREAM vs. SOCK_DGRAM), so
-        // it may return two copies of the same address, one for each type, unless it explicitly
-        // knows that the service name given is specific to one type.  But we can't tell it a type,
-        // because we don't actually know which one the user wants, and if we specify SOCK_STREAM
-        // while the user specified a UDP service name then they'll get a resolution error which
-        // is lame.  (At least, I think that's how it works.)
-        //
-        // So we instead resort to de-duping results.
-        std::set<SocketAddress> result;
-
-        ZC_IF_SOME(
-            exception, zc::runCatchingExceptions([&]() {
-              struct addrinfo hints;
-              memset(&hints, 0, sizeof(hints));
-              hints.ai_family = AF_UNSPEC;
+  // So we instead resort to de-duping results. They stay in the order getaddrinfo() sorted them
+  // in, which is the order to try connecting in (RFC 6724).
+  std::set<SocketAddress> seen;
+  Vector<SocketAddress> result;
+
+  struct addrinfo hints;
+  memset(&hints, 0, sizeof(hints));
+  hints.ai_family = AF_UNSPEC;
 #if __BIONIC__ || !defined(AI_V4MAPPED)
-              // AI_V4MAPPED causes getaddrinfo() to fail on Bionic libc (Android).
-              hints.ai_flags = AI_ADDRCONFIG;
+  // AI_V4MAPPED causes getaddrinfo() to fail on Bionic libc (Android).
+  hints.ai_flags = AI_ADDRCONFIG;
 #else
-              hints.ai_flags = AI_V4MAPPED | AI_ADDRCONFIG;
+  hints.ai_flags = AI_V4MAPPED | AI_ADDRCONFIG;
 #endif
-              struct addrinfo* list;
-              int status = getaddrinfo(params.host == "*" ? nullptr : params.host.cStr(),
-                                       params.service == nullptr ? nullptr : params.service.cStr(),
-                                       &hints, &list);
-              if (status == 0) {
-                ZC_DEFER(freeaddrinfo(list));
-
-                struct addrinfo* cur = list;
-                while (cur != nullptr) {
-                  if (params.service == nullptr) {
-                    switch (cur->ai_addr->sa_family) {
-                      case AF_INET:
-                        ((struct sockaddr_in*)cur->ai_addr)->sin_port = htons(portHint);
-                        break;
-                      case AF_INET6:
-                        ((struct sockaddr_in6*)cur->ai_addr)->sin6_port = htons(portHint);
-                        break;
-                      default:
-                        break;
-                    }
-                  }
-
-                  SocketAddress addr;
-                  if (params.host == "*") {
-                    // Set up a wildcard SocketAddress.  Only use the port number returned by
-                    // getaddrinfo().
-                    addr.wildcard = true;
-                    addr.addrlen = sizeof(addr.addr.inet6);
-                    addr.addr.inet6.sin6_family = AF_INET6;
-                    switch (cur->ai_addr->sa_family) {
-                      case AF_INET:
-                        addr.addr.inet6.sin6_port = ((struct sockaddr_in*)cur->ai_addr)->sin_port;
-                        break;
-                      case AF_INET6:
-                        addr.addr.inet6.sin6_port = ((struct sockaddr_in6*)cur->ai_addr)->sin6_port;
-                        break;
-                      default:
-                        addr.addr.inet6.sin6_port = portHint;
-                        break;
-                    }
-                  } else {
-                    addr.addrlen = cur->ai_addrlen;
-                    memcpy(&addr.addr.generic, cur->ai_addr, cur->ai_addrlen);
-                  }
-                  result.insert(addr);
-                  cur = cur->ai_next;
-                }
-              } else if (status == EAI_SYSTEM) {
-                ZC_FAIL_SYSCALL("getaddrinfo", errno, params.host, params.service) { return; }
-              } else {
-                ZC_FAIL_REQUIRE("DNS lookup failed.", params.host, params.service,
-                                gai_strerror(status)) {
-                  return;
-                }
-              }
-            })) {
-          fulfiller->reject(zc::mv(exception));
+  struct addrinfo* list;
+  int status = getaddrinfo(host == "*" ? nullptr : host.cStr(),
+                           service == nullptr ? nullptr : service.cStr(), &hints, &list);
+  if (status == 0) {
+    ZC_DEFER(freeaddrinfo(list));
+
+    struct addrinfo* cur = list;
+    while (cur != nullptr) {
+      if (service == nullptr) {
+        switch (cur->ai_addr->sa_family) {
+          case AF_INET:
+            ((struct sockaddr_in*)cur->ai_addr)->sin_port = htons(portHint);
+            break;
+          case AF_INET6:
+            ((struct sockaddr_in6*)cur->ai_addr)->sin6_port = htons(portHint);
+            break;
+          default:
+            break;
         }
-        else {
-          fulfiller->fulfill(ZC_MAP(addr, result) { return addr; });
+      }
+
+      SocketAddress addr;
+      if (host == "*") {
+        // Set up a wildcard SocketAddress.  Only use the port number returned by
+        // getaddrinfo().
+        addr.wildcard = true;
+        addr.addrlen = sizeof(addr.addr.inet6);
+        addr.addr.inet6.sin6_family = AF_INET6;
+        switch (cur->ai_addr->sa_family) {
+          case AF_INET:
+            addr.addr.inet6.sin6_port = ((struct sockaddr_in*)cur->ai_addr)->sin_port;
+            break;
+          case AF_INET6:
+            addr.addr.inet6.sin6_port = ((struct sockaddr_in6*)cur->ai_addr)->sin6_port;
+            break;
+          default:
+            addr.addr.inet6.sin6_port = portHint;
+            break;
         }
+      } else {
+        addr.addrlen = cur->ai_addrlen;
+        memcpy(&addr.addr.generic, cur->ai_addr, cur->ai_addrlen);
+      }
+      if (seen.insert(addr).second) { result.add(addr); }
+      cur = cur->ai_next;
+    }
+  } else if (status == EAI_SYSTEM) {
+    ZC_FAIL_SYSCALL("getaddrinfo", errno, host, service) { return nullptr; }
+  } else {
+    ZC_FAIL_REQUIRE("DNS lookup failed.", host, service, gai_strerror(status)) { return nullptr; }
+  }
+
+  return result.releaseAsArray();
+}
+
+class DnsCache final : public Refcounted, private TaskSet::ErrorHandler {
+  // The DNS lookups of a SocketNetwork and the networks restricted from it. Lookups of the same
+  // name that overlap share one call to getaddrinfo(), and its result is reused for a while after.
+  //
+  // getaddrinfo() doesn't report the records' TTLs, so successful lookups are kept for a fixed
+  // RESULT_TTL, which is the most that a changed record goes unnoticed for. Failed lookups aren't
+  // kept, so that a name that is only briefly unresolvable doesn't stay that way.
+  //
+  // Since getaddrinfo() blocks, it runs on a small pool of threads shared by every event loop in
+  // the process, rather than on a new thread per lookup.
+  //
+  // TODO(someday): Use the platform's asynchronous resolver where it has one, which would also
+  //   give us the TTLs. Please still do not implement a custom DNS resolver...
+
+public:
+  explicit DnsCache(Timer& timer) : timer(timer), tasks(*this) {}
+
+  Promise<Array<SocketAddress>> lookup(String host, String service, uint portHint) {
+    auto key = str(host, '\n', service, '\n', portHint);
+    auto now = timer.now();
+
+    ZC_IF_SOME(entry, entries.find(key)) {
+      ZC_IF_SOME(inFlight, entry.inFlight) {
+        return inFlight.addBranch().then(
+            [](Rc<Result> result) { return heapArray(result->addresses.asPtr()); });
+      }
+      if (now < entry.expires) { return heapArray(entry.addresses.asPtr()); }
+      entries.erase(key);
+    }
+
+    if (entries.size() >= MAX_ENTRIES) {
+      entries.eraseAll([&](const String&, Entry& entry) {
+        return entry.inFlight == zc::none && entry.expires <= now;
       });
+    }
+
+    auto promise = getLookupPool()
+                       .run([host = zc::mv(host), service = zc::mv(service), portHint]() {
+                         return SocketAddress::lookupHostBlocking(host, service, portHint);
+                       })
+                       .then([](Array<SocketAddress> addresses) {
+                         return rc<Result>(zc::mv(addresses));
+                       })
+                       .fork();
+    auto branch = promise.addBranch();
+
+    // Keep the result once it's in, unless the cache is already full.
+    tasks.add(promise.addBranch().then(
+        [this, key = heapString(key)](Rc<Result> result) {
+          ZC_IF_SOME(entry, entries.find(key)) {
+            entry.inFlight = zc::none;
+            entry.addresses = heapArray(result->addresses.asPtr());
+            entry.expires = timer.now() + RESULT_TTL;
+            if (entries.size() > MAX_ENTRIES) { entries.erase(key); }
+          }
+        },
+        [this, key = heapString(key)](Exception&&) { entries.erase(key); }));
+    entries.insert(zc::mv(key), Entry{zc::mv(promise), nullptr, now});
+
+    return branch.then([](Rc<Result> result) { return heapArray(result->addresses.asPtr()); });
+  }
+
+private:
+  static constexpr Duration RESULT_TTL = 30 * SECONDS;
+  static constexpr size_t MAX_ENTRIES = 10000;
+
+  struct Result final : public Refcounted {
+    explicit Result(Array<SocketAddress> addresses) : addresses(zc::mv(addresses)) {}
+    Array<SocketAddress> addresses;
+  };
 
-  return zc::mv(paf.promise);
+  struct Entry {
+    Maybe<ForkedPromise<Rc<Result>>> inFlight;
+    Array<SocketAddress> addresses;
+    TimePoint expires;
+  };
+
+  Timer& timer;
+  HashMap<String, Entry> entries;
+  TaskSet tasks;
+
+  static const WorkerPool& getLookupPool() {
+    // Never destroyed, so that exiting doesn't wait for a slow lookup to time out.
+    static const WorkerPool* pool = new WorkerPool(LOOKUP_THREADS);
+    return *pool;
+  }
+  static constexpr uint LOOKUP_THREADS = 8;
+
+  void taskFailed(Exception&& exception) override { ZC_LOG(ERROR, exception); }
+};
+
+Promise<Array<SocketAddress>> SocketAddress::lookupHost(DnsCache& dnsCache, zc::String host,
+                                                        zc::String service, uint portHint) {
+  return dnsCache.lookup(zc::mv(host), zc::mv(service), portHint);
 }
 
 // =======================================================================================
@@ -1304,7 +1828,15 @@ public:
         lowLevel(lowLevel),
         eventPort(eventPort),
         filter(filter),
-        observer(eventPort, fd, UnixEventPort::FdObserver::OBSERVE_READ) {}
+#if ZC_USE_EPOLL
+        ring(ringFor(eventPort, fd)),
+        observer(eventPort, fd, ring == zc::none ? UnixEventPort::FdObserver::OBSERVE_READ : 0) {
+    ZC_IF_SOME(r, ring) { acceptor = heap<RingAcceptor>(r, fd); }
+  }
+#else
+        observer(eventPort, fd, UnixEventPort::FdObserver::OBSERVE_READ) {
+  }
+#endif
 
   Promise<Own<AsyncIoStream>> accept() override {
     return acceptImpl(false).then([](AuthenticatedStream&& a) { return zc::mv(a.stream); });
@@ -1313,6 +1845,21 @@ public:
   Promise<AuthenticatedStream> acceptAuthenticated() override { return acceptImpl(true); }
 
   Promise<AuthenticatedStream> acceptImpl(bool authenticated) {
+#if ZC_USE_EPOLL
+    ZC_IF_SOME(a, acceptor) {
+      return a->accept().then([this, authenticated](OwnFd ownFd) {
+        // A multishot accept doesn't report addresses, so ask for this one.
+        struct sockaddr_storage addr;
+        socklen_t addrlen = sizeof(addr);
+        if (::getpeername(ownFd.get(), reinterpret_cast<struct sockaddr*>(&addr), &addrlen) < 0) {
+          // The connection is already gone.
+          return acceptImpl(authenticated);
+        }
+        return finishAccept(zc::mv(ownFd), addr, addrlen, authenticated);
+      });
+    }
+#endif
+
     int newFd;
 
     struct sockaddr_storage addr;
@@ -1327,53 +1874,7 @@ public:
 #endif
 
     if (newFd >= 0) {
-      zc::OwnFd ownFd(newFd);
-
-      if (addrlen == 0) {
-#if __APPLE__
-        // A bug in XNU (the macOS kernel) can cause accept() to return a socket but addrlen=0
-        // The socket is already dead and should be discarded
-        // https://github.com/apple-oss-distributions/xnu/blob/e3723e1f17661b24996789d8afc084c0c3303b26/bsd/kern/uipc_syscalls.c#L663-L691
-#else
-        ZC_LOG(ERROR, "accept() returned zero-size address?");
-#endif
-        return acceptImpl(authenticated);
-      }
-
-      if (!filter.shouldAllow(reinterpret_cast<struct sockaddr*>(&addr), addrlen)) {
-        // Ignore disallowed address.
-        return acceptImpl(authenticated);
-      } else {
-        // TODO(perf):  As a hack for the 0.4 release we are always setting
-        //   TCP_NODELAY because Nagle's algorithm pretty much kills Cap'n Proto's
-        //   RPC protocol.  Later, we should extend the interface to provide more
-        //   control over this.  Perhaps write() should have a flag which
-        //   specifies whether to pass MSG_MORE.
-        int one = 1;
-        ZC_SYSCALL_HANDLE_ERRORS(
-            ::setsockopt(ownFd.get(), IPPROTO_TCP, TCP_NODELAY, (char*)&one, sizeof(one))) {
-          case EOPNOTSUPP:
-          case ENOPROTOOPT:  // (returned for AF_UNIX in cygwin)
-#if __APPLE__ || __FreeBSD__
-          case EINVAL:
-            // On FreeBSD, EINVAL is returned for AF_UNIX sockets.
-            // On macOS, EINVAL may be returned for sockets that are already dead (due to a race
-            // with RST).
-#endif
-            break;
-          default:
-            ZC_FAIL_SYSCALL("setsocketopt(IPPROTO_TCP, TCP_NODELAY)", error);
-        }
-
-        AuthenticatedStream result;
-        result.stream = heap<AsyncStreamFd>(eventPort, ownFd.release(), NEW_FD_FLAGS,
-                                            UnixEventPort::FdObserver::OBSERVE_READ_WRITE);
-        if (authenticated) {
-          result.peerIdentity = SocketAddress(reinterpret_cast<struct sockaddr*>(&addr), addrlen)
-                                    .getIdentity(lowLevel, filter, *result.stream);
-        }
-        return zc::mv(result);
-      }
+      return finishAccept(zc::OwnFd(newFd), addr, addrlen, authenticated);
     } else {
       int error = errno;
 
@@ -1409,6 +1910,55 @@ public:
     }
   }
 
+  Promise<AuthenticatedStream> finishAccept(OwnFd ownFd, struct sockaddr_storage& addr,
+                                            socklen_t addrlen, bool authenticated) {
+    if (addrlen == 0) {
+#if __APPLE__
+      // A bug in XNU (the macOS kernel) can cause accept() to return a socket but addrlen=0
+      // The socket is already dead and should be discarded
+      // https://github.com/apple-oss-distributions/xnu/blob/e3723e1f17661b24996789d8afc084c0c3303b26/bsd/kern/uipc_syscalls.c#L663-L691
+#else
+      ZC_LOG(ERROR, "accept() returned zero-size address?");
+#endif
+      return acceptImpl(authenticated);
+    }
+
+    if (!filter.shouldAllow(reinterpret_cast<struct sockaddr*>(&addr), addrlen)) {
+      // Ignore disallowed address.
+      return acceptImpl(authenticated);
+    } else {
+      // TODO(perf):  As a hack for the 0.4 release we are always setting
+      //   TCP_NODELAY because Nagle's algorithm pretty much kills Cap'n Proto's
+      //   RPC protocol.  Later, we should extend the interface to provide more
+      //   control over this.  Perhaps write() should have a flag which
+      //   specifies whether to pass MSG_MORE.
+      int one = 1;
+      ZC_SYSCALL_HANDLE_ERRORS(
+          ::setsockopt(ownFd.get(), IPPROTO_TCP, TCP_NODELAY, (char*)&one, sizeof(one))) {
+        case EOPNOTSUPP:
+        case ENOPROTOOPT:  // (returned for AF_UNIX in cygwin)
+#if __APPLE__ || __FreeBSD__
+        case EINVAL:
+          // On FreeBSD, EINVAL is returned for AF_UNIX sockets.
+          // On macOS, EINVAL may be returned for sockets that are already dead (due to a race
+          // with RST).
+#endif
+          break;
+        default:
+          ZC_FAIL_SYSCALL("setsocketopt(IPPROTO_TCP, TCP_NODELAY)", error);
+      }
+
+      AuthenticatedStream result;
+      result.stream = heap<AsyncStreamFd>(eventPort, ownFd.release(), NEW_FD_FLAGS,
+                                          UnixEventPort::FdObserver::OBSERVE_READ_WRITE);
+      if (authenticated) {
+        result.peerIdentity = SocketAddress(reinterpret_cast<struct sockaddr*>(&addr), addrlen)
+                                  .getIdentity(lowLevel, filter, *result.stream);
+      }
+      return zc::mv(result);
+    }
+  }
+
   uint getPort() override { return SocketAddress::getLocalAddress(fd).getPort(); }
 
   void getsockopt(int level, int option, void* value, uint* length) override {
@@ -1429,7 +1979,13 @@ public:
   LowLevelAsyncIoProvider& lowLevel;
   UnixEventPort& eventPort;
   LowLevelAsyncIoProvider::NetworkFilter& filter;
+#if ZC_USE_EPOLL
+  Maybe<UnixEventPort::IoUring&> ring;
+#endif
   UnixEventPort::FdObserver observer;
+#if ZC_USE_EPOLL
+  Maybe<Own<RingAcceptor>> acceptor;
+#endif
 };
 
 class DatagramPortImpl final : public DatagramPort, public OwnedFileDescriptor {
@@ -1452,6 +2008,15 @@ public:
 
   Own<DatagramReceiver> makeReceiver(DatagramReceiver::Capacity capacity) override;
 
+#if __linux__
+  Promise<void> sendBatch(ArrayPtr<const OutgoingDatagram> datagrams) override;
+
+  class BatchReceiverImpl;
+
+  Own<DatagramBatchReceiver> makeBatchReceiver(size_t batchSize,
+                                               DatagramReceiver::Capacity capacity) override;
+#endif
+
   uint getPort() override { return SocketAddress::getLocalAddress(fd).getPort(); }
 
   void getsockopt(int level, int option, void* value, uint* length) override {
@@ -1539,27 +2104,147 @@ private:
 
 // =======================================================================================
 
+constexpr Duration DEFAULT_CONNECTION_ATTEMPT_DELAY = 250 * MILLISECONDS;
+// See Network::withConnectionAttemptDelay().
+
+class ConnectionRace final : private TaskSet::ErrorHandler {
+  // Connects to the first of several addresses to answer, the way RFC 8305 describes (see
+  // Network::withConnectionAttemptDelay()). Destroying the race cancels the attempts still going.
+
+public:
+  ConnectionRace(LowLevelAsyncIoProvider& lowLevel, LowLevelAsyncIoProvider::NetworkFilter& filter,
+                 ArrayPtr<const SocketAddress> addrs, bool authenticated, Duration attemptDelay)
+      : lowLevel(lowLevel),
+        filter(filter),
+        addrs(interleaveFamilies(addrs)),
+        authenticated(authenticated),
+        attemptDelay(attemptDelay),
+        tasks(*this) {}
+
+  Promise<AuthenticatedStream> run() {
+    ZC_ASSERT(addrs.size() > 0);
+    auto paf = newPromiseAndFulfiller<AuthenticatedStream>();
+    fulfiller = zc::mv(paf.fulfiller);
+    startNext();
+    return zc::mv(paf.promise);
+  }
+
+private:
+  LowLevelAsyncIoProvider& lowLevel;
+  LowLevelAsyncIoProvider::NetworkFilter& filter;
+  Array<SocketAddress> addrs;
+  bool authenticated;
+  Duration attemptDelay;
+
+  size_t started = 0;
+  size_t failed = 0;
+  Own<PromiseFulfiller<AuthenticatedStream>> fulfiller;
+  TaskSet tasks;
+
+  static Array<SocketAddress> interleaveFamilies(ArrayPtr<const SocketAddress> addrs) {
+    // Alternates between the first address's family and the others, keeping the resolver's order
+    // within each, as RFC 8305 section 4 recommends.
+    auto result = heapArrayBuilder<SocketAddress>(addrs.size());
+    if (addrs.size() == 0) { return result.finish(); }
+
+    auto firstFamily = addrs[0].getRaw()->sa_family;
+    size_t nextFirst = 0;
+    size_t nextOther = 0;
+    bool wantFirst = true;
+    while (!result.isFull()) {
+      while (nextFirst < addrs.size() && addrs[nextFirst].getRaw()->sa_family != firstFamily) {
+        ++nextFirst;
+      }
+      while (nextOther < addrs.size() && addrs[nextOther].getRaw()->sa_family == firstFamily) {
+        ++nextOther;
+      }
+      if (nextOther == addrs.size() || (wantFirst && nextFirst < addrs.size())) {
+        result.add(addrs[nextFirst++]);
+      } else {
+        result.add(addrs[nextOther++]);
+      }
+      wantFirst = !wantFirst;
+    }
+    return result.finish();
+  }
+
+  void startNext() {
+    if (started == addrs.size()) { return; }
+    size_t index = started++;
+
+    tasks.add(connectOne(addrs[index])
+                  .then(
+                      [this, index](Own<AsyncIoStream>&& stream) {
+                        AuthenticatedStream result;
+                        result.stream = zc::mv(stream);
+                        if (authenticated) {
+                          result.peerIdentity =
+                              addrs[index].getIdentity(lowLevel, filter, *result.stream);
+                        }
+                        fulfiller->fulfill(zc::mv(result));
+                      },
+                      [this](Exception&& exception) {
+                        // Don't wait out the delay when an attempt fails; the rest of the race
+                        // fails with the last address's exception, like trying them in turn would.
+                        if (++failed == addrs.size()) {
+                          fulfiller->reject(zc::mv(exception));
+                        } else {
+                          startNext();
+                        }
+                      }));
+
+    if (started < addrs.size()) {
+      tasks.add(lowLevel.getTimer().afterDelay(attemptDelay).then([this, index]() {
+        if (started == index + 1) { startNext(); }
+      }));
+    }
+  }
+
+  Promise<Own<AsyncIoStream>> connectOne(SocketAddress& addr) {
+    return zc::evalNow([&]() -> Promise<Own<AsyncIoStream>> {
+      if (!addr.allowedBy(filter)) {
+        return ZC_EXCEPTION(FAILED, "connect() blocked by restrictPeers()");
+      } else {
+        auto fd = addr.socket(SOCK_STREAM);
+        return lowLevel.wrapConnectingSocketFd(zc::mv(fd), addr.getRaw(), addr.getRawSize(),
+                                               NEW_FD_FLAGS);
+      }
+    });
+  }
+
+  void taskFailed(Exception&& exception) override { fulfiller->reject(zc::mv(exception)); }
+};
+
 class NetworkAddressImpl final : public NetworkAddress {
 public:
   NetworkAddressImpl(LowLevelAsyncIoProvider& lowLevel,
-                     LowLevelAsyncIoProvider::NetworkFilter& filter, Array<SocketAddress> addrs)
-      : lowLevel(lowLevel), filter(filter), addrs(zc::mv(addrs)) {}
+                     LowLevelAsyncIoProvider::NetworkFilter& filter, Array<SocketAddress> addrs,
+                     Duration connectionAttemptDelay = DEFAULT_CONNECTION_ATTEMPT_DELAY)
+      : lowLevel(lowLevel),
+        filter(filter),
+        addrs(zc::mv(addrs)),
+        connectionAttemptDelay(connectionAttemptDelay) {}
 
   Promise<Own<AsyncIoStream>> connect() override {
-    auto addrsCopy = heapArray(addrs.asPtr());
-    auto promise = connectImpl(lowLevel, filter, addrsCopy, false);
-    return promise.attach(zc::mv(addrsCopy)).then([](AuthenticatedStream&& a) {
-      return zc::mv(a.stream);
-    });
+    return connectAuthenticatedImpl(false).then(
+        [](AuthenticatedStream&& a) { return zc::mv(a.stream); });
   }
 
   Promise<AuthenticatedStream> connectAuthenticated() override {
-    auto addrsCopy = heapArray(addrs.asPtr());
-    auto promise = connectImpl(lowLevel, filter, addrsCopy, true);
-    return promise.attach(zc::mv(addrsCopy));
+    return connectAuthenticatedImpl(true);
+  }
+
+  Own<ConnectionReceiver> listen() override { return listenImpl(false); }
+
+  Own<ConnectionReceiver> listenShared() override {
+#ifdef SO_REUSEPORT
+    return listenImpl(true);
+#else
+    ZC_UNIMPLEMENTED("SO_REUSEPORT is not supported on this platform");
+#endif
   }
 
-  Own<ConnectionReceiver> listen() override {
+  Own<ConnectionReceiver> listenImpl(bool shared) {
     auto makeReceiver = [&](SocketAddress& addr) {
       auto fd = addr.socket(SOCK_STREAM);
 
@@ -1568,6 +2253,11 @@ public:
         // before it can restart really sucks.
         int optval = 1;
         ZC_SYSCALL(setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval)));
+#ifdef SO_REUSEPORT
+        if (shared) {
+          ZC_SYSCALL(setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &optval, sizeof(optval)));
+        }
+#endif
 
         addr.bind(fd);
 
@@ -1609,7 +2299,8 @@ public:
   }
 
   Own<NetworkAddress> clone() override {
-    return zc::heap<NetworkAddressImpl>(lowLevel, filter, zc::heapArray(addrs.asPtr()));
+    return zc::heap<NetworkAddressImpl>(lowLevel, filter, zc::heapArray(addrs.asPtr()),
+                                        connectionAttemptDelay);
   }
 
   String toString() override {
@@ -1626,44 +2317,13 @@ private:
   LowLevelAsyncIoProvider::NetworkFilter& filter;
   Array<SocketAddress> addrs;
   uint counter = 0;
+  Duration connectionAttemptDelay;
 
-  static Promise<AuthenticatedStream> connectImpl(LowLevelAsyncIoProvider& lowLevel,
-                                                  LowLevelAsyncIoProvider::NetworkFilter& filter,
-                                                  ArrayPtr<SocketAddress> addrs,
-                                                  bool authenticated) {
-    ZC_ASSERT(addrs.size() > 0);
-
-    return zc::evalNow([&]() -> Promise<Own<AsyncIoStream>> {
-             if (!addrs[0].allowedBy(filter)) {
-               return ZC_EXCEPTION(FAILED, "connect() blocked by restrictPeers()");
-             } else {
-               auto fd = addrs[0].socket(SOCK_STREAM);
-               return lowLevel.wrapConnectingSocketFd(zc::mv(fd), addrs[0].getRaw(),
-                                                      addrs[0].getRawSize(), NEW_FD_FLAGS);
-             }
-           })
-        .then(
-            [&lowLevel, &filter, addrs,
-             authenticated](Own<AsyncIoStream>&& stream) -> Promise<AuthenticatedStream> {
-              // Success, pass along.
-              AuthenticatedStream result;
-              result.stream = zc::mv(stream);
-              if (authenticated) {
-                result.peerIdentity = addrs[0].getIdentity(lowLevel, filter, *result.stream);
-              }
-              return zc::mv(result);
-            },
-            [&lowLevel, &filter, addrs,
-             authenticated](Exception&& exception) mutable -> Promise<AuthenticatedStream> {
-              // Connect failed.
-              if (addrs.size() > 1) {
-                // Try the next address instead.
-                return connectImpl(lowLevel, filter, addrs.slice(1, addrs.size()), authenticated);
-              } else {
-                // No more addresses to try, so propagate the exception.
-                return zc::mv(exception);
-              }
-            });
+  Promise<AuthenticatedStream> connectAuthenticatedImpl(bool authenticated) {
+    auto race =
+        heap<ConnectionRace>(lowLevel, filter, addrs, authenticated, connectionAttemptDelay);
+    auto promise = race->run();
+    return promise.attach(zc::mv(race));
   }
 };
 
@@ -1721,15 +2381,29 @@ zc::Own<PeerIdentity> SocketAddress::getIdentity(zc::LowLevelAsyncIoProvider& ll
 
 class SocketNetwork final : public Network {
 public:
-  explicit SocketNetwork(LowLevelAsyncIoProvider& lowLevel) : lowLevel(lowLevel) {}
+  explicit SocketNetwork(LowLevelAsyncIoProvider& lowLevel)
+      : lowLevel(lowLevel),
+        ownFilter(heap<_::NetworkFilter>()),
+        filter(*ownFilter),
+        dnsCache(rc<DnsCache>(lowLevel.getTimer())) {}
   explicit SocketNetwork(SocketNetwork& parent, zc::ArrayPtr<const zc::StringPtr> allow,
                          zc::ArrayPtr<const zc::StringPtr> deny)
-      : lowLevel(parent.lowLevel), filter(allow, deny, parent.filter) {}
+      : lowLevel(parent.lowLevel),
+        ownFilter(heap<_::NetworkFilter>(allow, deny, parent.filter)),
+        filter(*ownFilter),
+        dnsCache(parent.dnsCache.addRef()),
+        connectionAttemptDelay(parent.connectionAttemptDelay) {}
+  explicit SocketNetwork(SocketNetwork& parent, Duration connectionAttemptDelay)
+      : lowLevel(parent.lowLevel),
+        filter(parent.filter),
+        dnsCache(parent.dnsCache.addRef()),
+        connectionAttemptDelay(connectionAttemptDelay) {}
 
   Promise<Own<NetworkAddress>> parseAddress(StringPtr addr, uint portHint = 0) override {
-    return evalNow([&]() { return SocketAddress::parse(lowLevel, addr, portHint, filter); })
+    return evalNow([&]() { return SocketAddress::parse(*dnsCache.get(), addr, portHint, filter); })
         .then([this](Array<SocketAddress> addresses) -> Own<NetworkAddress> {
-          return heap<NetworkAddressImpl>(lowLevel, filter, zc::mv(addresses));
+          return heap<NetworkAddressImpl>(lowLevel, filter, zc::mv(addresses),
+                                          connectionAttemptDelay);
         });
   }
 
@@ -1737,7 +2411,8 @@ public:
     auto array = zc::heapArrayBuilder<SocketAddress>(1);
     array.add(SocketAddress(sockaddr, len));
     ZC_REQUIRE(array[0].allowedBy(filter), "address blocked by restrictPeers()") { break; }
-    return Own<NetworkAddress>(heap<NetworkAddressImpl>(lowLevel, filter, array.finish()));
+    return Own<NetworkAddress>(
+        heap<NetworkAddressImpl>(lowLevel, filter, array.finish(), connectionAttemptDelay));
   }
 
   Own<Network> restrictPeers(zc::ArrayPtr<const zc::StringPtr> allow,
@@ -1745,9 +2420,16 @@ public:
     return heap<SocketNetwork>(*this, allow, deny);
   }
 
+  Own<Network> withConnectionAttemptDelay(Duration delay) override {
+    return heap<SocketNetwork>(*this, delay);
+  }
+
 private:
   LowLevelAsyncIoProvider& lowLevel;
-  _::NetworkFilter filter;
+  Own<_::NetworkFilter> ownFilter;
+  _::NetworkFilter& filter;
+  Rc<DnsCache> dnsCache;
+  Duration connectionAttemptDelay = DEFAULT_CONNECTION_ATTEMPT_DELAY;
 };
 
 // =======================================================================================
@@ -1820,6 +2502,51 @@ Promise<size_t> DatagramPortImpl::send(ArrayPtr<const ArrayPtr<const byte>> piec
   }
 }
 
+void parseAncillary(struct msghdr& msg, ArrayPtr<const byte> buffer,
+                    Vector<AncillaryMessage>& list) {
+  // Collects the ancillary messages that recvmsg() left in `buffer`.
+
+  list.resize(0);
+  for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
+       cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+    // On some platforms (OSX), a cmsghdr's length may cross the end of the ancillary buffer
+    // when truncated. On other platforms (Linux) the length in cmsghdr will itself be
+    // truncated to fit within the buffer.
+
+    const byte* pos = reinterpret_cast<const byte*>(cmsg);
+    size_t available = buffer.end() - pos;
+    if (available < CMSG_SPACE(0)) {
+      // The buffer ends in the middle of the header. We can't use this message.
+      // (On Linux, this never happens, because the message is not included if there isn't
+      // space for a header. I'm not sure how other systems behave, though, so let's be safe.)
+      break;
+    }
+
+    // OK, we know the cmsghdr is valid, at least.
+
+    // Find the start of the message payload.
+    const byte* begin = (const byte*)CMSG_DATA(cmsg);
+
+    // Cap the message length to the available space.
+    const byte* end = pos + zc::min(available, cmsg->cmsg_len);
+
+    list.add(AncillaryMessage(cmsg->cmsg_level, cmsg->cmsg_type, arrayPtr(begin, end)));
+  }
+}
+
+struct StoredDatagramSource {
+  // The source of a received datagram, as the NetworkAddress that receivers hand out.
+
+  StoredDatagramSource(LowLevelAsyncIoProvider& lowLevel,
+                       LowLevelAsyncIoProvider::NetworkFilter& filter, const void* sockaddr,
+                       uint length)
+      : raw(sockaddr, length),
+        abstract(lowLevel, filter, Array<SocketAddress>(&raw, 1, NullArrayDisposer::instance)) {}
+
+  SocketAddress raw;
+  NetworkAddressImpl abstract;
+};
+
 class DatagramPortImpl::ReceiverImpl final : public DatagramReceiver {
 public:
   explicit ReceiverImpl(DatagramPortImpl& port, Capacity capacity)
@@ -1863,35 +2590,8 @@ public:
 
       source.emplace(port.lowLevel, port.filter, msg.msg_name, msg.msg_namelen);
 
-      ancillaryList.resize(0);
       ancillaryTruncated = msg.msg_flags & MSG_CTRUNC;
-
-      for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr;
-           cmsg = CMSG_NXTHDR(&msg, cmsg)) {
-        // On some platforms (OSX), a cmsghdr's length may cross the end of the ancillary buffer
-        // when truncated. On other platforms (Linux) the length in cmsghdr will itself be
-        // truncated to fit within the buffer.
-
-        const byte* pos = reinterpret_cast<const byte*>(cmsg);
-        size_t available = ancillaryBuffer.end() - pos;
-        if (available < CMSG_SPACE(0)) {
-          // The buffer ends in the middle of the header. We can't use this message.
-          // (On Linux, this never happens, because the message is not included if there isn't
-          // space for a header. I'm not sure how other systems behave, though, so let's be safe.)
-          break;
-        }
-
-        // OK, we know the cmsghdr is valid, at least.
-
-        // Find the start of the message payload.
-        const byte* begin = (const byte*)CMSG_DATA(cmsg);
-
-        // Cap the message length to the available space.
-        const byte* end = pos + zc::min(available, cmsg->cmsg_len);
-
-        ancillaryList.add(
-            AncillaryMessage(cmsg->cmsg_level, cmsg->cmsg_type, arrayPtr(begin, end)));
-      }
+      parseAncillary(msg, ancillaryBuffer, ancillaryList);
 
       return READY_NOW;
     }
@@ -1918,23 +2618,171 @@ private:
   bool contentTruncated = false;
   bool ancillaryTruncated = false;
 
-  struct StoredAddress {
-    StoredAddress(LowLevelAsyncIoProvider& lowLevel, LowLevelAsyncIoProvider::NetworkFilter& filter,
-                  const void* sockaddr, uint length)
-        : raw(sockaddr, length),
-          abstract(lowLevel, filter, Array<SocketAddress>(&raw, 1, NullArrayDisposer::instance)) {}
+  zc::Maybe<StoredDatagramSource> source;
+};
+
+Own<DatagramReceiver> DatagramPortImpl::makeReceiver(DatagramReceiver::Capacity capacity) {
+  return zc::heap<ReceiverImpl>(*this, capacity);
+}
+
+#if __linux__
+
+Promise<void> DatagramPortImpl::sendBatch(ArrayPtr<const OutgoingDatagram> datagrams) {
+  // sendmmsg() takes at most UIO_MAXIOV messages per call.
+  constexpr size_t MAX_BATCH = 1024;
+
+  while (datagrams.size() > 0) {
+    size_t count = zc::min(datagrams.size(), MAX_BATCH);
+    ZC_STACK_ARRAY(struct mmsghdr, msgs, count, 16, 64);
+    ZC_STACK_ARRAY(struct iovec, iov, count, 16, 64);
+    memset(msgs.begin(), 0, msgs.size() * sizeof(msgs[0]));
+
+    for (size_t i : zc::zeroTo(count)) {
+      auto& addr = downcast<NetworkAddressImpl>(datagrams[i].destination).chooseOneAddress();
+      iov[i].iov_base = const_cast<byte*>(datagrams[i].content.begin());
+      iov[i].iov_len = datagrams[i].content.size();
+      msgs[i].msg_hdr.msg_name = const_cast<void*>(implicitCast<const void*>(addr.getRaw()));
+      msgs[i].msg_hdr.msg_namelen = addr.getRawSize();
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int n;
+    ZC_NONBLOCKING_SYSCALL(n = sendmmsg(fd, msgs.begin(), count, 0));
+    if (n < 0) {
+      // Write buffer full.
+      return observer.whenBecomesWritable().then(
+          [this, datagrams]() { return sendBatch(datagrams); });
+    }
+
+    // If fewer messages were sent than asked, the next call either sends more or reports why not.
+    datagrams = datagrams.slice(n);
+  }
+
+  return READY_NOW;
+}
+
+class DatagramPortImpl::BatchReceiverImpl final : public DatagramBatchReceiver {
+public:
+  BatchReceiverImpl(DatagramPortImpl& port, size_t batchSize, DatagramReceiver::Capacity capacity)
+      : port(port),
+        capacity(capacity),
+        contentBuffer(heapArray<byte>(batchSize * capacity.content)),
+        ancillaryBuffer(heapArray<byte>(batchSize * capacity.ancillary)),
+        slots(heapArray<Slot>(batchSize)),
+        msgs(heapArray<struct mmsghdr>(batchSize)),
+        received(batchSize) {
+    ZC_REQUIRE(batchSize > 0, "batch size must be positive");
+  }
+
+  Promise<void> receive() override {
+    // The kernel overwrites the lengths and flags, so set the headers up anew each time.
+    memset(msgs.begin(), 0, msgs.size() * sizeof(msgs[0]));
+    for (size_t i : zc::indices(slots)) {
+      auto& slot = slots[i];
+      slot.iov.iov_base = contentBuffer.begin() + i * capacity.content;
+      slot.iov.iov_len = capacity.content;
+
+      auto& msg = msgs[i].msg_hdr;
+      msg.msg_name = &slot.addr;
+      msg.msg_namelen = sizeof(slot.addr);
+      msg.msg_iov = &slot.iov;
+      msg.msg_iovlen = 1;
+      if (capacity.ancillary > 0) {
+        msg.msg_control = ancillaryBuffer.begin() + i * capacity.ancillary;
+        msg.msg_controllen = capacity.ancillary;
+      }
+    }
+
+    int n;
+    ZC_NONBLOCKING_SYSCALL(n = recvmmsg(port.fd, msgs.begin(), msgs.size(), 0, nullptr));
+
+    if (n < 0) {
+      // No data available. Wait.
+      return port.observer.whenBecomesReadable().then([this]() { return receive(); });
+    }
+
+    received.resize(0);
+    for (size_t i : zc::zeroTo(n)) {
+      auto& msg = msgs[i].msg_hdr;
+      if (!port.filter.shouldAllow(reinterpret_cast<const struct sockaddr*>(msg.msg_name),
+                                   msg.msg_namelen)) {
+        // Ignore message from disallowed source.
+        continue;
+      }
+
+      auto& slot = slots[i];
+      slot.receivedSize = msgs[i].msg_len;
+      slot.contentTruncated = msg.msg_flags & MSG_TRUNC;
+      slot.addrlen = msg.msg_namelen;
+      slot.source = zc::none;
+
+      slot.ancillaryTruncated = msg.msg_flags & MSG_CTRUNC;
+      parseAncillary(msg, ancillaryBuffer.slice(i * capacity.ancillary).first(capacity.ancillary),
+                     slot.ancillaryList);
 
-    SocketAddress raw;
-    NetworkAddressImpl abstract;
+      received.add(i);
+    }
+
+    if (received.empty()) { return receive(); }
+    return READY_NOW;
+  }
+
+  size_t size() override { return received.size(); }
+
+  DatagramReceiver::MaybeTruncated<ArrayPtr<const byte>> getContent(size_t i) override {
+    auto& slot = getSlot(i);
+    return {arrayPtr(reinterpret_cast<const byte*>(slot.iov.iov_base), slot.receivedSize),
+            slot.contentTruncated};
+  }
+
+  DatagramReceiver::MaybeTruncated<ArrayPtr<const AncillaryMessage>> getAncillary(
+      size_t i) override {
+    auto& slot = getSlot(i);
+    return {slot.ancillaryList.asPtr(), slot.ancillaryTruncated};
+  }
+
+  NetworkAddress& getSource(size_t i) override {
+    // Most receivers never look at most sources, so they're only made into addresses on demand.
+    auto& slot = getSlot(i);
+    ZC_IF_SOME(source, slot.source) { return source.abstract; }
+    return slot.source.emplace(port.lowLevel, port.filter, &slot.addr, slot.addrlen).abstract;
+  }
+
+private:
+  struct Slot {
+    struct sockaddr_storage addr;
+    socklen_t addrlen = 0;
+    struct iovec iov;
+    size_t receivedSize = 0;
+    bool contentTruncated = false;
+    bool ancillaryTruncated = false;
+    Vector<AncillaryMessage> ancillaryList;
+    zc::Maybe<StoredDatagramSource> source;
   };
 
-  zc::Maybe<StoredAddress> source;
+  DatagramPortImpl& port;
+  DatagramReceiver::Capacity capacity;
+  Array<byte> contentBuffer;
+  Array<byte> ancillaryBuffer;
+  Array<Slot> slots;
+  Array<struct mmsghdr> msgs;
+  Vector<size_t> received;
+  // Indices of the slots holding this batch's messages, leaving out those from blocked sources.
+
+  Slot& getSlot(size_t i) {
+    ZC_REQUIRE(i < received.size(), "message index out of range");
+    return slots[received[i]];
+  }
 };
 
-Own<DatagramReceiver> DatagramPortImpl::makeReceiver(DatagramReceiver::Capacity capacity) {
-  return zc::heap<ReceiverImpl>(*this, capacity);
+Own<DatagramBatchReceiver> DatagramPortImpl::makeBatchReceiver(
+    size_t batchSize, DatagramReceiver::Capacity capacity) {
+  return zc::heap<BatchReceiverImpl>(*this, batchSize, capacity);
 }
 
+#endif  // __linux__
+
 // =======================================================================================
 
 class AsyncIoProviderImpl final : public AsyncIoProvider {
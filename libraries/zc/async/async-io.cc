@@ -25,12 +25,14 @@
 #endif
 
 #include <deque>
+#include <thread>
 
 #include "zc/async/async-io-internal.h"
 #include "zc/async/async-io.h"
 #include "zc/core/debug.h"
 #include "zc/core/filesystem.h"
 #include "zc/core/io.h"
+#include "zc/core/mutex.h"
 #include "zc/core/one-of.h"
 #include "zc/core/vector.h"
 
@@ -52,6 +54,10 @@
 #include <unistd.h>
 #endif
 
+#if __linux__
+#include <sched.h>
+#endif
+
 namespace zc {
 
 Promise<size_t> AsyncInputStream::read(ArrayPtr<byte> buffer, size_t minBytes) {
@@ -145,40 +151,87 @@ public:
   AllReader(AsyncInputStream& input) : input(input) {}
 
   Promise<Array<byte>> readAllBytes(uint64_t limit) {
-    return loop(limit).then([this, limit](uint64_t headroom) {
-      auto out = heapArray<byte>(limit - headroom);
+    return readAll(limit).then([this]() {
+      if (parts.size() == 1 && parts[0].size() <= total + 1) {
+        // Read into a part of the right size up front, so no copy is needed.
+        auto& part = parts[0];
+        return part.first(total).attach(zc::mv(part));
+      }
+      auto out = heapArray<byte>(total);
       copyInto(out);
       return out;
     });
   }
 
   Promise<String> readAllText(uint64_t limit) {
-    return loop(limit).then([this, limit](uint64_t headroom) {
-      auto out = heapArray<char>(limit - headroom + 1);
-      copyInto(out.first(out.size() - 1).asBytes());
+    return readAll(limit).then([this]() {
+      if (parts.size() == 1 && parts[0].size() == total + 1) {
+        // The byte left over from the check for EOF holds the NUL terminator.
+        parts[0][total] = '\0';
+        return String(parts[0].releaseAsChars());
+      }
+      auto out = heapArray<char>(total + 1);
+      copyInto(out.first(total).asBytes());
       out.back() = '\0';
       return String(zc::mv(out));
     });
   }
 
+  Promise<Array<Array<byte>>> readAllChunks(uint64_t limit) {
+    return readAll(limit).then([this]() {
+      // Only the last part can be partly filled.
+      if (lastAmount == 0) {
+        parts.removeLast();
+      } else {
+        auto last = zc::mv(parts.back());
+        parts.back() = last.first(lastAmount).attach(zc::mv(last));
+      }
+      return parts.releaseAsArray();
+    });
+  }
+
 private:
+  static constexpr size_t MIN_PART_SIZE = 4096;
+  static constexpr size_t MAX_PART_SIZE = 65536;
+  static constexpr uint64_t MAX_PREALLOCATION = 16 << 20;
+  // A stream's length comes from e.g. a Content-Length header the peer sent, so don't allocate
+  // arbitrarily much on its say-so before the bytes actually arrive.
+
   AsyncInputStream& input;
   Vector<Array<byte>> parts;
+  uint64_t total = 0;
+  size_t lastAmount = 0;
+  size_t nextPartSize = MIN_PART_SIZE;
+
+  Promise<void> readAll(uint64_t limit) {
+    ZC_IF_SOME(length, input.tryGetLength()) {
+      ZC_REQUIRE(length < limit, "Reached limit before EOF.");
+
+      // Leave a byte over so that the same read sees EOF.
+      return loop(limit, zc::min(length + 1, MAX_PREALLOCATION));
+    }
+    return loop(limit, takePartSize());
+  }
 
-  Promise<uint64_t> loop(uint64_t limit) {
+  size_t takePartSize() {
+    // Grow the parts as the stream goes on, so that long ones don't take a read per page.
+    auto result = nextPartSize;
+    nextPartSize = zc::min(nextPartSize * 2, MAX_PART_SIZE);
+    return result;
+  }
+
+  Promise<void> loop(uint64_t limit, uint64_t partSize) {
     ZC_REQUIRE(limit > 0, "Reached limit before EOF.");
 
-    auto part = heapArray<byte>(zc::min(4096, limit));
+    auto part = heapArray<byte>(zc::min(partSize, limit));
     auto partPtr = part.asPtr();
     parts.add(zc::mv(part));
     return input.tryRead(partPtr.begin(), partPtr.size(), partPtr.size())
-        .then([this, ZC_CPCAP(partPtr), limit](size_t amount) mutable -> Promise<uint64_t> {
-          limit -= amount;
-          if (amount < partPtr.size()) {
-            return limit;
-          } else {
-            return loop(limit);
-          }
+        .then([this, ZC_CPCAP(partPtr), limit](size_t amount) mutable -> Promise<void> {
+          total += amount;
+          lastAmount = amount;
+          if (amount < partPtr.size()) { return READY_NOW; }
+          return loop(limit - amount, takePartSize());
         });
   }
 
@@ -206,6 +259,27 @@ Promise<String> AsyncInputStream::readAllText(uint64_t limit) {
   return promise.attach(zc::mv(reader));
 }
 
+Promise<Array<Array<byte>>> AsyncInputStream::readAllChunks(uint64_t limit) {
+  auto reader = zc::heap<AllReader>(*this);
+  auto promise = reader->readAllChunks(limit);
+  return promise.attach(zc::mv(reader));
+}
+
+Promise<size_t> AsyncInputStream::readAllInto(ArrayPtr<byte> buffer) {
+  return tryRead(buffer.begin(), buffer.size(), buffer.size())
+      .then([this, buffer](size_t amount) -> Promise<size_t> {
+        if (amount < buffer.size()) { return amount; }
+
+        // The buffer is full, so it's only big enough if the stream ends here.
+        auto extra = heap<byte>(0);
+        auto promise = tryRead(extra.get(), 1, 1);
+        return promise.attach(zc::mv(extra)).then([amount](size_t more) {
+          ZC_REQUIRE(more == 0, "Reached limit before EOF.");
+          return amount;
+        });
+      });
+}
+
 Maybe<Promise<uint64_t>> AsyncOutputStream::tryPumpFrom(AsyncInputStream& input, uint64_t amount) {
   return zc::none;
 }
@@ -1691,6 +1765,253 @@ CapabilityPipe newCapabilityPipe() {
 
 namespace {
 
+class BufferedPipe final : public Refcounted {
+  // One direction of a buffered pipe. Unlike AsyncPipe, a write never waits for a read: it copies
+  // its data into `chunks` and only holds off completing while the buffer is over the high
+  // watermark.
+
+public:
+  explicit BufferedPipe(BufferedPipeOptions options) : options(options) {
+    ZC_REQUIRE(options.lowWatermark <= options.highWatermark,
+               "low watermark can't be above high watermark");
+  }
+
+  Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) {
+    ZC_REQUIRE(pendingRead == zc::none, "already reading");
+    ZC_REQUIRE(!readAborted, "abortRead() has been called");
+
+    auto bytes = arrayPtr(reinterpret_cast<byte*>(buffer), maxBytes);
+    if (queued >= minBytes || writeEnded) { return consume(bytes); }
+    return newAdaptedPromise<size_t, BlockedRead>(*this, bytes, minBytes);
+  }
+
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) {
+    ZC_REQUIRE(!writeEnded, "shutdownWrite() has been called");
+    if (readAborted) {
+      return ZC_EXCEPTION(DISCONNECTED, "abortRead() has been called");
+    }
+
+    size_t size = 0;
+    for (auto piece : pieces) { size += piece.size(); }
+    if (size == 0) { return READY_NOW; }
+
+    auto chunk = heapArray<byte>(size);
+    byte* pos = chunk.begin();
+    for (auto piece : pieces) {
+      if (piece.size() > 0) {
+        memcpy(pos, piece.begin(), piece.size());
+        pos += piece.size();
+      }
+    }
+    chunks.push_back(zc::mv(chunk));
+    queued += size;
+
+    ZC_IF_SOME(read, pendingRead) { read.tryFulfill(); }
+
+    if (queued <= options.highWatermark) { return READY_NOW; }
+    return whenWritable();
+  }
+
+  Promise<void> whenWritable() {
+    if (readAborted) {
+      return ZC_EXCEPTION(DISCONNECTED, "abortRead() has been called");
+    }
+    if (isWritable()) { return READY_NOW; }
+    auto paf = newPromiseAndFulfiller<void>();
+    writableWaiters.add(zc::mv(paf.fulfiller));
+    return zc::mv(paf.promise);
+  }
+
+  Promise<void> whenWriteDisconnected() {
+    if (readAborted) { return READY_NOW; }
+    auto paf = newPromiseAndFulfiller<void>();
+    disconnectWaiters.add(zc::mv(paf.fulfiller));
+    return zc::mv(paf.promise);
+  }
+
+  uint64_t getQueuedBytes() { return queued; }
+
+  void shutdownWrite() {
+    writeEnded = true;
+    ZC_IF_SOME(read, pendingRead) { read.tryFulfill(); }
+  }
+
+  void abortRead() {
+    readAborted = true;
+    chunks.clear();
+    queued = 0;
+    for (auto& waiter : writableWaiters) {
+      waiter->reject(ZC_EXCEPTION(DISCONNECTED, "abortRead() has been called"));
+    }
+    writableWaiters.clear();
+    for (auto& waiter : disconnectWaiters) { waiter->fulfill(); }
+    disconnectWaiters.clear();
+  }
+
+private:
+  class BlockedRead {
+  public:
+    BlockedRead(PromiseFulfiller<size_t>& fulfiller, BufferedPipe& pipe, ArrayPtr<byte> buffer,
+                size_t minBytes)
+        : fulfiller(fulfiller), pipe(pipe), buffer(buffer), minBytes(minBytes) {
+      pipe.pendingRead = *this;
+
+      // The writer may be waiting for the buffer to drain, which it won't until it's written more.
+      pipe.wakeWritersIfWritable();
+    }
+
+    ~BlockedRead() noexcept(false) {
+      ZC_IF_SOME(read, pipe.pendingRead) {
+        if (&read == this) { pipe.pendingRead = zc::none; }
+      }
+    }
+
+    void tryFulfill() {
+      // Reads are only ever completed whole, so that canceling one loses no data.
+      if (pipe.queued >= minBytes || pipe.writeEnded) {
+        pipe.pendingRead = zc::none;
+        fulfiller.fulfill(pipe.consume(buffer));
+      }
+    }
+
+  private:
+    PromiseFulfiller<size_t>& fulfiller;
+    BufferedPipe& pipe;
+    ArrayPtr<byte> buffer;
+    size_t minBytes;
+  };
+
+  BufferedPipeOptions options;
+  std::deque<Array<byte>> chunks;
+  size_t frontOffset = 0;
+  // Bytes of `chunks.front()` already read.
+  uint64_t queued = 0;
+
+  bool writeEnded = false;
+  bool readAborted = false;
+  Maybe<BlockedRead&> pendingRead;
+  Vector<Own<PromiseFulfiller<void>>> writableWaiters;
+  Vector<Own<PromiseFulfiller<void>>> disconnectWaiters;
+
+  bool isWritable() { return queued <= options.lowWatermark || pendingRead != zc::none; }
+
+  void wakeWritersIfWritable() {
+    if (writableWaiters.empty() || !isWritable()) { return; }
+    for (auto& waiter : writableWaiters) { waiter->fulfill(); }
+    writableWaiters.clear();
+  }
+
+  size_t consume(ArrayPtr<byte> buffer) {
+    size_t amount = 0;
+    while (amount < buffer.size() && !chunks.empty()) {
+      auto& front = chunks.front();
+      size_t n = zc::min(front.size() - frontOffset, buffer.size() - amount);
+      memcpy(buffer.begin() + amount, front.begin() + frontOffset, n);
+      amount += n;
+      frontOffset += n;
+      if (frontOffset == front.size()) {
+        chunks.pop_front();
+        frontOffset = 0;
+      }
+    }
+    queued -= amount;
+    wakeWritersIfWritable();
+    return amount;
+  }
+};
+
+class BufferedPipeReadEnd final : public AsyncInputStream {
+public:
+  BufferedPipeReadEnd(Own<BufferedPipe> pipe) : pipe(zc::mv(pipe)) {}
+  ~BufferedPipeReadEnd() noexcept(false) {
+    unwind.catchExceptionsIfUnwinding([&]() { pipe->abortRead(); });
+  }
+
+  Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    return pipe->tryRead(buffer, minBytes, maxBytes);
+  }
+
+private:
+  Own<BufferedPipe> pipe;
+  UnwindDetector unwind;
+};
+
+class BufferedPipeWriteEnd final : public AsyncBufferedOutputStream {
+public:
+  BufferedPipeWriteEnd(Own<BufferedPipe> pipe) : pipe(zc::mv(pipe)) {}
+  ~BufferedPipeWriteEnd() noexcept(false) {
+    unwind.catchExceptionsIfUnwinding([&]() { pipe->shutdownWrite(); });
+  }
+
+  Promise<void> write(ArrayPtr<const byte> buffer) override {
+    return pipe->write(arrayPtr(&buffer, 1));
+  }
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override {
+    return pipe->write(pieces);
+  }
+  Promise<void> whenWriteDisconnected() override { return pipe->whenWriteDisconnected(); }
+
+  uint64_t getQueuedBytes() override { return pipe->getQueuedBytes(); }
+  Promise<void> whenWritable() override { return pipe->whenWritable(); }
+
+private:
+  Own<BufferedPipe> pipe;
+  UnwindDetector unwind;
+};
+
+class BufferedTwoWayPipeEnd final : public AsyncBufferedIoStream {
+public:
+  BufferedTwoWayPipeEnd(Own<BufferedPipe> in, Own<BufferedPipe> out)
+      : in(zc::mv(in)), out(zc::mv(out)) {}
+  ~BufferedTwoWayPipeEnd() noexcept(false) {
+    unwind.catchExceptionsIfUnwinding([&]() {
+      out->shutdownWrite();
+      in->abortRead();
+    });
+  }
+
+  Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    return in->tryRead(buffer, minBytes, maxBytes);
+  }
+  void abortRead() override { in->abortRead(); }
+
+  Promise<void> write(ArrayPtr<const byte> buffer) override {
+    return out->write(arrayPtr(&buffer, 1));
+  }
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override {
+    return out->write(pieces);
+  }
+  Promise<void> whenWriteDisconnected() override { return out->whenWriteDisconnected(); }
+  void shutdownWrite() override { out->shutdownWrite(); }
+
+  uint64_t getQueuedBytes() override { return out->getQueuedBytes(); }
+  Promise<void> whenWritable() override { return out->whenWritable(); }
+
+private:
+  Own<BufferedPipe> in;
+  Own<BufferedPipe> out;
+  UnwindDetector unwind;
+};
+
+}  // namespace
+
+BufferedOneWayPipe newBufferedOneWayPipe(BufferedPipeOptions options) {
+  auto impl = zc::refcounted<BufferedPipe>(options);
+  auto readEnd = zc::heap<BufferedPipeReadEnd>(zc::addRef(*impl));
+  auto writeEnd = zc::heap<BufferedPipeWriteEnd>(zc::mv(impl));
+  return {zc::mv(readEnd), zc::mv(writeEnd)};
+}
+
+BufferedTwoWayPipe newBufferedTwoWayPipe(BufferedPipeOptions options) {
+  auto pipe1 = zc::refcounted<BufferedPipe>(options);
+  auto pipe2 = zc::refcounted<BufferedPipe>(options);
+  auto end1 = zc::heap<BufferedTwoWayPipeEnd>(zc::addRef(*pipe1), zc::addRef(*pipe2));
+  auto end2 = zc::heap<BufferedTwoWayPipeEnd>(zc::mv(pipe2), zc::mv(pipe1));
+  return {{zc::mv(end1), zc::mv(end2)}};
+}
+
+namespace {
+
 class AsyncTee final : public Refcounted {
   class Buffer {
   public:
@@ -2596,9 +2917,65 @@ void DatagramPort::getsockopt(int level, int option, void* value, uint* length)
 void DatagramPort::setsockopt(int level, int option, const void* value, uint length) {
   ZC_UNIMPLEMENTED("Not a socket.") { break; }
 }
+
+namespace {
+
+Promise<void> sendEach(DatagramPort& port,
+                       ArrayPtr<const DatagramPort::OutgoingDatagram> datagrams) {
+  if (datagrams.size() == 0) { return READY_NOW; }
+  return port.send(datagrams[0].content, datagrams[0].destination)
+      .then([&port, datagrams](size_t) { return sendEach(port, datagrams.slice(1)); });
+}
+
+class SingleDatagramBatchReceiver final : public DatagramBatchReceiver {
+  // The default DatagramBatchReceiver, for ports that can only receive one message at a time.
+
+public:
+  explicit SingleDatagramBatchReceiver(Own<DatagramReceiver> inner) : inner(zc::mv(inner)) {}
+
+  Promise<void> receive() override { return inner->receive(); }
+
+  size_t size() override { return 1; }
+
+  DatagramReceiver::MaybeTruncated<ArrayPtr<const byte>> getContent(size_t i) override {
+    ZC_REQUIRE(i == 0, "message index out of range");
+    return inner->getContent();
+  }
+
+  DatagramReceiver::MaybeTruncated<ArrayPtr<const AncillaryMessage>> getAncillary(
+      size_t i) override {
+    ZC_REQUIRE(i == 0, "message index out of range");
+    return inner->getAncillary();
+  }
+
+  NetworkAddress& getSource(size_t i) override {
+    ZC_REQUIRE(i == 0, "message index out of range");
+    return inner->getSource();
+  }
+
+private:
+  Own<DatagramReceiver> inner;
+};
+
+}  // namespace
+
+Promise<void> DatagramPort::sendBatch(ArrayPtr<const OutgoingDatagram> datagrams) {
+  return sendEach(*this, datagrams);
+}
+
+Own<DatagramBatchReceiver> DatagramPort::makeBatchReceiver(size_t batchSize,
+                                                           DatagramReceiver::Capacity capacity) {
+  return heap<SingleDatagramBatchReceiver>(makeReceiver(capacity));
+}
 Own<DatagramPort> NetworkAddress::bindDatagramPort() {
   ZC_UNIMPLEMENTED("Datagram sockets not implemented.");
 }
+Own<ConnectionReceiver> NetworkAddress::listenShared() {
+  ZC_UNIMPLEMENTED("Shared listening not implemented.");
+}
+Own<Network> Network::withConnectionAttemptDelay(Duration delay) {
+  ZC_UNIMPLEMENTED("Connection attempt delay not implemented.");
+}
 Own<DatagramPort> LowLevelAsyncIoProvider::wrapDatagramSocketFd(
     Fd fd, LowLevelAsyncIoProvider::NetworkFilter& filter, uint flags) {
   ZC_UNIMPLEMENTED("Datagram sockets not implemented.");
@@ -3045,17 +3422,13 @@ bool NetworkFilter::shouldAllow(const struct sockaddr* addr, uint addrlen) {
     }
   }
 
-  for (auto& cidr : allowCidrs) {
-    if (cidr.matches(addr)) {
-      allowSpecificity = zc::max(allowSpecificity, cidr.getSpecificity());
-      allowed = true;
-    }
+  ZC_IF_SOME(specificity, allowCidrs.findLongestMatch(addr)) {
+    allowSpecificity = specificity;
+    allowed = true;
   }
   if (!allowed) return false;
-  for (auto& cidr : denyCidrs) {
-    if (cidr.matches(addr)) {
-      if (cidr.getSpecificity() >= allowSpecificity) return false;
-    }
+  ZC_IF_SOME(specificity, denyCidrs.findLongestMatch(addr)) {
+    if (specificity >= allowSpecificity) return false;
   }
 
   ZC_IF_SOME(n, next) { return n.shouldAllow(addr, addrlen); }
@@ -3078,9 +3451,7 @@ bool NetworkFilter::shouldAllowParse(const struct sockaddr* addr, uint addrlen)
         (allowPublic || allowNetwork)) {
       matched = true;
     }
-    for (auto& cidr : allowCidrs) {
-      if (cidr.matchesFamily(addr->sa_family)) { matched = true; }
-    }
+    if (allowCidrs.matchesFamily(addr->sa_family)) { matched = true; }
 #if !_WIN32
   }
 #endif
@@ -3166,4 +3537,149 @@ Promise<AuthenticatedStream> NetworkAddress::connectAuthenticated() {
   });
 }
 
+// =======================================================================================
+
+struct EventLoopGroup::Shared {
+  Shared(StringPtr address, uint portHint,
+         Function<Promise<void>(AsyncIoContext&, ConnectionReceiver&)> serve, uint threadCount)
+      : address(heapString(address)),
+        portHint(portHint),
+        serve(zc::mv(serve)),
+        threadCount(threadCount) {}
+
+  const String address;
+  const uint portHint;
+  Function<Promise<void>(AsyncIoContext&, ConnectionReceiver&)> serve;
+  const uint threadCount;
+
+  struct State {
+    Maybe<uint> port;
+    // Set once the first thread is listening; the rest listen on the same port.
+
+    uint listening = 0;
+    Maybe<Exception> error;
+    // The first failure to start listening.
+
+    bool stopping = false;
+    Vector<Own<CrossThreadPromiseFulfiller<void>>> stoppers;
+  };
+  MutexGuarded<State> state;
+
+  void run(uint index, bool pin);
+  void stop() const;
+};
+
+namespace {
+
+#if __linux__
+void pinToCpu(uint index) {
+  // Count only the CPUs we're allowed on, which in a container may be fewer than the machine has.
+  cpu_set_t allowed;
+  ZC_SYSCALL(sched_getaffinity(0, sizeof(allowed), &allowed));
+  uint count = CPU_COUNT(&allowed);
+  if (count == 0) return;
+
+  uint target = index % count;
+  for (uint cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (CPU_ISSET(cpu, &allowed) && target-- == 0) {
+      cpu_set_t set;
+      CPU_ZERO(&set);
+      CPU_SET(cpu, &set);
+      ZC_SYSCALL(sched_setaffinity(0, sizeof(set), &set));
+      return;
+    }
+  }
+}
+#endif
+
+}  // namespace
+
+void EventLoopGroup::Shared::run(uint index, bool pin) {
+#if __linux__
+  if (pin) pinToCpu(index);
+#endif
+
+  auto io = setupAsyncIo();
+  Own<ConnectionReceiver> listener;
+  auto paf = newPromiseAndCrossThreadFulfiller<void>();
+
+  ZC_IF_SOME(exception, runCatchingExceptions([&]() {
+               uint port = portHint;
+               if (index > 0) {
+                 auto lock = state.lockExclusive();
+                 lock.wait(
+                     [](const State& s) { return s.port != zc::none || s.error != zc::none; });
+                 ZC_IF_SOME(p, lock->port) { port = p; }
+                 else { return; }
+               }
+
+               listener = io.provider->getNetwork()
+                              .parseAddress(address, port)
+                              .wait(io.waitScope)
+                              ->listenShared();
+             })) {
+    auto lock = state.lockExclusive();
+    if (lock->error == zc::none) lock->error = zc::mv(exception);
+    return;
+  }
+  if (listener.get() == nullptr) return;
+
+  {
+    auto lock = state.lockExclusive();
+    if (index == 0) lock->port = listener->getPort();
+    if (lock->stopping) return;
+    lock->stoppers.add(zc::mv(paf.fulfiller));
+    ++lock->listening;
+  }
+
+  serve(io, *listener).exclusiveJoin(zc::mv(paf.promise)).wait(io.waitScope);
+}
+
+void EventLoopGroup::Shared::stop() const {
+  auto lock = state.lockExclusive();
+  lock->stopping = true;
+  for (auto& stopper : lock->stoppers) stopper->fulfill();
+  lock->stoppers.clear();
+}
+
+EventLoopGroup::EventLoopGroup(StringPtr address, uint portHint,
+                               Function<Promise<void>(AsyncIoContext&, ConnectionReceiver&)> serve,
+                               Options options) {
+  uint count = options.threadCount;
+  if (count == 0) count = zc::max(std::thread::hardware_concurrency(), 1u);
+  shared = heap<Shared>(address, portHint, zc::mv(serve), count);
+
+  auto builder = heapArrayBuilder<Own<Thread>>(count);
+  for (uint i = 0; i < count; i++) {
+    // Threads only use `Shared`, so that they needn't outlive a constructor that throws.
+    builder.add(heap<Thread>(
+        [&shared = *shared, i, pin = options.pinThreads]() { shared.run(i, pin); }));
+  }
+  threads = builder.finish();
+
+  bool failed;
+  {
+    auto lock = shared->state.lockExclusive();
+    lock.wait(
+        [count](const Shared::State& s) { return s.listening == count || s.error != zc::none; });
+    failed = lock->error != zc::none;
+    ZC_IF_SOME(p, lock->port) { port = p; }
+  }
+
+  if (failed) {
+    // Threads still starting up are watching `error`, so leave it in place until they're gone.
+    shared->stop();
+    threads = nullptr;
+    auto lock = shared->state.lockExclusive();
+    throwFatalException(zc::mv(ZC_ASSERT_NONNULL(lock->error)));
+  }
+}
+
+EventLoopGroup::~EventLoopGroup() noexcept(false) {
+  shared->stop();
+  threads = nullptr;
+}
+
+void EventLoopGroup::stop() const { shared->stop(); }
+
 }  // namespace zc
@@ -96,6 +96,18 @@ public:
   //
   // To prevent runaway memory allocation, consider using a more conservative value for `limit` than
   // the default, particularly on untrusted data streams which may never see EOF.
+  //
+  // If tryGetLength() knows the size, the data is read straight into a buffer of that size, which
+  // is then returned without copying.
+
+  Promise<Array<Array<byte>>> readAllChunks(uint64_t limit = zc::maxValue);
+  // Like readAllBytes(), but returns the data in the chunks it was read into, saving the copy into
+  // one array. Useful for large bodies that are going to be fed to a streaming parser or written
+  // out again anyway. The chunks are never empty.
+
+  Promise<size_t> readAllInto(ArrayPtr<byte> buffer);
+  // Read until EOF into `buffer`, returning the number of bytes read. Throws an exception if the
+  // stream has more data than fits in `buffer`.
 
   virtual void registerAncillaryMessageHandler(Function<void(ArrayPtr<AncillaryMessage>)> fn);
   // Register interest in checking for ancillary messages (aka control messages) when reading.
@@ -335,6 +347,55 @@ CapabilityPipe newCapabilityPipe();
 // This implementation does not know how to convert streams to FDs or vice versa; if you write FDs
 // you must read FDs, and if you write streams you must read streams.
 
+struct BufferedPipeOptions {
+  uint64_t highWatermark = 65536;
+  // Writes complete as soon as their data is buffered, until the buffer holds more than this.
+  // The write that crosses the mark is still buffered in full, but doesn't complete until the
+  // buffer has drained to `lowWatermark`.
+
+  uint64_t lowWatermark = 16384;
+  // Must be at most `highWatermark`.
+};
+
+class AsyncBufferedOutputStream : public AsyncOutputStream {
+  // The output end of a buffered pipe, which also lets a producer see how far ahead of the
+  // consumer it is, to batch or throttle its writes rather than build up a queue of its own.
+
+public:
+  virtual uint64_t getQueuedBytes() = 0;
+  // Bytes written that haven't been read yet.
+
+  virtual Promise<void> whenWritable() = 0;
+  // Resolves once the buffer has drained to the low watermark, or while a read is waiting for
+  // more data than is buffered. Rejects with DISCONNECTED if the read end goes away. Unlike
+  // write(), may be called any number of times at once.
+};
+
+class AsyncBufferedIoStream : public AsyncIoStream {
+  // Like AsyncBufferedOutputStream, for buffered two-way pipes.
+
+public:
+  virtual uint64_t getQueuedBytes() = 0;
+  virtual Promise<void> whenWritable() = 0;
+};
+
+struct BufferedOneWayPipe {
+  Own<AsyncInputStream> in;
+  Own<AsyncBufferedOutputStream> out;
+};
+
+BufferedOneWayPipe newBufferedOneWayPipe(BufferedPipeOptions options = {});
+// Like newOneWayPipe(), but writes copy their data into a buffer and complete without waiting for
+// a read, until the buffer passes the high watermark. A read completes as soon as the buffer holds
+// `minBytes`.
+
+struct BufferedTwoWayPipe {
+  Own<AsyncBufferedIoStream> ends[2];
+};
+
+BufferedTwoWayPipe newBufferedTwoWayPipe(BufferedPipeOptions options = {});
+// Like newTwoWayPipe(), but buffered like newBufferedOneWayPipe() in each direction.
+
 struct Tee {
   // Two AsyncInputStreams which each read the same data from some wrapped inner AsyncInputStream.
 
@@ -570,17 +631,54 @@ public:
   };
 };
 
+class DatagramBatchReceiver {
+  // Like DatagramReceiver, but receives every datagram that is waiting, up to a batch size given
+  // in advance, at once. On Linux a batch takes one recvmmsg() system call, rather than one
+  // recvmsg() per datagram, which is most of what receiving a small datagram costs.
+
+public:
+  virtual Promise<void> receive() = 0;
+  // Receive at least one new message, overwriting this object's content.
+
+  virtual size_t size() = 0;
+  // The number of messages received by the last receive().
+
+  virtual DatagramReceiver::MaybeTruncated<ArrayPtr<const byte>> getContent(size_t i) = 0;
+  virtual DatagramReceiver::MaybeTruncated<ArrayPtr<const AncillaryMessage>> getAncillary(
+      size_t i) = 0;
+  virtual NetworkAddress& getSource(size_t i) = 0;
+  // The same as DatagramReceiver's, for the i'th message of the batch.
+};
+
 class DatagramPort {
 public:
   virtual Promise<size_t> send(ArrayPtr<const byte> buffer, NetworkAddress& destination) = 0;
   virtual Promise<size_t> send(ArrayPtr<const ArrayPtr<const byte>> pieces,
                                NetworkAddress& destination) = 0;
 
+  struct OutgoingDatagram {
+    ArrayPtr<const byte> content;
+    NetworkAddress& destination;
+  };
+
+  virtual Promise<void> sendBatch(ArrayPtr<const OutgoingDatagram> datagrams);
+  // Sends each datagram as send() would, in order, waiting for buffer space as needed. The
+  // datagrams and their content must stay valid until the promise resolves.
+  //
+  // On Linux this takes one sendmmsg() system call per batch that fits in the socket's buffer.
+  // The default implementation calls send() for each datagram in turn.
+
   virtual Own<DatagramReceiver> makeReceiver(
       DatagramReceiver::Capacity capacity = DatagramReceiver::Capacity()) = 0;
   // Create a new `Receiver` that can be used to receive datagrams. `capacity` specifies how much
   // space to allocate for the received message. The `DatagramPort` must outlive the `Receiver`.
 
+  virtual Own<DatagramBatchReceiver> makeBatchReceiver(
+      size_t batchSize, DatagramReceiver::Capacity capacity = DatagramReceiver::Capacity());
+  // Like makeReceiver(), but receives up to `batchSize` messages at a time, each with `capacity`.
+  //
+  // The default implementation receives one message at a time through makeReceiver().
+
   virtual uint getPort() = 0;
   // Gets the port number, if applicable (i.e. if listening on IP).  This is useful if you didn't
   // specify a port when constructing the NetworkAddress -- one will have been assigned
@@ -621,6 +719,14 @@ public:
   //
   // The address must be local.
 
+  virtual Own<ConnectionReceiver> listenShared();
+  // Like listen(), but other receivers may listen on the same address at the same time -- in this
+  // process or another -- and the operating system spreads incoming connections among them. This
+  // is how a server runs one accept loop per thread, each in its own event loop, without handing
+  // connections between threads. Every receiver sharing an address must be created this way.
+  //
+  // On Unix this sets SO_REUSEPORT. The default implementation throws UNIMPLEMENTED.
+
   virtual Own<NetworkAddress> clone() = 0;
   // Returns an equivalent copy of this NetworkAddress.
 
@@ -715,6 +821,20 @@ public:
   // Allows connections to/from 10.*.*.*, with the exception of 10.1.2.* (which is denied), with an
   // exception to the exception of 10.1.2.3 (which is allowed, because it is matched by an allow
   // rule that is more specific than the deny rule).
+
+  virtual Own<Network> withConnectionAttemptDelay(Duration delay);
+  // Constructs a new Network instance wrapping this one whose addresses wait `delay` between
+  // connection attempts, when an address resolves to several and connect() has to try them.
+  //
+  // The standard ZC network on Unix connects the way RFC 8305 ("Happy Eyeballs") describes: it
+  // alternates between IPv6 and IPv4 addresses, starting with the family of the first one
+  // resolved, and starts the next attempt when the last one fails or when `delay` has passed
+  // without it succeeding, whichever comes first. The first connection made wins, and the other
+  // attempts are canceled. This way a dead address -- commonly, a whole address family that
+  // doesn't route -- costs `delay` instead of a full connect timeout. The default delay is the
+  // 250ms that the RFC recommends.
+  //
+  // The default implementation throws UNIMPLEMENTED.
 };
 
 // =======================================================================================
@@ -984,6 +1104,69 @@ AsyncIoContext setupAsyncIo();
 //   note that this means that server processes which daemonize themselves at startup must wait
 //   until after daemonization to create an AsyncIoContext.
 
+class EventLoopGroup {
+  // Runs a server on several threads at once, each with its own event loop and its own receiver
+  // listening on a shared address (see NetworkAddress::listenShared()), so that each thread
+  // accepts and serves connections without ever touching another thread's loop.
+  //
+  // Each thread calls `serve` with its AsyncIoContext and its receiver, and waits on the promise
+  // it returns. For example, with an HttpServer:
+  //
+  //     zc::EventLoopGroup group("*", 8080,
+  //         [&](zc::AsyncIoContext& io, zc::ConnectionReceiver& listener) {
+  //       auto server = zc::heap<zc::HttpServer>(io.provider->getTimer(), headerTable, service);
+  //       auto promise = server->listenHttp(listener);
+  //       return promise.attach(zc::mv(server));
+  //     });
+  //
+  // `serve` is called from all the threads, concurrently, so it and everything it shares between
+  // calls (the header table and service above) must be thread-safe.
+
+public:
+  struct Options {
+    uint threadCount = 0;
+    // Number of threads. Zero means one per CPU.
+
+    bool pinThreads = false;
+    // Whether to pin thread `i` to CPU `i` (modulo the CPU count), so that each loop keeps its
+    // caches and its share of the listening sockets' queues to itself. Linux only; ignored
+    // elsewhere.
+  };
+
+  EventLoopGroup(StringPtr address, uint portHint,
+                 Function<Promise<void>(AsyncIoContext&, ConnectionReceiver&)> serve,
+                 Options options);
+  EventLoopGroup(StringPtr address, uint portHint,
+                 Function<Promise<void>(AsyncIoContext&, ConnectionReceiver&)> serve)
+      : EventLoopGroup(address, portHint, zc::mv(serve), Options()) {}
+  // Starts the threads, and returns once every thread is listening. `address` and `portHint` are
+  // as for Network::parseAddress(). If the address has no port, the first thread's receiver picks
+  // one and the rest listen on the same.
+  //
+  // If any thread fails to start listening, the others are stopped and the exception is thrown.
+
+  ~EventLoopGroup() noexcept(false);
+  // Stops all the threads and waits for them to exit. If `serve`'s promise failed on any thread,
+  // its exception is rethrown from here.
+
+  ZC_DISALLOW_COPY_AND_MOVE(EventLoopGroup);
+
+  uint getPort() const { return port; }
+  // The port that every thread is listening on.
+
+  uint getThreadCount() const { return threads.size(); }
+
+  void stop() const;
+  // Cancels each thread's `serve` promise, in that thread's event loop, which lets the thread
+  // exit. May be called from any thread, including one of the group's own.
+
+private:
+  struct Shared;
+  Own<Shared> shared;
+  Array<Own<Thread>> threads;
+  uint port = 0;
+};
+
 // =======================================================================================
 // Convenience adapters.
 
@@ -42,6 +42,20 @@
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
 #include <sys/timerfd.h>
+
+#if __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+
+#include <atomic>
+#ifdef IORING_ACCEPT_MULTISHOT
+// Headers from Linux 5.19 or later, which has everything UnixEventPort::IoUring uses.
+#define ZC_USE_IO_URING 1
+#endif
+#endif
 #elif ZC_USE_KQUEUE
 #include <fcntl.h>
 #include <sys/event.h>
@@ -559,6 +573,10 @@ bool UnixEventPort::wait() {
   }
 #endif
 
+  // Hand the kernel everything this turn started. Anything that completes right away makes the
+  // ring readable, so the wait below won't block.
+  ZC_IF_SOME(ring, ioUring) { ring->submit(); }
+
   int timeout = timerImpl.timeoutToNextEvent(clock.now(), MILLISECONDS, int(maxValue))
                     .map([](uint64_t t) -> int { return t; })
                     .orDefault(-1);
@@ -648,12 +666,16 @@ bool UnixEventPort::processEpollEvents(struct epoll_event events[], int n) {
       // The purpose of this event is just to wake up the event loop when needed. We'll check the
       // timer queue separately, so we don't need to do anything special in response to this event
       // here.
+    } else if (events[i].data.u64 == 2) {
+      // The io_uring has completions. We collect them below regardless.
     } else {
       FdObserver* observer = reinterpret_cast<FdObserver*>(events[i].data.ptr);
       observer->fire(events[i].events);
     }
   }
 
+  ZC_IF_SOME(ring, ioUring) { ring->reap(); }
+
   timerImpl.advanceTo(clock.now());
 
   return woken;
@@ -708,6 +730,8 @@ bool UnixEventPort::poll() {
     }
   }
 
+  ZC_IF_SOME(ring, ioUring) { ring->submit(); }
+
   struct epoll_event events[16];
   int n;
   ZC_SYSCALL(n = epoll_wait(epollFd, events, zc::size(events), 0));
@@ -721,6 +745,8 @@ void UnixEventPort::preparePollableFdForSleep() {
   ZC_ASSERT(signalHead == nullptr,
             "preparePollableFdForSleep() cannot be used when waiting for signals");
 
+  ZC_IF_SOME(ring, ioUring) { ring->submit(); }
+
   if (runnable) {
     // There is still immediate work in the queue, so force the epoll to be ready immediately. (See
     // comments in setRunnable() regarding using wake() for this.)
@@ -790,6 +816,348 @@ void UnixEventPort::updateNextTimerEvent(zc::Maybe<TimePoint> time) {
 
 zc::TimePoint UnixEventPort::getTimeWhileSleeping() { return clock.now(); }
 
+// =======================================================================================
+// io_uring
+
+Maybe<UnixEventPort::IoUring&> UnixEventPort::getIoUring() {
+  ZC_IF_SOME(ring, ioUring) { return *ring; }
+  return zc::none;
+}
+
+#if ZC_USE_IO_URING
+
+struct UnixEventPort::IoUring::Slot {
+  // Stands for one operation in flight; its address is the operation's user_data. Kept apart from
+  // the Operation so that an operation can outlive it, and reused once the operation is done.
+
+  Operation* op = nullptr;
+  // Null once cancelled.
+
+  uint8_t opcode;
+  bool inUse = false;
+  uint64_t generation = 0;
+  // Counts the times the slot has been released, so that cancelAndWait() can tell when its
+  // operation is over even if the slot is reused right away.
+};
+
+bool UnixEventPort::enableIoUring(uint entries, uint bufferSize) {
+  ZC_REQUIRE(ioUring == zc::none, "enableIoUring() was already called");
+  ZC_REQUIRE(entries > 0 && entries <= 32768 && (entries & (entries - 1)) == 0,
+             "io_uring entries must be a power of two, at most 32768", entries);
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  // Leave room for bursts of multishot results on top of a full submission queue.
+  params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+  params.cq_entries = entries * 4;
+  int fd = syscall(__NR_io_uring_setup, entries, &params);
+  if (fd < 0) {
+    // Too old a kernel, or disabled by sysctl or seccomp.
+    return false;
+  }
+  OwnFd ownFd(fd);
+  if (!(params.features & IORING_FEAT_NODROP) || !(params.features & IORING_FEAT_FAST_POLL)) {
+    return false;
+  }
+
+  auto ring = heap<IoUring>(zc::mv(ownFd), bufferSize, params);
+  if (!ring->registerBuffers()) return false;
+
+  struct epoll_event event;
+  memset(&event, 0, sizeof(event));
+  event.events = EPOLLIN;
+  event.data.u64 = 2;
+  ZC_SYSCALL(epoll_ctl(epollFd, EPOLL_CTL_ADD, ring->fd, &event));
+
+  ioUring = zc::mv(ring);
+  return true;
+}
+
+namespace {
+
+uint32_t* ringField(void* ring, uint32_t offset) {
+  return reinterpret_cast<uint32_t*>(reinterpret_cast<byte*>(ring) + offset);
+}
+
+void* mapRing(int fd, size_t size, off_t offset) {
+  void* result =
+      mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+  if (result == MAP_FAILED) { ZC_FAIL_SYSCALL("mmap(io_uring)", errno); }
+  return result;
+}
+
+void* mapAnonymous(size_t size) {
+  void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (result == MAP_FAILED) { ZC_FAIL_SYSCALL("mmap(anonymous)", errno); }
+  return result;
+}
+
+}  // namespace
+
+UnixEventPort::IoUring::IoUring(OwnFd fdParam, uint bufferSize,
+                                const struct io_uring_params& params)
+    : fd(zc::mv(fdParam)), entries(params.sq_entries), bufferSize(bufferSize) {
+  sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single) sqRingSize = cqRingSize = zc::max(sqRingSize, cqRingSize);
+
+  sqRing = mapRing(fd, sqRingSize, IORING_OFF_SQ_RING);
+  cqRing = single ? sqRing : mapRing(fd, cqRingSize, IORING_OFF_CQ_RING);
+  sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+  sqes = reinterpret_cast<struct io_uring_sqe*>(mapRing(fd, sqesSize, IORING_OFF_SQES));
+
+  sqHead = ringField(sqRing, params.sq_off.head);
+  sqTail = ringField(sqRing, params.sq_off.tail);
+  sqFlags = ringField(sqRing, params.sq_off.flags);
+  sqMask = *ringField(sqRing, params.sq_off.ring_mask);
+  sqArray = ringField(sqRing, params.sq_off.array);
+  cqHead = ringField(cqRing, params.cq_off.head);
+  cqTail = ringField(cqRing, params.cq_off.tail);
+  cqMask = *ringField(cqRing, params.cq_off.ring_mask);
+  cqes = reinterpret_cast<struct io_uring_cqe*>(reinterpret_cast<byte*>(cqRing) +
+                                                params.cq_off.cqes);
+  tail = *sqTail;
+}
+
+UnixEventPort::IoUring::~IoUring() noexcept(false) {
+  if (inFlight > 0) {
+    // Everything still running was cancelled by its owner, but the kernel may not be done with
+    // it, and may yet receive into our buffers. Make sure it's over before unmapping them.
+    auto& sqe = add(IORING_OP_ASYNC_CANCEL, -1, nullptr);
+    sqe.cancel_flags = IORING_ASYNC_CANCEL_ANY;
+    submit();
+    for (;;) {
+      reap();
+      if (inFlight == 0) break;
+      enter(0, 1, IORING_ENTER_GETEVENTS);
+    }
+  }
+
+  if (buffers != nullptr) munmap(buffers, buffersSize);
+  if (bufRing != nullptr) munmap(bufRing, bufRingSize);
+  munmap(sqes, sqesSize);
+  if (cqRing != sqRing) munmap(cqRing, cqRingSize);
+  munmap(sqRing, sqRingSize);
+}
+
+bool UnixEventPort::IoUring::registerBuffers() {
+  bufRingSize = entries * sizeof(struct io_uring_buf);
+  bufRing = reinterpret_cast<struct io_uring_buf*>(mapAnonymous(bufRingSize));
+  buffersSize = size_t(entries) * bufferSize;
+  buffers = reinterpret_cast<byte*>(mapAnonymous(buffersSize));
+
+  struct io_uring_buf_reg reg;
+  memset(&reg, 0, sizeof(reg));
+  reg.ring_addr = reinterpret_cast<uintptr_t>(bufRing);
+  reg.ring_entries = entries;
+  reg.bgid = 0;
+  if (syscall(__NR_io_uring_register, fd.get(), IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+    return false;
+  }
+
+  for (uint i = 0; i < entries; i++) recycle(i);
+  return true;
+}
+
+struct io_uring_sqe& UnixEventPort::IoUring::add(uint8_t opcode, int fd, Operation* op) {
+  if (tail - std::atomic_ref<uint32_t>(*sqHead).load(std::memory_order_acquire) == entries) {
+    // The submission queue is full. Hand it over now to make room.
+    submit();
+  }
+
+  uint index = tail & sqMask;
+  auto& sqe = sqes[index];
+  memset(&sqe, 0, sizeof(sqe));
+  sqe.opcode = opcode;
+  sqe.fd = fd;
+
+  if (op != nullptr) {
+    ZC_IREQUIRE(op->slot == nullptr, "io_uring operation is already in flight");
+    Slot* slot;
+    if (freeSlots.empty()) {
+      slot = slots.add(heap<Slot>()).get();
+    } else {
+      slot = freeSlots.back();
+      freeSlots.removeLast();
+    }
+    slot->op = op;
+    slot->opcode = opcode;
+    slot->inUse = true;
+    op->slot = slot;
+    ++inFlight;
+    sqe.user_data = reinterpret_cast<uintptr_t>(slot);
+  }
+
+  sqArray[index] = index;
+  ++tail;
+  ++queued;
+  return sqe;
+}
+
+void UnixEventPort::IoUring::submit() {
+  if (queued > 0) enter(queued, 0, 0);
+}
+
+void UnixEventPort::IoUring::enter(uint toSubmit, uint minComplete, uint flags) {
+  std::atomic_ref<uint32_t>(*sqTail).store(tail, std::memory_order_release);
+
+  for (;;) {
+    int n;
+    ZC_SYSCALL_HANDLE_ERRORS(n = syscall(__NR_io_uring_enter, fd.get(), toSubmit, minComplete,
+                                         flags, nullptr, 0)) {
+      case EBUSY:
+      case EAGAIN:
+        // The completion queue is full. Empty it, then try again.
+        reap();
+        continue;
+      default:
+        ZC_FAIL_SYSCALL("io_uring_enter()", error);
+    }
+
+    queued -= n;
+    toSubmit -= n;
+    if (toSubmit == 0) return;
+  }
+}
+
+void UnixEventPort::IoUring::reap() {
+  for (;;) {
+    uint32_t head = *cqHead;
+    if (head == std::atomic_ref<uint32_t>(*cqTail).load(std::memory_order_acquire)) {
+      if (std::atomic_ref<uint32_t>(*sqFlags).load(std::memory_order_relaxed) &
+          IORING_SQ_CQ_OVERFLOW) {
+        // More completions than fit in the queue; the kernel is holding on to the rest.
+        enter(0, 0, IORING_ENTER_GETEVENTS);
+        continue;
+      }
+      return;
+    }
+
+    auto& cqe = cqes[head & cqMask];
+    uint64_t userData = cqe.user_data;
+    int result = cqe.res;
+    uint flags = cqe.flags;
+    std::atomic_ref<uint32_t>(*cqHead).store(head + 1, std::memory_order_release);
+
+    // A zero user_data is a cancellation request's own result.
+    if (userData == 0) continue;
+
+    Slot* slot = reinterpret_cast<Slot*>(userData);
+    Operation* op = slot->op;
+    uint8_t opcode = slot->opcode;
+    if (!(flags & IORING_CQE_F_MORE)) {
+      slot->op = nullptr;
+      slot->inUse = false;
+      ++slot->generation;
+      freeSlots.add(slot);
+      --inFlight;
+      if (op != nullptr) op->slot = nullptr;
+    }
+
+    if (op != nullptr) {
+      op->complete(result, flags);
+    } else {
+      // Cancelled; clean up whatever it produced in the meantime.
+      if (flags & IORING_CQE_F_BUFFER) recycle(flags >> IORING_CQE_BUFFER_SHIFT);
+      if (opcode == IORING_OP_ACCEPT && result >= 0) close(result);
+    }
+  }
+}
+
+void UnixEventPort::IoUring::recv(int fd, Operation& op) {
+  auto& sqe = add(IORING_OP_RECV, fd, &op);
+  sqe.flags = IOSQE_BUFFER_SELECT;
+  sqe.buf_group = 0;
+}
+
+void UnixEventPort::IoUring::pollIn(int fd, Operation& op) {
+  auto& sqe = add(IORING_OP_POLL_ADD, fd, &op);
+  sqe.poll32_events = POLLIN;
+}
+
+void UnixEventPort::IoUring::sendmsg(int fd, const struct msghdr& message, Operation& op) {
+  auto& sqe = add(IORING_OP_SENDMSG, fd, &op);
+  sqe.addr = reinterpret_cast<uintptr_t>(&message);
+  sqe.msg_flags = MSG_NOSIGNAL;
+}
+
+void UnixEventPort::IoUring::acceptMultishot(int fd, Operation& op) {
+  auto& sqe = add(IORING_OP_ACCEPT, fd, &op);
+  sqe.ioprio = IORING_ACCEPT_MULTISHOT;
+  sqe.accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+}
+
+void UnixEventPort::IoUring::cancel(Operation& op) {
+  Slot* slot = op.slot;
+  if (slot == nullptr) return;
+
+  slot->op = nullptr;
+  op.slot = nullptr;
+  auto& sqe = add(IORING_OP_ASYNC_CANCEL, -1, nullptr);
+  sqe.addr = reinterpret_cast<uintptr_t>(slot);
+}
+
+void UnixEventPort::IoUring::cancelAndWait(Operation& op) {
+  Slot* slot = op.slot;
+  if (slot == nullptr) return;
+
+  uint64_t generation = slot->generation;
+  cancel(op);
+  submit();
+  for (;;) {
+    reap();
+    if (slot->generation != generation) return;
+    enter(0, 1, IORING_ENTER_GETEVENTS);
+  }
+}
+
+ArrayPtr<byte> UnixEventPort::IoUring::takeBuffer(uint flags, size_t size) {
+  ZC_IREQUIRE(flags & IORING_CQE_F_BUFFER, "completion has no buffer");
+  uint id = flags >> IORING_CQE_BUFFER_SHIFT;
+  return arrayPtr(buffers + size_t(id) * bufferSize, size);
+}
+
+void UnixEventPort::IoUring::releaseBuffer(ArrayPtr<byte> buffer) {
+  recycle((buffer.begin() - buffers) / bufferSize);
+}
+
+void UnixEventPort::IoUring::recycle(uint id) {
+  // Don't assign the whole entry: the ring's tail overlays the first entry's `resv`.
+  auto& entry = bufRing[bufTail & (entries - 1)];
+  entry.addr = reinterpret_cast<uintptr_t>(buffers + size_t(id) * bufferSize);
+  entry.len = bufferSize;
+  entry.bid = id;
+  ++bufTail;
+  std::atomic_ref<uint16_t>(reinterpret_cast<struct io_uring_buf_ring*>(bufRing)->tail)
+      .store(bufTail, std::memory_order_release);
+}
+
+#else  // ZC_USE_IO_URING
+
+struct UnixEventPort::IoUring::Slot {};
+
+bool UnixEventPort::enableIoUring(uint entries, uint bufferSize) {
+  // Built against kernel headers too old for what IoUring needs.
+  return false;
+}
+
+// Never constructed.
+UnixEventPort::IoUring::IoUring(OwnFd, uint, const struct io_uring_params&) { ZC_UNREACHABLE; }
+UnixEventPort::IoUring::~IoUring() noexcept(false) {}
+void UnixEventPort::IoUring::recv(int, Operation&) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::pollIn(int, Operation&) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::sendmsg(int, const struct msghdr&, Operation&) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::acceptMultishot(int, Operation&) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::cancel(Operation&) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::cancelAndWait(Operation&) { ZC_UNREACHABLE; }
+ArrayPtr<byte> UnixEventPort::IoUring::takeBuffer(uint, size_t) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::releaseBuffer(ArrayPtr<byte>) { ZC_UNREACHABLE; }
+void UnixEventPort::IoUring::submit() {}
+void UnixEventPort::IoUring::reap() {}
+
+#endif  // ZC_USE_IO_URING, else
+
 #elif ZC_USE_KQUEUE
 // =======================================================================================
 // kqueue FdObserver implementation
@@ -1197,6 +1565,8 @@ bool UnixEventPort::doKqueueWait(struct timespec* timeout) {
     }
   }
 
+  ZC_IF_SOME(ring, ioUring) { ring->reap(); }
+
   timerImpl.advanceTo(clock.now());
 
   return woken;
@@ -1621,6 +1991,8 @@ bool UnixEventPort::poll() {
     pollContext.run(0);
     if (pollContext.processResults()) { woken = true; }
   }
+  ZC_IF_SOME(ring, ioUring) { ring->reap(); }
+
   timerImpl.advanceTo(clock.now());
 
   return woken;
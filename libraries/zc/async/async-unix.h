@@ -30,6 +30,7 @@
 #include "zc/async/async.h"
 #include "zc/async/timer.h"
 #include "zc/core/io.h"
+#include "zc/core/vector.h"
 
 ZC_BEGIN_HEADER
 
@@ -57,6 +58,11 @@ ZC_BEGIN_HEADER
 
 #if ZC_USE_EPOLL
 struct epoll_event;
+struct io_uring_params;
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+struct msghdr;
 #elif ZC_USE_KQUEUE
 struct kevent;
 struct timespec;
@@ -231,8 +237,47 @@ public:
   // onSignal() or onChildExit(). Although it might theoretically be possible to support signals in
   // this mode, deep flaws in the relevant APIs across multiple OSs make it likely not worth
   // attempting.
+
+  bool enableIoUring(uint entries = 256, uint bufferSize = 4096);
+  // Has TCP sockets wrapped by this port's LowLevelAsyncIoProvider from now on do their I/O
+  // through a Linux io_uring rather than through epoll readiness followed by read() and write():
+  // streams read with recvs into buffers that the ring provides and write with sendmsgs, and
+  // listen sockets accept with a single multishot accept. Everything the event loop starts during
+  // a turn is submitted to the kernel in one syscall, just before the loop checks for events.
+  //
+  // Unix sockets are left alone, since a recv into a ring buffer would drop any file descriptors
+  // they carry, and a stream doing its reads through the ring can't register an ancillary message
+  // handler. Streams wrapped before the call keep using epoll.
+  //
+  // `entries` is the size of the submission queue and also the number of receive buffers, each
+  // `bufferSize` bytes; it must be a power of two. Returns false, leaving the port as it was, if
+  // the kernel can't do all of this (it needs Linux 5.19) or io_uring is disabled.
+
+  class IoUring;
+  Maybe<IoUring&> getIoUring();
+  // The ring set up by enableIoUring(), if any.
 #endif
 
+  void enableWriteCombining(size_t bufferSize = 16384) { writeCombiningLimit = bufferSize; }
+  // Has streams wrapped by this port's LowLevelAsyncIoProvider from now on combine small writes.
+  // A write that fits in the stream's buffer of `bufferSize` bytes is copied there and completes
+  // at once; everything buffered during a turn of the event loop goes out in one writev() at the
+  // end of the turn, so a caller writing many small pieces one after another (pipelined HTTP
+  // responses, small WebSocket frames) makes one syscall instead of one per piece. A larger write
+  // goes out together with whatever is buffered ahead of it.
+  //
+  // Since buffered writes complete before they reach the kernel, an error writing them is thrown
+  // by the next write instead, and shutdownWrite() waits for them to go out. A stream destroyed
+  // with writes still buffered makes one attempt to write them, and drops what doesn't fit in the
+  // socket's send buffer. Streams doing their I/O through io_uring, and streams wrapped before
+  // the call, don't combine writes.
+  //
+  // A stream that combines writes can't have a TCP ULP attached, so TLS connections over it don't
+  // use kernel TLS (see TlsContext::Options::kernelTls).
+
+  size_t getWriteCombiningLimit() { return writeCombiningLimit; }
+  // The `bufferSize` passed to enableWriteCombining(), or zero.
+
   // implements EventPort ------------------------------------------------------
   bool wait() override;
   bool poll() override;
@@ -248,6 +293,7 @@ private:
 
   const MonotonicClock& clock;
   TimerImpl timerImpl;
+  size_t writeCombiningLimit = 0;
 
 #if !ZC_USE_KQUEUE
   SignalPromiseAdapter* signalHead = nullptr;
@@ -268,6 +314,8 @@ private:
   bool runnable = false;  // Last value passed to setRunnable().
   bool timerfdIsArmed = false;
 
+  Maybe<Own<IoUring>> ioUring;
+
   bool processEpollEvents(struct epoll_event events[], int n);
 #elif ZC_USE_KQUEUE
   OwnFd kqueueFd;
@@ -441,6 +489,118 @@ private:
   friend class UnixEventPort;
 };
 
+#if ZC_USE_EPOLL
+
+class UnixEventPort::IoUring {
+  // Completion-based I/O through the io_uring set up by UnixEventPort::enableIoUring().
+  //
+  // Each operation reports to an `Operation`, whose complete() the event loop calls once the
+  // kernel is done -- or, for a multishot operation, once per result. Operations are queued when
+  // they are started and submitted together the next time the event loop checks for events.
+  //
+  // Receives use buffers belonging to the ring: the kernel picks a free one when data arrives. So
+  // a receive in flight holds on to none of the caller's memory, and can be left running when the
+  // read that started it is cancelled. Operations that do use the caller's memory, like sends,
+  // must be cancelled with cancelAndWait() before that memory goes away.
+
+  struct Slot;
+
+public:
+  class Operation {
+  public:
+    virtual void complete(int result, uint flags) = 0;
+    // `result` is what the equivalent syscall would have returned, or -errno. `flags` are the
+    // completion's IORING_CQE_F_* flags; IORING_CQE_F_MORE means more results will follow.
+
+    bool isInFlight() const { return slot != nullptr; }
+
+  protected:
+    ~Operation() noexcept(false) = default;
+
+  private:
+    Slot* slot = nullptr;
+    friend class IoUring;
+  };
+
+  IoUring(OwnFd fd, uint bufferSize, const struct io_uring_params& params);
+  // Use UnixEventPort::enableIoUring() instead.
+
+  ~IoUring() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(IoUring);
+
+  void recv(int fd, Operation& op);
+  // Receives into one of the ring's buffers. If the result is positive, takeBuffer() returns what
+  // was received, and the caller hands the buffer back with releaseBuffer() once done with it.
+  // Fails with ENOBUFS when every buffer is in use.
+
+  void pollIn(int fd, Operation& op);
+  // Completes when `fd` is readable, for when there's no buffer to receive into.
+
+  void sendmsg(int fd, const struct msghdr& message, Operation& op);
+  // `message`, and everything it points to, must stay valid until the operation completes.
+
+  void acceptMultishot(int fd, Operation& op);
+  // Produces a result for each connection accepted on the listen socket `fd`: a new non-blocking,
+  // close-on-exec file descriptor, or -errno. Runs until cancelled, or until a result comes
+  // without IORING_CQE_F_MORE.
+
+  void cancel(Operation& op);
+  // Detaches `op` from its operation, if any, and asks the kernel to cancel the operation. `op`
+  // won't be called again. Buffers and file descriptors that the operation still produces are
+  // released by the ring.
+
+  void cancelAndWait(Operation& op);
+  // Like cancel(), but also waits until the kernel is done with the operation.
+
+  ArrayPtr<byte> takeBuffer(uint flags, size_t size);
+  void releaseBuffer(ArrayPtr<byte> buffer);
+
+private:
+  OwnFd fd;
+  uint entries;
+  uint queued = 0;
+  uint32_t tail;
+
+  void* sqRing;
+  void* cqRing;
+  size_t sqRingSize;
+  size_t cqRingSize;
+  struct io_uring_sqe* sqes;
+  size_t sqesSize;
+
+  uint32_t* sqHead;
+  uint32_t* sqTail;
+  uint32_t* sqFlags;
+  uint32_t sqMask;
+  uint32_t* sqArray;
+  uint32_t* cqHead;
+  uint32_t* cqTail;
+  uint32_t cqMask;
+  struct io_uring_cqe* cqes;
+
+  struct io_uring_buf* bufRing = nullptr;
+  size_t bufRingSize;
+  byte* buffers = nullptr;
+  size_t buffersSize;
+  uint bufferSize;
+  uint16_t bufTail = 0;
+
+  Vector<Own<Slot>> slots;
+  Vector<Slot*> freeSlots;
+  uint inFlight = 0;
+
+  bool registerBuffers();
+  struct io_uring_sqe& add(uint8_t opcode, int fd, Operation* op);
+  void submit();
+  void reap();
+  void enter(uint toSubmit, uint minComplete, uint flags);
+  void recycle(uint id);
+
+  friend class UnixEventPort;
+};
+
+#endif  // ZC_USE_EPOLL
+
 }  // namespace zc
 
 ZC_END_HEADER
@@ -39,6 +39,9 @@
 #define _XOPEN_SOURCE  // Must be defined to see getcontext() on MacOS.
 #endif
 
+#include <math.h>
+#include <string.h>
+
 #include <atomic>
 #include <deque>
 
@@ -49,6 +52,7 @@
 #include "zc/core/map.h"
 #include "zc/core/mutex.h"
 #include "zc/core/one-of.h"
+#include "zc/core/time.h"
 #include "zc/core/vector.h"
 
 #if __linux__
@@ -494,6 +498,65 @@ private:
 
 }  // namespace _
 
+namespace _ {  // private
+
+#if ZC_PROMISE_ARENA_POOL
+namespace {
+
+struct ArenaFreeList {
+  // Arenas this thread has freed, linked through their first bytes.
+
+  static constexpr uint MAX_ARENAS = 256;
+
+  PromiseArena* head = nullptr;
+  uint count = 0;
+  bool destroyed = false;
+  // Promises destroyed by later thread_local destructors bypass the list.
+
+  ~ArenaFreeList() noexcept {
+    destroyed = true;
+    while (head != nullptr) {
+      PromiseArena* next = *reinterpret_cast<PromiseArena**>(head);
+      delete head;
+      head = next;
+    }
+  }
+};
+
+thread_local ArenaFreeList arenaFreeList;
+
+}  // namespace
+#endif
+
+PromiseArena* PromiseArena::allocate() {
+#if ZC_PROMISE_ARENA_POOL
+  auto& list = arenaFreeList;
+  PromiseArena* arena = list.head;
+  if (arena != nullptr) {
+    list.head = *reinterpret_cast<PromiseArena**>(arena);
+    --list.count;
+    return arena;
+  }
+#endif
+  return new PromiseArena;
+}
+
+void PromiseArena::free(PromiseArena* arena) noexcept {
+  if (arena == nullptr) return;
+#if ZC_PROMISE_ARENA_POOL
+  auto& list = arenaFreeList;
+  if (list.count < ArenaFreeList::MAX_ARENAS && !list.destroyed) {
+    *reinterpret_cast<PromiseArena**>(arena) = list.head;
+    list.head = arena;
+    ++list.count;
+    return;
+  }
+#endif
+  delete arena;
+}
+
+}  // namespace _
+
 #if __linux__
 // TODO(someday): Support core-local freelists on OSs other than Linux. The only tricky part is
 //   finding what to use instead of sched_getcpu() to get the current CPU ID.
@@ -731,7 +794,10 @@ struct Executor::Impl {
       return !start.empty() || !cancel.empty() || !replies.empty() || !fulfilled.empty();
     }
 
-    void dispatchAll(Vector<_::XThreadEvent*>& eventsToCancelOutsideLock) {
+    size_t dispatchAll(Vector<_::XThreadEvent*>& eventsToCancelOutsideLock) {
+      // Returns how many events were queued.
+      size_t queued = start.size() + cancel.size() + replies.size() + fulfilled.size();
+
       for (auto& event : start) {
         start.remove(event);
         executing.add(event);
@@ -751,6 +817,8 @@ struct Executor::Impl {
         event.state = _::XThreadPaf::DISPATCHED;
         event.onReadyEvent.armBreadthFirst();
       }
+
+      return queued;
     }
 
     void dispatchCancels(Vector<_::XThreadEvent*>& eventsToCancelOutsideLock) {
@@ -770,7 +838,23 @@ struct Executor::Impl {
   };
 
   zc::MutexGuarded<State> state;
-  // After modifying state from another thread, the loop's port.wake() must be called.
+  // After modifying state from another thread, the loop's port.wake() must be called, unless
+  // markPending() says a wake is already on its way.
+
+  size_t dispatchedSinceTaken = 0;
+  // Events dispatched since the loop last took the count for its stats. Only touched by the loop's
+  // own thread, so it isn't guarded.
+
+  mutable std::atomic<bool> pending = false;
+  // Set, under the lock, when something is queued for dispatch; cleared, also under the lock,
+  // just before the loop dispatches everything queued. While it's set, the loop is bound to
+  // dispatch again, so a burst of events from other threads costs one wake() rather than one each,
+  // and a loop woken for other reasons needn't take the lock to find nothing queued.
+
+  bool markPending() const {
+    // Call with `state` locked, after queuing something. Returns whether the loop needs waking.
+    return !pending.exchange(true, std::memory_order_relaxed);
+  }
 
   void processAsyncCancellations(Vector<_::XThreadEvent*>& eventsToCancelOutsideLock) {
     // After calling dispatchAll() or dispatchCancels() with the lock held, it may be that some
@@ -885,7 +969,9 @@ void XThreadEvent::ensureDoneOrCanceled() {
         lock->executing.remove(*this);
         lock->cancel.add(*this);
         state = CANCELING;
-        ZC_IF_SOME(p, loop->port) { p.wake(); }
+        if (targetExecutor->impl->markPending()) {
+          ZC_IF_SOME(p, loop->port) { p.wake(); }
+        }
 
         Maybe<Executor&> maybeSelfExecutor = zc::none;
         if (threadLocalEventLoop != nullptr) {
@@ -997,12 +1083,12 @@ void XThreadEvent::ensureDoneOrCanceled() {
 void XThreadEvent::sendReply() noexcept {
   ZC_IF_SOME(e, replyExecutor) {
     // Queue the reply.
-    const EventLoop* replyLoop;
+    const EventLoop* replyLoop = nullptr;
     {
       auto lock = e.impl->state.lockExclusive();
       ZC_IF_SOME(l, lock->loop) {
         lock->replies.add(*this);
-        replyLoop = &l;
+        if (e.impl->markPending()) replyLoop = &l;
       }
       else {
         // Calling thread exited without cancelling the promise. This is UB. In fact,
@@ -1023,7 +1109,9 @@ void XThreadEvent::sendReply() noexcept {
     // EventLoop, and when it tries to destroy this promise, it will wait for `state` to become
     // `DONE`, which we don't set until later on. That's nice because wake() probably makes a
     // syscall and we'd rather not hold the lock through syscalls.
-    ZC_IF_SOME(p, replyLoop->port) { p.wake(); }
+    if (replyLoop != nullptr) {
+      ZC_IF_SOME(p, replyLoop->port) { p.wake(); }
+    }
   }
 }
 
@@ -1173,10 +1261,11 @@ XThreadPaf::FulfillScope::~FulfillScope() noexcept(false) {
     lock->fulfilled.add(*obj);
     __atomic_store_n(&obj->state, FULFILLED, __ATOMIC_RELEASE);
     ZC_IF_SOME(l, lock->loop) {
+      bool needWake = obj->executor->impl->markPending();
       ZC_IF_SOME(p, l.port) {
         // TODO(perf): It's annoying we have to call wake() with the lock held, but we have to
         //   prevent the destination EventLoop from being destroyed first.
-        p.wake();
+        if (needWake) p.wake();
       }
     }
     else {
@@ -1247,7 +1336,10 @@ void Executor::send(_::XThreadEvent& event, bool sync) const {
   event.state = _::XThreadEvent::QUEUED;
   lock->start.add(event);
 
-  ZC_IF_SOME(p, loop->port) { p.wake(); }
+  bool needWake = impl->markPending();
+  ZC_IF_SOME(p, loop->port) {
+    if (needWake) p.wake();
+  }
   else {
     // Event loop will be waiting on executor.wait(), which will be woken when we unlock the mutex.
   }
@@ -1265,16 +1357,22 @@ void Executor::wait() {
 
   lock.wait([](const Impl::State& state) { return state.isDispatchNeeded(); });
 
-  lock->dispatchAll(eventsToCancelOutsideLock);
+  impl->pending.store(false, std::memory_order_relaxed);
+  impl->dispatchedSinceTaken += lock->dispatchAll(eventsToCancelOutsideLock);
 }
 
 bool Executor::poll() {
+  // Nothing can have been queued without setting `pending`, and whoever set it woke us after
+  // releasing the lock -- so if it's clear, there's no need to lock.
+  if (!impl->pending.load(std::memory_order_acquire)) return false;
+
   Vector<_::XThreadEvent*> eventsToCancelOutsideLock;
   ZC_DEFER(impl->processAsyncCancellations(eventsToCancelOutsideLock));
 
   auto lock = impl->state.lockExclusive();
+  impl->pending.store(false, std::memory_order_relaxed);
   if (lock->isDispatchNeeded()) {
-    lock->dispatchAll(eventsToCancelOutsideLock);
+    impl->dispatchedSinceTaken += lock->dispatchAll(eventsToCancelOutsideLock);
     return true;
   } else {
     return false;
@@ -1705,9 +1803,132 @@ struct FiberStack::Impl {
       }
     }
 
+    void EventLoopHistogram::add(uint64_t value) {
+      uint bucket = value <= 1 ? 0 : 64 - __builtin_clzll(value - 1);
+      ++buckets[zc::min(bucket, BUCKET_COUNT - 1)];
+      ++count;
+      sum += value;
+      max = zc::max(max, value);
+    }
+
+    uint64_t EventLoopHistogram::percentile(double fraction) const {
+      if (count == 0) { return 0; }
+      // Nearest rank, as with benchmarks.
+      uint64_t rank = zc::max(uint64_t(ceil(fraction * double(count))), uint64_t(1));
+      uint64_t seen = 0;
+      for (uint i = 0; i < BUCKET_COUNT - 1; i++) {
+        seen += buckets[i];
+        if (seen >= rank) { return zc::min(upperBound(i), max); }
+      }
+      return max;
+    }
+
+    namespace {
+
+    String summarize(StringPtr name, const EventLoopHistogram& histogram, StringPtr unit) {
+      return zc::str(name, " ", histogram.getCount(), " p50 ", histogram.percentile(0.5), unit,
+                     " p99 ", histogram.percentile(0.99), unit, " max ", histogram.getMax(), unit);
+    }
+
+    }  // namespace
+
+    String ZC_STRINGIFY(const EventLoopStats& stats) {
+      auto result = zc::str(summarize("turns", stats.turnNanoseconds, "ns"), "; ",
+                            summarize("events/turn", stats.eventsPerTurn, ""), "; ",
+                            summarize("events", stats.eventNanoseconds, "ns"), "; ",
+                            summarize("waits", stats.waitNanoseconds, "ns"), "; ",
+                            summarize("cross-thread", stats.crossThreadQueueDepth, ""));
+      if (stats.eventNanoseconds.getCount() == 0) { return result; }
+      return zc::str(result, "; longest event ", stats.longestEvent, " at ",
+                     stats.longestEventLocation, " trace ",
+                     stringifyStackTraceAddresses(stats.getLongestEventTrace()));
+    }
+
+    struct EventLoop::Instrumentation {
+      EventLoopStats stats;
+      const MonotonicClock& clock = systemPreciseMonotonicClock();
+
+      Maybe<TimePoint> turnStart;
+      TimePoint lastEventEnd = origin<TimePoint>();
+      uint64_t eventsThisTurn = 0;
+
+      SourceLocation eventLocation;
+      void* eventTraceSpace[EventLoopStats::TRACE_SIZE];
+      uint eventTraceSize = 0;
+      // Of the event firing, taken beforehand since the event may not survive firing.
+
+      TimePoint beginEvent(_::Event& event, SourceLocation location) {
+        eventLocation = location;
+        _::TraceBuilder builder(eventTraceSpace);
+        event.traceEvent(builder);
+        eventTraceSize = builder.finish().size();
+
+        auto now = clock.now();
+        if (turnStart == zc::none) { turnStart = now; }
+        return now;
+      }
+
+      void endEvent(TimePoint start) {
+        lastEventEnd = clock.now();
+        auto elapsed = lastEventEnd - start;
+        stats.eventNanoseconds.add(elapsed / NANOSECONDS);
+        ++eventsThisTurn;
+
+        if (elapsed > stats.longestEvent) {
+          stats.longestEvent = elapsed;
+          stats.longestEventLocation = eventLocation;
+          memcpy(stats.longestEventTraceSpace, eventTraceSpace, eventTraceSize * sizeof(void*));
+          stats.longestEventTraceSize = eventTraceSize;
+        }
+      }
+
+      void endTurn() {
+        ZC_IF_SOME(start, turnStart) {
+          stats.turnNanoseconds.add((lastEventEnd - start) / NANOSECONDS);
+          stats.eventsPerTurn.add(eventsThisTurn);
+          turnStart = zc::none;
+          eventsThisTurn = 0;
+        }
+      }
+
+      void endWait(TimePoint start, Maybe<Own<Executor>>& executor) {
+        stats.waitNanoseconds.add((clock.now() - start) / NANOSECONDS);
+        takeDispatched(executor);
+      }
+
+      void takeDispatched(Maybe<Own<Executor>>& executor) {
+        ZC_IF_SOME(e, executor) {
+          if (e->impl->dispatchedSinceTaken > 0) {
+            stats.crossThreadQueueDepth.add(e->impl->dispatchedSinceTaken);
+            e->impl->dispatchedSinceTaken = 0;
+          }
+        }
+      }
+    };
+
+    void EventLoop::enableStats() {
+      if (instrumentation == zc::none) { instrumentation = zc::heap<Instrumentation>(); }
+    }
+
+    EventLoopStats EventLoop::getStats() {
+      ZC_IF_SOME(i, instrumentation) { return i->stats; }
+      else { ZC_FAIL_REQUIRE("getStats() requires enableStats()"); }
+    }
+
+    void EventLoop::resetStats() {
+      ZC_IF_SOME(i, instrumentation) { i->stats = {}; }
+    }
+
+    void EventLoop::endTurn() {
+      ZC_IF_SOME(i, instrumentation) { i->endTurn(); }
+    }
+
     void EventLoop::run(uint maxTurnCount) {
       running = true;
-      ZC_DEFER(running = false);
+      ZC_DEFER({
+        running = false;
+        endTurn();
+      });
 
       for (uint i = 0; i < maxTurnCount; i++) {
         if (!turn()) { break; }
@@ -1739,7 +1960,12 @@ struct FiberStack::Impl {
           ZC_DEFER(event->firing = false);
           currentlyFiring = event;
           ZC_DEFER(currentlyFiring = nullptr);
-          eventToDestroy = event->fire();
+          ZC_IF_SOME(i, instrumentation) {
+            auto start = i->beginEvent(*event, event->location);
+            eventToDestroy = event->fire();
+            i->endEvent(start);
+          }
+          else { eventToDestroy = event->fire(); }
         }
 
         depthFirstInsertPoint = &head;
@@ -1784,6 +2010,10 @@ struct FiberStack::Impl {
         return;
       }
 
+      endTurn();
+      Maybe<TimePoint> waitStart;
+      ZC_IF_SOME(i, instrumentation) { waitStart = i->clock.now(); }
+
       ZC_IF_SOME(p, port) {
         if (p.wait()) {
           // Another thread called wake(). Check for cross-thread events.
@@ -1792,9 +2022,15 @@ struct FiberStack::Impl {
       }
       else ZC_IF_SOME(e, executor) { e->wait(); }
       else { ZC_FAIL_REQUIRE("Nothing to wait for; this thread would hang forever."); }
+
+      ZC_IF_SOME(i, instrumentation) {
+        ZC_IF_SOME(start, waitStart) { i->endWait(start, executor); }
+      }
     }
 
     void EventLoop::poll() {
+      endTurn();
+
       ZC_IF_SOME(p, port) {
         if (p.poll()) {
           // Another thread called wake(). Check for cross-thread events.
@@ -1803,6 +2039,8 @@ struct FiberStack::Impl {
       }
       else ZC_IF_SOME(e, executor) { e->poll(); }
 
+      ZC_IF_SOME(i, instrumentation) { i->takeDispatched(executor); }
+
       if (head == nullptr && wouldSleepHead != nullptr) {
         // We got nothing by polling. So, enqueue the next would-sleep event instead.
         _::Event* event = wouldSleepHead;
@@ -1816,7 +2054,10 @@ struct FiberStack::Impl {
       ZC_REQUIRE(!loop.running, "poll() is not allowed from within event callbacks.");
 
       loop.running = true;
-      ZC_DEFER(loop.running = false);
+      ZC_DEFER({
+        loop.running = false;
+        loop.endTurn();
+      });
 
       uint turnCount = 0;
       runOnStackPool([&]() {
@@ -1918,7 +2159,10 @@ struct FiberStack::Impl {
         node->onReady(&doneEvent);
 
         loop.running = true;
-        ZC_DEFER(loop.running = false);
+        ZC_DEFER({
+          loop.running = false;
+          loop.endTurn();
+        });
 
         for (;;) {
           waitScope.runOnStackPool([&]() {
@@ -1963,7 +2207,10 @@ struct FiberStack::Impl {
       node.onReady(&doneEvent);
 
       loop.running = true;
-      ZC_DEFER(loop.running = false);
+      ZC_DEFER({
+        loop.running = false;
+        loop.endTurn();
+      });
 
       waitScope.runOnStackPool([&]() {
         while (!doneEvent.fired) {
@@ -24,6 +24,7 @@
 #include "zc/async/async-prelude.h"
 #include "zc/core/exception.h"
 #include "zc/core/refcount.h"
+#include "zc/core/time.h"
 
 ZC_BEGIN_HEADER
 
@@ -36,6 +37,16 @@ ZC_BEGIN_HEADER
 #endif
 #endif
 
+#ifndef ZC_PROMISE_ARENA_POOL
+// Promise arenas are recycled through per-thread free lists, except under ASAN, where that would
+// hide use-after-free bugs. Define as 0 to always use the heap when debugging memory errors.
+#if ZC_HAS_COMPILER_FEATURE(address_sanitizer) || defined(__SANITIZE_ADDRESS__)
+#define ZC_PROMISE_ARENA_POOL 0
+#else
+#define ZC_PROMISE_ARENA_POOL 1
+#endif
+#endif
+
 namespace zc {
 
 class EventLoop;
@@ -1182,6 +1193,73 @@ public:
   // The default implementation throws an UNIMPLEMENTED exception.
 };
 
+class EventLoopHistogram {
+  // Counts of samples in buckets that double in width: bucket 0 holds the samples up to 1, and
+  // bucket i > 0 those from 2^(i-1) + 1 up to 2^i, except that the last bucket has no upper bound.
+  // That's coarse, but adding a sample is a handful of instructions, and the buckets export
+  // directly as a cumulative histogram with the bounds upperBound(i), as Prometheus expects.
+
+public:
+  static constexpr uint BUCKET_COUNT = 40;
+  // For nanoseconds, 2^38 is over four minutes.
+
+  void add(uint64_t value);
+
+  uint64_t getCount() const { return count; }
+  uint64_t getSum() const { return sum; }
+  uint64_t getMax() const { return max; }
+  ArrayPtr<const uint64_t> getBuckets() const { return buckets; }
+
+  static uint64_t upperBound(uint bucket) { return uint64_t(1) << bucket; }
+  // The largest sample the bucket counts, but for the last bucket, which counts everything else.
+
+  uint64_t percentile(double fraction) const;
+  // The upper bound of the bucket holding the given fraction of samples, e.g. 0.99, capped at
+  // getMax(). 0 when empty.
+
+private:
+  uint64_t buckets[BUCKET_COUNT] = {};
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+};
+
+struct EventLoopStats {
+  // What an EventLoop measured of itself, from EventLoop::getStats(). A turn here is the run of
+  // events between two checks of the EventPort for I/O, which is the time the loop couldn't
+  // respond to anything new.
+
+  EventLoopHistogram turnNanoseconds;
+  // Time from the start of each turn's first event to the end of its last.
+
+  EventLoopHistogram eventsPerTurn;
+  EventLoopHistogram eventNanoseconds;
+
+  EventLoopHistogram waitNanoseconds;
+  // Time blocked in EventPort::wait(), or waiting on other threads if the loop has no port.
+
+  EventLoopHistogram crossThreadQueueDepth;
+  // The number of cross-thread events -- calls, replies, cancellations, and fulfillments -- found
+  // queued each time the loop picks them up, not counting times it finds none.
+
+  Duration longestEvent = 0 * NANOSECONDS;
+  SourceLocation longestEventLocation;
+  // The slowest event and where its promise was created, e.g. the call to then() whose callback
+  // took the time.
+
+  static constexpr uint TRACE_SIZE = 16;
+  void* longestEventTraceSpace[TRACE_SIZE];
+  uint longestEventTraceSize = 0;
+  ArrayPtr<void* const> getLongestEventTrace() const {
+    return arrayPtr(longestEventTraceSpace, longestEventTraceSize);
+  }
+  // The slowest event's async trace, as getAsyncTrace() would have given inside it. Feed it to
+  // addr2line.
+};
+
+String ZC_STRINGIFY(const EventLoopStats& stats);
+// A one-line summary for logs, with the percentiles of each histogram.
+
 class EventLoop {
   // Represents a queue of events being executed in a loop.  Most code won't interact with
   // EventLoop directly, but instead use `Promise`s to interact with it indirectly.  See the
@@ -1244,6 +1322,19 @@ public:
   // Same as WaitScope::cancelAllDetached(). Sometimes it's easier to call on the EventLoop. (A
   // WaitScope still must exist, i.e., this EventLoop must be current.)
 
+  void enableStats();
+  // Starts measuring the loop for getStats(): how long turns, events, and waits take, and which
+  // event was slowest. While enabled, each event costs two reads of the monotonic clock and a walk
+  // of its promise chain, so this is meant for production use when a latency problem needs
+  // finding, not for every loop all the time. Calling it again has no effect.
+
+  EventLoopStats getStats();
+  // What was measured since enableStats() or resetStats(). Requires enableStats().
+
+  void resetStats();
+  // Starts the measurements over, e.g. after exporting them, so that the longest event is the
+  // longest since then.
+
 private:
   zc::Maybe<EventPort&> port;
   // If null, this thread doesn't receive I/O events from the OS. It can potentially receive
@@ -1277,7 +1368,12 @@ private:
 
   _::Event* currentlyFiring = nullptr;
 
+  struct Instrumentation;
+  zc::Maybe<Own<Instrumentation>> instrumentation;
+  // Allocated by enableStats().
+
   bool turn();
+  void endTurn();
   void setRunnable(bool runnable);
   void enterScope();
   void leaveScope();
@@ -22,9 +22,8 @@
 
 #include "zc/async/timer.h"
 
-#include <set>
-
 #include "zc/core/debug.h"
+#include "zc/core/vector.h"
 
 namespace zc {
 
@@ -32,61 +31,129 @@ zc::Exception Timer::makeTimeoutException() {
   return ZC_EXCEPTION(OVERLOADED, "operation timed out");
 }
 
+Promise<void> Timer::afterDelayCoarse(Duration delay, Duration slack) {
+  if (slack <= 0 * SECONDS) return afterDelay(delay);
+
+  TimePoint deadline = now() + delay;
+  Duration past = (deadline - origin<TimePoint>()) % slack;
+  if (past < 0 * SECONDS) past += slack;
+  if (past > 0 * SECONDS) deadline += slack - past;
+  return atTime(deadline);
+}
+
 struct TimerImpl::Impl {
-  struct TimerBefore {
-    bool operator()(TimerPromiseAdapter* lhs, TimerPromiseAdapter* rhs) const;
-  };
-  using Timers = std::multiset<TimerPromiseAdapter*, TimerBefore>;
-  Timers timers;
+  // Pending timers, in a 4-ary min-heap ordered by time and then by creation, so that timers set
+  // for the same time fire in the order they were set. Each timer records its own position in the
+  // heap, so none of this allocates per timer, and cancelling one needn't search for it.
+
+  Vector<TimerPromiseAdapter*> heap;
+  uint64_t nextSequence = 0;
+
+  static constexpr size_t NOT_QUEUED = maxValue;
+
+  void insert(TimerPromiseAdapter* timer);
+  void remove(TimerPromiseAdapter* timer);
+
+private:
+  static bool before(const TimerPromiseAdapter* a, const TimerPromiseAdapter* b);
+  void place(size_t index, TimerPromiseAdapter* timer);
+  void siftUp(size_t index);
+  void siftDown(size_t index);
 };
 
 class TimerImpl::TimerPromiseAdapter {
 public:
   TimerPromiseAdapter(PromiseFulfiller<void>& fulfiller, TimerImpl& parent, TimePoint time)
-      : time(time), fulfiller(fulfiller), parent(parent) {
-    pos = parent.impl->timers.insert(this);
+      : time(time), sequence(parent.impl->nextSequence++), fulfiller(fulfiller), parent(parent) {
+    parent.impl->insert(this);
 
     ZC_IF_SOME(h, parent.sleepHooks) {
-      if (pos == parent.impl->timers.begin()) { h.updateNextTimerEvent(time); }
+      if (index == 0) { h.updateNextTimerEvent(time); }
     }
   }
 
   ~TimerPromiseAdapter() {
-    if (pos != parent.impl->timers.end()) {
-      ZC_IF_SOME(h, parent.sleepHooks) {
-        bool isFirst = pos == parent.impl->timers.begin();
+    if (index != Impl::NOT_QUEUED) {
+      bool isFirst = index == 0;
+      parent.impl->remove(this);
 
-        parent.impl->timers.erase(pos);
-
-        if (isFirst) {
-          if (parent.impl->timers.empty()) {
-            h.updateNextTimerEvent(zc::none);
-          } else {
-            h.updateNextTimerEvent((*parent.impl->timers.begin())->time);
-          }
-        }
+      ZC_IF_SOME(h, parent.sleepHooks) {
+        if (isFirst) { h.updateNextTimerEvent(parent.nextEvent()); }
       }
-      else { parent.impl->timers.erase(pos); }
     }
   }
 
   void fulfill() {
     fulfiller.fulfill();
-    parent.impl->timers.erase(pos);
-    pos = parent.impl->timers.end();
+    parent.impl->remove(this);
   }
 
   const TimePoint time;
+  const uint64_t sequence;
+  size_t index = Impl::NOT_QUEUED;
 
 private:
   PromiseFulfiller<void>& fulfiller;
   TimerImpl& parent;
-  Impl::Timers::const_iterator pos;
 };
 
-inline bool TimerImpl::Impl::TimerBefore::operator()(TimerPromiseAdapter* lhs,
-                                                     TimerPromiseAdapter* rhs) const {
-  return lhs->time < rhs->time;
+inline bool TimerImpl::Impl::before(const TimerPromiseAdapter* a, const TimerPromiseAdapter* b) {
+  return a->time < b->time || (a->time == b->time && a->sequence < b->sequence);
+}
+
+inline void TimerImpl::Impl::place(size_t index, TimerPromiseAdapter* timer) {
+  heap[index] = timer;
+  timer->index = index;
+}
+
+void TimerImpl::Impl::insert(TimerPromiseAdapter* timer) {
+  timer->index = heap.size();
+  heap.add(timer);
+  siftUp(timer->index);
+}
+
+void TimerImpl::Impl::remove(TimerPromiseAdapter* timer) {
+  size_t index = timer->index;
+  timer->index = NOT_QUEUED;
+
+  TimerPromiseAdapter* last = heap.back();
+  heap.removeLast();
+  if (index < heap.size()) {
+    // Fill the hole with the last timer, and move it whichever way it needs to go.
+    place(index, last);
+    siftUp(index);
+    siftDown(last->index);
+  }
+}
+
+void TimerImpl::Impl::siftUp(size_t index) {
+  TimerPromiseAdapter* timer = heap[index];
+  while (index > 0) {
+    size_t parent = (index - 1) / 4;
+    if (!before(timer, heap[parent])) break;
+    place(index, heap[parent]);
+    index = parent;
+  }
+  place(index, timer);
+}
+
+void TimerImpl::Impl::siftDown(size_t index) {
+  TimerPromiseAdapter* timer = heap[index];
+  for (;;) {
+    size_t first = index * 4 + 1;
+    if (first >= heap.size()) break;
+
+    size_t best = first;
+    size_t end = zc::min(first + 4, heap.size());
+    for (size_t child = first + 1; child < end; child++) {
+      if (before(heap[child], heap[best])) best = child;
+    }
+
+    if (!before(heap[best], timer)) break;
+    place(index, heap[best]);
+    index = best;
+  }
+  place(index, timer);
 }
 
 TimePoint TimerImpl::now() const {
@@ -108,11 +175,10 @@ TimerImpl::TimerImpl(TimePoint startTime) : time(startTime), impl(heap<Impl>())
 TimerImpl::~TimerImpl() noexcept(false) {}
 
 Maybe<TimePoint> TimerImpl::nextEvent() {
-  auto iter = impl->timers.begin();
-  if (iter == impl->timers.end()) {
+  if (impl->heap.empty()) {
     return zc::none;
   } else {
-    return (*iter)->time;
+    return impl->heap[0]->time;
   }
 }
 
@@ -147,11 +213,7 @@ void TimerImpl::advanceTo(TimePoint newTime) {
   time = newTime;
 #endif
 
-  for (;;) {
-    auto front = impl->timers.begin();
-    if (front == impl->timers.end() || (*front)->time > time) { break; }
-    (*front)->fulfill();
-  }
+  while (!impl->heap.empty() && impl->heap[0]->time <= time) { impl->heap[0]->fulfill(); }
 }
 
 }  // namespace zc
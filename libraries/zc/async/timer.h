@@ -61,6 +61,13 @@ public:
   virtual Promise<void> afterDelay(Duration delay) = 0;
   // Equivalent to atTime(now() + delay).
 
+  Promise<void> afterDelayCoarse(Duration delay, Duration slack);
+  // Like afterDelay(), but may fire up to `slack` late: the deadline is rounded up to the next
+  // multiple of `slack` since the timer's origin. Timers that would expire within the same window
+  // then share a deadline, so the event loop wakes once per window rather than once per timer.
+  // Suits timeouts that are kept in large numbers and rarely fire, like per-connection idle
+  // timeouts. A `slack` of zero is the same as afterDelay().
+
   template <typename T>
   Promise<T> timeoutAt(TimePoint time, Promise<T>&& promise) ZC_WARN_UNUSED_RESULT;
   // Return a promise equivalent to `promise` but which throws an exception (and cancels the
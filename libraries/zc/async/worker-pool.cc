@@ -0,0 +1,126 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#if _WIN32 || __CYGWIN__
+#include "zc/core/win32-api-version.h"
+#endif
+
+#include "zc/async/worker-pool.h"
+
+#include <atomic>
+#include <deque>
+#include <thread>
+
+#include "zc/core/concurrent-queue.h"
+#include "zc/core/debug.h"
+#include "zc/core/mutex.h"
+#include "zc/core/thread.h"
+
+namespace zc {
+
+struct WorkerPool::Impl {
+  explicit Impl(uint threadCount) : queues(heapArray<Queue>(threadCount)) {}
+
+  using Queue = MutexGuarded<std::deque<Own<_::WorkerPoolTask>>>;
+  Array<Queue> queues;
+  // One per thread. Each thread takes from the front of its own queue, and steals from the front
+  // of the others' when its own is empty.
+
+  mutable std::atomic<uint> nextQueue = 0;
+  // run() deals work into the queues in turn.
+
+  mutable std::atomic<size_t> queued = 0;
+  // Total across all queues, so that idle threads needn't look through every queue to find out
+  // there's nothing to do.
+
+  std::atomic<bool> stopping = false;
+  mutable _::QueueWaiter idle;
+
+  Array<Own<Thread>> threads;
+
+  Own<_::WorkerPoolTask> take(uint index);
+  void run(uint index);
+};
+
+Own<_::WorkerPoolTask> WorkerPool::Impl::take(uint index) {
+  if (queued.load(std::memory_order_acquire) == 0) return {};
+
+  for (uint i = 0; i < queues.size(); i++) {
+    auto lock = queues[(index + i) % queues.size()].lockExclusive();
+    if (!lock->empty()) {
+      auto task = zc::mv(lock->front());
+      lock->pop_front();
+      queued.fetch_sub(1, std::memory_order_relaxed);
+      return task;
+    }
+  }
+  return {};
+}
+
+void WorkerPool::Impl::run(uint index) {
+  for (;;) {
+    auto task = take(index);
+    if (task.get() != nullptr) {
+      task->run();
+      continue;
+    }
+
+    uint epoch = idle.prepareWait();
+    if (queued.load(std::memory_order_acquire) > 0) {
+      idle.cancelWait();
+      continue;
+    }
+    // Only stop once everything queued before the destructor has been taken.
+    if (stopping.load(std::memory_order_acquire)) {
+      idle.cancelWait();
+      return;
+    }
+    idle.wait(epoch);
+  }
+}
+
+WorkerPool::WorkerPool(uint threadCount) {
+  if (threadCount == 0) threadCount = zc::max(std::thread::hardware_concurrency(), 1u);
+  impl = heap<Impl>(threadCount);
+
+  auto builder = heapArrayBuilder<Own<Thread>>(threadCount);
+  for (uint i = 0; i < threadCount; i++) {
+    builder.add(heap<Thread>([&impl = *impl, i]() { impl.run(i); }));
+  }
+  impl->threads = builder.finish();
+}
+
+WorkerPool::~WorkerPool() noexcept(false) {
+  impl->stopping.store(true, std::memory_order_release);
+  impl->idle.notifyAll();
+  impl->threads = nullptr;
+}
+
+uint WorkerPool::getThreadCount() const { return impl->queues.size(); }
+
+void WorkerPool::submit(Own<_::WorkerPoolTask> task) const {
+  uint index = impl->nextQueue.fetch_add(1, std::memory_order_relaxed) % impl->queues.size();
+  impl->queues[index].lockExclusive()->push_back(zc::mv(task));
+  impl->queued.fetch_add(1, std::memory_order_release);
+  impl->idle.notifyOne();
+}
+
+}  // namespace zc
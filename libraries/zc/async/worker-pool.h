@@ -0,0 +1,129 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "zc/async/async.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+class WorkerPoolTask {
+public:
+  virtual ~WorkerPoolTask() noexcept(false) = default;
+  virtual void run() = 0;
+};
+
+template <typename Func, typename T>
+class WorkerPoolTaskImpl final : public WorkerPoolTask {
+public:
+  WorkerPoolTaskImpl(Func&& func, Own<CrossThreadPromiseFulfiller<T>> fulfiller)
+      : func(zc::fwd<Func>(func)), fulfiller(zc::mv(fulfiller)) {}
+
+  void run() override {
+    // Don't bother if the caller has already dropped the promise.
+    if (!fulfiller->isWaiting()) return;
+
+    ZC_IF_SOME(exception, runCatchingExceptions([&]() {
+      if constexpr (isSameType<T, void>()) {
+        func();
+        fulfiller->fulfill();
+      } else {
+        fulfiller->fulfill(func());
+      }
+    })) {
+      fulfiller->reject(zc::mv(exception));
+    }
+  }
+
+private:
+  Decay<Func> func;
+  Own<CrossThreadPromiseFulfiller<T>> fulfiller;
+};
+
+}  // namespace _
+
+class WorkerPool {
+  // A fixed set of threads for CPU-bound work, so that an event loop -- or a coroutine running on
+  // one -- can hand off a long computation and keep serving I/O in the meantime:
+  //
+  //     String output = co_await pool.run([&input]() { return compile(input); });
+  //
+  // The function runs on one of the pool's threads; the returned promise belongs to the calling
+  // thread's event loop, so whatever follows it (the rest of the coroutine, or a .then()) runs
+  // back on that loop. Any number of event loops may share one pool.
+  //
+  // Each thread has a queue of its own, which run() deals work into in turn, so that the threads
+  // rarely contend for a lock. A thread whose queue is empty steals the oldest work from another
+  // thread's queue before going to sleep, so a thread that happens to be handed several long jobs
+  // doesn't hold up the work queued behind them.
+  //
+  // Work that hasn't started when its promise is dropped is skipped; work that has started runs
+  // to completion, and its result is discarded.
+
+public:
+  explicit WorkerPool(uint threadCount = 0);
+  // `threadCount` defaults to the number of CPUs.
+
+  ~WorkerPool() noexcept(false);
+  // Waits for work that has already been queued to finish.
+
+  ZC_DISALLOW_COPY_AND_MOVE(WorkerPool);
+
+  template <typename Func>
+  PromiseForResult<Func, void> run(Func&& func) const;
+  // Queues `func` to be called on one of the pool's threads and returns a promise for its result,
+  // which must not itself be a promise: the pool's threads have no event loops. The calling
+  // thread must have an event loop.
+  //
+  // `func` is called, and destroyed, on the pool's thread, and its result is moved across threads
+  // to the caller, so both need to be safe to use that way. If `func` throws, the promise is
+  // rejected with the exception.
+
+  uint getThreadCount() const;
+
+private:
+  struct Impl;
+  Own<Impl> impl;
+
+  void submit(Own<_::WorkerPoolTask> task) const;
+};
+
+// =======================================================================================
+// inline implementation details
+
+template <typename Func>
+PromiseForResult<Func, void> WorkerPool::run(Func&& func) const {
+  using T = _::ReturnType<Func, void>;
+  static_assert(isSameType<PromiseForResult<Func, void>, Promise<T>>(),
+                "WorkerPool::run() can't wait for a promise; return a value instead");
+
+  auto paf = newPromiseAndCrossThreadFulfiller<T>();
+  submit(heap<_::WorkerPoolTaskImpl<Func, T>>(zc::fwd<Func>(func), zc::mv(paf.fulfiller)));
+  return zc::mv(paf.promise);
+}
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/async/async-io.h"
+#include "zc/async/timer.h"
+#include "zc/core/mutex.h"
+#include "zc/core/thread.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+ZC_BENCHMARK("Promise") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  benchmark.setItemsPerIteration(1000);
+
+  benchmark.run("then", [&]() {
+    Promise<uint> promise = uint(0);
+    for (uint i = 0; i < 1000; i++) {
+      promise = promise.then([](uint x) { return x + 1; });
+    }
+    doNotOptimize(promise.wait(waitScope));
+  });
+
+  benchmark.run("evalLater", [&]() {
+    uint count = 0;
+    Promise<void> promise = READY_NOW;
+    for (uint i = 0; i < 1000; i++) {
+      promise = promise.then([&]() { return evalLater([&]() { ++count; }); });
+    }
+    promise.wait(waitScope);
+    doNotOptimize(count);
+  });
+
+  benchmark.run("fulfiller", [&]() {
+    for (uint i = 0; i < 1000; i++) {
+      auto paf = newPromiseAndFulfiller<uint>();
+      paf.fulfiller->fulfill(zc::cp(i));
+      doNotOptimize(paf.promise.wait(waitScope));
+    }
+  });
+}
+
+ZC_BENCHMARK("Executor") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+
+  struct Worker {
+    const Executor& executor;
+    Own<CrossThreadPromiseFulfiller<void>> done;
+  };
+  MutexGuarded<Maybe<Worker>> worker;
+
+  Thread thread([&]() noexcept {
+    EventLoop loop;
+    WaitScope waitScope(loop);
+    auto paf = newPromiseAndCrossThreadFulfiller<void>();
+    *worker.lockExclusive() = Worker{getCurrentThreadExecutor(), zc::mv(paf.fulfiller)};
+    paf.promise.wait(waitScope);
+  });
+
+  const Executor* executor;
+  {
+    auto lock = worker.lockExclusive();
+    lock.wait([](const Maybe<Worker>& value) { return value != zc::none; });
+    executor = &ZC_ASSERT_NONNULL(*lock).executor;
+  }
+
+  benchmark.run("executeAsync", [&]() {
+    doNotOptimize(executor->executeAsync([]() { return 123; }).wait(waitScope));
+  });
+
+  benchmark.setItemsPerIteration(100);
+  benchmark.run("executeAsync/pipelined", [&]() {
+    auto promises = heapArrayBuilder<Promise<uint>>(100);
+    for (uint i = 0; i < 100; i++) {
+      promises.add(executor->executeAsync([i]() { return i; }));
+    }
+    doNotOptimize(joinPromises(promises.finish()).wait(waitScope));
+  });
+
+  ZC_ASSERT_NONNULL(*worker.lockExclusive()).done->fulfill();
+}
+
+ZC_BENCHMARK("Timer") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+
+  // Scheduling and firing in bulk, with a timer driven by hand so that no time is spent waiting.
+  for (uint count : {10u, 1000u, 10000u}) {
+    benchmark.setItemsPerIteration(count);
+    benchmark.run(str("afterDelay/", count), [&]() {
+      TimerImpl timer(origin<TimePoint>());
+      auto promises = heapArrayBuilder<Promise<void>>(count);
+      for (uint i = 0; i < count; i++) {
+        promises.add(timer.afterDelay((i * 7919 % count) * MICROSECONDS));
+      }
+      timer.advanceTo(origin<TimePoint>() + count * MICROSECONDS);
+      joinPromises(promises.finish()).wait(waitScope);
+    });
+  }
+
+  // Timers that are canceled before they fire, as timeouts usually are.
+  benchmark.setItemsPerIteration(1000);
+  benchmark.run("timeoutAfter/canceled", [&]() {
+    TimerImpl timer(origin<TimePoint>());
+    for (uint i = 0; i < 1000; i++) {
+      doNotOptimize(timer.timeoutAfter(1 * SECONDS, Promise<uint>(i)).wait(waitScope));
+    }
+  });
+}
+
+ZC_BENCHMARK("Timer/system") {
+  // A zero delay still goes through the OS, so this is the overhead of one real timer wakeup.
+  auto io = setupAsyncIo();
+  benchmark.run("afterDelay/0", [&]() {
+    io.provider->getTimer().afterDelay(0 * NANOSECONDS).wait(io.waitScope);
+  });
+}
+
+void pipeThroughput(Benchmark& benchmark, StringPtr variant, WaitScope& waitScope,
+                    AsyncOutputStream& out, AsyncInputStream& in) {
+  for (size_t size : {size_t(64), size_t(4096), size_t(65536)}) {
+    auto data = heapArray<byte>(size);
+    for (size_t i = 0; i < data.size(); i++) { data[i] = byte(i); }
+    auto buffer = heapArray<byte>(data.size());
+
+    benchmark.setBytesPerIteration(data.size());
+    benchmark.run(str(variant, '/', size), [&]() {
+      auto write = out.write(data);
+      in.read(buffer, buffer.size()).wait(waitScope);
+      write.wait(waitScope);
+    });
+  }
+}
+
+ZC_BENCHMARK("pipe") {
+  auto io = setupAsyncIo();
+
+  auto memoryPipe = newOneWayPipe();
+  pipeThroughput(benchmark, "memory", io.waitScope, *memoryPipe.out, *memoryPipe.in);
+
+  auto socketPipe = io.provider->newTwoWayPipe();
+  pipeThroughput(benchmark, "socket", io.waitScope, *socketPipe.ends[0], *socketPipe.ends[1]);
+}
+
+}  // namespace
+}  // namespace zc
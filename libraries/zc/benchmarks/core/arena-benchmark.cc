@@ -0,0 +1,70 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/arena.h"
+#include "zc/core/memory.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+struct Node {
+  Node* next;
+  uint64_t value;
+};
+
+constexpr uint NODE_COUNT = 1000;
+
+ZC_BENCHMARK("Arena") {
+  benchmark.setItemsPerIteration(NODE_COUNT);
+
+  benchmark.run("allocate", [&]() {
+    Arena arena;
+    Node* head = nullptr;
+    for (uint i = 0; i < NODE_COUNT; i++) { head = &arena.allocate<Node>(Node{head, i}); }
+    doNotOptimize(head);
+  });
+
+  ArenaChunkPool pool;
+  benchmark.run("allocate/pooled", [&]() {
+    Arena arena(pool);
+    Node* head = nullptr;
+    for (uint i = 0; i < NODE_COUNT; i++) { head = &arena.allocate<Node>(Node{head, i}); }
+    doNotOptimize(head);
+  });
+
+  byte scratch[NODE_COUNT * sizeof(Node) + 1024];
+  benchmark.run("allocate/scratch", [&]() {
+    Arena arena(scratch);
+    Node* head = nullptr;
+    for (uint i = 0; i < NODE_COUNT; i++) { head = &arena.allocate<Node>(Node{head, i}); }
+    doNotOptimize(head);
+  });
+
+  // The same allocations from the heap, to compare against.
+  benchmark.run("heap", [&]() {
+    Own<Node> nodes[NODE_COUNT];
+    for (uint i = 0; i < NODE_COUNT; i++) { nodes[i] = heap<Node>(Node{nullptr, i}); }
+    doNotOptimize(nodes);
+  });
+}
+
+}  // namespace
+}  // namespace zc
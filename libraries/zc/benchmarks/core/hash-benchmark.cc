@@ -0,0 +1,68 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/hash.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+constexpr size_t SIZES[] = {16, 256, 4096, 65536};
+
+Array<byte> makeData(size_t size) {
+  auto data = heapArray<byte>(size);
+  for (size_t i = 0; i < size; i++) { data[i] = byte(i * 131 + 7); }
+  return data;
+}
+
+ZC_BENCHMARK("hashCode") {
+  for (size_t size : SIZES) {
+    auto data = makeData(size);
+    benchmark.setBytesPerIteration(size);
+    benchmark.run(str("bytes/", size), [&]() { doNotOptimize(hashCode(data.asPtr())); });
+  }
+
+  auto ints = heapArray<uint64_t>(1000);
+  for (uint i = 0; i < ints.size(); i++) { ints[i] = i * 0x9E3779B97F4A7C15ull; }
+  benchmark.setBytesPerIteration(0);
+  benchmark.setItemsPerIteration(ints.size());
+  benchmark.run("uint64_t", [&]() {
+    for (uint64_t i : ints) { doNotOptimize(hashCode(i)); }
+  });
+}
+
+ZC_BENCHMARK("murmur2") {
+  for (size_t size : SIZES) {
+    auto data = makeData(size);
+    benchmark.setBytesPerIteration(size);
+    benchmark.run(str(size), [&]() { doNotOptimize(_::murmur2(data)); });
+  }
+}
+
+ZC_BENCHMARK("fastHash64") {
+  for (size_t size : SIZES) {
+    auto data = makeData(size);
+    benchmark.setBytesPerIteration(size);
+    benchmark.run(str(size), [&]() { doNotOptimize(fastHash64(data)); });
+  }
+}
+
+}  // namespace
+}  // namespace zc
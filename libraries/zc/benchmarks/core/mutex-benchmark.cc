@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/mutex.h"
+#include "zc/core/string.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+constexpr uint LOCKS_PER_THREAD = 10000;
+
+ZC_BENCHMARK("MutexGuarded") {
+  // Each iteration starts the threads afresh, which costs little next to their locking.
+  for (uint threadCount : {1u, 2u, 4u, 8u}) {
+    benchmark.setItemsPerIteration(threadCount * LOCKS_PER_THREAD);
+    benchmark.run(str("exclusive/", threadCount), [&]() {
+      MutexGuarded<uint64_t> counter(0);
+      {
+        Vector<Own<Thread>> threads(threadCount);
+        for (uint i = 0; i < threadCount; i++) {
+          threads.add(heap<Thread>([&]() {
+            for (uint j = 0; j < LOCKS_PER_THREAD; j++) { ++*counter.lockExclusive(); }
+          }));
+        }
+      }
+      ZC_ASSERT(*counter.lockShared() == threadCount * LOCKS_PER_THREAD);
+    });
+
+    benchmark.run(str("shared/", threadCount), [&]() {
+      MutexGuarded<uint64_t> value(1);
+      {
+        Vector<Own<Thread>> threads(threadCount);
+        for (uint i = 0; i < threadCount; i++) {
+          threads.add(heap<Thread>([&]() {
+            uint64_t sum = 0;
+            for (uint j = 0; j < LOCKS_PER_THREAD; j++) { sum += *value.lockShared(); }
+            doNotOptimize(sum);
+          }));
+        }
+      }
+    });
+  }
+}
+
+}  // namespace
+}  // namespace zc
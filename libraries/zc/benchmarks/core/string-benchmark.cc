@@ -0,0 +1,55 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+ZC_BENCHMARK("str") {
+  benchmark.run("literals", [&]() { doNotOptimize(str("foo", "bar", "baz", 'q')); });
+  benchmark.run("integers", [&]() {
+    doNotOptimize(str(123, ", ", -4567890, ", ", 0xffffffffffffffffull, ", ", 0u));
+  });
+  benchmark.run("doubles", [&]() { doNotOptimize(str(3.14159, ", ", 1e100, ", ", 0.1)); });
+  benchmark.run("mixed", [&]() {
+    doNotOptimize(str("GET ", "/some/path", " returned ", 200, " in ", 1.25, "ms"));
+  });
+  benchmark.run("hex", [&]() { doNotOptimize(str(hex(0xdeadbeefu), hex(uint64_t(1) << 60))); });
+}
+
+ZC_BENCHMARK("strArray") {
+  Vector<String> parts;
+  for (uint i = 0; i < 1000; i++) { parts.add(str("part", i)); }
+  benchmark.setItemsPerIteration(parts.size());
+  benchmark.run([&]() { doNotOptimize(strArray(parts, ", ")); });
+}
+
+ZC_BENCHMARK("StringPtr::parseAs") {
+  auto text = str(1234567890123ull);
+  benchmark.run("uint64_t", [&]() { doNotOptimize(text.parseAs<uint64_t>()); });
+  auto decimal = str(12345.6789);
+  benchmark.run("double", [&]() { doNotOptimize(decimal.parseAs<double>()); });
+}
+
+}  // namespace
+}  // namespace zc
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/map.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+constexpr uint SIZES[] = {100, 10000, 100000};
+
+uint scramble(uint i) { return i * 2654435761u; }
+
+ZC_BENCHMARK("HashMap") {
+  for (uint size : SIZES) {
+    benchmark.setItemsPerIteration(size);
+    benchmark.run(str("insert/", size), [&]() {
+      HashMap<uint, uint> map;
+      for (uint i = 0; i < size; i++) { map.insert(scramble(i), i); }
+      doNotOptimize(map);
+    });
+
+    HashMap<uint, uint> map;
+    for (uint i = 0; i < size; i++) { map.insert(scramble(i), i); }
+    benchmark.run(str("find/", size), [&]() {
+      for (uint i = 0; i < size; i++) { doNotOptimize(map.find(scramble(i))); }
+    });
+    benchmark.run(str("miss/", size), [&]() {
+      for (uint i = 0; i < size; i++) { doNotOptimize(map.find(scramble(i + size))); }
+    });
+  }
+}
+
+ZC_BENCHMARK("TreeMap") {
+  for (uint size : SIZES) {
+    benchmark.setItemsPerIteration(size);
+    benchmark.run(str("insert/", size), [&]() {
+      TreeMap<uint, uint> map;
+      for (uint i = 0; i < size; i++) { map.insert(scramble(i), i); }
+      doNotOptimize(map);
+    });
+
+    TreeMap<uint, uint> map;
+    for (uint i = 0; i < size; i++) { map.insert(scramble(i), i); }
+    benchmark.run(str("find/", size), [&]() {
+      for (uint i = 0; i < size; i++) { doNotOptimize(map.find(scramble(i))); }
+    });
+    benchmark.run(str("iterate/", size), [&]() {
+      uint sum = 0;
+      for (auto& entry : map) { sum += entry.value; }
+      doNotOptimize(sum);
+    });
+  }
+}
+
+ZC_BENCHMARK("HashMap<String>") {
+  auto keys = heapArray<String>(10000);
+  for (uint i = 0; i < keys.size(); i++) { keys[i] = str("some-longish-key-", scramble(i)); }
+  HashMap<StringPtr, uint> map;
+  for (uint i = 0; i < keys.size(); i++) { map.insert(keys[i], i); }
+
+  benchmark.setItemsPerIteration(keys.size());
+  benchmark.run("find", [&]() {
+    for (auto& key : keys) { doNotOptimize(map.find(key)); }
+  });
+}
+
+}  // namespace
+}  // namespace zc
@@ -0,0 +1,53 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+ZC_BENCHMARK("Vector") {
+  for (uint size : {16u, 1000u, 100000u}) {
+    benchmark.setItemsPerIteration(size);
+    benchmark.run(str("grow/", size), [&]() {
+      Vector<uint> vector;
+      for (uint i = 0; i < size; i++) { vector.add(i); }
+      doNotOptimize(vector);
+    });
+    benchmark.run(str("reserve/", size), [&]() {
+      Vector<uint> vector(size);
+      for (uint i = 0; i < size; i++) { vector.add(i); }
+      doNotOptimize(vector);
+    });
+  }
+
+  // Growing moves every element each time capacity runs out.
+  benchmark.setItemsPerIteration(1000);
+  benchmark.run("grow/String", [&]() {
+    Vector<String> vector;
+    for (uint i = 0; i < 1000; i++) { vector.add(heapString("some string")); }
+    doNotOptimize(vector);
+  });
+}
+
+}  // namespace
+}  // namespace zc
@@ -0,0 +1,164 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+#include <string.h>
+
+#include "zc/core/vector.h"
+#include "zc/http/http.h"
+#include "zc/ztest/benchmark.h"
+
+namespace zc {
+namespace {
+
+constexpr char REQUEST_HEADERS[] =
+    "GET /some/path/to/a/resource?with=a&query=string HTTP/1.1\r\n"
+    "Host: www.example.com\r\n"
+    "User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:128.0) Gecko/20100101 Firefox/128.0\r\n"
+    "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,*/*;q=0.8\r\n"
+    "Accept-Language: en-US,en;q=0.5\r\n"
+    "Accept-Encoding: gzip, deflate, br, zstd\r\n"
+    "Connection: keep-alive\r\n"
+    "Cookie: session=0123456789abcdef0123456789abcdef; theme=dark\r\n"
+    "Upgrade-Insecure-Requests: 1\r\n"
+    "\r\n";
+
+ZC_BENCHMARK("HttpHeaders") {
+  HttpHeaderTable table;
+  HttpHeaders headers(table);
+  auto text = heapString(REQUEST_HEADERS);
+  auto copy = heapString(text);
+
+  benchmark.setBytesPerIteration(text.size());
+  benchmark.run("parse", [&]() {
+    // Parsing modifies its input.
+    memcpy(copy.begin(), text.begin(), text.size());
+    headers.clear();
+    doNotOptimize(headers.tryParseRequest(copy.asArray()));
+  });
+
+  auto parsed = heapString(text);
+  headers.clear();
+  ZC_ASSERT(headers.tryParseRequest(parsed.asArray()).is<HttpHeaders::Request>());
+  benchmark.run("serialize", [&]() {
+    doNotOptimize(headers.serializeRequest(HttpMethod::GET, "/some/path/to/a/resource"));
+  });
+}
+
+class FixedResponseService final : public HttpService {
+public:
+  FixedResponseService(const HttpHeaderTable& table, StringPtr body)
+      : responseHeaders(table), body(body) {
+    responseHeaders.set(HttpHeaderId::CONTENT_TYPE, "text/plain");
+  }
+
+  Promise<void> request(HttpMethod method, StringPtr url, const HttpHeaders& headers,
+                        AsyncInputStream& requestBody, Response& response) override {
+    auto stream = response.send(200, "OK", responseHeaders, uint64_t(body.size()));
+    auto promise = stream->write(body.asBytes());
+    return promise.attach(zc::mv(stream));
+  }
+
+private:
+  HttpHeaders responseHeaders;
+  StringPtr body;
+};
+
+ZC_BENCHMARK("HTTP round trip") {
+  auto io = setupAsyncIo();
+  HttpHeaderTable table;
+
+  for (size_t size : {size_t(16), size_t(65536)}) {
+    auto body = str(repeat('x', size));
+    FixedResponseService service(table, body);
+    HttpServer server(io.provider->getTimer(), table, service);
+
+    auto pipe = io.provider->newTwoWayPipe();
+    auto listenTask = server.listenHttp(zc::mv(pipe.ends[0]));
+    auto client = newHttpClient(table, *pipe.ends[1]);
+    HttpHeaders requestHeaders(table);
+
+    benchmark.setBytesPerIteration(size);
+    benchmark.run(str(size), [&]() {
+      auto response =
+          client->request(HttpMethod::GET, "/", requestHeaders).response.wait(io.waitScope);
+      doNotOptimize(response.body->readAllText().wait(io.waitScope));
+    });
+
+    // Hang up, so that the server finishes with the connection before it's destroyed.
+    client = nullptr;
+    pipe.ends[1]->shutdownWrite();
+    listenTask.wait(io.waitScope);
+  }
+}
+
+ZC_BENCHMARK("HttpServer over loopback") {
+  auto io = setupAsyncIo();
+  auto& network = io.provider->getNetwork();
+  HttpHeaderTable table;
+  FixedResponseService service(table, "Hello, World!");
+  HttpServer server(io.provider->getTimer(), table, service);
+
+  auto listener = network.parseAddress("127.0.0.1").wait(io.waitScope)->listen();
+  auto listenTask = server.listenHttp(*listener);
+  auto address = network.parseAddress("127.0.0.1", listener->getPort()).wait(io.waitScope);
+  HttpHeaders requestHeaders(table);
+
+  auto get = [&](HttpClient& client) {
+    auto response =
+        client.request(HttpMethod::GET, "/", requestHeaders).response.wait(io.waitScope);
+    doNotOptimize(response.body->readAllText().wait(io.waitScope));
+  };
+
+  // Requests per second is one over the median.
+  {
+    auto connection = address->connect().wait(io.waitScope);
+    auto client = newHttpClient(table, *connection);
+    benchmark.run("keep-alive", [&]() { get(*client); });
+  }
+
+  benchmark.run("connection per request", [&]() {
+    auto connection = address->connect().wait(io.waitScope);
+    auto client = newHttpClient(table, *connection);
+    get(*client);
+  });
+
+  // Several connections at once, as a server usually has.
+  constexpr uint CONNECTION_COUNT = 16;
+  Vector<Own<AsyncIoStream>> connections;
+  Vector<Own<HttpClient>> clients;
+  for (uint i = 0; i < CONNECTION_COUNT; i++) {
+    connections.add(address->connect().wait(io.waitScope));
+    clients.add(newHttpClient(table, *connections.back()));
+  }
+  benchmark.setItemsPerIteration(CONNECTION_COUNT);
+  benchmark.run(str("concurrent/", CONNECTION_COUNT), [&]() {
+    auto responses = heapArrayBuilder<Promise<String>>(CONNECTION_COUNT);
+    for (auto& client : clients) {
+      auto response = client->request(HttpMethod::GET, "/", requestHeaders).response;
+      responses.add(response.then([](HttpClient::Response&& response) {
+        return response.body->readAllText().attach(zc::mv(response.body));
+      }));
+    }
+    doNotOptimize(joinPromises(responses.finish()).wait(io.waitScope));
+  });
+}
+
+}  // namespace
+}  // namespace zc
@@ -24,6 +24,8 @@
 #include <stdint.h>
 
 #include "zc/core/debug.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
 
 namespace zc {
 
@@ -39,9 +41,13 @@ Arena::Arena(ArrayPtr<byte> scratch) : nextChunkSize(zc::max(sizeof(ChunkHeader)
     // Don't place the chunk in the chunk list because it's not ours to delete.  Just make it the
     // current chunk so that we'll allocate from it until it is empty.
     currentChunk = chunk;
+    scratchChunk = chunk;
   }
 }
 
+Arena::Arena(ArenaChunkPool& chunkPool, size_t chunkSizeHint)
+    : nextChunkSize(zc::max(sizeof(ChunkHeader), chunkSizeHint)), chunkPool(&chunkPool) {}
+
 Arena::~Arena() noexcept(false) {
   // Run cleanup() explicitly, but if it throws an exception, make sure to run it again as part of
   // unwind.  The second call will not throw because destructors are required to guard against
@@ -51,17 +57,63 @@ Arena::~Arena() noexcept(false) {
 }
 
 void Arena::cleanup() {
+  runDestructors();
+
+  while (chunkList != nullptr) {
+    ChunkHeader* chunk = chunkList;
+    chunkList = chunkList->next;
+    freeChunk(chunk);
+  }
+}
+
+void Arena::runDestructors() {
   while (objectList != nullptr) {
     void* ptr = objectList + 1;
     auto destructor = objectList->destructor;
     objectList = objectList->next;
     destructor(ptr);
   }
+}
+
+void Arena::freeChunk(ChunkHeader* chunk) {
+  if (chunkPool != nullptr) {
+    chunkPool->give(arrayPtr(reinterpret_cast<byte*>(chunk), chunk->end));
+  } else {
+    operator delete(chunk);
+  }
+}
+
+void Arena::reset() {
+  // If a destructor throws, the arena is left as it is, and reset() or the destructor picks up
+  // where it left off.
+  runDestructors();
+
+  ChunkHeader* largest = nullptr;
+  size_t largestSize = 0;
+  for (ChunkHeader* chunk = chunkList; chunk != nullptr; chunk = chunk->next) {
+    size_t size = chunk->end - reinterpret_cast<byte*>(chunk);
+    if (size > largestSize) {
+      largest = chunk;
+      largestSize = size;
+    }
+  }
 
   while (chunkList != nullptr) {
-    void* ptr = chunkList;
+    ChunkHeader* chunk = chunkList;
     chunkList = chunkList->next;
-    operator delete(ptr);
+    if (chunk != largest) { freeChunk(chunk); }
+  }
+
+  if (largest != nullptr) {
+    largest->next = nullptr;
+    largest->pos = reinterpret_cast<byte*>(largest + 1);
+    chunkList = largest;
+    currentChunk = largest;
+  } else if (scratchChunk != nullptr) {
+    scratchChunk->pos = reinterpret_cast<byte*>(scratchChunk + 1);
+    currentChunk = scratchChunk;
+  } else {
+    currentChunk = nullptr;
   }
 }
 
@@ -131,20 +183,42 @@ void* Arena::allocateBytesInternal(size_t amount, uint alignment) {
   // Make sure we're going to allocate enough space.
   while (nextChunkSize < amount) { nextChunkSize *= 2; }
 
-  // Allocate.
-  byte* bytes = reinterpret_cast<byte*>(operator new(nextChunkSize));
+  // Allocate, from the pool if it has a chunk that is large enough.
+  ArrayPtr<byte> bytes = nullptr;
+  if (chunkPool != nullptr) {
+    ZC_IF_SOME(recycled, chunkPool->take(nextChunkSize)) { bytes = recycled; }
+  }
+  if (bytes == nullptr) {
+    bytes = arrayPtr(reinterpret_cast<byte*>(operator new(nextChunkSize)), nextChunkSize);
+  }
 
   // Set up the ChunkHeader at the beginning of the allocation.
-  ChunkHeader* newChunk = reinterpret_cast<ChunkHeader*>(bytes);
+  ChunkHeader* newChunk = reinterpret_cast<ChunkHeader*>(bytes.begin());
   newChunk->next = chunkList;
-  newChunk->pos = bytes + amount;
-  newChunk->end = bytes + nextChunkSize;
+  newChunk->pos = bytes.begin() + amount;
+  newChunk->end = bytes.end();
   currentChunk = newChunk;
   chunkList = newChunk;
   nextChunkSize *= 2;
 
   // Move past the ChunkHeader to find the position of the allocated object.
-  return alignTo(bytes + sizeof(ChunkHeader), alignment);
+  return alignTo(bytes.begin() + sizeof(ChunkHeader), alignment);
+}
+
+size_t Arena::getChunkBytes() const {
+  size_t total = 0;
+  for (ChunkHeader* chunk = chunkList; chunk != nullptr; chunk = chunk->next) {
+    total += chunk->end - reinterpret_cast<byte*>(chunk);
+  }
+  return total;
+}
+
+size_t Arena::getUsedBytes() const {
+  size_t total = 0;
+  for (ChunkHeader* chunk = chunkList; chunk != nullptr; chunk = chunk->next) {
+    total += chunk->pos - reinterpret_cast<byte*>(chunk);
+  }
+  return total;
 }
 
 StringPtr Arena::copyString(StringPtr content) {
@@ -161,4 +235,264 @@ void Arena::setDestructor(void* ptr, void (*destructor)(void*)) {
   objectList = header;
 }
 
+// =======================================================================================
+// ArenaChunkPool
+
+namespace {
+
+struct FreeChunk {
+  FreeChunk* next;
+  size_t size;
+};
+
+}  // namespace
+
+struct ArenaChunkPool::Impl {
+  size_t maxBytes;
+
+  struct State {
+    FreeChunk* chunks = nullptr;
+    size_t bytes = 0;
+    size_t count = 0;
+  };
+  MutexGuarded<State> state;
+
+  explicit Impl(size_t maxBytes) : maxBytes(maxBytes) {}
+};
+
+ArenaChunkPool::ArenaChunkPool(size_t maxBytes) : impl(heap<Impl>(maxBytes)) {}
+
+ArenaChunkPool::~ArenaChunkPool() noexcept(false) { trim(); }
+
+ArenaChunkPool& ArenaChunkPool::getGlobal() {
+  static ArenaChunkPool* pool = new ArenaChunkPool();
+  return *pool;
+}
+
+size_t ArenaChunkPool::getFreeBytes() const { return impl->state.lockShared()->bytes; }
+
+size_t ArenaChunkPool::getFreeChunkCount() const { return impl->state.lockShared()->count; }
+
+void ArenaChunkPool::trim() {
+  FreeChunk* chunks;
+  {
+    auto locked = impl->state.lockExclusive();
+    chunks = locked->chunks;
+    *locked = {};
+  }
+  while (chunks != nullptr) {
+    FreeChunk* next = chunks->next;
+    operator delete(chunks);
+    chunks = next;
+  }
+}
+
+Maybe<ArrayPtr<byte>> ArenaChunkPool::take(size_t minSize) {
+  auto locked = impl->state.lockExclusive();
+
+  // The pool holds few chunks, so a best-fit scan is cheap.
+  FreeChunk** best = nullptr;
+  for (FreeChunk** link = &locked->chunks; *link != nullptr; link = &(*link)->next) {
+    if ((*link)->size >= minSize && (best == nullptr || (*link)->size < (*best)->size)) {
+      best = link;
+    }
+  }
+  if (best == nullptr) { return zc::none; }
+
+  FreeChunk* chunk = *best;
+  *best = chunk->next;
+  locked->bytes -= chunk->size;
+  --locked->count;
+  return arrayPtr(reinterpret_cast<byte*>(chunk), chunk->size);
+}
+
+void ArenaChunkPool::give(ArrayPtr<byte> chunk) {
+  // Every chunk has room for an Arena's ChunkHeader, which is larger than a FreeChunk.
+  {
+    auto locked = impl->state.lockExclusive();
+    if (locked->bytes + chunk.size() <= impl->maxBytes) {
+      FreeChunk* freeChunk = reinterpret_cast<FreeChunk*>(chunk.begin());
+      freeChunk->next = locked->chunks;
+      freeChunk->size = chunk.size();
+      locked->chunks = freeChunk;
+      locked->bytes += chunk.size();
+      ++locked->count;
+      return;
+    }
+  }
+  operator delete(chunk.begin());
+}
+
+// =======================================================================================
+// ThreadLocalArena
+
+namespace {
+
+std::atomic<uint64_t> nextThreadLocalArenaId{1};
+std::atomic<uint64_t> nextArenaThreadKey{1};
+
+struct CachedArena {
+  uint64_t owner = 0;
+  Arena* arena = nullptr;
+};
+
+thread_local uint64_t arenaThreadKey = 0;
+thread_local CachedArena cachedArena;
+// The arena the thread allocated from last.  Checking it first keeps the common case of a thread
+// repeatedly allocating from the same ThreadLocalArena lock-free.
+
+}  // namespace
+
+struct ThreadLocalArena::Impl {
+  size_t chunkSizeHint;
+  MutexGuarded<HashMap<uint64_t, Own<Arena>>> arenas;
+  // Keyed by `arenaThreadKey`.
+
+  explicit Impl(size_t chunkSizeHint) : chunkSizeHint(chunkSizeHint) {}
+};
+
+ThreadLocalArena::ThreadLocalArena(size_t chunkSizeHint)
+    : impl(heap<Impl>(chunkSizeHint)),
+      id(nextThreadLocalArenaId.fetch_add(1, std::memory_order_relaxed)) {}
+
+ThreadLocalArena::~ThreadLocalArena() noexcept(false) {}
+
+Arena& ThreadLocalArena::getArena() {
+  if (cachedArena.owner == id) { return *cachedArena.arena; }
+
+  if (arenaThreadKey == 0) {
+    arenaThreadKey = nextArenaThreadKey.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Arena& arena = *impl->arenas.lockExclusive()->findOrCreate(arenaThreadKey, [&]() {
+    return HashMap<uint64_t, Own<Arena>>::Entry{arenaThreadKey, heap<Arena>(impl->chunkSizeHint)};
+  });
+  cachedArena = {id, &arena};
+  return arena;
+}
+
+StringPtr ThreadLocalArena::copyString(StringPtr content) {
+  return getArena().copyString(content);
+}
+
+size_t ThreadLocalArena::getArenaCount() const { return impl->arenas.lockShared()->size(); }
+
+size_t ThreadLocalArena::getChunkBytes() const {
+  size_t total = 0;
+  for (auto& entry : *impl->arenas.lockShared()) { total += entry.value->getChunkBytes(); }
+  return total;
+}
+
+// =======================================================================================
+// ConcurrentArena
+
+ConcurrentArena::ConcurrentArena(size_t chunkSizeHint)
+    : nextChunkSize(zc::max(sizeof(ChunkHeader), chunkSizeHint)) {}
+
+ConcurrentArena::~ConcurrentArena() noexcept(false) {
+  // See Arena::~Arena().
+  ZC_ON_SCOPE_FAILURE(cleanup());
+  cleanup();
+}
+
+void ConcurrentArena::cleanup() {
+  // The arena is no longer shared by now, so relaxed accesses suffice.
+  for (;;) {
+    ObjectHeader* object = objectList.load(std::memory_order_relaxed);
+    if (object == nullptr) { break; }
+    objectList.store(object->next, std::memory_order_relaxed);
+    object->destructor(object + 1);
+  }
+
+  for (;;) {
+    ChunkHeader* chunk = currentChunk.load(std::memory_order_relaxed);
+    if (chunk == nullptr) { break; }
+    currentChunk.store(chunk->next, std::memory_order_relaxed);
+    chunk->~ChunkHeader();
+    operator delete(chunk);
+  }
+}
+
+void* ConcurrentArena::allocateBytes(size_t amount, uint alignment, bool hasDisposer) {
+  if (hasDisposer) {
+    alignment = zc::max(alignment, alignof(ObjectHeader));
+    amount += alignTo(sizeof(ObjectHeader), alignment);
+  }
+
+  void* result = allocateBytesInternal(amount, alignment);
+
+  if (hasDisposer) {
+    result = alignTo(reinterpret_cast<byte*>(result) + sizeof(ObjectHeader), alignment);
+  }
+
+  ZC_DASSERT(reinterpret_cast<uintptr_t>(result) % alignment == 0);
+  return result;
+}
+
+void* ConcurrentArena::allocateBytesInternal(size_t amount, uint alignment) {
+  // Claim enough bytes that an aligned pointer fits whatever position the claim starts at, since
+  // the position can't be aligned before claiming without a compare-and-swap loop.  This wastes
+  // less than `alignment` bytes per allocation.
+  size_t claim = amount + alignment - 1;
+
+  ChunkHeader* chunk = currentChunk.load(std::memory_order_acquire);
+  for (;;) {
+    if (chunk != nullptr) {
+      byte* base = reinterpret_cast<byte*>(chunk);
+      size_t offset = chunk->pos.fetch_add(claim, std::memory_order_relaxed);
+      if (offset < size_t(chunk->end - base) && claim <= size_t(chunk->end - base) - offset) {
+        return alignTo(base + offset, alignment);
+      }
+      // The chunk is full.  `pos` keeps growing past its end as other threads fail too, which is
+      // harmless.
+    }
+
+    // Allocate a new chunk with room for the header and this allocation, as in Arena.
+    size_t headerSize = alignTo(sizeof(ChunkHeader), alignment);
+    size_t chunkSize = nextChunkSize.load(std::memory_order_relaxed);
+    while (chunkSize < headerSize + claim) { chunkSize *= 2; }
+
+    byte* bytes = reinterpret_cast<byte*>(operator new(chunkSize));
+    ChunkHeader* newChunk = new (bytes) ChunkHeader;
+    newChunk->next = chunk;
+    newChunk->end = bytes + chunkSize;
+    newChunk->pos.store(headerSize + claim, std::memory_order_relaxed);
+
+    if (currentChunk.compare_exchange_strong(chunk, newChunk, std::memory_order_acq_rel,
+                                             std::memory_order_acquire)) {
+      nextChunkSize.store(chunkSize * 2, std::memory_order_relaxed);
+      return alignTo(bytes + headerSize, alignment);
+    }
+
+    // Another thread installed a chunk first, and `chunk` is now that one.  Nobody else has seen
+    // ours, so free it and try again in theirs.
+    newChunk->~ChunkHeader();
+    operator delete(bytes);
+  }
+}
+
+size_t ConcurrentArena::getChunkBytes() const {
+  size_t total = 0;
+  for (ChunkHeader* chunk = currentChunk.load(std::memory_order_acquire); chunk != nullptr;
+       chunk = chunk->next) {
+    total += chunk->end - reinterpret_cast<byte*>(chunk);
+  }
+  return total;
+}
+
+StringPtr ConcurrentArena::copyString(StringPtr content) {
+  char* data = reinterpret_cast<char*>(allocateBytes(content.size() + 1, 1, false));
+  memcpy(data, content.cStr(), content.size() + 1);
+  return StringPtr(data, content.size());
+}
+
+void ConcurrentArena::setDestructor(void* ptr, void (*destructor)(void*)) {
+  ObjectHeader* header = reinterpret_cast<ObjectHeader*>(ptr) - 1;
+  ZC_DASSERT(reinterpret_cast<uintptr_t>(header) % alignof(ObjectHeader) == 0);
+  header->destructor = destructor;
+  header->next = objectList.load(std::memory_order_relaxed);
+  while (!objectList.compare_exchange_weak(header->next, header, std::memory_order_release,
+                                           std::memory_order_relaxed)) {}
+}
+
 }  // namespace zc
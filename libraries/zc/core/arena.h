@@ -29,14 +29,53 @@ ZC_BEGIN_HEADER
 namespace zc {
 class StringPtr;
 
+class ArenaChunkPool {
+  // A freelist of arena chunks.  Arenas constructed with a pool take their chunks from it when it
+  // has one large enough, and give their chunks back to it when they are reset or destroyed, so
+  // that short-lived arenas reuse memory instead of going back to the heap allocator every time.
+  //
+  // A pool may be shared by any number of threads; taking or giving a chunk takes the pool's lock,
+  // but that only happens once per chunk.
+
+public:
+  explicit ArenaChunkPool(size_t maxBytes = 8u << 20);
+  // The pool keeps at most `maxBytes` of free chunks, and frees chunks given beyond that.
+
+  ZC_DISALLOW_COPY_AND_MOVE(ArenaChunkPool);
+  ~ArenaChunkPool() noexcept(false);
+  // Every arena using the pool must be destroyed first.
+
+  static ArenaChunkPool& getGlobal();
+  // The process-wide pool.  It is never destroyed, so arenas using it may outlive static
+  // destructors.
+
+  size_t getFreeBytes() const;
+  size_t getFreeChunkCount() const;
+
+  void trim();
+  // Frees every chunk in the pool.
+
+private:
+  struct Impl;
+  Own<Impl> impl;
+
+  Maybe<ArrayPtr<byte>> take(size_t minSize);
+  // Removes and returns the smallest free chunk of at least `minSize` bytes.
+
+  void give(ArrayPtr<byte> chunk);
+  // Adds a chunk allocated with `operator new()` to the pool, or frees it if the pool is full.
+
+  friend class Arena;
+};
+
 class Arena {
   // A class which allows several objects to be allocated in contiguous chunks of memory, then
   // frees them all at once.
   //
   // Allocating from the same Arena in multiple threads concurrently is NOT safe, because making
   // it safe would require atomic operations that would slow down allocation even when
-  // single-threaded.  If you need to use arena allocation in a multithreaded context, consider
-  // allocating thread-local arenas.
+  // single-threaded.  If you need to use arena allocation in a multithreaded context, use
+  // ThreadLocalArena or ConcurrentArena, below.
 
 public:
   explicit Arena(size_t chunkSizeHint = 1024);
@@ -47,6 +86,10 @@ public:
   explicit Arena(ArrayPtr<byte> scratch);
   // Allocates from the given scratch space first, only resorting to the heap when it runs out.
 
+  explicit Arena(ArenaChunkPool& chunkPool, size_t chunkSizeHint = 1024);
+  // Takes chunks from the given pool when it has one large enough, rather than from the heap,
+  // and gives them back to it when reset or destroyed.  The pool must outlive the arena.
+
   ZC_DISALLOW_COPY_AND_MOVE(Arena);
   ~Arena() noexcept(false);
 
@@ -81,6 +124,23 @@ public:
   StringPtr copyString(StringPtr content);
   // Make a copy of the given string inside the arena, and return a pointer to the copy.
 
+  void reset();
+  // Runs the destructors of everything allocated so far, as the destructor would, and makes the
+  // arena empty again.  The largest chunk is kept and allocated from anew; the others are given
+  // to the chunk pool, if any, or freed.  Objects allocated with allocateOwn() and friends must
+  // be gone by then, as with destruction.  An arena which has no chunk of its own goes back to
+  // its scratch space.
+
+  size_t getChunkBytes() const;
+  // Total size of the chunks this arena has taken from the heap or its chunk pool.  Chunks are
+  // only freed with the arena or by reset(), so this is also its peak footprint since the last
+  // reset().  Scratch space given to the constructor is not counted.
+
+  size_t getUsedBytes() const;
+  // The part of getChunkBytes() allocated so far, chunk headers and alignment padding included.
+  // The rest is slack: room at the ends of chunks that no allocation has claimed, including what
+  // was left behind in a chunk too full for the allocation that started the next one.
+
 private:
   struct ChunkHeader {
     ChunkHeader* next;
@@ -98,11 +158,19 @@ private:
 
   ChunkHeader* currentChunk = nullptr;
 
+  ChunkHeader* scratchChunk = nullptr;
+  ArenaChunkPool* chunkPool = nullptr;
+
   void cleanup();
   // Run all destructors, leaving the above pointers null.  If a destructor throws, the State is
   // left in a consistent state, such that if cleanup() is called again, it will pick up where
   // it left off.
 
+  void runDestructors();
+  // The first half of cleanup(), shared with reset().
+
+  void freeChunk(ChunkHeader* chunk);
+
   void* allocateBytes(size_t amount, uint alignment, bool hasDisposer);
   // Allocate the given number of bytes.  `hasDisposer` must be true if `setDisposer()` may be
   // called on this pointer later.
@@ -128,6 +196,114 @@ private:
   static void destroyObject(void* pointer) {
     dtor(*reinterpret_cast<T*>(pointer));
   }
+
+  friend class ConcurrentArena;
+};
+
+class ThreadLocalArena {
+  // An arena which any number of threads may allocate from at once, by giving each thread an
+  // Arena of its own.  The arenas all belong to the ThreadLocalArena and are freed with it, so
+  // objects allocated by one thread may be used by others, and outlive the thread.
+  //
+  // Allocation takes no lock as long as the calling thread keeps allocating from the same
+  // ThreadLocalArena; only a thread's first allocation, or one that follows an allocation from
+  // a different ThreadLocalArena, has to look up the thread's arena under a lock.
+
+public:
+  explicit ThreadLocalArena(size_t chunkSizeHint = 1024);
+  // `chunkSizeHint` is passed to each thread's Arena.
+
+  ZC_DISALLOW_COPY_AND_MOVE(ThreadLocalArena);
+  ~ThreadLocalArena() noexcept(false);
+
+  Arena& getArena();
+  // Returns the calling thread's arena, creating it on first use.  Only the calling thread may
+  // allocate from it.
+
+  template <typename T, typename... Params>
+  inline T& allocate(Params&&... params) {
+    return getArena().allocate<T>(zc::fwd<Params>(params)...);
+  }
+  template <typename T>
+  inline ArrayPtr<T> allocateArray(size_t size) {
+    return getArena().allocateArray<T>(size);
+  }
+  template <typename T>
+  inline T& copy(T&& value) {
+    return getArena().copy(zc::fwd<T>(value));
+  }
+  StringPtr copyString(StringPtr content);
+  // Like the same methods of Arena, on the calling thread's arena.  Destructors run when the
+  // ThreadLocalArena is destroyed, one thread's arena at a time.
+
+  size_t getArenaCount() const;
+  // Number of threads which have allocated from this arena.
+
+  size_t getChunkBytes() const;
+  // Total of getChunkBytes() over every thread's arena.  Must not be called while another thread
+  // may be allocating.
+
+private:
+  struct Impl;
+  Own<Impl> impl;
+  uint64_t id;
+  // Unique among all ThreadLocalArenas ever created, so that a thread's cached arena is never
+  // mistaken for one of a new ThreadLocalArena at the same address.
+};
+
+class ConcurrentArena {
+  // An arena which any number of threads may allocate from at once.  Allocation bumps the current
+  // chunk's position atomically, so it takes no lock, but every allocation is an atomic operation
+  // on a cache line shared by all threads.  When many threads allocate heavily, ThreadLocalArena
+  // will scale better; ConcurrentArena suits allocations scattered across threads, and keeps them
+  // in fewer chunks.
+  //
+  // A thread that finds the current chunk full allocates the next one and installs it with a
+  // compare-and-swap.  If another thread installed one first, it frees its own and retries in the
+  // winner's.
+
+public:
+  explicit ConcurrentArena(size_t chunkSizeHint = 1024);
+  ZC_DISALLOW_COPY_AND_MOVE(ConcurrentArena);
+  ~ConcurrentArena() noexcept(false);
+
+  template <typename T, typename... Params>
+  T& allocate(Params&&... params);
+  template <typename T>
+  ArrayPtr<T> allocateArray(size_t size);
+  template <typename T>
+  inline T& copy(T&& value) {
+    return allocate<Decay<T>>(zc::fwd<T>(value));
+  }
+  StringPtr copyString(StringPtr content);
+  // Like the same methods of Arena.  Destructors run in the opposite order of the allocations'
+  // construction, as the threads finished them.
+
+  size_t getChunkBytes() const;
+  // Total size of the chunks this arena has taken from the heap.  May be called at any time, but
+  // only counts the chunks installed so far.
+
+private:
+  struct ChunkHeader {
+    ChunkHeader* next;
+    byte* end;
+    std::atomic<size_t> pos;  // offset of the first unallocated byte from the chunk's start
+  };
+  struct ObjectHeader {
+    void (*destructor)(void*);
+    ObjectHeader* next;
+  };
+
+  std::atomic<size_t> nextChunkSize;
+  std::atomic<ChunkHeader*> currentChunk = nullptr;
+  // Each chunk's `next` is the chunk that was current before it, so this is also the chunk list.
+  std::atomic<ObjectHeader*> objectList = nullptr;
+
+  void cleanup();
+
+  void* allocateBytes(size_t amount, uint alignment, bool hasDisposer);
+  void* allocateBytesInternal(size_t amount, uint alignment);
+  void setDestructor(void* ptr, void (*destructor)(void*));
 };
 
 // =======================================================================================
@@ -200,6 +376,48 @@ ArrayBuilder<T> Arena::allocateOwnArrayBuilder(size_t capacity) {
       DestructorOnlyArrayDisposer::instance);
 }
 
+template <typename T, typename... Params>
+T& ConcurrentArena::allocate(Params&&... params) {
+  T& result =
+      *reinterpret_cast<T*>(allocateBytes(sizeof(T), alignof(T), !ZC_HAS_TRIVIAL_DESTRUCTOR(T)));
+  if (!ZC_HAS_TRIVIAL_CONSTRUCTOR(T) || sizeof...(Params) > 0) {
+    ctor(result, zc::fwd<Params>(params)...);
+  }
+  if (!ZC_HAS_TRIVIAL_DESTRUCTOR(T)) { setDestructor(&result, &Arena::destroyObject<T>); }
+  return result;
+}
+
+template <typename T>
+ArrayPtr<T> ConcurrentArena::allocateArray(size_t size) {
+  if (ZC_HAS_TRIVIAL_DESTRUCTOR(T)) {
+    ArrayPtr<T> result =
+        arrayPtr(reinterpret_cast<T*>(allocateBytes(sizeof(T) * size, alignof(T), false)), size);
+    if (!ZC_HAS_TRIVIAL_CONSTRUCTOR(T)) {
+      for (size_t i = 0; i < size; i++) { ctor(result[i]); }
+    }
+    return result;
+  } else {
+    // Same layout as Arena::allocateArray().
+    constexpr size_t prefixSize = zc::max(alignof(T), sizeof(size_t));
+    void* base = allocateBytes(sizeof(T) * size + prefixSize, alignof(T), true);
+    size_t& tag = *reinterpret_cast<size_t*>(base);
+    ArrayPtr<T> result =
+        arrayPtr(reinterpret_cast<T*>(reinterpret_cast<byte*>(base) + prefixSize), size);
+    setDestructor(base, &Arena::destroyArray<T>);
+
+    if (ZC_HAS_TRIVIAL_CONSTRUCTOR(T)) {
+      tag = size;
+    } else {
+      tag = 0;
+      for (size_t i = 0; i < size; i++) {
+        ctor(result[i]);
+        tag = i + 1;
+      }
+    }
+    return result;
+  }
+}
+
 }  // namespace zc
 
 ZC_END_HEADER
@@ -61,21 +61,42 @@ void NullArrayDisposer::disposeImpl(void* firstElement, size_t elementSize, size
 
 namespace _ {  // private
 
+#if ZC_HEAP_ALLOCATOR
+constexpr size_t HEAP_ARRAY_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+// The element type's alignment isn't passed down here, so give every array what operator new would.
+#endif  // ZC_HEAP_ALLOCATOR
+
 struct AutoDeleter {
   void* ptr;
+  size_t size;
   inline void* release() {
     void* result = ptr;
     ptr = nullptr;
     return result;
   }
-  inline AutoDeleter(void* ptr) : ptr(ptr) {}
-  inline ~AutoDeleter() { operator delete(ptr); }
+  inline AutoDeleter(void* ptr, size_t size) : ptr(ptr), size(size) {}
+  inline ~AutoDeleter() {
+#if ZC_HEAP_ALLOCATOR
+    if (ptr != nullptr) { deallocateHeap(ptr, size, HEAP_ARRAY_ALIGNMENT); }
+#else
+    operator delete(ptr);
+#endif  // ZC_HEAP_ALLOCATOR
+  }
 };
 
+inline void* allocateArrayBytes(size_t size) {
+#if ZC_HEAP_ALLOCATOR
+  return allocateHeap(size, HEAP_ARRAY_ALIGNMENT);
+#else
+  return operator new(size);
+#endif  // ZC_HEAP_ALLOCATOR
+}
+
 void* HeapArrayDisposer::allocateImpl(size_t elementSize, size_t elementCount, size_t capacity,
                                       void (*constructElement)(void*),
                                       void (*destroyElement)(void*)) {
-  AutoDeleter result(operator new(elementSize * capacity));
+  AutoDeleter result(allocateArrayBytes(elementSize * capacity), elementSize * capacity);
+  trackAllocation(AllocationKind::ARRAY, elementSize * capacity);
 
   if (constructElement == nullptr) {
     // Nothing to do.
@@ -97,8 +118,9 @@ void* HeapArrayDisposer::allocateImpl(size_t elementSize, size_t elementCount, s
 
 void HeapArrayDisposer::disposeImpl(void* firstElement, size_t elementSize, size_t elementCount,
                                     size_t capacity, void (*destroyElement)(void*)) const {
-  // Note that capacity is ignored since operator delete() doesn't care about it.
-  AutoDeleter deleter(firstElement);
+  // The capacity only matters to a HeapAllocator; operator delete() doesn't care about it.
+  AutoDeleter deleter(firstElement, elementSize * capacity);
+  trackAllocation(AllocationKind::ARRAY_DISPOSAL, 0);
 
   if (destroyElement != nullptr) {
     ExceptionSafeArrayUtil guard(firstElement, elementSize, elementCount, destroyElement);
@@ -178,4 +178,90 @@ void CidrRange::zeroIrrelevantBits() {
   }
 }
 
+// =======================================================================================
+
+namespace {
+
+constexpr byte V6MAPPED_PREFIX[12] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff};
+
+}  // namespace
+
+CidrSet::CidrSet() {
+  nodes.add();  // INET4_ROOT
+  nodes.add();  // INET6_ROOT
+}
+
+CidrSet::CidrSet(ArrayPtr<const CidrRange> ranges) : CidrSet() { addAll(ranges); }
+
+void CidrSet::add(const CidrRange& range) {
+  uint32_t node = range.family == AF_INET ? INET4_ROOT : INET6_ROOT;
+  for (uint i = 0; i < range.bitCount; i++) {
+    uint bit = (range.bits[i / 8] >> (7 - i % 8)) & 1;
+    uint32_t child = nodes[node].children[bit];
+    if (child == 0) {
+      child = nodes.size();
+      nodes.add();
+      nodes[node].children[bit] = child;
+    }
+    node = child;
+  }
+
+  nodes[node].terminal = true;
+  ++count;
+  if (range.family == AF_INET) hasInet4 = true;
+}
+
+void CidrSet::addAll(ArrayPtr<const CidrRange> ranges) {
+  for (auto& range : ranges) { add(range); }
+}
+
+Maybe<uint> CidrSet::lookup(uint32_t root, const byte* bits, uint bitCount) const {
+  Maybe<uint> result;
+  uint32_t node = root;
+  for (uint i = 0;; i++) {
+    if (nodes[node].terminal) result = i;
+    if (i == bitCount) break;
+
+    node = nodes[node].children[(bits[i / 8] >> (7 - i % 8)) & 1];
+    if (node == 0) break;
+  }
+  return result;
+}
+
+Maybe<uint> CidrSet::findLongestMatch(const struct sockaddr* addr) const {
+  switch (addr->sa_family) {
+    case AF_INET:
+      return lookup(INET4_ROOT,
+                    reinterpret_cast<const byte*>(
+                        &reinterpret_cast<const struct sockaddr_in*>(addr)->sin_addr.s_addr),
+                    32);
+
+    case AF_INET6: {
+      const byte* bits = reinterpret_cast<const struct sockaddr_in6*>(addr)->sin6_addr.s6_addr;
+      Maybe<uint> result = lookup(INET6_ROOT, bits, 128);
+      if (hasInet4 && arrayPtr(bits, sizeof(V6MAPPED_PREFIX)) == V6MAPPED_PREFIX) {
+        // A v6-mapped address also matches IPv4 ranges, as with CidrRange::matches().
+        ZC_IF_SOME(specificity, lookup(INET4_ROOT, bits + sizeof(V6MAPPED_PREFIX), 32)) {
+          result = zc::max(specificity, result.orDefault(0));
+        }
+      }
+      return result;
+    }
+
+    default:
+      return zc::none;
+  }
+}
+
+bool CidrSet::matchesFamily(int family) const {
+  switch (family) {
+    case AF_INET:
+      return hasInet4;
+    case AF_INET6:
+      return count > 0;
+    default:
+      return false;
+  }
+}
+
 }  // namespace zc
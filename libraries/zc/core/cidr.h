@@ -25,6 +25,7 @@
 #include <cstdint>
 
 #include "zc/core/common.h"
+#include "zc/core/vector.h"
 
 ZC_BEGIN_HEADER
 
@@ -59,6 +60,52 @@ private:
   CidrRange(int family, ArrayPtr<const byte> bits, uint bitCount);
 
   void zeroIrrelevantBits();
+
+  friend class CidrSet;
+};
+
+class CidrSet {
+  // A set of CidrRanges compiled into a binary trie per address family, so that an address is
+  // matched against all of them in time proportional to its length -- at most 32 steps for IPv4
+  // and 128 for IPv6 -- rather than to the number of ranges. Matches addresses the same way as
+  // CidrRange::matches(), including IPv4 ranges matching v4-mapped IPv6 addresses.
+
+public:
+  CidrSet();
+  explicit CidrSet(ArrayPtr<const CidrRange> ranges);
+  ZC_DISALLOW_COPY(CidrSet);
+  CidrSet(CidrSet&&) = default;
+  CidrSet& operator=(CidrSet&&) = default;
+
+  void add(const CidrRange& range);
+  void addAll(ArrayPtr<const CidrRange> ranges);
+
+  size_t size() const { return count; }
+  // The number of ranges added, counting duplicates.
+
+  Maybe<uint> findLongestMatch(const struct sockaddr* addr) const;
+  // The specificity of the most specific range that matches `addr`, or none if no range does.
+
+  bool matches(const struct sockaddr* addr) const { return findLongestMatch(addr) != zc::none; }
+  bool matchesFamily(int family) const;
+  // Whether any range can match an address of `family`, like CidrRange::matchesFamily().
+
+private:
+  struct Node {
+    uint32_t children[2] = {0, 0};
+    // Indexes into `nodes`; 0 for none, since the roots are no one's children.
+    bool terminal = false;
+    // Whether a range ends here.
+  };
+
+  static constexpr uint32_t INET4_ROOT = 0;
+  static constexpr uint32_t INET6_ROOT = 1;
+
+  Vector<Node> nodes;
+  size_t count = 0;
+  bool hasInet4 = false;
+
+  Maybe<uint> lookup(uint32_t root, const byte* bits, uint bitCount) const;
 };
 
 }  // namespace zc
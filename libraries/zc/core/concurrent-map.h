@@ -0,0 +1,251 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "zc/core/hash.h"
+#include "zc/core/mutex.h"
+#include "zc/core/table.h"
+#include "zc/core/vector.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+class ConcurrentHashMapCallbacks {
+public:
+  template <typename Entry>
+  inline auto& keyForRow(Entry& entry) const {
+    return entry.key;
+  }
+
+  template <typename Entry, typename KeyLike>
+  inline bool matches(Entry& entry, KeyLike&& key) const {
+    return entry.key == key;
+  }
+  template <typename KeyLike>
+  inline auto hashCode(KeyLike&& key) const {
+    return zc::hashCode(key);
+  }
+};
+
+}  // namespace _
+
+template <typename Key, typename Value, typename Callbacks = _::ConcurrentHashMapCallbacks>
+class ConcurrentHashMap {
+  // A key/value mapping that any number of threads may use at once.
+  //
+  // The map is split into SHARD_COUNT shards by the high bits of each key's hash, each a
+  // `Table<Entry, HashIndex<Callbacks>>` behind its own reader/writer lock, so that threads only
+  // contend when they touch the same shard, and lookups only take a shared lock. `Callbacks`
+  // has the interface `HashIndex` expects (see `table.h`), over `Entry` rows; the default hashes
+  // with `zc::hashCode()` and compares with `operator==()`, like `HashMap`, so a `String`-keyed
+  // map accepts `StringPtr` lookups. It must be default-constructible.
+  //
+  // Since another thread may rehash a shard as soon as its lock is released, no reference into the
+  // map is ever handed out: lookups return a copy of the value, or pass the entry to a callback
+  // that runs under the shard's lock. Such a callback must not use the same map, or it may
+  // deadlock.
+
+public:
+  static constexpr uint SHARD_BITS = 6;
+  static constexpr uint SHARD_COUNT = 1u << SHARD_BITS;
+
+  struct Entry {
+    Key key;
+    Value value;
+  };
+
+  size_t size() const;
+  // Sums the shards' sizes, locking each in turn, so it is only exact if no other thread is
+  // modifying the map.
+
+  void reserve(size_t size);
+  // Pre-allocates space in every shard for a map of the given size, assuming keys spread evenly.
+
+  void clear();
+
+  void insert(Key key, Value value);
+  // Inserts a new entry. Throws if the key already exists.
+
+  template <typename KeyLike>
+  Maybe<Value> find(KeyLike&& key) const;
+  // Returns a copy of the value for the matching key. Requires `Value` to be copyable.
+
+  template <typename KeyLike, typename Func>
+  bool find(KeyLike&& key, Func&& func) const;
+  // If the key is present, calls `func(const Entry&)` under the shard's shared lock and returns
+  // true.
+
+  template <typename KeyLike, typename Func>
+  Value findOrCreate(KeyLike&& key, Func&& createEntry);
+  // Like find() but if the key isn't present then call createEntry() to create the corresponding
+  // entry and insert it. createEntry() must return type `Entry`, and runs under the shard's
+  // exclusive lock, so that it is called at most once per key even when several threads ask for
+  // the same key at once. Keys that are already present only take the shared lock.
+
+  template <typename UpdateFunc>
+  void upsert(Key key, Value value, UpdateFunc&& update);
+  void upsert(Key key, Value value);
+  // Tries to insert a new entry. However, if the key already exists, then
+  // update(Value& existingValue, Value&& newValue) is called, under the shard's exclusive lock, to
+  // modify the existing value. If no function is provided, the default is to simply replace the
+  // value (but not the key).
+
+  template <typename KeyLike>
+  bool erase(KeyLike&& key);
+  // Erase the entry with the matching key.
+
+  template <typename Func>
+  void forEach(Func&& func) const;
+  // Calls `func(const Entry&)` for every entry, one shard at a time under its shared lock. Each
+  // shard is seen as of one moment, but entries that other threads insert or erase meanwhile may
+  // or may not be seen, depending on whether their shard was visited yet.
+
+  Array<Entry> snapshot() const;
+  // Copies every entry, as forEach() visits them. Requires `Key` and `Value` to be copyable.
+
+private:
+  struct alignas(64) Shard {
+    // Padded to a cache line so that threads locking neighbouring shards do not contend.
+    MutexGuarded<Table<Entry, HashIndex<Callbacks>>> table;
+  };
+
+  Callbacks cb;
+  Shard shards[SHARD_COUNT];
+
+  template <typename KeyLike>
+  inline Shard& getShard(KeyLike& key) {
+    // The high bits, since the tables' buckets use the low ones.
+    return shards[uint(cb.hashCode(key)) >> (32 - SHARD_BITS)];
+  }
+  template <typename KeyLike>
+  inline const Shard& getShard(KeyLike& key) const {
+    return shards[uint(cb.hashCode(key)) >> (32 - SHARD_BITS)];
+  }
+};
+
+// =======================================================================================
+// inline implementation details
+
+template <typename Key, typename Value, typename Callbacks>
+size_t ConcurrentHashMap<Key, Value, Callbacks>::size() const {
+  size_t result = 0;
+  for (auto& shard : shards) { result += shard.table.lockShared()->size(); }
+  return result;
+}
+
+template <typename Key, typename Value, typename Callbacks>
+void ConcurrentHashMap<Key, Value, Callbacks>::reserve(size_t size) {
+  size_t perShard = (size + SHARD_COUNT - 1) / SHARD_COUNT;
+  for (auto& shard : shards) { shard.table.lockExclusive()->reserve(perShard); }
+}
+
+template <typename Key, typename Value, typename Callbacks>
+void ConcurrentHashMap<Key, Value, Callbacks>::clear() {
+  for (auto& shard : shards) { shard.table.lockExclusive()->clear(); }
+}
+
+template <typename Key, typename Value, typename Callbacks>
+void ConcurrentHashMap<Key, Value, Callbacks>::insert(Key key, Value value) {
+  auto& shard = getShard(key);
+  shard.table.lockExclusive()->insert(Entry{zc::mv(key), zc::mv(value)});
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename KeyLike>
+Maybe<Value> ConcurrentHashMap<Key, Value, Callbacks>::find(KeyLike&& key) const {
+  auto locked = getShard(key).table.lockShared();
+  ZC_IF_SOME(entry, locked->find(key)) { return Value(entry.value); }
+  return zc::none;
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename KeyLike, typename Func>
+bool ConcurrentHashMap<Key, Value, Callbacks>::find(KeyLike&& key, Func&& func) const {
+  auto locked = getShard(key).table.lockShared();
+  ZC_IF_SOME(entry, locked->find(key)) {
+    func(entry);
+    return true;
+  }
+  return false;
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename KeyLike, typename Func>
+Value ConcurrentHashMap<Key, Value, Callbacks>::findOrCreate(KeyLike&& key, Func&& createEntry) {
+  auto& shard = getShard(key);
+  {
+    auto locked = shard.table.lockShared();
+    ZC_IF_SOME(entry, locked->find(key)) { return Value(entry.value); }
+  }
+  // Another thread may create the entry between the two locks; Table::findOrCreate() then finds
+  // it rather than calling createEntry().
+  return Value(shard.table.lockExclusive()->findOrCreate(key, zc::fwd<Func>(createEntry)).value);
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename UpdateFunc>
+void ConcurrentHashMap<Key, Value, Callbacks>::upsert(Key key, Value value, UpdateFunc&& update) {
+  auto& shard = getShard(key);
+  shard.table.lockExclusive()->upsert(Entry{zc::mv(key), zc::mv(value)},
+                                      [&](Entry& existingEntry, Entry&& newEntry) {
+                                        update(existingEntry.value, zc::mv(newEntry.value));
+                                      });
+}
+
+template <typename Key, typename Value, typename Callbacks>
+void ConcurrentHashMap<Key, Value, Callbacks>::upsert(Key key, Value value) {
+  auto& shard = getShard(key);
+  shard.table.lockExclusive()->upsert(Entry{zc::mv(key), zc::mv(value)},
+                                      [&](Entry& existingEntry, Entry&& newEntry) {
+                                        existingEntry.value = zc::mv(newEntry.value);
+                                      });
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename KeyLike>
+bool ConcurrentHashMap<Key, Value, Callbacks>::erase(KeyLike&& key) {
+  return getShard(key).table.lockExclusive()->eraseMatch(key);
+}
+
+template <typename Key, typename Value, typename Callbacks>
+template <typename Func>
+void ConcurrentHashMap<Key, Value, Callbacks>::forEach(Func&& func) const {
+  for (auto& shard : shards) {
+    auto locked = shard.table.lockShared();
+    for (const Entry& entry : *locked) { func(entry); }
+  }
+}
+
+template <typename Key, typename Value, typename Callbacks>
+Array<typename ConcurrentHashMap<Key, Value, Callbacks>::Entry>
+ConcurrentHashMap<Key, Value, Callbacks>::snapshot() const {
+  Vector<Entry> result;
+  forEach([&](const Entry& entry) { result.add(Entry{Key(entry.key), Value(entry.value)}); });
+  return result.releaseAsArray();
+}
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/concurrent-queue.h"
+
+#if ZC_USE_FUTEX
+#include <limits.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#ifndef SYS_futex
+// Missing on Android/Bionic.
+#define SYS_futex __NR_futex
+#endif
+
+#ifndef FUTEX_WAIT_PRIVATE
+// Missing on Android/Bionic.
+#define FUTEX_WAIT_PRIVATE FUTEX_WAIT
+#define FUTEX_WAKE_PRIVATE FUTEX_WAKE
+#endif
+#endif
+
+namespace zc {
+namespace _ {  // private
+
+// The waiter announces itself before re-checking the queue, and the notifier changes the queue
+// before checking for waiters, with a full fence on each side (the notifier's is in the inline
+// notify functions). So either the waiter's re-check sees the change, or the notifier sees the
+// waiter and bumps `epoch`, which makes the waiter's sleep return immediately if it hasn't
+// started yet.
+
+uint QueueWaiter::prepareWait() {
+  waiters.fetch_add(1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+#if ZC_USE_FUTEX
+  return epoch.load(std::memory_order_relaxed);
+#else
+  return *epoch.lockShared();
+#endif
+}
+
+void QueueWaiter::cancelWait() { waiters.fetch_sub(1, std::memory_order_relaxed); }
+
+#if ZC_USE_FUTEX
+
+static_assert(sizeof(std::atomic<uint>) == sizeof(uint), "can't futex on std::atomic<uint>");
+
+void QueueWaiter::wait(uint expected) {
+  // Spurious wakeups and EINTR are fine: the caller re-checks the queue either way.
+  syscall(SYS_futex, reinterpret_cast<uint*>(&epoch), FUTEX_WAIT_PRIVATE, expected, nullptr,
+          nullptr, 0);
+  waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void QueueWaiter::wake(bool all) {
+  epoch.fetch_add(1, std::memory_order_relaxed);
+  syscall(SYS_futex, reinterpret_cast<uint*>(&epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1,
+          nullptr, nullptr, 0);
+}
+
+#else
+
+void QueueWaiter::wait(uint expected) {
+  epoch.when([expected](const uint& current) { return current != expected; }, [](uint&) {});
+  waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+void QueueWaiter::wake(bool) {
+  // The mutex wakes every waiter whose condition now holds, so there's no waking just one.
+  ++*epoch.lockExclusive();
+}
+
+#endif
+
+}  // namespace _
+}  // namespace zc
@@ -0,0 +1,353 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+
+#include "zc/core/array.h"
+#include "zc/core/mutex.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+inline size_t queueCapacity(size_t requested) {
+  // Rounds up to a power of two, so that positions map to slots with a mask.
+  ZC_IREQUIRE(requested > 0, "queue capacity must be positive");
+  size_t result = 1;
+  while (result < requested) result <<= 1;
+  return result;
+}
+
+template <typename T>
+union QueueSlot {
+  // Uninitialized storage for one element; the queue tracks which slots are occupied.
+  QueueSlot() {}
+  ~QueueSlot() {}
+  T value;
+};
+
+class QueueWaiter {
+  // Lets threads sleep until another thread has changed a lock-free queue, without taking a lock
+  // on the queue's fast path (this is what's sometimes called an "event count"). A waiter calls
+  // prepareWait(), re-checks the queue, and then calls either wait() or cancelWait(). A thread
+  // that changes the queue calls notifyOne() or notifyAll() afterwards, which costs one fence and
+  // one load when nobody is waiting.
+
+public:
+  QueueWaiter() = default;
+  ZC_DISALLOW_COPY_AND_MOVE(QueueWaiter);
+
+  uint prepareWait();
+  void wait(uint epoch);
+  void cancelWait();
+
+  inline void notifyOne() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ZC_UNLIKELY(waiters.load(std::memory_order_relaxed) != 0)) wake(false);
+  }
+  inline void notifyAll() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (ZC_UNLIKELY(waiters.load(std::memory_order_relaxed) != 0)) wake(true);
+  }
+
+private:
+  std::atomic<uint> waiters = 0;
+#if ZC_USE_FUTEX
+  std::atomic<uint> epoch = 0;
+#else
+  MutexGuarded<uint> epoch;
+#endif
+
+  void wake(bool all);
+};
+
+}  // namespace _
+
+template <typename T>
+class SpscQueue {
+  // A bounded FIFO queue for exactly one producer thread and one consumer thread, which never
+  // blocks and never locks. Each side only writes its own position, on a cache line of its own,
+  // and keeps a cached copy of the other side's so that it rarely has to read it.
+  //
+  // Use `BlockingQueue<T, SpscQueue<T>>` for a version whose push() and pop() wait.
+
+public:
+  explicit SpscQueue(size_t capacity);
+  // `capacity` is rounded up to a power of two.
+
+  ~SpscQueue() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(SpscQueue);
+
+  inline size_t capacity() const { return slots.size(); }
+
+  bool tryPush(T&& value);
+  // Adds `value` to the back of the queue, or returns false without moving it if the queue is
+  // full. Only the producer thread may call this.
+
+  Maybe<T> tryPop();
+  // Removes the front element, or returns none if the queue is empty. Only the consumer thread
+  // may call this.
+
+private:
+  Array<_::QueueSlot<T>> slots;
+  size_t mask;
+
+  alignas(64) std::atomic<size_t> head = 0;  // next position to pop; written by the consumer
+  size_t cachedTail = 0;                     // the consumer's last look at `tail`
+
+  alignas(64) std::atomic<size_t> tail = 0;  // next position to push; written by the producer
+  size_t cachedHead = 0;                     // the producer's last look at `head`
+};
+
+template <typename T>
+class MpmcQueue {
+  // A bounded FIFO queue that any number of threads may push to and pop from at once, without
+  // locks: Dmitry Vyukov's array-based queue. Each slot carries a sequence number saying whose
+  // turn it is, so a thread claims a position with one compare-and-swap on the shared push or pop
+  // index and then owns that slot until it publishes it again.
+  //
+  // It is not wait-free: a thread stalled between claiming a slot and publishing it holds up the
+  // threads that wrap around to that slot. Use `BlockingQueue<T, MpmcQueue<T>>` for a version
+  // whose push() and pop() wait.
+
+public:
+  explicit MpmcQueue(size_t capacity);
+  // `capacity` is rounded up to a power of two.
+
+  ~MpmcQueue() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(MpmcQueue);
+
+  inline size_t capacity() const { return cells.size(); }
+
+  bool tryPush(T&& value);
+  // Adds `value` to the back of the queue, or returns false without moving it if the queue is
+  // full.
+
+  Maybe<T> tryPop();
+  // Removes the front element, or returns none if the queue is empty.
+
+private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    _::QueueSlot<T> slot;
+  };
+
+  Array<Cell> cells;
+  size_t mask;
+
+  alignas(64) std::atomic<size_t> pushPos = 0;
+  alignas(64) std::atomic<size_t> popPos = 0;
+};
+
+template <typename T, typename Queue = MpmcQueue<T>>
+class BlockingQueue {
+  // Wraps a `SpscQueue<T>` or `MpmcQueue<T>` with push() and pop() that sleep while the queue is
+  // full or empty. Threads only go to the kernel when they actually need to wait, or to wake a
+  // waiter; otherwise this costs about the same as the underlying queue. The same restrictions
+  // on which threads may push and pop apply.
+
+public:
+  explicit BlockingQueue(size_t capacity) : queue(capacity) {}
+
+  inline size_t capacity() const { return queue.capacity(); }
+
+  void push(T&& value);
+  // Waits until there is room, then adds `value` to the back of the queue.
+
+  T pop();
+  // Waits until the queue is non-empty, then removes the front element.
+
+  bool tryPush(T&& value);
+  Maybe<T> tryPop();
+  // Like push() and pop(), but return immediately if they would have to wait.
+
+private:
+  Queue queue;
+  _::QueueWaiter notEmpty;
+  _::QueueWaiter notFull;
+};
+
+// =======================================================================================
+// inline implementation details
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity)
+    : slots(heapArray<_::QueueSlot<T>>(_::queueCapacity(capacity))), mask(slots.size() - 1) {}
+
+template <typename T>
+SpscQueue<T>::~SpscQueue() noexcept(false) {
+  size_t end = tail.load(std::memory_order_relaxed);
+  for (size_t pos = head.load(std::memory_order_relaxed); pos != end; pos++) {
+    dtor(slots[pos & mask].value);
+  }
+}
+
+template <typename T>
+bool SpscQueue<T>::tryPush(T&& value) {
+  size_t pos = tail.load(std::memory_order_relaxed);
+  if (pos - cachedHead == slots.size()) {
+    cachedHead = head.load(std::memory_order_acquire);
+    if (pos - cachedHead == slots.size()) return false;
+  }
+  ctor(slots[pos & mask].value, zc::mv(value));
+  tail.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+Maybe<T> SpscQueue<T>::tryPop() {
+  size_t pos = head.load(std::memory_order_relaxed);
+  if (pos == cachedTail) {
+    cachedTail = tail.load(std::memory_order_acquire);
+    if (pos == cachedTail) return zc::none;
+  }
+  T& slot = slots[pos & mask].value;
+  Maybe<T> result = zc::mv(slot);
+  dtor(slot);
+  head.store(pos + 1, std::memory_order_release);
+  return result;
+}
+
+template <typename T>
+MpmcQueue<T>::MpmcQueue(size_t capacity)
+    : cells(heapArray<Cell>(_::queueCapacity(capacity))), mask(cells.size() - 1) {
+  for (size_t i = 0; i < cells.size(); i++) {
+    cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+}
+
+template <typename T>
+MpmcQueue<T>::~MpmcQueue() noexcept(false) {
+  size_t end = pushPos.load(std::memory_order_relaxed);
+  for (size_t pos = popPos.load(std::memory_order_relaxed); pos != end; pos++) {
+    dtor(cells[pos & mask].slot.value);
+  }
+}
+
+template <typename T>
+bool MpmcQueue<T>::tryPush(T&& value) {
+  // A cell is ready for the push at position `pos` when its sequence equals `pos`; it lags behind
+  // while the pop from the previous lap hasn't finished, i.e. the queue is full.
+  Cell* cell;
+  size_t pos = pushPos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &cells[pos & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff = intptr_t(sequence) - intptr_t(pos);
+    if (diff == 0) {
+      if (pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      return false;
+    } else {
+      // Another producer got here first.
+      pos = pushPos.load(std::memory_order_relaxed);
+    }
+  }
+
+  ctor(cell->slot.value, zc::mv(value));
+  cell->sequence.store(pos + 1, std::memory_order_release);
+  return true;
+}
+
+template <typename T>
+Maybe<T> MpmcQueue<T>::tryPop() {
+  // A cell is ready for the pop at position `pos` once the push at `pos` has published it, which
+  // sets the sequence to `pos + 1`.
+  Cell* cell;
+  size_t pos = popPos.load(std::memory_order_relaxed);
+  for (;;) {
+    cell = &cells[pos & mask];
+    size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    intptr_t diff = intptr_t(sequence) - intptr_t(pos + 1);
+    if (diff == 0) {
+      if (popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      return zc::none;
+    } else {
+      // Another consumer got here first.
+      pos = popPos.load(std::memory_order_relaxed);
+    }
+  }
+
+  T& slot = cell->slot.value;
+  Maybe<T> result = zc::mv(slot);
+  dtor(slot);
+  // Hand the cell to the push one lap ahead.
+  cell->sequence.store(pos + mask + 1, std::memory_order_release);
+  return result;
+}
+
+template <typename T, typename Queue>
+inline bool BlockingQueue<T, Queue>::tryPush(T&& value) {
+  if (!queue.tryPush(zc::mv(value))) return false;
+  notEmpty.notifyOne();
+  return true;
+}
+
+template <typename T, typename Queue>
+inline Maybe<T> BlockingQueue<T, Queue>::tryPop() {
+  Maybe<T> result = queue.tryPop();
+  if (result != zc::none) notFull.notifyOne();
+  return result;
+}
+
+template <typename T, typename Queue>
+void BlockingQueue<T, Queue>::push(T&& value) {
+  for (;;) {
+    if (tryPush(zc::mv(value))) return;
+
+    // Full. Register as a waiter before checking again, so that a pop in between can't be missed.
+    uint epoch = notFull.prepareWait();
+    if (queue.tryPush(zc::mv(value))) {
+      notFull.cancelWait();
+      notEmpty.notifyOne();
+      return;
+    }
+    notFull.wait(epoch);
+  }
+}
+
+template <typename T, typename Queue>
+T BlockingQueue<T, Queue>::pop() {
+  for (;;) {
+    Maybe<T> result = tryPop();
+    ZC_IF_SOME(value, result) { return zc::mv(value); }
+
+    // Empty. Register as a waiter before checking again, so that a push in between can't be
+    // missed.
+    uint epoch = notEmpty.prepareWait();
+    result = queue.tryPop();
+    ZC_IF_SOME(value, result) {
+      notEmpty.cancelWait();
+      notFull.notifyOne();
+      return zc::mv(value);
+    }
+    notEmpty.wait(epoch);
+  }
+}
+
+}  // namespace zc
+
+ZC_END_HEADER
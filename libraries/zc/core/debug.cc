@@ -29,6 +29,7 @@
 #include <string.h>
 
 #include "zc/core/debug.h"
+#include "zc/core/log-sink.h"
 
 #if _WIN32 || __CYGWIN__
 #if !__CYGWIN__
@@ -335,6 +336,8 @@ static String makeDescriptionImpl(DescriptionStyle style, const char* code, int
 
 void Debug::logInternal(const char* file, int line, LogSeverity severity, const char* macroArgs,
                         ArrayPtr<String> argValues) {
+  if (logAsync(file, line, severity, macroArgs, argValues)) return;
+
   getExceptionCallback().logMessage(
       severity, trimSourceFilename(file).cStr(), line, 0,
       makeDescriptionImpl(LOG, nullptr, 0, nullptr, macroArgs, argValues));
@@ -459,6 +459,8 @@ namespace zc {
 
 #endif
 
+class AsyncLogSink;
+
 namespace _ {  // private
 
 class Debug {
@@ -593,6 +595,8 @@ private:
 
   static int getOsErrorNumber(bool nonblocking);
   // Get the error code of the last error (e.g. from errno).  Returns -1 on EINTR.
+
+  friend class zc::AsyncLogSink;
 };
 
 template <typename... Params>
@@ -22,8 +22,22 @@
 #include "zc/core/encoding.h"
 
 #include "zc/core/debug.h"
+#include "zc/core/io.h"
 #include "zc/core/vector.h"
 
+#if __SSE2__ || _M_X64 || (_M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZC_ENCODING_SSE2 1
+#if __SSSE3__
+// Base64 needs PSHUFB, which only builds targeting SSSE3 or better (e.g. -march=x86-64-v2) get.
+#include <tmmintrin.h>
+#define ZC_ENCODING_SSSE3 1
+#endif
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_ENCODING_NEON 1
+#endif
+
 namespace zc {
 
 namespace {
@@ -31,6 +45,64 @@ namespace {
 #define GOTO_ERROR_IF(cond) \
   if (ZC_UNLIKELY(cond)) goto error
 
+template <typename T>
+constexpr uint64_t nonAsciiMask() {
+  // Every bit above the low seven of each code unit in a 64-bit word. The lanes line up with the
+  // code units whatever the byte order, since each unit is loaded at its native width.
+  uint64_t unit = (uint64_t(1) << (sizeof(T) * 8)) - 0x80;
+  uint64_t mask = 0;
+  for (size_t i = 0; i < sizeof(uint64_t) / sizeof(T); i++) {
+    mask = (mask << (sizeof(T) * 8)) | unit;
+  }
+  return mask;
+}
+
+template <typename T>
+size_t asciiPrefixByWords(ArrayPtr<const T> text) {
+  // Returns how many code units at the start of `text` are ASCII, checking a word at a time. `T`
+  // must be unsigned.
+  const T* begin = text.begin();
+  const T* end = text.end();
+  const T* p = begin;
+
+  constexpr size_t PER_WORD = sizeof(uint64_t) / sizeof(T);
+  while (size_t(end - p) >= PER_WORD) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    if (word & nonAsciiMask<T>()) break;
+    p += PER_WORD;
+  }
+
+  while (p < end && *p < 0x80) { ++p; }
+  return p - begin;
+}
+
+inline size_t asciiPrefix(ArrayPtr<const char16_t> text) { return asciiPrefixByWords(text); }
+inline size_t asciiPrefix(ArrayPtr<const char32_t> text) { return asciiPrefixByWords(text); }
+
+size_t asciiPrefix(ArrayPtr<const byte> text) {
+  // Like asciiPrefixByWords() but 16 bytes at a time where SSE2 or NEON is available.
+  const byte* begin = text.begin();
+  const byte* end = text.end();
+  const byte* p = begin;
+
+#if ZC_ENCODING_SSE2
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if (_mm_movemask_epi8(chunk) != 0) break;
+    p += 16;
+  }
+#elif ZC_ENCODING_NEON
+  while (end - p >= 16) {
+    if (vmaxvq_u8(vld1q_u8(p)) >= 0x80) break;
+    p += 16;
+  }
+#endif
+
+  // Finishes off the tail, or the 16-byte block holding the first non-ASCII byte.
+  return (p - begin) + asciiPrefixByWords(arrayPtr(p, end));
+}
+
 inline void addChar32(Vector<char16_t>& vec, char32_t u) {
   // Encode as surrogate pair.
   u -= 0x10000;
@@ -45,14 +117,20 @@ EncodingResult<Array<T>> encodeUtf(ArrayPtr<const char> text, bool nulTerminate)
   Vector<T> result(text.size() + nulTerminate);
   bool hadErrors = false;
 
+  auto bytes = text.asBytes();
   size_t i = 0;
-  while (i < text.size()) {
-    byte c = text[i++];
+  while (i < bytes.size()) {
+    byte c = bytes[i];
     if (c < 0x80) {
-      // 0xxxxxxx -- ASCII
-      result.add(c);
+      // 0xxxxxxx -- ASCII, which is widened a run at a time.
+      auto ascii = bytes.slice(i, i + asciiPrefix(bytes.slice(i)));
+      result.addAll(ascii.begin(), ascii.end());
+      i += ascii.size();
       continue;
-    } else if (ZC_UNLIKELY(c < 0xc0)) {
+    }
+
+    ++i;
+    if (ZC_UNLIKELY(c < 0xc0)) {
       // 10xxxxxx -- malformed continuation byte
       goto error;
     } else if (c < 0xe0) {
@@ -147,18 +225,69 @@ EncodingResult<Array<char32_t>> encodeUtf32(ArrayPtr<const char> text, bool nulT
   return encodeUtf<char32_t>(text, nulTerminate);
 }
 
+bool validateUtf8(ArrayPtr<const char> text) {
+  // The well-formed byte sequences of the Unicode Standard, table 3-7: the second byte's range
+  // depends on the first, which is how overlongs, surrogates and values past U+10FFFF are excluded.
+  auto bytes = text.asBytes();
+  size_t i = 0;
+  while (i < bytes.size()) {
+    byte c = bytes[i];
+    if (c < 0x80) {
+      i += asciiPrefix(bytes.slice(i));
+      continue;
+    }
+
+    size_t length;
+    byte low = 0x80, high = 0xbf;
+    if (c < 0xc2) {
+      // A continuation byte, or the lead of an overlong 2-byte sequence.
+      return false;
+    } else if (c < 0xe0) {
+      length = 2;
+    } else if (c < 0xf0) {
+      length = 3;
+      if (c == 0xe0) {
+        low = 0xa0;
+      } else if (c == 0xed) {
+        high = 0x9f;
+      }
+    } else if (c < 0xf5) {
+      length = 4;
+      if (c == 0xf0) {
+        low = 0x90;
+      } else if (c == 0xf4) {
+        high = 0x8f;
+      }
+    } else {
+      return false;
+    }
+
+    if (bytes.size() - i < length) return false;
+    if (bytes[i + 1] < low || bytes[i + 1] > high) return false;
+    for (size_t j = 2; j < length; j++) {
+      if ((bytes[i + j] & 0xc0) != 0x80) return false;
+    }
+    i += length;
+  }
+
+  return true;
+}
+
 EncodingResult<String> decodeUtf16(ArrayPtr<const char16_t> utf16) {
   Vector<char> result(utf16.size() + 1);
   bool hadErrors = false;
 
   size_t i = 0;
   while (i < utf16.size()) {
-    char16_t u = utf16[i++];
-
-    if (u < 0x80) {
-      result.add(u);
+    if (utf16[i] < 0x80) {
+      auto ascii = utf16.slice(i, i + asciiPrefix(utf16.slice(i)));
+      result.addAll(ascii.begin(), ascii.end());
+      i += ascii.size();
       continue;
-    } else if (u < 0x0800) {
+    }
+
+    char16_t u = utf16[i++];
+    if (u < 0x0800) {
       result.addAll<std::initializer_list<char>>(
           {static_cast<char>(((u >> 6)) | 0xc0), static_cast<char>(((u) & 0x3f) | 0x80)});
       continue;
@@ -198,12 +327,15 @@ EncodingResult<String> decodeUtf32(ArrayPtr<const char32_t> utf16) {
 
   size_t i = 0;
   while (i < utf16.size()) {
-    char32_t u = utf16[i++];
-
-    if (u < 0x80) {
-      result.add(u);
+    if (utf16[i] < 0x80) {
+      auto ascii = utf16.slice(i, i + asciiPrefix(utf16.slice(i)));
+      result.addAll(ascii.begin(), ascii.end());
+      i += ascii.size();
       continue;
-    } else if (u < 0x0800) {
+    }
+
+    char32_t u = utf16[i++];
+    if (u < 0x0800) {
       result.addAll<std::initializer_list<char>>(
           {static_cast<char>(((u >> 6)) | 0xc0), static_cast<char>(((u) & 0x3f) | 0x80)});
       continue;
@@ -356,15 +488,66 @@ static Maybe<uint> tryFromOctDigit(char c) {
 
 }  // namespace
 
+char* encodeHexTo(char* __restrict__ target, ArrayPtr<const byte> input) {
+  const byte* p = input.begin();
+  const byte* end = input.end();
+
+#if ZC_ENCODING_SSE2
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i low = _mm_and_si128(chunk, _mm_set1_epi8(0x0f));
+    __m128i high = _mm_and_si128(_mm_srli_epi16(chunk, 4), _mm_set1_epi8(0x0f));
+
+    // Nibbles past 9 need moving up from ':' to 'a'.
+    auto toDigits = [](__m128i nibbles) {
+      __m128i letters = _mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9));
+      __m128i offset = _mm_add_epi8(_mm_set1_epi8('0'),
+                                    _mm_and_si128(letters, _mm_set1_epi8('a' - '0' - 10)));
+      return _mm_add_epi8(nibbles, offset);
+    };
+    high = toDigits(high);
+    low = toDigits(low);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target + 16), _mm_unpackhi_epi8(high, low));
+    p += 16;
+    target += 32;
+  }
+#elif ZC_ENCODING_NEON
+  uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(HEX_DIGITS));
+  while (end - p >= 16) {
+    uint8x16_t chunk = vld1q_u8(p);
+    uint8x16x2_t pairs = {{vqtbl1q_u8(digits, vshrq_n_u8(chunk, 4)),
+                           vqtbl1q_u8(digits, vandq_u8(chunk, vdupq_n_u8(0x0f)))}};
+    vst2q_u8(reinterpret_cast<uint8_t*>(target), pairs);
+    p += 16;
+    target += 32;
+  }
+#endif
+
+  for (; p < end; ++p) {
+    *target++ = HEX_DIGITS[*p / 16];
+    *target++ = HEX_DIGITS[*p % 16];
+  }
+  return target;
+}
+
 String encodeHex(ArrayPtr<const byte> input) {
   auto result = heapString(input.size() * 2);
-  for (auto i : zc::indices(input)) {
-    result[i * 2] = HEX_DIGITS[input[i] / 16];
-    result[i * 2 + 1] = HEX_DIGITS[input[i] % 16];
-  }
+  encodeHexTo(result.begin(), input);
   return result;
 }
 
+void encodeHex(OutputStream& output, ArrayPtr<const byte> input) {
+  char buffer[1024];
+  while (input.size() > 0) {
+    auto chunk = input.first(zc::min(input.size(), sizeof(buffer) / 2));
+    char* end = encodeHexTo(buffer, chunk);
+    output.write(arrayPtr(buffer, end).asBytes());
+    input = input.slice(chunk.size());
+  }
+}
+
 EncodingResult<Array<byte>> decodeHex(ArrayPtr<const char> text) {
   auto result = heapArray<byte>(text.size() / 2);
   bool hadErrors = text.size() % 2;
@@ -381,21 +564,111 @@ EncodingResult<Array<byte>> decodeHex(ArrayPtr<const char> text) {
   return {zc::mv(result), hadErrors};
 }
 
-String encodeUriComponent(ArrayPtr<const byte> bytes) {
-  Vector<char> result(bytes.size() + 1);
-  for (byte b : bytes) {
-    if (('A' <= b && b <= 'Z') || ('a' <= b && b <= 'z') || ('0' <= b && b <= '9') || b == '-' ||
-        b == '_' || b == '.' || b == '!' || b == '~' || b == '*' || b == '\'' || b == '(' ||
-        b == ')') {
-      result.add(b);
-    } else {
-      result.add('%');
-      result.add(HEX_DIGITS_URI[b / 16]);
-      result.add(HEX_DIGITS_URI[b % 16]);
+namespace {
+
+inline bool isUriComponentSafe(byte b) {
+  return ('A' <= b && b <= 'Z') || ('a' <= b && b <= 'z') || ('0' <= b && b <= '9') || b == '-' ||
+         b == '_' || b == '.' || b == '!' || b == '~' || b == '*' || b == '\'' || b == '(' ||
+         b == ')';
+}
+
+#if ZC_ENCODING_SSE2
+inline __m128i inRange(__m128i chunk, char low, char high) {
+  // Bytes in [low, high] are all ones. The subtraction wraps, so one unsigned comparison does.
+  __m128i offset = _mm_sub_epi8(chunk, _mm_set1_epi8(low));
+  return _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8(high - low)), offset);
+}
+#elif ZC_ENCODING_NEON
+inline uint8x16_t inRange(uint8x16_t chunk, char low, char high) {
+  return vcleq_u8(vsubq_u8(chunk, vdupq_n_u8(low)), vdupq_n_u8(high - low));
+}
+#endif
+
+size_t uriComponentSafePrefix(ArrayPtr<const byte> bytes) {
+  // Returns how many bytes at the start of `bytes` encodeUriComponent() would pass through as-is,
+  // checking 16 at a time where SSE2 or NEON is available.
+  const byte* begin = bytes.begin();
+  const byte* end = bytes.end();
+  const byte* p = begin;
+
+  // Setting 0x20 folds upper case onto lower case, which no other byte lands in 'a'-'z' from.
+#if ZC_ENCODING_SSE2
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i safe = _mm_or_si128(inRange(_mm_or_si128(chunk, _mm_set1_epi8(0x20)), 'a', 'z'),
+                                inRange(chunk, '0', '9'));
+    safe = _mm_or_si128(safe, inRange(chunk, '\'', '*'));
+    safe = _mm_or_si128(safe, inRange(chunk, '-', '.'));
+    safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('!')));
+    safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('_')));
+    safe = _mm_or_si128(safe, _mm_cmpeq_epi8(chunk, _mm_set1_epi8('~')));
+    if (_mm_movemask_epi8(safe) != 0xffff) break;
+    p += 16;
+  }
+#elif ZC_ENCODING_NEON
+  while (end - p >= 16) {
+    uint8x16_t chunk = vld1q_u8(p);
+    uint8x16_t safe = vorrq_u8(inRange(vorrq_u8(chunk, vdupq_n_u8(0x20)), 'a', 'z'),
+                               inRange(chunk, '0', '9'));
+    safe = vorrq_u8(safe, inRange(chunk, '\'', '*'));
+    safe = vorrq_u8(safe, inRange(chunk, '-', '.'));
+    safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('!')));
+    safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('_')));
+    safe = vorrq_u8(safe, vceqq_u8(chunk, vdupq_n_u8('~')));
+    if (vminvq_u8(safe) != 0xff) break;
+    p += 16;
+  }
+#endif
+
+  while (p < end && isUriComponentSafe(*p)) { ++p; }
+  return p - begin;
+}
+
+}  // namespace
+
+char* encodeUriComponentTo(char* __restrict__ target, ArrayPtr<const byte> bytes) {
+  while (bytes.size() > 0) {
+    size_t n = uriComponentSafePrefix(bytes);
+    if (n > 0) {
+      memcpy(target, bytes.begin(), n);
+      target += n;
+      bytes = bytes.slice(n);
+      if (bytes.size() == 0) break;
     }
+
+    byte b = bytes[0];
+    *target++ = '%';
+    *target++ = HEX_DIGITS_URI[b / 16];
+    *target++ = HEX_DIGITS_URI[b % 16];
+    bytes = bytes.slice(1);
+  }
+  return target;
+}
+
+String encodeUriComponent(ArrayPtr<const byte> bytes) {
+  // Size the result exactly first; finding the runs again is cheap next to growing a Vector.
+  size_t size = bytes.size();
+  for (auto rest = bytes; rest.size() > 0;) {
+    rest = rest.slice(uriComponentSafePrefix(rest));
+    if (rest.size() == 0) break;
+    size += 2;
+    rest = rest.slice(1);
+  }
+
+  auto result = heapString(size);
+  char* end = encodeUriComponentTo(result.begin(), bytes);
+  ZC_ASSERT(end == result.end());
+  return result;
+}
+
+void encodeUriComponent(OutputStream& output, ArrayPtr<const byte> bytes) {
+  char buffer[1024 * 3];
+  while (bytes.size() > 0) {
+    auto chunk = bytes.first(zc::min(bytes.size(), sizeof(buffer) / 3));
+    char* end = encodeUriComponentTo(buffer, chunk);
+    output.write(arrayPtr(buffer, end).asBytes());
+    bytes = bytes.slice(chunk.size());
   }
-  result.add('\0');
-  return String(result.releaseAsArray());
 }
 
 String encodeUriFragment(ArrayPtr<const byte> bytes) {
@@ -705,163 +978,127 @@ EncodingResult<Array<byte>> decodeBinaryCEscape(ArrayPtr<const char> text, bool
 }
 
 // =======================================================================================
-// This code is derived from libb64 which has been placed in the public domain.
-// For details, see http://sourceforge.net/projects/libb64
-
-// -------------------------------------------------------------------
-// Encoder
+// Base64
 
 namespace {
 
-typedef enum { step_A, step_B, step_C } base64_encodestep;
-
-typedef struct {
-  base64_encodestep step;
-  char result;
-  int stepcount;
-} base64_encodestate;
+const char BASE64_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+const char BASE64URL_DIGITS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
 
 const int CHARS_PER_LINE = 72;
+const int BYTES_PER_LINE = CHARS_PER_LINE / 4 * 3;
+
+char* encodeBase64Groups(char* __restrict__ target, ArrayPtr<const byte> input,
+                         const char* digits) {
+  // Encodes `input`, whose size must be a multiple of 3, four output characters per three bytes.
+  const byte* p = input.begin();
+  const byte* end = input.end();
+
+#if ZC_ENCODING_SSSE3
+  // Wojciech Muła's method: spread each 3 bytes over 4 lanes, move each 6-bit field into its lane
+  // with two multiplies, then map the fields to ASCII by adding an offset looked up per range.
+  // Each step loads 16 bytes but consumes 12, so it stops while that's still in bounds.
+  const __m128i offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                        digits[62] - 62, digits[63] - 63, 'A', 0, 0);
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    chunk =
+        _mm_shuffle_epi8(chunk, _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1));
+    __m128i high = _mm_mulhi_epu16(_mm_and_si128(chunk, _mm_set1_epi32(0x0fc0fc00)),
+                                   _mm_set1_epi32(0x04000040));
+    __m128i low = _mm_mullo_epi16(_mm_and_si128(chunk, _mm_set1_epi32(0x003f03f0)),
+                                  _mm_set1_epi32(0x01000010));
+    __m128i indices = _mm_or_si128(high, low);
+
+    // 0-25 -> 13, 26-51 -> 0, 52-61 -> 1-10, 62 -> 11, 63 -> 12.
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    __m128i upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+    range = _mm_or_si128(range, _mm_and_si128(upper, _mm_set1_epi8(13)));
+    __m128i chars = _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(target), chars);
+    p += 12;
+    target += 16;
+  }
+#endif
 
-void base64_init_encodestate(base64_encodestate* state_in) {
-  state_in->step = step_A;
-  state_in->result = 0;
-  state_in->stepcount = 0;
-}
-
-char base64_encode_value(char value_in) {
-  static const char* encoding = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
-  if (value_in > 63) return '=';
-  return encoding[(int)value_in];
+  for (; p < end; p += 3) {
+    uint32_t group = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2];
+    *target++ = digits[group >> 18];
+    *target++ = digits[(group >> 12) & 0x3f];
+    *target++ = digits[(group >> 6) & 0x3f];
+    *target++ = digits[group & 0x3f];
+  }
+  return target;
 }
 
-int base64_encode_block(const char* plaintext_in, int length_in, char* code_out,
-                        base64_encodestate* state_in, bool breakLines) {
-  const char* plainchar = plaintext_in;
-  const char* const plaintextend = plaintext_in + length_in;
-  char* codechar = code_out;
-  char result;
-  char fragment;
-
-  result = state_in->result;
-
-  switch (state_in->step) {
-    while (1) {
-      ZC_FALLTHROUGH;
-      case step_A:
-        if (plainchar == plaintextend) {
-          state_in->result = result;
-          state_in->step = step_A;
-          return codechar - code_out;
-        }
-        fragment = *plainchar++;
-        result = (fragment & 0x0fc) >> 2;
-        *codechar++ = base64_encode_value(result);
-        result = (fragment & 0x003) << 4;
-        ZC_FALLTHROUGH;
-      case step_B:
-        if (plainchar == plaintextend) {
-          state_in->result = result;
-          state_in->step = step_B;
-          return codechar - code_out;
-        }
-        fragment = *plainchar++;
-        result |= (fragment & 0x0f0) >> 4;
-        *codechar++ = base64_encode_value(result);
-        result = (fragment & 0x00f) << 2;
-        ZC_FALLTHROUGH;
-      case step_C:
-        if (plainchar == plaintextend) {
-          state_in->result = result;
-          state_in->step = step_C;
-          return codechar - code_out;
-        }
-        fragment = *plainchar++;
-        result |= (fragment & 0x0c0) >> 6;
-        *codechar++ = base64_encode_value(result);
-        result = (fragment & 0x03f) >> 0;
-        *codechar++ = base64_encode_value(result);
-
-        ++(state_in->stepcount);
-        if (breakLines && state_in->stepcount == CHARS_PER_LINE / 4) {
-          *codechar++ = '\n';
-          state_in->stepcount = 0;
-        }
+char* encodeBase64Impl(char* __restrict__ target, ArrayPtr<const byte> input, const char* digits,
+                       bool pad) {
+  size_t whole = input.size() / 3 * 3;
+  target = encodeBase64Groups(target, input.first(whole), digits);
+
+  auto rest = input.slice(whole);
+  if (rest.size() > 0) {
+    uint32_t group = uint32_t(rest[0]) << 16;
+    if (rest.size() > 1) group |= uint32_t(rest[1]) << 8;
+    *target++ = digits[group >> 18];
+    *target++ = digits[(group >> 12) & 0x3f];
+    if (rest.size() > 1) {
+      *target++ = digits[(group >> 6) & 0x3f];
+    } else if (pad) {
+      *target++ = '=';
     }
+    if (pad) *target++ = '=';
   }
-  /* control should not reach here */
-  return codechar - code_out;
+  return target;
 }
 
-int base64_encode_blockend(char* code_out, base64_encodestate* state_in, bool breakLines) {
-  char* codechar = code_out;
+}  // namespace
 
-  switch (state_in->step) {
-    case step_B:
-      *codechar++ = base64_encode_value(state_in->result);
-      *codechar++ = '=';
-      *codechar++ = '=';
-      ++state_in->stepcount;
-      break;
-    case step_C:
-      *codechar++ = base64_encode_value(state_in->result);
-      *codechar++ = '=';
-      ++state_in->stepcount;
-      break;
-    case step_A:
-      break;
+size_t encodeBase64Size(size_t byteCount, bool breakLines) {
+  // equivalent to ceil(byteCount / 3) * 4
+  size_t numChars = (byteCount + 2) / 3 * 4;
+  if (breakLines) {
+    // Add space for newline characters, including one ending a partial line.
+    numChars += (numChars + CHARS_PER_LINE - 1) / CHARS_PER_LINE;
   }
-  if (breakLines && state_in->stepcount > 0) { *codechar++ = '\n'; }
-
-  return codechar - code_out;
+  return numChars;
 }
 
-}  // namespace
+char* encodeBase64To(char* __restrict__ target, ArrayPtr<const byte> input, bool breakLines) {
+  if (!breakLines) return encodeBase64Impl(target, input, BASE64_DIGITS, true);
 
-String encodeBase64(ArrayPtr<const byte> input, bool breakLines) {
-  /* set up a destination buffer large enough to hold the encoded data */
-  // equivalent to ceil(input.size() / 3) * 4
-  auto numChars = (input.size() + 2) / 3 * 4;
-  if (breakLines) {
-    // Add space for newline characters.
-    uint lineCount = numChars / CHARS_PER_LINE;
-    if (numChars % CHARS_PER_LINE > 0) {
-      // Partial line.
-      ++lineCount;
-    }
-    numChars = numChars + lineCount;
+  while (input.size() > 0) {
+    auto line = input.first(zc::min(input.size(), size_t(BYTES_PER_LINE)));
+    target = encodeBase64Impl(target, line, BASE64_DIGITS, true);
+    *target++ = '\n';
+    input = input.slice(line.size());
   }
-  auto output = heapString(numChars);
-  /* keep track of our encoded position */
-  char* c = output.begin();
-  /* store the number of bytes encoded by a single call */
-  int cnt = 0;
-  size_t total = 0;
-  /* we need an encoder state */
-  base64_encodestate s;
-
-  /*---------- START ENCODING ----------*/
-  /* initialise the encoder state */
-  base64_init_encodestate(&s);
-  /* gather data from the input and send it to the output */
-  cnt = base64_encode_block((const char*)input.begin(), input.size(), c, &s, breakLines);
-  c += cnt;
-  total += cnt;
-
-  /* since we have encoded the entire input string, we know that
-     there is no more input data; finalise the encoding */
-  cnt = base64_encode_blockend(c, &s, breakLines);
-  c += cnt;
-  total += cnt;
-  /*---------- STOP ENCODING  ----------*/
-
-  ZC_ASSERT(total == output.size(), total, output.size());
+  return target;
+}
 
+String encodeBase64(ArrayPtr<const byte> input, bool breakLines) {
+  auto output = heapString(encodeBase64Size(input.size(), breakLines));
+  char* end = encodeBase64To(output.begin(), input, breakLines);
+  ZC_ASSERT(end == output.end(), end - output.begin(), output.size());
   return output;
 }
 
+void encodeBase64(OutputStream& output, ArrayPtr<const byte> input, bool breakLines) {
+  // Whole lines at a time, so that padding and line breaks only ever land at the true end.
+  char buffer[16 * (CHARS_PER_LINE + 1)];
+  while (input.size() > 0) {
+    auto chunk = input.first(zc::min(input.size(), size_t(16 * BYTES_PER_LINE)));
+    char* end = encodeBase64To(buffer, chunk, breakLines);
+    output.write(arrayPtr(buffer, end).asBytes());
+    input = input.slice(chunk.size());
+  }
+}
+
 // -------------------------------------------------------------------
-// Decoder
+// The decoder is derived from libb64 which has been placed in the public domain.
+// For details, see http://sourceforge.net/projects/libb64
 
 namespace {
 
@@ -917,6 +1154,18 @@ int base64_decode_block(const char* code_in, const int length_in, char* plaintex
     while (1) {
       ZC_FALLTHROUGH;
       case step_a:
+        // Fast path: whole groups of four alphabet characters need none of the checks below.
+        while (code_in + length_in - codechar >= 4) {
+          int a = base64_decode_value(codechar[0]);
+          int b = base64_decode_value(codechar[1]);
+          int c = base64_decode_value(codechar[2]);
+          int d = base64_decode_value(codechar[3]);
+          if ((a | b | c | d) < 0) break;
+          *plainchar++ = (a << 2) | (b >> 4);
+          *plainchar++ = (b << 4) | (c >> 2);
+          *plainchar++ = (c << 6) | d;
+          codechar += 4;
+        }
         do {
           if (codechar == code_in + length_in) {
             state_in->step = step_a;
@@ -1012,21 +1261,14 @@ EncodingResult<Array<byte>> decodeBase64(ArrayPtr<const char> input) {
 }
 
 String encodeBase64Url(ArrayPtr<const byte> bytes) {
-  // TODO(perf): Rewrite as single pass?
   // TODO(someday): Write decoder?
 
-  auto base64 = zc::encodeBase64(bytes);
-
-  for (char& c : base64) {
-    if (c == '+') c = '-';
-    if (c == '/') c = '_';
-  }
-
-  // Remove trailing '='s.
-  zc::ArrayPtr<const char> slice = base64;
-  while (slice.size() > 0 && slice.back() == '=') { slice = slice.first(slice.size() - 1); }
-
-  return zc::str(slice);
+  // Unpadded, so the last group may be two or three characters rather than four.
+  size_t partial = bytes.size() % 3;
+  auto output = heapString(bytes.size() / 3 * 4 + (partial == 0 ? 0 : partial + 1));
+  char* end = encodeBase64Impl(output.begin(), bytes, BASE64URL_DIGITS, false);
+  ZC_ASSERT(end == output.end(), end - output.begin(), output.size());
+  return output;
 }
 
 }  // namespace zc
@@ -32,6 +32,8 @@ ZC_BEGIN_HEADER
 
 namespace zc {
 
+class OutputStream;
+
 template <typename ResultType>
 struct EncodingResult : public ResultType {
   // Equivalent to ResultType (a String or wide-char array) for all intents and purposes, except
@@ -72,6 +74,12 @@ EncodingResult<Array<char32_t>> encodeUtf32(ArrayPtr<const char> text, bool nulT
 // [WTF-8 encoding](http://simonsapin.github.io/wtf-8/), which affects how invalid input is
 // handled. See comments on decodeUtf16() for more info.
 
+bool validateUtf8(ArrayPtr<const char> text);
+// Returns true if `text` is well-formed UTF-8, i.e. exactly when encodeUtf16() would not set
+// `hadErrors`. Overlong sequences, encoded surrogates and code points past U+10FFFF are all
+// rejected. Runs of ASCII are skipped many bytes at a time, so this is much cheaper than
+// transcoding just to check the result.
+
 EncodingResult<String> decodeUtf16(ArrayPtr<const char16_t> utf16);
 EncodingResult<String> decodeUtf32(ArrayPtr<const char32_t> utf32);
 // Convert UTF-16 or UTF-32 to UTF-8 (which ZC strings use).
@@ -124,6 +132,12 @@ String encodeHex(ArrayPtr<const byte> bytes);
 EncodingResult<Array<byte>> decodeHex(ArrayPtr<const char> text);
 // Encode/decode bytes as hex strings.
 
+char* encodeHexTo(char* target, ArrayPtr<const byte> bytes);
+void encodeHex(OutputStream& output, ArrayPtr<const byte> bytes);
+// Like encodeHex(), but write the text to `target`, which must have room for `bytes.size() * 2`
+// characters, returning the end of what was written; or write it to `output` in chunks. Neither
+// allocates.
+
 String encodeUriComponent(ArrayPtr<const byte> bytes);
 String encodeUriComponent(ArrayPtr<const char> bytes);
 EncodingResult<String> decodeUriComponent(ArrayPtr<const char> text);
@@ -132,6 +146,12 @@ EncodingResult<String> decodeUriComponent(ArrayPtr<const char> text);
 //
 // See https://tools.ietf.org/html/rfc2396#section-2.3
 
+char* encodeUriComponentTo(char* target, ArrayPtr<const byte> bytes);
+void encodeUriComponent(OutputStream& output, ArrayPtr<const byte> bytes);
+// Like encodeUriComponent(), but write the text to `target`, returning the end of what was
+// written, or to `output` in chunks. `target` must have room for the worst case of
+// `bytes.size() * 3` characters.
+
 String encodeUriFragment(ArrayPtr<const byte> bytes);
 String encodeUriFragment(ArrayPtr<const char> bytes);
 // Encode URL fragment components using the fragment percent encode set defined by the WHATWG URL
@@ -211,6 +231,13 @@ String encodeBase64(ArrayPtr<const byte> bytes, bool breakLines = false);
 // Encode the given bytes as base64 text. If `breakLines` is true, line breaks will be inserted
 // into the output every 72 characters (e.g. for encoding e-mail bodies).
 
+size_t encodeBase64Size(size_t byteCount, bool breakLines = false);
+char* encodeBase64To(char* target, ArrayPtr<const byte> bytes, bool breakLines = false);
+void encodeBase64(OutputStream& output, ArrayPtr<const byte> bytes, bool breakLines = false);
+// Like encodeBase64(), but write the text to `target`, which must have room for
+// `encodeBase64Size(bytes.size(), breakLines)` characters, returning the end of what was written;
+// or write it to `output` in chunks. Neither allocates, so these suit large payloads.
+
 EncodingResult<Array<byte>> decodeBase64(ArrayPtr<const char> text);
 // Decode base64 text. This function reports errors required by the WHATWG HTML/Infra specs: see
 // https://html.spec.whatwg.org/multipage/webappapis.html#atob for details.
@@ -0,0 +1,250 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#if _WIN32 || __CYGWIN__
+#include "zc/core/win32-api-version.h"
+#endif
+
+#include "zc/core/epoch.h"
+
+#include "zc/core/debug.h"
+#include "zc/core/vector.h"
+
+#if __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#if _WIN32 || __CYGWIN__
+#include <windows.h>
+#else
+#include <sched.h>
+#endif
+
+#if __linux__ && defined(SYS_membarrier)
+#define ZC_EPOCH_MEMBARRIER 1
+#endif
+
+namespace zc {
+namespace _ {  // private
+
+// How it works
+//
+// A global epoch counter only moves forward. A thread entering a read lock publishes the epoch it
+// saw in its `active` slot (0 meaning "not reading"). The counter may advance from E to E+1 only
+// once every thread that is reading is doing so in epoch E. So if an object was retired in epoch
+// R, then once the counter reaches R+2, every reader that started before the retirement has
+// finished, and the object can be freed.
+//
+// The reader's store to `active` must be visible before it loads any shared pointers. Normally
+// that takes a full fence on every read lock. On Linux, membarrier(2) instead lets whoever scans
+// the `active` slots force a fence on all of the process's running threads at once, so readers
+// only need to keep the compiler from reordering.
+
+struct Retired {
+  Own<const void> object;
+  uint64_t epoch;
+};
+
+struct EpochDomain {
+  std::atomic<uint64_t> epoch = 1;
+  bool useMembarrier = false;
+
+  struct Registry {
+    Vector<EpochThread*> threads;
+    Vector<Retired> orphans;
+    // Retired by threads that exited before they could free it.
+  };
+  MutexGuarded<Registry> registry;
+
+  EpochDomain() {
+#if ZC_EPOCH_MEMBARRIER
+    useMembarrier =
+        syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#endif
+  }
+
+  inline void readerFence() {
+    if (ZC_LIKELY(useMembarrier)) {
+      std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+  }
+
+  void scannerFence() {
+#if ZC_EPOCH_MEMBARRIER
+    if (useMembarrier) {
+      ZC_SYSCALL(syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0));
+      return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  bool tryAdvance();
+};
+
+struct EpochThread {
+  EpochDomain& domain;
+  std::atomic<uint64_t> active = 0;
+  uint nesting = 0;
+  Vector<Retired> retired;
+
+  EpochThread();
+  ~EpochThread() noexcept(false);
+
+  void reclaim();
+};
+
+namespace {
+
+EpochDomain& epochDomain() {
+  static EpochDomain domain;
+  return domain;
+}
+
+thread_local EpochThread epochThread;
+
+constexpr size_t RECLAIM_THRESHOLD = 64;
+// How many objects a thread retires before it tries to free some.
+
+void freeExpired(Vector<Retired>& list, uint64_t current) {
+  // `list` is in retirement order, so the expired objects are a prefix. They're moved out before
+  // being destroyed because their destructors may well retire more objects.
+  size_t expired = 0;
+  while (expired < list.size() && list[expired].epoch + 2 <= current) ++expired;
+  if (expired == 0) return;
+
+  auto doomed = heapArrayBuilder<Retired>(expired);
+  for (size_t i = 0; i < expired; i++) doomed.add(zc::mv(list[i]));
+  for (size_t i = expired; i < list.size(); i++) list[i - expired] = zc::mv(list[i]);
+  list.truncate(list.size() - expired);
+}
+
+void yieldThread() {
+#if _WIN32 || __CYGWIN__
+  SwitchToThread();
+#else
+  sched_yield();
+#endif
+}
+
+}  // namespace
+
+bool EpochDomain::tryAdvance() {
+  uint64_t current = epoch.load(std::memory_order_acquire);
+  scannerFence();
+
+  {
+    auto lock = registry.lockShared();
+    for (auto t : lock->threads) {
+      uint64_t a = t->active.load(std::memory_order_acquire);
+      if (a != 0 && a != current) return false;
+    }
+  }
+
+  // If this fails, another thread advanced it for us.
+  epoch.compare_exchange_strong(current, current + 1, std::memory_order_acq_rel);
+  return true;
+}
+
+EpochThread::EpochThread() : domain(epochDomain()) {
+  domain.registry.lockExclusive()->threads.add(this);
+}
+
+EpochThread::~EpochThread() noexcept(false) {
+  ZC_ASSERT(nesting == 0, "thread exited while holding an Epoch::ReadLock") { break; }
+
+  auto lock = domain.registry.lockExclusive();
+  auto& threads = lock->threads;
+  for (auto& t : threads) {
+    if (t == this) {
+      t = threads.back();
+      threads.removeLast();
+      break;
+    }
+  }
+  for (auto& r : retired) { lock->orphans.add(zc::mv(r)); }
+}
+
+void EpochThread::reclaim() {
+  uint64_t current = domain.epoch.load(std::memory_order_acquire);
+  freeExpired(retired, current);
+
+  Vector<Retired> orphans;
+  {
+    auto lock = domain.registry.lockExclusive();
+    if (lock->orphans.empty()) return;
+    orphans = zc::mv(lock->orphans);
+  }
+  freeExpired(orphans, current);
+  if (!orphans.empty()) {
+    auto lock = domain.registry.lockExclusive();
+    for (auto& r : orphans) lock->orphans.add(zc::mv(r));
+  }
+}
+
+}  // namespace _
+
+Epoch::ReadLock::ReadLock() : thread(_::epochThread) {
+  if (thread.nesting++ == 0) {
+    thread.active.store(thread.domain.epoch.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    thread.domain.readerFence();
+  }
+}
+
+Epoch::ReadLock::~ReadLock() noexcept(false) {
+  if (--thread.nesting == 0) { thread.active.store(0, std::memory_order_release); }
+}
+
+void Epoch::retireImpl(Own<const void> object) {
+  auto& thread = _::epochThread;
+  auto& domain = thread.domain;
+
+  // Whatever the caller did to unlink `object` must be ordered before we read the epoch.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  thread.retired.add(_::Retired{zc::mv(object), domain.epoch.load(std::memory_order_relaxed)});
+
+  if (thread.retired.size() >= _::RECLAIM_THRESHOLD) {
+    // Only try once: if some reader holds the epoch back, we'll try again next time.
+    domain.tryAdvance();
+    thread.reclaim();
+  }
+}
+
+void Epoch::synchronize() {
+  auto& thread = _::epochThread;
+  auto& domain = thread.domain;
+  ZC_REQUIRE(thread.nesting == 0, "Epoch::synchronize() called while holding a read lock");
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  uint64_t target = domain.epoch.load(std::memory_order_relaxed) + 2;
+  while (domain.epoch.load(std::memory_order_acquire) < target) {
+    if (!domain.tryAdvance()) _::yieldThread();
+  }
+
+  thread.reclaim();
+}
+
+}  // namespace zc
@@ -0,0 +1,197 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+
+#include "zc/core/memory.h"
+#include "zc/core/mutex.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+struct EpochThread;
+
+}  // namespace _
+
+class Epoch {
+  // Epoch-based memory reclamation, for data structures that threads read without taking locks.
+  //
+  // A reader wraps each traversal of a shared structure in an `Epoch::ReadLock`. A writer that
+  // unlinks an object from the structure can't free it right away, because readers may still be
+  // looking at it; instead it passes ownership to `Epoch::retire()`. The object is destroyed once
+  // every thread that was inside a read lock at the time has left it -- the "grace period".
+  //
+  // Entering a read lock is a thread-local store, and on Linux not even a memory fence: writers
+  // make up for that with membarrier(2) when they check for readers. Reclamation is batched, so
+  // retire() is usually just appending to a thread-local list.
+  //
+  // There is one process-wide domain. Threads register themselves the first time they use it, and
+  // unregister when they exit (via a thread_local destructor, so this works for `zc::Thread` and
+  // threads created any other way). Objects a thread retired but couldn't free before exiting are
+  // handed over to the threads that remain.
+  //
+  // A read lock must not be held while waiting for another thread that might call
+  // `synchronize()`, and should not be held for long: no memory retired by any thread can be
+  // freed while it is.
+
+public:
+  class ReadLock {
+    // Keeps the calling thread's reads protected while in scope. May be nested. Must be destroyed
+    // on the thread that created it.
+
+  public:
+    ReadLock();
+    ~ReadLock() noexcept(false);
+    ZC_DISALLOW_COPY_AND_MOVE(ReadLock);
+
+  private:
+    _::EpochThread& thread;
+  };
+
+  template <typename T>
+  static void retire(Own<T>&& object) {
+    retireImpl(Own<const void>(zc::mv(object)));
+  }
+  // Destroys `object` once all current readers have left their read locks. The calling thread
+  // must not itself be inside a read lock that it expects to protect `object` after this returns.
+  // The object may be destroyed on any thread.
+
+  static void synchronize();
+  // Waits until every read lock held anywhere at the time of the call has been released, then
+  // frees what the calling thread has retired. Must not be called while holding a read lock.
+
+private:
+  static void retireImpl(Own<const void> object);
+};
+
+template <typename T>
+class RcuLocked {
+  // Return type for `RcuGuarded<T>::lockShared()`: a read lock plus the value it protects.
+
+public:
+  ZC_DISALLOW_COPY_AND_MOVE(RcuLocked);
+
+  inline const T* operator->() const { return ptr; }
+  inline const T& operator*() const { return *ptr; }
+  inline const T* get() const { return ptr; }
+  inline operator const T*() const { return ptr; }
+
+private:
+  Epoch::ReadLock lock;
+  const T* ptr;
+
+  template <typename Func>
+  inline RcuLocked(Func&& load) : ptr(load()) {}
+  // `load` runs after the read lock is taken.
+
+  template <typename U>
+  friend class RcuGuarded;
+};
+
+template <typename T>
+class RcuGuarded {
+  // Read-copy-update: a value that any number of threads read without locks or atomic
+  // read-modify-writes, and that writers replace wholesale. `lockShared()` takes an
+  // `Epoch::ReadLock` and loads a pointer; `update()` copies the current value, modifies the copy,
+  // publishes it, and retires the old version to `Epoch`.
+  //
+  // Writers are serialized by an internal mutex, and each write copies the whole value, so this
+  // suits small, rarely-written, frequently-read state -- a routing table, a configuration, a
+  // symbol scope that is complete before it's shared.
+
+public:
+  template <typename... Params>
+  explicit RcuGuarded(Params&&... params);
+  // Initialize the guarded object by passing the given parameters to its constructor.
+
+  ~RcuGuarded() noexcept(false);
+  // Destroys the current value right away; no reader may be using it anymore.
+
+  ZC_DISALLOW_COPY_AND_MOVE(RcuGuarded);
+
+  RcuLocked<T> lockShared() const;
+  // Returns the current value, protected for as long as the returned object lives. A later
+  // update() does not affect what it points to.
+
+  template <typename Func>
+  void update(Func&& func);
+  // Calls `func(T&)` on a copy of the current value, then makes the copy current. Requires `T` to
+  // be copyable.
+
+  void set(Own<T> value);
+  // Replaces the current value outright.
+
+private:
+  std::atomic<const T*> current;
+  MutexGuarded<Own<T>> owner;
+  // Owns `current`, and serializes writers.
+
+  void publish(Locked<Own<T>>& lock, Own<T> value);
+};
+
+// =======================================================================================
+// inline implementation details
+
+template <typename T>
+template <typename... Params>
+inline RcuGuarded<T>::RcuGuarded(Params&&... params)
+    : owner(heap<T>(zc::fwd<Params>(params)...)) {
+  current.store(owner.getWithoutLock().get(), std::memory_order_relaxed);
+}
+
+template <typename T>
+inline RcuGuarded<T>::~RcuGuarded() noexcept(false) {}
+
+template <typename T>
+inline RcuLocked<T> RcuGuarded<T>::lockShared() const {
+  return RcuLocked<T>([this]() { return current.load(std::memory_order_acquire); });
+}
+
+template <typename T>
+template <typename Func>
+void RcuGuarded<T>::update(Func&& func) {
+  auto lock = owner.lockExclusive();
+  auto copy = heap<T>(static_cast<const T&>(**lock));
+  func(*copy);
+  publish(lock, zc::mv(copy));
+}
+
+template <typename T>
+void RcuGuarded<T>::set(Own<T> value) {
+  auto lock = owner.lockExclusive();
+  publish(lock, zc::mv(value));
+}
+
+template <typename T>
+void RcuGuarded<T>::publish(Locked<Own<T>>& lock, Own<T> value) {
+  current.store(value.get(), std::memory_order_release);
+  Epoch::retire(zc::mv(*lock));
+  *lock = zc::mv(value);
+}
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -44,6 +44,7 @@
 #include "zc/core/debug.h"
 #include "zc/core/exception.h"
 #include "zc/core/function.h"
+#include "zc/core/log-sink.h"
 #include "zc/core/main.h"
 #include "zc/core/miniposix.h"
 #include "zc/core/string.h"
@@ -76,6 +77,11 @@
 #include <stdio.h>
 #endif
 
+#if ZC_USE_FRAME_POINTERS && __linux__ && (__x86_64__ || __aarch64__)
+// The build promises frame pointers everywhere, so a trace can be taken by following them.
+#define ZC_FRAME_POINTER_UNWIND 1
+#endif
+
 #if __CYGWIN__
 #include <sys/cygwin.h>
 #include <ucontext.h>
@@ -84,6 +90,12 @@
 #if ZC_HAS_LIBDL
 #include <dlfcn.h>
 #include <sys/wait.h>
+
+#include <algorithm>
+
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
 #endif
 
 #if _MSC_VER
@@ -282,7 +294,23 @@ struct Subprocess {
   zc::OwnFd out;
 };
 
-String stringifyStackTraceWithLlvm(ArrayPtr<void* const> trace) {
+struct SymbolCache {
+  HashMap<void*, String> frames;
+  // llvm-symbolizer's output for each address: a function and a location for the frame and for
+  // each call inlined into it, then a blank line.
+
+  bool symbolizerMissing = false;
+  // Set once we've found there's no llvm-symbolizer to run, so we stop trying.
+};
+
+MutexGuarded<SymbolCache>& symbolCache() {
+  static MutexGuarded<SymbolCache> cache;
+  return cache;
+}
+
+Maybe<Vector<String>> runLlvmSymbolizer(ArrayPtr<void* const> trace) {
+  // Returns the symbolizer's output for each address in `trace`, or none if it failed.
+
   const char* llvmSymbolizer = getenv("LLVM_SYMBOLIZER");
   if (llvmSymbolizer == nullptr) { llvmSymbolizer = "llvm-symbolizer"; }
 
@@ -296,86 +324,182 @@ String stringifyStackTraceWithLlvm(ArrayPtr<void* const> trace) {
     return false;
   }();
 
-  try {
-    ZC_IF_SOME(subprocess, Subprocess::exec(argv)) {
-      // write addresses as "CODE <file_name> <hex_address>" lines.
-      auto addrs = strArray(
-          ZC_MAP(addr, trace) {
-            Dl_info info;
-            if (dladdr(addr, &info)) {
-              uintptr_t offset =
-                  reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(info.dli_fbase);
-              return zc::str("CODE ", info.dli_fname, " 0x", reinterpret_cast<void*>(offset));
-            } else {
-              return zc::str("CODE 0x", reinterpret_cast<void*>(addr));
-            }
-          },
-          "\n");
-      if (write(subprocess.in, addrs.cStr(), addrs.size()) != addrs.size()) {
-        // Ignore EPIPE, which means the process exited early. We'll deal with it below, presumably.
-        if (errno != EPIPE) {
-          ZC_LOG(ERROR, "write error", strerror(errno));
-          return nullptr;
-        }
+  ZC_IF_SOME(subprocess, Subprocess::exec(argv)) {
+    // write addresses as "CODE <file_name> <hex_address>" lines.
+    auto addrs = strArray(
+        ZC_MAP(addr, trace) {
+          Dl_info info;
+          if (dladdr(addr, &info)) {
+            uintptr_t offset =
+                reinterpret_cast<uintptr_t>(addr) - reinterpret_cast<uintptr_t>(info.dli_fbase);
+            return zc::str("CODE ", info.dli_fname, " 0x", reinterpret_cast<void*>(offset));
+          } else {
+            return zc::str("CODE 0x", reinterpret_cast<void*>(addr));
+          }
+        },
+        "\n");
+    if (write(subprocess.in, addrs.cStr(), addrs.size()) != addrs.size()) {
+      // Ignore EPIPE, which means the process exited early. We'll deal with it below, presumably.
+      if (errno != EPIPE) {
+        ZC_LOG(ERROR, "write error", strerror(errno));
+        return zc::none;
       }
-      subprocess.in = nullptr;
-
-      // read result
-      // Note that fdopen() takes ownership of the FD and will close it later.
-      auto out = fdopen(subprocess.out.release(), "r");
-      if (!out) {
-        ZC_LOG(ERROR, "fdopen error", strerror(errno));
-        return nullptr;
+    }
+    subprocess.in = nullptr;
+
+    // read result
+    // Note that fdopen() takes ownership of the FD and will close it later.
+    auto out = fdopen(subprocess.out.release(), "r");
+    if (!out) {
+      ZC_LOG(ERROR, "fdopen error", strerror(errno));
+      return zc::none;
+    }
+    ZC_DEFER(fclose(out));
+
+    Vector<String> frames(trace.size());
+    Vector<String> lines;
+    for (char line[512]{}; fgets(line, sizeof(line), out) != nullptr;) {
+      lines.add(zc::str(line));
+      if (StringPtr(line) == "\n") {
+        frames.add(zc::strArray(lines, ""));
+        lines.clear();
+      }
+    }
+    int status = subprocess.wait();
+    if (WIFEXITED(status)) {
+      if (WEXITSTATUS(status) != 0) {
+        if (WEXITSTATUS(status) == 2) {
+          ZC_LOG(WARNING,
+                 zc::str(llvmSymbolizer,
+                         " was not found. "
+                         "To symbolize stack traces, install it in your $PATH or set "
+                         "$LLVM_SYMBOLIZER to "
+                         "the location of the binary. When running tests under bazel, use "
+                         "`--test_env=LLVM_SYMBOLIZER=<path>`."));
+          symbolCache().lockExclusive()->symbolizerMissing = true;
+        } else {
+          ZC_LOG(ERROR, "bad exit code", WEXITSTATUS(status));
+        }
+        return zc::none;
       }
-      ZC_DEFER(fclose(out));
+    } else {
+      ZC_LOG(ERROR, "bad exit status", status);
+      return zc::none;
+    }
+
+    if (frames.size() != trace.size()) {
+      ZC_LOG(ERROR, "llvm-symbolizer output didn't match its input");
+      return zc::none;
+    }
+    return zc::mv(frames);
+  }
+  else {
+    ZC_LOG(ERROR, "error starting llvm-symbolizer");
+    return zc::none;
+  }
+}
 
-      zc::String lines[256];
-      size_t i = 0;
-      for (char line[512]{}; fgets(line, sizeof(line), out) != nullptr;) {
-        if (i < zc::size(lines)) { lines[i++] = zc::str(line); }
+String stringifyStackTraceWithLlvm(ArrayPtr<void* const> trace) {
+  // Each address is symbolized once per process: later traces through the same code, which is the
+  // common case for exceptions used as control flow, are formatted without running anything.
+
+  Vector<void*> missing;
+  {
+    auto lock = symbolCache().lockShared();
+    if (lock->symbolizerMissing) return nullptr;
+    for (void* addr : trace) {
+      if (lock->frames.find(addr) == zc::none &&
+          std::find(missing.begin(), missing.end(), addr) == missing.end()) {
+        missing.add(addr);
       }
-      int status = subprocess.wait();
-      if (WIFEXITED(status)) {
-        if (WEXITSTATUS(status) != 0) {
-          if (WEXITSTATUS(status) == 2) {
-            static bool logged = false;
-            if (!logged) {
-              ZC_LOG(WARNING,
-                     zc::str(llvmSymbolizer,
-                             " was not found. "
-                             "To symbolize stack traces, install it in your $PATH or set "
-                             "$LLVM_SYMBOLIZER to "
-                             "the location of the binary. When running tests under bazel, use "
-                             "`--test_env=LLVM_SYMBOLIZER=<path>`."));
-              logged = true;
-            }
-          } else {
-            ZC_LOG(ERROR, "bad exit code", WEXITSTATUS(status));
-          }
-          return nullptr;
+    }
+  }
+
+  if (!missing.empty()) {
+    try {
+      ZC_IF_SOME(frames, runLlvmSymbolizer(missing)) {
+        auto lock = symbolCache().lockExclusive();
+        for (auto i : zc::indices(missing)) {
+          lock->frames.upsert(missing[i], zc::mv(frames[i]));
         }
-      } else {
-        ZC_LOG(ERROR, "bad exit status", status);
-        return nullptr;
       }
-      return zc::str("\n", zc::strArray(zc::arrayPtr(lines, i), ""));
+      else { return nullptr; }
+    } catch (...) {
+      auto exception = getCaughtExceptionAsKj();
+
+      // Carefully log only the exception description here, since we don't want to trigger stack
+      // trace stringification recursively!
+      ZC_LOG(ERROR, "caught exception while trying to stringify stack trace",
+             exception.getDescription());
+      return nullptr;
     }
-    else { return zc::str("\nerror starting llvm-symbolizer"); }
-  } catch (...) {
-    auto exception = getCaughtExceptionAsKj();
-
-    // Carefully log only the exception description here, since we don't want to trigger stack
-    // trace stringification recursively!
-    ZC_LOG(ERROR, "caught exception while trying to stringify stack trace",
-           exception.getDescription());
-    return nullptr;
   }
+
+  auto lock = symbolCache().lockShared();
+  return zc::str("\n", zc::strArray(ZC_MAP(addr, trace) -> StringPtr {
+                   return ZC_ASSERT_NONNULL(lock->frames.find(addr));
+                 }, ""));
 }
 
 }  // namespace
 
 #endif
 
+#if ZC_FRAME_POINTER_UNWIND
+
+namespace {
+
+struct StackBounds {
+  uintptr_t low = 0;
+  uintptr_t high = 0;
+};
+
+const StackBounds& currentStackBounds() {
+  // Looking these up reads /proc/self/maps for the main thread, so do it once per thread.
+  static thread_local StackBounds bounds;
+  if (bounds.high == 0) {
+    pthread_attr_t attr;
+    if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+      void* addr;
+      size_t size;
+      if (pthread_attr_getstack(&attr, &addr, &size) == 0) {
+        bounds.low = reinterpret_cast<uintptr_t>(addr);
+        bounds.high = bounds.low + size;
+      }
+      pthread_attr_destroy(&attr);
+    }
+  }
+  return bounds;
+}
+
+ZC_NOINLINE size_t walkFramePointers(ArrayPtr<void*> space) {
+  // Like backtrace(), the first address is in our caller. Each frame record is {caller's frame
+  // pointer, return address}, and older frames sit at higher addresses. Anything that breaks those
+  // rules -- or leaves the thread's stack, as on a signal stack -- means we've reached code built
+  // without frame pointers, and we stop rather than read garbage.
+
+  const StackBounds& bounds = currentStackBounds();
+  uintptr_t fp = reinterpret_cast<uintptr_t>(__builtin_frame_address(0));
+  size_t size = 0;
+  while (size < space.size()) {
+    if (fp < bounds.low || fp + 2 * sizeof(void*) > bounds.high || fp % sizeof(void*) != 0) {
+      break;
+    }
+    auto record = reinterpret_cast<void* const*>(fp);
+    if (record[1] == nullptr) break;
+    space[size++] = record[1];
+
+    uintptr_t next = reinterpret_cast<uintptr_t>(record[0]);
+    if (next <= fp) break;
+    fp = next;
+  }
+  return size;
+}
+
+}  // namespace
+
+#endif  // ZC_FRAME_POINTER_UNWIND
+
 ArrayPtr<void* const> getStackTrace(ArrayPtr<void*> space, uint ignoreCount) {
   if (getExceptionCallback().stackTraceMode() == ExceptionCallback::StackTraceMode::NONE) {
     return nullptr;
@@ -385,8 +509,17 @@ ArrayPtr<void* const> getStackTrace(ArrayPtr<void*> space, uint ignoreCount) {
   CONTEXT context;
   RtlCaptureContext(&context);
   return getStackTrace(space, ignoreCount, GetCurrentThread(), context);
-#elif ZC_HAS_BACKTRACE
+#elif ZC_HAS_BACKTRACE || ZC_FRAME_POINTER_UNWIND
+#if ZC_FRAME_POINTER_UNWIND
+  // Much cheaper than backtrace(), which consults unwind tables for every frame. Fall back to it
+  // if we're somewhere the frame pointers don't lead.
+  size_t size = walkFramePointers(space);
+#if ZC_HAS_BACKTRACE
+  if (size <= ignoreCount + 1) size = backtrace(space.begin(), space.size());
+#endif
+#else
   size_t size = backtrace(space.begin(), space.size());
+#endif
   for (auto& addr : space.first(size)) {
     // The addresses produced by backtrace() are return addresses, which means they point to the
     // instruction immediately after the call. Invoking addr2line on these can be confusing because
@@ -1282,6 +1415,7 @@ public:
                   String&& text) override {
     text =
         str(zc::repeat('_', contextDepth), file, ":", line, ": ", severity, ": ", mv(text), '\n');
+    if (_::logAsync(severity, text)) return;
 
     StringPtr textPtr = text;
 
@@ -1359,6 +1493,8 @@ ExceptionCallback& getExceptionCallback() {
   return scoped != nullptr ? *scoped : *defaultCallback;
 }
 
+bool _::hasScopedExceptionCallback() { return threadLocalCallback != nullptr; }
+
 void throwFatalException(zc::Exception&& exception, uint ignoreCount) {
   if (ignoreCount != (uint)zc::maxValue) exception.extendTrace(ignoreCount + 1);
   getExceptionCallback().onFatalException(zc::mv(exception));
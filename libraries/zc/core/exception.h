@@ -293,6 +293,14 @@ private:
 ExceptionCallback& getExceptionCallback();
 // Returns the current exception callback.
 
+namespace _ {  // private
+
+bool hasScopedExceptionCallback();
+// Returns whether the calling thread has an ExceptionCallback of its own in scope, rather than
+// just the root callback.
+
+}  // namespace _
+
 ZC_NOINLINE ZC_NORETURN(void throwFatalException(zc::Exception&& exception, uint ignoreCount = 0));
 // Invoke the exception callback to throw the given fatal exception.  If the exception callback
 // returns, abort.
@@ -55,6 +55,13 @@
 #include <syscall.h>
 #endif
 
+#if __linux__ && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+
+#include <atomic>
+#define ZC_USE_IO_URING 1
+#endif
+
 namespace zc {
 namespace {
 
@@ -1690,8 +1697,255 @@ private:
   }
 };
 
+#if ZC_USE_IO_URING
+
+class IoUring {
+  // Just enough of io_uring to submit a batch of operations and wait for all of them. Talks to the
+  // kernel directly rather than through liburing, which we'd otherwise have to depend on.
+
+public:
+  static Maybe<Own<IoUring>> tryCreate(uint entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    int fd = syscall(__NR_io_uring_setup, entries, &params);
+    if (fd < 0) {
+      // Too old a kernel, or disabled by sysctl or seccomp.
+      return zc::none;
+    }
+    return heap<IoUring>(OwnFd(fd), params);
+  }
+
+  IoUring(OwnFd fd, const struct io_uring_params& params)
+      : fd(zc::mv(fd)), entries(params.sq_entries) {
+    sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool single = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (single) sqRingSize = cqRingSize = zc::max(sqRingSize, cqRingSize);
+
+    sqRing = map(sqRingSize, IORING_OFF_SQ_RING);
+    cqRing = single ? sqRing : map(cqRingSize, IORING_OFF_CQ_RING);
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes = reinterpret_cast<struct io_uring_sqe*>(map(sqesSize, IORING_OFF_SQES));
+
+    sqHead = field(sqRing, params.sq_off.head);
+    sqTail = field(sqRing, params.sq_off.tail);
+    sqMask = *field(sqRing, params.sq_off.ring_mask);
+    sqArray = field(sqRing, params.sq_off.array);
+    cqHead = field(cqRing, params.cq_off.head);
+    cqTail = field(cqRing, params.cq_off.tail);
+    cqMask = *field(cqRing, params.cq_off.ring_mask);
+    cqes = reinterpret_cast<struct io_uring_cqe*>(reinterpret_cast<byte*>(cqRing) +
+                                                  params.cq_off.cqes);
+    tail = *sqTail;
+  }
+
+  ~IoUring() noexcept(false) {
+    munmap(sqes, sqesSize);
+    if (cqRing != sqRing) munmap(cqRing, cqRingSize);
+    munmap(sqRing, sqRingSize);
+  }
+
+  uint capacity() const { return entries; }
+
+  struct io_uring_sqe& add(uint8_t opcode, int fd, uint64_t userData) {
+    // The caller must not queue more than capacity() operations per run().
+    ZC_IREQUIRE(queued < entries);
+    uint index = tail & sqMask;
+    auto& sqe = sqes[index];
+    memset(&sqe, 0, sizeof(sqe));
+    sqe.opcode = opcode;
+    sqe.fd = fd;
+    sqe.user_data = userData;
+    sqArray[index] = index;
+    ++tail;
+    ++queued;
+    return sqe;
+  }
+
+  template <typename Func>
+  void run(Func&& onComplete) {
+    // Submits everything add()ed and waits for it all, calling onComplete(userData, result) for
+    // each operation. `result` is what the equivalent syscall returns, or -errno.
+
+    std::atomic_ref<uint32_t>(*sqTail).store(tail, std::memory_order_release);
+    uint toSubmit = queued;
+    uint remaining = queued;
+    queued = 0;
+
+    while (remaining > 0) {
+      uint32_t head = *cqHead;
+      uint32_t available = std::atomic_ref<uint32_t>(*cqTail).load(std::memory_order_acquire);
+      if (head == available || toSubmit > 0) {
+        int n;
+        ZC_SYSCALL(n = syscall(__NR_io_uring_enter, fd.get(), toSubmit,
+                               head == available ? 1 : 0, IORING_ENTER_GETEVENTS, nullptr, 0));
+        toSubmit -= n;
+        continue;
+      }
+
+      for (; head != available; ++head) {
+        auto& cqe = cqes[head & cqMask];
+        onComplete(cqe.user_data, cqe.res);
+        --remaining;
+      }
+      std::atomic_ref<uint32_t>(*cqHead).store(head, std::memory_order_release);
+    }
+  }
+
+private:
+  OwnFd fd;
+  uint entries;
+  uint queued = 0;
+  uint32_t tail;
+
+  void* sqRing;
+  void* cqRing;
+  size_t sqRingSize;
+  size_t cqRingSize;
+  struct io_uring_sqe* sqes;
+  size_t sqesSize;
+
+  uint32_t* sqHead;
+  uint32_t* sqTail;
+  uint32_t sqMask;
+  uint32_t* sqArray;
+  uint32_t* cqHead;
+  uint32_t* cqTail;
+  uint32_t cqMask;
+  struct io_uring_cqe* cqes;
+
+  void* map(size_t size, off_t offset) {
+    void* result = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                        fd.get(), offset);
+    if (result == MAP_FAILED) { ZC_FAIL_SYSCALL("mmap(io_uring)", errno); }
+    return result;
+  }
+
+  static uint32_t* field(void* ring, uint32_t offset) {
+    return reinterpret_cast<uint32_t*>(reinterpret_cast<byte*>(ring) + offset);
+  }
+};
+
+Array<const byte> withPadding(Array<byte> storage, size_t size) {
+  return storage.first(size).attach(zc::mv(storage));
+}
+
+Maybe<Array<const byte>> readFileSlowly(const ReadableDirectory& dir, PathPtr path,
+                                        size_t padding) {
+  ZC_IF_SOME(file, dir.tryOpenFile(path)) {
+    auto content = file->readAllBytes();
+    auto storage = heapArray<byte>(content.size() + padding);
+    memcpy(storage.begin(), content.begin(), content.size());
+    memset(storage.begin() + content.size(), 0, padding);
+    return withPadding(zc::mv(storage), content.size());
+  }
+  return zc::none;
+}
+
+void readBatch(IoUring& ring, const ReadableDirectory& dir, int dirFd,
+               ArrayPtr<const PathPtr> paths, size_t padding,
+               ArrayPtr<Maybe<Array<const byte>>> results) {
+  struct Pending {
+    String path;
+    OwnFd fd;
+    struct statx stats;
+    Array<byte> storage;
+    bool missing = false;
+    bool slowPath = false;
+  };
+  auto pending = heapArray<Pending>(paths.size());
+
+  for (auto i : zc::indices(paths)) {
+    auto& p = pending[i];
+    p.path = paths[i].toString();
+    auto& sqe = ring.add(IORING_OP_OPENAT, dirFd, i);
+    sqe.addr = reinterpret_cast<uintptr_t>(p.path.cStr());
+    sqe.open_flags = O_RDONLY | MAYBE_O_CLOEXEC;
+  }
+  ring.run([&](uint64_t i, int result) {
+    auto& p = pending[i];
+    if (result >= 0) {
+      p.fd = OwnFd(result);
+    } else if (result == -ENOENT || result == -ENOTDIR) {
+      p.missing = true;
+    } else {
+      p.slowPath = true;
+    }
+  });
+
+  for (auto i : zc::indices(pending)) {
+    auto& p = pending[i];
+    if (p.fd == nullptr) continue;
+    auto& sqe = ring.add(IORING_OP_STATX, p.fd, i);
+    sqe.addr = reinterpret_cast<uintptr_t>("");
+    sqe.len = STATX_TYPE | STATX_SIZE;
+    sqe.off = reinterpret_cast<uintptr_t>(&p.stats);
+    sqe.statx_flags = AT_EMPTY_PATH;
+  }
+  ring.run([&](uint64_t i, int result) {
+    auto& p = pending[i];
+    // A single read can't return more than about 2GB, and files that big gain nothing here.
+    if (result < 0 || !S_ISREG(p.stats.stx_mode) || p.stats.stx_size > (1u << 30)) {
+      p.slowPath = true;
+    }
+  });
+
+  for (auto i : zc::indices(pending)) {
+    auto& p = pending[i];
+    if (p.fd == nullptr || p.slowPath) continue;
+    size_t size = p.stats.stx_size;
+    p.storage = heapArray<byte>(size + padding);
+    memset(p.storage.begin() + size, 0, padding);
+    if (size == 0) continue;
+    auto& sqe = ring.add(IORING_OP_READ, p.fd, i);
+    sqe.addr = reinterpret_cast<uintptr_t>(p.storage.begin());
+    sqe.len = size;
+    sqe.off = 0;
+  }
+  ring.run([&](uint64_t i, int result) {
+    auto& p = pending[i];
+    // A short read means the file changed size since the statx().
+    if (result < 0 || uint64_t(result) != p.stats.stx_size) p.slowPath = true;
+  });
+
+  for (auto i : zc::indices(pending)) {
+    auto& p = pending[i];
+    if (p.slowPath) {
+      results[i] = readFileSlowly(dir, paths[i], padding);
+    } else if (!p.missing) {
+      results[i] = withPadding(zc::mv(p.storage), p.stats.stx_size);
+    }
+  }
+}
+
+#endif  // ZC_USE_IO_URING
+
 }  // namespace
 
+Maybe<Array<Maybe<Array<const byte>>>> tryReadFilesBatched(const ReadableDirectory& dir,
+                                                           ArrayPtr<const PathPtr> paths,
+                                                           size_t padding) {
+#if ZC_USE_IO_URING
+  int dirFd;
+  ZC_IF_SOME(fd, dir.getFd()) { dirFd = fd; }
+  else { return zc::none; }
+
+  constexpr uint RING_ENTRIES = 256;
+  Own<IoUring> ring;
+  ZC_IF_SOME(r, IoUring::tryCreate(RING_ENTRIES)) { ring = zc::mv(r); }
+  else { return zc::none; }
+
+  auto results = heapArray<Maybe<Array<const byte>>>(paths.size());
+  for (size_t start = 0; start < paths.size(); start += ring->capacity()) {
+    size_t end = zc::min(start + ring->capacity(), paths.size());
+    readBatch(*ring, dir, dirFd, paths.slice(start, end), padding, results.slice(start, end));
+  }
+  return zc::mv(results);
+#else
+  return zc::none;
+#endif
+}
+
 Own<ReadableFile> newDiskReadableFile(zc::OwnFd fd) { return heap<DiskReadableFile>(zc::mv(fd)); }
 Own<AppendableFile> newDiskAppendableFile(zc::OwnFd fd) {
   return heap<DiskAppendableFile>(zc::mv(fd));
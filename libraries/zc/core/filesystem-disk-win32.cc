@@ -1487,6 +1487,12 @@ static Own<Directory> newDiskDirectory(AutoCloseHandle fd, Path&& path) {
 
 Own<Filesystem> newDiskFilesystem() { return heap<DiskFilesystem>(); }
 
+Maybe<Array<Maybe<Array<const byte>>>> tryReadFilesBatched(const ReadableDirectory& dir,
+                                                           ArrayPtr<const PathPtr> paths,
+                                                           size_t padding) {
+  return zc::none;
+}
+
 static AutoCloseHandle* getHandlePointerHack(Directory& dir) {
   return &static_cast<DiskDirectoryBase&>(dir).handle;
 }
@@ -21,16 +21,22 @@
 
 #include "zc/core/filesystem.h"
 
+#include <algorithm>
 #include <map>
+#include <thread>
 
 #include "zc/core/debug.h"
 #include "zc/core/encoding.h"
+#include "zc/core/glob-filter.h"
 #include "zc/core/mutex.h"
 #include "zc/core/one-of.h"
 #include "zc/core/refcount.h"
+#include "zc/core/thread.h"
 #include "zc/core/vector.h"
 
 #if __linux__
+#include <errno.h>
+#include <fcntl.h>     // for fallocate()
 #include <sys/mman.h>  // for memfd_create()
 #endif                 // __linux__
 
@@ -514,6 +520,133 @@ size_t File::copy(uint64_t offset, const ReadableFile& from, uint64_t fromOffset
   return result;
 }
 
+namespace {
+
+constexpr size_t MIN_WINDOW_SIZE = 64 * 1024;
+constexpr size_t MAX_WINDOW_SIZE = 64 * 1024 * 1024;
+
+void growFile(const File& file, uint64_t oldSize, uint64_t newSize) {
+#if __linux__
+  // Reserve real blocks so that a full disk is reported here, as an exception, rather than as a
+  // SIGBUS when we later store into the mapping. Not every filesystem can do this.
+  ZC_IF_SOME(fd, file.getFd()) {
+    ZC_SYSCALL_HANDLE_ERRORS(fallocate(fd, 0, oldSize, newSize - oldSize)) {
+      case EOPNOTSUPP:
+        break;
+      default:
+        ZC_FAIL_SYSCALL("fallocate(fd)", error) { return; }
+    }
+    else { return; }
+  }
+#endif
+  file.truncate(newSize);
+}
+
+}  // namespace
+
+MappedFileOutputStream::MappedFileOutputStream(Own<const File> fileParam, uint64_t offset)
+    : file(zc::mv(fileParam)),
+      startOffset(offset),
+      windowOffset(offset),
+      fileSize(file->stat().size),
+      window(nullptr),
+      pos(nullptr),
+      nextWindowSize(MIN_WINDOW_SIZE) {}
+
+MappedFileOutputStream::~MappedFileOutputStream() noexcept(false) {
+  if (!finished) {
+    unwindDetector.catchExceptionsIfUnwinding([&]() { finish(); });
+  }
+}
+
+void MappedFileOutputStream::releaseWindow() {
+  ZC_IF_SOME(m, mapping) {
+    // Start writeback now rather than whenever the kernel gets around to it.
+    m->changed(window.first(pos - window.begin()));
+  }
+  windowOffset = getPosition();
+  mapping = zc::none;
+  window = nullptr;
+  pos = nullptr;
+}
+
+void MappedFileOutputStream::nextWindow(size_t minSize) {
+  releaseWindow();
+
+  size_t size = zc::max(nextWindowSize, minSize);
+  nextWindowSize = zc::min(size * 2, MAX_WINDOW_SIZE);
+
+  // The file must cover the whole mapping: disk files fault on stores past EOF. This also has to
+  // happen while nothing is mapped, because in-memory files can't move their storage otherwise.
+  uint64_t end = windowOffset + size;
+  if (end > fileSize) {
+    growFile(*file, fileSize, end);
+    fileSize = end;
+  }
+
+  auto m = file->mmapWritable(windowOffset, size);
+  window = m->get();
+  pos = window.begin();
+  mapping = zc::mv(m);
+}
+
+ArrayPtr<byte> MappedFileOutputStream::getWriteBuffer() {
+  ZC_REQUIRE(!finished, "MappedFileOutputStream already finished");
+  if (pos == window.end()) nextWindow(0);
+  return arrayPtr(pos, window.end());
+}
+
+void MappedFileOutputStream::write(ArrayPtr<const byte> data) {
+  ZC_REQUIRE(!finished, "MappedFileOutputStream already finished");
+
+  if (data.begin() == pos && data.size() > 0) {
+    // The caller wrote directly into our window.
+    ZC_REQUIRE(data.size() <= size_t(window.end() - pos), "write() overruns the write buffer");
+    pos += data.size();
+    return;
+  }
+
+  while (data.size() > 0) {
+    size_t available = window.end() - pos;
+    if (available == 0) {
+      nextWindow(data.size());
+      available = window.end() - pos;
+    }
+
+    size_t n = zc::min(available, data.size());
+    memcpy(pos, data.begin(), n);
+    pos += n;
+    data = data.slice(n);
+  }
+}
+
+void MappedFileOutputStream::sync(uint64_t offset, uint64_t size) {
+  uint64_t end = offset + size;
+  ZC_REQUIRE(end >= offset && offset >= startOffset && end <= getPosition(),
+             "sync() range is outside what has been written");
+  if (size == 0) return;
+
+  if (offset < windowOffset) {
+    // Earlier windows are no longer mapped, so their dirty pages can only be reached via the file.
+    file->datasync();
+  }
+
+  ZC_IF_SOME(m, mapping) {
+    if (end > windowOffset) {
+      uint64_t from = zc::max(offset, windowOffset) - windowOffset;
+      m->sync(window.slice(from, end - windowOffset));
+    }
+  }
+}
+
+void MappedFileOutputStream::finish() {
+  if (finished) return;
+  finished = true;
+
+  releaseWindow();
+  if (fileSize != windowOffset) { file->truncate(windowOffset); }
+}
+
 FsNode::Metadata ReadableDirectory::lstat(PathPtr path) const {
   ZC_IF_SOME(meta, tryLstat(path)) { return meta; }
   else {
@@ -546,6 +679,108 @@ String ReadableDirectory::readlink(PathPtr path) const {
   }
 }
 
+namespace {
+
+struct WalkState {
+  struct Pending {
+    Own<const ReadableDirectory> dir;
+    Path path;
+  };
+
+  Vector<Pending> queue;
+  uint busy = 0;
+  // Workers currently listing a directory, which may yet add to `queue`.
+
+  Maybe<Exception> error;
+  Vector<ReadableDirectory::WalkEntry> results;
+};
+
+void walkWorker(const MutexGuarded<WalkState>& state, Function<bool(PathPtr)>& descend) {
+  Vector<ReadableDirectory::WalkEntry> results;
+  Vector<WalkState::Pending> found;
+
+  for (;;) {
+    auto next = state.when(
+        [](const WalkState& s) { return !s.queue.empty() || s.busy == 0 || s.error != zc::none; },
+        [](WalkState& s) -> Maybe<WalkState::Pending> {
+          if (s.queue.empty() || s.error != zc::none) return zc::none;
+          ++s.busy;
+          auto result = zc::mv(s.queue.back());
+          s.queue.removeLast();
+          return zc::mv(result);
+        });
+
+    ZC_IF_SOME(item, next) {
+      auto error = zc::runCatchingExceptions([&]() {
+        for (auto& entry : item.dir->listEntries()) {
+          auto path = item.path.append(entry.name);
+          if (entry.type == FsNode::Type::DIRECTORY && descend(path)) {
+            ZC_IF_SOME(subdir, item.dir->tryOpenSubdir(Path(entry.name))) {
+              found.add(WalkState::Pending{zc::mv(subdir), path.clone()});
+            }
+          }
+          results.add(ReadableDirectory::WalkEntry{entry.type, zc::mv(path)});
+        }
+      });
+
+      auto lock = state.lockExclusive();
+      --lock->busy;
+      ZC_IF_SOME(e, error) {
+        if (lock->error == zc::none) lock->error = zc::mv(e);
+      }
+      for (auto& pending : found) lock->queue.add(zc::mv(pending));
+      found.clear();
+    }
+    else { break; }
+  }
+
+  auto lock = state.lockExclusive();
+  for (auto& entry : results) lock->results.add(zc::mv(entry));
+}
+
+}  // namespace
+
+Array<ReadableDirectory::WalkEntry> ReadableDirectory::walk(uint threadCount) const {
+  return walk([](PathPtr) { return true; }, threadCount);
+}
+
+Array<ReadableDirectory::WalkEntry> ReadableDirectory::walk(Function<bool(PathPtr)> descend,
+                                                            uint threadCount) const {
+  if (threadCount == 0) threadCount = zc::max(std::thread::hardware_concurrency(), 1u);
+
+  MutexGuarded<WalkState> state;
+  state.getWithoutLock().queue.add(WalkState::Pending{clone(), Path(nullptr)});
+
+  {
+    // The calling thread is one of the workers.
+    Vector<Own<Thread>> threads(threadCount - 1);
+    for (uint i = 1; i < threadCount; i++) {
+      threads.add(heap<Thread>([&]() { walkWorker(state, descend); }));
+    }
+    walkWorker(state, descend);
+  }
+
+  auto& result = state.getWithoutLock();
+  ZC_IF_SOME(e, result.error) { throwFatalException(zc::mv(e)); }
+
+  auto entries = result.results.releaseAsArray();
+  std::sort(entries.begin(), entries.end(),
+            [](const WalkEntry& a, const WalkEntry& b) { return a.path < b.path; });
+  return entries;
+}
+
+Array<ReadableDirectory::WalkEntry> ReadableDirectory::walk(GlobFilter& filter,
+                                                            uint threadCount) const {
+  // GlobFilter isn't thread-safe, so match afterwards on this thread.
+  Vector<WalkEntry> matches;
+  for (auto& entry : walk(threadCount)) {
+    if (entry.type != FsNode::Type::DIRECTORY && filter.matches(entry.path.toString())) {
+      matches.add(zc::mv(entry));
+    }
+  }
+  return matches.releaseAsArray();
+}
+
 Own<const File> Directory::openFile(PathPtr path, WriteMode mode) const {
   ZC_IF_SOME(f, tryOpenFile(path, mode)) { return zc::mv(f); }
   else if (has(mode, WriteMode::CREATE) && !has(mode, WriteMode::MODIFY)) {
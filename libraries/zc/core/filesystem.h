@@ -37,6 +37,7 @@ template <typename T>
 class Vector;
 
 class PathPtr;
+class GlobFilter;
 
 class Path {
   // A Path identifies a file in a directory tree.
@@ -515,6 +516,66 @@ public:
   // superior implementations that offload the work to the OS or even implement copy-on-write.
 };
 
+class MappedFileOutputStream final : public BufferedOutputStream {
+  // Writes sequentially to a File through a window of writable memory mapping rather than with
+  // write() calls, so emitting a large output costs a memcpy (or nothing, for callers that fill
+  // getWriteBuffer() directly).
+  //
+  // The file is grown a window at a time -- preallocated with fallocate() on Linux, so running out
+  // of disk space throws rather than faulting on a later store -- and each window that fills up
+  // is handed to the kernel for asynchronous writeback before the next one is mapped. Windows
+  // start small and double up to a limit, so small outputs don't reserve much. When the stream is
+  // finished, the file is truncated to end where the stream ended.
+  //
+  // Nothing here waits for data to reach the disk unless you call sync().
+
+public:
+  explicit MappedFileOutputStream(Own<const File> file, uint64_t offset = 0);
+  // Starts writing at `offset`. Anything in the file past that point is overwritten or, on
+  // finish(), truncated away.
+
+  ~MappedFileOutputStream() noexcept(false);
+  // Calls finish() if it hasn't been called yet.
+
+  ZC_DISALLOW_COPY_AND_MOVE(MappedFileOutputStream);
+
+  uint64_t getPosition() const { return windowOffset + (pos - window.begin()); }
+  // The file offset the next byte will be written to.
+
+  void sync(uint64_t offset, uint64_t size);
+  // Waits until the given range of already-written bytes has reached the disk. Bytes in the
+  // current window are synced through the mapping alone; anything earlier needs a datasync() of
+  // the whole file.
+
+  void sync() { sync(startOffset, getPosition() - startOffset); }
+  // Waits until everything written so far has reached the disk.
+
+  void finish();
+  // Releases the mapping and truncates the file to getPosition(). No more writes are allowed.
+
+  // implements BufferedOutputStream ---------------------------------
+  ArrayPtr<byte> getWriteBuffer() override;
+  void write(ArrayPtr<const byte> data) override;
+
+private:
+  Own<const File> file;
+  uint64_t startOffset;
+  uint64_t windowOffset;
+  // File offset of `window.begin()`.
+  uint64_t fileSize;
+  // How far we've grown the file so far.
+
+  Maybe<Own<const WritableFileMapping>> mapping;
+  ArrayPtr<byte> window;
+  byte* pos;
+  size_t nextWindowSize;
+  bool finished = false;
+  UnwindDetector unwindDetector;
+
+  void nextWindow(size_t minSize);
+  void releaseWindow();
+};
+
 class ReadableDirectory : public FsNode {
   // Read-only subset of `Directory`.
 
@@ -576,6 +637,26 @@ public:
   // checking if it is a link, wasting a syscall and a path traversal.
   //
   // See Directory::symlink() for warnings about symlinks.
+
+  struct WalkEntry {
+    FsNode::Type type;
+    Path path;
+    // Relative to the directory being walked.
+  };
+
+  Array<WalkEntry> walk(uint threadCount = 0) const;
+  Array<WalkEntry> walk(Function<bool(PathPtr)> descend, uint threadCount = 0) const;
+  // Lists everything under this directory, recursively, sorted by path. Subdirectories are listed
+  // in parallel on `threadCount` threads (counting the calling thread; 0 means one per CPU), each
+  // opened relative to its parent, and entry types come from listEntries(), so disk directories
+  // only need a stat() where the filesystem doesn't report types.
+  //
+  // `descend` is asked about each subdirectory before it is opened; returning false prunes it (the
+  // subdirectory itself is still listed). It may be called from several threads at once. Symlinks
+  // are never followed.
+
+  Array<WalkEntry> walk(GlobFilter& filter, uint threadCount = 0) const;
+  // Like walk(), but returns only the non-directory entries whose path matches `filter`.
 };
 
 enum class WriteMode {
@@ -999,6 +1080,21 @@ Own<Filesystem> newDiskFilesystem();
 // newDiskFilesystem() reads the current working directory at the time it is called. The returned
 // object is not affected by subsequent calls to chdir().
 
+Maybe<Array<Maybe<Array<const byte>>>> tryReadFilesBatched(const ReadableDirectory& dir,
+                                                           ArrayPtr<const PathPtr> paths,
+                                                           size_t padding = 0);
+// Reads the whole of each file in `paths`, relative to `dir`, submitting the opens, stats and
+// reads for many files to the kernel at once instead of making a blocking call per step. This
+// mainly helps where each call has real latency, such as on network filesystems.
+//
+// Each element of the result is null if that file doesn't exist. Each returned array's storage
+// extends `padding` zero bytes past its end, which is handy for parsers that want a sentinel.
+// A file that can't be read this way (not a regular file, changed size while being read) is read
+// the ordinary way instead, so errors are thrown just as ReadableDirectory::openFile() would.
+//
+// Returns null if batched I/O isn't available: it needs io_uring on Linux, and `dir` must be a
+// disk directory. Callers should then read the files themselves, perhaps on several threads.
+
 // =======================================================================================
 // inline implementation details
 
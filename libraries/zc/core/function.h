@@ -82,6 +82,10 @@ class Function;
 //
 // Notice how ZC_BIND_METHOD is able to figure out which overload to use depending on the kind of
 // Function it is binding to.
+//
+// A callable of up to three pointers in size (that can be moved without throwing) is stored inside
+// the Function itself; only bigger ones are allocated on the heap. That covers lambdas capturing a
+// few references, ZC_BIND_METHOD() on an lvalue, and `reference()`.
 
 template <typename Signature>
 class ConstFunction;
@@ -96,11 +100,102 @@ class FunctionParam;
 // outlive the FunctionParam instance. This is true when FunctionParam is used as a parameter type,
 // but not if it is used as a local variable nor a class member variable.
 
+namespace _ {  // private
+
+class FunctionIface {
+  // Base of the type-erased callables behind Function and ConstFunction.
+public:
+  virtual FunctionIface* moveTo(void* space) = 0;
+  // If this object is stored inline, moves it into `space`, destroys the original, and returns
+  // the new one. Otherwise returns `this`.
+
+  virtual void destroy() = 0;
+  // Destroys this object, and frees it if it's on the heap.
+};
+
+class FunctionStorage {
+  // Owns a FunctionIface, stored in `space` if it fits and on the heap otherwise.
+
+public:
+  FunctionStorage() = default;
+  FunctionStorage(FunctionStorage&& other) : impl(other.release(space)) {}
+  FunctionStorage& operator=(FunctionStorage&& other) {
+    if (this != &other) {
+      reset();
+      impl = other.release(space);
+    }
+    return *this;
+  }
+  ~FunctionStorage() noexcept(false) { reset(); }
+
+  template <typename Impl, typename F>
+  void init(F&& f) {
+    if constexpr (fitsInline<Impl>()) {
+      Impl* result = reinterpret_cast<Impl*>(space);
+      ctor(*result, zc::fwd<F>(f));
+      impl = result;
+    } else {
+      impl = new Impl(zc::fwd<F>(f));
+    }
+  }
+
+  inline FunctionIface* get() const { return impl; }
+
+  template <typename Impl>
+  static FunctionIface* moveImpl(Impl* impl, void* space) {
+    if constexpr (fitsInline<Impl>()) {
+      Impl* result = reinterpret_cast<Impl*>(space);
+      ctor(*result, zc::mv(*impl));
+      dtor(*impl);
+      return result;
+    } else {
+      return impl;
+    }
+  }
+
+  template <typename Impl>
+  static void destroyImpl(Impl* impl) {
+    if constexpr (fitsInline<Impl>()) {
+      dtor(*impl);
+    } else {
+      delete impl;
+    }
+  }
+
+private:
+  alignas(void*) byte space[4 * sizeof(void*)];
+  // A vtable pointer plus a callable of up to three pointers.
+
+  FunctionIface* impl = nullptr;
+
+  template <typename Impl>
+  static constexpr bool fitsInline() {
+    return sizeof(Impl) <= sizeof(space) && alignof(Impl) <= alignof(void*) &&
+           noexcept(Impl(zc::instance<Impl&&>()));
+  }
+
+  FunctionIface* release(void* to) {
+    FunctionIface* result = impl == nullptr ? nullptr : impl->moveTo(to);
+    impl = nullptr;
+    return result;
+  }
+
+  void reset() {
+    FunctionIface* old = impl;
+    impl = nullptr;
+    if (old != nullptr) old->destroy();
+  }
+};
+
+}  // namespace _
+
 template <typename Return, typename... Params>
 class Function<Return(Params...)> {
 public:
   template <typename F>
-  inline Function(F&& f) : impl(heap<Impl<F>>(zc::fwd<F>(f))) {}
+  inline Function(F&& f) {
+    storage.template init<Impl<F>>(zc::fwd<F>(f));
+  }
   Function() = default;
 
   // Make sure people don't accidentally end up wrapping a reference when they meant to return
@@ -119,18 +214,19 @@ public:
   Function(Function&&) = default;
   Function& operator=(Function&&) = default;
 
-  inline Return operator()(Params... params) { return (*impl)(zc::fwd<Params>(params)...); }
+  inline Return operator()(Params... params) { return iface()(zc::fwd<Params>(params)...); }
 
   Function reference() {
     // Forms a new Function of the same type that delegates to this Function by reference.
-    // Therefore, this Function must outlive the returned Function, but otherwise they behave
-    // exactly the same.
+    // Therefore, this Function must outlive the returned Function, and must not be moved while
+    // it's referenced (a callable stored inline moves with it), but otherwise they behave exactly
+    // the same.
 
-    return *impl;
+    return iface();
   }
 
 private:
-  class Iface {
+  class Iface : public _::FunctionIface {
   public:
     virtual Return operator()(Params... params) = 0;
   };
@@ -141,19 +237,27 @@ private:
     explicit Impl(F&& f) : f(zc::fwd<F>(f)) {}
 
     Return operator()(Params... params) override { return f(zc::fwd<Params>(params)...); }
+    _::FunctionIface* moveTo(void* space) override {
+      return _::FunctionStorage::moveImpl(this, space);
+    }
+    void destroy() override { _::FunctionStorage::destroyImpl(this); }
 
   private:
     F f;
   };
 
-  Own<Iface> impl;
+  _::FunctionStorage storage;
+
+  inline Iface& iface() { return *static_cast<Iface*>(storage.get()); }
 };
 
 template <typename Return, typename... Params>
 class ConstFunction<Return(Params...)> {
 public:
   template <typename F>
-  inline ConstFunction(F&& f) : impl(heap<Impl<F>>(zc::fwd<F>(f))) {}
+  inline ConstFunction(F&& f) {
+    storage.template init<Impl<F>>(zc::fwd<F>(f));
+  }
   ConstFunction() = default;
 
   // Make sure people don't accidentally end up wrapping a reference when they meant to return
@@ -172,18 +276,20 @@ public:
   ConstFunction(ConstFunction&&) = default;
   ConstFunction& operator=(ConstFunction&&) = default;
 
-  inline Return operator()(Params... params) const { return (*impl)(zc::fwd<Params>(params)...); }
+  inline Return operator()(Params... params) const {
+    return iface()(zc::fwd<Params>(params)...);
+  }
 
   ConstFunction reference() const {
     // Forms a new ConstFunction of the same type that delegates to this ConstFunction by reference.
-    // Therefore, this ConstFunction must outlive the returned ConstFunction, but otherwise they
-    // behave exactly the same.
+    // Therefore, this ConstFunction must outlive the returned ConstFunction, and must not be moved
+    // while it's referenced, but otherwise they behave exactly the same.
 
-    return *impl;
+    return iface();
   }
 
 private:
-  class Iface {
+  class Iface : public _::FunctionIface {
   public:
     virtual Return operator()(Params... params) const = 0;
   };
@@ -194,12 +300,18 @@ private:
     explicit Impl(F&& f) : f(zc::fwd<F>(f)) {}
 
     Return operator()(Params... params) const override { return f(zc::fwd<Params>(params)...); }
+    _::FunctionIface* moveTo(void* space) override {
+      return _::FunctionStorage::moveImpl(this, space);
+    }
+    void destroy() override { _::FunctionStorage::destroyImpl(this); }
 
   private:
     F f;
   };
 
-  Own<Iface> impl;
+  _::FunctionStorage storage;
+
+  inline const Iface& iface() const { return *static_cast<const Iface*>(storage.get()); }
 };
 
 template <typename Return, typename... Params>
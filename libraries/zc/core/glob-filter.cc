@@ -21,6 +21,8 @@
 
 #include "zc/core/glob-filter.h"
 
+#include <algorithm>
+
 namespace zc {
 
 GlobFilter::GlobFilter(const char* pattern) : pattern(heapString(pattern)) {}
@@ -94,4 +96,133 @@ void GlobFilter::applyState(char c, int state) {
   }
 }
 
+// =======================================================================================
+// GlobSet
+
+namespace {
+
+bool isSeparator(char c) { return c == '/' || c == '\\'; }
+
+}  // namespace
+
+GlobSet::GlobSet(ArrayPtr<const StringPtr> patterns) {
+  for (auto pattern : patterns) { add(pattern); }
+}
+
+uint GlobSet::add(StringPtr pattern) {
+  uint index = patternCount++;
+  starts.add(positions.size());
+  for (char c : pattern) {
+    Kind kind = c == '*' ? Kind::STAR : c == '?' ? Kind::ANY : Kind::LITERAL;
+    positions.add(Position{kind, c, index});
+  }
+  positions.add(Position{Kind::END, '\0', index});
+
+  compileClasses();
+  dfa.clear();
+  dfaIndex.clear();
+  return index;
+}
+
+ArrayPtr<const uint> GlobSet::matches(StringPtr name) {
+  if (patternCount == 0) { return nullptr; }
+
+  // State 0 is always the start, where every pattern is at its beginning.
+  if (dfa.empty()) { intern(heapArray(starts.asPtr())); }
+
+  uint state = 0;
+  for (char c : name) { state = step(state, c); }
+  return dfa[state].matched;
+}
+
+void GlobSet::compileClasses() {
+  bool literal[256] = {};
+  for (auto& position : positions) {
+    if (position.kind == Kind::LITERAL) { literal[byte(position.c)] = true; }
+  }
+
+  representatives.clear();
+  uint separatorClass = UNKNOWN;
+  uint otherClass = UNKNOWN;
+  for (uint i = 0; i < 256; i++) {
+    char c = char(i);
+    uint* shared = isSeparator(c) ? &separatorClass : &otherClass;
+    if (literal[i]) {
+      classes[i] = representatives.size();
+      representatives.add(c);
+    } else if (*shared == UNKNOWN) {
+      *shared = classes[i] = representatives.size();
+      representatives.add(c);
+    } else {
+      classes[i] = *shared;
+    }
+  }
+}
+
+uint GlobSet::intern(Array<uint> statePositions) {
+  ZC_IF_SOME(index, dfaIndex.find(statePositions.asPtr())) { return index; }
+
+  // A pattern matches if one of its states is at its end, or at '*'s just before the end.
+  Vector<uint> matched;
+  for (uint position : statePositions) {
+    while (positions[position].kind == Kind::STAR) { ++position; }
+    if (positions[position].kind == Kind::END) {
+      uint pattern = positions[position].pattern;
+      if (matched.empty() || matched.back() != pattern) { matched.add(pattern); }
+    }
+  }
+
+  auto next = heapArray<uint>(representatives.size());
+  for (auto& target : next) { target = UNKNOWN; }
+
+  uint index = dfa.size();
+  auto& state = dfa.add(DfaState{zc::mv(statePositions), matched.releaseAsArray(), zc::mv(next)});
+  dfaIndex.insert(state.positions.asPtr(), index);
+  return index;
+}
+
+uint GlobSet::step(uint state, byte c) {
+  byte cls = classes[c];
+  uint cached = dfa[state].next[cls];
+  if (cached != UNKNOWN) { return cached; }
+
+  // The same moves as GlobFilter::matches() makes, on every NFA state at once.
+  char representative = representatives[cls];
+  Vector<uint> next;
+  if (isSeparator(representative)) { next.addAll(starts); }
+  for (uint position : dfa[state].positions) { applyPosition(next, representative, position); }
+  std::sort(next.begin(), next.end());
+  auto end = std::unique(next.begin(), next.end());
+  next.truncate(end - next.begin());
+
+  if (dfa.size() >= MAX_DFA_STATES) {
+    dfa.clear();
+    dfaIndex.clear();
+    intern(heapArray(starts.asPtr()));
+    return intern(next.releaseAsArray());
+  }
+
+  uint target = intern(next.releaseAsArray());
+  dfa[state].next[cls] = target;
+  return target;
+}
+
+void GlobSet::applyPosition(Vector<uint>& next, char c, uint position) {
+  auto& state = positions[position];
+  switch (state.kind) {
+    case Kind::STAR:
+      if (!isSeparator(c)) { next.add(position); }
+      applyPosition(next, c, position + 1);
+      break;
+    case Kind::ANY:
+      if (!isSeparator(c)) { next.add(position + 1); }
+      break;
+    case Kind::LITERAL:
+      if (c == state.c) { next.add(position + 1); }
+      break;
+    case Kind::END:
+      break;
+  }
+}
+
 }  // namespace zc
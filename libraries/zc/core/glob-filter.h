@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "zc/core/map.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
 
@@ -42,4 +43,70 @@ private:
   void applyState(char c, int state);
 };
 
+class GlobSet {
+  // Matches a path against many GlobFilter-style patterns at once, e.g. the include and exclude
+  // lists of a directory walk. The patterns are compiled together into one DFA, built lazily as
+  // paths are matched, so each character of a path costs one table lookup however many patterns
+  // there are, and the DFA states reached are reused by every later path.
+
+public:
+  GlobSet() = default;
+  explicit GlobSet(ArrayPtr<const StringPtr> patterns);
+  ZC_DISALLOW_COPY(GlobSet);
+  GlobSet(GlobSet&&) = default;
+  GlobSet& operator=(GlobSet&&) = default;
+
+  uint add(StringPtr pattern);
+  // Returns the pattern's index, which matches() reports it by. Discards the DFA built so far.
+
+  size_t size() const { return patternCount; }
+
+  ArrayPtr<const uint> matches(StringPtr name);
+  // The indices of the patterns that match `name`, in increasing order. The result is valid until
+  // the next call to a non-const method.
+
+  bool matchesAny(StringPtr name) { return matches(name).size() > 0; }
+
+private:
+  enum class Kind : byte { LITERAL, STAR, ANY, END };
+
+  struct Position {
+    // One NFA state per character of each pattern, plus one for its end, numbered so that the
+    // state after `i` is `i + 1`.
+    Kind kind;
+    char c;
+    uint pattern;
+  };
+
+  struct DfaState {
+    Array<uint> positions;
+    // The NFA states this stands for, sorted.
+    Array<uint> matched;
+    Array<uint> next;
+    // Indexed by character class. UNKNOWN until first taken.
+  };
+
+  static constexpr uint UNKNOWN = maxValue;
+  static constexpr size_t MAX_DFA_STATES = 4096;
+  // A pathological set of patterns can have exponentially many DFA states, so the cache is
+  // flushed when it grows this big, falling back to building the states for each path anew.
+
+  Vector<Position> positions;
+  Vector<uint> starts;
+  size_t patternCount = 0;
+
+  byte classes[256] = {};
+  // Characters that no pattern tells apart share a class: one for all characters no pattern names,
+  // one for the separators, and one for each character that appears literally.
+  Vector<char> representatives;
+
+  Vector<DfaState> dfa;
+  HashMap<ArrayPtr<const uint>, uint> dfaIndex;
+
+  void compileClasses();
+  uint intern(Array<uint> positions);
+  uint step(uint state, byte c);
+  void applyPosition(Vector<uint>& next, char c, uint position);
+};
+
 }  // namespace zc
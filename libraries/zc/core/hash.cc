@@ -21,14 +21,26 @@
 
 #include "zc/core/hash.h"
 
+#if _MSC_VER && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+#if __AVX2__
+#include <immintrin.h>
+#define ZC_HASH_AVX2 1
+#elif __SSE2__ || _M_X64 || (_M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZC_HASH_SSE2 1
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_HASH_NEON 1
+#endif
+
 namespace zc {
 namespace _ {  // private
 
-uint HashCoder::operator*(ArrayPtr<const byte> s) const {
+uint murmur2(ArrayPtr<const byte> s) {
   // murmur2 adapted from libc++ source code.
-  //
-  // TODO(perf): Use CityHash or FarmHash on 64-bit machines? They seem optimized for x86-64; what
-  //   about ARM? Ask Vlad for advice.
 
   constexpr uint m = 0x5bd1e995;
   constexpr uint r = 24;
@@ -61,5 +73,227 @@ uint HashCoder::operator*(ArrayPtr<const byte> s) const {
   return h;
 }
 
+uint HashCoder::operator*(ArrayPtr<const byte> s) const {
+#if ZC_FAST_STRING_HASH
+  uint64_t h = fastHash64(s);
+  return uint(h ^ (h >> 32));
+#else
+  return murmur2(s);
+#endif
+}
+
+namespace {
+
+// The key material of fastHash64(): splitmix64 outputs from a seed of zero.
+constexpr uint64_t SECRET[16] = {
+    0xe220a8397b1dcdafull, 0x6e789e6aa1b965f4ull, 0x06c45d188009454full, 0xf88bb8a8724c81ecull,
+    0x1b39896a51a8749bull, 0x53cb9f0c747ea2eaull, 0x2c829abe1f4532e1ull, 0xc584133ac916ab3cull,
+    0x3ee5789041c98ac3ull, 0xf3b8488c368cb0a6ull, 0x657eecdd3cb13d09ull, 0xc2d326e0055bdef6ull,
+    0x8621a03fe0bbdb7bull, 0x8e1f7555983aa92full, 0xb54e0f1600cc4d19ull, 0x84bb3f97971d80abull,
+};
+
+// Inputs of at least this many bytes take the wide path.
+constexpr size_t WIDE_THRESHOLD = 1024;
+constexpr size_t STRIPE_SIZE = 64;
+constexpr size_t STRIPES_PER_BLOCK = 8;
+
+// Values are defined on little-endian words, so that they are the same on every platform.
+inline uint64_t read64(const byte* p) {
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap64(v);
+#endif
+  return v;
+}
+
+inline uint64_t read32(const byte* p) {
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  v = __builtin_bswap32(v);
+#endif
+  return v;
+}
+
+inline void multiply128(uint64_t& a, uint64_t& b) {
+  // Replace `a` and `b` by the low and high halves of their product.
+#if __SIZEOF_INT128__
+  unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#elif _MSC_VER && _M_X64
+  a = _umul128(a, b, &b);
+#else
+  uint64_t ha = a >> 32, hb = b >> 32, la = uint32_t(a), lb = uint32_t(b);
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+  multiply128(a, b);
+  return a ^ b;
+}
+
+// -----------------------------------------------------------------------------
+// Wide path: eight 64-bit lanes, each accumulating the 32x32-bit product of a keyed word and the
+// word itself, as XXH3 does. Stripe `n` of a block is keyed with SECRET[n..n+7], and the lanes are
+// scrambled after each block, so that reordering stripes changes the hash. Every implementation
+// computes exactly what the scalar one does.
+
+#if ZC_HASH_AVX2 && __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+void accumulate(uint64_t acc[8], const byte* p, size_t stripes, size_t keyOffset) {
+  __m256i lanes[2];
+  for (size_t j = 0; j < 2; j++) {
+    lanes[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + j * 4));
+  }
+  for (size_t n = 0; n < stripes; n++, p += STRIPE_SIZE) {
+    const uint64_t* key = SECRET + keyOffset + n;
+    for (size_t j = 0; j < 2; j++) {
+      __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + j * 32));
+      __m256i keyed = _mm256_xor_si256(
+          data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key + j * 4)));
+      __m256i product = _mm256_mul_epu32(keyed, _mm256_srli_epi64(keyed, 32));
+      __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[j] = _mm256_add_epi64(lanes[j], _mm256_add_epi64(swapped, product));
+    }
+  }
+  for (size_t j = 0; j < 2; j++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + j * 4), lanes[j]);
+  }
+}
+#elif ZC_HASH_SSE2 && __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+void accumulate(uint64_t acc[8], const byte* p, size_t stripes, size_t keyOffset) {
+  __m128i lanes[4];
+  for (size_t j = 0; j < 4; j++) {
+    lanes[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + j * 2));
+  }
+  for (size_t n = 0; n < stripes; n++, p += STRIPE_SIZE) {
+    const uint64_t* key = SECRET + keyOffset + n;
+    for (size_t j = 0; j < 4; j++) {
+      __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + j * 16));
+      __m128i keyed =
+          _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key + j * 2)));
+      __m128i product = _mm_mul_epu32(keyed, _mm_srli_epi64(keyed, 32));
+      __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[j] = _mm_add_epi64(lanes[j], _mm_add_epi64(swapped, product));
+    }
+  }
+  for (size_t j = 0; j < 4; j++) {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + j * 2), lanes[j]);
+  }
+}
+#elif ZC_HASH_NEON && __BYTE_ORDER__ != __ORDER_BIG_ENDIAN__
+void accumulate(uint64_t acc[8], const byte* p, size_t stripes, size_t keyOffset) {
+  uint64x2_t lanes[4];
+  for (size_t j = 0; j < 4; j++) { lanes[j] = vld1q_u64(acc + j * 2); }
+  for (size_t n = 0; n < stripes; n++, p += STRIPE_SIZE) {
+    const uint64_t* key = SECRET + keyOffset + n;
+    for (size_t j = 0; j < 4; j++) {
+      uint64x2_t data = vreinterpretq_u64_u8(vld1q_u8(p + j * 16));
+      uint64x2_t keyed = veorq_u64(data, vld1q_u64(key + j * 2));
+      uint64x2_t product = vmull_u32(vmovn_u64(keyed), vshrn_n_u64(keyed, 32));
+      uint64x2_t swapped = vextq_u64(data, data, 1);
+      lanes[j] = vaddq_u64(lanes[j], vaddq_u64(swapped, product));
+    }
+  }
+  for (size_t j = 0; j < 4; j++) { vst1q_u64(acc + j * 2, lanes[j]); }
+}
+#else
+void accumulate(uint64_t acc[8], const byte* p, size_t stripes, size_t keyOffset) {
+  for (size_t n = 0; n < stripes; n++, p += STRIPE_SIZE) {
+    const uint64_t* key = SECRET + keyOffset + n;
+    for (size_t i = 0; i < 8; i++) {
+      uint64_t data = read64(p + i * 8);
+      uint64_t keyed = data ^ key[i];
+      acc[i ^ 1] += data;
+      acc[i] += (keyed & 0xffffffff) * (keyed >> 32);
+    }
+  }
+}
+#endif
+
+void scramble(uint64_t acc[8]) {
+  for (size_t i = 0; i < 8; i++) { acc[i] = (acc[i] ^ (acc[i] >> 47) ^ SECRET[i]) * 0x9e3779b1; }
+}
+
+uint64_t wideHash(const byte* p, size_t len, uint64_t seed) {
+  uint64_t acc[8];
+  for (size_t i = 0; i < 8; i++) { acc[i] = SECRET[i] ^ seed; }
+
+  // The last stripe is always the input's last 64 bytes, overlapping the one before if need be.
+  size_t stripes = (len - 1) / STRIPE_SIZE;
+  for (size_t block = 0; block < stripes; block += STRIPES_PER_BLOCK) {
+    size_t count = zc::min(STRIPES_PER_BLOCK, stripes - block);
+    accumulate(acc, p + block * STRIPE_SIZE, count, 0);
+    if (count == STRIPES_PER_BLOCK) { scramble(acc); }
+  }
+  accumulate(acc, p + len - STRIPE_SIZE, 1, STRIPES_PER_BLOCK - 1);
+
+  uint64_t h = len * 0x9e3779b97f4a7c15ull;
+  for (size_t j = 0; j < 4; j++) {
+    h += mix(acc[j * 2] ^ SECRET[8 + j * 2], acc[j * 2 + 1] ^ SECRET[9 + j * 2]);
+  }
+  return mix(h ^ SECRET[0], seed ^ SECRET[1]);
+}
+
+}  // namespace
+
 }  // namespace _
+
+uint64_t fastHash64(ArrayPtr<const byte> data, uint64_t seed) {
+  // Shorter inputs follow rapidhash's structure: two words read with overlap for up to 16 bytes,
+  // and three independent multiply chains over 48-byte chunks above that.
+  using namespace _;
+
+  const byte* p = data.begin();
+  const size_t len = data.size();
+  if (len >= WIDE_THRESHOLD) { return wideHash(p, len, seed); }
+
+  seed ^= mix(seed ^ SECRET[0], SECRET[1]) ^ len;
+  uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      const byte* last = p + len - 4;
+      const size_t delta = (len & 24) >> (len >> 3);
+      a = (read32(p) << 32) | read32(last);
+      b = (read32(p + delta) << 32) | read32(last - delta);
+    } else if (len > 0) {
+      a = (uint64_t(p[0]) << 56) | (uint64_t(p[len >> 1]) << 32) | p[len - 1];
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = mix(read64(p) ^ SECRET[0], read64(p + 8) ^ seed);
+        see1 = mix(read64(p + 16) ^ SECRET[1], read64(p + 24) ^ see1);
+        see2 = mix(read64(p + 32) ^ SECRET[2], read64(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    if (i > 16) {
+      seed = mix(read64(p) ^ SECRET[2], read64(p + 8) ^ seed ^ SECRET[1]);
+      if (i > 32) { seed = mix(read64(p + 16) ^ SECRET[2], read64(p + 24) ^ seed); }
+    }
+    a = read64(p + i - 16);
+    b = read64(p + i - 8);
+  }
+  a ^= SECRET[1];
+  b ^= seed;
+  multiply128(a, b);
+  return mix(a ^ SECRET[0] ^ len, b ^ SECRET[1]);
+}
+
 }  // namespace zc
@@ -38,6 +38,9 @@ namespace _ {  // private
 inline uint intHash32(uint32_t i);
 inline uint intHash64(uint64_t i);
 
+uint murmur2(ArrayPtr<const byte> s);
+// The hash of bytes HashCoder uses unless ZC_FAST_STRING_HASH is set.
+
 struct HashCoder {
   // This is a dummy type with only one instance: HASHCODER (below).  To make an arbitrary type
   // hashable, define `operator*(HashCoder, T)` to return any other type that is already hashable.
@@ -61,6 +64,10 @@ struct HashCoder {
   inline uint operator*(const String& s) const { return operator*(s.asBytes()); }
   inline uint operator*(const StringPtr& s) const { return operator*(s.asBytes()); }
   inline uint operator*(const ConstString& s) const { return operator*(s.asBytes()); }
+  template <size_t smallSize>
+  inline uint operator*(const SmallString<smallSize>& s) const {
+    return operator*(s.asBytes());
+  }
 
   inline uint operator*(decltype(nullptr)) const { return 0; }
   inline uint operator*(bool b) const { return b; }
@@ -126,6 +133,7 @@ static ZC_CONSTEXPR(const) HashCoder HASHCODER = HashCoder();
 }  // namespace _
 
 #define ZC_HASHCODE(...) operator*(::zc::_::HashCoder, __VA_ARGS__)
+
 // Defines a hash function for a custom type.  Example:
 //
 //    class Foo {...};
@@ -157,6 +165,16 @@ static ZC_CONSTEXPR(const) HashCoder HASHCODER = HashCoder();
 //   to call a specific API to construct a `HashCode` value, like
 //   `zc::HashCode::fromUniformInteger(hash)`, which promises that the value is already uniform.
 
+uint64_t fastHash64(ArrayPtr<const byte> data, uint64_t seed = 0);
+// A 64-bit hash of `data` for hash tables and checksums that need not be cryptographic, several
+// times faster than murmur2 on long inputs: short ones follow rapidhash's design, and inputs of a
+// kilobyte or more are hashed eight 64-bit lanes at a time with AVX2, SSE2 or NEON where available.
+// Its values are the same on every platform and will not change, so they may be persisted.
+//
+// `hashCode()` of strings and byte arrays uses it instead of murmur2 when the library is built with
+// ZC_FAST_STRING_HASH defined to 1. That changes every hash code of such data, so it is opt-in for
+// users who persist hash codes; define it the same way in every translation unit.
+
 template <typename T>
 inline uint hashCode(T&& value) {
   return _::HASHCODER * zc::fwd<T>(value);
@@ -0,0 +1,293 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#if _WIN32 || __CYGWIN__
+#include "zc/core/win32-api-version.h"
+#endif
+
+#include "zc/core/log-sink.h"
+
+#include "zc/core/debug.h"
+#include "zc/core/miniposix.h"
+
+namespace zc {
+
+struct AsyncLogSink::Record {
+  LogSeverity severity;
+  const char* file;
+  // Null if `text` is already a complete line.
+
+  int line;
+  const char* macroArgs;
+  Array<String> argValues;
+  // The ZC_LOG() macro's argument text, and its stringified arguments. The message is built from
+  // these on the background thread.
+
+  String text;
+};
+
+struct AsyncLogSink::Ring {
+  explicit Ring(size_t capacity) : queue(capacity) {}
+
+  SpscQueue<Record> queue;
+  std::atomic<bool> closed = false;
+  // Set when the owning thread exits; it won't push again.
+};
+
+namespace {
+
+struct Installed {
+  AsyncLogSink* sink = nullptr;
+  uint64_t id = 0;
+};
+
+MutexGuarded<Installed>& installed() {
+  static MutexGuarded<Installed> instance;
+  return instance;
+}
+
+std::atomic<AsyncLogSink*> activeSink = nullptr;
+// Same as `installed().sink`, for the logging fast path.
+
+std::atomic<uint64_t> nextSinkId = 1;
+
+thread_local bool onSinkThread = false;
+// The background thread writes its own messages synchronously, since it can't wait on itself.
+
+struct ThreadRing {
+  // The calling thread's ring in the current sink. Since the sink owns the ring, the thread only
+  // marks it closed on exit -- and only if that sink still exists.
+
+  uint64_t sinkId = 0;
+  AsyncLogSink::Ring* ring = nullptr;
+
+  ~ThreadRing() noexcept(false) {
+    if (ring == nullptr) return;
+    auto lock = installed().lockExclusive();
+    if (lock->id == sinkId) ring->closed.store(true, std::memory_order_release);
+  }
+};
+
+thread_local ThreadRing threadRing;
+
+}  // namespace
+
+namespace _ {  // private
+
+bool logAsync(const char* file, int line, LogSeverity severity, const char* macroArgs,
+              ArrayPtr<String> argValues) {
+  AsyncLogSink* sink = activeSink.load(std::memory_order_acquire);
+  if (ZC_LIKELY(sink == nullptr) || onSinkThread || hasScopedExceptionCallback()) return false;
+
+  auto args = heapArrayBuilder<String>(argValues.size());
+  for (auto& value : argValues) args.add(zc::mv(value));
+  AsyncLogSink::Record record{severity, file, line, macroArgs, args.finish(), nullptr};
+
+  if (severity == LogSeverity::FATAL) {
+    sink->writeNow(zc::mv(record));
+  } else {
+    sink->push(zc::mv(record));
+  }
+  return true;
+}
+
+bool logAsync(LogSeverity severity, String& line) {
+  AsyncLogSink* sink = activeSink.load(std::memory_order_acquire);
+  if (ZC_LIKELY(sink == nullptr) || onSinkThread) return false;
+
+  AsyncLogSink::Record record{severity, nullptr, 0, nullptr, nullptr, zc::mv(line)};
+  if (severity == LogSeverity::FATAL) {
+    sink->writeNow(zc::mv(record));
+  } else {
+    sink->push(zc::mv(record));
+  }
+  return true;
+}
+
+}  // namespace _
+
+AsyncLogSink::AsyncLogSink(int fd, size_t ringCapacity)
+    : fd(fd),
+      ringCapacity(ringCapacity),
+      id(nextSinkId.fetch_add(1, std::memory_order_relaxed)) {
+  {
+    auto lock = installed().lockExclusive();
+    ZC_REQUIRE(lock->sink == nullptr, "only one AsyncLogSink may exist at a time");
+    lock->sink = this;
+    lock->id = id;
+  }
+
+  thread = heap<Thread>([this]() { run(); });
+  activeSink.store(this, std::memory_order_release);
+}
+
+AsyncLogSink::~AsyncLogSink() noexcept(false) {
+  {
+    auto lock = installed().lockExclusive();
+    activeSink.store(nullptr, std::memory_order_relaxed);
+    lock->sink = nullptr;
+    lock->id = 0;
+  }
+
+  state.lockExclusive()->stopping = true;
+  notEmpty.notifyOne();
+  thread = nullptr;
+}
+
+void AsyncLogSink::flush() {
+  if (onSinkThread) return;
+
+  uint64_t ticket;
+  {
+    auto lock = state.lockExclusive();
+    ticket = ++lock->flushRequests;
+  }
+  notEmpty.notifyOne();
+  state.when([ticket](const State& s) { return s.flushesDone >= ticket; }, [](State&) {});
+}
+
+void AsyncLogSink::push(Record&& record) {
+  auto& local = threadRing;
+  if (local.sinkId != id) {
+    auto ring = heap<Ring>(ringCapacity);
+    local.ring = ring.get();
+    local.sinkId = id;
+    rings.lockExclusive()->add(zc::mv(ring));
+  }
+
+  auto& queue = local.ring->queue;
+  while (!queue.tryPush(zc::mv(record))) {
+    // Full. Make sure the background thread is awake, then wait for it to make room.
+    notEmpty.notifyOne();
+    uint epoch = notFull.prepareWait();
+    if (queue.tryPush(zc::mv(record))) {
+      notFull.cancelWait();
+      break;
+    }
+    notFull.wait(epoch);
+  }
+  notEmpty.notifyOne();
+}
+
+void AsyncLogSink::writeNow(Record&& record) {
+  flush();
+  write(arrayPtr(&record, 1));
+}
+
+bool AsyncLogSink::drain(Vector<Record>& batch) {
+  bool any = false;
+  auto lock = rings.lockExclusive();
+  for (size_t i = 0; i < lock->size();) {
+    Ring& ring = *(*lock)[i];
+    // Read `closed` first: if it was set, nothing can be pushed after what we pop now.
+    bool closed = ring.closed.load(std::memory_order_acquire);
+
+    // Take no more than one ring's worth per pass, so that a busy thread can't starve the rest.
+    bool empty = false;
+    for (size_t n = 0; n < ring.queue.capacity(); n++) {
+      Maybe<Record> record = ring.queue.tryPop();
+      ZC_IF_SOME(r, record) {
+        batch.add(zc::mv(r));
+        any = true;
+      }
+      else {
+        empty = true;
+        break;
+      }
+    }
+
+    if (closed && empty) {
+      (*lock)[i] = zc::mv(lock->back());
+      lock->removeLast();
+    } else {
+      ++i;
+    }
+  }
+  return any;
+}
+
+void AsyncLogSink::write(ArrayPtr<Record> batch) {
+  Vector<String> lines(batch.size());
+  for (auto& record : batch) {
+    if (record.file == nullptr) {
+      lines.add(zc::mv(record.text));
+    } else {
+      lines.add(str(trimSourceFilename(record.file), ":", record.line, ": ", record.severity, ": ",
+                    _::Debug::makeDescriptionInternal(record.macroArgs, record.argValues), '\n'));
+    }
+  }
+
+  String text = strArray(lines, "");
+  StringPtr textPtr = text;
+  while (textPtr != nullptr) {
+    miniposix::ssize_t n = miniposix::write(fd, textPtr.begin(), textPtr.size());
+    if (n <= 0) {
+      // The output is broken. Give up, as the root ExceptionCallback does.
+      return;
+    }
+    textPtr = textPtr.slice(n);
+  }
+}
+
+void AsyncLogSink::run() {
+  onSinkThread = true;
+  Vector<Record> batch;
+  uint64_t flushed = 0;
+
+  for (;;) {
+    uint64_t flushRequests;
+    bool stopping;
+    {
+      auto lock = state.lockShared();
+      flushRequests = lock->flushRequests;
+      stopping = lock->stopping;
+    }
+
+    // Everything pushed before a flush request or the stop request is in the rings by now.
+    for (;;) {
+      drain(batch);
+      if (batch.empty()) break;
+      notFull.notifyAll();
+      write(batch);
+      batch.clear();
+    }
+
+    if (flushRequests != flushed) {
+      state.lockExclusive()->flushesDone = flushRequests;
+      flushed = flushRequests;
+    }
+    if (stopping) return;
+
+    uint epoch = notEmpty.prepareWait();
+    bool changed;
+    {
+      auto lock = state.lockShared();
+      changed = lock->flushRequests != flushRequests || lock->stopping;
+    }
+    if (changed || drain(batch)) {
+      notEmpty.cancelWait();
+      continue;
+    }
+    notEmpty.wait(epoch);
+  }
+}
+
+}  // namespace zc
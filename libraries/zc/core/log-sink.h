@@ -0,0 +1,121 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+
+#include "zc/core/concurrent-queue.h"
+#include "zc/core/exception.h"
+#include "zc/core/mutex.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+bool logAsync(const char* file, int line, LogSeverity severity, const char* macroArgs,
+              ArrayPtr<String> argValues);
+// Hands a ZC_LOG() message to the AsyncLogSink, if there is one and the calling thread has no
+// ExceptionCallback in scope, moving from `argValues`. Returns false if the caller should log
+// the message itself.
+
+bool logAsync(LogSeverity severity, String& line);
+// Same, for a complete line of output from the root ExceptionCallback. Moves from `line` only
+// when returning true.
+
+}  // namespace _
+
+class AsyncLogSink {
+  // Moves the cost of log messages off the threads that log them. While an AsyncLogSink exists,
+  // a ZC_LOG() only stringifies its arguments and pushes them, along with the static file, line,
+  // and macro-argument text, onto a ring buffer belonging to the calling thread. A background
+  // thread collects the records from every thread's ring, builds the messages, and writes them to
+  // `fd` in batches. The log-level check in front of all this is unchanged.
+  //
+  // Messages are only deferred when the logging thread has no ExceptionCallback of its own in
+  // scope; otherwise they go to that callback as usual, so that callbacks which capture or
+  // redirect logs (such as the ones in tests) keep working. Text that reaches the root callback
+  // already formatted -- exceptions logged during unwind, for example -- is written by the sink
+  // as well, so nothing is written out of order with respect to it. FATAL messages are written
+  // synchronously, after everything queued before them.
+  //
+  // Messages from one thread are written in the order they were logged; messages from different
+  // threads may be interleaved differently than they happened. A thread whose ring is full waits
+  // for the background thread to catch up rather than dropping messages.
+  //
+  // At most one AsyncLogSink may exist at a time. It must outlive all logging in other threads:
+  // destroy it only once those threads are done. The destructor writes out everything that is
+  // still queued.
+
+public:
+  explicit AsyncLogSink(int fd = 2, size_t ringCapacity = 1024);
+  // `fd` defaults to stderr. `ringCapacity` is the number of messages each thread can have
+  // queued, rounded up to a power of two.
+
+  ~AsyncLogSink() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(AsyncLogSink);
+
+  void flush();
+  // Waits until everything the calling thread logged before the call has been written.
+
+  struct Record;
+  struct Ring;
+
+private:
+  const int fd;
+  const size_t ringCapacity;
+  const uint64_t id;
+  // Distinguishes this sink from an earlier one at the same address, in threads' cached rings.
+
+  MutexGuarded<Vector<Own<Ring>>> rings;
+  // One per thread that has logged. The background thread drops a ring once its thread has exited
+  // and the ring is empty.
+
+  struct State {
+    uint64_t flushRequests = 0;
+    uint64_t flushesDone = 0;
+    bool stopping = false;
+  };
+  MutexGuarded<State> state;
+
+  _::QueueWaiter notEmpty;
+  _::QueueWaiter notFull;
+
+  Own<Thread> thread;
+
+  void push(Record&& record);
+  void writeNow(Record&& record);
+  bool drain(Vector<Record>& batch);
+  void write(ArrayPtr<Record> batch);
+  void run();
+
+  friend bool _::logAsync(const char* file, int line, LogSeverity severity,
+                          const char* macroArgs, ArrayPtr<String> argValues);
+  friend bool _::logAsync(LogSeverity severity, String& line);
+};
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -22,9 +22,20 @@
 #include "zc/core/memory.h"
 
 #include <stdlib.h>
+#include <string.h>
+
+#include <new>
 
 #include "zc/core/debug.h"
 
+#if ZC_HAS_JEMALLOC
+#include <jemalloc/jemalloc.h>
+#endif  // ZC_HAS_JEMALLOC
+
+#if ZC_HAS_MIMALLOC
+#include <mimalloc.h>
+#endif  // ZC_HAS_MIMALLOC
+
 namespace zc {
 
 const NullDisposer NullDisposer::instance = NullDisposer();
@@ -48,4 +59,362 @@ void throwWrongDisposerError() {
 
 }  // namespace _
 
+// =======================================================================================
+// Allocation tracking
+
+AllocationCounts& AllocationCounts::operator+=(const AllocationCounts& other) {
+  heapAllocations += other.heapAllocations;
+  heapDisposals += other.heapDisposals;
+  arrayAllocations += other.arrayAllocations;
+  arrayDisposals += other.arrayDisposals;
+  bytes += other.bytes;
+  return *this;
+}
+
+namespace {
+
+thread_local const char* currentAllocationCategory = "";
+
+bool sameCategory(const char* a, const char* b) { return a == b || strcmp(a, b) == 0; }
+
+}  // namespace
+
+AllocationScope::AllocationScope(const char* category) : previous(currentAllocationCategory) {
+  currentAllocationCategory = category;
+}
+
+AllocationScope::~AllocationScope() noexcept(false) { currentAllocationCategory = previous; }
+
+#if ZC_TRACK_ALLOCATIONS
+
+namespace _ {
+
+std::atomic<AllocationTracker*> activeAllocationTracker{nullptr};
+
+void recordAllocation(AllocationKind kind, size_t bytes) {
+  // The tracker may have gone away since trackAllocation() looked
+  AllocationTracker* tracker = activeAllocationTracker.load(std::memory_order_acquire);
+  if (tracker != nullptr) { tracker->record(currentAllocationCategory, kind, bytes); }
+}
+
+}  // namespace _
+
+AllocationTracker::AllocationTracker() {
+  AllocationTracker* expected = nullptr;
+  ZC_REQUIRE(_::activeAllocationTracker.compare_exchange_strong(expected, this,
+                                                                std::memory_order_acq_rel),
+             "only one AllocationTracker may exist at a time");
+}
+
+AllocationTracker::~AllocationTracker() noexcept(false) {
+  _::activeAllocationTracker.store(nullptr, std::memory_order_release);
+}
+
+AllocationTracker::Slot& AllocationTracker::getSlot(const char* category) {
+  for (size_t i = 0; i < MAX_CATEGORIES; ++i) {
+    Slot& slot = slots[i];
+    const char* claimed = slot.category.load(std::memory_order_acquire);
+    if (claimed == nullptr) {
+      // Claim it, unless another thread just did
+      if (slot.category.compare_exchange_strong(claimed, category, std::memory_order_acq_rel)) {
+        return slot;
+      }
+    }
+    if (sameCategory(claimed, category)) { return slot; }
+  }
+  return slots[MAX_CATEGORIES];
+}
+
+void AllocationTracker::record(const char* category, AllocationKind kind, size_t bytes) {
+  Slot& slot = getSlot(category);
+  slot.counts[static_cast<uint>(kind)].fetch_add(1, std::memory_order_relaxed);
+  if (bytes > 0) { slot.counts[4].fetch_add(bytes, std::memory_order_relaxed); }
+}
+
+AllocationCounts AllocationTracker::read(const Slot& slot) {
+  AllocationCounts counts;
+  counts.heapAllocations = slot.counts[static_cast<uint>(AllocationKind::HEAP)].load(
+      std::memory_order_relaxed);
+  counts.heapDisposals = slot.counts[static_cast<uint>(AllocationKind::HEAP_DISPOSAL)].load(
+      std::memory_order_relaxed);
+  counts.arrayAllocations = slot.counts[static_cast<uint>(AllocationKind::ARRAY)].load(
+      std::memory_order_relaxed);
+  counts.arrayDisposals = slot.counts[static_cast<uint>(AllocationKind::ARRAY_DISPOSAL)].load(
+      std::memory_order_relaxed);
+  counts.bytes = slot.counts[4].load(std::memory_order_relaxed);
+  return counts;
+}
+
+AllocationCounts AllocationTracker::getCounts() const {
+  AllocationCounts total;
+  for (const Slot& slot : slots) { total += read(slot); }
+  return total;
+}
+
+AllocationCounts AllocationTracker::getCounts(const char* category) const {
+  AllocationCounts total;
+  for (size_t i = 0; i < MAX_CATEGORIES; ++i) {
+    const char* claimed = slots[i].category.load(std::memory_order_acquire);
+    if (claimed != nullptr && sameCategory(claimed, category)) { total += read(slots[i]); }
+  }
+  if (sameCategory(category, "(other)")) { total += read(slots[MAX_CATEGORIES]); }
+  return total;
+}
+
+void AllocationTracker::reset() {
+  for (Slot& slot : slots) {
+    for (auto& count : slot.counts) { count.store(0, std::memory_order_relaxed); }
+  }
+}
+
+#else  // ZC_TRACK_ALLOCATIONS
+
+AllocationTracker::AllocationTracker() {}
+AllocationTracker::~AllocationTracker() noexcept(false) {}
+AllocationCounts AllocationTracker::getCounts() const { return {}; }
+AllocationCounts AllocationTracker::getCounts(const char* category) const { return {}; }
+void AllocationTracker::reset() {}
+
+#endif  // ZC_TRACK_ALLOCATIONS
+
+// =======================================================================================
+// HeapAllocator
+
+namespace {
+
+constexpr size_t DEFAULT_NEW_ALIGNMENT = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+class SystemHeapAllocator final : public HeapAllocator {
+public:
+  void* allocate(size_t size, size_t alignment) override {
+    if (alignment > DEFAULT_NEW_ALIGNMENT) {
+      return operator new(size, std::align_val_t(alignment));
+    }
+    return operator new(size);
+  }
+
+  void deallocate(void* pointer, size_t size, size_t alignment) override {
+    if (alignment > DEFAULT_NEW_ALIGNMENT) {
+      operator delete(pointer, size, std::align_val_t(alignment));
+    } else {
+      operator delete(pointer, size);
+    }
+  }
+
+  const char* getName() const override { return "system"; }
+};
+
+SystemHeapAllocator systemHeapAllocator;
+
+struct ThreadHeapCache {
+  // One thread's freelists for ThreadCachingHeapAllocator.
+
+  static constexpr uint MIN_CLASS_BITS = 4;
+  static constexpr uint CLASS_COUNT = 7;
+  // Size classes of 16, 32, ..., 1024 bytes.
+  static constexpr size_t MAX_CACHED_BYTES = 64 * 1024;
+  // Per size class.
+
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+
+  FreeBlock* freelists[CLASS_COUNT] = {};
+  uint counts[CLASS_COUNT] = {};
+  bool destroyed = false;
+  // Once the thread's cache is gone, allocations made by other thread-local destructors go
+  // straight to operator new and delete.
+
+  static constexpr size_t classSize(uint sizeClass) {
+    return size_t(1) << (sizeClass + MIN_CLASS_BITS);
+  }
+
+  ~ThreadHeapCache() {
+    for (uint sizeClass = 0; sizeClass < CLASS_COUNT; sizeClass++) {
+      while (freelists[sizeClass] != nullptr) {
+        FreeBlock* block = freelists[sizeClass];
+        freelists[sizeClass] = block->next;
+        operator delete(block, classSize(sizeClass));
+      }
+      counts[sizeClass] = 0;
+    }
+    destroyed = true;
+  }
+};
+
+thread_local ThreadHeapCache threadHeapCache;
+
+class ThreadCachingHeapAllocator final : public HeapAllocator {
+public:
+  void* allocate(size_t size, size_t alignment) override {
+    uint sizeClass;
+    if (!getSizeClass(size, alignment, sizeClass)) {
+      return systemHeapAllocator.allocate(size, alignment);
+    }
+
+    ThreadHeapCache& cache = threadHeapCache;
+    ThreadHeapCache::FreeBlock* block = cache.freelists[sizeClass];
+    if (block != nullptr) {
+      cache.freelists[sizeClass] = block->next;
+      --cache.counts[sizeClass];
+      return block;
+    }
+    return operator new(ThreadHeapCache::classSize(sizeClass));
+  }
+
+  void deallocate(void* pointer, size_t size, size_t alignment) override {
+    uint sizeClass;
+    if (!getSizeClass(size, alignment, sizeClass)) {
+      return systemHeapAllocator.deallocate(pointer, size, alignment);
+    }
+
+    ThreadHeapCache& cache = threadHeapCache;
+    size_t blockSize = ThreadHeapCache::classSize(sizeClass);
+    if (cache.destroyed ||
+        cache.counts[sizeClass] * blockSize >= ThreadHeapCache::MAX_CACHED_BYTES) {
+      return operator delete(pointer, blockSize);
+    }
+    auto block = reinterpret_cast<ThreadHeapCache::FreeBlock*>(pointer);
+    block->next = cache.freelists[sizeClass];
+    cache.freelists[sizeClass] = block;
+    ++cache.counts[sizeClass];
+  }
+
+  const char* getName() const override { return "thread-caching"; }
+
+private:
+  static bool getSizeClass(size_t size, size_t alignment, uint& sizeClass) {
+    constexpr size_t MAX_SIZE = ThreadHeapCache::classSize(ThreadHeapCache::CLASS_COUNT - 1);
+    if (size > MAX_SIZE || alignment > DEFAULT_NEW_ALIGNMENT) { return false; }
+    // The smallest class whose size is at least `size`.
+    constexpr uint MIN_BITS = ThreadHeapCache::MIN_CLASS_BITS;
+    uint bits = size <= 1 ? 0 : 64 - __builtin_clzll(size - 1);
+    sizeClass = bits <= MIN_BITS ? 0 : bits - MIN_BITS;
+    return true;
+  }
+};
+
+ThreadCachingHeapAllocator threadCachingHeapAllocator;
+
+#if ZC_HAS_JEMALLOC
+class JemallocHeapAllocator final : public HeapAllocator {
+public:
+  void* allocate(size_t size, size_t alignment) override {
+    void* result = mallocx(zc::max(size, size_t(1)), flags(alignment));
+    if (result == nullptr) { throw std::bad_alloc(); }
+    return result;
+  }
+
+  void deallocate(void* pointer, size_t size, size_t alignment) override {
+    sdallocx(pointer, zc::max(size, size_t(1)), flags(alignment));
+  }
+
+  const char* getName() const override { return "jemalloc"; }
+
+private:
+  static int flags(size_t alignment) {
+    return alignment > DEFAULT_NEW_ALIGNMENT ? MALLOCX_ALIGN(alignment) : 0;
+  }
+};
+
+JemallocHeapAllocator jemallocHeapAllocator;
+#endif  // ZC_HAS_JEMALLOC
+
+#if ZC_HAS_MIMALLOC
+class MimallocHeapAllocator final : public HeapAllocator {
+public:
+  void* allocate(size_t size, size_t alignment) override {
+    void* result = mi_malloc_aligned(size, alignment);
+    if (result == nullptr) { throw std::bad_alloc(); }
+    return result;
+  }
+
+  void deallocate(void* pointer, size_t size, size_t alignment) override {
+    mi_free_size_aligned(pointer, size, alignment);
+  }
+
+  const char* getName() const override { return "mimalloc"; }
+};
+
+MimallocHeapAllocator mimallocHeapAllocator;
+#endif  // ZC_HAS_MIMALLOC
+
+}  // namespace
+
+#if ZC_HEAP_ALLOCATOR
+namespace _ {
+std::atomic<HeapAllocator*> activeHeapAllocator{nullptr};
+}  // namespace _
+using _::activeHeapAllocator;
+#else
+namespace {
+std::atomic<HeapAllocator*> activeHeapAllocator{nullptr};
+// Nothing allocates through it, but setHeapAllocator() and getHeapAllocator() behave the same.
+}  // namespace
+#endif  // ZC_HEAP_ALLOCATOR
+
+HeapAllocator& getSystemHeapAllocator() { return systemHeapAllocator; }
+
+HeapAllocator& getThreadCachingHeapAllocator() { return threadCachingHeapAllocator; }
+
+Maybe<HeapAllocator&> getJemallocHeapAllocator() {
+#if ZC_HAS_JEMALLOC
+  return jemallocHeapAllocator;
+#else
+  return zc::none;
+#endif
+}
+
+Maybe<HeapAllocator&> getMimallocHeapAllocator() {
+#if ZC_HAS_MIMALLOC
+  return mimallocHeapAllocator;
+#else
+  return zc::none;
+#endif
+}
+
+Maybe<HeapAllocator&> findHeapAllocator(const char* name) {
+  if (strcmp(name, "system") == 0) { return getSystemHeapAllocator(); }
+  if (strcmp(name, "thread-caching") == 0) { return getThreadCachingHeapAllocator(); }
+  if (strcmp(name, "jemalloc") == 0) { return getJemallocHeapAllocator(); }
+  if (strcmp(name, "mimalloc") == 0) { return getMimallocHeapAllocator(); }
+  return zc::none;
+}
+
+void setHeapAllocator(HeapAllocator& allocator) {
+  HeapAllocator* expected = nullptr;
+  if (!activeHeapAllocator.compare_exchange_strong(expected, &allocator,
+                                                   std::memory_order_acq_rel) &&
+      expected != &allocator) {
+    ZC_FAIL_REQUIRE("setHeapAllocator() called after a heap allocator was chosen",
+                    expected->getName(), allocator.getName());
+  }
+}
+
+HeapAllocator& getHeapAllocator() {
+  HeapAllocator* current = activeHeapAllocator.load(std::memory_order_acquire);
+  if (current != nullptr) { return *current; }
+
+  // Choose without allocating, since zc::heap() may be what got us here.
+  const char* name = getenv("ZC_HEAP_ALLOCATOR");
+  HeapAllocator* chosen = &systemHeapAllocator;
+  bool unknown = false;
+  if (name != nullptr && *name != '\0') {
+    ZC_IF_SOME(allocator, findHeapAllocator(name)) {
+      chosen = &allocator;
+    } else {
+      unknown = true;
+    }
+  }
+
+  // Another thread may have chosen first; then theirs wins.
+  if (activeHeapAllocator.compare_exchange_strong(current, chosen, std::memory_order_acq_rel)) {
+    current = chosen;
+    if (unknown) {
+      ZC_LOG(WARNING, "unknown ZC_HEAP_ALLOCATOR; using the system allocator", name);
+    }
+  }
+  return *current;
+}
+
 }  // namespace zc
@@ -42,9 +42,23 @@
 #define ZC_ASSERT_PTR_COUNTERS ZC_DEBUG_MEMORY
 #endif  // ZC_ASSERT_PTR_COUNTERS
 
-#if ZC_ASSERT_PTR_COUNTERS
+// ZC_TRACK_ALLOCATIONS == 1 lets an AllocationTracker count the allocations of zc::heap() and
+// heap arrays. Costs a relaxed atomic load per allocation while no tracker is active.
+// ZC_TRACK_ALLOCATIONS == 0 compiles the hooks out, and AllocationTracker counts nothing.
+#if !defined(ZC_TRACK_ALLOCATIONS)
+#define ZC_TRACK_ALLOCATIONS 1
+#endif  // ZC_TRACK_ALLOCATIONS
+
+// ZC_HEAP_ALLOCATOR == 1 routes zc::heap() and heap arrays through the HeapAllocator chosen at
+// startup, instead of operator new and delete. Costs an atomic load and a virtual call per
+// allocation and disposal.
+#if !defined(ZC_HEAP_ALLOCATOR)
+#define ZC_HEAP_ALLOCATOR 0
+#endif  // ZC_HEAP_ALLOCATOR
+
+#if ZC_ASSERT_PTR_COUNTERS || ZC_TRACK_ALLOCATIONS || ZC_HEAP_ALLOCATOR
 #include <atomic>
-#endif  // ZC_ASSERT_PTR_COUNTERS
+#endif  // ZC_ASSERT_PTR_COUNTERS || ZC_TRACK_ALLOCATIONS || ZC_HEAP_ALLOCATOR
 
 ZC_BEGIN_HEADER
 
@@ -131,6 +145,185 @@ ZC_NORETURN(void throwWrongDisposerError());
 
 }  // namespace _
 
+// =======================================================================================
+// Allocation tracking
+
+enum class AllocationKind : uint8_t {
+  HEAP,            // An object allocated by zc::heap().
+  HEAP_DISPOSAL,   // An Own<T> from zc::heap() disposed of its object.
+  ARRAY,           // Backing storage of heapArray(), heapArrayBuilder(), String, or Vector growth.
+  ARRAY_DISPOSAL,  // Such storage freed.
+};
+
+struct AllocationCounts {
+  uint64_t heapAllocations = 0;
+  uint64_t heapDisposals = 0;
+  uint64_t arrayAllocations = 0;
+  uint64_t arrayDisposals = 0;
+  uint64_t bytes = 0;
+  // Bytes allocated, by both kinds of allocation. Disposals are not subtracted.
+
+  inline uint64_t allocations() const { return heapAllocations + arrayAllocations; }
+
+  AllocationCounts& operator+=(const AllocationCounts& other);
+};
+
+namespace _ {  // private
+void recordAllocation(AllocationKind kind, size_t bytes);
+}  // namespace _
+
+class AllocationTracker {
+  // Counts the allocations made through zc::heap() and heap arrays, by every thread, while it
+  // exists. Each allocation is counted under the category of the innermost AllocationScope of the
+  // thread that made it, or under no category outside of any scope. Allocations made directly with
+  // `new` or malloc() are not seen.
+  //
+  // Only one tracker may exist at a time. Destroy it only once other threads that may allocate
+  // have stopped doing so, since they do not synchronize with its destruction.
+  //
+  //     zc::AllocationTracker tracker;
+  //     {
+  //       zc::AllocationScope scope("lexer");
+  //       lexer.lexAll();
+  //     }
+  //     ZC_EXPECT(tracker.getCounts("lexer").allocations() < tokenCount);
+
+public:
+  AllocationTracker();
+  ~AllocationTracker() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(AllocationTracker);
+
+  AllocationCounts getCounts() const;
+  // Counts of every category.
+
+  AllocationCounts getCounts(const char* category) const;
+  // Counts of the scopes named `category`. Allocations outside of any scope count under "".
+
+  void reset();
+  // Set every count back to zero.
+
+  static constexpr size_t MAX_CATEGORIES = 32;
+  // Categories past this many are counted under "(other)".
+
+private:
+#if ZC_TRACK_ALLOCATIONS
+  struct Slot {
+    std::atomic<const char*> category{nullptr};
+    std::atomic<uint64_t> counts[5] = {};
+    // Indexed by AllocationKind, then bytes.
+  };
+
+  Slot slots[MAX_CATEGORIES + 1];
+  // Claimed in order; the last one is "(other)".
+
+  Slot& getSlot(const char* category);
+  void record(const char* category, AllocationKind kind, size_t bytes);
+  static AllocationCounts read(const Slot& slot);
+
+  friend void _::recordAllocation(AllocationKind kind, size_t bytes);
+#endif  // ZC_TRACK_ALLOCATIONS
+};
+
+class AllocationScope {
+  // Counts the allocations the calling thread makes while it exists under `category`, by the
+  // active AllocationTracker if there is one. `category` must outlive the scope; categories are
+  // told apart by their text.
+  //
+  // Scopes nest, and the innermost one wins. The category does not follow work handed to other
+  // threads, which count under their own scopes.
+
+public:
+  explicit AllocationScope(const char* category);
+  ~AllocationScope() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(AllocationScope);
+
+private:
+  const char* previous;
+};
+
+// =======================================================================================
+// HeapAllocator -- the allocator behind zc::heap() and heap arrays
+
+class HeapAllocator {
+  // The allocator behind zc::heap() and heap arrays, and so behind the growth of Vector, String
+  // and the like, when zc is built with ZC_HEAP_ALLOCATOR == 1. Otherwise they use operator new
+  // and delete directly, and the choice below has no effect. Objects allocated with `new`,
+  // including by refcounted() and attach(), are never affected.
+  //
+  // One allocator serves the whole process, since memory must go back to the allocator it came
+  // from. It is chosen before the first allocation through it, either by calling
+  // setHeapAllocator() early in main(), or else by the ZC_HEAP_ALLOCATOR environment variable,
+  // naming one of the allocators findHeapAllocator() knows. That way the same binary can be
+  // measured with each.
+
+public:
+  virtual void* allocate(size_t size, size_t alignment) = 0;
+  virtual void deallocate(void* pointer, size_t size, size_t alignment) = 0;
+  // `size` and `alignment` are always the ones given to allocate(), so implementations may size
+  // their deallocations. Both may be called from any thread.
+
+  virtual const char* getName() const = 0;
+};
+
+HeapAllocator& getSystemHeapAllocator();
+// "system": operator new and delete, as when ZC_HEAP_ALLOCATOR is 0. The default.
+
+HeapAllocator& getThreadCachingHeapAllocator();
+// "thread-caching": keeps a per-thread freelist of recently disposed blocks for each power-of-two
+// size class up to 1 KiB, and allocates from it before going to operator new. Blocks disposed on
+// another thread join that thread's freelist. Each freelist holds up to 64 KiB; larger or
+// over-aligned allocations go straight to operator new.
+
+Maybe<HeapAllocator&> getJemallocHeapAllocator();
+Maybe<HeapAllocator&> getMimallocHeapAllocator();
+// "jemalloc" and "mimalloc", using their sized deallocation, when zc is built with ZC_HAS_JEMALLOC
+// or ZC_HAS_MIMALLOC. Otherwise none.
+
+Maybe<HeapAllocator&> findHeapAllocator(const char* name);
+// One of the allocators above, by name.
+
+void setHeapAllocator(HeapAllocator& allocator);
+// Makes `allocator` the process's heap allocator. Throws if a different one was already chosen,
+// which happens at the first allocation through it, or by an earlier call.
+
+HeapAllocator& getHeapAllocator();
+// The process's heap allocator, choosing it first if need be.
+
+namespace _ {  // private
+
+#if ZC_HEAP_ALLOCATOR
+extern std::atomic<HeapAllocator*> activeHeapAllocator;
+
+inline void* allocateHeap(size_t size, size_t alignment) {
+  HeapAllocator* allocator = activeHeapAllocator.load(std::memory_order_acquire);
+  if (ZC_UNLIKELY(allocator == nullptr)) { allocator = &getHeapAllocator(); }
+  return allocator->allocate(size, alignment);
+}
+
+inline void deallocateHeap(void* pointer, size_t size, size_t alignment) {
+  // Anything being disposed of was allocated, so the allocator has been chosen.
+  activeHeapAllocator.load(std::memory_order_acquire)->deallocate(pointer, size, alignment);
+}
+#endif  // ZC_HEAP_ALLOCATOR
+
+}  // namespace _
+
+namespace _ {  // private
+
+#if ZC_TRACK_ALLOCATIONS
+extern std::atomic<AllocationTracker*> activeAllocationTracker;
+
+inline void trackAllocation(AllocationKind kind, size_t bytes) {
+  if (ZC_UNLIKELY(activeAllocationTracker.load(std::memory_order_relaxed) != nullptr)) {
+    recordAllocation(kind, bytes);
+  }
+}
+#else
+inline void trackAllocation(AllocationKind kind, size_t bytes) {}
+#endif  // ZC_TRACK_ALLOCATIONS
+
+}  // namespace _
+
 // =======================================================================================
 // Disposer -- Implementation details.
 
@@ -683,10 +876,33 @@ private:
 
 namespace _ {  // private
 
+template <typename T, typename... Params>
+inline T* newHeapObject(Params&&... params) {
+#if ZC_HEAP_ALLOCATOR
+  RemoveConst<T>* object = reinterpret_cast<RemoveConst<T>*>(allocateHeap(sizeof(T), alignof(T)));
+  bool constructed = false;
+  ZC_DEFER(if (!constructed) { deallocateHeap(object, sizeof(T), alignof(T)); });
+  ctor(*object, zc::fwd<Params>(params)...);
+  constructed = true;
+  return object;
+#else
+  return new T(zc::fwd<Params>(params)...);
+#endif  // ZC_HEAP_ALLOCATOR
+}
+
 template <typename T>
 class HeapDisposer final : public Disposer {
 public:
-  virtual void disposeImpl(void* pointer) const override { delete reinterpret_cast<T*>(pointer); }
+  virtual void disposeImpl(void* pointer) const override {
+    _::trackAllocation(AllocationKind::HEAP_DISPOSAL, 0);
+#if ZC_HEAP_ALLOCATOR
+    // Like `delete`, free the memory even if the destructor throws.
+    ZC_DEFER(deallocateHeap(pointer, sizeof(T), alignof(T)));
+    reinterpret_cast<T*>(pointer)->~T();
+#else
+    delete reinterpret_cast<T*>(pointer);
+#endif  // ZC_HEAP_ALLOCATOR
+  }
 
   static const HeapDisposer instance;
 };
@@ -717,11 +933,12 @@ static constexpr CustomDisposer<T, F> CUSTOM_DISPOSER_INSTANCE{};
 template <typename T, typename... Params>
 Own<T> heap(Params&&... params) {
   // heap<T>(...) allocates a T on the heap, forwarding the parameters to its constructor.  The
-  // exact heap implementation is unspecified -- for now it is operator new, but you should not
-  // assume this.  (Since we know the object size at delete time, we could actually implement an
-  // allocator that is more efficient than operator new.)
+  // exact heap implementation is unspecified -- by default it is operator new, or the
+  // HeapAllocator when built with ZC_HEAP_ALLOCATOR, but you should not assume either.
 
-  return Own<T>(new T(zc::fwd<Params>(params)...), _::HeapDisposer<T>::instance);
+  T* object = _::newHeapObject<T>(zc::fwd<Params>(params)...);
+  _::trackAllocation(AllocationKind::HEAP, sizeof(T));
+  return Own<T>(object, _::HeapDisposer<T>::instance);
 }
 
 template <typename T>
@@ -732,7 +949,9 @@ Own<Decay<T>> heap(T&& orig) {
   // one argument and the purpose is to copy it.
 
   typedef Decay<T> T2;
-  return Own<T2>(new T2(zc::fwd<T>(orig)), _::HeapDisposer<T2>::instance);
+  T2* object = _::newHeapObject<T2>(zc::fwd<T>(orig));
+  _::trackAllocation(AllocationKind::HEAP, sizeof(T2));
+  return Own<T2>(object, _::HeapDisposer<T2>::instance);
 }
 
 template <auto F, typename T>
@@ -71,6 +71,11 @@ public:
   bool lock(Exclusivity exclusivity, Maybe<Duration> timeout, LockSourceLocationArg location);
   void unlock(Exclusivity exclusivity, Waiter* waiterToSkip = nullptr);
 
+  void setAdaptiveSpinning(bool enabled);
+  // When enabled, a contended lock() spins briefly before sleeping in the kernel, adjusting how
+  // long it spins based on how long the lock has recently been held. Only implemented on Linux;
+  // elsewhere this is a no-op. Must be called before other threads use the mutex.
+
   void assertLockedByCaller(Exclusivity exclusivity) const;
   // In debug mode, assert that the mutex is locked by the calling thread, or if that is
   // non-trivial, assert that the mutex is locked (which should be good enough to catch problems
@@ -113,6 +118,12 @@ private:
   bool printContendedReader = false;
 #endif
 
+  uint spinEstimate = NO_SPINNING;
+  // NO_SPINNING unless adaptive spinning is enabled, in which case this is a running average of
+  // how many pause instructions recent contended lock() calls spent waiting before the lock came
+  // free. Racy updates are harmless; it's only a heuristic.
+
+  static constexpr uint NO_SPINNING = ~0u;
   static constexpr uint EXCLUSIVE_HELD = 1u << 31;
   static constexpr uint EXCLUSIVE_REQUESTED = 1u << 30;
   static constexpr uint SHARED_COUNT_MASK = EXCLUSIVE_REQUESTED - 1;
@@ -211,6 +222,39 @@ private:
 #endif
 };
 
+class ScalableMutex {
+  // Internal implementation details.  See `ScalableMutexGuarded<T>`.
+
+public:
+  ScalableMutex() = default;
+  ZC_DISALLOW_COPY_AND_MOVE(ScalableMutex);
+
+  void lockExclusive(LockSourceLocationArg location);
+  void unlockExclusive();
+
+  uint lockShared(LockSourceLocationArg location);
+  void unlockShared(uint stripe);
+  // lockShared() returns the reader stripe it registered on, to be passed back to unlockShared().
+
+  static constexpr uint STRIPE_COUNT = 64;
+
+private:
+  struct alignas(64) Stripe {
+    uint readers = 0;
+  };
+
+  Stripe stripes[STRIPE_COUNT];
+  // Each thread is assigned one stripe and counts its read locks there, so that readers on
+  // different threads don't fight over a cache line.
+
+  bool writerActive = false;
+  // Set by a writer, under `mutex`, before it waits for all stripes to drain. Readers that see it
+  // set back out and queue up on `mutex` instead.
+
+  Mutex mutex;
+  // Serializes writers and parks readers while a writer is active.
+};
+
 }  // namespace _
 
 // =======================================================================================
@@ -343,6 +387,13 @@ public:
   // Attempts to lock the value for shared access. If the timeout elapses before the lock is
   // acquired, this returns null.
 
+  inline void setAdaptiveSpinning(bool enabled = true) { mutex.setAdaptiveSpinning(enabled); }
+  // Makes contended lock attempts spin for a short, self-tuning while before going to sleep,
+  // similar to glibc's PTHREAD_MUTEX_ADAPTIVE_NP. This pays off when critical sections are only a
+  // handful of instructions long and a sleep/wake round trip through the kernel would cost far
+  // more than the wait itself. Call it before sharing the MutexGuarded with other threads (hence
+  // non-const). Currently only has an effect on Linux.
+
   inline const T& getWithoutLock() const { return value; }
   inline T& getWithoutLock() { return value; }
   // Escape hatch for cases where some external factor guarantees that it's safe to get the
@@ -483,6 +534,115 @@ private:
   // struct will be 1 byte larger than it would otherwise be.
 };
 
+template <typename T>
+class ScalableLocked {
+  // Return type for `ScalableMutexGuarded<T>::lockExclusive()` and `lockShared()`. Works like
+  // `Locked<T>`, except that there is no `wait()`.
+
+public:
+  ZC_DISALLOW_COPY(ScalableLocked);
+  inline ScalableLocked() : mutex(nullptr), ptr(nullptr), stripe(0) {}
+  inline ScalableLocked(ScalableLocked&& other)
+      : mutex(other.mutex), ptr(other.ptr), stripe(other.stripe) {
+    other.mutex = nullptr;
+    other.ptr = nullptr;
+  }
+  inline ~ScalableLocked() { unlock(); }
+
+  inline ScalableLocked& operator=(ScalableLocked&& other) {
+    unlock();
+    mutex = other.mutex;
+    ptr = other.ptr;
+    stripe = other.stripe;
+    other.mutex = nullptr;
+    other.ptr = nullptr;
+    return *this;
+  }
+
+  inline void release() {
+    unlock();
+    mutex = nullptr;
+    ptr = nullptr;
+  }
+
+  inline T* operator->() { return ptr; }
+  inline const T* operator->() const { return ptr; }
+  inline T& operator*() { return *ptr; }
+  inline const T& operator*() const { return *ptr; }
+  inline T* get() { return ptr; }
+  inline const T* get() const { return ptr; }
+  inline operator T*() { return ptr; }
+  inline operator const T*() const { return ptr; }
+
+private:
+  _::ScalableMutex* mutex;
+  T* ptr;
+  uint stripe;
+
+  inline ScalableLocked(_::ScalableMutex& mutex, T& value, uint stripe = 0)
+      : mutex(&mutex), ptr(&value), stripe(stripe) {}
+
+  inline void unlock() {
+    if (mutex != nullptr) {
+      if constexpr (isConst<T>()) {
+        mutex->unlockShared(stripe);
+      } else {
+        mutex->unlockExclusive();
+      }
+    }
+  }
+
+  template <typename U>
+  friend class ScalableMutexGuarded;
+};
+
+template <typename T>
+class ScalableMutexGuarded {
+  // A variant of `MutexGuarded<T>` for data that is read far more often than it is written, by
+  // many threads at once.
+  //
+  // `MutexGuarded<T>::lockShared()` has to modify the single word the mutex lives in, so even a
+  // purely read-only workload bounces that cache line between every core taking the lock. Here,
+  // a reader only touches a counter on a cache line of its own (one of 64 stripes, handed out to
+  // threads round-robin) plus a flag that nobody writes unless a writer shows up. Shared locking
+  // therefore scales with the number of cores.
+  //
+  // The price is paid by writers: lockExclusive() has to check every stripe and wait for readers
+  // already inside to leave, which makes it considerably slower than MutexGuarded's, and the
+  // object is about 4KiB large. Use this for long-lived, rarely-updated state that is hit by every
+  // worker thread -- a configuration snapshot, a mostly-read registry -- not for general data.
+  //
+  // As with MutexGuarded, locks are not recursive, shared ones included: a thread re-taking a
+  // shared lock while a writer waits deadlocks. Timeouts and `when()` are not supported.
+
+public:
+  template <typename... Params>
+  explicit ScalableMutexGuarded(Params&&... params);
+  // Initialize the mutex-bounded object by passing the given parameters to its constructor.
+
+  ScalableLocked<T> lockExclusive(LockSourceLocationArg location = {}) const;
+  // Exclusively locks the object and returns it.
+
+  ScalableLocked<const T> lockShared(LockSourceLocationArg location = {}) const;
+  // Lock the value for shared access. Unless a writer is active, this touches no memory shared
+  // with readers on other threads.
+
+  inline const T& getWithoutLock() const { return value; }
+  inline T& getWithoutLock() { return value; }
+  // Escape hatch for cases where some external factor guarantees that it's safe to get the
+  // value.  You should treat these like const_cast -- be highly suspicious of any use.
+
+private:
+  mutable _::ScalableMutex mutex;
+  mutable T value;
+};
+
+template <typename T>
+class ScalableMutexGuarded<const T> {
+  // ScalableMutexGuarded cannot guard a const type, for the same reasons as MutexGuarded.
+  static_assert(sizeof(T) < 0, "ScalableMutexGuarded's type cannot be const.");
+};
+
 template <typename T>
 class Lazy {
   // A lazily-initialized value.
@@ -570,6 +730,25 @@ inline T& MutexGuarded<T>::getAlreadyLockedExclusive() const {
   return const_cast<T&>(value);
 }
 
+template <typename T>
+template <typename... Params>
+inline ScalableMutexGuarded<T>::ScalableMutexGuarded(Params&&... params)
+    : value(zc::fwd<Params>(params)...) {}
+
+template <typename T>
+inline ScalableLocked<T> ScalableMutexGuarded<T>::lockExclusive(
+    LockSourceLocationArg location) const {
+  mutex.lockExclusive(location);
+  return ScalableLocked<T>(mutex, value);
+}
+
+template <typename T>
+inline ScalableLocked<const T> ScalableMutexGuarded<T>::lockShared(
+    LockSourceLocationArg location) const {
+  uint stripe = mutex.lockShared(location);
+  return ScalableLocked<const T>(mutex, value, stripe);
+}
+
 template <typename T>
 template <typename Func>
 class Lazy<T>::InitImpl : public _::Once::Initializer {
@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/object-pool.h"
+
+#include <atomic>
+#include <new>
+
+#include "zc/core/debug.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
+
+namespace zc {
+namespace _ {  // private
+
+namespace {
+
+struct FreeSlot {
+  FreeSlot* next;
+};
+
+std::atomic<uint64_t> nextSlotPoolId{1};
+std::atomic<uint64_t> nextPoolThreadKey{1};
+
+struct CachedThreadCache {
+  uint64_t owner = 0;
+  SlotPool::ThreadCache* cache = nullptr;
+};
+
+constexpr size_t CACHED_POOLS = 8;
+
+thread_local uint64_t poolThreadKey = 0;
+thread_local CachedThreadCache cachedThreadCaches[CACHED_POOLS];
+// The free lists of the pools the thread used most recently, indexed by pool ID, so that a thread
+// alternating between a few pools usually finds its free list without a lock.
+
+}  // namespace
+
+struct SlotPool::ThreadCache {
+  // A free list belonging to one thread. Only that thread touches it.
+
+  FreeSlot* head = nullptr;
+  size_t count = 0;
+};
+
+struct SlotPool::Impl {
+  size_t slotSize;
+  size_t slotAlignment;
+  size_t slabSlots;
+
+  struct Shared {
+    FreeSlot* head = nullptr;
+    Vector<void*> slabs;
+    HashMap<uint64_t, Own<ThreadCache>> caches;
+    // Keyed by `poolThreadKey`.
+  };
+  MutexGuarded<Shared> shared;
+
+  Impl(size_t slotSize, size_t slotAlignment, size_t slabSlots)
+      : slotSize(slotSize), slotAlignment(slotAlignment), slabSlots(slabSlots) {}
+
+  void refill(ThreadCache& cache) {
+    auto lock = shared.lockExclusive();
+
+    while (cache.count < slabSlots && lock->head != nullptr) {
+      FreeSlot* slot = lock->head;
+      lock->head = slot->next;
+      slot->next = cache.head;
+      cache.head = slot;
+      ++cache.count;
+    }
+    if (cache.count > 0) return;
+
+    byte* slab = reinterpret_cast<byte*>(
+        operator new(slotSize * slabSlots, std::align_val_t(slotAlignment)));
+    lock->slabs.add(slab);
+    for (size_t i = slabSlots; i-- > 0;) {
+      FreeSlot* slot = reinterpret_cast<FreeSlot*>(slab + i * slotSize);
+      slot->next = cache.head;
+      cache.head = slot;
+    }
+    cache.count = slabSlots;
+  }
+
+  void spill(ThreadCache& cache) {
+    // Give a batch back, keeping the rest for this thread to reuse.
+    FreeSlot* first = cache.head;
+    FreeSlot* last = first;
+    for (size_t i = 1; i < slabSlots; i++) last = last->next;
+    cache.head = last->next;
+    cache.count -= slabSlots;
+
+    auto lock = shared.lockExclusive();
+    last->next = lock->head;
+    lock->head = first;
+  }
+};
+
+SlotPool::SlotPool(size_t slotSize, size_t slotAlignment, size_t slabSlots)
+    : impl(heap<Impl>((slotSize + slotAlignment - 1) / slotAlignment * slotAlignment,
+                      slotAlignment, slabSlots)),
+      id(nextSlotPoolId.fetch_add(1, std::memory_order_relaxed)) {
+  ZC_REQUIRE(slabSlots > 0, "an ObjectPool's slabs must hold at least one object");
+}
+
+SlotPool::~SlotPool() noexcept(false) {
+  auto lock = impl->shared.lockExclusive();
+  for (void* slab : lock->slabs) { operator delete(slab, std::align_val_t(impl->slotAlignment)); }
+}
+
+SlotPool::ThreadCache& SlotPool::getThreadCache() {
+  auto& cached = cachedThreadCaches[id % CACHED_POOLS];
+  if (ZC_LIKELY(cached.owner == id)) return *cached.cache;
+
+  if (poolThreadKey == 0) {
+    poolThreadKey = nextPoolThreadKey.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  ThreadCache& cache = *impl->shared.lockExclusive()->caches.findOrCreate(poolThreadKey, [&]() {
+    return HashMap<uint64_t, Own<ThreadCache>>::Entry{poolThreadKey, heap<ThreadCache>()};
+  });
+  cached = {id, &cache};
+  return cache;
+}
+
+void* SlotPool::allocate() {
+  ThreadCache& cache = getThreadCache();
+  if (cache.head == nullptr) impl->refill(cache);
+
+  FreeSlot* slot = cache.head;
+  cache.head = slot->next;
+  --cache.count;
+  return slot;
+}
+
+void SlotPool::free(void* slot) {
+  ThreadCache& cache = getThreadCache();
+  FreeSlot* freed = reinterpret_cast<FreeSlot*>(slot);
+  freed->next = cache.head;
+  cache.head = freed;
+  if (++cache.count >= 2 * impl->slabSlots) impl->spill(cache);
+}
+
+size_t SlotPool::getSlabCount() const { return impl->shared.lockShared()->slabs.size(); }
+
+}  // namespace _
+}  // namespace zc
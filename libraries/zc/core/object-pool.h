@@ -0,0 +1,125 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "zc/core/exception.h"
+#include "zc/core/memory.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+namespace _ {  // private
+
+class SlotPool {
+  // The untyped part of ObjectPool: hands out fixed-size slots carved from slabs.
+
+public:
+  SlotPool(size_t slotSize, size_t slotAlignment, size_t slabSlots);
+  ZC_DISALLOW_COPY_AND_MOVE(SlotPool);
+  ~SlotPool() noexcept(false);
+
+  void* allocate();
+  void free(void* slot);
+
+  size_t getSlabCount() const;
+
+  struct ThreadCache;
+
+private:
+  struct Impl;
+  Own<Impl> impl;
+  uint64_t id;
+  // Unique among all pools ever created, so that a thread's cached free list is never mistaken for
+  // one of a new pool at the same address.
+
+  ThreadCache& getThreadCache();
+};
+
+}  // namespace _
+
+template <typename T>
+class ObjectPool {
+  // Allocates objects of a single type from slabs of fixed-size slots, returning them as Own<T>
+  // whose disposer puts the slot back. Each thread allocates from and frees to a free list of its
+  // own, so neither takes a lock in the common case; a thread only goes to the pool's shared free
+  // list (under a lock) to trade a batch of slots when its own list runs dry or grows too long.
+  //
+  // Suits types that are allocated and freed in large numbers with lifetimes that don't nest, so
+  // that an Arena doesn't fit. An object may be freed on any thread, not just the one that
+  // allocated it.
+  //
+  // Slabs are only released when the pool is destroyed, by which time every object allocated from
+  // it must have been disposed. A thread that exits keeps a bounded number of free slots cached
+  // until then.
+
+public:
+  explicit ObjectPool(size_t slabObjects = 64)
+      : slots(zc::max(sizeof(T), sizeof(void*)), zc::max(alignof(T), alignof(void*)),
+              slabObjects),
+        disposer(*this) {}
+  // `slabObjects` is the number of objects each slab holds, which is also the number of slots a
+  // thread trades with the shared free list at a time.
+
+  ZC_DISALLOW_COPY_AND_MOVE(ObjectPool);
+
+  template <typename... Params>
+  Own<T> allocate(Params&&... params) {
+    T* object = reinterpret_cast<T*>(slots.allocate());
+    if constexpr (noexcept(T(zc::fwd<Params>(params)...))) {
+      ctor(*object, zc::fwd<Params>(params)...);
+    } else {
+      ZC_ON_SCOPE_FAILURE(slots.free(object));
+      ctor(*object, zc::fwd<Params>(params)...);
+    }
+    return Own<T>(object, disposer);
+  }
+
+  size_t getSlabCount() const { return slots.getSlabCount(); }
+
+private:
+  _::SlotPool slots;
+
+  class PoolDisposer final : public Disposer {
+  public:
+    explicit PoolDisposer(ObjectPool& pool) : pool(pool) {}
+
+    void disposeImpl(void* pointer) const override {
+      if constexpr (noexcept(zc::instance<T&>().~T())) {
+        static_cast<T*>(pointer)->~T();
+        pool.slots.free(pointer);
+      } else {
+        // Give the slot back even if the destructor throws, as `delete` would.
+        ZC_DEFER(pool.slots.free(pointer));
+        static_cast<T*>(pointer)->~T();
+      }
+    }
+
+  private:
+    ObjectPool& pool;
+  };
+  PoolDisposer disposer;
+};
+
+}  // namespace zc
+
+ZC_END_HEADER
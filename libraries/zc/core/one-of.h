@@ -59,6 +59,11 @@ struct SuccessIfNotZero {
 template <>
 struct SuccessIfNotZero<0> {};
 
+template <typename First, typename... Rest>
+struct FirstOf_ {
+  typedef First Type;
+};
+
 enum class Variants0 {};
 enum class Variants1 { _variant0 };
 enum class Variants2 { _variant0, _variant1 };
@@ -1639,9 +1644,23 @@ class OneOf {
   // Has a member type called "Success" if and only if all of `OtherVariants` are types that
   // appear in `Variants`. Used with SFINAE to enable subset constructors.
 
+  static constexpr bool trivial =
+      ((canMemcpy<Variants>() && ZC_HAS_TRIVIAL_DESTRUCTOR(Variants)) && ...);
+  // If every variant can be copied with memcpy() and needs no destructor, so can the OneOf, and
+  // the special members below are the defaulted ones. Containers then copy it with memcpy().
+
 public:
   inline OneOf() : tag(0) {}
 
+  OneOf(const OneOf& other)
+    requires trivial
+  = default;
+  OneOf(OneOf& other)
+    requires trivial
+  = default;
+  OneOf(OneOf&& other)
+    requires trivial
+  = default;
   OneOf(const OneOf& other) { copyFrom(other); }
   OneOf(OneOf& other) { copyFrom(other); }
   OneOf(OneOf&& other) { moveFrom(other); }
@@ -1667,8 +1686,17 @@ public:
   }
   // Copy/move from a value that matches one of the individual types in the OneOf.
 
+  ~OneOf()
+    requires trivial
+  = default;
   ~OneOf() { destroy(); }
 
+  OneOf& operator=(const OneOf& other)
+    requires trivial
+  = default;
+  OneOf& operator=(OneOf&& other)
+    requires trivial
+  = default;
   OneOf& operator=(const OneOf& other) {
     if (tag != 0) destroy();
     copyFrom(other);
@@ -1733,6 +1761,30 @@ public:
     }
   }
 
+  template <typename Func>
+  decltype(auto) visit(Func&& func) & {
+    return visitImpl<OneOf&>(*this, func);
+  }
+  template <typename Func>
+  decltype(auto) visit(Func&& func) const& {
+    return visitImpl<const OneOf&>(*this, func);
+  }
+  template <typename Func>
+  decltype(auto) visit(Func&& func) && {
+    return visitImpl<OneOf&&>(zc::mv(*this), func);
+  }
+  // Calls `func` with the current value, as whichever variant it holds. `func` must accept every
+  // variant -- typically a generic lambda, or a struct with an operator() for each -- and return
+  // the same type for all of them. The call goes through a single table of function pointers
+  // indexed by the tag, rather than a comparison against each variant in turn.
+  //
+  // Example:
+  //
+  //     zc::OneOf<int, zc::String> value = 123;
+  //     zc::String text = value.visit([](auto& v) { return zc::str(v); });
+  //
+  // The OneOf must not be null.
+
   template <uint i>
   ZC_NORETURN(void allHandled());
   // After a series of if/else blocks handling each variant of the OneOf, have the final else
@@ -1758,6 +1810,28 @@ public:
 private:
   uint tag;
 
+  template <typename Self, typename T>
+  using VariantRef = decltype(zc::instance<Self>().template get<T>());
+  // `T&`, `const T&`, or `T&&`, following how `Self` refers to the OneOf.
+
+  template <typename Self, typename Func, typename T>
+  static decltype(auto) visitVariant(Self self, Func& func) {
+    return func(static_cast<Self>(self).template get<T>());
+  }
+
+  template <typename Self, typename Func>
+  static decltype(auto) visitImpl(Self self, Func& func) {
+    using Result =
+        typename _::FirstOf_<decltype(func(zc::instance<VariantRef<Self, Variants>>()))...>::Type;
+    static_assert(
+        (isSameType<Result, decltype(func(zc::instance<VariantRef<Self, Variants>>()))>() && ...),
+        "OneOf::visit() requires the same return type for every variant");
+
+    ZC_IREQUIRE(self.tag != 0, "Can't visit() an uninitialized OneOf.");
+    static constexpr Result (*table[])(Self, Func&) = {&visitVariant<Self, Func, Variants>...};
+    return table[self.tag - 1](static_cast<Self>(self), func);
+  }
+
   static inline constexpr size_t maxSize(size_t a) { return a; }
   template <typename... Rest>
   static inline constexpr size_t maxSize(size_t a, size_t b, Rest... rest) {
@@ -51,6 +51,13 @@ AtomicRefcounted::~AtomicRefcounted() noexcept(false) {
 }
 
 void AtomicRefcounted::disposeImpl(void* pointer) const {
+  if (biased) {
+    auto count = refcount - 1;
+    refcount = count;
+    if (count == 0) { delete this; }
+    return;
+  }
+
 #if _MSC_VER && !defined(__clang__)
   if (ZC_MSVC_INTERLOCKED(Decrement, rel)(&refcount) == 0) {
     std::atomic_thread_fence(std::memory_order_acquire);
@@ -65,6 +72,12 @@ void AtomicRefcounted::disposeImpl(void* pointer) const {
 }
 
 bool AtomicRefcounted::addRefWeakInternal() const {
+  if (biased) {
+    if (refcount == 0) { return false; }
+    refcount = refcount + 1;
+    return true;
+  }
+
 #if _MSC_VER && !defined(__clang__)
   long orig = refcount;
 
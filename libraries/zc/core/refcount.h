@@ -321,6 +321,7 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(AtomicRefcounted);
 
   inline bool isShared() const {
+    if (biased) return refcount > 1;
 #if _MSC_VER && !defined(__clang__)
     return ZC_MSVC_INTERLOCKED(Or, acq)(&refcount, 0) > 1;
 #else
@@ -328,6 +329,14 @@ public:
 #endif
   }
 
+  inline void unbias() const {
+    // Switches an object created with `biasedArc()` over to atomic refcounting. The creating
+    // thread must call this before it hands a reference (or the means to get one) to any other
+    // thread; from then on the object behaves exactly like one created with `arc()`. Does nothing
+    // if the object is not biased.
+    if (biased) biased = false;
+  }
+
 private:
 #if _MSC_VER && !defined(__clang__)
   mutable volatile long refcount = 0;
@@ -335,6 +344,10 @@ private:
   mutable volatile uint refcount = 0;
 #endif
 
+  mutable bool biased = false;
+  // If true, the object is still private to the thread that created it, and `refcount` is
+  // maintained with plain arithmetic instead of atomic ops. See `biasedArc()`.
+
   bool addRefWeakInternal() const;
 
   void disposeImpl(void* pointer) const override;
@@ -359,6 +372,8 @@ private:
   friend class Arc;
   template <typename T, typename... Params>
   friend zc::Arc<T> arc(Params&&... params);
+  template <typename T, typename... Params>
+  friend zc::Arc<T> biasedArc(Params&&... params);
 
   template <typename>
   friend class EnableAddRefToThis;
@@ -374,6 +389,21 @@ inline zc::Arc<T> arc(Params&&... params) {
   return AtomicRefcounted::addRcRefInternal(new T(zc::fwd<Params>(params)...));
 }
 
+template <typename T, typename... Params>
+inline zc::Arc<T> biasedArc(Params&&... params) {
+  // Like `arc()`, but the object starts out biased towards the calling thread: as long as it
+  // stays there, adding and dropping references costs a plain increment or decrement rather than
+  // an atomic read-modify-write, which is several times cheaper and doesn't need the cache line
+  // exclusively. Call `unbias()` on the object before letting any other thread touch it; nothing
+  // checks that you did, and refcounting a biased object from two threads corrupts the count.
+  //
+  // Useful for objects that must be AtomicRefcounted because they *may* cross threads, but that
+  // usually live and die on the thread that created them.
+  T* object = new T(zc::fwd<Params>(params)...);
+  object->AtomicRefcounted::biased = true;
+  return AtomicRefcounted::addRcRefInternal(object);
+}
+
 template <typename T>
 zc::Own<T> atomicAddRef(T& object) {
   ZC_IREQUIRE(object.AtomicRefcounted::refcount > 0,
@@ -408,22 +438,30 @@ zc::Maybe<zc::Own<const T>> atomicAddRefWeak(const T& object) {
 template <typename T>
 zc::Own<T> AtomicRefcounted::addRefInternal(T* object) {
   AtomicRefcounted* refcounted = object;
+  if (refcounted->biased) {
+    refcounted->refcount = refcounted->refcount + 1;
+  } else {
 #if _MSC_VER && !defined(__clang__)
-  ZC_MSVC_INTERLOCKED(Increment, nf)(&refcounted->refcount);
+    ZC_MSVC_INTERLOCKED(Increment, nf)(&refcounted->refcount);
 #else
-  __atomic_add_fetch(&refcounted->refcount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&refcounted->refcount, 1, __ATOMIC_RELAXED);
 #endif
+  }
   return zc::Own<T>(object, *refcounted);
 }
 
 template <typename T>
 zc::Own<const T> AtomicRefcounted::addRefInternal(const T* object) {
   const AtomicRefcounted* refcounted = object;
+  if (refcounted->biased) {
+    refcounted->refcount = refcounted->refcount + 1;
+  } else {
 #if _MSC_VER && !defined(__clang__)
-  ZC_MSVC_INTERLOCKED(Increment, nf)(&refcounted->refcount);
+    ZC_MSVC_INTERLOCKED(Increment, nf)(&refcounted->refcount);
 #else
-  __atomic_add_fetch(&refcounted->refcount, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&refcounted->refcount, 1, __ATOMIC_RELAXED);
 #endif
+  }
   return zc::Own<const T>(object, *refcounted);
 }
 
@@ -46,12 +46,32 @@ StringTree::StringTree(Array<StringTree>&& pieces, StringPtr delim)
   }
 }
 
-String StringTree::flatten() const {
+String StringTree::flatten() const& {
   String result = heapString(size());
   flattenTo(result.begin());
   return result;
 }
 
+String StringTree::flatten() && {
+  if (branches.size() == 0) {
+    size_ = 0;
+    return zc::mv(text);
+  }
+  return static_cast<const StringTree&>(*this).flatten();
+}
+
+size_t StringTree::pieceCount() const {
+  size_t count = 0;
+  visit([&count](ArrayPtr<const char>) { ++count; });
+  return count;
+}
+
+Array<ArrayPtr<const byte>> StringTree::asIoVec() const {
+  auto result = heapArrayBuilder<ArrayPtr<const byte>>(pieceCount());
+  visit([&result](ArrayPtr<const char> text) { result.add(text.asBytes()); });
+  return result.finish();
+}
+
 char* StringTree::flattenTo(char* __restrict__ target) const {
   visit([&target](ArrayPtr<const char> text) {
     memcpy(target, text.begin(), text.size());
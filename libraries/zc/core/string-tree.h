@@ -54,11 +54,19 @@ public:
   template <typename Func>
   void visit(Func&& func) const;
 
-  String flatten() const;
-  // Return the contents as a string.
-
-  // TODO(someday):  flatten() when *this is an rvalue and when branches.size() == 0 could simply
-  //   return `zc::mv(text)`.  Requires reference qualifiers (Clang 3.3 / GCC 4.8).
+  String flatten() const&;
+  String flatten() &&;
+  // Return the contents as a string.  Flattening an rvalue tree which has no branches just moves
+  // out its text.
+
+  size_t pieceCount() const;
+  // Number of pieces visit() passes to its callback.  None of them are empty.
+
+  Array<ArrayPtr<const byte>> asIoVec() const;
+  // The pieces visit() would visit, in order, as byte arrays pointing into the tree.  Pass them to
+  // `OutputStream::write(ArrayPtr<const ArrayPtr<const byte>>)` or the same method of
+  // AsyncOutputStream to write the tree with one gathering write instead of flattening it first.
+  // The tree must stay alive and unmodified until the write is done.
 
   char* flattenTo(char* __restrict__ target) const;
   char* flattenTo(char* __restrict__ target, char* limit) const;
@@ -28,11 +28,19 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <charconv>
+
 #include "zc/core/debug.h"
 #if !defined(_WIN32)
 #include <string.h>
 #endif
 
+#if __cpp_lib_to_chars >= 201611L
+// The standard library can format floating point shortest-round-trip (libstdc++ and MSVC use
+// Ryu), so DoubleToBuffer() and FloatToBuffer() below are built on it where it's available.
+#define ZC_FLOAT_TO_CHARS 1
+#endif
+
 namespace zc {
 
 namespace {
@@ -338,6 +346,14 @@ StringPtr Stringifier::operator*(decltype(nullptr)) const { return "nullptr"; }
 
 StringPtr Stringifier::operator*(bool b) const { return b ? "true"_zc : "false"_zc; }
 
+static const char DIGIT_PAIRS[] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+// The two-digit decimal representations of 0 through 99, back to back.
+
 template <typename T, typename Unsigned>
 static CappedArray<char, sizeof(T) * 3 + 2> stringifyImpl(T i) {
   // We don't use sprintf() because it's not async-signal-safe (for strPreallocated()).
@@ -348,21 +364,28 @@ static CappedArray<char, sizeof(T) * 3 + 2> stringifyImpl(T i) {
   // unsigned first, then negate it, to avoid ubsan complaining.
   Unsigned u = i;
   if (negative) u = -u;
-  uint8_t reverse[sizeof(T) * 3 + 1]{};
-  uint8_t* p = reverse;
-  if (u == 0) {
-    *p++ = 0;
+
+  // Digits are produced two at a time, from the right, which halves the number of divisions.
+  char digits[sizeof(T) * 3 + 1];
+  char* end = digits + sizeof(digits);
+  char* p = end;
+  while (u >= 100) {
+    uint pair = u % 100;
+    u /= 100;
+    p -= 2;
+    memcpy(p, DIGIT_PAIRS + pair * 2, 2);
+  }
+  if (u >= 10) {
+    p -= 2;
+    memcpy(p, DIGIT_PAIRS + u * 2, 2);
   } else {
-    while (u > 0) {
-      *p++ = u % 10;
-      u /= 10;
-    }
+    *--p = '0' + u;
   }
 
   char* p2 = result.begin();
   if (negative) *p2++ = '-';
-  while (p > reverse) { *p2++ = '0' + *--p; }
-  result.setSize(p2 - result.begin());
+  memcpy(p2, p, end - p);
+  result.setSize(p2 - result.begin() + (end - p));
   return result;
 }
 
@@ -470,6 +493,95 @@ inline bool IsNaN(double value) {
 static const int kDoubleToBufferSize = 32;
 static const int kFloatToBufferSize = 24;
 
+#if ZC_FLOAT_TO_CHARS
+
+template <typename T>
+char* ShortestToBuffer(T value, int precision, char* buffer) {
+  // Formats `value` with the fewest significant digits that parse back to exactly `value`, laid
+  // out the way the snprintf() version below prints it: like "%.*g" with `precision` (or
+  // `precision + 2` when more digits than `precision` are needed), without '+' in the exponent.
+  // So the text only differs from that version where it used more digits than necessary.
+
+  if (value == inf()) {
+    strcpy(buffer, "inf");
+    return buffer;
+  } else if (value == -inf()) {
+    strcpy(buffer, "-inf");
+    return buffer;
+  } else if (IsNaN(value)) {
+    strcpy(buffer, "nan");
+    return buffer;
+  }
+
+  // Scientific form is "[-]d[.ddd]e(+|-)dd[d]"; split it into digits and a decimal exponent.
+  char scientific[32];
+  auto conversion = std::to_chars(scientific, scientific + sizeof(scientific), value,
+                                  std::chars_format::scientific);
+  ZC_DASSERT(conversion.ec == std::errc());
+
+  const char* p = scientific;
+  bool negative = *p == '-';
+  if (negative) ++p;
+  char digits[20];
+  int count = 0;
+  for (; *p != 'e'; ++p) {
+    if (*p != '.') digits[count++] = *p;
+  }
+  ++p;
+  bool negativeExponent = *p++ == '-';
+  int exponent = 0;
+  for (; p < conversion.ptr; ++p) { exponent = exponent * 10 + (*p - '0'); }
+  if (negativeExponent) exponent = -exponent;
+
+  if (count > precision) precision += 2;
+
+  char* out = buffer;
+  if (negative) *out++ = '-';
+  if (exponent < -4 || exponent >= precision) {
+    *out++ = digits[0];
+    if (count > 1) {
+      *out++ = '.';
+      memcpy(out, digits + 1, count - 1);
+      out += count - 1;
+    }
+    *out++ = 'e';
+    if (exponent < 0) {
+      *out++ = '-';
+      exponent = -exponent;
+    }
+    // Like printf(), use at least two exponent digits.
+    if (exponent >= 100) *out++ = '0' + exponent / 100;
+    *out++ = '0' + exponent / 10 % 10;
+    *out++ = '0' + exponent % 10;
+  } else if (exponent < 0) {
+    *out++ = '0';
+    *out++ = '.';
+    for (int i = -1; i > exponent; i--) { *out++ = '0'; }
+    memcpy(out, digits, count);
+    out += count;
+  } else if (count <= exponent + 1) {
+    memcpy(out, digits, count);
+    out += count;
+    for (int i = count; i <= exponent; i++) { *out++ = '0'; }
+  } else {
+    memcpy(out, digits, exponent + 1);
+    out += exponent + 1;
+    *out++ = '.';
+    memcpy(out, digits + exponent + 1, count - exponent - 1);
+    out += count - exponent - 1;
+  }
+  *out = '\0';
+  return buffer;
+}
+
+char* DoubleToBuffer(double value, char* buffer) {
+  return ShortestToBuffer(value, DBL_DIG, buffer);
+}
+
+char* FloatToBuffer(float value, char* buffer) { return ShortestToBuffer(value, FLT_DIG, buffer); }
+
+#else  // ZC_FLOAT_TO_CHARS
+
 static inline bool IsValidFloatChar(char c) {
   return ('0' <= c && c <= '9') || c == 'e' || c == 'E' || c == '+' || c == '-';
 }
@@ -635,6 +747,8 @@ char* FloatToBuffer(float value, char* buffer) {
   return buffer;
 }
 
+#endif  // ZC_FLOAT_TO_CHARS, else
+
 // ----------------------------------------------------------------------
 // NoLocaleStrtod()
 //   This code will make you cry.
@@ -35,6 +35,8 @@ class StringPtr;
 class LiteralStringConst;
 class String;
 class ConstString;
+template <size_t smallSize>
+class SmallString;
 
 class StringTree;  // string-tree.h
 }  // namespace zc
@@ -550,6 +552,99 @@ String heapString(const String& value);
 String heapString(ArrayPtr<const char> value);
 // Allocates a copy of the given value on the heap.
 
+// =======================================================================================
+// SmallString -- An immutable string which stores short values inline.
+
+template <size_t smallSize = 15>
+class SmallString {
+  // Holds up to `smallSize` chars (plus the NUL terminator) inside the object itself, and only
+  // allocates on the heap for longer values. Meant for strings that are usually short, such as
+  // identifiers and header values, where allocating would dominate their cost. With the default
+  // size the object is 32 bytes.
+  //
+  // Like String it converts to StringPtr and ArrayPtr<const char>, and it compares, hashes and
+  // stringifies the same way, so it can be the key of a HashMap looked up by StringPtr. The
+  // content cannot be modified; to change it, assign a new SmallString.
+
+public:
+  inline SmallString() : SmallString(StringPtr()) {}
+  inline explicit SmallString(StringPtr value);
+  // Copies `value`.
+  inline SmallString(SmallString&& other);
+  inline SmallString& operator=(SmallString&& other);
+  inline ~SmallString() noexcept(false) { dispose(); }
+  ZC_DISALLOW_COPY(SmallString);
+
+  inline operator ArrayPtr<const char>() const ZC_LIFETIMEBOUND { return arrayPtr(ptr, len); }
+  inline ArrayPtr<const char> asArray() const ZC_LIFETIMEBOUND { return arrayPtr(ptr, len); }
+  inline ArrayPtr<const byte> asBytes() const ZC_LIFETIMEBOUND { return asArray().asBytes(); }
+  // Result does not include NUL terminator.
+
+  inline operator StringPtr() const ZC_LIFETIMEBOUND { return StringPtr(ptr, len); }
+  inline StringPtr asPtr() const ZC_LIFETIMEBOUND { return StringPtr(ptr, len); }
+
+  inline const char* cStr() const ZC_LIFETIMEBOUND { return ptr; }
+
+  inline size_t size() const { return len; }
+  // Result does not include NUL terminator.
+
+  inline bool isInline() const { return ptr == space; }
+  // True if the value did not need a heap allocation.
+
+  inline char operator[](size_t index) const { return asPtr()[index]; }
+
+  inline const char* begin() const ZC_LIFETIMEBOUND { return ptr; }
+  inline const char* end() const ZC_LIFETIMEBOUND { return ptr + len; }
+
+  inline bool operator==(decltype(nullptr)) const { return len == 0; }
+
+  inline bool operator==(const StringPtr& other) const { return asPtr() == other; }
+  inline bool operator<(const StringPtr& other) const { return asPtr() < other; }
+  inline bool operator>(const StringPtr& other) const { return asPtr() > other; }
+  inline bool operator<=(const StringPtr& other) const { return asPtr() <= other; }
+  inline bool operator>=(const StringPtr& other) const { return asPtr() >= other; }
+
+  inline bool operator==(const SmallString& other) const { return asPtr() == other.asPtr(); }
+  inline bool operator<(const SmallString& other) const { return asPtr() < other.asPtr(); }
+  inline bool operator>(const SmallString& other) const { return asPtr() > other.asPtr(); }
+  inline bool operator<=(const SmallString& other) const { return asPtr() <= other.asPtr(); }
+  inline bool operator>=(const SmallString& other) const { return asPtr() >= other.asPtr(); }
+  // Overloaded for `const SmallString&` specifically for the same reason as ConstString.
+
+  inline bool startsWith(const StringPtr& other) const { return asPtr().startsWith(other); }
+  inline bool endsWith(const StringPtr& other) const { return asPtr().endsWith(other); }
+  inline Maybe<size_t> find(const StringPtr& other) const { return asPtr().find(other); }
+  inline bool contains(const StringPtr& other) const { return asPtr().contains(other); }
+  inline Maybe<size_t> findFirst(char c) const { return asPtr().findFirst(c); }
+  inline Maybe<size_t> findLast(char c) const { return asPtr().findLast(c); }
+
+  inline StringPtr slice(size_t start) const ZC_LIFETIMEBOUND { return asPtr().slice(start); }
+  inline ArrayPtr<const char> slice(size_t start, size_t end) const ZC_LIFETIMEBOUND {
+    return asPtr().slice(start, end);
+  }
+
+private:
+  char* ptr;
+  size_t len;
+  char space[smallSize + 1];
+
+  inline void dispose() {
+    if (ptr != space) { _::HeapArrayDisposer::instance.dispose(ptr, len + 1, len + 1); }
+  }
+  inline void takeFrom(SmallString& other) {
+    len = other.len;
+    if (other.isInline()) {
+      ptr = space;
+      memcpy(space, other.space, len + 1);
+    } else {
+      ptr = other.ptr;
+      other.ptr = other.space;
+      other.len = 0;
+      other.space[0] = '\0';
+    }
+  }
+};
+
 // =======================================================================================
 // Magic str() function which transforms parameters to text and concatenates them into one big
 // String.
@@ -577,7 +672,15 @@ template <typename First, typename... Rest>
 char* fill(char* __restrict__ target, const First& first, Rest&&... rest) {
   auto i = first.begin();
   auto end = first.end();
-  while (i != end) { *target++ = *i++; }
+  if constexpr (isSameType<Decay<decltype(i)>, const char*>() ||
+                isSameType<Decay<decltype(i)>, char*>()) {
+    // Contiguous text, which is what almost every stringifier returns: copy it in one go.
+    size_t n = end - i;
+    if (n > 0) memcpy(target, i, n);
+    target += n;
+  } else {
+    while (i != end) { *target++ = *i++; }
+  }
   return fill(target, zc::fwd<Rest>(rest)...);
 }
 
@@ -593,6 +696,20 @@ String concat(Params&&... params) {
 
 inline String concat(String&& arr) { return zc::mv(arr); }
 
+template <typename... Params>
+ArrayPtr<char> concatInto(ArrayPtr<char> buffer, Params&&... params) {
+  // Like concat() but into `buffer`, which must be big enough.
+
+  size_t size = sum({params.size()...});
+  if (ZC_UNLIKELY(size > buffer.size())) {
+    // Unlike ZC_IREQUIRE(), checked in every build, since going on would overrun the buffer.
+    inlineRequireFailure(__FILE__, __LINE__, "size <= buffer.size()",
+                         "\"strInto() buffer too small\"", "strInto() buffer too small");
+  }
+  fill(buffer.begin(), zc::fwd<Params>(params)...);
+  return buffer.first(size);
+}
+
 template <typename First, typename... Rest>
 char* fillLimited(char* __restrict__ target, char* limit, const First& first, Rest&&... rest) {
   auto i = first.begin();
@@ -645,6 +762,10 @@ struct Stringifier {
   inline ArrayPtr<const char> operator*(const FixedArray<char, n>& s) const ZC_LIFETIMEBOUND {
     return s;
   }
+  template <size_t n>
+  inline ArrayPtr<const char> operator*(const SmallString<n>& s) const ZC_LIFETIMEBOUND {
+    return s;
+  }
   inline ArrayPtr<const char> operator*(const char* s) const ZC_LIFETIMEBOUND {
     return arrayPtr(s, strlen(s));
   }
@@ -780,6 +901,20 @@ StringPtr strPreallocated(ArrayPtr<char> buffer, Params&&... params) {
   return StringPtr(buffer.begin(), end);
 }
 
+template <typename... Params>
+ArrayPtr<char> strInto(ArrayPtr<char> buffer, Params&&... params) {
+  // Like str() but formats into `buffer` rather than a new heap allocation, returning the part of
+  // `buffer` that was written. Unlike strPreallocated(), the text is not NUL-terminated and must
+  // fit: the total size is computed before anything is written, and a buffer that is too small is
+  // a precondition failure rather than silent truncation. This lets a hot path such as a log or
+  // metrics formatter reuse one buffer:
+  //
+  //     char buffer[256];
+  //     out.write(strInto(buffer, name, '=', value, '\n').asBytes());
+
+  return _::concatInto(buffer, toCharSequence(zc::fwd<Params>(params))...);
+}
+
 template <typename T, typename = decltype(toCharSequence(zc::instance<T&>()))>
 inline _::Delimited<ArrayPtr<T>> operator*(const _::Stringifier&, ArrayPtr<T> arr) {
   return _::Delimited<ArrayPtr<T>>(arr, ", ");
@@ -811,6 +946,31 @@ inline constexpr StringPtr::StringPtr(const String& value)
 inline constexpr StringPtr::StringPtr(const ConstString& value)
     : content(value.cStr(), value.size() + 1) {}
 
+template <size_t smallSize>
+inline SmallString<smallSize>::SmallString(StringPtr value) : len(value.size()) {
+  if (len <= smallSize) {
+    ptr = space;
+  } else {
+    ptr = _::HeapArrayDisposer::allocateUninitialized<char>(len + 1);
+  }
+  memcpy(ptr, value.begin(), len);
+  ptr[len] = '\0';
+}
+
+template <size_t smallSize>
+inline SmallString<smallSize>::SmallString(SmallString&& other) {
+  takeFrom(other);
+}
+
+template <size_t smallSize>
+inline SmallString<smallSize>& SmallString<smallSize>::operator=(SmallString&& other) {
+  if (&other != this) {
+    dispose();
+    takeFrom(other);
+  }
+  return *this;
+}
+
 inline constexpr StringPtr::operator ArrayPtr<const char>() const {
   return ArrayPtr<const char>(content.begin(), content.size() - 1);
 }
@@ -107,6 +107,36 @@ zc::Array<HashBucket> rehash(zc::ArrayPtr<const HashBucket> oldBuckets, size_t t
   return newBuckets;
 }
 
+void rehash(Array<byte>& ctrl, Array<FlatHashSlot>& slots, size_t targetSize) {
+  ZC_REQUIRE(targetSize < (1 << 30), "hash table has reached maximum size");
+
+  // A power of two number of groups, at most 7/8 full.
+  size_t size = FLAT_HASH_GROUP_SIZE;
+  while (size * 7 < targetSize * 8) { size *= 2; }
+  if (size < slots.size()) { size = slots.size(); }
+
+  auto newCtrl = zc::heapArray<byte>(size);
+  memset(newCtrl.begin(), FLAT_HASH_EMPTY, size);
+  auto newSlots = zc::heapArray<FlatHashSlot>(size);
+
+  for (size_t i = 0; i < slots.size(); i++) {
+    if (ctrl[i] & 0x80) continue;  // empty or erased
+    uint mixed = flatHashMix(slots[i].hash);
+    for (FlatHashProbe probe(mixed, size);; probe.next()) {
+      uint free = FlatHashGroup(newCtrl.begin() + probe.offset()).matchEmpty();
+      if (free != 0) {
+        size_t j = probe.offset() + flatHashLowestBit(free);
+        newCtrl[j] = flatHashTag(mixed);
+        newSlots[j] = slots[i];
+        break;
+      }
+    }
+  }
+
+  ctrl = zc::mv(newCtrl);
+  slots = zc::mv(newSlots);
+}
+
 // =======================================================================================
 // BTree
 
@@ -294,6 +324,69 @@ BTreeImpl::Iterator BTreeImpl::search(const SearchKey& searchKey) const {
   return {tree, &leaf, searchKey.search(leaf)};
 }
 
+void BTreeImpl::bulkLoad(uint count) {
+  ZC_REQUIRE(count < (1u << 31), "b-tree has reached maximum size");
+
+  clear();
+  if (count == 0) { return; }
+
+  // Spread the rows evenly over as few leaves as can hold them, and each level's nodes over as
+  // few parents, so that every node but the root is at least half-full, as erase() expects: e.g.
+  // any two leaves hold more than 14 rows between them, so at least 7 each.
+  uint levelSizes[32];
+  uint levels = 0;
+  uint total = 0;
+  for (uint n = (count + Leaf::NROWS - 1) / Leaf::NROWS;;
+       n = (n + Parent::NCHILDREN - 1) / Parent::NCHILDREN) {
+    levelSizes[levels++] = n;
+    total += n;
+    if (n == 1) { break; }
+  }
+  if (tree == &EMPTY_NODE || treeCapacity < total) { growTree(total); }
+
+  // The root is node 0. Below it, each level is laid out contiguously starting at node 1, leaves
+  // first, so that iterating in order walks memory in order.
+  auto lastRows = heapArray<uint>(levelSizes[0]);
+  uint childBase = levels == 1 ? 0 : 1;
+
+  uint leafCount = levelSizes[0];
+  uint row = 0;
+  for (uint j = 0; j < leafCount; j++) {
+    Leaf& leaf = tree[childBase + j].leaf;
+    uint n = count / leafCount + (j < count % leafCount);
+    for (uint i = 0; i < n; i++) { leaf.rows[i] = row++; }
+    if (j > 0) { leaf.prev = childBase + j - 1; }
+    if (j + 1 < leafCount) { leaf.next = childBase + j + 1; }
+    lastRows[j] = row - 1;
+  }
+  beginLeaf = childBase;
+  endLeaf = childBase + leafCount - 1;
+
+  for (uint level = 1; level < levels; level++) {
+    uint childCount = levelSizes[level - 1];
+    uint parentCount = levelSizes[level];
+    uint parentBase = level + 1 == levels ? 0 : childBase + childCount;
+    uint child = 0;
+    for (uint p = 0; p < parentCount; p++) {
+      Parent& parent = tree[parentBase + p].parent;
+      uint n = childCount / parentCount + (p < childCount % parentCount);
+      for (uint i = 0; i < n; i++, child++) {
+        parent.children[i] = childBase + child;
+        if (i + 1 < n) { parent.keys[i] = lastRows[child]; }
+      }
+      // Overwriting in place is fine: later parents only read children after this one's.
+      lastRows[p] = lastRows[child - 1];
+    }
+    childBase = parentBase;
+  }
+
+  // Nodes 0 through total - 1 are in use. The rest are still zero'd, which chains them into the
+  // freelist in order.
+  height = levels - 1;
+  freelistHead = total;
+  freelistSize -= total - 1;
+}
+
 template <typename T>
 struct BTreeImpl::AllocResult {
   uint index;
@@ -31,6 +31,14 @@
 #include <intrin0.h>
 #endif
 
+#if __SSE2__ || _M_X64 || (_M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZC_FLAT_HASH_SSE2 1
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_FLAT_HASH_NEON 1
+#endif
+
 #if ZC_DEBUG_TABLE_IMPL
 #include "zc/core/debug.h"
 #define ZC_TABLE_IREQUIRE ZC_REQUIRE
@@ -119,6 +127,12 @@ class Table {
   //     //
   //     // This should never throw; if it does the table may be corrupted.
   //
+  //     template <typename... SearchParams>
+  //     bool bulkInsert(zc::ArrayPtr<const Row> table, size_t firstPos);
+  //     // Optional. Called by Table::bulkInsert() once all of `table[firstPos]` onwards hold the
+  //     // new rows, before they are indexed. The index may index them all at once and return true,
+  //     // or return false without modifying anything to have them insert()ed one at a time.
+  //
   //     class Iterator;  // Behaves like a C++ iterator over size_t values.
   //     class Iterable;  // Has begin() and end() methods returning iterators.
   //
@@ -169,6 +183,19 @@ public:
   // If an insertion throws (e.g. because it violates a uniqueness constraint of some index),
   // subsequent insertions do not occur, but previous insertions remain inserted.
 
+  template <typename Collection>
+  void bulkInsert(Collection&& collection);
+  template <typename Collection>
+  void bulkInsert(Collection& collection);
+  // Like insertAll(), but faster for loading many rows at once: all of the rows are added first,
+  // and then each index which supports it indexes them in a single pass. In particular a
+  // `TreeIndex` of a table which was empty is built bottom-up, with its nodes packed, if the rows
+  // come in its order. Other indexes, and a TreeIndex given rows out of order, fall back to
+  // inserting the rows one at a time.
+  //
+  // Unlike insertAll(), this is all-or-nothing: if any row violates a uniqueness constraint, none
+  // of the rows are inserted.
+
   template <typename UpdateFunc>
   Row& upsert(Row&& row, UpdateFunc&& update);
   template <typename UpdateFunc>
@@ -294,6 +321,8 @@ private:
   Vector<Row> rows;
   Tuple<Indexes...> indexes;
 
+  void bulkIndex(size_t firstPos);
+
   template <size_t index = 0, bool final = (index >= sizeof...(Indexes))>
   class Impl;
   template <typename Func, typename... Params>
@@ -344,6 +373,14 @@ class HashIndex;
 // If your `Callbacks` type has dynamic state, you may pass its constructor parameters as the
 // constructor parameters to `HashIndex`.
 
+template <typename Callbacks>
+class FlatHashIndex;
+// A Table index based on a hash table with the same `Callbacks` interface as `HashIndex`, laid
+// out like a "Swiss table": slots are grouped sixteen at a time, and each has a control byte
+// holding seven bits of its hash code, so that a lookup compares a whole group's tags with one
+// SSE2 or NEON instruction and checks equality only for the slots whose tags match. Prefer it
+// over `HashIndex` for large tables with long probe chains; it is limited to the same 2^30 rows.
+
 template <typename Callbacks>
 class TreeIndex;
 // A Table index based on a B-tree.
@@ -385,6 +422,17 @@ inline void tryReserveSize(Params&&...) {}
 // If `src` has a `.size()` method, call dst.reserve(dst.size() + src.size()).
 // Otherwise, do nothing.
 
+template <typename Index, typename Row,
+          typename = decltype(instance<Index&>().bulkInsert(instance<ArrayPtr<Row>>(), size_t()))>
+inline bool tryBulkInsert(Index& index, ArrayPtr<Row> table, size_t firstPos) {
+  return index.bulkInsert(table, firstPos);
+}
+template <typename... Params>
+inline bool tryBulkInsert(Params&&...) {
+  return false;
+}
+// If the index has a `.bulkInsert()` method, call it. Otherwise, return false.
+
 template <typename Row>
 class TableMapping {
 public:
@@ -465,6 +513,44 @@ public:
     indexObj.move(table.rows.asPtr(), oldPos, newPos, indexObj.keyForRow(row));
     Impl<index + 1>::move(table, oldPos, newPos, row);
   }
+
+  static void bulkInsert(Table<Row, Indexes...>& table, size_t firstPos) {
+    // Index table.rows[firstPos] onwards, and on failure leave this and the later indexes as they
+    // were.
+    auto& indexObj = get<index>(table.indexes);
+    auto rows = table.rows.asPtr();
+
+    size_t indexed = firstPos;
+    ZC_DEFER(if (indexed != rows.size()) { unindex(table, firstPos, indexed); });
+    if (_::tryBulkInsert(indexObj, rows, firstPos)) {
+      indexed = rows.size();
+    } else {
+      for (; indexed < rows.size(); ++indexed) {
+        if (indexObj.insert(rows, indexed, indexObj.keyForRow(rows[indexed])) != zc::none) {
+          _::throwDuplicateTableRow();
+        }
+      }
+    }
+
+    bool success = false;
+    ZC_DEFER(if (!success) { unindex(table, firstPos, rows.size()); });
+    Impl<index + 1>::bulkInsert(table, firstPos);
+    success = true;
+  }
+
+private:
+  static void unindex(Table<Row, Indexes...>& table, size_t firstPos, size_t endPos) {
+    auto& indexObj = get<index>(table.indexes);
+    if (firstPos == 0) {
+      // The index held nothing else.
+      indexObj.clear();
+    } else {
+      auto rows = table.rows.asPtr();
+      for (size_t pos = endPos; pos-- > firstPos;) {
+        indexObj.erase(rows, pos, indexObj.keyForRow(rows[pos]));
+      }
+    }
+  }
 };
 
 template <typename Row, typename... Indexes>
@@ -478,6 +564,7 @@ public:
   }
   static void erase(Table<Row, Indexes...>& table, size_t pos, Row& row) {}
   static void move(Table<Row, Indexes...>& table, size_t oldPos, size_t newPos, Row& row) {}
+  static void bulkInsert(Table<Row, Indexes...>& table, size_t firstPos) {}
 };
 
 template <typename Row, typename... Indexes>
@@ -551,6 +638,32 @@ void Table<Row, Indexes...>::insertAll(Collection& collection) {
   for (auto& row : collection) { insert(row); }
 }
 
+template <typename Row, typename... Indexes>
+template <typename Collection>
+void Table<Row, Indexes...>::bulkInsert(Collection&& collection) {
+  size_t firstPos = rows.size();
+  _::tryReserveSize(*this, collection);
+  for (auto& row : collection) { rows.add(zc::mv(row)); }
+  bulkIndex(firstPos);
+}
+
+template <typename Row, typename... Indexes>
+template <typename Collection>
+void Table<Row, Indexes...>::bulkInsert(Collection& collection) {
+  size_t firstPos = rows.size();
+  _::tryReserveSize(*this, collection);
+  for (auto& row : collection) { rows.add(row); }
+  bulkIndex(firstPos);
+}
+
+template <typename Row, typename... Indexes>
+void Table<Row, Indexes...>::bulkIndex(size_t firstPos) {
+  bool success = false;
+  ZC_DEFER(if (!success) { rows.truncate(firstPos); });
+  Impl<>::bulkInsert(*this, firstPos);
+  success = true;
+}
+
 template <typename Row, typename... Indexes>
 template <typename UpdateFunc>
 Row& Table<Row, Indexes...>::upsert(Row&& row, UpdateFunc&& update) {
@@ -1012,6 +1125,259 @@ private:
   }
 };
 
+// -----------------------------------------------------------------------------
+// Flat hash table index
+
+namespace _ {  // private
+
+struct FlatHashSlot {
+  uint hash;
+  uint pos;
+};
+
+// A control byte is the tag of an occupied slot, which has the high bit clear, or one of these.
+static constexpr byte FLAT_HASH_EMPTY = 0x80;
+static constexpr byte FLAT_HASH_ERASED = 0xfe;
+static constexpr size_t FLAT_HASH_GROUP_SIZE = 16;
+
+inline uint flatHashMix(uint hash) {
+  // Hash codes of integers may be the integers themselves, so spread them over all bits before
+  // taking the tag and the group from them.
+  return uint((uint64_t(hash) * 0x9e3779b97f4a7c15ull) >> 32);
+}
+inline byte flatHashTag(uint mixed) { return byte(mixed & 0x7f); }
+
+inline uint flatHashLowestBit(uint mask) {
+#if _MSC_VER && !defined(__clang__)
+  unsigned long i;
+  _BitScanForward(&i, mask);
+  return i;
+#else
+  return __builtin_ctz(mask);
+#endif
+}
+
+class FlatHashGroup {
+  // The control bytes of one group of slots. Each match returns a mask with bit `i` set if the
+  // group's byte `i` matches.
+
+public:
+  explicit FlatHashGroup(const byte* ctrl) {
+#if ZC_FLAT_HASH_SSE2
+    bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+#elif ZC_FLAT_HASH_NEON
+    bytes = vld1q_u8(ctrl);
+#else
+    memcpy(bytes, ctrl, sizeof(bytes));
+#endif
+  }
+
+  uint match(byte tag) const {
+#if ZC_FLAT_HASH_SSE2
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, _mm_set1_epi8(static_cast<char>(tag))));
+#elif ZC_FLAT_HASH_NEON
+    return toMask(vceqq_u8(bytes, vdupq_n_u8(tag)));
+#else
+    uint mask = 0;
+    for (uint i = 0; i < FLAT_HASH_GROUP_SIZE; i++) { mask |= uint(bytes[i] == tag) << i; }
+    return mask;
+#endif
+  }
+
+  uint matchEmpty() const { return match(FLAT_HASH_EMPTY); }
+
+  uint matchAvailable() const {
+    // Empty or erased: the bytes with the high bit set.
+#if ZC_FLAT_HASH_SSE2
+    return _mm_movemask_epi8(bytes);
+#elif ZC_FLAT_HASH_NEON
+    return toMask(vtstq_u8(bytes, vdupq_n_u8(0x80)));
+#else
+    uint mask = 0;
+    for (uint i = 0; i < FLAT_HASH_GROUP_SIZE; i++) { mask |= uint(bytes[i] >> 7) << i; }
+    return mask;
+#endif
+  }
+
+private:
+#if ZC_FLAT_HASH_SSE2
+  __m128i bytes;
+#elif ZC_FLAT_HASH_NEON
+  uint8x16_t bytes;
+
+  static uint toMask(uint8x16_t matched) {
+    // NEON has no movemask: keep one distinct bit per byte, then add up each half.
+    static constexpr uint8_t BITS[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                         1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bits = vandq_u8(matched, vld1q_u8(BITS));
+    return vaddv_u8(vget_low_u8(bits)) | (uint(vaddv_u8(vget_high_u8(bits))) << 8);
+  }
+#else
+  byte bytes[FLAT_HASH_GROUP_SIZE];
+#endif
+};
+
+class FlatHashProbe {
+  // The groups a hash code may be found in, in the order they are searched. Triangular steps over
+  // a power-of-two number of groups visit each of them once.
+
+public:
+  FlatHashProbe(uint mixed, size_t slotCount)
+      : mask(slotCount / FLAT_HASH_GROUP_SIZE - 1), group((mixed >> 7) & mask) {}
+
+  inline size_t offset() const { return group * FLAT_HASH_GROUP_SIZE; }
+  inline void next() { group = (group + ++step) & mask; }
+
+private:
+  size_t mask;
+  size_t group;
+  size_t step = 0;
+};
+
+void rehash(Array<byte>& ctrl, Array<FlatHashSlot>& slots, size_t targetSize);
+// Rebuild a FlatHashIndex's arrays with room for at least `targetSize` rows, dropping erased
+// slots.
+
+}  // namespace _
+
+template <typename Callbacks>
+class FlatHashIndex {
+public:
+  FlatHashIndex() = default;
+  template <typename... Params>
+  FlatHashIndex(Params&&... params) : cb(zc::fwd<Params>(params)...) {}
+
+  size_t capacity() {
+    // This method is for testing.
+    return slots.size();
+  }
+
+  void reserve(size_t size) {
+    if (slots.size() * 7 < size * 8) { rehash(size); }
+  }
+
+  void clear() {
+    erasedCount = 0;
+    if (ctrl.size() > 0) memset(ctrl.begin(), _::FLAT_HASH_EMPTY, ctrl.size());
+  }
+
+  template <typename Row>
+  decltype(auto) keyForRow(Row&& row) const {
+    return cb.keyForRow(zc::fwd<Row>(row));
+  }
+
+  template <typename Row, typename... Params>
+  zc::Maybe<size_t> insert(zc::ArrayPtr<Row> table, size_t pos, Params&&... params) {
+    if (slots.size() * 7 < (table.size() + 1 + erasedCount) * 8) {
+      // Load factor is more than 7/8, counting erased slots, which searches have to step over.
+      // Rehash so that it's at most 1/2; as with HashIndex, a table with many erasures may only
+      // be cleaned up rather than grown.
+      rehash((table.size() + 1) * 2);
+    }
+
+    uint hashCode = cb.hashCode(params...);
+    uint mixed = _::flatHashMix(hashCode);
+    byte tag = _::flatHashTag(mixed);
+    size_t available = slots.size();
+    for (_::FlatHashProbe probe(mixed, slots.size());; probe.next()) {
+      _::FlatHashGroup group(ctrl.begin() + probe.offset());
+      for (uint bits = group.match(tag); bits != 0; bits &= bits - 1) {
+        auto& slot = slots[probe.offset() + _::flatHashLowestBit(bits)];
+        if (slot.hash == hashCode && cb.matches(table[slot.pos], params...)) {
+          // duplicate row
+          return size_t(slot.pos);
+        }
+      }
+      if (available == slots.size()) {
+        // We can fill in the first free slot, but have to keep searching for duplicates.
+        uint free = group.matchAvailable();
+        if (free != 0) { available = probe.offset() + _::flatHashLowestBit(free); }
+      }
+      if (group.matchEmpty() != 0) { break; }
+    }
+
+    if (ctrl[available] == _::FLAT_HASH_ERASED) { --erasedCount; }
+    ctrl[available] = tag;
+    slots[available] = {hashCode, uint(pos)};
+    return zc::none;
+  }
+
+  template <typename Row, typename... Params>
+  void erase(zc::ArrayPtr<Row> table, size_t pos, Params&&... params) {
+    uint hashCode = cb.hashCode(params...);
+    uint mixed = _::flatHashMix(hashCode);
+    ZC_IF_SOME(i, findPos(mixed, pos)) {
+      // Searches stop at a group with an empty slot, so none can have gone past this one if it
+      // has one; the slot can then be emptied rather than marked erased.
+      _::FlatHashGroup group(ctrl.begin() + i / _::FLAT_HASH_GROUP_SIZE * _::FLAT_HASH_GROUP_SIZE);
+      if (group.matchEmpty() != 0) {
+        ctrl[i] = _::FLAT_HASH_EMPTY;
+      } else {
+        ctrl[i] = _::FLAT_HASH_ERASED;
+        ++erasedCount;
+      }
+    }
+    else { _::logHashTableInconsistency(); }
+  }
+
+  template <typename Row, typename... Params>
+  void move(zc::ArrayPtr<Row> table, size_t oldPos, size_t newPos, Params&&... params) {
+    uint hashCode = cb.hashCode(params...);
+    ZC_IF_SOME(i, findPos(_::flatHashMix(hashCode), oldPos)) { slots[i].pos = newPos; }
+    else { _::logHashTableInconsistency(); }
+  }
+
+  template <typename Row, typename... Params>
+  Maybe<size_t> find(zc::ArrayPtr<Row> table, Params&&... params) const {
+    if (slots.size() == 0) return zc::none;
+
+    uint hashCode = cb.hashCode(params...);
+    uint mixed = _::flatHashMix(hashCode);
+    byte tag = _::flatHashTag(mixed);
+    for (_::FlatHashProbe probe(mixed, slots.size());; probe.next()) {
+      _::FlatHashGroup group(ctrl.begin() + probe.offset());
+      for (uint bits = group.match(tag); bits != 0; bits &= bits - 1) {
+        auto& slot = slots[probe.offset() + _::flatHashLowestBit(bits)];
+        if (slot.hash == hashCode && cb.matches(table[slot.pos], params...)) {
+          // found
+          return size_t(slot.pos);
+        }
+      }
+      if (group.matchEmpty() != 0) {
+        // not found.
+        return zc::none;
+      }
+    }
+  }
+
+  // No begin() nor end() because hash tables are not usefully ordered.
+
+private:
+  Callbacks cb;
+  size_t erasedCount = 0;
+  Array<byte> ctrl;
+  Array<_::FlatHashSlot> slots;
+
+  void rehash(size_t targetSize) {
+    _::rehash(ctrl, slots, targetSize);
+    erasedCount = 0;
+  }
+
+  Maybe<size_t> findPos(uint mixed, size_t pos) const {
+    // Find the slot of row `pos`, which hashes to `mixed`.
+    if (slots.size() == 0) return zc::none;
+    byte tag = _::flatHashTag(mixed);
+    for (_::FlatHashProbe probe(mixed, slots.size());; probe.next()) {
+      _::FlatHashGroup group(ctrl.begin() + probe.offset());
+      for (uint bits = group.match(tag); bits != 0; bits &= bits - 1) {
+        size_t i = probe.offset() + _::flatHashLowestBit(bits);
+        if (slots[i].pos == pos) { return i; }
+      }
+      if (group.matchEmpty() != 0) return zc::none;
+    }
+  }
+};
+
 // -----------------------------------------------------------------------------
 // BTree index
 
@@ -1101,6 +1467,10 @@ public:
   // Renumber the given row from oldRow to newRow. searchKey.isAfter() returns true for oldRow and
   // all rows after it. (It will not be called on newRow.)
 
+  void bulkLoad(uint count);
+  // Replace the tree's content with rows 0 through count - 1, which must be in sorted order,
+  // building it bottom-up with its nodes as full as the rest of the implementation allows.
+
   void verify(size_t size, FunctionParam<bool(uint, uint)>);
 
 private:
@@ -1464,6 +1834,17 @@ public:
     impl.erase(pos, searchKeyForErase(table, pos, params...));
   }
 
+  template <typename Row>
+  bool bulkInsert(zc::ArrayPtr<Row> table, size_t firstPos) {
+    // Only a whole table, sorted without duplicates, can be loaded directly.
+    if (firstPos != 0) { return false; }
+    for (size_t i = 1; i < table.size(); i++) {
+      if (!cb.isBefore(table[i - 1], cb.keyForRow(table[i]))) { return false; }
+    }
+    impl.bulkLoad(table.size());
+    return true;
+  }
+
   template <typename Row, typename... Params>
   void move(zc::ArrayPtr<Row> table, size_t oldPos, size_t newPos, Params&&... params) {
     impl.renumber(oldPos, newPos, searchKey(table, params...));
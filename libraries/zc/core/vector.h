@@ -132,11 +132,154 @@ private:
   }
 };
 
+template <typename T, size_t smallSize>
+class SmallVector {
+  // Like Vector, but the first `smallSize` elements are stored inside the object itself, so that
+  // it only allocates once it grows beyond that. Meant for lists that are usually tiny, e.g. the
+  // children of a node, where allocation would dominate the cost of the list.
+  //
+  // Once it has moved to the heap it stays there, even if it shrinks again. Moving a SmallVector
+  // whose elements are still inline moves each element.
+
+  static_assert(smallSize > 0, "use Vector instead");
+
+public:
+  inline SmallVector() : builder(inlineBuilder()) {}
+  inline SmallVector(SmallVector&& other) : builder(inlineBuilder()) { takeFrom(other); }
+  inline ~SmallVector() noexcept(false) {}
+  ZC_DISALLOW_COPY(SmallVector);
+
+  inline SmallVector& operator=(SmallVector&& other) {
+    if (&other != this) {
+      builder = inlineBuilder();
+      takeFrom(other);
+    }
+    return *this;
+  }
+
+  inline operator ArrayPtr<T>() ZC_LIFETIMEBOUND { return builder; }
+  inline operator ArrayPtr<const T>() const ZC_LIFETIMEBOUND { return builder; }
+  inline ArrayPtr<T> asPtr() ZC_LIFETIMEBOUND { return builder.asPtr(); }
+  inline ArrayPtr<const T> asPtr() const ZC_LIFETIMEBOUND { return builder.asPtr(); }
+
+  inline size_t size() const { return builder.size(); }
+  inline bool empty() const { return size() == 0; }
+  inline size_t capacity() const { return builder.capacity(); }
+  inline bool isInline() const { return builder.begin() == space.elements; }
+  // True until the elements have moved to the heap.
+  inline T& operator[](size_t index) ZC_LIFETIMEBOUND { return builder[index]; }
+  inline const T& operator[](size_t index) const ZC_LIFETIMEBOUND { return builder[index]; }
+
+  inline const T* begin() const ZC_LIFETIMEBOUND { return builder.begin(); }
+  inline const T* end() const ZC_LIFETIMEBOUND { return builder.end(); }
+  inline const T& front() const ZC_LIFETIMEBOUND { return builder.front(); }
+  inline const T& back() const ZC_LIFETIMEBOUND { return builder.back(); }
+  inline T* begin() ZC_LIFETIMEBOUND { return builder.begin(); }
+  inline T* end() ZC_LIFETIMEBOUND { return builder.end(); }
+  inline T& front() ZC_LIFETIMEBOUND { return builder.front(); }
+  inline T& back() ZC_LIFETIMEBOUND { return builder.back(); }
+
+  inline Array<T> releaseAsArray() {
+    // Always copies into a new heap array of the exact size.
+    auto result = heapArrayBuilder<T>(size());
+    result.addAll(zc::mv(builder));
+    builder = inlineBuilder();
+    return result.finish();
+  }
+
+  template <typename U>
+  inline bool operator==(const U& other) const {
+    return asPtr() == other;
+  }
+
+  inline ArrayPtr<T> slice(size_t start, size_t end) ZC_LIFETIMEBOUND {
+    return asPtr().slice(start, end);
+  }
+  inline ArrayPtr<const T> slice(size_t start, size_t end) const ZC_LIFETIMEBOUND {
+    return asPtr().slice(start, end);
+  }
+
+  inline ArrayPtr<T> first(size_t count) ZC_LIFETIMEBOUND { return slice(0, count); }
+  inline ArrayPtr<const T> first(size_t count) const ZC_LIFETIMEBOUND { return slice(0, count); }
+
+  template <typename... Params>
+  inline T& add(Params&&... params) ZC_LIFETIMEBOUND {
+    if (builder.isFull()) grow();
+    return builder.add(zc::fwd<Params>(params)...);
+  }
+
+  template <typename Iterator>
+  inline void addAll(Iterator begin, Iterator end) {
+    size_t needed = builder.size() + (end - begin);
+    if (needed > builder.capacity()) grow(needed);
+    builder.addAll(begin, end);
+  }
+
+  template <typename Container>
+  inline void addAll(Container&& container) {
+    addAll(container.begin(), container.end());
+  }
+
+  inline void removeLast() { builder.removeLast(); }
+
+  inline void resize(size_t size) {
+    if (size > builder.capacity()) grow(size);
+    builder.resize(size);
+  }
+
+  inline void clear() { builder.clear(); }
+
+  inline void truncate(size_t size) { builder.truncate(size); }
+
+  inline void reserve(size_t size) {
+    if (size > builder.capacity()) { grow(size); }
+  }
+
+private:
+  union Space {
+    // Raw storage; `builder` constructs and destroys the elements.
+    inline Space() {}
+    inline ~Space() {}
+    T elements[smallSize];
+  };
+
+  Space space;
+  ArrayBuilder<T> builder;
+  // Declared after `space`, so that it destroys the inline elements before they go away.
+
+  inline ArrayBuilder<T> inlineBuilder() {
+    return ArrayBuilder<T>(space.elements, smallSize, DestructorOnlyArrayDisposer::instance);
+  }
+
+  void takeFrom(SmallVector& other) {
+    if (other.isInline()) {
+      builder.addAll(zc::mv(other.builder));
+      other.builder.clear();
+    } else {
+      builder = zc::mv(other.builder);
+      other.builder = other.inlineBuilder();
+    }
+  }
+
+  void grow(size_t minCapacity = 0) {
+    size_t newCapacity = zc::max(minCapacity, capacity() * 2);
+    ArrayBuilder<T> newBuilder = heapArrayBuilder<T>(newCapacity);
+    newBuilder.addAll(zc::mv(builder));
+    builder = zc::mv(newBuilder);
+  }
+};
+
 template <typename T>
 inline auto ZC_STRINGIFY(const Vector<T>& v) -> decltype(toCharSequence(v.asPtr())) {
   return toCharSequence(v.asPtr());
 }
 
+template <typename T, size_t smallSize>
+inline auto ZC_STRINGIFY(const SmallVector<T, smallSize>& v)
+    -> decltype(toCharSequence(v.asPtr())) {
+  return toCharSequence(v.asPtr());
+}
+
 }  // namespace zc
 
 ZC_END_HEADER
@@ -0,0 +1,361 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/common.h"
+#if ZC_HAS_ZLIB
+
+#include "zc/http/compression.h"
+
+#include "zc/core/debug.h"
+
+namespace zc {
+
+namespace {
+
+inline char toLower(char c) { return c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c; }
+
+bool equalsIgnoreCase(zc::ArrayPtr<const char> a, zc::StringPtr b) {
+  if (a.size() != b.size()) { return false; }
+  for (size_t i = 0; i < a.size(); i++) {
+    if (toLower(a[i]) != toLower(b[i])) { return false; }
+  }
+  return true;
+}
+
+int parseQuality(zc::ArrayPtr<const char> value) {
+  // Parses a qvalue (RFC 9110 section 12.4.2) as thousandths. Anything malformed counts as 0, so
+  // that the coding it was given for isn't used.
+  if (value.size() == 0 || (value[0] != '0' && value[0] != '1')) { return 0; }
+  int result = (value[0] - '0') * 1000;
+  if (value.size() > 1) {
+    if (value[1] != '.' || value.size() > 5) { return 0; }
+    int scale = 100;
+    for (char c : value.slice(2)) {
+      if (c < '0' || c > '9') { return 0; }
+      result += (c - '0') * scale;
+      scale /= 10;
+    }
+  }
+  return result > 1000 ? 0 : result;
+}
+
+}  // namespace
+
+// =======================================================================================
+
+class HttpCompressionService::ResponseImpl final : public HttpService::Response {
+public:
+  ResponseImpl(HttpCompressionService& service, Response& inner, Encoding encoding)
+      : service(service), inner(inner), encoding(encoding) {}
+
+  zc::Own<zc::AsyncOutputStream> send(uint statusCode, zc::StringPtr statusText,
+                                      const HttpHeaders& headers,
+                                      zc::Maybe<uint64_t> expectedBodySize) override;
+
+  zc::Own<WebSocket> acceptWebSocket(const HttpHeaders& headers) override {
+    return inner.acceptWebSocket(headers);
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const byte> buffer) {
+    ZC_IF_SOME(stream, compressor) { return stream.write(buffer); }
+
+    held.addAll(buffer);
+    if (held.size() < service.settings.minSize) { return zc::READY_NOW; }
+
+    startCompressing();
+    return ZC_ASSERT_NONNULL(compressor).write(held.asPtr()).then([this]() {
+      held = zc::Vector<byte>();
+    });
+  }
+
+  zc::Promise<void> whenWriteDisconnected() {
+    ZC_IF_SOME(body, innerBody) { return body->whenWriteDisconnected(); }
+    return zc::NEVER_DONE;
+  }
+
+  zc::Promise<void> finish() {
+    ZC_IF_SOME(stream, gzip) { return stream->end(); }
+#if ZC_HAS_BROTLI
+    ZC_IF_SOME(stream, brotli) { return stream->end(); }
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+    ZC_IF_SOME(stream, zstd) { return stream->end(); }
+#endif  // ZC_HAS_ZSTD
+
+    ZC_IF_SOME(h, headers) {
+      // The body ended short of the threshold, so it goes out as it is.
+      auto body = inner.send(statusCode, statusText, h, held.size());
+      auto promise = body->write(held.asPtr());
+      return promise.attach(zc::mv(body));
+    }
+    return zc::READY_NOW;
+  }
+
+private:
+  HttpCompressionService& service;
+  Response& inner;
+  Encoding encoding;
+
+  // Set by send() if the response might be compressed.
+  uint statusCode = 0;
+  zc::String statusText;
+  zc::Maybe<HttpHeaders> headers;
+
+  zc::Vector<byte> held;
+  // The start of a body of unknown size, until it's long enough to compress.
+
+  zc::Maybe<zc::Own<zc::AsyncOutputStream>> innerBody;
+  zc::Maybe<zc::Own<GzipAsyncOutputStream>> gzip;
+#if ZC_HAS_BROTLI
+  zc::Maybe<zc::Own<BrotliAsyncOutputStream>> brotli;
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+  zc::Maybe<zc::Own<ZstdAsyncOutputStream>> zstd;
+#endif  // ZC_HAS_ZSTD
+  zc::Maybe<zc::AsyncOutputStream&> compressor;
+
+  void startCompressing() {
+    auto& h = ZC_ASSERT_NONNULL(headers);
+    h.set(service.contentEncoding, encodingName(encoding));
+    ZC_IF_SOME(value, h.get(service.vary)) {
+      h.set(service.vary, zc::str(value, ", Accept-Encoding"));
+    }
+    else { h.set(service.vary, "Accept-Encoding"); }
+
+    auto& body = *innerBody.emplace(inner.send(statusCode, statusText, h));
+    switch (encoding) {
+      case Encoding::IDENTITY:
+        ZC_UNREACHABLE;
+      case Encoding::GZIP:
+        compressor = *gzip.emplace(
+            zc::heap<GzipAsyncOutputStream>(body, service.gzipContexts.get()));
+        break;
+      case Encoding::BROTLI:
+#if ZC_HAS_BROTLI
+        compressor = *brotli.emplace(
+            zc::heap<BrotliAsyncOutputStream>(body, service.brotliContexts.get()));
+        break;
+#else
+        ZC_UNREACHABLE;
+#endif  // ZC_HAS_BROTLI
+      case Encoding::ZSTD:
+#if ZC_HAS_ZSTD
+        compressor = *zstd.emplace(
+            zc::heap<ZstdAsyncOutputStream>(body, service.zstdContexts.get()));
+        break;
+#else
+        ZC_UNREACHABLE;
+#endif  // ZC_HAS_ZSTD
+    }
+  }
+
+  static zc::StringPtr encodingName(Encoding encoding) {
+    switch (encoding) {
+      case Encoding::IDENTITY:
+        break;
+      case Encoding::GZIP:
+        return "gzip";
+      case Encoding::BROTLI:
+        return "br";
+      case Encoding::ZSTD:
+        return "zstd";
+    }
+    ZC_UNREACHABLE;
+  }
+};
+
+class HttpCompressionService::BodyStream final : public zc::AsyncOutputStream {
+  // What the wrapped service writes the body to. Finishing the compressed stream is left to
+  // ResponseImpl::finish(), since the service signals the end of the body by dropping this, which
+  // can't wait for the compressor to flush.
+
+public:
+  explicit BodyStream(ResponseImpl& response) : response(response) {}
+
+  zc::Promise<void> write(zc::ArrayPtr<const byte> buffer) override {
+    return response.write(buffer);
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const zc::ArrayPtr<const byte>> pieces) override {
+    for (auto piece : pieces) co_await response.write(piece);
+  }
+
+  zc::Promise<void> whenWriteDisconnected() override { return response.whenWriteDisconnected(); }
+
+private:
+  ResponseImpl& response;
+};
+
+zc::Own<zc::AsyncOutputStream> HttpCompressionService::ResponseImpl::send(
+    uint statusCode, zc::StringPtr statusText, const HttpHeaders& headers,
+    zc::Maybe<uint64_t> expectedBodySize) {
+  if (!service.isCompressible(statusCode, headers)) {
+    return inner.send(statusCode, statusText, headers, expectedBodySize);
+  }
+  ZC_IF_SOME(size, expectedBodySize) {
+    if (size < service.settings.minSize) {
+      return inner.send(statusCode, statusText, headers, expectedBodySize);
+    }
+  }
+
+  this->statusCode = statusCode;
+  this->statusText = zc::str(statusText);
+  this->headers = headers.clone();
+  if (expectedBodySize != zc::none) { startCompressing(); }
+  return zc::heap<BodyStream>(*this);
+}
+
+// =======================================================================================
+
+HttpCompressionService::HttpCompressionService(HttpService& inner,
+                                               HttpHeaderTable::Builder& headerTableBuilder,
+                                               HttpCompressionSettings settings)
+    : inner(inner),
+      settings(settings),
+      acceptEncoding(headerTableBuilder.add("Accept-Encoding")),
+      contentEncoding(headerTableBuilder.add("Content-Encoding")),
+      cacheControl(headerTableBuilder.add("Cache-Control")),
+      vary(headerTableBuilder.add("Vary")),
+      gzipContexts(settings.maxIdleContexts, settings.gzipLevel)
+#if ZC_HAS_BROTLI
+      ,
+      brotliContexts(settings.maxIdleContexts, settings.brotliQuality)
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+      ,
+      zstdContexts(settings.maxIdleContexts, settings.zstdLevel)
+#endif  // ZC_HAS_ZSTD
+{
+}
+
+HttpCompressionService::~HttpCompressionService() noexcept(false) {}
+
+zc::Promise<void> HttpCompressionService::request(HttpMethod method, zc::StringPtr url,
+                                                  const HttpHeaders& headers,
+                                                  zc::AsyncInputStream& requestBody,
+                                                  Response& response) {
+  auto encoding = method == HttpMethod::HEAD ? Encoding::IDENTITY : negotiate(headers);
+  if (encoding == Encoding::IDENTITY) {
+    return inner.request(method, url, headers, requestBody, response);
+  }
+
+  auto wrapper = zc::heap<ResponseImpl>(*this, response, encoding);
+  auto promise = inner.request(method, url, headers, requestBody, *wrapper);
+  return promise.then([&impl = *wrapper]() { return impl.finish(); }).attach(zc::mv(wrapper));
+}
+
+zc::Promise<void> HttpCompressionService::connect(zc::StringPtr host, const HttpHeaders& headers,
+                                                  zc::AsyncIoStream& connection,
+                                                  ConnectResponse& response,
+                                                  HttpConnectSettings settings) {
+  return inner.connect(host, headers, connection, response, settings);
+}
+
+HttpCompressionService::Encoding HttpCompressionService::negotiate(
+    const HttpHeaders& headers) const {
+  auto header = ZC_UNWRAP_OR(headers.get(acceptEncoding), return Encoding::IDENTITY);
+
+  // The quality given to each coding, in thousandths, or -1 where it isn't named.
+  int gzipQuality = -1;
+#if ZC_HAS_BROTLI
+  int brotliQuality = -1;
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+  int zstdQuality = -1;
+#endif  // ZC_HAS_ZSTD
+  int anyQuality = -1;
+
+  zc::ArrayPtr<const char> cursor = header.asArray();
+  while (cursor.size() > 0) {
+    auto params = _::splitNext(cursor, ',');
+    auto coding = _::splitNext(params, ';');
+    _::stripLeadingAndTrailingSpace(coding);
+
+    int quality = 1000;
+    while (params.size() > 0) {
+      auto param = _::splitNext(params, ';');
+      _::stripLeadingAndTrailingSpace(param);
+      if (param.size() >= 2 && toLower(param[0]) == 'q' && param[1] == '=') {
+        quality = parseQuality(param.slice(2));
+      }
+    }
+
+    if (equalsIgnoreCase(coding, "gzip") || equalsIgnoreCase(coding, "x-gzip")) {
+      gzipQuality = quality;
+#if ZC_HAS_BROTLI
+    } else if (equalsIgnoreCase(coding, "br")) {
+      brotliQuality = quality;
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+    } else if (equalsIgnoreCase(coding, "zstd")) {
+      zstdQuality = quality;
+#endif  // ZC_HAS_ZSTD
+    } else if (equalsIgnoreCase(coding, "*")) {
+      anyQuality = quality;
+    }
+  }
+
+  // Considered in order of preference, so that the first wins a tie.
+  Encoding best = Encoding::IDENTITY;
+  int bestQuality = 0;
+  auto consider = [&](Encoding encoding, int quality) {
+    if (quality < 0) { quality = anyQuality; }
+    if (quality > bestQuality) {
+      best = encoding;
+      bestQuality = quality;
+    }
+  };
+#if ZC_HAS_ZSTD
+  consider(Encoding::ZSTD, zstdQuality);
+#endif  // ZC_HAS_ZSTD
+#if ZC_HAS_BROTLI
+  consider(Encoding::BROTLI, brotliQuality);
+#endif  // ZC_HAS_BROTLI
+  consider(Encoding::GZIP, gzipQuality);
+  return best;
+}
+
+bool HttpCompressionService::isCompressible(uint statusCode, const HttpHeaders& headers) const {
+  // Statuses whose responses have no body, or only part of one.
+  if (statusCode < 200 || statusCode == 204 || statusCode == 206 || statusCode == 304) {
+    return false;
+  }
+
+  if (headers.get(contentEncoding) != zc::none ||
+      headers.get(HttpHeaderId::CONTENT_RANGE) != zc::none) {
+    return false;
+  }
+
+  ZC_IF_SOME(value, headers.get(cacheControl)) {
+    zc::ArrayPtr<const char> cursor = value.asArray();
+    while (cursor.size() > 0) {
+      auto directive = _::splitNext(cursor, ',');
+      _::stripLeadingAndTrailingSpace(directive);
+      if (equalsIgnoreCase(directive, "no-transform")) { return false; }
+    }
+  }
+
+  return true;
+}
+
+}  // namespace zc
+
+#endif  // ZC_HAS_ZLIB
@@ -0,0 +1,111 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+// Compression of HTTP responses, negotiated by Accept-Encoding. Requires zlib; brotli and zstd are
+// offered too if ZC_HAS_BROTLI and ZC_HAS_ZSTD are set.
+
+#include "zc/http/http.h"
+#include "zc/zip/gzip.h"
+#if ZC_HAS_BROTLI
+#include "zc/zip/brotli.h"
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+#include "zc/zip/zstd.h"
+#endif  // ZC_HAS_ZSTD
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+struct HttpCompressionSettings {
+  size_t minSize = 1024;
+  // Bodies shorter than this are sent as they are, since compressing them would save little. A
+  // body whose size the service doesn't give up front is held back until it reaches this size or
+  // ends.
+
+  int gzipLevel = Z_DEFAULT_COMPRESSION;
+#if ZC_HAS_BROTLI
+  int brotliQuality = ZC_BROTLI_DEFAULT_QUALITY;
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+  int zstdLevel = ZC_ZSTD_DEFAULT_LEVEL;
+#endif  // ZC_HAS_ZSTD
+
+  size_t maxIdleContexts = 16;
+  // The most compression contexts of each encoding kept for reuse once their responses finish.
+};
+
+class HttpCompressionService final : public HttpService {
+  // Wraps another service, compressing the bodies of its responses for clients that accept it.
+  // Where the client accepts several equally, zstd is preferred, then brotli, then gzip.
+  // Compression contexts are drawn from pools, so that responses don't each allocate their own.
+  //
+  // Responses that already have a Content-Encoding, that say "Cache-Control: no-transform", that
+  // are partial, or that have no body to begin with are passed through untouched, as are
+  // WebSockets and CONNECT requests. A compressed response loses its Content-Length and gains a
+  // Vary: Accept-Encoding header.
+  //
+  // The compressed stream is finished when the wrapped service's request() promise resolves, so
+  // the service must be done writing the body by then.
+
+public:
+  HttpCompressionService(HttpService& inner, HttpHeaderTable::Builder& headerTableBuilder,
+                         HttpCompressionSettings settings = {});
+  ~HttpCompressionService() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(HttpCompressionService);
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, Response& response) override;
+
+  zc::Promise<void> connect(zc::StringPtr host, const HttpHeaders& headers,
+                            zc::AsyncIoStream& connection, ConnectResponse& response,
+                            HttpConnectSettings settings) override;
+
+private:
+  enum class Encoding { IDENTITY, GZIP, BROTLI, ZSTD };
+
+  class ResponseImpl;
+  class BodyStream;
+
+  HttpService& inner;
+  HttpCompressionSettings settings;
+
+  HttpHeaderId acceptEncoding;
+  HttpHeaderId contentEncoding;
+  HttpHeaderId cacheControl;
+  HttpHeaderId vary;
+
+  GzipContextPool gzipContexts;
+#if ZC_HAS_BROTLI
+  BrotliContextPool brotliContexts;
+#endif  // ZC_HAS_BROTLI
+#if ZC_HAS_ZSTD
+  ZstdContextPool zstdContexts;
+#endif  // ZC_HAS_ZSTD
+
+  Encoding negotiate(const HttpHeaders& headers) const;
+  bool isCompressible(uint statusCode, const HttpHeaders& headers) const;
+};
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -31,6 +31,7 @@
 #include "zc/core/debug.h"
 #include "zc/core/encoding.h"
 #include "zc/core/exception.h"
+#include "zc/core/list.h"
 #include "zc/core/string.h"
 #include "zc/http/url.h"
 #include "zc/parse/char.h"
@@ -38,6 +39,14 @@
 #include <zlib.h>
 #endif  // ZC_HAS_ZLIB
 
+#if __SSE2__ || _M_X64 || (_M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZC_HTTP_SSE2 1
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_HTTP_NEON 1
+#endif
+
 namespace zc {
 
 // =======================================================================================
@@ -575,11 +584,107 @@ struct HeaderNameHash {
   }
 };
 
+// Builtin header names are looked up first in a table built at compile time, where each one has a
+// slot to itself, so that recognizing them takes one probe and one comparison instead of a hash
+// over the whole name and a strcasecmp().
+
+constexpr uint BUILTIN_HEADER_SLOT_COUNT = 32;
+
+constexpr uint builtinHeaderSlot(size_t size, char first, char last) {
+  // Perfect over the builtin names, which differ enough in length and in their first and last
+  // letters. If a new builtin header collides, the static_assert below says so; adjust the
+  // multipliers until it doesn't.
+  return (size * 3 + (first | 0x20) * 12 + (last | 0x20) * 14) % BUILTIN_HEADER_SLOT_COUNT;
+}
+
+struct BuiltinHeaderSlot {
+  alignas(16) char lowerName[32];  // Zero-padded.
+  uint size;                       // Zero if no builtin header hashes here.
+  uint id;
+};
+
+struct BuiltinHeaderSlots {
+  BuiltinHeaderSlot slots[BUILTIN_HEADER_SLOT_COUNT];
+  bool perfect;
+};
+
+constexpr BuiltinHeaderSlots BUILTIN_HEADER_SLOTS = []() {
+  constexpr const char* names[] = {
+#define HEADER_NAME(id, name) name,
+      ZC_HTTP_FOR_EACH_BUILTIN_HEADER(HEADER_NAME)
+#undef HEADER_NAME
+  };
+
+  BuiltinHeaderSlots result{};
+  result.perfect = true;
+  for (uint id = 0; id < zc::size(names); id++) {
+    const char* name = names[id];
+    size_t size = 0;
+    while (name[size] != '\0') ++size;
+    if (size > sizeof(BuiltinHeaderSlot::lowerName)) {
+      result.perfect = false;
+      break;
+    }
+
+    auto& slot = result.slots[builtinHeaderSlot(size, name[0], name[size - 1])];
+    if (slot.size != 0) result.perfect = false;
+    for (size_t i = 0; i < size; i++) {
+      char c = name[i];
+      slot.lowerName[i] = 'A' <= c && c <= 'Z' ? c + ('a' - 'A') : c;
+    }
+    slot.size = size;
+    slot.id = id;
+  }
+  return result;
+}();
+
+static_assert(BUILTIN_HEADER_SLOTS.perfect,
+              "builtinHeaderSlot() is no longer perfect over the builtin header names");
+
+static zc::Maybe<uint> findBuiltinHeader(zc::StringPtr name) {
+  if (name.size() == 0 || name.size() > sizeof(BuiltinHeaderSlot::lowerName)) return zc::none;
+
+  auto& slot =
+      BUILTIN_HEADER_SLOTS.slots[builtinHeaderSlot(name.size(), name[0], name[name.size() - 1])];
+  if (slot.size != name.size()) return zc::none;
+
+  // Compare case-insensitively, folding only 'A'-'Z' so that no other byte can match a letter.
+  alignas(16) char padded[sizeof(BuiltinHeaderSlot::lowerName)]{};
+  memcpy(padded, name.begin(), name.size());
+
+#if ZC_HTTP_SSE2
+  for (size_t i = 0; i < sizeof(padded); i += 16) {
+    __m128i chunk = _mm_load_si128(reinterpret_cast<const __m128i*>(padded + i));
+    __m128i offset = _mm_sub_epi8(chunk, _mm_set1_epi8('A'));
+    __m128i upper = _mm_cmpeq_epi8(_mm_min_epu8(offset, _mm_set1_epi8('Z' - 'A')), offset);
+    chunk = _mm_or_si128(chunk, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+    __m128i expected = _mm_load_si128(reinterpret_cast<const __m128i*>(slot.lowerName + i));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, expected)) != 0xffff) return zc::none;
+  }
+#elif ZC_HTTP_NEON
+  for (size_t i = 0; i < sizeof(padded); i += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(padded + i));
+    uint8x16_t upper = vcleq_u8(vsubq_u8(chunk, vdupq_n_u8('A')), vdupq_n_u8('Z' - 'A'));
+    chunk = vorrq_u8(chunk, vandq_u8(upper, vdupq_n_u8(0x20)));
+    uint8x16_t expected = vld1q_u8(reinterpret_cast<const uint8_t*>(slot.lowerName + i));
+    if (vminvq_u8(vceqq_u8(chunk, expected)) != 0xff) return zc::none;
+  }
+#else
+  for (size_t i = 0; i < name.size(); i++) {
+    char c = padded[i];
+    if ('A' <= c && c <= 'Z') c += 'a' - 'A';
+    if (c != slot.lowerName[i]) return zc::none;
+  }
+#endif
+
+  return slot.id;
+}
+
 }  // namespace
 
 struct HttpHeaderTable::IdsByNameMap {
-  // TODO(perf): If we were cool we could maybe use a perfect hash here, since our hashtable is
-  //   static once built.
+  // Holds the builtin headers too, so that Builder::add() finds them, but stringToId() only comes
+  // here for names findBuiltinHeader() doesn't recognize.
 
   std::unordered_map<zc::StringPtr, uint, HeaderNameHash, HeaderNameHash> map;
 };
@@ -606,6 +711,8 @@ HttpHeaderTable::HttpHeaderTable() : idsByName(zc::heap<IdsByNameMap>()) {
 HttpHeaderTable::~HttpHeaderTable() noexcept(false) {}
 
 zc::Maybe<HttpHeaderId> HttpHeaderTable::stringToId(zc::StringPtr name) const {
+  ZC_IF_SOME(id, findBuiltinHeader(name)) { return HttpHeaderId(this, id); }
+
   auto iter = idsByName->map.find(name);
   if (iter == idsByName->map.end()) {
     return zc::none;
@@ -638,6 +745,7 @@ void HttpHeaders::clear() {
   for (auto& header : indexedHeaders) { header = nullptr; }
 
   unindexedHeaders.clear();
+  borrowed = false;
 }
 
 size_t HttpHeaders::size() const {
@@ -679,6 +787,12 @@ HttpHeaders HttpHeaders::cloneShallow() const {
   return result;
 }
 
+HttpHeaders HttpHeaders::borrow() const {
+  auto result = cloneShallow();
+  result.borrowed = true;
+  return result;
+}
+
 zc::StringPtr HttpHeaders::cloneToOwn(zc::StringPtr str) {
   auto copy = zc::heapString(str);
   zc::StringPtr result = copy;
@@ -788,11 +902,34 @@ static inline char* skipSpace(char* p) {
   return const_cast<char*>(skipSpace(const_cast<const char*>(p)));
 }
 
-static zc::Maybe<zc::StringPtr> consumeWord(char*& ptr) {
+static inline char* skipAbove(char* p, const char* end, byte floor) {
+  // Returns the first position at or after `p` holding a byte no greater than `floor`, or `end`
+  // if there's none. This is where header parsing spends most of its time, so it checks 16 bytes
+  // at a time where SSE2 or NEON is available. A single unsigned comparison finds every delimiter
+  // the callers care about, since they're all control characters or space.
+#if ZC_HTTP_SSE2
+  __m128i bound = _mm_set1_epi8(floor + 1);
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(chunk, bound), chunk)) != 0xffff) break;
+    p += 16;
+  }
+#elif ZC_HTTP_NEON
+  while (end - p >= 16) {
+    if (vminvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p))) <= floor) break;
+    p += 16;
+  }
+#endif
+  while (p < end && byte(*p) > floor) ++p;
+  return p;
+}
+
+static zc::Maybe<zc::StringPtr> consumeWord(char*& ptr, const char* end) {
   char* start = skipSpace(ptr);
   char* p = start;
 
   for (;;) {
+    p = skipAbove(p, end, ' ');
     switch (*p) {
       case '\0':
         ptr = p;
@@ -843,11 +980,12 @@ static zc::Maybe<uint> consumeNumber(char*& ptr) {
   return result;
 }
 
-static zc::StringPtr consumeLine(char*& ptr) {
+static zc::StringPtr consumeLine(char*& ptr, const char* end) {
   char* start = skipSpace(ptr);
   char* p = start;
 
   for (;;) {
+    p = skipAbove(p, end, '\r');
     switch (*p) {
       case '\0':
         ptr = p;
@@ -962,7 +1100,7 @@ HttpHeaders::RequestConnectOrProtocolError HttpHeaders::tryParseRequestOrConnect
     ++ptr;
 
     zc::Maybe<StringPtr> path;
-    ZC_IF_SOME(p, consumeWord(ptr)) { path = p; }
+    ZC_IF_SOME(p, consumeWord(ptr, end)) { path = p; }
     else { return ProtocolError{400, "Bad Request", "Invalid request line.", content}; }
 
     ZC_SWITCH_ONEOF(method) {
@@ -975,7 +1113,7 @@ HttpHeaders::RequestConnectOrProtocolError HttpHeaders::tryParseRequestOrConnect
   else { return ProtocolError{501, "Not Implemented", "Unrecognized request method.", content}; }
 
   // Ignore rest of line. Don't care about "HTTP/1.1" or whatever.
-  consumeLine(ptr);
+  consumeLine(ptr, end);
 
   if (!parseHeaders(ptr, end)) {
     return ProtocolError{400, "Bad Request", "The headers sent by your client are not valid.",
@@ -995,7 +1133,7 @@ HttpHeaders::ResponseOrProtocolError HttpHeaders::tryParseResponse(zc::ArrayPtr<
 
   HttpHeaders::Response response;
 
-  ZC_IF_SOME(version, consumeWord(ptr)) {
+  ZC_IF_SOME(version, consumeWord(ptr, end)) {
     if (!version.startsWith("HTTP/")) {
       return ProtocolError{502, "Bad Gateway", "Invalid response status line (invalid protocol).",
                            content};
@@ -1011,7 +1149,7 @@ HttpHeaders::ResponseOrProtocolError HttpHeaders::tryParseResponse(zc::ArrayPtr<
                          content};
   }
 
-  response.statusText = consumeLine(ptr);
+  response.statusText = consumeLine(ptr, end);
 
   if (!parseHeaders(ptr, end)) {
     return ProtocolError{502, "Bad Gateway", "The headers sent by the server are not valid.",
@@ -1032,7 +1170,7 @@ bool HttpHeaders::tryParse(zc::ArrayPtr<char> content) {
 bool HttpHeaders::parseHeaders(char* ptr, char* end) {
   while (*ptr != '\0') {
     ZC_IF_SOME(name, consumeHeaderName(ptr)) {
-      zc::StringPtr line = consumeLine(ptr);
+      zc::StringPtr line = consumeLine(ptr, end);
       addNoCheck(name, line);
     }
     else { return false; }
@@ -1049,6 +1187,42 @@ zc::String HttpHeaders::serializeRequest(
   return serialize(zc::toCharSequence(method), url, "HTTP/1.1"_zc, connectionHeaders);
 }
 
+zc::Array<zc::ArrayPtr<const byte>> HttpHeaders::serializeRequestPieces(
+    HttpMethod method, zc::StringPtr url,
+    zc::ArrayPtr<const zc::StringPtr> connectionHeaders) const {
+  const zc::StringPtr space = " ";
+  const zc::StringPtr newline = "\r\n";
+  const zc::StringPtr colon = ": ";
+
+  // The request line takes six pieces, each header four, and the final newline one.
+  size_t count = 7 + unindexedHeaders.size() * 4;
+  ZC_ASSERT(connectionHeaders.size() <= indexedHeaders.size());
+  for (auto i : zc::indices(indexedHeaders)) {
+    zc::StringPtr value = i < connectionHeaders.size() ? connectionHeaders[i] : indexedHeaders[i];
+    if (value != nullptr) { count += 4; }
+  }
+
+  auto pieces = zc::heapArrayBuilder<zc::ArrayPtr<const byte>>(count);
+  auto addLine = [&](zc::StringPtr a, zc::StringPtr sep, zc::StringPtr b) {
+    pieces.add(a.asBytes());
+    pieces.add(sep.asBytes());
+    pieces.add(b.asBytes());
+    pieces.add(newline.asBytes());
+  };
+
+  pieces.add(zc::toCharSequence(method).asBytes());
+  pieces.add(space.asBytes());
+  addLine(url, space, "HTTP/1.1"_zc);
+  for (auto i : zc::indices(indexedHeaders)) {
+    zc::StringPtr value = i < connectionHeaders.size() ? connectionHeaders[i] : indexedHeaders[i];
+    if (value != nullptr) { addLine(table->idToString(HttpHeaderId(table, i)), colon, value); }
+  }
+  for (auto& header : unindexedHeaders) { addLine(header.name, colon, header.value); }
+  pieces.add(newline.asBytes());
+
+  return pieces.finish();
+}
+
 zc::String HttpHeaders::serializeConnectRequest(
     zc::StringPtr authority, zc::ArrayPtr<const zc::StringPtr> connectionHeaders) const {
   return serialize("CONNECT"_zc, authority, "HTTP/1.1"_zc, connectionHeaders);
@@ -2190,6 +2364,33 @@ public:
     queueWrite(zc::mv(content));
   }
 
+  void writeHeaders(Array<ArrayPtr<const byte>> pieces, String scratch) {
+    // Like writeHeaders(String), but gathers the header content from `pieces`, which reference
+    // strings owned elsewhere, except perhaps for `scratch`. Until the write completes, which
+    // isBorrowedWritePending() reports, the caller must keep those strings alive or else call
+    // cancelBorrowedWrites().
+
+    ZC_REQUIRE(!writeInProgress, "concurrent write()s not allowed") { return; }
+    ZC_REQUIRE(!inBody, "previous HTTP message body incomplete; can't write more messages");
+    inBody = true;
+
+    ++borrowedWritesPending;
+    writeQueue = writeQueue.then(
+        [this, pieces = zc::mv(pieces), scratch = zc::mv(scratch)]() mutable {
+          auto promise = inner.write(pieces);
+          return promise.attach(zc::mv(pieces), zc::mv(scratch));
+        }).then([this]() { --borrowedWritesPending; });
+  }
+
+  bool isBorrowedWritePending() { return borrowedWritesPending > 0; }
+
+  void cancelBorrowedWrites() {
+    // Called when the strings a queued writeHeaders() references are about to go away. The write
+    // can't be completed, nor the stream be used any further.
+    broken = true;
+    writeQueue = ZC_EXCEPTION(DISCONNECTED, "HTTP request canceled while writing its headers");
+  }
+
   void writeBodyData(zc::String content) {
     ZC_REQUIRE(!writeInProgress, "concurrent write()s not allowed") { return; }
     ZC_REQUIRE(inBody) { return; }
@@ -2295,6 +2496,8 @@ private:
   // a write throws an exception or is canceled, this remains true forever. In these cases, the
   // underlying stream is in an inconsistent state and cannot be reused.
 
+  uint borrowedWritesPending = 0;
+
   void queueWrite(zc::String content) {
     // We only use queueWrite() in cases where we can take ownership of the write buffer, and where
     // it is convenient if we can return `void` rather than a promise.  In particular, this is used
@@ -2457,49 +2660,57 @@ private:
 
 class HttpChunkedEntityWriter final : public HttpEntityBodyWriter {
 public:
-  HttpChunkedEntityWriter(HttpOutputStream& inner) : HttpEntityBodyWriter(inner) {}
+  HttpChunkedEntityWriter(HttpOutputStream& inner, size_t minChunkSize = 0)
+      : HttpEntityBodyWriter(inner), minChunkSize(minChunkSize) {}
   ~HttpChunkedEntityWriter() noexcept(false) {
     if (!alreadyDone()) {
       auto& inner = getInner();
       if (inner.canWriteBodyData()) {
-        inner.writeBodyData(zc::str("0\r\n\r\n"));
+        if (pending.empty()) {
+          inner.writeBodyData(zc::str("0\r\n\r\n"));
+        } else {
+          inner.writeBodyData(
+              zc::str(zc::hex(pending.size()), "\r\n", pending.asPtr().asChars(), "\r\n0\r\n\r\n"));
+        }
         doneWriting();
       }
     }
   }
 
   Promise<void> write(ArrayPtr<const byte> buffer) override {
-    if (buffer == nullptr)
-      return zc::READY_NOW;  // can't encode zero-size chunk since it indicates EOF.
-
-    auto header = zc::str(zc::hex(buffer.size()), "\r\n");
-    auto parts = zc::heapArray<ArrayPtr<const byte>>(3);
-    parts[0] = header.asBytes();
-    parts[1] = buffer;
-    parts[2] = "\r\n"_zcb;
-
-    auto promise = getInner().writeBodyData(parts.asPtr());
-    return promise.attach(zc::mv(header), zc::mv(parts));
+    return write(arrayPtr(&buffer, 1));
   }
 
   Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override {
-    uint64_t size = 0;
+    uint64_t size = pending.size();
     for (auto& piece : pieces) size += piece.size();
 
     if (size == 0) return zc::READY_NOW;  // can't encode zero-size chunk since it indicates EOF.
 
-    auto header = zc::str(zc::hex(size), "\r\n");
-    auto partsBuilder = zc::heapArrayBuilder<ArrayPtr<const byte>>(pieces.size() + 2);
-    partsBuilder.add(header.asBytes());
-    for (auto& piece : pieces) { partsBuilder.add(piece); }
-    partsBuilder.add("\r\n"_zcb);
+    if (size < minChunkSize) {
+      // Too small to be worth a chunk of its own; hold on to it until more comes.
+      for (auto& piece : pieces) pending.addAll(piece);
+      return zc::READY_NOW;
+    }
+
+    // Only one write can be in progress at a time, so the header and the list of parts can live
+    // in the writer rather than being allocated for every chunk.
+    parts.clear();
+    parts.add(formatChunkHeader(size));
+    if (!pending.empty()) parts.add(pending.asPtr());
+    parts.addAll(pieces);
+    parts.add("\r\n"_zcb);
 
-    auto parts = partsBuilder.finish();
     auto promise = getInner().writeBodyData(parts.asPtr());
-    return promise.attach(zc::mv(header), zc::mv(parts));
+    if (pending.empty()) return promise;
+    return promise.then([this]() { pending.clear(); });
   }
 
   Maybe<Promise<uint64_t>> tryPumpFrom(AsyncInputStream& input, uint64_t amount) override {
+    if (!pending.empty()) {
+      // Let the read/write loop take care of sending what's held back along with the input.
+      return zc::none;
+    }
     ZC_IF_SOME(l, input.tryGetLength()) { return pumpImpl(input, zc::min(amount, l)); }
     else {
       // Need to use naive read/write loop.
@@ -2525,6 +2736,22 @@ public:
   }
 
   Promise<void> whenWriteDisconnected() override { return getInner().whenWriteDisconnected(); }
+
+private:
+  size_t minChunkSize;
+  zc::Vector<byte> pending;
+  // Writes held back until there's `minChunkSize` worth of them.
+
+  char chunkHeader[sizeof(uint64_t) * 2 + 2];
+  zc::Vector<ArrayPtr<const byte>> parts;
+  // The chunk header and the pieces of the chunk being written.
+
+  ArrayPtr<const byte> formatChunkHeader(uint64_t size) {
+    auto digits = zc::hex(size);
+    memcpy(chunkHeader, digits.begin(), digits.size());
+    memcpy(chunkHeader + digits.size(), "\r\n", 2);
+    return arrayPtr(chunkHeader, digits.size() + 2).asBytes();
+  }
 };
 
 // =======================================================================================
@@ -2534,20 +2761,27 @@ public:
   WebSocketImpl(zc::Own<zc::AsyncIoStream> stream, zc::Maybe<EntropySource&> maskKeyGenerator,
                 zc::Maybe<CompressionParameters> compressionConfigParam = zc::none,
                 zc::Maybe<WebSocketErrorHandler&> errorHandler = zc::none,
+                WebSocketCompressionSettings compressionSettings = {},
                 zc::Array<byte> buffer = zc::heapArray<byte>(4096),
                 zc::ArrayPtr<byte> leftover = nullptr,
                 zc::Maybe<zc::Promise<void>> waitBeforeSend = zc::none)
       : stream(zc::mv(stream)),
         maskKeyGenerator(maskKeyGenerator),
         compressionConfig(zc::mv(compressionConfigParam)),
+        compressionSettings(compressionSettings),
         errorHandler(errorHandler.orDefault(*this)),
         sendingControlMessage(zc::mv(waitBeforeSend)),
         recvBuffer(zc::mv(buffer)),
         recvData(leftover) {
 #if ZC_HAS_ZLIB
     ZC_IF_SOME(config, compressionConfig) {
-      compressionContext.emplace(ZlibContext::Mode::COMPRESS, config);
-      decompressionContext.emplace(ZlibContext::Mode::DECOMPRESS, config);
+      // A direction without context takeover can make do with a shared context, if allowed.
+      if (!compressionSettings.shareContexts || !config.outboundNoContextTakeover) {
+        compressionContext.emplace(ZlibContext::Mode::COMPRESS, config);
+      }
+      if (!compressionSettings.shareContexts || !config.inboundNoContextTakeover) {
+        decompressionContext.emplace(ZlibContext::Mode::DECOMPRESS, config);
+      }
     }
 #else
     ZC_REQUIRE(compressionConfig == zc::none,
@@ -2563,6 +2797,72 @@ public:
     return sendImpl(OPCODE_TEXT, message.asBytes());
   }
 
+  zc::Promise<void> sendFrame(zc::Arc<WebSocketBroadcastFrame> frame) override {
+    ZC_REQUIRE(!disconnected, "WebSocket can't send after disconnect()");
+    ZC_REQUIRE(!currentlySending, "another message send is already in progress");
+
+    currentlySending = true;
+    co_await waitForSendingControlMessage();
+
+    zc::Maybe<const CompressionParameters&> compression;
+    if (frame->getMessage().size() >= compressionSettings.minMessageSize) {
+      compression = compressionConfig;
+    }
+    auto encoding = frame->getEncoding(compression);
+
+    Mask mask(maskKeyGenerator);
+    if (mask.isZero()) {
+      co_await stream->write(encoding.frame);
+      sentBytes += encoding.frame.size();
+    } else {
+      auto payload = zc::heapArray<byte>(encoding.payload.size());
+      mask.copyTo(encoding.payload, payload);
+
+      zc::ArrayPtr<const byte> sendParts[2];
+      sendParts[0] = sendHeader.compose(true, encoding.compressed,
+                                        frame->isText() ? OPCODE_TEXT : OPCODE_BINARY,
+                                        payload.size(), mask);
+      sendParts[1] = payload;
+      co_await stream->write(sendParts);
+      sentBytes += sendParts[0].size() + sendParts[1].size();
+    }
+    currentlySending = false;
+
+    if (queuedControlMessage != zc::none) { setUpSendingControlMessage(); }
+  }
+
+  static zc::Array<byte> encodeFrame(bool text, bool compressed,
+                                     zc::ArrayPtr<const byte> payload) {
+    // Frames a data message for WebSocketBroadcastFrame: unmasked, header and payload together.
+    Header header;
+    auto headerBytes = header.compose(true, compressed, text ? OPCODE_TEXT : OPCODE_BINARY,
+                                      payload.size(), Mask());
+    auto result = zc::heapArray<byte>(headerBytes.size() + payload.size());
+    result.first(headerBytes.size()).copyFrom(headerBytes);
+    result.slice(headerBytes.size()).copyFrom(payload);
+    return result;
+  }
+
+#if ZC_HAS_ZLIB
+  static zc::Array<byte> encodeCompressedFrame(bool text, zc::ArrayPtr<const byte> message,
+                                               const CompressionParameters& config) {
+    // Like encodeFrame(), but compresses the message first, with a context of its own, as
+    // sendImpl() does.
+    ZlibContext compressor(ZlibContext::Mode::COMPRESS, config);
+    ZC_SWITCH_ONEOF(compressor.processMessage(message)) {
+      ZC_CASE_ONEOF(error, ProtocolError) {
+        ZC_FAIL_REQUIRE("Error compressing websocket message: ", error.description);
+      }
+      ZC_CASE_ONEOF(compressed, zc::Array<byte>) {
+        if (message.size() == 0) { return encodeFrame(text, true, {0x00}); }
+        ZC_ASSERT(compressed.asPtr().endsWith({0x00, 0x00, 0xFF, 0xFF}));
+        return encodeFrame(text, true, compressed.first(compressed.size() - 4));
+      }
+    }
+    ZC_UNREACHABLE;
+  }
+#endif  // ZC_HAS_ZLIB
+
   zc::Promise<void> close(uint16_t code, zc::StringPtr reason) override {
     zc::Array<byte> payload = serializeClose(code, reason);
     auto promise = sendImpl(OPCODE_CLOSE, payload);
@@ -2729,7 +3029,8 @@ public:
 #if ZC_HAS_ZLIB
           if (isCompressed) {
             auto& config = ZC_ASSERT_NONNULL(compressionConfig);
-            auto& decompressor = ZC_ASSERT_NONNULL(decompressionContext);
+            auto decompressor =
+                getZlibContext(ZlibContext::Mode::DECOMPRESS, decompressionContext, config);
             ZC_ASSERT(message.size() >= 4);
             auto tail = message.slice(message.size() - 4, message.size());
             // Note that we added an additional 4 bytes to `message`s capacity to account for these
@@ -2740,12 +3041,12 @@ public:
             // See: https://datatracker.ietf.org/doc/html/rfc7692#section-7.2.2
             if (config.inboundNoContextTakeover) {
               // We must reset context on each message.
-              decompressor.reset();
+              decompressor->reset();
             }
             bool addNullTerminator = true;
             // We want to add the null terminator when receiving a TEXT message.
             auto decompressedOrError =
-                decompressor.processMessage(message, originalMaxSize, addNullTerminator);
+                decompressor->processMessage(message, originalMaxSize, addNullTerminator);
             ZC_SWITCH_ONEOF(decompressedOrError) {
               ZC_CASE_ONEOF(protocolError, ProtocolError) {
                 return sendCloseDueToError(protocolError.statusCode, protocolError.description)
@@ -2763,7 +3064,8 @@ public:
 #if ZC_HAS_ZLIB
           if (isCompressed) {
             auto& config = ZC_ASSERT_NONNULL(compressionConfig);
-            auto& decompressor = ZC_ASSERT_NONNULL(decompressionContext);
+            auto decompressor =
+                getZlibContext(ZlibContext::Mode::DECOMPRESS, decompressionContext, config);
             ZC_ASSERT(message.size() >= 4);
             auto tail = message.slice(message.size() - 4, message.size());
             // Note that we added an additional 4 bytes to `message`s capacity to account for these
@@ -2774,10 +3076,10 @@ public:
             // See: https://datatracker.ietf.org/doc/html/rfc7692#section-7.2.2
             if (config.inboundNoContextTakeover) {
               // We must reset context on each message.
-              decompressor.reset();
+              decompressor->reset();
             }
 
-            auto decompressedOrError = decompressor.processMessage(message, originalMaxSize);
+            auto decompressedOrError = decompressor->processMessage(message, originalMaxSize);
             ZC_SWITCH_ONEOF(decompressedOrError) {
               ZC_CASE_ONEOF(protocolError, ProtocolError) {
                 return sendCloseDueToError(protocolError.statusCode, protocolError.description)
@@ -2958,11 +3260,43 @@ private:
 
     bool isZero() const { return (maskBytes[0] | maskBytes[1] | maskBytes[2] | maskBytes[3]) == 0; }
 
+    void copyTo(zc::ArrayPtr<const byte> input, zc::ArrayPtr<byte> output) const {
+      // Writes `input`, masked, to `output`, in one pass rather than a copy followed by apply().
+      ZC_DASSERT(output.size() == input.size());
+      apply(input.begin(), output.begin(), input.size());
+    }
+
   private:
     byte maskBytes[4];
 
-    void apply(byte* __restrict__ bytes, size_t size) const {
-      for (size_t i = 0; i < size; i++) { bytes[i] ^= maskBytes[i % 4]; }
+    void apply(byte* bytes, size_t size) const { apply(bytes, bytes, size); }
+
+    void apply(const byte* input, byte* output, size_t size) const {
+      // Masks 16 bytes at a time where SSE2 or NEON is available, then 8 at a time. Each step
+      // covers a multiple of 4 bytes, so the mask stays lined up for the byte-at-a-time tail.
+      size_t i = 0;
+      uint32_t word;
+      memcpy(&word, maskBytes, 4);
+#if ZC_HTTP_SSE2
+      __m128i vector = _mm_set1_epi32(word);
+      for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), _mm_xor_si128(chunk, vector));
+      }
+#elif ZC_HTTP_NEON
+      uint8x16_t vector = vreinterpretq_u8_u32(vdupq_n_u32(word));
+      for (; i + 16 <= size; i += 16) {
+        vst1q_u8(output + i, veorq_u8(vld1q_u8(input + i), vector));
+      }
+#endif
+      uint64_t wide = (uint64_t(word) << 32) | word;
+      for (; i + 8 <= size; i += 8) {
+        uint64_t chunk;
+        memcpy(&chunk, input + i, 8);
+        chunk ^= wide;
+        memcpy(output + i, &chunk, 8);
+      }
+      for (; i < size; i++) { output[i] = input[i] ^ maskBytes[i % 4]; }
     }
   };
 
@@ -3097,19 +3431,10 @@ private:
       size_t size = 0;  // Number of bytes used; size <= buffer.size().
     };
 
-    ZlibContext(Mode mode, const CompressionParameters& config) : mode(mode) {
+    ZlibContext(Mode mode, const CompressionParameters& config)
+        : mode(mode), windowBits(getWindowBits(mode, config)) {
       switch (mode) {
         case Mode::COMPRESS: {
-          int windowBits = -config.outboundMaxWindowBits.orDefault(15);
-          // We use negative values because we want to use raw deflate.
-          if (windowBits == -8) {
-            // Zlib cannot accept `windowBits` of 8 for the deflater. However, due to an
-            // implementation quirk, `windowBits` of 8 and 9 would both use 250 bytes.
-            // Therefore, a decompressor using `windowBits` of 8 could safely inflate a message
-            // that a zlib client compressed using `windowBits` = 9.
-            // https://bugs.chromium.org/p/chromium/issues/detail?id=691074
-            windowBits = -9;
-          }
           int result = deflateInit2(&ctx, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits,
                                     8,  // memLevel = 8 is the default
                                     Z_DEFAULT_STRATEGY);
@@ -3117,8 +3442,6 @@ private:
           break;
         }
         case Mode::DECOMPRESS: {
-          int windowBits = -config.inboundMaxWindowBits.orDefault(15);
-          // We use negative values because we want to use raw inflate.
           int result = inflateInit2(&ctx, windowBits);
           ZC_REQUIRE(result == Z_OK, "Failed to initialize decompression context (inflate).");
           break;
@@ -3126,6 +3449,31 @@ private:
       }
     }
 
+    static int getWindowBits(Mode mode, const CompressionParameters& config) {
+      // We use negative values because we want to use raw deflate and inflate.
+      switch (mode) {
+        case Mode::COMPRESS: {
+          int windowBits = -config.outboundMaxWindowBits.orDefault(15);
+          if (windowBits == -8) {
+            // Zlib cannot accept `windowBits` of 8 for the deflater. However, due to an
+            // implementation quirk, `windowBits` of 8 and 9 would both use 250 bytes.
+            // Therefore, a decompressor using `windowBits` of 8 could safely inflate a message
+            // that a zlib client compressed using `windowBits` = 9.
+            // https://bugs.chromium.org/p/chromium/issues/detail?id=691074
+            windowBits = -9;
+          }
+          return windowBits;
+        }
+        case Mode::DECOMPRESS:
+          return -config.inboundMaxWindowBits.orDefault(15);
+      }
+      ZC_UNREACHABLE;
+    }
+
+    bool isCompatible(Mode otherMode, int otherWindowBits) const {
+      return mode == otherMode && windowBits == otherWindowBits;
+    }
+
     ~ZlibContext() noexcept(false) {
       switch (mode) {
         case Mode::COMPRESS:
@@ -3268,8 +3616,57 @@ private:
     }
 
     Mode mode;
+    int windowBits;
     z_stream ctx = {};
   };
+
+  class ZlibContextLoan {
+    // The context to (de)compress one message with: either the WebSocket's own, or one borrowed
+    // from the thread's shared pool, to which it goes back when the loan is destroyed. The loan
+    // must not outlive the (synchronous) processing of the message, or other WebSockets would
+    // needlessly create contexts of their own in the meantime.
+
+  public:
+    explicit ZlibContextLoan(ZlibContext& context) : context(context) {}
+    explicit ZlibContextLoan(zc::Own<ZlibContext> borrowed)
+        : context(*borrowed), borrowed(zc::mv(borrowed)) {}
+    ~ZlibContextLoan() noexcept(false) {
+      ZC_IF_SOME(b, borrowed) { sharedZlibContexts().add(zc::mv(b)); }
+    }
+    ZC_DISALLOW_COPY_AND_MOVE(ZlibContextLoan);
+
+    ZlibContext* operator->() { return &context; }
+
+  private:
+    ZlibContext& context;
+    zc::Maybe<zc::Own<ZlibContext>> borrowed;
+  };
+
+  static zc::Vector<zc::Own<ZlibContext>>& sharedZlibContexts() {
+    // Idle contexts for WebSocketCompressionSettings::shareContexts. Messages are (de)compressed
+    // synchronously, so there's seldom more than one per mode and window size.
+    static thread_local zc::Vector<zc::Own<ZlibContext>> contexts;
+    return contexts;
+  }
+
+  static ZlibContextLoan getZlibContext(ZlibContext::Mode mode, zc::Maybe<ZlibContext>& own,
+                                        const CompressionParameters& config) {
+    ZC_IF_SOME(context, own) { return ZlibContextLoan(context); }
+
+    auto& shared = sharedZlibContexts();
+    int windowBits = ZlibContext::getWindowBits(mode, config);
+    for (auto i : zc::indices(shared)) {
+      if (shared[i]->isCompatible(mode, windowBits)) {
+        auto context = zc::mv(shared[i]);
+        if (i + 1 < shared.size()) shared[i] = zc::mv(shared.back());
+        shared.removeLast();
+        // Whoever used it last left their state behind.
+        context->reset();
+        return ZlibContextLoan(zc::mv(context));
+      }
+    }
+    return ZlibContextLoan(zc::heap<ZlibContext>(mode, config));
+  }
 #endif  // ZC_HAS_ZLIB
 
   static constexpr byte OPCODE_CONTINUATION = 0;
@@ -3287,6 +3684,7 @@ private:
   zc::Own<zc::AsyncIoStream> stream;
   zc::Maybe<EntropySource&> maskKeyGenerator;
   zc::Maybe<CompressionParameters> compressionConfig;
+  WebSocketCompressionSettings compressionSettings;
   WebSocketErrorHandler& errorHandler;
 #if ZC_HAS_ZLIB
   zc::Maybe<ZlibContext> compressionContext;
@@ -3351,19 +3749,7 @@ private:
     ZC_REQUIRE(!currentlySending, "another message send is already in progress");
 
     currentlySending = true;
-
-    for (;;) {
-      ZC_IF_SOME(p, sendingControlMessage) {
-        // Re-check in case of disconnect on a previous loop iteration.
-        ZC_REQUIRE(!disconnected, "WebSocket can't send after disconnect()");
-
-        // We recently sent a control message; make sure it's finished before proceeding.
-        auto localPromise = zc::mv(p);
-        sendingControlMessage = zc::none;
-        co_await localPromise;
-      }
-      else { break; }
-    }
+    co_await waitForSendingControlMessage();
 
     // We don't stop the application from sending further messages after close() -- this is the
     // application's error to make. But, we do want to make sure we don't send any PONGs after a
@@ -3374,19 +3760,21 @@ private:
 
     bool useCompression = false;
     zc::Maybe<zc::Array<byte>> compressedMessage;
-    if (opcode == OPCODE_BINARY || opcode == OPCODE_TEXT) {
-      // We can only compress data frames.
+    if ((opcode == OPCODE_BINARY || opcode == OPCODE_TEXT) &&
+        message.size() >= compressionSettings.minMessageSize) {
+      // We can only compress data frames. Short ones aren't worth it; each message is compressed
+      // or not independently, so skipping one doesn't disturb the compressor's context.
 #if ZC_HAS_ZLIB
       ZC_IF_SOME(config, compressionConfig) {
         useCompression = true;
         // Compress `message` according to `compressionConfig`s outbound parameters.
-        auto& compressor = ZC_ASSERT_NONNULL(compressionContext);
+        auto compressor = getZlibContext(ZlibContext::Mode::COMPRESS, compressionContext, config);
         if (config.outboundNoContextTakeover) {
           // We must reset context on each message.
-          compressor.reset();
+          compressor->reset();
         }
 
-        ZC_SWITCH_ONEOF(compressor.processMessage(message)) {
+        ZC_SWITCH_ONEOF(compressor->processMessage(message)) {
           ZC_CASE_ONEOF(error, ProtocolError) {
             ZC_FAIL_REQUIRE("Error compressing websocket message: ", error.description);
           }
@@ -3410,10 +3798,16 @@ private:
 
     zc::Array<byte> ownMessage;
     if (!mask.isZero()) {
-      // Sadness, we have to make a copy to apply the mask.
-      ownMessage = zc::heapArray(message);
-      mask.apply(ownMessage);
-      message = ownMessage;
+      ZC_IF_SOME(compressed, compressedMessage) {
+        // The compressed message is our own copy already, so we can mask it in place.
+        mask.apply(compressed.first(message.size()));
+      }
+      else {
+        // Sadness, we have to make a copy to apply the mask.
+        ownMessage = zc::heapArray<byte>(message.size());
+        mask.copyTo(message, ownMessage);
+        message = ownMessage;
+      }
     }
 
     zc::ArrayPtr<const byte> sendParts[2];
@@ -3432,6 +3826,21 @@ private:
     ;
   }
 
+  zc::Promise<void> waitForSendingControlMessage() {
+    for (;;) {
+      ZC_IF_SOME(p, sendingControlMessage) {
+        // Re-check in case of disconnect on a previous loop iteration.
+        ZC_REQUIRE(!disconnected, "WebSocket can't send after disconnect()");
+
+        // We recently sent a control message; make sure it's finished before proceeding.
+        auto localPromise = zc::mv(p);
+        sendingControlMessage = zc::none;
+        co_await localPromise;
+      }
+      else { break; }
+    }
+  }
+
   void queueClose(uint16_t code, zc::StringPtr reason,
                   zc::Own<zc::PromiseFulfiller<void>> fulfiller) {
     bool alreadyWaiting = (queuedControlMessage != zc::none);
@@ -3581,12 +3990,14 @@ zc::Own<WebSocket> upgradeToWebSocket(zc::Own<zc::AsyncIoStream> stream,
                                       HttpInputStreamImpl& httpInput, HttpOutputStream& httpOutput,
                                       zc::Maybe<EntropySource&> maskKeyGenerator,
                                       zc::Maybe<CompressionParameters> compressionConfig = zc::none,
-                                      zc::Maybe<WebSocketErrorHandler&> errorHandler = zc::none) {
+                                      zc::Maybe<WebSocketErrorHandler&> errorHandler = zc::none,
+                                      WebSocketCompressionSettings compressionSettings = {}) {
   // Create a WebSocket upgraded from an HTTP stream.
   auto releasedBuffer = httpInput.releaseBuffer();
   return zc::heap<WebSocketImpl>(zc::mv(stream), maskKeyGenerator, zc::mv(compressionConfig),
-                                 errorHandler, zc::mv(releasedBuffer.buffer),
-                                 releasedBuffer.leftover, httpOutput.flush());
+                                 errorHandler, compressionSettings,
+                                 zc::mv(releasedBuffer.buffer), releasedBuffer.leftover,
+                                 httpOutput.flush());
 }
 
 }  // namespace
@@ -3594,9 +4005,10 @@ zc::Own<WebSocket> upgradeToWebSocket(zc::Own<zc::AsyncIoStream> stream,
 zc::Own<WebSocket> newWebSocket(zc::Own<zc::AsyncIoStream> stream,
                                 zc::Maybe<EntropySource&> maskKeyGenerator,
                                 zc::Maybe<CompressionParameters> compressionConfig,
-                                zc::Maybe<WebSocketErrorHandler&> errorHandler) {
+                                zc::Maybe<WebSocketErrorHandler&> errorHandler,
+                                WebSocketCompressionSettings compressionSettings) {
   return zc::heap<WebSocketImpl>(zc::mv(stream), maskKeyGenerator, zc::mv(compressionConfig),
-                                 errorHandler);
+                                 errorHandler, compressionSettings);
 }
 
 static zc::Promise<void> pumpWebSocketLoop(WebSocket& from, WebSocket& to) {
@@ -3644,6 +4056,50 @@ zc::Promise<void> WebSocket::pumpTo(WebSocket& other) {
 
 zc::Maybe<zc::Promise<void>> WebSocket::tryPumpFrom(WebSocket& other) { return zc::none; }
 
+zc::Promise<void> WebSocket::sendFrame(zc::Arc<WebSocketBroadcastFrame> frame) {
+  auto message = frame->getMessage();
+  auto promise = frame->isText() ? send(message.asChars()) : send(message);
+  return promise.attach(zc::mv(frame));
+}
+
+WebSocketBroadcastFrame::WebSocketBroadcastFrame(bool text, zc::ArrayPtr<const byte> message,
+                                                 zc::Maybe<CompressionParameters> compression)
+    : textMessage(text), frame(WebSocketImpl::encodeFrame(text, false, message)) {
+  ZC_IF_SOME(config, compression) {
+#if ZC_HAS_ZLIB
+    compressedFrame = WebSocketImpl::encodeCompressedFrame(text, message, config);
+    compressedWindowBits = config.outboundMaxWindowBits.orDefault(15);
+#else
+    (void)config;
+    ZC_FAIL_REQUIRE("WebSocket compression is only supported if ZC is compiled with Zlib.");
+#endif  // ZC_HAS_ZLIB
+  }
+}
+
+zc::Arc<WebSocketBroadcastFrame> WebSocketBroadcastFrame::text(
+    zc::ArrayPtr<const char> message, zc::Maybe<CompressionParameters> compression) {
+  return zc::arc<WebSocketBroadcastFrame>(true, message.asBytes(), zc::mv(compression));
+}
+
+zc::Arc<WebSocketBroadcastFrame> WebSocketBroadcastFrame::binary(
+    zc::ArrayPtr<const byte> message, zc::Maybe<CompressionParameters> compression) {
+  return zc::arc<WebSocketBroadcastFrame>(false, message, zc::mv(compression));
+}
+
+WebSocketBroadcastFrame::Encoding WebSocketBroadcastFrame::getEncoding(
+    zc::Maybe<const CompressionParameters&> compression) const {
+  bool compressed = false;
+  ZC_IF_SOME(config, compression) {
+    compressed = compressedFrame != nullptr && config.outboundNoContextTakeover &&
+                 config.outboundMaxWindowBits.orDefault(15) >= compressedWindowBits;
+  }
+
+  auto& bytes = compressed ? compressedFrame : frame;
+  // The frames are unmasked, so the 7-bit length alone tells how long the header is.
+  size_t headerSize = bytes[1] == 127 ? 10 : bytes[1] == 126 ? 4 : 2;
+  return {.frame = bytes, .payload = bytes.slice(headerSize), .compressed = compressed};
+}
+
 namespace {
 
 class WebSocketPipeImpl final : public WebSocket, public zc::Refcounted {
@@ -4309,6 +4765,131 @@ WebSocketPipe newWebSocketPipe() {
   return {{zc::mv(end1), zc::mv(end2)}};
 }
 
+// =======================================================================================
+
+class WebSocketSendQueue::Impl {
+public:
+  using Message = zc::OneOf<zc::Array<byte>, zc::String, zc::Arc<WebSocketBroadcastFrame>>;
+
+  Impl(WebSocket& webSocket, WebSocketSendQueueOptions options)
+      : webSocket(webSocket), options(options) {
+    ZC_REQUIRE(options.lowWatermark <= options.highWatermark,
+               "low watermark can't be above high watermark");
+    sendLoop = sendNext().eagerlyEvaluate([this](zc::Exception&& e) { fail(zc::mv(e)); });
+  }
+
+  bool add(Message message, uint64_t size) {
+    ZC_IF_SOME(e, error) { zc::throwFatalException(zc::cp(e)); }
+
+    queue.push_back(zc::mv(message));
+    sizes.push_back(size);
+    queuedBytes += size;
+    ZC_IF_SOME(fulfiller, moreMessages) { fulfiller->fulfill(); }
+    moreMessages = zc::none;
+
+    return queuedBytes <= options.highWatermark;
+  }
+
+  uint64_t getQueuedBytes() const { return queuedBytes; }
+  size_t getQueuedMessages() const { return queue.size(); }
+
+  zc::Promise<void> whenWritable() {
+    return wait(writableWaiters, queuedBytes <= options.lowWatermark);
+  }
+
+  zc::Promise<void> whenDrained() { return wait(drainedWaiters, queue.empty()); }
+
+private:
+  WebSocket& webSocket;
+  WebSocketSendQueueOptions options;
+  std::deque<Message> queue;
+  std::deque<uint64_t> sizes;
+  uint64_t queuedBytes = 0;
+  zc::Maybe<zc::Exception> error;
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> moreMessages;
+  zc::Vector<zc::Own<zc::PromiseFulfiller<void>>> writableWaiters;
+  zc::Vector<zc::Own<zc::PromiseFulfiller<void>>> drainedWaiters;
+  zc::Promise<void> sendLoop = nullptr;
+  // Declared last, so that it's canceled before the rest goes away.
+
+  zc::Promise<void> wait(zc::Vector<zc::Own<zc::PromiseFulfiller<void>>>& waiters, bool ready) {
+    ZC_IF_SOME(e, error) { return zc::cp(e); }
+    if (ready) { return zc::READY_NOW; }
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    waiters.add(zc::mv(paf.fulfiller));
+    return zc::mv(paf.promise);
+  }
+
+  static void wake(zc::Vector<zc::Own<zc::PromiseFulfiller<void>>>& waiters) {
+    for (auto& waiter : waiters) { waiter->fulfill(); }
+    waiters.clear();
+  }
+
+  zc::Promise<void> sendNext() {
+    if (queue.empty()) {
+      auto paf = zc::newPromiseAndFulfiller<void>();
+      moreMessages = zc::mv(paf.fulfiller);
+      return paf.promise.then([this]() { return sendNext(); });
+    }
+
+    return sendFront().then([this]() {
+      queuedBytes -= sizes.front();
+      queue.pop_front();
+      sizes.pop_front();
+      if (queuedBytes <= options.lowWatermark) { wake(writableWaiters); }
+      if (queue.empty()) { wake(drainedWaiters); }
+      return sendNext();
+    });
+  }
+
+  zc::Promise<void> sendFront() {
+    ZC_SWITCH_ONEOF(queue.front()) {
+      ZC_CASE_ONEOF(bytes, zc::Array<byte>) { return webSocket.send(bytes.asPtr()); }
+      ZC_CASE_ONEOF(text, zc::String) { return webSocket.send(text.asArray()); }
+      ZC_CASE_ONEOF(frame, zc::Arc<WebSocketBroadcastFrame>) {
+        return webSocket.sendFrame(frame.addRef());
+      }
+    }
+    ZC_UNREACHABLE;
+  }
+
+  void fail(zc::Exception&& e) {
+    // Nothing more will be sent, so drop what's queued and hand the error to whoever's waiting.
+    queue.clear();
+    sizes.clear();
+    queuedBytes = 0;
+    for (auto& waiter : writableWaiters) { waiter->reject(zc::cp(e)); }
+    writableWaiters.clear();
+    for (auto& waiter : drainedWaiters) { waiter->reject(zc::cp(e)); }
+    drainedWaiters.clear();
+    error = zc::mv(e);
+  }
+};
+
+WebSocketSendQueue::WebSocketSendQueue(WebSocket& webSocket, WebSocketSendQueueOptions options)
+    : impl(zc::heap<Impl>(webSocket, options)) {}
+WebSocketSendQueue::~WebSocketSendQueue() noexcept(false) {}
+
+bool WebSocketSendQueue::send(zc::Array<byte> message) {
+  auto size = message.size();
+  return impl->add(zc::mv(message), size);
+}
+
+bool WebSocketSendQueue::send(zc::String message) {
+  auto size = message.size();
+  return impl->add(zc::mv(message), size);
+}
+
+bool WebSocketSendQueue::sendFrame(zc::Arc<WebSocketBroadcastFrame> frame) {
+  auto size = frame->getMessage().size();
+  return impl->add(zc::mv(frame), size);
+}
+
+uint64_t WebSocketSendQueue::getQueuedBytes() const { return impl->getQueuedBytes(); }
+size_t WebSocketSendQueue::getQueuedMessages() const { return impl->getQueuedMessages(); }
+zc::Promise<void> WebSocketSendQueue::whenWritable() { return impl->whenWritable(); }
+zc::Promise<void> WebSocketSendQueue::whenDrained() { return impl->whenDrained(); }
+
 // =======================================================================================
 class AsyncIoStreamWithInitialBuffer final : public zc::AsyncIoStream {
   // An AsyncIoStream implementation that accepts an initial buffer of data
@@ -5088,6 +5669,17 @@ public:
     return !upgraded && !closed && httpInput.canReuse() && httpOutput.canReuse();
   }
 
+  void setClosedWhileIdleCallback(zc::Function<void()> callback) {
+    // Arranges for `callback` to be called if the server closes the connection while no request
+    // is using it. That's watched for after every response.
+    onClosedWhileIdle = zc::mv(callback);
+  }
+
+  void watchForCloseBeforeFirstRequest() {
+    // Watches a connection that hasn't been used yet the same way.
+    if (counter == 0 && closeWatcherTask == zc::none) watchForClose();
+  }
+
   Request request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
                   zc::Maybe<uint64_t> expectedBodySize = zc::none) override {
     ZC_REQUIRE(
@@ -5131,7 +5723,14 @@ public:
       }
     }
 
-    httpOutput.writeHeaders(headers.serializeRequest(method, url, connectionHeaders));
+    bool borrowed = headers.isBorrowed();
+    if (borrowed) {
+      // Write the headers in place. The length is the only connection header not a literal.
+      httpOutput.writeHeaders(headers.serializeRequestPieces(method, url, connectionHeaders),
+                              zc::mv(lengthStr));
+    } else {
+      httpOutput.writeHeaders(headers.serializeRequest(method, url, connectionHeaders));
+    }
 
     zc::Own<zc::AsyncOutputStream> bodyStream;
     if (!hasBody) {
@@ -5142,7 +5741,7 @@ public:
       ZC_IF_SOME(s, expectedBodySize) {
         bodyStream = heap<HttpFixedLengthEntityWriter>(httpOutput, s);
       }
-    else { bodyStream = heap<HttpChunkedEntityWriter>(httpOutput); }
+    else { bodyStream = heap<HttpChunkedEntityWriter>(httpOutput, settings.minChunkSize); }
 
     auto id = ++counter;
 
@@ -5178,6 +5777,17 @@ public:
           ZC_UNREACHABLE;
         });
 
+    if (borrowed) {
+      // The caller only keeps borrowed headers alive for as long as it waits for the response, so
+      // once it stops, a write still referencing them must not go on.
+      responsePromise = responsePromise.attach(zc::defer([this]() {
+        if (httpOutput.isBorrowedWritePending()) {
+          closed = true;
+          httpOutput.cancelBorrowedWrites();
+        }
+      }));
+    }
+
     return {zc::mv(bodyStream), zc::mv(responsePromise)};
   }
 
@@ -5308,7 +5918,8 @@ public:
                     &httpInput.getHeaders(),
                     upgradeToWebSocket(zc::mv(ownStream), httpInput, httpOutput,
                                        settings.entropySource, zc::mv(compressionParameters),
-                                       settings.webSocketErrorHandler),
+                                       settings.webSocketErrorHandler,
+                                       settings.webSocketCompressionSettings),
                 };
               } else {
                 upgraded = false;
@@ -5418,6 +6029,7 @@ private:
   zc::Own<AsyncIoStream> ownStream;
   HttpClientSettings settings;
   zc::Maybe<zc::Promise<void>> closeWatcherTask;
+  zc::Maybe<zc::Function<void()>> onClosedWhileIdle;
   bool upgraded = false;
   bool closed = false;
 
@@ -5450,16 +6062,12 @@ private:
                                } else {
                                  return httpOutput.flush().then([this]() {
                                    // We might be sitting in NetworkAddressHttpClient's
-                                   // `availableClients` pool. We don't have a way to notify it to
-                                   // remove this client from the pool; instead, when it tries to
-                                   // pull this client from the pool later, it will notice the
-                                   // client is dead and will discard it then. But, we would like to
-                                   // avoid holding on to a socket forever. So, destroy the socket
-                                   // now.
-                                   // TODO(cleanup): Maybe we should arrange to proactively remove
-                                   // ourselves? Seems
-                                   //   like the code will be awkward.
+                                   // `availableClients` pool. It can't destroy us from within
+                                   // this callback, so it only schedules a sweep of the pool
+                                   // when told; in any case, we would like to avoid holding on
+                                   // to a socket forever. So, destroy the socket now.
                                    ownStream = nullptr;
+                                   ZC_IF_SOME(callback, onClosedWhileIdle) { callback(); }
                                  });
                                }
                              }
@@ -5654,7 +6262,21 @@ public:
       : timer(timer),
         responseHeaderTable(responseHeaderTable),
         address(zc::mv(address)),
-        settings(zc::mv(settings)) {}
+        settings(zc::mv(settings)),
+        unlimited(*this) {
+    if (this->settings.maxConnections != uint(zc::maxValue)) {
+      limiter = newConcurrencyLimitingHttpClient(
+          unlimited, this->settings.maxConnections, [this](uint running, uint pending) {
+            ZC_IF_SOME(stats, this->settings.stats) {
+              if (pending > pendingRequestCount) {
+                stats.requestsQueued += pending - pendingRequestCount;
+              }
+            }
+            pendingRequestCount = pending;
+          });
+    }
+    preconnect();
+  }
 
   bool isDrained() {
     // Returns true if there are no open connections.
@@ -5670,45 +6292,20 @@ public:
 
   Request request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
                   zc::Maybe<uint64_t> expectedBodySize = zc::none) override {
-    auto refcounted = getClient();
-    auto result = refcounted->client->request(method, url, headers, expectedBodySize);
-    result.body = result.body.attach(zc::addRef(*refcounted));
-    result.response =
-        result.response.then([refcounted = zc::mv(refcounted)](Response&& response) mutable {
-          response.body = response.body.attach(zc::mv(refcounted));
-          return zc::mv(response);
-        });
-    return result;
+    ZC_IF_SOME(l, limiter) { return l->request(method, url, headers, expectedBodySize); }
+    return requestNow(method, url, headers, expectedBodySize);
   }
 
   zc::Promise<WebSocketResponse> openWebSocket(zc::StringPtr url,
                                                const HttpHeaders& headers) override {
-    auto refcounted = getClient();
-    auto result = refcounted->client->openWebSocket(url, headers);
-    return result.then([refcounted = zc::mv(refcounted)](WebSocketResponse&& response) mutable {
-      ZC_SWITCH_ONEOF(response.webSocketOrBody) {
-        ZC_CASE_ONEOF(body, zc::Own<zc::AsyncInputStream>) {
-          response.webSocketOrBody = body.attach(zc::mv(refcounted));
-        }
-        ZC_CASE_ONEOF(ws, zc::Own<WebSocket>) {
-          // The only reason we need to attach the client to the WebSocket is because otherwise
-          // the response headers will be deleted prematurely. Otherwise, the WebSocket has taken
-          // ownership of the connection.
-          //
-          // TODO(perf): Maybe we could transfer ownership of the response headers specifically?
-          response.webSocketOrBody = ws.attach(zc::mv(refcounted));
-        }
-      }
-      return zc::mv(response);
-    });
+    ZC_IF_SOME(l, limiter) { return l->openWebSocket(url, headers); }
+    return openWebSocketNow(url, headers);
   }
 
   ConnectRequest connect(zc::StringPtr host, const HttpHeaders& headers,
                          HttpConnectSettings settings) override {
-    auto refcounted = getClient();
-    auto request = refcounted->client->connect(host, headers, settings);
-    return ConnectRequest{request.status.attach(zc::addRef(*refcounted)),
-                          request.connection.attach(zc::mv(refcounted))};
+    ZC_IF_SOME(l, limiter) { return l->connect(host, headers, settings); }
+    return connectNow(host, headers, settings);
   }
 
 private:
@@ -5729,6 +6326,38 @@ private:
   };
 
   std::deque<AvailableClient> availableClients;
+  // Ordered by `expires`, which is also the order the clients became idle in.
+
+  bool sweepScheduled = false;
+  zc::Promise<void> sweepTask = nullptr;
+  zc::Promise<void> preconnectTask = nullptr;
+
+  class Unlimited final : public HttpClient {
+    // What `limiter` wraps: makes requests without regard to `maxConnections`.
+  public:
+    Unlimited(NetworkAddressHttpClient& parent) : parent(parent) {}
+
+    Request request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                    zc::Maybe<uint64_t> expectedBodySize = zc::none) override {
+      return parent.requestNow(method, url, headers, expectedBodySize);
+    }
+    zc::Promise<WebSocketResponse> openWebSocket(zc::StringPtr url,
+                                                 const HttpHeaders& headers) override {
+      return parent.openWebSocketNow(url, headers);
+    }
+    ConnectRequest connect(zc::StringPtr host, const HttpHeaders& headers,
+                           HttpConnectSettings settings) override {
+      return parent.connectNow(host, headers, settings);
+    }
+
+  private:
+    NetworkAddressHttpClient& parent;
+  };
+
+  Unlimited unlimited;
+  zc::Maybe<zc::Own<HttpClient>> limiter;
+  // Queues requests beyond `maxConnections`, if that's set.
+  uint pendingRequestCount = 0;
 
   struct RefcountedClient final : public zc::Refcounted {
     RefcountedClient(NetworkAddressHttpClient& parent, zc::Own<HttpClientImpl> client)
@@ -5747,25 +6376,128 @@ private:
     zc::Own<HttpClientImpl> client;
   };
 
+  Request requestNow(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                     zc::Maybe<uint64_t> expectedBodySize) {
+    auto refcounted = getClient();
+    auto result = refcounted->client->request(method, url, headers, expectedBodySize);
+    result.body = result.body.attach(zc::addRef(*refcounted));
+    result.response =
+        result.response.then([refcounted = zc::mv(refcounted)](Response&& response) mutable {
+          response.body = response.body.attach(zc::mv(refcounted));
+          return zc::mv(response);
+        });
+    return result;
+  }
+
+  zc::Promise<WebSocketResponse> openWebSocketNow(zc::StringPtr url, const HttpHeaders& headers) {
+    auto refcounted = getClient();
+    auto result = refcounted->client->openWebSocket(url, headers);
+    return result.then([refcounted = zc::mv(refcounted)](WebSocketResponse&& response) mutable {
+      ZC_SWITCH_ONEOF(response.webSocketOrBody) {
+        ZC_CASE_ONEOF(body, zc::Own<zc::AsyncInputStream>) {
+          response.webSocketOrBody = body.attach(zc::mv(refcounted));
+        }
+        ZC_CASE_ONEOF(ws, zc::Own<WebSocket>) {
+          // The only reason we need to attach the client to the WebSocket is because otherwise
+          // the response headers will be deleted prematurely. Otherwise, the WebSocket has taken
+          // ownership of the connection.
+          //
+          // TODO(perf): Maybe we could transfer ownership of the response headers specifically?
+          response.webSocketOrBody = ws.attach(zc::mv(refcounted));
+        }
+      }
+      return zc::mv(response);
+    });
+  }
+
+  ConnectRequest connectNow(zc::StringPtr host, const HttpHeaders& headers,
+                            HttpConnectSettings settings) {
+    auto refcounted = getClient();
+    auto request = refcounted->client->connect(host, headers, settings);
+    return ConnectRequest{request.status.attach(zc::addRef(*refcounted)),
+                          request.connection.attach(zc::mv(refcounted))};
+  }
+
   zc::Own<RefcountedClient> getClient() {
     for (;;) {
       if (availableClients.empty()) {
-        auto stream = newPromisedStream(address->connect());
-        return zc::refcounted<RefcountedClient>(
-            *this, zc::heap<HttpClientImpl>(responseHeaderTable, zc::mv(stream), settings));
+        return zc::refcounted<RefcountedClient>(*this, newClient(newPromisedStream(openStream())));
       } else {
-        auto client = zc::mv(availableClients.back().client);
-        availableClients.pop_back();
-        if (client->canReuse()) { return zc::refcounted<RefcountedClient>(*this, zc::mv(client)); }
+        zc::Own<HttpClientImpl> client;
+        if (settings.connectionReusePolicy == HttpClientSettings::FIFO) {
+          client = zc::mv(availableClients.front().client);
+          availableClients.pop_front();
+        } else {
+          client = zc::mv(availableClients.back().client);
+          availableClients.pop_back();
+        }
+        if (client->canReuse()) {
+          ZC_IF_SOME(stats, settings.stats) { ++stats.connectionsReused; }
+          return zc::refcounted<RefcountedClient>(*this, zc::mv(client));
+        }
         // Whoops, this client's connection was closed by the server at some point. Discard.
+        countIdleClosed(1);
       }
     }
   }
 
+  zc::Promise<zc::Own<zc::AsyncIoStream>> openStream() {
+    ZC_IF_SOME(stats, settings.stats) {
+      return address->connect().then(
+          [&stats, &timer = timer, start = timer.now()](zc::Own<zc::AsyncIoStream> stream) {
+            ++stats.connectionsOpened;
+            stats.connectTime += timer.now() - start;
+            return zc::mv(stream);
+          },
+          [&stats](zc::Exception&& e) -> zc::Own<zc::AsyncIoStream> {
+            ++stats.connectFailures;
+            zc::throwFatalException(zc::mv(e));
+          });
+    }
+    return address->connect();
+  }
+
+  zc::Own<HttpClientImpl> newClient(zc::Own<zc::AsyncIoStream> stream) {
+    auto client = zc::heap<HttpClientImpl>(responseHeaderTable, zc::mv(stream), settings);
+    client->setClosedWhileIdleCallback([this]() { scheduleSweep(); });
+    return client;
+  }
+
+  void preconnect() {
+    if (settings.preconnectCount == 0 || settings.maxIdleConnections == 0 ||
+        settings.idleTimeout <= 0 * zc::SECONDS) {
+      return;
+    }
+
+    auto promises = zc::heapArrayBuilder<zc::Promise<void>>(settings.preconnectCount);
+    for (uint i = 0; i < settings.preconnectCount; i++) {
+      promises.add(openStream().then(
+          [this](zc::Own<zc::AsyncIoStream> stream) {
+            auto client = newClient(zc::mv(stream));
+            client->watchForCloseBeforeFirstRequest();
+            returnClientToAvailable(zc::mv(client));
+          },
+          [](zc::Exception&& e) {
+            // Never mind: requests will connect for themselves, and report the error if it
+            // happens again.
+          }));
+    }
+    preconnectTask = zc::joinPromises(promises.finish()).eagerlyEvaluate(nullptr);
+  }
+
+  void countIdleClosed(size_t count) {
+    ZC_IF_SOME(stats, settings.stats) { stats.idleConnectionsClosed += count; }
+  }
+
   void returnClientToAvailable(zc::Own<HttpClientImpl> client) {
     // Only return the connection to the pool if it is reusable and if our settings indicate we
     // should reuse connections.
-    if (client->canReuse() && settings.idleTimeout > 0 * zc::SECONDS) {
+    if (client->canReuse() && settings.idleTimeout > 0 * zc::SECONDS &&
+        settings.maxIdleConnections > 0) {
+      if (availableClients.size() >= settings.maxIdleConnections) {
+        availableClients.pop_front();
+        countIdleClosed(1);
+      }
       availableClients.push_back(
           AvailableClient{zc::mv(client), timer.now() + settings.idleTimeout});
     }
@@ -5777,6 +6509,23 @@ private:
     }
   }
 
+  void scheduleSweep() {
+    // Called when the server closes an idle connection. The client that noticed can't be
+    // destroyed from within its own callback, so it's removed from the pool on a later turn.
+    if (sweepScheduled) return;
+    sweepScheduled = true;
+    sweepTask = zc::evalLater([this]() {
+                  sweepScheduled = false;
+                  countIdleClosed(std::erase_if(availableClients, [](AvailableClient& available) {
+                    return !available.client->canReuse();
+                  }));
+
+                  // Rearm the timeouts, which also signals onDrained() if the pool is now empty.
+                  timeoutsScheduled = true;
+                  timeoutTask = applyTimeouts();
+                }).eagerlyEvaluate(nullptr);
+  }
+
   zc::Promise<void> applyTimeouts() {
     if (availableClients.empty()) {
       timeoutsScheduled = false;
@@ -5792,6 +6541,7 @@ private:
       return timer.atTime(time).then([this, time]() {
         while (!availableClients.empty() && availableClients.front().expires <= time) {
           availableClients.pop_front();
+          countIdleClosed(1);
         }
         return applyTimeouts();
       });
@@ -6967,6 +7717,127 @@ zc::Promise<void> HttpService::connect(zc::StringPtr host, const HttpHeaders& he
   ZC_UNIMPLEMENTED("CONNECT is not implemented by this HttpService");
 }
 
+class HttpServer::AdmissionControl {
+  // Enforces HttpServerSettings::maxConcurrentRequests, queuing requests past the limit, and
+  // shedding them when the queue stands. The shedding follows CoDel as adapted to request queues
+  // by e.g. Folly's Codel: rather than dropping packets at a controlled rate, we turn away requests
+  // that waited over twice the target for as long as the queue is judged to be standing.
+
+public:
+  explicit AdmissionControl(HttpServer& server) : server(server) {}
+
+  class Slot {
+    // A request's place among the maxConcurrentRequests. Destroying it lets in the next in line.
+
+  public:
+    explicit Slot(AdmissionControl& control) : control(control) { ++control.inFlight; }
+    ~Slot() noexcept(false) { control.release(); }
+    ZC_DISALLOW_COPY_AND_MOVE(Slot);
+
+  private:
+    AdmissionControl& control;
+  };
+
+  zc::Promise<zc::Maybe<zc::Own<Slot>>> admit() {
+    // Resolves to none if the request is turned away.
+
+    auto& settings = server.settings;
+    auto now = server.timer.now();
+    if (inFlight < settings.maxConcurrentRequests) {
+      shouldShed(0 * zc::SECONDS, now);
+      admitted(0 * zc::SECONDS);
+      return zc::Maybe<zc::Own<Slot>>(zc::heap<Slot>(*this));
+    }
+
+    if (settings.maxQueueTime <= 0 * zc::SECONDS) {
+      rejected(HttpServerCallbacks::Rejection::QUEUE_TIMEOUT);
+      return zc::Maybe<zc::Own<Slot>>(zc::none);
+    }
+    if (overloaded && now < intervalEnd) {
+      // Queuing would only make the request late, and everyone behind it later. Once the interval
+      // is over, though, the request should queue to find out whether the queue still stands.
+      rejected(HttpServerCallbacks::Rejection::OVERLOADED);
+      return zc::Maybe<zc::Own<Slot>>(zc::none);
+    }
+
+    return zc::newAdaptedPromise<zc::Maybe<zc::Own<Slot>>, Waiter>(*this, now)
+        .exclusiveJoin(server.timer.afterDelay(settings.maxQueueTime)
+                           .then([this]() -> zc::Maybe<zc::Own<Slot>> {
+                             rejected(HttpServerCallbacks::Rejection::QUEUE_TIMEOUT);
+                             return zc::none;
+                           }));
+  }
+
+  void rejected(HttpServerCallbacks::Rejection reason) {
+    ZC_IF_SOME(callbacks, server.settings.callbacks) { callbacks.requestRejected(reason); }
+  }
+
+private:
+  class Waiter {
+  public:
+    Waiter(zc::PromiseFulfiller<zc::Maybe<zc::Own<Slot>>>& fulfiller, AdmissionControl& control,
+           zc::TimePoint since)
+        : fulfiller(fulfiller), control(control), since(since) {
+      control.queue.add(*this);
+    }
+    ~Waiter() noexcept(false) {
+      if (link.isLinked()) { control.queue.remove(*this); }
+    }
+    ZC_DISALLOW_COPY_AND_MOVE(Waiter);
+
+    zc::PromiseFulfiller<zc::Maybe<zc::Own<Slot>>>& fulfiller;
+    AdmissionControl& control;
+    zc::TimePoint since;
+    zc::ListLink<Waiter> link;
+  };
+
+  HttpServer& server;
+  uint inFlight = 0;
+  zc::List<Waiter, &Waiter::link> queue;
+
+  bool overloaded = false;
+  zc::TimePoint intervalEnd = zc::origin<zc::TimePoint>();
+  zc::Duration minDelay = 0 * zc::SECONDS;
+  // The shortest time a request waited in the current interval.
+
+  void release() {
+    --inFlight;
+
+    auto now = server.timer.now();
+    while (!queue.empty() && inFlight < server.settings.maxConcurrentRequests) {
+      auto& waiter = queue.front();
+      queue.remove(waiter);
+
+      auto delay = now - waiter.since;
+      if (shouldShed(delay, now)) {
+        rejected(HttpServerCallbacks::Rejection::OVERLOADED);
+        waiter.fulfiller.fulfill(zc::none);
+      } else {
+        admitted(delay);
+        waiter.fulfiller.fulfill(zc::heap<Slot>(*this));
+      }
+    }
+  }
+
+  bool shouldShed(zc::Duration delay, zc::TimePoint now) {
+    auto target = server.settings.queueDelayTarget;
+    if (target <= 0 * zc::SECONDS) { return false; }
+
+    if (now >= intervalEnd) {
+      overloaded = minDelay > target;
+      minDelay = delay;
+      intervalEnd = now + server.settings.queueDelayInterval;
+    } else {
+      minDelay = zc::min(minDelay, delay);
+    }
+    return overloaded && delay > 2 * target;
+  }
+
+  void admitted(zc::Duration queueTime) {
+    ZC_IF_SOME(callbacks, server.settings.callbacks) { callbacks.requestAdmitted(queueTime); }
+  }
+};
+
 class HttpServer::Connection final : private HttpService::Response,
                                      private HttpService::ConnectResponse,
                                      private HttpServerErrorHandler {
@@ -7060,6 +7931,10 @@ private:
   zc::Maybe<zc::Promise<LoopResult>> tunnelRejected;
   zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> tunnelWriteGuard;
 
+  double requestTokens = 0;
+  zc::Maybe<zc::TimePoint> lastRequestTime;
+  // For settings.connectionRequestRate: a token bucket, filled at the rate up to the burst.
+
   static HttpInputStreamImpl makeHttpInput(zc::AsyncIoStream& stream,
                                            const zc::HttpHeaderTable& table,
                                            zc::Maybe<SuspendedRequest> suspendedRequest) {
@@ -7087,7 +7962,8 @@ private:
       if (!firstRequest) {
         // For requests after the first, require that the first byte arrive before the pipeline
         // timeout, otherwise treat it like the connection was simply closed.
-        auto timeoutPromise = server.timer.afterDelay(server.settings.pipelineTimeout);
+        auto timeoutPromise = server.timer.afterDelayCoarse(server.settings.pipelineTimeout,
+                                                            server.settings.timeoutSlack);
 
         if (httpInput.isCleanDrain()) {
           // If we haven't buffered any data, then we can safely drain here, so allow the wait to
@@ -7132,7 +8008,9 @@ private:
                 // On requests other than the first, the header timeout starts ticking when we
                 // receive the first byte of a pipeline response.
                 readHeaders = readHeaders.exclusiveJoin(
-                    server.timer.afterDelay(server.settings.headerTimeout)
+                    server.timer
+                        .afterDelayCoarse(server.settings.headerTimeout,
+                                          server.settings.timeoutSlack)
                         .then([this]() -> HttpHeaders::RequestConnectOrProtocolError {
                           timedOut = true;
                           return HttpHeaders::ProtocolError{
@@ -7158,7 +8036,9 @@ private:
         // NOTE: Since we assume that the client wouldn't have formed a connection if they did not
         //   intend to send a request, we immediately treat this connection as having an active
         //   request, i.e. we do NOT cancel it if drain() is called.
-        auto timeoutPromise = server.timer.afterDelay(server.settings.headerTimeout)
+        auto timeoutPromise = server.timer
+                                  .afterDelayCoarse(server.settings.headerTimeout,
+                                                    server.settings.timeoutSlack)
                                   .then([this]() -> HttpHeaders::RequestConnectOrProtocolError {
                                     timedOut = true;
                                     return HttpHeaders::ProtocolError{
@@ -7300,11 +8180,37 @@ private:
     co_return BREAK_LOOP_CONN_ERR;
   }
 
+  bool takeRequestToken() {
+    auto& settings = server.settings;
+    if (settings.connectionRequestRate == 0) { return true; }
+
+    auto now = server.timer.now();
+    ZC_IF_SOME(last, lastRequestTime) {
+      double nanoseconds = (now - last) / zc::NANOSECONDS;
+      requestTokens += nanoseconds * settings.connectionRequestRate / 1e9;
+      requestTokens = zc::min(requestTokens, double(settings.connectionRequestBurst));
+    }
+    else { requestTokens = settings.connectionRequestBurst; }
+    lastRequestTime = now;
+
+    if (requestTokens < 1) { return false; }
+    requestTokens -= 1;
+    return true;
+  }
+
   zc::Promise<LoopResult> onRequest(HttpHeaders::Request& request) {
     auto& headers = httpInput.getHeaders();
 
     currentMethod = request.method;
 
+    if (!takeRequestToken()) {
+      ZC_IF_SOME(callbacks, server.settings.callbacks) {
+        callbacks.requestRejected(HttpServerCallbacks::Rejection::RATE_LIMITED);
+      }
+      co_return co_await sendError(HttpHeaders::ProtocolError{
+          429, "Too Many Requests", "Too many requests on this connection.", nullptr});
+    }
+
     SuspendableRequest suspendable(*this, request.method, request.url, headers);
     auto maybeService = factory(suspendable);
 
@@ -7314,6 +8220,15 @@ private:
         ZC_ASSERT_NONNULL(zc::mv(maybeService),
                           "SuspendableHttpServiceFactory did not suspend, but returned zc::none.");
 
+    zc::Maybe<zc::Own<AdmissionControl::Slot>> slot;
+    ZC_IF_SOME(admission, server.admission) {
+      slot = co_await admission->admit();
+      if (slot == zc::none) {
+        co_return co_await sendError(HttpHeaders::ProtocolError{
+            503, "Service Unavailable", "The server is overloaded.", nullptr});
+      }
+    }
+
     // TODO(perf): If the client disconnects, should we cancel the response? Probably, to
     //   prevent permanent deadlock. It's slightly weird in that arguably the client should
     //   be able to shutdown the upstream but still wait on the downstream, but I believe many
@@ -7323,6 +8238,7 @@ private:
 
     co_await service->request(request.method, request.url, headers, *body, *this)
         .attach(zc::mv(service));
+    slot = zc::none;
     // Response done. Await next request.
 
     ZC_IF_SOME(p, webSocketError) {
@@ -7509,7 +8425,7 @@ private:
       return heap<HttpNullEntityWriter>();
     } else
       ZC_IF_SOME(s, expectedBodySize) { return heap<HttpFixedLengthEntityWriter>(httpOutput, s); }
-    else { return heap<HttpChunkedEntityWriter>(httpOutput); }
+    else { return heap<HttpChunkedEntityWriter>(httpOutput, server.settings.minChunkSize); }
   }
 
   zc::Own<WebSocket> acceptWebSocket(const HttpHeaders& headers) override {
@@ -7589,7 +8505,8 @@ private:
     zc::Own<zc::AsyncIoStream> ownStream(&stream, zc::NullDisposer::instance);
     return upgradeToWebSocket(ownStream.attach(zc::mv(deferNoteClosed)), httpInput, httpOutput,
                               zc::none, zc::mv(acceptedParameters),
-                              server.settings.webSocketErrorHandler);
+                              server.settings.webSocketErrorHandler,
+                              server.settings.webSocketCompressionSettings);
   }
 
   zc::Promise<LoopResult> sendError(HttpHeaders::ProtocolError protocolError) {
@@ -7708,7 +8625,13 @@ HttpServer::HttpServer(zc::Timer& timer, const HttpHeaderTable& requestHeaderTab
       settings(settings),
       onDrain(paf.promise.fork()),
       drainFulfiller(zc::mv(paf.fulfiller)),
-      tasks(*this) {}
+      tasks(*this) {
+  if (this->settings.maxConcurrentRequests > 0) {
+    admission = zc::heap<AdmissionControl>(*this);
+  }
+}
+
+HttpServer::~HttpServer() noexcept(false) {}
 
 zc::Promise<void> HttpServer::drain() {
   ZC_REQUIRE(!draining, "you can only call drain() once");
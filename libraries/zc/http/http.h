@@ -38,6 +38,7 @@
 #include "zc/core/debug.h"
 #include "zc/core/memory.h"
 #include "zc/core/one-of.h"
+#include "zc/core/refcount.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
 
@@ -307,6 +308,19 @@ public:
   // Creates a shallow clone of the HttpHeaders. The returned object references the same strings
   // as the original, owning none of them.
 
+  HttpHeaders borrow() const;
+  // Like cloneShallow(), but for forwarding the headers on, as a proxy does with the headers of a
+  // request it received. Overrides can be set on the result as usual, and only they are validated.
+  //
+  // HttpClient::request() writes borrowed headers straight from the strings they reference rather
+  // than serializing them into a new buffer, so unlike other headers, they and everything they
+  // reference must remain valid until the request's response has arrived or been canceled, not
+  // just until request() returns. A proxy forwarding a request from inside HttpService::request()
+  // gets this for free, since the received headers outlive that call. Canceling the response
+  // while the headers are still being written breaks the connection.
+
+  bool isBorrowed() const { return borrowed; }
+
   bool isWebSocket() const;
   // Convenience method that checks for the presence of the header `Upgrade: websocket`.
   //
@@ -452,6 +466,9 @@ public:
       zc::StringPtr authority, zc::ArrayPtr<const zc::StringPtr> connectionHeaders = nullptr) const;
   zc::String serializeResponse(uint statusCode, zc::StringPtr statusText,
                                zc::ArrayPtr<const zc::StringPtr> connectionHeaders = nullptr) const;
+  zc::Array<zc::ArrayPtr<const byte>> serializeRequestPieces(
+      HttpMethod method, zc::StringPtr url,
+      zc::ArrayPtr<const zc::StringPtr> connectionHeaders = nullptr) const;
   // **Most applications will not use these methods; they are called by the HTTP client and server
   // implementations.**
   //
@@ -462,6 +479,10 @@ public:
   // implementation, in the order specified by the ZC_HTTP_FOR_EACH_BUILTIN_HEADER macro. These
   // headers values override any corresponding header value in the HttpHeaders object. The
   // CONNECTION_HEADERS_COUNT constants below can help you construct this `connectionHeaders` array.
+  //
+  // serializeRequestPieces() produces the same bytes as serializeRequest(), but as pieces for a
+  // gather write that reference the header strings, `url`, and the `connectionHeaders` values
+  // rather than copying them.
 
   enum class BuiltinIndicesEnum {
 #define HEADER_ID(id, name) id,
@@ -496,6 +517,8 @@ private:
 
   zc::Vector<zc::Array<char>> ownedStrings;
 
+  bool borrowed = false;
+
   void addNoCheck(zc::StringPtr name, zc::StringPtr value);
 
   zc::StringPtr cloneToOwn(zc::StringPtr str);
@@ -618,6 +641,72 @@ struct CompressionParameters {
   zc::Maybe<size_t> inboundMaxWindowBits = zc::none;
 };
 
+struct WebSocketCompressionSettings {
+  // Local choices about how a WebSocket uses the compression it has negotiated. Unlike
+  // `CompressionParameters`, these aren't visible to the peer.
+
+  size_t minMessageSize = 0;
+  // Messages shorter than this are sent uncompressed. Deflating a short message saves little or
+  // nothing, and permessage-deflate lets each message choose.
+
+  bool shareContexts = false;
+  // If true, a direction for which `no_context_takeover` was negotiated doesn't keep its own zlib
+  // context -- its state is thrown away after every message anyway. Instead it borrows one for
+  // each message from a pool shared by all WebSockets on the thread, which saves a few hundred KiB
+  // of memory per WebSocket. Directions that do take over context are unaffected.
+};
+
+class WebSocketBroadcastFrame final : public zc::AtomicRefcounted {
+  // A message framed ahead of time, for sending the same message to many WebSockets with
+  // WebSocket::sendFrame(). On a WebSocket that doesn't mask its frames -- the server side of a
+  // connection -- the prepared frame is written as is, without framing, compressing or copying the
+  // message again. Client-side WebSockets must mask each frame with a fresh key, so they still copy
+  // the payload, but skip the compression.
+  //
+  // Frames never change once created, so one can be sent from any number of threads.
+
+public:
+  static zc::Arc<WebSocketBroadcastFrame> text(
+      zc::ArrayPtr<const char> message, zc::Maybe<CompressionParameters> compression = zc::none);
+  static zc::Arc<WebSocketBroadcastFrame> binary(
+      zc::ArrayPtr<const byte> message, zc::Maybe<CompressionParameters> compression = zc::none);
+  // Frames a text or binary message. If `compression` is given, the message is also compressed,
+  // on its own, with at most `compression.outboundMaxWindowBits`. The compressed frame is used on
+  // WebSockets that negotiated permessage-deflate with no context takeover in the sending
+  // direction and a window at least as large; any other WebSocket gets the uncompressed frame,
+  // since a message compressed without the WebSocket's own context can't be slipped in between
+  // messages compressed with it.
+
+  struct Encoding {
+    zc::ArrayPtr<const byte> frame;
+    // The whole frame, header and payload, unmasked.
+
+    zc::ArrayPtr<const byte> payload;
+    // The tail of `frame` following the header.
+
+    bool compressed;
+  };
+
+  Encoding getEncoding(zc::Maybe<const CompressionParameters&> compression) const;
+  // The frame to send on a WebSocket that negotiated `compression`, or none if it didn't
+  // negotiate permessage-deflate.
+
+  bool isText() const { return textMessage; }
+  zc::ArrayPtr<const byte> getMessage() const { return getEncoding(zc::none).payload; }
+
+private:
+  WebSocketBroadcastFrame(bool text, zc::ArrayPtr<const byte> message,
+                          zc::Maybe<CompressionParameters> compression);
+
+  bool textMessage;
+  zc::Array<byte> frame;
+  zc::Array<byte> compressedFrame;  // empty if not compressed
+  size_t compressedWindowBits = 0;
+
+  template <typename T, typename... Params>
+  friend zc::Arc<T> arc(Params&&... params);
+};
+
 class WebSocket {
   // Interface representincg an open WebSocket session.
   //
@@ -634,6 +723,10 @@ public:
   // Send a message (binary or text). The underlying buffer must remain valid, and you must not
   // call send() again, until the returned promise resolves.
 
+  virtual zc::Promise<void> sendFrame(zc::Arc<WebSocketBroadcastFrame> frame);
+  // Send a message framed ahead of time with WebSocketBroadcastFrame, subject to the same rules as
+  // send(). The default implementation passes the frame's message to send().
+
   virtual zc::Promise<void> close(uint16_t code, zc::StringPtr reason) = 0;
   // Send a Close message.
   //
@@ -1051,11 +1144,59 @@ public:
   // exception from being thrown.
 };
 
+struct HttpClientStats {
+  // Counters kept by the clients which automatically create new connections, when given one
+  // through HttpClientSettings::stats. They only ever go up, and cover every host the client talks
+  // to; sample them periodically to compute rates. The reuse rate is
+  // connectionsReused / (connectionsReused + connectionsOpened), and the mean connect latency is
+  // connectTime / connectionsOpened.
+
+  uint64_t connectionsOpened = 0;
+  uint64_t connectFailures = 0;
+
+  zc::Duration connectTime = 0 * zc::SECONDS;
+  // Total time spent establishing the connections counted in `connectionsOpened`.
+
+  uint64_t connectionsReused = 0;
+  // Requests sent on a connection taken from the idle pool.
+
+  uint64_t idleConnectionsClosed = 0;
+  // Idle connections closed because of `idleTimeout` or `maxIdleConnections`, or by the server.
+
+  uint64_t requestsQueued = 0;
+  // Requests that had to wait because `maxConnections` connections were already in use.
+};
+
 struct HttpClientSettings {
   zc::Duration idleTimeout = 5 * zc::SECONDS;
   // For clients which automatically create new connections, any connection idle for at least this
   // long will be closed. Set this to 0 to prevent connection reuse entirely.
 
+  uint maxIdleConnections = zc::maxValue;
+  // For clients which automatically create new connections, at most this many idle connections are
+  // kept to each host. When another becomes idle, the one that has been idle longest is closed.
+
+  uint maxConnections = zc::maxValue;
+  // For clients which automatically create new connections, at most this many requests are in
+  // flight to each host at once, and so at most this many connections are in use. Further
+  // requests wait, in order, for one to finish.
+
+  enum ConnectionReusePolicy {
+    LIFO,  // Reuse the most recently used idle connection, so surplus connections time out.
+    FIFO,  // Reuse the connection idle the longest, spreading requests across all of them.
+  };
+  ConnectionReusePolicy connectionReusePolicy = LIFO;
+
+  uint preconnectCount = 0;
+  // For clients which automatically create new connections, open this many connections to each
+  // host ahead of time -- when the client is created, or for a client that connects to any host,
+  // when a host is first requested -- and put them in the idle pool. They are subject to
+  // `idleTimeout` like any other idle connection.
+
+  zc::Maybe<HttpClientStats&> stats;
+  // If given, clients which automatically create new connections count their activity here. Must
+  // outlive the client.
+
   zc::Maybe<EntropySource&> entropySource = zc::none;
   // Must be provided in order to use `openWebSocket`. If you don't need WebSockets, this can be
   // omitted. The WebSocket protocol uses random values to avoid triggering flaws (including
@@ -1077,6 +1218,16 @@ struct HttpClientSettings {
   };
   WebSocketCompressionMode webSocketCompressionMode = NO_COMPRESSION;
 
+  WebSocketCompressionSettings webSocketCompressionSettings;
+  // Applies to WebSockets for which compression was negotiated.
+
+  size_t minChunkSize = 0;
+  // With chunked transfer encoding, body writes smaller than this are held back and sent together
+  // in one chunk once this many bytes have accumulated, or when the body ends, rather than each in
+  // a chunk of its own. This saves chunk headers and system calls for bodies written in many
+  // small pieces, at the cost of delaying them; leave it at 0 for streams whose readers want each
+  // piece right away, such as server-sent events.
+
   zc::Maybe<WebSocketErrorHandler&> webSocketErrorHandler = zc::none;
   // Customize exceptions thrown on WebSocket protocol errors.
 
@@ -1152,7 +1303,8 @@ zc::Own<HttpInputStream> newHttpInputStream(zc::AsyncInputStream& input,
 zc::Own<WebSocket> newWebSocket(zc::Own<zc::AsyncIoStream> stream,
                                 zc::Maybe<EntropySource&> maskEntropySource,
                                 zc::Maybe<CompressionParameters> compressionConfig = zc::none,
-                                zc::Maybe<WebSocketErrorHandler&> errorHandler = zc::none);
+                                zc::Maybe<WebSocketErrorHandler&> errorHandler = zc::none,
+                                WebSocketCompressionSettings compressionSettings = {});
 // Create a new WebSocket on top of the given stream. It is assumed that the HTTP -> WebSocket
 // upgrade handshake has already occurred (or is not needed), and messages can immediately be
 // sent and received on the stream. Normally applications would not call this directly.
@@ -1171,6 +1323,8 @@ zc::Own<WebSocket> newWebSocket(zc::Own<zc::AsyncIoStream> stream,
 //
 // `errorHandler` is an optional argument that lets callers throw custom exceptions for WebSocket
 // protocol errors.
+//
+// `compressionSettings` tunes how the compression in `compressionConfig`, if any, is applied.
 
 struct WebSocketPipe {
   zc::Own<WebSocket> ends[2];
@@ -1181,6 +1335,51 @@ WebSocketPipe newWebSocketPipe();
 // end. No buffering occurs -- a message send does not complete until a corresponding receive
 // accepts the message.
 
+struct WebSocketSendQueueOptions {
+  uint64_t highWatermark = 1u << 20;
+  // send() asks the producer to hold off once more than this many message bytes are queued.
+
+  uint64_t lowWatermark = 256u << 10;
+  // whenWritable() resolves once the queue has drained to this. Must be at most `highWatermark`.
+};
+
+class WebSocketSendQueue {
+  // Queues messages for a WebSocket, which otherwise takes one send() at a time, and keeps count
+  // of the bytes waiting, so that a producer outpacing a slow peer can throttle or batch rather
+  // than chain up promises without bound. As with a writable stream in Node.js, send() never
+  // blocks but returns false once the producer should wait for whenWritable().
+  //
+  // The WebSocket must outlive the queue, and mustn't be sent on other than through it while it
+  // exists. Destroying the queue cancels the send in progress and drops the rest.
+
+public:
+  explicit WebSocketSendQueue(WebSocket& webSocket, WebSocketSendQueueOptions options = {});
+  ~WebSocketSendQueue() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(WebSocketSendQueue);
+
+  bool send(zc::Array<byte> message);
+  bool send(zc::String message);
+  bool sendFrame(zc::Arc<WebSocketBroadcastFrame> frame);
+  // Queue a binary or text message, or a prepared frame. Returns whether the queue is still at or
+  // under the high watermark. Throws the error if an earlier send failed.
+
+  uint64_t getQueuedBytes() const;
+  size_t getQueuedMessages() const;
+  // What's queued, counting the message currently being sent.
+
+  zc::Promise<void> whenWritable();
+  // Resolves once the queue has drained to the low watermark. Rejects if a send fails. May be
+  // called any number of times at once.
+
+  zc::Promise<void> whenDrained();
+  // Resolves once every queued message has been sent, e.g. before close(). Rejects if a send
+  // fails.
+
+private:
+  class Impl;
+  zc::Own<Impl> impl;
+};
+
 class HttpServerErrorHandler;
 class HttpServerCallbacks;
 
@@ -1193,6 +1392,11 @@ struct HttpServerSettings {
   // After one request/response completes, we'll wait up to this long for a pipelined request to
   // arrive.
 
+  zc::Duration timeoutSlack = 0 * zc::SECONDS;
+  // How much later than configured the above two timeouts may fire (see
+  // Timer::afterDelayCoarse()). A server with many connections can set this to a fraction of the
+  // timeouts so that the event loop expires them in batches rather than waking for each one.
+
   zc::Duration canceledUploadGracePeriod = 1 * zc::SECONDS;
   size_t canceledUploadGraceBytes = 65536;
   // If the HttpService sends a response and returns without having read the entire request body,
@@ -1217,6 +1421,44 @@ struct HttpServerSettings {
     AUTOMATIC_COMPRESSION,  // Will perform compression parameter negotiation if client requests it.
   };
   WebSocketCompressionMode webSocketCompressionMode = NO_COMPRESSION;
+
+  WebSocketCompressionSettings webSocketCompressionSettings;
+  // Applies to WebSockets for which compression was negotiated.
+
+  size_t minChunkSize = 0;
+  // With chunked transfer encoding, body writes smaller than this are held back and sent together
+  // in one chunk once this many bytes have accumulated, or when the body ends, rather than each in
+  // a chunk of its own. This saves chunk headers and system calls for bodies written in many
+  // small pieces, at the cost of delaying them; leave it at 0 for streams whose readers want each
+  // piece right away, such as server-sent events.
+
+  uint maxConcurrentRequests = 0;
+  // If non-zero, at most this many requests, across all connections, are handed to the
+  // HttpService at once, and the rest wait their turn in a queue. A request holds its place from
+  // when its headers have been read until the service's request() promise completes; CONNECT
+  // requests don't count. The queue settings below only apply with a limit.
+  //
+  // A request the server turns away gets a 503 Service Unavailable through
+  // HttpServerErrorHandler::handleClientProtocolError(), without the service seeing it, and its
+  // connection is closed. That costs next to nothing, so that a server past its capacity still
+  // serves what it can promptly, rather than everything too late.
+
+  zc::Duration maxQueueTime = 1 * zc::SECONDS;
+  // A request that has waited this long for its turn is turned away. With 0, requests are turned
+  // away as soon as the limit is reached rather than queued.
+
+  zc::Duration queueDelayTarget = 5 * zc::MILLISECONDS;
+  zc::Duration queueDelayInterval = 100 * zc::MILLISECONDS;
+  // Adaptive shedding, after CoDel. If no request got through the queue within the target during
+  // a whole interval, the queue isn't absorbing a burst but standing, and until the end of an
+  // interval in which one does, queued requests that waited over twice the target are turned
+  // away, as are new requests that would have to queue. A target of 0 disables this.
+
+  uint connectionRequestRate = 0;
+  uint connectionRequestBurst = 10;
+  // If the rate is non-zero, each connection may make that many requests per second on average,
+  // and up to the burst back to back. A request over the limit gets a 429 Too Many Requests
+  // through handleClientProtocolError(), and its connection is closed.
 };
 
 class HttpServerErrorHandler {
@@ -1268,6 +1510,20 @@ public:
   // This can be useful e.g. if the server has too many connections open and wants to shed some
   // of them. Note that to implement graceful shutdown of a server, you should use
   // `HttpServer::drain()` instead.
+
+  enum class Rejection {
+    QUEUE_TIMEOUT,  // Waited `maxQueueTime` for its turn, or couldn't queue, it being 0.
+    OVERLOADED,     // Shed because of a standing queue; see `queueDelayTarget`.
+    RATE_LIMITED,   // Over its connection's `connectionRequestRate`.
+  };
+
+  virtual void requestAdmitted(zc::Duration queueTime) {}
+  // With `maxConcurrentRequests` set, called as each request is handed to the HttpService, with
+  // how long it waited for its turn. For metrics.
+
+  virtual void requestRejected(Rejection reason) {}
+  // Called when the server turns a request away under the limits in HttpServerSettings. For
+  // metrics.
 };
 
 class HttpServer final : private zc::TaskSet::ErrorHandler {
@@ -1292,6 +1548,8 @@ public:
   // connection, based on the connection object. This is particularly useful for capturing the
   // client's IP address and injecting it as a header.
 
+  ~HttpServer() noexcept(false);
+
   zc::Promise<void> drain();
   // Stop accepting new connections or new requests on existing connections. Finish any requests
   // that are already executing, then close the connections. Returns once no more requests are
@@ -1372,6 +1630,7 @@ public:
 
 private:
   class Connection;
+  class AdmissionControl;
 
   zc::Timer& timer;
   const HttpHeaderTable& requestHeaderTable;
@@ -1385,6 +1644,9 @@ private:
   uint connectionCount = 0;
   zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> zeroConnectionsFulfiller;
 
+  zc::Maybe<zc::Own<AdmissionControl>> admission;
+  // If settings.maxConcurrentRequests is set.
+
   zc::TaskSet tasks;
 
   HttpServer(zc::Timer& timer, const HttpHeaderTable& requestHeaderTable,
@@ -0,0 +1,2231 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/http/http2.h"
+
+#include <deque>
+
+#include "zc/core/debug.h"
+#include "zc/core/map.h"
+#include "zc/core/refcount.h"
+
+namespace zc {
+
+namespace {
+
+// =======================================================================================
+// HPACK primitives
+
+struct HuffmanCode {
+  uint32_t code;
+  byte bits;
+};
+
+static constexpr HuffmanCode HUFFMAN_CODES[257] = {
+    {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+    {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+    {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+    {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+    {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+    {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+    {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+    {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+    {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+    {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+    {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+    {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+    {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+    {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+    {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+    {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+    {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+    {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+    {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+    {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+    {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+    {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+    {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+    {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+    {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+    {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+    {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+    {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+    {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+    {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+    {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+    {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+    {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+    {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+    {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+    {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+    {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+    {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+    {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+    {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+    {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+    {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+    {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+    {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+    {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+    {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+    {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+    {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+    {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+    {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+    {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+    {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+    {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+    {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+    {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+    {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+    {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+    {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+    {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+    {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+    {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+    {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+    {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+    {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+    {0x3fffffff, 30},
+};
+// RFC 7541 Appendix B, indexed by symbol. Symbol 256 is EOS, which never appears in a string.
+
+struct HuffmanDecodeTable {
+  // The code is canonical: the codes of each length are consecutive, in the order of their
+  // symbols. So `bits` bits make a code iff they're less than `count[bits]` above `first[bits]`,
+  // and the symbol is the one that many places after `start[bits]` in `symbols`.
+
+  uint32_t first[31] = {};
+  uint16_t count[31] = {};
+  uint16_t start[31] = {};
+  uint16_t symbols[257] = {};
+};
+
+static constexpr HuffmanDecodeTable makeHuffmanDecodeTable() {
+  HuffmanDecodeTable table;
+  for (auto& code : HUFFMAN_CODES) ++table.count[code.bits];
+
+  uint16_t next[31] = {};
+  uint16_t position = 0;
+  for (uint bits = 0; bits < 31; bits++) {
+    table.start[bits] = next[bits] = position;
+    position += table.count[bits];
+  }
+
+  for (uint16_t symbol = 0; symbol < 257; symbol++) {
+    auto& code = HUFFMAN_CODES[symbol];
+    if (next[code.bits] == table.start[code.bits]) table.first[code.bits] = code.code;
+    table.symbols[next[code.bits]++] = symbol;
+  }
+  return table;
+}
+
+static constexpr HuffmanDecodeTable HUFFMAN_DECODE = makeHuffmanDecodeTable();
+
+static constexpr bool huffmanDecodesEveryCode() {
+  for (uint symbol = 0; symbol < 257; symbol++) {
+    auto& code = HUFFMAN_CODES[symbol];
+    uint32_t offset = code.code - HUFFMAN_DECODE.first[code.bits];
+    if (offset >= HUFFMAN_DECODE.count[code.bits] ||
+        HUFFMAN_DECODE.symbols[HUFFMAN_DECODE.start[code.bits] + offset] != symbol) {
+      return false;
+    }
+  }
+  return true;
+}
+static_assert(huffmanDecodesEveryCode(), "the HPACK Huffman code should be canonical");
+
+static void huffmanDecode(zc::ArrayPtr<const byte> input, zc::Vector<char>& output) {
+  // TODO(perf): Decoding a bit at a time is simple, but a table indexed by whole bytes would be
+  //   several times faster. Header values are short, so it hasn't mattered so far.
+  uint32_t code = 0;
+  uint bits = 0;
+  for (byte b : input) {
+    for (int i = 7; i >= 0; i--) {
+      code = (code << 1) | ((b >> i) & 1);
+      ++bits;
+      uint32_t offset = code - HUFFMAN_DECODE.first[bits];
+      if (offset < HUFFMAN_DECODE.count[bits]) {
+        uint16_t symbol = HUFFMAN_DECODE.symbols[HUFFMAN_DECODE.start[bits] + offset];
+        ZC_REQUIRE(symbol != 256, "HPACK: EOS in Huffman-encoded string");
+        output.add(symbol);
+        code = 0;
+        bits = 0;
+      } else {
+        ZC_REQUIRE(bits < 30, "HPACK: invalid Huffman code");
+      }
+    }
+  }
+
+  // What's left must be padding: a prefix of EOS, which is all ones, shorter than a byte.
+  ZC_REQUIRE(bits < 8 && code == (1u << bits) - 1, "HPACK: invalid Huffman padding");
+}
+
+static size_t huffmanSize(zc::ArrayPtr<const byte> input) {
+  uint64_t bits = 0;
+  for (byte b : input) bits += HUFFMAN_CODES[b].bits;
+  return (bits + 7) / 8;
+}
+
+static void huffmanEncode(zc::ArrayPtr<const byte> input, zc::Vector<byte>& output) {
+  uint64_t pending = 0;  // only the low `bits` bits matter
+  uint bits = 0;
+  for (byte b : input) {
+    auto& code = HUFFMAN_CODES[b];
+    pending = (pending << code.bits) | code.code;
+    bits += code.bits;
+    while (bits >= 8) {
+      bits -= 8;
+      output.add(pending >> bits);
+    }
+  }
+  if (bits > 0) output.add((pending << (8 - bits)) | (0xff >> bits));
+}
+
+static void encodeInteger(zc::Vector<byte>& output, byte flags, uint prefixBits, uint64_t value) {
+  // RFC 7541 section 5.1: the value goes in the low `prefixBits` bits of the first byte, and if
+  // it doesn't fit, the rest follows seven bits per byte, least significant first.
+  uint limit = (1u << prefixBits) - 1;
+  if (value < limit) {
+    output.add(flags | value);
+    return;
+  }
+  output.add(flags | limit);
+  value -= limit;
+  while (value >= 128) {
+    output.add((value % 128) | 128);
+    value /= 128;
+  }
+  output.add(value);
+}
+
+static uint64_t decodeInteger(const byte*& pos, const byte* end, uint prefixBits) {
+  ZC_REQUIRE(pos < end, "HPACK: truncated integer");
+  uint limit = (1u << prefixBits) - 1;
+  uint64_t value = *pos++ & limit;
+  if (value < limit) return value;
+
+  for (uint shift = 0;; shift += 7) {
+    ZC_REQUIRE(pos < end, "HPACK: truncated integer");
+    ZC_REQUIRE(shift <= 28, "HPACK: integer too large");
+    byte b = *pos++;
+    value += uint64_t(b & 127) << shift;
+    if ((b & 128) == 0) return value;
+  }
+}
+
+static void encodeString(zc::Vector<byte>& output, zc::StringPtr string) {
+  auto bytes = string.asBytes();
+  size_t compressedSize = huffmanSize(bytes);
+  if (compressedSize < bytes.size()) {
+    encodeInteger(output, 0x80, 7, compressedSize);
+    huffmanEncode(bytes, output);
+  } else {
+    encodeInteger(output, 0, 7, bytes.size());
+    output.addAll(bytes);
+  }
+}
+
+static zc::String decodeString(const byte*& pos, const byte* end) {
+  ZC_REQUIRE(pos < end, "HPACK: truncated string");
+  bool huffman = *pos & 0x80;
+  uint64_t size = decodeInteger(pos, end, 7);
+  ZC_REQUIRE(size <= uint64_t(end - pos), "HPACK: truncated string");
+  auto bytes = zc::arrayPtr(pos, size);
+  pos += size;
+
+  if (huffman) {
+    // The shortest code is five bits.
+    zc::Vector<char> chars(size * 8 / 5);
+    huffmanDecode(bytes, chars);
+    return zc::heapString(chars);
+  } else {
+    return zc::heapString(bytes.asChars());
+  }
+}
+
+struct StaticField {
+  zc::StringPtr name;
+  zc::StringPtr value;
+};
+
+static constexpr StaticField STATIC_TABLE[] = {
+    {":authority"_zc, ""_zc},
+    {":method"_zc, "GET"_zc},
+    {":method"_zc, "POST"_zc},
+    {":path"_zc, "/"_zc},
+    {":path"_zc, "/index.html"_zc},
+    {":scheme"_zc, "http"_zc},
+    {":scheme"_zc, "https"_zc},
+    {":status"_zc, "200"_zc},
+    {":status"_zc, "204"_zc},
+    {":status"_zc, "206"_zc},
+    {":status"_zc, "304"_zc},
+    {":status"_zc, "400"_zc},
+    {":status"_zc, "404"_zc},
+    {":status"_zc, "500"_zc},
+    {"accept-charset"_zc, ""_zc},
+    {"accept-encoding"_zc, "gzip, deflate"_zc},
+    {"accept-language"_zc, ""_zc},
+    {"accept-ranges"_zc, ""_zc},
+    {"accept"_zc, ""_zc},
+    {"access-control-allow-origin"_zc, ""_zc},
+    {"age"_zc, ""_zc},
+    {"allow"_zc, ""_zc},
+    {"authorization"_zc, ""_zc},
+    {"cache-control"_zc, ""_zc},
+    {"content-disposition"_zc, ""_zc},
+    {"content-encoding"_zc, ""_zc},
+    {"content-language"_zc, ""_zc},
+    {"content-length"_zc, ""_zc},
+    {"content-location"_zc, ""_zc},
+    {"content-range"_zc, ""_zc},
+    {"content-type"_zc, ""_zc},
+    {"cookie"_zc, ""_zc},
+    {"date"_zc, ""_zc},
+    {"etag"_zc, ""_zc},
+    {"expect"_zc, ""_zc},
+    {"expires"_zc, ""_zc},
+    {"from"_zc, ""_zc},
+    {"host"_zc, ""_zc},
+    {"if-match"_zc, ""_zc},
+    {"if-modified-since"_zc, ""_zc},
+    {"if-none-match"_zc, ""_zc},
+    {"if-range"_zc, ""_zc},
+    {"if-unmodified-since"_zc, ""_zc},
+    {"last-modified"_zc, ""_zc},
+    {"link"_zc, ""_zc},
+    {"location"_zc, ""_zc},
+    {"max-forwards"_zc, ""_zc},
+    {"proxy-authenticate"_zc, ""_zc},
+    {"proxy-authorization"_zc, ""_zc},
+    {"range"_zc, ""_zc},
+    {"referer"_zc, ""_zc},
+    {"refresh"_zc, ""_zc},
+    {"retry-after"_zc, ""_zc},
+    {"server"_zc, ""_zc},
+    {"set-cookie"_zc, ""_zc},
+    {"strict-transport-security"_zc, ""_zc},
+    {"transfer-encoding"_zc, ""_zc},
+    {"user-agent"_zc, ""_zc},
+    {"vary"_zc, ""_zc},
+    {"via"_zc, ""_zc},
+    {"www-authenticate"_zc, ""_zc},
+};
+// RFC 7541 Appendix A. Index 1 is the first entry; the dynamic table's entries follow.
+
+static constexpr size_t ENTRY_OVERHEAD = 32;
+// RFC 7541 section 4.1: each entry counts as its name and value plus this much.
+
+}  // namespace
+
+// =======================================================================================
+// HpackDecoder
+
+struct HpackDecoder::Table {
+  struct Entry {
+    zc::String name;
+    zc::String value;
+  };
+  std::deque<Entry> entries;  // newest first
+  size_t size = 0;
+  size_t maxSize;  // the size we announced; the peer can't make the table any bigger
+  size_t limit;    // the size the peer chose, at most maxSize
+
+  explicit Table(size_t maxSize) : maxSize(maxSize), limit(maxSize) {}
+
+  void evict(size_t target) {
+    while (size > target) {
+      auto& oldest = entries.back();
+      size -= oldest.name.size() + oldest.value.size() + ENTRY_OVERHEAD;
+      entries.pop_back();
+    }
+  }
+
+  void add(zc::String name, zc::String value) {
+    size_t entrySize = name.size() + value.size() + ENTRY_OVERHEAD;
+    if (entrySize > limit) {
+      // RFC 7541 section 4.4: an entry too large for the table empties it.
+      evict(0);
+      return;
+    }
+    evict(limit - entrySize);
+    entries.push_front(Entry{zc::mv(name), zc::mv(value)});
+    size += entrySize;
+  }
+
+  StaticField get(uint64_t index) {
+    ZC_REQUIRE(index > 0, "HPACK: index zero");
+    if (index <= zc::size(STATIC_TABLE)) return STATIC_TABLE[index - 1];
+    index -= zc::size(STATIC_TABLE) + 1;
+    ZC_REQUIRE(index < entries.size(), "HPACK: index beyond the dynamic table");
+    auto& entry = entries[index];
+    return {entry.name, entry.value};
+  }
+};
+
+HpackDecoder::HpackDecoder(size_t maxTableSize) : table(zc::heap<Table>(maxTableSize)) {}
+HpackDecoder::~HpackDecoder() noexcept(false) {}
+
+size_t HpackDecoder::getTableSize() const { return table->size; }
+
+zc::Maybe<zc::Array<HpackDecoder::Header>> HpackDecoder::decode(zc::ArrayPtr<const byte> block,
+                                                                size_t maxListSize) {
+  zc::Vector<Header> headers;
+  size_t listSize = 0;
+  bool tooLarge = false;
+  bool sawField = false;
+
+  auto emit = [&](zc::String name, zc::String value) {
+    listSize += name.size() + value.size() + ENTRY_OVERHEAD;
+    if (listSize > maxListSize) {
+      tooLarge = true;
+      headers.clear();
+    }
+    if (!tooLarge) headers.add(Header{zc::mv(name), zc::mv(value)});
+  };
+
+  const byte* pos = block.begin();
+  const byte* end = block.end();
+  while (pos < end) {
+    byte b = *pos;
+    if (b & 0x80) {
+      // Indexed field (section 6.1).
+      auto field = table->get(decodeInteger(pos, end, 7));
+      emit(zc::str(field.name), zc::str(field.value));
+    } else if ((b & 0xe0) == 0x20) {
+      // Dynamic table size update (section 6.3), allowed only before the first field.
+      ZC_REQUIRE(!sawField, "HPACK: dynamic table size update after a field");
+      uint64_t size = decodeInteger(pos, end, 5);
+      ZC_REQUIRE(size <= table->maxSize, "HPACK: dynamic table size update beyond our limit");
+      table->limit = size;
+      table->evict(size);
+      continue;
+    } else {
+      // Literal field (sections 6.2.1 to 6.2.3), with incremental indexing or without, the name
+      // being either indexed or a literal too.
+      bool indexing = b & 0x40;
+      uint64_t nameIndex = decodeInteger(pos, end, indexing ? 6 : 4);
+      zc::String name =
+          nameIndex == 0 ? decodeString(pos, end) : zc::str(table->get(nameIndex).name);
+      zc::String value = decodeString(pos, end);
+      if (indexing) table->add(zc::str(name), zc::str(value));
+      emit(zc::mv(name), zc::mv(value));
+    }
+    sawField = true;
+  }
+
+  if (tooLarge) return zc::none;
+  return headers.releaseAsArray();
+}
+
+// =======================================================================================
+// HpackEncoder
+
+struct HpackEncoder::Table {
+  struct Entry {
+    zc::String name;
+    zc::String value;
+  };
+  std::deque<Entry> entries;  // newest first
+  size_t size = 0;
+  size_t maxSize;  // never grow beyond this, whatever the peer allows
+  size_t limit;    // what we use, at most the peer's SETTINGS_HEADER_TABLE_SIZE
+  zc::Maybe<size_t> smallestLimit;  // since the last block, if the limit changed
+
+  explicit Table(size_t maxSize) : maxSize(maxSize), limit(zc::min(maxSize, 4096)) {}
+
+  void evict(size_t target) {
+    while (size > target) {
+      auto& oldest = entries.back();
+      size -= oldest.name.size() + oldest.value.size() + ENTRY_OVERHEAD;
+      entries.pop_back();
+    }
+  }
+};
+
+HpackEncoder::HpackEncoder(size_t maxTableSize) : table(zc::heap<Table>(maxTableSize)) {
+  // The peer starts out expecting the default size of 4096. If we use less, we have to say so.
+  if (table->limit < 4096) table->smallestLimit = table->limit;
+}
+HpackEncoder::~HpackEncoder() noexcept(false) {}
+
+void HpackEncoder::setMaxTableSize(size_t size) {
+  size_t limit = zc::min(size, table->maxSize);
+  if (limit == table->limit) return;
+  table->limit = limit;
+  table->evict(limit);
+  table->smallestLimit = zc::min(table->smallestLimit.orDefault(limit), limit);
+}
+
+static bool isSensitive(zc::StringPtr name, zc::StringPtr value) {
+  // RFC 7541 section 7.1.3: fields an attacker could guess one piece at a time, by watching how
+  // well their own guesses compress, must never be indexed. Cookies are only guessable when short.
+  if (name == "authorization" || name == "proxy-authorization") return true;
+  return (name == "cookie" || name == "set-cookie") && value.size() < 20;
+}
+
+void HpackEncoder::encode(zc::Vector<byte>& out, zc::ArrayPtr<const Field> fields) {
+  auto& t = *table;
+
+  ZC_IF_SOME(smallest, t.smallestLimit) {
+    // Section 4.2: announce the smallest size since the last block, then the current one.
+    if (smallest < t.limit) encodeInteger(out, 0x20, 5, smallest);
+    encodeInteger(out, 0x20, 5, t.limit);
+    t.smallestLimit = zc::none;
+  }
+
+  for (auto& field : fields) {
+    // TODO(perf): Both searches are linear. The static table could be searched by a perfect hash
+    //   of the name, like HttpHeaderTable's builtin headers, and the dynamic table by a map.
+    uint64_t nameIndex = 0;
+    uint64_t fieldIndex = 0;
+    for (size_t i = 0; i < zc::size(STATIC_TABLE); i++) {
+      if (STATIC_TABLE[i].name == field.name) {
+        if (nameIndex == 0) nameIndex = i + 1;
+        if (STATIC_TABLE[i].value == field.value) {
+          fieldIndex = i + 1;
+          break;
+        }
+      }
+    }
+    if (fieldIndex == 0) {
+      for (size_t i = 0; i < t.entries.size(); i++) {
+        auto& entry = t.entries[i];
+        if (entry.name == field.name) {
+          if (nameIndex == 0) nameIndex = zc::size(STATIC_TABLE) + 1 + i;
+          if (entry.value == field.value) {
+            fieldIndex = zc::size(STATIC_TABLE) + 1 + i;
+            break;
+          }
+        }
+      }
+    }
+
+    if (fieldIndex != 0) {
+      encodeInteger(out, 0x80, 7, fieldIndex);
+      continue;
+    }
+
+    size_t entrySize = field.name.size() + field.value.size() + ENTRY_OVERHEAD;
+    if (isSensitive(field.name, field.value)) {
+      encodeInteger(out, 0x10, 4, nameIndex);
+    } else if (entrySize <= t.limit / 2) {
+      // Index fields that leave room for others; bigger ones would flush the table for little gain.
+      encodeInteger(out, 0x40, 6, nameIndex);
+      t.evict(t.limit - entrySize);
+      t.entries.push_front(Table::Entry{zc::str(field.name), zc::str(field.value)});
+      t.size += entrySize;
+    } else {
+      encodeInteger(out, 0, 4, nameIndex);
+    }
+    if (nameIndex == 0) encodeString(out, field.name);
+    encodeString(out, field.value);
+  }
+}
+
+// =======================================================================================
+// Connections and streams
+
+namespace {
+
+static constexpr zc::StringPtr CONNECTION_PREFACE = "PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"_zc;
+static constexpr size_t FRAME_HEADER_SIZE = 9;
+static constexpr int64_t DEFAULT_WINDOW_SIZE = 65535;
+static constexpr int64_t MAX_WINDOW_SIZE = 0x7fffffff;
+static constexpr uint32_t MAX_STREAM_ID = 0x7fffffff;
+static constexpr size_t READ_BUFFER_SIZE = 16384 + FRAME_HEADER_SIZE;
+
+enum class FrameType : byte {
+  DATA = 0,
+  HEADERS = 1,
+  PRIORITY = 2,
+  RST_STREAM = 3,
+  SETTINGS = 4,
+  PUSH_PROMISE = 5,
+  PING = 6,
+  GOAWAY = 7,
+  WINDOW_UPDATE = 8,
+  CONTINUATION = 9,
+};
+
+static constexpr byte FLAG_END_STREAM = 0x01;
+static constexpr byte FLAG_ACK = 0x01;
+static constexpr byte FLAG_END_HEADERS = 0x04;
+static constexpr byte FLAG_PADDED = 0x08;
+static constexpr byte FLAG_PRIORITY = 0x20;
+
+enum class ErrorCode : uint32_t {
+  NO_ERROR = 0,
+  PROTOCOL_ERROR = 1,
+  INTERNAL_ERROR = 2,
+  FLOW_CONTROL_ERROR = 3,
+  SETTINGS_TIMEOUT = 4,
+  STREAM_CLOSED = 5,
+  FRAME_SIZE_ERROR = 6,
+  REFUSED_STREAM = 7,
+  CANCEL = 8,
+  COMPRESSION_ERROR = 9,
+};
+
+enum class SettingId : uint16_t {
+  HEADER_TABLE_SIZE = 1,
+  ENABLE_PUSH = 2,
+  MAX_CONCURRENT_STREAMS = 3,
+  INITIAL_WINDOW_SIZE = 4,
+  MAX_FRAME_SIZE = 5,
+  MAX_HEADER_LIST_SIZE = 6,
+};
+
+static uint32_t readUint32(const byte* p) {
+  return (uint32_t(p[0]) << 24) | (uint32_t(p[1]) << 16) | (uint32_t(p[2]) << 8) | p[3];
+}
+
+static void writeUint32(byte* p, uint32_t value) {
+  p[0] = value >> 24;
+  p[1] = value >> 16;
+  p[2] = value >> 8;
+  p[3] = value;
+}
+
+struct FrameHeader {
+  uint32_t length;
+  FrameType type;
+  byte flags;
+  uint32_t streamId;
+};
+
+static zc::ArrayPtr<const byte> stripPadding(const FrameHeader& header,
+                                             zc::ArrayPtr<const byte> payload, size_t skip);
+
+class Http2Connection;
+
+class Http2Stream : public zc::Refcounted {
+  // One request and its response. The connection holds a reference while the stream is open (or,
+  // on the client, waiting to be opened); the application's body streams hold the others.
+
+public:
+  Http2Stream(Http2Connection& connection, int64_t sendWindow, int64_t recvWindow)
+      : connection(connection), sendWindow(sendWindow), recvWindow(recvWindow) {}
+  virtual ~Http2Stream() noexcept(false) {}
+
+  uint32_t id = 0;  // zero while a client stream waits to be opened
+  zc::Maybe<Http2Connection&> connection;
+  // None once the stream is closed, or the connection is gone.
+
+  zc::Maybe<zc::Exception> error;
+  // Why the stream ended early, if it did.
+
+  bool localClosed = false;   // we've sent END_STREAM, or decided to
+  bool remoteClosed = false;  // the peer has sent END_STREAM
+
+  int64_t sendWindow;
+  int64_t recvWindow;
+  uint32_t unacked = 0;  // bytes the application has read that we haven't credited the peer with
+
+  struct Chunk {
+    zc::Array<byte> frame;
+    zc::ArrayPtr<const byte> data;  // the unread part of `frame`
+  };
+  std::deque<Chunk> received;
+
+  zc::Maybe<uint64_t> expectedLength;  // the remaining content-length, if there was one
+
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> readWaiter;
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> writeWaiter;
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> openWaiter;
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> disconnectWaiter;
+
+  static zc::Promise<void> wait(zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>>& waiter) {
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    waiter = zc::mv(paf.fulfiller);
+    return zc::mv(paf.promise);
+  }
+
+  static void wake(zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>>& waiter) {
+    auto w = zc::mv(waiter);
+    waiter = zc::none;
+    ZC_IF_SOME(f, w) { f->fulfill(); }
+  }
+
+  void requireOk() {
+    ZC_IF_SOME(e, error) { zc::throwFatalException(zc::cp(e)); }
+  }
+
+  Http2Connection& getConnection() {
+    requireOk();
+    ZC_IF_SOME(c, connection) { return c; }
+    ZC_FAIL_REQUIRE("HTTP/2 stream is already closed");
+  }
+
+  void fail(const zc::Exception& exception) {
+    if (error != zc::none) return;
+    error = zc::cp(exception);
+    received.clear();
+    for (auto waiter : {&readWaiter, &writeWaiter, &openWaiter}) {
+      auto w = zc::mv(*waiter);
+      *waiter = zc::none;
+      ZC_IF_SOME(f, w) { f->reject(zc::cp(exception)); }
+    }
+    wake(disconnectWaiter);
+    onFailed(exception);
+  }
+
+  virtual void onFailed(const zc::Exception& exception) {}
+
+  size_t take(zc::ArrayPtr<byte> out);
+  // Copies received body data into `out`, crediting the peer's window for it.
+};
+
+class Http2Connection : private zc::TaskSet::ErrorHandler {
+  // The parts of an HTTP/2 connection common to both ends: framing, HPACK, stream bookkeeping and
+  // flow control. Http2Client and Http2Server::Connection add requests and responses.
+
+public:
+  Http2Connection(zc::AsyncIoStream& io, zc::Own<zc::AsyncIoStream> ownIo, Http2Settings settings,
+                  bool isClient)
+      : settings(settings),
+        isClient(isClient),
+        ownIo(zc::mv(ownIo)),
+        io(io),
+        decoder(settings.headerTableSize),
+        readBuffer(zc::heapArray<byte>(READ_BUFFER_SIZE)),
+        recvWindow(zc::max(settings.connectionWindowSize, DEFAULT_WINDOW_SIZE)),
+        tasks(*this) {
+    ZC_REQUIRE(settings.maxFrameSize >= 16384 && settings.maxFrameSize <= 16777215,
+               "invalid HTTP/2 maxFrameSize", settings.maxFrameSize);
+    ZC_REQUIRE(settings.initialWindowSize <= MAX_WINDOW_SIZE &&
+                   settings.connectionWindowSize <= MAX_WINDOW_SIZE,
+               "HTTP/2 windows can't exceed 2^31-1 bytes");
+  }
+
+  virtual ~Http2Connection() noexcept(false) {
+    tasks.clear();
+    failAll(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 connection destroyed"));
+  }
+
+  const Http2Settings settings;
+
+  zc::Promise<void> run() {
+    // Sends our preface, then handles frames until the peer closes the connection.
+
+    zc::Vector<byte> settingsPayload;
+    auto addSetting = [&](SettingId id, uint32_t value) {
+      settingsPayload.add(static_cast<uint16_t>(id) >> 8);
+      settingsPayload.add(static_cast<uint16_t>(id) & 0xff);
+      byte bytes[4];
+      writeUint32(bytes, value);
+      settingsPayload.addAll(zc::arrayPtr(bytes));
+    };
+    if (isClient) addSetting(SettingId::ENABLE_PUSH, 0);
+    addSetting(SettingId::HEADER_TABLE_SIZE, settings.headerTableSize);
+    addSetting(SettingId::MAX_CONCURRENT_STREAMS, settings.maxConcurrentStreams);
+    addSetting(SettingId::INITIAL_WINDOW_SIZE, settings.initialWindowSize);
+    addSetting(SettingId::MAX_FRAME_SIZE, settings.maxFrameSize);
+    addSetting(SettingId::MAX_HEADER_LIST_SIZE, settings.maxHeaderListSize);
+
+    if (isClient) queue(CONNECTION_PREFACE.asBytes());
+    queueFrame(FrameType::SETTINGS, 0, 0, settingsPayload);
+    if (recvWindow > DEFAULT_WINDOW_SIZE) {
+      queueWindowUpdate(0, recvWindow - DEFAULT_WINDOW_SIZE);
+    }
+
+    auto promise = isClient ? readLoop() : readPreface().then([this]() { return readLoop(); });
+    auto brokenPaf = zc::newPromiseAndFulfiller<void>();
+    writeFailed = zc::mv(brokenPaf.fulfiller);
+    return promise.exclusiveJoin(zc::mv(brokenPaf.promise))
+        .catch_([this](zc::Exception&& exception) -> zc::Promise<void> {
+          if (broken != zc::none) {
+            // The connection already failed, e.g. because a write failed.
+            return zc::mv(exception);
+          }
+          if (exception.getType() != zc::Exception::Type::DISCONNECTED) {
+            queueGoAway(goAwayCode);
+          }
+          failAll(exception);
+          return whenWritten().then([exception = zc::mv(exception)]() mutable -> zc::Promise<void> {
+            return zc::mv(exception);
+          });
+        });
+  }
+
+  // ---------------------------------------------------------------------------------------------
+  // Called by the streams.
+
+  zc::Promise<void> writeData(Http2Stream& stream, zc::ArrayPtr<const byte> data, bool end) {
+    // Sends `data` on `stream` as the flow control windows permit, with END_STREAM after it if
+    // `end`. Resolves once it's all been written to the connection.
+
+    stream.requireOk();
+    if (stream.id == 0) {
+      return Http2Stream::wait(stream.openWaiter).then([this, &stream, data, end]() {
+        return writeData(stream, data, end);
+      });
+    }
+
+    while (data.size() > 0) {
+      int64_t window = zc::min(sendWindow, stream.sendWindow);
+      if (window <= 0) {
+        return Http2Stream::wait(stream.writeWaiter).then([this, &stream, data, end]() {
+          return writeData(stream, data, end);
+        });
+      }
+      size_t n = zc::min(data.size(), zc::min<uint64_t>(window, peerMaxFrameSize));
+      bool last = n == data.size();
+      queueFrame(FrameType::DATA, last && end ? FLAG_END_STREAM : 0, stream.id, data.first(n));
+      sendWindow -= n;
+      stream.sendWindow -= n;
+      data = data.slice(n, data.size());
+      if (last && end) {
+        markLocalClosed(stream);
+        return flushed();
+      }
+    }
+
+    if (end) {
+      queueFrame(FrameType::DATA, FLAG_END_STREAM, stream.id, nullptr);
+      markLocalClosed(stream);
+    }
+    return flushed();
+  }
+
+  void endStream(Http2Stream& stream) {
+    // Ends our side of the stream, without waiting for the frame to be written.
+    if (stream.localClosed) return;
+    if (stream.id == 0) {
+      // Not opened yet. The HEADERS frame will carry END_STREAM.
+      stream.localClosed = true;
+    } else {
+      queueFrame(FrameType::DATA, FLAG_END_STREAM, stream.id, nullptr);
+      markLocalClosed(stream);
+    }
+  }
+
+  void resetStream(Http2Stream& stream, ErrorCode code, zc::StringPtr reason) {
+    auto ref = zc::addRef(stream);
+    if (stream.id != 0) queueRstStream(stream.id, code);
+    stream.fail(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 stream canceled", reason));
+    stream.localClosed = stream.remoteClosed = true;
+    removeStream(stream);
+  }
+
+  void credit(Http2Stream& stream, size_t n) {
+    // The application has read `n` bytes of the stream's body, so the peer may send more.
+    stream.unacked += n;
+    if (!stream.remoteClosed && stream.unacked >= settings.initialWindowSize / 2) {
+      queueWindowUpdate(stream.id, stream.unacked);
+      stream.recvWindow += stream.unacked;
+      stream.unacked = 0;
+    }
+  }
+
+  zc::Promise<void> flushed() {
+    // Resolves once everything queued so far has been written.
+    ZC_IF_SOME(e, broken) { return zc::cp(e); }
+    return whenWritten();
+  }
+
+protected:
+  const bool isClient;
+  zc::Own<zc::AsyncIoStream> ownIo;
+  zc::AsyncIoStream& io;
+
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+
+  zc::HashMap<uint32_t, zc::Own<Http2Stream>> streams;
+  zc::Maybe<zc::Exception> broken;
+
+  uint32_t lastPeerStreamId = 0;
+  bool goAwaySent = false;
+  bool goAwayReceived = false;
+
+  int64_t peerInitialWindowSize = DEFAULT_WINDOW_SIZE;
+  uint32_t peerMaxConcurrentStreams = 0xffffffff;
+  uint32_t peerMaxFrameSize = 16384;
+
+  virtual void onHeaders(uint32_t streamId, zc::Maybe<zc::Array<HpackDecoder::Header>> fields,
+                         bool endStream) = 0;
+  // Called for each complete header block. `fields` is none if they exceed maxHeaderListSize.
+
+  virtual void onStreamRemoved() {}
+  virtual void onSettings() {}
+  virtual void onGoAway(uint32_t lastStreamId) {}
+
+  [[noreturn]] void protocolError(ErrorCode code, zc::StringPtr description) {
+    goAwayCode = code;
+    zc::throwFatalException(ZC_EXCEPTION(FAILED, "HTTP/2 protocol error", description));
+  }
+
+  void failAll(const zc::Exception& exception) {
+    if (broken == zc::none) broken = zc::cp(exception);
+
+    zc::Vector<zc::Own<Http2Stream>> all;
+    for (auto& entry : streams) all.add(zc::addRef(*entry.value));
+    streams.clear();
+    for (auto& stream : all) {
+      stream->connection = zc::none;
+      stream->fail(exception);
+    }
+    onFailed(exception);
+
+    for (auto& waiter : flushWaiters) waiter.fulfiller->reject(zc::cp(exception));
+    flushWaiters.clear();
+  }
+
+  virtual void onFailed(const zc::Exception& exception) {}
+
+  void addStream(Http2Stream& stream) {
+    streams.insert(stream.id, zc::addRef(stream));
+    stream.connection = *this;
+  }
+
+  void removeStream(Http2Stream& stream) {
+    // Callers must hold a reference to `stream`, since this may drop the last other one.
+    if (stream.id == 0 || !streams.erase(stream.id)) return;
+    stream.connection = zc::none;
+    onStreamRemoved();
+  }
+
+  void markLocalClosed(Http2Stream& stream) {
+    stream.localClosed = true;
+    if (stream.remoteClosed) {
+      auto ref = zc::addRef(stream);
+      removeStream(stream);
+    }
+  }
+
+  void markRemoteClosed(Http2Stream& stream) {
+    stream.remoteClosed = true;
+    Http2Stream::wake(stream.readWaiter);
+    if (stream.localClosed) {
+      auto ref = zc::addRef(stream);
+      removeStream(stream);
+    }
+  }
+
+  zc::Maybe<Http2Stream&> findStream(uint32_t id) {
+    ZC_IF_SOME(stream, streams.find(id)) { return *stream; }
+    return zc::none;
+  }
+
+  void queueHeaders(uint32_t streamId, zc::ArrayPtr<const HpackEncoder::Field> fields,
+                    bool endStream) {
+    // Encodes the fields and queues them as a HEADERS frame followed by as many CONTINUATION
+    // frames as needed. Nothing may be queued in between, and nothing is.
+    zc::Vector<byte> block;
+    encoder.encode(block, fields);
+
+    auto rest = block.asPtr();
+    bool first = true;
+    do {
+      auto piece = rest.first(zc::min(rest.size(), peerMaxFrameSize));
+      rest = rest.slice(piece.size(), rest.size());
+      byte flags = rest.size() == 0 ? FLAG_END_HEADERS : 0;
+      if (first && endStream) flags |= FLAG_END_STREAM;
+      queueFrame(first ? FrameType::HEADERS : FrameType::CONTINUATION, flags, streamId, piece);
+      first = false;
+    } while (rest.size() > 0);
+  }
+
+  void queueRstStream(uint32_t streamId, ErrorCode code) {
+    byte payload[4];
+    writeUint32(payload, static_cast<uint32_t>(code));
+    queueFrame(FrameType::RST_STREAM, 0, streamId, payload);
+  }
+
+  void queueWindowUpdate(uint32_t streamId, uint32_t increment) {
+    byte payload[4];
+    writeUint32(payload, increment);
+    queueFrame(FrameType::WINDOW_UPDATE, 0, streamId, payload);
+  }
+
+  void queueGoAway(ErrorCode code) {
+    if (goAwaySent && code == ErrorCode::NO_ERROR) return;
+    goAwaySent = true;
+    byte payload[8];
+    writeUint32(payload, lastPeerStreamId);
+    writeUint32(payload + 4, static_cast<uint32_t>(code));
+    queueFrame(FrameType::GOAWAY, 0, 0, payload);
+  }
+
+  zc::Promise<void> close() {
+    // Flushes whatever is queued, then closes our end of the connection.
+    return flushed().then([this]() { io.shutdownWrite(); });
+  }
+
+  zc::TaskSet& getTasks() { return tasks; }
+
+private:
+  ErrorCode goAwayCode = ErrorCode::INTERNAL_ERROR;  // set by protocolError()
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> writeFailed;
+
+  // Reading.
+  zc::Array<byte> readBuffer;
+  size_t readStart = 0;
+  size_t readEnd = 0;
+
+  int64_t recvWindow;     // what the peer may still send on the connection
+  uint32_t recvUnacked = 0;  // received, but not yet credited back
+
+  uint32_t continuationStreamId = 0;  // nonzero while a header block is incomplete
+  bool continuationEndsStream = false;
+  zc::Vector<byte> headerBlock;
+
+  // Writing.
+  int64_t sendWindow = DEFAULT_WINDOW_SIZE;
+  zc::Vector<byte> pending;   // frames not yet handed to `io`
+  zc::Vector<byte> inFlight;  // frames `io` is writing
+  bool writeScheduled = false;
+  uint64_t queuedBytes = 0;
+  uint64_t writtenBytes = 0;
+
+  struct FlushWaiter {
+    uint64_t position;
+    zc::Own<zc::PromiseFulfiller<void>> fulfiller;
+  };
+  std::deque<FlushWaiter> flushWaiters;
+
+  zc::TaskSet tasks;
+
+  void taskFailed(zc::Exception&& exception) override {
+    // Request tasks handle their own errors; the write loop handles its own.
+  }
+
+  // ---------------------------------------------------------------------------------------------
+  // Writing
+
+  void queue(zc::ArrayPtr<const byte> bytes) {
+    pending.addAll(bytes);
+    queuedBytes += bytes.size();
+    if (!writeScheduled) {
+      // Everything queued during this turn of the event loop goes out in one write.
+      writeScheduled = true;
+      tasks.add(zc::evalLater([this]() { return writeLoop(); })
+                    .catch_([this](zc::Exception&& exception) {
+                      failAll(exception);
+                      ZC_IF_SOME(f, writeFailed) { f->reject(zc::mv(exception)); }
+                    }));
+    }
+  }
+
+  void queueFrame(FrameType type, byte flags, uint32_t streamId, zc::ArrayPtr<const byte> payload) {
+    byte header[FRAME_HEADER_SIZE];
+    header[0] = payload.size() >> 16;
+    header[1] = payload.size() >> 8;
+    header[2] = payload.size();
+    header[3] = static_cast<byte>(type);
+    header[4] = flags;
+    writeUint32(header + 5, streamId);
+    queue(header);
+    queue(payload);
+  }
+
+  zc::Promise<void> writeLoop() {
+    if (pending.size() == 0) {
+      writeScheduled = false;
+      return zc::READY_NOW;
+    }
+
+    auto next = zc::mv(pending);
+    pending = zc::mv(inFlight);
+    pending.clear();
+    inFlight = zc::mv(next);
+
+    return io.write(inFlight.asPtr()).then([this]() {
+      writtenBytes += inFlight.size();
+      while (!flushWaiters.empty() && flushWaiters.front().position <= writtenBytes) {
+        flushWaiters.front().fulfiller->fulfill();
+        flushWaiters.pop_front();
+      }
+      return writeLoop();
+    });
+  }
+
+  zc::Promise<void> whenWritten() {
+    if (writtenBytes == queuedBytes) return zc::READY_NOW;
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    flushWaiters.push_back(FlushWaiter{queuedBytes, zc::mv(paf.fulfiller)});
+    return zc::mv(paf.promise);
+  }
+
+  // ---------------------------------------------------------------------------------------------
+  // Reading
+
+  zc::Promise<void> readPreface() {
+    auto buffer = zc::heapArray<byte>(CONNECTION_PREFACE.size());
+    auto promise = io.tryRead(buffer.begin(), buffer.size(), buffer.size());
+    return promise.then([this, buffer = zc::mv(buffer)](size_t n) {
+      if (n == 0) {
+        zc::throwFatalException(
+            ZC_EXCEPTION(DISCONNECTED, "HTTP/2 client closed the connection without a request"));
+      }
+      if (n < buffer.size() || buffer != CONNECTION_PREFACE.asBytes()) {
+        protocolError(ErrorCode::PROTOCOL_ERROR, "invalid connection preface");
+      }
+    });
+  }
+
+  zc::Promise<void> readLoop() {
+    // Handles the frames in the buffer, then reads more. Resolves when the peer closes the
+    // connection.
+
+    for (;;) {
+      size_t available = readEnd - readStart;
+      if (available < FRAME_HEADER_SIZE) {
+        if (readStart > 0) {
+          memmove(readBuffer.begin(), readBuffer.begin() + readStart, available);
+          readStart = 0;
+          readEnd = available;
+        }
+        size_t wanted = FRAME_HEADER_SIZE - available;
+        return io.tryRead(readBuffer.begin() + readEnd, wanted, readBuffer.size() - readEnd)
+            .then([this, wanted](size_t n) -> zc::Promise<void> {
+              readEnd += n;
+              if (n >= wanted) return readLoop();
+              if (readEnd > 0) {
+                return ZC_EXCEPTION(DISCONNECTED, "HTTP/2 connection ended mid-frame");
+              }
+              failAll(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 connection closed by peer"));
+              return zc::READY_NOW;
+            });
+      }
+
+      const byte* p = readBuffer.begin() + readStart;
+      FrameHeader header{(uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | p[2],
+                         static_cast<FrameType>(p[3]), p[4], readUint32(p + 5) & MAX_STREAM_ID};
+      if (header.length > settings.maxFrameSize) {
+        protocolError(ErrorCode::FRAME_SIZE_ERROR, "frame too large");
+      }
+
+      // Each frame gets its own buffer, so that received data can be handed to the stream as-is.
+      auto payload = zc::heapArray<byte>(header.length);
+      size_t n = zc::min(header.length, available - FRAME_HEADER_SIZE);
+      memcpy(payload.begin(), p + FRAME_HEADER_SIZE, n);
+      readStart += FRAME_HEADER_SIZE + n;
+      if (readStart == readEnd) readStart = readEnd = 0;
+
+      if (n < header.length) {
+        auto rest = payload.slice(n, payload.size());
+        return io.read(rest).then([this, header, payload = zc::mv(payload)]() mutable {
+          handleFrame(header, zc::mv(payload));
+          return readLoop();
+        });
+      }
+      handleFrame(header, zc::mv(payload));
+    }
+  }
+
+  void handleFrame(const FrameHeader& header, zc::Array<byte> payload) {
+    if (continuationStreamId != 0 &&
+        (header.type != FrameType::CONTINUATION || header.streamId != continuationStreamId)) {
+      protocolError(ErrorCode::PROTOCOL_ERROR, "expected CONTINUATION frame");
+    }
+
+    switch (header.type) {
+      case FrameType::DATA:
+        handleData(header, zc::mv(payload));
+        break;
+      case FrameType::HEADERS: {
+        if (header.streamId == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "HEADERS on stream 0");
+        auto block = stripPadding(header, payload, header.flags & FLAG_PRIORITY ? 5 : 0);
+        appendHeaderBlock(block);
+        continuationEndsStream = header.flags & FLAG_END_STREAM;
+        if (header.flags & FLAG_END_HEADERS) {
+          finishHeaders(header.streamId);
+        } else {
+          continuationStreamId = header.streamId;
+        }
+        break;
+      }
+      case FrameType::CONTINUATION:
+        if (continuationStreamId == 0) {
+          protocolError(ErrorCode::PROTOCOL_ERROR, "unexpected CONTINUATION frame");
+        }
+        appendHeaderBlock(payload);
+        if (header.flags & FLAG_END_HEADERS) {
+          continuationStreamId = 0;
+          finishHeaders(header.streamId);
+        }
+        break;
+      case FrameType::PRIORITY:
+        if (header.streamId == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "PRIORITY on stream 0");
+        break;
+      case FrameType::RST_STREAM:
+        handleRstStream(header, payload);
+        break;
+      case FrameType::SETTINGS:
+        handleSettings(header, payload);
+        break;
+      case FrameType::PUSH_PROMISE:
+        protocolError(ErrorCode::PROTOCOL_ERROR, "server push is disabled");
+      case FrameType::PING:
+        if (header.streamId != 0) protocolError(ErrorCode::PROTOCOL_ERROR, "PING on a stream");
+        if (payload.size() != 8) protocolError(ErrorCode::FRAME_SIZE_ERROR, "PING size");
+        if (!(header.flags & FLAG_ACK)) queueFrame(FrameType::PING, FLAG_ACK, 0, payload);
+        break;
+      case FrameType::GOAWAY:
+        handleGoAway(header, payload);
+        break;
+      case FrameType::WINDOW_UPDATE:
+        handleWindowUpdate(header, payload);
+        break;
+      default:
+        // RFC 9113 section 4.1: unknown frame types are ignored.
+        break;
+    }
+  }
+
+  bool isIdleStream(uint32_t streamId) {
+    // Has the stream never been opened, as opposed to having been closed?
+    if ((streamId % 2 == 1) == isClient) return streamId >= nextLocalStreamId();
+    return streamId > lastPeerStreamId;
+  }
+
+  virtual uint32_t nextLocalStreamId() { return 2; }
+
+  void handleData(const FrameHeader& header, zc::Array<byte> payload) {
+    if (header.streamId == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "DATA on stream 0");
+    auto data = stripPadding(header, payload, 0);
+
+    // The whole frame counts against the windows, padding included.
+    recvWindow -= payload.size();
+    if (recvWindow < 0) protocolError(ErrorCode::FLOW_CONTROL_ERROR, "connection window exceeded");
+    recvUnacked += payload.size();
+    if (recvUnacked >= settings.connectionWindowSize / 2) {
+      queueWindowUpdate(0, recvUnacked);
+      recvWindow += recvUnacked;
+      recvUnacked = 0;
+    }
+
+    Http2Stream* found = nullptr;
+    ZC_IF_SOME(s, findStream(header.streamId)) { found = &s; }
+    if (found == nullptr) {
+      if (isIdleStream(header.streamId)) {
+        protocolError(ErrorCode::PROTOCOL_ERROR, "DATA on idle stream");
+      }
+      // Probably a stream we reset; the peer may not have heard yet.
+      return;
+    }
+    auto stream = zc::addRef(*found);
+    if (stream->remoteClosed) {
+      resetStream(*stream, ErrorCode::STREAM_CLOSED, "DATA after END_STREAM");
+      return;
+    }
+
+    stream->recvWindow -= payload.size();
+    if (stream->recvWindow < 0) {
+      resetStream(*stream, ErrorCode::FLOW_CONTROL_ERROR, "peer exceeded stream window");
+      return;
+    }
+    ZC_IF_SOME(expected, stream->expectedLength) {
+      if (data.size() > expected || ((header.flags & FLAG_END_STREAM) && data.size() < expected)) {
+        resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "body doesn't match content-length");
+        return;
+      }
+      expected -= data.size();
+    }
+    // Padding is never read by the application, so credit it right away.
+    size_t padding = payload.size() - data.size();
+    if (padding > 0) credit(*stream, padding);
+
+    if (data.size() > 0) {
+      stream->received.push_back(Http2Stream::Chunk{zc::mv(payload), data});
+      Http2Stream::wake(stream->readWaiter);
+    }
+    if (header.flags & FLAG_END_STREAM) markRemoteClosed(*stream);
+  }
+
+  void appendHeaderBlock(zc::ArrayPtr<const byte> fragment) {
+    // Checked as each fragment arrives rather than at END_HEADERS, or a peer could grow the block
+    // without bound by never ending it. We can't decode only part of a block, nor skip it, since
+    // it may update the HPACK table.
+    if (headerBlock.size() + fragment.size() > settings.maxHeaderListSize * 2) {
+      protocolError(ErrorCode::PROTOCOL_ERROR, "header block too large");
+    }
+    headerBlock.addAll(fragment);
+  }
+
+  void finishHeaders(uint32_t streamId) {
+    zc::Maybe<zc::Array<HpackDecoder::Header>> fields;
+    ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() {
+                 fields = decoder.decode(headerBlock, settings.maxHeaderListSize);
+               })) {
+      protocolError(ErrorCode::COMPRESSION_ERROR, exception.getDescription());
+    }
+    headerBlock.clear();
+    onHeaders(streamId, zc::mv(fields), continuationEndsStream);
+  }
+
+  void handleRstStream(const FrameHeader& header, zc::ArrayPtr<const byte> payload) {
+    if (header.streamId == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "RST_STREAM on stream 0");
+    if (payload.size() != 4) protocolError(ErrorCode::FRAME_SIZE_ERROR, "RST_STREAM size");
+    if (isIdleStream(header.streamId)) {
+      protocolError(ErrorCode::PROTOCOL_ERROR, "RST_STREAM on idle stream");
+    }
+
+    ZC_IF_SOME(s, findStream(header.streamId)) {
+      auto stream = zc::addRef(s);
+      uint32_t code = readUint32(payload.begin());
+      stream->fail(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 stream reset by peer", code));
+      stream->localClosed = stream->remoteClosed = true;
+      removeStream(*stream);
+    }
+  }
+
+  void handleSettings(const FrameHeader& header, zc::ArrayPtr<const byte> payload) {
+    if (header.streamId != 0) protocolError(ErrorCode::PROTOCOL_ERROR, "SETTINGS on a stream");
+    if (header.flags & FLAG_ACK) {
+      if (payload.size() != 0) protocolError(ErrorCode::FRAME_SIZE_ERROR, "SETTINGS ACK size");
+      return;
+    }
+    if (payload.size() % 6 != 0) protocolError(ErrorCode::FRAME_SIZE_ERROR, "SETTINGS size");
+
+    for (size_t i = 0; i < payload.size(); i += 6) {
+      uint16_t id = (uint16_t(payload[i]) << 8) | payload[i + 1];
+      uint32_t value = readUint32(payload.begin() + i + 2);
+      switch (static_cast<SettingId>(id)) {
+        case SettingId::HEADER_TABLE_SIZE:
+          encoder.setMaxTableSize(value);
+          break;
+        case SettingId::ENABLE_PUSH:
+          if (value > 1) protocolError(ErrorCode::PROTOCOL_ERROR, "invalid ENABLE_PUSH");
+          break;
+        case SettingId::MAX_CONCURRENT_STREAMS:
+          peerMaxConcurrentStreams = value;
+          break;
+        case SettingId::INITIAL_WINDOW_SIZE: {
+          if (value > MAX_WINDOW_SIZE) {
+            protocolError(ErrorCode::FLOW_CONTROL_ERROR, "invalid INITIAL_WINDOW_SIZE");
+          }
+          // Section 6.9.2: the change applies to the windows of all open streams, which may even
+          // go negative.
+          int64_t delta = int64_t(value) - peerInitialWindowSize;
+          peerInitialWindowSize = value;
+          for (auto& entry : streams) {
+            entry.value->sendWindow += delta;
+            if (entry.value->sendWindow > MAX_WINDOW_SIZE) {
+              protocolError(ErrorCode::FLOW_CONTROL_ERROR, "stream window too large");
+            }
+            if (delta > 0) Http2Stream::wake(entry.value->writeWaiter);
+          }
+          break;
+        }
+        case SettingId::MAX_FRAME_SIZE:
+          if (value < 16384 || value > 16777215) {
+            protocolError(ErrorCode::PROTOCOL_ERROR, "invalid MAX_FRAME_SIZE");
+          }
+          peerMaxFrameSize = value;
+          break;
+        default:
+          // MAX_HEADER_LIST_SIZE is advisory, and unknown settings are ignored.
+          break;
+      }
+    }
+
+    queueFrame(FrameType::SETTINGS, FLAG_ACK, 0, nullptr);
+    onSettings();
+  }
+
+  void handleGoAway(const FrameHeader& header, zc::ArrayPtr<const byte> payload) {
+    if (header.streamId != 0) protocolError(ErrorCode::PROTOCOL_ERROR, "GOAWAY on a stream");
+    if (payload.size() < 8) protocolError(ErrorCode::FRAME_SIZE_ERROR, "GOAWAY size");
+    goAwayReceived = true;
+    uint32_t lastStreamId = readUint32(payload.begin()) & MAX_STREAM_ID;
+
+    // Our streams beyond the last one the peer will process were never seen, and can be retried
+    // elsewhere.
+    zc::Vector<zc::Own<Http2Stream>> unprocessed;
+    for (auto& entry : streams) {
+      if (entry.key > lastStreamId && (entry.key % 2 == 1) == isClient) {
+        unprocessed.add(zc::addRef(*entry.value));
+      }
+    }
+    for (auto& stream : unprocessed) {
+      stream->fail(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 server went away before the request"));
+      stream->localClosed = stream->remoteClosed = true;
+      removeStream(*stream);
+    }
+    onGoAway(lastStreamId);
+  }
+
+  void handleWindowUpdate(const FrameHeader& header, zc::ArrayPtr<const byte> payload) {
+    if (payload.size() != 4) protocolError(ErrorCode::FRAME_SIZE_ERROR, "WINDOW_UPDATE size");
+    uint32_t increment = readUint32(payload.begin()) & MAX_STREAM_ID;
+
+    if (header.streamId == 0) {
+      if (increment == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "zero WINDOW_UPDATE");
+      sendWindow += increment;
+      if (sendWindow > MAX_WINDOW_SIZE) {
+        protocolError(ErrorCode::FLOW_CONTROL_ERROR, "connection window too large");
+      }
+      for (auto& entry : streams) Http2Stream::wake(entry.value->writeWaiter);
+      return;
+    }
+
+    ZC_IF_SOME(s, findStream(header.streamId)) {
+      auto stream = zc::addRef(s);
+      if (increment == 0) {
+        resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "zero WINDOW_UPDATE");
+        return;
+      }
+      stream->sendWindow += increment;
+      if (stream->sendWindow > MAX_WINDOW_SIZE) {
+        resetStream(*stream, ErrorCode::FLOW_CONTROL_ERROR, "stream window too large");
+        return;
+      }
+      Http2Stream::wake(stream->writeWaiter);
+    }
+  }
+};
+
+static zc::ArrayPtr<const byte> stripPadding(const FrameHeader& header,
+                                             zc::ArrayPtr<const byte> payload, size_t skip) {
+  // Returns the part of a DATA or HEADERS payload after `skip` bytes, without padding.
+  size_t padding = 0;
+  if (header.flags & FLAG_PADDED) {
+    if (payload.size() == 0) {
+      zc::throwFatalException(ZC_EXCEPTION(FAILED, "HTTP/2 protocol error", "missing pad length"));
+    }
+    padding = payload[0];
+    payload = payload.slice(1, payload.size());
+  }
+  if (skip + padding > payload.size()) {
+    zc::throwFatalException(ZC_EXCEPTION(FAILED, "HTTP/2 protocol error", "too much padding"));
+  }
+  return payload.slice(skip, payload.size() - padding);
+}
+
+size_t Http2Stream::take(zc::ArrayPtr<byte> out) {
+  size_t n = 0;
+  while (n < out.size() && !received.empty()) {
+    auto& chunk = received.front();
+    size_t m = zc::min(out.size() - n, chunk.data.size());
+    memcpy(out.begin() + n, chunk.data.begin(), m);
+    chunk.data = chunk.data.slice(m, chunk.data.size());
+    n += m;
+    if (chunk.data.size() == 0) received.pop_front();
+  }
+  if (n > 0) {
+    ZC_IF_SOME(c, connection) { c.credit(*this, n); }
+  }
+  return n;
+}
+
+// =======================================================================================
+// Bodies
+
+class Http2InputStream final : public zc::AsyncInputStream {
+public:
+  explicit Http2InputStream(zc::Own<Http2Stream> stream) : stream(zc::mv(stream)) {}
+
+  ~Http2InputStream() noexcept(false) {
+    // Tell the peer to stop sending a body nobody will read.
+    if (!stream->remoteClosed && stream->error == zc::none) {
+      ZC_IF_SOME(c, stream->connection) {
+        c.resetStream(*stream, stream->localClosed ? ErrorCode::NO_ERROR : ErrorCode::CANCEL,
+                      "body stream dropped before the end");
+      }
+    }
+  }
+
+  zc::Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    return read(reinterpret_cast<byte*>(buffer), minBytes, maxBytes, 0);
+  }
+
+  zc::Maybe<uint64_t> tryGetLength() override {
+    if (stream->remoteClosed && stream->error == zc::none) {
+      uint64_t size = 0;
+      for (auto& chunk : stream->received) size += chunk.data.size();
+      return size;
+    }
+    return zc::none;
+  }
+
+private:
+  zc::Own<Http2Stream> stream;
+
+  zc::Promise<size_t> read(byte* buffer, size_t minBytes, size_t maxBytes, size_t alreadyRead) {
+    size_t n = stream->take(zc::arrayPtr(buffer, maxBytes));
+    alreadyRead += n;
+    if (n >= minBytes) return alreadyRead;
+    if (stream->received.empty()) {
+      stream->requireOk();
+      if (stream->remoteClosed) return alreadyRead;
+    }
+
+    return Http2Stream::wait(stream->readWaiter)
+        .then([this, buffer, minBytes, maxBytes, alreadyRead, n]() {
+          return read(buffer + n, minBytes - n, maxBytes - n, alreadyRead);
+        });
+  }
+};
+
+class Http2OutputStream final : public zc::AsyncOutputStream {
+public:
+  Http2OutputStream(zc::Own<Http2Stream> stream, zc::Maybe<uint64_t> expectedSize)
+      : stream(zc::mv(stream)), expectedSize(expectedSize) {}
+
+  ~Http2OutputStream() noexcept(false) {
+    if (stream->localClosed || stream->error != zc::none) return;
+    ZC_IF_SOME(c, stream->connection) {
+      ZC_IF_SOME(expected, expectedSize) {
+        if (written < expected) {
+          c.resetStream(*stream, ErrorCode::CANCEL, "body ended before its expected size");
+          return;
+        }
+      }
+      c.endStream(*stream);
+    }
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const byte> buffer) override {
+    if (buffer.size() == 0) return zc::READY_NOW;
+    bool end = false;
+    ZC_IF_SOME(expected, expectedSize) {
+      ZC_REQUIRE(written + buffer.size() <= expected, "overwrote expected body size");
+      end = written + buffer.size() == expected;
+    }
+    written += buffer.size();
+    return stream->getConnection().writeData(*stream, buffer, end);
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const zc::ArrayPtr<const byte>> pieces) override {
+    if (pieces.size() == 0) return zc::READY_NOW;
+    return write(pieces[0]).then(
+        [this, pieces]() { return write(pieces.slice(1, pieces.size())); });
+  }
+
+  zc::Promise<void> whenWriteDisconnected() override {
+    if (stream->error != zc::none) return zc::READY_NOW;
+    return Http2Stream::wait(stream->disconnectWaiter);
+  }
+
+private:
+  zc::Own<Http2Stream> stream;
+  zc::Maybe<uint64_t> expectedSize;
+  uint64_t written = 0;
+};
+
+class Http2NullBodyWriter final : public zc::AsyncOutputStream {
+public:
+  explicit Http2NullBodyWriter(bool discard) : discard(discard) {}
+
+  zc::Promise<void> write(zc::ArrayPtr<const byte> buffer) override {
+    if (discard) return zc::READY_NOW;
+    return ZC_EXCEPTION(FAILED, "HTTP message has no entity-body; can't write()");
+  }
+  zc::Promise<void> write(zc::ArrayPtr<const zc::ArrayPtr<const byte>> pieces) override {
+    if (discard) return zc::READY_NOW;
+    return ZC_EXCEPTION(FAILED, "HTTP message has no entity-body; can't write()");
+  }
+  zc::Promise<void> whenWriteDisconnected() override { return zc::NEVER_DONE; }
+
+private:
+  bool discard;  // for responses to HEAD, whose bodies are written only to be thrown away
+};
+
+// =======================================================================================
+// Header conversion
+
+static bool isConnectionSpecific(zc::StringPtr name) {
+  // RFC 9113 section 8.2.2: HTTP/2 has no use for these, and forbids them.
+  return name == "connection" || name == "keep-alive" || name == "proxy-connection" ||
+         name == "transfer-encoding" || name == "upgrade";
+}
+
+static zc::StringPtr lowercase(zc::StringPtr name, zc::Vector<zc::String>& storage) {
+  for (char c : name) {
+    if ('A' <= c && c <= 'Z') {
+      auto lower = zc::heapString(name);
+      for (char& d : lower) {
+        if ('A' <= d && d <= 'Z') d += 'a' - 'A';
+      }
+      return storage.add(zc::mv(lower));
+    }
+  }
+  return name;
+}
+
+static void addHeaderFields(const HttpHeaders& headers, zc::Vector<HpackEncoder::Field>& fields,
+                            zc::Vector<zc::String>& storage, bool skipContentLength) {
+  headers.forEach([&](zc::StringPtr name, zc::StringPtr value) {
+    auto lower = lowercase(name, storage);
+    if (isConnectionSpecific(lower) || lower == "host" ||
+        (lower == "te" && value != "trailers") ||
+        (skipContentLength && lower == "content-length")) {
+      return;
+    }
+    fields.add(HpackEncoder::Field{lower, value});
+  });
+}
+
+static bool isValidFieldName(zc::StringPtr name) {
+  // Lowercase tokens only; uppercase would make the message malformed (section 8.2.1).
+  if (name.size() == 0) return false;
+  for (char c : name) {
+    if (c <= ' ' || c >= 0x7f || ('A' <= c && c <= 'Z') || c == ':') return false;
+  }
+  return true;
+}
+
+static zc::Maybe<zc::String> addReceivedFields(HttpHeaders& headers,
+                                               zc::ArrayPtr<HpackDecoder::Header> fields,
+                                               zc::Maybe<uint64_t>& contentLength) {
+  // Adds the regular fields of a received header block to `headers`, which takes ownership of
+  // them. The pseudo-header fields must already have been taken out. Returns an error message if
+  // the block is malformed.
+
+  zc::Vector<zc::String> cookies;
+  for (auto& field : fields) {
+    if (field.name.startsWith(":")) return zc::str("misplaced pseudo-header field ", field.name);
+    if (!isValidFieldName(field.name)) return zc::str("invalid header name");
+    if (!HttpHeaders::isValidHeaderValue(field.value)) return zc::str("invalid header value");
+    if (isConnectionSpecific(field.name) || (field.name == "te" && field.value != "trailers")) {
+      return zc::str("connection-specific header field ", field.name);
+    }
+
+    if (field.name == "content-length") {
+      char* end;
+      uint64_t value = strtoull(field.value.cStr(), &end, 10);
+      if (field.value.size() == 0 || *end != '\0') return zc::str("invalid content-length");
+      ZC_IF_SOME(previous, contentLength) {
+        if (previous != value) return zc::str("conflicting content-length");
+        continue;
+      }
+      contentLength = value;
+    } else if (field.name == "cookie") {
+      // Section 8.2.3: a client may split cookies into several fields, to be rejoined with "; "
+      // (not the ", " that HttpHeaders::add() would join them with).
+      cookies.add(zc::mv(field.value));
+      continue;
+    }
+    headers.add(zc::mv(field.name), zc::mv(field.value));
+  }
+  if (cookies.size() > 0) headers.add(zc::str("cookie"), zc::strArray(cookies, "; "));
+  return zc::none;
+}
+
+// =======================================================================================
+// Client
+
+class Http2Client final : public HttpClient, public Http2Connection {
+public:
+  Http2Client(const HttpHeaderTable& responseHeaderTable, zc::AsyncIoStream& io,
+              zc::Own<zc::AsyncIoStream> ownIo, Http2Settings settings)
+      : Http2Connection(io, zc::mv(ownIo), settings, true),
+        responseHeaderTable(responseHeaderTable) {
+    getTasks().add(run());
+  }
+
+  ~Http2Client() noexcept(false) { getTasks().clear(); }
+
+  bool canSendRequests() {
+    return broken == zc::none && !goAwayReceived && nextStreamId <= MAX_STREAM_ID;
+  }
+
+  bool isIdle() { return streams.size() == 0 && waiting.empty(); }
+
+  Request request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                  zc::Maybe<uint64_t> expectedBodySize = zc::none) override {
+    ZC_IF_SOME(e, broken) { zc::throwFatalException(zc::cp(e)); }
+    if (!canSendRequests()) {
+      zc::throwFatalException(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 connection is going away"));
+    }
+
+    auto stream = zc::refcounted<Stream>(*this, peerInitialWindowSize);
+
+    // The header block may have to wait until there are few enough streams open, so the stream
+    // keeps its own copy of the fields.
+    auto& fields = stream->fields;
+    auto& storage = stream->storage;
+    zc::StringPtr scheme = "https";
+    zc::Maybe<zc::StringPtr> authority = headers.get(HttpHeaderId::HOST);
+    zc::StringPtr path = url;
+    for (zc::StringPtr prefix : {"http://"_zc, "https://"_zc}) {
+      if (url.startsWith(prefix)) {
+        scheme = prefix == "http://" ? "http"_zc : "https"_zc;
+        auto rest = url.slice(prefix.size());
+        size_t slash = rest.findFirst('/').orDefault(rest.size());
+        authority = storage.add(zc::str(rest.first(slash)));
+        path = slash < rest.size() ? rest.slice(slash) : "/"_zc;
+        break;
+      }
+    }
+    fields.add(HpackEncoder::Field{":method", storage.add(zc::str(method))});
+    fields.add(HpackEncoder::Field{":scheme", storage.add(zc::str(scheme))});
+    ZC_IF_SOME(a, authority) {
+      fields.add(HpackEncoder::Field{":authority", storage.add(zc::str(a))});
+    }
+    fields.add(HpackEncoder::Field{":path", storage.add(zc::str(path))});
+
+    bool hasBody = expectedBodySize.orDefault(1) > 0 &&
+                   !(expectedBodySize == zc::none &&
+                     (method == HttpMethod::GET || method == HttpMethod::HEAD));
+    ZC_IF_SOME(size, expectedBodySize) {
+      if (size > 0 || (method != HttpMethod::GET && method != HttpMethod::HEAD)) {
+        fields.add(HpackEncoder::Field{"content-length", storage.add(zc::str(size))});
+      }
+    }
+    addHeaderFields(headers, fields, storage, expectedBodySize != zc::none);
+    // The values the fields point to must outlive this call.
+    for (auto& field : fields) {
+      if (!isOwned(field.name, storage)) field.name = storage.add(zc::str(field.name));
+      if (!isOwned(field.value, storage)) field.value = storage.add(zc::str(field.value));
+    }
+
+    stream->isHead = method == HttpMethod::HEAD;
+    stream->localClosed = !hasBody;
+    auto paf = zc::newPromiseAndFulfiller<Response>();
+    stream->response = zc::mv(paf.fulfiller);
+
+    waiting.push_back(zc::addRef(*stream));
+    openWaiting();
+
+    zc::Own<zc::AsyncOutputStream> body;
+    if (hasBody) {
+      body = zc::heap<Http2OutputStream>(zc::mv(stream), expectedBodySize);
+    } else {
+      body = zc::heap<Http2NullBodyWriter>(false);
+    }
+    return {zc::mv(body), zc::mv(paf.promise)};
+  }
+
+private:
+  class Stream final : public Http2Stream {
+  public:
+    Stream(Http2Client& client, int64_t sendWindow)
+        : Http2Stream(client, sendWindow, client.settings.initialWindowSize) {}
+
+    zc::Vector<HpackEncoder::Field> fields;
+    zc::Vector<zc::String> storage;
+    bool isHead = false;
+    zc::Maybe<zc::Own<zc::PromiseFulfiller<Response>>> response;
+
+    void onFailed(const zc::Exception& exception) override {
+      ZC_IF_SOME(r, response) { r->reject(zc::cp(exception)); }
+      response = zc::none;
+    }
+  };
+
+  const HttpHeaderTable& responseHeaderTable;
+  uint32_t nextStreamId = 1;
+  std::deque<zc::Own<Stream>> waiting;  // requests waiting for a stream
+
+  static bool isOwned(zc::StringPtr s, zc::Vector<zc::String>& storage) {
+    // Is `s` one of the strings in `storage`, or a literal? Either way, it will stay put.
+    for (auto& owned : storage) {
+      if (s.begin() == owned.begin()) return true;
+    }
+    return s == ":method" || s == ":scheme" || s == ":authority" || s == ":path" ||
+           s == "content-length";
+  }
+
+  uint32_t nextLocalStreamId() override { return nextStreamId; }
+
+  void openWaiting() {
+    while (!waiting.empty() && streams.size() < peerMaxConcurrentStreams &&
+           broken == zc::none && !goAwayReceived) {
+      auto stream = zc::mv(waiting.front());
+      waiting.pop_front();
+      if (stream->error != zc::none) continue;
+      if (nextStreamId > MAX_STREAM_ID) {
+        stream->fail(ZC_EXCEPTION(DISCONNECTED, "HTTP/2 connection ran out of stream IDs"));
+        continue;
+      }
+
+      stream->id = nextStreamId;
+      nextStreamId += 2;
+      stream->sendWindow = peerInitialWindowSize;
+      addStream(*stream);
+      queueHeaders(stream->id, stream->fields, stream->localClosed);
+      stream->fields.clear();
+      stream->storage.clear();
+      Http2Stream::wake(stream->openWaiter);
+    }
+  }
+
+  void onStreamRemoved() override { openWaiting(); }
+  void onSettings() override { openWaiting(); }
+
+  void onGoAway(uint32_t lastStreamId) override {
+    auto exception = ZC_EXCEPTION(DISCONNECTED, "HTTP/2 server went away before the request");
+    for (auto& stream : waiting) stream->fail(exception);
+    waiting.clear();
+  }
+
+  void onFailed(const zc::Exception& exception) override {
+    for (auto& stream : waiting) {
+      stream->connection = zc::none;
+      stream->fail(exception);
+    }
+    waiting.clear();
+  }
+
+  void onHeaders(uint32_t streamId, zc::Maybe<zc::Array<HpackDecoder::Header>> maybeFields,
+                 bool endStream) override {
+    if (streamId % 2 == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "HEADERS on a server stream");
+    Stream* found = nullptr;
+    ZC_IF_SOME(s, findStream(streamId)) { found = &zc::downcast<Stream>(s); }
+    if (found == nullptr) {
+      if (streamId >= nextStreamId) {
+        protocolError(ErrorCode::PROTOCOL_ERROR, "HEADERS on idle stream");
+      }
+      return;  // a stream we reset
+    }
+    auto stream = zc::addRef(*found);
+    if (stream->remoteClosed) {
+      resetStream(*stream, ErrorCode::STREAM_CLOSED, "HEADERS after END_STREAM");
+      return;
+    }
+
+    if (stream->response == zc::none) {
+      // Trailers, which we don't pass on.
+      if (!endStream) {
+        resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "trailers without END_STREAM");
+        return;
+      }
+      markRemoteClosed(*stream);
+      return;
+    }
+
+    auto& fields = ZC_UNWRAP_OR(maybeFields, {
+      resetStream(*stream, ErrorCode::CANCEL, "response headers too large");
+      return;
+    });
+
+    zc::Maybe<uint> statusCode;
+    size_t i = 0;
+    for (; i < fields.size() && fields[i].name.startsWith(":"); i++) {
+      char* end;
+      uint status = strtoul(fields[i].value.cStr(), &end, 10);
+      if (fields[i].name != ":status" || statusCode != zc::none || fields[i].value.size() != 3 ||
+          *end != '\0') {
+        resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "invalid response pseudo-header fields");
+        return;
+      }
+      statusCode = status;
+    }
+    uint status = ZC_UNWRAP_OR(statusCode, {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "response without :status");
+      return;
+    });
+    if (status < 200) {
+      // Informational; the real response follows.
+      if (endStream) resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "END_STREAM on 1xx response");
+      return;
+    }
+
+    auto headers = zc::heap<HttpHeaders>(responseHeaderTable);
+    zc::Maybe<uint64_t> contentLength;
+    ZC_IF_SOME(error, addReceivedFields(*headers, fields.slice(i, fields.size()), contentLength)) {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, error);
+      return;
+    }
+    if (!stream->isHead && status != 204 && status != 304) {
+      stream->expectedLength = contentLength;
+    }
+
+    auto& headersRef = *headers;
+    auto fulfiller = ZC_ASSERT_NONNULL(zc::mv(stream->response));
+    stream->response = zc::none;
+    if (endStream) markRemoteClosed(*stream);
+    fulfiller->fulfill(Response{status, "", &headersRef,
+                                zc::heap<Http2InputStream>(zc::addRef(*stream)).attach(
+                                    zc::mv(headers))});
+  }
+};
+
+class NetworkAddressHttp2Client final : public HttpClient {
+  // Sends requests over one HTTP/2 connection to the address, opening a new one when that fails
+  // or goes away.
+
+public:
+  NetworkAddressHttp2Client(const HttpHeaderTable& responseHeaderTable, zc::NetworkAddress& address,
+                            Http2Settings settings)
+      : responseHeaderTable(responseHeaderTable), address(address), settings(settings) {}
+
+  Request request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                  zc::Maybe<uint64_t> expectedBodySize = zc::none) override {
+    ZC_IF_SOME(c, getClient()) { return c.request(method, url, headers, expectedBodySize); }
+
+    // As in PromiseNetworkAddressHttpClient, wait for the connection, then make the request.
+    auto combined = connect().then(
+        [this, method, expectedBodySize, url = zc::str(url), headers = headers.clone()]()
+            -> zc::Tuple<zc::Own<zc::AsyncOutputStream>, zc::Promise<Response>> {
+          auto& client = ZC_REQUIRE_NONNULL(getClient(), "HTTP/2 connection already went away");
+          auto req = client.request(method, url, headers, expectedBodySize);
+          return zc::tuple(zc::mv(req.body), zc::mv(req.response));
+        });
+    auto split = combined.split();
+    return {newPromisedStream(zc::mv(zc::get<0>(split))), zc::mv(zc::get<1>(split))};
+  }
+
+private:
+  const HttpHeaderTable& responseHeaderTable;
+  zc::NetworkAddress& address;
+  Http2Settings settings;
+
+  zc::Maybe<zc::Own<Http2Client>> current;
+  zc::Vector<zc::Own<Http2Client>> retired;
+  // Connections that went away with requests still in flight, kept until those finish.
+
+  zc::Maybe<zc::ForkedPromise<void>> connecting;
+  bool connectFailed = false;
+
+  zc::Maybe<Http2Client&> getClient() {
+    ZC_IF_SOME(c, current) {
+      if (c->canSendRequests()) return *c;
+      retired.add(zc::mv(c));
+      current = zc::none;
+    }
+    for (size_t i = 0; i < retired.size();) {
+      if (retired[i]->isIdle()) {
+        retired[i] = zc::mv(retired.back());
+        retired.removeLast();
+      } else {
+        i++;
+      }
+    }
+    return zc::none;
+  }
+
+  zc::Promise<void> connect() {
+    ZC_IF_SOME(c, connecting) {
+      if (!connectFailed) return c.addBranch();
+    }
+    connectFailed = false;
+    connecting = address.connect()
+                     .then([this](zc::Own<zc::AsyncIoStream> stream) {
+                       auto& ref = *stream;
+                       current = zc::heap<Http2Client>(responseHeaderTable, ref, zc::mv(stream),
+                                                       settings);
+                     }, [this](zc::Exception&& exception) {
+                       connectFailed = true;
+                       zc::throwFatalException(zc::mv(exception));
+                     })
+                     .fork();
+    return ZC_ASSERT_NONNULL(connecting).addBranch();
+  }
+};
+
+}  // namespace
+
+// =======================================================================================
+// Server
+
+class Http2Server::Connection final : public Http2Connection {
+public:
+  Connection(Http2Server& server, zc::AsyncIoStream& io, zc::Own<zc::AsyncIoStream> ownIo)
+      : Http2Connection(io, zc::mv(ownIo), server.settings, false), server(server) {
+    server.connections.add(this);
+  }
+
+  ~Connection() noexcept(false) {
+    getTasks().clear();
+    for (size_t i = 0; i < server.connections.size(); i++) {
+      if (server.connections[i] == this) {
+        server.connections[i] = server.connections.back();
+        server.connections.removeLast();
+        break;
+      }
+    }
+    if (server.draining && server.connections.size() == 0) {
+      for (auto& fulfiller : server.drainFulfillers) fulfiller->fulfill();
+      server.drainFulfillers.clear();
+    }
+  }
+
+  zc::Promise<void> listen() {
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    drained = zc::mv(paf.fulfiller);
+    if (server.draining) drain();
+    return run().exclusiveJoin(zc::mv(paf.promise));
+  }
+
+  void drain() {
+    queueGoAway(ErrorCode::NO_ERROR);
+    maybeFinishDrain();
+  }
+
+private:
+  class Stream final : public Http2Stream, public HttpService::Response {
+  public:
+    Stream(Connection& connection, uint32_t id)
+        : Http2Stream(connection, connection.peerInitialWindowSize,
+                      connection.settings.initialWindowSize),
+          owner(connection) {
+      this->id = id;
+    }
+
+    Connection& owner;
+    bool isHead = false;
+    bool responded = false;
+    zc::Canceler canceler;
+
+    zc::Own<zc::AsyncOutputStream> send(uint statusCode, zc::StringPtr statusText,
+                                        const HttpHeaders& headers,
+                                        zc::Maybe<uint64_t> expectedBodySize) override {
+      ZC_REQUIRE(!responded, "already called send()");
+      responded = true;
+      requireOk();
+      auto& c = owner;
+
+      zc::Vector<HpackEncoder::Field> fields;
+      zc::Vector<zc::String> storage;
+      fields.add(HpackEncoder::Field{":status", storage.add(zc::str(statusCode))});
+      ZC_IF_SOME(size, expectedBodySize) {
+        fields.add(HpackEncoder::Field{"content-length", storage.add(zc::str(size))});
+      }
+      addHeaderFields(headers, fields, storage, expectedBodySize != zc::none);
+
+      bool noBody = isHead || statusCode == 204 || statusCode == 304 ||
+                    expectedBodySize.orDefault(1) == 0;
+      c.queueHeaders(id, fields, noBody);
+      if (noBody) {
+        owner.markLocalClosed(*this);
+        return zc::heap<Http2NullBodyWriter>(isHead);
+      }
+      return zc::heap<Http2OutputStream>(zc::addRef(*this), expectedBodySize);
+    }
+
+    zc::Own<WebSocket> acceptWebSocket(const HttpHeaders& headers) override {
+      ZC_UNIMPLEMENTED("WebSockets over HTTP/2 are not supported");
+    }
+
+    void onFailed(const zc::Exception& exception) override {
+      // Cancel the service's request, but not right away: we may be inside one of its callbacks.
+      owner.getTasks().add(zc::evalLater(
+          [self = zc::addRef(*this), exception = zc::cp(exception)]() mutable {
+            self->canceler.cancel(exception);
+          }));
+    }
+  };
+
+  Http2Server& server;
+  zc::Own<zc::PromiseFulfiller<void>> drained;
+  uint activeRequests = 0;
+
+  void maybeFinishDrain() {
+    if (goAwaySent && activeRequests == 0 && drained->isWaiting()) {
+      getTasks().add(close().then([this]() { drained->fulfill(); },
+                                  [this](zc::Exception&& e) { drained->reject(zc::mv(e)); }));
+    }
+  }
+
+  uint32_t nextLocalStreamId() override { return 2; }
+
+  void respond(Stream& stream, uint statusCode, zc::StringPtr statusText) {
+    // Responds without involving the service, to a request it never saw. The task keeps the
+    // stream until the response is written, since flow control may hold back its body.
+    ++activeRequests;
+    auto promise = stream.sendError(statusCode, statusText, server.requestHeaderTable);
+    getTasks().add(stream.canceler.wrap(zc::mv(promise))
+                       .attach(zc::defer([this]() {
+                         --activeRequests;
+                         maybeFinishDrain();
+                       }),
+                               zc::addRef(stream)));
+  }
+
+  void onHeaders(uint32_t streamId, zc::Maybe<zc::Array<HpackDecoder::Header>> maybeFields,
+                 bool endStream) override {
+    if (streamId % 2 == 0) protocolError(ErrorCode::PROTOCOL_ERROR, "HEADERS on a server stream");
+
+    if (streamId <= lastPeerStreamId) {
+      ZC_IF_SOME(s, findStream(streamId)) {
+        // Trailers, which we don't pass on.
+        auto stream = zc::addRef(s);
+        if (stream->remoteClosed) {
+          resetStream(*stream, ErrorCode::STREAM_CLOSED, "HEADERS after END_STREAM");
+        } else if (!endStream) {
+          resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "trailers without END_STREAM");
+        } else {
+          markRemoteClosed(*stream);
+        }
+        return;
+      }
+      // A stream that's done with, maybe one we reset.
+      return;
+    }
+    lastPeerStreamId = streamId;
+
+    if (goAwaySent || streams.size() >= settings.maxConcurrentStreams) {
+      queueRstStream(streamId, ErrorCode::REFUSED_STREAM);
+      return;
+    }
+
+    auto stream = zc::refcounted<Stream>(*this, streamId);
+    addStream(*stream);
+    if (endStream) stream->remoteClosed = true;
+
+    auto& fields = ZC_UNWRAP_OR(maybeFields, {
+      respond(*stream, 431, "Request Header Fields Too Large");
+      return;
+    });
+
+    // Section 8.3.1: the pseudo-header fields come first, each once.
+    zc::Maybe<zc::String> method, scheme, path, authority;
+    size_t i = 0;
+    for (; i < fields.size() && fields[i].name.startsWith(":"); i++) {
+      auto& field = fields[i];
+      zc::Maybe<zc::String>* slot = nullptr;
+      if (field.name == ":method") {
+        slot = &method;
+      } else if (field.name == ":scheme") {
+        slot = &scheme;
+      } else if (field.name == ":path") {
+        slot = &path;
+      } else if (field.name == ":authority") {
+        slot = &authority;
+      }
+      if (slot == nullptr || *slot != zc::none) {
+        resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "invalid request pseudo-header fields");
+        return;
+      }
+      *slot = zc::mv(field.value);
+    }
+
+    auto& methodName = ZC_UNWRAP_OR(method, {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "request without :method");
+      return;
+    });
+    if (methodName == "CONNECT") {
+      respond(*stream, 501, "Not Implemented");
+      return;
+    }
+    auto& url = ZC_UNWRAP_OR(path, {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "request without :path");
+      return;
+    });
+    if (scheme == zc::none || url.size() == 0) {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "request without :scheme or :path");
+      return;
+    }
+    auto parsedMethod = ZC_UNWRAP_OR(tryParseHttpMethod(methodName), {
+      respond(*stream, 501, "Not Implemented");
+      return;
+    });
+    stream->isHead = parsedMethod == HttpMethod::HEAD;
+
+    auto headers = zc::heap<HttpHeaders>(server.requestHeaderTable);
+    zc::Maybe<uint64_t> contentLength;
+    ZC_IF_SOME(error, addReceivedFields(*headers, fields.slice(i, fields.size()), contentLength)) {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, error);
+      return;
+    }
+    ZC_IF_SOME(a, authority) {
+      // Section 8.3.1: :authority stands in for Host, which applications look for.
+      if (headers->get(HttpHeaderId::HOST) == zc::none) {
+        headers->set(HttpHeaderId::HOST, zc::mv(a));
+      }
+    }
+    if (endStream && contentLength.orDefault(0) != 0) {
+      resetStream(*stream, ErrorCode::PROTOCOL_ERROR, "body doesn't match content-length");
+      return;
+    }
+    stream->expectedLength = contentLength;
+
+    auto body = zc::heap<Http2InputStream>(zc::addRef(*stream));
+    ++activeRequests;
+    auto& s = *stream;
+    auto promise =
+        zc::evalNow([&]() { return server.service.request(parsedMethod, url, *headers, *body, s); })
+            .then([this, &s]() { return finish(s); },
+                  [this, &s](zc::Exception&& exception) { return finish(s, zc::mv(exception)); })
+            .attach(zc::mv(body), zc::mv(headers), zc::mv(url));
+    // The stream owns the canceler, so it must outlive the wrapped promise.
+    getTasks().add(s.canceler.wrap(zc::mv(promise))
+                       .attach(zc::defer([this]() {
+                         --activeRequests;
+                         maybeFinishDrain();
+                       }),
+                               zc::mv(stream)));
+  }
+
+  zc::Promise<void> finish(Stream& stream) {
+    if (!stream.responded) {
+      if (stream.error != zc::none) return zc::READY_NOW;
+      return stream.sendError(500, "Internal Server Error", server.requestHeaderTable);
+    }
+    return zc::READY_NOW;
+  }
+
+  zc::Promise<void> finish(Stream& stream, zc::Exception&& exception) {
+    if (exception.getType() == zc::Exception::Type::DISCONNECTED) {
+      if (stream.connection != zc::none) resetStream(stream, ErrorCode::CANCEL, "disconnected");
+      return zc::READY_NOW;
+    }
+    ZC_LOG(INFO, "threw exception while serving HTTP/2 response", exception);
+
+    if (stream.responded || stream.connection == zc::none) {
+      if (stream.connection != zc::none) {
+        resetStream(stream, ErrorCode::INTERNAL_ERROR, "exception while serving response");
+      }
+      return zc::READY_NOW;
+    }
+
+    switch (exception.getType()) {
+      case zc::Exception::Type::OVERLOADED:
+        return stream.sendError(503, "Service Unavailable", server.requestHeaderTable);
+      case zc::Exception::Type::UNIMPLEMENTED:
+        return stream.sendError(501, "Not Implemented", server.requestHeaderTable);
+      default:
+        return stream.sendError(500, "Internal Server Error", server.requestHeaderTable);
+    }
+  }
+};
+
+Http2Server::Http2Server(const HttpHeaderTable& requestHeaderTable, HttpService& service,
+                         Http2Settings settings)
+    : requestHeaderTable(requestHeaderTable), service(service), settings(settings) {}
+
+Http2Server::~Http2Server() noexcept(false) {
+  ZC_ASSERT(connections.size() == 0, "Http2Server destroyed while connections still exist");
+}
+
+zc::Promise<void> Http2Server::listenHttp(zc::Own<zc::AsyncIoStream> connection) {
+  auto& stream = *connection;
+  auto conn = zc::heap<Connection>(*this, stream, zc::mv(connection));
+  auto promise = conn->listen();
+  return promise.attach(zc::mv(conn));
+}
+
+zc::Promise<void> Http2Server::drain() {
+  draining = true;
+  for (auto connection : connections) connection->drain();
+  if (connections.size() == 0) return zc::READY_NOW;
+  auto paf = zc::newPromiseAndFulfiller<void>();
+  drainFulfillers.add(zc::mv(paf.fulfiller));
+  return zc::mv(paf.promise);
+}
+
+zc::Own<HttpClient> newHttp2Client(const HttpHeaderTable& responseHeaderTable,
+                                   zc::AsyncIoStream& stream, Http2Settings settings) {
+  return zc::heap<Http2Client>(responseHeaderTable, stream, zc::Own<zc::AsyncIoStream>(), settings);
+}
+
+zc::Own<HttpClient> newHttp2Client(const HttpHeaderTable& responseHeaderTable,
+                                   zc::NetworkAddress& addr, Http2Settings settings) {
+  return zc::heap<NetworkAddressHttp2Client>(responseHeaderTable, addr, settings);
+}
+
+}  // namespace zc
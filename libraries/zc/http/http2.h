@@ -0,0 +1,190 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+// HTTP/2 (RFC 9113) for the ZC HTTP library.
+//
+// Requests and responses carried over HTTP/2 go through the same HttpClient and HttpService
+// interfaces as HTTP/1.1, so applications needn't care which of the two they're speaking. Any
+// number of requests share one connection, each on its own stream, so a slow response doesn't hold
+// up the others the way it would on an HTTP/1.1 connection.
+//
+// Over TLS, HTTP/2 is negotiated with ALPN: offer {"h2", "http/1.1"} in
+// TlsContext::Options::alpnProtocols, then hand each connection on which
+// TlsPeerIdentity::getAlpnProtocol() comes out as "h2" to Http2Server::listenHttp() and any other
+// to HttpServer::listenHttp(). Over cleartext, both ends must know in advance that they'll speak
+// HTTP/2 ("prior knowledge"); the upgrade from HTTP/1.1 is not supported.
+//
+// Not supported either: server push, WebSockets and CONNECT tunnels over HTTP/2, and stream
+// priorities, which are ignored.
+
+#include "zc/http/http.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+struct Http2Settings {
+  // Settings we announce to the peer. They limit what the peer may send us; what we send is
+  // limited by the settings the peer announces.
+
+  uint maxConcurrentStreams = 100;
+  // The most streams the peer may have open at once. A server refuses streams beyond this; for a
+  // client it's moot, since servers can't open streams without server push.
+
+  uint initialWindowSize = 1 << 20;
+  // How many bytes of each stream's body the peer may send ahead of the application reading them.
+
+  uint connectionWindowSize = 16 << 20;
+  // Likewise for all streams of the connection put together. This is returned to the peer as soon
+  // as data arrives, rather than as the application reads it, so that a stream whose reader is
+  // slow can't hold up the others -- initialWindowSize already limits how much of it we buffer.
+
+  uint maxFrameSize = 16384;
+  // The largest frame payload the peer may send. HTTP/2 requires 16384 to 16777215.
+
+  uint headerTableSize = 4096;
+  // The size of the HPACK table for header fields the peer sends us.
+
+  uint maxHeaderListSize = 65536;
+  // The most header data the peer may send with a request or response, counting each field as its
+  // name and value plus 32 bytes. Servers reply to requests with more with 431 Request Header
+  // Fields Too Large.
+};
+
+class HpackDecoder {
+  // Decodes header blocks compressed with HPACK (RFC 7541). There's one per connection and
+  // direction, since blocks refer to fields in earlier blocks.
+
+public:
+  explicit HpackDecoder(size_t maxTableSize = 4096);
+  ZC_DISALLOW_COPY_AND_MOVE(HpackDecoder);
+  ~HpackDecoder() noexcept(false);
+
+  struct Header {
+    zc::String name;
+    zc::String value;
+  };
+
+  zc::Maybe<zc::Array<Header>> decode(zc::ArrayPtr<const byte> block, size_t maxListSize);
+  // Decodes one complete header block. Returns none if the fields add up to more than
+  // `maxListSize`, counted as for Http2Settings::maxHeaderListSize; the block is still decoded
+  // all the way, since the fields it adds to the table are needed by later blocks. Throws if the
+  // block is malformed, after which the decoder can't be used further.
+
+  size_t getTableSize() const;
+  // The current size of the dynamic table, counted as in RFC 7541 section 4.1.
+
+private:
+  struct Table;
+  zc::Own<Table> table;
+};
+
+class HpackEncoder {
+  // Encodes header blocks with HPACK (RFC 7541), the counterpart of HpackDecoder.
+
+public:
+  explicit HpackEncoder(size_t maxTableSize = 4096);
+  ZC_DISALLOW_COPY_AND_MOVE(HpackEncoder);
+  ~HpackEncoder() noexcept(false);
+
+  struct Field {
+    zc::StringPtr name;  // must be lowercase
+    zc::StringPtr value;
+  };
+
+  void encode(zc::Vector<byte>& out, zc::ArrayPtr<const Field> fields);
+  // Appends a header block holding `fields` to `out`. Blocks must reach the peer in the order
+  // they were encoded.
+  //
+  // Fields are added to the dynamic table for later blocks to refer to, except for credentials
+  // (`authorization`, `cookie` and the like), which are never added, so that they can't be
+  // guessed by probing the table's contents.
+
+  void setMaxTableSize(size_t size);
+  // Applies the peer's SETTINGS_HEADER_TABLE_SIZE. The table never grows beyond the size given to
+  // the constructor regardless.
+
+private:
+  struct Table;
+  zc::Own<Table> table;
+};
+
+class Http2Server final {
+  // Serves HTTP/2 connections, directing the requests on them to an HttpService.
+
+public:
+  Http2Server(const HttpHeaderTable& requestHeaderTable, HttpService& service,
+              Http2Settings settings = Http2Settings());
+  ~Http2Server() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(Http2Server);
+
+  zc::Promise<void> listenHttp(zc::Own<zc::AsyncIoStream> connection);
+  // Serves requests on the given connection, which must begin with the HTTP/2 connection preface.
+  // Resolves once the client has closed the connection, or it has been drained. Throws if the
+  // client breaks the protocol or some I/O error occurs. Dropping the promise closes the
+  // connection, canceling in-flight requests.
+  //
+  // Requests whose service promise rejects before a response has been sent get a 500 Internal
+  // Server Error (503 for OVERLOADED, 501 for UNIMPLEMENTED); the others have their stream reset.
+
+  zc::Promise<void> drain();
+  // Tells the clients of all connections that no more requests will be accepted, then closes each
+  // connection once its in-flight requests are complete. Resolves once all connections are closed.
+
+private:
+  class Connection;
+
+  const HttpHeaderTable& requestHeaderTable;
+  HttpService& service;
+  Http2Settings settings;
+
+  bool draining = false;
+  zc::Vector<Connection*> connections;
+  zc::Vector<zc::Own<zc::PromiseFulfiller<void>>> drainFulfillers;
+};
+
+zc::Own<HttpClient> newHttp2Client(const HttpHeaderTable& responseHeaderTable,
+                                   zc::AsyncIoStream& stream,
+                                   Http2Settings settings = Http2Settings());
+// Creates an HttpClient that speaks HTTP/2 over the given pre-established connection, on which it
+// sends the connection preface first thing. Requests run concurrently, up to the limit the server
+// announces; beyond that they wait their turn. Once the connection fails or the server closes
+// it, all requests fail.
+//
+// Requests whose `url` is just a path go out with the `https` scheme, HTTP/2 being used over TLS
+// almost everywhere; pass a full URL to use another.
+//
+// The returned client must outlive the bodies of its requests and responses.
+
+zc::Own<HttpClient> newHttp2Client(const HttpHeaderTable& responseHeaderTable,
+                                   zc::NetworkAddress& addr,
+                                   Http2Settings settings = Http2Settings());
+// Creates an HttpClient that sends all requests over one HTTP/2 connection to the given address,
+// which it opens on the first request. When the connection fails or the server closes it, the
+// client opens a new one for the next request, leaving requests already sent to finish on the old
+// one. Use TlsContext::wrapAddress() with "h2" among the context's `alpnProtocols` for HTTPS.
+//
+// The returned client must outlive the bodies of its requests and responses.
+
+}  // namespace zc
+
+ZC_END_HEADER
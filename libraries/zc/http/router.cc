@@ -0,0 +1,330 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/http/router.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "zc/core/debug.h"
+#include "zc/core/encoding.h"
+#include "zc/core/map.h"
+#include "zc/http/url.h"
+
+namespace zc {
+
+namespace {
+
+zc::Maybe<zc::ArrayPtr<const char>> nextSegment(zc::ArrayPtr<const char>& path) {
+  // Consumes and returns the next non-empty segment of `path`, if any.
+  while (path.size() > 0 && path[0] == '/') path = path.slice(1, path.size());
+  if (path.size() == 0) return zc::none;
+
+  size_t size = 1;
+  while (size < path.size() && path[size] != '/') ++size;
+  auto segment = path.first(size);
+  path = path.slice(size, path.size());
+  return segment;
+}
+
+int compareSegments(zc::ArrayPtr<const char> a, zc::ArrayPtr<const char> b) {
+  int result = memcmp(a.begin(), b.begin(), zc::min(a.size(), b.size()));
+  if (result != 0) return result;
+  return a.size() < b.size() ? -1 : a.size() > b.size() ? 1 : 0;
+}
+
+}  // namespace
+
+// =======================================================================================
+
+struct HttpRouter::Route {
+  struct Condition {
+    HttpHeaderId id;
+    zc::String value;
+  };
+
+  zc::Maybe<HttpMethod> method;
+  zc::Array<Condition> headers;
+  zc::Array<zc::String> paramNames;  // in the order the path captures them
+  Handler& handler;
+};
+
+struct HttpRouter::Edge {
+  zc::Array<zc::String> segments;
+  // The literal segments leading to `node`: more than one where a chain of them has no
+  // alternatives. Edges out of a node differ in their first segment, by which they're sorted.
+
+  uint node;
+};
+
+struct HttpRouter::Node {
+  zc::Array<Edge> edges;
+  zc::Maybe<uint> param;           // the node reached by capturing one segment
+  zc::Array<uint> routes;          // routes ending here, in the order they were added
+  zc::Array<uint> wildcardRoutes;  // routes capturing whatever follows
+};
+
+struct HttpRouter::MatchState {
+  HttpMethod method;
+  const HttpHeaders& headers;
+  Params& params;
+  bool methodMismatch = false;
+};
+
+struct HttpRouter::Builder::TrieNode {
+  zc::HashMap<zc::String, zc::Own<TrieNode>> literals;
+  zc::Maybe<zc::Own<TrieNode>> param;
+  zc::Vector<uint> routes;
+  zc::Vector<uint> wildcardRoutes;
+};
+
+HttpRouter::Builder::Builder(const HttpHeaderTable& headerTable)
+    : headerTable(headerTable), root(zc::heap<TrieNode>()) {}
+HttpRouter::Builder::~Builder() noexcept(false) {}
+
+HttpRouter::Builder& HttpRouter::Builder::add(zc::Maybe<HttpMethod> method, zc::StringPtr pattern,
+                                              Handler& handler) {
+  return add(method, pattern, nullptr, handler);
+}
+
+HttpRouter::Builder& HttpRouter::Builder::add(zc::Maybe<HttpMethod> method, zc::StringPtr pattern,
+                                              zc::ArrayPtr<const HeaderCondition> headers,
+                                              Handler& handler) {
+  ZC_REQUIRE(root.get() != nullptr, "HttpRouter::Builder was already built");
+  ZC_REQUIRE(pattern.startsWith("/"), "route pattern must start with '/'", pattern);
+
+  zc::Vector<zc::String> paramNames;
+  TrieNode* node = root.get();
+  bool wildcard = false;
+
+  auto rest = pattern.asArray();
+  for (;;) {
+    ZC_IF_SOME(segment, nextSegment(rest)) {
+      ZC_REQUIRE(!wildcard, "wildcard must be the last segment of a route pattern", pattern);
+      if (segment[0] == ':' || segment[0] == '*') {
+        ZC_REQUIRE(segment.size() > 1, "route parameter needs a name", pattern);
+        ZC_REQUIRE(paramNames.size() < MAX_PARAMS, "route pattern has too many parameters",
+                   pattern);
+        paramNames.add(zc::str(segment.slice(1, segment.size())));
+        if (segment[0] == '*') {
+          wildcard = true;
+        } else {
+          auto& param = node->param;
+          if (param == zc::none) param = zc::heap<TrieNode>();
+          node = ZC_ASSERT_NONNULL(param).get();
+        }
+      } else {
+        node = node->literals.findOrCreate(segment, [&]() -> decltype(node->literals)::Entry {
+          return {zc::str(segment), zc::heap<TrieNode>()};
+        }).get();
+      }
+    }
+    else { break; }
+  }
+
+  auto routeConditions = zc::heapArrayBuilder<Route::Condition>(headers.size());
+  for (auto& condition : headers) {
+    condition.id.requireFrom(headerTable);
+    routeConditions.add(Route::Condition{condition.id, zc::str(condition.value)});
+  }
+
+  uint index = routes.size();
+  routes.add(Route{method, routeConditions.finish(), paramNames.releaseAsArray(), handler});
+  (wildcard ? node->wildcardRoutes : node->routes).add(index);
+  return *this;
+}
+
+uint HttpRouter::Builder::compile(TrieNode& node, zc::Vector<Node>& nodes) {
+  uint index = nodes.size();
+  nodes.add();
+
+  auto edges = zc::heapArrayBuilder<Edge>(node.literals.size());
+  for (auto& literal : node.literals) {
+    zc::Vector<zc::String> segments;
+    segments.add(zc::str(literal.key));
+    TrieNode* target = literal.value.get();
+    while (target->literals.size() == 1 && target->param == zc::none &&
+           target->routes.empty() && target->wildcardRoutes.empty()) {
+      auto& only = *target->literals.begin();
+      segments.add(zc::str(only.key));
+      target = only.value.get();
+    }
+    edges.add(Edge{segments.releaseAsArray(), compile(*target, nodes)});
+  }
+  std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+    return compareSegments(a.segments[0], b.segments[0]) < 0;
+  });
+
+  zc::Maybe<uint> param;
+  ZC_IF_SOME(p, node.param) { param = compile(*p, nodes); }
+
+  // `nodes` may have moved while compiling the children.
+  auto& result = nodes[index];
+  result.edges = edges.finish();
+  result.param = param;
+  result.routes = node.routes.releaseAsArray();
+  result.wildcardRoutes = node.wildcardRoutes.releaseAsArray();
+  return index;
+}
+
+zc::Own<HttpRouter> HttpRouter::Builder::build(zc::Maybe<HttpService&> fallback) {
+  ZC_REQUIRE(root.get() != nullptr, "HttpRouter::Builder was already built");
+
+  zc::Vector<Node> nodes;
+  compile(*root, nodes);
+  root = nullptr;
+  return zc::heap<HttpRouter>(headerTable, routes.releaseAsArray(), nodes.releaseAsArray(),
+                              fallback);
+}
+
+// =======================================================================================
+
+zc::Maybe<zc::ArrayPtr<const char>> HttpRouter::Params::getRaw(zc::StringPtr name) const {
+  for (auto i : zc::zeroTo(count)) {
+    if (names[i] == name) return values[i];
+  }
+  return zc::none;
+}
+
+zc::Maybe<zc::String> HttpRouter::Params::get(zc::StringPtr name) const {
+  return getRaw(name).map(
+      [](zc::ArrayPtr<const char> value) -> zc::String { return decodeUriComponent(value); });
+}
+
+HttpRouter::HttpRouter(const HttpHeaderTable& headerTable, zc::Array<Route> routes,
+                       zc::Array<Node> nodes, zc::Maybe<HttpService&> fallback)
+    : headerTable(headerTable),
+      routes(zc::mv(routes)),
+      nodes(zc::mv(nodes)),
+      fallback(fallback) {}
+HttpRouter::~HttpRouter() noexcept(false) {}
+
+bool HttpRouter::accepts(const Route& route, MatchState& state) const {
+  for (auto& condition : route.headers) {
+    ZC_IF_SOME(value, state.headers.get(condition.id)) {
+      if (value != condition.value) return false;
+    }
+    else { return false; }
+  }
+  ZC_IF_SOME(m, route.method) {
+    if (m != state.method) {
+      state.methodMismatch = true;
+      return false;
+    }
+  }
+  state.params.names = route.paramNames;
+  return true;
+}
+
+zc::Maybe<const HttpRouter::Route&> HttpRouter::matchFrom(const Node& node,
+                                                          zc::ArrayPtr<const char> path,
+                                                          MatchState& state) const {
+  auto& params = state.params;
+  auto afterSegment = path;
+  ZC_IF_SOME(segment, nextSegment(afterSegment)) {
+    // Literal segments first. Only the edge starting with this segment can match.
+    auto edge = std::lower_bound(
+        node.edges.begin(), node.edges.end(), segment, [](const Edge& e, ArrayPtr<const char> s) {
+          return compareSegments(e.segments[0], s) < 0;
+        });
+    if (edge != node.edges.end() && compareSegments(edge->segments[0], segment) == 0) {
+      auto rest = afterSegment;
+      bool matched = true;
+      for (auto& expected : edge->segments.slice(1, edge->segments.size())) {
+        ZC_IF_SOME(next, nextSegment(rest)) {
+          if (compareSegments(expected, next) != 0) {
+            matched = false;
+            break;
+          }
+        }
+        else {
+          matched = false;
+          break;
+        }
+      }
+      if (matched) {
+        ZC_IF_SOME(route, matchFrom(nodes[edge->node], rest, state)) { return route; }
+      }
+    }
+
+    // Then a parameter.
+    ZC_IF_SOME(p, node.param) {
+      if (params.count < MAX_PARAMS) {
+        params.values[params.count++] = segment;
+        ZC_IF_SOME(route, matchFrom(nodes[p], afterSegment, state)) { return route; }
+        --params.count;
+      }
+    }
+  }
+  else {
+    for (auto i : node.routes) {
+      if (accepts(routes[i], state)) return routes[i];
+    }
+  }
+
+  // Finally a wildcard, which takes the rest of the path, sans leading slashes.
+  if (node.wildcardRoutes.size() > 0 && params.count < MAX_PARAMS) {
+    while (path.size() > 0 && path[0] == '/') path = path.slice(1, path.size());
+    params.values[params.count++] = path;
+    for (auto i : node.wildcardRoutes) {
+      if (accepts(routes[i], state)) return routes[i];
+    }
+    --params.count;
+  }
+
+  return zc::none;
+}
+
+zc::Maybe<const HttpRouter::Route&> HttpRouter::findRoute(zc::StringPtr url,
+                                                          MatchState& state) const {
+  state.params = Params();
+  ZC_IF_SOME(view, UrlView::tryParse(url, url.startsWith("/") ? Url::HTTP_REQUEST
+                                                              : Url::HTTP_PROXY_REQUEST)) {
+    return matchFrom(nodes[0], view.getRawPath(), state);
+  }
+  else { return zc::none; }
+}
+
+zc::Maybe<HttpRouter::Handler&> HttpRouter::match(HttpMethod method, zc::StringPtr url,
+                                                  const HttpHeaders& headers,
+                                                  Params& params) const {
+  MatchState state{method, headers, params};
+  ZC_IF_SOME(route, findRoute(url, state)) { return route.handler; }
+  return zc::none;
+}
+
+zc::Promise<void> HttpRouter::request(HttpMethod method, zc::StringPtr url,
+                                      const HttpHeaders& headers,
+                                      zc::AsyncInputStream& requestBody, Response& response) {
+  auto params = zc::heap<Params>();
+  MatchState state{method, headers, *params};
+  ZC_IF_SOME(route, findRoute(url, state)) {
+    auto promise = route.handler.request(method, url, headers, requestBody, response, *params);
+    return promise.attach(zc::mv(params));
+  }
+
+  ZC_IF_SOME(f, fallback) { return f.request(method, url, headers, requestBody, response); }
+  if (state.methodMismatch) { return response.sendError(405, "Method Not Allowed", headerTable); }
+  return response.sendError(404, "Not Found", headerTable);
+}
+
+}  // namespace zc
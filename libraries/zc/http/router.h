@@ -0,0 +1,148 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+// Dispatches the requests an HttpService receives to handlers by method, path and headers.
+//
+// Routes are given as path patterns, whose segments are either literal, a parameter capturing one
+// segment (":name"), or, as the last segment, a wildcard capturing the rest of the path ("*name").
+// They are compiled once into a trie over path segments, in which chains of literal segments
+// without alternatives are merged into a single edge, so that matching a request takes time
+// proportional to the length of its path, regardless of how many routes there are, and allocates
+// nothing.
+
+#include "zc/http/http.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+class HttpRouter final : public HttpService {
+  struct Route;
+  struct Edge;
+  struct Node;
+  struct MatchState;
+
+public:
+  static constexpr size_t MAX_PARAMS = 8;
+  // The most parameters (wildcard included) a route may capture.
+
+  class Params {
+    // The parts of a request's path captured by the parameters of the route it matched. They
+    // point into the request URL, so they're only valid as long as it is.
+
+  public:
+    Params() = default;
+
+    zc::Maybe<zc::ArrayPtr<const char>> getRaw(zc::StringPtr name) const;
+    // The value captured for the parameter `name`, as written in the URL, or none if the route
+    // has no such parameter.
+
+    zc::Maybe<zc::String> get(zc::StringPtr name) const;
+    // Likewise, percent-decoded.
+
+    size_t size() const { return count; }
+
+  private:
+    zc::ArrayPtr<const zc::String> names;
+    zc::ArrayPtr<const char> values[MAX_PARAMS];
+    size_t count = 0;
+
+    friend class HttpRouter;
+  };
+
+  class Handler {
+  public:
+    virtual zc::Promise<void> request(HttpMethod method, zc::StringPtr url,
+                                      const HttpHeaders& headers,
+                                      zc::AsyncInputStream& requestBody, Response& response,
+                                      const Params& params) = 0;
+    // Like HttpService::request(), with the parameters the route captured. `params` stays valid
+    // until the returned promise resolves, but the values in it are invalidated along with `url`.
+  };
+
+  struct HeaderCondition {
+    HttpHeaderId id;
+    zc::StringPtr value;
+    // The route only matches requests whose header `id` has exactly this value.
+  };
+
+  class Builder {
+  public:
+    explicit Builder(const HttpHeaderTable& headerTable);
+    ~Builder() noexcept(false);
+    ZC_DISALLOW_COPY_AND_MOVE(Builder);
+
+    Builder& add(zc::Maybe<HttpMethod> method, zc::StringPtr pattern, Handler& handler);
+    Builder& add(zc::Maybe<HttpMethod> method, zc::StringPtr pattern,
+                 zc::ArrayPtr<const HeaderCondition> headers, Handler& handler);
+    // Adds a route for requests with the given method (any, if none) whose path matches `pattern`
+    // and whose headers satisfy all of `headers`, which must come from the builder's header table.
+    //
+    // A request goes to the first route added that matches it, save that literal segments take
+    // precedence over parameters, and parameters over wildcards, wherever two patterns diverge.
+    // Paths are matched as written, without percent-decoding, and empty segments are ignored in
+    // both patterns and paths, so "/a//b/" matches "/a/b".
+
+    zc::Own<HttpRouter> build(zc::Maybe<HttpService&> fallback = zc::none);
+    // Compiles the routes. Requests that match none of them go to `fallback` or, if there's none,
+    // get a 404 Not Found -- or a 405 Method Not Allowed, if they would have matched but for their
+    // method. The builder can't be used any further.
+
+  private:
+    struct TrieNode;
+
+    const HttpHeaderTable& headerTable;
+    zc::Own<TrieNode> root;
+    zc::Vector<Route> routes;
+
+    uint compile(TrieNode& node, zc::Vector<Node>& nodes);
+  };
+
+  HttpRouter(const HttpHeaderTable& headerTable, zc::Array<Route> routes, zc::Array<Node> nodes,
+             zc::Maybe<HttpService&> fallback);
+  // Use Builder to create one.
+  ~HttpRouter() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(HttpRouter);
+
+  zc::Maybe<Handler&> match(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            Params& params) const;
+  // Finds the route for a request, filling in `params`, without dispatching it. `url` may be a
+  // path or, as proxy services receive it, a full URL.
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, Response& response) override;
+
+private:
+  const HttpHeaderTable& headerTable;
+  zc::Array<Route> routes;
+  zc::Array<Node> nodes;  // nodes[0] is the root
+  zc::Maybe<HttpService&> fallback;
+
+  zc::Maybe<const Route&> findRoute(zc::StringPtr url, MatchState& state) const;
+  zc::Maybe<const Route&> matchFrom(const Node& node, zc::ArrayPtr<const char> path,
+                                    MatchState& state) const;
+  bool accepts(const Route& route, MatchState& state) const;
+};
+
+}  // namespace zc
+
+ZC_END_HEADER
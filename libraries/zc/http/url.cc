@@ -23,6 +23,14 @@
 
 #include <stdlib.h>
 
+#if __SSE2__ || _M_X64 || (_M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ZC_URL_SSE2 1
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_URL_NEON 1
+#endif
+
 #include "zc/core/debug.h"
 #include "zc/core/encoding.h"
 #include "zc/parse/char.h"
@@ -122,6 +130,78 @@ ArrayPtr<const char> split(StringPtr& text, const parse::CharGroup_& chars) {
   return result;
 }
 
+constexpr auto HEX_DIGITS = DIGITS.orRange('a', 'f').orRange('A', 'F');
+
+const char* findEscapeOrDelimiter(const char* p, const char* end) {
+  // Returns the first '%', '?' or '#' at or after `p`, or `end` if there's none. These are all
+  // UrlView::tryParse() needs to stop at, so it checks 16 bytes at a time where SSE2 or NEON is
+  // available.
+#if ZC_URL_SSE2
+  __m128i percent = _mm_set1_epi8('%');
+  __m128i question = _mm_set1_epi8('?');
+  __m128i hash = _mm_set1_epi8('#');
+  while (end - p >= 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i hits = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(chunk, percent), _mm_cmpeq_epi8(chunk, question)),
+        _mm_cmpeq_epi8(chunk, hash));
+    if (_mm_movemask_epi8(hits) != 0) break;
+    p += 16;
+  }
+#elif ZC_URL_NEON
+  while (end - p >= 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t hits = vorrq_u8(
+        vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('%')), vceqq_u8(chunk, vdupq_n_u8('?'))),
+        vceqq_u8(chunk, vdupq_n_u8('#')));
+    if (vmaxvq_u8(hits) != 0) break;
+    p += 16;
+  }
+#endif
+  while (p < end && *p != '%' && *p != '?' && *p != '#') ++p;
+  return p;
+}
+
+bool isValidEscape(const char* p, const char* end) {
+  // Whether the '%' at `p` starts an escape that percent-decoding will accept.
+  return end - p >= 3 && HEX_DIGITS.contains(p[1]) && HEX_DIGITS.contains(p[2]);
+}
+
+const char* skipComponent(const char* p, const char* end, bool stopAtQuery, bool stopAtFragment) {
+  // Returns the end of the URL component starting at `p`, which is the first '?' or '#' at which
+  // we're asked to stop, or `end`. Returns null if the component holds a malformed escape.
+  for (;;) {
+    p = findEscapeOrDelimiter(p, end);
+    if (p == end) return p;
+    switch (*p) {
+      case '%':
+        if (!isValidEscape(p, end)) return nullptr;
+        p += 3;
+        break;
+      case '?':
+        if (stopAtQuery) return p;
+        ++p;
+        break;
+      case '#':
+        if (stopAtFragment) return p;
+        ++p;
+        break;
+    }
+  }
+}
+
+Maybe<ArrayPtr<const char>> nextPathSegment(ArrayPtr<const char>& path) {
+  // Consumes and returns the next non-empty segment of `path`, if any.
+  while (path.size() > 0 && path[0] == '/') path = path.slice(1, path.size());
+  if (path.size() == 0) return zc::none;
+
+  size_t size = 1;
+  while (size < path.size() && path[size] != '/') ++size;
+  auto segment = path.first(size);
+  path = path.slice(size, path.size());
+  return segment;
+}
+
 String percentDecode(ArrayPtr<const char> text, bool& hadErrors, const Url::Options& options) {
   if (options.percentDecode) {
     auto result = decodeUriComponent(text);
@@ -466,4 +546,135 @@ String Url::toString(Context context) const {
   return String(chars.releaseAsArray());
 }
 
+// =======================================================================================
+
+Maybe<UrlView> UrlView::tryParse(StringPtr text, Url::Context context) {
+  UrlView result;
+  bool fragmentAllowed = context == Url::REMOTE_HREF;
+
+  if (context == Url::HTTP_REQUEST) {
+    if (!text.startsWith("/")) { return zc::none; }
+  } else {
+    ZC_IF_SOME(scheme, trySplit(text, ':')) { result.scheme = scheme; }
+    else {
+      // missing scheme
+      return zc::none;
+    }
+    if (result.scheme.size() == 0 || !ALPHAS.contains(result.scheme[0]) ||
+        !SCHEME_CHARS.containsAll(result.scheme.slice(1, result.scheme.size()))) {
+      // bad scheme
+      return zc::none;
+    }
+
+    if (!text.startsWith("//")) {
+      // We require an authority (hostname) part.
+      return zc::none;
+    }
+    text = text.slice(2);
+
+    auto authority = split(text, END_AUTHORITY);
+    ZC_IF_SOME(userpass, trySplit(authority, '@')) {
+      if (context != Url::REMOTE_HREF) {
+        // No user/pass allowed here.
+        return zc::none;
+      }
+      if (skipComponent(userpass.begin(), userpass.end(), false, false) == nullptr) {
+        return zc::none;
+      }
+    }
+    if (!HOST_CHARS.containsAll(authority)) return zc::none;
+    result.host = authority;
+  }
+
+  const char* p = text.begin();
+  const char* end = text.end();
+
+  const char* pathEnd = skipComponent(p, end, true, fragmentAllowed);
+  if (pathEnd == nullptr) return zc::none;
+  result.path = arrayPtr(p, pathEnd);
+  p = pathEnd;
+
+  auto segments = result.path;
+  for (;;) {
+    ZC_IF_SOME(segment, nextPathSegment(segments)) {
+      if (segment == "."_zc.asArray() || segment == ".."_zc.asArray()) {
+        // Url would resolve these, which would take copying the path.
+        return zc::none;
+      }
+    }
+    else { break; }
+  }
+
+  if (p < end && *p == '?') {
+    const char* queryEnd = skipComponent(p + 1, end, false, fragmentAllowed);
+    if (queryEnd == nullptr) return zc::none;
+    result.query = arrayPtr(p + 1, queryEnd);
+    p = queryEnd;
+  }
+
+  if (p < end) {
+    // Only a fragment can be left, and only where fragments are allowed.
+    ZC_ASSERT(*p == '#' && fragmentAllowed);
+    if (skipComponent(p + 1, end, false, false) == nullptr) return zc::none;
+    result.fragment = arrayPtr(p + 1, end);
+  }
+
+  return result;
+}
+
+Maybe<ArrayPtr<const char>> UrlView::getRawPathSegment(size_t index) const {
+  auto rest = path;
+  for (;;) {
+    ZC_IF_SOME(segment, nextPathSegment(rest)) {
+      if (index-- == 0) return segment;
+    }
+    else { return zc::none; }
+  }
+}
+
+Maybe<String> UrlView::getPathSegment(size_t index) const {
+  // tryParse() made sure that every escape is valid, so decoding can't fail.
+  return getRawPathSegment(index).map(
+      [](ArrayPtr<const char> segment) -> String { return decodeUriComponent(segment); });
+}
+
+Maybe<String> UrlView::getQueryParam(StringPtr name) const {
+  ZC_IF_SOME(q, query) {
+    auto rest = q;
+    for (;;) {
+      ArrayPtr<const char> part;
+      bool last = false;
+      ZC_IF_SOME(p, trySplit(rest, '&')) { part = p; }
+      else {
+        part = rest;
+        last = true;
+      }
+
+      if (part.size() > 0) {
+        auto key = part;
+        ArrayPtr<const char> value = nullptr;
+        ZC_IF_SOME(k, trySplit(part, '=')) {
+          key = k;
+          value = part;
+        }
+
+        bool encoded = false;
+        for (char c : key) {
+          if (c == '%' || c == '+') {
+            encoded = true;
+            break;
+          }
+        }
+        // Only decode the names that need it.
+        if (encoded ? decodeWwwForm(key) == name : key == name.asArray()) {
+          return String(decodeWwwForm(value));
+        }
+      }
+
+      if (last) break;
+    }
+  }
+  return zc::none;
+}
+
 }  // namespace zc
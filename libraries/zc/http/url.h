@@ -152,6 +152,56 @@ struct Url {
   // Parse a relative URL string with this URL as the base.
 };
 
+class UrlView {
+  // A URL parsed in place, for code that only looks at a few of its components -- say, a router
+  // that matches on the first path segments and one query parameter. Where Url allocates and
+  // percent-decodes every component up front, a UrlView only records where each one lies in the
+  // text it was parsed from, which must outlive it, and decodes a component only when asked for
+  // it.
+  //
+  // Parsing accepts what Url::tryParse() accepts with default options, save that paths with "."
+  // or ".." segments and percent-encoded hosts are rejected, since a view can't resolve or decode
+  // them in place. Fall back to Url for those.
+
+public:
+  static Maybe<UrlView> tryParse(StringPtr text, Url::Context context = Url::REMOTE_HREF);
+
+  ArrayPtr<const char> getScheme() const { return scheme; }
+  ArrayPtr<const char> getHost() const { return host; }
+  // As written, so not lowercased as in Url. Empty in the HTTP_REQUEST context. The user info
+  // preceding the host, if any, is skipped.
+
+  ArrayPtr<const char> getRawPath() const { return path; }
+  // The path as written, starting with '/', or empty if there's none.
+
+  bool hasTrailingSlash() const { return path.size() > 0 && path.back() == '/'; }
+
+  Maybe<ArrayPtr<const char>> getRawPathSegment(size_t index) const;
+  Maybe<String> getPathSegment(size_t index) const;
+  // The segment of the path at `index`, as written or percent-decoded, or none if the path has
+  // fewer segments. Empty segments are skipped, as Url::path does by default. Both walk the path
+  // from the start, so they suit the first few segments rather than iterating over all of them.
+
+  Maybe<ArrayPtr<const char>> getRawQuery() const { return query; }
+  // The query as written, without the '?'.
+
+  Maybe<String> getQueryParam(StringPtr name) const;
+  // The decoded value of the first query parameter whose decoded name is `name`, or none if there
+  // is none. A parameter without an '=' sign has an empty value.
+
+  Maybe<ArrayPtr<const char>> getRawFragment() const { return fragment; }
+  // The fragment as written, without the '#'.
+
+private:
+  ArrayPtr<const char> scheme;
+  ArrayPtr<const char> host;
+  ArrayPtr<const char> path;
+  Maybe<ArrayPtr<const char>> query;
+  Maybe<ArrayPtr<const char>> fragment;
+
+  UrlView() = default;
+};
+
 }  // namespace zc
 
 ZC_END_HEADER
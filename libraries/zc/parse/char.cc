@@ -25,9 +25,58 @@
 
 #include "zc/core/debug.h"
 
+#if __SSSE3__ || __AVX__
+#include <tmmintrin.h>
+#define ZC_PARSE_SSSE3 1
+#elif __aarch64__ && __ARM_NEON
+#include <arm_neon.h>
+#define ZC_PARSE_NEON 1
+#endif
+
 namespace zc {
 namespace parse {
 
+size_t CharGroup_::span(ArrayPtr<const char> text) const {
+  const char* p = text.begin();
+  const char* end = text.end();
+
+  // Sixteen characters at a time: look up each one's row by its low nibble, then test the bit for
+  // its high nibble. On the first block with a character outside the group, the loop below finds
+  // which.
+#if ZC_PARSE_SSSE3
+  const __m128i lowRows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows));
+  const __m128i highRows = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows + 16));
+  const __m128i bitOf = _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m128i nibble = _mm_set1_epi8(0x0f);
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i low = _mm_and_si128(chunk, nibble);
+    __m128i high = _mm_and_si128(_mm_srli_epi16(chunk, 4), nibble);
+    __m128i upper = _mm_cmplt_epi8(chunk, _mm_setzero_si128());
+    __m128i row = _mm_or_si128(_mm_andnot_si128(upper, _mm_shuffle_epi8(lowRows, low)),
+                               _mm_and_si128(upper, _mm_shuffle_epi8(highRows, low)));
+    __m128i hits = _mm_and_si128(row, _mm_shuffle_epi8(bitOf, high));
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(hits, _mm_setzero_si128())) != 0) break;
+  }
+#elif ZC_PARSE_NEON
+  const uint8x16_t lowRows = vld1q_u8(rows);
+  const uint8x16_t highRows = vld1q_u8(rows + 16);
+  static const uint8_t BIT_OF[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+  const uint8x16_t bitOf = vld1q_u8(BIT_OF);
+  for (; end - p >= 16; p += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    uint8x16_t low = vandq_u8(chunk, vdupq_n_u8(0x0f));
+    uint8x16_t row = vbslq_u8(vcgeq_u8(chunk, vdupq_n_u8(0x80)), vqtbl1q_u8(highRows, low),
+                              vqtbl1q_u8(lowRows, low));
+    uint8x16_t hits = vtstq_u8(row, vqtbl1q_u8(bitOf, vshrq_n_u8(chunk, 4)));
+    if (vminvq_u8(hits) == 0) break;
+  }
+#endif
+
+  while (p < end && contains(*p)) ++p;
+  return p - text.begin();
+}
+
 namespace _ {  // private
 
 double ParseFloat::operator()(const Array<char>& digits, const Maybe<Array<char>>& fraction,
@@ -70,9 +70,22 @@ constexpr ExactlyConst_<char, c> exactChar() {
 // =======================================================================================
 // Char ranges / sets
 
+namespace _ {  // private
+
+template <typename Input>
+concept CharArrayInput = requires(Input& input) {
+  requires isSameType<decltype(input.getPosition()), const char*>();
+  requires isSameType<decltype(input.getEnd()), const char*>();
+  input.skip(size_t(0));
+};
+// An input over a char array -- an IteratorInput<char, const char*>, say -- which a CharGroup_ can
+// scan a whole run of at once.
+
+}  // namespace _
+
 class CharGroup_ {
 public:
-  constexpr inline CharGroup_() : bits{0, 0, 0, 0} {}
+  constexpr inline CharGroup_() : bits{0, 0, 0, 0}, rows{} {}
 
   constexpr inline CharGroup_ orRange(unsigned char first, unsigned char last) const {
     return CharGroup_(bits[0] | (oneBits(last + 1) & ~oneBits(first)),
@@ -103,12 +116,11 @@ public:
     return (bits[c / 64] & (1ll << (c % 64))) != 0;
   }
 
-  inline bool containsAll(ArrayPtr<const char> text) const {
-    for (char c : text) {
-      if (!contains(c)) return false;
-    }
-    return true;
-  }
+  inline bool containsAll(ArrayPtr<const char> text) const { return span(text) == text.size(); }
+
+  size_t span(ArrayPtr<const char> text) const;
+  // Returns the length of the longest prefix of `text` made only of characters in the group, like
+  // strspn(). Scans 16 characters at a time where SSSE3 or NEON is available.
 
   template <typename Input>
   Maybe<char> operator()(Input& input) const {
@@ -122,12 +134,31 @@ public:
     }
   }
 
+  template <_::CharArrayInput Input>
+  ArrayPtr<const char> parseRun(Input& input) const {
+    // Consumes every character in the group up to the first that isn't, returning them. many()
+    // calls this in place of the parser for each character.
+    const char* begin = input.getPosition();
+    size_t count = span(arrayPtr(begin, input.getEnd()));
+    input.skip(count);
+    return arrayPtr(begin, count);
+  }
+
 private:
   typedef unsigned long long Bits64;
 
-  constexpr inline CharGroup_(Bits64 a, Bits64 b, Bits64 c, Bits64 d) : bits{a, b, c, d} {}
+  constexpr inline CharGroup_(Bits64 a, Bits64 b, Bits64 c, Bits64 d) : bits{a, b, c, d}, rows{} {
+    for (uint c = 0; c < 256; c++) {
+      if (contains(c)) { rows[(c >> 7) * 16 + (c & 15)] |= 1 << ((c >> 4) & 7); }
+    }
+  }
   Bits64 bits[4];
 
+  unsigned char rows[32];
+  // The same set arranged for SIMD lookup by the low nibble of each character, as in Muła's
+  // "SIMD byte lookup": bit `h` of rows[l] says whether the character (h << 4 | l) is in the group,
+  // and rows[16 + l] does the same for the characters from 0x80 up.
+
   static constexpr inline Bits64 oneBits(int count) {
     return count <= 0 ? 0ll : count >= 64 ? -1ll : ((1ll << count) - 1);
   }
@@ -197,9 +228,38 @@ constexpr auto octDigit = charRange('0', '7');
 constexpr auto whitespaceChar = anyOfChars(" \f\n\r\t\v");
 constexpr auto controlChar = charRange(0, 0x1f).invert().orGroup(whitespaceChar).invert();
 
+class SpanOf_ {
+public:
+  explicit constexpr SpanOf_(CharGroup_ group) : group(group) {}
+
+  template <typename Input>
+  Maybe<uint> operator()(Input& input) const {
+    if constexpr (_::CharArrayInput<Input>) {
+      return group.parseRun(input).size();
+    } else {
+      uint count = 0;
+      while (!input.atEnd() && group.contains(input.current())) {
+        input.next();
+        ++count;
+      }
+      return count;
+    }
+  }
+
+private:
+  CharGroup_ group;
+};
+
+constexpr inline SpanOf_ spanOf(CharGroup_ group) {
+  // Returns a parser which consumes the longest run of characters in `group`, possibly empty, and
+  // returns how many there were. Like `many(discard(group))`, but over a char array the whole run
+  // is scanned at once; see CharGroup_::span().
+  return SpanOf_(group);
+}
+
 constexpr auto whitespace = many(anyOfChars(" \f\n\r\t\v"));
 
-constexpr auto discardWhitespace = discard(many(discard(anyOfChars(" \f\n\r\t\v"))));
+constexpr auto discardWhitespace = discard(spanOf(whitespaceChar));
 // Like discard(whitespace) but avoids some memory allocation.
 
 // =======================================================================================
@@ -37,6 +37,7 @@
 
 #include "zc/core/array.h"
 #include "zc/core/common.h"
+#include "zc/core/map.h"
 #include "zc/core/memory.h"
 #include "zc/core/tuple.h"
 #include "zc/core/vector.h"
@@ -88,8 +89,15 @@ public:
   Iterator getBest() { return zc::max(pos, best); }
 
   Iterator getPosition() { return pos; }
+  Iterator getEnd() { return end; }
 
-private:
+  void skip(size_t count) {
+    // Consumes `count` tokens at once. Only for random-access iterators.
+    ZC_IREQUIRE(count <= size_t(end - pos));
+    pos += count;
+  }
+
+protected:
   IteratorInput* parent;
   Iterator pos;
   Iterator end;
@@ -113,6 +121,16 @@ using OutputType = typename OutputType_<
     >::Type;
 // Synonym for the output type of a parser, given the parser type and the input type.
 
+namespace _ {  // private
+
+template <typename Parser, typename Input>
+concept RunParser = requires(const Parser& parser, Input& input) { parser.parseRun(input); };
+// A parser which, given an input it supports, can consume every match in a row at once, returning
+// the run of input they span -- as CharGroup_ can, with SIMD. many() uses parseRun() where it can
+// rather than calling the parser for each match.
+
+}  // namespace _
+
 // =======================================================================================
 
 template <typename Input, typename Output>
@@ -412,6 +430,12 @@ template <typename SubParser, bool atLeastOne>
 template <typename Input, typename Output>
 struct Many_<SubParser, atLeastOne>::Impl {
   static Maybe<Array<Output>> apply(const SubParser& subParser, Input& input) {
+    if constexpr (_::RunParser<Decay<SubParser>, Input>) {
+      auto run = subParser.parseRun(input);
+      if (atLeastOne && run.size() == 0) { return zc::none; }
+      return heapArray(run);
+    }
+
     typedef Vector<OutputType<SubParser, Input>> Results;
     Results results;
 
@@ -780,6 +804,133 @@ constexpr NotLookingAt_<SubParser> notLookingAt(SubParser&& subParser) {
   return NotLookingAt_<SubParser>(zc::fwd<SubParser>(subParser));
 }
 
+// -------------------------------------------------------------------
+// memoize()
+// Output = same as sub-parser
+
+template <typename Element, typename Iterator>
+class PackratInput : public IteratorInput<Element, Iterator> {
+  // An IteratorInput which also remembers, for each memoize()d parser and each position it was
+  // tried at, what the parser returned and where it stopped. When a grammar backtracks and tries
+  // the same rule at the same position again, that costs a table lookup rather than a reparse. A
+  // grammar whose alternatives share prefixes, or whose rules are ambiguous, can take
+  // exponential time on an IteratorInput. Once its rules are memoized, it runs in time linear in
+  // the input, at the cost of an entry per rule and position tried.
+  //
+  // Results are copied out of the table, so a memoized parser's output must be copyable; wrap
+  // anything else in an Rc. `Iterator` must be random-access. Left-recursive rules still recurse
+  // forever, as they would without memoization.
+
+public:
+  PackratInput(Iterator begin, Iterator end)
+      : IteratorInput<Element, Iterator>(begin, end),
+        ownMemo(zc::heap<Memo>(begin)),
+        memo(*ownMemo) {}
+  explicit PackratInput(PackratInput& parent)
+      : IteratorInput<Element, Iterator>(parent), memo(parent.memo) {}
+  ZC_DISALLOW_COPY_AND_MOVE(PackratInput);
+
+  size_t getMemoSize() { return memo.entries.size(); }
+  // How many (parser, position) results are remembered.
+
+  template <typename SubParser>
+  Maybe<OutputType<SubParser, PackratInput>> parseMemoized(const void* rule,
+                                                           const SubParser& subParser) {
+    typedef OutputType<SubParser, PackratInput> Output;
+    static_assert(canConvert<const Output&, Output>(),
+                  "memoize() needs a copyable output; wrap it in an Rc.");
+
+    MemoKey key{rule, size_t(this->pos - memo.begin)};
+    ZC_IF_SOME(entry, memo.entries.find(key)) {
+      auto& result = static_cast<MemoEntry<Output>&>(*entry);
+      this->best = zc::max(this->best, result.best);
+      if (result.output != zc::none) { this->pos = result.end; }
+      return result.output;
+    }
+
+    PackratInput subInput(*this);
+    Maybe<Output> output = subParser(subInput);
+    if (output != zc::none) { subInput.advanceParent(); }
+
+    // Parsing the rule may well have grown the table, so the entry is only inserted now.
+    auto entry = zc::heap<MemoEntry<Output>>();
+    entry->end = subInput.getPosition();
+    entry->best = subInput.getBest();
+    entry->output = output;
+    memo.entries.insert(key, zc::mv(entry));
+    return output;
+  }
+
+private:
+  struct MemoKey {
+    const void* rule;
+    size_t offset;
+
+    bool operator==(const MemoKey& other) const {
+      return rule == other.rule && offset == other.offset;
+    }
+    uint hashCode() const { return zc::hashCode(rule, offset); }
+  };
+
+  struct MemoEntryBase {
+    virtual ~MemoEntryBase() noexcept(false) = default;
+    Iterator end;
+    Iterator best;
+  };
+
+  template <typename Output>
+  struct MemoEntry final : public MemoEntryBase {
+    Maybe<Output> output;
+  };
+
+  struct Memo {
+    explicit Memo(Iterator begin) : begin(begin) {}
+    Iterator begin;
+    HashMap<MemoKey, Own<MemoEntryBase>> entries;
+  };
+
+  Own<Memo> ownMemo;  // Only in the outermost input.
+  Memo& memo;
+};
+
+template <typename SubParser>
+class Memoize_ {
+public:
+  explicit constexpr Memoize_(SubParser&& subParser) : subParser(zc::fwd<SubParser>(subParser)) {}
+
+  template <typename Input>
+  Maybe<OutputType<SubParser, Input>> operator()(Input& input) const {
+    return parse(input);
+  }
+
+private:
+  SubParser subParser;
+
+  template <typename Input>
+  Maybe<OutputType<SubParser, Input>> parse(Input& input) const {
+    return subParser(input);
+  }
+
+  template <typename Element, typename Iterator>
+  Maybe<OutputType<SubParser, PackratInput<Element, Iterator>>> parse(
+      PackratInput<Element, Iterator>& input) const {
+    return input.parseMemoized(this, subParser);
+  }
+};
+
+template <typename SubParser>
+constexpr Memoize_<SubParser> memoize(SubParser&& subParser) {
+  // Constructs a parser which behaves as `subParser`, but when parsing a PackratInput, remembers
+  // its result at each position, so that it runs only once per position however often the grammar
+  // backtracks into it. On any other input, it just calls `subParser`.
+  //
+  // Memoize the rules a grammar backtracks over -- typically those heading several alternatives of
+  // a oneOf() and those that are recursive -- rather than every parser: a table lookup costs more
+  // than matching a character. The results are remembered per memoize() object, so a rule must be
+  // one object, e.g. referenced through a ParserRef, rather than a copy at each use.
+  return Memoize_<SubParser>(zc::fwd<SubParser>(subParser));
+}
+
 // -------------------------------------------------------------------
 // endOfInput()
 // Output = Tuple<>, only succeeds if at end-of-input
@@ -30,6 +30,11 @@ static size_t copyInto(zc::ArrayPtr<byte> dst, zc::ArrayPtr<const byte>& src) {
   return n;
 }
 
+static constexpr size_t IN_PLACE_MIN = 4096;
+// readInPlace() and writeInPlace() only bypass the buffer for at least this many bytes -- a TLS
+// record's worth, more or less. Anything smaller goes through the buffer, where reads are served
+// several at a time and writes are combined.
+
 // =======================================================================================
 
 ReadyInputStreamWrapper::ReadyInputStreamWrapper(AsyncInputStream& input) : input(input) {}
@@ -41,17 +46,11 @@ zc::Maybe<size_t> ReadyInputStreamWrapper::read(zc::ArrayPtr<byte> dst) {
   if (content.size() == 0) {
     // No data available. Try to read more.
     if (!isPumping) {
-      isPumping = true;
-      pumpTask = zc::evalNow([&]() {
-                   return input.tryRead(buffer, 1, sizeof(buffer)).then([this](size_t n) {
-                     if (n == 0) {
-                       eof = true;
-                     } else {
-                       content = zc::arrayPtr(buffer, n);
-                     }
-                     isPumping = false;
-                   });
-                 }).fork();
+      if (pumpsDeferred) {
+        pumpWanted = true;
+      } else {
+        pump();
+      }
     }
 
     return zc::none;
@@ -60,8 +59,54 @@ zc::Maybe<size_t> ReadyInputStreamWrapper::read(zc::ArrayPtr<byte> dst) {
   return copyInto(dst, content);
 }
 
+zc::Maybe<size_t> ReadyInputStreamWrapper::readInPlace(zc::ArrayPtr<byte> dst) {
+  if (inPlaceDst != nullptr && dst.begin() == inPlaceDst.begin()) {
+    // Retrying an earlier read.
+    if (isPumping) return zc::none;
+    inPlaceDst = nullptr;
+    return inPlaceSize;
+  }
+
+  if (content.size() > 0 || dst.size() < IN_PLACE_MIN || isPumping || pumpsDeferred || eof) {
+    return read(dst);
+  }
+
+  isPumping = true;
+  inPlaceDst = dst;
+  pumpTask = zc::evalNow([&]() {
+               return input.tryRead(dst.begin(), 1, dst.size()).then([this](size_t n) {
+                 if (n == 0) eof = true;
+                 inPlaceSize = n;
+                 isPumping = false;
+               });
+             }).fork();
+  return zc::none;
+}
+
 zc::Promise<void> ReadyInputStreamWrapper::whenReady() { return pumpTask.addBranch(); }
 
+void ReadyInputStreamWrapper::resumePumps() {
+  pumpsDeferred = false;
+  if (pumpWanted) {
+    pumpWanted = false;
+    if (!isPumping && content.size() == 0 && !eof) pump();
+  }
+}
+
+void ReadyInputStreamWrapper::pump() {
+  isPumping = true;
+  pumpTask = zc::evalNow([&]() {
+               return input.tryRead(buffer, 1, sizeof(buffer)).then([this](size_t n) {
+                 if (n == 0) {
+                   eof = true;
+                 } else {
+                   content = zc::arrayPtr(buffer, n);
+                 }
+                 isPumping = false;
+               });
+             }).fork();
+}
+
 // =======================================================================================
 
 ReadyOutputStreamWrapper::ReadyOutputStreamWrapper(AsyncOutputStream& output) : output(output) {}
@@ -94,7 +139,7 @@ zc::Maybe<size_t> ReadyOutputStreamWrapper::write(zc::ArrayPtr<const byte> data)
 
   filled += result;
 
-  if (!isPumping && (!corked || filled == sizeof(buffer))) {
+  if (!isPumping && !pumpsDeferred && (!corked || filled == sizeof(buffer))) {
     isPumping = true;
     pumpTask = zc::evalNow([&]() { return pump(); }).fork();
   }
@@ -102,6 +147,32 @@ zc::Maybe<size_t> ReadyOutputStreamWrapper::write(zc::ArrayPtr<const byte> data)
   return result;
 }
 
+zc::Maybe<size_t> ReadyOutputStreamWrapper::writeInPlace(zc::ArrayPtr<const byte> data) {
+  if (inPlaceSrc != nullptr && data.begin() == inPlaceSrc.begin()) {
+    // Retrying an earlier write.
+    if (isPumping) return zc::none;
+    size_t result = inPlaceSrc.size();
+    inPlaceSrc = nullptr;
+    return result;
+  }
+
+  if (filled > 0 || data.size() < IN_PLACE_MIN || isPumping || pumpsDeferred) {
+    return write(data);
+  }
+
+  isPumping = true;
+  inPlaceSrc = data;
+  pumpTask = zc::evalNow([&]() {
+               return output.write(data).then([this]() -> zc::Promise<void> {
+                 // write() may have buffered more behind us in the meantime.
+                 if (filled > 0) return pump();
+                 isPumping = false;
+                 return zc::READY_NOW;
+               });
+             }).fork();
+  return zc::none;
+}
+
 zc::Promise<void> ReadyOutputStreamWrapper::whenReady() { return pumpTask.addBranch(); }
 
 ReadyOutputStreamWrapper::Cork ReadyOutputStreamWrapper::cork() {
@@ -111,12 +182,26 @@ ReadyOutputStreamWrapper::Cork ReadyOutputStreamWrapper::cork() {
 
 void ReadyOutputStreamWrapper::uncork() {
   corked = false;
-  if (!isPumping && filled > 0) {
+  flush();
+}
+
+void ReadyOutputStreamWrapper::flush() {
+  if (pumpsDeferred) {
+    flushWanted = true;
+  } else if (!isPumping && filled > 0) {
     isPumping = true;
     pumpTask = zc::evalNow([&]() { return pump(); }).fork();
   }
 }
 
+void ReadyOutputStreamWrapper::resumePumps() {
+  pumpsDeferred = false;
+  if (flushWanted || !corked || filled == sizeof(buffer)) {
+    flushWanted = false;
+    flush();
+  }
+}
+
 zc::Promise<void> ReadyOutputStreamWrapper::pump() {
   uint oldFilled = filled;
   uint end = start + filled;
@@ -42,20 +42,44 @@ public:
   // Reads bytes into `dst`, returning the number of bytes read. Returns zero only at EOF. Returns
   // nullptr if not ready.
 
+  zc::Maybe<size_t> readInPlace(zc::ArrayPtr<byte> dst);
+  // Like read(), except that when nothing is buffered and `dst` is large, the underlying stream
+  // reads straight into `dst` rather than into the internal buffer, saving a copy. The caller must
+  // keep `dst` valid in the meantime and, once whenReady() resolves, call again with the same
+  // `dst` -- only then does it learn how many bytes landed there. OpenSSL retries reads exactly
+  // like that, always from its own record buffer.
+
   zc::Promise<void> whenReady();
   // Returns a promise that resolves when read() will return non-null.
 
   bool isAtEnd() { return eof; }
   // Returns true if read() would return zero.
 
+  bool isBusy() { return isPumping; }
+  // Returns true while reading from the underlying stream.
+
+  void deferPumps() { pumpsDeferred = true; }
+  void resumePumps();
+  // While deferred, read() doesn't start reading from the underlying stream -- which has to
+  // happen on the event loop's thread -- so that another thread may call it, provided the event
+  // loop leaves the wrapper alone in the meantime (i.e. it isn't busy). resumePumps(), back on
+  // the event loop, starts the read that was put off, if any.
+
 private:
   AsyncInputStream& input;
   zc::ForkedPromise<void> pumpTask = nullptr;
   bool isPumping = false;
   bool eof = false;
+  bool pumpsDeferred = false;
+  bool pumpWanted = false;
 
   zc::ArrayPtr<const byte> content = nullptr;  // Points to currently-valid part of `buffer`.
   byte buffer[8192];
+
+  zc::ArrayPtr<byte> inPlaceDst = nullptr;  // Set while a readInPlace() awaits its retry.
+  size_t inPlaceSize = 0;
+
+  void pump();
 };
 
 class ReadyOutputStreamWrapper {
@@ -73,9 +97,31 @@ public:
   // Writes bytes from `src`, returning the number of bytes written. Never returns zero for
   // a non-empty `src`. Returns nullptr if not ready.
 
+  zc::Maybe<size_t> writeInPlace(zc::ArrayPtr<const byte> src);
+  // Like write(), except that when nothing is buffered and `src` is large, it's written to the
+  // underlying stream straight from `src` rather than copied into the internal buffer first. In
+  // that case this returns nullptr; the caller must keep `src` valid in the meantime and, once
+  // whenReady() resolves, call again with the same `src` to be told it was written. Corking
+  // doesn't hold such writes back, since there's nothing to gain by coalescing them.
+
   zc::Promise<void> whenReady();
   // Returns a promise that resolves when write() will return non-null.
 
+  bool isEmpty() const { return filled == 0 && !isPumping; }
+  // True if everything written so far has been written to the underlying stream.
+
+  void flush();
+  // Starts writing out whatever is buffered, even while corked. whenReady() resolves once it's
+  // all been written.
+
+  bool isBusy() { return isPumping; }
+  // Returns true while writing to the underlying stream.
+
+  void deferPumps() { pumpsDeferred = true; }
+  void resumePumps();
+  // Like the ReadyInputStreamWrapper methods of the same names: while deferred, write() and
+  // flush() only buffer, and resumePumps() starts writing out whatever they would have.
+
   class Cork;
   // An object that, when destructed, will uncork its parent stream.
 
@@ -94,12 +140,16 @@ private:
   zc::ForkedPromise<void> pumpTask = nullptr;
   bool isPumping = false;
   bool corked = false;
+  bool pumpsDeferred = false;
+  bool flushWanted = false;
 
   uint start = 0;   // index of first byte
   uint filled = 0;  // number of bytes currently in buffer
 
   byte buffer[8192];
 
+  zc::ArrayPtr<const byte> inPlaceSrc = nullptr;  // Set while a writeInPlace() awaits its retry.
+
   void uncork();
 
   zc::Promise<void> pump();
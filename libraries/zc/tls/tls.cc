@@ -27,13 +27,17 @@
 #include <openssl/conf.h>
 #include <openssl/err.h>
 #include <openssl/evp.h>
+#include <openssl/rand.h>
 #include <openssl/ssl.h>
 #include <openssl/tls1.h>
 #include <openssl/x509.h>
 #include <openssl/x509v3.h>
 
 #include "zc/async/async-queue.h"
+#include "zc/async/worker-pool.h"
 #include "zc/core/debug.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
 #include "zc/core/vector.h"
 #include "zc/tls/readiness-io.h"
 
@@ -54,6 +58,33 @@
 #define BIO_set_data(x, v) (x->ptr = v)
 #endif
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L && !defined(OPENSSL_IS_BORINGSSL)
+// The ticket key callback that takes an HMAC_CTX is deprecated as of OpenSSL 3.0.
+#define ZC_TLS_TICKET_KEY_EVP_CB 1
+#include <openssl/core_names.h>
+#else
+#define ZC_TLS_TICKET_KEY_EVP_CB 0
+#include <openssl/hmac.h>
+#endif
+
+#if __linux__ && defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+// Kernel TLS, for sending only. See TlsContext::Options::kernelTls.
+#define ZC_TLS_KERNEL_TX 1
+#include <errno.h>
+#include <linux/tls.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+
+// OpenSSL passes these to a BIO's ctrl callback, but only declares them in a private header.
+#define ZC_BIO_CTRL_SET_KTLS 72
+#define ZC_BIO_CTRL_SET_KTLS_TX_SEND_CTRL_MSG 74
+#define ZC_BIO_CTRL_CLEAR_KTLS_TX_CTRL_MSG 75
+#else
+#define ZC_TLS_KERNEL_TX 0
+#endif
+
 namespace zc {
 
 // =======================================================================================
@@ -203,6 +234,10 @@ public:
     BIO_set_data(bio, this);
     BIO_set_init(bio, 1);
     SSL_set_bio(ssl, bio, bio);
+
+    // Have OpenSSL ask for as much as its record buffer holds rather than a record header at a
+    // time, so that bioRead() can read whole records straight into that buffer.
+    SSL_set_read_ahead(ssl, 1);
   }
 
   zc::Promise<void> connect(zc::StringPtr expectedServerHostname) {
@@ -231,7 +266,7 @@ public:
     // https://letsencrypt.org/docs/dst-root-ca-x3-expiration-september-2021/
     X509_VERIFY_PARAM_set_flags(verify, X509_V_FLAG_TRUSTED_FIRST);
 
-    return sslCall([this]() { return SSL_connect(ssl); }).then([this](size_t) {
+    return handshakeCall(&SSL_connect).then([this](size_t) {
       X509* cert = SSL_get_peer_certificate(ssl);
       ZC_REQUIRE(cert != nullptr, "TLS peer provided no certificate") { return; }
       X509_free(cert);
@@ -248,7 +283,7 @@ public:
     // We are the server. Set SSL options to prefer server's cipher choice.
     SSL_set_options(ssl, SSL_OP_CIPHER_SERVER_PREFERENCE);
 
-    auto acceptPromise = sslCall([this]() { return SSL_accept(ssl); });
+    auto acceptPromise = handshakeCall(&SSL_accept);
     return acceptPromise.then([](size_t ret) {
       if (ret == 0) {
         zc::throwRecoverableException(
@@ -257,12 +292,40 @@ public:
     });
   }
 
+  void offloadHandshake(const WorkerPool& pool) {
+    // Run connect() or accept()'s handshake steps on `pool`'s threads.
+    handshakeWorkers = pool;
+    handshakeGuard = zc::arc<HandshakeGuard>(this);
+  }
+
+  void resumeSession(SSL_SESSION* session) {
+    // Offer to resume `session` in the handshake connect() starts. If the server declines, the
+    // handshake is a full one.
+    SSL_set_session(ssl, session);
+  }
+
   zc::Own<TlsPeerIdentity> getIdentity(zc::Own<zc::PeerIdentity> inner) {
-    return zc::heap<TlsPeerIdentity>(SSL_get_peer_certificate(ssl), zc::mv(inner),
-                                     zc::Badge<TlsConnection>());
+    const unsigned char* alpn = nullptr;
+    unsigned int alpnSize = 0;
+    SSL_get0_alpn_selected(ssl, &alpn, &alpnSize);
+    return zc::heap<TlsPeerIdentity>(
+        SSL_get_peer_certificate(ssl), zc::mv(inner), SSL_session_reused(ssl),
+        zc::heapString(reinterpret_cast<const char*>(alpn), alpnSize),
+        zc::Badge<TlsConnection>());
   }
 
-  ~TlsConnection() noexcept(false) { SSL_free(ssl); }
+  ~TlsConnection() noexcept(false) {
+    if (handshakeGuard != nullptr) {
+      // Wait out a handshake step still running on another thread.
+      *handshakeGuard->conn.lockExclusive() = nullptr;
+    }
+
+    // OpenSSL won't resume a session once a connection using it is freed without having sent
+    // close_notify, but dropping a connection is no reason not to resume its session later.
+    // Fatal errors still invalidate the session as they happen.
+    SSL_set_shutdown(ssl, SSL_get_shutdown(ssl) | SSL_SENT_SHUTDOWN);
+    SSL_free(ssl);
+  }
 
   zc::Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
     return tryReadInternal(buffer, minBytes, maxBytes, 0);
@@ -277,6 +340,28 @@ public:
     return writeInternal(pieces[0], pieces.slice(1, pieces.size())).attach(zc::mv(cork));
   }
 
+  Maybe<Promise<uint64_t>> tryPumpFrom(AsyncInputStream& input, uint64_t amount) override {
+#if ZC_TLS_KERNEL_TX
+    if (kernelTx != KernelTx::OFF) {
+      // The kernel encrypts whatever is written to the socket, so the underlying stream's
+      // sendfile() and splice() work as they would without TLS, once everything OpenSSL has
+      // already queued has gone out.
+      return whenWriteBufferEmpty().then([this, &input, amount]() {
+        finishKernelTx();
+        return input.pumpTo(inner, amount);
+      });
+    }
+#endif
+
+    // Otherwise everything has to pass through SSL_write(), so the underlying stream's sendfile() and
+    // splice() can't help. Pump through a buffer holding a full record's plaintext, though,
+    // rather than the generic pump's 4 KiB, so that each read turns into as few records as
+    // possible.
+    auto buffer = zc::heapArray<byte>(zc::min(amount, MAX_RECORD_PLAINTEXT));
+    auto promise = pumpLoop(input, buffer, amount, 0);
+    return promise.attach(zc::mv(buffer));
+  }
+
   Promise<void> whenWriteDisconnected() override { return inner.whenWriteDisconnected(); }
 
   void shutdownWrite() override {
@@ -337,6 +422,24 @@ private:
         });
   }
 
+  static constexpr uint64_t MAX_RECORD_PLAINTEXT = 16384;
+
+  Promise<uint64_t> pumpLoop(AsyncInputStream& input, zc::ArrayPtr<byte> buffer, uint64_t amount,
+                             uint64_t completedSoFar) {
+    uint64_t n = zc::min(amount - completedSoFar, buffer.size());
+    if (n == 0) return completedSoFar;
+
+    return input.tryRead(buffer.begin(), 1, n)
+        .then([this, &input, buffer, amount,
+               completedSoFar](size_t actual) -> zc::Promise<uint64_t> {
+          if (actual == 0) return completedSoFar;  // EOF
+          return writeInternal(buffer.first(actual), nullptr)
+              .then([this, &input, buffer, amount, completedSoFar = completedSoFar + actual]() {
+                return pumpLoop(input, buffer, amount, completedSoFar);
+              });
+        });
+  }
+
   Promise<void> writeInternal(zc::ArrayPtr<const byte> first,
                               zc::ArrayPtr<const zc::ArrayPtr<const byte>> rest) {
     ZC_REQUIRE(shutdownTask == zc::none, "already called shutdownWrite()");
@@ -371,40 +474,116 @@ private:
       return result;
     } else {
       int error = SSL_get_error(ssl, result);
-      switch (error) {
-        case SSL_ERROR_ZERO_RETURN:
-          return constPromise<size_t, 0>();
-        case SSL_ERROR_WANT_READ:
-          return readBuffer.whenReady().then(
-              [this, func = zc::mv(func)]() mutable { return sslCall(zc::fwd<Func>(func)); });
-        case SSL_ERROR_WANT_WRITE:
-          return writeBuffer.whenReady().then(
-              [this, func = zc::mv(func)]() mutable { return sslCall(zc::fwd<Func>(func)); });
-        case SSL_ERROR_SSL:
-          return getOpensslError();
-        case SSL_ERROR_SYSCALL:
-          if (result == 0) {
-            // OpenSSL pre-3.0 reports unexpected disconnects this way. Note that 3.0+ report it
-            // as SSL_ERROR_SSL with the reason SSL_R_UNEXPECTED_EOF_WHILE_READING, which is
-            // handled in throwOpensslError().
-            return ZC_EXCEPTION(DISCONNECTED,
-                                "peer disconnected without gracefully ending TLS session");
-          } else {
-            // According to documentation we shouldn't get here, because our BIO never returns an
-            // "error". But in practice we do get here sometimes when the peer disconnects
-            // prematurely.
-            return ZC_EXCEPTION(DISCONNECTED, "SSL unable to continue I/O");
-          }
-        default:
-          ZC_FAIL_ASSERT("unexpected SSL error code", error);
-      }
+      if (error == SSL_ERROR_SSL) return getOpensslError();
+      return sslErrorResult(result, error, [this, func = zc::mv(func)]() mutable {
+        return sslCall(zc::fwd<Func>(func));
+      });
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Handshakes on a WorkerPool
+
+  zc::Maybe<const WorkerPool&> handshakeWorkers;
+
+  struct HandshakeGuard : public zc::AtomicRefcounted {
+    // Keeps a handshake step running on another thread from outliving the connection.
+    explicit HandshakeGuard(TlsConnection* conn) : conn(conn) {}
+    zc::MutexGuarded<TlsConnection*> conn;
+  };
+  zc::Arc<HandshakeGuard> handshakeGuard;
+
+  struct HandshakeStep {
+    int result = 0;
+    int error = SSL_ERROR_NONE;
+    zc::Maybe<zc::Exception> exception;
+  };
+
+  zc::Promise<size_t> handshakeCall(int (*step)(SSL*)) {
+    ZC_IF_SOME(pool, handshakeWorkers) { return offloadedHandshakeCall(pool, step); }
+    return sslCall([this, step]() { return step(ssl); });
+  }
+
+  zc::Promise<size_t> offloadedHandshakeCall(const WorkerPool& pool, int (*step)(SSL*)) {
+    // Like sslCall(), but calls `step` on one of `pool`'s threads. The step reads and writes
+    // through readBuffer and writeBuffer there, so they mustn't be doing I/O of their own on the
+    // event loop in the meantime: wait until they're idle, and keep them from starting any until
+    // the step is done.
+    return whenBuffersIdle()
+        .then([this, &pool, step]() {
+          readBuffer.deferPumps();
+          writeBuffer.deferPumps();
+          return pool.run([guard = handshakeGuard.addRef(), step]() {
+            HandshakeStep result;
+            auto conn = guard->conn.lockExclusive();
+            if (*conn == nullptr) return result;  // The connection is gone.
+
+            SSL* ssl = (*conn)->ssl;
+            result.result = step(ssl);
+            if (result.result <= 0) {
+              result.error = SSL_get_error(ssl, result.result);
+              // OpenSSL's error queue is per-thread.
+              if (result.error == SSL_ERROR_SSL) result.exception = getOpensslError();
+              ERR_clear_error();
+            }
+            return result;
+          });
+        })
+        .then([this, &pool, step](HandshakeStep&& result) -> zc::Promise<size_t> {
+          readBuffer.resumePumps();
+          writeBuffer.resumePumps();
+
+          if (result.result > 0) return size_t(result.result);
+          ZC_IF_SOME(exception, result.exception) { return zc::mv(exception); }
+          return sslErrorResult(result.result, result.error, [this, &pool, step]() {
+            return offloadedHandshakeCall(pool, step);
+          });
+        });
+  }
+
+  zc::Promise<void> whenBuffersIdle() {
+    if (readBuffer.isBusy()) {
+      return readBuffer.whenReady().then([this]() { return whenBuffersIdle(); });
+    } else if (writeBuffer.isBusy()) {
+      return writeBuffer.whenReady().then([this]() { return whenBuffersIdle(); });
+    } else {
+      return zc::READY_NOW;
+    }
+  }
+
+  template <typename Retry>
+  zc::Promise<size_t> sslErrorResult(int result, int error, Retry&& retry) {
+    // What to do about an OpenSSL call that returned `result`, for which SSL_get_error() returned
+    // `error`, other than SSL_ERROR_SSL. `retry` makes the call again.
+    switch (error) {
+      case SSL_ERROR_ZERO_RETURN:
+        return constPromise<size_t, 0>();
+      case SSL_ERROR_WANT_READ:
+        return readBuffer.whenReady().then(zc::fwd<Retry>(retry));
+      case SSL_ERROR_WANT_WRITE:
+        return writeBuffer.whenReady().then(zc::fwd<Retry>(retry));
+      case SSL_ERROR_SYSCALL:
+        if (result == 0) {
+          // OpenSSL pre-3.0 reports unexpected disconnects this way. Note that 3.0+ report it
+          // as SSL_ERROR_SSL with the reason SSL_R_UNEXPECTED_EOF_WHILE_READING, which is
+          // handled in throwOpensslError().
+          return ZC_EXCEPTION(DISCONNECTED,
+                              "peer disconnected without gracefully ending TLS session");
+        } else {
+          // According to documentation we shouldn't get here, because our BIO never returns an
+          // "error". But in practice we do get here sometimes when the peer disconnects
+          // prematurely.
+          return ZC_EXCEPTION(DISCONNECTED, "SSL unable to continue I/O");
+        }
+      default:
+        ZC_FAIL_ASSERT("unexpected SSL error code", error);
     }
   }
 
   static int bioRead(BIO* b, char* out, int outl) {
     BIO_clear_retry_flags(b);
     ZC_IF_SOME(n, reinterpret_cast<TlsConnection*>(BIO_get_data(b))
-                      ->readBuffer.read(zc::asBytes(out, outl))) {
+                      ->readBuffer.readInPlace(zc::asBytes(out, outl))) {
       return n;
     }
     else {
@@ -413,10 +592,147 @@ private:
     }
   }
 
+#if ZC_TLS_KERNEL_TX
+  enum class KernelTx { OFF, PENDING, ON };
+  KernelTx kernelTx = KernelTx::OFF;
+  // OpenSSL hands over the keys for sending (see startKernelTx()) just after queuing the last
+  // record it encrypts itself, and from then on passes plaintext to bioWrite(). The keys can't go
+  // to the kernel until everything queued ahead of them has been written to the socket, though,
+  // or the kernel would encrypt it a second time; until then, kernelTx is PENDING.
+
+  zc::Array<byte> kernelTxKeys;
+  // The kernel's `tls12_crypto_info_*` struct, while PENDING.
+
+  zc::Maybe<byte> controlRecordType;
+  // Set by OpenSSL while it writes a record other than application data (an alert, or a session
+  // ticket), whose type has to be passed to the kernel along with the bytes.
+
+  bool startKernelTx(const void* cryptoInfo) {
+    size_t size;
+    switch (reinterpret_cast<const tls_crypto_info*>(cryptoInfo)->cipher_type) {
+      case TLS_CIPHER_AES_GCM_128:
+        size = sizeof(tls12_crypto_info_aes_gcm_128);
+        break;
+      case TLS_CIPHER_AES_GCM_256:
+        size = sizeof(tls12_crypto_info_aes_gcm_256);
+        break;
+#ifdef TLS_CIPHER_AES_CCM_128
+      case TLS_CIPHER_AES_CCM_128:
+        size = sizeof(tls12_crypto_info_aes_ccm_128);
+        break;
+#endif
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+      case TLS_CIPHER_CHACHA20_POLY1305:
+        size = sizeof(tls12_crypto_info_chacha20_poly1305);
+        break;
+#endif
+      default:
+        return false;
+    }
+    if (inner.getFd() == zc::none) return false;
+
+    // Attaching the kernel's TLS layer fails unless the socket is TCP and the kernel has the
+    // module, in which case OpenSSL carries on as usual. It goes through `inner` rather than
+    // straight to the fd so that a stream which buffers writes of its own can refuse.
+    static constexpr char ULP[] = "tls";
+    if (zc::runCatchingExceptions(
+            [&]() { inner.setsockopt(IPPROTO_TCP, TCP_ULP, ULP, sizeof(ULP)); }) != zc::none) {
+      return false;
+    }
+
+    kernelTxKeys = zc::heapArray(zc::arrayPtr(reinterpret_cast<const byte*>(cryptoInfo), size));
+    kernelTx = KernelTx::PENDING;
+    return true;
+  }
+
+  void finishKernelTx() {
+    // Gives the kernel the keys, once nothing is left in writeBuffer.
+    if (kernelTx != KernelTx::PENDING) return;
+
+    auto keys = zc::mv(kernelTxKeys);
+    ZC_DEFER(OPENSSL_cleanse(keys.begin(), keys.size()));
+    inner.setsockopt(SOL_TLS, TLS_TX, keys.begin(), keys.size());
+    kernelTx = KernelTx::ON;
+  }
+
+  zc::Promise<void> whenWriteBufferEmpty() {
+    if (writeBuffer.isEmpty()) return zc::READY_NOW;
+    writeBuffer.flush();
+    return writeBuffer.whenReady().then([this]() { return whenWriteBufferEmpty(); });
+  }
+
+  int kernelTxWrite(BIO* b, zc::ArrayPtr<const byte> data) {
+    if (kernelTx == KernelTx::PENDING || controlRecordType != zc::none) {
+      if (!writeBuffer.isEmpty()) {
+        writeBuffer.flush();
+        BIO_set_retry_write(b);
+        return -1;
+      }
+    }
+
+    ZC_IF_SOME(exception, zc::runCatchingExceptions([this]() { finishKernelTx(); })) {
+      // It's too late to fall back: OpenSSL has already thrown its copy of the keys away.
+      ZC_LOG(ERROR, "failed to hand TLS keys to the kernel", exception);
+      return -1;
+    }
+
+    ZC_IF_SOME(type, controlRecordType) {
+      // Control records are sent straight to the socket, which is fine since writeBuffer is
+      // empty.
+      int fd = ZC_ASSERT_NONNULL(inner.getFd());
+
+      union {
+        char buffer[CMSG_SPACE(sizeof(type))];
+        struct cmsghdr align;
+      } control;
+      memset(&control, 0, sizeof(control));
+
+      struct iovec iov;
+      iov.iov_base = const_cast<byte*>(data.begin());
+      iov.iov_len = data.size();
+
+      struct msghdr msg;
+      memset(&msg, 0, sizeof(msg));
+      msg.msg_iov = &iov;
+      msg.msg_iovlen = 1;
+      msg.msg_control = control.buffer;
+      msg.msg_controllen = sizeof(control.buffer);
+
+      struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+      cmsg->cmsg_level = SOL_TLS;
+      cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+      cmsg->cmsg_len = CMSG_LEN(sizeof(type));
+      *CMSG_DATA(cmsg) = type;
+
+      ssize_t n;
+      do { n = ::sendmsg(fd, &msg, MSG_NOSIGNAL); } while (n < 0 && errno == EINTR);
+      if (n < 0) {
+        // TODO(perf): On EAGAIN, sslCall() retries on the next turn of the event loop rather than
+        //   waiting for the socket to become writable. Control records are tiny and rare, so the
+        //   socket's send buffer is hardly ever full when one is sent.
+        if (errno == EAGAIN || errno == EWOULDBLOCK) { BIO_set_retry_write(b); }
+        return -1;
+      }
+      if (size_t(n) == data.size()) controlRecordType = zc::none;
+      return n;
+    }
+
+    ZC_IF_SOME(n, writeBuffer.write(data)) { return n; }
+    BIO_set_retry_write(b);
+    return -1;
+  }
+#endif
+
   static int bioWrite(BIO* b, const char* in, int inl) {
     BIO_clear_retry_flags(b);
+#if ZC_TLS_KERNEL_TX
+    auto& self = *reinterpret_cast<TlsConnection*>(BIO_get_data(b));
+    if (self.kernelTx != KernelTx::OFF) return self.kernelTxWrite(b, zc::asBytes(in, inl));
+#endif
+    // OpenSSL retries a write from the same place in its record buffer, so whole records can be
+    // written from there without a copy.
     ZC_IF_SOME(n, reinterpret_cast<TlsConnection*>(BIO_get_data(b))
-                      ->writeBuffer.write(zc::asBytes(in, inl))) {
+                      ->writeBuffer.writeInPlace(zc::asBytes(in, inl))) {
       return n;
     }
     else {
@@ -435,10 +751,24 @@ private:
       case BIO_CTRL_POP:
         // Informational?
         return 0;
-#ifdef BIO_CTRL_GET_KTLS_SEND
+#if ZC_TLS_KERNEL_TX
+      case ZC_BIO_CTRL_SET_KTLS:
+        // `num` is nonzero for sending. Receiving stays in userspace: readBuffer may already hold
+        // bytes the kernel would need to have seen.
+        return num && reinterpret_cast<TlsConnection*>(BIO_get_data(b))->startKernelTx(ptr);
+      case BIO_CTRL_GET_KTLS_SEND:
+        return reinterpret_cast<TlsConnection*>(BIO_get_data(b))->kernelTx != KernelTx::OFF;
+      case BIO_CTRL_GET_KTLS_RECV:
+        return 0;
+      case ZC_BIO_CTRL_SET_KTLS_TX_SEND_CTRL_MSG:
+        reinterpret_cast<TlsConnection*>(BIO_get_data(b))->controlRecordType = byte(num);
+        return 0;
+      case ZC_BIO_CTRL_CLEAR_KTLS_TX_CTRL_MSG:
+        reinterpret_cast<TlsConnection*>(BIO_get_data(b))->controlRecordType = zc::none;
+        return 0;
+#elif defined(BIO_CTRL_GET_KTLS_SEND)
       case BIO_CTRL_GET_KTLS_SEND:
       case BIO_CTRL_GET_KTLS_RECV:
-        // TODO(someday): Support kTLS if the underlying stream is a raw socket.
         return 0;
 #endif
       default:
@@ -610,6 +940,7 @@ public:
   }
 
   Own<ConnectionReceiver> listen() override { return tls.wrapPort(inner->listen()); }
+  Own<ConnectionReceiver> listenShared() override { return tls.wrapPort(inner->listenShared()); }
 
   Own<NetworkAddress> clone() override {
     return zc::heap<TlsNetworkAddress>(tls, zc::str(hostname), inner->clone());
@@ -690,6 +1021,10 @@ public:
     return zc::heap<TlsNetwork>(tls, inner.restrictPeers(allow, deny));
   }
 
+  Own<Network> withConnectionAttemptDelay(Duration delay) override {
+    return zc::heap<TlsNetwork>(tls, inner.withConnectionAttemptDelay(delay));
+  }
+
 private:
   TlsContext& tls;
   zc::Network& inner;
@@ -699,14 +1034,31 @@ private:
 // =======================================================================================
 // class TlsContext
 
+static int selectAlpnProtocol(SSL* ssl, const unsigned char** out, unsigned char* outSize,
+                              const unsigned char* in, unsigned int inSize, void* arg) {
+  // The last parameter is actually type zc::Array<byte>*, holding our protocols in wire format.
+  // SSL_select_next_proto() goes by the order of its first list, so ours takes precedence.
+
+  auto& ours = *reinterpret_cast<zc::Array<byte>*>(arg);
+  unsigned char* selected;
+  if (SSL_select_next_proto(&selected, outSize, ours.begin(), ours.size(), in, inSize) !=
+      OPENSSL_NPN_NEGOTIATED) {
+    return SSL_TLSEXT_ERR_NOACK;
+  }
+  *out = selected;
+  return SSL_TLSEXT_ERR_OK;
+}
+
 TlsContext::Options::Options()
     : useSystemTrustStore(true),
       verifyClients(false),
       minVersion(TlsVersion::TLS_1_2),
       cipherList(
           "ECDHE-ECDSA-AES128-GCM-SHA256:ECDHE-RSA-AES128-GCM-SHA256:ECDHE-ECDSA-AES256-GCM-SHA384:"
-          "ECDHE-RSA-AES256-GCM-SHA384:ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305") {
-}
+          "ECDHE-RSA-AES256-GCM-SHA384:ECDHE-ECDSA-CHACHA20-POLY1305:ECDHE-RSA-CHACHA20-POLY1305"),
+      kernelTls(false),
+      sessionCacheSize(20480),
+      clientSessionCacheSize(0) {}
 // Cipher list is Mozilla's "intermediate" list, except with classic DH removed since we don't
 // currently support setting dhparams. See:
 //     https://mozilla.github.io/server-side-tls/ssl-config-generator/
@@ -721,6 +1073,169 @@ struct TlsContext::SniCallback {
   static int callback(SSL* ssl, int* ad, void* arg);
 };
 
+struct TlsContext::SessionCache {
+  // What a context needs for session resumption beyond what OpenSSL keeps itself. OpenSSL's
+  // callbacks find it through the SSL_CTX's app data.
+
+  struct TicketKey {
+    byte name[16];
+    byte hmacKey[32];
+    byte aesKey[32];
+  };
+  static_assert(sizeof(TicketKey) == 80);
+
+  struct TicketKeys {
+    TicketKey current;
+    zc::Maybe<TicketKey> previous;
+  };
+  zc::MutexGuarded<TicketKeys> ticketKeys;
+
+  zc::Maybe<TlsSessionStore&> store;
+
+  uint clientCapacity = 0;
+  zc::MutexGuarded<zc::HashMap<zc::String, SSL_SESSION*>> clientSessions;
+  // The latest session for each hostname connected to, holding a reference.
+
+  SessionCache() {
+    auto keys = ticketKeys.lockExclusive();
+    if (RAND_bytes(reinterpret_cast<byte*>(&keys->current), sizeof(TicketKey)) <= 0) {
+      throwOpensslError();
+    }
+  }
+
+  ~SessionCache() noexcept(false) {
+    OPENSSL_cleanse(&*ticketKeys.lockExclusive(), sizeof(TicketKeys));
+    for (auto& entry : *clientSessions.lockExclusive()) { SSL_SESSION_free(entry.value); }
+  }
+
+  static SessionCache& from(SSL* ssl) {
+    return *reinterpret_cast<SessionCache*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+  }
+
+  void resume(TlsConnection& conn, zc::StringPtr hostname) {
+    if (clientCapacity == 0) return;
+    auto lock = clientSessions.lockExclusive();
+    ZC_IF_SOME(session, lock->find(hostname)) {
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L || defined(OPENSSL_IS_BORINGSSL)
+      // A TLS 1.3 client uses each ticket only once.
+      if (!SSL_SESSION_is_resumable(session)) return;
+#endif
+      conn.resumeSession(session);
+    }
+  }
+
+  static int newSession(SSL* ssl, SSL_SESSION* session) {
+    // Returns 1 if we've kept OpenSSL's reference to `session`.
+    auto& self = from(ssl);
+
+    if (!SSL_is_server(ssl)) {
+      const char* hostname = SSL_get_servername(ssl, TLSEXT_NAMETYPE_host_name);
+      if (hostname == nullptr || self.clientCapacity == 0) return 0;
+
+      auto lock = self.clientSessions.lockExclusive();
+      ZC_IF_SOME(old, lock->find(zc::StringPtr(hostname))) {
+        SSL_SESSION_free(old);
+        old = session;
+        return 1;
+      }
+      if (lock->size() >= self.clientCapacity) {
+        // Make room by forgetting some other host.
+        auto& victim = *lock->begin();
+        SSL_SESSION_free(victim.value);
+        lock->erase(victim);
+      }
+      lock->insert(zc::heapString(hostname), session);
+      return 1;
+    }
+
+    ZC_IF_SOME(store, self.store) {
+      // A TLS 1.3 session is resumed from its ticket, never by ID.
+      if (SSL_version(ssl) >= TLS1_3_VERSION && (SSL_get_options(ssl) & SSL_OP_NO_TICKET) == 0) {
+        return 0;
+      }
+
+      int size = i2d_SSL_SESSION(session, nullptr);
+      if (size <= 0) return 0;
+      auto bytes = zc::heapArray<byte>(size);
+      byte* out = bytes.begin();
+      i2d_SSL_SESSION(session, &out);
+
+      unsigned int idSize;
+      const byte* id = SSL_SESSION_get_id(session, &idSize);
+      ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() {
+                   store.put(zc::arrayPtr(id, idSize), bytes,
+                             SSL_SESSION_get_timeout(session) * zc::SECONDS);
+                 })) {
+        ZC_LOG(ERROR, "exception when storing TLS session", exception);
+      }
+    }
+    return 0;
+  }
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L || defined(OPENSSL_IS_BORINGSSL)
+  static SSL_SESSION* getSession(SSL* ssl, const byte* id, int idSize, int* copy) {
+#else
+  static SSL_SESSION* getSession(SSL* ssl, byte* id, int idSize, int* copy) {
+#endif
+    *copy = 0;  // OpenSSL takes our reference.
+
+    SSL_SESSION* result = nullptr;
+    ZC_IF_SOME(store, from(ssl).store) {
+      ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() {
+                   ZC_IF_SOME(bytes, store.get(zc::arrayPtr(id, idSize))) {
+                     const byte* in = bytes.begin();
+                     result = d2i_SSL_SESSION(nullptr, &in, bytes.size());
+                   }
+                 })) {
+        ZC_LOG(ERROR, "exception when looking up TLS session", exception);
+      }
+    }
+    return result;
+  }
+
+#if ZC_TLS_TICKET_KEY_EVP_CB
+  static int ticketKey(SSL* ssl, byte name[16], byte iv[16], EVP_CIPHER_CTX* cipher,
+                       EVP_MAC_CTX* mac, int encrypt) {
+#else
+  static int ticketKey(SSL* ssl, byte name[16], byte iv[16], EVP_CIPHER_CTX* cipher,
+                       HMAC_CTX* mac, int encrypt) {
+#endif
+    // Returns 1 to use the key, 2 to use it and issue a new ticket under the current key, 0 if
+    // the ticket's key is unknown (meaning a full handshake), or -1 on error.
+    auto keys = from(ssl).ticketKeys.lockExclusive();
+
+    const TicketKey* key = &keys->current;
+    // A TLS 1.3 client uses each ticket only once, so it needs a new one every time.
+    int result = SSL_version(ssl) >= TLS1_3_VERSION ? 2 : 1;
+    if (encrypt) {
+      memcpy(name, key->name, sizeof(key->name));
+      if (RAND_bytes(iv, 16) <= 0) return -1;
+    } else if (memcmp(name, key->name, sizeof(key->name)) != 0) {
+      ZC_IF_SOME(previous, keys->previous) {
+        if (memcmp(name, previous.name, sizeof(previous.name)) != 0) return 0;
+        key = &previous;
+        result = 2;
+      }
+      else { return 0; }
+    }
+
+    if (!EVP_CipherInit_ex(cipher, EVP_aes_256_cbc(), nullptr, key->aesKey, iv, encrypt)) {
+      return -1;
+    }
+#if ZC_TLS_TICKET_KEY_EVP_CB
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_octet_string(OSSL_MAC_PARAM_KEY, const_cast<byte*>(key->hmacKey),
+                                          sizeof(key->hmacKey)),
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end()};
+    if (!EVP_MAC_CTX_set_params(mac, params)) return -1;
+#else
+    if (!HMAC_Init_ex(mac, key->hmacKey, sizeof(key->hmacKey), EVP_sha256(), nullptr)) return -1;
+#endif
+    return result;
+  }
+};
+
 TlsContext::TlsContext(Options options) {
   ensureOpenSslInitialized();
 
@@ -769,6 +1284,11 @@ TlsContext::TlsContext(Options options) {
     ZC_FAIL_REQUIRE("OpenSSL headers don't support TLS 1.3");
 #endif
   }
+#if ZC_TLS_KERNEL_TX
+  // honor options.kernelTls -- TlsConnection::startKernelTx() decides whether each connection
+  // can actually use it
+  if (options.kernelTls) { optionFlags |= SSL_OP_ENABLE_KTLS; }
+#endif
   SSL_CTX_set_options(ctx, optionFlags);  // note: never fails; returns new options bitmask
 
   // honor options.cipherList
@@ -805,6 +1325,59 @@ TlsContext::TlsContext(Options options) {
     SSL_CTX_set_tlsext_servername_arg(ctx, &sni);
   }
 
+  // honor options.alpnProtocols
+  if (options.alpnProtocols.size() > 0) {
+    size_t size = 0;
+    for (auto& protocol : options.alpnProtocols) {
+      ZC_REQUIRE(protocol.size() > 0 && protocol.size() < 256, "invalid ALPN protocol", protocol);
+      size += protocol.size() + 1;
+    }
+    auto builder = zc::heapArrayBuilder<byte>(size);
+    for (auto& protocol : options.alpnProtocols) {
+      builder.add(protocol.size());
+      builder.addAll(protocol.asBytes());
+    }
+    alpnProtocols = builder.finish();
+
+    // Note that SSL_CTX_set_alpn_protos() returns zero on success, unlike most OpenSSL functions.
+    if (SSL_CTX_set_alpn_protos(ctx, alpnProtocols.begin(), alpnProtocols.size()) != 0) {
+      throwOpensslError();
+    }
+    SSL_CTX_set_alpn_select_cb(ctx, &selectAlpnProtocol, &alpnProtocols);
+  }
+
+  // honor options.sessionCacheSize, options.sessionStore, and options.clientSessionCacheSize
+  sessions = zc::heap<SessionCache>();
+  sessions->store = options.sessionStore;
+  sessions->clientCapacity = options.clientSessionCacheSize;
+  SSL_CTX_set_app_data(ctx, sessions.get());
+
+  long cacheMode = SSL_SESS_CACHE_SERVER;
+  if (options.sessionCacheSize == 0) {
+    cacheMode |= SSL_SESS_CACHE_NO_INTERNAL;
+  } else {
+    SSL_CTX_sess_set_cache_size(ctx, options.sessionCacheSize);
+  }
+  if (options.clientSessionCacheSize > 0) { cacheMode |= SSL_SESS_CACHE_CLIENT; }
+  SSL_CTX_set_session_cache_mode(ctx, cacheMode);
+  SSL_CTX_sess_set_new_cb(ctx, &SessionCache::newSession);
+  if (options.sessionStore != zc::none) {
+    SSL_CTX_sess_set_get_cb(ctx, &SessionCache::getSession);
+  }
+#if ZC_TLS_TICKET_KEY_EVP_CB
+  SSL_CTX_set_tlsext_ticket_key_evp_cb(ctx, &SessionCache::ticketKey);
+#else
+  SSL_CTX_set_tlsext_ticket_key_cb(ctx, &SessionCache::ticketKey);
+#endif
+
+  // OpenSSL refuses to resume sessions on a server that verifies clients unless they're tagged
+  // with a context. Sessions only ever come from this TlsContext or the application's own
+  // sessionStore and ticket keys, so a constant will do.
+  static constexpr byte SESSION_ID_CONTEXT[] = {'z', 'c'};
+  if (!SSL_CTX_set_session_id_context(ctx, SESSION_ID_CONTEXT, sizeof(SESSION_ID_CONTEXT))) {
+    throwOpensslError();
+  }
+
   ZC_IF_SOME(timeout, options.acceptTimeout) {
     this->timer = ZC_REQUIRE_NONNULL(options.timer,
                                      "acceptTimeout option requires that a timer is also provided");
@@ -812,6 +1385,7 @@ TlsContext::TlsContext(Options options) {
   }
 
   this->acceptErrorHandler = zc::mv(options.acceptErrorHandler);
+  this->handshakeWorkers = options.handshakeWorkers;
 
   this->ctx = ctx;
 }
@@ -858,9 +1432,27 @@ int TlsContext::SniCallback::callback(SSL* ssl, int* ad, void* arg) {
 
 TlsContext::~TlsContext() noexcept(false) { SSL_CTX_free(reinterpret_cast<SSL_CTX*>(ctx)); }
 
+void TlsContext::rotateSessionTicketKey(zc::Maybe<zc::ArrayPtr<const byte>> key) {
+  SessionCache::TicketKey next;
+  ZC_IF_SOME(k, key) {
+    ZC_REQUIRE(k.size() == sizeof(next), "session ticket key must be 80 bytes", k.size());
+    memcpy(&next, k.begin(), sizeof(next));
+  }
+  else {
+    if (RAND_bytes(reinterpret_cast<byte*>(&next), sizeof(next)) <= 0) { throwOpensslError(); }
+  }
+
+  auto keys = sessions->ticketKeys.lockExclusive();
+  keys->previous = keys->current;
+  keys->current = next;
+  OPENSSL_cleanse(&next, sizeof(next));
+}
+
 zc::Promise<zc::Own<zc::AsyncIoStream>> TlsContext::wrapClient(
     zc::Own<zc::AsyncIoStream> stream, zc::StringPtr expectedServerHostname) {
   auto conn = zc::heap<TlsConnection>(zc::mv(stream), reinterpret_cast<SSL_CTX*>(ctx));
+  ZC_IF_SOME(pool, handshakeWorkers) { conn->offloadHandshake(pool); }
+  sessions->resume(*conn, expectedServerHostname);
   auto promise = conn->connect(expectedServerHostname);
   return promise.then(
       [conn = zc::mv(conn)]() mutable -> zc::Own<zc::AsyncIoStream> { return zc::mv(conn); });
@@ -868,6 +1460,7 @@ zc::Promise<zc::Own<zc::AsyncIoStream>> TlsContext::wrapClient(
 
 zc::Promise<zc::Own<zc::AsyncIoStream>> TlsContext::wrapServer(zc::Own<zc::AsyncIoStream> stream) {
   auto conn = zc::heap<TlsConnection>(zc::mv(stream), reinterpret_cast<SSL_CTX*>(ctx));
+  ZC_IF_SOME(pool, handshakeWorkers) { conn->offloadHandshake(pool); }
   auto promise = conn->accept();
   ZC_IF_SOME(timeout, acceptTimeout) {
     promise = ZC_REQUIRE_NONNULL(timer)
@@ -885,6 +1478,8 @@ zc::Promise<zc::Own<zc::AsyncIoStream>> TlsContext::wrapServer(zc::Own<zc::Async
 zc::Promise<zc::AuthenticatedStream> TlsContext::wrapClient(zc::AuthenticatedStream stream,
                                                             zc::StringPtr expectedServerHostname) {
   auto conn = zc::heap<TlsConnection>(zc::mv(stream.stream), reinterpret_cast<SSL_CTX*>(ctx));
+  ZC_IF_SOME(pool, handshakeWorkers) { conn->offloadHandshake(pool); }
+  sessions->resume(*conn, expectedServerHostname);
   auto promise = conn->connect(expectedServerHostname);
   return promise.then([conn = zc::mv(conn), innerId = zc::mv(stream.peerIdentity)]() mutable {
     auto id = conn->getIdentity(zc::mv(innerId));
@@ -894,6 +1489,7 @@ zc::Promise<zc::AuthenticatedStream> TlsContext::wrapClient(zc::AuthenticatedStr
 
 zc::Promise<zc::AuthenticatedStream> TlsContext::wrapServer(zc::AuthenticatedStream stream) {
   auto conn = zc::heap<TlsConnection>(zc::mv(stream.stream), reinterpret_cast<SSL_CTX*>(ctx));
+  ZC_IF_SOME(pool, handshakeWorkers) { conn->offloadHandshake(pool); }
   auto promise = conn->accept();
   ZC_IF_SOME(timeout, acceptTimeout) {
     promise = ZC_REQUIRE_NONNULL(timer)
@@ -38,7 +38,9 @@ class TlsPrivateKey;
 class TlsCertificate;
 struct TlsKeypair;
 class TlsSniCallback;
+class TlsSessionStore;
 class TlsConnection;
+class WorkerPool;
 
 enum class TlsVersion {
   SSL_3,    // avoid; cryptographically broken
@@ -116,6 +118,48 @@ public:
 
     zc::Maybe<TlsErrorHandler> acceptErrorHandler;
     // Error handler used for TLS accept errors.
+
+    bool kernelTls;
+    // If true, on Linux, connections over TCP sockets hand the encryption of outgoing records to
+    // the kernel ("kTLS") once the handshake is done. The kernel then encrypts whatever is
+    // written to the socket, which in particular lets pumps into the connection from files and
+    // other sockets use sendfile() and splice() instead of passing everything through OpenSSL.
+    // Incoming records are still decrypted by OpenSSL. Connections quietly go on encrypting in
+    // userspace wherever OpenSSL, the kernel (which needs the `tls` module), the cipher, or the
+    // underlying stream doesn't support it. Default: false.
+
+    uint sessionCacheSize;
+    // Number of sessions a server keeps in memory, so that clients coming back can resume them
+    // with an abbreviated handshake instead of a full one. Zero disables the cache. Default: 20480.
+    //
+    // Only clients resuming by session ID need the cache: those on TLS 1.3, and most on TLS 1.2,
+    // resume from a session ticket instead, which the server needn't store. See
+    // rotateSessionTicketKey().
+
+    zc::Maybe<TlsSessionStore&> sessionStore;
+    // Where a server also keeps sessions for resumption by session ID, e.g. so that servers
+    // behind a load balancer can resume each other's sessions. Must outlive the TlsContext.
+    // Default: none.
+
+    uint clientSessionCacheSize;
+    // Number of hostnames for which a client remembers the latest session, to resume on the next
+    // connection to the same hostname. Default: 0 (clients always do a full handshake).
+
+    zc::Maybe<const WorkerPool&> handshakeWorkers;
+    // If set, connections run each step of their handshakes on one of these threads, resuming on
+    // the event loop whenever the step has to wait for the peer. The private-key operation a
+    // server does in every full handshake, and the certificate checks a client does, then don't
+    // hold up the event loop, so a flood of new connections doesn't stall established ones. It
+    // costs a round trip to the pool for each step, so it's only worthwhile for busy servers.
+    //
+    // The sniCallback and sessionStore are then called on the pool's threads, possibly several at
+    // once. Must outlive the TlsContext. Default: none.
+
+    zc::ArrayPtr<const zc::StringPtr> alpnProtocols;
+    // Application protocols to negotiate via ALPN, most preferred first, e.g. {"h2", "http/1.1"}
+    // to offer HTTP/2 alongside HTTP/1.1. A client offers them all; a server picks the first of
+    // them that the client offered, and goes without if there's none. Either side finds out what
+    // was picked from TlsPeerIdentity::getAlpnProtocol(). Default: none.
   };
 
   TlsContext(Options options = Options());
@@ -159,13 +203,30 @@ public:
   // only accept addresses of the form "hostname" and "hostname:port" (it does not accept raw IP
   // addresses). It will automatically use SNI and verify certificates based on these hostnames.
 
+  void rotateSessionTicketKey(zc::Maybe<zc::ArrayPtr<const byte>> key = zc::none);
+  // Start encrypting session tickets under a new key: `key` if given, which must be 80 bytes
+  // (a 16-byte name, a 32-byte HMAC key and a 32-byte AES key, the layout OpenSSL's
+  // SSL_CTX_set_tlsext_ticket_keys() uses), otherwise a random one. Tickets issued under the
+  // previous key are still accepted, and replaced with new ones; tickets issued under any key
+  // before that are not, so their clients do a full handshake.
+  //
+  // The context starts out with a random key. Servers should rotate it periodically, e.g. from a
+  // timer every few hours, since anyone who obtains the key can decrypt every session whose
+  // ticket it encrypted. Servers behind a load balancer can accept each other's tickets by
+  // rotating to the same keys.
+
 private:
   void* ctx;  // actually type SSL_CTX, but we don't want to #include the OpenSSL headers here
   zc::Maybe<zc::Timer&> timer;
   zc::Maybe<zc::Duration> acceptTimeout;
   zc::Maybe<TlsErrorHandler> acceptErrorHandler;
+  zc::Maybe<const WorkerPool&> handshakeWorkers;
+  zc::Array<byte> alpnProtocols;  // in the wire format: each name prefixed with its length
 
   struct SniCallback;
+
+  struct SessionCache;
+  zc::Own<SessionCache> sessions;
 };
 
 class TlsPrivateKey {
@@ -271,6 +332,23 @@ public:
   // TlsContext::Options::defaultKeypair.
 };
 
+class TlsSessionStore {
+  // Storage for server-side TLS sessions outside the process; see
+  // TlsContext::Options::sessionStore.
+  //
+  // Like TlsSniCallback, this is synchronous because OpenSSL's callbacks are. An implementation
+  // backed by a remote service should keep a local replica rather than block the event loop.
+
+public:
+  virtual void put(zc::ArrayPtr<const byte> id, zc::ArrayPtr<const byte> session,
+                   zc::Duration ttl) = 0;
+  // Store `session`, a serialized session, under its session ID `id`. It may be dropped at any
+  // time, and should be dropped after `ttl`.
+
+  virtual zc::Maybe<zc::Array<byte>> get(zc::ArrayPtr<const byte> id) = 0;
+  // Get the session stored under `id`, if there is one.
+};
+
 class TlsPeerIdentity final : public zc::PeerIdentity {
 public:
   ZC_DISALLOW_COPY_AND_MOVE(TlsPeerIdentity);
@@ -297,16 +375,33 @@ public:
   // Check if the certificate authenticates the given hostname, considering wildcards and SAN
   // extensions. If no certificate was provided, always returns false.
 
+  bool isResumed() { return resumed; }
+  // Was the session resumed from an earlier connection, rather than established with a full
+  // handshake? The certificate is then the one presented in that earlier handshake.
+
+  zc::Maybe<zc::StringPtr> getAlpnProtocol() {
+    if (alpnProtocol == nullptr) return zc::none;
+    return alpnProtocol.asPtr();
+  }
+  // The application protocol negotiated via ALPN (see TlsContext::Options::alpnProtocols), if
+  // any.
+
   // TODO(someday): Methods for other things. Match hostnames (i.e. evaluate wildcards and SAN)?
   //   Key fingerprint? Other certificate fields?
 
 private:
   void* cert;  // actually type X509*, but we don't want to #include the OpenSSL headers here.
   zc::Own<zc::PeerIdentity> inner;
+  bool resumed;
+  zc::String alpnProtocol;
 
 public:  // (not really public, only TlsConnection can call this)
-  TlsPeerIdentity(void* cert, zc::Own<zc::PeerIdentity> inner, zc::Badge<TlsConnection>)
-      : cert(cert), inner(zc::mv(inner)) {}
+  TlsPeerIdentity(void* cert, zc::Own<zc::PeerIdentity> inner, bool resumed,
+                  zc::String alpnProtocol, zc::Badge<TlsConnection>)
+      : cert(cert),
+        inner(zc::mv(inner)),
+        resumed(resumed),
+        alpnProtocol(zc::mv(alpnProtocol)) {}
 };
 
 }  // namespace zc
@@ -28,6 +28,8 @@
 
 #include <sys/types.h>
 
+#include <atomic>
+
 #include "zc/async/async-io-internal.h"
 #include "zc/async/async-io.h"
 #include "zc/core/cidr.h"
@@ -51,6 +53,8 @@
 #include <netinet/in.h>
 #include <sys/socket.h>
 #include <unistd.h>
+
+#include "zc/async/async-unix.h"
 #endif
 
 namespace zc {
@@ -447,6 +451,30 @@ TEST(AsyncIo, AddressParsing) {
   // connect to "localhost" in a different test, though.
 }
 
+#if !_WIN32
+ZC_TEST("Network shares DNS lookups") {
+  // Overlapping lookups of a name share one, and later ones reuse its result, including from a
+  // restricted network. Whatever "localhost" resolves to, the answers must all agree.
+  auto ioContext = setupAsyncIo();
+  auto& w = ioContext.waitScope;
+  auto& network = ioContext.provider->getNetwork();
+  auto restricted = network.restrictPeers({"local"});
+
+  Vector<Promise<Own<NetworkAddress>>> promises;
+  for (uint i = 0; i < 100; i++) { promises.add(network.parseAddress("localhost", i % 2)); }
+  promises.add(restricted->parseAddress("localhost", 1));
+  auto addresses = joinPromises(promises.releaseAsArray()).wait(w);
+
+  auto expected0 = addresses[0]->toString();
+  auto expected1 = addresses[1]->toString();
+  for (uint i = 0; i < 100; i++) {
+    ZC_EXPECT(addresses[i]->toString() == (i % 2 == 0 ? expected0 : expected1), i);
+  }
+  ZC_EXPECT(addresses[100]->toString() == expected1);
+  ZC_EXPECT(network.parseAddress("localhost", 1).wait(w)->toString() == expected1);
+}
+#endif
+
 TEST(AsyncIo, OneWayPipe) {
   auto ioContext = setupAsyncIo();
 
@@ -1165,6 +1193,49 @@ TEST(AsyncIo, Udp) {
   }
 }
 
+ZC_TEST("DatagramPort batches") {
+  bool msgTruncBroken = isMsgTruncBroken();
+
+  auto ioContext = setupAsyncIo();
+  auto& w = ioContext.waitScope;
+  auto& network = ioContext.provider->getNetwork();
+
+  auto addr = network.parseAddress("127.0.0.1").wait(w);
+  auto port1 = addr->bindDatagramPort();
+  auto port2 = addr->bindDatagramPort();
+  auto addr1 = network.parseAddress("127.0.0.1", port1->getPort()).wait(w);
+  auto addr2 = network.parseAddress("127.0.0.1", port2->getPort()).wait(w);
+
+  Vector<String> contents;
+  for (uint i = 0; i < 100; i++) { contents.add(str("message ", i)); }
+  contents.add(str("a message too long for the receiver"));
+  Vector<DatagramPort::OutgoingDatagram> datagrams;
+  for (auto& content : contents) { datagrams.add(content.asBytes(), *addr2); }
+  port1->sendBatch(datagrams).wait(w);
+
+  DatagramReceiver::Capacity capacity;
+  capacity.content = 16;
+  auto receiver = port2->makeBatchReceiver(16, capacity);
+
+  size_t count = 0;
+  while (count < contents.size()) {
+    receiver->receive().wait(w);
+    ZC_ASSERT(receiver->size() > 0);
+#if __linux__
+    // Everything was sent already, so every batch but the last is full.
+    ZC_EXPECT(receiver->size() == zc::min(16, contents.size() - count));
+#endif
+    for (size_t i : zc::zeroTo(receiver->size())) {
+      auto& sent = contents[count++];
+      auto content = receiver->getContent(i);
+      ZC_EXPECT(content.value.asChars() == sent.first(zc::min(16, sent.size())));
+      ZC_EXPECT(content.isTruncated == (sent.size() > 16) || msgTruncBroken);
+      ZC_EXPECT(receiver->getAncillary(i).value.size() == 0);
+      ZC_EXPECT(receiver->getSource(i).toString() == addr1->toString());
+    }
+  }
+}
+
 #endif  // !_WIN32
 
 #ifdef __linux__  // Abstract unix sockets are only supported on Linux
@@ -1189,6 +1260,207 @@ TEST(AsyncIo, AbstractUnixSocket) {
 
 #endif  // __linux__
 
+#if !_WIN32
+
+ZC_TEST("write combining buffers small writes until the end of the turn") {
+  auto ioContext = setupAsyncIo();
+  ioContext.unixEventPort.enableWriteCombining(64);
+  auto& ws = ioContext.waitScope;
+
+  int fds[2]{};
+  ZC_SYSCALL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  auto stream =
+      ioContext.lowLevelProvider->wrapSocketFd(fds[0], LowLevelAsyncIoProvider::TAKE_OWNERSHIP);
+  OwnFd peer(fds[1]);
+
+  // Small writes complete without reaching the socket.
+  auto foo = stream->write("foo"_zcb);
+  auto bar = stream->write("bar"_zcb);
+  char buffer[256]{};
+  ZC_EXPECT(recv(peer, buffer, sizeof(buffer), MSG_DONTWAIT) < 0);
+  ZC_EXPECT(errno == EAGAIN || errno == EWOULDBLOCK);
+
+  // They go out together at the end of the turn.
+  foo.wait(ws);
+  bar.wait(ws);
+  ws.poll();
+  ZC_EXPECT(recv(peer, buffer, sizeof(buffer), MSG_DONTWAIT) == 6);
+  ZC_EXPECT(heapString(buffer, 6) == "foobar");
+
+  // A write too big to buffer goes out after what's buffered, and shutdownWrite() waits for both.
+  auto big = heapArray<byte>(100);
+  memset(big.begin(), 'x', big.size());
+  stream->write("baz"_zcb).wait(ws);
+  stream->write(big).wait(ws);
+  stream->write("qux"_zcb).wait(ws);
+  stream->shutdownWrite();
+  ws.poll();
+  ZC_EXPECT(FdInputStream(zc::mv(peer)).readAllText() ==
+            str("baz", big.asChars(), "qux"));
+}
+
+ZC_TEST("write combining writes what's buffered when the stream is destroyed") {
+  auto ioContext = setupAsyncIo();
+  ioContext.unixEventPort.enableWriteCombining();
+
+  int fds[2]{};
+  ZC_SYSCALL(socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+  auto stream =
+      ioContext.lowLevelProvider->wrapSocketFd(fds[0], LowLevelAsyncIoProvider::TAKE_OWNERSHIP);
+  OwnFd peer(fds[1]);
+
+  stream->write("foo"_zcb).wait(ioContext.waitScope);
+  stream = nullptr;
+  ZC_EXPECT(FdInputStream(zc::mv(peer)).readAllText() == "foo");
+}
+
+#endif  // !_WIN32
+
+#if ZC_USE_EPOLL
+
+ZC_TEST("TCP streams through io_uring") {
+  auto ioContext = setupAsyncIo();
+  if (!ioContext.unixEventPort.enableIoUring(8, 1024)) {
+    ZC_LOG(WARNING, "io_uring unavailable; skipping test");
+    return;
+  }
+  auto& ws = ioContext.waitScope;
+  auto& network = ioContext.provider->getNetwork();
+
+  auto listener = network.parseAddress("127.0.0.1").wait(ws)->listen();
+  auto address = network.parseAddress("127.0.0.1", listener->getPort()).wait(ws);
+
+  // Several connections arriving before anyone accepts are all picked up by one multishot accept.
+  auto client1 = address->connect().wait(ws);
+  auto client2 = address->connect().wait(ws);
+  auto server1 = listener->accept().wait(ws);
+  auto server2 = listener->accept().wait(ws);
+
+  client1->write("foo"_zcb).wait(ws);
+  client2->write("bar"_zcb).wait(ws);
+  char buffer[16]{};
+  ZC_EXPECT(server1->tryRead(buffer, 3, sizeof(buffer)).wait(ws) == 3);
+  ZC_EXPECT(heapString(buffer, 3) == "foo");
+  ZC_EXPECT(server2->tryRead(buffer, 3, sizeof(buffer)).wait(ws) == 3);
+  ZC_EXPECT(heapString(buffer, 3) == "bar");
+
+  // Much more than fits in the ring's buffers, or in the socket's; writes have to be continued,
+  // and reads fall back to reading directly when the ring runs out of buffers.
+  auto data = heapArray<byte>(1 << 22);
+  for (auto i : zc::indices(data)) data[i] = i * 7;
+  ArrayPtr<const byte> pieces[] = {data.first(1000), data.slice(1000, data.size())};
+  auto writePromise = server1->write(pieces)
+                          .then([&]() { server1->shutdownWrite(); })
+                          .eagerlyEvaluate(nullptr);
+  auto received = client1->readAllBytes().wait(ws);
+  writePromise.wait(ws);
+  ZC_EXPECT(received == data);
+
+  // EOF.
+  client2 = nullptr;
+  ZC_EXPECT(server2->tryRead(buffer, 1, sizeof(buffer)).wait(ws) == 0);
+}
+
+ZC_TEST("io_uring streams survive cancelled reads and writes") {
+  auto ioContext = setupAsyncIo();
+  if (!ioContext.unixEventPort.enableIoUring()) {
+    ZC_LOG(WARNING, "io_uring unavailable; skipping test");
+    return;
+  }
+  auto& ws = ioContext.waitScope;
+  auto& network = ioContext.provider->getNetwork();
+
+  auto listener = network.parseAddress("127.0.0.1").wait(ws)->listen();
+  auto connectPromise =
+      network.parseAddress("127.0.0.1", listener->getPort()).wait(ws)->connect();
+  auto server = listener->accept().wait(ws);
+  auto client = connectPromise.wait(ws);
+
+  char buffer[16]{};
+  {
+    // Cancel a read while its recv is in flight. The recv stays armed, and what it receives is
+    // kept for the next read.
+    auto readPromise = server->tryRead(buffer, 1, sizeof(buffer));
+    ZC_EXPECT(!readPromise.poll(ws));
+  }
+  client->write("hello"_zcb).wait(ws);
+
+  ZC_EXPECT(server->tryRead(buffer, 5, sizeof(buffer)).wait(ws) == 5);
+  ZC_EXPECT(heapString(buffer, 5) == "hello");
+
+  // A write can be cancelled while the kernel is still sending it.
+  auto data = heapArray<byte>(1 << 24);
+  memset(data.begin(), 'x', data.size());
+  {
+    auto writePromise = client->write(data);
+    ZC_EXPECT(!writePromise.poll(ws));
+  }
+
+  // Streams can go away while they have operations in flight.
+  auto readPromise = client->tryRead(buffer, 1, sizeof(buffer));
+  ws.poll();
+  client = nullptr;
+  server = nullptr;
+  listener = nullptr;
+}
+
+#endif  // ZC_USE_EPOLL
+
+#if !_WIN32
+
+Promise<void> acceptAndGreet(ConnectionReceiver& listener, std::atomic<uint>& count) {
+  return listener.accept().then([&](Own<AsyncIoStream> stream) {
+    ++count;
+    auto promise = stream->write("hi"_zcb).attach(zc::mv(stream));
+    return promise.then([&]() { return acceptAndGreet(listener, count); });
+  });
+}
+
+ZC_TEST("EventLoopGroup serves connections") {
+  constexpr uint THREADS = 3;
+  std::atomic<uint> accepted[THREADS] = {};
+  std::atomic<uint> nextThread = 0;
+
+  EventLoopGroup group(
+      "127.0.0.1", 0,
+      [&](AsyncIoContext&, ConnectionReceiver& listener) {
+        return acceptAndGreet(listener, accepted[nextThread++]);
+      },
+      {.threadCount = THREADS, .pinThreads = true});
+  ZC_EXPECT(group.getThreadCount() == THREADS);
+  ZC_EXPECT(group.getPort() != 0);
+
+  auto io = setupAsyncIo();
+  auto address =
+      io.provider->getNetwork().parseAddress("127.0.0.1", group.getPort()).wait(io.waitScope);
+
+  constexpr uint CONNECTIONS = 64;
+  for (uint i = 0; i < CONNECTIONS; i++) {
+    auto stream = address->connect().wait(io.waitScope);
+    ZC_EXPECT(stream->readAllText().wait(io.waitScope) == "hi");
+  }
+
+  uint total = 0;
+  for (auto& count : accepted) total += count;
+  ZC_EXPECT(total == CONNECTIONS);
+}
+
+ZC_TEST("EventLoopGroup throws if a thread can't listen") {
+  auto io = setupAsyncIo();
+  auto listener =
+      io.provider->getNetwork().parseAddress("127.0.0.1").wait(io.waitScope)->listen();
+
+  // The port is taken by a receiver that doesn't share it.
+  ZC_EXPECT_THROW_MESSAGE("bind", EventLoopGroup(
+                                      "127.0.0.1", listener->getPort(),
+                                      [](AsyncIoContext&, ConnectionReceiver&) -> Promise<void> {
+                                        return NEVER_DONE;
+                                      },
+                                      {.threadCount = 2}));
+}
+
+#endif  // !_WIN32
+
 ZC_TEST("CIDR parsing") {
   ZC_EXPECT(CidrRange("1.2.3.4/16").toString() == "1.2.0.0/16");
   ZC_EXPECT(CidrRange("1.2.255.4/18").toString() == "1.2.192.0/18");
@@ -1242,6 +1514,94 @@ ZC_TEST("CIDR parsing") {
   }
 }
 
+ZC_TEST("CidrSet") {
+  union {
+    struct sockaddr addr;
+    struct sockaddr_in addr4;
+    struct sockaddr_in6 addr6;
+  };
+  memset(&addr6, 0, sizeof(addr6));
+
+  CidrSet set;
+  ZC_EXPECT(!set.matchesFamily(AF_INET) && !set.matchesFamily(AF_INET6));
+  set.add(CidrRange("1.2.0.0/16"));
+  set.add(CidrRange("1.2.192.0/18"));
+  set.add(CidrRange("0102:0300::/24"));
+  ZC_EXPECT(set.size() == 3);
+  ZC_EXPECT(set.matchesFamily(AF_INET) && set.matchesFamily(AF_INET6));
+
+  addr4.sin_family = AF_INET;
+  addr4.sin_addr.s_addr = htonl(0x0102dfff);
+  ZC_EXPECT(set.findLongestMatch(&addr) == uint(18));
+  addr4.sin_addr.s_addr = htonl(0x01020304);
+  ZC_EXPECT(set.findLongestMatch(&addr) == uint(16));
+  addr4.sin_addr.s_addr = htonl(0x01030304);
+  ZC_EXPECT(set.findLongestMatch(&addr) == zc::none);
+
+  // v4-mapped addresses match the IPv4 ranges.
+  addr6.sin6_family = AF_INET6;
+  inet_pton(AF_INET6, "::ffff:1.2.223.255", &addr6.sin6_addr);
+  ZC_EXPECT(set.findLongestMatch(&addr) == uint(18));
+  inet_pton(AF_INET6, "102:3ff::1", &addr6.sin6_addr);
+  ZC_EXPECT(set.findLongestMatch(&addr) == uint(24));
+  inet_pton(AF_INET6, "::1.2.223.255", &addr6.sin6_addr);
+  ZC_EXPECT(set.findLongestMatch(&addr) == zc::none);
+
+  set.add(CidrRange("::/0"));
+  ZC_EXPECT(set.findLongestMatch(&addr) == uint(0));
+
+  // Against CidrRange::matches() on random ranges, clustered so that they overlap.
+  uint64_t state = 12345;
+  auto random = [&]() {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    return uint(state >> 33);
+  };
+  auto randomBits = [&](byte* bits, size_t size) {
+    for (size_t i = 0; i < size; i++) { bits[i] = i < 2 ? random() % 4 : random(); }
+  };
+
+  Vector<CidrRange> ranges;
+  for (uint i = 0; i < 500; i++) {
+    byte bits[16];
+    randomBits(bits, sizeof(bits));
+    ranges.add(CidrRange::inet4(arrayPtr(bits, 4), random() % 33));
+    uint16_t words[8];
+    for (uint j = 0; j < 8; j++) { words[j] = bits[j * 2] << 8 | bits[j * 2 + 1]; }
+    ranges.add(CidrRange::inet6(words, {}, random() % 129));
+  }
+  CidrSet randomSet(ranges.asPtr());
+
+  for (uint i = 0; i < 3000; i++) {
+    memset(&addr6, 0, sizeof(addr6));
+    byte bits[16];
+    randomBits(bits, sizeof(bits));
+    switch (i % 3) {
+      case 0:
+        addr4.sin_family = AF_INET;
+        memcpy(&addr4.sin_addr.s_addr, bits, 4);
+        break;
+      case 1:
+        addr6.sin6_family = AF_INET6;
+        memcpy(addr6.sin6_addr.s6_addr, bits, 16);
+        break;
+      case 2:
+        addr6.sin6_family = AF_INET6;
+        addr6.sin6_addr.s6_addr[10] = 0xff;
+        addr6.sin6_addr.s6_addr[11] = 0xff;
+        memcpy(addr6.sin6_addr.s6_addr + 12, bits, 4);
+        break;
+    }
+
+    Maybe<uint> expected;
+    for (auto& range : ranges) {
+      if (range.matches(&addr)) {
+        expected = zc::max(range.getSpecificity(), expected.orDefault(0));
+      }
+    }
+    ZC_EXPECT(randomSet.findLongestMatch(&addr) == expected, i);
+  }
+}
+
 bool allowed4(_::NetworkFilter& filter, StringPtr addrStr) {
   struct sockaddr_in addr;
   memset(&addr, 0, sizeof(addr));
@@ -1409,6 +1769,34 @@ ZC_TEST("Network::restrictPeers()") {
   ZC_EXPECT(conn->readAllText().wait(w) == "");
 }
 
+#if !_WIN32
+ZC_TEST("Network::withConnectionAttemptDelay()") {
+  auto ioContext = setupAsyncIo();
+  auto& w = ioContext.waitScope;
+  auto& network = ioContext.provider->getNetwork();
+  auto delayedNetwork = network.withConnectionAttemptDelay(10 * MILLISECONDS);
+
+  auto listener = network.parseAddress("127.0.0.1").wait(w)->listen();
+  auto acceptTask = listener->accept()
+                        .then([](Own<AsyncIoStream> stream) {
+                          return stream->write("foo"_zcb).attach(zc::mv(stream));
+                        })
+                        .eagerlyEvaluate(nullptr);
+
+  // Whether "localhost" resolves to 127.0.0.1 alone or to ::1 too, one of the attempts reaches the
+  // listener.
+  auto addr = delayedNetwork->parseAddress("localhost", listener->getPort()).wait(w);
+  auto conn = addr->connect().wait(w);
+  ZC_EXPECT(conn->readAllText().wait(w) == "foo");
+  acceptTask.wait(w);
+
+  // The delay carries over to restricted networks, and the race fails once every attempt has.
+  auto restricted = delayedNetwork->restrictPeers({"public"});
+  auto restrictedAddr = restricted->parseAddress("localhost", listener->getPort()).wait(w);
+  ZC_EXPECT_THROW_MESSAGE("restrictPeers", restrictedAddr->connect().wait(w));
+}
+#endif
+
 zc::Promise<void> expectRead(zc::AsyncInputStream& in, zc::StringPtr expected) {
   if (expected.size() == 0) return zc::READY_NOW;
 
@@ -1429,8 +1817,13 @@ zc::Promise<void> expectRead(zc::AsyncInputStream& in, zc::StringPtr expected) {
 
 class MockAsyncInputStream final : public AsyncInputStream {
 public:
-  MockAsyncInputStream(zc::ArrayPtr<const byte> bytes, size_t blockSize)
-      : bytes(bytes), blockSize(blockSize) {}
+  MockAsyncInputStream(zc::ArrayPtr<const byte> bytes, size_t blockSize, bool knownLength = false)
+      : bytes(bytes), blockSize(blockSize), knownLength(knownLength) {}
+
+  zc::Maybe<uint64_t> tryGetLength() override {
+    if (knownLength) { return bytes.size(); }
+    return zc::none;
+  }
 
   zc::Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
     // Clamp max read to blockSize.
@@ -1450,6 +1843,7 @@ public:
 private:
   zc::ArrayPtr<const byte> bytes;
   size_t blockSize;
+  bool knownLength;
 };
 
 ZC_TEST("AsyncInputStream::readAllText() / readAllBytes()") {
@@ -1471,28 +1865,84 @@ ZC_TEST("AsyncInputStream::readAllText() / readAllBytes()") {
   for (size_t inputSize : inputSizes) {
     for (size_t blockSize : blockSizes) {
       for (uint64_t limit : limits) {
-        ZC_CONTEXT(inputSize, blockSize, limit);
-        auto textSlice = bigText.asBytes().first(inputSize);
-        auto readAllText = [&]() {
-          MockAsyncInputStream input(textSlice, blockSize);
-          return input.readAllText(limit).wait(ws);
-        };
-        auto readAllBytes = [&]() {
-          MockAsyncInputStream input(textSlice, blockSize);
-          return input.readAllBytes(limit).wait(ws);
-        };
-        if (limit > inputSize) {
-          ZC_EXPECT(readAllText().asBytes() == textSlice);
-          ZC_EXPECT(readAllBytes() == textSlice);
-        } else {
-          ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.", readAllText());
-          ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.", readAllBytes());
+        for (bool knownLength : {false, true}) {
+          ZC_CONTEXT(inputSize, blockSize, limit, knownLength);
+          auto textSlice = bigText.asBytes().first(inputSize);
+          auto readAllText = [&]() {
+            MockAsyncInputStream input(textSlice, blockSize, knownLength);
+            return input.readAllText(limit).wait(ws);
+          };
+          auto readAllBytes = [&]() {
+            MockAsyncInputStream input(textSlice, blockSize, knownLength);
+            return input.readAllBytes(limit).wait(ws);
+          };
+          auto readAllChunks = [&]() {
+            MockAsyncInputStream input(textSlice, blockSize, knownLength);
+            auto chunks = input.readAllChunks(limit).wait(ws);
+            zc::Vector<byte> joined;
+            for (auto& chunk : chunks) {
+              ZC_EXPECT(chunk.size() > 0);
+              joined.addAll(chunk);
+            }
+            return joined.releaseAsArray();
+          };
+          if (limit > inputSize) {
+            ZC_EXPECT(readAllText().asBytes() == textSlice);
+            ZC_EXPECT(readAllBytes() == textSlice);
+            ZC_EXPECT(readAllChunks() == textSlice);
+          } else {
+            ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.", readAllText());
+            ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.", readAllBytes());
+            ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.", readAllChunks());
+          }
         }
       }
     }
   }
 }
 
+ZC_TEST("AsyncInputStream::readAllChunks() / readAllInto()") {
+  zc::EventLoop loop;
+  WaitScope ws(loop);
+
+  auto text = strArray(zc::repeat("foo bar baz"_zc, 1000), ",");
+
+  // A body of known length comes back in one chunk.
+  {
+    MockAsyncInputStream input(text.asBytes(), 256, true);
+    auto chunks = input.readAllChunks().wait(ws);
+    ZC_ASSERT(chunks.size() == 1);
+    ZC_EXPECT(chunks[0] == text.asBytes());
+  }
+
+  // One of unknown length comes back in chunks that grow.
+  {
+    MockAsyncInputStream input(text.asBytes(), 256);
+    auto chunks = input.readAllChunks().wait(ws);
+    ZC_ASSERT(chunks.size() == 2);
+    ZC_EXPECT(chunks[0].size() == 4096);
+    ZC_EXPECT(chunks[1].size() == text.size() - 4096);
+  }
+
+  // The buffer may be exactly full, but not overflow.
+  auto buffer = zc::heapArray<byte>(text.size());
+  {
+    MockAsyncInputStream input(text.asBytes(), 256);
+    ZC_EXPECT(input.readAllInto(buffer).wait(ws) == text.size());
+    ZC_EXPECT(buffer == text.asBytes());
+  }
+  {
+    MockAsyncInputStream input(text.asBytes().first(100), 256);
+    ZC_EXPECT(input.readAllInto(buffer).wait(ws) == 100);
+    ZC_EXPECT(buffer.first(100) == text.asBytes().first(100));
+  }
+  {
+    MockAsyncInputStream input(text.asBytes(), 256);
+    ZC_EXPECT_THROW_MESSAGE("Reached limit before EOF.",
+                            input.readAllInto(buffer.first(text.size() - 1)).wait(ws));
+  }
+}
+
 ZC_TEST("Userland pipe") {
   zc::EventLoop loop;
   WaitScope ws(loop);
@@ -2264,6 +2714,69 @@ ZC_TEST("Userland pipe BlockedRead gets empty tryPumpFrom") {
   ZC_EXPECT(zc::StringPtr(buffer, 3) == "foo");
 }
 
+ZC_TEST("Userland buffered pipe watermarks") {
+  zc::EventLoop loop;
+  WaitScope ws(loop);
+
+  auto pipe = newBufferedOneWayPipe({.highWatermark = 8, .lowWatermark = 4});
+
+  // Writes complete without a reader until the buffer passes the high watermark.
+  pipe.out->write("foo"_zcb).wait(ws);
+  pipe.out->write("bar"_zcb).wait(ws);
+  ZC_EXPECT(pipe.out->getQueuedBytes() == 6);
+  ZC_EXPECT(!pipe.out->whenWritable().poll(ws));
+
+  auto blocked = pipe.out->write("baz"_zcb);
+  ZC_EXPECT(!blocked.poll(ws));
+  ZC_EXPECT(pipe.out->getQueuedBytes() == 9);
+
+  // Draining to the low watermark unblocks it.
+  char buffer[16]{};
+  ZC_EXPECT(pipe.in->tryRead(buffer, 4, 4).wait(ws) == 4);
+  ZC_EXPECT(!blocked.poll(ws));
+  ZC_EXPECT(pipe.in->tryRead(buffer + 4, 1, 1).wait(ws) == 1);
+  blocked.wait(ws);
+  pipe.out->whenWritable().wait(ws);
+
+  // A read for more than is buffered waits for it, and lets the writer go on meanwhile.
+  auto read = pipe.in->tryRead(buffer + 5, 6, 16);
+  ZC_EXPECT(!read.poll(ws));
+  pipe.out->write("qux"_zcb).wait(ws);
+  ZC_EXPECT(read.wait(ws) == 7);
+  ZC_EXPECT(zc::StringPtr(buffer, 12) == "foobarbazqux");
+
+  // EOF completes a read short.
+  pipe.out->write("!"_zcb).wait(ws);
+  auto last = pipe.in->tryRead(buffer, 4, 4);
+  ZC_EXPECT(!last.poll(ws));
+  pipe.out = nullptr;
+  ZC_EXPECT(last.wait(ws) == 1);
+  ZC_EXPECT(buffer[0] == '!');
+}
+
+ZC_TEST("Userland buffered pipe read end going away") {
+  zc::EventLoop loop;
+  WaitScope ws(loop);
+
+  auto pipe = newBufferedTwoWayPipe({.highWatermark = 4, .lowWatermark = 0});
+  auto disconnected = pipe.ends[0]->whenWriteDisconnected();
+  auto blocked = pipe.ends[0]->write("foobar"_zcb);
+  auto writable = pipe.ends[0]->whenWritable();
+  ZC_EXPECT(pipe.ends[0]->getQueuedBytes() == 6);
+  ZC_EXPECT(!disconnected.poll(ws));
+
+  // Data still flows the other way.
+  pipe.ends[1]->write("baz"_zcb).wait(ws);
+  expectRead(*pipe.ends[0], "baz").wait(ws);
+
+  pipe.ends[1] = nullptr;
+  disconnected.wait(ws);
+  ZC_EXPECT_THROW_RECOVERABLE_MESSAGE("abortRead", blocked.wait(ws));
+  ZC_EXPECT_THROW_RECOVERABLE_MESSAGE("abortRead", writable.wait(ws));
+  ZC_EXPECT_THROW_RECOVERABLE_MESSAGE("abortRead", pipe.ends[0]->write("qux"_zcb).wait(ws));
+  ZC_EXPECT(pipe.ends[0]->getQueuedBytes() == 0);
+}
+
 constexpr static auto TEE_MAX_CHUNK_SIZE = 1 << 14;
 // AsyncTee::MAX_CHUNK_SIZE, 16k as of this writing
 
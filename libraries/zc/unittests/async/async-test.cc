@@ -21,10 +21,12 @@
 
 #include "zc/async/async.h"
 
+#include "zc/async/timer.h"
 #include "zc/core/array.h"
 #include "zc/core/debug.h"
 #include "zc/core/mutex.h"
 #include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/gtest.h"
 #include "zc/ztest/test.h"
 
@@ -1975,5 +1977,168 @@ ZC_TEST("EventLoopLocal") {
   ZC_EXPECT(!rc2->isShared());
 }
 
+
+ZC_TEST("TimerImpl fires timers in time order, then in the order they were set") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  TimerImpl timer(origin<TimePoint>());
+
+  // Enough timers, in a scrambled order with plenty of ties, to exercise every level of the heap.
+  constexpr uint COUNT = 1000;
+  Vector<uint> fired;
+  Vector<Maybe<Promise<void>>> promises;
+  for (uint i = 0; i < COUNT; i++) {
+    auto time = origin<TimePoint>() + (i * 7919 % 101) * MILLISECONDS;
+    promises.add(timer.atTime(time).then([&fired, i]() { fired.add(i); }).eagerlyEvaluate(nullptr));
+  }
+
+  // Cancel every third one.
+  for (uint i = 0; i < COUNT; i += 3) promises[i] = zc::none;
+
+  ZC_EXPECT(timer.nextEvent() == origin<TimePoint>());
+
+  timer.advanceTo(origin<TimePoint>() + 50 * MILLISECONDS);
+  waitScope.poll();
+  ZC_EXPECT(timer.nextEvent() == origin<TimePoint>() + 51 * MILLISECONDS);
+
+  timer.advanceTo(origin<TimePoint>() + 100 * MILLISECONDS);
+  waitScope.poll();
+  ZC_EXPECT(timer.nextEvent() == zc::none);
+
+  Vector<uint> expected;
+  for (uint ms = 0; ms <= 100; ms++) {
+    for (uint i = 0; i < COUNT; i++) {
+      if (i % 3 != 0 && i * 7919 % 101 == ms) expected.add(i);
+    }
+  }
+  ZC_EXPECT(fired.asPtr() == expected.asPtr());
+}
+
+ZC_TEST("Timer::afterDelayCoarse() rounds deadlines up to a multiple of the slack") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  TimerImpl timer(origin<TimePoint>() + 3 * MILLISECONDS);
+
+  uint fired = 0;
+  auto count = [&]() { ++fired; };
+  auto first = timer.afterDelayCoarse(1 * MILLISECONDS, 5 * MILLISECONDS).then(count);
+  auto second = timer.afterDelayCoarse(2 * MILLISECONDS, 5 * MILLISECONDS).then(count);
+  auto third = timer.afterDelayCoarse(3 * MILLISECONDS, 5 * MILLISECONDS).then(count);
+  auto exact = timer.afterDelayCoarse(1 * MILLISECONDS, 0 * MILLISECONDS).then(count);
+
+  // The first two share a deadline; the third goes into the next window.
+  ZC_EXPECT(timer.nextEvent() == origin<TimePoint>() + 4 * MILLISECONDS);
+  timer.advanceTo(origin<TimePoint>() + 4 * MILLISECONDS);
+  exact.wait(waitScope);
+  ZC_EXPECT(timer.nextEvent() == origin<TimePoint>() + 5 * MILLISECONDS);
+
+  timer.advanceTo(origin<TimePoint>() + 5 * MILLISECONDS);
+  first.wait(waitScope);
+  second.wait(waitScope);
+  ZC_EXPECT(!third.poll(waitScope));
+  ZC_EXPECT(timer.nextEvent() == origin<TimePoint>() + 10 * MILLISECONDS);
+
+  timer.advanceTo(origin<TimePoint>() + 10 * MILLISECONDS);
+  third.wait(waitScope);
+  ZC_EXPECT(fired == 4);
+}
+
+#if ZC_PROMISE_ARENA_POOL
+ZC_TEST("promise arenas are recycled") {
+  auto* arena = _::PromiseArena::allocate();
+  _::PromiseArena::free(arena);
+  auto* again = _::PromiseArena::allocate();
+  ZC_EXPECT(again == arena);
+  _::PromiseArena::free(again);
+
+  // A promise chain started after another is destroyed takes its arena.
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  evalLater([]() { return 1; }).then([](int i) { return i + 1; }).wait(waitScope);
+  ZC_EXPECT(evalLater([]() { return 2; }).wait(waitScope) == 2);
+}
+#endif
+
+ZC_TEST("EventLoopHistogram") {
+  EventLoopHistogram histogram;
+  ZC_EXPECT(histogram.percentile(0.5) == 0);
+
+  for (uint64_t value : {0, 1, 2, 3, 4, 5, 1000}) { histogram.add(value); }
+  ZC_EXPECT(histogram.getCount() == 7);
+  ZC_EXPECT(histogram.getSum() == 1015);
+  ZC_EXPECT(histogram.getMax() == 1000);
+
+  auto buckets = histogram.getBuckets();
+  ZC_EXPECT(buckets[0] == 2);
+  ZC_EXPECT(buckets[1] == 1);
+  ZC_EXPECT(buckets[2] == 2);
+  ZC_EXPECT(buckets[3] == 1);
+  ZC_EXPECT(buckets[10] == 1);
+  ZC_EXPECT(EventLoopHistogram::upperBound(10) == 1024);
+
+  ZC_EXPECT(histogram.percentile(0.5) == 4);
+  ZC_EXPECT(histogram.percentile(0.8) == 8);
+  ZC_EXPECT(histogram.percentile(1) == 1000);
+
+  // Beyond the last bucket's lower bound, it's all one bucket.
+  histogram.add(uint64_t(1) << 50);
+  ZC_EXPECT(buckets[EventLoopHistogram::BUCKET_COUNT - 1] == 1);
+  ZC_EXPECT(histogram.percentile(1) == uint64_t(1) << 50);
+}
+
+ZC_TEST("EventLoop stats") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  loop.enableStats();
+
+  auto spin = [](Duration time) {
+    auto& clock = systemPreciseMonotonicClock();
+    auto end = clock.now() + time;
+    while (clock.now() < end) {}
+  };
+
+  // Some quick events and a slow one, in one turn.
+  auto quick = evalLater([]() {}).then([]() {}).eagerlyEvaluate(nullptr);
+  auto slow = evalLater([&]() { spin(20 * MILLISECONDS); }).eagerlyEvaluate(nullptr);
+  uint slowLine = __LINE__ - 1;
+  quick.wait(waitScope);
+  slow.wait(waitScope);
+
+  auto stats = loop.getStats();
+  ZC_EXPECT(stats.eventNanoseconds.getCount() >= 2);
+  ZC_EXPECT(stats.turnNanoseconds.getCount() >= 1);
+  ZC_EXPECT(stats.turnNanoseconds.getMax() >= 20'000'000);
+  ZC_EXPECT(stats.eventsPerTurn.getMax() >= 2);
+  ZC_EXPECT(stats.longestEvent >= 20 * MILLISECONDS);
+  ZC_EXPECT(stats.longestEvent < stats.turnNanoseconds.getMax() * NANOSECONDS + 1 * NANOSECONDS);
+  ZC_EXPECT(stats.getLongestEventTrace().size() > 0);
+#if ZC_COMPILER_SUPPORTS_SOURCE_LOCATION
+  ZC_EXPECT(stats.longestEventLocation.lineNumber == slowLine, stats.longestEventLocation);
+#endif
+  ZC_EXPECT(zc::str(stats).startsWith("turns "), stats);
+
+  // Everything another thread queued gets picked up at once.
+  loop.resetStats();
+  ZC_EXPECT(loop.getStats().eventNanoseconds.getCount() == 0);
+  auto paf1 = newPromiseAndCrossThreadFulfiller<void>();
+  auto paf2 = newPromiseAndCrossThreadFulfiller<void>();
+  auto paf3 = newPromiseAndCrossThreadFulfiller<void>();
+  {
+    Thread thread([&]() {
+      paf1.fulfiller->fulfill();
+      paf2.fulfiller->fulfill();
+      paf3.fulfiller->fulfill();
+    });
+  }
+  paf1.promise.wait(waitScope);
+  paf2.promise.wait(waitScope);
+  paf3.promise.wait(waitScope);
+
+  stats = loop.getStats();
+  ZC_EXPECT(stats.crossThreadQueueDepth.getCount() == 1);
+  ZC_EXPECT(stats.crossThreadQueueDepth.getMax() == 3);
+  ZC_EXPECT(stats.waitNanoseconds.getCount() >= 1);
+}
+
 }  // namespace
 }  // namespace zc
@@ -27,6 +27,7 @@
 #include "zc/core/debug.h"
 #include "zc/core/mutex.h"
 #include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 
 #if _WIN32
@@ -1144,5 +1145,42 @@ ZC_TEST("cross-thread fulfiller created using Executor, used after Executor dies
   })();
 }
 
+ZC_TEST("bursts of cross-thread events from several threads are all delivered") {
+  // Senders skip waking the target loop while it still has a wake pending; make sure nothing gets
+  // stranded by that.
+  constexpr uint THREADS = 4;
+  constexpr uint EVENTS = 2000;
+
+  ([&]() noexcept {
+    ZC_XTHREAD_TEST_SETUP_LOOP;
+    const Executor& executor = getCurrentThreadExecutor();
+
+    uint count = 0;  // only touched by this thread
+    Vector<Promise<void>> done;
+    Vector<Own<Thread>> threads;
+    for (uint t = 0; t < THREADS; t++) {
+      auto paf = newPromiseAndCrossThreadFulfiller<void>();
+      done.add(zc::mv(paf.promise));
+      threads.add(heap<Thread>([&executor, &count, fulfiller = zc::mv(paf.fulfiller)]() noexcept {
+        ZC_XTHREAD_TEST_SETUP_LOOP;
+
+        Vector<Promise<void>> promises;
+        for (uint i = 0; i < EVENTS; i++) {
+          promises.add(executor.executeAsync([&count]() { ++count; }));
+          if (i % 3 == 0) {
+            // Mix in some synchronous ones too.
+            executor.executeSync([&count]() { ++count; });
+          }
+        }
+        joinPromises(promises.releaseAsArray()).wait(waitScope);
+        fulfiller->fulfill();
+      }));
+    }
+
+    joinPromises(done.releaseAsArray()).wait(waitScope);
+    ZC_EXPECT(count == THREADS * (EVENTS + (EVENTS + 2) / 3));
+  })();
+}
+
 }  // namespace
 }  // namespace zc
@@ -0,0 +1,112 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/async/worker-pool.h"
+
+#include <thread>
+
+#include "zc/core/debug.h"
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+Promise<uint64_t> sumOnPool(const WorkerPool& pool, uint64_t n, std::thread::id& resumedOn) {
+  uint64_t sum = co_await pool.run([n]() {
+    uint64_t result = 0;
+    for (uint64_t i = 1; i <= n; i++) result += i;
+    return result;
+  });
+  resumedOn = std::this_thread::get_id();
+  co_return sum;
+}
+
+ZC_TEST("WorkerPool runs work off the loop and resumes coroutines on it") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  WorkerPool pool(4);
+  ZC_EXPECT(pool.getThreadCount() == 4);
+
+  auto ranOn = pool.run([]() { return std::this_thread::get_id(); }).wait(waitScope);
+  ZC_EXPECT(ranOn != std::this_thread::get_id());
+
+  std::thread::id resumedOn;
+  ZC_EXPECT(sumOnPool(pool, 1000, resumedOn).wait(waitScope) == 500500);
+  ZC_EXPECT(resumedOn == std::this_thread::get_id());
+
+  Vector<Promise<uint>> promises;
+  for (uint i = 0; i < 100; i++) promises.add(pool.run([i]() { return i * i; }));
+  auto results = joinPromises(promises.releaseAsArray()).wait(waitScope);
+  for (uint i = 0; i < 100; i++) ZC_EXPECT(results[i] == i * i);
+
+  uint count = 0;
+  pool.run([&count]() { ++count; }).wait(waitScope);
+  ZC_EXPECT(count == 1);
+}
+
+ZC_TEST("WorkerPool rejects the promise when the work throws") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  WorkerPool pool(2);
+
+  ZC_EXPECT_THROW_MESSAGE("no good", pool.run([]() -> int { ZC_FAIL_REQUIRE("no good"); })
+                                         .wait(waitScope));
+}
+
+ZC_TEST("WorkerPool threads steal work queued behind a long job") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  WorkerPool pool(2);
+
+  // Work is dealt into the two threads' queues in turn, so the third job lands behind the first.
+  // The first job can't finish until the third has run, which only happens if the second thread
+  // steals it.
+  MutexGuarded<bool> thirdDone(false);
+  auto first = pool.run([&]() { thirdDone.lockExclusive().wait([](bool done) { return done; }); });
+  auto second = pool.run([]() {});
+  auto third = pool.run([&]() { *thirdDone.lockExclusive() = true; });
+
+  first.wait(waitScope);
+  second.wait(waitScope);
+  third.wait(waitScope);
+}
+
+ZC_TEST("WorkerPool skips work whose promise was dropped before it started") {
+  EventLoop loop;
+  WaitScope waitScope(loop);
+  WorkerPool pool(1);
+
+  MutexGuarded<bool> released(false);
+  auto blocker = pool.run([&]() { released.lockExclusive().wait([](bool r) { return r; }); });
+
+  bool ran = false;
+  { auto dropped = pool.run([&ran]() { ran = true; }); }
+  *released.lockExclusive() = true;
+
+  blocker.wait(waitScope);
+  pool.run([]() {}).wait(waitScope);
+  ZC_EXPECT(!ran);
+}
+
+}  // namespace
+}  // namespace zc
@@ -24,6 +24,9 @@
 #include <stdint.h>
 
 #include "zc/core/debug.h"
+#include "zc/core/mutex.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/gtest.h"
 
 namespace zc {
@@ -302,5 +305,295 @@ TEST(Arena, Strings) {
   EXPECT_EQ(quux.end() + 1, corge.begin());
 }
 
+TEST(Arena, ChunkBytes) {
+  Arena arena(1024);
+  EXPECT_EQ(0u, arena.getChunkBytes());
+
+  arena.allocateArray<byte>(16);
+  EXPECT_EQ(1024u, arena.getChunkBytes());
+
+  // The next chunk doubles in size.
+  arena.allocateArray<byte>(1000);
+  EXPECT_EQ(1024u + 2048u, arena.getChunkBytes());
+
+  byte scratch[256];
+  Arena scratchArena(arrayPtr(scratch, sizeof(scratch)));
+  scratchArena.allocateArray<byte>(16);
+  EXPECT_EQ(0u, scratchArena.getChunkBytes());
+}
+
+TEST(Arena, UsedBytes) {
+  Arena arena(1024);
+  EXPECT_EQ(0u, arena.getUsedBytes());
+
+  // The chunk header counts as used.
+  arena.allocateArray<byte>(16);
+  size_t header = arena.getUsedBytes() - 16;
+  EXPECT_TRUE(header > 0 && header < 1024);
+
+  arena.allocateArray<byte>(100);
+  EXPECT_EQ(header + 116, arena.getUsedBytes());
+
+  // What is left of the first chunk is too small, and stays unused.
+  arena.allocateArray<byte>(1000);
+  EXPECT_EQ(1024u + 2048u, arena.getChunkBytes());
+  EXPECT_EQ(header + 116 + header + 1000, arena.getUsedBytes());
+
+  arena.reset();
+  EXPECT_EQ(header, arena.getUsedBytes());
+}
+
+TEST(Arena, Reset) {
+  TestObject::throwAt = -1;
+  Arena arena(1024);
+
+  arena.allocate<TestObject>();
+  arena.allocateArray<TestObject>(3);
+  arena.allocateArray<byte>(3000);  // a 4096-byte chunk
+  arena.allocateArray<byte>(2000);  // an 8192-byte one
+  EXPECT_EQ(4, TestObject::count);
+  EXPECT_EQ(1024u + 4096u + 8192u, arena.getChunkBytes());
+
+  arena.reset();
+  EXPECT_EQ(0, TestObject::count);
+  EXPECT_EQ(8192u, arena.getChunkBytes());
+
+  // The kept chunk is allocated from anew, before a new chunk is taken.
+  byte* first = arena.allocateArray<byte>(8000).begin();
+  arena.reset();
+  EXPECT_EQ(first, arena.allocateArray<byte>(8000).begin());
+  EXPECT_EQ(8192u, arena.getChunkBytes());
+
+  arena.allocate<TestObject>();
+  EXPECT_EQ(1, TestObject::count);
+}
+
+TEST(Arena, ResetScratch) {
+  byte scratch[256];
+  Arena arena(arrayPtr(scratch, sizeof(scratch)));
+
+  byte* first = arena.allocateArray<byte>(16).begin();
+  EXPECT_TRUE(first >= scratch && first < scratch + sizeof(scratch));
+  arena.reset();
+  EXPECT_EQ(first, arena.allocateArray<byte>(16).begin());
+  EXPECT_EQ(0u, arena.getChunkBytes());
+}
+
+TEST(Arena, ChunkPool) {
+  ArenaChunkPool pool(16384);
+
+  byte* chunkStart;
+  {
+    Arena arena(pool, 1024);
+    chunkStart = arena.allocateArray<byte>(16).begin();
+    arena.allocateArray<byte>(1500);  // a 2048-byte chunk
+    arena.allocateArray<byte>(3000);  // a 4096-byte one
+    arena.reset();
+    // The two smaller chunks went to the pool.
+    EXPECT_EQ(2u, pool.getFreeChunkCount());
+    EXPECT_EQ(1024u + 2048u, pool.getFreeBytes());
+  }
+  EXPECT_EQ(3u, pool.getFreeChunkCount());
+  EXPECT_EQ(1024u + 2048u + 4096u, pool.getFreeBytes());
+
+  {
+    // A new arena takes the smallest chunk that fits from the pool, rather than the heap.
+    Arena arena(pool, 1024);
+    EXPECT_EQ(chunkStart, arena.allocateArray<byte>(16).begin());
+    EXPECT_EQ(1024u, arena.getChunkBytes());
+    EXPECT_EQ(2u, pool.getFreeChunkCount());
+
+    // Too big for anything in the pool.
+    arena.allocateArray<byte>(10000);
+    EXPECT_EQ(2u, pool.getFreeChunkCount());
+  }
+
+  // The pool keeps at most 16384 bytes, so the 16384-byte chunk was freed.
+  EXPECT_EQ(3u, pool.getFreeChunkCount());
+  EXPECT_EQ(1024u + 2048u + 4096u, pool.getFreeBytes());
+
+  pool.trim();
+  EXPECT_EQ(0u, pool.getFreeChunkCount());
+  EXPECT_EQ(0u, pool.getFreeBytes());
+}
+
+struct DestructionCounter {
+  explicit DestructionCounter(std::atomic<uint>& count) : count(count) {}
+  ~DestructionCounter() { count.fetch_add(1, std::memory_order_relaxed); }
+
+  std::atomic<uint>& count;
+};
+
+TEST(Arena, ThreadLocal) {
+  constexpr uint THREADS = 4;
+  constexpr uint ALLOCATIONS = 1000;
+
+  std::atomic<uint> destroyed{0};
+  MutexGuarded<Vector<ArrayPtr<uint>>> arrays;
+  {
+    ThreadLocalArena arena(64);
+    Arena* mainArena = &arena.getArena();
+    EXPECT_EQ(mainArena, &arena.getArena());
+
+    {
+      Vector<Own<Thread>> threads;
+      for (uint t = 0; t < THREADS; t++) {
+        threads.add(heap<Thread>([&, t]() {
+          Arena& own = arena.getArena();
+          ZC_ASSERT(&own != mainArena);
+          for (uint i = 0; i < ALLOCATIONS; i++) {
+            arena.allocate<DestructionCounter>(destroyed);
+            auto array = arena.allocateArray<uint>(3);
+            for (auto& value : array) { value = t * ALLOCATIONS + i; }
+            arrays.lockExclusive()->add(array);
+          }
+          ZC_ASSERT(&arena.getArena() == &own);
+        }));
+      }
+    }
+
+    // The threads are gone, but what they allocated is not.
+    EXPECT_EQ(THREADS + 1, arena.getArenaCount());
+    EXPECT_EQ(0u, destroyed.load());
+    auto locked = arrays.lockExclusive();
+    EXPECT_EQ(THREADS * ALLOCATIONS, locked->size());
+    for (auto array : *locked) {
+      EXPECT_EQ(array[0], array[1]);
+      EXPECT_EQ(array[0], array[2]);
+    }
+
+    // Alternating between two ThreadLocalArenas still finds the right arena.
+    ThreadLocalArena other;
+    Arena* otherArena = &other.getArena();
+    EXPECT_NE(otherArena, mainArena);
+    EXPECT_EQ(mainArena, &arena.getArena());
+    EXPECT_EQ(otherArena, &other.getArena());
+    EXPECT_EQ("foo", arena.copyString("foo"));
+  }
+  EXPECT_EQ(THREADS * ALLOCATIONS, destroyed.load());
+}
+
+TEST(Arena, Concurrent) {
+  constexpr uint THREADS = 4;
+  constexpr uint ALLOCATIONS = 10000;
+
+  std::atomic<uint> destroyed{0};
+  MutexGuarded<Vector<ArrayPtr<uint64_t>>> arrays;
+  {
+    ConcurrentArena arena(64);
+    {
+      Vector<Own<Thread>> threads;
+      for (uint t = 0; t < THREADS; t++) {
+        threads.add(heap<Thread>([&, t]() {
+          Vector<ArrayPtr<uint64_t>> mine;
+          for (uint i = 0; i < ALLOCATIONS; i++) {
+            // Vary sizes and alignments, so that allocations straddle chunk ends.
+            auto array = arena.allocateArray<uint64_t>(i % 7 + 1);
+            for (auto& value : array) { value = uint64_t(t) << 32 | i; }
+            mine.add(array);
+            if (i % 16 == 0) { arena.allocate<DestructionCounter>(destroyed); }
+            arena.copyString("x");
+          }
+          auto locked = arrays.lockExclusive();
+          for (auto array : mine) { locked->add(array); }
+        }));
+      }
+    }
+
+    // No two allocations overlapped: every array still holds what its thread wrote.
+    auto locked = arrays.lockExclusive();
+    EXPECT_EQ(THREADS * ALLOCATIONS, locked->size());
+    for (auto array : *locked) {
+      EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(array.begin()) % alignof(uint64_t));
+      for (auto value : array) { EXPECT_EQ(array[0], value); }
+    }
+    EXPECT_GT(arena.getChunkBytes(), THREADS * ALLOCATIONS * 4 * sizeof(uint64_t));
+    EXPECT_EQ(0u, destroyed.load());
+  }
+  EXPECT_EQ(THREADS * ALLOCATIONS / 16, destroyed.load());
+}
+
+TEST(Arena, ConcurrentTooBig) {
+  ConcurrentArena arena(1024);
+
+  byte& b1 = arena.allocate<byte>();
+  ArrayPtr<byte> big = arena.allocateArray<byte>(4096);
+  byte& b2 = arena.allocate<byte>();
+
+  // The big allocation gets a chunk of its own, which becomes the current chunk.
+  EXPECT_NE(&b1 + 1, big.begin());
+  EXPECT_EQ(big.end(), &b2);
+  EXPECT_GE(arena.getChunkBytes(), 1024u + 4096u);
+}
+
+void arenaBenchmark(uint threadCount, Function<void*()> allocate) {
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ALLOCATIONS = 10000;
+#else
+  constexpr uint ALLOCATIONS = 1000000;
+#endif
+
+  Vector<Own<Thread>> threads;
+  for (uint t = 0; t < threadCount; t++) {
+    threads.add(heap<Thread>([&]() {
+      for (uint i = 0; i < ALLOCATIONS; i++) { *reinterpret_cast<uint*>(allocate()) = i; }
+    }));
+  }
+}
+
+void perRequestBenchmark(Function<void()> request) {
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint REQUESTS = 10;
+#else
+  constexpr uint REQUESTS = 1000;
+#endif
+  for (uint i = 0; i < REQUESTS; i++) { request(); }
+}
+
+constexpr size_t REQUEST_CHUNK_SIZE = 64 * 1024;
+
+void handleRequest(Arena& arena) {
+  // About 800 KiB, over a few chunks.
+  for (uint i = 0; i < 4000; i++) { memset(arena.allocateArray<byte>(200).begin(), i, 200); }
+}
+
+ZC_TEST("benchmark: a new Arena per request") {
+  perRequestBenchmark([]() {
+    Arena arena(REQUEST_CHUNK_SIZE);
+    handleRequest(arena);
+  });
+}
+
+ZC_TEST("benchmark: a new Arena per request, from a chunk pool") {
+  ArenaChunkPool pool;
+  perRequestBenchmark([&]() {
+    Arena arena(pool, REQUEST_CHUNK_SIZE);
+    handleRequest(arena);
+  });
+}
+
+ZC_TEST("benchmark: one Arena reset after each request") {
+  Arena arena(REQUEST_CHUNK_SIZE);
+  perRequestBenchmark([&]() {
+    handleRequest(arena);
+    arena.reset();
+  });
+}
+
+ZC_TEST("benchmark: MutexGuarded<Arena> allocating from 4 threads") {
+  MutexGuarded<Arena> arena;
+  arenaBenchmark(4, [&]() -> void* { return &arena.lockExclusive()->allocate<uint>(); });
+}
+
+ZC_TEST("benchmark: ThreadLocalArena allocating from 4 threads") {
+  ThreadLocalArena arena;
+  arenaBenchmark(4, [&]() -> void* { return &arena.allocate<uint>(); });
+}
+
+ZC_TEST("benchmark: ConcurrentArena allocating from 4 threads") {
+  ConcurrentArena arena;
+  arenaBenchmark(4, [&]() -> void* { return &arena.allocate<uint>(); });
+}
+
 }  // namespace
 }  // namespace zc
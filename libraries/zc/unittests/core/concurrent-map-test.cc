@@ -0,0 +1,194 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "zc/core/concurrent-map.h"
+
+#include "zc/core/map.h"
+#include "zc/core/string.h"
+#include "zc/core/thread.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace _ {
+namespace {
+
+ZC_TEST("ConcurrentHashMap") {
+  ConcurrentHashMap<String, int> map;
+
+  map.insert(str("foo"), 123);
+  map.insert(str("bar"), 456);
+  ZC_EXPECT_THROW_MESSAGE("inserted row already exists", map.insert(str("foo"), 789));
+
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find("foo"_zc)) == 123);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find("bar"_zc)) == 456);
+  ZC_EXPECT(map.find("baz"_zc) == zc::none);
+  ZC_EXPECT(map.size() == 2);
+
+  StringPtr seen;
+  ZC_EXPECT(map.find("foo"_zc, [&](auto& entry) { seen = entry.key; }));
+  ZC_EXPECT(seen == "foo");
+  ZC_EXPECT(!map.find("baz"_zc, [&](auto&) { ZC_FAIL_EXPECT("called for a missing key"); }));
+
+  map.upsert(str("foo"), 789);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find("foo"_zc)) == 789);
+  map.upsert(str("foo"), 1, [](int& existing, int&& added) { existing += added; });
+  map.upsert(str("baz"), 1, [](int& existing, int&& added) { existing += added; });
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find("foo"_zc)) == 790);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find("baz"_zc)) == 1);
+
+  uint created = 0;
+  auto create = [&]() {
+    ++created;
+    return decltype(map)::Entry{str("qux"), 5};
+  };
+  ZC_EXPECT(map.findOrCreate("qux"_zc, create) == 5);
+  ZC_EXPECT(map.findOrCreate("qux"_zc, create) == 5);
+  ZC_EXPECT(created == 1);
+
+  ZC_EXPECT(map.erase("bar"_zc));
+  ZC_EXPECT(!map.erase("bar"_zc));
+  ZC_EXPECT(map.size() == 3);
+
+  map.clear();
+  ZC_EXPECT(map.size() == 0);
+  ZC_EXPECT(map.find("foo"_zc) == zc::none);
+}
+
+ZC_TEST("ConcurrentHashMap iteration visits every shard") {
+  ConcurrentHashMap<uint, uint> map;
+  map.reserve(1000);
+  for (uint i : zeroTo(1000)) { map.insert(i, i * 2); }
+
+  uint64_t keySum = 0, valueSum = 0;
+  map.forEach([&](auto& entry) {
+    keySum += entry.key;
+    valueSum += entry.value;
+  });
+  ZC_EXPECT(keySum == 999 * 1000 / 2);
+  ZC_EXPECT(valueSum == 999 * 1000);
+
+  auto entries = map.snapshot();
+  ZC_ASSERT(entries.size() == 1000);
+  // The snapshot is a copy; it doesn't follow later changes.
+  map.clear();
+  for (auto& entry : entries) { ZC_EXPECT(entry.value == entry.key * 2); }
+}
+
+struct ModuloCallbacks {
+  // Keys equal modulo 10, as the same interface HashIndex takes.
+  template <typename Entry>
+  inline auto& keyForRow(Entry& entry) const {
+    return entry.key;
+  }
+  template <typename Entry>
+  inline bool matches(Entry& entry, uint key) const {
+    return entry.key % 10 == key % 10;
+  }
+  inline uint hashCode(uint key) const { return zc::hashCode(key % 10); }
+};
+
+ZC_TEST("ConcurrentHashMap with custom callbacks") {
+  ConcurrentHashMap<uint, StringPtr, ModuloCallbacks> map;
+  map.insert(3, "three");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find(13u)) == "three");
+  map.upsert(23, "twenty-three");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(map.find(3u)) == "twenty-three");
+  ZC_EXPECT(map.size() == 1);
+}
+
+ZC_TEST("ConcurrentHashMap creates each entry once across threads") {
+  constexpr uint THREADS = 8;
+  constexpr uint KEYS = 2000;
+  ConcurrentHashMap<uint, uint> map;
+  MutexGuarded<uint> created(0);
+  {
+    Vector<Own<Thread>> threads;
+    for (uint t : zeroTo(THREADS)) {
+      threads.add(heap<Thread>([&, t]() {
+        for (uint i : zeroTo(KEYS)) {
+          uint key = (i * 7 + t * 13) % KEYS;
+          uint value = map.findOrCreate(key, [&]() {
+            ++*created.lockExclusive();
+            return ConcurrentHashMap<uint, uint>::Entry{key, key + 1};
+          });
+          ZC_ASSERT(value == key + 1);
+          map.upsert(KEYS + t, i);
+        }
+      }));
+    }
+  }
+  ZC_EXPECT(*created.lockShared() == KEYS);
+  ZC_EXPECT(map.size() == KEYS + THREADS);
+  for (uint t : zeroTo(THREADS)) { ZC_EXPECT(ZC_ASSERT_NONNULL(map.find(KEYS + t)) == KEYS - 1); }
+}
+
+// -----------------------------------------------------------------------------
+// Contention: threads looking up a shared set of keys, creating the missing ones, as the
+// compiler's interning does. Compare with the same load on a MutexGuarded<HashMap>.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+static constexpr uint BENCHMARK_LOOKUPS = 1 << 14;
+#else
+static constexpr uint BENCHMARK_LOOKUPS = 1 << 20;
+#endif
+static constexpr uint BENCHMARK_THREADS = 8;
+static constexpr uint BENCHMARK_KEYS = 1 << 14;
+
+template <typename Lookup>
+void runContention(Lookup&& lookup) {
+  Vector<Own<Thread>> threads;
+  for (uint t : zeroTo(BENCHMARK_THREADS)) {
+    threads.add(heap<Thread>([&lookup, t]() {
+      uint state = t * 2654435761u + 1;
+      for (uint i = 0; i < BENCHMARK_LOOKUPS; i++) {
+        state = state * 1103515245 + 12345;
+        uint key = (state >> 8) % BENCHMARK_KEYS;
+        ZC_ASSERT(lookup(key) == key * 3);
+      }
+    }));
+  }
+}
+
+ZC_TEST("benchmark: ConcurrentHashMap under contention") {
+  using Map = ConcurrentHashMap<uint, uint>;
+  Map map;
+  runContention(
+      [&](uint key) { return map.findOrCreate(key, [&]() { return Map::Entry{key, key * 3}; }); });
+  ZC_EXPECT(map.size() == BENCHMARK_KEYS);
+}
+
+ZC_TEST("benchmark: MutexGuarded<HashMap> under contention") {
+  MutexGuarded<HashMap<uint, uint>> map;
+  runContention([&](uint key) {
+    {
+      auto locked = map.lockShared();
+      ZC_IF_SOME(value, locked->find(key)) { return value; }
+    }
+    return map.lockExclusive()->findOrCreate(
+        key, [&]() { return HashMap<uint, uint>::Entry{key, key * 3}; });
+  });
+  ZC_EXPECT(map.lockShared()->size() == BENCHMARK_KEYS);
+}
+
+}  // namespace
+}  // namespace _
+}  // namespace zc
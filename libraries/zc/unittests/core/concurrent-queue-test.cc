@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/concurrent-queue.h"
+
+#include "zc/core/thread.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+template <typename Queue>
+void testSingleThreaded() {
+  Queue queue(5);
+  ZC_EXPECT(queue.capacity() == 8);
+  ZC_EXPECT(queue.tryPop() == zc::none);
+
+  // Go around the ring a few times.
+  for (uint round = 0; round < 3; round++) {
+    for (uint i = 0; i < 8; i++) { ZC_EXPECT(queue.tryPush(round * 100 + i)); }
+    ZC_EXPECT(!queue.tryPush(999));
+    for (uint i = 0; i < 8; i++) {
+      ZC_EXPECT(ZC_ASSERT_NONNULL(queue.tryPop()) == round * 100 + i);
+    }
+    ZC_EXPECT(queue.tryPop() == zc::none);
+  }
+}
+
+ZC_TEST("SpscQueue") { testSingleThreaded<SpscQueue<uint>>(); }
+
+ZC_TEST("MpmcQueue") { testSingleThreaded<MpmcQueue<uint>>(); }
+
+struct Counted {
+  uint& destroyed;
+  ~Counted() noexcept(false) { ++destroyed; }
+};
+
+template <typename Queue>
+void testOwnership() {
+  // A failed push leaves the value alone, and elements still queued are destroyed with the queue.
+  uint destroyed = 0;
+
+  {
+    Queue queue(2);
+    ZC_EXPECT(queue.tryPush(heap<Counted>(destroyed)));
+    ZC_EXPECT(queue.tryPush(heap<Counted>(destroyed)));
+
+    auto extra = heap<Counted>(destroyed);
+    ZC_EXPECT(!queue.tryPush(zc::mv(extra)));
+    ZC_EXPECT(extra.get() != nullptr);
+
+    ZC_EXPECT(queue.tryPop() != zc::none);
+    ZC_EXPECT(destroyed == 1);
+  }
+  ZC_EXPECT(destroyed == 3);
+}
+
+ZC_TEST("SpscQueue owns its elements") { testOwnership<SpscQueue<Own<Counted>>>(); }
+
+ZC_TEST("MpmcQueue owns its elements") { testOwnership<MpmcQueue<Own<Counted>>>(); }
+
+ZC_TEST("SpscQueue across threads") {
+  constexpr uint COUNT = 20000;
+  SpscQueue<uint> queue(256);
+
+  Thread producer([&]() {
+    for (uint i = 0; i < COUNT; i++) {
+      while (!queue.tryPush(zc::mv(i))) {}
+    }
+  });
+
+  for (uint i = 0; i < COUNT;) {
+    ZC_IF_SOME(value, queue.tryPop()) {
+      ZC_ASSERT(value == i);
+      i++;
+    }
+  }
+}
+
+ZC_TEST("MpmcQueue across threads") {
+  // Every value pushed is popped exactly once, and each producer's values come out in order.
+  constexpr uint PRODUCERS = 4;
+  constexpr uint CONSUMERS = 4;
+  constexpr uint PER_PRODUCER = 5000;
+  MpmcQueue<uint> queue(256);
+
+  uint64_t sums[CONSUMERS] = {};
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(PRODUCERS + CONSUMERS);
+    for (uint p = 0; p < PRODUCERS; p++) {
+      threads.add(heap<Thread>([&, p]() {
+        for (uint i = 0; i < PER_PRODUCER; i++) {
+          uint value = p * PER_PRODUCER + i;
+          while (!queue.tryPush(zc::mv(value))) {}
+        }
+      }));
+    }
+    for (uint c = 0; c < CONSUMERS; c++) {
+      threads.add(heap<Thread>([&, c]() {
+        uint last[PRODUCERS];
+        for (auto& l : last) l = UINT_MAX;
+        for (uint n = 0; n < PRODUCERS * PER_PRODUCER / CONSUMERS;) {
+          ZC_IF_SOME(value, queue.tryPop()) {
+            uint p = value / PER_PRODUCER;
+            ZC_ASSERT(last[p] == UINT_MAX || value > last[p]);
+            last[p] = value;
+            sums[c] += value;
+            n++;
+          }
+        }
+      }));
+    }
+  }
+
+  uint64_t total = 0;
+  for (auto sum : sums) total += sum;
+  uint64_t n = PRODUCERS * PER_PRODUCER;
+  ZC_EXPECT(total == n * (n - 1) / 2);
+  ZC_EXPECT(queue.tryPop() == zc::none);
+}
+
+ZC_TEST("BlockingQueue") {
+  // The queue is tiny, so producers and consumers both spend time asleep.
+  constexpr uint THREADS = 3;
+  constexpr uint PER_THREAD = 10000;
+  BlockingQueue<uint> queue(2);
+
+  uint64_t sums[THREADS] = {};
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(THREADS * 2);
+    for (uint t = 0; t < THREADS; t++) {
+      threads.add(heap<Thread>([&, t]() {
+        for (uint i = 0; i < PER_THREAD; i++) { queue.push(t * PER_THREAD + i); }
+      }));
+      threads.add(heap<Thread>([&, t]() {
+        for (uint i = 0; i < PER_THREAD; i++) { sums[t] += queue.pop(); }
+      }));
+    }
+  }
+
+  uint64_t total = 0;
+  for (auto sum : sums) total += sum;
+  uint64_t n = THREADS * PER_THREAD;
+  ZC_EXPECT(total == n * (n - 1) / 2);
+  ZC_EXPECT(queue.tryPop() == zc::none);
+  ZC_EXPECT(queue.tryPush(1));
+  ZC_EXPECT(queue.pop() == 1);
+}
+
+ZC_TEST("BlockingQueue over SpscQueue") {
+  constexpr uint COUNT = 100000;
+  BlockingQueue<uint, SpscQueue<uint>> queue(16);
+
+  Thread producer([&]() {
+    for (uint i = 0; i < COUNT; i++) { queue.push(zc::mv(i)); }
+  });
+
+  for (uint i = 0; i < COUNT; i++) { ZC_ASSERT(queue.pop() == i); }
+}
+
+void queueBenchmark(Function<void(uint)> push, Function<uint()> pop) {
+  // Two producers handing values to two consumers.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ITEMS = 10000;
+#else
+  constexpr uint ITEMS = 1000000;
+#endif
+
+  auto threads = heapArrayBuilder<Own<Thread>>(4);
+  for (uint t = 0; t < 2; t++) {
+    threads.add(heap<Thread>([&]() {
+      for (uint i = 0; i < ITEMS; i++) { push(i); }
+    }));
+    threads.add(heap<Thread>([&]() {
+      for (uint i = 0; i < ITEMS; i++) { pop(); }
+    }));
+  }
+}
+
+ZC_TEST("benchmark: BlockingQueue") {
+  BlockingQueue<uint> queue(1024);
+  queueBenchmark([&](uint i) { queue.push(zc::mv(i)); }, [&]() { return queue.pop(); });
+}
+
+ZC_TEST("benchmark: MutexGuarded<Vector> as a queue") {
+  // The way a queue shared by threads is usually written without this header.
+  struct State {
+    Vector<uint> items;
+    size_t popped = 0;
+  };
+  MutexGuarded<State> state;
+  queueBenchmark(
+      [&](uint i) { state.lockExclusive()->items.add(i); },
+      [&]() {
+        auto lock = state.lockExclusive();
+        lock.wait([](const State& s) { return s.popped < s.items.size(); });
+        return lock->items[lock->popped++];
+      });
+}
+
+}  // namespace
+}  // namespace zc
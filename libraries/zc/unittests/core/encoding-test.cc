@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 
+#include "zc/core/io.h"
 #include "zc/ztest/test.h"
 
 namespace zc {
@@ -230,6 +231,94 @@ ZC_TEST("round-trip invalid UTF-16") {
   expectRes(encodeUtf16(decodeUtf32(encodeUtf32(decodeUtf16(INVALID)))), INVALID, true);
 }
 
+ZC_TEST("validate UTF-8") {
+  ZC_EXPECT(validateUtf8(""_zc));
+  ZC_EXPECT(validateUtf8("foo"_zc));
+  ZC_EXPECT(validateUtf8("Здравствуйте"_zc));
+  ZC_EXPECT(validateUtf8("😺☁☄🐵"_zc));
+  ZC_EXPECT(validateUtf8("\xc2\x80\xdf\xbf\xe0\xa0\x80\xef\xbf\xbf"_zc));
+  ZC_EXPECT(validateUtf8("\xf0\x90\x80\x80\xf4\x8f\xbf\xbf"_zc));
+
+  ZC_EXPECT(!validateUtf8("\x80"_zc));
+  ZC_EXPECT(!validateUtf8("f\xbfo"_zc));
+  ZC_EXPECT(!validateUtf8("\xc2"_zc));
+  ZC_EXPECT(!validateUtf8("\xe0\xa0"_zc));
+  ZC_EXPECT(!validateUtf8("\xf0\x90\x80"_zc));
+  ZC_EXPECT(!validateUtf8("\xf0\x90\x80x"_zc));
+  ZC_EXPECT(!validateUtf8("\xc0\x80"_zc));
+  ZC_EXPECT(!validateUtf8("\xc1\xbf"_zc));
+  ZC_EXPECT(!validateUtf8("\xe0\x9f\xbf"_zc));
+  ZC_EXPECT(!validateUtf8("\xf0\x8f\xbf\xbf"_zc));
+  ZC_EXPECT(!validateUtf8("\xf4\x90\x80\x80"_zc));
+  ZC_EXPECT(!validateUtf8("\xf8\x88\x80\x80\x80"_zc));
+  ZC_EXPECT(!validateUtf8("\xed\xa0\x80"_zc));
+  ZC_EXPECT(!validateUtf8("\xed\xbf\xbf"_zc));
+  ZC_EXPECT(validateUtf8("\xed\x9f\xbf"_zc));
+
+  // Errors either side of the 16-byte and 8-byte blocks the ASCII runs are scanned in.
+  for (size_t length : {7, 8, 15, 16, 17, 31, 32, 33, 100}) {
+    for (size_t pos = 0; pos < length; pos++) {
+      auto text = heapString(length);
+      memset(text.begin(), 'a', length);
+      ZC_EXPECT(validateUtf8(text));
+      text[pos] = '\x80';
+      ZC_EXPECT(!validateUtf8(text), length, pos);
+    }
+  }
+}
+
+ZC_TEST("validateUtf8() agrees with encodeUtf16()") {
+  // Random text, mostly ASCII with multi-byte sequences and stray bytes mixed in, so that both the
+  // ASCII runs and the sequences between them are exercised.
+  uint32_t state = 12345;
+  auto next = [&]() {
+    state = state * 1103515245 + 12345;
+    return state >> 16;
+  };
+
+  static const char* const PIECES[] = {
+      "\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\xba", "\xed\xa0\x80", "\xc0\xaf",
+      "\xf4\x90\x80\x80", "\x80", "\xe0\xa0", "\xff"};
+
+  for (uint iteration = 0; iteration < 2000; iteration++) {
+    Vector<char> text;
+    uint length = next() % 64;
+    while (text.size() < length) {
+      if (next() % 4 == 0) {
+        StringPtr piece = PIECES[next() % zc::size(PIECES)];
+        text.addAll(piece);
+      } else {
+        text.add('a' + next() % 26);
+      }
+    }
+
+    auto encoded = encodeUtf16(text);
+    ZC_EXPECT(validateUtf8(text) == !encoded.hadErrors, iteration);
+    if (!encoded.hadErrors) { expectResImpl(decodeUtf16(encoded), text.asPtr().asConst()); }
+  }
+}
+
+ZC_TEST("transcode long ASCII runs") {
+  auto ascii = heapString(1000);
+  for (auto i : zc::indices(ascii)) { ascii[i] = ' ' + i % 95; }
+
+  for (size_t offset : {0, 1, 7, 15, 16, 17, 500}) {
+    auto text = str(ascii.first(offset), "Ω", ascii.slice(offset));
+    auto utf16 = encodeUtf16(text);
+    ZC_EXPECT(!utf16.hadErrors);
+    ZC_EXPECT(utf16.size() == 1001);
+    ZC_EXPECT(utf16[offset] == u'Ω');
+    auto utf32 = encodeUtf32(text);
+    ZC_EXPECT(!utf32.hadErrors);
+    ZC_EXPECT(utf32.size() == 1001);
+    ZC_EXPECT(utf32[offset] == U'Ω');
+    ZC_EXPECT(utf32[999] == char32_t(ascii[998]));
+
+    expectResImpl(decodeUtf16(utf16), text.asArray().asConst());
+    expectResImpl(decodeUtf32(utf32), text.asArray().asConst());
+  }
+}
+
 ZC_TEST("EncodingResult as a Maybe") {
   {
     auto result = encodeUtf16("\x80");
@@ -534,5 +623,97 @@ ZC_TEST("base64 url encoding") {
   }
 }
 
+ZC_TEST("bulk base64, hex and URI encoding") {
+  // Long enough inputs that the vector paths run, with every length mod 48 so that they all hand
+  // off to the scalar tail at each possible point.
+  auto data = heapArray<byte>(1000);
+  uint32_t state = 54321;
+  for (auto& b : data) {
+    state = state * 1103515245 + 12345;
+    b = state >> 24;
+  }
+  // Make runs that encodeUriComponent() passes through unchanged.
+  for (auto i : zc::indices(data)) {
+    if (i % 64 < 40) data[i] = "abcXYZ019-_.!~*'()"[i % 18];
+  }
+
+  for (size_t size : {0, 1, 2, 3, 15, 16, 17, 47, 48, 49, 53, 54, 55, 108, 500, 999, 1000}) {
+    auto bytes = data.first(size);
+
+    for (bool breakLines : {false, true}) {
+      auto base64 = encodeBase64(bytes, breakLines);
+      ZC_EXPECT(base64.size() == encodeBase64Size(size, breakLines));
+      ZC_EXPECT(decodeBase64(base64).asPtr() == bytes, size, breakLines);
+
+      auto buffer = heapArray<char>(base64.size());
+      ZC_EXPECT(encodeBase64To(buffer.begin(), bytes, breakLines) == buffer.end());
+      ZC_EXPECT(buffer.asPtr() == base64.asArray());
+
+      VectorOutputStream output;
+      encodeBase64(output, bytes, breakLines);
+      ZC_EXPECT(output.getArray() == base64.asBytes());
+    }
+
+    auto url = encodeBase64Url(bytes);
+    auto base64 = encodeBase64(bytes);
+    ZC_EXPECT(url.size() == base64.size() - (3 - size % 3) % 3);
+    for (auto i : zc::indices(url)) {
+      char expected = base64[i] == '+' ? '-' : base64[i] == '/' ? '_' : base64[i];
+      ZC_EXPECT(url[i] == expected, size, i);
+    }
+
+    auto hexText = encodeHex(bytes);
+    ZC_EXPECT(decodeHex(hexText).asPtr() == bytes, size);
+    {
+      VectorOutputStream output;
+      encodeHex(output, bytes);
+      ZC_EXPECT(output.getArray() == hexText.asBytes());
+    }
+
+    auto uri = encodeUriComponent(bytes);
+    ZC_EXPECT(decodeBinaryUriComponent(uri).asPtr() == bytes, size);
+    {
+      VectorOutputStream output;
+      encodeUriComponent(output, bytes);
+      ZC_EXPECT(output.getArray() == uri.asBytes());
+    }
+  }
+
+  // More than one chunk's worth of output through an OutputStream.
+  auto big = heapArray<byte>(100000);
+  for (auto i : zc::indices(big)) { big[i] = i * 7; }
+  for (bool breakLines : {false, true}) {
+    VectorOutputStream output;
+    encodeBase64(output, big, breakLines);
+    ZC_EXPECT(output.getArray() == encodeBase64(big, breakLines).asBytes());
+  }
+  {
+    VectorOutputStream output;
+    encodeHex(output, big);
+    ZC_EXPECT(output.getArray() == encodeHex(big).asBytes());
+  }
+  {
+    VectorOutputStream output;
+    encodeUriComponent(output, big);
+    ZC_EXPECT(output.getArray() == encodeUriComponent(big).asBytes());
+  }
+}
+
+ZC_TEST("every byte through the URI component encoder") {
+  // Put each byte at each position of a 16-byte block of otherwise safe characters.
+  for (uint b = 0; b < 256; b++) {
+    bool safe = ('A' <= b && b <= 'Z') || ('a' <= b && b <= 'z') || ('0' <= b && b <= '9') ||
+                StringPtr("-_.!~*'()").findFirst(b) != zc::none;
+    for (uint pos = 0; pos < 16; pos++) {
+      byte bytes[32];
+      memset(bytes, 'a', sizeof(bytes));
+      bytes[pos] = b;
+      auto encoded = encodeUriComponent(arrayPtr(bytes));
+      ZC_EXPECT(encoded.size() == (safe ? 32 : 34), b, pos);
+      ZC_EXPECT(decodeBinaryUriComponent(encoded).asPtr() == arrayPtr(bytes), b, pos);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace zc
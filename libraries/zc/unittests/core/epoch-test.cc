@@ -0,0 +1,168 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/epoch.h"
+
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+struct Counted {
+  std::atomic<uint>& destroyed;
+  ~Counted() noexcept(false) { destroyed.fetch_add(1, std::memory_order_relaxed); }
+};
+
+ZC_TEST("Epoch::retire() frees after synchronize()") {
+  std::atomic<uint> destroyed = 0;
+
+  {
+    Epoch::ReadLock lock;
+    Epoch::ReadLock nested;
+  }
+
+  Epoch::retire(heap<Counted>(destroyed));
+  Epoch::retire(heap<Counted>(destroyed));
+  Epoch::synchronize();
+  ZC_EXPECT(destroyed == 2);
+
+  // synchronize() refuses to wait on its own thread's read lock.
+  Epoch::ReadLock lock;
+  ZC_EXPECT_THROW_MESSAGE("while holding a read lock", Epoch::synchronize());
+}
+
+ZC_TEST("Epoch read locks hold back reclamation") {
+  std::atomic<uint> destroyed = 0;
+  MutexGuarded<uint> stage(0);
+
+  Thread reader([&]() {
+    Epoch::ReadLock lock;
+    *stage.lockExclusive() = 1;
+    stage.when([](uint s) { return s == 2; }, [](uint&) {});
+  });
+  stage.when([](uint s) { return s == 1; }, [](uint&) {});
+
+  // Plenty to trigger reclamation attempts, none of which may succeed.
+  for (uint i = 0; i < 1000; i++) { Epoch::retire(heap<Counted>(destroyed)); }
+  ZC_EXPECT(destroyed == 0);
+
+  *stage.lockExclusive() = 2;
+  Epoch::synchronize();
+  ZC_EXPECT(destroyed == 1000);
+}
+
+ZC_TEST("Epoch frees what exiting threads left behind") {
+  std::atomic<uint> destroyed = 0;
+
+  {
+    Thread thread([&]() { Epoch::retire(heap<Counted>(destroyed)); });
+  }
+
+  // The orphan is picked up by whichever thread reclaims next.
+  Epoch::synchronize();
+  ZC_EXPECT(destroyed == 1);
+}
+
+ZC_TEST("RcuGuarded") {
+  struct Pair {
+    uint a;
+    uint b;
+  };
+
+  RcuGuarded<Pair> guarded(Pair{1, 1});
+  {
+    auto before = guarded.lockShared();
+    guarded.update([](Pair& p) {
+      ++p.a;
+      ++p.b;
+    });
+
+    // Readers keep the version they started with.
+    ZC_EXPECT(before->a == 1);
+    ZC_EXPECT(guarded.lockShared()->a == 2);
+  }
+
+  guarded.set(heap<Pair>(Pair{5, 5}));
+  ZC_EXPECT(guarded.lockShared()->b == 5);
+
+  // Readers racing a writer always see a consistent version.
+  constexpr uint READERS = 3;
+  constexpr uint UPDATES = 2000;
+  std::atomic<bool> done = false;
+
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(READERS);
+    for (uint t = 0; t < READERS; t++) {
+      threads.add(heap<Thread>([&]() {
+        while (!done.load(std::memory_order_relaxed)) {
+          auto pair = guarded.lockShared();
+          ZC_ASSERT(pair->a == pair->b);
+        }
+      }));
+    }
+
+    for (uint i = 0; i < UPDATES; i++) {
+      guarded.update([](Pair& p) {
+        ++p.a;
+        ++p.b;
+      });
+    }
+    done = true;
+  }
+
+  ZC_EXPECT(guarded.lockShared()->a == 5 + UPDATES);
+  Epoch::synchronize();
+}
+
+template <typename Read>
+void readBenchmark(Read&& read) {
+  // Four threads reading a small shared value.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ITERATIONS = 10000;
+#else
+  constexpr uint ITERATIONS = 1000000;
+#endif
+
+  auto threads = heapArrayBuilder<Own<Thread>>(4);
+  for (uint t = 0; t < 4; t++) {
+    threads.add(heap<Thread>([&]() {
+      uint sum = 0;
+      for (uint i = 0; i < ITERATIONS; i++) { sum += read(); }
+      ZC_ASSERT(sum == 7 * ITERATIONS);
+    }));
+  }
+}
+
+ZC_TEST("benchmark: reading MutexGuarded") {
+  MutexGuarded<uint> value(7);
+  readBenchmark([&]() { return *value.lockShared(); });
+}
+
+ZC_TEST("benchmark: reading RcuGuarded") {
+  RcuGuarded<uint> value(7);
+  readBenchmark([&]() { return *value.lockShared(); });
+}
+
+}  // namespace
+}  // namespace zc
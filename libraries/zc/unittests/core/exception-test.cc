@@ -177,6 +177,26 @@ ZC_TEST("getStackTrace() returns correct line number, not line + 1") {
   ZC_ASSERT(!trace.contains(wrong), trace, wrong);
 }
 
+ZC_TEST("stringifyStackTrace() answers repeat traces from its cache") {
+  class FullTraces final : public ExceptionCallback {
+  public:
+    StackTraceMode stackTraceMode() override { return StackTraceMode::FULL; }
+  };
+  FullTraces callback;
+
+  void* space[32]{};
+  auto trace = zc::getStackTrace(space, 0);
+  auto first = stringifyStackTrace(trace);
+  ZC_EXPECT(stringifyStackTrace(trace) == first);
+
+  // A trace sharing some of the addresses is assembled from the same cached frames.
+  if (first != nullptr && trace.size() > 1) {
+    ZC_EXPECT(first.contains("exception-test.cc"), first);
+    auto tail = stringifyStackTrace(trace.slice(1, trace.size()));
+    ZC_EXPECT(first.endsWith(tail.slice(1)), first, tail);
+  }
+}
+
 ZC_TEST("InFlightExceptionIterator works") {
   bool caught = false;
   try {
@@ -386,6 +386,27 @@ ZC_TEST("DiskFile::copy()") {
   ZC_EXPECT(dest->readAllText().slice(321) == bigString);
 }
 
+ZC_TEST("DiskFile MappedFileOutputStream") {
+  auto file = newTempFile();
+  file->writeAll("header-and-stale-trailing-bytes");
+
+  String bigString = strArray(repeat("foobar", 100000), "");
+  {
+    MappedFileOutputStream out(file->clone(), 7);
+    out.write("abc"_zcb);
+    ZC_EXPECT(file->stat().size > out.getPosition());
+    out.write(bigString.asBytes());
+    out.sync(7, 3);
+
+    auto buffer = out.getWriteBuffer();
+    memcpy(buffer.begin(), "xyz", 3);
+    out.write(buffer.first(3));
+    out.sync();
+  }
+
+  ZC_EXPECT(file->readAllText() == str("header-abc", bigString, "xyz"));
+}
+
 ZC_TEST("DiskDirectory") {
   TempDir tempDir;
   auto dir = tempDir.get();
@@ -534,6 +555,57 @@ ZC_TEST("DiskDirectory") {
 }
 
 #if !_WIN32  // Creating symlinks on Win32 requires admin privileges prior to Windows 10.
+ZC_TEST("DiskDirectory walk()") {
+  TempDir tempDir;
+  auto dir = tempDir.get();
+
+  auto mode = WriteMode::CREATE | WriteMode::CREATE_PARENT;
+  for (uint i = 0; i < 20; i++) {
+    dir->openFile(Path({"tree", zc::str("d", i / 5), zc::str("f", i)}), mode);
+  }
+
+  auto entries = dir->walk(4);
+  ZC_EXPECT(entries.size() == 25);
+  ZC_EXPECT(entries[0].path.toString() == "tree");
+  ZC_EXPECT(entries[0].type == FsNode::Type::DIRECTORY);
+  ZC_EXPECT(entries[1].path.toString() == "tree/d0");
+  ZC_EXPECT(entries[2].path.toString() == "tree/d0/f0");
+  ZC_EXPECT(entries[2].type == FsNode::Type::FILE);
+}
+
+ZC_TEST("tryReadFilesBatched()") {
+  TempDir tempDir;
+  auto dir = tempDir.get();
+
+  auto mode = WriteMode::CREATE | WriteMode::CREATE_PARENT;
+  Vector<Path> paths;
+  for (uint i = 0; i < 300; i++) {
+    auto path = Path({"src", zc::str("f", i)});
+    dir->openFile(path, mode)->writeAll(zc::str("file ", i));
+    paths.add(zc::mv(path));
+  }
+  dir->openFile(Path({"empty"}), mode);
+  paths.add(Path({"empty"}));
+  paths.add(Path({"missing"}));
+
+  auto ptrs = ZC_MAP(p, paths) { return PathPtr(p); };
+  ZC_IF_SOME(results, tryReadFilesBatched(*dir, ptrs, 1)) {
+    ZC_ASSERT(results.size() == 302);
+    for (uint i = 0; i < 300; i++) {
+      auto& content = ZC_ASSERT_NONNULL(results[i]);
+      ZC_EXPECT(heapString(content.asChars()) == zc::str("file ", i));
+      ZC_EXPECT(content.end()[0] == 0);
+    }
+    ZC_EXPECT(ZC_ASSERT_NONNULL(results[300]).size() == 0);
+    ZC_EXPECT(results[301] == zc::none);
+  }
+  else {
+    // No io_uring here.
+  }
+
+  ZC_EXPECT(tryReadFilesBatched(*newInMemoryDirectory(nullClock()), ptrs) == zc::none);
+}
+
 ZC_TEST("DiskDirectory symlinks") {
   TempDir tempDir;
   auto dir = tempDir.get();
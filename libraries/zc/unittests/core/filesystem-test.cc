@@ -23,6 +23,7 @@
 
 #include <wchar.h>
 
+#include "zc/core/glob-filter.h"
 #include "zc/ztest/test.h"
 
 #if __linux__
@@ -438,6 +439,48 @@ ZC_TEST("File::copy()") {
   ZC_EXPECT(dest->readAllText().slice(321) == bigString);
 }
 
+ZC_TEST("MappedFileOutputStream") {
+  TestClock clock;
+
+  auto file = newInMemoryFile(clock);
+  file->writeAll("header-and-stale-trailing-bytes");
+
+  String bigString = strArray(repeat("foobar", 100000), "");
+  {
+    MappedFileOutputStream out(file->clone(), 7);
+    out.write("abc"_zcb);
+    ZC_EXPECT(out.getPosition() == 10);
+
+    // Spans several windows.
+    out.write(bigString.asBytes());
+    ZC_EXPECT(out.getPosition() == 10 + bigString.size());
+
+    // Filling the write buffer directly.
+    auto buffer = out.getWriteBuffer();
+    ZC_ASSERT(buffer.size() >= 3);
+    memcpy(buffer.begin(), "xyz", 3);
+    out.write(buffer.first(3));
+
+    out.sync();
+  }
+
+  ZC_EXPECT(file->readAllText() == str("header-abc", bigString, "xyz"));
+
+  {
+    // Nothing written: the file ends at the starting offset.
+    MappedFileOutputStream out(file->clone(), 6);
+  }
+  ZC_EXPECT(file->readAllText() == "header");
+
+  {
+    MappedFileOutputStream out(file->clone());
+    out.write("done"_zcb);
+    out.finish();
+    ZC_EXPECT_THROW_MESSAGE("already finished", out.write("more"_zcb));
+  }
+  ZC_EXPECT(file->readAllText() == "done");
+}
+
 ZC_TEST("InMemoryDirectory") {
   TestClock clock;
 
@@ -765,6 +808,52 @@ ZC_TEST("InMemoryDirectory transfer from self") {
   ZC_EXPECT(file.get() == file2.get());
 }
 
+ZC_TEST("ReadableDirectory::walk()") {
+  TestClock clock;
+
+  auto dir = newInMemoryDirectory(clock);
+  auto mode = WriteMode::CREATE | WriteMode::CREATE_PARENT;
+  dir->openFile(Path({"main.zom"}), mode);
+  dir->openFile(Path({"src", "a.zom"}), mode);
+  dir->openFile(Path({"src", "b.txt"}), mode);
+  dir->openFile(Path({"src", "nested", "c.zom"}), mode);
+  dir->openFile(Path({"skip", "d.zom"}), mode);
+  dir->symlink(Path({"link"}), "src", mode);
+
+  for (uint threads : {1, 4}) {
+    auto entries = dir->walk(threads);
+    auto paths = ZC_MAP(e, entries) { return e.path.toString(); };
+    ZC_EXPECT(strArray(paths, ",") ==
+                  "link,main.zom,skip,skip/d.zom,src,src/a.zom,src/b.txt,src/nested,"
+                  "src/nested/c.zom",
+              threads);
+    ZC_EXPECT(entries[0].type == FsNode::Type::SYMLINK);
+    ZC_EXPECT(entries[4].type == FsNode::Type::DIRECTORY);
+    ZC_EXPECT(entries[5].type == FsNode::Type::FILE);
+  }
+
+  {
+    auto entries = dir->walk([](PathPtr path) { return path[0] != "skip"; }, 2);
+    auto paths = ZC_MAP(e, entries) { return e.path.toString(); };
+    ZC_EXPECT(strArray(paths, ",") ==
+              "link,main.zom,skip,src,src/a.zom,src/b.txt,src/nested,src/nested/c.zom");
+  }
+
+  {
+    GlobFilter filter("src/*.zom");
+    auto entries = dir->walk(filter, 2);
+    auto paths = ZC_MAP(e, entries) { return e.path.toString(); };
+    ZC_EXPECT(strArray(paths, ",") == "src/a.zom");
+  }
+
+  {
+    GlobFilter filter("*.zom");
+    auto entries = dir->walk(filter, 2);
+    auto paths = ZC_MAP(e, entries) { return e.path.toString(); };
+    ZC_EXPECT(strArray(paths, ",") == "main.zom,skip/d.zom,src/a.zom,src/nested/c.zom");
+  }
+}
+
 ZC_TEST("InMemoryDirectory createTemporary") {
   TestClock clock;
 
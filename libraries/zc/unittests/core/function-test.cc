@@ -119,6 +119,56 @@ TEST(ConstFunction, Method) {
   EXPECT_EQ(9 + 2 + 5, f(2, 9));
 }
 
+struct Tracked {
+  // Counts live instances, and knows whether it has been moved from.
+  uint& live;
+  bool valid = true;
+
+  explicit Tracked(uint& live) : live(live) { ++live; }
+  Tracked(Tracked&& other) noexcept : live(other.live), valid(other.valid) {
+    other.valid = false;
+    ++live;
+  }
+  ~Tracked() noexcept(false) { --live; }
+};
+
+ZC_TEST("Function stores small callables inline and big ones on the heap") {
+  uint live = 0;
+
+  {
+    // Small enough to store inline: moving the Function moves the callable.
+    Function<bool()> small = [t = Tracked(live)]() { return t.valid; };
+    ZC_EXPECT(live == 1);
+    Function<bool()> movedSmall = zc::mv(small);
+    ZC_EXPECT(live == 1);
+    ZC_EXPECT(movedSmall());
+
+    // Too big: moving the Function moves a pointer.
+    void* padding[3] = {};
+    Function<bool()> big = [t = Tracked(live), padding]() { return t.valid && !padding[0]; };
+    ZC_EXPECT(live == 2);
+    Function<bool()> movedBig = zc::mv(big);
+    ZC_EXPECT(live == 2);
+    ZC_EXPECT(movedBig());
+
+    // Assigning destroys what was there before.
+    movedBig = zc::mv(movedSmall);
+    ZC_EXPECT(live == 1);
+    ZC_EXPECT(movedBig());
+
+    Function<bool()> ref = movedBig.reference();
+    ZC_EXPECT(ref());
+  }
+  ZC_EXPECT(live == 0);
+
+  {
+    ConstFunction<uint()> f = [t = Tracked(live)]() { return t.live; };
+    ConstFunction<uint()> g = zc::mv(f);
+    ZC_EXPECT(g() == 1);
+  }
+  ZC_EXPECT(live == 0);
+}
+
 int testFunctionParam(FunctionParam<int(char, bool)> func, char c, bool b) { return func(c, b); }
 
 int testFunctionParamRecursive(FunctionParam<int(char, bool)> func, char c, bool b) {
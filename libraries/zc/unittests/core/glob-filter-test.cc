@@ -80,6 +80,67 @@ ZC_TEST("GlobFilter") {
   }
 }
 
+ZC_TEST("GlobSet") {
+  GlobSet set;
+  ZC_EXPECT(set.matches("foo").size() == 0);
+
+  ZC_EXPECT(set.add("*.cc") == 0);
+  ZC_EXPECT(set.add("foo*") == 1);
+  ZC_EXPECT(set.add("src/*-test.cc") == 2);
+  ZC_EXPECT(set.add("?") == 3);
+  ZC_EXPECT(set.size() == 4);
+
+  auto expectMatches = [&](StringPtr name, std::initializer_list<uint> expected) {
+    ZC_EXPECT(set.matches(name) == arrayPtr(expected.begin(), expected.size()), name);
+  };
+
+  expectMatches("foo.cc", {0, 1});
+  expectMatches("bar.h", {});
+  expectMatches("lib/src/foo-test.cc", {0, 1, 2});
+  expectMatches("lib/src/bar-test.cc", {0, 2});
+  expectMatches("src/foo/bar-test.cc", {0});
+  expectMatches("x", {3});
+  expectMatches("a/b\\foo", {1});
+  expectMatches("foo/b", {3});
+  expectMatches("", {});
+  ZC_EXPECT(set.matchesAny("foo"));
+  ZC_EXPECT(!set.matchesAny("bar"));
+
+  // Adding a pattern starts the DFA over.
+  set.add("bar");
+  expectMatches("bar", {4});
+  expectMatches("foo.cc", {0, 1});
+}
+
+ZC_TEST("GlobSet matches like GlobFilter") {
+  // Random patterns and names over a small alphabet, so that they often match.
+  uint32_t state = 1;
+  auto random = [&](uint n) {
+    state = state * 1103515245 + 12345;
+    return (state >> 16) % n;
+  };
+  auto randomString = [&](StringPtr alphabet, uint maxSize) {
+    auto result = heapString(random(maxSize + 1));
+    for (auto& c : result) { c = alphabet[random(alphabet.size())]; }
+    return result;
+  };
+
+  Vector<String> patterns;
+  for (uint i = 0; i < 40; i++) { patterns.add(randomString("ab/*?", 6)); }
+  Vector<StringPtr> patternPtrs;
+  for (auto& pattern : patterns) { patternPtrs.add(pattern); }
+  GlobSet set(patternPtrs.asPtr());
+
+  for (uint i = 0; i < 2000; i++) {
+    auto name = randomString("abc/", 10);
+    Vector<uint> expected;
+    for (uint j = 0; j < patterns.size(); j++) {
+      if (GlobFilter(patterns[j].asPtr()).matches(name)) { expected.add(j); }
+    }
+    ZC_EXPECT(set.matches(name) == expected.asPtr(), name);
+  }
+}
+
 }  // namespace
 }  // namespace _
 }  // namespace zc
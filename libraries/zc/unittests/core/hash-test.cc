@@ -0,0 +1,209 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/hash.h"
+
+#include <string.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#if __SSE4_2__ || __CRC32__
+#include <nmmintrin.h>
+#endif
+
+#include "zc/core/io.h"
+#include "zc/core/string.h"
+#include "zc/core/time.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace _ {
+namespace {
+
+Array<byte> patternBytes(size_t size) {
+  auto bytes = heapArray<byte>(size);
+  uint state = 0x12345678;
+  for (auto& b : bytes) {
+    state = state * 1103515245 + 12345;
+    b = state >> 16;
+  }
+  return bytes;
+}
+
+ZC_TEST("fastHash64 values are stable") {
+  // These are persisted by users, so they must never change, on any platform.
+  ZC_EXPECT(fastHash64(nullptr) == 0xa9cdbebe29be3743ull, fastHash64(nullptr));
+  ZC_EXPECT(fastHash64("a"_zcb) == 0xc323f349d41a868full, fastHash64("a"_zcb));
+  ZC_EXPECT(fastHash64("hello world"_zcb) == 0x39ee890f8faadf5dull, fastHash64("hello world"_zcb));
+  ZC_EXPECT(fastHash64("hello world"_zcb, 1) == 0xd11191ca00b43426ull,
+            fastHash64("hello world"_zcb, 1));
+  auto bytes = patternBytes(5000);
+  struct {
+    size_t size;
+    uint64_t hash;
+  } cases[] = {
+      {17, 0xc104aba22bd44e95ull},
+      {48, 0x9db26660a7e79e49ull},
+      {49, 0x2af0a56d1327107bull},
+      {200, 0xea1ecd7ba8a09895ull},
+      {1023, 0x6a47ab784f36d3c4ull},
+      {1024, 0x4af6b38055f7c896ull},
+      {1100, 0x04ea90b5f0985d62ull},
+      {5000, 0x9f1df05e17b74d96ull},
+  };
+  for (auto& c : cases) {
+    ZC_EXPECT(fastHash64(bytes.first(c.size)) == c.hash, c.size, fastHash64(bytes.first(c.size)));
+  }
+}
+
+ZC_TEST("fastHash64 depends on every byte, the length and the seed") {
+  auto bytes = patternBytes(3000);
+  for (size_t size : {1, 2, 3, 4, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 48, 49, 63, 64, 65, 96, 97,
+                      500, 1023, 1024, 1025, 1087, 1088, 1600, 3000}) {
+    ZC_CONTEXT(size);
+    ArrayPtr<byte> data = bytes.first(size);
+    uint64_t expected = fastHash64(data);
+    for (size_t i = 0; i < size; i++) {
+      data[i] ^= 0x10;
+      ZC_ASSERT(fastHash64(data) != expected, i);
+      data[i] ^= 0x10;
+    }
+    ZC_ASSERT(fastHash64(data) == expected);
+    ZC_ASSERT(fastHash64(data, 1) != expected);
+    ZC_ASSERT(fastHash64(bytes.first(size - 1)) != expected);
+  }
+
+  // Inputs of zeros differ only in length.
+  auto zeros = heapArray<byte>(2100);
+  memset(zeros.begin(), 0, zeros.size());
+  Vector<uint64_t> hashes;
+  for (size_t size = 0; size <= zeros.size(); size++) { hashes.add(fastHash64(zeros.first(size))); }
+  std::sort(hashes.begin(), hashes.end());
+  ZC_EXPECT(std::unique(hashes.begin(), hashes.end()) == hashes.end());
+}
+
+ZC_TEST("fastHash64 distinguishes reordered stripes") {
+  // The wide path sums its lanes, so the stripes must be keyed by position.
+  auto bytes = patternBytes(2048);
+  uint64_t expected = fastHash64(bytes);
+  byte stripe[64];
+  memcpy(stripe, bytes.begin(), 64);
+  memcpy(bytes.begin(), bytes.begin() + 64, 64);
+  memcpy(bytes.begin() + 64, stripe, 64);
+  ZC_EXPECT(fastHash64(bytes) != expected);
+
+  memcpy(bytes.begin() + 64, bytes.begin(), 64);
+  memcpy(bytes.begin(), stripe, 64);
+  memcpy(stripe, bytes.begin() + 512, 64);
+  memcpy(bytes.begin() + 512, bytes.begin(), 64);
+  memcpy(bytes.begin(), stripe, 64);
+  ZC_EXPECT(fastHash64(bytes) != expected);
+}
+
+ZC_TEST("hashCode() of strings and their bytes agree") {
+  StringPtr text = "the quick brown fox"_zc;
+  ZC_EXPECT(hashCode(text) == hashCode(text.asBytes()));
+  ZC_EXPECT(hashCode(text) == hashCode(zc::str(text)));
+#if ZC_FAST_STRING_HASH
+  uint64_t wide = fastHash64(text.asBytes());
+  ZC_EXPECT(hashCode(text) == uint(wide ^ (wide >> 32)));
+#else
+  ZC_EXPECT(hashCode(text) == murmur2(text.asBytes()));
+#endif
+}
+
+// -----------------------------------------------------------------------------
+// hash-bench: throughput of the string hashes by key length
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+static constexpr size_t BENCHMARK_BYTES = 1 << 22;
+#else
+static constexpr size_t BENCHMARK_BYTES = 1 << 28;
+#endif
+
+#if __SSE4_2__ || __CRC32__ || __ARM_FEATURE_CRC32
+#define ZC_HASH_TEST_CRC32 1
+
+uint crc32Hash(ArrayPtr<const byte> s) {
+  // Strings hashed with the CRC32 instruction intHash32() uses: fast, but it mixes poorly.
+  uint64_t h = s.size();
+  const byte* p = s.begin();
+  size_t len = s.size();
+  for (; len >= 8; p += 8, len -= 8) {
+    uint64_t k;
+    memcpy(&k, p, sizeof(k));
+#if __ARM_FEATURE_CRC32
+    h = __crc32d(h, k);
+#else
+    h = _mm_crc32_u64(h, k);
+#endif
+  }
+  for (; len > 0; p++, len--) {
+#if __ARM_FEATURE_CRC32
+    h = __crc32b(h, *p);
+#else
+    h = _mm_crc32_u8(h, *p);
+#endif
+  }
+  return h;
+}
+#endif
+
+template <typename Hash>
+double measureHash(ArrayPtr<const byte> bytes, size_t keySize, Hash&& hash) {
+  // Returns MB/s hashing BENCHMARK_BYTES as keys of `keySize` bytes.
+  uint64_t sink = 0;
+  auto& clock = systemPreciseMonotonicClock();
+  auto start = clock.now();
+  for (size_t done = 0; done < BENCHMARK_BYTES; done += keySize) {
+    // Vary the start so that the keys differ and the loop can't be hoisted.
+    size_t offset = (done / keySize) & 63;
+    sink += hash(bytes.slice(offset, offset + keySize));
+  }
+  double seconds = double((clock.now() - start) / NANOSECONDS) / 1e9;
+  ZC_EXPECT(sink != 0);
+  return double(BENCHMARK_BYTES) / 1e6 / seconds;
+}
+
+ZC_TEST("benchmark: hash-bench") {
+  FdOutputStream out(STDOUT_FILENO);
+  out.write("key bytes   murmur2 MB/s   fastHash64 MB/s   crc32 MB/s\n"_zcb);
+  for (size_t keySize : {8, 16, 24, 32, 64, 128, 256, 1024, 4096, 65536}) {
+    auto bytes = patternBytes(keySize + 64);
+    double murmur = measureHash(bytes, keySize, [](ArrayPtr<const byte> s) { return murmur2(s); });
+    double fast =
+        measureHash(bytes, keySize, [](ArrayPtr<const byte> s) { return fastHash64(s); });
+#if ZC_HASH_TEST_CRC32
+    String crc = str(
+        uint64_t(measureHash(bytes, keySize, [](ArrayPtr<const byte> s) { return crc32Hash(s); })));
+#else
+    String crc = str("-");
+#endif
+    out.write(str(keySize, "   ", uint64_t(murmur), "   ", uint64_t(fast), "   ", crc, "\n")
+                  .asBytes());
+  }
+}
+
+}  // namespace
+}  // namespace _
+}  // namespace zc
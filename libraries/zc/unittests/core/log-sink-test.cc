@@ -0,0 +1,127 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/log-sink.h"
+
+#include <thread>
+
+#include "zc/core/debug.h"
+#include "zc/core/io.h"
+#include "zc/core/miniposix.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+Vector<String> splitLines(StringPtr text) {
+  Vector<String> result;
+  while (text.size() > 0) {
+    ZC_IF_SOME(end, text.findFirst('\n')) {
+      result.add(heapString(text.first(end)));
+      text = text.slice(end + 1);
+    }
+    else {
+      result.add(heapString(text));
+      break;
+    }
+  }
+  return result;
+}
+
+// The test runner puts an ExceptionCallback in scope on its own threads, and on threads started
+// with zc::Thread, so messages are only deferred on a plain std::thread.
+
+ZC_TEST("AsyncLogSink writes ZC_LOG() messages from the background thread") {
+  int fds[2];
+  ZC_SYSCALL(miniposix::pipe(fds));
+  OwnFd in(fds[0]);
+  OwnFd out(fds[1]);
+
+  {
+    AsyncLogSink sink(out);
+
+    std::thread([&]() {
+      int value = 123;
+      ZC_LOG(WARNING, "first", value);
+      sink.flush();
+      ZC_LOG(WARNING, "second");
+    }).join();
+
+    // With the test's callback in scope, the message goes to the callback as usual.
+    {
+      ZC_EXPECT_LOG(WARNING, "not deferred");
+      ZC_LOG(WARNING, "not deferred");
+    }
+  }
+  out = nullptr;
+
+  auto text = FdInputStream(zc::mv(in)).readAllText();
+  auto lines = splitLines(text);
+  ZC_ASSERT(lines.size() == 2, text);
+  ZC_EXPECT(lines[0].contains("log-sink-test.cc:"), lines[0]);
+  ZC_EXPECT(lines[0].endsWith(": warning: first; value = 123"), lines[0]);
+  ZC_EXPECT(lines[1].endsWith(": warning: second"), lines[1]);
+}
+
+ZC_TEST("AsyncLogSink keeps each thread's messages in order") {
+  int fds[2];
+  ZC_SYSCALL(miniposix::pipe(fds));
+  OwnFd in(fds[0]);
+  OwnFd out(fds[1]);
+
+  constexpr uint THREADS = 4;
+  constexpr uint MESSAGES = 200;
+
+  // The pipe would fill up long before the threads are done; read it as we go.
+  String text;
+  std::thread reader([&]() { text = FdInputStream(zc::mv(in)).readAllText(); });
+
+  {
+    // Small rings, so that the threads have to wait for the background thread.
+    AsyncLogSink sink(out, 4);
+
+    std::thread threads[THREADS];
+    for (uint t = 0; t < THREADS; t++) {
+      threads[t] = std::thread([t]() {
+        for (uint i = 0; i < MESSAGES; i++) ZC_LOG(WARNING, "tick", t, i);
+      });
+    }
+    for (auto& thread : threads) thread.join();
+  }
+  out = nullptr;
+  reader.join();
+
+  uint next[THREADS] = {};
+  for (auto& line : splitLines(text)) {
+    ZC_IF_SOME(pos, line.find("tick; t = ")) {
+      uint t = line.slice(pos + 10, pos + 11)[0] - '0';
+      ZC_ASSERT(t < THREADS, line);
+      ZC_EXPECT(line.endsWith(str("; i = ", next[t])), line);
+      ++next[t];
+    }
+    else { ZC_FAIL_EXPECT("unexpected line", line); }
+  }
+  for (auto n : next) ZC_EXPECT(n == MESSAGES);
+}
+
+}  // namespace
+}  // namespace zc
@@ -28,6 +28,8 @@
 #include "zc/core/function.h"
 #include "zc/core/refcount.h"
 #include "zc/core/string.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/gtest.h"
 #include "zc/ztest/test.h"
 
@@ -714,6 +716,159 @@ ZC_TEST("zc::Ptr<T> subtyping") {
   ZC_EXPECT(ptr3 == pin);
 }
 
+#if ZC_TRACK_ALLOCATIONS
+ZC_TEST("AllocationTracker counts heap objects and arrays") {
+  AllocationTracker tracker;
+  {
+    Own<int> object = heap<int>(1);
+    Array<int> array = heapArray<int>(16);
+    ZC_EXPECT(tracker.getCounts().heapAllocations == 1);
+    ZC_EXPECT(tracker.getCounts().arrayAllocations == 1);
+    ZC_EXPECT(tracker.getCounts().bytes == sizeof(int) * 17);
+  }
+  AllocationCounts counts = tracker.getCounts();
+  ZC_EXPECT(counts.heapDisposals == 1);
+  ZC_EXPECT(counts.arrayDisposals == 1);
+
+  // Each time a Vector grows, it moves to a new array
+  tracker.reset();
+  Vector<int> vector;
+  for (int i = 0; i < 5; ++i) { vector.add(i); }
+  counts = tracker.getCounts();
+  ZC_EXPECT(counts.arrayAllocations == 2, counts.arrayAllocations);
+  ZC_EXPECT(counts.arrayDisposals == 1, counts.arrayDisposals);
+}
+
+ZC_TEST("AllocationTracker counts under the innermost scope") {
+  AllocationTracker tracker;
+  Own<int> outside = heap<int>(0);
+  {
+    AllocationScope outer("outer");
+    Own<int> first = heap<int>(1);
+    {
+      AllocationScope inner("inner");
+      Own<int> second = heap<int>(2);
+      Own<int> third = heap<int>(3);
+    }
+    Own<int> fourth = heap<int>(4);
+  }
+
+  ZC_EXPECT(tracker.getCounts("").heapAllocations == 1);
+  ZC_EXPECT(tracker.getCounts("outer").heapAllocations == 2);
+  // Categories are matched by their text
+  const String inner = heapString("inner");
+  ZC_EXPECT(tracker.getCounts(inner.cStr()).heapAllocations == 2);
+  ZC_EXPECT(tracker.getCounts().heapAllocations == 5);
+}
+
+ZC_TEST("AllocationTracker is exclusive") {
+  AllocationTracker tracker;
+  ZC_EXPECT_THROW_MESSAGE("only one AllocationTracker", AllocationTracker());
+}
+#endif  // ZC_TRACK_ALLOCATIONS
+
+ZC_TEST("findHeapAllocator knows the allocators by name") {
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(findHeapAllocator("system")) == &getSystemHeapAllocator());
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(findHeapAllocator("thread-caching")) ==
+            &getThreadCachingHeapAllocator());
+  ZC_EXPECT((findHeapAllocator("jemalloc") == zc::none) ==
+            (getJemallocHeapAllocator() == zc::none));
+  ZC_EXPECT((findHeapAllocator("mimalloc") == zc::none) ==
+            (getMimallocHeapAllocator() == zc::none));
+  ZC_EXPECT(findHeapAllocator("tcmalloc") == zc::none);
+
+  for (const char* name : {"system", "thread-caching", "jemalloc", "mimalloc"}) {
+    ZC_IF_SOME(allocator, findHeapAllocator(name)) {
+      ZC_EXPECT(StringPtr(allocator.getName()) == name);
+    }
+  }
+}
+
+ZC_TEST("HeapAllocators honor size and alignment") {
+  Vector<HeapAllocator*> allocators;
+  allocators.add(&getSystemHeapAllocator());
+  allocators.add(&getThreadCachingHeapAllocator());
+  ZC_IF_SOME(allocator, getJemallocHeapAllocator()) { allocators.add(&allocator); }
+  ZC_IF_SOME(allocator, getMimallocHeapAllocator()) { allocators.add(&allocator); }
+
+  for (HeapAllocator* allocator : allocators) {
+    for (size_t size : {0, 1, 16, 17, 1000, 1024, 1025, 100000}) {
+      for (size_t alignment : {1, 8, 16, 64, 4096}) {
+        byte* bytes = reinterpret_cast<byte*>(allocator->allocate(size, alignment));
+        ZC_EXPECT(reinterpret_cast<uintptr_t>(bytes) % alignment == 0, allocator->getName(),
+                  size, alignment);
+        memset(bytes, 0xab, size);
+        allocator->deallocate(bytes, size, alignment);
+      }
+    }
+  }
+}
+
+ZC_TEST("thread-caching HeapAllocator reuses blocks of the same size class") {
+  HeapAllocator& allocator = getThreadCachingHeapAllocator();
+
+  void* first = allocator.allocate(40, 8);
+  allocator.deallocate(first, 40, 8);
+  // 33 to 64 bytes share a class, so the block comes straight back.
+  void* second = allocator.allocate(64, 16);
+  ZC_EXPECT(second == first);
+  allocator.deallocate(second, 64, 16);
+
+  // A smaller class doesn't see it.
+  void* small = allocator.allocate(16, 8);
+  ZC_EXPECT(small != first);
+  allocator.deallocate(small, 16, 8);
+
+  // Blocks disposed on another thread join that thread's freelist.
+  void* crossThread = allocator.allocate(200, 8);
+  void* reused = nullptr;
+  Thread([&]() {
+    allocator.deallocate(crossThread, 200, 8);
+    reused = allocator.allocate(200, 8);
+    allocator.deallocate(reused, 200, 8);
+  });
+  ZC_EXPECT(reused == crossThread);
+}
+
+ZC_TEST("setHeapAllocator only works before the allocator is chosen") {
+  // The test runner has allocated by now, so the allocator is already chosen.
+  HeapAllocator& current = getHeapAllocator();
+  setHeapAllocator(current);
+  HeapAllocator& other = &current == &getSystemHeapAllocator() ? getThreadCachingHeapAllocator()
+                                                                : getSystemHeapAllocator();
+  ZC_EXPECT_THROW_MESSAGE("after a heap allocator was chosen", setHeapAllocator(other));
+  ZC_EXPECT(&getHeapAllocator() == &current);
+
+#if ZC_HEAP_ALLOCATOR
+  // zc::heap() and heap arrays go through it.
+  Own<int> object = heap<int>(1);
+  Array<String> strings = heapArray<String>(3);
+  strings[2] = heapString("a string long enough to allocate");
+  ZC_EXPECT(*object == 1);
+#endif  // ZC_HEAP_ALLOCATOR
+}
+
+void heapAllocatorBenchmark(HeapAllocator& allocator) {
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ROUNDS = 1000;
+#else
+  constexpr uint ROUNDS = 100000;
+#endif
+  // Small, short-lived objects of a few sizes, like AST nodes and string pieces.
+  constexpr size_t SIZES[] = {16, 24, 48, 64, 120, 200, 32, 512};
+  void* blocks[zc::size(SIZES)];
+  for (uint round = 0; round < ROUNDS; round++) {
+    for (uint i = 0; i < zc::size(SIZES); i++) { blocks[i] = allocator.allocate(SIZES[i], 8); }
+    for (uint i = 0; i < zc::size(SIZES); i++) { allocator.deallocate(blocks[i], SIZES[i], 8); }
+  }
+}
+
+ZC_TEST("benchmark: system HeapAllocator") { heapAllocatorBenchmark(getSystemHeapAllocator()); }
+
+ZC_TEST("benchmark: thread-caching HeapAllocator") {
+  heapAllocatorBenchmark(getThreadCachingHeapAllocator());
+}
+
 #if ZC_ASSERT_PTR_COUNTERS
 ZC_TEST("zc::Pin<T> destroyed with active ptrs crashed") {
   PtrHolder* holder = nullptr;
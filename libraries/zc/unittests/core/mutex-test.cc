@@ -33,6 +33,7 @@
 #include "zc/core/debug.h"
 #include "zc/core/mutex.h"
 #include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/gtest.h"
 
 #if _WIN32
@@ -617,6 +618,163 @@ ZC_TEST("condvar wait with flapping predicate") {
   }
 }
 
+ZC_TEST("adaptive spinning MutexGuarded") {
+  constexpr uint THREADS = 4;
+  constexpr uint ITERATIONS = 10000;
+
+  MutexGuarded<uint> guarded(0);
+  guarded.setAdaptiveSpinning();
+
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(THREADS);
+    for (uint t = 0; t < THREADS; t++) {
+      threads.add(heap<Thread>([&, t]() {
+        for (uint i = 0; i < ITERATIONS; i++) {
+          if (i % 4 == t % 4) {
+            // Mix in some readers, which are counted differently while they wait.
+            ZC_ASSERT(*guarded.lockShared() <= THREADS * ITERATIONS);
+          }
+          ++*guarded.lockExclusive();
+        }
+      }));
+    }
+  }
+
+  ZC_EXPECT(*guarded.lockShared() == THREADS * ITERATIONS);
+
+  // Turning it back off works too.
+  guarded.setAdaptiveSpinning(false);
+  ++*guarded.lockExclusive();
+  ZC_EXPECT(*guarded.lockShared() == THREADS * ITERATIONS + 1);
+}
+
+void contendedMutexBenchmark(bool adaptiveSpinning) {
+  // Four threads hammering a lock protecting a trivially short critical section, which is the
+  // case adaptive spinning is meant for.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ITERATIONS = 10000;
+#else
+  constexpr uint ITERATIONS = 1000000;
+#endif
+
+  MutexGuarded<uint64_t> counter(0);
+  counter.setAdaptiveSpinning(adaptiveSpinning);
+
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(4);
+    for (uint t = 0; t < 4; t++) {
+      threads.add(heap<Thread>([&]() {
+        for (uint i = 0; i < ITERATIONS; i++) { ++*counter.lockExclusive(); }
+      }));
+    }
+  }
+
+  ZC_EXPECT(*counter.lockShared() == 4 * ITERATIONS);
+}
+
+ZC_TEST("benchmark: contended MutexGuarded, sleeping") { contendedMutexBenchmark(false); }
+
+ZC_TEST("benchmark: contended MutexGuarded, adaptive spinning") { contendedMutexBenchmark(true); }
+
+ZC_TEST("ScalableMutexGuarded") {
+  struct Pair {
+    uint a = 0;
+    uint b = 0;
+  };
+
+  ScalableMutexGuarded<Pair> guarded;
+
+  {
+    auto lock = guarded.lockExclusive();
+    lock->a = 1;
+    lock->b = 1;
+
+    // Moving and releasing locks work as with Locked<T>.
+    auto lock2 = zc::mv(lock);
+    ZC_EXPECT(lock.get() == nullptr);
+    ZC_EXPECT(lock2->a == 1);
+    lock2.release();
+  }
+
+  {
+    // Shared locks can be held simultaneously.
+    auto shared1 = guarded.lockShared();
+    auto shared2 = guarded.lockShared();
+    ZC_EXPECT(shared1->a == 1);
+    ZC_EXPECT(shared2->b == 1);
+  }
+
+  // Writers keep `a` and `b` equal; readers must never see them differ, no matter which path
+  // their lock took.
+  constexpr uint READERS = 4;
+  constexpr uint WRITES = 1000;
+  bool done = false;
+
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(READERS + 1);
+    for (uint t = 0; t < READERS; t++) {
+      threads.add(heap<Thread>([&]() {
+        while (!__atomic_load_n(&done, __ATOMIC_RELAXED)) {
+          auto lock = guarded.lockShared();
+          ZC_ASSERT(lock->a == lock->b);
+        }
+      }));
+    }
+    threads.add(heap<Thread>([&]() {
+      for (uint i = 0; i < WRITES; i++) {
+        auto lock = guarded.lockExclusive();
+        ++lock->a;
+        ++lock->b;
+      }
+      __atomic_store_n(&done, true, __ATOMIC_RELAXED);
+    }));
+  }
+
+  auto lock = guarded.lockShared();
+  ZC_EXPECT(lock->a == WRITES + 1);
+  ZC_EXPECT(lock->b == WRITES + 1);
+}
+
+template <typename Guarded>
+void readMostlyBenchmark() {
+  // Four threads taking shared locks on a small table, with an occasional write.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ITERATIONS = 10000;
+#else
+  constexpr uint ITERATIONS = 1000000;
+#endif
+
+  Guarded table;
+  for (uint i = 0; i < 16; i++) { table.lockExclusive()->add(i); }
+
+  {
+    auto threads = heapArrayBuilder<Own<Thread>>(4);
+    for (uint t = 0; t < 4; t++) {
+      threads.add(heap<Thread>([&, t]() {
+        uint sum = 0;
+        for (uint i = 0; i < ITERATIONS; i++) {
+          if (t == 0 && i % 10000 == 0) {
+            (*table.lockExclusive())[i % 16] = i % 16;
+          } else {
+            sum += (*table.lockShared())[i % 16];
+          }
+        }
+        ZC_ASSERT(sum > 0);
+      }));
+    }
+  }
+}
+
+ZC_TEST("benchmark: read-mostly MutexGuarded") {
+  readMostlyBenchmark<MutexGuarded<Vector<uint>>>();
+}
+
+ZC_TEST("benchmark: read-mostly ScalableMutexGuarded") {
+  readMostlyBenchmark<ScalableMutexGuarded<Vector<uint>>>();
+}
+
 #ifdef ZC_CONTENTION_WARNING_THRESHOLD
 ZC_TEST("make sure contended mutex warns") {
   class Expectation final : public ExceptionCallback {
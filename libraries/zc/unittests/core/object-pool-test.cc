@@ -0,0 +1,131 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/object-pool.h"
+
+#include "zc/core/mutex.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+struct Node {
+  uint& live;
+  uint value;
+  Node* next = nullptr;
+
+  Node(uint& live, uint value) : live(live), value(value) { ++live; }
+  ~Node() noexcept(false) { --live; }
+};
+
+ZC_TEST("ObjectPool reuses slots") {
+  uint live = 0;
+  ObjectPool<Node> pool(4);
+
+  {
+    Vector<Own<Node>> nodes;
+    for (uint i = 0; i < 10; i++) nodes.add(pool.allocate(live, i));
+    ZC_EXPECT(live == 10);
+    ZC_EXPECT(pool.getSlabCount() == 3);
+    for (uint i = 0; i < 10; i++) ZC_EXPECT(nodes[i]->value == i);
+  }
+  ZC_EXPECT(live == 0);
+
+  // Freed slots are used again before any new slab is allocated.
+  for (uint round = 0; round < 100; round++) {
+    Vector<Own<Node>> nodes;
+    for (uint i = 0; i < 10; i++) nodes.add(pool.allocate(live, i));
+  }
+  ZC_EXPECT(pool.getSlabCount() == 3);
+  ZC_EXPECT(live == 0);
+}
+
+struct alignas(64) Aligned {
+  byte data[3];
+};
+
+ZC_TEST("ObjectPool respects alignment") {
+  ObjectPool<Aligned> pool(3);
+  Vector<Own<Aligned>> objects;
+  for (uint i = 0; i < 7; i++) {
+    objects.add(pool.allocate());
+    ZC_EXPECT(reinterpret_cast<uintptr_t>(objects.back().get()) % 64 == 0);
+  }
+}
+
+struct Throws {
+  explicit Throws(bool fail) {
+    if (fail) ZC_FAIL_REQUIRE("constructor failed");
+  }
+};
+
+ZC_TEST("ObjectPool takes back the slot when the constructor throws") {
+  ObjectPool<Throws> pool(1);
+  ZC_EXPECT_THROW_MESSAGE("constructor failed", pool.allocate(true));
+  auto object = pool.allocate(false);
+  ZC_EXPECT(pool.getSlabCount() == 1);
+}
+
+ZC_TEST("ObjectPool objects may be freed on another thread") {
+  uint live = 0;
+  ObjectPool<Node> pool(8);
+
+  struct Handoff {
+    Vector<Own<Node>> nodes;
+    uint freed = 0;
+  };
+  MutexGuarded<Handoff> handoff;
+
+  // One thread allocates, another frees. Slots migrate from the freeing thread's free list back
+  // to the allocating thread's through the shared free list, so the pool stops growing once the
+  // number of objects in flight stops growing.
+  constexpr uint ROUNDS = 100;
+  constexpr uint PER_ROUND = 100;
+  {
+    Thread consumer([&]() {
+      for (uint freed = 0; freed < ROUNDS * PER_ROUND;) {
+        Vector<Own<Node>> batch = handoff.when(
+            [](const Handoff& h) { return !h.nodes.empty(); },
+            [](Handoff& h) { return zc::mv(h.nodes); });
+        freed += batch.size();
+        batch.clear();
+        handoff.lockExclusive()->freed = freed;
+      }
+    });
+
+    for (uint round = 1; round <= ROUNDS; round++) {
+      for (uint i = 0; i < PER_ROUND; i++) {
+        auto node = pool.allocate(live, i);
+        handoff.lockExclusive()->nodes.add(zc::mv(node));
+      }
+      handoff.when([&](const Handoff& h) { return h.freed == round * PER_ROUND; },
+                   [](Handoff&) {});
+    }
+  }
+
+  ZC_EXPECT(live == 0);
+  ZC_EXPECT(pool.getSlabCount() < 2 * PER_ROUND / 8, pool.getSlabCount());
+}
+
+}  // namespace
+}  // namespace zc
@@ -240,6 +240,48 @@ ZC_TEST("OneOf stringification") {
   }
 }
 
+struct Describe {
+  String operator()(int i) { return str("int ", i); }
+  String operator()(const String& s) { return str("string ", s); }
+  String operator()(String&& s) { return str("moved string ", s); }
+};
+
+ZC_TEST("OneOf::visit()") {
+  OneOf<int, String> value = 123;
+  ZC_EXPECT(value.visit(Describe()) == "int 123");
+
+  value = str("foo");
+  ZC_EXPECT(value.visit(Describe()) == "string foo");
+  ZC_EXPECT(zc::mv(value).visit(Describe()) == "moved string foo");
+
+  const OneOf<int, String>& constValue = value;
+  ZC_EXPECT(constValue.visit([](auto& v) { return sizeof(v); }) == sizeof(String));
+
+  // Visitors may modify the value.
+  value = 5;
+  value.visit([](auto& v) {
+    if constexpr (isSameType<Decay<decltype(v)>, int>()) v *= 2;
+  });
+  ZC_EXPECT(value.get<int>() == 10);
+
+  OneOf<int, float> number = 1.5f;
+  void* address = number.visit([](auto& v) -> void* { return &v; });
+  ZC_EXPECT(address == &number.get<float>());
+}
+
+ZC_TEST("OneOf of trivially copyable types is trivially copyable") {
+  static_assert(__is_trivially_copyable(OneOf<int, float, const char*>));
+  static_assert(canMemcpy<OneOf<int, float>>());
+  static_assert(!canMemcpy<OneOf<int, String>>());
+
+  OneOf<int, float> a = 1.5f;
+  OneOf<int, float> b = a;
+  OneOf<int, float> c;
+  c = b;
+  ZC_EXPECT(c.is<float>());
+  ZC_EXPECT(c.get<float>() == 1.5f);
+}
+
 template <unsigned int N>
 struct T {
   unsigned int n = N;
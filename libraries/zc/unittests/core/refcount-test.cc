@@ -21,6 +21,7 @@
 
 #include "zc/core/refcount.h"
 
+#include "zc/core/thread.h"
 #include "zc/ztest/gtest.h"
 
 namespace zc {
@@ -415,6 +416,67 @@ ZC_TEST("atomicAddRefWeak") {
   ZC_EXPECT(b);  // Now object is destroyed
 }
 
+ZC_TEST("biasedArc") {
+  bool b = false;
+
+  auto ref1 = zc::biasedArc<AtomicSetTrueInDestructor>(&b);
+  EXPECT_FALSE(ref1->isShared());
+  auto ref2 = ref1.addRef();
+  auto ref3 = ref1->newRef();
+  EXPECT_TRUE(ref1->isShared());
+
+  ZC_IF_SOME(weak, zc::atomicAddRefWeak(*ref1.get())) { EXPECT_TRUE(weak->isShared()); }
+  else {
+    ZC_FAIL_EXPECT("weak ref failed");
+  }
+
+  ref2 = nullptr;
+  ref3 = nullptr;
+  EXPECT_FALSE(ref1->isShared());
+
+  // After unbias(), references can go to other threads and be dropped there.
+  ref1->unbias();
+  ref1->unbias();  // no-op
+  {
+    auto ref4 = ref1.addRef();
+    Thread thread([&]() {
+      for (uint i = 0; i < 1000; i++) { auto ref5 = ref4.addRef(); }
+      ref4 = nullptr;
+    });
+  }
+
+  EXPECT_FALSE(ref1->isShared());
+  EXPECT_FALSE(b);
+  ref1 = nullptr;
+  EXPECT_TRUE(b);
+}
+
+void refcountBenchmark(zc::Arc<AtomicSetTrueInDestructor> ref) {
+  // Taking and dropping references on one thread, as a typical single-threaded user of a
+  // potentially shared object does.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+  constexpr uint ITERATIONS = 100000;
+#else
+  constexpr uint ITERATIONS = 10000000;
+#endif
+
+  for (uint i = 0; i < ITERATIONS; i++) {
+    auto copy = ref.addRef();
+    ZC_ASSERT(copy->isShared());
+  }
+}
+
+ZC_TEST("benchmark: Arc refcounting on one thread") {
+  bool b = false;
+  refcountBenchmark(zc::arc<AtomicSetTrueInDestructor>(&b));
+}
+
+ZC_TEST("benchmark: biased Arc refcounting on one thread") {
+  bool b = false;
+  refcountBenchmark(zc::biasedArc<AtomicSetTrueInDestructor>(&b));
+}
+
 ZC_TEST("RefcountedWrapper edge cases") {
   // Test with primitive type
   {
@@ -21,11 +21,13 @@
 
 #include "zc/core/string.h"
 
+#include <float.h>
 #include <locale.h>
 #include <stdint.h>
 
 #include <string>
 
+#include "zc/core/hash.h"
 #include "zc/core/vector.h"
 #include "zc/ztest/gtest.h"
 
@@ -327,6 +329,89 @@ ZC_TEST("zc::delimited() and zc::strPreallocated()") {
   }
 }
 
+ZC_TEST("zc::strInto()") {
+  int rawArray[] = {1, 23, 456, 78};
+  ArrayPtr<int> array = rawArray;
+
+  char buffer[16];
+  auto text = strInto(buffer, delimited(array, "::"), 'x');
+  ZC_EXPECT(text == "1::23::456::78x"_zc.asArray());
+  ZC_EXPECT(text.begin() == buffer);
+
+  // Exactly full is fine; no room is kept for a NUL terminator.
+  ZC_EXPECT(strInto(buffer, "0123456789", -12345) == "0123456789-12345"_zc.asArray());
+
+  ZC_EXPECT_THROW_MESSAGE("buffer too small", strInto(buffer, "0123456789", 1234567));
+}
+
+ZC_TEST("integer stringification") {
+  ZC_EXPECT(str(0) == "0");
+  ZC_EXPECT(str(7) == "7");
+  ZC_EXPECT(str(10) == "10");
+  ZC_EXPECT(str(99) == "99");
+  ZC_EXPECT(str(100) == "100");
+  ZC_EXPECT(str(-1) == "-1");
+  ZC_EXPECT(str(-10) == "-10");
+  ZC_EXPECT(str(-100) == "-100");
+  ZC_EXPECT(str(1000000007) == "1000000007");
+  ZC_EXPECT(str((unsigned char)255) == "255");
+  ZC_EXPECT(str((unsigned short)65535) == "65535");
+  ZC_EXPECT(str(4294967295u) == "4294967295");
+  ZC_EXPECT(str(18446744073709551615ull) == "18446744073709551615");
+  ZC_EXPECT(str((long long)9223372036854775807ll) == "9223372036854775807");
+
+  // Every number of digits, and the digit pairs either side of each power of ten.
+  for (uint64_t power = 1; power <= 1000000000000000000ull; power *= 10) {
+    for (uint64_t n : {power - 1, power, power + 1, power * 9 + 1}) {
+      ZC_EXPECT(str(n) == std::to_string(n).c_str(), n);
+      ZC_EXPECT(str(-(long long)n) == std::to_string(-(long long)n).c_str(), n);
+    }
+  }
+}
+
+ZC_TEST("floating-point stringification is shortest round-trip") {
+  // Same layout as printf("%g"), with no '+' in exponents.
+  ZC_EXPECT(str(0.0) == "0");
+  ZC_EXPECT(str(-0.0) == "-0");
+  ZC_EXPECT(str(1.0) == "1");
+  ZC_EXPECT(str(100.0) == "100");
+  ZC_EXPECT(str(0.0001) == "0.0001");
+  ZC_EXPECT(str(0.00001) == "1e-05");
+  ZC_EXPECT(str(1e14) == "100000000000000");
+  ZC_EXPECT(str(1e15) == "1e15");
+  ZC_EXPECT(str(1e100) == "1e100");
+  ZC_EXPECT(str(-1.5e-300) == "-1.5e-300");
+  ZC_EXPECT(str(123.456) == "123.456");
+  ZC_EXPECT(str(1e6f) == "1e06");
+  ZC_EXPECT(str(123456.0f) == "123456");
+  ZC_EXPECT(str(inf()) == "inf");
+  ZC_EXPECT(str(-inf()) == "-inf");
+  ZC_EXPECT(str(nan()) == "nan");
+
+  // No more digits than needed to read back the same value.
+  ZC_EXPECT(str(0.1 + 0.2) == "0.30000000000000004");
+  ZC_EXPECT(str(1.0 / 3) == "0.3333333333333333");
+  ZC_EXPECT(str(0.1f) == "0.1");
+  ZC_EXPECT(str(DBL_MAX) == "1.7976931348623157e308");
+  ZC_EXPECT(str(DBL_TRUE_MIN) == "5e-324");
+  ZC_EXPECT(str(FLT_MAX) == "3.4028235e38");
+
+  uint64_t state = 1;
+  for (uint i = 0; i < 10000; i++) {
+    state = state * 6364136223846793005ull + 1442695040888963407ull;
+    double d;
+    memcpy(&d, &state, sizeof(d));
+    if (isNaN(d)) continue;
+    ZC_EXPECT(str(d).parseAs<double>() == d, d);
+
+    float f;
+    uint32_t bits = state >> 32;
+    memcpy(&f, &bits, sizeof(f));
+    if (isNaN(f)) continue;
+    ZC_EXPECT(str(f).parseAs<float>() == f, f);
+  }
+}
+
 ZC_TEST("parsing 'nan' returns canonical NaN value") {
   // There are many representations of NaN. We would prefer that parsing "NaN" produces exactly the
   // same bits that zc::nan() returns.
@@ -456,6 +541,79 @@ ZC_TEST("ConstString attachment lifetimes") {
   ZC_EXPECT(destroyed3 == 3, destroyed3);
 }
 
+ZC_TEST("SmallString") {
+  SmallString<> empty;
+  ZC_EXPECT(empty == nullptr);
+  ZC_EXPECT(empty.size() == 0);
+  ZC_EXPECT(empty.cStr()[0] == '\0');
+  static_assert(sizeof(SmallString<>) == 32);
+
+  SmallString<> name("identifier"_zc);
+  ZC_EXPECT(name.isInline());
+  ZC_EXPECT(name == "identifier");
+  ZC_EXPECT(name.size() == 10);
+  ZC_EXPECT(name.cStr()[10] == '\0');
+  ZC_EXPECT(name.startsWith("ident"));
+  ZC_EXPECT(name.slice(5) == "ifier");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(name.findFirst('i')) == 0);
+  ZC_EXPECT(str(name, "!") == "identifier!");
+  ZC_EXPECT(hashCode(name) == hashCode("identifier"_zc));
+
+  SmallString<> exact("exactly15chars."_zc);
+  ZC_EXPECT(exact.isInline());
+  SmallString<> longer("a rather longer value"_zc);
+  ZC_EXPECT(!longer.isInline());
+  ZC_EXPECT(longer == "a rather longer value");
+  ZC_EXPECT(longer.cStr()[longer.size()] == '\0');
+  ZC_EXPECT(longer < name);
+
+  StringPtr ptr = longer;
+  const char* heapChars = longer.begin();
+  SmallString<> moved = zc::mv(longer);
+  ZC_EXPECT(moved.begin() == heapChars);
+  ZC_EXPECT(moved == ptr);
+  ZC_EXPECT(longer == nullptr);
+
+  moved = zc::mv(name);
+  ZC_EXPECT(moved.isInline());
+  ZC_EXPECT(moved == "identifier");
+  ZC_EXPECT(moved.begin() != name.begin());
+
+  SmallString<4> tiny("abcd"_zc);
+  ZC_EXPECT(tiny.isInline());
+  ArrayPtr<const char> chars = tiny;
+  ZC_EXPECT(chars.size() == 4);
+}
+
+// -----------------------------------------------------------------------------
+// Short identifiers, as most of a program's names are.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+static constexpr uint BENCHMARK_STRINGS = 1 << 14;
+#else
+static constexpr uint BENCHMARK_STRINGS = 1 << 22;
+#endif
+static constexpr StringPtr BENCHMARK_NAMES[] = {"i"_zc, "node"_zc, "value"_zc, "scopeName"_zc,
+                                                "Content-Type"_zc};
+
+template <typename Make>
+void copyShortStrings(Make&& make) {
+  size_t total = 0;
+  for (uint i = 0; i < BENCHMARK_STRINGS; i++) {
+    auto copy = make(BENCHMARK_NAMES[i % zc::size(BENCHMARK_NAMES)]);
+    total += copy.size();
+  }
+  ZC_EXPECT(total != 0);
+}
+
+ZC_TEST("benchmark: String of short identifiers") {
+  copyShortStrings([](StringPtr name) { return heapString(name); });
+}
+
+ZC_TEST("benchmark: SmallString of short identifiers") {
+  copyShortStrings([](StringPtr name) { return SmallString<>(name); });
+}
+
 ZC_TEST("StringPtr find") {
   // Empty string doesn't find anything
   StringPtr empty("");
@@ -58,6 +58,38 @@ TEST(StringTree, DelimitedArray) {
   EXPECT_EQ("foo, bar, baz, qux", StringTree(zc::mv(arr), ", ").flatten());
 }
 
+TEST(StringTree, FlattenRvalue) {
+  String text = str("foobar");
+  const char* chars = text.begin();
+  StringTree leaf(zc::mv(text));
+  // A tree without branches gives up its text rather than copying it.
+  String flat = zc::mv(leaf).flatten();
+  EXPECT_EQ("foobar", flat);
+  EXPECT_EQ(chars, flat.begin());
+
+  StringTree branched = strTree("foo", str("bar"));
+  EXPECT_EQ("foobar", zc::mv(branched).flatten());
+}
+
+TEST(StringTree, AsIoVec) {
+  String bar = str("bar");
+  const char* barChars = bar.begin();
+  StringTree tree = strTree("foo", zc::mv(bar), strTree("baz", str("qux")), "!");
+  EXPECT_EQ(5u, tree.pieceCount());
+
+  Array<ArrayPtr<const byte>> pieces = tree.asIoVec();
+  ASSERT_EQ(5u, pieces.size());
+  // The pieces point into the tree.
+  EXPECT_EQ(reinterpret_cast<const byte*>(barChars), pieces[1].begin());
+
+  String joined;
+  for (auto piece : pieces) { joined = str(joined, piece.asChars()); }
+  EXPECT_EQ(tree.flatten(), joined);
+
+  EXPECT_EQ(0u, StringTree().pieceCount());
+  EXPECT_EQ(0u, StringTree().asIoVec().size());
+}
+
 }  // namespace
 }  // namespace _
 }  // namespace zc
@@ -284,6 +284,96 @@ ZC_TEST("HashIndex with many erasures doesn't keep growing") {
   ZC_ASSERT(index.capacity() < 10);
 }
 
+ZC_TEST("FlatHashIndex") {
+  Table<StringPtr, FlatHashIndex<StringHasher>> table;
+
+  ZC_EXPECT(table.find("foo") == zc::none);
+  ZC_EXPECT(table.insert("foo") == "foo");
+  ZC_EXPECT(table.insert("bar") == "bar");
+  ZC_EXPECT(table.insert("baz") == "baz");
+  ZC_EXPECT(table.size() == 3);
+
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table.find("foo")) == "foo");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table.find("bar")) == "bar");
+  ZC_EXPECT(table.find("fop") == zc::none);
+
+  // Erasing moves the last row into the erased one's place, which the index has to follow.
+  ZC_EXPECT(table.eraseMatch("foo"));
+  ZC_EXPECT(table.size() == 2);
+  ZC_EXPECT(table.find("foo") == zc::none);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table.find("baz")) == "baz");
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.find("baz")) == table.begin());
+
+  ZC_EXPECT_THROW_MESSAGE("inserted row already exists in table", table.insert("bar"));
+
+  table.clear();
+  ZC_EXPECT(table.find("bar") == zc::none);
+  ZC_EXPECT(table.insert("bar") == "bar");
+}
+
+ZC_TEST("FlatHashIndex when hash is always same") {
+  // Every row has the same tag and wants the same group, so groups fill up and searches move on
+  // to the next ones.
+  Table<StringPtr, FlatHashIndex<BadHasher>> table;
+
+  zc::Vector<String> strings;
+  for (uint i : zc::zeroTo(100)) { strings.add(zc::str(i)); }
+  for (auto& s : strings) { table.insert(s); }
+  ZC_EXPECT(table.size() == 100);
+  for (auto& s : strings) { ZC_EXPECT(ZC_ASSERT_NONNULL(table.find(s)) == s); }
+  ZC_EXPECT(table.find("100") == zc::none);
+
+  for (uint i : zc::zeroTo(100)) {
+    if (i % 3 == 0) { ZC_EXPECT(table.eraseMatch(strings[i])); }
+  }
+  for (uint i : zc::zeroTo(100)) {
+    if (i % 3 == 0) {
+      ZC_EXPECT(table.find(strings[i]) == zc::none);
+    } else {
+      ZC_EXPECT(ZC_ASSERT_NONNULL(table.find(strings[i])) == strings[i]);
+    }
+  }
+}
+
+ZC_TEST("FlatHashIndex with many erasures doesn't keep growing") {
+  FlatHashIndex<IntHasher> index;
+
+  zc::ArrayPtr<uint> rows = nullptr;
+
+  for (uint i : zc::zeroTo(1000000)) {
+    ZC_ASSERT(index.insert(rows, 0, i) == zc::none);
+    index.erase(rows, 0, i);
+  }
+
+  ZC_ASSERT(index.capacity() <= 16);
+}
+
+ZC_TEST("FlatHashIndex matches HashIndex") {
+  // Random inserts and erasures, checked against the linear-probing index.
+  Table<uint, FlatHashIndex<IntHasher>> flat;
+  Table<uint, HashIndex<IntHasher>> reference;
+
+  uint state = 12345;
+  auto next = [&]() {
+    state = state * 1103515245 + 12345;
+    return (state >> 8) % 4096;
+  };
+
+  for (uint i : zc::zeroTo(MEDIUM_PRIME * 4)) {
+    uint value = next();
+    if (i % 3 == 2) {
+      ZC_ASSERT(flat.eraseMatch(value) == reference.eraseMatch(value));
+    } else {
+      flat.upsert(value, [](uint&, uint&&) {});
+      reference.upsert(value, [](uint&, uint&&) {});
+    }
+    ZC_ASSERT(flat.size() == reference.size());
+  }
+  for (uint value : zc::zeroTo(4096)) {
+    ZC_ASSERT((flat.find(value) == zc::none) == (reference.find(value) == zc::none), value);
+  }
+}
+
 struct SiPair {
   zc::StringPtr str;
   uint i;
@@ -491,6 +581,75 @@ ZC_TEST("benchmark: zc::Table<StringPtr, HashIndex>") {
   }
 }
 
+ZC_TEST("benchmark: zc::Table<uint, FlatHashIndex>") {
+  constexpr uint SOME_PRIME = BIG_PRIME;
+  constexpr uint STEP[] = {1, 2, 4, 7, 43, 127};
+
+  for (auto step : STEP) {
+    ZC_CONTEXT(step);
+    Table<uint, FlatHashIndex<UintHasher>> table;
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      uint j = (i * step) % SOME_PRIME;
+      table.insert(j * 5 + 123);
+    }
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      uint value = ZC_ASSERT_NONNULL(table.find(i * 5 + 123));
+      ZC_ASSERT(value == i * 5 + 123);
+      ZC_ASSERT(table.find(i * 5 + 122) == zc::none);
+      ZC_ASSERT(table.find(i * 5 + 124) == zc::none);
+    }
+
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      if (i % 2 == 0 || i % 7 == 0) { table.erase(ZC_ASSERT_NONNULL(table.find(i * 5 + 123))); }
+    }
+
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      if (i % 2 == 0 || i % 7 == 0) {
+        // erased
+        ZC_ASSERT(table.find(i * 5 + 123) == zc::none);
+      } else {
+        uint value = ZC_ASSERT_NONNULL(table.find(i * 5 + 123));
+        ZC_ASSERT(value == i * 5 + 123);
+      }
+    }
+  }
+}
+
+ZC_TEST("benchmark: zc::Table<StringPtr, FlatHashIndex>") {
+  constexpr uint SOME_PRIME = BIG_PRIME;
+  constexpr uint STEP[] = {1, 2, 4, 7, 43, 127};
+
+  zc::Vector<String> strings(SOME_PRIME);
+  for (uint i : zc::zeroTo(SOME_PRIME)) { strings.add(zc::str(i * 5 + 123)); }
+
+  for (auto step : STEP) {
+    ZC_CONTEXT(step);
+    Table<StringPtr, FlatHashIndex<StringHasher>> table;
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      uint j = (i * step) % SOME_PRIME;
+      table.insert(strings[j]);
+    }
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      StringPtr value = ZC_ASSERT_NONNULL(table.find(strings[i]));
+      ZC_ASSERT(value == strings[i]);
+    }
+
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      if (i % 2 == 0 || i % 7 == 0) { table.erase(ZC_ASSERT_NONNULL(table.find(strings[i]))); }
+    }
+
+    for (uint i : zc::zeroTo(SOME_PRIME)) {
+      if (i % 2 == 0 || i % 7 == 0) {
+        // erased
+        ZC_ASSERT(table.find(strings[i]) == zc::none);
+      } else {
+        StringPtr value = ZC_ASSERT_NONNULL(table.find(strings[i]));
+        ZC_ASSERT(value == strings[i]);
+      }
+    }
+  }
+}
+
 struct StlStringHash {
   inline size_t operator()(StringPtr str) const { return zc::hashCode(str); }
 };
@@ -939,6 +1098,58 @@ ZC_TEST("TreeIndex clear() leaves tree in valid state") {
   for (uint i = 0; i < 29; ++i) { ZC_EXPECT(table.find(i) != zc::none); }
 }
 
+ZC_TEST("TreeIndex bulkInsert() of sorted rows") {
+  for (uint size : {0u, 1u, 13u, 14u, 15u, 28u, 29u, 113u, 1000u, MEDIUM_PRIME}) {
+    ZC_CONTEXT(size);
+    Vector<uint> rows;
+    for (uint i : zc::zeroTo(size)) { rows.add(i * 5 + 123); }
+
+    Table<uint, TreeIndex<UintCompare>> table;
+    table.bulkInsert(rows);
+    ZC_ASSERT(table.size() == size);
+    table.verify();
+
+    for (uint i : zc::zeroTo(size)) {
+      uint value = ZC_ASSERT_NONNULL(table.find(i * 5 + 123));
+      ZC_ASSERT(value == i * 5 + 123);
+      ZC_ASSERT(table.find(i * 5 + 124) == zc::none);
+    }
+    {
+      auto range = table.ordered();
+      auto iter = range.begin();
+      for (uint i : zc::zeroTo(size)) { ZC_ASSERT(*iter++ == i * 5 + 123); }
+      ZC_ASSERT(iter == range.end());
+    }
+
+    // The packed tree splits and merges like any other.
+    for (uint i : zc::zeroTo(size)) { table.insert(i * 5 + 124); }
+    table.verify();
+    for (uint i : zc::zeroTo(size)) {
+      if (i % 3 != 0) { table.erase(ZC_ASSERT_NONNULL(table.find(i * 5 + 123))); }
+    }
+    table.verify();
+    ZC_ASSERT(table.size() == size + (size + 2) / 3);
+  }
+}
+
+ZC_TEST("TreeIndex bulkInsert() of unsorted rows, or into a table with rows") {
+  constexpr uint SOME_PRIME = MEDIUM_PRIME;
+  Table<uint, TreeIndex<UintCompare>> table;
+  table.insert(0);
+
+  Vector<uint> rows;
+  for (uint i : zc::zeroTo(SOME_PRIME)) { rows.add((i * 43) % SOME_PRIME + 1); }
+  table.bulkInsert(zc::mv(rows));
+  table.verify();
+  ZC_ASSERT(table.size() == SOME_PRIME + 1);
+  for (uint i : zc::zeroTo(SOME_PRIME + 1)) { ZC_ASSERT(table.find(i) != zc::none); }
+
+  Table<uint, TreeIndex<UintCompare>> unsorted;
+  unsorted.bulkInsert(zc::arr(3u, 1u, 2u));
+  unsorted.verify();
+  ZC_EXPECT(ZC_ASSERT_NONNULL(unsorted.find(2)) == 2);
+}
+
 ZC_TEST("benchmark: zc::Table<uint, TreeIndex>") {
   constexpr uint SOME_PRIME = BIG_PRIME;
   constexpr uint STEP[] = {1, 2, 4, 7, 43, 127};
@@ -974,6 +1185,22 @@ ZC_TEST("benchmark: zc::Table<uint, TreeIndex>") {
   }
 }
 
+ZC_TEST("benchmark: zc::Table<uint, TreeIndex> insertAll() of sorted rows") {
+  Vector<uint> rows;
+  for (uint i : zc::zeroTo(BIG_PRIME * 8)) { rows.add(i * 5 + 123); }
+  Table<uint, TreeIndex<UintCompare>> table;
+  table.insertAll(rows);
+  ZC_ASSERT(table.size() == rows.size());
+}
+
+ZC_TEST("benchmark: zc::Table<uint, TreeIndex> bulkInsert() of sorted rows") {
+  Vector<uint> rows;
+  for (uint i : zc::zeroTo(BIG_PRIME * 8)) { rows.add(i * 5 + 123); }
+  Table<uint, TreeIndex<UintCompare>> table;
+  table.bulkInsert(rows);
+  ZC_ASSERT(table.size() == rows.size());
+}
+
 ZC_TEST("benchmark: std::set<uint>") {
   constexpr uint SOME_PRIME = BIG_PRIME;
   constexpr uint STEP[] = {1, 2, 4, 7, 43, 127};
@@ -1329,6 +1556,31 @@ ZC_TEST("TreeIndex rollback on insertion failure") {
   }
 }
 
+ZC_TEST("Table bulkInsert() is all-or-nothing") {
+  Table<StringPtr, TreeIndex<StringCompare>, HashIndex<StringLengthCompare>> table;
+  table.insert("x"_zc);
+
+  // The second index rejects "cd", having the same length as "ab", after the first index took all
+  // of the rows.
+  ZC_EXPECT_THROW_MESSAGE("inserted row already exists",
+                          table.bulkInsert(zc::arr("ab"_zc, "abc"_zc, "cd"_zc)));
+  ZC_EXPECT(table.size() == 1);
+  table.verify();
+  ZC_EXPECT(table.find("ab"_zc) == zc::none);
+  ZC_EXPECT(table.find<1>(size_t(2)) == zc::none);
+
+  table.bulkInsert(zc::arr("ab"_zc, "abc"_zc));
+  ZC_EXPECT(table.size() == 3);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table.find<1>(size_t(3))) == "abc");
+
+  Table<uint, TreeIndex<UintCompare>> empty;
+  ZC_EXPECT_THROW_MESSAGE("inserted row already exists", empty.bulkInsert(zc::arr(1u, 2u, 2u)));
+  ZC_EXPECT(empty.size() == 0);
+  empty.bulkInsert(zc::arr(1u, 2u));
+  empty.verify();
+  ZC_EXPECT(empty.size() == 2);
+}
+
 }  // namespace
 }  // namespace _
 }  // namespace zc
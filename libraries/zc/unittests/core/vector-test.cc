@@ -0,0 +1,134 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+
+#include "zc/core/vector.h"
+
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace _ {
+namespace {
+
+struct Counted {
+  static int live;
+  int value;
+  Counted(int value) : value(value) { ++live; }
+  Counted(Counted&& other) : value(other.value) { ++live; }
+  Counted& operator=(Counted&& other) = default;
+  ~Counted() { --live; }
+};
+int Counted::live = 0;
+
+ZC_TEST("SmallVector stays inline until it outgrows its inline size") {
+  SmallVector<Own<int>, 3> vec;
+  ZC_EXPECT(vec.empty());
+  ZC_EXPECT(vec.capacity() == 3);
+
+  vec.add(heap(1));
+  vec.add(heap(2));
+  vec.add(heap(3));
+  ZC_EXPECT(vec.isInline());
+  ZC_EXPECT(*vec[2] == 3);
+
+  vec.add(heap(4));
+  ZC_EXPECT(!vec.isInline());
+  ZC_EXPECT(vec.size() == 4);
+  ZC_EXPECT(vec.capacity() == 6);
+  for (auto i : zeroTo(4)) { ZC_EXPECT(*vec[i] == i + 1); }
+
+  vec.truncate(1);
+  ZC_EXPECT(!vec.isInline());
+  ZC_EXPECT(*vec.back() == 1);
+
+  SmallVector<int, 2> ints;
+  ints.addAll(std::initializer_list<int>{1, 2, 3, 4, 5});
+  ZC_EXPECT(ints.asPtr() == arrayPtr<const int>({1, 2, 3, 4, 5}));
+  ArrayPtr<const int> ptr = ints;
+  ZC_EXPECT(ptr.size() == 5);
+
+  auto released = ints.releaseAsArray();
+  ZC_EXPECT(released.size() == 5);
+  ZC_EXPECT(ints.empty());
+  ZC_EXPECT(ints.isInline());
+}
+
+ZC_TEST("SmallVector destroys and moves its inline elements") {
+  {
+    SmallVector<Counted, 4> a;
+    a.add(1);
+    a.add(2);
+    ZC_EXPECT(Counted::live == 2);
+
+    SmallVector<Counted, 4> b = zc::mv(a);
+    ZC_EXPECT(Counted::live == 2);
+    ZC_EXPECT(a.empty());
+    ZC_EXPECT(b.isInline());
+    ZC_EXPECT(b[1].value == 2);
+
+    SmallVector<Counted, 4> c;
+    for (auto i : zeroTo(5)) { c.add(i); }
+    ZC_EXPECT(!c.isInline());
+    const Counted* heapElements = c.begin();
+    b = zc::mv(c);
+    ZC_EXPECT(b.begin() == heapElements);
+    ZC_EXPECT(c.empty());
+    ZC_EXPECT(c.isInline());
+    ZC_EXPECT(Counted::live == 5);
+
+    b.removeLast();
+    ZC_EXPECT(Counted::live == 4);
+    b.clear();
+    ZC_EXPECT(Counted::live == 0);
+    b.add(7);
+  }
+  ZC_EXPECT(Counted::live == 0);
+}
+
+// -----------------------------------------------------------------------------
+// Lists of a few elements, as most of a syntax tree's child lists are.
+
+#if defined(ZC_DEBUG) && !__OPTIMIZE__
+static constexpr uint BENCHMARK_LISTS = 1 << 14;
+#else
+static constexpr uint BENCHMARK_LISTS = 1 << 22;
+#endif
+
+template <typename List>
+void buildTinyLists() {
+  uint64_t sum = 0;
+  for (uint i = 0; i < BENCHMARK_LISTS; i++) {
+    List list;
+    for (uint j = 0; j <= i % 4; j++) { list.add(i + j); }
+    for (uint value : list) { sum += value; }
+  }
+  ZC_EXPECT(sum != 0);
+}
+
+ZC_TEST("benchmark: Vector of 1-4 elements") { buildTinyLists<Vector<uint>>(); }
+
+ZC_TEST("benchmark: SmallVector of 1-4 elements") { buildTinyLists<SmallVector<uint, 4>>(); }
+
+}  // namespace
+}  // namespace _
+}  // namespace zc
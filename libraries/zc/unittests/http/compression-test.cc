@@ -0,0 +1,213 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#if ZC_HAS_ZLIB
+
+#include "zc/http/compression.h"
+
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+class BodyService final : public HttpService {
+  // Responds with `body`, split into pieces of `pieceSize` bytes.
+
+public:
+  explicit BodyService(const HttpHeaderTable& table) : table(table) {}
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, Response& response) override {
+    HttpHeaders responseHeaders(table);
+    responseHeaders.set(HttpHeaderId::CONTENT_TYPE, "text/plain");
+    ZC_IF_SOME(name, extraHeaderName) { responseHeaders.add(name, extraHeaderValue); }
+
+    auto stream = response.send(200, "OK", responseHeaders,
+                                knownSize ? zc::Maybe<uint64_t>(body.size()) : zc::none);
+    zc::Vector<zc::ArrayPtr<const byte>> pieces;
+    for (size_t i = 0; i < body.size(); i += pieceSize) {
+      pieces.add(body.asBytes().slice(i, zc::min(i + pieceSize, body.size())));
+    }
+    auto promise = stream->write(pieces.asPtr());
+    return promise.attach(zc::mv(stream), zc::mv(pieces));
+  }
+
+  const HttpHeaderTable& table;
+  zc::String body;
+  size_t pieceSize = 100;
+  bool knownSize = false;
+  zc::Maybe<zc::StringPtr> extraHeaderName;
+  zc::StringPtr extraHeaderValue;
+};
+
+class CaptureResponse final : public HttpService::Response, public zc::AsyncOutputStream {
+public:
+  explicit CaptureResponse(const HttpHeaderTable& table) : headers(table) {}
+
+  zc::Own<zc::AsyncOutputStream> send(uint statusCode, zc::StringPtr statusText,
+                                      const HttpHeaders& responseHeaders,
+                                      zc::Maybe<uint64_t> expectedBodySize) override {
+    headers = responseHeaders.clone();
+    this->expectedBodySize = expectedBodySize;
+    return zc::Own<zc::AsyncOutputStream>(this, zc::NullDisposer::instance);
+  }
+
+  zc::Own<WebSocket> acceptWebSocket(const HttpHeaders& headers) override {
+    ZC_UNIMPLEMENTED("no WebSockets here");
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const byte> buffer) override {
+    bytes.addAll(buffer);
+    return zc::READY_NOW;
+  }
+
+  zc::Promise<void> write(zc::ArrayPtr<const zc::ArrayPtr<const byte>> pieces) override {
+    for (auto piece : pieces) { bytes.addAll(piece); }
+    return zc::READY_NOW;
+  }
+
+  zc::Promise<void> whenWriteDisconnected() override { return zc::NEVER_DONE; }
+
+  HttpHeaders headers;
+  zc::Maybe<uint64_t> expectedBodySize;
+  zc::Vector<byte> bytes;
+};
+
+struct CompressionTest {
+  zc::AsyncIoContext io = zc::setupAsyncIo();
+  HttpHeaderTable::Builder builder;
+  HttpHeaderId acceptEncoding = builder.add("Accept-Encoding");
+  HttpHeaderId contentEncoding = builder.add("Content-Encoding");
+  HttpHeaderId vary = builder.add("Vary");
+  BodyService inner{builder.getFutureTable()};
+  HttpCompressionService service{inner, builder, {.minSize = 1000}};
+  zc::Own<HttpHeaderTable> table = builder.build();
+
+  zc::Own<CaptureResponse> get(zc::Maybe<zc::StringPtr> accept,
+                               HttpMethod method = HttpMethod::GET) {
+    HttpHeaders headers(*table);
+    ZC_IF_SOME(value, accept) { headers.set(acceptEncoding, value); }
+    auto response = zc::heap<CaptureResponse>(*table);
+    zc::NullStream requestBody;
+    service.request(method, "/", headers, requestBody, *response).wait(io.waitScope);
+    return response;
+  }
+};
+
+zc::String gunzip(zc::ArrayPtr<const byte> bytes) {
+  zc::ArrayInputStream input(bytes);
+  GzipInputStream gzip(input);
+  return gzip.readAllText();
+}
+
+ZC_TEST("HttpCompressionService compresses large responses") {
+  CompressionTest test;
+  test.inner.body = zc::strArray(zc::repeat("compress me "_zc, 500), "");
+
+  // Offered in pieces of unknown total size.
+  {
+    auto response = test.get("deflate, gzip;q=0.8"_zc);
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.contentEncoding)) == "gzip");
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.vary)) == "Accept-Encoding");
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(HttpHeaderId::CONTENT_TYPE)) ==
+              "text/plain");
+    ZC_EXPECT(response->expectedBodySize == zc::none);
+    ZC_EXPECT(response->bytes.size() < test.inner.body.size());
+    ZC_EXPECT(gunzip(response->bytes) == test.inner.body);
+  }
+
+  // Of known size, with an existing Vary header.
+  test.inner.knownSize = true;
+  test.inner.extraHeaderName = "Vary"_zc;
+  test.inner.extraHeaderValue = "Cookie";
+  {
+    auto response = test.get("*;q=0.5, gzip"_zc);
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.vary)) == "Cookie, Accept-Encoding");
+    ZC_EXPECT(response->expectedBodySize == zc::none);
+    ZC_EXPECT(gunzip(response->bytes) == test.inner.body);
+  }
+
+#if ZC_HAS_BROTLI
+  // Brotli wins a tie with gzip.
+  {
+    auto response = test.get("gzip, br"_zc);
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.contentEncoding)) == "br");
+    zc::ArrayInputStream input(response->bytes);
+    BrotliInputStream brotli(input);
+    ZC_EXPECT(brotli.readAllText() == test.inner.body);
+  }
+#endif  // ZC_HAS_BROTLI
+
+#if ZC_HAS_ZSTD
+  // zstd wins a tie with both, but not a higher quality.
+  {
+    auto response = test.get("gzip, br, zstd"_zc);
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.contentEncoding)) == "zstd");
+    zc::ArrayInputStream input(response->bytes);
+    ZstdInputStream zstd(input);
+    ZC_EXPECT(zstd.readAllText() == test.inner.body);
+  }
+  {
+    auto response = test.get("gzip, zstd;q=0.9"_zc);
+    ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.contentEncoding)) == "gzip");
+  }
+#endif  // ZC_HAS_ZSTD
+}
+
+ZC_TEST("HttpCompressionService passes responses through") {
+  CompressionTest test;
+
+  auto expectIdentity = [&](zc::Maybe<zc::StringPtr> accept,
+                            HttpMethod method = HttpMethod::GET) {
+    auto response = test.get(accept, method);
+    ZC_EXPECT(response->bytes.asPtr() == test.inner.body.asBytes());
+    return response;
+  };
+
+  // Small bodies, whether or not their size is known up front. Held back, the body gets a length.
+  test.inner.body = zc::str(zc::repeat('x', 999));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(expectIdentity("gzip"_zc)->expectedBodySize) == 999);
+  test.inner.knownSize = true;
+  ZC_EXPECT(ZC_ASSERT_NONNULL(expectIdentity("gzip"_zc)->expectedBodySize) == 999);
+
+  // Clients that don't accept gzip.
+  test.inner.body = zc::str(zc::repeat('x', 5000));
+  expectIdentity(zc::none);
+  expectIdentity("identity"_zc);
+  expectIdentity("gzip;q=0, deflate"_zc);
+  expectIdentity("*;q=0"_zc);
+  expectIdentity("gzip;q=2"_zc);
+  expectIdentity("gzip"_zc, HttpMethod::HEAD);
+
+  // Responses that mustn't be compressed.
+  test.inner.extraHeaderName = "Content-Encoding"_zc;
+  test.inner.extraHeaderValue = "deflate";
+  auto response = expectIdentity("gzip"_zc);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(response->headers.get(test.contentEncoding)) == "deflate");
+  test.inner.extraHeaderName = "Cache-Control"_zc;
+  test.inner.extraHeaderValue = "public, No-Transform";
+  expectIdentity("gzip"_zc);
+}
+
+}  // namespace
+}  // namespace zc
+
+#endif  // ZC_HAS_ZLIB
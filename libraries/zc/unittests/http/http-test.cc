@@ -129,6 +129,13 @@ ZC_TEST("HttpHeaderTable") {
   ZC_EXPECT(ZC_ASSERT_NONNULL(table->stringToId("foo-BAR")) == fooBar);
   ZC_EXPECT(table->stringToId("foobar") == zc::none);
   ZC_EXPECT(table->stringToId("barfoo") == zc::none);
+
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table->stringToId("SEC-websocket-EXTENSIONS")) ==
+            HttpHeaderId::SEC_WEBSOCKET_EXTENSIONS);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table->stringToId("te")) == HttpHeaderId::TE);
+  ZC_EXPECT(table->stringToId("Hosts") == zc::none);
+  ZC_EXPECT(table->stringToId("Content-Lengtm") == zc::none);
+  ZC_EXPECT(table->stringToId("Content\x0dLength") == zc::none);
 }
 
 ZC_TEST("HttpHeaders::parseRequest") {
@@ -234,6 +241,45 @@ ZC_TEST("HttpHeaders::parseResponse") {
             "\r\n");
 }
 
+ZC_TEST("HttpHeaders parse long lines") {
+  // Long enough that the parser scans most of each line 16 bytes at a time.
+  auto table = HttpHeaderTable::Builder().build();
+  HttpHeaders headers(*table);
+
+  auto text = zc::heapString(
+      "GET /a/rather/long/path/with?a=query&string=that%20goes%20on HTTP/1.1\r\n"
+      "Host: a-long-host-name.subdomain.example.com\r\n"
+      "User-Agent: Mozilla/5.0 (X11; Linux x86_64)\tGecko/20100101 Firefox/128.0\r\n"
+      "X-Unicode: caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9 and then some more text\r\n"
+      "X-Folded: the first part of a value that\r\n"
+      "  goes on to a second line of its own\r\n"
+      "X-Short: ok\r\n"
+      "\r\n");
+  auto result = headers.tryParseRequest(text.asArray()).get<HttpHeaders::Request>();
+
+  ZC_EXPECT(result.method == HttpMethod::GET);
+  ZC_EXPECT(result.url == "/a/rather/long/path/with?a=query&string=that%20goes%20on");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(headers.get(HttpHeaderId::HOST)) ==
+            "a-long-host-name.subdomain.example.com");
+
+  std::map<zc::StringPtr, zc::StringPtr> unpackedHeaders;
+  headers.forEach([&](zc::StringPtr name, zc::StringPtr value) {
+    ZC_EXPECT(unpackedHeaders.insert(std::make_pair(name, value)).second);
+  });
+  ZC_EXPECT(unpackedHeaders.size() == 5);
+  ZC_EXPECT(unpackedHeaders["User-Agent"] ==
+            "Mozilla/5.0 (X11; Linux x86_64)\tGecko/20100101 Firefox/128.0");
+  ZC_EXPECT(unpackedHeaders["X-Unicode"] ==
+            "caf\xc3\xa9 na\xc3\xafve r\xc3\xa9sum\xc3\xa9 and then some more text");
+  ZC_EXPECT(unpackedHeaders["X-Folded"] ==
+            "the first part of a value that    goes on to a second line of its own");
+  ZC_EXPECT(unpackedHeaders["X-Short"] == "ok");
+
+  // Values point into the parsed text rather than being copied out of it.
+  auto host = ZC_ASSERT_NONNULL(headers.get(HttpHeaderId::HOST));
+  ZC_EXPECT(host.begin() > text.begin() && host.end() < text.end());
+}
+
 ZC_TEST("HttpHeaders parse invalid") {
   auto table = HttpHeaderTable::Builder().build();
   HttpHeaders headers(*table);
@@ -1096,6 +1142,83 @@ ZC_TEST("HttpClient canceled write") {
   ZC_EXPECT(text == "POST / HTTP/1.1\r\nContent-Length: 4096\r\n\r\n", text);
 }
 
+ZC_TEST("HttpClient forwards borrowed headers") {
+  ZC_HTTP_TEST_SETUP_IO;
+
+  auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
+
+  auto serverPromise = pipe.ends[1]->readAllText();
+
+  {
+    HttpHeaderTable::Builder builder;
+    auto hVia = builder.add("Via");
+    auto table = builder.build();
+
+    auto received = zc::heapString(
+        "POST /foo HTTP/1.1\r\n"
+        "Host: example.com\r\n"
+        "Content-Length: 3\r\n"
+        "Via: 1.1 first\r\n"
+        "X-Unknown: bar\r\n"
+        "\r\n");
+    HttpHeaders headers(*table);
+    auto request = headers.tryParseRequest(received.asArray()).get<HttpHeaders::Request>();
+
+    auto forwarded = headers.borrow();
+    ZC_EXPECT(forwarded.isBorrowed());
+    ZC_EXPECT(!headers.isBorrowed());
+    ZC_EXPECT(!forwarded.clone().isBorrowed());
+    forwarded.setPtr(hVia, "1.1 first, 1.1 proxy");
+    ZC_EXPECT_THROW_MESSAGE("invalid header value", forwarded.setPtr(hVia, "bad\r\nvalue"));
+
+    // The pieces add up to the same bytes serialization would copy.
+    zc::StringPtr length = "3";
+    zc::StringPtr connectionHeaders[HttpHeaders::CONNECTION_HEADERS_COUNT];
+    connectionHeaders[HttpHeaders::BuiltinIndices::CONTENT_LENGTH] = length;
+    zc::Vector<byte> joined;
+    for (auto piece : forwarded.serializeRequestPieces(request.method, request.url,
+                                                       connectionHeaders)) {
+      joined.addAll(piece);
+    }
+    ZC_EXPECT(joined.asPtr() ==
+              forwarded.serializeRequest(request.method, request.url, connectionHeaders).asBytes());
+
+    auto client = newHttpClient(*table, *pipe.ends[0]);
+    auto req = client->request(request.method, request.url, forwarded, uint64_t(3));
+    req.body->write("baz"_zcb).wait(waitScope);
+    req.body = nullptr;
+
+    zc::StringPtr responseText = "HTTP/1.1 204 No Content\r\n\r\n";
+    pipe.ends[1]->write(responseText.asBytes()).wait(waitScope);
+    auto response = req.response.wait(waitScope);
+    ZC_EXPECT(response.statusCode == 204);
+
+    // Dropping the response before the headers are written breaks the connection rather than
+    // leaving the write to read headers that may be gone.
+    auto pipe2 = ZC_HTTP_TEST_CREATE_2PIPE;
+    auto client2 = newHttpClient(*table, *pipe2.ends[0]);
+    {
+      auto req2 = client2->request(HttpMethod::GET, "/", forwarded);
+      auto ignore ZC_UNUSED = zc::mv(req2.response);
+    }
+    ZC_EXPECT_THROW_MESSAGE(
+        "connection has been closed",
+        client2->request(HttpMethod::GET, "/", HttpHeaders(*table)).response.wait(waitScope));
+  }
+
+  pipe.ends[0]->shutdownWrite();
+  auto text = serverPromise.wait(waitScope);
+  ZC_EXPECT(text ==
+                "POST /foo HTTP/1.1\r\n"
+                "Content-Length: 3\r\n"
+                "Host: example.com\r\n"
+                "Via: 1.1 first, 1.1 proxy\r\n"
+                "X-Unknown: bar\r\n"
+                "\r\n"
+                "baz",
+            text);
+}
+
 ZC_TEST("HttpClient chunked body gather-write") {
   ZC_HTTP_TEST_SETUP_IO;
 
@@ -1129,6 +1252,46 @@ ZC_TEST("HttpClient chunked body gather-write") {
             text);
 }
 
+ZC_TEST("HttpClient chunked body coalesces small writes") {
+  ZC_HTTP_TEST_SETUP_IO;
+
+  auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
+
+  auto serverPromise = pipe.ends[1]->readAllText();
+
+  {
+    HttpHeaderTable table;
+    HttpClientSettings settings;
+    settings.minChunkSize = 8;
+    auto client = newHttpClient(table, *pipe.ends[0], settings);
+
+    auto req = client->request(HttpMethod::POST, "/", HttpHeaders(table));
+
+    // Held back until there are 8 bytes...
+    req.body->write("foo"_zcb).wait(waitScope);
+    req.body->write(" "_zcb).wait(waitScope);
+    req.body->write("bar"_zcb).wait(waitScope);
+    // ...which this makes, so it all goes out in one chunk.
+    zc::ArrayPtr<const byte> bodyParts[] = {" baz"_zcb, " qux"_zcb};
+    req.body->write(zc::arrayPtr(bodyParts, zc::size(bodyParts))).wait(waitScope);
+    // The rest goes out when the body ends.
+    req.body->write("!"_zcb).wait(waitScope);
+    req.body = nullptr;
+
+    zc::StringPtr responseText = "HTTP/1.1 204 No Content\r\n\r\n";
+    pipe.ends[1]->write(responseText.asBytes()).wait(waitScope);
+    auto response = req.response.wait(waitScope);
+  }
+
+  pipe.ends[0]->shutdownWrite();
+
+  auto text = serverPromise.wait(waitScope);
+  ZC_EXPECT(text ==
+                "POST / HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+                "f\r\nfoo bar baz qux\r\n1\r\n!\r\n0\r\n\r\n",
+            text);
+}
+
 ZC_TEST("HttpClient chunked body pump from fixed length stream") {
   class FixedBodyStream final : public zc::AsyncInputStream {
     Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
@@ -1905,6 +2068,103 @@ ZC_TEST("WebSocket compressed fragment") {
 
   clientTask.wait(waitScope);
 }
+
+ZC_TEST("WebSocket compression threshold and shared contexts") {
+  ZC_HTTP_TEST_SETUP_IO;
+  CompressionParameters config{
+      .outboundNoContextTakeover = true,
+      .inboundNoContextTakeover = true,
+      .outboundMaxWindowBits = 15,
+      .inboundMaxWindowBits = 15,
+  };
+  WebSocketCompressionSettings settings{.minMessageSize = 10, .shareContexts = true};
+
+  auto pipe1 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto pipe2 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto pipe3 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto sender1 = newWebSocket(zc::mv(pipe1.ends[0]), zc::none, config, zc::none, settings);
+  auto sender2 = newWebSocket(zc::mv(pipe2.ends[0]), zc::none, config, zc::none, settings);
+  auto receiver = newWebSocket(zc::mv(pipe3.ends[0]), zc::none, config, zc::none, settings);
+
+  auto readFrame = [&](zc::AsyncIoStream& raw) {
+    auto buffer = zc::heapArray<byte>(256);
+    size_t n = raw.tryRead(buffer.begin(), 2, buffer.size()).wait(waitScope);
+    ZC_ASSERT(n == 2 + (buffer[1] & 0x7f));
+    return zc::heapArray(buffer.first(n));
+  };
+
+  // A short message goes out uncompressed.
+  auto shortTask = sender1->send("short"_zc);
+  auto shortFrame = readFrame(*pipe1.ends[1]);
+  shortTask.wait(waitScope);
+  ZC_EXPECT(shortFrame.asPtr() == "\x81\x05short"_zcb);
+
+  // A long one is compressed. Both senders share one context, reset for each message, so they
+  // produce the same bytes.
+  auto text = zc::strArray(zc::repeat("compress me "_zc, 10), "");
+  auto task1 = sender1->send(text);
+  auto frame1 = readFrame(*pipe1.ends[1]);
+  task1.wait(waitScope);
+  auto task2 = sender2->send(text);
+  auto frame2 = readFrame(*pipe2.ends[1]);
+  task2.wait(waitScope);
+  ZC_EXPECT(frame1[0] == 0xc1);  // FIN, RSV1 (compressed) and TEXT
+  ZC_EXPECT(frame1.size() < text.size());
+  ZC_EXPECT(frame1 == frame2);
+
+  // The receiving side decompresses with a shared context too.
+  auto writeTask =
+      pipe3.ends[1]->write(frame1).then([&]() { return pipe3.ends[1]->write(frame2); });
+  for (auto i ZC_UNUSED : zc::zeroTo(2)) {
+    auto message = receiver->receive().wait(waitScope);
+    ZC_ASSERT(message.is<zc::String>());
+    ZC_EXPECT(message.get<zc::String>() == text);
+  }
+  writeTask.wait(waitScope);
+}
+
+ZC_TEST("WebSocket compressed broadcast frame") {
+  ZC_HTTP_TEST_SETUP_IO;
+  CompressionParameters resetting{.outboundNoContextTakeover = true};
+  CompressionParameters takingOver{};
+
+  auto text = zc::strArray(zc::repeat("broadcast "_zc, 10), "");
+  auto frame = WebSocketBroadcastFrame::text(text, resetting);
+
+  auto readFrame = [&](zc::AsyncIoStream& raw) {
+    auto buffer = zc::heapArray<byte>(256);
+    size_t n = raw.tryRead(buffer.begin(), 2, buffer.size()).wait(waitScope);
+    ZC_ASSERT(n == 2 + (buffer[1] & 0x7f));
+    return zc::heapArray(buffer.first(n));
+  };
+
+  // A WebSocket whose compressor resets after every message gets the compressed frame.
+  auto pipe1 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto ws1 = newWebSocket(zc::mv(pipe1.ends[0]), zc::none, resetting);
+  auto task1 = ws1->sendFrame(frame.addRef());
+  auto frame1 = readFrame(*pipe1.ends[1]);
+  task1.wait(waitScope);
+  ZC_EXPECT(frame1[0] == 0xc1);
+  ZC_EXPECT(frame1.asPtr() == frame->getEncoding(resetting).frame);
+
+  // One that takes over context can't use it and sends the message uncompressed.
+  auto pipe2 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto ws2 = newWebSocket(zc::mv(pipe2.ends[0]), zc::none, takingOver);
+  auto task2 = ws2->sendFrame(frame.addRef());
+  auto frame2 = readFrame(*pipe2.ends[1]);
+  task2.wait(waitScope);
+  ZC_EXPECT(frame2[0] == 0x81);
+  ZC_EXPECT(frame2.slice(2) == text.asBytes());
+
+  // The compressed frame decompresses to the message.
+  auto pipe3 = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto receiver = newWebSocket(zc::mv(pipe3.ends[0]), zc::none, CompressionParameters{});
+  auto writeTask = pipe3.ends[1]->write(frame1);
+  auto message = receiver->receive().wait(waitScope);
+  writeTask.wait(waitScope);
+  ZC_ASSERT(message.is<zc::String>());
+  ZC_EXPECT(message.get<zc::String>() == text);
+}
 #endif  // ZC_HAS_ZLIB
 
 class FakeEntropySource final : public EntropySource {
@@ -1943,6 +2203,65 @@ ZC_TEST("WebSocket masked") {
   serverTask.wait(waitScope);
 }
 
+ZC_TEST("WebSocket masked long message") {
+  // Long enough to take every path through the masking code: 16 bytes at a time, then 8, then
+  // one at a time.
+  ZC_HTTP_TEST_SETUP_IO;
+  auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
+  FakeEntropySource maskGenerator;
+
+  auto client = zc::mv(pipe.ends[0]);
+  auto server = newWebSocket(zc::mv(pipe.ends[1]), maskGenerator);
+
+  auto text = "The quick brown fox jumps over the lazy dog. 0123"_zc.first(45);
+  zc::Vector<byte> expected;
+  expected.addAll(std::initializer_list<byte>{0x81, 0x80 | 45, 12, 34, 56, 78});
+  const byte maskBytes[] = {12, 34, 56, 78};
+  for (auto i : zc::indices(text)) expected.add(text[i] ^ maskBytes[i % 4]);
+
+  auto serverTask = server->send(text);
+  expectRead(*client, expected).wait(waitScope);
+  serverTask.wait(waitScope);
+}
+
+ZC_TEST("WebSocket broadcast frame") {
+  ZC_HTTP_TEST_SETUP_IO;
+  auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
+  auto maskedPipe = ZC_HTTP_TEST_CREATE_2PIPE;
+  FakeEntropySource maskGenerator;
+
+  auto server = newWebSocket(zc::mv(pipe.ends[0]), zc::none);
+  auto client = newWebSocket(zc::mv(maskedPipe.ends[0]), maskGenerator);
+
+  auto frame = WebSocketBroadcastFrame::text("hello"_zc);
+  ZC_EXPECT(frame->isText());
+  ZC_EXPECT(frame->getMessage() == "hello"_zcb);
+
+  // Unmasked, the prepared frame goes out as is...
+  {
+    auto sendTask = server->sendFrame(frame.addRef());
+    expectRead(*pipe.ends[1], "\x81\x05hello"_zcb).wait(waitScope);
+    sendTask.wait(waitScope);
+  }
+
+  // ...while masking calls for a copy.
+  {
+    auto sendTask = client->sendFrame(frame.addRef());
+    expectRead(*maskedPipe.ends[1], "\x81\x85\x0c\x22\x38\x4e\x64\x47\x54\x22\x63"_zcb)
+        .wait(waitScope);
+    sendTask.wait(waitScope);
+  }
+
+  // Other WebSockets send the message the usual way.
+  auto wsPipe = newWebSocketPipe();
+  auto binary = WebSocketBroadcastFrame::binary("\x01\x02"_zcb);
+  auto sendTask = wsPipe.ends[0]->sendFrame(zc::mv(binary));
+  auto message = wsPipe.ends[1]->receive().wait(waitScope);
+  sendTask.wait(waitScope);
+  ZC_ASSERT(message.is<zc::Array<byte>>());
+  ZC_EXPECT(message.get<zc::Array<byte>>() == "\x01\x02"_zcb);
+}
+
 class WebSocketErrorCatcher : public WebSocketErrorHandler {
 public:
   zc::Vector<zc::WebSocket::ProtocolError> errors;
@@ -1982,6 +2301,44 @@ void assertContainsWebSocketClose(zc::ArrayPtr<zc::byte> data, uint16_t code,
   }
 }
 
+ZC_TEST("WebSocketSendQueue") {
+  ZC_HTTP_TEST_SETUP_IO;
+
+  auto pipe = newWebSocketPipe();
+  WebSocketSendQueue queue(*pipe.ends[0], {.highWatermark = 8, .lowWatermark = 3});
+
+  // Sends queue up without waiting, until the high watermark is passed.
+  ZC_EXPECT(queue.send(zc::str("foo")));
+  ZC_EXPECT(queue.send(zc::heapArray("bar"_zcb)));
+  ZC_EXPECT(!queue.send(zc::str("bazqux")));
+  ZC_EXPECT(queue.getQueuedBytes() == 12);
+  ZC_EXPECT(queue.getQueuedMessages() == 3);
+
+  auto writable = queue.whenWritable();
+  auto drained = queue.whenDrained();
+  ZC_EXPECT(!writable.poll(waitScope));
+
+  ZC_EXPECT(pipe.ends[1]->receive().wait(waitScope).get<zc::String>() == "foo");
+  ZC_EXPECT(pipe.ends[1]->receive().wait(waitScope).get<zc::Array<byte>>() == "bar"_zcb);
+  ZC_EXPECT(!writable.poll(waitScope));
+  ZC_EXPECT(queue.getQueuedBytes() == 6);
+
+  // The last message drains the queue below the low watermark.
+  ZC_EXPECT(pipe.ends[1]->receive().wait(waitScope).get<zc::String>() == "bazqux");
+  writable.wait(waitScope);
+  drained.wait(waitScope);
+  ZC_EXPECT(queue.getQueuedBytes() == 0);
+  queue.whenDrained().wait(waitScope);
+
+  // A failed send fails the queue.
+  pipe.ends[1] = nullptr;
+  queue.send(zc::str("lost"));
+  ZC_EXPECT_THROW_MESSAGE("other end of WebSocketPipe was destroyed",
+                          queue.whenDrained().wait(waitScope));
+  ZC_EXPECT_THROW_MESSAGE("other end of WebSocketPipe was destroyed", queue.send(zc::str("x")));
+  ZC_EXPECT(queue.getQueuedBytes() == 0);
+}
+
 ZC_TEST("WebSocket unexpected RSV bits") {
   ZC_HTTP_TEST_SETUP_IO;
   auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
@@ -4769,6 +5126,200 @@ ZC_TEST("HttpServer cancels request when client disconnects") {
   cancelPromise.wait(waitScope);
 }
 
+class ManualHttpService final : public HttpService {
+  // Responds to each request with an empty 200 OK when the test says so.
+
+public:
+  explicit ManualHttpService(const HttpHeaderTable& table) : table(table) {}
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, Response& response) override {
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    pending.add(zc::mv(paf.fulfiller));
+    return paf.promise.then([this, &response]() {
+      HttpHeaders responseHeaders(table);
+      response.send(200, "OK", responseHeaders, uint64_t(0));
+    });
+  }
+
+  void respond(uint i) { pending[i]->fulfill(); }
+
+  uint requestCount() { return pending.size(); }
+
+private:
+  const HttpHeaderTable& table;
+  zc::Vector<zc::Own<zc::PromiseFulfiller<void>>> pending;
+};
+
+class RecordingCallbacks final : public HttpServerCallbacks {
+public:
+  void requestAdmitted(zc::Duration queueTime) override { queueTimes.add(queueTime); }
+  void requestRejected(Rejection reason) override { rejections.add(reason); }
+
+  zc::Vector<zc::Duration> queueTimes;
+  zc::Vector<Rejection> rejections;
+};
+
+struct AdmissionTest {
+  zc::AsyncIoContext io = zc::setupAsyncIo();
+  zc::TimerImpl timer{zc::origin<zc::TimePoint>()};
+  HttpHeaderTable table;
+  ManualHttpService service{table};
+  RecordingCallbacks callbacks;
+  zc::Own<HttpServer> server;
+
+  explicit AdmissionTest(HttpServerSettings settings) {
+    settings.callbacks = callbacks;
+    server = zc::heap<HttpServer>(timer, table, service, settings);
+  }
+
+  struct Client {
+    zc::Own<zc::AsyncIoStream> stream;
+    zc::Promise<void> listenTask;
+  };
+
+  Client connect() {
+    // Opens a connection and sends a request on it.
+    auto pipe = ZC_HTTP_TEST_CREATE_2PIPE;
+    auto listenTask = server->listenHttp(zc::mv(pipe.ends[0]));
+    Client client{zc::mv(pipe.ends[1]), zc::mv(listenTask)};
+    send(client);
+    return client;
+  }
+
+  void send(Client& client) {
+    static constexpr auto request = "GET / HTTP/1.1\r\n\r\n"_zc;
+    client.stream->write(request.asBytes()).wait(io.waitScope);
+    io.waitScope.poll();
+  }
+
+  void advance(zc::Duration delay) {
+    timer.advanceTo(timer.now() + delay);
+    io.waitScope.poll();
+  }
+
+  void respond(uint i) {
+    service.respond(i);
+    io.waitScope.poll();
+  }
+
+  void expectOk(Client& client) {
+    expectRead(*client.stream, "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n").wait(io.waitScope);
+  }
+
+  void expectRejected(Client& client, zc::StringPtr status) {
+    auto text = client.stream->readAllText().wait(io.waitScope);
+    ZC_EXPECT(text.startsWith(zc::str("HTTP/1.1 ", status, "\r\nConnection: close\r\n")), text);
+  }
+};
+
+ZC_TEST("HttpServer maxConcurrentRequests queues requests up to maxQueueTime") {
+  HttpServerSettings settings;
+  settings.maxConcurrentRequests = 1;
+  settings.maxQueueTime = 10 * zc::MILLISECONDS;
+  settings.queueDelayTarget = 0 * zc::SECONDS;
+  AdmissionTest test(settings);
+
+  auto a = test.connect();
+  auto b = test.connect();
+  ZC_EXPECT(test.service.requestCount() == 1);
+
+  // `b` waits too long.
+  test.advance(10 * zc::MILLISECONDS);
+  test.expectRejected(b, "503 Service Unavailable");
+
+  // `c` gets its turn when `a` is done.
+  auto c = test.connect();
+  test.advance(5 * zc::MILLISECONDS);
+  ZC_EXPECT(test.service.requestCount() == 1);
+  test.respond(0);
+  test.expectOk(a);
+  ZC_EXPECT(test.service.requestCount() == 2);
+  test.respond(1);
+  test.expectOk(c);
+
+  // And `a` can go again right away.
+  test.send(a);
+  ZC_EXPECT(test.service.requestCount() == 3);
+
+  ZC_EXPECT(test.callbacks.queueTimes.asPtr() ==
+            zc::arr(0 * zc::MILLISECONDS, 5 * zc::MILLISECONDS, 0 * zc::MILLISECONDS).asPtr());
+  ZC_EXPECT(test.callbacks.rejections.asPtr() ==
+            zc::arr(HttpServerCallbacks::Rejection::QUEUE_TIMEOUT).asPtr());
+}
+
+ZC_TEST("HttpServer sheds requests when the queue stands") {
+  HttpServerSettings settings;
+  settings.maxConcurrentRequests = 1;
+  settings.queueDelayTarget = 5 * zc::MILLISECONDS;
+  settings.queueDelayInterval = 100 * zc::MILLISECONDS;
+  AdmissionTest test(settings);
+
+  // A queue that empties now and then is fine, however long the waits.
+  auto a = test.connect();
+  auto b = test.connect();
+  test.advance(20 * zc::MILLISECONDS);
+  test.respond(0);
+  ZC_EXPECT(test.service.requestCount() == 2);
+  auto c = test.connect();
+  test.advance(110 * zc::MILLISECONDS);
+  test.respond(1);
+  ZC_EXPECT(test.service.requestCount() == 3);
+
+  // But after an interval in which every request waited, long waiters are turned away...
+  auto d = test.connect();
+  test.advance(110 * zc::MILLISECONDS);
+  test.respond(2);
+  test.expectRejected(d, "503 Service Unavailable");
+  ZC_EXPECT(test.service.requestCount() == 3);
+
+  // ...and so are requests that would have to queue, until the interval is over.
+  auto e = test.connect();
+  ZC_EXPECT(test.service.requestCount() == 4);
+  auto f = test.connect();
+  test.expectRejected(f, "503 Service Unavailable");
+
+  test.advance(110 * zc::MILLISECONDS);
+  auto g = test.connect();
+  test.advance(10 * zc::MILLISECONDS);
+  test.respond(3);
+  ZC_EXPECT(test.service.requestCount() == 5);
+
+  using Rejection = HttpServerCallbacks::Rejection;
+  ZC_EXPECT(test.callbacks.queueTimes.asPtr() ==
+            zc::arr(0 * zc::MILLISECONDS, 20 * zc::MILLISECONDS, 110 * zc::MILLISECONDS,
+                    0 * zc::MILLISECONDS, 10 * zc::MILLISECONDS)
+                .asPtr());
+  ZC_EXPECT(test.callbacks.rejections.asPtr() ==
+            zc::arr(Rejection::OVERLOADED, Rejection::OVERLOADED).asPtr());
+}
+
+ZC_TEST("HttpServer limits the request rate of each connection") {
+  HttpServerSettings settings;
+  settings.connectionRequestRate = 10;
+  settings.connectionRequestBurst = 2;
+  AdmissionTest test(settings);
+
+  auto client = test.connect();
+  test.respond(0);
+  test.expectOk(client);
+  test.send(client);
+  test.respond(1);
+  test.expectOk(client);
+
+  // The burst is spent, but a tenth of a second earns another request.
+  test.advance(100 * zc::MILLISECONDS);
+  test.send(client);
+  test.respond(2);
+  test.expectOk(client);
+
+  test.send(client);
+  test.expectRejected(client, "429 Too Many Requests");
+  ZC_EXPECT(test.service.requestCount() == 3);
+  ZC_EXPECT(test.callbacks.rejections.asPtr() ==
+            zc::arr(HttpServerCallbacks::Rejection::RATE_LIMITED).asPtr());
+}
+
 class SuspendAfter : private HttpService {
   // A SuspendableHttpServiceFactory which responds to the first `n` requests with 200 OK, then
   // suspends all subsequent requests until its counter is reset.
@@ -5890,6 +6441,85 @@ ZC_TEST("HttpClient connection management") {
   ZC_EXPECT(cumulative == 9);
 }
 
+ZC_TEST("HttpClient connection pool limits") {
+  ZC_HTTP_TEST_SETUP_IO;
+  ZC_HTTP_TEST_SETUP_LOOPBACK_LISTENER_AND_ADDR;
+
+  zc::TimerImpl serverTimer(zc::origin<zc::TimePoint>());
+  zc::TimerImpl clientTimer(zc::origin<zc::TimePoint>());
+  HttpHeaderTable headerTable;
+
+  DummyService service(headerTable);
+  HttpServerSettings serverSettings;
+  HttpServer server(serverTimer, headerTable, service, serverSettings);
+  auto listenTask = server.listenHttp(*listener);
+
+  uint count = 0;
+  uint cumulative = 0;
+  CountingNetworkAddress countingAddr(*addr, count, cumulative);
+
+  FakeEntropySource entropySource;
+  HttpClientStats stats;
+  HttpClientSettings clientSettings;
+  clientSettings.entropySource = entropySource;
+  clientSettings.maxIdleConnections = 1;
+  clientSettings.maxConnections = 2;
+  clientSettings.preconnectCount = 2;
+  clientSettings.stats = stats;
+  auto client = newHttpClient(clientTimer, headerTable, countingAddr, clientSettings);
+
+  // Both preconnected connections open, but only one of them is kept.
+  for (uint n = 0; n < 100 && stats.connectionsOpened + stats.connectFailures < 2; n++) {
+    waitScope.poll();
+  }
+  ZC_EXPECT(stats.connectionsOpened == 2);
+  ZC_EXPECT(stats.connectFailures == 0);
+  ZC_EXPECT(stats.idleConnectionsClosed == 1);
+  ZC_EXPECT(count == 1);
+  ZC_EXPECT(cumulative == 2);
+
+  uint i = 0;
+  auto doRequest = [&]() {
+    uint n = i++;
+    return client->request(HttpMethod::GET, zc::str("/", n), HttpHeaders(headerTable))
+        .response
+        .then([](HttpClient::Response&& response) {
+          auto promise = response.body->readAllText();
+          return promise.attach(zc::mv(response.body));
+        })
+        .then([n](zc::String body) { ZC_EXPECT(body == zc::str("null:/", n)); });
+  };
+
+  // Of three requests at once, the first takes the idle connection, the second opens another, and
+  // the third waits for one of those to come free.
+  auto req1 = doRequest();
+  auto req2 = doRequest();
+  auto req3 = doRequest();
+  ZC_EXPECT(stats.requestsQueued == 1);
+  req1.wait(waitScope);
+  req2.wait(waitScope);
+  req3.wait(waitScope);
+  ZC_EXPECT(cumulative == 3);
+  ZC_EXPECT(stats.connectionsOpened == 3);
+  ZC_EXPECT(stats.connectionsReused == 2);
+
+  // Again, only one of the two connections stays idle.
+  waitScope.poll();
+  ZC_EXPECT(count == 1);
+  ZC_EXPECT(stats.idleConnectionsClosed == 2);
+
+  // When the server closes it, it's dropped from the pool without waiting for the idle timeout.
+  serverTimer.advanceTo(serverTimer.now() + serverSettings.pipelineTimeout * 2);
+  waitScope.poll();
+  clientTimer.advanceTo(clientTimer.now() + 100 * zc::MILLISECONDS);
+  waitScope.poll();
+  ZC_EXPECT(count == 0);
+  ZC_EXPECT(stats.idleConnectionsClosed == 3);
+
+  doRequest().wait(waitScope);
+  ZC_EXPECT(cumulative == 4);
+}
+
 ZC_TEST("HttpClient disable connection reuse") {
   ZC_HTTP_TEST_SETUP_IO;
   ZC_HTTP_TEST_SETUP_LOOPBACK_LISTENER_AND_ADDR;
@@ -0,0 +1,426 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/http/http2.h"
+
+#include "zc/core/debug.h"
+#include "zc/core/encoding.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+zc::String dumpHeaders(zc::ArrayPtr<const HpackDecoder::Header> headers) {
+  zc::Vector<zc::String> lines;
+  for (auto& header : headers) lines.add(zc::str(header.name, ": ", header.value));
+  return zc::strArray(lines, "\n");
+}
+
+zc::String repeatString(zc::StringPtr piece, size_t count) {
+  auto result = zc::heapString(piece.size() * count);
+  for (size_t i = 0; i < count; i++) {
+    memcpy(result.begin() + i * piece.size(), piece.begin(), piece.size());
+  }
+  return result;
+}
+
+zc::String decodeBlock(HpackDecoder& decoder, zc::StringPtr hex) {
+  auto block = zc::decodeHex(hex);
+  ZC_ASSERT(!block.hadErrors);
+  auto headers = ZC_ASSERT_NONNULL(decoder.decode(block, 65536));
+  return dumpHeaders(headers);
+}
+
+ZC_TEST("HPACK decodes RFC 7541 examples") {
+  // Appendix C.3: requests without Huffman coding.
+  {
+    HpackDecoder decoder;
+    ZC_EXPECT(decodeBlock(decoder, "828684410f7777772e6578616d706c652e636f6d") ==
+              ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com");
+    ZC_EXPECT(decoder.getTableSize() == 57);
+    ZC_EXPECT(decodeBlock(decoder, "828684be58086e6f2d6361636865") ==
+              ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+              "cache-control: no-cache");
+    ZC_EXPECT(decoder.getTableSize() == 110);
+    ZC_EXPECT(decodeBlock(decoder,
+                          "828785bf400a637573746f6d2d6b65790c637573746f6d2d76616c7565") ==
+              ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+              "custom-key: custom-value");
+    ZC_EXPECT(decoder.getTableSize() == 164);
+  }
+
+  // Appendix C.4: the same requests, with Huffman coding.
+  {
+    HpackDecoder decoder;
+    ZC_EXPECT(decodeBlock(decoder, "828684418cf1e3c2e5f23a6ba0ab90f4ff") ==
+              ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com");
+    ZC_EXPECT(decodeBlock(decoder, "828684be5886a8eb10649cbf") ==
+              ":method: GET\n:scheme: http\n:path: /\n:authority: www.example.com\n"
+              "cache-control: no-cache");
+    ZC_EXPECT(decodeBlock(decoder, "828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf") ==
+              ":method: GET\n:scheme: https\n:path: /index.html\n:authority: www.example.com\n"
+              "custom-key: custom-value");
+    ZC_EXPECT(decoder.getTableSize() == 164);
+  }
+
+  // Appendix C.5: responses, with a table of only 256 bytes, so that entries get evicted.
+  {
+    HpackDecoder decoder(256);
+    decodeBlock(decoder,
+                "4803333032580770726976617465611d4d6f6e2c203231204f637420323031332032303a3133"
+                "3a323120474d546e1768747470733a2f2f7777772e6578616d706c652e636f6d");
+    ZC_EXPECT(decoder.getTableSize() == 222);
+    ZC_EXPECT(decodeBlock(decoder, "4803333037c1c0bf") ==
+              ":status: 307\ncache-control: private\ndate: Mon, 21 Oct 2013 20:13:21 GMT\n"
+              "location: https://www.example.com");
+    ZC_EXPECT(decoder.getTableSize() == 222);
+  }
+}
+
+ZC_TEST("HPACK rejects malformed blocks") {
+  {
+    // Index 70 is beyond both tables.
+    HpackDecoder decoder;
+    ZC_EXPECT_THROW_MESSAGE("index", decoder.decode(zc::decodeHex("c6"), 65536));
+  }
+  {
+    // A table size update above what we allow.
+    HpackDecoder decoder(4096);
+    ZC_EXPECT_THROW_MESSAGE("table size", decoder.decode(zc::decodeHex("3fe21f"), 65536));
+  }
+  {
+    // A string whose Huffman padding isn't all ones.
+    HpackDecoder decoder;
+    ZC_EXPECT_THROW_MESSAGE("Huffman", decoder.decode(zc::decodeHex("0081008100"), 65536));
+  }
+  {
+    // Too long a header list comes out as none, but still updates the table.
+    HpackDecoder decoder;
+    ZC_EXPECT(decoder.decode(zc::decodeHex("400a637573746f6d2d6b65790c637573746f6d2d76616c7565"),
+                             40) == zc::none);
+    ZC_EXPECT(decoder.getTableSize() == 54);
+  }
+}
+
+ZC_TEST("HPACK round trip") {
+  HpackEncoder encoder;
+  HpackDecoder decoder;
+
+  zc::String longValue = repeatString("abcdefgh", 1000);
+  HpackEncoder::Field fields[] = {
+      {":method", "POST"},
+      {":path", "/some/path?with=query"},
+      {"user-agent", "zc-test/1.0 (\x7f binary \x01 bytes)"},
+      {"authorization", "Bearer secret"},
+      {"x-long", longValue},
+  };
+
+  zc::Vector<byte> first;
+  encoder.encode(first, fields);
+  auto decoded = ZC_ASSERT_NONNULL(decoder.decode(first, 1 << 20));
+  ZC_ASSERT(decoded.size() == zc::size(fields));
+  for (auto i : zc::indices(fields)) {
+    ZC_EXPECT(decoded[i].name == fields[i].name);
+    ZC_EXPECT(decoded[i].value == fields[i].value);
+  }
+
+  // The second time, everything but the credentials and the over-long value comes from the table.
+  zc::Vector<byte> second;
+  encoder.encode(second, zc::arrayPtr(fields).first(3));
+  ZC_EXPECT(second.size() == 3, second.size());
+  ZC_EXPECT(decoder.getTableSize() < 200, decoder.getTableSize());
+  auto decodedAgain = ZC_ASSERT_NONNULL(decoder.decode(second, 1 << 20));
+  ZC_EXPECT(decodedAgain[2].value == fields[2].value);
+
+  // Every byte value survives Huffman coding.
+  zc::Vector<char> allBytes;
+  for (uint i = 1; i < 256; i++) allBytes.add(i);
+  allBytes.add('\0');
+  zc::String binary = zc::heapString(allBytes.asPtr().first(allBytes.size() - 1));
+  HpackEncoder::Field binaryField[] = {{"x-binary", binary}};
+  zc::Vector<byte> third;
+  encoder.encode(third, binaryField);
+  auto decodedBinary = ZC_ASSERT_NONNULL(decoder.decode(third, 1 << 20));
+  ZC_EXPECT(decodedBinary[0].value == binary);
+}
+
+// =======================================================================================
+
+class TestService final : public HttpService {
+  // Echoes requests back: the response body says what was asked for and holds the request body.
+  // Requests for "/wait" don't complete until a request for "/release" arrives.
+
+public:
+  explicit TestService(const HttpHeaderTable& table) : table(table) {}
+
+  uint requestCount = 0;
+  zc::Maybe<zc::Own<zc::PromiseFulfiller<void>>> release;
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, Response& response) override {
+    ++requestCount;
+    if (url == "/throw") ZC_FAIL_REQUIRE("oops");
+
+    zc::Promise<void> ready = zc::READY_NOW;
+    if (url == "/wait") {
+      auto paf = zc::newPromiseAndFulfiller<void>();
+      release = zc::mv(paf.fulfiller);
+      ready = zc::mv(paf.promise);
+    } else if (url == "/release") {
+      ZC_IF_SOME(r, release) { r->fulfill(); }
+    }
+
+    zc::StringPtr cookie = "-";
+    headers.forEach([&](zc::StringPtr name, zc::StringPtr value) {
+      if (name == "cookie") cookie = value;
+    });
+    auto text = zc::str(method, " ", url, " ", headers.get(HttpHeaderId::HOST).orDefault("-"),
+                        " ", cookie, "\n");
+    return ready.then([&requestBody]() { return requestBody.readAllText(); })
+        .then([this, &response, text = zc::mv(text)](zc::String body) mutable {
+          HttpHeaders responseHeaders(table);
+          responseHeaders.set(HttpHeaderId::CONTENT_TYPE, "text/plain");
+          auto content = zc::str(text, body);
+          auto stream = response.send(200, "OK", responseHeaders, content.size());
+          auto promise = stream->write(content.asBytes());
+          return promise.attach(zc::mv(stream), zc::mv(content));
+        });
+  }
+
+private:
+  const HttpHeaderTable& table;
+};
+
+struct Http2Fixture {
+  Http2Fixture(zc::WaitScope& waitScope, Http2Settings settings = Http2Settings())
+      : waitScope(waitScope),
+        pipe(zc::newTwoWayPipe()),
+        service(table),
+        server(table, service, settings),
+        client(newHttp2Client(table, *pipe.ends[0], settings)),
+        listenTask(server.listenHttp(zc::mv(pipe.ends[1])).eagerlyEvaluate(nullptr)) {}
+
+  zc::WaitScope& waitScope;
+  HttpHeaderTable table;
+  zc::TwoWayPipe pipe;
+  TestService service;
+  Http2Server server;
+  zc::Own<HttpClient> client;
+  zc::Promise<void> listenTask;
+
+  HttpClient::Request request(HttpMethod method, zc::StringPtr url,
+                              zc::Maybe<uint64_t> bodySize = zc::none) {
+    HttpHeaders headers(table);
+    headers.set(HttpHeaderId::HOST, "example.com");
+    return client->request(method, url, headers, bodySize);
+  }
+
+  zc::String get(zc::StringPtr url) {
+    auto response = request(HttpMethod::GET, url).response.wait(waitScope);
+    return zc::str(response.statusCode, " ", response.body->readAllText().wait(waitScope));
+  }
+};
+
+ZC_TEST("HTTP/2 client and server") {
+  auto io = zc::setupAsyncIo();
+  Http2Fixture fixture(io.waitScope);
+
+  ZC_EXPECT(fixture.get("/foo") == "200 GET /foo example.com -\n");
+  ZC_EXPECT(fixture.get("/bar") == "200 GET /bar example.com -\n");
+
+  {
+    auto req = fixture.request(HttpMethod::POST, "/post", 11);
+    req.body->write("hello world"_zcb).wait(io.waitScope);
+    auto response = req.response.wait(io.waitScope);
+    ZC_EXPECT(response.statusCode == 200);
+    ZC_EXPECT(response.headers->get(HttpHeaderId::CONTENT_TYPE).orDefault("") == "text/plain");
+    ZC_EXPECT(response.body->readAllText().wait(io.waitScope) ==
+              "POST /post example.com -\nhello world");
+  }
+
+  {
+    // A body of unknown length ends when the stream is dropped.
+    auto req = fixture.request(HttpMethod::PUT, "/put");
+    req.body->write("abc"_zcb).wait(io.waitScope);
+    req.body->write("def"_zcb).wait(io.waitScope);
+    req.body = nullptr;
+    auto response = req.response.wait(io.waitScope);
+    ZC_EXPECT(response.body->readAllText().wait(io.waitScope) == "PUT /put example.com -\nabcdef");
+  }
+
+  {
+    // Cookies split across fields are joined back up.
+    HttpHeaders headers(fixture.table);
+    headers.set(HttpHeaderId::HOST, "example.com");
+    headers.add("Cookie", "a=1");
+    headers.add("Cookie", "b=2");
+    auto response = fixture.client->request(HttpMethod::GET, "/cookie", headers)
+                        .response.wait(io.waitScope);
+    ZC_EXPECT(response.body->readAllText().wait(io.waitScope) ==
+              "GET /cookie example.com a=1; b=2\n");
+  }
+
+  ZC_EXPECT(fixture.get("/throw").startsWith("500 "));
+  ZC_EXPECT(fixture.get("/after-throw") == "200 GET /after-throw example.com -\n");
+}
+
+ZC_TEST("HTTP/2 requests run concurrently") {
+  auto io = zc::setupAsyncIo();
+  Http2Fixture fixture(io.waitScope);
+
+  auto waiting = fixture.request(HttpMethod::GET, "/wait").response;
+  ZC_EXPECT(!waiting.poll(io.waitScope));
+
+  // Over HTTP/1.1, this would be stuck behind /wait.
+  ZC_EXPECT(fixture.get("/release") == "200 GET /release example.com -\n");
+
+  auto response = waiting.wait(io.waitScope);
+  ZC_EXPECT(response.body->readAllText().wait(io.waitScope) == "GET /wait example.com -\n");
+}
+
+ZC_TEST("HTTP/2 waits for the peer's flow control windows") {
+  auto io = zc::setupAsyncIo();
+  Http2Settings settings;
+  settings.initialWindowSize = 65535;
+  settings.connectionWindowSize = 65535;
+  Http2Fixture fixture(io.waitScope, settings);
+
+  auto body = repeatString("0123456789abcdef", 20000);
+  auto req = fixture.request(HttpMethod::POST, "/big", body.size());
+  auto written = req.body->write(body.asBytes());
+  auto response = req.response.wait(io.waitScope);
+  written.wait(io.waitScope);
+  auto text = response.body->readAllText().wait(io.waitScope);
+  ZC_EXPECT(text.size() == body.size() + 24, text.size());
+  ZC_EXPECT(text.endsWith(body));
+}
+
+ZC_TEST("HTTP/2 limits concurrent streams") {
+  auto io = zc::setupAsyncIo();
+  Http2Settings settings;
+  settings.maxConcurrentStreams = 1;
+  Http2Fixture fixture(io.waitScope, settings);
+
+  // Until the client has heard the server's settings, it doesn't know about the limit.
+  ZC_EXPECT(fixture.get("/first") == "200 GET /first example.com -\n");
+
+  // The second request isn't sent until the first is done.
+  auto waiting = fixture.request(HttpMethod::GET, "/wait").response;
+  auto second = fixture.request(HttpMethod::GET, "/release").response;
+  ZC_EXPECT(!second.poll(io.waitScope));
+  ZC_EXPECT(fixture.service.requestCount == 2);
+
+  ZC_IF_SOME(r, fixture.service.release) { r->fulfill(); }
+  auto response = waiting.wait(io.waitScope);
+  response.body->readAllText().wait(io.waitScope);
+  response.body = nullptr;
+
+  auto secondResponse = second.wait(io.waitScope);
+  ZC_EXPECT(secondResponse.body->readAllText().wait(io.waitScope) ==
+            "GET /release example.com -\n");
+}
+
+ZC_TEST("HTTP/2 client drops a response early") {
+  auto io = zc::setupAsyncIo();
+  Http2Settings settings;
+  settings.initialWindowSize = 65535;
+  Http2Fixture fixture(io.waitScope, settings);
+
+  auto body = repeatString("x", 200000);
+  {
+    auto req = fixture.request(HttpMethod::POST, "/echo", body.size());
+    auto written = req.body->write(body.asBytes());
+    auto response = req.response.wait(io.waitScope);
+    // Dropping the body resets the stream, unblocking the server's write.
+  }
+
+  ZC_EXPECT(fixture.get("/next") == "200 GET /next example.com -\n");
+}
+
+ZC_TEST("HTTP/2 server drains") {
+  auto io = zc::setupAsyncIo();
+  Http2Fixture fixture(io.waitScope);
+
+  auto waiting = fixture.request(HttpMethod::GET, "/wait").response;
+  ZC_EXPECT(!waiting.poll(io.waitScope));
+
+  auto drained = fixture.server.drain();
+  ZC_EXPECT(!drained.poll(io.waitScope));
+
+  // The request in flight completes; new ones are refused.
+  ZC_IF_SOME(r, fixture.service.release) { r->fulfill(); }
+  auto response = waiting.wait(io.waitScope);
+  ZC_EXPECT(response.body->readAllText().wait(io.waitScope) == "GET /wait example.com -\n");
+  ZC_EXPECT_THROW(DISCONNECTED,
+                  fixture.request(HttpMethod::GET, "/late").response.wait(io.waitScope));
+
+  fixture.listenTask.wait(io.waitScope);
+  drained.wait(io.waitScope);
+}
+
+ZC_TEST("HTTP/2 server bounds header blocks that never end") {
+  auto io = zc::setupAsyncIo();
+  HttpHeaderTable table;
+  TestService service(table);
+  Http2Settings settings;
+  settings.maxHeaderListSize = 1024;
+  Http2Server server(table, service, settings);
+  auto pipe = zc::newTwoWayPipe();
+  auto listenTask = server.listenHttp(zc::mv(pipe.ends[1])).eagerlyEvaluate(nullptr);
+
+  // A HEADERS frame and CONTINUATION frames, none of which ends the block. What they hold doesn't
+  // matter, since the block is never decoded.
+  zc::Vector<byte> frames;
+  frames.addAll("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n"_zc.asBytes());
+  auto addFrame = [&](byte type, uint32_t streamId, size_t length) {
+    byte header[9] = {byte(length >> 16), byte(length >> 8), byte(length), type, 0,
+                      byte(streamId >> 24), byte(streamId >> 16), byte(streamId >> 8),
+                      byte(streamId)};
+    frames.addAll(zc::arrayPtr(header));
+    for (size_t i = 0; i < length; i++) frames.add(0);
+  };
+  addFrame(0x4 /* SETTINGS */, 0, 0);
+  addFrame(0x1 /* HEADERS */, 1, 1000);
+  for (uint i = 0; i < 100; i++) addFrame(0x9 /* CONTINUATION */, 1, 1000);
+  auto written = pipe.ends[0]->write(frames.asPtr()).catch_([](zc::Exception&&) {});
+
+  // The server gives up on the connection long before the frames run out.
+  auto received = pipe.ends[0]->readAllBytes();
+  ZC_ASSERT(received.poll(io.waitScope));
+  ZC_EXPECT_THROW_MESSAGE("header block too large", listenTask.wait(io.waitScope));
+
+  auto output = received.wait(io.waitScope);
+  zc::Maybe<uint32_t> goAwayCode;
+  for (auto p = output.asPtr(); p.size() >= 9;) {
+    size_t length = (size_t(p[0]) << 16) | (size_t(p[1]) << 8) | p[2];
+    ZC_ASSERT(p.size() >= 9 + length);
+    if (p[3] == 0x7 /* GOAWAY */ && length >= 8) {
+      // The error code follows the last stream ID.
+      goAwayCode =
+          (uint32_t(p[13]) << 24) | (uint32_t(p[14]) << 16) | (uint32_t(p[15]) << 8) | p[16];
+    }
+    p = p.slice(9 + length, p.size());
+  }
+  ZC_EXPECT(goAwayCode == uint32_t(1) /* PROTOCOL_ERROR */);
+}
+
+}  // namespace
+}  // namespace zc
@@ -0,0 +1,161 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/http/router.h"
+
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+class NamedHandler final : public HttpRouter::Handler {
+public:
+  explicit NamedHandler(zc::StringPtr name) : name(name) {}
+
+  zc::Promise<void> request(HttpMethod method, zc::StringPtr url, const HttpHeaders& headers,
+                            zc::AsyncInputStream& requestBody, HttpService::Response& response,
+                            const HttpRouter::Params& params) override {
+    lastParam = params.get("id").orDefault(zc::String());
+    return zc::READY_NOW;
+  }
+
+  zc::StringPtr name;
+  zc::String lastParam;
+};
+
+class StatusResponse final : public HttpService::Response {
+public:
+  zc::Own<zc::AsyncOutputStream> send(uint statusCode, zc::StringPtr statusText,
+                                      const HttpHeaders& headers,
+                                      zc::Maybe<uint64_t> expectedBodySize) override {
+    status = statusCode;
+    return zc::heap<zc::NullStream>();
+  }
+
+  zc::Own<WebSocket> acceptWebSocket(const HttpHeaders& headers) override {
+    ZC_UNIMPLEMENTED("no WebSockets here");
+  }
+
+  uint status = 0;
+};
+
+zc::StringPtr matchName(const HttpRouter& router, HttpMethod method, zc::StringPtr url,
+                        const HttpHeaders& headers, HttpRouter::Params& params) {
+  ZC_IF_SOME(handler, router.match(method, url, headers, params)) {
+    return static_cast<NamedHandler&>(handler).name;
+  }
+  else { return "none"; }
+}
+
+ZC_TEST("HttpRouter matches routes") {
+  HttpHeaderTable table;
+  auto hostId = HttpHeaderId::HOST;
+
+  NamedHandler list("list"), user("user"), me("me"), post("post"), files("files"),
+      health("health"), healthz("healthz"), tenant("tenant"), anyHost("anyHost");
+  HttpRouter::HeaderCondition tenantHost[] = {{hostId, "tenant.example"}};
+
+  HttpRouter::Builder builder(table);
+  builder.add(HttpMethod::GET, "/users", list)
+      .add(HttpMethod::GET, "/users/:id", user)
+      .add(HttpMethod::GET, "/users/me", me)
+      .add(HttpMethod::POST, "/users/:id/posts/:post", post)
+      .add(zc::none, "/static/*path", files)
+      .add(HttpMethod::GET, "/api/v1/health", health)
+      .add(HttpMethod::GET, "/api/v1/healthz", healthz)
+      .add(HttpMethod::GET, "/where", tenantHost, tenant)
+      .add(HttpMethod::GET, "/where", anyHost);
+  auto router = builder.build();
+
+  HttpHeaders headers(table);
+  headers.set(hostId, "other.example");
+  HttpRouter::Params params;
+
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users", headers, params) == "list");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users/", headers, params) == "list");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users/42?x=1", headers, params) == "user");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(params.getRaw("id")) == "42"_zc.asArray());
+  ZC_EXPECT(params.size() == 1);
+
+  // A literal segment wins over a parameter, whichever was added first.
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users/me", headers, params) == "me");
+  ZC_EXPECT(params.size() == 0);
+
+  ZC_EXPECT(matchName(*router, HttpMethod::POST, "/users/a%20b/posts/7", headers, params) ==
+            "post");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(params.get("id")) == "a b");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(params.getRaw("post")) == "7"_zc.asArray());
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users/1/posts/7", headers, params) == "none");
+
+  ZC_EXPECT(matchName(*router, HttpMethod::PUT, "/static/css/site.css", headers, params) ==
+            "files");
+  ZC_EXPECT(ZC_ASSERT_NONNULL(params.getRaw("path")) == "css/site.css"_zc.asArray());
+
+  // "/api/v1" is compiled into a single edge, but still has to match segment by segment.
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "//api//v1/health", headers, params) == "health");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/api/v1/healthz", headers, params) == "healthz");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/api/health", headers, params) == "none");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/api/v1", headers, params) == "none");
+
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/where", headers, params) == "anyHost");
+  headers.set(hostId, "tenant.example");
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/where", headers, params) == "tenant");
+
+  // Proxy-style URLs are matched by their path.
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "http://tenant.example/users/9", headers,
+                      params) == "user");
+
+  // Paths with dot segments aren't resolved, so they match nothing.
+  ZC_EXPECT(matchName(*router, HttpMethod::GET, "/users/../users", headers, params) == "none");
+}
+
+ZC_TEST("HttpRouter dispatches requests") {
+  auto io = zc::setupAsyncIo();
+  HttpHeaderTable table;
+  NamedHandler user("user");
+
+  HttpRouter::Builder builder(table);
+  builder.add(HttpMethod::GET, "/users/:id", user);
+  auto router = builder.build();
+
+  HttpHeaders headers(table);
+  zc::NullStream body;
+
+  {
+    StatusResponse response;
+    router->request(HttpMethod::GET, "/users/7", headers, body, response).wait(io.waitScope);
+    ZC_EXPECT(user.lastParam == "7");
+    ZC_EXPECT(response.status == 0);
+  }
+  {
+    StatusResponse response;
+    router->request(HttpMethod::DELETE, "/users/7", headers, body, response).wait(io.waitScope);
+    ZC_EXPECT(response.status == 405);
+  }
+  {
+    StatusResponse response;
+    router->request(HttpMethod::GET, "/groups/7", headers, body, response).wait(io.waitScope);
+    ZC_EXPECT(response.status == 404);
+  }
+}
+
+}  // namespace
+}  // namespace zc
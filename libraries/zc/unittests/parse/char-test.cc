@@ -192,6 +192,56 @@ TEST(CharParsers, CharGroupCombo) {
   }
 }
 
+TEST(CharParsers, CharGroupSpan) {
+  // Every character, each in a run long enough for the vectorized scan, against groups with
+  // members in both halves of the character set.
+  constexpr CharGroup_ groups[] = {alphaNumeric, whitespaceChar, hexDigit.invert(),
+                                   charRange('\x70', '\x8f').orChar('\xff'), CharGroup_()};
+  for (auto group : groups) {
+    char member = 'a';
+    for (uint c = 0; c < 256; c++) {
+      if (group.contains(c)) {
+        member = c;
+        break;
+      }
+    }
+
+    for (uint c = 0; c < 256; c++) {
+      for (size_t position : {0, 5, 16, 37}) {
+        String text = str(repeat(member, 40));
+        text[position] = c;
+        size_t expected = 0;
+        while (expected < text.size() && group.contains(text[expected])) ++expected;
+        EXPECT_EQ(expected, group.span(text));
+      }
+    }
+  }
+}
+
+TEST(CharParsers, CharGroupRuns) {
+  String text = str(repeat(' ', 20), "\t\nfoo", repeat('x', 50), "123 bar");
+
+  {
+    Input input(text.begin(), text.end());
+    ZC_IF_SOME(spaces, whitespace(input)) { EXPECT_EQ(22u, spaces.size()); }
+    else { ADD_FAILURE() << "Expected parse result, got null."; }
+    ZC_IF_SOME(name, charsToString(oneOrMore(alphaNumeric))(input)) {
+      EXPECT_EQ(str("foo", repeat('x', 50), "123"), name);
+    }
+    else { ADD_FAILURE() << "Expected parse result, got null."; }
+    EXPECT_TRUE(oneOrMore(alpha)(input) == zc::none);
+    EXPECT_TRUE(discardWhitespace(input) != zc::none);
+    EXPECT_EQ('b', input.current());
+  }
+
+  {
+    Input input(text.begin(), text.end());
+    ZC_IF_SOME(count, spanOf(whitespaceChar)(input)) { EXPECT_EQ(22u, count); }
+    else { ADD_FAILURE() << "Expected parse result, got null."; }
+    EXPECT_EQ('f', input.current());
+  }
+}
+
 TEST(CharParsers, Identifier) {
   constexpr auto parser = identifier;
 
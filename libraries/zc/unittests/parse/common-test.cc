@@ -454,6 +454,86 @@ TEST(CommonParsers, EndOfInput) {
   }
 }
 
+template <typename SubParser>
+class CountCalls_ {
+public:
+  CountCalls_(SubParser&& subParser, uint& calls)
+      : subParser(zc::fwd<SubParser>(subParser)), calls(calls) {}
+
+  template <typename Input>
+  Maybe<OutputType<SubParser, Input>> operator()(Input& input) const {
+    ++calls;
+    return subParser(input);
+  }
+
+private:
+  SubParser subParser;
+  uint& calls;
+};
+
+template <typename SubParser>
+CountCalls_<SubParser> countCalls(SubParser&& subParser, uint& calls) {
+  return CountCalls_<SubParser>(zc::fwd<SubParser>(subParser), calls);
+}
+
+typedef PackratInput<char, const char*> MemoInput;
+
+TEST(CommonParsers, MemoizeParser) {
+  uint calls = 0;
+  auto letters = memoize(countCalls(many(exactly('a')), calls));
+  auto parser = oneOf(sequence(letters, exactly('x')), sequence(letters, exactly('y')));
+
+  {
+    StringPtr text = "aaay";
+    Input input(text.begin(), text.end());
+    ZC_IF_SOME(count, parser(input)) { EXPECT_EQ(3u, count); }
+    else { ADD_FAILURE() << "Expected 3, got null."; }
+    EXPECT_TRUE(input.atEnd());
+    EXPECT_EQ(2u, calls);
+  }
+
+  calls = 0;
+  {
+    StringPtr text = "aaay";
+    MemoInput input(text.begin(), text.end());
+    ZC_IF_SOME(count, parser(input)) { EXPECT_EQ(3u, count); }
+    else { ADD_FAILURE() << "Expected 3, got null."; }
+    EXPECT_TRUE(input.atEnd());
+    EXPECT_EQ(1u, calls);
+    EXPECT_EQ(1u, input.getMemoSize());
+  }
+
+  calls = 0;
+  {
+    StringPtr text = "aaaz";
+    MemoInput input(text.begin(), text.end());
+    EXPECT_TRUE(parser(input) == zc::none);
+    EXPECT_EQ(1u, calls);
+    EXPECT_EQ(text.begin() + 3, input.getBest());
+  }
+}
+
+TEST(CommonParsers, MemoizeRecursiveParser) {
+  // Each level tries its nested expression twice, so without memoization this takes 2^depth steps.
+  ParserRef<MemoInput, uint> nested;
+  uint calls = 0;
+  auto addLevel = [](uint depth) { return depth + 1; };
+  auto body = countCalls(
+      oneOf(transform(sequence(exactly('('), nested, exactly(')'), exactly('!')), addLevel),
+            transform(sequence(exactly('('), nested, exactly(')')), addLevel),
+            constResult(exactly('x'), 0u)),
+      calls);
+  auto rule = memoize(body);
+  nested = rule;
+
+  String text = zc::str(zc::repeat('(', 40), 'x', zc::repeat(')', 40));
+  MemoInput input(text.begin(), text.end());
+  ZC_IF_SOME(depth, nested(input)) { EXPECT_EQ(40u, depth); }
+  else { ADD_FAILURE() << "Expected 40, got null."; }
+  EXPECT_TRUE(input.atEnd());
+  EXPECT_EQ(41u, calls);
+}
+
 }  // namespace
 }  // namespace parse
 }  // namespace zc
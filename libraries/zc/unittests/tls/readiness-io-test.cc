@@ -267,5 +267,66 @@ ZC_TEST("readiness IO: read many even") {
   }
 }
 
+ZC_TEST("readiness IO: write in place") {
+  auto io = setupAsyncIo();
+  auto pipe = io.provider->newOneWayPipe();
+
+  auto record = zc::heapArray<byte>(16384);
+  for (auto i : zc::indices(record)) { record[i] = i % 251; }
+  auto buf = zc::heapArray<byte>(record.size() + 3);
+  auto readPromise = pipe.in->read(buf, buf.size());
+
+  ReadyOutputStreamWrapper out(*pipe.out);
+  auto cork = out.cork();
+
+  // Large writes go straight out, even while corked, and aren't acknowledged until retried.
+  ZC_ASSERT(out.writeInPlace(record) == zc::none);
+  ZC_ASSERT(!out.isEmpty());
+
+  // Small writes are still buffered behind it.
+  ZC_ASSERT(ZC_ASSERT_NONNULL(out.writeInPlace("foo"_zcb)) == 3);
+
+  out.whenReady().wait(io.waitScope);
+  ZC_ASSERT(ZC_ASSERT_NONNULL(out.writeInPlace(record)) == record.size());
+
+  if (true) { auto tmp = zc::mv(cork); }
+  ZC_ASSERT(readPromise.wait(io.waitScope) == buf.size());
+  ZC_ASSERT(buf.first(record.size()) == record);
+  ZC_ASSERT(buf.slice(record.size()) == "foo"_zcb);
+  ZC_ASSERT(out.isEmpty());
+}
+
+ZC_TEST("readiness IO: read in place") {
+  auto io = setupAsyncIo();
+  auto pipe = io.provider->newOneWayPipe();
+
+  ReadyInputStreamWrapper in(*pipe.in);
+  auto buf = zc::heapArray<byte>(16384);
+  ZC_ASSERT(in.readInPlace(buf) == zc::none);
+
+  auto record = zc::heapArray<byte>(10000);
+  for (auto i : zc::indices(record)) { record[i] = i % 251; }
+  pipe.out->write(record).wait(io.waitScope);
+
+  // The bytes land in `buf` itself, but aren't reported until the read is retried.
+  in.whenReady().wait(io.waitScope);
+  ZC_ASSERT(buf.first(record.size()) == record);
+  ZC_ASSERT(ZC_ASSERT_NONNULL(in.readInPlace(buf)) == record.size());
+
+  // Small reads go through the internal buffer.
+  char small[4]{};
+  ZC_ASSERT(in.readInPlace(zc::ArrayPtr<char>(small).asBytes()) == zc::none);
+  pipe.out->write("foo"_zcb).wait(io.waitScope);
+  in.whenReady().wait(io.waitScope);
+  ZC_ASSERT(ZC_ASSERT_NONNULL(in.readInPlace(zc::ArrayPtr<char>(small).asBytes())) == 3);
+  ZC_ASSERT(zc::StringPtr(small) == "foo");
+
+  pipe.out = nullptr;
+  ZC_ASSERT(in.readInPlace(buf) == zc::none);
+  in.whenReady().wait(io.waitScope);
+  ZC_ASSERT(ZC_ASSERT_NONNULL(in.readInPlace(buf)) == 0);
+  ZC_ASSERT(in.isAtEnd());
+}
+
 }  // namespace
 }  // namespace zc
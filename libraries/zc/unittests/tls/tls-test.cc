@@ -39,7 +39,11 @@
 #include <sys/socket.h>
 #endif
 
+#include <thread>
+
 #include "zc/async/async-io.h"
+#include "zc/async/worker-pool.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 
 namespace zc {
@@ -551,6 +555,89 @@ ZC_TEST("TLS peer identity") {
   test.testConnection(*client.stream, *server.stream);
 }
 
+ZC_TEST("TLS session resumption") {
+  auto clientOptions = TlsTest::defaultClient();
+  clientOptions.clientSessionCacheSize = 16;
+  TlsTest test(zc::mv(clientOptions));
+
+  auto connect = [&]() {
+    ErrorNexus e;
+    auto pipe = test.io.provider->newTwoWayPipe();
+    auto clientPromise = e.wrap(test.tlsClient.wrapClient(
+        zc::AuthenticatedStream{zc::mv(pipe.ends[0]), zc::LocalPeerIdentity::newInstance({})},
+        "example.com"));
+    auto serverPromise = e.wrap(test.tlsServer.wrapServer(
+        zc::AuthenticatedStream{zc::mv(pipe.ends[1]), zc::LocalPeerIdentity::newInstance({})}));
+    auto client = clientPromise.wait(test.io.waitScope);
+    auto server = serverPromise.wait(test.io.waitScope);
+
+    // The client only picks up the server's session tickets when it reads.
+    test.testConnection(*client.stream, *server.stream);
+    test.testConnection(*server.stream, *client.stream);
+
+    auto clientId = client.peerIdentity.downcast<TlsPeerIdentity>();
+    ZC_EXPECT(clientId->getCommonName() == "example.com");
+    bool resumed = clientId->isResumed();
+    ZC_EXPECT(server.peerIdentity.downcast<TlsPeerIdentity>()->isResumed() == resumed);
+    return resumed;
+  };
+
+  ZC_EXPECT(!connect());
+  ZC_EXPECT(connect());
+
+  // A ticket issued under the previous key is still good...
+  test.tlsServer.rotateSessionTicketKey();
+  ZC_EXPECT(connect());
+
+  // ...but not one issued under the key before that.
+  test.tlsServer.rotateSessionTicketKey();
+  test.tlsServer.rotateSessionTicketKey();
+  ZC_EXPECT(!connect());
+  ZC_EXPECT(connect());
+
+  ZC_EXPECT_THROW_MESSAGE("80 bytes", test.tlsServer.rotateSessionTicketKey("short"_zcb));
+}
+
+ZC_TEST("TLS ALPN") {
+  auto connect = [](zc::ArrayPtr<const zc::StringPtr> clientProtocols,
+                    zc::ArrayPtr<const zc::StringPtr> serverProtocols) {
+    auto clientOptions = TlsTest::defaultClient();
+    clientOptions.alpnProtocols = clientProtocols;
+    auto serverOptions = TlsTest::defaultServer();
+    serverOptions.alpnProtocols = serverProtocols;
+    TlsTest test(zc::mv(clientOptions), zc::mv(serverOptions));
+
+    ErrorNexus e;
+    auto pipe = test.io.provider->newTwoWayPipe();
+    auto clientPromise = e.wrap(test.tlsClient.wrapClient(
+        zc::AuthenticatedStream{zc::mv(pipe.ends[0]), zc::LocalPeerIdentity::newInstance({})},
+        "example.com"));
+    auto serverPromise = e.wrap(test.tlsServer.wrapServer(
+        zc::AuthenticatedStream{zc::mv(pipe.ends[1]), zc::LocalPeerIdentity::newInstance({})}));
+    auto client = clientPromise.wait(test.io.waitScope);
+    auto server = serverPromise.wait(test.io.waitScope);
+
+    auto clientId = client.peerIdentity.downcast<TlsPeerIdentity>();
+    auto serverId = server.peerIdentity.downcast<TlsPeerIdentity>();
+    ZC_EXPECT(clientId->getAlpnProtocol() == serverId->getAlpnProtocol());
+    return zc::str(clientId->getAlpnProtocol().orDefault("(none)"));
+  };
+
+  zc::StringPtr both[] = {"h2", "http/1.1"};
+  zc::StringPtr http11[] = {"http/1.1"};
+  zc::StringPtr other[] = {"spdy/3"};
+
+  // The server's preference wins.
+  ZC_EXPECT(connect(both, both) == "h2");
+  ZC_EXPECT(connect(zc::arrayPtr(both).slice(1, 2), both) == "http/1.1");
+  ZC_EXPECT(connect(both, http11) == "http/1.1");
+
+  // Without a protocol in common, or without ALPN on either side, there's none.
+  ZC_EXPECT(connect(both, other) == "(none)");
+  ZC_EXPECT(connect(both, nullptr) == "(none)");
+  ZC_EXPECT(connect(nullptr, both) == "(none)");
+}
+
 ZC_TEST("TLS multiple messages") {
   TlsTest test;
   ErrorNexus e;
@@ -587,6 +674,87 @@ ZC_TEST("TLS multiple messages") {
   ZC_ASSERT(buf == "qux"_zcb);
 }
 
+ZC_TEST("TLS pump from another stream") {
+  TlsTest test;
+  ErrorNexus e;
+
+  auto pipe = test.io.provider->newTwoWayPipe();
+
+  auto clientPromise = e.wrap(test.tlsClient.wrapClient(zc::mv(pipe.ends[0]), "example.com"));
+  auto serverPromise = e.wrap(test.tlsServer.wrapServer(zc::mv(pipe.ends[1])));
+
+  auto client = clientPromise.wait(test.io.waitScope);
+  auto server = serverPromise.wait(test.io.waitScope);
+
+  // Several records' worth, arriving in pieces.
+  auto data = heapArray<byte>(100000);
+  for (auto i : zc::indices(data)) data[i] = i * 7;
+  auto source = test.io.provider->newTwoWayPipe();
+  auto feedPromise = source.ends[0]
+                         ->write(data)
+                         .then([&]() { source.ends[0]->shutdownWrite(); })
+                         .eagerlyEvaluate(nullptr);
+  auto pumpPromise = source.ends[1]
+                         ->pumpTo(*client)
+                         .then([&](uint64_t n) {
+                           ZC_EXPECT(n == data.size());
+                           client->shutdownWrite();
+                         })
+                         .eagerlyEvaluate(nullptr);
+
+  ZC_EXPECT(server->readAllBytes().wait(test.io.waitScope) == data);
+  feedPromise.wait(test.io.waitScope);
+  pumpPromise.wait(test.io.waitScope);
+}
+
+ZC_TEST("TLS with kernelTls over TCP") {
+  // Uses kernel TLS for sending where the kernel has it, and works just the same where it doesn't.
+  auto clientOptions = TlsTest::defaultClient();
+  clientOptions.kernelTls = true;
+  auto serverOptions = TlsTest::defaultServer();
+  serverOptions.kernelTls = true;
+  TlsTest test(zc::mv(clientOptions), zc::mv(serverOptions));
+  ErrorNexus e;
+
+  auto& network = test.io.provider->getNetwork();
+  auto listener = network.parseAddress("127.0.0.1", 0).wait(test.io.waitScope)->listen();
+  auto acceptPromise = listener->accept();
+  auto address = network.parseAddress("127.0.0.1", listener->getPort()).wait(test.io.waitScope);
+  auto clientPromise = e.wrap(address->connect().then([&](Own<AsyncIoStream> stream) {
+    return test.tlsClient.wrapClient(zc::mv(stream), "example.com");
+  }));
+  auto serverPromise = e.wrap(acceptPromise.then(
+      [&](Own<AsyncIoStream> stream) { return test.tlsServer.wrapServer(zc::mv(stream)); }));
+
+  auto client = clientPromise.wait(test.io.waitScope);
+  auto server = serverPromise.wait(test.io.waitScope);
+
+  test.testConnection(*client, *server);
+  server->write("bar"_zcb).wait(test.io.waitScope);
+  auto buf = heapArray<byte>(3);
+  client->read(buf).wait(test.io.waitScope);
+  ZC_EXPECT(buf == "bar"_zcb);
+
+  auto data = heapArray<byte>(100000);
+  for (auto i : zc::indices(data)) data[i] = i * 7;
+  auto source = test.io.provider->newTwoWayPipe();
+  auto feedPromise = source.ends[0]
+                         ->write(data)
+                         .then([&]() { source.ends[0]->shutdownWrite(); })
+                         .eagerlyEvaluate(nullptr);
+  auto pumpPromise = source.ends[1]
+                         ->pumpTo(*client)
+                         .then([&](uint64_t n) {
+                           ZC_EXPECT(n == data.size());
+                           client->shutdownWrite();
+                         })
+                         .eagerlyEvaluate(nullptr);
+
+  ZC_EXPECT(server->readAllBytes().wait(test.io.waitScope) == data);
+  feedPromise.wait(test.io.waitScope);
+  pumpPromise.wait(test.io.waitScope);
+}
+
 ZC_TEST("TLS zero-sized write") {
   TlsTest test;
   ErrorNexus e;
@@ -732,6 +900,56 @@ void expectInvalidCert(zc::StringPtr hostname, TlsCertificate cert, zc::StringPt
       .wait(test.io.waitScope);
 }
 
+class ThreadRecordingSniCallback final : public TlsSniCallback {
+public:
+  zc::Maybe<TlsKeypair> getKey(zc::StringPtr hostname) override {
+    calledOn = std::this_thread::get_id();
+    return zc::none;
+  }
+
+  std::thread::id calledOn;
+};
+
+ZC_TEST("TLS handshakes on a WorkerPool") {
+  WorkerPool pool(2);
+  ThreadRecordingSniCallback callback;
+
+  auto clientOptions = TlsTest::defaultClient();
+  clientOptions.handshakeWorkers = pool;
+  auto serverOptions = TlsTest::defaultServer();
+  serverOptions.handshakeWorkers = pool;
+  serverOptions.sniCallback = callback;
+  TlsTest test(zc::mv(clientOptions), zc::mv(serverOptions));
+
+  {
+    ErrorNexus e;
+    Vector<Promise<Own<AsyncIoStream>>> clientPromises;
+    Vector<Promise<Own<AsyncIoStream>>> serverPromises;
+    for (uint i = 0; i < 4; i++) {
+      auto pipe = test.io.provider->newTwoWayPipe();
+      clientPromises.add(e.wrap(test.tlsClient.wrapClient(zc::mv(pipe.ends[0]), "example.com")));
+      serverPromises.add(e.wrap(test.tlsServer.wrapServer(zc::mv(pipe.ends[1]))));
+    }
+    auto clients = joinPromises(clientPromises.releaseAsArray()).wait(test.io.waitScope);
+    auto servers = joinPromises(serverPromises.releaseAsArray()).wait(test.io.waitScope);
+
+    for (auto i : zc::indices(clients)) {
+      test.testConnection(*clients[i], *servers[i]);
+      test.testConnection(*servers[i], *clients[i]);
+    }
+    ZC_EXPECT(callback.calledOn != std::this_thread::get_id());
+  }
+
+  // A connection dropped mid-handshake waits for the step running on the pool.
+  {
+    auto pipe = test.io.provider->newTwoWayPipe();
+    auto clientPromise = test.tlsClient.wrapClient(zc::mv(pipe.ends[0]), "example.com");
+    auto serverPromise = test.tlsServer.wrapServer(zc::mv(pipe.ends[1]));
+    clientPromise.poll(test.io.waitScope);
+    serverPromise.poll(test.io.waitScope);
+  }
+}
+
 ZC_TEST("TLS certificate validation") {
   // Where we've given two possible error texts below, it's because OpenSSL v1 produces the former
   // text while v3 produces the latter. Note that as of this writing, our Windows CI build claims
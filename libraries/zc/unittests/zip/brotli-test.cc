@@ -304,6 +304,32 @@ ZC_TEST("brotli compression") {
   }
 }
 
+ZC_TEST("brotli one-shot compression") {
+  auto text = zc::strArray(zc::repeat("foobar"_zc, 100), "");
+  auto compressed = zc::heapArray<byte>(brotliCompressBound(text.size()));
+  auto used = brotliCompress(text.asBytes(), compressed);
+  ZC_EXPECT(used.begin() == compressed.begin());
+  ZC_EXPECT(used.size() < text.size());
+
+  {
+    MockInputStream rawInput(used, zc::maxValue);
+    BrotliInputStream brotli(rawInput);
+    ZC_EXPECT(brotli.readAllText() == text);
+  }
+
+  auto decompressed = zc::heapArray<byte>(text.size());
+  ZC_EXPECT(brotliDecompress(used, decompressed) == text.asBytes());
+
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          brotliCompress(text.asBytes(), compressed.first(3)));
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          brotliDecompress(used, decompressed.first(text.size() - 1)));
+  ZC_EXPECT_THROW_MESSAGE("ended prematurely",
+                          brotliDecompress(used.first(used.size() - 1), decompressed));
+  ZC_EXPECT_THROW_MESSAGE("trailing data", brotliDecompress(compressed.first(used.size() + 1),
+                                                            decompressed));
+}
+
 ZC_TEST("brotli huge round trip") {
   auto bytes = heapArray<byte>(96 * 1024);
   for (auto& b : bytes) { b = rand(); }
@@ -367,6 +393,30 @@ ZC_TEST("async brotli compression") {
   }
 }
 
+ZC_TEST("async brotli compression with pooled contexts") {
+  auto io = setupAsyncIo();
+  BrotliContextPool pool(1, ZC_BROTLI_DEFAULT_QUALITY);
+
+  for (auto text : {"foobar"_zc, "bazqux"_zc, "foobar"_zc}) {
+    MockAsyncOutputStream rawOutput;
+    {
+      BrotliAsyncOutputStream brotli(rawOutput, pool.get());
+      ZC_EXPECT(pool.getIdleCount() == 0);
+      brotli.write(text.asBytes()).wait(io.waitScope);
+      brotli.end().wait(io.waitScope);
+    }
+    ZC_EXPECT(pool.getIdleCount() == 1);
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == text);
+  }
+
+  // Only `maxIdle` contexts are kept.
+  auto first = pool.get();
+  auto second = pool.get();
+  first = nullptr;
+  second = nullptr;
+  ZC_EXPECT(pool.getIdleCount() == 1);
+}
+
 ZC_TEST("async brotli huge round trip") {
   auto io = setupAsyncIo();
 
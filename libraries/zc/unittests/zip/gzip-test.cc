@@ -261,6 +261,40 @@ ZC_TEST("gzip compression") {
   }
 }
 
+ZC_TEST("gzip one-shot compression") {
+  auto text = zc::strArray(zc::repeat("foobar"_zc, 100), "");
+  auto compressed = zc::heapArray<byte>(gzipCompressBound(text.size()));
+  auto used = gzipCompress(text.asBytes(), compressed);
+  ZC_EXPECT(used.begin() == compressed.begin());
+  ZC_EXPECT(used.size() < text.size());
+
+  {
+    MockInputStream rawInput(used, zc::maxValue);
+    GzipInputStream gzip(rawInput);
+    ZC_EXPECT(gzip.readAllText() == text);
+  }
+
+  // The thread's context is reused by the next call.
+  auto empty = gzipCompress(nullptr, compressed.slice(used.size()));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(gzipDecompressedSize(empty)) == 0);
+
+  ZC_EXPECT(ZC_ASSERT_NONNULL(gzipDecompressedSize(used)) == text.size());
+  auto decompressed = zc::heapArray<byte>(text.size());
+  ZC_EXPECT(gzipDecompress(used, decompressed) == text.asBytes());
+  ZC_EXPECT(gzipDecompress(empty, decompressed).size() == 0);
+  ZC_EXPECT(gzipDecompress(FOOBAR_GZIP, decompressed) == "foobar"_zcb);
+
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          gzipCompress(text.asBytes(), compressed.first(10)));
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          gzipDecompress(used, decompressed.first(text.size() - 1)));
+  ZC_EXPECT_THROW_MESSAGE("ended prematurely",
+                          gzipDecompress(used.first(used.size() - 1), decompressed));
+  ZC_EXPECT_THROW_MESSAGE("trailing data", gzipDecompress(compressed.first(used.size() + 1),
+                                                          decompressed));
+  ZC_EXPECT(gzipDecompressedSize(used.first(10)) == zc::none);
+}
+
 ZC_TEST("gzip huge round trip") {
   auto bytes = heapArray<byte>(65536);
   for (auto& b : bytes) { b = rand(); }
@@ -325,6 +359,64 @@ ZC_TEST("async gzip compression") {
   }
 }
 
+ZC_TEST("async gzip compression with pooled contexts") {
+  auto io = setupAsyncIo();
+  GzipContextPool pool(1, Z_DEFAULT_COMPRESSION);
+
+  for (auto text : {"foobar"_zc, "bazqux"_zc, "foobar"_zc}) {
+    MockAsyncOutputStream rawOutput;
+    {
+      GzipAsyncOutputStream gzip(rawOutput, pool.get());
+      ZC_EXPECT(pool.getIdleCount() == 0);
+      gzip.write(text.asBytes()).wait(io.waitScope);
+      gzip.end().wait(io.waitScope);
+    }
+    ZC_EXPECT(pool.getIdleCount() == 1);
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == text);
+  }
+
+  // Only `maxIdle` contexts are kept.
+  auto first = pool.get();
+  auto second = pool.get();
+  first = nullptr;
+  second = nullptr;
+  ZC_EXPECT(pool.getIdleCount() == 1);
+}
+
+ZC_TEST("async parallel gzip compression") {
+  auto io = setupAsyncIo();
+  WorkerPool pool(3);
+
+  zc::Vector<byte> input;
+  for (uint i = 0; i < 20000; i++) {
+    input.addAll(zc::str("line ", i % 1000, ": ", rand() % 100, "\n").asBytes());
+  }
+
+  for (size_t blockSize : {size_t(64 * 1024), size_t(1000)}) {
+    MockAsyncOutputStream rawOutput;
+    ParallelGzipAsyncOutputStream gzip(rawOutput, pool, Z_DEFAULT_COMPRESSION, blockSize, 2);
+
+    // Writes of odd sizes, straddling blocks.
+    for (size_t i = 0; i < input.size(); i += 7777) {
+      gzip.write(input.slice(i, zc::min(i + 7777, input.size()))).wait(io.waitScope);
+    }
+    gzip.end().wait(io.waitScope);
+
+    ZC_EXPECT(rawOutput.bytes.size() < input.size() / 3, rawOutput.bytes.size());
+    MockInputStream rawInput(rawOutput.bytes, zc::maxValue);
+    GzipInputStream gunzip(rawInput);
+    ZC_EXPECT(gunzip.readAllBytes() == input);
+  }
+
+  // An empty stream.
+  {
+    MockAsyncOutputStream rawOutput;
+    ParallelGzipAsyncOutputStream gzip(rawOutput, pool);
+    gzip.end().wait(io.waitScope);
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == "");
+  }
+}
+
 ZC_TEST("async gzip huge round trip") {
   auto io = setupAsyncIo();
 
@@ -0,0 +1,467 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#if ZC_HAS_ZSTD
+
+#include "zc/zip/zstd.h"
+
+#include <stdlib.h>
+
+#include "zc/core/debug.h"
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace {
+
+class MockInputStream : public InputStream {
+public:
+  MockInputStream(zc::ArrayPtr<const byte> bytes, size_t blockSize)
+      : bytes(bytes), blockSize(blockSize) {}
+
+  size_t tryRead(ArrayPtr<byte> buffer, size_t minBytes) override {
+    // Clamp max read to blockSize.
+    size_t n = zc::min(blockSize, buffer.size());
+
+    // Unless that's less than minBytes -- in which case, use minBytes.
+    n = zc::max(n, minBytes);
+
+    // But also don't read more data than we have.
+    n = zc::min(n, bytes.size());
+
+    memcpy(buffer.begin(), bytes.begin(), n);
+    bytes = bytes.slice(n, bytes.size());
+    return n;
+  }
+
+private:
+  zc::ArrayPtr<const byte> bytes;
+  size_t blockSize;
+};
+
+class MockAsyncInputStream : public AsyncInputStream {
+public:
+  MockAsyncInputStream(zc::ArrayPtr<const byte> bytes, size_t blockSize)
+      : bytes(bytes), blockSize(blockSize) {}
+
+  Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override {
+    // Clamp max read to blockSize.
+    size_t n = zc::min(blockSize, maxBytes);
+
+    // Unless that's less than minBytes -- in which case, use minBytes.
+    n = zc::max(n, minBytes);
+
+    // But also don't read more data than we have.
+    n = zc::min(n, bytes.size());
+
+    memcpy(buffer, bytes.begin(), n);
+    bytes = bytes.slice(n, bytes.size());
+    return n;
+  }
+
+private:
+  zc::ArrayPtr<const byte> bytes;
+  size_t blockSize;
+};
+
+class MockOutputStream : public OutputStream {
+public:
+  zc::Vector<byte> bytes;
+
+  zc::String decompress(zc::Maybe<const ZstdDictionary&> dictionary = zc::none) {
+    MockInputStream rawInput(bytes, zc::maxValue);
+    ZstdInputStream zstd(rawInput, dictionary);
+    return zstd.readAllText();
+  }
+
+  void write(ArrayPtr<const byte> data) override { bytes.addAll(data); }
+};
+
+class MockAsyncOutputStream : public AsyncOutputStream {
+public:
+  zc::Vector<byte> bytes;
+
+  zc::String decompress(WaitScope& ws) {
+    MockAsyncInputStream rawInput(bytes, zc::maxValue);
+    ZstdAsyncInputStream zstd(rawInput);
+    return zstd.readAllText().wait(ws);
+  }
+
+  Promise<void> write(ArrayPtr<const byte> buffer) override {
+    bytes.addAll(buffer);
+    return zc::READY_NOW;
+  }
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override {
+    for (auto& piece : pieces) { bytes.addAll(piece); }
+    return zc::READY_NOW;
+  }
+
+  Promise<void> whenWriteDisconnected() override { ZC_UNIMPLEMENTED("not used"); }
+};
+
+zc::Array<byte> compressFrame(zc::StringPtr text) {
+  auto compressed = zc::heapArray<byte>(zstdCompressBound(text.size()));
+  auto size = zstdCompress(text.asBytes(), compressed).size();
+  return zc::heapArray(compressed.first(size));
+}
+
+ZC_TEST("zstd decompression") {
+  auto foobar = compressFrame("foobar");
+
+  // Normal read.
+  {
+    MockInputStream rawInput(foobar, zc::maxValue);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText() == "foobar");
+  }
+
+  // Force read one byte at a time.
+  {
+    MockInputStream rawInput(foobar, 1);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText() == "foobar");
+  }
+
+  // Read truncated input.
+  {
+    MockInputStream rawInput(foobar.first(foobar.size() - 1), zc::maxValue);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT_THROW_MESSAGE("zstd compressed stream ended prematurely", zstd.readAllText());
+  }
+
+  // Frames one after another read as one stream.
+  {
+    auto bazqux = compressFrame("bazqux");
+    auto concatenated = zc::heapArray<byte>(foobar.size() + bazqux.size());
+    concatenated.first(foobar.size()).copyFrom(foobar);
+    concatenated.slice(foobar.size()).copyFrom(bazqux);
+
+    MockInputStream rawInput(concatenated, 3);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText() == "foobarbazqux");
+  }
+
+  // Corrupt input.
+  {
+    MockInputStream rawInput("foobarbazqux"_zcb, zc::maxValue);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT_THROW_MESSAGE("zstd decompression failed", zstd.readAllText());
+  }
+
+  // Decompressing through an output stream.
+  {
+    MockOutputStream rawOutput;
+    {
+      ZstdOutputStream zstd(rawOutput, ZstdOutputStream::DECOMPRESS);
+      zstd.write(foobar);
+    }
+    ZC_EXPECT(rawOutput.bytes.asPtr() == "foobar"_zcb);
+
+    MockOutputStream truncated;
+    ZC_EXPECT_THROW_MESSAGE("zstd compressed stream ended prematurely", [&]() {
+      ZstdOutputStream zstd(truncated, ZstdOutputStream::DECOMPRESS);
+      zstd.write(foobar.first(foobar.size() - 1));
+    }());
+  }
+}
+
+ZC_TEST("async zstd decompression") {
+  auto io = setupAsyncIo();
+  auto foobar = compressFrame("foobar");
+
+  // Normal read.
+  {
+    MockAsyncInputStream rawInput(foobar, zc::maxValue);
+    ZstdAsyncInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText().wait(io.waitScope) == "foobar");
+  }
+
+  // Force read one byte at a time.
+  {
+    MockAsyncInputStream rawInput(foobar, 1);
+    ZstdAsyncInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText().wait(io.waitScope) == "foobar");
+  }
+
+  // Read truncated input.
+  {
+    MockAsyncInputStream rawInput(foobar.first(foobar.size() - 1), zc::maxValue);
+    ZstdAsyncInputStream zstd(rawInput);
+    ZC_EXPECT_THROW_MESSAGE("zstd compressed stream ended prematurely",
+                            zstd.readAllText().wait(io.waitScope));
+  }
+
+  // Decompressing through an output stream.
+  {
+    MockAsyncOutputStream rawOutput;
+    ZstdAsyncOutputStream zstd(rawOutput, ZstdAsyncOutputStream::DECOMPRESS);
+    zstd.write(foobar).wait(io.waitScope);
+    zstd.end().wait(io.waitScope);
+    ZC_EXPECT(rawOutput.bytes.asPtr() == "foobar"_zcb);
+  }
+}
+
+ZC_TEST("zstd compression") {
+  // Normal write.
+  {
+    MockOutputStream rawOutput;
+    {
+      ZstdOutputStream zstd(rawOutput);
+      zstd.write("foobar"_zcb);
+    }
+
+    ZC_EXPECT(rawOutput.decompress() == "foobar");
+  }
+
+  // Multi-part write.
+  {
+    MockOutputStream rawOutput;
+    {
+      ZstdOutputStream zstd(rawOutput);
+      zstd.write("foo"_zcb);
+      zstd.write("bar"_zcb);
+    }
+
+    ZC_EXPECT(rawOutput.decompress() == "foobar");
+  }
+
+  // Array-of-arrays write.
+  {
+    MockOutputStream rawOutput;
+
+    {
+      ZstdOutputStream zstd(rawOutput);
+
+      ArrayPtr<const byte> pieces[] = {
+          "foo"_zcb,
+          "bar"_zcb,
+      };
+      zstd.write(pieces);
+    }
+
+    ZC_EXPECT(rawOutput.decompress() == "foobar");
+  }
+
+  MockOutputStream rawOutput;
+  ZC_EXPECT_THROW_MESSAGE("invalid zstd compression level",
+                          ZstdOutputStream(rawOutput, ZSTD_maxCLevel() + 1));
+}
+
+ZC_TEST("zstd compression with a dictionary") {
+  auto dictionaryText = zc::str("{\"user\": \"\", \"action\": \"login\", \"status\": \"ok\"}");
+  ZstdDictionary dictionary(dictionaryText.asBytes());
+  ZC_EXPECT(dictionary.getId() == 0);
+
+  auto message = "{\"user\": \"alice\", \"action\": \"login\", \"status\": \"ok\"}"_zc;
+
+  MockOutputStream plain;
+  {
+    ZstdOutputStream zstd(plain);
+    zstd.write(message.asBytes());
+  }
+
+  MockOutputStream withDictionary;
+  {
+    ZstdOutputStream zstd(withDictionary, ZC_ZSTD_DEFAULT_LEVEL, {.dictionary = dictionary});
+    zstd.write(message.asBytes());
+  }
+
+  ZC_EXPECT(withDictionary.bytes.size() < plain.bytes.size(), withDictionary.bytes.size(),
+            plain.bytes.size());
+  ZC_EXPECT(withDictionary.decompress(dictionary) == message);
+  ZC_EXPECT_THROW_MESSAGE("zstd decompression failed", withDictionary.decompress());
+
+  // One-shot, too.
+  auto compressed = zc::heapArray<byte>(zstdCompressBound(message.size()));
+  auto used = zstdCompress(message.asBytes(), compressed, ZC_ZSTD_DEFAULT_LEVEL, dictionary);
+  ZC_EXPECT(used.size() < plain.bytes.size());
+  auto decompressed = zc::heapArray<byte>(message.size());
+  ZC_EXPECT(zstdDecompress(used, decompressed, dictionary) == message.asBytes());
+  ZC_EXPECT_THROW_MESSAGE("zstd decompression failed", zstdDecompress(used, decompressed));
+}
+
+ZC_TEST("zstd multithreaded compression") {
+  auto bytes = heapArray<byte>(4 * 1024 * 1024);
+  for (size_t i = 0; i < bytes.size(); i++) { bytes[i] = (i * 7 + i / 4096) % 251; }
+
+  ZstdOptions options{.workers = 2};
+  if (ZSTD_cParam_getBounds(ZSTD_c_nbWorkers).upperBound == 0) {
+    MockOutputStream rawOutput;
+    ZC_EXPECT_THROW_MESSAGE("zstd multithreaded compression is unavailable",
+                            ZstdOutputStream(rawOutput, ZC_ZSTD_DEFAULT_LEVEL, options));
+    return;
+  }
+
+  MockOutputStream rawOutput;
+  {
+    ZstdOutputStream zstd(rawOutput, ZC_ZSTD_DEFAULT_LEVEL, options);
+    for (size_t i = 0; i < bytes.size(); i += 100000) {
+      zstd.write(bytes.slice(i, zc::min(i + 100000, bytes.size())));
+    }
+  }
+
+  MockInputStream rawInput(rawOutput.bytes, zc::maxValue);
+  ZstdInputStream zstdIn(rawInput);
+  ZC_ASSERT(zstdIn.readAllBytes() == bytes);
+}
+
+ZC_TEST("zstd one-shot compression") {
+  auto text = zc::strArray(zc::repeat("foobar"_zc, 100), "");
+  auto compressed = zc::heapArray<byte>(zstdCompressBound(text.size()));
+  auto used = zstdCompress(text.asBytes(), compressed);
+  ZC_EXPECT(used.begin() == compressed.begin());
+  ZC_EXPECT(used.size() < text.size());
+  ZC_EXPECT(ZC_ASSERT_NONNULL(zstdDecompressedSize(used)) == text.size());
+
+  {
+    MockInputStream rawInput(used, zc::maxValue);
+    ZstdInputStream zstd(rawInput);
+    ZC_EXPECT(zstd.readAllText() == text);
+  }
+
+  auto decompressed = zc::heapArray<byte>(text.size());
+  ZC_EXPECT(zstdDecompress(used, decompressed) == text.asBytes());
+
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          zstdCompress(text.asBytes(), compressed.first(3)));
+  ZC_EXPECT_THROW_MESSAGE("output buffer is too small",
+                          zstdDecompress(used, decompressed.first(text.size() - 1)));
+  // Cut short of the checksum, or it would just fail to match.
+  ZC_EXPECT_THROW_MESSAGE("ended prematurely",
+                          zstdDecompress(used.first(used.size() - 5), decompressed));
+
+  // A stream written a piece at a time doesn't record its size.
+  MockOutputStream rawOutput;
+  {
+    ZstdOutputStream zstd(rawOutput);
+    zstd.write(text.asBytes());
+  }
+  ZC_EXPECT(zstdDecompressedSize(rawOutput.bytes) == zc::none);
+}
+
+ZC_TEST("zstd huge round trip") {
+  auto bytes = heapArray<byte>(96 * 1024);
+  for (auto& b : bytes) { b = rand(); }
+
+  MockOutputStream rawOutput;
+  {
+    ZstdOutputStream zstdOut(rawOutput);
+    zstdOut.write(bytes);
+  }
+
+  MockInputStream rawInput(rawOutput.bytes, zc::maxValue);
+  ZstdInputStream zstdIn(rawInput);
+  auto decompressed = zstdIn.readAllBytes();
+
+  ZC_ASSERT(bytes == decompressed);
+}
+
+ZC_TEST("async zstd compression") {
+  auto io = setupAsyncIo();
+  // Normal write.
+  {
+    MockAsyncOutputStream rawOutput;
+    ZstdAsyncOutputStream zstd(rawOutput);
+    zstd.write("foobar"_zcb).wait(io.waitScope);
+    zstd.end().wait(io.waitScope);
+
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == "foobar");
+  }
+
+  // Multi-part write.
+  {
+    MockAsyncOutputStream rawOutput;
+    ZstdAsyncOutputStream zstd(rawOutput);
+
+    zstd.write("foo"_zcb).wait(io.waitScope);
+    auto prevSize = rawOutput.bytes.size();
+
+    zstd.write("bar"_zcb).wait(io.waitScope);
+    auto curSize = rawOutput.bytes.size();
+    ZC_EXPECT(prevSize == curSize, prevSize, curSize);
+
+    zstd.flush().wait(io.waitScope);
+    curSize = rawOutput.bytes.size();
+    ZC_EXPECT(prevSize < curSize, prevSize, curSize);
+
+    zstd.end().wait(io.waitScope);
+
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == "foobar");
+  }
+
+  // Array-of-arrays write.
+  {
+    MockAsyncOutputStream rawOutput;
+    ZstdAsyncOutputStream zstd(rawOutput);
+
+    ArrayPtr<const byte> pieces[] = {"foo"_zcb, "bar"_zcb};
+    zstd.write(pieces).wait(io.waitScope);
+    zstd.end().wait(io.waitScope);
+
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == "foobar");
+  }
+}
+
+ZC_TEST("async zstd compression with pooled contexts") {
+  auto io = setupAsyncIo();
+  ZstdContextPool pool(1, ZC_ZSTD_DEFAULT_LEVEL);
+
+  for (auto text : {"foobar"_zc, "bazqux"_zc, "foobar"_zc}) {
+    MockAsyncOutputStream rawOutput;
+    {
+      ZstdAsyncOutputStream zstd(rawOutput, pool.get());
+      ZC_EXPECT(pool.getIdleCount() == 0);
+      zstd.write(text.asBytes()).wait(io.waitScope);
+      zstd.end().wait(io.waitScope);
+    }
+    ZC_EXPECT(pool.getIdleCount() == 1);
+    ZC_EXPECT(rawOutput.decompress(io.waitScope) == text);
+  }
+
+  // Only `maxIdle` contexts are kept.
+  auto first = pool.get();
+  auto second = pool.get();
+  first = nullptr;
+  second = nullptr;
+  ZC_EXPECT(pool.getIdleCount() == 1);
+}
+
+ZC_TEST("async zstd huge round trip") {
+  auto io = setupAsyncIo();
+
+  auto bytes = heapArray<byte>(65536);
+  for (auto& b : bytes) { b = rand(); }
+
+  MockAsyncOutputStream rawOutput;
+  ZstdAsyncOutputStream zstdOut(rawOutput);
+  zstdOut.write(bytes).wait(io.waitScope);
+  zstdOut.end().wait(io.waitScope);
+
+  MockAsyncInputStream rawInput(rawOutput.bytes, zc::maxValue);
+  ZstdAsyncInputStream zstdIn(rawInput);
+  auto decompressed = zstdIn.readAllBytes().wait(io.waitScope);
+
+  ZC_ASSERT(bytes == decompressed);
+}
+
+}  // namespace
+}  // namespace zc
+
+#endif  // ZC_HAS_ZSTD
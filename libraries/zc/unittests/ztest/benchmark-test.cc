@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/ztest/benchmark.h"
+
+#include <math.h>
+
+#include "zc/ztest/test.h"
+
+namespace zc {
+namespace _ {
+namespace {
+
+ZC_TEST("summarizeSamples") {
+  double samples[] = {5, 1, 3, 2, 4};
+  auto stats = summarizeSamples(samples);
+  ZC_EXPECT(stats.median == 3);
+  ZC_EXPECT(stats.p99 == 5);
+  ZC_EXPECT(stats.mean == 3);
+  ZC_EXPECT(fabs(stats.stddev - sqrt(2.5)) < 1e-9);
+  ZC_EXPECT(samples[0] == 1 && samples[4] == 5);
+
+  // An even count takes the mean of the middle two, and nearest rank keeps p99 a sample.
+  double evenSamples[] = {10, 40, 20, 30};
+  stats = summarizeSamples(evenSamples);
+  ZC_EXPECT(stats.median == 25);
+  ZC_EXPECT(stats.p99 == 40);
+
+  double oneSample[] = {7};
+  stats = summarizeSamples(oneSample);
+  ZC_EXPECT(stats.median == 7 && stats.p99 == 7 && stats.stddev == 0);
+}
+
+uint benchmarkCalls = 0;
+uint variantCalls = 0;
+
+ZC_BENCHMARK("counting calls") {
+  benchmark.setItemsPerIteration(1);
+  benchmark.run([&]() { doNotOptimize(++benchmarkCalls); });
+  benchmark.run("variant", [&]() { doNotOptimize(++variantCalls); });
+}
+
+ZC_TEST("ZC_BENCHMARK runs its function") {
+  // Unless measuring, each run calls its function once; the benchmark above has run by now.
+  ZC_EXPECT(benchmarkCalls >= 1);
+  ZC_EXPECT(variantCalls >= 1);
+}
+
+}  // namespace
+}  // namespace _
+}  // namespace zc
@@ -23,6 +23,10 @@
 
 #include "zc/zip/brotli.h"
 
+#include <stdlib.h>
+
+#include <cstddef>
+
 #include "zc/core/debug.h"
 
 namespace zc {
@@ -51,22 +55,22 @@ int getBrotliWindowBits(zc::byte peek) {
 
 namespace _ {  // private
 
-BrotliOutputContext::BrotliOutputContext(zc::Maybe<int> compressionLevel,
+struct BrotliOutputContext::Block {
+  // Precedes each block allocated for brotli's state.
+  alignas(alignof(std::max_align_t)) size_t size;
+  Block* next;
+};
+
+BrotliOutputContext::BrotliOutputContext(zc::Maybe<int> compressionLevelParam,
                                          zc::Maybe<int> windowBitsParam)
     : nextIn(nullptr), availableIn(0) {
-  ZC_IF_SOME(level, compressionLevel) {
+  ZC_IF_SOME(level, compressionLevelParam) {
     // Emulate zlib's behavior of using -1 to signify the default quality
     if (level == -1) { level = ZC_BROTLI_DEFAULT_QUALITY; }
     ZC_REQUIRE(level >= BROTLI_MIN_QUALITY && level <= BROTLI_MAX_QUALITY,
                "invalid brotli compression level", level);
+    compressionLevel = level;
     windowBits = windowBitsParam.orDefault(_::ZC_BROTLI_DEFAULT_WBITS);
-    ZC_REQUIRE(windowBits >= BROTLI_MIN_WINDOW_BITS && windowBits <= BROTLI_MAX_WINDOW_BITS,
-               "invalid brotli window size", windowBits);
-    BrotliEncoderState* cctx = BrotliEncoderCreateInstance(nullptr, nullptr, nullptr);
-    ZC_REQUIRE(cctx, "brotli state allocation failed");
-    ZC_ASSERT(BrotliEncoderSetParameter(cctx, BROTLI_PARAM_QUALITY, level) == BROTLI_TRUE);
-    ZC_ASSERT(BrotliEncoderSetParameter(cctx, BROTLI_PARAM_LGWIN, windowBits) == BROTLI_TRUE);
-    ctx = cctx;
   }
   else {
     // In the decoder, we manually check that the stream does not have a higher window size than
@@ -74,21 +78,93 @@ BrotliOutputContext::BrotliOutputContext(zc::Maybe<int> compressionLevel,
     // By default, we accept streams with a window size up to (1 << ZC_BROTLI_MAX_DEC_WBITS),
     // this is more than the default window size for compression (i.e. ZC_BROTLI_DEFAULT_WBITS)
     windowBits = windowBitsParam.orDefault(_::ZC_BROTLI_MAX_DEC_WBITS);
-    ZC_REQUIRE(windowBits >= BROTLI_MIN_WINDOW_BITS && windowBits <= BROTLI_MAX_WINDOW_BITS,
-               "invalid brotli window size", windowBits);
-    BrotliDecoderState* dctx = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+  }
+  ZC_REQUIRE(windowBits >= BROTLI_MIN_WINDOW_BITS && windowBits <= BROTLI_MAX_WINDOW_BITS,
+             "invalid brotli window size", windowBits);
+  createState();
+}
+
+BrotliOutputContext::~BrotliOutputContext() noexcept(false) {
+  destroyState();
+  while (spareBlocks != nullptr) {
+    Block* block = spareBlocks;
+    spareBlocks = block->next;
+    free(block);
+  }
+}
+
+void BrotliOutputContext::createState() {
+  ZC_IF_SOME(level, compressionLevel) {
+    BrotliEncoderState* cctx = BrotliEncoderCreateInstance(&allocBlock, &freeBlock, this);
+    ZC_REQUIRE(cctx, "brotli state allocation failed");
+    ZC_ASSERT(BrotliEncoderSetParameter(cctx, BROTLI_PARAM_QUALITY, level) == BROTLI_TRUE);
+    ZC_ASSERT(BrotliEncoderSetParameter(cctx, BROTLI_PARAM_LGWIN, windowBits) == BROTLI_TRUE);
+    ctx = cctx;
+  }
+  else {
+    BrotliDecoderState* dctx = BrotliDecoderCreateInstance(&allocBlock, &freeBlock, this);
     ZC_REQUIRE(dctx, "brotli state allocation failed");
     ctx = dctx;
   }
 }
 
-BrotliOutputContext::~BrotliOutputContext() noexcept(false) {
+void BrotliOutputContext::destroyState() {
   ZC_SWITCH_ONEOF(ctx) {
     ZC_CASE_ONEOF(cctx, BrotliEncoderState*) { BrotliEncoderDestroyInstance(cctx); }
     ZC_CASE_ONEOF(dctx, BrotliDecoderState*) { BrotliDecoderDestroyInstance(dctx); }
   }
 }
 
+void BrotliOutputContext::reset() {
+  // Only the blocks of the last stream are kept: any left over from the one before weren't needed.
+  while (spareBlocks != nullptr) {
+    Block* block = spareBlocks;
+    spareBlocks = block->next;
+    free(block);
+  }
+
+  recycling = true;
+  destroyState();
+  recycling = false;
+  createState();
+
+  nextIn = nullptr;
+  availableIn = 0;
+  firstInput = true;
+}
+
+void* BrotliOutputContext::allocBlock(void* opaque, size_t size) {
+  auto& context = *reinterpret_cast<BrotliOutputContext*>(opaque);
+
+  // Brotli asks for the same handful of sizes for every stream with the same parameters, so an
+  // exact match is all we look for.
+  for (Block** link = &context.spareBlocks; *link != nullptr; link = &(*link)->next) {
+    Block* block = *link;
+    if (block->size == size) {
+      *link = block->next;
+      return block + 1;
+    }
+  }
+
+  Block* block = reinterpret_cast<Block*>(malloc(sizeof(Block) + size));
+  if (block == nullptr) { return nullptr; }
+  block->size = size;
+  return block + 1;
+}
+
+void BrotliOutputContext::freeBlock(void* opaque, void* address) {
+  if (address == nullptr) { return; }
+  auto& context = *reinterpret_cast<BrotliOutputContext*>(opaque);
+
+  Block* block = reinterpret_cast<Block*>(address) - 1;
+  if (context.recycling) {
+    block->next = context.spareBlocks;
+    context.spareBlocks = block;
+  } else {
+    free(block);
+  }
+}
+
 void BrotliOutputContext::setInput(const void* in, size_t size) {
   nextIn = reinterpret_cast<const byte*>(in);
   availableIn = size;
@@ -311,14 +387,18 @@ Promise<size_t> BrotliAsyncInputStream::readImpl(byte* out, size_t minBytes, siz
 
 BrotliAsyncOutputStream::BrotliAsyncOutputStream(AsyncOutputStream& inner, int compressionLevel,
                                                  int windowBits)
-    : inner(inner), ctx(compressionLevel, windowBits) {}
+    : inner(inner), ctx(zc::heap<_::BrotliOutputContext>(compressionLevel, windowBits)) {}
 
 BrotliAsyncOutputStream::BrotliAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS),
                                                  int windowBits)
-    : inner(inner), ctx(zc::none, windowBits) {}
+    : inner(inner), ctx(zc::heap<_::BrotliOutputContext>(zc::none, windowBits)) {}
+
+BrotliAsyncOutputStream::BrotliAsyncOutputStream(AsyncOutputStream& inner,
+                                                 zc::Own<_::BrotliOutputContext> ctx)
+    : inner(inner), ctx(zc::mv(ctx)) {}
 
 Promise<void> BrotliAsyncOutputStream::write(ArrayPtr<const byte> buffer) {
-  ctx.setInput(buffer.begin(), buffer.size());
+  ctx->setInput(buffer.begin(), buffer.size());
   return pump(BROTLI_OPERATION_PROCESS);
 }
 
@@ -327,7 +407,7 @@ Promise<void> BrotliAsyncOutputStream::write(ArrayPtr<const ArrayPtr<const byte>
 }
 
 zc::Promise<void> BrotliAsyncOutputStream::pump(BrotliEncoderOperation flush) {
-  auto result = ctx.pumpOnce(flush);
+  auto result = ctx->pumpOnce(flush);
   auto ok = get<0>(result);
   auto chunk = get<1>(result);
 
@@ -346,6 +426,58 @@ zc::Promise<void> BrotliAsyncOutputStream::pump(BrotliEncoderOperation flush) {
   }
 }
 
+// =======================================================================================
+
+size_t brotliCompressBound(size_t inputSize) {
+  size_t bound = BrotliEncoderMaxCompressedSize(inputSize);
+  ZC_REQUIRE(bound > 0, "brotli input is too large", inputSize);
+  return bound;
+}
+
+ArrayPtr<byte> brotliCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                              int compressionLevel, int windowBits) {
+  // Emulate zlib's behavior of using -1 to signify the default quality
+  if (compressionLevel == -1) { compressionLevel = ZC_BROTLI_DEFAULT_QUALITY; }
+  ZC_REQUIRE(compressionLevel >= BROTLI_MIN_QUALITY && compressionLevel <= BROTLI_MAX_QUALITY,
+             "invalid brotli compression level", compressionLevel);
+  ZC_REQUIRE(windowBits >= BROTLI_MIN_WINDOW_BITS && windowBits <= BROTLI_MAX_WINDOW_BITS,
+             "invalid brotli window size", windowBits);
+
+  size_t outputSize = output.size();
+  BROTLI_BOOL result =
+      BrotliEncoderCompress(compressionLevel, windowBits, BROTLI_DEFAULT_MODE, input.size(),
+                            input.begin(), &outputSize, output.begin());
+  ZC_REQUIRE(result == BROTLI_TRUE, "brotliCompress() output buffer is too small", output.size());
+  return output.first(outputSize);
+}
+
+ArrayPtr<byte> brotliDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output) {
+  // BrotliDecoderDecompress() would do, but reports every failure alike.
+  BrotliDecoderState* ctx = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+  ZC_REQUIRE(ctx, "brotli state allocation failed");
+  ZC_DEFER(BrotliDecoderDestroyInstance(ctx));
+
+  const byte* nextIn = input.begin();
+  size_t availableIn = input.size();
+  byte* nextOut = output.begin();
+  size_t availableOut = output.size();
+  BrotliDecoderResult result =
+      BrotliDecoderDecompressStream(ctx, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+  switch (result) {
+    case BROTLI_DECODER_RESULT_SUCCESS:
+      ZC_REQUIRE(availableIn == 0, "brotli compressed stream has trailing data");
+      return output.first(output.size() - availableOut);
+    case BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT:
+      ZC_FAIL_REQUIRE("brotliDecompress() output buffer is too small", output.size());
+    case BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT:
+      ZC_FAIL_REQUIRE("brotli compressed stream ended prematurely");
+    case BROTLI_DECODER_RESULT_ERROR:
+      break;
+  }
+  ZC_FAIL_REQUIRE("brotli decompression failed",
+                  BrotliDecoderErrorString(BrotliDecoderGetErrorCode(ctx)));
+}
+
 }  // namespace zc
 
 #endif  // ZC_HAS_BROTLI
@@ -27,6 +27,7 @@
 #include "zc/async/async-io.h"
 #include "zc/core/io.h"
 #include "zc/core/one-of.h"
+#include "zc/zip/context-pool.h"
 
 ZC_BEGIN_HEADER
 
@@ -65,7 +66,13 @@ public:
   // Flush the stream. Parameter is ignored for decoding as brotli only uses an operation parameter
   // during encoding.
 
+  void reset();
+  // Readies the context for a new stream. Brotli can't reset its state in place, so this creates
+  // a new one, but the memory the old one allocated is kept to be handed to the new one as it
+  // asks for blocks of the same sizes.
+
 private:
+  zc::Maybe<int> compressionLevel;
   int windowBits;
   const byte* nextIn;
   size_t availableIn;
@@ -73,10 +80,25 @@ private:
 
   zc::OneOf<BrotliEncoderState*, BrotliDecoderState*> ctx;
   byte buffer[_::ZC_BROTLI_BUF_SIZE];
+
+  struct Block;
+  Block* spareBlocks = nullptr;
+  bool recycling = false;
+  // While reset() destroys the old state, the blocks it frees are put on the `spareBlocks` list
+  // rather than returned to the system.
+
+  void createState();
+  void destroyState();
+  static void* allocBlock(void* opaque, size_t size);
+  static void freeBlock(void* opaque, void* address);
 };
 
 }  // namespace _
 
+using BrotliContextPool = CompressionContextPool<_::BrotliOutputContext>;
+// Constructed with `maxIdle` and then the compression level, or none to decompress, and optionally
+// the window size.
+
 class BrotliInputStream final : public InputStream {
 public:
   BrotliInputStream(InputStream& inner, zc::Maybe<int> windowBits = zc::none);
@@ -160,6 +182,8 @@ public:
                           int windowBits = _::ZC_BROTLI_DEFAULT_WBITS);
   BrotliAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS),
                           int windowBits = _::ZC_BROTLI_MAX_DEC_WBITS);
+  BrotliAsyncOutputStream(AsyncOutputStream& inner, zc::Own<_::BrotliOutputContext> ctx);
+  // Uses a context from a BrotliContextPool.
   ZC_DISALLOW_COPY_AND_MOVE(BrotliAsyncOutputStream);
 
   Promise<void> write(ArrayPtr<const byte> buffer) override;
@@ -180,11 +204,28 @@ public:
 
 private:
   AsyncOutputStream& inner;
-  _::BrotliOutputContext ctx;
+  zc::Own<_::BrotliOutputContext> ctx;
 
   zc::Promise<void> pump(BrotliEncoderOperation flush);
 };
 
+// =======================================================================================
+// One-shot compression, like gzipCompress() and friends
+
+size_t brotliCompressBound(size_t inputSize);
+// The most bytes brotliCompress() can produce from `inputSize` bytes of input.
+
+ArrayPtr<byte> brotliCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                              int compressionLevel = ZC_BROTLI_DEFAULT_QUALITY,
+                              int windowBits = _::ZC_BROTLI_DEFAULT_WBITS);
+// Compresses `input` to a brotli stream in `output`, returning the part of `output` it takes.
+// Throws if `output` is too small, which it can't be if it's brotliCompressBound(input.size())
+// bytes.
+
+ArrayPtr<byte> brotliDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output);
+// Decompresses the brotli stream `input` into `output`, returning the part of `output` it takes.
+// Throws if `input` isn't exactly one complete brotli stream or if `output` is too small.
+
 }  // namespace zc
 
 ZC_END_HEADER
@@ -0,0 +1,98 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+
+#include "zc/core/exception.h"
+#include "zc/core/function.h"
+#include "zc/core/memory.h"
+#include "zc/core/vector.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+template <typename Context>
+class CompressionContextPool {
+  // Keeps the contexts of finished streams so that later streams can reuse them, rather than each
+  // allocate fresh compressor state -- hundreds of KB of it, for deflate or brotli. A context
+  // taken from the pool goes back to it, reset, when its Own is disposed, unless `maxIdle`
+  // contexts are idle already, in which case it's freed.
+  //
+  // See GzipContextPool, BrotliContextPool and ZstdContextPool. A pool isn't thread-safe, and
+  // every context taken from it must be disposed before it is.
+
+public:
+  template <typename... Params>
+  explicit CompressionContextPool(size_t maxIdle, Params... params)
+      : maxIdle(maxIdle),
+        newContext([params...]() { return new Context(params...); }),
+        disposer(*this) {}
+  // `params` are passed to the constructor of each context the pool creates.
+
+  ~CompressionContextPool() noexcept(false) {
+    for (auto context : idle) { delete context; }
+  }
+
+  ZC_DISALLOW_COPY_AND_MOVE(CompressionContextPool);
+
+  Own<Context> get() {
+    Context* context;
+    if (idle.empty()) {
+      context = newContext();
+    } else {
+      context = idle.back();
+      idle.removeLast();
+    }
+    return Own<Context>(context, disposer);
+  }
+
+  size_t getIdleCount() const { return idle.size(); }
+
+private:
+  class PoolDisposer final : public Disposer {
+  public:
+    explicit PoolDisposer(CompressionContextPool& pool) : pool(pool) {}
+
+    void disposeImpl(void* pointer) const override {
+      auto context = static_cast<Context*>(pointer);
+      if (pool.idle.size() < pool.maxIdle) {
+        ZC_ON_SCOPE_FAILURE(delete context);
+        context->reset();
+        pool.idle.add(context);
+      } else {
+        delete context;
+      }
+    }
+
+  private:
+    CompressionContextPool& pool;
+  };
+
+  size_t maxIdle;
+  Function<Context*()> newContext;
+  Vector<Context*> idle;
+  PoolDisposer disposer;
+};
+
+}  // namespace zc
+
+ZC_END_HEADER
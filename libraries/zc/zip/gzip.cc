@@ -22,11 +22,80 @@
 #include "zc/core/common.h"
 #if ZC_HAS_ZLIB
 
+#include <string.h>
+
 #include "zc/core/debug.h"
 #include "zc/zip/gzip.h"
 
 namespace zc {
 
+namespace {
+
+class ThreadDeflater {
+  // A deflate context for each thread, reused from one call to the next as long as it's asked for
+  // the same parameters.
+
+public:
+  ~ThreadDeflater() noexcept(false) {
+    if (initialized) { deflateEnd(&ctx); }
+  }
+
+  z_stream& get(int compressionLevel, int windowBits) {
+    if (initialized) {
+      if (compressionLevel == level && windowBits == this->windowBits) {
+        ZC_ASSERT(deflateReset(&ctx) == Z_OK);
+        return ctx;
+      }
+      deflateEnd(&ctx);
+      ctx = {};
+      initialized = false;
+    }
+
+    int result = deflateInit2(&ctx, compressionLevel, Z_DEFLATED, windowBits, 8,
+                              Z_DEFAULT_STRATEGY);
+    ZC_REQUIRE(result == Z_OK, "gzip compression failed", result);
+    initialized = true;
+    level = compressionLevel;
+    this->windowBits = windowBits;
+    return ctx;
+  }
+
+private:
+  z_stream ctx = {};
+  bool initialized = false;
+  int level = 0;
+  int windowBits = 0;
+};
+
+class ThreadInflater {
+  // A gzip inflate context for each thread, reused from one call to the next.
+
+public:
+  ~ThreadInflater() noexcept(false) {
+    if (initialized) { inflateEnd(&ctx); }
+  }
+
+  z_stream& get() {
+    if (initialized) {
+      ZC_ASSERT(inflateReset(&ctx) == Z_OK);
+    } else {
+      // windowBits = 15 (maximum) + magic value 16 to ask for gzip.
+      ZC_ASSERT(inflateInit2(&ctx, 15 + 16) == Z_OK);
+      initialized = true;
+    }
+    return ctx;
+  }
+
+private:
+  z_stream ctx = {};
+  bool initialized = false;
+};
+
+thread_local ThreadDeflater threadDeflater;
+thread_local ThreadInflater threadInflater;
+
+}  // namespace
+
 namespace _ {  // private
 
 GzipOutputContext::GzipOutputContext(zc::Maybe<int> compressionLevel) {
@@ -70,6 +139,11 @@ zc::Tuple<bool, zc::ArrayPtr<const byte>> GzipOutputContext::pumpOnce(int flush)
   return zc::tuple(result == Z_OK, zc::arrayPtr(buffer, sizeof(buffer) - ctx.avail_out));
 }
 
+void GzipOutputContext::reset() {
+  auto result = compressing ? deflateReset(&ctx) : inflateReset(&ctx);
+  if (result != Z_OK) { fail(result); }
+}
+
 void GzipOutputContext::fail(int result) {
   auto header = compressing ? "gzip compression failed" : "gzip decompression failed";
   if (ctx.msg == nullptr) {
@@ -226,13 +300,17 @@ Promise<size_t> GzipAsyncInputStream::readImpl(byte* out, size_t minBytes, size_
 // =======================================================================================
 
 GzipAsyncOutputStream::GzipAsyncOutputStream(AsyncOutputStream& inner, int compressionLevel)
-    : inner(inner), ctx(compressionLevel) {}
+    : inner(inner), ctx(zc::heap<_::GzipOutputContext>(compressionLevel)) {}
 
 GzipAsyncOutputStream::GzipAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS))
-    : inner(inner), ctx(zc::none) {}
+    : inner(inner), ctx(zc::heap<_::GzipOutputContext>(zc::none)) {}
+
+GzipAsyncOutputStream::GzipAsyncOutputStream(AsyncOutputStream& inner,
+                                             zc::Own<_::GzipOutputContext> ctx)
+    : inner(inner), ctx(zc::mv(ctx)) {}
 
 Promise<void> GzipAsyncOutputStream::write(ArrayPtr<const byte> buffer) {
-  ctx.setInput(buffer.begin(), buffer.size());
+  ctx->setInput(buffer.begin(), buffer.size());
   return pump(Z_NO_FLUSH);
 }
 
@@ -241,7 +319,7 @@ Promise<void> GzipAsyncOutputStream::write(ArrayPtr<const ArrayPtr<const byte>>
 }
 
 zc::Promise<void> GzipAsyncOutputStream::pump(int flush) {
-  auto result = ctx.pumpOnce(flush);
+  auto result = ctx->pumpOnce(flush);
   auto ok = get<0>(result);
   auto chunk = get<1>(result);
 
@@ -260,6 +338,192 @@ zc::Promise<void> GzipAsyncOutputStream::pump(int flush) {
   }
 }
 
+// =======================================================================================
+
+namespace {
+
+constexpr size_t DEFLATE_WINDOW_SIZE = 32768;
+
+// Magic, compression method, no flags, no modification time, no extra flags, unknown OS.
+const byte GZIP_HEADER[] = {0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, 0, 0xff};
+
+}  // namespace
+
+ParallelGzipAsyncOutputStream::ParallelGzipAsyncOutputStream(AsyncOutputStream& inner,
+                                                             const WorkerPool& pool,
+                                                             int compressionLevel,
+                                                             size_t blockSize,
+                                                             uint maxBlocksInFlight)
+    : inner(inner),
+      pool(pool),
+      compressionLevel(compressionLevel),
+      blockSize(blockSize),
+      inFlight(zc::heapArray<zc::Maybe<Promise<Block>>>(
+          maxBlocksInFlight > 0 ? maxBlocksInFlight : zc::max(pool.getThreadCount() * 2, 1u))) {
+  ZC_REQUIRE(blockSize > 0);
+  pending.reserve(blockSize);
+}
+
+Promise<void> ParallelGzipAsyncOutputStream::write(ArrayPtr<const byte> buffer) {
+  while (buffer.size() > 0) {
+    if (inFlightCount == inFlight.size()) {
+      return writeOut(inFlightCount - 1).then([this, buffer]() { return write(buffer); });
+    }
+
+    size_t n = zc::min(blockSize - pending.size(), buffer.size());
+    pending.addAll(buffer.first(n));
+    buffer = buffer.slice(n);
+    if (pending.size() == blockSize) { submit(false); }
+  }
+  return zc::READY_NOW;
+}
+
+Promise<void> ParallelGzipAsyncOutputStream::write(ArrayPtr<const ArrayPtr<const byte>> pieces) {
+  for (auto piece : pieces) co_await write(piece);
+}
+
+Promise<void> ParallelGzipAsyncOutputStream::end() {
+  return writeOut(inFlight.size() - 1)
+      .then([this]() {
+        submit(true);
+        return writeOut(0);
+      })
+      .then([this]() {
+        for (uint i = 0; i < 4; i++) {
+          trailer[i] = crc >> (i * 8);
+          trailer[i + 4] = totalSize >> (i * 8);
+        }
+        return inner.write(trailer);
+      });
+}
+
+void ParallelGzipAsyncOutputStream::submit(bool last) {
+  auto input = pending.releaseAsArray();
+  if (!last) { pending.reserve(blockSize); }
+
+  auto previous = zc::mv(dictionary);
+  dictionary = zc::heapArray(input.slice(input.size() - zc::min(input.size(), DEFLATE_WINDOW_SIZE),
+                                         input.size()));
+
+  bool first = !started;
+  started = true;
+
+  inFlight[(oldest + inFlightCount) % inFlight.size()] =
+      pool.run([input = zc::mv(input), previous = zc::mv(previous),
+                compressionLevel = compressionLevel, first, last]() {
+        return compressBlock(input, previous, compressionLevel, first, last);
+      });
+  ++inFlightCount;
+}
+
+Promise<void> ParallelGzipAsyncOutputStream::writeOut(size_t keep) {
+  if (inFlightCount <= keep) { return zc::READY_NOW; }
+
+  auto next = ZC_ASSERT_NONNULL(zc::mv(inFlight[oldest]));
+  inFlight[oldest] = zc::none;
+  oldest = (oldest + 1) % inFlight.size();
+  --inFlightCount;
+
+  return next
+      .then([this](Block block) {
+        crc = crc32_combine(crc, block.crc, block.inputSize);
+        totalSize += block.inputSize;
+        auto promise = inner.write(block.output.first(block.outputSize));
+        return promise.attach(zc::mv(block.output));
+      })
+      .then([this, keep]() { return writeOut(keep); });
+}
+
+ParallelGzipAsyncOutputStream::Block ParallelGzipAsyncOutputStream::compressBlock(
+    ArrayPtr<const byte> input, ArrayPtr<const byte> dictionary, int compressionLevel,
+    bool first, bool last) {
+  // Runs on the pool's thread.
+  auto& ctx = threadDeflater.get(compressionLevel, -15);
+  if (dictionary.size() > 0) {
+    ZC_ASSERT(deflateSetDictionary(&ctx, dictionary.begin(), dictionary.size()) == Z_OK);
+  }
+
+  // deflateBound() allows for finishing the stream; a sync flush's empty stored block may need a
+  // few more bytes.
+  size_t headerSize = first ? sizeof(GZIP_HEADER) : 0;
+  auto output = zc::heapArray<byte>(headerSize + deflateBound(&ctx, input.size()) + 16);
+  if (first) { memcpy(output.begin(), GZIP_HEADER, headerSize); }
+
+  ctx.next_in = const_cast<byte*>(input.begin());
+  ctx.avail_in = input.size();
+  ctx.next_out = output.begin() + headerSize;
+  ctx.avail_out = output.size() - headerSize;
+
+  // A sync flush ends the block's output on a byte boundary, so that the next block's follows on.
+  auto result = deflate(&ctx, last ? Z_FINISH : Z_SYNC_FLUSH);
+  ZC_ASSERT(result == (last ? Z_STREAM_END : Z_OK) && ctx.avail_in == 0 && ctx.avail_out > 0,
+            "gzip compression failed", result);
+
+  size_t outputSize = output.size() - ctx.avail_out;
+  uLong blockCrc = crc32(0, input.begin(), input.size());
+  return {zc::mv(output), outputSize, blockCrc, input.size()};
+}
+
+// =======================================================================================
+
+size_t gzipCompressBound(size_t inputSize) {
+  // compressBound() allows for zlib's 6 bytes of header and trailer; gzip's take 18.
+  return compressBound(inputSize) + 12;
+}
+
+ArrayPtr<byte> gzipCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                            int compressionLevel) {
+  ZC_REQUIRE(input.size() <= uInt(zc::maxValue) && output.size() <= uInt(zc::maxValue),
+             "gzipCompress() buffers are too large");
+
+  // windowBits = 15 (maximum) + magic value 16 to ask for gzip.
+  auto& ctx = threadDeflater.get(compressionLevel, 15 + 16);
+  ctx.next_in = const_cast<byte*>(input.begin());
+  ctx.avail_in = input.size();
+  ctx.next_out = output.begin();
+  ctx.avail_out = output.size();
+
+  auto result = deflate(&ctx, Z_FINISH);
+  if (result != Z_STREAM_END) {
+    ZC_REQUIRE(result == Z_OK || result == Z_BUF_ERROR, "gzip compression failed", result);
+    ZC_FAIL_REQUIRE("gzipCompress() output buffer is too small", output.size());
+  }
+  return output.first(output.size() - ctx.avail_out);
+}
+
+Maybe<size_t> gzipDecompressedSize(ArrayPtr<const byte> input) {
+  // The header takes 10 bytes, an empty deflate stream 2, and the trailer 8, ending in ISIZE.
+  if (input.size() < 20) { return zc::none; }
+  auto isize = input.slice(input.size() - 4);
+  return size_t(isize[0]) | size_t(isize[1]) << 8 | size_t(isize[2]) << 16 |
+         size_t(isize[3]) << 24;
+}
+
+ArrayPtr<byte> gzipDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output) {
+  ZC_REQUIRE(input.size() <= uInt(zc::maxValue) && output.size() <= uInt(zc::maxValue),
+             "gzipDecompress() buffers are too large");
+
+  auto& ctx = threadInflater.get();
+  ctx.next_in = const_cast<byte*>(input.begin());
+  ctx.avail_in = input.size();
+  ctx.next_out = output.begin();
+  ctx.avail_out = output.size();
+
+  auto result = inflate(&ctx, Z_FINISH);
+  if (result == Z_STREAM_END) {
+    ZC_REQUIRE(ctx.avail_in == 0, "gzip compressed stream has trailing data");
+  } else if (result == Z_BUF_ERROR || result == Z_OK) {
+    // Either the output or the input ran out first.
+    ZC_REQUIRE(ctx.avail_in == 0, "gzipDecompress() output buffer is too small", output.size());
+    ZC_FAIL_REQUIRE("gzip compressed stream ended prematurely");
+  } else if (ctx.msg == nullptr) {
+    ZC_FAIL_REQUIRE("gzip decompression failed", result);
+  } else {
+    ZC_FAIL_REQUIRE("gzip decompression failed", ctx.msg);
+  }
+  return output.first(output.size() - ctx.avail_out);
+}
+
 }  // namespace zc
 
 #endif  // ZC_HAS_ZLIB
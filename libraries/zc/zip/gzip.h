@@ -24,7 +24,9 @@
 #include <zlib.h>
 
 #include "zc/async/async-io.h"
+#include "zc/async/worker-pool.h"
 #include "zc/core/io.h"
+#include "zc/zip/context-pool.h"
 
 ZC_BEGIN_HEADER
 
@@ -43,6 +45,9 @@ public:
   void setInput(const void* in, size_t size);
   zc::Tuple<bool, zc::ArrayPtr<const byte>> pumpOnce(int flush);
 
+  void reset();
+  // Readies the context for a new stream, keeping the state zlib has allocated.
+
 private:
   bool compressing;
   z_stream ctx = {};
@@ -53,6 +58,9 @@ private:
 
 }  // namespace _
 
+using GzipContextPool = CompressionContextPool<_::GzipOutputContext>;
+// Constructed with `maxIdle` and then the compression level, or none to decompress.
+
 class GzipInputStream final : public InputStream {
 public:
   GzipInputStream(InputStream& inner);
@@ -117,6 +125,8 @@ public:
 
   GzipAsyncOutputStream(AsyncOutputStream& inner, int compressionLevel = Z_DEFAULT_COMPRESSION);
   GzipAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS));
+  GzipAsyncOutputStream(AsyncOutputStream& inner, zc::Own<_::GzipOutputContext> ctx);
+  // Uses a context from a GzipContextPool.
   ZC_DISALLOW_COPY_AND_MOVE(GzipAsyncOutputStream);
 
   Promise<void> write(ArrayPtr<const byte> buffer) override;
@@ -134,11 +144,99 @@ public:
 
 private:
   AsyncOutputStream& inner;
-  _::GzipOutputContext ctx;
+  zc::Own<_::GzipOutputContext> ctx;
 
   zc::Promise<void> pump(int flush);
 };
 
+class ParallelGzipAsyncOutputStream final : public AsyncOutputStream {
+  // Compresses like GzipAsyncOutputStream, but on the threads of a WorkerPool, the way pigz does:
+  // the input is cut into blocks of `blockSize` bytes, each compressed on its own, with the last
+  // 32K of the block before it as a preset dictionary so that the compression ratio barely
+  // suffers. Each block's deflate output ends on a byte boundary, so they concatenate into one
+  // deflate stream, and their CRC-32s combine into the stream's. The result is an ordinary
+  // single-member gzip stream.
+  //
+  // Up to `maxBlocksInFlight` blocks -- by default, twice the pool's threads -- are compressed at
+  // a time. Once there are that many, a write waits for the oldest to be written out.
+
+public:
+  ParallelGzipAsyncOutputStream(AsyncOutputStream& inner, const WorkerPool& pool,
+                                int compressionLevel = Z_DEFAULT_COMPRESSION,
+                                size_t blockSize = 128 * 1024, uint maxBlocksInFlight = 0);
+  ZC_DISALLOW_COPY_AND_MOVE(ParallelGzipAsyncOutputStream);
+
+  Promise<void> write(ArrayPtr<const byte> buffer) override;
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override;
+
+  Promise<void> whenWriteDisconnected() override { return inner.whenWriteDisconnected(); }
+
+  Promise<void> end();
+  // Must call to compress the rest of the input and finish the stream.
+
+private:
+  struct Block {
+    zc::Array<byte> output;
+    size_t outputSize;
+    uLong crc;
+    size_t inputSize;
+  };
+
+  AsyncOutputStream& inner;
+  const WorkerPool& pool;
+  int compressionLevel;
+  size_t blockSize;
+
+  zc::Vector<byte> pending;
+  // Input not yet handed to the pool.
+
+  zc::Array<byte> dictionary;
+  // The end of the last block handed to the pool, to prime the next one with.
+
+  bool started = false;
+
+  zc::Array<zc::Maybe<Promise<Block>>> inFlight;
+  size_t oldest = 0;
+  size_t inFlightCount = 0;
+  // Blocks being compressed, as a ring buffer in input order.
+
+  uLong crc = 0;
+  uint64_t totalSize = 0;
+  byte trailer[8];
+
+  void submit(bool last);
+  Promise<void> writeOut(size_t keep);
+  // Writes out the oldest blocks, in order, until no more than `keep` are in flight.
+
+  static Block compressBlock(ArrayPtr<const byte> input, ArrayPtr<const byte> dictionary,
+                             int compressionLevel, bool first, bool last);
+};
+
+// =======================================================================================
+// One-shot compression
+//
+// These compress or decompress a whole message at once, straight from one buffer to another,
+// rather than through a stream's buffer. They reuse a context kept for the calling thread instead
+// of setting one up for every call, which suits small messages.
+
+size_t gzipCompressBound(size_t inputSize);
+// The most bytes gzipCompress() can produce from `inputSize` bytes of input.
+
+ArrayPtr<byte> gzipCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                            int compressionLevel = Z_DEFAULT_COMPRESSION);
+// Compresses `input` to a gzip stream in `output`, returning the part of `output` it takes. Throws
+// if `output` is too small, which it can't be if it's gzipCompressBound(input.size()) bytes.
+
+Maybe<size_t> gzipDecompressedSize(ArrayPtr<const byte> input);
+// The size of the data in the gzip stream `input`, as recorded in its trailer, or none if `input`
+// is too short to be one. The trailer only records the size modulo 2^32, and only that of the
+// last member of a multi-member stream, so this can only be trusted for streams that came from
+// gzipCompress().
+
+ArrayPtr<byte> gzipDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output);
+// Decompresses the gzip stream `input` into `output`, returning the part of `output` it takes.
+// Throws if `input` isn't exactly one complete gzip stream or if `output` is too small.
+
 }  // namespace zc
 
 ZC_END_HEADER
@@ -0,0 +1,401 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/core/common.h"
+#if ZC_HAS_ZSTD
+
+#include "zc/zip/zstd.h"
+
+#include <zstd_errors.h>
+
+#include "zc/core/debug.h"
+
+namespace zc {
+
+namespace {
+
+ZSTD_CCtx* newCompressor(int compressionLevel, const ZstdOptions& options) {
+  ZC_REQUIRE(compressionLevel >= ZSTD_minCLevel() && compressionLevel <= ZSTD_maxCLevel(),
+             "invalid zstd compression level", compressionLevel);
+
+  ZSTD_CCtx* cctx = ZSTD_createCCtx();
+  ZC_REQUIRE(cctx, "zstd state allocation failed");
+  ZC_ON_SCOPE_FAILURE(ZSTD_freeCCtx(cctx));
+
+  ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                                                 compressionLevel)));
+  // Like gzip's CRC-32, and what the zstd tool does by default; zstd itself leaves it out.
+  ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1)));
+  if (options.workers > 0) {
+    size_t result = ZSTD_CCtx_setParameter(cctx, ZSTD_c_nbWorkers, options.workers);
+    ZC_REQUIRE(!ZSTD_isError(result), "zstd multithreaded compression is unavailable",
+               ZSTD_getErrorName(result));
+  }
+  ZC_IF_SOME(dictionary, options.dictionary) {
+    ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_refCDict(cctx, dictionary.getCompressionDict())));
+  }
+  return cctx;
+}
+
+ZSTD_DCtx* newDecompressor(zc::Maybe<const ZstdDictionary&> dictionary) {
+  ZSTD_DCtx* dctx = ZSTD_createDCtx();
+  ZC_REQUIRE(dctx, "zstd state allocation failed");
+  ZC_IF_SOME(d, dictionary) {
+    ZC_ASSERT(!ZSTD_isError(ZSTD_DCtx_refDDict(dctx, d.getDecompressionDict())));
+  }
+  return dctx;
+}
+
+class ThreadZstdContexts {
+  // The contexts zstdCompress() and zstdDecompress() use, one of each for each thread, made when
+  // first needed and reused from one call to the next.
+
+public:
+  ~ThreadZstdContexts() noexcept(false) {
+    ZSTD_freeCCtx(cctx);
+    ZSTD_freeDCtx(dctx);
+  }
+
+  ZSTD_CCtx* getCompressor() {
+    if (cctx == nullptr) {
+      cctx = ZSTD_createCCtx();
+      ZC_REQUIRE(cctx, "zstd state allocation failed");
+    } else {
+      ZSTD_CCtx_reset(cctx, ZSTD_reset_session_and_parameters);
+    }
+    return cctx;
+  }
+
+  ZSTD_DCtx* getDecompressor() {
+    if (dctx == nullptr) {
+      dctx = ZSTD_createDCtx();
+      ZC_REQUIRE(dctx, "zstd state allocation failed");
+    } else {
+      ZSTD_DCtx_reset(dctx, ZSTD_reset_session_and_parameters);
+    }
+    return dctx;
+  }
+
+private:
+  ZSTD_CCtx* cctx = nullptr;
+  ZSTD_DCtx* dctx = nullptr;
+};
+
+thread_local ThreadZstdContexts threadZstdContexts;
+
+}  // namespace
+
+ZstdDictionary::ZstdDictionary(ArrayPtr<const byte> content, int compressionLevel) {
+  ZC_REQUIRE(compressionLevel >= ZSTD_minCLevel() && compressionLevel <= ZSTD_maxCLevel(),
+             "invalid zstd compression level", compressionLevel);
+  cdict = ZSTD_createCDict(content.begin(), content.size(), compressionLevel);
+  ZC_REQUIRE(cdict, "invalid zstd dictionary");
+  ZC_ON_SCOPE_FAILURE(ZSTD_freeCDict(cdict));
+  ddict = ZSTD_createDDict(content.begin(), content.size());
+  ZC_REQUIRE(ddict, "invalid zstd dictionary");
+}
+
+ZstdDictionary::~ZstdDictionary() noexcept(false) {
+  ZSTD_freeCDict(cdict);
+  ZSTD_freeDDict(ddict);
+}
+
+uint ZstdDictionary::getId() const { return ZSTD_getDictID_fromDDict(ddict); }
+
+namespace _ {  // private
+
+ZstdOutputContext::ZstdOutputContext(zc::Maybe<int> compressionLevel, ZstdOptions options) {
+  ZC_IF_SOME(level, compressionLevel) { ctx = newCompressor(level, options); }
+  else { ctx = newDecompressor(options.dictionary); }
+}
+
+ZstdOutputContext::~ZstdOutputContext() noexcept(false) {
+  ZC_SWITCH_ONEOF(ctx) {
+    ZC_CASE_ONEOF(cctx, ZSTD_CCtx*) { ZSTD_freeCCtx(cctx); }
+    ZC_CASE_ONEOF(dctx, ZSTD_DCtx*) { ZSTD_freeDCtx(dctx); }
+  }
+}
+
+void ZstdOutputContext::reset() {
+  ZC_SWITCH_ONEOF(ctx) {
+    ZC_CASE_ONEOF(cctx, ZSTD_CCtx*) { ZSTD_CCtx_reset(cctx, ZSTD_reset_session_only); }
+    ZC_CASE_ONEOF(dctx, ZSTD_DCtx*) { ZSTD_DCtx_reset(dctx, ZSTD_reset_session_only); }
+  }
+  input = {nullptr, 0, 0};
+  atFrameEnd = false;
+}
+
+void ZstdOutputContext::setInput(const void* in, size_t size) { input = {in, size, 0}; }
+
+zc::Tuple<bool, zc::ArrayPtr<const byte>> ZstdOutputContext::pumpOnce(ZSTD_EndDirective flush) {
+  ZSTD_outBuffer output = {buffer, sizeof(buffer), 0};
+
+  ZC_SWITCH_ONEOF(ctx) {
+    ZC_CASE_ONEOF(cctx, ZSTD_CCtx*) {
+      size_t result = ZSTD_compressStream2(cctx, &output, &input, flush);
+      ZC_REQUIRE(!ZSTD_isError(result), "zstd compression failed", ZSTD_getErrorName(result));
+
+      // Without a flush, zstd only has to take all the input; it says how much output is left to
+      // flush otherwise.
+      bool more = flush == ZSTD_e_continue ? input.pos < input.size : result != 0;
+      return zc::tuple(more, zc::arrayPtr(buffer, output.pos));
+    }
+    ZC_CASE_ONEOF(dctx, ZSTD_DCtx*) {
+      size_t consumed = input.pos;
+      size_t result = ZSTD_decompressStream(dctx, &output, &input);
+      ZC_REQUIRE(!ZSTD_isError(result), "zstd decompression failed", ZSTD_getErrorName(result));
+
+      // Called with nothing to do, zstd returns a nonzero hint even at the end of a frame.
+      if (input.pos > consumed || output.pos > 0) { atFrameEnd = result == 0; }
+
+      // A full output buffer may mean zstd has more for us, even with all the input taken.
+      bool more = input.pos < input.size || output.pos == output.size;
+      if (!more && flush == ZSTD_e_end) {
+        ZC_REQUIRE(atFrameEnd, "zstd compressed stream ended prematurely");
+      }
+      return zc::tuple(more, zc::arrayPtr(buffer, output.pos));
+    }
+  }
+  ZC_UNREACHABLE;
+}
+
+}  // namespace _
+
+// =======================================================================================
+
+ZstdInputStream::ZstdInputStream(InputStream& inner, zc::Maybe<const ZstdDictionary&> dictionary)
+    : inner(inner), ctx(newDecompressor(dictionary)) {}
+
+ZstdInputStream::~ZstdInputStream() noexcept(false) { ZSTD_freeDCtx(ctx); }
+
+size_t ZstdInputStream::tryRead(ArrayPtr<byte> out, size_t minBytes) {
+  if (out == nullptr) return 0;
+  return readImpl(out, minBytes, 0);
+}
+
+size_t ZstdInputStream::readImpl(ArrayPtr<byte> out, size_t minBytes, size_t alreadyRead) {
+  // Ask for more input unless there may be pending output
+  if (input.pos == input.size && !outputPending) {
+    size_t amount = inner.tryRead(buffer, 1);
+    if (amount == 0) {
+      ZC_REQUIRE(atValidEndpoint, "zstd compressed stream ended prematurely");
+      return alreadyRead;
+    } else {
+      input = {buffer, amount, 0};
+    }
+  }
+
+  ZSTD_outBuffer output = {out.begin(), out.size(), 0};
+  size_t consumed = input.pos;
+  size_t result = ZSTD_decompressStream(ctx, &output, &input);
+  ZC_REQUIRE(!ZSTD_isError(result), "zstd decompression failed", ZSTD_getErrorName(result));
+
+  // A stream may hold several frames one after another; zstd starts on the next by itself.
+  if (input.pos > consumed || output.pos > 0) { atValidEndpoint = result == 0; }
+  outputPending = output.pos == output.size;
+
+  size_t n = output.pos;
+  if (n >= minBytes) {
+    return n + alreadyRead;
+  } else {
+    ZC_MUSTTAIL return readImpl(out.slice(n), minBytes - n, alreadyRead + n);
+  }
+}
+
+ZstdOutputStream::ZstdOutputStream(OutputStream& inner, int compressionLevel,
+                                   ZstdOptions options)
+    : inner(inner), ctx(compressionLevel, options) {}
+
+ZstdOutputStream::ZstdOutputStream(OutputStream& inner, decltype(DECOMPRESS),
+                                   zc::Maybe<const ZstdDictionary&> dictionary)
+    : inner(inner), ctx(zc::none, ZstdOptions{.dictionary = dictionary}) {}
+
+ZstdOutputStream::~ZstdOutputStream() noexcept(false) { pump(ZSTD_e_end); }
+
+void ZstdOutputStream::write(ArrayPtr<const byte> data) {
+  ctx.setInput(data.begin(), data.size());
+  pump(ZSTD_e_continue);
+}
+
+void ZstdOutputStream::pump(ZSTD_EndDirective flush) {
+  bool ok;
+  do {
+    auto result = ctx.pumpOnce(flush);
+    ok = get<0>(result);
+    auto chunk = get<1>(result);
+    if (chunk.size() > 0) { inner.write(chunk); }
+  } while (ok);
+}
+
+// =======================================================================================
+
+ZstdAsyncInputStream::ZstdAsyncInputStream(AsyncInputStream& inner,
+                                           zc::Maybe<const ZstdDictionary&> dictionary)
+    : inner(inner), ctx(newDecompressor(dictionary)) {}
+
+ZstdAsyncInputStream::~ZstdAsyncInputStream() noexcept(false) { ZSTD_freeDCtx(ctx); }
+
+Promise<size_t> ZstdAsyncInputStream::tryRead(void* out, size_t minBytes, size_t maxBytes) {
+  if (maxBytes == 0) return constPromise<size_t, 0>();
+
+  return readImpl(reinterpret_cast<byte*>(out), minBytes, maxBytes, 0);
+}
+
+Promise<size_t> ZstdAsyncInputStream::readImpl(byte* out, size_t minBytes, size_t maxBytes,
+                                               size_t alreadyRead) {
+  // Ask for more input unless there may be pending output
+  if (input.pos == input.size && !outputPending) {
+    return inner.tryRead(buffer, 1, sizeof(buffer))
+        .then([this, out, minBytes, maxBytes, alreadyRead](size_t amount) -> Promise<size_t> {
+          if (amount == 0) {
+            if (!atValidEndpoint) {
+              return ZC_EXCEPTION(DISCONNECTED, "zstd compressed stream ended prematurely");
+            }
+            return alreadyRead;
+          } else {
+            input = {buffer, amount, 0};
+            return readImpl(out, minBytes, maxBytes, alreadyRead);
+          }
+        });
+  }
+
+  ZSTD_outBuffer output = {out, maxBytes, 0};
+  size_t consumed = input.pos;
+  size_t result = ZSTD_decompressStream(ctx, &output, &input);
+  ZC_REQUIRE(!ZSTD_isError(result), "zstd decompression failed", ZSTD_getErrorName(result));
+
+  if (input.pos > consumed || output.pos > 0) { atValidEndpoint = result == 0; }
+  outputPending = output.pos == output.size;
+
+  size_t n = output.pos;
+  if (n >= minBytes) {
+    return n + alreadyRead;
+  } else {
+    return readImpl(out + n, minBytes - n, maxBytes - n, alreadyRead + n);
+  }
+}
+
+// =======================================================================================
+
+ZstdAsyncOutputStream::ZstdAsyncOutputStream(AsyncOutputStream& inner, int compressionLevel,
+                                             ZstdOptions options)
+    : inner(inner), ctx(zc::heap<_::ZstdOutputContext>(compressionLevel, options)) {}
+
+ZstdAsyncOutputStream::ZstdAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS),
+                                             zc::Maybe<const ZstdDictionary&> dictionary)
+    : inner(inner),
+      ctx(zc::heap<_::ZstdOutputContext>(zc::none, ZstdOptions{.dictionary = dictionary})) {}
+
+ZstdAsyncOutputStream::ZstdAsyncOutputStream(AsyncOutputStream& inner,
+                                             zc::Own<_::ZstdOutputContext> ctx)
+    : inner(inner), ctx(zc::mv(ctx)) {}
+
+Promise<void> ZstdAsyncOutputStream::write(ArrayPtr<const byte> buffer) {
+  ctx->setInput(buffer.begin(), buffer.size());
+  return pump(ZSTD_e_continue);
+}
+
+Promise<void> ZstdAsyncOutputStream::write(ArrayPtr<const ArrayPtr<const byte>> pieces) {
+  for (auto piece : pieces) co_await write(piece);
+}
+
+zc::Promise<void> ZstdAsyncOutputStream::pump(ZSTD_EndDirective flush) {
+  auto result = ctx->pumpOnce(flush);
+  auto ok = get<0>(result);
+  auto chunk = get<1>(result);
+
+  if (chunk.size() == 0) {
+    if (ok) {
+      return pump(flush);
+    } else {
+      return zc::READY_NOW;
+    }
+  } else {
+    auto promise = inner.write(chunk);
+    if (ok) {
+      promise = promise.then([this, flush]() { return pump(flush); });
+    }
+    return promise;
+  }
+}
+
+// =======================================================================================
+
+size_t zstdCompressBound(size_t inputSize) {
+  size_t bound = ZSTD_compressBound(inputSize);
+  ZC_REQUIRE(!ZSTD_isError(bound), "zstd input is too large", inputSize);
+  return bound;
+}
+
+ArrayPtr<byte> zstdCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                            int compressionLevel, zc::Maybe<const ZstdDictionary&> dictionary) {
+  ZC_REQUIRE(compressionLevel >= ZSTD_minCLevel() && compressionLevel <= ZSTD_maxCLevel(),
+             "invalid zstd compression level", compressionLevel);
+
+  ZSTD_CCtx* cctx = threadZstdContexts.getCompressor();
+  ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel,
+                                                 compressionLevel)));
+  ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1)));
+  ZC_IF_SOME(d, dictionary) {
+    ZC_ASSERT(!ZSTD_isError(ZSTD_CCtx_refCDict(cctx, d.getCompressionDict())));
+  }
+
+  size_t result =
+      ZSTD_compress2(cctx, output.begin(), output.size(), input.begin(), input.size());
+  if (ZSTD_isError(result)) {
+    ZC_REQUIRE(ZSTD_getErrorCode(result) != ZSTD_error_dstSize_tooSmall,
+               "zstdCompress() output buffer is too small", output.size());
+    ZC_FAIL_REQUIRE("zstd compression failed", ZSTD_getErrorName(result));
+  }
+  return output.first(result);
+}
+
+Maybe<size_t> zstdDecompressedSize(ArrayPtr<const byte> input) {
+  auto size = ZSTD_getFrameContentSize(input.begin(), input.size());
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) { return zc::none; }
+  return size_t(size);
+}
+
+ArrayPtr<byte> zstdDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                              zc::Maybe<const ZstdDictionary&> dictionary) {
+  ZSTD_DCtx* dctx = threadZstdContexts.getDecompressor();
+  ZC_IF_SOME(d, dictionary) {
+    ZC_ASSERT(!ZSTD_isError(ZSTD_DCtx_refDDict(dctx, d.getDecompressionDict())));
+  }
+
+  size_t result =
+      ZSTD_decompressDCtx(dctx, output.begin(), output.size(), input.begin(), input.size());
+  if (ZSTD_isError(result)) {
+    switch (ZSTD_getErrorCode(result)) {
+      case ZSTD_error_dstSize_tooSmall:
+        ZC_FAIL_REQUIRE("zstdDecompress() output buffer is too small", output.size());
+      case ZSTD_error_srcSize_wrong:
+        ZC_FAIL_REQUIRE("zstd compressed stream ended prematurely");
+      default:
+        ZC_FAIL_REQUIRE("zstd decompression failed", ZSTD_getErrorName(result));
+    }
+  }
+  return output.first(result);
+}
+
+}  // namespace zc
+
+#endif  // ZC_HAS_ZSTD
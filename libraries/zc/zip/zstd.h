@@ -0,0 +1,233 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+// Zstandard (RFC 8878) compression, with the same classes as gzip.h and brotli.h. Requires
+// ZC_HAS_ZSTD.
+
+#include <zstd.h>
+
+#include "zc/async/async-io.h"
+#include "zc/core/io.h"
+#include "zc/core/one-of.h"
+#include "zc/zip/context-pool.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+constexpr int ZC_ZSTD_DEFAULT_LEVEL = ZSTD_CLEVEL_DEFAULT;
+// Level 3. Unlike with zlib, -1 isn't the default here but a valid, faster-than-1 level: zstd
+// takes levels from ZSTD_minCLevel(), which is negative, to ZSTD_maxCLevel().
+
+class ZstdDictionary {
+  // A dictionary digested once for any number of streams to compress or decompress with. Small
+  // messages that look alike -- RPCs, say -- compress far better against a dictionary trained on
+  // samples of them (see `zstd --train`), which both ends must have.
+  //
+  // A dictionary compresses at the level it was created with, whatever level a stream using it
+  // asks for. It must outlive the streams and contexts using it, and may be shared between
+  // threads.
+
+public:
+  explicit ZstdDictionary(ArrayPtr<const byte> content,
+                          int compressionLevel = ZC_ZSTD_DEFAULT_LEVEL);
+  ~ZstdDictionary() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdDictionary);
+
+  uint getId() const;
+  // The ID the dictionary's header records, which the frames compressed with it carry, or 0 for a
+  // raw-content dictionary.
+
+  const ZSTD_CDict* getCompressionDict() const { return cdict; }
+  const ZSTD_DDict* getDecompressionDict() const { return ddict; }
+
+private:
+  ZSTD_CDict* cdict;
+  ZSTD_DDict* ddict;
+};
+
+struct ZstdOptions {
+  zc::Maybe<const ZstdDictionary&> dictionary;
+
+  uint workers = 0;
+  // Compression only. If non-zero, zstd compresses on this many threads of its own while the
+  // calling thread is left to feed it, which pays off for big inputs at higher levels. Requires a
+  // libzstd built with ZSTD_MULTITHREAD; throws otherwise.
+};
+
+namespace _ {  // private
+
+// Use an output buffer size of 8K, as with gzip and brotli. zstd recommends ZSTD_CStreamOutSize(),
+// around 128K, but that only saves copies out of its own buffers, not compression work.
+constexpr size_t ZC_ZSTD_BUF_SIZE = 8192;
+
+class ZstdOutputContext final {
+public:
+  ZstdOutputContext(zc::Maybe<int> compressionLevel, ZstdOptions options = {});
+  ~ZstdOutputContext() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdOutputContext);
+
+  void setInput(const void* in, size_t size);
+  zc::Tuple<bool, zc::ArrayPtr<const byte>> pumpOnce(ZSTD_EndDirective flush);
+  // Flush the stream. When decompressing, ZSTD_e_end checks that the input ended where a frame
+  // did, and the other directives are ignored.
+
+  void reset();
+  // Readies the context for a new stream. zstd resets in place, keeping its parameters, its
+  // dictionary, and all its memory.
+
+private:
+  zc::OneOf<ZSTD_CCtx*, ZSTD_DCtx*> ctx;
+  ZSTD_inBuffer input = {nullptr, 0, 0};
+  bool atFrameEnd = false;
+  byte buffer[_::ZC_ZSTD_BUF_SIZE];
+};
+
+}  // namespace _
+
+using ZstdContextPool = CompressionContextPool<_::ZstdOutputContext>;
+// Constructed with `maxIdle` and then the compression level, or none to decompress, and optionally
+// ZstdOptions.
+
+class ZstdInputStream final : public InputStream {
+public:
+  ZstdInputStream(InputStream& inner, zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+  ~ZstdInputStream() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdInputStream);
+
+  size_t tryRead(ArrayPtr<byte> buffer, size_t minBytes) override;
+
+private:
+  InputStream& inner;
+  ZSTD_DCtx* ctx;
+  bool atValidEndpoint = false;
+  bool outputPending = false;
+  // Whether the last call filled the output buffer, so that zstd may have more for us before it
+  // needs more input.
+
+  byte buffer[_::ZC_ZSTD_BUF_SIZE];
+  ZSTD_inBuffer input = {buffer, 0, 0};
+
+  size_t readImpl(ArrayPtr<byte> buffer, size_t minBytes, size_t alreadyRead);
+};
+
+class ZstdOutputStream final : public OutputStream {
+public:
+  enum { DECOMPRESS };
+
+  ZstdOutputStream(OutputStream& inner, int compressionLevel = ZC_ZSTD_DEFAULT_LEVEL,
+                   ZstdOptions options = {});
+  ZstdOutputStream(OutputStream& inner, decltype(DECOMPRESS),
+                   zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+  ~ZstdOutputStream() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdOutputStream);
+
+  void write(ArrayPtr<const byte> data) override;
+
+  using OutputStream::write;
+
+  inline void flush() { pump(ZSTD_e_flush); }
+
+private:
+  OutputStream& inner;
+  _::ZstdOutputContext ctx;
+
+  void pump(ZSTD_EndDirective flush);
+};
+
+class ZstdAsyncInputStream final : public AsyncInputStream {
+public:
+  ZstdAsyncInputStream(AsyncInputStream& inner,
+                       zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+  ~ZstdAsyncInputStream() noexcept(false);
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdAsyncInputStream);
+
+  Promise<size_t> tryRead(void* buffer, size_t minBytes, size_t maxBytes) override;
+
+private:
+  AsyncInputStream& inner;
+  ZSTD_DCtx* ctx;
+  bool atValidEndpoint = false;
+  bool outputPending = false;
+
+  byte buffer[_::ZC_ZSTD_BUF_SIZE];
+  ZSTD_inBuffer input = {buffer, 0, 0};
+
+  Promise<size_t> readImpl(byte* buffer, size_t minBytes, size_t maxBytes, size_t alreadyRead);
+};
+
+class ZstdAsyncOutputStream final : public AsyncOutputStream {
+public:
+  enum { DECOMPRESS };
+
+  ZstdAsyncOutputStream(AsyncOutputStream& inner, int compressionLevel = ZC_ZSTD_DEFAULT_LEVEL,
+                        ZstdOptions options = {});
+  ZstdAsyncOutputStream(AsyncOutputStream& inner, decltype(DECOMPRESS),
+                        zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+  ZstdAsyncOutputStream(AsyncOutputStream& inner, zc::Own<_::ZstdOutputContext> ctx);
+  // Uses a context from a ZstdContextPool.
+  ZC_DISALLOW_COPY_AND_MOVE(ZstdAsyncOutputStream);
+
+  Promise<void> write(ArrayPtr<const byte> buffer) override;
+  Promise<void> write(ArrayPtr<const ArrayPtr<const byte>> pieces) override;
+
+  Promise<void> whenWriteDisconnected() override { return inner.whenWriteDisconnected(); }
+
+  inline Promise<void> flush() { return pump(ZSTD_e_flush); }
+  // Call if you need to flush a stream at an arbitrary data point.
+
+  Promise<void> end() { return pump(ZSTD_e_end); }
+  // Must call to flush and finish the stream, since some data may be buffered.
+  //
+  // TODO(cleanup): This should be a virtual method on AsyncOutputStream.
+
+private:
+  AsyncOutputStream& inner;
+  zc::Own<_::ZstdOutputContext> ctx;
+
+  zc::Promise<void> pump(ZSTD_EndDirective flush);
+};
+
+// =======================================================================================
+// One-shot compression, like gzipCompress() and friends
+
+size_t zstdCompressBound(size_t inputSize);
+// The most bytes zstdCompress() can produce from `inputSize` bytes of input.
+
+ArrayPtr<byte> zstdCompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                            int compressionLevel = ZC_ZSTD_DEFAULT_LEVEL,
+                            zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+// Compresses `input` to a zstd frame in `output`, returning the part of `output` it takes. Throws
+// if `output` is too small, which it can't be if it's zstdCompressBound(input.size()) bytes.
+
+Maybe<size_t> zstdDecompressedSize(ArrayPtr<const byte> input);
+// The size of the data in the zstd frame at the start of `input`, as recorded in its header, or
+// none if the header doesn't record it. zstdCompress() always records it.
+
+ArrayPtr<byte> zstdDecompress(ArrayPtr<const byte> input, ArrayPtr<byte> output,
+                              zc::Maybe<const ZstdDictionary&> dictionary = zc::none);
+// Decompresses the zstd frames `input` into `output`, returning the part of `output` they take.
+// Throws if `input` ends partway through a frame or if `output` is too small.
+
+}  // namespace zc
+
+ZC_END_HEADER
@@ -0,0 +1,237 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#include "zc/ztest/benchmark.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+
+#include "zc/core/debug.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/glob-filter.h"
+#include "zc/core/io.h"
+#include "zc/core/miniposix.h"
+#include "zc/core/time.h"
+
+namespace zc {
+
+namespace {
+
+constexpr size_t SAMPLE_COUNT = 20;
+// Samples taken of each run. Of 20 samples, the 99th percentile is the slowest, which is the one
+// a stall during the run shows up in.
+
+struct BenchmarkOptions {
+  bool measure = false;
+  size_t fixedIterations = 0;
+  // From --benchmark. Zero to calibrate the iteration count instead.
+  Duration time = 200 * MILLISECONDS;
+  // Spent sampling each run, not counting warmup.
+  Maybe<GlobFilter> filter;
+  Maybe<Own<const File>> json;
+  uint64_t jsonSize = 0;
+};
+
+BenchmarkOptions& getOptions() {
+  static BenchmarkOptions options;
+  return options;
+}
+
+Duration timeLoop(FunctionParam<void(size_t)>& loop, size_t iterations) {
+  auto& clock = systemPreciseMonotonicClock();
+  auto start = clock.now();
+  loop(iterations);
+  return clock.now() - start;
+}
+
+size_t calibrate(FunctionParam<void(size_t)>& loop, Duration target) {
+  // Grows the iteration count until one sample lasts `target`, which warms up the caches, branch
+  // predictors, and allocator along the way.
+  size_t iterations = 1;
+  for (;;) {
+    double elapsed = timeLoop(loop, iterations) / NANOSECONDS;
+    double wanted = target / NANOSECONDS;
+    if (elapsed >= wanted || iterations >= (size_t(1) << 40)) { return iterations; }
+
+    // Aim a little past the target, but grow at most tenfold at a time, since the first,
+    // cold samples overstate the time per iteration.
+    double scale = elapsed > 0 ? zc::min(wanted * 1.2 / elapsed, 10.0) : 10.0;
+    iterations = zc::max(iterations + 1, size_t(double(iterations) * scale));
+  }
+}
+
+String formatTime(double nanoseconds) {
+  char buffer[32];
+  if (nanoseconds < 1e3) {
+    snprintf(buffer, sizeof(buffer), "%.3g ns", nanoseconds);
+  } else if (nanoseconds < 1e6) {
+    snprintf(buffer, sizeof(buffer), "%.3g us", nanoseconds / 1e3);
+  } else if (nanoseconds < 1e9) {
+    snprintf(buffer, sizeof(buffer), "%.3g ms", nanoseconds / 1e6);
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.3g s", nanoseconds / 1e9);
+  }
+  return heapString(buffer);
+}
+
+String formatRate(double perSecond, StringPtr unit) {
+  char buffer[48];
+  if (perSecond < 1e3) {
+    snprintf(buffer, sizeof(buffer), "%.3g %s/s", perSecond, unit.cStr());
+  } else if (perSecond < 1e6) {
+    snprintf(buffer, sizeof(buffer), "%.3g k%s/s", perSecond / 1e3, unit.cStr());
+  } else if (perSecond < 1e9) {
+    snprintf(buffer, sizeof(buffer), "%.3g M%s/s", perSecond / 1e6, unit.cStr());
+  } else {
+    snprintf(buffer, sizeof(buffer), "%.3g G%s/s", perSecond / 1e9, unit.cStr());
+  }
+  return heapString(buffer);
+}
+
+String jsonString(StringPtr text) {
+  Vector<char> result(text.size() + 2);
+  result.add('"');
+  for (char c : text) {
+    if (c == '"' || c == '\\') { result.add('\\'); }
+    result.add(c);
+  }
+  result.add('"');
+  result.add('\0');
+  return String(result.releaseAsArray());
+}
+
+}  // namespace
+
+Benchmark::Benchmark(StringPtr name) : name(name) {}
+
+void Benchmark::runSamples(Maybe<StringPtr> variant, FunctionParam<void(size_t)> loop) {
+  auto& options = getOptions();
+
+  String fullName;
+  ZC_IF_SOME(v, variant) { fullName = str(name, '/', v); }
+  else { fullName = heapString(name); }
+
+  ZC_IF_SOME(filter, options.filter) {
+    // Like a path, '*' doesn't match across the '/', so matching the name selects all variants.
+    if (!filter.matches(fullName) && !filter.matches(name)) { return; }
+  }
+
+  if (!options.measure) {
+    // Just make sure the benchmark works.
+    loop(1);
+    return;
+  }
+
+  size_t iterations = options.fixedIterations;
+  if (iterations == 0) {
+    iterations = calibrate(loop, options.time / SAMPLE_COUNT);
+  } else {
+    loop(iterations);
+  }
+
+  double samples[SAMPLE_COUNT];
+  for (auto& sample : samples) {
+    sample = double(timeLoop(loop, iterations) / NANOSECONDS) / double(iterations);
+  }
+  auto stats = _::summarizeSamples(samples);
+
+  Vector<String> parts;
+  parts.add(str(formatTime(stats.median), " median"));
+  parts.add(str(formatTime(stats.p99), " p99"));
+  parts.add(str("stddev ", formatTime(stats.stddev)));
+
+  double bytesPerSecond = 0;
+  double itemsPerSecond = 0;
+  if (stats.median > 0) {
+    bytesPerSecond = double(bytesPerIteration) * 1e9 / stats.median;
+    itemsPerSecond = double(itemsPerIteration) * 1e9 / stats.median;
+  }
+  if (bytesPerIteration > 0) { parts.add(formatRate(bytesPerSecond, "B")); }
+  if (itemsPerIteration > 0) { parts.add(formatRate(itemsPerSecond, " items")); }
+
+  auto line = str("  ", fullName, ": ", strArray(parts, ", "), " (", SAMPLE_COUNT,
+                  " samples of ", iterations, ")\n");
+  FdOutputStream(STDOUT_FILENO).write(line.asBytes());
+
+  ZC_IF_SOME(file, options.json) {
+    auto json = str("{\"name\":", jsonString(fullName), ",\"iterations\":", iterations,
+                    ",\"samples\":", SAMPLE_COUNT, ",\"medianNs\":", stats.median,
+                    ",\"p99Ns\":", stats.p99, ",\"meanNs\":", stats.mean,
+                    ",\"stddevNs\":", stats.stddev, ",\"bytesPerSecond\":", bytesPerSecond,
+                    ",\"itemsPerSecond\":", itemsPerSecond, "}\n");
+    file->write(options.jsonSize, json.asBytes());
+    options.jsonSize += json.size();
+  }
+}
+
+namespace _ {  // private
+
+BenchmarkStats summarizeSamples(ArrayPtr<double> samples) {
+  ZC_REQUIRE(samples.size() > 0);
+  std::sort(samples.begin(), samples.end());
+  size_t n = samples.size();
+
+  BenchmarkStats stats;
+  stats.median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+  // Nearest rank, so that the percentile is always one of the samples.
+  stats.p99 = samples[size_t(ceil(0.99 * double(n))) - 1];
+
+  double sum = 0;
+  for (double sample : samples) { sum += sample; }
+  stats.mean = sum / double(n);
+
+  double squares = 0;
+  for (double sample : samples) { squares += (sample - stats.mean) * (sample - stats.mean); }
+  stats.stddev = n > 1 ? sqrt(squares / double(n - 1)) : 0;
+  return stats;
+}
+
+void setBenchmarkIterations(size_t iterations) {
+  // One iteration, the default, only tests that the benchmarks work.
+  if (iterations > 1) {
+    getOptions().measure = true;
+    getOptions().fixedIterations = iterations;
+  }
+}
+
+void setBenchmarkTime(uint milliseconds) {
+  getOptions().measure = true;
+  getOptions().time = milliseconds * MILLISECONDS;
+}
+
+void setBenchmarkJson(StringPtr path) {
+  auto& options = getOptions();
+  options.measure = true;
+
+  auto filesystem = newDiskFilesystem();
+  auto file = filesystem->getRoot().openFile(filesystem->getCurrentPath().evalNative(path),
+                                             WriteMode::CREATE | WriteMode::MODIFY);
+  file->truncate(0);
+  options.json = zc::mv(file);
+  options.jsonSize = 0;
+}
+
+void setBenchmarkFilter(StringPtr pattern) { getOptions().filter = GlobFilter(pattern); }
+
+}  // namespace _
+}  // namespace zc
@@ -0,0 +1,130 @@
+// Copyright (c) 2025 Zode.Z and contributors
+// Licensed under the MIT License:
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE.
+
+#pragma once
+// Timed benchmarks for the test runner. A ZC_BENCHMARK is an ordinary test case whose
+// measurements only happen when the runner is asked for them:
+//
+//     ZC_BENCHMARK("HashMap lookup") {
+//       HashMap<uint, uint> map = ...;
+//       benchmark.setItemsPerIteration(1000);
+//       benchmark.run([&]() {
+//         for (uint i = 0; i < 1000; i++) zc::doNotOptimize(map.find(i));
+//       });
+//     }
+//
+// By default each run() calls its function once, so that the benchmark is still tested along
+// with everything else. With --benchmark-time, --benchmark-json, or --benchmark, the runner
+// instead warms the function up, picks an iteration count that makes each of its samples last
+// long enough to time, and reports the median, 99th percentile, and standard deviation of the
+// time per iteration, and the bytes and items per second if they were set.
+
+#include "zc/core/function.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+ZC_BEGIN_HEADER
+
+namespace zc {
+
+template <typename T>
+inline void doNotOptimize(T&& value) {
+  // Makes the compiler assume `value` is read and memory written, so that the work computing it
+  // is neither optimized away nor hoisted out of the benchmark's loop.
+#if _MSC_VER && !defined(__clang__)
+  const volatile void* sink = &value;
+  (void)sink;
+#else
+  asm volatile("" : : "r"(&value) : "memory");
+#endif
+}
+
+class Benchmark {
+public:
+  explicit Benchmark(StringPtr name);
+  ZC_DISALLOW_COPY_AND_MOVE(Benchmark);
+
+  void setBytesPerIteration(uint64_t bytes) { bytesPerIteration = bytes; }
+  void setItemsPerIteration(uint64_t items) { itemsPerIteration = items; }
+  // What one call of the function does, to report throughput alongside time. They apply to the
+  // run() calls that follow.
+
+  template <typename Func>
+  void run(Func&& func) {
+    runSamples(zc::none, [&](size_t iterations) {
+      for (size_t i = iterations; i-- > 0;) { func(); }
+    });
+  }
+
+  template <typename Func>
+  void run(StringPtr variant, Func&& func) {
+    // Reported as "<name>/<variant>", e.g. to time one operation at several sizes.
+    runSamples(variant, [&](size_t iterations) {
+      for (size_t i = iterations; i-- > 0;) { func(); }
+    });
+  }
+
+private:
+  StringPtr name;
+  uint64_t bytesPerIteration = 0;
+  uint64_t itemsPerIteration = 0;
+
+  void runSamples(Maybe<StringPtr> variant, FunctionParam<void(size_t iterations)> loop);
+};
+
+namespace _ {  // private
+
+struct BenchmarkStats {
+  double median;
+  double p99;
+  double mean;
+  double stddev;
+};
+
+BenchmarkStats summarizeSamples(ArrayPtr<double> samples);
+// Statistics of the nanoseconds per iteration of each sample. Sorts `samples`.
+
+void setBenchmarkIterations(size_t iterations);
+void setBenchmarkTime(uint milliseconds);
+void setBenchmarkJson(StringPtr path);
+void setBenchmarkFilter(StringPtr pattern);
+// Set from the test runner's flags.
+
+}  // namespace _
+
+#define ZC_BENCHMARK(description)                                                           \
+  /* Make sure the linker fails if benchmarks are not in anonymous namespaces. */           \
+  extern int ZC_CONCAT(YouMustWrapTestsInAnonymousNamespace, __COUNTER__) ZC_UNUSED;        \
+  class ZC_UNIQUE_NAME(Benchmark) : public ::zc::TestCase {                                 \
+  public:                                                                                   \
+    ZC_UNIQUE_NAME(Benchmark)()                                                             \
+        : ::zc::TestCase(__FILE__, __LINE__, "benchmark: " description) {}                  \
+    void run() override {                                                                   \
+      ::zc::Benchmark benchmark(description);                                               \
+      measure(benchmark);                                                                   \
+    }                                                                                       \
+    void measure(::zc::Benchmark& benchmark);                                               \
+  } ZC_UNIQUE_NAME(benchmark);                                                              \
+  void ZC_UNIQUE_NAME(Benchmark)::measure(::zc::Benchmark& benchmark)
+
+}  // namespace zc
+
+ZC_END_HEADER
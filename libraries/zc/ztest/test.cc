@@ -36,6 +36,7 @@
 #include "zc/core/main.h"
 #include "zc/core/miniposix.h"
 #include "zc/core/time.h"
+#include "zc/ztest/benchmark.h"
 #ifndef _WIN32
 #include <sys/mman.h>
 #endif
@@ -165,7 +166,20 @@ public:
         .addOptionWithArg(
             {'b', "benchmark"}, ZC_BIND_METHOD(*this, setBenchmarkIters), "<iters>",
             "Specifies that any benchmarks in the tests should run for <iters> iterations. "
-            "If not specified, then count is 1, which simply tests that the benchmarks function.")
+            "If not specified, then count is 1, which simply tests that the benchmarks function. "
+            "ZC_BENCHMARKs are measured with <iters> iterations per sample.")
+        .addOptionWithArg(
+            {"benchmark-time"}, ZC_BIND_METHOD(*this, setBenchmarkTime), "<ms>",
+            "Measure the ZC_BENCHMARKs, sampling each of their runs for about <ms> milliseconds "
+            "(200 by default) after warming it up.")
+        .addOptionWithArg(
+            {"benchmark-json"}, ZC_BIND_METHOD(*this, setBenchmarkJson), "<file>",
+            "Measure the ZC_BENCHMARKs and also write their results to <file>, one JSON object "
+            "per line.")
+        .addOptionWithArg(
+            {"benchmark-filter"}, ZC_BIND_METHOD(*this, setBenchmarkFilter), "<pattern>",
+            "Run only the ZC_BENCHMARK runs whose \"<name>\" or \"<name>/<variant>\" matches "
+            "<pattern>, which may use '*' wildcards and omit a leading \"<name>/\".")
         .callAfterParsing(ZC_BIND_METHOD(*this, run))
         .build();
   }
@@ -225,11 +239,32 @@ public:
   MainBuilder::Validity setBenchmarkIters(StringPtr param) {
     ZC_IF_SOME(i, param.tryParseAs<size_t>()) {
       benchmarkIterCount = i;
+      _::setBenchmarkIterations(i);
+      return true;
+    }
+    else { return "expected an integer"; }
+  }
+
+  MainBuilder::Validity setBenchmarkTime(StringPtr param) {
+    ZC_IF_SOME(i, param.tryParseAs<uint>()) {
+      _::setBenchmarkTime(i);
       return true;
     }
     else { return "expected an integer"; }
   }
 
+  MainBuilder::Validity setBenchmarkJson(StringPtr param) {
+    ZC_IF_SOME(exception, runCatchingExceptions([&]() { _::setBenchmarkJson(param); })) {
+      return zc::str(exception.getDescription());
+    }
+    return true;
+  }
+
+  MainBuilder::Validity setBenchmarkFilter(StringPtr param) {
+    _::setBenchmarkFilter(param);
+    return true;
+  }
+
   MainBuilder::Validity run() {
     if (testCasesHead == nullptr) { return "no tests were declared"; }
 
@@ -49,8 +49,8 @@ protected:
     // is set by the --benchmark CLI flag. This defaults to 1, so that when --benchmark is not
     // specified, we only test that the benchmark works.
     //
-    // In the future, this could adaptively choose iteration count by running a few iterations to
-    // find out how fast the benchmark is, then scaling.
+    // For a benchmark that is timed and reported, with an adaptive iteration count, use
+    // ZC_BENCHMARK from benchmark.h instead.
 
     for (size_t i = iterCount(); i-- > 0;) { func(); }
   }
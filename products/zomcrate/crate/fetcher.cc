@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/fetcher.h"
+
+#include "zc/core/debug.h"
+#include "zc/zip/brotli.h"
+#include "zc/zip/gzip.h"
+
+namespace zomcrate {
+
+namespace {
+
+/// Larger artifacts are rejected rather than held in memory
+constexpr uint64_t kMaxArtifactSize = 256ull << 20;
+
+/// `body` decoded as `encoding` says, owning the raw stream.
+zc::Own<zc::AsyncInputStream> decode(zc::Own<zc::AsyncInputStream> body,
+                                     zc::Maybe<zc::StringPtr> encoding) {
+  ZC_IF_SOME(name, encoding) {
+    if (name == "gzip") {
+      auto decoded = zc::heap<zc::GzipAsyncInputStream>(*body);
+      return decoded.attach(zc::mv(body));
+    }
+    if (name == "br") {
+      auto decoded = zc::heap<zc::BrotliAsyncInputStream>(*body);
+      return decoded.attach(zc::mv(body));
+    }
+    ZC_REQUIRE(name == "identity", "unsupported content encoding", name);
+  }
+  return body;
+}
+
+}  // namespace
+
+FetchHeaders::FetchHeaders(zc::HttpHeaderTable::Builder& builder)
+    : table(builder.getFutureTable()),
+      acceptEncoding(builder.add("Accept-Encoding")),
+      contentEncoding(builder.add("Content-Encoding")) {}
+
+struct Fetcher::Impl {
+  Impl(zc::HttpClient& client, const FetchHeaders& headers, const ContentStore& store,
+       zc::uint maxConcurrentRequests)
+      : headers(headers),
+        store(store),
+        client(zc::newConcurrencyLimitingHttpClient(
+            client, maxConcurrentRequests, [this](zc::uint running, zc::uint pending) {
+              maxRunningRequests = zc::max(maxRunningRequests, running);
+            })) {}
+
+  const FetchHeaders& headers;
+  const ContentStore& store;
+  zc::uint maxRunningRequests = 0;
+  size_t downloadCount = 0;
+  zc::Own<zc::HttpClient> client;
+};
+
+Fetcher::Fetcher(zc::HttpClient& client, const FetchHeaders& headers, const ContentStore& store,
+                 zc::uint maxConcurrentRequests) noexcept
+    : impl(zc::heap<Impl>(client, headers, store, maxConcurrentRequests)) {}
+
+Fetcher::~Fetcher() noexcept(false) = default;
+
+zc::Promise<void> Fetcher::fetch(const Release& release) {
+  if (impl->store.contains(release.checksum)) { return zc::READY_NOW; }
+
+  zc::HttpHeaders requestHeaders(impl->headers.table);
+  requestHeaders.set(impl->headers.acceptEncoding, "br, gzip");
+  auto request = impl->client->request(zc::HttpMethod::GET, release.url, requestHeaders);
+
+  return request.response.then([this, &release](zc::HttpClient::Response&& response) {
+    ZC_REQUIRE(response.statusCode == 200, "failed to download crate", release.name,
+               release.version, release.url, response.statusCode, response.statusText);
+    auto body =
+        decode(zc::mv(response.body), response.headers->get(impl->headers.contentEncoding));
+    auto content = body->readAllBytes(kMaxArtifactSize);
+    return content
+        .then([this, &release](zc::Array<zc::byte> bytes) {
+          impl->store.add(release.checksum, bytes);
+          ++impl->downloadCount;
+        })
+        .attach(zc::mv(body));
+  });
+}
+
+size_t Fetcher::getDownloadCount() const { return impl->downloadCount; }
+
+zc::uint Fetcher::getMaxRunningRequests() const { return impl->maxRunningRequests; }
+
+}  // namespace zomcrate
@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/async/async.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/http/http.h"
+#include "zomcrate/crate/resolver.h"
+#include "zomcrate/crate/store.h"
+
+namespace zomcrate {
+
+/// \brief The headers the fetcher uses that `HttpHeaderTable` has no builtin id for.
+struct FetchHeaders {
+  explicit FetchHeaders(zc::HttpHeaderTable::Builder& builder);
+
+  const zc::HttpHeaderTable& table;
+  zc::HttpHeaderId acceptEncoding;
+  zc::HttpHeaderId contentEncoding;
+};
+
+/// \brief Downloads crate artifacts into a content store.
+///
+/// Any number of fetches may be started at once; the fetcher keeps up to `maxConcurrentRequests`
+/// of them on the wire and queues the rest. Artifacts are requested compressed, and a brotli or
+/// gzip response is decoded as it is read. An artifact is only stored once it matches the
+/// checksum of its release, and one the store has already is not downloaded again.
+class Fetcher {
+public:
+  /// \param client Ideally one made by `zc::newHttpClient()` from a network, which keeps the
+  /// connections to each registry host open between requests instead of opening one per crate
+  Fetcher(zc::HttpClient& client, const FetchHeaders& headers, const ContentStore& store,
+          zc::uint maxConcurrentRequests = 8) noexcept;
+  ~Fetcher() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(Fetcher);
+
+  /// \brief Make sure the store has the release's artifact. `release` must outlive the promise.
+  zc::Promise<void> fetch(const Release& release);
+
+  /// \brief Artifacts downloaded so far, not counting those the store already had.
+  size_t getDownloadCount() const;
+  /// \brief The most requests that were on the wire at once.
+  zc::uint getMaxRunningRequests() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace zomcrate
@@ -0,0 +1,172 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/hash.h"
+
+#include <cstring>
+
+#include "zc/core/debug.h"
+
+namespace zomcrate {
+
+namespace {
+
+constexpr uint32_t kRoundConstants[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4,
+    0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe,
+    0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f,
+    0x4a7484aa, 0x5cb0a9dc, 0x76f988da, 0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc,
+    0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070, 0x19a4c116,
+    0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7,
+    0xc67178f2,
+};
+
+constexpr uint32_t kInitialState[8] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+inline uint32_t rotateRight(uint32_t value, int bits) {
+  return (value >> bits) | (value << (32 - bits));
+}
+
+zc::Maybe<uint8_t> parseHexDigit(char c) {
+  if (c >= '0' && c <= '9') { return c - '0'; }
+  if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+  if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+  return zc::none;
+}
+
+}  // namespace
+
+ContentHash ContentHash::of(zc::ArrayPtr<const zc::byte> content) {
+  Sha256 hasher;
+  hasher.update(content);
+  return hasher.finish();
+}
+
+zc::Maybe<ContentHash> ContentHash::parse(zc::StringPtr hex) {
+  if (hex.size() != kSize * 2) { return zc::none; }
+  ContentHash hash;
+  for (size_t i = 0; i < kSize; ++i) {
+    ZC_IF_SOME(high, parseHexDigit(hex[i * 2])) {
+      ZC_IF_SOME(low, parseHexDigit(hex[i * 2 + 1])) {
+        hash.bytes[i] = static_cast<zc::byte>(high << 4 | low);
+        continue;
+      }
+    }
+    return zc::none;
+  }
+  return hash;
+}
+
+zc::String ContentHash::toString() const {
+  static constexpr char kDigits[] = "0123456789abcdef";
+  zc::String hex = zc::heapString(kSize * 2);
+  for (size_t i = 0; i < kSize; ++i) {
+    hex[i * 2] = kDigits[bytes[i] >> 4];
+    hex[i * 2 + 1] = kDigits[bytes[i] & 0xf];
+  }
+  return hex;
+}
+
+zc::String ZC_STRINGIFY(const ContentHash& hash) { return hash.toString(); }
+
+Sha256::Sha256() { memcpy(state, kInitialState, sizeof(state)); }
+
+void Sha256::update(zc::ArrayPtr<const zc::byte> data) {
+  totalSize += data.size();
+  if (blockSize > 0) {
+    const size_t taken = zc::min(sizeof(block) - blockSize, data.size());
+    memcpy(block + blockSize, data.begin(), taken);
+    blockSize += taken;
+    data = data.slice(taken, data.size());
+    if (blockSize < sizeof(block)) { return; }
+    compress(block);
+    blockSize = 0;
+  }
+  while (data.size() >= sizeof(block)) {
+    compress(data.begin());
+    data = data.slice(sizeof(block), data.size());
+  }
+  memcpy(block, data.begin(), data.size());
+  blockSize = data.size();
+}
+
+ContentHash Sha256::finish() {
+  const uint64_t totalBits = totalSize * 8;
+  block[blockSize++] = 0x80;
+  if (blockSize > sizeof(block) - 8) {
+    memset(block + blockSize, 0, sizeof(block) - blockSize);
+    compress(block);
+    blockSize = 0;
+  }
+  memset(block + blockSize, 0, sizeof(block) - 8 - blockSize);
+  for (int i = 0; i < 8; ++i) { block[56 + i] = static_cast<zc::byte>(totalBits >> (56 - i * 8)); }
+  compress(block);
+
+  ContentHash hash;
+  for (int i = 0; i < 8; ++i) {
+    for (int j = 0; j < 4; ++j) {
+      hash.bytes[i * 4 + j] = static_cast<zc::byte>(state[i] >> (24 - j * 8));
+    }
+  }
+  return hash;
+}
+
+void Sha256::compress(const zc::byte* chunk) {
+  uint32_t schedule[64];
+  for (int i = 0; i < 16; ++i) {
+    schedule[i] = uint32_t(chunk[i * 4]) << 24 | uint32_t(chunk[i * 4 + 1]) << 16 |
+                  uint32_t(chunk[i * 4 + 2]) << 8 | uint32_t(chunk[i * 4 + 3]);
+  }
+  for (int i = 16; i < 64; ++i) {
+    const uint32_t s0 = rotateRight(schedule[i - 15], 7) ^ rotateRight(schedule[i - 15], 18) ^
+                        (schedule[i - 15] >> 3);
+    const uint32_t s1 = rotateRight(schedule[i - 2], 17) ^ rotateRight(schedule[i - 2], 19) ^
+                        (schedule[i - 2] >> 10);
+    schedule[i] = schedule[i - 16] + s0 + schedule[i - 7] + s1;
+  }
+
+  uint32_t a = state[0], b = state[1], c = state[2], d = state[3];
+  uint32_t e = state[4], f = state[5], g = state[6], h = state[7];
+  for (int i = 0; i < 64; ++i) {
+    const uint32_t s1 = rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25);
+    const uint32_t choice = (e & f) ^ (~e & g);
+    const uint32_t t1 = h + s1 + choice + kRoundConstants[i] + schedule[i];
+    const uint32_t s0 = rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22);
+    const uint32_t majority = (a & b) ^ (a & c) ^ (b & c);
+    const uint32_t t2 = s0 + majority;
+    h = g;
+    g = f;
+    f = e;
+    e = d + t1;
+    d = c;
+    c = b;
+    b = a;
+    a = t1 + t2;
+  }
+  state[0] += a;
+  state[1] += b;
+  state[2] += c;
+  state[3] += d;
+  state[4] += e;
+  state[5] += f;
+  state[6] += g;
+  state[7] += h;
+}
+
+}  // namespace zomcrate
@@ -0,0 +1,69 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/hash.h"
+#include "zc/core/string.h"
+
+namespace zomcrate {
+
+/// \brief The SHA-256 digest of a crate artifact, which names it in the content store.
+class ContentHash {
+public:
+  static constexpr size_t kSize = 32;
+
+  ContentHash() = default;
+
+  /// \brief The hash of `content`.
+  static ContentHash of(zc::ArrayPtr<const zc::byte> content);
+  /// \brief A hash from its 64 lowercase or uppercase hex digits, as registries publish them.
+  static zc::Maybe<ContentHash> parse(zc::StringPtr hex);
+
+  zc::ArrayPtr<const zc::byte> asBytes() const { return bytes; }
+  /// \brief The 64 lowercase hex digits.
+  zc::String toString() const;
+
+  bool operator==(const ContentHash& other) const = default;
+  zc::uint hashCode() const { return zc::hashCode(asBytes()); }
+
+private:
+  zc::byte bytes[kSize] = {};
+
+  friend class Sha256;
+};
+
+zc::String ZC_STRINGIFY(const ContentHash& hash);
+
+/// \brief SHA-256 over content fed in any number of pieces, so that an artifact can be hashed as
+/// it streams in.
+class Sha256 {
+public:
+  Sha256();
+
+  void update(zc::ArrayPtr<const zc::byte> data);
+  /// \brief The digest of everything fed so far. The hasher must not be used afterwards.
+  ContentHash finish();
+
+private:
+  uint32_t state[8];
+  zc::byte block[64];
+  size_t blockSize = 0;
+  uint64_t totalSize = 0;
+
+  void compress(const zc::byte* chunk);
+};
+
+}  // namespace zomcrate
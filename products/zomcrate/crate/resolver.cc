@@ -0,0 +1,186 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/resolver.h"
+
+#include "zc/core/debug.h"
+
+namespace zomcrate {
+
+namespace {
+
+/// More rounds than this mean the picks keep replacing each other
+constexpr size_t kMaxResolutionRounds = 100;
+
+using Picks = zc::HashMap<zc::StringPtr, const Release*>;
+
+/// Orders the picked releases so that each comes after its dependencies.
+class TopologicalOrder {
+public:
+  explicit TopologicalOrder(const Picks& picks) : picks(picks) {}
+
+  size_t visit(const Release& release) {
+    ZC_IF_SOME(index, indices.find(release.name)) { return index; }
+    ZC_REQUIRE(!visiting.contains(release.name), "crates depend on each other in a cycle",
+               release.name);
+    visiting.insert(release.name);
+
+    auto dependencies = zc::heapArrayBuilder<size_t>(release.dependencies.size());
+    for (const Dependency& dependency : release.dependencies) {
+      dependencies.add(visit(*ZC_ASSERT_NONNULL(picks.find(dependency.name))));
+    }
+
+    visiting.eraseMatch(release.name);
+    const size_t index = crates.size();
+    crates.add(ResolvedCrate{release, dependencies.finish()});
+    indices.insert(release.name, index);
+    return index;
+  }
+
+  zc::Vector<ResolvedCrate> crates;
+
+private:
+  const Picks& picks;
+  zc::HashMap<zc::StringPtr, size_t> indices;
+  zc::HashSet<zc::StringPtr> visiting;
+};
+
+}  // namespace
+
+zc::Maybe<Version> Version::parse(zc::StringPtr text) {
+  Version version;
+  uint32_t* components[] = {&version.major, &version.minor, &version.patch};
+  size_t pos = 0;
+  for (size_t i = 0; i < 3; ++i) {
+    if (i > 0) {
+      if (pos >= text.size() || text[pos] != '.') { return zc::none; }
+      ++pos;
+    }
+    const size_t start = pos;
+    uint64_t value = 0;
+    while (pos < text.size() && text[pos] >= '0' && text[pos] <= '9') {
+      value = value * 10 + (text[pos++] - '0');
+      if (value > UINT32_MAX) { return zc::none; }
+    }
+    if (pos == start) { return zc::none; }
+    *components[i] = static_cast<uint32_t>(value);
+  }
+  if (pos != text.size()) { return zc::none; }
+  return version;
+}
+
+zc::String ZC_STRINGIFY(const Version& version) {
+  return zc::str(version.major, '.', version.minor, '.', version.patch);
+}
+
+zc::Maybe<VersionRequirement> VersionRequirement::parse(zc::StringPtr text) {
+  VersionRequirement requirement;
+  if (text.startsWith("=")) {
+    requirement.exact = true;
+    text = text.slice(1);
+  } else if (text.startsWith("^")) {
+    text = text.slice(1);
+  }
+  ZC_IF_SOME(minimum, Version::parse(text)) {
+    requirement.minimum = minimum;
+    return requirement;
+  }
+  return zc::none;
+}
+
+bool VersionRequirement::matches(const Version& version) const {
+  if (exact || version < minimum) { return version == minimum; }
+  if (minimum.major > 0) { return version.major == minimum.major; }
+  if (minimum.minor > 0) { return version.major == 0 && version.minor == minimum.minor; }
+  return version == minimum;
+}
+
+zc::String VersionRequirement::toString() const { return zc::str(exact ? "=" : "^", minimum); }
+
+zc::String ZC_STRINGIFY(const VersionRequirement& requirement) { return requirement.toString(); }
+
+void IndexRegistry::add(Release release) {
+  auto owned = zc::heap<Release>(zc::mv(release));
+  const Release* added = owned.get();
+  releases.add(zc::mv(owned));
+  byName
+      .findOrCreate(added->name,
+                    [&]() -> decltype(byName)::Entry {
+                      return {added->name, zc::Vector<const Release*>()};
+                    })
+      .add(added);
+}
+
+zc::Array<const Release*> IndexRegistry::getReleases(zc::StringPtr name) const {
+  ZC_IF_SOME(found, byName.find(name)) { return zc::heapArray(found.asPtr()); }
+  return nullptr;
+}
+
+Resolution resolve(const Registry& registry, zc::ArrayPtr<const Dependency> roots) {
+  Picks picks;
+  for (size_t round = 0;; ++round) {
+    ZC_REQUIRE(round < kMaxResolutionRounds, "dependency resolution does not settle");
+
+    // Every requirement on each crate, from the roots and from the current picks
+    zc::HashMap<zc::StringPtr, zc::Vector<const Dependency*>> requirements;
+    auto require = [&](const Dependency& dependency) {
+      requirements
+          .findOrCreate(dependency.name,
+                        [&]() -> decltype(requirements)::Entry {
+                          return {dependency.name, zc::Vector<const Dependency*>()};
+                        })
+          .add(&dependency);
+    };
+    for (const Dependency& dependency : roots) { require(dependency); }
+    for (const auto& pick : picks) {
+      for (const Dependency& dependency : pick.value->dependencies) { require(dependency); }
+    }
+
+    Picks next;
+    bool changed = requirements.size() != picks.size();
+    for (const auto& entry : requirements) {
+      const Release* best = nullptr;
+      for (const Release* release : registry.getReleases(entry.key)) {
+        bool satisfies = true;
+        for (const Dependency* dependency : entry.value) {
+          satisfies = satisfies && dependency->requirement.matches(release->version);
+        }
+        if (satisfies && (best == nullptr || release->version > best->version)) { best = release; }
+      }
+      if (best == nullptr) {
+        zc::Vector<zc::String> spelled;
+        for (const Dependency* dependency : entry.value) {
+          spelled.add(zc::str(dependency->requirement));
+        }
+        ZC_FAIL_REQUIRE("no release satisfies every requirement", entry.key,
+                        zc::strArray(spelled, ", "));
+      }
+      ZC_IF_SOME(previous, picks.find(entry.key)) {
+        changed = changed || previous != best;
+      } else {
+        changed = true;
+      }
+      next.insert(best->name, best);
+    }
+
+    picks = zc::mv(next);
+    if (!changed) { break; }
+  }
+
+  TopologicalOrder order(picks);
+  for (const auto& pick : picks) { order.visit(*pick.value); }
+  return Resolution{order.crates.releaseAsArray()};
+}
+
+}  // namespace zomcrate
@@ -0,0 +1,117 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <compare>
+
+#include "zc/core/common.h"
+#include "zc/core/map.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomcrate/crate/hash.h"
+
+namespace zomcrate {
+
+/// \brief A release's `major.minor.patch` version.
+struct Version {
+  uint32_t major = 0;
+  uint32_t minor = 0;
+  uint32_t patch = 0;
+
+  static zc::Maybe<Version> parse(zc::StringPtr text);
+
+  auto operator<=>(const Version& other) const = default;
+  bool operator==(const Version& other) const = default;
+};
+
+zc::String ZC_STRINGIFY(const Version& version);
+
+/// \brief Which versions of a crate a dependency accepts.
+///
+/// `1.2.3` or `^1.2.3` accepts every version from 1.2.3 up to but not including 2.0.0, since a
+/// release only breaks compatibility in its first non-zero component: `^0.2.3` accepts 0.2.x from
+/// 0.2.3 on, and `^0.0.3` only 0.0.3. `=1.2.3` accepts exactly 1.2.3.
+class VersionRequirement {
+public:
+  static zc::Maybe<VersionRequirement> parse(zc::StringPtr text);
+
+  bool matches(const Version& version) const;
+
+  zc::String toString() const;
+
+private:
+  Version minimum;
+  bool exact = false;
+};
+
+zc::String ZC_STRINGIFY(const VersionRequirement& requirement);
+
+struct Dependency {
+  zc::String name;
+  VersionRequirement requirement;
+};
+
+/// \brief One published version of a crate, as the registry index describes it.
+struct Release {
+  zc::String name;
+  Version version;
+  /// The hash of the artifact, which the fetched one must match
+  ContentHash checksum;
+  zc::String url;
+  zc::Array<Dependency> dependencies;
+};
+
+/// \brief The index of the crates a registry publishes.
+class Registry {
+public:
+  virtual ~Registry() noexcept(false) = default;
+
+  /// \brief Every release of the crate, in no particular order. They must outlive the registry's
+  /// resolutions.
+  virtual zc::Array<const Release*> getReleases(zc::StringPtr name) const = 0;
+};
+
+/// \brief A registry whose index is held in memory, e.g. after being downloaded whole.
+class IndexRegistry final : public Registry {
+public:
+  void add(Release release);
+
+  zc::Array<const Release*> getReleases(zc::StringPtr name) const override;
+
+private:
+  zc::Vector<zc::Own<Release>> releases;
+  zc::HashMap<zc::StringPtr, zc::Vector<const Release*>> byName;
+};
+
+struct ResolvedCrate {
+  const Release& release;
+  /// Indices of the crates this one depends on, all smaller than its own
+  zc::Array<size_t> dependencies;
+};
+
+/// \brief The crates a build needs, each dependency before its dependents.
+struct Resolution {
+  zc::Array<ResolvedCrate> crates;
+};
+
+/// \brief Pick one release of every crate the roots need, directly or not.
+///
+/// Each crate gets the highest release that satisfies every requirement on it from the roots and
+/// from the other picked releases, which makes for one copy of each crate in the build. Picking
+/// repeats until no pick changes. Throws if no release satisfies all the requirements on a crate,
+/// or if crates depend on each other in a cycle.
+Resolution resolve(const Registry& registry, zc::ArrayPtr<const Dependency> roots);
+
+}  // namespace zomcrate
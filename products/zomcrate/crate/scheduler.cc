@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/scheduler.h"
+
+#include <deque>
+
+#include "zc/core/debug.h"
+#include "zc/core/vector.h"
+
+namespace zomcrate {
+
+struct BuildScheduler::Impl {
+  explicit Impl(zc::uint maxParallelBuilds) : maxParallelBuilds(maxParallelBuilds) {}
+
+  struct Steps {
+    Step fetch;
+    Step build;
+  };
+
+  zc::uint maxParallelBuilds;
+  zc::uint runningBuilds = 0;
+  zc::uint maxRunningBuilds = 0;
+  /// Builds waiting for a slot, first come first served
+  std::deque<zc::Own<zc::PromiseFulfiller<void>>> waiting;
+
+  zc::Promise<void> acquireSlot() {
+    if (runningBuilds < maxParallelBuilds) {
+      maxRunningBuilds = zc::max(maxRunningBuilds, ++runningBuilds);
+      return zc::READY_NOW;
+    }
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    waiting.push_back(zc::mv(paf.fulfiller));
+    return zc::mv(paf.promise);
+  }
+
+  void releaseSlot() {
+    while (!waiting.empty()) {
+      auto next = zc::mv(waiting.front());
+      waiting.pop_front();
+      // The slot passes straight to the next build, unless that one was cancelled
+      if (next->isWaiting()) {
+        next->fulfill();
+        return;
+      }
+    }
+    --runningBuilds;
+  }
+};
+
+BuildScheduler::BuildScheduler(zc::uint maxParallelBuilds) noexcept
+    : impl(zc::heap<Impl>(maxParallelBuilds)) {
+  ZC_REQUIRE(maxParallelBuilds > 0);
+}
+
+BuildScheduler::~BuildScheduler() noexcept(false) = default;
+
+zc::Promise<void> BuildScheduler::run(const Resolution& resolution, Step fetch, Step build) {
+  auto steps = zc::heap<Impl::Steps>(Impl::Steps{zc::mv(fetch), zc::mv(build)});
+  Impl& state = *impl;
+  Step& buildStep = steps->build;
+
+  // The crates come in dependency order, so every crate's dependencies are forked before it
+  zc::Vector<zc::ForkedPromise<void>> built(resolution.crates.size());
+  for (const ResolvedCrate& crate : resolution.crates) {
+    auto ready = zc::heapArrayBuilder<zc::Promise<void>>(crate.dependencies.size() + 1);
+    ready.add(steps->fetch(crate));
+    for (size_t dependency : crate.dependencies) { ready.add(built[dependency].addBranch()); }
+
+    built.add(zc::joinPromisesFailFast(ready.finish())
+                  .then([&state]() { return state.acquireSlot(); })
+                  .then([&state, &buildStep, &crate]() {
+                    auto slot = zc::defer([&state]() { state.releaseSlot(); });
+                    return buildStep(crate).attach(zc::mv(slot));
+                  })
+                  .fork());
+  }
+
+  auto all = zc::heapArrayBuilder<zc::Promise<void>>(built.size());
+  for (auto& crate : built) { all.add(crate.addBranch()); }
+  return zc::joinPromisesFailFast(all.finish()).attach(zc::mv(built), zc::mv(steps));
+}
+
+zc::uint BuildScheduler::getMaxRunningBuilds() const { return impl->maxRunningBuilds; }
+
+}  // namespace zomcrate
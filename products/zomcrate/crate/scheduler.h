@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/async/async.h"
+#include "zc/core/common.h"
+#include "zc/core/function.h"
+#include "zc/core/memory.h"
+#include "zomcrate/crate/resolver.h"
+
+namespace zomcrate {
+
+/// \brief Fetches and builds the crates of a resolution, each as soon as it can be.
+///
+/// Every fetch is started at once, since a fetcher limits by itself how many are on the wire. A
+/// crate is built once it is fetched and all its dependencies are built, so crates that do not
+/// depend on each other build at the same time, up to `maxParallelBuilds` of them; the others
+/// wait for a slot in the order they became ready.
+class BuildScheduler {
+public:
+  using Step = zc::Function<zc::Promise<void>(const ResolvedCrate& crate)>;
+
+  explicit BuildScheduler(zc::uint maxParallelBuilds) noexcept;
+  ~BuildScheduler() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(BuildScheduler);
+
+  /// \brief Fetch and build every crate of `resolution`, which must outlive the promise. Fails as
+  /// soon as any step does, cancelling the steps still running.
+  zc::Promise<void> run(const Resolution& resolution, Step fetch, Step build);
+
+  /// \brief The most builds that ran at once.
+  zc::uint getMaxRunningBuilds() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace zomcrate
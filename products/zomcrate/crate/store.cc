@@ -0,0 +1,54 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/store.h"
+
+#include "zc/core/debug.h"
+
+namespace zomcrate {
+
+ContentStore::ContentStore(const zc::Directory& root) noexcept : root(root) {}
+
+bool ContentStore::contains(const ContentHash& hash) const { return root.exists(getPath(hash)); }
+
+zc::Maybe<zc::Own<const zc::ReadableFile>> ContentStore::open(const ContentHash& hash) const {
+  return root.tryOpenFile(getPath(hash));
+}
+
+ContentHash ContentStore::add(zc::ArrayPtr<const zc::byte> content) const {
+  ContentHash hash = ContentHash::of(content);
+  write(hash, content);
+  return hash;
+}
+
+void ContentStore::add(const ContentHash& expected, zc::ArrayPtr<const zc::byte> content) const {
+  ContentHash actual = ContentHash::of(content);
+  ZC_REQUIRE(actual == expected, "artifact does not match its checksum", expected, actual);
+  write(expected, content);
+}
+
+zc::Path ContentStore::getPath(const ContentHash& hash) {
+  zc::String hex = hash.toString();
+  return zc::Path({"objects", zc::heapString(hex.first(2)), hex.slice(2)});
+}
+
+void ContentStore::write(const ContentHash& hash, zc::ArrayPtr<const zc::byte> content) const {
+  auto replacer =
+      root.replaceFile(getPath(hash), zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT);
+  replacer->get().writeAll(content);
+  // Fails only if another writer stored the artifact first, with the same content
+  replacer->tryCommit();
+}
+
+}  // namespace zomcrate
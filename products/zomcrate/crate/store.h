@@ -0,0 +1,55 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/memory.h"
+#include "zomcrate/crate/hash.h"
+
+namespace zomcrate {
+
+/// \brief Crate artifacts on local disk, each stored under the hash of its content.
+///
+/// An artifact is at `objects/<first two hex digits>/<the other 62>` below the root, so that a
+/// crate fetched once, for any project, is never fetched again, and an artifact is never stored
+/// under a name that does not match its content. Files are written through a replacer and moved
+/// into place when complete, so a reader never sees half an artifact, and two writers of the same
+/// artifact both find it stored.
+class ContentStore {
+public:
+  explicit ContentStore(const zc::Directory& root) noexcept;
+
+  ZC_DISALLOW_COPY_AND_MOVE(ContentStore);
+
+  bool contains(const ContentHash& hash) const;
+  zc::Maybe<zc::Own<const zc::ReadableFile>> open(const ContentHash& hash) const;
+
+  /// \brief Store `content` under its own hash.
+  ContentHash add(zc::ArrayPtr<const zc::byte> content) const;
+  /// \brief Store `content` under `expected`, which it must hash to. Throws if it does not, e.g.
+  /// because a download was corrupted or tampered with.
+  void add(const ContentHash& expected, zc::ArrayPtr<const zc::byte> content) const;
+
+  /// \brief The path of an artifact relative to the root.
+  static zc::Path getPath(const ContentHash& hash);
+
+private:
+  const zc::Directory& root;
+
+  void write(const ContentHash& hash, zc::ArrayPtr<const zc::byte> content) const;
+};
+
+}  // namespace zomcrate
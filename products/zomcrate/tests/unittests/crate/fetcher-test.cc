@@ -0,0 +1,166 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/fetcher.h"
+
+#include "zc/async/async.h"
+#include "zc/core/common.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/string.h"
+#include "zc/http/http.h"
+#include "zc/zip/gzip.h"
+#include "zc/ztest/test.h"
+
+namespace zomcrate {
+
+namespace {
+
+zc::Array<zc::byte> gzip(zc::ArrayPtr<const zc::byte> content) {
+  zc::VectorOutputStream compressed;
+  {
+    zc::GzipOutputStream stream(compressed);
+    stream.write(content);
+  }
+  return zc::heapArray<zc::byte>(compressed.getArray());
+}
+
+/// Serves gzip-compressed artifacts by URL. Responses are held until `open()`, so that requests
+/// can pile up.
+class FakeRegistry final : public zc::HttpService {
+public:
+  FakeRegistry(const FetchHeaders& headers) : headers(headers) {
+    auto paf = zc::newPromiseAndFulfiller<void>();
+    gate = paf.promise.fork();
+    opener = zc::mv(paf.fulfiller);
+  }
+
+  void serve(zc::StringPtr url, zc::ArrayPtr<const zc::byte> content) {
+    artifacts.insert(zc::str(url), gzip(content));
+  }
+  void open() { opener->fulfill(); }
+
+  zc::Promise<void> request(zc::HttpMethod method, zc::StringPtr url,
+                            const zc::HttpHeaders& requestHeaders,
+                            zc::AsyncInputStream& requestBody, Response& response) override {
+    ++requests;
+    ZC_EXPECT(requestHeaders.get(headers.acceptEncoding) == zc::StringPtr("br, gzip"));
+    return gate.addBranch().then([this, url = zc::str(url), &response]() -> zc::Promise<void> {
+      zc::HttpHeaders responseHeaders(headers.table);
+      ZC_IF_SOME(artifact, artifacts.find(url)) {
+        responseHeaders.set(headers.contentEncoding, "gzip");
+        auto body = response.send(200, "OK", responseHeaders, artifact.size());
+        auto promise = body->write(artifact);
+        return promise.attach(zc::mv(body));
+      }
+      response.send(404, "Not Found", responseHeaders, uint64_t(0));
+      return zc::READY_NOW;
+    });
+  }
+
+  size_t requests = 0;
+
+private:
+  const FetchHeaders& headers;
+  zc::HashMap<zc::String, zc::Array<zc::byte>> artifacts;
+  zc::ForkedPromise<void> gate = nullptr;
+  zc::Own<zc::PromiseFulfiller<void>> opener;
+};
+
+struct FetcherTest {
+  FetcherTest() : headers(builder), table(builder.build()), server(headers) {}
+
+  Release release(zc::StringPtr name, zc::StringPtr content) {
+    return Release{zc::str(name), Version{1, 0, 0}, ContentHash::of(content.asBytes()),
+                   zc::str("/", name), nullptr};
+  }
+
+  zc::EventLoop loop;
+  zc::WaitScope waitScope{loop};
+  zc::HttpHeaderTable::Builder builder;
+  FetchHeaders headers;
+  zc::Own<zc::HttpHeaderTable> table;
+  FakeRegistry server;
+  zc::Own<zc::HttpClient> client = zc::newHttpClient(server);
+  zc::Own<const zc::Directory> root = zc::newInMemoryDirectory(zc::nullClock());
+  ContentStore store{*root};
+};
+
+}  // namespace
+
+ZC_TEST("ContentStoreTest_StoresArtifactsByHash") {
+  auto root = zc::newInMemoryDirectory(zc::nullClock());
+  ContentStore store(*root);
+
+  ContentHash hash = store.add(zc::StringPtr("artifact").asBytes());
+  ZC_EXPECT(store.contains(hash));
+  ZC_EXPECT(root->exists(zc::Path({"objects", zc::heapString(zc::str(hash).first(2))})));
+  ZC_IF_SOME(file, store.open(hash)) {
+    ZC_EXPECT(file->readAllText() == "artifact");
+  } else {
+    ZC_FAIL_EXPECT("artifact was not stored");
+  }
+
+  // The same content again is already there, and other content is refused under its hash
+  store.add(hash, zc::StringPtr("artifact").asBytes());
+  ZC_EXPECT_THROW_MESSAGE("does not match its checksum",
+                          store.add(hash, zc::StringPtr("tampered").asBytes()));
+}
+
+ZC_TEST("FetcherTest_DownloadsConcurrentlyAndDecodes") {
+  FetcherTest test;
+  Fetcher fetcher(*test.client, test.headers, test.store, 2);
+
+  zc::Vector<Release> releases;
+  for (size_t i = 0; i < 6; ++i) {
+    zc::String content = zc::str("crate number ", i, zc::repeat('.', i * 1000));
+    releases.add(test.release(zc::str("c", i), content));
+    test.server.serve(releases.back().url, content.asBytes());
+  }
+
+  auto fetches = zc::heapArrayBuilder<zc::Promise<void>>(releases.size());
+  for (const Release& release : releases) { fetches.add(fetcher.fetch(release)); }
+  auto all = zc::joinPromisesFailFast(fetches.finish());
+  test.loop.run();
+  // No more than the limit are on the wire while the server holds them
+  ZC_EXPECT(test.server.requests == 2);
+
+  test.server.open();
+  all.wait(test.waitScope);
+  ZC_EXPECT(fetcher.getDownloadCount() == 6);
+  ZC_EXPECT(fetcher.getMaxRunningRequests() == 2);
+  for (const Release& release : releases) { ZC_EXPECT(test.store.contains(release.checksum)); }
+
+  // What the store has is not fetched again
+  fetcher.fetch(releases[0]).wait(test.waitScope);
+  ZC_EXPECT(test.server.requests == 6);
+}
+
+ZC_TEST("FetcherTest_RejectsMissingAndCorruptArtifacts") {
+  FetcherTest test;
+  Fetcher fetcher(*test.client, test.headers, test.store);
+  test.server.open();
+
+  Release missing = test.release("missing", "content");
+  ZC_EXPECT_THROW_MESSAGE("failed to download crate", fetcher.fetch(missing).wait(test.waitScope));
+
+  Release corrupt = test.release("corrupt", "expected content");
+  test.server.serve(corrupt.url, zc::StringPtr("other content").asBytes());
+  ZC_EXPECT_THROW_MESSAGE("does not match its checksum",
+                          fetcher.fetch(corrupt).wait(test.waitScope));
+  ZC_EXPECT(!test.store.contains(corrupt.checksum));
+  ZC_EXPECT(fetcher.getDownloadCount() == 0);
+}
+
+}  // namespace zomcrate
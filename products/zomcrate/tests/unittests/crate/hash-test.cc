@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/hash.h"
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomcrate {
+
+ZC_TEST("ContentHashTest_MatchesKnownDigests") {
+  ZC_EXPECT(ContentHash::of(zc::StringPtr("").asBytes()).toString() ==
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+  ZC_EXPECT(ContentHash::of(zc::StringPtr("abc").asBytes()).toString() ==
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  // Two blocks, since the padding does not fit after 56 bytes
+  ZC_EXPECT(
+      ContentHash::of(
+          zc::StringPtr("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq").asBytes())
+          .toString() == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+}
+
+ZC_TEST("ContentHashTest_PiecesHashLikeTheWhole") {
+  zc::String text = zc::str(zc::repeat('z', 1000));
+  Sha256 hasher;
+  for (size_t i = 0; i < text.size(); i += 7) {
+    hasher.update(text.asBytes().slice(i, zc::min(i + 7, text.size())));
+  }
+  ZC_EXPECT(hasher.finish() == ContentHash::of(text.asBytes()));
+}
+
+ZC_TEST("ContentHashTest_ParsesItsOwnSpelling") {
+  ContentHash hash = ContentHash::of(zc::StringPtr("crate").asBytes());
+  ZC_EXPECT(ContentHash::parse(hash.toString()) == hash);
+  ZC_EXPECT(ContentHash::parse(zc::str(hash).slice(1)) == zc::none);
+  ZC_EXPECT(ContentHash::parse(zc::str(zc::repeat('g', 64))) == zc::none);
+}
+
+}  // namespace zomcrate
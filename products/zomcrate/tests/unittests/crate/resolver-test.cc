@@ -0,0 +1,101 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/resolver.h"
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomcrate {
+
+namespace {
+
+Dependency depend(zc::StringPtr name, zc::StringPtr requirement) {
+  return Dependency{zc::str(name), ZC_ASSERT_NONNULL(VersionRequirement::parse(requirement))};
+}
+
+void publish(IndexRegistry& registry, zc::StringPtr name, zc::StringPtr version,
+             zc::Array<Dependency> dependencies = nullptr) {
+  registry.add(Release{zc::str(name), ZC_ASSERT_NONNULL(Version::parse(version)),
+                       ContentHash::of(zc::str(name, version).asBytes()),
+                       zc::str("https://crates.zom/", name, "/", version), zc::mv(dependencies)});
+}
+
+zc::String describe(const Resolution& resolution) {
+  zc::Vector<zc::String> crates;
+  for (const ResolvedCrate& crate : resolution.crates) {
+    crates.add(zc::str(crate.release.name, "@", crate.release.version));
+  }
+  return zc::strArray(crates, " ");
+}
+
+}  // namespace
+
+ZC_TEST("VersionTest_RequirementsAcceptCompatibleVersions") {
+  auto version = [](zc::StringPtr text) { return ZC_ASSERT_NONNULL(Version::parse(text)); };
+  auto caret = ZC_ASSERT_NONNULL(VersionRequirement::parse("1.2.3"));
+  ZC_EXPECT(caret.matches(version("1.2.3")));
+  ZC_EXPECT(caret.matches(version("1.9.0")));
+  ZC_EXPECT(!caret.matches(version("1.2.2")));
+  ZC_EXPECT(!caret.matches(version("2.0.0")));
+
+  auto zeroMajor = ZC_ASSERT_NONNULL(VersionRequirement::parse("^0.2.3"));
+  ZC_EXPECT(zeroMajor.matches(version("0.2.9")));
+  ZC_EXPECT(!zeroMajor.matches(version("0.3.0")));
+
+  auto exact = ZC_ASSERT_NONNULL(VersionRequirement::parse("=1.2.3"));
+  ZC_EXPECT(!exact.matches(version("1.2.4")));
+
+  ZC_EXPECT(Version::parse("1.2") == zc::none);
+  ZC_EXPECT(Version::parse("1.2.3-beta") == zc::none);
+}
+
+ZC_TEST("ResolverTest_PicksTheHighestCompatibleReleases") {
+  IndexRegistry registry;
+  publish(registry, "log", "1.0.0");
+  publish(registry, "log", "1.4.0");
+  publish(registry, "log", "2.0.0");
+  publish(registry, "json", "0.3.1", zc::arr(depend("log", "1.1.0")));
+  publish(registry, "http", "1.0.0", zc::arr(depend("log", "1.0.0"), depend("json", "0.3.0")));
+
+  auto roots = zc::arr(depend("http", "1.0.0"));
+  Resolution resolution = resolve(registry, roots);
+
+  // One copy of each crate, each after its dependencies
+  ZC_EXPECT(describe(resolution) == "log@1.4.0 json@0.3.1 http@1.0.0", describe(resolution));
+  ZC_EXPECT(resolution.crates[2].dependencies.size() == 2);
+  ZC_EXPECT(resolution.crates[1].dependencies[0] == 0);
+}
+
+ZC_TEST("ResolverTest_ConflictingRequirementsFail") {
+  IndexRegistry registry;
+  publish(registry, "log", "1.0.0");
+  publish(registry, "log", "2.0.0");
+  publish(registry, "json", "1.0.0", zc::arr(depend("log", "2.0.0")));
+
+  auto roots = zc::arr(depend("json", "1.0.0"), depend("log", "1.0.0"));
+  ZC_EXPECT_THROW_MESSAGE("no release satisfies every requirement", resolve(registry, roots));
+}
+
+ZC_TEST("ResolverTest_CyclesFail") {
+  IndexRegistry registry;
+  publish(registry, "a", "1.0.0", zc::arr(depend("b", "1.0.0")));
+  publish(registry, "b", "1.0.0", zc::arr(depend("a", "1.0.0")));
+
+  auto roots = zc::arr(depend("a", "1.0.0"));
+  ZC_EXPECT_THROW_MESSAGE("cycle", resolve(registry, roots));
+}
+
+}  // namespace zomcrate
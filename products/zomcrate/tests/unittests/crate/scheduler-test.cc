@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomcrate/crate/scheduler.h"
+
+#include "zc/async/async.h"
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+
+namespace zomcrate {
+
+namespace {
+
+Release release(zc::StringPtr name) {
+  return Release{zc::str(name), Version{1, 0, 0}, ContentHash::of(name.asBytes()),
+                 zc::str("/", name), nullptr};
+}
+
+/// `a` to `d` without dependencies, and `top` depending on all four.
+struct SchedulerTest {
+  SchedulerTest() {
+    for (zc::StringPtr name : {"a", "b", "c", "d", "top"}) { releases.add(release(name)); }
+    auto crates = zc::heapArrayBuilder<ResolvedCrate>(releases.size());
+    for (size_t i = 0; i < 4; ++i) { crates.add(ResolvedCrate{releases[i], nullptr}); }
+    crates.add(ResolvedCrate{releases[4], zc::arr<size_t>(0, 1, 2, 3)});
+    resolution.crates = crates.finish();
+  }
+
+  zc::EventLoop loop;
+  zc::WaitScope waitScope{loop};
+  zc::Vector<Release> releases;
+  Resolution resolution;
+  zc::Vector<zc::String> events;
+};
+
+}  // namespace
+
+ZC_TEST("BuildSchedulerTest_IndependentCratesBuildInParallel") {
+  SchedulerTest test;
+  BuildScheduler scheduler(2);
+  size_t running = 0;
+
+  auto fetch = [&](const ResolvedCrate& crate) -> zc::Promise<void> {
+    test.events.add(zc::str("fetch ", crate.release.name));
+    return zc::evalLater([]() {});
+  };
+  auto build = [&](const ResolvedCrate& crate) -> zc::Promise<void> {
+    ++running;
+    test.events.add(zc::str("build ", crate.release.name, " with ", running, " running"));
+    return zc::evalLater([&]() { --running; });
+  };
+  scheduler.run(test.resolution, fetch, build).wait(test.waitScope);
+
+  ZC_EXPECT(scheduler.getMaxRunningBuilds() == 2);
+  // Every fetch starts before any build, and the dependent builds alone, last
+  ZC_EXPECT(test.events.size() == 10);
+  for (size_t i = 0; i < 5; ++i) { ZC_EXPECT(test.events[i].startsWith("fetch "), test.events[i]); }
+  ZC_EXPECT(test.events[5] == "build a with 1 running", test.events[5]);
+  ZC_EXPECT(test.events[6] == "build b with 2 running", test.events[6]);
+  ZC_EXPECT(test.events[9] == "build top with 1 running", test.events[9]);
+}
+
+ZC_TEST("BuildSchedulerTest_AFailedFetchStopsItsDependents") {
+  SchedulerTest test;
+  BuildScheduler scheduler(4);
+
+  auto fetch = [&](const ResolvedCrate& crate) -> zc::Promise<void> {
+    if (crate.release.name == "c") { return ZC_EXCEPTION(FAILED, "registry unreachable"); }
+    return zc::READY_NOW;
+  };
+  auto build = [&](const ResolvedCrate& crate) -> zc::Promise<void> {
+    test.events.add(zc::str(crate.release.name));
+    return zc::READY_NOW;
+  };
+  ZC_EXPECT_THROW_MESSAGE("registry unreachable",
+                          scheduler.run(test.resolution, fetch, build).wait(test.waitScope));
+  for (zc::StringPtr built : test.events) { ZC_EXPECT(built != "c" && built != "top", built); }
+}
+
+}  // namespace zomcrate
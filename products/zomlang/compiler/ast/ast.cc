@@ -27,61 +27,152 @@ namespace compiler {
 namespace ast {
 
 // ================================================================================
-// NodeImpl::Impl
+// ArenaScope
 
-struct NodeImpl::Impl {
-  SyntaxKind kind;
-  mutable NodeFlags flags = NodeFlags::None;
+namespace {
 
-  source::SourceRange range;
+thread_local zc::Arena* currentArena = nullptr;
 
-  zc::Maybe<const Node&> parent = zc::none;
+}  // namespace
 
-  Impl(SyntaxKind kind) : kind(kind) {}
-};
+ArenaScope::ArenaScope(zc::Arena& arena) noexcept : previous(getCurrentArena()) {
+  currentArena = &arena;
+}
 
-NodeImpl::NodeImpl(SyntaxKind kind) noexcept : impl(zc::heap<Impl>(kind)) {}
+ArenaScope::~ArenaScope() noexcept {
+  currentArena = nullptr;
+  ZC_IF_SOME(arena, previous) { currentArena = &arena; }
+}
 
-NodeImpl::~NodeImpl() noexcept(false) = default;
+zc::Maybe<zc::Arena&> getCurrentArena() {
+  if (currentArena == nullptr) { return zc::none; }
+  return *currentArena;
+}
 
-void NodeImpl::setSourceRange(const source::SourceRange&& range) { impl->range = zc::mv(range); }
+// ================================================================================
+// AllocationStats
 
-const source::SourceRange& NodeImpl::getSourceRange() const { return impl->range; }
+namespace {
 
-SyntaxKind NodeImpl::getKind() const { return impl->kind; }
+thread_local AllocationStats* currentAllocationStats = nullptr;
 
-NodeFlags NodeImpl::getFlags() const { return impl->flags; }
+}  // namespace
 
-void NodeImpl::setFlags(NodeFlags flags) const { impl->flags = flags; }
+AllocationStats::Entry AllocationStats::getTotal() const {
+  Entry total;
+  for (const Entry& entry : entries) {
+    total.nodes += entry.nodes;
+    total.bytes += entry.bytes;
+  }
+  return total;
+}
 
-// ================================================================================
-// TokenNode
+void AllocationStats::merge(const AllocationStats& other) {
+  for (size_t i = 0; i < entries.size(); ++i) {
+    entries[i].nodes += other.entries[i].nodes;
+    entries[i].bytes += other.entries[i].bytes;
+  }
+  pending += other.pending;
+}
 
-struct TokenNode::Impl : private NodeImpl {
-  explicit Impl(SyntaxKind kind) : NodeImpl(kind) {}
+void AllocationStats::endNode(SyntaxKind kind, size_t size, size_t resume) {
+  Entry& entry = entries[static_cast<size_t>(kind)];
+  ++entry.nodes;
+  entry.bytes += size + pending;
+  pending = resume;
+}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-};
+AllocationStatsScope::AllocationStatsScope(AllocationStats& stats) noexcept
+    : previous(getCurrentAllocationStats()) {
+  currentAllocationStats = &stats;
+}
 
-TokenNode::TokenNode(SyntaxKind kind) noexcept : impl(zc::heap<Impl>(kind)) {}
+AllocationStatsScope::~AllocationStatsScope() noexcept {
+  currentAllocationStats = nullptr;
+  ZC_IF_SOME(stats, previous) { currentAllocationStats = &stats; }
+}
 
-TokenNode::~TokenNode() noexcept(false) = default;
+zc::Maybe<AllocationStats&> getCurrentAllocationStats() {
+  if (currentAllocationStats == nullptr) { return zc::none; }
+  return *currentAllocationStats;
+}
 
-void TokenNode::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
+// ================================================================================
+// Node
+
+bool carriesFlags(SyntaxKind kind) {
+  switch (kind) {
+    // Statements, declarations and predefined types never carry flags; they always report
+    // NodeFlags::None.
+    case SyntaxKind::BindingElement:
+    case SyntaxKind::ParameterDeclaration:
+    case SyntaxKind::VariableDeclaration:
+    case SyntaxKind::VariableDeclarationList:
+    case SyntaxKind::VariableStatement:
+    case SyntaxKind::FunctionDeclaration:
+    case SyntaxKind::ClassDeclaration:
+    case SyntaxKind::InterfaceDeclaration:
+    case SyntaxKind::StructDeclaration:
+    case SyntaxKind::EnumMember:
+    case SyntaxKind::EnumDeclaration:
+    case SyntaxKind::ErrorDeclaration:
+    case SyntaxKind::AliasDeclaration:
+    case SyntaxKind::MatchClause:
+    case SyntaxKind::DefaultClause:
+    case SyntaxKind::ArrayBindingPattern:
+    case SyntaxKind::ObjectBindingPattern:
+    case SyntaxKind::BlockStatement:
+    case SyntaxKind::ExpressionStatement:
+    case SyntaxKind::IfStatement:
+    case SyntaxKind::LabeledStatement:
+    case SyntaxKind::BreakStatement:
+    case SyntaxKind::ContinueStatement:
+    case SyntaxKind::WhileStatement:
+    case SyntaxKind::ReturnStatement:
+    case SyntaxKind::EmptyStatement:
+    case SyntaxKind::MatchStatement:
+    case SyntaxKind::ForStatement:
+    case SyntaxKind::ForInStatement:
+    case SyntaxKind::HeritageClause:
+    case SyntaxKind::PropertySignature:
+    case SyntaxKind::MethodSignature:
+    case SyntaxKind::SemicolonInterfaceElement:
+    case SyntaxKind::SemicolonClassElement:
+    case SyntaxKind::MethodDeclaration:
+    case SyntaxKind::InitDeclaration:
+    case SyntaxKind::DeinitDeclaration:
+    case SyntaxKind::GetAccessor:
+    case SyntaxKind::SetAccessor:
+    case SyntaxKind::PropertyDeclaration:
+    case SyntaxKind::BoolTypeNode:
+    case SyntaxKind::I8TypeNode:
+    case SyntaxKind::I16TypeNode:
+    case SyntaxKind::I32TypeNode:
+    case SyntaxKind::I64TypeNode:
+    case SyntaxKind::U8TypeNode:
+    case SyntaxKind::U16TypeNode:
+    case SyntaxKind::U32TypeNode:
+    case SyntaxKind::U64TypeNode:
+    case SyntaxKind::F32TypeNode:
+    case SyntaxKind::F64TypeNode:
+    case SyntaxKind::StrTypeNode:
+    case SyntaxKind::UnitTypeNode:
+    case SyntaxKind::NullTypeNode:
+    case SyntaxKind::ObjectTypeNode:
+    case SyntaxKind::SourceFile:
+    case SyntaxKind::ModulePath:
+      return false;
+    default:
+      return true;
+  }
 }
 
-const source::SourceRange& TokenNode::getSourceRange() const { return impl->getSourceRange(); }
+// ================================================================================
+// TokenNode
 
-SyntaxKind TokenNode::getKind() const { return impl->getKind(); }
+TokenNode::TokenNode(SyntaxKind kind) noexcept : Node(kind) {}
 
-NodeFlags TokenNode::getFlags() const { return impl->getFlags(); }
-void TokenNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
+TokenNode::~TokenNode() noexcept(false) = default;
 
 void TokenNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
@@ -95,7 +186,7 @@ struct LocalsContainerImpl::Impl {
   Impl() = default;
 };
 
-LocalsContainerImpl::LocalsContainerImpl() noexcept : impl(zc::heap<Impl>()) {}
+LocalsContainerImpl::LocalsContainerImpl() noexcept : impl(allocate<Impl>()) {}
 
 LocalsContainerImpl::~LocalsContainerImpl() noexcept(false) = default;
 
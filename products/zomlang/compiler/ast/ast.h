@@ -14,23 +14,23 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <type_traits>
 
+#include "zc/core/arena.h"
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
 #include "zc/core/memory.h"
 #include "zc/core/vector.h"
+#include "zomlang/compiler/basic/side-table.h"
 #include "zomlang/compiler/ast/kinds.h"
 #include "zomlang/compiler/ast/visitor.h"
+#include "zomlang/compiler/source/location.h"
 
 namespace zomlang {
 namespace compiler {
 
-namespace source {
-class SourceRange;
-}  // namespace source
-
 namespace symbol {
 class Symbol;
 class SymbolTable;
@@ -39,6 +39,7 @@ class SymbolTable;
 namespace ast {
 
 // Forward declarations
+class Node;
 class Visitor;
 
 enum class NodeFlags : uint32_t {
@@ -81,6 +82,114 @@ constexpr bool hasFlag(NodeFlags flags, NodeFlags flag) {
   return (flags & flag) != NodeFlags::None;
 }
 
+/// \brief Check whether nodes of the given kind carry flags. Setting flags on any other node is a
+/// no-op.
+bool carriesFlags(SyntaxKind kind);
+
+/// \brief Route AST allocations on the current thread to an arena.
+///
+/// While a scope is active, nodes created through `ast::factory`, and the implementation objects
+/// they own, are bump-allocated from `arena` instead of the heap. Every such node must be destroyed
+/// before the arena is; `SourceFile::adoptArena()` ties the arena's lifetime to the tree. Scopes
+/// nest, restoring the previous arena on exit.
+class ArenaScope {
+public:
+  explicit ArenaScope(zc::Arena& arena) noexcept;
+  ~ArenaScope() noexcept;
+
+  ZC_DISALLOW_COPY_AND_MOVE(ArenaScope);
+
+private:
+  zc::Maybe<zc::Arena&> previous;
+};
+
+/// \brief Get the arena AST allocations are currently routed to, if any.
+zc::Maybe<zc::Arena&> getCurrentArena();
+
+/// \brief Counts and bytes of the AST allocations made on a thread, by node kind.
+///
+/// While an `AllocationStatsScope` is active, each node created through `allocate()` is charged
+/// with its own size plus everything allocated while it is constructed: its implementation object
+/// and the capacity of the child lists it takes over. Nodes that are dropped again, such as the
+/// results of failed speculative parses, are included since their memory is only returned with
+/// the arena. Token nodes are recorded under their token kind.
+class AllocationStats {
+public:
+  struct Entry {
+    size_t nodes = 0;
+    size_t bytes = 0;
+  };
+
+  AllocationStats() noexcept = default;
+
+  ZC_DISALLOW_COPY_AND_MOVE(AllocationStats);
+
+  const Entry& get(SyntaxKind kind) const { return entries[static_cast<size_t>(kind)]; }
+  /// \brief Sum over all kinds.
+  Entry getTotal() const;
+  /// \brief Bytes allocated outside the construction of any node.
+  size_t getUnattributedBytes() const { return pending; }
+
+  /// \brief Add the allocations recorded by `other`, e.g. on another thread.
+  void merge(const AllocationStats& other);
+
+  /// \brief Charge `bytes` to the node under construction. Used by `allocate()` and `NodeList`.
+  void charge(size_t bytes) { pending += bytes; }
+  /// \brief Start charging a node; returns what `endNode()` needs to resume the enclosing one.
+  size_t beginNode() {
+    const size_t resume = pending;
+    pending = 0;
+    return resume;
+  }
+  void endNode(SyntaxKind kind, size_t size, size_t resume);
+
+private:
+  std::array<Entry, static_cast<size_t>(SyntaxKind::Count)> entries{};
+  size_t pending = 0;
+};
+
+/// \brief Record AST allocations on the current thread into `stats`. Scopes nest like
+/// `ArenaScope`.
+class AllocationStatsScope {
+public:
+  explicit AllocationStatsScope(AllocationStats& stats) noexcept;
+  ~AllocationStatsScope() noexcept;
+
+  ZC_DISALLOW_COPY_AND_MOVE(AllocationStatsScope);
+
+private:
+  zc::Maybe<AllocationStats&> previous;
+};
+
+/// \brief Get the statistics AST allocations are currently recorded into, if any.
+zc::Maybe<AllocationStats&> getCurrentAllocationStats();
+
+namespace _ {  // Private implementation details
+
+template <typename T, typename... Params>
+zc::Own<T> allocateUncounted(Params&&... params) {
+  ZC_IF_SOME(arena, getCurrentArena()) { return arena.allocateOwn<T>(zc::fwd<Params>(params)...); }
+  return zc::heap<T>(zc::fwd<Params>(params)...);
+}
+
+}  // namespace _
+
+/// \brief Allocate an AST object from the current arena, or from the heap when there is none.
+template <typename T, typename... Params>
+zc::Own<T> allocate(Params&&... params) {
+  ZC_IF_SOME(stats, getCurrentAllocationStats()) {
+    if constexpr (std::is_base_of_v<Node, T>) {
+      const size_t resume = stats.beginNode();
+      zc::Own<T> node = _::allocateUncounted<T>(zc::fwd<Params>(params)...);
+      stats.endNode(node->getKind(), sizeof(T), resume);
+      return node;
+    } else {
+      stats.charge(sizeof(T));
+    }
+  }
+  return _::allocateUncounted<T>(zc::fwd<Params>(params)...);
+}
+
 class Visitable {
 public:
   ZC_DISALLOW_COPY_AND_MOVE(Visitable);
@@ -91,56 +200,75 @@ protected:
   Visitable() = default;
 };
 
+/// \brief Dense id of a node, for data kept about nodes outside the tree.
+///
+/// Nodes are created without one; the binder numbers the nodes it records something about from 1
+/// upward, so side tables indexed by them stay small.
+class NodeId {
+public:
+  NodeId() = default;
+
+  static NodeId create(uint32_t index) {
+    NodeId id;
+    id.raw = index;
+    return id;
+  }
+
+  uint32_t index() const { return raw; }
+  bool isValid() const { return raw != 0; }
+
+  bool operator==(const NodeId& other) const { return raw == other.raw; }
+
+private:
+  uint32_t raw = 0;
+};
+
+/// \brief Per-node data in an array indexed by NodeId
+template <typename T>
+using NodeSideTable = basic::SideTable<NodeId, T>;
+
 // Base class for all AST nodes
+//
+// Kind, flags and source range live inline so that `isa`/`cast` checks and range lookups are plain
+// loads rather than virtual calls.
 class Node : public Visitable {
 public:
   ZC_DISALLOW_COPY_AND_MOVE(Node);
 
   /// \brief Set the source range of this node
-  virtual void setSourceRange(const source::SourceRange&& range) = 0;
+  void setSourceRange(const source::SourceRange&& range) { this->range = range; }
 
   /// \brief Get the source range of this node
-  virtual const source::SourceRange& getSourceRange() const = 0;
+  const source::SourceRange& getSourceRange() const { return range; }
 
   /// \brief Get the syntax kind of this node
-  virtual SyntaxKind getKind() const = 0;
+  SyntaxKind getKind() const { return kind; }
 
   /// \brief Get the node flags
-  virtual NodeFlags getFlags() const = 0;
-
-  /// \brief Set the node flags
-  virtual void setFlags(NodeFlags flags) = 0;
+  NodeFlags getFlags() const { return flags; }
 
-protected:
-  Node() noexcept = default;
-};
-
-class NodeImpl {
-public:
-  explicit NodeImpl(SyntaxKind kind) noexcept;
-  ~NodeImpl() noexcept(false);
-
-  void setSourceRange(const source::SourceRange&& range);
+  /// \brief Set the node flags. Ignored for kinds that do not carry flags.
+  void setFlags(NodeFlags flags) {
+    if (carriesFlags(kind)) { this->flags = flags; }
+  }
 
-  const source::SourceRange& getSourceRange() const;
+  /// \brief Get the node's id, invalid until one is assigned
+  NodeId getId() const { return id; }
 
-  SyntaxKind getKind() const;
+  /// \brief Assign the node's id. The binder does this for the nodes it binds.
+  void setId(NodeId id) { this->id = id; }
 
-  NodeFlags getFlags() const;
-  void setFlags(NodeFlags flags) const;
+protected:
+  explicit Node(SyntaxKind kind) noexcept : kind(kind) {}
 
 private:
-  struct Impl;
-  zc::Own<Impl> impl;
+  const SyntaxKind kind;
+  NodeFlags flags = NodeFlags::None;
+  source::SourceRange range;
+  NodeId id;
 };
 
-#define NODE_METHOD_DECLARE()                                      \
-  void setSourceRange(const source::SourceRange&& range) override; \
-  const source::SourceRange& getSourceRange() const override;      \
-  SyntaxKind getKind() const override;                             \
-  NodeFlags getFlags() const override;                             \
-  void setFlags(NodeFlags flags) override;                         \
-  void accept(Visitor& visitor) const override;
+#define NODE_METHOD_DECLARE() void accept(Visitor& visitor) const override;
 
 class TokenNode final : public Node {
 public:
@@ -150,10 +278,6 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(TokenNode);
 
   NODE_METHOD_DECLARE();
-
-private:
-  struct Impl;
-  zc::Own<Impl> impl;
 };
 
 /// \brief Interface for AST nodes that can contain local symbols
@@ -230,7 +354,11 @@ template <NodeLike T>
 class NodeList {
 public:
   NodeList() noexcept = default;
-  explicit NodeList(zc::Vector<zc::Own<T>>&& nodes) noexcept : nodes(zc::mv(nodes)) {}
+  explicit NodeList(zc::Vector<zc::Own<T>>&& nodes) noexcept : nodes(zc::mv(nodes)) {
+    ZC_IF_SOME(stats, getCurrentAllocationStats()) {
+      stats.charge(this->nodes.capacity() * sizeof(zc::Own<T>));
+    }
+  }
 
   ~NodeList() noexcept(false) = default;
 
@@ -261,6 +389,8 @@ public:
     return result;
   }
   void clear() { nodes.clear(); }
+  /// Move every node out, leaving the list empty
+  zc::Vector<zc::Own<T>> release() { return zc::mv(nodes); }
 
   // Access operations
   T& operator[](size_t index) { return *nodes[index]; }
@@ -0,0 +1,1853 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/compact.h"
+
+#include <cstring>
+#include <type_traits>
+
+#include "zc/core/arena.h"
+#include "zc/core/map.h"
+#include "zc/core/one-of.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/factory.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/type.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+constexpr uint32_t kNoOffset = UINT32_MAX;
+constexpr uint32_t kNoPayload = UINT32_MAX;
+
+static_assert(static_cast<uint32_t>(SyntaxKind::Count) <= UINT16_MAX,
+              "SyntaxKind must fit the 16-bit kind column");
+
+/// Header of a serialized tree. The columns follow in declaration order of `Impl`'s views, each
+/// padded to 8 bytes so that every column is naturally aligned when the image is.
+struct ImageHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t nodeCount;
+  uint32_t textCount;
+  uint32_t textBytes;
+  uint32_t integerCount;
+  uint32_t floatCount;
+  uint32_t extraCount;
+  uint32_t reserved;
+};
+
+constexpr char kImageMagic[4] = {'Z', 'A', 'S', 'T'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kImageAlignment = 8;
+
+// A node's kind and flags share one 16-bit tag: the kind in the low bits, the flags above it.
+constexpr unsigned kKindBits = 10;
+constexpr uint16_t kKindMask = (1u << kKindBits) - 1;
+
+static_assert(static_cast<unsigned>(SyntaxKind::Count) <= kKindMask);
+
+static_assert(sizeof(ImageHeader) % kImageAlignment == 0);
+
+}  // namespace
+
+struct CompactTree::Impl {
+  // Columns, one entry per node in preorder. They view either `owned` or a serialized image.
+  zc::ArrayPtr<const int64_t> integers;
+  zc::ArrayPtr<const double> floats;
+  zc::ArrayPtr<const uint32_t> starts;  // Offset from `base`, or kNoOffset without a range.
+  zc::ArrayPtr<const uint32_t> lengths;
+  zc::ArrayPtr<const NodeIndex> subtreeEnds;
+  // Index into the payload column for the node's kind: text, integers or floats for literals,
+  // otherwise the offset of the node's extra words, or kNoPayload without any.
+  zc::ArrayPtr<const uint32_t> payloads;
+  zc::ArrayPtr<const uint32_t> extras;  // Per node: a word count, then that many words.
+  zc::ArrayPtr<const uint32_t> textOffsets;
+  zc::ArrayPtr<const uint16_t> tags;  // Kind and flags, see `kKindBits`.
+  zc::ArrayPtr<const char> textData;  // NUL-terminated runs, indexed by `textOffsets`.
+
+  source::SourceLoc base;
+
+  /// Columns of a tree encoded in this process.
+  struct Storage {
+    zc::Vector<int64_t> integers;
+    zc::Vector<double> floats;
+    zc::Vector<uint32_t> starts;
+    zc::Vector<uint32_t> lengths;
+    zc::Vector<NodeIndex> subtreeEnds;
+    zc::Vector<uint32_t> payloads;
+    zc::Vector<uint32_t> extras;
+    zc::Vector<uint32_t> textOffsets;
+    zc::Vector<uint16_t> tags;
+    zc::Vector<char> textData;
+  };
+  Storage owned;
+
+  /// Serialized image adopted by `deserialize()`, if the caller handed over ownership.
+  zc::Array<const zc::byte> image;
+
+  void viewOwned() {
+    integers = owned.integers.asPtr();
+    floats = owned.floats.asPtr();
+    starts = owned.starts.asPtr();
+    lengths = owned.lengths.asPtr();
+    subtreeEnds = owned.subtreeEnds.asPtr();
+    payloads = owned.payloads.asPtr();
+    extras = owned.extras.asPtr();
+    textOffsets = owned.textOffsets.asPtr();
+    tags = owned.tags.asPtr();
+    textData = owned.textData.asPtr();
+  }
+
+  /// Point the columns into `bytes` after checking that every index they hold stays in bounds, so
+  /// that accessors never read outside the image.
+  bool viewImage(zc::ArrayPtr<const zc::byte> bytes);
+
+  SyntaxKind kindOf(NodeIndex index) const {
+    return static_cast<SyntaxKind>(tags[index] & kKindMask);
+  }
+
+  NodeFlags flagsOf(NodeIndex index) const {
+    return static_cast<NodeFlags>(tags[index] >> kKindBits);
+  }
+
+  uint32_t payloadOf(NodeIndex index, SyntaxKind kind) const {
+    ZC_REQUIRE(index < tags.size(), "node index out of range");
+    if (kindOf(index) != kind) { return kNoPayload; }
+    return payloads[index];
+  }
+};
+
+namespace {
+
+size_t alignImageOffset(size_t offset) {
+  return (offset + kImageAlignment - 1) & ~(kImageAlignment - 1);
+}
+
+template <typename T>
+void appendColumn(zc::Vector<zc::byte>& out, zc::ArrayPtr<const T> column) {
+  out.addAll(column.asBytes());
+  // Zero the padding so equal trees always serialize to equal images.
+  while (out.size() % kImageAlignment != 0) { out.add(0); }
+}
+
+template <typename T>
+bool takeColumn(zc::ArrayPtr<const zc::byte>& rest, size_t count, zc::ArrayPtr<const T>& column) {
+  const size_t bytes = count * sizeof(T);
+  if (rest.size() < bytes) { return false; }
+  column = zc::arrayPtr(reinterpret_cast<const T*>(rest.begin()), count);
+  rest = rest.slice(zc::min(alignImageOffset(bytes), rest.size()), rest.size());
+  return true;
+}
+
+}  // namespace
+
+bool CompactTree::Impl::viewImage(zc::ArrayPtr<const zc::byte> bytes) {
+  if (bytes.size() < sizeof(ImageHeader) ||
+      reinterpret_cast<uintptr_t>(bytes.begin()) % kImageAlignment != 0) {
+    return false;
+  }
+  ImageHeader header;
+  memcpy(&header, bytes.begin(), sizeof(header));
+  if (memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) != 0 ||
+      header.version != kFormatVersion || header.byteOrder != kByteOrderMark) {
+    return false;
+  }
+
+  auto rest = bytes.slice(sizeof(ImageHeader), bytes.size());
+  const size_t n = header.nodeCount;
+  if (!takeColumn(rest, header.integerCount, integers) ||
+      !takeColumn(rest, header.floatCount, floats) || !takeColumn(rest, n, starts) ||
+      !takeColumn(rest, n, lengths) || !takeColumn(rest, n, subtreeEnds) ||
+      !takeColumn(rest, n, payloads) || !takeColumn(rest, header.extraCount, extras) ||
+      !takeColumn(rest, header.textCount, textOffsets) ||
+      !takeColumn(rest, n, tags) ||
+      !takeColumn(rest, header.textBytes, textData)) {
+    return false;
+  }
+
+  if (textData.size() > 0 && textData.back() != '\0') { return false; }
+  for (uint32_t offset : textOffsets) {
+    if (offset >= textData.size()) { return false; }
+  }
+  for (NodeIndex i = 0; i < n; ++i) {
+    if (subtreeEnds[i] <= i || subtreeEnds[i] > n) { return false; }
+    if ((tags[i] & kKindMask) >= static_cast<uint16_t>(SyntaxKind::Count)) { return false; }
+    const uint32_t payload = payloads[i];
+    switch (kindOf(i)) {
+      case SyntaxKind::Identifier:
+      case SyntaxKind::StringLiteral:
+      case SyntaxKind::BigIntLiteral:
+        if (payload >= textOffsets.size()) { return false; }
+        break;
+      case SyntaxKind::IntegerLiteral:
+        if (payload >= integers.size()) { return false; }
+        break;
+      case SyntaxKind::FloatLiteral:
+        if (payload >= floats.size()) { return false; }
+        break;
+      case SyntaxKind::BooleanLiteral:
+        break;
+      default:
+        if (payload != kNoPayload &&
+            (payload >= extras.size() || extras[payload] > extras.size() - payload - 1)) {
+          return false;
+        }
+        break;
+    }
+  }
+  return true;
+}
+
+namespace {
+
+template <typename T>
+const Node& asNode(const T& node) {
+  if constexpr (std::is_base_of_v<Node, T>) {
+    return node;
+  } else {
+    // Class, interface and object literal elements are nodes, but not through their interface.
+    return dynamic_cast<const Node&>(node);
+  }
+}
+
+template <typename T>
+const Node& asNode(const zc::Own<T>& node) {
+  return asNode(*node);
+}
+
+}  // namespace
+
+/// Encodes an object-model tree into the columns of a CompactTree. Children are encoded in the
+/// order NodeWalker visits them, followed by the parts NodeWalker skips, such as operator tokens.
+/// Everything a node's getters expose beyond its children goes into its extra words in the order
+/// the decoder reads them back: presence flags of optional children, list counts, operators,
+/// modifiers and booleans.
+class CompactTreeBuilder final {
+public:
+  explicit CompactTreeBuilder(CompactTree::Impl& tree) : tree(tree) {}
+
+  ZC_DISALLOW_COPY_AND_MOVE(CompactTreeBuilder);
+
+  void build(const Node& root) {
+    encode(root);
+    ZC_ASSERT(words.empty());
+    pack();
+    tree.viewOwned();
+  }
+
+private:
+  CompactTree::Impl& tree;
+  zc::Vector<source::SourceRange> ranges;
+  /// Extra words of the nodes being encoded, innermost last. A node's words move to the extras
+  /// column once its children are done.
+  zc::Vector<uint32_t> words;
+  /// Text already stored, so repeated names and strings share one run.
+  zc::HashMap<zc::String, uint32_t> texts;
+
+  void encode(const Node& node) {
+    ZC_REQUIRE(tree.owned.tags.size() < UINT32_MAX, "too many nodes for a compact tree");
+    const auto flags = static_cast<uint32_t>(node.getFlags());
+    ZC_REQUIRE(flags >> (16 - kKindBits) == 0, "node flags do not fit a compact tree tag", flags);
+    const auto index = static_cast<CompactTree::NodeIndex>(tree.owned.tags.size());
+    tree.owned.tags.add(static_cast<uint16_t>(static_cast<uint32_t>(node.getKind()) |
+                                              flags << kKindBits));
+    tree.owned.subtreeEnds.add(index + 1);
+    tree.owned.payloads.add(kNoPayload);
+    ranges.add(node.getSourceRange());
+
+    const size_t first = words.size();
+    encodeFields(index, node);
+
+    // Reading past the end of a node's words yields zero, so trailing zeros are not stored and
+    // most nodes need no extras at all.
+    size_t last = words.size();
+    while (last > first && words[last - 1] == 0) { --last; }
+    if (last > first) {
+      ZC_REQUIRE(tree.owned.extras.size() < kNoPayload, "too many extras for a compact tree");
+      tree.owned.payloads[index] = static_cast<uint32_t>(tree.owned.extras.size());
+      tree.owned.extras.add(static_cast<uint32_t>(last - first));
+      tree.owned.extras.addAll(words.begin() + first, words.begin() + last);
+    }
+    words.truncate(first);
+    tree.owned.subtreeEnds[index] = static_cast<CompactTree::NodeIndex>(tree.owned.tags.size());
+  }
+
+  void encodeFields(CompactTree::NodeIndex index, const Node& node) {
+    switch (node.getKind()) {
+      case SyntaxKind::SourceFile: {
+        const auto& file = static_cast<const SourceFile&>(node);
+        word(addText(file.getFileName()));
+        optional(file.getModuleDeclaration());
+        rest(file.getStatements());
+        break;
+      }
+      case SyntaxKind::ModulePath:
+        rest(static_cast<const ModulePath&>(node).getSegments());
+        break;
+      case SyntaxKind::ImportSpecifier: {
+        const auto& specifier = static_cast<const ImportSpecifier&>(node);
+        encode(specifier.getImportedName());
+        optional(specifier.getAlias());
+        break;
+      }
+      case SyntaxKind::ExportSpecifier: {
+        const auto& specifier = static_cast<const ExportSpecifier&>(node);
+        encode(specifier.getExportedName());
+        optional(specifier.getAlias());
+        break;
+      }
+      case SyntaxKind::Identifier:
+        setText(index, static_cast<const Identifier&>(node).getText());
+        break;
+      case SyntaxKind::BindingElement: {
+        const auto& element = static_cast<const BindingElement&>(node);
+        name(element.getName());
+        optional(element.getInitializer());
+        break;
+      }
+      case SyntaxKind::CaptureElement: {
+        const auto& capture = static_cast<const CaptureElement&>(node);
+        word(capture.isByReference());
+        word(capture.isThis());
+        optional(capture.getIdentifier());
+        break;
+      }
+      case SyntaxKind::VariableDeclaration: {
+        const auto& declaration = static_cast<const VariableDeclaration&>(node);
+        name(declaration.getName());
+        optional(declaration.getType());
+        optional(declaration.getInitializer());
+        break;
+      }
+      case SyntaxKind::VariableDeclarationList:
+        rest(static_cast<const VariableDeclarationList&>(node).getBindings());
+        break;
+      case SyntaxKind::TypeParameterDeclaration: {
+        const auto& parameter = static_cast<const TypeParameterDeclaration&>(node);
+        name(parameter.getName());
+        optional(parameter.getConstraint());
+        break;
+      }
+      case SyntaxKind::MethodDeclaration: {
+        const auto& method = static_cast<const MethodDeclaration&>(node);
+        modifiers(method.getModifiers());
+        name(method.getName());
+        word(method.isOptional());
+        list(method.getTypeParameters());
+        list(method.getParameters());
+        optional(method.getReturnType());
+        optional(method.getBody());
+        break;
+      }
+      case SyntaxKind::GetAccessor: {
+        const auto& accessor = static_cast<const GetAccessor&>(node);
+        modifiers(accessor.getModifiers());
+        name(accessor.getName());
+        list(accessor.getTypeParameters());
+        list(accessor.getParameters());
+        optional(accessor.getReturnType());
+        optional(accessor.getBody());
+        break;
+      }
+      case SyntaxKind::SetAccessor: {
+        const auto& accessor = static_cast<const SetAccessor&>(node);
+        modifiers(accessor.getModifiers());
+        name(accessor.getName());
+        list(accessor.getTypeParameters());
+        list(accessor.getParameters());
+        optional(accessor.getReturnType());
+        optional(accessor.getBody());
+        break;
+      }
+      case SyntaxKind::InitDeclaration: {
+        const auto& init = static_cast<const InitDeclaration&>(node);
+        modifiers(init.getModifiers());
+        list(init.getTypeParameters());
+        list(init.getParameters());
+        optional(init.getReturnType());
+        optional(init.getBody());
+        break;
+      }
+      case SyntaxKind::DeinitDeclaration: {
+        const auto& deinit = static_cast<const DeinitDeclaration&>(node);
+        modifiers(deinit.getModifiers());
+        optional(deinit.getBody());
+        break;
+      }
+      case SyntaxKind::ParameterDeclaration: {
+        const auto& parameter = static_cast<const ParameterDeclaration&>(node);
+        modifiers(parameter.getModifiers());
+        optional(parameter.getDotDotDotToken());
+        name(parameter.getName());
+        optional(parameter.getQuestionToken());
+        optional(parameter.getType());
+        optional(parameter.getInitializer());
+        break;
+      }
+      case SyntaxKind::PropertyDeclaration: {
+        const auto& property = static_cast<const PropertyDeclaration&>(node);
+        modifiers(property.getModifiers());
+        name(property.getName());
+        optional(property.getType());
+        optional(property.getInitializer());
+        break;
+      }
+      case SyntaxKind::SemicolonClassElement:
+      case SyntaxKind::SemicolonInterfaceElement:
+        break;
+      case SyntaxKind::PropertySignature: {
+        const auto& property = static_cast<const PropertySignature&>(node);
+        modifiers(property.getModifiers());
+        name(property.getName());
+        word(property.isOptional());
+        optional(property.getType());
+        optional(property.getInitializer());
+        break;
+      }
+      case SyntaxKind::MethodSignature: {
+        const auto& method = static_cast<const MethodSignature&>(node);
+        modifiers(method.getModifiers());
+        name(method.getName());
+        word(method.isOptional());
+        list(method.getTypeParameters());
+        list(method.getParameters());
+        optional(method.getReturnType());
+        break;
+      }
+      case SyntaxKind::ModuleDeclaration:
+        encode(static_cast<const ModuleDeclaration&>(node).getModulePath());
+        break;
+      case SyntaxKind::ImportDeclaration: {
+        const auto& declaration = static_cast<const ImportDeclaration&>(node);
+        encode(declaration.getModulePath());
+        optional(declaration.getAlias());
+        rest(declaration.getSpecifiers());
+        break;
+      }
+      case SyntaxKind::ExportDeclaration: {
+        const auto& declaration = static_cast<const ExportDeclaration&>(node);
+        optional(declaration.getModulePath());
+        list(declaration.getSpecifiers());
+        optional(declaration.getDeclaration());
+        break;
+      }
+      case SyntaxKind::FunctionDeclaration: {
+        const auto& function = static_cast<const FunctionDeclaration&>(node);
+        name(function.getName());
+        list(function.getTypeParameters());
+        list(function.getParameters());
+        optional(function.getReturnType());
+        encode(function.getBody());
+        break;
+      }
+      case SyntaxKind::ClassDeclaration: {
+        const auto& declaration = static_cast<const ClassDeclaration&>(node);
+        name(declaration.getName());
+        list(declaration.getTypeParameters());
+        list(declaration.getHeritageClauses());
+        rest(declaration.getMembers());
+        break;
+      }
+      case SyntaxKind::InterfaceDeclaration: {
+        const auto& declaration = static_cast<const InterfaceDeclaration&>(node);
+        name(declaration.getName());
+        list(declaration.getTypeParameters());
+        list(declaration.getHeritageClauses());
+        rest(declaration.getMembers());
+        break;
+      }
+      case SyntaxKind::StructDeclaration: {
+        const auto& declaration = static_cast<const StructDeclaration&>(node);
+        name(declaration.getName());
+        list(declaration.getTypeParameters());
+        list(declaration.getHeritageClauses());
+        rest(declaration.getMembers());
+        break;
+      }
+      case SyntaxKind::EnumDeclaration: {
+        const auto& declaration = static_cast<const EnumDeclaration&>(node);
+        name(declaration.getName());
+        rest(declaration.getMembers());
+        break;
+      }
+      case SyntaxKind::EnumMember: {
+        const auto& member = static_cast<const EnumMember&>(node);
+        name(member.getName());
+        optional(member.getInitializer());
+        optional(member.getTupleType());
+        break;
+      }
+      case SyntaxKind::ErrorDeclaration: {
+        const auto& declaration = static_cast<const ErrorDeclaration&>(node);
+        name(declaration.getName());
+        rest(declaration.getMembers());
+        break;
+      }
+      case SyntaxKind::AliasDeclaration: {
+        const auto& declaration = static_cast<const AliasDeclaration&>(node);
+        name(declaration.getName());
+        list(declaration.getTypeParameters());
+        encode(declaration.getType());
+        break;
+      }
+      case SyntaxKind::VariableStatement:
+        encode(static_cast<const VariableStatement&>(node).getDeclarations());
+        break;
+      case SyntaxKind::BlockStatement:
+        rest(static_cast<const BlockStatement&>(node).getStatements());
+        break;
+      case SyntaxKind::EmptyStatement:
+      case SyntaxKind::DebuggerStatement:
+        break;
+      case SyntaxKind::ExpressionStatement:
+        encode(static_cast<const ExpressionStatement&>(node).getExpression());
+        break;
+      case SyntaxKind::IfStatement: {
+        const auto& statement = static_cast<const IfStatement&>(node);
+        encode(statement.getCondition());
+        encode(statement.getThenStatement());
+        optional(statement.getElseStatement());
+        break;
+      }
+      case SyntaxKind::WhileStatement: {
+        const auto& statement = static_cast<const WhileStatement&>(node);
+        encode(statement.getCondition());
+        encode(statement.getBody());
+        break;
+      }
+      case SyntaxKind::ForStatement: {
+        const auto& statement = static_cast<const ForStatement&>(node);
+        optional(statement.getInitializer());
+        optional(statement.getCondition());
+        optional(statement.getUpdate());
+        encode(statement.getBody());
+        break;
+      }
+      case SyntaxKind::ForInStatement: {
+        const auto& statement = static_cast<const ForInStatement&>(node);
+        encode(statement.getInitializer());
+        encode(statement.getExpression());
+        encode(statement.getBody());
+        break;
+      }
+      case SyntaxKind::LabeledStatement: {
+        const auto& statement = static_cast<const LabeledStatement&>(node);
+        encode(statement.getLabel());
+        encode(statement.getStatement());
+        break;
+      }
+      case SyntaxKind::BreakStatement:
+        optional(static_cast<const BreakStatement&>(node).getLabel());
+        break;
+      case SyntaxKind::ContinueStatement:
+        optional(static_cast<const ContinueStatement&>(node).getLabel());
+        break;
+      case SyntaxKind::ReturnStatement:
+        optional(static_cast<const ReturnStatement&>(node).getExpression());
+        break;
+      case SyntaxKind::MatchStatement: {
+        const auto& statement = static_cast<const MatchStatement&>(node);
+        encode(statement.getDiscriminant());
+        rest(statement.getClauses());
+        break;
+      }
+      case SyntaxKind::MatchClause: {
+        const auto& clause = static_cast<const MatchClause&>(node);
+        encode(clause.getPattern());
+        optional(clause.getGuard());
+        encode(clause.getBody());
+        break;
+      }
+      case SyntaxKind::DefaultClause:
+        rest(static_cast<const DefaultClause&>(node).getStatements());
+        break;
+      case SyntaxKind::ArrayBindingPattern:
+        rest(static_cast<const ArrayBindingPattern&>(node).getElements());
+        break;
+      case SyntaxKind::ObjectBindingPattern:
+        rest(static_cast<const ObjectBindingPattern&>(node).getProperties());
+        break;
+      case SyntaxKind::PrefixUnaryExpression: {
+        const auto& expression = static_cast<const PrefixUnaryExpression&>(node);
+        word(static_cast<uint32_t>(expression.getOperator()));
+        encode(expression.getOperand());
+        break;
+      }
+      case SyntaxKind::PostfixUnaryExpression: {
+        const auto& expression = static_cast<const PostfixUnaryExpression&>(node);
+        word(static_cast<uint32_t>(expression.getOperator()));
+        encode(expression.getOperand());
+        break;
+      }
+      case SyntaxKind::PropertyAccessExpression: {
+        const auto& expression = static_cast<const PropertyAccessExpression&>(node);
+        encode(expression.getExpression());
+        encode(expression.getName());
+        word(expression.isQuestionDot());
+        break;
+      }
+      case SyntaxKind::ElementAccessExpression: {
+        const auto& expression = static_cast<const ElementAccessExpression&>(node);
+        encode(expression.getExpression());
+        encode(expression.getIndex());
+        word(expression.isQuestionDot());
+        break;
+      }
+      case SyntaxKind::NewExpression: {
+        const auto& expression = static_cast<const NewExpression&>(node);
+        encode(expression.getCallee());
+        optionalList(expression.getArguments());
+        break;
+      }
+      case SyntaxKind::ParenthesizedExpression:
+        encode(static_cast<const ParenthesizedExpression&>(node).getExpression());
+        break;
+      case SyntaxKind::BinaryExpression: {
+        const auto& expression = static_cast<const BinaryExpression&>(node);
+        encode(expression.getLeft());
+        encode(expression.getOperator());
+        encode(expression.getRight());
+        break;
+      }
+      case SyntaxKind::ConditionalExpression: {
+        const auto& expression = static_cast<const ConditionalExpression&>(node);
+        encode(expression.getTest());
+        encode(expression.getConsequent());
+        encode(expression.getAlternate());
+        break;
+      }
+      case SyntaxKind::CallExpression: {
+        const auto& expression = static_cast<const CallExpression&>(node);
+        encode(expression.getCallee());
+        rest(expression.getArguments());
+        break;
+      }
+      case SyntaxKind::FunctionExpression: {
+        const auto& expression = static_cast<const FunctionExpression&>(node);
+        optionalList(expression.getTypeParameters());
+        list(expression.getParameters());
+        list(expression.getCaptures());
+        optional(expression.getReturnType());
+        encode(expression.getBody());
+        break;
+      }
+      case SyntaxKind::ArrayLiteralExpression: {
+        const auto& expression = static_cast<const ArrayLiteralExpression&>(node);
+        word(expression.isMultiLine());
+        rest(expression.getElements());
+        break;
+      }
+      case SyntaxKind::ObjectLiteralExpression: {
+        const auto& expression = static_cast<const ObjectLiteralExpression&>(node);
+        word(expression.isMultiLine());
+        rest(expression.getProperties());
+        break;
+      }
+      case SyntaxKind::PropertyAssignment: {
+        const auto& property = static_cast<const PropertyAssignment&>(node);
+        encode(property.getNameIdentifier());
+        optional(property.getInitializer());
+        optional(property.getQuestionToken());
+        break;
+      }
+      case SyntaxKind::ShorthandPropertyAssignment: {
+        const auto& property = static_cast<const ShorthandPropertyAssignment&>(node);
+        encode(property.getNameIdentifier());
+        optional(property.getObjectAssignmentInitializer());
+        optional(property.getEqualsToken());
+        break;
+      }
+      case SyntaxKind::SpreadAssignment:
+        encode(static_cast<const SpreadAssignment&>(node).getExpression());
+        break;
+      case SyntaxKind::SpreadElement:
+        encode(static_cast<const SpreadElement&>(node).getExpression());
+        break;
+      case SyntaxKind::StringLiteral:
+        setText(index, static_cast<const StringLiteral&>(node).getValue());
+        break;
+      case SyntaxKind::BooleanLiteral:
+        setBoolean(index, static_cast<const BooleanLiteral&>(node).getValue());
+        break;
+      case SyntaxKind::NullLiteral:
+      case SyntaxKind::ThisExpression:
+        break;
+      case SyntaxKind::TemplateLiteralExpression: {
+        const auto& expression = static_cast<const TemplateLiteralExpression&>(node);
+        encode(expression.getHead());
+        rest(expression.getSpans());
+        break;
+      }
+      case SyntaxKind::TemplateSpan: {
+        const auto& span = static_cast<const TemplateSpan&>(node);
+        encode(span.getExpression());
+        encode(span.getLiteral());
+        break;
+      }
+      case SyntaxKind::IntegerLiteral:
+        setInteger(index, static_cast<const IntegerLiteral&>(node).getValue());
+        break;
+      case SyntaxKind::FloatLiteral:
+        setFloat(index, static_cast<const FloatLiteral&>(node).getValue());
+        break;
+      case SyntaxKind::BigIntLiteral:
+        setText(index, static_cast<const BigIntLiteral&>(node).getText());
+        break;
+      case SyntaxKind::AsExpression:
+      case SyntaxKind::ForcedAsExpression:
+      case SyntaxKind::ConditionalAsExpression: {
+        const auto& expression = static_cast<const CastExpression&>(node);
+        encode(expression.getExpression());
+        encode(expression.getTargetType());
+        break;
+      }
+      case SyntaxKind::VoidExpression:
+        encode(static_cast<const VoidExpression&>(node).getExpression());
+        break;
+      case SyntaxKind::TypeOfExpression:
+        encode(static_cast<const TypeOfExpression&>(node).getExpression());
+        break;
+      case SyntaxKind::AwaitExpression:
+        encode(static_cast<const AwaitExpression&>(node).getExpression());
+        break;
+      case SyntaxKind::NonNullExpression:
+        encode(static_cast<const NonNullExpression&>(node).getExpression());
+        break;
+      case SyntaxKind::ExpressionWithTypeArguments: {
+        const auto& expression = static_cast<const ExpressionWithTypeArguments&>(node);
+        encode(expression.getExpression());
+        optionalList(expression.getTypeArguments());
+        break;
+      }
+      case SyntaxKind::TypeReferenceNode: {
+        const auto& type = static_cast<const TypeReferenceNode&>(node);
+        encode(type.getName());
+        optionalList(type.getTypeArguments());
+        break;
+      }
+      case SyntaxKind::ArrayTypeNode:
+        encode(static_cast<const ArrayTypeNode&>(node).getElementType());
+        break;
+      case SyntaxKind::UnionTypeNode:
+        rest(static_cast<const UnionTypeNode&>(node).getTypes());
+        break;
+      case SyntaxKind::IntersectionTypeNode:
+        rest(static_cast<const IntersectionTypeNode&>(node).getTypes());
+        break;
+      case SyntaxKind::ParenthesizedTypeNode:
+        encode(static_cast<const ParenthesizedTypeNode&>(node).getType());
+        break;
+      case SyntaxKind::BoolTypeNode:
+      case SyntaxKind::I8TypeNode:
+      case SyntaxKind::I16TypeNode:
+      case SyntaxKind::I32TypeNode:
+      case SyntaxKind::I64TypeNode:
+      case SyntaxKind::U8TypeNode:
+      case SyntaxKind::U16TypeNode:
+      case SyntaxKind::U32TypeNode:
+      case SyntaxKind::U64TypeNode:
+      case SyntaxKind::F32TypeNode:
+      case SyntaxKind::F64TypeNode:
+      case SyntaxKind::StrTypeNode:
+      case SyntaxKind::UnitTypeNode:
+      case SyntaxKind::NullTypeNode:
+        break;
+      case SyntaxKind::ObjectTypeNode:
+        rest(static_cast<const ObjectTypeNode&>(node).getMembers());
+        break;
+      case SyntaxKind::TupleTypeNode:
+        rest(static_cast<const TupleTypeNode&>(node).getElementTypes());
+        break;
+      case SyntaxKind::ReturnTypeNode: {
+        const auto& type = static_cast<const ReturnTypeNode&>(node);
+        encode(type.getType());
+        optional(type.getErrorType());
+        break;
+      }
+      case SyntaxKind::FunctionTypeNode: {
+        const auto& type = static_cast<const FunctionTypeNode&>(node);
+        optionalList(type.getTypeParameters());
+        list(type.getParameters());
+        encode(type.getReturnType());
+        break;
+      }
+      case SyntaxKind::OptionalTypeNode:
+        encode(static_cast<const OptionalTypeNode&>(node).getType());
+        break;
+      case SyntaxKind::TypeQueryNode:
+        encode(static_cast<const TypeQueryNode&>(node).getExpression());
+        break;
+      case SyntaxKind::NamedTupleElement: {
+        const auto& element = static_cast<const NamedTupleElement&>(node);
+        encode(element.getName());
+        encode(element.getType());
+        break;
+      }
+      case SyntaxKind::WildcardPattern:
+        optional(static_cast<const WildcardPattern&>(node).getTypeAnnotation());
+        break;
+      case SyntaxKind::IdentifierPattern: {
+        const auto& pattern = static_cast<const IdentifierPattern&>(node);
+        encode(pattern.getIdentifier());
+        optional(pattern.getTypeAnnotation());
+        break;
+      }
+      case SyntaxKind::TuplePattern:
+        rest(static_cast<const TuplePattern&>(node).getElements());
+        break;
+      case SyntaxKind::StructurePattern:
+        rest(static_cast<const StructurePattern&>(node).getProperties());
+        break;
+      case SyntaxKind::ArrayPattern:
+        rest(static_cast<const ArrayPattern&>(node).getElements());
+        break;
+      case SyntaxKind::IsPattern:
+        encode(static_cast<const IsPattern&>(node).getType());
+        break;
+      case SyntaxKind::PatternProperty: {
+        const auto& property = static_cast<const PatternProperty&>(node);
+        encode(property.getName());
+        optional(property.getPattern());
+        break;
+      }
+      case SyntaxKind::ExpressionPattern:
+        encode(static_cast<const ExpressionPattern&>(node).getExpression());
+        break;
+      case SyntaxKind::EnumPattern: {
+        const auto& pattern = static_cast<const EnumPattern&>(node);
+        optional(pattern.getTypeReference());
+        encode(pattern.getPropertyName());
+        encode(pattern.getTuplePattern());
+        break;
+      }
+      case SyntaxKind::HeritageClause: {
+        const auto& clause = static_cast<const HeritageClause&>(node);
+        word(static_cast<uint32_t>(clause.getToken()));
+        rest(clause.getTypes());
+        break;
+      }
+      default:
+        // Tokens are recorded under their own kind.
+        ZC_REQUIRE(dynamic_cast<const TokenNode*>(&node) != nullptr,
+                   "node kind has no compact encoding", static_cast<int>(node.getKind()));
+        break;
+    }
+  }
+
+  void word(uint32_t value) { words.add(value); }
+
+  template <typename T>
+  void optional(zc::Maybe<const T&> node) {
+    ZC_IF_SOME(n, node) {
+      word(1);
+      encode(asNode(n));
+    }
+    else { word(0); }
+  }
+
+  template <typename List>
+  void list(const List& nodes) {
+    word(static_cast<uint32_t>(nodes.size()));
+    rest(nodes);
+  }
+
+  /// A list whose absence the getter distinguishes from an empty one: size plus one, or zero.
+  template <typename List>
+  void optionalList(const zc::Maybe<List>& nodes) {
+    ZC_IF_SOME(n, nodes) {
+      word(static_cast<uint32_t>(n.size()) + 1);
+      rest(n);
+    }
+    else { word(0); }
+  }
+
+  /// A list that runs to the end of the node's children and so needs no count.
+  template <typename List>
+  void rest(const List& nodes) {
+    for (const auto& node : nodes) { encode(asNode(node)); }
+  }
+
+  void name(const Identifier& identifier) { encode(identifier); }
+
+  void name(
+      zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> declarationName) {
+    ZC_SWITCH_ONEOF(declarationName) {
+      ZC_CASE_ONEOF(maybeIdentifier, zc::Maybe<const Identifier&>) {
+        encode(ZC_REQUIRE_NONNULL(maybeIdentifier, "declaration has no name"));
+      }
+      ZC_CASE_ONEOF(maybePattern, zc::Maybe<const BindingPattern&>) {
+        encode(ZC_REQUIRE_NONNULL(maybePattern, "declaration has no name"));
+      }
+    }
+  }
+
+  void modifiers(zc::ArrayPtr<const SyntaxKind> modifiers) {
+    word(static_cast<uint32_t>(modifiers.size()));
+    for (SyntaxKind modifier : modifiers) { word(static_cast<uint32_t>(modifier)); }
+  }
+
+  uint32_t addText(zc::StringPtr text) {
+    return texts.findOrCreate(text, [&]() -> decltype(texts)::Entry {
+      const auto textIndex = static_cast<uint32_t>(tree.owned.textOffsets.size());
+      tree.owned.textOffsets.add(static_cast<uint32_t>(tree.owned.textData.size()));
+      tree.owned.textData.addAll(text.begin(), text.end() + 1);
+      return {zc::str(text), textIndex};
+    });
+  }
+
+  void setText(CompactTree::NodeIndex index, zc::StringPtr text) {
+    tree.owned.payloads[index] = addText(text);
+  }
+
+  void setInteger(CompactTree::NodeIndex index, int64_t value) {
+    tree.owned.payloads[index] = static_cast<uint32_t>(tree.owned.integers.size());
+    tree.owned.integers.add(value);
+  }
+
+  void setFloat(CompactTree::NodeIndex index, double value) {
+    tree.owned.payloads[index] = static_cast<uint32_t>(tree.owned.floats.size());
+    tree.owned.floats.add(value);
+  }
+
+  void setBoolean(CompactTree::NodeIndex index, bool value) { tree.owned.payloads[index] = value; }
+
+  /// Rebase every range on the tree's base, which defaults to the lowest start, so that images of
+  /// the same text match wherever its buffer sits in the location space.
+  void pack() {
+    if (tree.base.isInvalid()) {
+      for (const auto& range : ranges) {
+        if (range.isInvalid()) { continue; }
+        if (tree.base.isInvalid() || range.getStart() < tree.base) { tree.base = range.getStart(); }
+      }
+    }
+    tree.owned.starts.reserve(ranges.size());
+    tree.owned.lengths.reserve(ranges.size());
+    for (const auto& range : ranges) {
+      if (range.isInvalid()) {
+        tree.owned.starts.add(kNoOffset);
+        tree.owned.lengths.add(0);
+        continue;
+      }
+      ZC_REQUIRE(range.getStart() >= tree.base, "node starts before the compact tree's base");
+      const uint32_t offset = range.getStart().getOpaqueValue() - tree.base.getOpaqueValue();
+      ZC_REQUIRE(offset < kNoOffset, "source too large for a compact tree");
+      tree.owned.starts.add(offset);
+      tree.owned.lengths.add(range.getLength());
+    }
+  }
+};
+
+namespace {
+
+template <typename T>
+zc::Own<T> castNode(zc::Own<Node> node) {
+  static_assert(std::is_base_of_v<Node, T>);
+  ZC_REQUIRE(dynamic_cast<T*>(node.get()) != nullptr, "unexpected node kind in compact tree",
+             static_cast<int>(node->getKind()));
+  return node.downcast<T>();
+}
+
+// Element interfaces are not nodes, so members are converted through their concrete kind.
+
+template <>
+zc::Own<ClassElement> castNode<ClassElement>(zc::Own<Node> node) {
+  switch (node->getKind()) {
+    case SyntaxKind::MethodDeclaration:
+      return node.downcast<MethodDeclaration>();
+    case SyntaxKind::GetAccessor:
+      return node.downcast<GetAccessor>();
+    case SyntaxKind::SetAccessor:
+      return node.downcast<SetAccessor>();
+    case SyntaxKind::InitDeclaration:
+      return node.downcast<InitDeclaration>();
+    case SyntaxKind::DeinitDeclaration:
+      return node.downcast<DeinitDeclaration>();
+    case SyntaxKind::PropertyDeclaration:
+      return node.downcast<PropertyDeclaration>();
+    case SyntaxKind::SemicolonClassElement:
+      return node.downcast<SemicolonClassElement>();
+    default:
+      ZC_FAIL_REQUIRE("expected a class element in compact tree",
+                      static_cast<int>(node->getKind()));
+  }
+}
+
+template <>
+zc::Own<InterfaceElement> castNode<InterfaceElement>(zc::Own<Node> node) {
+  switch (node->getKind()) {
+    case SyntaxKind::PropertySignature:
+      return node.downcast<PropertySignature>();
+    case SyntaxKind::MethodSignature:
+      return node.downcast<MethodSignature>();
+    case SyntaxKind::SemicolonInterfaceElement:
+      return node.downcast<SemicolonInterfaceElement>();
+    default:
+      ZC_FAIL_REQUIRE("expected an interface element in compact tree",
+                      static_cast<int>(node->getKind()));
+  }
+}
+
+template <>
+zc::Own<ObjectLiteralElement> castNode<ObjectLiteralElement>(zc::Own<Node> node) {
+  switch (node->getKind()) {
+    case SyntaxKind::PropertyAssignment:
+      return node.downcast<PropertyAssignment>();
+    case SyntaxKind::ShorthandPropertyAssignment:
+      return node.downcast<ShorthandPropertyAssignment>();
+    case SyntaxKind::SpreadAssignment:
+      return node.downcast<SpreadAssignment>();
+    default:
+      ZC_FAIL_REQUIRE("expected an object literal element in compact tree",
+                      static_cast<int>(node->getKind()));
+  }
+}
+
+bool isElementKind(SyntaxKind kind) {
+  switch (kind) {
+#define AST_ELEMENT_NODE(Class, ...) case SyntaxKind::Class:
+#include "zomlang/compiler/ast/ast-nodes.def"
+#undef AST_ELEMENT_NODE
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+/// Rebuilds object-model nodes from a CompactTree through the factory, reading each node's
+/// children and extra words in the order CompactTreeBuilder wrote them. Inconsistent columns
+/// throw, so a damaged image fails to decode rather than producing a different tree. Must run
+/// under an ArenaScope for `arena`, which also holds the identifier names.
+class CompactTreeDecoder final {
+public:
+  CompactTreeDecoder(const CompactTree::Impl& tree, zc::Arena& arena,
+                     zc::Maybe<zc::StringPtr> fileName = zc::none)
+      : tree(tree), arena(arena), fileName(fileName) {}
+
+  ZC_DISALLOW_COPY_AND_MOVE(CompactTreeDecoder);
+
+  zc::Own<Node> decode(CompactTree::NodeIndex index) {
+    Fields fields(*this, index);
+    zc::Own<Node> node = decodeFields(index, fields);
+    fields.finish();
+    const uint32_t start = tree.starts[index];
+    if (start != kNoOffset) {
+      const source::SourceLoc begin = tree.base + start;
+      node->setSourceRange(source::SourceRange(begin, begin + tree.lengths[index]));
+    }
+    node->setFlags(tree.flagsOf(index));
+    return node;
+  }
+
+private:
+  const CompactTree::Impl& tree;
+  zc::Arena& arena;
+  /// Replaces the name the SourceFile was encoded with.
+  zc::Maybe<zc::StringPtr> fileName;
+
+  /// Reads the children and extra words of one node in order.
+  class Fields {
+  public:
+    Fields(CompactTreeDecoder& decoder, CompactTree::NodeIndex index)
+        : decoder(decoder), nextChild(index + 1), end(decoder.tree.subtreeEnds[index]) {
+      const uint32_t payload = decoder.tree.payloads[index];
+      if (payload != kNoPayload && carriesExtras(index)) {
+        words = decoder.tree.extras.slice(payload + 1, payload + 1 + decoder.tree.extras[payload]);
+      }
+    }
+
+    uint32_t word() { return nextWord < words.size() ? words[nextWord++] : 0; }
+    bool flag() { return word() != 0; }
+
+    SyntaxKind kind() {
+      const uint32_t value = word();
+      ZC_REQUIRE(value < static_cast<uint32_t>(SyntaxKind::Count), "invalid kind in compact tree");
+      return static_cast<SyntaxKind>(value);
+    }
+
+    zc::Vector<SyntaxKind> modifiers() {
+      const uint32_t count = word();
+      ZC_REQUIRE(count <= words.size() - nextWord, "modifier count out of range in compact tree");
+      zc::Vector<SyntaxKind> result(count);
+      for (uint32_t i = 0; i < count; ++i) { result.add(kind()); }
+      return result;
+    }
+
+    template <typename T>
+    zc::Own<T> child() {
+      ZC_REQUIRE(nextChild < end, "compact tree node is missing a child");
+      const CompactTree::NodeIndex index = nextChild;
+      nextChild = decoder.tree.subtreeEnds[index];
+      ZC_REQUIRE(nextChild <= end, "compact tree subtree overruns its parent");
+      return castNode<T>(decoder.decode(index));
+    }
+
+    template <typename T>
+    zc::Maybe<zc::Own<T>> optional() {
+      if (!flag()) { return zc::none; }
+      return child<T>();
+    }
+
+    template <typename T>
+    zc::Vector<zc::Own<T>> list() {
+      return take<T>(word());
+    }
+
+    template <typename T>
+    zc::Maybe<zc::Vector<zc::Own<T>>> optionalList() {
+      const uint32_t count = word();
+      if (count == 0) { return zc::none; }
+      return take<T>(count - 1);
+    }
+
+    template <typename T>
+    zc::Vector<zc::Own<T>> rest() {
+      zc::Vector<zc::Own<T>> result;
+      while (nextChild < end) { result.add(child<T>()); }
+      return result;
+    }
+
+    zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> name() {
+      ZC_REQUIRE(nextChild < end, "compact tree node is missing a child");
+      if (decoder.tree.kindOf(nextChild) == SyntaxKind::Identifier) {
+        return child<Identifier>();
+      }
+      return child<BindingPattern>();
+    }
+
+    zc::StringPtr text(uint32_t textIndex) { return decoder.text(textIndex); }
+
+    void finish() { ZC_REQUIRE(nextChild == end, "compact tree node has unexpected children"); }
+
+  private:
+    CompactTreeDecoder& decoder;
+    CompactTree::NodeIndex nextChild;
+    const CompactTree::NodeIndex end;
+    zc::ArrayPtr<const uint32_t> words;
+    size_t nextWord = 0;
+
+    bool carriesExtras(CompactTree::NodeIndex index) const {
+      switch (decoder.tree.kindOf(index)) {
+        case SyntaxKind::Identifier:
+        case SyntaxKind::StringLiteral:
+        case SyntaxKind::BigIntLiteral:
+        case SyntaxKind::IntegerLiteral:
+        case SyntaxKind::FloatLiteral:
+        case SyntaxKind::BooleanLiteral:
+          return false;
+        default:
+          return true;
+      }
+    }
+
+    template <typename T>
+    zc::Vector<zc::Own<T>> take(uint32_t count) {
+      ZC_REQUIRE(count <= end - nextChild, "list count out of range in compact tree");
+      zc::Vector<zc::Own<T>> result(count);
+      for (uint32_t i = 0; i < count; ++i) { result.add(child<T>()); }
+      return result;
+    }
+  };
+
+  zc::StringPtr text(uint32_t textIndex) const {
+    ZC_REQUIRE(textIndex < tree.textOffsets.size(), "text index out of range in compact tree");
+    const size_t begin = tree.textOffsets[textIndex];
+    const size_t end = textIndex + 1 < tree.textOffsets.size() ? tree.textOffsets[textIndex + 1]
+                                                               : tree.textData.size();
+    ZC_REQUIRE(begin < end, "malformed text in compact tree");
+    return zc::StringPtr(tree.textData.begin() + begin, end - begin - 1);
+  }
+
+  zc::Own<Node> decodeFields(CompactTree::NodeIndex index, Fields& fields) {
+    using namespace factory;
+
+    const auto kind = tree.kindOf(index);
+    switch (kind) {
+      case SyntaxKind::SourceFile: {
+        zc::StringPtr name = fields.text(fields.word());
+        ZC_IF_SOME(n, fileName) { name = n; }
+        auto moduleDeclaration = fields.optional<ModuleDeclaration>();
+        auto statements = fields.rest<Statement>();
+        return createSourceFile(zc::str(name), zc::mv(moduleDeclaration), zc::mv(statements));
+      }
+      case SyntaxKind::ModulePath:
+        return createModulePath(fields.rest<Identifier>());
+      case SyntaxKind::ImportSpecifier: {
+        auto importedName = fields.child<Identifier>();
+        auto alias = fields.optional<Identifier>();
+        return createImportSpecifier(zc::mv(importedName), zc::mv(alias));
+      }
+      case SyntaxKind::ExportSpecifier: {
+        auto exportedName = fields.child<Identifier>();
+        auto alias = fields.optional<Identifier>();
+        return createExportSpecifier(zc::mv(exportedName), zc::mv(alias));
+      }
+      case SyntaxKind::Identifier:
+        return createIdentifier(arena.copyString(text(tree.payloads[index])));
+      case SyntaxKind::BindingElement: {
+        auto name = fields.name();
+        auto initializer = fields.optional<Expression>();
+        return createBindingElement(zc::none, zc::none, zc::mv(name), zc::mv(initializer));
+      }
+      case SyntaxKind::CaptureElement: {
+        const bool isByReference = fields.flag();
+        const bool isThis = fields.flag();
+        auto identifier = fields.optional<Identifier>();
+        return createCaptureElement(isByReference, zc::mv(identifier), isThis);
+      }
+      case SyntaxKind::VariableDeclaration: {
+        auto name = fields.name();
+        auto type = fields.optional<TypeNode>();
+        auto initializer = fields.optional<Expression>();
+        return createVariableDeclaration(zc::mv(name), zc::mv(type), zc::mv(initializer));
+      }
+      case SyntaxKind::VariableDeclarationList:
+        return createVariableDeclarationList(fields.rest<VariableDeclaration>());
+      case SyntaxKind::TypeParameterDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto constraint = fields.optional<TypeNode>();
+        return createTypeParameterDeclaration(zc::mv(name), zc::mv(constraint));
+      }
+      case SyntaxKind::MethodDeclaration: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto optional = optionalToken(fields.flag());
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        auto body = fields.optional<Statement>();
+        return createMethodDeclaration(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+                                       zc::mv(typeParameters), zc::mv(parameters),
+                                       zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::GetAccessor: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        auto body = fields.optional<Statement>();
+        return createGetAccessorDeclaration(zc::mv(modifiers), zc::mv(name),
+                                            zc::mv(typeParameters), zc::mv(parameters),
+                                            zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::SetAccessor: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        auto body = fields.optional<Statement>();
+        return createSetAccessorDeclaration(zc::mv(modifiers), zc::mv(name),
+                                            zc::mv(typeParameters), zc::mv(parameters),
+                                            zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::InitDeclaration: {
+        auto modifiers = fields.modifiers();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        auto body = fields.optional<Statement>();
+        return createInitDeclaration(zc::mv(modifiers), zc::mv(typeParameters),
+                                     zc::mv(parameters), zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::DeinitDeclaration: {
+        auto modifiers = fields.modifiers();
+        auto body = fields.optional<Statement>();
+        return createDeinitDeclaration(zc::mv(modifiers), zc::mv(body));
+      }
+      case SyntaxKind::ParameterDeclaration: {
+        auto modifiers = fields.modifiers();
+        auto dotDotDotToken = fields.optional<TokenNode>();
+        auto name = fields.name();
+        auto questionToken = fields.optional<TokenNode>();
+        auto type = fields.optional<TypeNode>();
+        auto initializer = fields.optional<Expression>();
+        return createParameterDeclaration(zc::mv(modifiers), zc::mv(dotDotDotToken), zc::mv(name),
+                                          zc::mv(questionToken), zc::mv(type),
+                                          zc::mv(initializer));
+      }
+      case SyntaxKind::PropertyDeclaration: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto type = fields.optional<TypeNode>();
+        auto initializer = fields.optional<Expression>();
+        return createPropertyDeclaration(zc::mv(modifiers), zc::mv(name), zc::mv(type),
+                                         zc::mv(initializer));
+      }
+      case SyntaxKind::SemicolonClassElement:
+        return createSemicolonClassElement();
+      case SyntaxKind::SemicolonInterfaceElement:
+        return createSemicolonInterfaceElement();
+      case SyntaxKind::PropertySignature: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto optional = optionalToken(fields.flag());
+        auto type = fields.optional<TypeNode>();
+        auto initializer = fields.optional<Expression>();
+        return createPropertySignature(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+                                       zc::mv(type), zc::mv(initializer));
+      }
+      case SyntaxKind::MethodSignature: {
+        auto modifiers = fields.modifiers();
+        auto name = fields.child<Identifier>();
+        auto optional = optionalToken(fields.flag());
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        return createMethodSignature(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+                                     zc::mv(typeParameters), zc::mv(parameters),
+                                     zc::mv(returnType));
+      }
+      case SyntaxKind::ModuleDeclaration:
+        return createModuleDeclaration(fields.child<ModulePath>());
+      case SyntaxKind::ImportDeclaration: {
+        auto modulePath = fields.child<ModulePath>();
+        auto alias = fields.optional<Identifier>();
+        auto specifiers = fields.rest<ImportSpecifier>();
+        return createImportDeclaration(zc::mv(modulePath), zc::mv(alias), zc::mv(specifiers));
+      }
+      case SyntaxKind::ExportDeclaration: {
+        auto modulePath = fields.optional<ModulePath>();
+        auto specifiers = fields.list<ExportSpecifier>();
+        auto declaration = fields.optional<Statement>();
+        return createExportDeclaration(zc::mv(modulePath), zc::mv(specifiers),
+                                       zc::mv(declaration));
+      }
+      case SyntaxKind::FunctionDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.optional<ReturnTypeNode>();
+        auto body = fields.child<Statement>();
+        return createFunctionDeclaration(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
+                                         zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::ClassDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto heritageClauses = fields.list<HeritageClause>();
+        auto members = fields.rest<ClassElement>();
+        return createClassDeclaration(zc::mv(name), zc::mv(typeParameters),
+                                      zc::mv(heritageClauses), zc::mv(members));
+      }
+      case SyntaxKind::InterfaceDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto heritageClauses = fields.list<HeritageClause>();
+        auto members = fields.rest<InterfaceElement>();
+        return createInterfaceDeclaration(zc::mv(name), zc::mv(typeParameters),
+                                          zc::mv(heritageClauses), zc::mv(members));
+      }
+      case SyntaxKind::StructDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto heritageClauses = fields.list<HeritageClause>();
+        auto members = fields.rest<ClassElement>();
+        return createStructDeclaration(zc::mv(name), zc::mv(typeParameters),
+                                       zc::mv(heritageClauses), zc::mv(members));
+      }
+      case SyntaxKind::EnumDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto members = fields.rest<EnumMember>();
+        return createEnumDeclaration(zc::mv(name), zc::mv(members));
+      }
+      case SyntaxKind::EnumMember: {
+        auto name = fields.child<Identifier>();
+        auto initializer = fields.optional<Expression>();
+        auto tupleType = fields.optional<TupleTypeNode>();
+        return createEnumMember(zc::mv(name), zc::mv(initializer), zc::mv(tupleType));
+      }
+      case SyntaxKind::ErrorDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto members = fields.rest<Statement>();
+        return createErrorDeclaration(zc::mv(name), zc::mv(members));
+      }
+      case SyntaxKind::AliasDeclaration: {
+        auto name = fields.child<Identifier>();
+        auto typeParameters = fields.list<TypeParameterDeclaration>();
+        auto type = fields.child<TypeNode>();
+        return createAliasDeclaration(zc::mv(name), zc::mv(typeParameters), zc::mv(type));
+      }
+      case SyntaxKind::VariableStatement:
+        return createVariableStatement(fields.child<VariableDeclarationList>());
+      case SyntaxKind::BlockStatement:
+        return createBlockStatement(fields.rest<Statement>());
+      case SyntaxKind::EmptyStatement:
+        return createEmptyStatement();
+      case SyntaxKind::DebuggerStatement:
+        return createDebuggerStatement();
+      case SyntaxKind::ExpressionStatement:
+        return createExpressionStatement(fields.child<Expression>());
+      case SyntaxKind::IfStatement: {
+        auto condition = fields.child<Expression>();
+        auto thenStatement = fields.child<Statement>();
+        auto elseStatement = fields.optional<Statement>();
+        return createIfStatement(zc::mv(condition), zc::mv(thenStatement),
+                                 zc::mv(elseStatement));
+      }
+      case SyntaxKind::WhileStatement: {
+        auto condition = fields.child<Expression>();
+        auto body = fields.child<Statement>();
+        return createWhileStatement(zc::mv(condition), zc::mv(body));
+      }
+      case SyntaxKind::ForStatement: {
+        auto initializer = fields.optional<Statement>();
+        auto condition = fields.optional<Expression>();
+        auto update = fields.optional<Expression>();
+        auto body = fields.child<Statement>();
+        return createForStatement(zc::mv(initializer), zc::mv(condition), zc::mv(update),
+                                  zc::mv(body));
+      }
+      case SyntaxKind::ForInStatement: {
+        auto initializer = fields.child<Statement>();
+        auto expression = fields.child<Expression>();
+        auto body = fields.child<Statement>();
+        return createForInStatement(zc::mv(initializer), zc::mv(expression), zc::mv(body));
+      }
+      case SyntaxKind::LabeledStatement: {
+        auto label = fields.child<Identifier>();
+        auto statement = fields.child<Statement>();
+        return createLabeledStatement(zc::mv(label), zc::mv(statement));
+      }
+      case SyntaxKind::BreakStatement:
+        return createBreakStatement(fields.optional<Identifier>());
+      case SyntaxKind::ContinueStatement:
+        return createContinueStatement(fields.optional<Identifier>());
+      case SyntaxKind::ReturnStatement:
+        return createReturnStatement(fields.optional<Expression>());
+      case SyntaxKind::MatchStatement: {
+        auto discriminant = fields.child<Expression>();
+        auto clauses = fields.rest<Statement>();
+        return createMatchStatement(zc::mv(discriminant), zc::mv(clauses));
+      }
+      case SyntaxKind::MatchClause: {
+        auto pattern = fields.child<Pattern>();
+        auto guard = fields.optional<Expression>();
+        auto body = fields.child<Statement>();
+        return createMatchClause(zc::mv(pattern), zc::mv(guard), zc::mv(body));
+      }
+      case SyntaxKind::DefaultClause:
+        return createDefaultClause(fields.rest<Statement>());
+      case SyntaxKind::ArrayBindingPattern:
+        return createArrayBindingPattern(fields.rest<BindingElement>());
+      case SyntaxKind::ObjectBindingPattern:
+        return createObjectBindingPattern(fields.rest<BindingElement>());
+      case SyntaxKind::PrefixUnaryExpression: {
+        const SyntaxKind op = fields.kind();
+        return createPrefixUnaryExpression(op, fields.child<Expression>());
+      }
+      case SyntaxKind::PostfixUnaryExpression: {
+        const SyntaxKind op = fields.kind();
+        return createPostfixUnaryExpression(op, fields.child<Expression>());
+      }
+      case SyntaxKind::PropertyAccessExpression: {
+        auto expression = fields.child<LeftHandSideExpression>();
+        auto name = fields.child<Identifier>();
+        return createPropertyAccessExpression(zc::mv(expression), zc::mv(name), fields.flag());
+      }
+      case SyntaxKind::ElementAccessExpression: {
+        auto expression = fields.child<LeftHandSideExpression>();
+        auto elementIndex = fields.child<Expression>();
+        return createElementAccessExpression(zc::mv(expression), zc::mv(elementIndex),
+                                             fields.flag());
+      }
+      case SyntaxKind::NewExpression: {
+        auto callee = fields.child<Expression>();
+        auto arguments = fields.optionalList<Expression>();
+        return createNewExpression(zc::mv(callee), zc::none, zc::mv(arguments));
+      }
+      case SyntaxKind::ParenthesizedExpression:
+        return createParenthesizedExpression(fields.child<Expression>());
+      case SyntaxKind::BinaryExpression: {
+        auto left = fields.child<Expression>();
+        auto op = fields.child<TokenNode>();
+        auto right = fields.child<Expression>();
+        return createBinaryExpression(zc::mv(left), zc::mv(op), zc::mv(right));
+      }
+      case SyntaxKind::ConditionalExpression: {
+        auto test = fields.child<Expression>();
+        auto consequent = fields.child<Expression>();
+        auto alternate = fields.child<Expression>();
+        return createConditionalExpression(zc::mv(test), zc::none, zc::mv(consequent), zc::none,
+                                           zc::mv(alternate));
+      }
+      case SyntaxKind::CallExpression: {
+        auto callee = fields.child<Expression>();
+        auto arguments = fields.rest<Expression>();
+        return createCallExpression(zc::mv(callee), zc::none, zc::none, zc::mv(arguments));
+      }
+      case SyntaxKind::FunctionExpression: {
+        auto typeParameters = fields.optionalList<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto captures = fields.list<CaptureElement>();
+        auto returnType = fields.optional<TypeNode>();
+        auto body = fields.child<Statement>();
+        return createFunctionExpression(zc::mv(typeParameters), zc::mv(parameters),
+                                        zc::mv(captures), zc::mv(returnType), zc::mv(body));
+      }
+      case SyntaxKind::ArrayLiteralExpression: {
+        const bool multiLine = fields.flag();
+        return createArrayLiteralExpression(fields.rest<Expression>(), multiLine);
+      }
+      case SyntaxKind::ObjectLiteralExpression: {
+        const bool multiLine = fields.flag();
+        return createObjectLiteralExpression(fields.rest<ObjectLiteralElement>(), multiLine);
+      }
+      case SyntaxKind::PropertyAssignment: {
+        auto name = fields.child<Identifier>();
+        auto initializer = fields.optional<Expression>();
+        auto questionToken = fields.optional<TokenNode>();
+        return createPropertyAssignment(zc::mv(name), zc::mv(initializer), zc::mv(questionToken));
+      }
+      case SyntaxKind::ShorthandPropertyAssignment: {
+        auto name = fields.child<Identifier>();
+        auto initializer = fields.optional<Expression>();
+        auto equalsToken = fields.optional<TokenNode>();
+        return createShorthandPropertyAssignment(zc::mv(name), zc::mv(initializer),
+                                                 zc::mv(equalsToken));
+      }
+      case SyntaxKind::SpreadAssignment:
+        return createSpreadAssignment(fields.child<Expression>());
+      case SyntaxKind::SpreadElement:
+        return createSpreadElement(fields.child<Expression>());
+      case SyntaxKind::StringLiteral:
+        return createStringLiteral(text(tree.payloads[index]));
+      case SyntaxKind::BooleanLiteral:
+        return createBooleanLiteral(tree.payloads[index] != 0);
+      case SyntaxKind::NullLiteral:
+        return createNullLiteral();
+      case SyntaxKind::TemplateLiteralExpression: {
+        auto head = fields.child<StringLiteral>();
+        auto spans = fields.rest<TemplateSpan>();
+        return createTemplateLiteralExpression(zc::mv(head), zc::mv(spans));
+      }
+      case SyntaxKind::TemplateSpan: {
+        auto expression = fields.child<Expression>();
+        auto literal = fields.child<StringLiteral>();
+        return createTemplateSpan(zc::mv(expression), zc::mv(literal));
+      }
+      case SyntaxKind::IntegerLiteral:
+        ZC_REQUIRE(tree.payloads[index] < tree.integers.size(), "integer out of range");
+        return createIntegerLiteral(tree.integers[tree.payloads[index]]);
+      case SyntaxKind::FloatLiteral:
+        ZC_REQUIRE(tree.payloads[index] < tree.floats.size(), "float out of range");
+        return createFloatLiteral(tree.floats[tree.payloads[index]]);
+      case SyntaxKind::BigIntLiteral:
+        return allocate<BigIntLiteral>(text(tree.payloads[index]));
+      case SyntaxKind::AsExpression: {
+        auto expression = fields.child<Expression>();
+        auto targetType = fields.child<TypeNode>();
+        return createAsExpression(zc::mv(expression), zc::mv(targetType));
+      }
+      case SyntaxKind::ForcedAsExpression: {
+        auto expression = fields.child<Expression>();
+        auto targetType = fields.child<TypeNode>();
+        return createForcedAsExpression(zc::mv(expression), zc::mv(targetType));
+      }
+      case SyntaxKind::ConditionalAsExpression: {
+        auto expression = fields.child<Expression>();
+        auto targetType = fields.child<TypeNode>();
+        return createConditionalAsExpression(zc::mv(expression), zc::mv(targetType));
+      }
+      case SyntaxKind::VoidExpression:
+        return createVoidExpression(fields.child<Expression>());
+      case SyntaxKind::TypeOfExpression:
+        return createTypeOfExpression(fields.child<Expression>());
+      case SyntaxKind::AwaitExpression:
+        return createAwaitExpression(fields.child<Expression>());
+      case SyntaxKind::ThisExpression:
+        return createThisExpression();
+      case SyntaxKind::NonNullExpression:
+        return createNonNullExpression(fields.child<Expression>());
+      case SyntaxKind::ExpressionWithTypeArguments: {
+        auto expression = fields.child<LeftHandSideExpression>();
+        auto typeArguments = fields.optionalList<TypeNode>();
+        return createExpressionWithTypeArguments(zc::mv(expression), zc::mv(typeArguments));
+      }
+      case SyntaxKind::TypeReferenceNode: {
+        auto typeName = fields.child<Identifier>();
+        auto typeArguments = fields.optionalList<TypeNode>();
+        return createTypeReference(zc::mv(typeName), zc::mv(typeArguments));
+      }
+      case SyntaxKind::ArrayTypeNode:
+        return createArrayType(fields.child<TypeNode>());
+      case SyntaxKind::UnionTypeNode:
+        return createUnionType(fields.rest<TypeNode>());
+      case SyntaxKind::IntersectionTypeNode:
+        return createIntersectionType(fields.rest<TypeNode>());
+      case SyntaxKind::ParenthesizedTypeNode:
+        return createParenthesizedType(fields.child<TypeNode>());
+      case SyntaxKind::BoolTypeNode:
+        return allocate<BoolTypeNode>();
+      case SyntaxKind::I8TypeNode:
+        return allocate<I8TypeNode>();
+      case SyntaxKind::I16TypeNode:
+        return allocate<I16TypeNode>();
+      case SyntaxKind::I32TypeNode:
+        return allocate<I32TypeNode>();
+      case SyntaxKind::I64TypeNode:
+        return allocate<I64TypeNode>();
+      case SyntaxKind::U8TypeNode:
+        return allocate<U8TypeNode>();
+      case SyntaxKind::U16TypeNode:
+        return allocate<U16TypeNode>();
+      case SyntaxKind::U32TypeNode:
+        return allocate<U32TypeNode>();
+      case SyntaxKind::U64TypeNode:
+        return allocate<U64TypeNode>();
+      case SyntaxKind::F32TypeNode:
+        return allocate<F32TypeNode>();
+      case SyntaxKind::F64TypeNode:
+        return allocate<F64TypeNode>();
+      case SyntaxKind::StrTypeNode:
+        return allocate<StrTypeNode>();
+      case SyntaxKind::UnitTypeNode:
+        return allocate<UnitTypeNode>();
+      case SyntaxKind::NullTypeNode:
+        return allocate<NullTypeNode>();
+      case SyntaxKind::ObjectTypeNode:
+        return createObjectType(fields.rest<Node>());
+      case SyntaxKind::TupleTypeNode:
+        return createTupleType(fields.rest<TypeNode>());
+      case SyntaxKind::ReturnTypeNode: {
+        auto type = fields.child<TypeNode>();
+        auto errorType = fields.optional<TypeNode>();
+        return createReturnType(zc::mv(type), zc::mv(errorType));
+      }
+      case SyntaxKind::FunctionTypeNode: {
+        auto typeParameters = fields.optionalList<TypeParameterDeclaration>();
+        auto parameters = fields.list<ParameterDeclaration>();
+        auto returnType = fields.child<ReturnTypeNode>();
+        return createFunctionType(zc::mv(typeParameters), zc::mv(parameters),
+                                  zc::mv(returnType));
+      }
+      case SyntaxKind::OptionalTypeNode:
+        return createOptionalType(fields.child<TypeNode>());
+      case SyntaxKind::TypeQueryNode:
+        return createTypeQuery(fields.child<Expression>());
+      case SyntaxKind::NamedTupleElement: {
+        auto name = fields.child<Identifier>();
+        auto type = fields.child<TypeNode>();
+        return createNamedTupleElement(zc::mv(name), zc::mv(type));
+      }
+      case SyntaxKind::WildcardPattern:
+        return createWildcardPattern(fields.optional<TypeNode>());
+      case SyntaxKind::IdentifierPattern: {
+        auto identifier = fields.child<Identifier>();
+        auto typeAnnotation = fields.optional<TypeNode>();
+        return createIdentifierPattern(zc::mv(identifier), zc::mv(typeAnnotation));
+      }
+      case SyntaxKind::TuplePattern:
+        return createTuplePattern(fields.rest<Pattern>());
+      case SyntaxKind::StructurePattern:
+        return createStructurePattern(fields.rest<Pattern>());
+      case SyntaxKind::ArrayPattern:
+        return createArrayPattern(fields.rest<Pattern>());
+      case SyntaxKind::IsPattern:
+        return createIsPattern(fields.child<TypeNode>());
+      case SyntaxKind::PatternProperty: {
+        auto name = fields.child<Identifier>();
+        auto pattern = fields.optional<Pattern>();
+        return createPatternProperty(zc::mv(name), zc::mv(pattern));
+      }
+      case SyntaxKind::ExpressionPattern:
+        return createExpressionPattern(fields.child<Expression>());
+      case SyntaxKind::EnumPattern: {
+        auto typeReference = fields.optional<TypeReferenceNode>();
+        auto propertyName = fields.child<Identifier>();
+        auto tuplePattern = fields.child<TuplePattern>();
+        return createEnumPattern(zc::mv(typeReference), zc::mv(propertyName),
+                                 zc::mv(tuplePattern));
+      }
+      case SyntaxKind::HeritageClause: {
+        const SyntaxKind token = fields.kind();
+        return createHeritageClause(token, fields.rest<ExpressionWithTypeArguments>());
+      }
+      default:
+        ZC_REQUIRE(!isElementKind(kind), "node kind has no compact encoding",
+                   static_cast<int>(kind));
+        return createTokenNode(kind);
+    }
+  }
+
+  static zc::Maybe<zc::Own<TokenNode>> optionalToken(bool present) {
+    if (!present) { return zc::none; }
+    return factory::createTokenNode(SyntaxKind::Question);
+  }
+};
+
+CompactTree::CompactTree(const Node& root, source::SourceLoc base) : impl(zc::heap<Impl>()) {
+  impl->base = base;
+  CompactTreeBuilder(*impl).build(root);
+}
+
+CompactTree::CompactTree(zc::Own<Impl> impl) noexcept : impl(zc::mv(impl)) {}
+
+CompactTree::~CompactTree() noexcept(false) = default;
+
+CompactTree::CompactTree(CompactTree&&) noexcept = default;
+CompactTree& CompactTree::operator=(CompactTree&&) noexcept = default;
+
+zc::Array<zc::byte> CompactTree::serialize() const {
+  ImageHeader header;
+  memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+  header.version = kFormatVersion;
+  header.byteOrder = kByteOrderMark;
+  header.nodeCount = static_cast<uint32_t>(impl->tags.size());
+  header.textCount = static_cast<uint32_t>(impl->textOffsets.size());
+  header.textBytes = static_cast<uint32_t>(impl->textData.size());
+  header.integerCount = static_cast<uint32_t>(impl->integers.size());
+  header.floatCount = static_cast<uint32_t>(impl->floats.size());
+  header.extraCount = static_cast<uint32_t>(impl->extras.size());
+  header.reserved = 0;
+
+  zc::Vector<zc::byte> out(sizeof(ImageHeader) + getMemoryUsage() + 10 * kImageAlignment);
+  out.addAll(zc::arrayPtr(&header, 1).asBytes());
+  appendColumn(out, impl->integers);
+  appendColumn(out, impl->floats);
+  appendColumn(out, impl->starts);
+  appendColumn(out, impl->lengths);
+  appendColumn(out, impl->subtreeEnds);
+  appendColumn(out, impl->payloads);
+  appendColumn(out, impl->extras);
+  appendColumn(out, impl->textOffsets);
+  appendColumn(out, impl->tags);
+  appendColumn(out, impl->textData);
+  return out.releaseAsArray();
+}
+
+zc::Maybe<CompactTree> CompactTree::deserialize(zc::ArrayPtr<const zc::byte> image,
+                                                source::SourceLoc base) {
+  auto impl = zc::heap<Impl>();
+  if (!impl->viewImage(image)) { return zc::none; }
+  impl->base = base;
+  return CompactTree(zc::mv(impl));
+}
+
+zc::Maybe<CompactTree> CompactTree::deserialize(zc::Array<const zc::byte> image,
+                                                source::SourceLoc base) {
+  auto impl = zc::heap<Impl>();
+  if (!impl->viewImage(image)) { return zc::none; }
+  impl->image = zc::mv(image);
+  impl->base = base;
+  return CompactTree(zc::mv(impl));
+}
+
+source::SourceLoc CompactTree::getBase() const { return impl->base; }
+
+size_t CompactTree::size() const { return impl->tags.size(); }
+
+SyntaxKind CompactTree::getKind(NodeIndex index) const {
+  return impl->kindOf(index);
+}
+
+NodeFlags CompactTree::getFlags(NodeIndex index) const {
+  return impl->flagsOf(index);
+}
+
+source::SourceRange CompactTree::getSourceRange(NodeIndex index) const {
+  const uint32_t start = impl->starts[index];
+  if (start == kNoOffset) { return source::SourceRange(); }
+  const source::SourceLoc begin = impl->base + start;
+  return source::SourceRange(begin, begin + impl->lengths[index]);
+}
+
+CompactTree::NodeIndex CompactTree::getSubtreeEnd(NodeIndex index) const {
+  return impl->subtreeEnds[index];
+}
+
+size_t CompactTree::getChildCount(NodeIndex index) const {
+  size_t count = 0;
+  const NodeIndex end = impl->subtreeEnds[index];
+  for (NodeIndex child = index + 1; child < end; child = impl->subtreeEnds[child]) { ++count; }
+  return count;
+}
+
+zc::Maybe<zc::StringPtr> CompactTree::getText(NodeIndex index) const {
+  const SyntaxKind kind = getKind(index);
+  if (kind != SyntaxKind::Identifier && kind != SyntaxKind::StringLiteral &&
+      kind != SyntaxKind::BigIntLiteral) {
+    return zc::none;
+  }
+  // Each text is followed by its NUL terminator, so the next text starts one byte past its end.
+  const uint32_t payload = impl->payloads[index];
+  const size_t begin = impl->textOffsets[payload];
+  const size_t end = payload + 1 < impl->textOffsets.size() ? impl->textOffsets[payload + 1]
+                                                            : impl->textData.size();
+  return zc::StringPtr(impl->textData.begin() + begin, end - begin - 1);
+}
+
+zc::Maybe<int64_t> CompactTree::getInteger(NodeIndex index) const {
+  const uint32_t payload = impl->payloadOf(index, SyntaxKind::IntegerLiteral);
+  if (payload == kNoPayload) { return zc::none; }
+  return impl->integers[payload];
+}
+
+zc::Maybe<double> CompactTree::getFloat(NodeIndex index) const {
+  const uint32_t payload = impl->payloadOf(index, SyntaxKind::FloatLiteral);
+  if (payload == kNoPayload) { return zc::none; }
+  return impl->floats[payload];
+}
+
+zc::Maybe<bool> CompactTree::getBoolean(NodeIndex index) const {
+  const uint32_t payload = impl->payloadOf(index, SyntaxKind::BooleanLiteral);
+  if (payload == kNoPayload) { return zc::none; }
+  return payload != 0;
+}
+
+zc::Maybe<zc::Own<SourceFile>> CompactTree::decodeSourceFile(
+    zc::Maybe<zc::StringPtr> fileName) const {
+  if (size() == 0 || getKind(0) != SyntaxKind::SourceFile) { return zc::none; }
+  auto arena = zc::heap<zc::Arena>();
+  zc::Maybe<zc::Own<Node>> root;
+  auto maybeException = zc::runCatchingExceptions([&]() {
+    ArenaScope scope(*arena);
+    root = CompactTreeDecoder(*impl, *arena, fileName).decode(0);
+  });
+  if (maybeException != zc::none) { return zc::none; }
+  auto sourceFile = ZC_ASSERT_NONNULL(zc::mv(root)).downcast<SourceFile>();
+  sourceFile->adoptArena(zc::mv(arena));
+  return zc::mv(sourceFile);
+}
+
+void CompactTree::accept(Visitor& visitor) const {
+  ZC_REQUIRE(size() > 0, "empty compact tree");
+  zc::Arena arena;
+  zc::Own<Node> root = [&]() {
+    ArenaScope scope(arena);
+    return CompactTreeDecoder(*impl, arena).decode(0);
+  }();
+  root->accept(visitor);
+}
+
+size_t CompactTree::getMemoryUsage() const {
+  return impl->integers.asBytes().size() + impl->floats.asBytes().size() +
+         impl->starts.asBytes().size() + impl->lengths.asBytes().size() +
+         impl->subtreeEnds.asBytes().size() + impl->payloads.asBytes().size() +
+         impl->extras.asBytes().size() + impl->textOffsets.asBytes().size() +
+         impl->tags.asBytes().size() + impl->textData.size();
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,133 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/array.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/source/location.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+class SourceFile;
+class Visitor;
+
+/// \brief Compact, index-based encoding of a syntax tree.
+///
+/// Nodes are numbered in preorder and described by parallel column arrays: kind and flags packed
+/// into one tag, source offsets relative to a base location, and the index one past the last node
+/// of each subtree. The children of a node are therefore the index range that directly follows it,
+/// and a full traversal is a linear scan over the columns. Literal payloads live in per-kind
+/// columns referenced from the node's payload slot; text is copied into the tree, so it does not
+/// depend on the object model it was encoded from. What else a node's getters expose, such as
+/// operators, modifiers and which optional children are present, is kept in a column of extra
+/// words, so `decodeSourceFile()` and `accept()` can rebuild the object model.
+///
+/// `serialize()` writes the columns into a versioned image that `deserialize()` can view in place,
+/// so a memory-mapped file is traversed without being copied or decoded.
+///
+/// Direct children of `index` are visited with:
+/// \code
+/// for (auto child = index + 1; child < tree.getSubtreeEnd(index);
+///      child = tree.getSubtreeEnd(child)) { ... }
+/// \endcode
+class CompactTree {
+public:
+  using NodeIndex = uint32_t;
+
+  /// \brief Version of the serialized image, bumped whenever its layout changes.
+  static constexpr uint32_t kFormatVersion = 2;
+
+  /// \brief Encode the tree rooted at `root`, which becomes node 0.
+  /// \param base Location source offsets are stored relative to, normally the start of the source
+  /// buffer. Defaults to the lowest start in the tree.
+  explicit CompactTree(const Node& root, source::SourceLoc base = source::SourceLoc());
+  ~CompactTree() noexcept(false);
+
+  ZC_DISALLOW_COPY(CompactTree);
+  CompactTree(CompactTree&&) noexcept;
+  CompactTree& operator=(CompactTree&&) noexcept;
+
+  /// \brief Number of encoded nodes.
+  size_t size() const;
+
+  SyntaxKind getKind(NodeIndex index) const;
+  NodeFlags getFlags(NodeIndex index) const;
+  source::SourceRange getSourceRange(NodeIndex index) const;
+
+  /// \brief Index one past the last node in the subtree rooted at `index`.
+  NodeIndex getSubtreeEnd(NodeIndex index) const;
+  /// \brief Number of direct children of `index`.
+  size_t getChildCount(NodeIndex index) const;
+
+  /// \brief Name of an Identifier, value of a StringLiteral or text of a BigIntLiteral.
+  zc::Maybe<zc::StringPtr> getText(NodeIndex index) const;
+  /// \brief Value of an IntegerLiteral.
+  zc::Maybe<int64_t> getInteger(NodeIndex index) const;
+  /// \brief Value of a FloatLiteral.
+  zc::Maybe<double> getFloat(NodeIndex index) const;
+  /// \brief Value of a BooleanLiteral.
+  zc::Maybe<bool> getBoolean(NodeIndex index) const;
+
+  /// \brief Location that source offsets are relative to.
+  source::SourceLoc getBase() const;
+
+  /// \brief Bytes used by the columns, for comparison with the object model.
+  size_t getMemoryUsage() const;
+
+  /// \brief Rebuild the object model of a tree whose root is a SourceFile. The nodes live in an
+  /// arena the returned file adopts, so it does not depend on this tree. Returns none if the root
+  /// is not a SourceFile or the columns are inconsistent.
+  /// \param fileName Name the file gets instead of the encoded one, e.g. when the image was
+  /// cached for a file of the same content under another path.
+  zc::Maybe<zc::Own<SourceFile>> decodeSourceFile(
+      zc::Maybe<zc::StringPtr> fileName = zc::none) const;
+
+  /// \brief Run `visitor` over the tree as over the object model it was encoded from. The nodes
+  /// are rebuilt for the duration of the call. Throws if the columns are inconsistent.
+  void accept(Visitor& visitor) const;
+
+  /// \brief Write the tree as a self-contained binary image.
+  zc::Array<zc::byte> serialize() const;
+
+  /// \brief View a serialized image in place. The image must be 8-byte aligned and outlive the
+  /// tree. Returns none if the image is malformed or from another format version.
+  /// \param base Location to rebase source offsets on; it must match the base the image was written
+  /// with for source ranges to be meaningful.
+  static zc::Maybe<CompactTree> deserialize(zc::ArrayPtr<const zc::byte> image,
+                                            source::SourceLoc base);
+  /// \brief Like the overload above, but the tree takes ownership of the image, e.g. a mapping
+  /// returned by `zc::ReadableFile::mmap()`.
+  static zc::Maybe<CompactTree> deserialize(zc::Array<const zc::byte> image,
+                                            source::SourceLoc base);
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+
+  explicit CompactTree(zc::Own<Impl> impl) noexcept;
+
+  friend class CompactTreeBuilder;
+  friend class CompactTreeDecoder;
+};
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
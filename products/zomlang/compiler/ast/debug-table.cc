@@ -0,0 +1,168 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/compiler/ast/debug-table.h"
+
+#include "zc/core/mutex.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/walker.h"
+
+using zomlang::compiler::ast::DebugNodeRecord;
+using zomlang::compiler::ast::DebugNodeTable;
+using zomlang::compiler::ast::DebugTreeRecord;
+
+/// Found by the debugger formatters by name, so it is neither mangled nor static.
+extern "C" DebugNodeTable zomlang_debug_node_table;
+DebugNodeTable zomlang_debug_node_table = {DebugNodeTable::kMagic,
+                                           DebugNodeTable::kVersion,
+                                           sizeof(DebugNodeRecord),
+                                           sizeof(DebugTreeRecord),
+                                           0,
+                                           nullptr,
+                                           0,
+                                           nullptr,
+                                           0};
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+struct ListedTree {
+  const Node* root;
+  zc::String fileName;
+  zc::Array<DebugNodeRecord> nodes;
+};
+
+struct ListedTrees {
+  zc::Vector<zc::Own<ListedTree>> trees;
+  /// What `zomlang_debug_node_table.trees` points at, one record per entry of `trees`
+  zc::Vector<DebugTreeRecord> records;
+
+  /// Point the table at the records after they changed
+  void publish() {
+    records.clear();
+    for (const zc::Own<ListedTree>& tree : trees) {
+      records.add(DebugTreeRecord{tree->root, tree->fileName.cStr(), tree->nodes.begin(),
+                                  tree->nodes.size()});
+    }
+    zomlang_debug_node_table.trees = records.begin();
+    zomlang_debug_node_table.treeCount = records.size();
+    ++zomlang_debug_node_table.generation;
+  }
+};
+
+zc::MutexGuarded<ListedTrees>& getListedTrees() {
+  static zc::MutexGuarded<ListedTrees> listed;
+  return listed;
+}
+
+const zc::String& getKindNames() {
+  static const zc::String names = []() {
+    zc::Vector<char> chars;
+    for (size_t i = 0; i < static_cast<size_t>(SyntaxKind::Count); ++i) {
+      chars.addAll(_::syntaxKindToString(static_cast<SyntaxKind>(i)));
+      chars.add('\0');
+    }
+    chars.add('\0');
+    return zc::String(chars.releaseAsArray());
+  }();
+  return names;
+}
+
+class RecordCollector final : public NodeWalker {
+public:
+  RecordCollector(zc::ArrayPtr<const zc::byte> source, source::SourceLoc sourceStart)
+      : source(source), sourceStart(sourceStart) {}
+
+  zc::Vector<DebugNodeRecord> records;
+
+private:
+  zc::ArrayPtr<const zc::byte> source;
+  source::SourceLoc sourceStart;
+  zc::Vector<const Node*> parents;
+
+  const char* getText(source::SourceLoc loc) const {
+    if (loc.isInvalid() || loc < sourceStart) { return nullptr; }
+    const size_t offset = loc.getOpaqueValue() - sourceStart.getOpaqueValue();
+    if (offset > source.size()) { return nullptr; }
+    return reinterpret_cast<const char*>(source.begin()) + offset;
+  }
+
+  void enter(const Node& node) override {
+    const source::SourceRange& range = node.getSourceRange();
+    const char* begin = getText(range.getStart());
+    const char* end = getText(range.getEnd());
+    if (begin == nullptr || end == nullptr || end < begin) { begin = end = nullptr; }
+    records.add(DebugNodeRecord{&node, parents.empty() ? nullptr : parents.back(), begin, end,
+                                static_cast<uint32_t>(node.getKind()),
+                                static_cast<uint32_t>(parents.size())});
+    parents.add(&node);
+  }
+
+  void leave(const Node&) override { parents.removeLast(); }
+};
+
+}  // namespace
+
+void addToDebugNodeTable(const Node& root, zc::ArrayPtr<const zc::byte> source,
+                         source::SourceLoc sourceStart) {
+  // Walked outside the lock, since it may parse deferred bodies
+  RecordCollector collector(source, sourceStart);
+  collector.walk(root);
+
+  zc::Own<ListedTree> tree = zc::heap<ListedTree>();
+  tree->root = &root;
+  ZC_IF_SOME(sourceFile, dyn_cast<SourceFile>(root)) {
+    tree->fileName = zc::str(sourceFile.getFileName());
+  }
+  else { tree->fileName = zc::str(""); }
+  tree->nodes = collector.records.releaseAsArray();
+
+  auto listed = getListedTrees().lockExclusive();
+  const zc::String& kindNames = getKindNames();
+  zomlang_debug_node_table.kindNames = kindNames.cStr();
+  zomlang_debug_node_table.kindNamesSize = kindNames.size();
+  for (zc::Own<ListedTree>& existing : listed->trees) {
+    if (existing->root == &root) {
+      existing = zc::mv(tree);
+      listed->publish();
+      return;
+    }
+  }
+  listed->trees.add(zc::mv(tree));
+  listed->publish();
+}
+
+void removeFromDebugNodeTable(const Node& root) {
+  auto listed = getListedTrees().lockExclusive();
+  for (size_t i = 0; i < listed->trees.size(); ++i) {
+    if (listed->trees[i]->root != &root) { continue; }
+    // Order does not matter to the readers
+    if (i + 1 != listed->trees.size()) { listed->trees[i] = zc::mv(listed->trees.back()); }
+    listed->trees.removeLast();
+    listed->publish();
+    return;
+  }
+}
+
+const DebugNodeTable& getDebugNodeTable() { return zomlang_debug_node_table; }
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,92 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include <cstdint>
+
+#include "zc/core/array.h"
+#include "zc/core/common.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/source/location.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+/// \brief A flat description of the parsed trees, for debugger formatters to read in bulk.
+///
+/// Walking a tree through the debugger's expression evaluator costs one evaluation per node and
+/// member. With debug info enabled the driver instead lists every node of every tree it holds
+/// here, in the order `NodeWalker` visits them, and the formatters in
+/// `tools/lldb/zomlang_lldb.py` find the table under the symbol `zomlang_debug_node_table` and
+/// read each tree with one memory read. The layout is plain data, so that it can be read without
+/// type information; `version` changes with it.
+
+/// \brief One node. The text is the source the node's range covers, or null if it has none.
+struct DebugNodeRecord {
+  const Node* node;
+  /// Null for the root of a tree
+  const Node* parent;
+  const char* textBegin;
+  const char* textEnd;
+  /// A `SyntaxKind`, whose name is at the same index in `DebugNodeTable::kindNames`
+  uint32_t kind;
+  /// Nodes above this one in its tree, zero for the root
+  uint32_t depth;
+};
+
+/// \brief One tree, with its nodes in walk order, so that the root comes first.
+struct DebugTreeRecord {
+  const Node* root;
+  /// NUL-terminated, empty if the root is not a source file
+  const char* fileName;
+  const DebugNodeRecord* nodes;
+  uint64_t nodeCount;
+};
+
+struct DebugNodeTable {
+  static constexpr uint32_t kMagic = 0x4d4f5a44;  // "DZOM"
+  static constexpr uint32_t kVersion = 1;
+
+  uint32_t magic;
+  uint32_t version;
+  uint32_t nodeRecordSize;
+  uint32_t treeRecordSize;
+  /// Changed whenever a tree is added or removed, so that readers can keep what they read until
+  /// it does
+  uint64_t generation;
+  /// The name of every `SyntaxKind` in order, each followed by a NUL
+  const char* kindNames;
+  uint64_t kindNamesSize;
+  const DebugTreeRecord* trees;
+  uint64_t treeCount;
+};
+
+/// \brief Add every node of the tree rooted at `root` to the table, replacing what was listed
+/// for it before. Deferred function bodies are parsed to list their nodes. Thread-safe.
+/// \param source Text the tree was parsed from
+/// \param sourceStart Location of the first byte of `source`
+void addToDebugNodeTable(const Node& root, zc::ArrayPtr<const zc::byte> source,
+                         source::SourceLoc sourceStart);
+
+/// \brief Remove the tree rooted at `root` from the table, if it is listed. Must be called before
+/// the tree is destroyed. Thread-safe.
+void removeFromDebugNodeTable(const Node& root);
+
+/// \brief The table as the debugger sees it. Only stable while no tree is added or removed.
+const DebugNodeTable& getDebugNodeTable();
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,6 +14,8 @@
 
 #include "zomlang/compiler/ast/dumper.h"
 
+#include <cstring>
+
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/module.h"
 #include "zomlang/compiler/ast/operator.h"
@@ -31,15 +33,34 @@ void dumpName(ASTDumper& dumper,
               zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> name) {
   ZC_SWITCH_ONEOF(name) {
     ZC_CASE_ONEOF(maybeId, zc::Maybe<const Identifier&>) {
-      ZC_IF_SOME(id, maybeId) { id.accept(dumper); }
+      ZC_IF_SOME(id, maybeId) { dumper.dispatch(id); }
     }
     ZC_CASE_ONEOF(maybePattern, zc::Maybe<const BindingPattern&>) {
-      ZC_IF_SOME(pattern, maybePattern) { pattern.accept(dumper); }
+      ZC_IF_SOME(pattern, maybePattern) { dumper.dispatch(pattern); }
     }
   }
 }
 
-void dumpName(ASTDumper& dumper, const Identifier& name) { name.accept(dumper); }
+void dumpName(ASTDumper& dumper, const Identifier& name) { dumper.dispatch(name); }
+
+/// Formats a numeric literal value on the stack, so writing it needs no heap-allocated string.
+class NumberText {
+public:
+  template <typename T>
+  explicit NumberText(T value) {
+    auto digits = zc::toCharSequence(value);
+    ZC_IREQUIRE(digits.size() < sizeof(text));
+    memcpy(text, digits.begin(), digits.size());
+    size = digits.size();
+    text[size] = '\0';
+  }
+
+  zc::StringPtr get() const { return zc::StringPtr(text, size); }
+
+private:
+  char text[40];
+  size_t size;
+};
 }  // namespace
 
 struct ASTDumper::Impl {
@@ -53,7 +74,10 @@ ASTDumper::ASTDumper(zc::Own<Serializer> serializer) noexcept
 
 ASTDumper::~ASTDumper() noexcept(false) = default;
 
-void ASTDumper::dump(const Node& node) { node.accept(*this); }
+void ASTDumper::dump(const Node& node) {
+  dispatch(node);
+  impl->serializer->flush();
+}
 
 void ASTDumper::visit(const SourceFile& node) {
   impl->serializer->writeNodeStart("SourceFile"_zc);
@@ -62,7 +86,7 @@ void ASTDumper::visit(const SourceFile& node) {
 
   ZC_IF_SOME(moduleDeclaration, node.getModuleDeclaration()) {
     impl->serializer->writeChildStart("moduleDeclaration"_zc);
-    moduleDeclaration.accept(*this);
+    dispatch(moduleDeclaration);
     impl->serializer->writeChildEnd("moduleDeclaration"_zc);
   }
 
@@ -70,7 +94,7 @@ void ASTDumper::visit(const SourceFile& node) {
   impl->serializer->writeArrayStart("statements"_zc, statements.size());
   for (const auto& stmt : statements) {
     impl->serializer->writeArrayElement();
-    stmt.accept(*this);
+    dispatch(stmt);
   }
   impl->serializer->writeArrayEnd("statements"_zc);
 
@@ -81,7 +105,7 @@ void ASTDumper::visit(const ModuleDeclaration& node) {
   impl->serializer->writeNodeStart("ModuleDeclaration"_zc);
 
   impl->serializer->writeChildStart("modulePath"_zc);
-  node.getModulePath().accept(*this);
+  dispatch(node.getModulePath());
   impl->serializer->writeChildEnd("modulePath"_zc);
 
   impl->serializer->writeNodeEnd("ModuleDeclaration"_zc);
@@ -91,7 +115,7 @@ void ASTDumper::visit(const ImportDeclaration& node) {
   impl->serializer->writeNodeStart("ImportDeclaration"_zc);
 
   impl->serializer->writeChildStart("modulePath"_zc);
-  node.getModulePath().accept(*this);
+  dispatch(node.getModulePath());
   impl->serializer->writeChildEnd("modulePath"_zc);
 
   ZC_IF_SOME(alias, node.getAlias()) { impl->serializer->writeProperty("alias", alias.getText()); }
@@ -100,7 +124,7 @@ void ASTDumper::visit(const ImportDeclaration& node) {
   impl->serializer->writeArrayStart("specifiers"_zc, specifiers.size());
   for (const auto& specifier : specifiers) {
     impl->serializer->writeArrayElement();
-    specifier.accept(*this);
+    dispatch(specifier);
   }
   impl->serializer->writeArrayEnd("specifiers"_zc);
 
@@ -111,11 +135,11 @@ void ASTDumper::visit(const ImportSpecifier& node) {
   impl->serializer->writeNodeStart("ImportSpecifier"_zc);
 
   impl->serializer->writeChildStart("importedName"_zc);
-  node.getImportedName().accept(*this);
+  dispatch(node.getImportedName());
   impl->serializer->writeChildEnd("importedName"_zc);
 
   impl->serializer->writeChildStart("alias"_zc);
-  ZC_IF_SOME(alias, node.getAlias()) { alias.accept(*this); }
+  ZC_IF_SOME(alias, node.getAlias()) { dispatch(alias); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("alias"_zc);
 
@@ -126,7 +150,7 @@ void ASTDumper::visit(const ExportDeclaration& node) {
   impl->serializer->writeNodeStart("ExportDeclaration"_zc);
 
   impl->serializer->writeChildStart("modulePath"_zc);
-  ZC_IF_SOME(modulePath, node.getModulePath()) { modulePath.accept(*this); }
+  ZC_IF_SOME(modulePath, node.getModulePath()) { dispatch(modulePath); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("modulePath"_zc);
 
@@ -134,13 +158,13 @@ void ASTDumper::visit(const ExportDeclaration& node) {
   impl->serializer->writeArrayStart("specifiers"_zc, specifiers.size());
   for (const auto& specifier : specifiers) {
     impl->serializer->writeArrayElement();
-    specifier.accept(*this);
+    dispatch(specifier);
   }
   impl->serializer->writeArrayEnd("specifiers"_zc);
 
   ZC_IF_SOME(declaration, node.getDeclaration()) {
     impl->serializer->writeChildStart("declaration"_zc);
-    declaration.accept(*this);
+    dispatch(declaration);
     impl->serializer->writeChildEnd("declaration"_zc);
   }
 
@@ -151,11 +175,11 @@ void ASTDumper::visit(const ExportSpecifier& node) {
   impl->serializer->writeNodeStart("ExportSpecifier"_zc);
 
   impl->serializer->writeChildStart("exportedName"_zc);
-  node.getExportedName().accept(*this);
+  dispatch(node.getExportedName());
   impl->serializer->writeChildEnd("exportedName"_zc);
 
   impl->serializer->writeChildStart("alias"_zc);
-  ZC_IF_SOME(alias, node.getAlias()) { alias.accept(*this); }
+  ZC_IF_SOME(alias, node.getAlias()) { dispatch(alias); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("alias"_zc);
 
@@ -169,7 +193,7 @@ void ASTDumper::visit(const VariableDeclarationList& node) {
   impl->serializer->writeArrayStart("bindings"_zc, bindings.size());
   for (const auto& binding : bindings) {
     impl->serializer->writeArrayElement();
-    binding.accept(*this);
+    dispatch(binding);
   }
   impl->serializer->writeArrayEnd("bindings"_zc);
 
@@ -180,7 +204,7 @@ void ASTDumper::visit(const VariableStatement& node) {
   impl->serializer->writeNodeStart("VariableStatement"_zc);
 
   impl->serializer->writeChildStart("declarations"_zc);
-  node.getDeclarations().accept(*this);
+  dispatch(node.getDeclarations());
   impl->serializer->writeChildEnd("declarations"_zc);
 
   impl->serializer->writeNodeEnd("VariableStatement"_zc);
@@ -198,7 +222,7 @@ void ASTDumper::visit(const FunctionDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -206,18 +230,18 @@ void ASTDumper::visit(const FunctionDeclaration& node) {
   impl->serializer->writeArrayStart("parameters"_zc, params.size());
   for (const auto& param : params) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   ZC_IF_SOME(returnType, node.getReturnType()) {
     impl->serializer->writeChildStart("returnType"_zc);
-    returnType.accept(*this);
+    dispatch(returnType);
     impl->serializer->writeChildEnd("returnType"_zc);
   }
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("FunctionDeclaration"_zc);
@@ -230,7 +254,7 @@ void ASTDumper::visit(const BlockStatement& node) {
   impl->serializer->writeArrayStart("children"_zc, statements.size());
   for (const auto& stmt : statements) {
     impl->serializer->writeArrayElement();
-    stmt.accept(*this);
+    dispatch(stmt);
   }
   impl->serializer->writeArrayEnd("children"_zc);
 
@@ -241,7 +265,7 @@ void ASTDumper::visit(const ExpressionStatement& node) {
   impl->serializer->writeNodeStart("ExpressionStatement"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("ExpressionStatement"_zc);
@@ -256,15 +280,15 @@ void ASTDumper::visit(const BinaryExpression& node) {
   impl->serializer->writeNodeStart("BinaryExpression"_zc);
 
   impl->serializer->writeChildStart("left"_zc);
-  node.getLeft().accept(*this);
+  dispatch(node.getLeft());
   impl->serializer->writeChildEnd("left"_zc);
 
   impl->serializer->writeChildStart("operator"_zc);
-  node.getOperator().accept(*this);
+  dispatch(node.getOperator());
   impl->serializer->writeChildEnd("operator"_zc);
 
   impl->serializer->writeChildStart("right"_zc);
-  node.getRight().accept(*this);
+  dispatch(node.getRight());
   impl->serializer->writeChildEnd("right"_zc);
 
   impl->serializer->writeNodeEnd("BinaryExpression"_zc);
@@ -280,14 +304,14 @@ void ASTDumper::visit(const TemplateLiteralExpression& node) {
   impl->serializer->writeNodeStart("TemplateLiteralExpression"_zc);
 
   impl->serializer->writeChildStart("head"_zc);
-  node.getHead().accept(*this);
+  dispatch(node.getHead());
   impl->serializer->writeChildEnd("head"_zc);
 
   const auto& spans = node.getSpans();
   impl->serializer->writeArrayStart("spans"_zc, spans.size());
   for (const auto& span : spans) {
     impl->serializer->writeArrayElement();
-    span.accept(*this);
+    dispatch(span);
   }
   impl->serializer->writeArrayEnd("spans"_zc);
 
@@ -298,11 +322,11 @@ void ASTDumper::visit(const TemplateSpan& node) {
   impl->serializer->writeNodeStart("TemplateSpan"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("literal"_zc);
-  node.getLiteral().accept(*this);
+  dispatch(node.getLiteral());
   impl->serializer->writeChildEnd("literal"_zc);
 
   impl->serializer->writeNodeEnd("TemplateSpan"_zc);
@@ -310,13 +334,13 @@ void ASTDumper::visit(const TemplateSpan& node) {
 
 void ASTDumper::visit(const IntegerLiteral& node) {
   impl->serializer->writeNodeStart("IntegerLiteral"_zc);
-  impl->serializer->writeProperty("value", zc::str(node.getValue()));
+  impl->serializer->writeProperty("value", NumberText(node.getValue()).get());
   impl->serializer->writeNodeEnd("IntegerLiteral"_zc);
 }
 
 void ASTDumper::visit(const FloatLiteral& node) {
   impl->serializer->writeNodeStart("FloatLiteral"_zc);
-  impl->serializer->writeProperty("value", zc::str(node.getValue()));
+  impl->serializer->writeProperty("value", NumberText(node.getValue()).get());
   impl->serializer->writeNodeEnd("FloatLiteral"_zc);
 }
 
@@ -348,7 +372,7 @@ void ASTDumper::visit(const PatternProperty& node) {
   impl->serializer->writeProperty("name", node.getName().getText());
   ZC_IF_SOME(pattern, node.getPattern()) {
     impl->serializer->writeChildStart("pattern"_zc);
-    pattern.accept(*this);
+    dispatch(pattern);
     impl->serializer->writeChildEnd("pattern"_zc);
   }
   impl->serializer->writeNodeEnd("PatternProperty"_zc);
@@ -358,23 +382,23 @@ void ASTDumper::visit(const ParenthesizedExpression& node) {
   impl->serializer->writeNodeStart("ParenthesizedExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("ParenthesizedExpression"_zc);
 }
 
-void ASTDumper::visit(const Node& node) { node.accept(*this); }
+void ASTDumper::visit(const Node& node) { dispatch(node); }
 
-void ASTDumper::visit(const Statement& node) { node.accept(*this); }
+void ASTDumper::visit(const Statement& node) { dispatch(node); }
 
-void ASTDumper::visit(const IterationStatement& node) { node.accept(*this); }
+void ASTDumper::visit(const IterationStatement& node) { dispatch(node); }
 
 void ASTDumper::visit(const DeclarationStatement& node) {
-  static_cast<const Statement&>(node).accept(*this);
+  dispatch(static_cast<const Statement&>(node));
 }
 
-void ASTDumper::visit(const Expression& node) { node.accept(*this); }
+void ASTDumper::visit(const Expression& node) { dispatch(node); }
 
 void ASTDumper::visit(const BindingElement& node) {
   impl->serializer->writeNodeStart("BindingElement"_zc);
@@ -385,12 +409,12 @@ void ASTDumper::visit(const BindingElement& node) {
 
   ZC_IF_SOME(pattern, node.getBindingPattern()) {
     impl->serializer->writeChildStart("bindingPattern"_zc);
-    pattern.accept(*this);
+    dispatch(pattern);
     impl->serializer->writeChildEnd("bindingPattern"_zc);
   }
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
@@ -407,7 +431,7 @@ void ASTDumper::visit(const ModulePath& node) {
   impl->serializer->writeArrayStart("segments"_zc, segments.size());
   for (const auto& segment : segments) {
     impl->serializer->writeArrayElement();
-    segment.accept(*this);
+    dispatch(segment);
   }
   impl->serializer->writeArrayEnd("segments"_zc);
 
@@ -423,7 +447,7 @@ void ASTDumper::visit(const TypeParameterDeclaration& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("constraint"_zc);
-  ZC_IF_SOME(constraint, node.getConstraint()) { constraint.accept(*this); }
+  ZC_IF_SOME(constraint, node.getConstraint()) { dispatch(constraint); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("constraint"_zc);
 
@@ -442,7 +466,7 @@ void ASTDumper::visit(const ClassDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -452,7 +476,7 @@ void ASTDumper::visit(const ClassDeclaration& node) {
     impl->serializer->writeArrayStart("heritageClauses"_zc, heritageClauses.size());
     for (const auto& clause : heritageClauses) {
       impl->serializer->writeArrayElement();
-      clause.accept(*this);
+      dispatch(clause);
     }
     impl->serializer->writeArrayEnd("heritageClauses"_zc);
   }
@@ -480,7 +504,7 @@ void ASTDumper::visit(const InterfaceDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -490,7 +514,7 @@ void ASTDumper::visit(const InterfaceDeclaration& node) {
     impl->serializer->writeArrayStart("heritageClauses"_zc, heritageClauses.size());
     for (const auto& clause : heritageClauses) {
       impl->serializer->writeArrayElement();
-      clause.accept(*this);
+      dispatch(clause);
     }
     impl->serializer->writeArrayEnd("heritageClauses"_zc);
   }
@@ -518,7 +542,7 @@ void ASTDumper::visit(const StructDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -528,7 +552,7 @@ void ASTDumper::visit(const StructDeclaration& node) {
     impl->serializer->writeArrayStart("heritageClauses"_zc, heritageClauses.size());
     for (const auto& clause : heritageClauses) {
       impl->serializer->writeArrayElement();
-      clause.accept(*this);
+      dispatch(clause);
     }
     impl->serializer->writeArrayEnd("heritageClauses"_zc);
   }
@@ -552,12 +576,12 @@ void ASTDumper::visit(const EnumMember& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(initializer, node.getInitializer()) { initializer.accept(*this); }
+  ZC_IF_SOME(initializer, node.getInitializer()) { dispatch(initializer); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
   impl->serializer->writeChildStart("tupleType"_zc);
-  ZC_IF_SOME(tupleType, node.getTupleType()) { tupleType.accept(*this); }
+  ZC_IF_SOME(tupleType, node.getTupleType()) { dispatch(tupleType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("tupleType"_zc);
 
@@ -575,7 +599,7 @@ void ASTDumper::visit(const EnumDeclaration& node) {
   impl->serializer->writeArrayStart("members"_zc, members.size());
   for (const auto& member : members) {
     impl->serializer->writeArrayElement();
-    member.accept(*this);
+    dispatch(member);
   }
   impl->serializer->writeArrayEnd("members"_zc);
 
@@ -593,7 +617,7 @@ void ASTDumper::visit(const ErrorDeclaration& node) {
   impl->serializer->writeArrayStart("members"_zc, members.size());
   for (const auto& member : members) {
     impl->serializer->writeArrayElement();
-    member.accept(*this);
+    dispatch(member);
   }
   impl->serializer->writeArrayEnd("members"_zc);
 
@@ -611,12 +635,12 @@ void ASTDumper::visit(const AliasDeclaration& node) {
   impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
   for (const auto& param : typeParameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("typeParameters"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeNodeEnd("AliasDeclaration"_zc);
@@ -626,15 +650,15 @@ void ASTDumper::visit(const IfStatement& node) {
   impl->serializer->writeNodeStart("IfStatement"_zc);
 
   impl->serializer->writeChildStart("condition"_zc);
-  node.getCondition().accept(*this);
+  dispatch(node.getCondition());
   impl->serializer->writeChildEnd("condition"_zc);
 
   impl->serializer->writeChildStart("thenStatement"_zc);
-  node.getThenStatement().accept(*this);
+  dispatch(node.getThenStatement());
   impl->serializer->writeChildEnd("thenStatement"_zc);
 
   impl->serializer->writeChildStart("elseStatement"_zc);
-  ZC_IF_SOME(elseStatement, node.getElseStatement()) { elseStatement.accept(*this); }
+  ZC_IF_SOME(elseStatement, node.getElseStatement()) { dispatch(elseStatement); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("elseStatement"_zc);
 
@@ -645,11 +669,11 @@ void ASTDumper::visit(const WhileStatement& node) {
   impl->serializer->writeNodeStart("WhileStatement"_zc);
 
   impl->serializer->writeChildStart("condition"_zc);
-  node.getCondition().accept(*this);
+  dispatch(node.getCondition());
   impl->serializer->writeChildEnd("condition"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("WhileStatement"_zc);
@@ -659,22 +683,22 @@ void ASTDumper::visit(const ForStatement& node) {
   impl->serializer->writeNodeStart("ForStatement"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
   impl->serializer->writeChildStart("condition"_zc);
-  ZC_IF_SOME(cond, node.getCondition()) { cond.accept(*this); }
+  ZC_IF_SOME(cond, node.getCondition()) { dispatch(cond); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("condition"_zc);
 
   impl->serializer->writeChildStart("update"_zc);
-  ZC_IF_SOME(upd, node.getUpdate()) { upd.accept(*this); }
+  ZC_IF_SOME(upd, node.getUpdate()) { dispatch(upd); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("update"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("ForStatement"_zc);
@@ -684,15 +708,15 @@ void ASTDumper::visit(const ForInStatement& node) {
   impl->serializer->writeNodeStart("ForInStatement"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  node.getInitializer().accept(*this);
+  dispatch(node.getInitializer());
   impl->serializer->writeChildEnd("initializer"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("ForInStatement"_zc);
@@ -702,11 +726,11 @@ void ASTDumper::visit(const LabeledStatement& node) {
   impl->serializer->writeNodeStart("LabeledStatement"_zc);
 
   impl->serializer->writeChildStart("label"_zc);
-  node.getLabel().accept(*this);
+  dispatch(node.getLabel());
   impl->serializer->writeChildEnd("label"_zc);
 
   impl->serializer->writeChildStart("statement"_zc);
-  node.getStatement().accept(*this);
+  dispatch(node.getStatement());
   impl->serializer->writeChildEnd("statement"_zc);
 
   impl->serializer->writeNodeEnd("LabeledStatement"_zc);
@@ -716,7 +740,7 @@ void ASTDumper::visit(const BreakStatement& node) {
   impl->serializer->writeNodeStart("BreakStatement"_zc);
 
   impl->serializer->writeChildStart("label"_zc);
-  ZC_IF_SOME(label, node.getLabel()) { label.accept(*this); }
+  ZC_IF_SOME(label, node.getLabel()) { dispatch(label); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("label"_zc);
 
@@ -727,7 +751,7 @@ void ASTDumper::visit(const ContinueStatement& node) {
   impl->serializer->writeNodeStart("ContinueStatement"_zc);
 
   impl->serializer->writeChildStart("label"_zc);
-  ZC_IF_SOME(label, node.getLabel()) { label.accept(*this); }
+  ZC_IF_SOME(label, node.getLabel()) { dispatch(label); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("label"_zc);
 
@@ -738,7 +762,7 @@ void ASTDumper::visit(const ReturnStatement& node) {
   impl->serializer->writeNodeStart("ReturnStatement"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  ZC_IF_SOME(expr, node.getExpression()) { expr.accept(*this); }
+  ZC_IF_SOME(expr, node.getExpression()) { dispatch(expr); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("expression"_zc);
 
@@ -749,14 +773,14 @@ void ASTDumper::visit(const MatchStatement& node) {
   impl->serializer->writeNodeStart("MatchStatement"_zc);
 
   impl->serializer->writeChildStart("discriminant"_zc);
-  node.getDiscriminant().accept(*this);
+  dispatch(node.getDiscriminant());
   impl->serializer->writeChildEnd("discriminant"_zc);
 
   const auto& clauses = node.getClauses();
   impl->serializer->writeArrayStart("clauses"_zc, clauses.size());
   for (const auto& clause : clauses) {
     impl->serializer->writeArrayElement();
-    clause.accept(*this);
+    dispatch(clause);
   }
   impl->serializer->writeArrayEnd("clauses"_zc);
 
@@ -767,16 +791,16 @@ void ASTDumper::visit(const MatchClause& node) {
   impl->serializer->writeNodeStart("MatchClause"_zc);
 
   impl->serializer->writeChildStart("pattern"_zc);
-  node.getPattern().accept(*this);
+  dispatch(node.getPattern());
   impl->serializer->writeChildEnd("pattern"_zc);
 
   impl->serializer->writeChildStart("guard"_zc);
-  ZC_IF_SOME(guard, node.getGuard()) { guard.accept(*this); }
+  ZC_IF_SOME(guard, node.getGuard()) { dispatch(guard); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("guard"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("MatchClause"_zc);
@@ -789,7 +813,7 @@ void ASTDumper::visit(const DefaultClause& node) {
   impl->serializer->writeArrayStart("statements"_zc, statements.size());
   for (const auto& stmt : statements) {
     impl->serializer->writeArrayElement();
-    stmt.accept(*this);
+    dispatch(stmt);
   }
   impl->serializer->writeArrayEnd("statements"_zc);
 
@@ -801,9 +825,9 @@ void ASTDumper::visit(const DebuggerStatement& node) {
   impl->serializer->writeNodeEnd("DebuggerStatement"_zc);
 }
 
-void ASTDumper::visit(const UnaryExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const UnaryExpression& node) { dispatch(node); }
 
-void ASTDumper::visit(const UpdateExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const UpdateExpression& node) { dispatch(node); }
 
 void ASTDumper::visit(const PrefixUnaryExpression& node) {
   impl->serializer->writeNodeStart("PrefixUnaryExpression"_zc);
@@ -817,7 +841,7 @@ void ASTDumper::visit(const PrefixUnaryExpression& node) {
   impl->serializer->writeChildEnd("operator"_zc);
 
   impl->serializer->writeChildStart("operand"_zc);
-  node.getOperand().accept(*this);
+  dispatch(node.getOperand());
   impl->serializer->writeChildEnd("operand"_zc);
 
   impl->serializer->writeNodeEnd("PrefixUnaryExpression"_zc);
@@ -827,7 +851,7 @@ void ASTDumper::visit(const PostfixUnaryExpression& node) {
   impl->serializer->writeNodeStart("PostfixUnaryExpression"_zc);
 
   impl->serializer->writeChildStart("operand"_zc);
-  node.getOperand().accept(*this);
+  dispatch(node.getOperand());
   impl->serializer->writeChildEnd("operand"_zc);
 
   impl->serializer->writeChildStart("operator"_zc);
@@ -841,17 +865,17 @@ void ASTDumper::visit(const PostfixUnaryExpression& node) {
   impl->serializer->writeNodeEnd("PostfixUnaryExpression"_zc);
 }
 
-void ASTDumper::visit(const LeftHandSideExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const LeftHandSideExpression& node) { dispatch(node); }
 
-void ASTDumper::visit(const MemberExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const MemberExpression& node) { dispatch(node); }
 
-void ASTDumper::visit(const PrimaryExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const PrimaryExpression& node) { dispatch(node); }
 
 void ASTDumper::visit(const PropertyAccessExpression& node) {
   impl->serializer->writeNodeStart("PropertyAccessExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("name"_zc);
@@ -867,11 +891,11 @@ void ASTDumper::visit(const ElementAccessExpression& node) {
   impl->serializer->writeNodeStart("ElementAccessExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("index"_zc);
-  node.getIndex().accept(*this);
+  dispatch(node.getIndex());
   impl->serializer->writeChildEnd("index"_zc);
 
   impl->serializer->writeProperty("questionDot"_zc, node.isQuestionDot() ? "true"_zc : "false"_zc);
@@ -883,14 +907,14 @@ void ASTDumper::visit(const NewExpression& node) {
   impl->serializer->writeNodeStart("NewExpression"_zc);
 
   impl->serializer->writeChildStart("callee"_zc);
-  node.getCallee().accept(*this);
+  dispatch(node.getCallee());
   impl->serializer->writeChildEnd("callee"_zc);
 
   ZC_IF_SOME(args, node.getArguments()) {
     impl->serializer->writeArrayStart("arguments"_zc, args.size());
     for (const auto& arg : args) {
       impl->serializer->writeArrayElement();
-      arg->accept(*this);
+      dispatch(*arg);
     }
     impl->serializer->writeArrayEnd("arguments"_zc);
   }
@@ -907,15 +931,15 @@ void ASTDumper::visit(const ConditionalExpression& node) {
   impl->serializer->writeNodeStart("ConditionalExpression"_zc);
 
   impl->serializer->writeChildStart("test"_zc);
-  node.getTest().accept(*this);
+  dispatch(node.getTest());
   impl->serializer->writeChildEnd("test"_zc);
 
   impl->serializer->writeChildStart("consequent"_zc);
-  node.getConsequent().accept(*this);
+  dispatch(node.getConsequent());
   impl->serializer->writeChildEnd("consequent"_zc);
 
   impl->serializer->writeChildStart("alternate"_zc);
-  node.getAlternate().accept(*this);
+  dispatch(node.getAlternate());
   impl->serializer->writeChildEnd("alternate"_zc);
 
   impl->serializer->writeNodeEnd("ConditionalExpression"_zc);
@@ -925,33 +949,33 @@ void ASTDumper::visit(const CallExpression& node) {
   impl->serializer->writeNodeStart("CallExpression"_zc);
 
   impl->serializer->writeChildStart("callee"_zc);
-  node.getCallee().accept(*this);
+  dispatch(node.getCallee());
   impl->serializer->writeChildEnd("callee"_zc);
 
   const auto& args = node.getArguments();
   impl->serializer->writeArrayStart("arguments"_zc, args.size());
   for (const auto& arg : args) {
     impl->serializer->writeArrayElement();
-    arg.accept(*this);
+    dispatch(arg);
   }
   impl->serializer->writeArrayEnd("arguments"_zc);
 
   impl->serializer->writeNodeEnd("CallExpression"_zc);
 }
 
-void ASTDumper::visit(const LiteralExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const LiteralExpression& node) { dispatch(node); }
 
-void ASTDumper::visit(const CastExpression& node) { node.accept(*this); }
+void ASTDumper::visit(const CastExpression& node) { dispatch(node); }
 
 void ASTDumper::visit(const AsExpression& node) {
   impl->serializer->writeNodeStart("AsExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("targetType"_zc);
-  node.getTargetType().accept(*this);
+  dispatch(node.getTargetType());
   impl->serializer->writeChildEnd("targetType"_zc);
 
   impl->serializer->writeNodeEnd("AsExpression"_zc);
@@ -961,11 +985,11 @@ void ASTDumper::visit(const ForcedAsExpression& node) {
   impl->serializer->writeNodeStart("ForcedAsExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("targetType"_zc);
-  node.getTargetType().accept(*this);
+  dispatch(node.getTargetType());
   impl->serializer->writeChildEnd("targetType"_zc);
 
   impl->serializer->writeNodeEnd("ForcedAsExpression"_zc);
@@ -975,11 +999,11 @@ void ASTDumper::visit(const ConditionalAsExpression& node) {
   impl->serializer->writeNodeStart("ConditionalAsExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeChildStart("targetType"_zc);
-  node.getTargetType().accept(*this);
+  dispatch(node.getTargetType());
   impl->serializer->writeChildEnd("targetType"_zc);
 
   impl->serializer->writeNodeEnd("ConditionalAsExpression"_zc);
@@ -989,7 +1013,7 @@ void ASTDumper::visit(const NonNullExpression& node) {
   impl->serializer->writeNodeStart("NonNullExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("NonNullExpression"_zc);
@@ -999,7 +1023,7 @@ void ASTDumper::visit(const ExpressionWithTypeArguments& node) {
   impl->serializer->writeNodeStart("ExpressionWithTypeArguments"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   const auto& typeArguments = node.getTypeArguments();
@@ -1008,7 +1032,7 @@ void ASTDumper::visit(const ExpressionWithTypeArguments& node) {
       impl->serializer->writeArrayStart("typeArguments"_zc, args.size());
       for (const auto& typeArg : args) {
         impl->serializer->writeArrayElement();
-        typeArg.accept(*this);
+        dispatch(typeArg);
       }
       impl->serializer->writeArrayEnd("typeArguments"_zc);
     }
@@ -1032,7 +1056,7 @@ void ASTDumper::visit(const HeritageClause& node) {
   impl->serializer->writeArrayStart("types"_zc, types.size());
   for (const auto& t : types) {
     impl->serializer->writeArrayElement();
-    t->accept(*this);
+    dispatch(*t);
   }
   impl->serializer->writeArrayEnd("types"_zc);
 
@@ -1043,7 +1067,7 @@ void ASTDumper::visit(const VoidExpression& node) {
   impl->serializer->writeNodeStart("VoidExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("VoidExpression"_zc);
@@ -1053,7 +1077,7 @@ void ASTDumper::visit(const TypeOfExpression& node) {
   impl->serializer->writeNodeStart("TypeOfExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("TypeOfExpression"_zc);
@@ -1063,7 +1087,7 @@ void ASTDumper::visit(const AwaitExpression& node) {
   impl->serializer->writeNodeStart("AwaitExpression"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("AwaitExpression"_zc);
@@ -1076,7 +1100,7 @@ void ASTDumper::visit(const FunctionExpression& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParams.size());
     for (const auto& param : typeParams) {
       impl->serializer->writeArrayElement();
-      param->accept(*this);
+      dispatch(*param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1085,7 +1109,7 @@ void ASTDumper::visit(const FunctionExpression& node) {
   impl->serializer->writeArrayStart("parameters"_zc, params.size());
   for (const auto& param : params) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
@@ -1093,18 +1117,18 @@ void ASTDumper::visit(const FunctionExpression& node) {
   impl->serializer->writeArrayStart("captures"_zc, captures.size());
   for (const auto& capture : captures) {
     impl->serializer->writeArrayElement();
-    capture.accept(*this);
+    dispatch(capture);
   }
   impl->serializer->writeArrayEnd("captures"_zc);
 
   ZC_IF_SOME(returnType, node.getReturnType()) {
     impl->serializer->writeChildStart("returnType"_zc);
-    returnType.accept(*this);
+    dispatch(returnType);
     impl->serializer->writeChildEnd("returnType"_zc);
   }
 
   impl->serializer->writeChildStart("body"_zc);
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
   impl->serializer->writeChildEnd("body"_zc);
 
   impl->serializer->writeNodeEnd("FunctionExpression"_zc);
@@ -1117,7 +1141,7 @@ void ASTDumper::visit(const ArrayLiteralExpression& node) {
   impl->serializer->writeArrayStart("elements"_zc, elements.size());
   for (const auto& element : elements) {
     impl->serializer->writeArrayElement();
-    element.accept(*this);
+    dispatch(element);
   }
   impl->serializer->writeArrayEnd("elements"_zc);
 
@@ -1146,17 +1170,17 @@ void ASTDumper::visit(const PropertyAssignment& node) {
   impl->serializer->writeNodeStart("PropertyAssignment"_zc);
 
   impl->serializer->writeChildStart("name"_zc);
-  node.getNameIdentifier().accept(*this);
+  dispatch(node.getNameIdentifier());
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
   ZC_IF_SOME(questionToken, node.getQuestionToken()) {
     impl->serializer->writeChildStart("questionToken"_zc);
-    questionToken.accept(*this);
+    dispatch(questionToken);
     impl->serializer->writeChildEnd("questionToken"_zc);
   }
 
@@ -1167,18 +1191,18 @@ void ASTDumper::visit(const ShorthandPropertyAssignment& node) {
   impl->serializer->writeNodeStart("ShorthandPropertyAssignment"_zc);
 
   impl->serializer->writeChildStart("name"_zc);
-  node.getNameIdentifier().accept(*this);
+  dispatch(node.getNameIdentifier());
   impl->serializer->writeChildEnd("name"_zc);
 
   ZC_IF_SOME(init, node.getObjectAssignmentInitializer()) {
     impl->serializer->writeChildStart("objectAssignmentInitializer"_zc);
-    init.accept(*this);
+    dispatch(init);
     impl->serializer->writeChildEnd("objectAssignmentInitializer"_zc);
   }
 
   ZC_IF_SOME(equalsToken, node.getEqualsToken()) {
     impl->serializer->writeChildStart("equalsToken"_zc);
-    equalsToken.accept(*this);
+    dispatch(equalsToken);
     impl->serializer->writeChildEnd("equalsToken"_zc);
   }
 
@@ -1189,7 +1213,7 @@ void ASTDumper::visit(const SpreadAssignment& node) {
   impl->serializer->writeNodeStart("SpreadAssignment"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("SpreadAssignment"_zc);
@@ -1199,14 +1223,14 @@ void ASTDumper::visit(const SpreadElement& node) {
   impl->serializer->writeNodeStart("SpreadElement"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("SpreadElement"_zc);
 }
 
 // Type node visit methods
-void ASTDumper::visit(const TypeNode& node) { node.accept(*this); }
+void ASTDumper::visit(const TypeNode& node) { dispatch(node); }
 
 void ASTDumper::visit(const TokenNode& node) {
   impl->serializer->writeNodeStart("TokenNode"_zc);
@@ -1229,7 +1253,7 @@ void ASTDumper::visit(const ArrayTypeNode& node) {
   impl->serializer->writeNodeStart("ArrayTypeNode"_zc);
 
   impl->serializer->writeChildStart("elementType"_zc);
-  node.getElementType().accept(*this);
+  dispatch(node.getElementType());
   impl->serializer->writeChildEnd("elementType"_zc);
 
   impl->serializer->writeNodeEnd("ArrayTypeNode"_zc);
@@ -1242,7 +1266,7 @@ void ASTDumper::visit(const UnionTypeNode& node) {
   impl->serializer->writeArrayStart("types"_zc, types.size());
   for (const auto& type : types) {
     impl->serializer->writeArrayElement();
-    type.accept(*this);
+    dispatch(type);
   }
   impl->serializer->writeArrayEnd("types"_zc);
 
@@ -1256,7 +1280,7 @@ void ASTDumper::visit(const IntersectionTypeNode& node) {
   impl->serializer->writeArrayStart("types"_zc, types.size());
   for (const auto& type : types) {
     impl->serializer->writeArrayElement();
-    type.accept(*this);
+    dispatch(type);
   }
   impl->serializer->writeArrayEnd("types"_zc);
 
@@ -1267,23 +1291,23 @@ void ASTDumper::visit(const ParenthesizedTypeNode& node) {
   impl->serializer->writeNodeStart("ParenthesizedTypeNode"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeNodeEnd("ParenthesizedTypeNode"_zc);
 }
 
-void ASTDumper::visit(const PredefinedTypeNode& node) { node.accept(*this); }
+void ASTDumper::visit(const PredefinedTypeNode& node) { dispatch(node); }
 
 void ASTDumper::visit(const Declaration& node) { node.accept(*this); }
 
 void ASTDumper::visit(const NamedDeclaration& node) { node.accept(*this); }
 
-void ASTDumper::visit(const Pattern& node) { node.accept(*this); }
+void ASTDumper::visit(const Pattern& node) { dispatch(node); }
 
-void ASTDumper::visit(const PrimaryPattern& node) { node.accept(*this); }
+void ASTDumper::visit(const PrimaryPattern& node) { dispatch(node); }
 
-void ASTDumper::visit(const BindingPattern& node) { node.accept(*this); }
+void ASTDumper::visit(const BindingPattern& node) { dispatch(node); }
 
 void ASTDumper::visit(const ObjectTypeNode& node) {
   impl->serializer->writeNodeStart("ObjectTypeNode"_zc);
@@ -1292,7 +1316,7 @@ void ASTDumper::visit(const ObjectTypeNode& node) {
   impl->serializer->writeArrayStart("members"_zc, members.size());
   for (const auto& member : members) {
     impl->serializer->writeArrayElement();
-    member.accept(*this);
+    dispatch(member);
   }
   impl->serializer->writeArrayEnd("members"_zc);
 
@@ -1306,7 +1330,7 @@ void ASTDumper::visit(const TupleTypeNode& node) {
   impl->serializer->writeArrayStart("elementTypes"_zc, elementTypes.size());
   for (const auto& elementType : elementTypes) {
     impl->serializer->writeArrayElement();
-    elementType.accept(*this);
+    dispatch(elementType);
   }
   impl->serializer->writeArrayEnd("elementTypes"_zc);
 
@@ -1317,12 +1341,12 @@ void ASTDumper::visit(const ReturnTypeNode& node) {
   impl->serializer->writeNodeStart("ReturnType"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   ZC_IF_SOME(errorType, node.getErrorType()) {
     impl->serializer->writeChildStart("errorType"_zc);
-    errorType.accept(*this);
+    dispatch(errorType);
     impl->serializer->writeChildEnd("errorType"_zc);
   }
 
@@ -1336,7 +1360,7 @@ void ASTDumper::visit(const FunctionTypeNode& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParams.size());
     for (const auto& param : typeParams) {
       impl->serializer->writeArrayElement();
-      param->accept(*this);
+      dispatch(*param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1345,12 +1369,12 @@ void ASTDumper::visit(const FunctionTypeNode& node) {
   impl->serializer->writeArrayStart("parameters"_zc, params.size());
   for (const auto& param : params) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  node.getReturnType().accept(*this);
+  dispatch(node.getReturnType());
   impl->serializer->writeChildEnd("returnType"_zc);
 
   impl->serializer->writeNodeEnd("FunctionTypeNode"_zc);
@@ -1360,7 +1384,7 @@ void ASTDumper::visit(const OptionalTypeNode& node) {
   impl->serializer->writeNodeStart("OptionalTypeNode"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeNodeEnd("OptionalTypeNode"_zc);
@@ -1370,7 +1394,7 @@ void ASTDumper::visit(const TypeQueryNode& node) {
   impl->serializer->writeNodeStart("TypeQueryNode"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("TypeQueryNode"_zc);
@@ -1384,7 +1408,7 @@ void ASTDumper::visit(const NamedTupleElement& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeNodeEnd("NamedTupleElement"_zc);
@@ -1417,7 +1441,7 @@ void ASTDumper::visit(const MethodDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1426,17 +1450,17 @@ void ASTDumper::visit(const MethodDeclaration& node) {
   impl->serializer->writeArrayStart("parameters"_zc, parameters.size());
   for (const auto& param : parameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("returnType"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("body"_zc);
 
@@ -1467,7 +1491,7 @@ void ASTDumper::visit(const GetAccessor& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1476,17 +1500,17 @@ void ASTDumper::visit(const GetAccessor& node) {
   impl->serializer->writeArrayStart("parameters"_zc, parameters.size());
   for (const auto& param : parameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("returnType"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("body"_zc);
 
@@ -1517,7 +1541,7 @@ void ASTDumper::visit(const SetAccessor& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1526,17 +1550,17 @@ void ASTDumper::visit(const SetAccessor& node) {
   impl->serializer->writeArrayStart("parameters"_zc, parameters.size());
   for (const auto& param : parameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("returnType"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("body"_zc);
 
@@ -1567,7 +1591,7 @@ void ASTDumper::visit(const InitDeclaration& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1576,17 +1600,17 @@ void ASTDumper::visit(const InitDeclaration& node) {
   impl->serializer->writeArrayStart("parameters"_zc, parameters.size());
   for (const auto& param : parameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("returnType"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("body"_zc);
 
@@ -1613,7 +1637,7 @@ void ASTDumper::visit(const DeinitDeclaration& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("body"_zc);
-  ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("body"_zc);
 
@@ -1628,12 +1652,12 @@ void ASTDumper::visit(const ParameterDeclaration& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  ZC_IF_SOME(type, node.getType()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
@@ -1660,12 +1684,12 @@ void ASTDumper::visit(const PropertyDeclaration& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  ZC_IF_SOME(type, node.getType()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
@@ -1712,7 +1736,7 @@ void ASTDumper::visit(const ArrayBindingPattern& node) {
   impl->serializer->writeArrayStart("elements"_zc, elements.size());
   for (const auto& element : elements) {
     impl->serializer->writeArrayElement();
-    element.accept(*this);
+    dispatch(element);
   }
   impl->serializer->writeArrayEnd("elements"_zc);
 
@@ -1726,7 +1750,7 @@ void ASTDumper::visit(const ObjectBindingPattern& node) {
   impl->serializer->writeArrayStart("properties"_zc, properties.size());
   for (const auto& prop : properties) {
     impl->serializer->writeArrayElement();
-    prop.accept(*this);
+    dispatch(prop);
   }
   impl->serializer->writeArrayEnd("properties"_zc);
 
@@ -1850,12 +1874,12 @@ void ASTDumper::visit(const PropertySignature& node) {
   impl->serializer->writeProperty("optional"_zc, node.isOptional() ? "true"_zc : "false"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  ZC_IF_SOME(type, node.getType()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
@@ -1888,7 +1912,7 @@ void ASTDumper::visit(const MethodSignature& node) {
     impl->serializer->writeArrayStart("typeParameters"_zc, typeParameters.size());
     for (const auto& param : typeParameters) {
       impl->serializer->writeArrayElement();
-      param.accept(*this);
+      dispatch(param);
     }
     impl->serializer->writeArrayEnd("typeParameters"_zc);
   }
@@ -1897,12 +1921,12 @@ void ASTDumper::visit(const MethodSignature& node) {
   impl->serializer->writeArrayStart("parameters"_zc, parameters.size());
   for (const auto& param : parameters) {
     impl->serializer->writeArrayElement();
-    param.accept(*this);
+    dispatch(param);
   }
   impl->serializer->writeArrayEnd("parameters"_zc);
 
   impl->serializer->writeChildStart("returnType"_zc);
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("returnType"_zc);
 
@@ -1924,12 +1948,12 @@ void ASTDumper::visit(const VariableDeclaration& node) {
   impl->serializer->writeChildEnd("name"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  ZC_IF_SOME(type, node.getType()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeChildStart("initializer"_zc);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("initializer"_zc);
 
@@ -1940,7 +1964,7 @@ void ASTDumper::visit(const WildcardPattern& node) {
   impl->serializer->writeNodeStart("WildcardPattern"_zc);
 
   impl->serializer->writeChildStart("typeAnnotation"_zc);
-  ZC_IF_SOME(type, node.getTypeAnnotation()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getTypeAnnotation()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("typeAnnotation"_zc);
 
@@ -1951,11 +1975,11 @@ void ASTDumper::visit(const IdentifierPattern& node) {
   impl->serializer->writeNodeStart("IdentifierPattern"_zc);
 
   impl->serializer->writeChildStart("identifier"_zc);
-  node.getIdentifier().accept(*this);
+  dispatch(node.getIdentifier());
   impl->serializer->writeChildEnd("identifier"_zc);
 
   impl->serializer->writeChildStart("typeAnnotation"_zc);
-  ZC_IF_SOME(type, node.getTypeAnnotation()) { type.accept(*this); }
+  ZC_IF_SOME(type, node.getTypeAnnotation()) { dispatch(type); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("typeAnnotation"_zc);
 
@@ -1969,7 +1993,7 @@ void ASTDumper::visit(const TuplePattern& node) {
   impl->serializer->writeArrayStart("elements"_zc, elements.size());
   for (const auto& element : elements) {
     impl->serializer->writeArrayElement();
-    element.accept(*this);
+    dispatch(element);
   }
   impl->serializer->writeArrayEnd("elements"_zc);
 
@@ -1983,7 +2007,7 @@ void ASTDumper::visit(const StructurePattern& node) {
   impl->serializer->writeArrayStart("properties"_zc, properties.size());
   for (const auto& prop : properties) {
     impl->serializer->writeArrayElement();
-    prop.accept(*this);
+    dispatch(prop);
   }
   impl->serializer->writeArrayEnd("properties"_zc);
 
@@ -1997,7 +2021,7 @@ void ASTDumper::visit(const ArrayPattern& node) {
   impl->serializer->writeArrayStart("elements"_zc, elements.size());
   for (const auto& element : elements) {
     impl->serializer->writeArrayElement();
-    element.accept(*this);
+    dispatch(element);
   }
   impl->serializer->writeArrayEnd("elements"_zc);
 
@@ -2008,7 +2032,7 @@ void ASTDumper::visit(const IsPattern& node) {
   impl->serializer->writeNodeStart("IsPattern"_zc);
 
   impl->serializer->writeChildStart("type"_zc);
-  node.getType().accept(*this);
+  dispatch(node.getType());
   impl->serializer->writeChildEnd("type"_zc);
 
   impl->serializer->writeNodeEnd("IsPattern"_zc);
@@ -2018,7 +2042,7 @@ void ASTDumper::visit(const ExpressionPattern& node) {
   impl->serializer->writeNodeStart("ExpressionPattern"_zc);
 
   impl->serializer->writeChildStart("expression"_zc);
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   impl->serializer->writeChildEnd("expression"_zc);
 
   impl->serializer->writeNodeEnd("ExpressionPattern"_zc);
@@ -2028,16 +2052,16 @@ void ASTDumper::visit(const EnumPattern& node) {
   impl->serializer->writeNodeStart("EnumPattern"_zc);
 
   impl->serializer->writeChildStart("typeReference"_zc);
-  ZC_IF_SOME(typeReference, node.getTypeReference()) { typeReference.accept(*this); }
+  ZC_IF_SOME(typeReference, node.getTypeReference()) { dispatch(typeReference); }
   else { impl->serializer->writeNull(); }
   impl->serializer->writeChildEnd("typeReference"_zc);
 
   impl->serializer->writeChildStart("propertyName"_zc);
-  node.getPropertyName().accept(*this);
+  dispatch(node.getPropertyName());
   impl->serializer->writeChildEnd("propertyName"_zc);
 
   impl->serializer->writeChildStart("tuplePattern"_zc);
-  node.getTuplePattern().accept(*this);
+  dispatch(node.getTuplePattern());
   impl->serializer->writeChildEnd("tuplePattern"_zc);
 
   impl->serializer->writeNodeEnd("EnumPattern"_zc);
@@ -2051,7 +2075,7 @@ void ASTDumper::visit(const CaptureElement& node) {
 
   ZC_IF_SOME(id, node.getIdentifier()) {
     impl->serializer->writeChildStart("identifier"_zc);
-    id.accept(*this);
+    dispatch(id);
     impl->serializer->writeChildEnd("identifier"_zc);
   }
   impl->serializer->writeNodeEnd("CaptureElement"_zc);
@@ -19,6 +19,7 @@
 #include "zc/core/string.h"
 #include "zomlang/compiler/ast/serializer.h"
 #include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/static-visitor.h"
 #include "zomlang/compiler/ast/visitor.h"
 
 namespace zomlang {
@@ -43,14 +44,14 @@ class OptionalTypeNode;
 class TypeQueryNode;
 
 /// AST dumper class for outputting AST using pluggable serializers
-class ASTDumper final : public Visitor {
+class ASTDumper final : public Visitor, public StaticVisitor<ASTDumper> {
 public:
   explicit ASTDumper(zc::Own<Serializer> serializer) noexcept;
   ~ASTDumper() noexcept(false);
 
   ZC_DISALLOW_COPY_AND_MOVE(ASTDumper);
 
-  /// Dump a single AST node
+  /// Dump a single AST node and flush the serializer, so the output is complete on return
   void dump(const Node& node);
 
   /// Set current indentation level
@@ -40,17 +40,13 @@ public:
   /// This is a pure virtual method that must be implemented by concrete Expression subclasses
   virtual void accept(Visitor& visitor) const = 0;
 
-  /// \brief Get the syntax kind of this expression
-  /// This is a pure virtual method that must be implemented by concrete Expression subclasses
-  virtual SyntaxKind getKind() const = 0;
-
   /// \brief LLVM-style RTTI support
   /// \param node The node to check
   /// \return true if the node is an Expression or derived class
   GENERATE_CLASSOF_IMPL(Expression)
 
 protected:
-  Expression() noexcept = default;
+  explicit Expression(SyntaxKind kind) noexcept : Node(kind) {}
 };
 
 class UnaryExpression : public Expression {
@@ -63,7 +59,7 @@ public:
   GENERATE_CLASSOF_IMPL(UnaryExpression)
 
 protected:
-  UnaryExpression() noexcept = default;
+  explicit UnaryExpression(SyntaxKind kind) noexcept : Expression(kind) {}
 };
 
 class UpdateExpression : public UnaryExpression {
@@ -76,7 +72,7 @@ public:
   GENERATE_CLASSOF_IMPL(UpdateExpression)
 
 protected:
-  UpdateExpression() noexcept = default;
+  explicit UpdateExpression(SyntaxKind kind) noexcept : UnaryExpression(kind) {}
 };
 
 class PrefixUnaryExpression final : public UpdateExpression {
@@ -125,7 +121,7 @@ public:
   GENERATE_CLASSOF_IMPL(LeftHandSideExpression)
 
 protected:
-  LeftHandSideExpression() noexcept = default;
+  explicit LeftHandSideExpression(SyntaxKind kind) noexcept : UpdateExpression(kind) {}
 };
 
 class MemberExpression : public LeftHandSideExpression {
@@ -138,7 +134,7 @@ public:
   GENERATE_CLASSOF_IMPL(MemberExpression)
 
 protected:
-  MemberExpression() noexcept = default;
+  explicit MemberExpression(SyntaxKind kind) noexcept : LeftHandSideExpression(kind) {}
 };
 
 class PrimaryExpression : public MemberExpression {
@@ -151,7 +147,7 @@ public:
   GENERATE_CLASSOF_IMPL(PrimaryExpression)
 
 protected:
-  PrimaryExpression() noexcept = default;
+  explicit PrimaryExpression(SyntaxKind kind) noexcept : MemberExpression(kind) {}
 };
 
 class Identifier final : public PrimaryExpression {
@@ -272,10 +268,6 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(ThisExpression);
 
   NODE_METHOD_DECLARE();
-
-private:
-  struct Impl;
-  const zc::Own<Impl> impl;
 };
 
 class BinaryExpression final : public Expression, public Declaration {
@@ -356,7 +348,7 @@ public:
   GENERATE_CLASSOF_IMPL(LiteralExpression)
 
 protected:
-  LiteralExpression() noexcept = default;
+  explicit LiteralExpression(SyntaxKind kind) noexcept : PrimaryExpression(kind) {}
 };
 
 class LiteralExpressionImpl {
@@ -523,7 +515,7 @@ public:
   GENERATE_CLASSOF_IMPL(CastExpression)
 
 protected:
-  CastExpression() noexcept = default;
+  explicit CastExpression(SyntaxKind kind) noexcept : Expression(kind) {}
 };
 
 class CastExpressionImpl {
@@ -819,7 +811,7 @@ public:
   GENERATE_CLASSOF_IMPL(Pattern)
 
 protected:
-  Pattern() noexcept = default;
+  explicit Pattern(SyntaxKind kind) noexcept : Expression(kind) {}
 };
 
 class PrimaryPattern : public Pattern {
@@ -832,7 +824,7 @@ public:
   GENERATE_CLASSOF_IMPL(PrimaryPattern)
 
 protected:
-  PrimaryPattern() noexcept = default;
+  explicit PrimaryPattern(SyntaxKind kind) noexcept : Pattern(kind) {}
 };
 
 class WildcardPattern final : public PrimaryPattern {
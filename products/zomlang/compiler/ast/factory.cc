@@ -34,37 +34,45 @@ namespace factory {
 zc::Own<SourceFile> createSourceFile(zc::String&& fileName,
                                      zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration,
                                      zc::Vector<zc::Own<ast::Statement>>&& statements) {
+  // The source file owns the arenas, so it always lives on the heap; account for it by hand.
+  ZC_IF_SOME(stats, getCurrentAllocationStats()) {
+    const size_t resume = stats.beginNode();
+    auto sourceFile =
+        zc::heap<SourceFile>(zc::mv(fileName), zc::mv(moduleDeclaration), zc::mv(statements));
+    stats.endNode(SyntaxKind::SourceFile, sizeof(SourceFile), resume);
+    return sourceFile;
+  }
   return zc::heap<SourceFile>(zc::mv(fileName), zc::mv(moduleDeclaration), zc::mv(statements));
 }
 
 zc::Own<ModulePath> createModulePath(zc::Vector<zc::Own<ast::Identifier>>&& segments) {
-  return zc::heap<ModulePath>(zc::mv(segments));
+  return allocate<ModulePath>(zc::mv(segments));
 }
 
 zc::Own<ModuleDeclaration> createModuleDeclaration(zc::Own<ModulePath>&& modulePath) {
-  return zc::heap<ModuleDeclaration>(zc::mv(modulePath));
+  return allocate<ModuleDeclaration>(zc::mv(modulePath));
 }
 
 zc::Own<ImportSpecifier> createImportSpecifier(zc::Own<ast::Identifier>&& importedName,
                                                zc::Maybe<zc::Own<ast::Identifier>> alias) {
-  return zc::heap<ImportSpecifier>(zc::mv(importedName), zc::mv(alias));
+  return allocate<ImportSpecifier>(zc::mv(importedName), zc::mv(alias));
 }
 
 zc::Own<ImportDeclaration> createImportDeclaration(
     zc::Own<ModulePath> modulePath, zc::Maybe<zc::Own<ast::Identifier>> alias,
     zc::Vector<zc::Own<ImportSpecifier>>&& specifiers) {
-  return zc::heap<ImportDeclaration>(zc::mv(modulePath), zc::mv(alias), zc::mv(specifiers));
+  return allocate<ImportDeclaration>(zc::mv(modulePath), zc::mv(alias), zc::mv(specifiers));
 }
 
 zc::Own<ExportSpecifier> createExportSpecifier(zc::Own<ast::Identifier>&& exportedName,
                                                zc::Maybe<zc::Own<ast::Identifier>> alias) {
-  return zc::heap<ExportSpecifier>(zc::mv(exportedName), zc::mv(alias));
+  return allocate<ExportSpecifier>(zc::mv(exportedName), zc::mv(alias));
 }
 
 zc::Own<ExportDeclaration> createExportDeclaration(
     zc::Maybe<zc::Own<ModulePath>> modulePath, zc::Vector<zc::Own<ExportSpecifier>>&& specifiers,
     zc::Maybe<zc::Own<ast::Statement>> declaration) {
-  return zc::heap<ExportDeclaration>(zc::mv(modulePath), zc::mv(specifiers), zc::mv(declaration));
+  return allocate<ExportDeclaration>(zc::mv(modulePath), zc::mv(specifiers), zc::mv(declaration));
 }
 
 // Statement factory functions
@@ -72,14 +80,14 @@ zc::Own<BindingElement> createBindingElement(
     zc::Maybe<zc::Own<TokenNode>> dotDotDotToken, zc::Maybe<zc::Own<Identifier>> propertyName,
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> nameOrPattern,
     zc::Maybe<zc::Own<Expression>> initializer) {
-  return zc::heap<BindingElement>(zc::mv(dotDotDotToken), zc::mv(propertyName),
+  return allocate<BindingElement>(zc::mv(dotDotDotToken), zc::mv(propertyName),
                                   zc::mv(nameOrPattern), zc::mv(initializer));
 }
 
 zc::Own<VariableDeclaration> createVariableDeclaration(
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> name, zc::Maybe<zc::Own<TypeNode>> type,
     zc::Maybe<zc::Own<Expression>> initializer) {
-  return zc::heap<VariableDeclaration>(zc::mv(name), zc::mv(type), zc::mv(initializer));
+  return allocate<VariableDeclaration>(zc::mv(name), zc::mv(type), zc::mv(initializer));
 }
 
 zc::Own<ParameterDeclaration> createParameterDeclaration(
@@ -87,17 +95,17 @@ zc::Own<ParameterDeclaration> createParameterDeclaration(
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> name,
     zc::Maybe<zc::Own<TokenNode>> questionToken, zc::Maybe<zc::Own<TypeNode>> type,
     zc::Maybe<zc::Own<Expression>> init) {
-  return zc::heap<ParameterDeclaration>(zc::mv(modifiers), zc::mv(dotDotDotToken), zc::mv(name),
+  return allocate<ParameterDeclaration>(zc::mv(modifiers), zc::mv(dotDotDotToken), zc::mv(name),
                                         zc::mv(questionToken), zc::mv(type), zc::mv(init));
 }
 
 zc::Own<VariableDeclarationList> createVariableDeclarationList(
     zc::Vector<zc::Own<VariableDeclaration>>&& bindings) {
-  return zc::heap<VariableDeclarationList>(zc::mv(bindings));
+  return allocate<VariableDeclarationList>(zc::mv(bindings));
 }
 
 zc::Own<VariableStatement> createVariableStatement(zc::Own<VariableDeclarationList> declarations) {
-  return zc::heap<VariableStatement>(zc::mv(declarations));
+  return allocate<VariableStatement>(zc::mv(declarations));
 }
 
 zc::Own<FunctionDeclaration> createFunctionDeclaration(
@@ -105,7 +113,16 @@ zc::Own<FunctionDeclaration> createFunctionDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Own<Statement> body) {
-  return zc::heap<FunctionDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
+  return allocate<FunctionDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
+                                       zc::mv(returnType), zc::mv(body));
+}
+
+zc::Own<FunctionDeclaration> createFunctionDeclaration(
+    zc::Own<Identifier> name,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) {
+  return allocate<FunctionDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
                                        zc::mv(returnType), zc::mv(body));
 }
 
@@ -115,7 +132,18 @@ zc::Own<MethodDeclaration> createMethodDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) {
-  return zc::heap<MethodDeclaration>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+  return allocate<MethodDeclaration>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+                                     zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType),
+                                     zc::mv(body));
+}
+
+zc::Own<MethodDeclaration> createMethodDeclaration(
+    zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
+    zc::Maybe<zc::Own<ast::TokenNode>> optional,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) {
+  return allocate<MethodDeclaration>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
                                      zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType),
                                      zc::mv(body));
 }
@@ -125,7 +153,7 @@ zc::Own<GetAccessor> createGetAccessorDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) {
-  return zc::heap<GetAccessor>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
+  return allocate<GetAccessor>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
                                zc::mv(parameters), zc::mv(returnType), zc::mv(body));
 }
 
@@ -134,7 +162,7 @@ zc::Own<SetAccessor> createSetAccessorDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) {
-  return zc::heap<SetAccessor>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
+  return allocate<SetAccessor>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
                                zc::mv(parameters), zc::mv(returnType), zc::mv(body));
 }
 
@@ -143,13 +171,13 @@ zc::Own<InitDeclaration> createInitDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) {
-  return zc::heap<InitDeclaration>(zc::mv(modifiers), zc::mv(typeParameters), zc::mv(parameters),
+  return allocate<InitDeclaration>(zc::mv(modifiers), zc::mv(typeParameters), zc::mv(parameters),
                                    zc::mv(returnType), zc::mv(body));
 }
 
 zc::Own<DeinitDeclaration> createDeinitDeclaration(zc::Vector<ast::SyntaxKind> modifiers,
                                                    zc::Maybe<zc::Own<Statement>> body) {
-  return zc::heap<DeinitDeclaration>(zc::mv(modifiers), zc::mv(body));
+  return allocate<DeinitDeclaration>(zc::mv(modifiers), zc::mv(body));
 }
 
 zc::Own<MethodSignature> createMethodSignature(
@@ -158,7 +186,7 @@ zc::Own<MethodSignature> createMethodSignature(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType) {
-  return zc::heap<MethodSignature>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+  return allocate<MethodSignature>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
                                    zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType));
 }
 
@@ -167,16 +195,16 @@ zc::Own<PropertySignature> createPropertySignature(zc::Vector<ast::SyntaxKind> m
                                                    zc::Maybe<zc::Own<ast::TokenNode>> optional,
                                                    zc::Maybe<zc::Own<TypeNode>> type,
                                                    zc::Maybe<zc::Own<Expression>> initializer) {
-  return zc::heap<PropertySignature>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
+  return allocate<PropertySignature>(zc::mv(modifiers), zc::mv(name), zc::mv(optional),
                                      zc::mv(type), zc::mv(initializer));
 }
 
 zc::Own<SemicolonClassElement> createSemicolonClassElement() {
-  return zc::heap<SemicolonClassElement>();
+  return allocate<SemicolonClassElement>();
 }
 
 zc::Own<SemicolonInterfaceElement> createSemicolonInterfaceElement() {
-  return zc::heap<SemicolonInterfaceElement>();
+  return allocate<SemicolonInterfaceElement>();
 }
 
 zc::Own<ClassDeclaration> createClassDeclaration(
@@ -184,7 +212,7 @@ zc::Own<ClassDeclaration> createClassDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<ClassElement>>&& members) {
-  return zc::heap<ClassDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
+  return allocate<ClassDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
                                     zc::mv(members));
 }
 
@@ -193,7 +221,7 @@ zc::Own<InterfaceDeclaration> createInterfaceDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<InterfaceElement>>&& members) {
-  return zc::heap<InterfaceDeclaration>(zc::mv(name), zc::mv(typeParameters),
+  return allocate<InterfaceDeclaration>(zc::mv(name), zc::mv(typeParameters),
                                         zc::mv(heritageClauses), zc::mv(members));
 }
 
@@ -202,93 +230,93 @@ zc::Own<StructDeclaration> createStructDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<ClassElement>>&& body) {
-  return zc::heap<StructDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
+  return allocate<StructDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
                                      zc::mv(body));
 }
 
 zc::Own<EnumMember> createEnumMember(zc::Own<Identifier> name,
                                      zc::Maybe<zc::Own<Expression>> initializer,
                                      zc::Maybe<zc::Own<TupleTypeNode>> tupleType) {
-  return zc::heap<EnumMember>(zc::mv(name), zc::mv(initializer), zc::mv(tupleType));
+  return allocate<EnumMember>(zc::mv(name), zc::mv(initializer), zc::mv(tupleType));
 }
 
 zc::Own<EnumDeclaration> createEnumDeclaration(zc::Own<Identifier> name,
                                                zc::Vector<zc::Own<EnumMember>>&& body) {
-  return zc::heap<EnumDeclaration>(zc::mv(name), zc::mv(body));
+  return allocate<EnumDeclaration>(zc::mv(name), zc::mv(body));
 }
 
 zc::Own<ErrorDeclaration> createErrorDeclaration(zc::Own<Identifier> name,
                                                  zc::Vector<zc::Own<Statement>>&& body) {
-  return zc::heap<ErrorDeclaration>(zc::mv(name), zc::mv(body));
+  return allocate<ErrorDeclaration>(zc::mv(name), zc::mv(body));
 }
 
 zc::Own<BlockStatement> createBlockStatement(zc::Vector<zc::Own<Statement>>&& statements) {
-  return zc::heap<BlockStatement>(zc::mv(statements));
+  return allocate<BlockStatement>(zc::mv(statements));
 }
 
 zc::Own<ExpressionStatement> createExpressionStatement(zc::Own<Expression> expression) {
-  return zc::heap<ExpressionStatement>(zc::mv(expression));
+  return allocate<ExpressionStatement>(zc::mv(expression));
 }
 
 zc::Own<IfStatement> createIfStatement(zc::Own<Expression> test, zc::Own<Statement> consequent,
                                        zc::Maybe<zc::Own<Statement>> alternate) {
-  return zc::heap<IfStatement>(zc::mv(test), zc::mv(consequent), zc::mv(alternate));
+  return allocate<IfStatement>(zc::mv(test), zc::mv(consequent), zc::mv(alternate));
 }
 
 zc::Own<WhileStatement> createWhileStatement(zc::Own<Expression> test, zc::Own<Statement> body) {
-  return zc::heap<WhileStatement>(zc::mv(test), zc::mv(body));
+  return allocate<WhileStatement>(zc::mv(test), zc::mv(body));
 }
 
 zc::Own<ReturnStatement> createReturnStatement(zc::Maybe<zc::Own<Expression>> argument) {
-  return zc::heap<ReturnStatement>(zc::mv(argument));
+  return allocate<ReturnStatement>(zc::mv(argument));
 }
 
-zc::Own<EmptyStatement> createEmptyStatement() { return zc::heap<EmptyStatement>(); }
+zc::Own<EmptyStatement> createEmptyStatement() { return allocate<EmptyStatement>(); }
 
 zc::Own<MatchStatement> createMatchStatement(zc::Own<Expression> discriminant,
                                              zc::Vector<zc::Own<Statement>>&& clauses) {
-  return zc::heap<MatchStatement>(zc::mv(discriminant), zc::mv(clauses));
+  return allocate<MatchStatement>(zc::mv(discriminant), zc::mv(clauses));
 }
 
 zc::Own<ForStatement> createForStatement(zc::Maybe<zc::Own<Statement>> init,
                                          zc::Maybe<zc::Own<Expression>> condition,
                                          zc::Maybe<zc::Own<Expression>> update,
                                          zc::Own<Statement> body) {
-  return zc::heap<ForStatement>(zc::mv(init), zc::mv(condition), zc::mv(update), zc::mv(body));
+  return allocate<ForStatement>(zc::mv(init), zc::mv(condition), zc::mv(update), zc::mv(body));
 }
 
 zc::Own<ForInStatement> createForInStatement(zc::Own<Statement> initializer,
                                              zc::Own<Expression> expression,
                                              zc::Own<Statement> body) {
-  return zc::heap<ForInStatement>(zc::mv(initializer), zc::mv(expression), zc::mv(body));
+  return allocate<ForInStatement>(zc::mv(initializer), zc::mv(expression), zc::mv(body));
 }
 
 zc::Own<LabeledStatement> createLabeledStatement(zc::Own<Identifier> label,
                                                  zc::Own<Statement> statement) {
-  return zc::heap<LabeledStatement>(zc::mv(label), zc::mv(statement));
+  return allocate<LabeledStatement>(zc::mv(label), zc::mv(statement));
 }
 
 /// Expression factory functions
 zc::Own<BinaryExpression> createBinaryExpression(zc::Own<Expression> left, zc::Own<TokenNode> op,
                                                  zc::Own<Expression> right) {
-  return zc::heap<BinaryExpression>(zc::mv(left), zc::mv(op), zc::mv(right));
+  return allocate<BinaryExpression>(zc::mv(left), zc::mv(op), zc::mv(right));
 }
 
 zc::Own<PrefixUnaryExpression> createPrefixUnaryExpression(SyntaxKind op,
                                                            zc::Own<Expression> operand) {
-  return zc::heap<PrefixUnaryExpression>(zc::mv(op), zc::mv(operand));
+  return allocate<PrefixUnaryExpression>(zc::mv(op), zc::mv(operand));
 }
 
 zc::Own<PostfixUnaryExpression> createPostfixUnaryExpression(SyntaxKind op,
                                                              zc::Own<Expression> operand) {
-  return zc::heap<PostfixUnaryExpression>(zc::mv(op), zc::mv(operand));
+  return allocate<PostfixUnaryExpression>(zc::mv(op), zc::mv(operand));
 }
 
 zc::Own<ConditionalExpression> createConditionalExpression(
     zc::Own<Expression> test, zc::Maybe<zc::Own<TokenNode>> questionToken,
     zc::Own<Expression> consequent, zc::Maybe<zc::Own<TokenNode>> colonToken,
     zc::Own<Expression> alternate) {
-  return zc::heap<ConditionalExpression>(zc::mv(test), zc::mv(questionToken), zc::mv(consequent),
+  return allocate<ConditionalExpression>(zc::mv(test), zc::mv(questionToken), zc::mv(consequent),
                                          zc::mv(colonToken), zc::mv(alternate));
 }
 
@@ -296,7 +324,7 @@ zc::Own<CallExpression> createCallExpression(
     zc::Own<Expression> callee, zc::Maybe<zc::Own<TokenNode>> questionDotToken,
     zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> typeArguments,
     zc::Vector<zc::Own<Expression>>&& arguments, bool isOptionalChain) {
-  auto callExpression = zc::heap<CallExpression>(zc::mv(callee), zc::mv(questionDotToken),
+  auto callExpression = allocate<CallExpression>(zc::mv(callee), zc::mv(questionDotToken),
                                                  zc::mv(typeArguments), zc::mv(arguments));
   if (isOptionalChain) {
     callExpression->setFlags(callExpression->getFlags() | ast::NodeFlags::OptionalChain);
@@ -308,7 +336,7 @@ zc::Own<PropertyAccessExpression> createPropertyAccessExpression(
     zc::Own<LeftHandSideExpression> expression, zc::Own<Identifier> name, bool questionDot,
     bool isOptionalChain) {
   auto propertyAccessExpression =
-      zc::heap<PropertyAccessExpression>(zc::mv(expression), zc::mv(name), questionDot);
+      allocate<PropertyAccessExpression>(zc::mv(expression), zc::mv(name), questionDot);
   if (isOptionalChain) {
     propertyAccessExpression->setFlags(propertyAccessExpression->getFlags() |
                                        ast::NodeFlags::OptionalChain);
@@ -320,7 +348,7 @@ zc::Own<ElementAccessExpression> createElementAccessExpression(
     zc::Own<LeftHandSideExpression> expression, zc::Own<Expression> index, bool questionDot,
     bool isOptionalChain) {
   auto elementAccessExpression =
-      zc::heap<ElementAccessExpression>(zc::mv(expression), zc::mv(index), questionDot);
+      allocate<ElementAccessExpression>(zc::mv(expression), zc::mv(index), questionDot);
   if (isOptionalChain) {
     elementAccessExpression->setFlags(elementAccessExpression->getFlags() |
                                       ast::NodeFlags::OptionalChain);
@@ -330,45 +358,45 @@ zc::Own<ElementAccessExpression> createElementAccessExpression(
 
 zc::Own<AsExpression> createAsExpression(zc::Own<Expression> expression,
                                          zc::Own<TypeNode> targetType) {
-  return zc::heap<AsExpression>(zc::mv(expression), zc::mv(targetType));
+  return allocate<AsExpression>(zc::mv(expression), zc::mv(targetType));
 }
 
 zc::Own<ForcedAsExpression> createForcedAsExpression(zc::Own<Expression> expression,
                                                      zc::Own<TypeNode> targetType) {
-  return zc::heap<ForcedAsExpression>(zc::mv(expression), zc::mv(targetType));
+  return allocate<ForcedAsExpression>(zc::mv(expression), zc::mv(targetType));
 }
 
 zc::Own<ConditionalAsExpression> createConditionalAsExpression(zc::Own<Expression> expression,
                                                                zc::Own<TypeNode> targetType) {
-  return zc::heap<ConditionalAsExpression>(zc::mv(expression), zc::mv(targetType));
+  return allocate<ConditionalAsExpression>(zc::mv(expression), zc::mv(targetType));
 }
 
 zc::Own<VoidExpression> createVoidExpression(zc::Own<Expression> expression) {
-  return zc::heap<VoidExpression>(zc::mv(expression));
+  return allocate<VoidExpression>(zc::mv(expression));
 }
 
 zc::Own<TypeOfExpression> createTypeOfExpression(zc::Own<Expression> expression) {
-  return zc::heap<TypeOfExpression>(zc::mv(expression));
+  return allocate<TypeOfExpression>(zc::mv(expression));
 }
 
 zc::Own<AwaitExpression> createAwaitExpression(zc::Own<Expression> expression) {
-  return zc::heap<AwaitExpression>(zc::mv(expression));
+  return allocate<AwaitExpression>(zc::mv(expression));
 }
 
 zc::Own<NonNullExpression> createNonNullExpression(zc::Own<Expression> expression) {
-  return zc::heap<NonNullExpression>(zc::mv(expression));
+  return allocate<NonNullExpression>(zc::mv(expression));
 }
 
 zc::Own<ExpressionWithTypeArguments> createExpressionWithTypeArguments(
     zc::Own<LeftHandSideExpression> expression,
     zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments) {
-  return zc::heap<ExpressionWithTypeArguments>(zc::mv(expression), zc::mv(typeArguments));
+  return allocate<ExpressionWithTypeArguments>(zc::mv(expression), zc::mv(typeArguments));
 }
 
 zc::Own<CaptureElement> createCaptureElement(bool isByReference,
                                              zc::Maybe<zc::Own<Identifier>> identifier,
                                              bool isThis) {
-  return zc::heap<CaptureElement>(isByReference, zc::mv(identifier), isThis);
+  return allocate<CaptureElement>(isByReference, zc::mv(identifier), isThis);
 }
 
 zc::Own<FunctionExpression> createFunctionExpression(
@@ -376,200 +404,200 @@ zc::Own<FunctionExpression> createFunctionExpression(
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Vector<zc::Own<CaptureElement>>&& captures, zc::Maybe<zc::Own<TypeNode>> returnType,
     zc::Own<Statement> body) {
-  return zc::heap<FunctionExpression>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(captures),
+  return allocate<FunctionExpression>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(captures),
                                       zc::mv(returnType), zc::mv(body));
 }
 
 zc::Own<NewExpression> createNewExpression(zc::Own<Expression> callee,
                                            zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments,
                                            zc::Maybe<zc::Vector<zc::Own<Expression>>> arguments) {
-  return zc::heap<NewExpression>(zc::mv(callee), zc::mv(typeArguments), zc::mv(arguments));
+  return allocate<NewExpression>(zc::mv(callee), zc::mv(typeArguments), zc::mv(arguments));
 }
 
 zc::Own<ParenthesizedExpression> createParenthesizedExpression(zc::Own<Expression> expression) {
-  return zc::heap<ParenthesizedExpression>(zc::mv(expression));
+  return allocate<ParenthesizedExpression>(zc::mv(expression));
 }
 
 zc::Own<ArrayLiteralExpression> createArrayLiteralExpression(
     zc::Vector<zc::Own<Expression>>&& elements, bool multiLine) {
-  return zc::heap<ArrayLiteralExpression>(zc::mv(elements), multiLine);
+  return allocate<ArrayLiteralExpression>(zc::mv(elements), multiLine);
 }
 
 zc::Own<ObjectLiteralExpression> createObjectLiteralExpression(
     zc::Vector<zc::Own<ObjectLiteralElement>>&& properties, bool multiLine) {
-  return zc::heap<ObjectLiteralExpression>(zc::mv(properties), multiLine);
+  return allocate<ObjectLiteralExpression>(zc::mv(properties), multiLine);
 }
 
 zc::Own<PropertyAssignment> createPropertyAssignment(zc::Own<Identifier> name,
                                                      zc::Maybe<zc::Own<Expression>> initializer,
                                                      zc::Maybe<zc::Own<TokenNode>> questionToken) {
-  return zc::heap<PropertyAssignment>(zc::mv(name), zc::mv(initializer), zc::mv(questionToken));
+  return allocate<PropertyAssignment>(zc::mv(name), zc::mv(initializer), zc::mv(questionToken));
 }
 
 zc::Own<ShorthandPropertyAssignment> createShorthandPropertyAssignment(
     zc::Own<Identifier> name, zc::Maybe<zc::Own<Expression>> objectAssignmentInitializer,
     zc::Maybe<zc::Own<TokenNode>> equalsToken) {
-  return zc::heap<ShorthandPropertyAssignment>(zc::mv(name), zc::mv(objectAssignmentInitializer),
+  return allocate<ShorthandPropertyAssignment>(zc::mv(name), zc::mv(objectAssignmentInitializer),
                                                zc::mv(equalsToken));
 }
 
 zc::Own<SpreadAssignment> createSpreadAssignment(zc::Own<Expression> expression) {
-  return zc::heap<SpreadAssignment>(zc::mv(expression));
+  return allocate<SpreadAssignment>(zc::mv(expression));
 }
 
 zc::Own<SpreadElement> createSpreadElement(zc::Own<Expression> expression) {
-  return zc::heap<SpreadElement>(zc::mv(expression));
+  return allocate<SpreadElement>(zc::mv(expression));
 }
 
 zc::Own<Identifier> createIdentifier(zc::StringPtr name) {
-  return zc::heap<Identifier>(zc::mv(name));
+  return allocate<Identifier>(zc::mv(name));
 }
 
-zc::Own<Identifier> createMissingIdentifier() { return zc::heap<Identifier>(""_zc); }
+zc::Own<Identifier> createMissingIdentifier() { return allocate<Identifier>(""_zc); }
 
 zc::Own<StringLiteral> createStringLiteral(zc::StringPtr value) {
-  return zc::heap<StringLiteral>(zc::mv(value));
+  return allocate<StringLiteral>(zc::mv(value));
 }
 
 zc::Own<IntegerLiteral> createIntegerLiteral(int64_t value) {
-  return zc::heap<IntegerLiteral>(value);
+  return allocate<IntegerLiteral>(value);
 }
 
-zc::Own<FloatLiteral> createFloatLiteral(double value) { return zc::heap<FloatLiteral>(value); }
+zc::Own<FloatLiteral> createFloatLiteral(double value) { return allocate<FloatLiteral>(value); }
 
-zc::Own<BooleanLiteral> createBooleanLiteral(bool value) { return zc::heap<BooleanLiteral>(value); }
+zc::Own<BooleanLiteral> createBooleanLiteral(bool value) { return allocate<BooleanLiteral>(value); }
 
-zc::Own<NullLiteral> createNullLiteral() { return zc::heap<NullLiteral>(); }
+zc::Own<NullLiteral> createNullLiteral() { return allocate<NullLiteral>(); }
 
-zc::Own<ThisExpression> createThisExpression() { return zc::heap<ThisExpression>(); }
+zc::Own<ThisExpression> createThisExpression() { return allocate<ThisExpression>(); }
 
 zc::Own<TemplateSpan> createTemplateSpan(zc::Own<Expression> expression,
                                          zc::Own<StringLiteral> literal) {
-  return zc::heap<TemplateSpan>(zc::mv(expression), zc::mv(literal));
+  return allocate<TemplateSpan>(zc::mv(expression), zc::mv(literal));
 }
 
 zc::Own<TemplateLiteralExpression> createTemplateLiteralExpression(
     zc::Own<StringLiteral> head, zc::Vector<zc::Own<TemplateSpan>>&& spans) {
-  return zc::heap<TemplateLiteralExpression>(zc::mv(head), zc::mv(spans));
+  return allocate<TemplateLiteralExpression>(zc::mv(head), zc::mv(spans));
 }
 
 zc::Own<AliasDeclaration> createAliasDeclaration(
     zc::Own<Identifier> name,
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Own<TypeNode> type) {
-  return zc::heap<AliasDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(type));
+  return allocate<AliasDeclaration>(zc::mv(name), zc::mv(typeParameters), zc::mv(type));
 }
 
-zc::Own<DebuggerStatement> createDebuggerStatement() { return zc::heap<DebuggerStatement>(); }
+zc::Own<DebuggerStatement> createDebuggerStatement() { return allocate<DebuggerStatement>(); }
 
 // Type factory functions
 zc::Own<TypeReferenceNode> createTypeReference(
     zc::Own<Identifier> typeName, zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments) {
-  return zc::heap<TypeReferenceNode>(zc::mv(typeName), zc::mv(typeArguments));
+  return allocate<TypeReferenceNode>(zc::mv(typeName), zc::mv(typeArguments));
 }
 
 zc::Own<ArrayTypeNode> createArrayType(zc::Own<TypeNode> elementType) {
-  return zc::heap<ArrayTypeNode>(zc::mv(elementType));
+  return allocate<ArrayTypeNode>(zc::mv(elementType));
 }
 
 zc::Own<UnionTypeNode> createUnionType(zc::Vector<zc::Own<TypeNode>>&& types) {
-  return zc::heap<UnionTypeNode>(zc::mv(types));
+  return allocate<UnionTypeNode>(zc::mv(types));
 }
 
 zc::Own<IntersectionTypeNode> createIntersectionType(zc::Vector<zc::Own<TypeNode>>&& types) {
-  return zc::heap<IntersectionTypeNode>(zc::mv(types));
+  return allocate<IntersectionTypeNode>(zc::mv(types));
 }
 
 zc::Own<ParenthesizedTypeNode> createParenthesizedType(zc::Own<TypeNode> type) {
-  return zc::heap<ParenthesizedTypeNode>(zc::mv(type));
+  return allocate<ParenthesizedTypeNode>(zc::mv(type));
 }
 
 zc::Own<PredefinedTypeNode> createPredefinedType(zc::StringPtr name) {
   if (name == "bool") {
-    return zc::heap<BoolTypeNode>();
+    return allocate<BoolTypeNode>();
   } else if (name == "i8") {
-    return zc::heap<I8TypeNode>();
+    return allocate<I8TypeNode>();
   } else if (name == "i16") {
-    return zc::heap<I16TypeNode>();
+    return allocate<I16TypeNode>();
   } else if (name == "i32") {
-    return zc::heap<I32TypeNode>();
+    return allocate<I32TypeNode>();
   } else if (name == "i64") {
-    return zc::heap<I64TypeNode>();
+    return allocate<I64TypeNode>();
   } else if (name == "u8") {
-    return zc::heap<U8TypeNode>();
+    return allocate<U8TypeNode>();
   } else if (name == "u16") {
-    return zc::heap<U16TypeNode>();
+    return allocate<U16TypeNode>();
   } else if (name == "u32") {
-    return zc::heap<U32TypeNode>();
+    return allocate<U32TypeNode>();
   } else if (name == "u64") {
-    return zc::heap<U64TypeNode>();
+    return allocate<U64TypeNode>();
   } else if (name == "f32") {
-    return zc::heap<F32TypeNode>();
+    return allocate<F32TypeNode>();
   } else if (name == "f64") {
-    return zc::heap<F64TypeNode>();
+    return allocate<F64TypeNode>();
   } else if (name == "str") {
-    return zc::heap<StrTypeNode>();
+    return allocate<StrTypeNode>();
   } else if (name == "unit") {
-    return zc::heap<UnitTypeNode>();
+    return allocate<UnitTypeNode>();
   } else if (name == "null") {
-    return zc::heap<NullTypeNode>();
+    return allocate<NullTypeNode>();
   } else {
     ZC_UNREACHABLE;
   }
 }
 
 zc::Own<ObjectTypeNode> createObjectType(zc::Vector<zc::Own<Node>>&& members) {
-  return zc::heap<ObjectTypeNode>(zc::mv(members));
+  return allocate<ObjectTypeNode>(zc::mv(members));
 }
 
 zc::Own<TupleTypeNode> createTupleType(zc::Vector<zc::Own<TypeNode>>&& elementTypes) {
-  return zc::heap<TupleTypeNode>(zc::mv(elementTypes));
+  return allocate<TupleTypeNode>(zc::mv(elementTypes));
 }
 
 zc::Own<ReturnTypeNode> createReturnType(zc::Own<TypeNode> type,
                                          zc::Maybe<zc::Own<TypeNode>> errorType) {
-  return zc::heap<ReturnTypeNode>(zc::mv(type), zc::mv(errorType));
+  return allocate<ReturnTypeNode>(zc::mv(type), zc::mv(errorType));
 }
 
 zc::Own<FunctionTypeNode> createFunctionType(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters, zc::Own<ReturnTypeNode> returnType) {
-  return zc::heap<FunctionTypeNode>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType));
+  return allocate<FunctionTypeNode>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType));
 }
 
 zc::Own<TypeParameterDeclaration> createTypeParameterDeclaration(
     zc::Own<Identifier> name, zc::Maybe<zc::Own<TypeNode>> constraint) {
-  return zc::heap<TypeParameterDeclaration>(zc::mv(name), zc::mv(constraint));
+  return allocate<TypeParameterDeclaration>(zc::mv(name), zc::mv(constraint));
 }
 
 zc::Own<OptionalTypeNode> createOptionalType(zc::Own<TypeNode> type) {
-  return zc::heap<OptionalTypeNode>(zc::mv(type));
+  return allocate<OptionalTypeNode>(zc::mv(type));
 }
 
 zc::Own<TypeQueryNode> createTypeQuery(zc::Own<Expression> expr) {
-  return zc::heap<TypeQueryNode>(zc::mv(expr));
+  return allocate<TypeQueryNode>(zc::mv(expr));
 }
 
 zc::Own<NamedTupleElement> createNamedTupleElement(zc::Own<Identifier> name,
                                                    zc::Own<TypeNode> type) {
-  return zc::heap<NamedTupleElement>(zc::mv(name), zc::mv(type));
+  return allocate<NamedTupleElement>(zc::mv(name), zc::mv(type));
 }
 
 zc::Own<BreakStatement> createBreakStatement(zc::Maybe<zc::Own<Identifier>> label) {
   if (label == zc::none) {
-    return zc::heap<BreakStatement>(zc::none);
+    return allocate<BreakStatement>(zc::none);
   } else {
-    ZC_IF_SOME(labelPtr, label) { return zc::heap<BreakStatement>(zc::mv(labelPtr)); }
-    return zc::heap<BreakStatement>(zc::none);
+    ZC_IF_SOME(labelPtr, label) { return allocate<BreakStatement>(zc::mv(labelPtr)); }
+    return allocate<BreakStatement>(zc::none);
   }
 }
 
 zc::Own<ContinueStatement> createContinueStatement(zc::Maybe<zc::Own<Identifier>> label) {
   if (label == zc::none) {
-    return zc::heap<ContinueStatement>(zc::none);
+    return allocate<ContinueStatement>(zc::none);
   } else {
-    ZC_IF_SOME(labelPtr, label) { return zc::heap<ContinueStatement>(zc::mv(labelPtr)); }
-    return zc::heap<ContinueStatement>(zc::none);
+    ZC_IF_SOME(labelPtr, label) { return allocate<ContinueStatement>(zc::mv(labelPtr)); }
+    return allocate<ContinueStatement>(zc::none);
   }
 }
 
@@ -577,36 +605,36 @@ zc::Own<ContinueStatement> createContinueStatement(zc::Maybe<zc::Own<Identifier>
 // Note: PrimaryPattern is a base class, typically not instantiated directly
 // This function is temporarily disabled
 // zc::Own<PrimaryPattern> createPrimaryPattern(zc::Own<Expression> expression) {
-//   return zc::heap<PrimaryPattern>();
+//   return allocate<PrimaryPattern>();
 // }
 
 zc::Own<WildcardPattern> createWildcardPattern(zc::Maybe<zc::Own<TypeNode>> typeAnnotation) {
-  return zc::heap<WildcardPattern>(zc::mv(typeAnnotation));
+  return allocate<WildcardPattern>(zc::mv(typeAnnotation));
 }
 
 zc::Own<IdentifierPattern> createIdentifierPattern(zc::Own<Identifier> identifier,
                                                    zc::Maybe<zc::Own<TypeNode>> typeAnnotation) {
-  return zc::heap<IdentifierPattern>(zc::mv(identifier), zc::mv(typeAnnotation));
+  return allocate<IdentifierPattern>(zc::mv(identifier), zc::mv(typeAnnotation));
 }
 
 zc::Own<TuplePattern> createTuplePattern(zc::Vector<zc::Own<Pattern>>&& elements) {
-  return zc::heap<TuplePattern>(zc::mv(elements));
+  return allocate<TuplePattern>(zc::mv(elements));
 }
 
 zc::Own<StructurePattern> createStructurePattern(zc::Vector<zc::Own<Pattern>>&& fields) {
-  return zc::heap<StructurePattern>(zc::mv(fields));
+  return allocate<StructurePattern>(zc::mv(fields));
 }
 
 zc::Own<ArrayPattern> createArrayPattern(zc::Vector<zc::Own<Pattern>>&& elements) {
-  return zc::heap<ArrayPattern>(zc::mv(elements));
+  return allocate<ArrayPattern>(zc::mv(elements));
 }
 
 zc::Own<IsPattern> createIsPattern(zc::Own<TypeNode> type) {
-  return zc::heap<IsPattern>(zc::mv(type));
+  return allocate<IsPattern>(zc::mv(type));
 }
 
 zc::Own<ExpressionPattern> createExpressionPattern(zc::Own<Expression> expression) {
-  return zc::heap<ExpressionPattern>(zc::mv(expression));
+  return allocate<ExpressionPattern>(zc::mv(expression));
 }
 
 zc::Own<EnumPattern> createEnumPattern(zc::Maybe<zc::Own<TypeReferenceNode>> typeReference,
@@ -617,50 +645,50 @@ zc::Own<EnumPattern> createEnumPattern(zc::Maybe<zc::Own<TypeReferenceNode>> typ
 
   zc::Own<TuplePattern> tuple;
   ZC_IF_SOME(tp, tuplePattern) { tuple = zc::mv(tp); }
-  else { tuple = zc::heap<TuplePattern>(zc::Vector<zc::Own<Pattern>>()); }
+  else { tuple = allocate<TuplePattern>(zc::Vector<zc::Own<Pattern>>()); }
 
-  return zc::heap<EnumPattern>(zc::mv(typeRef), zc::mv(propertyName), zc::mv(tuple));
+  return allocate<EnumPattern>(zc::mv(typeRef), zc::mv(propertyName), zc::mv(tuple));
 }
 
 zc::Own<PatternProperty> createPatternProperty(zc::Own<Identifier> name,
                                                zc::Maybe<zc::Own<Pattern>> pattern) {
-  return zc::heap<PatternProperty>(zc::mv(name), zc::mv(pattern));
+  return allocate<PatternProperty>(zc::mv(name), zc::mv(pattern));
 }
 
 // Match clause factory functions
 zc::Own<MatchClause> createMatchClause(zc::Own<Pattern> pattern,
                                        zc::Maybe<zc::Own<Expression>> guard,
                                        zc::Own<Statement> body) {
-  return zc::heap<MatchClause>(zc::mv(pattern), zc::mv(guard), zc::mv(body));
+  return allocate<MatchClause>(zc::mv(pattern), zc::mv(guard), zc::mv(body));
 }
 
 zc::Own<DefaultClause> createDefaultClause(zc::Vector<zc::Own<Statement>>&& statements) {
-  return zc::heap<DefaultClause>(zc::mv(statements));
+  return allocate<DefaultClause>(zc::mv(statements));
 }
 
 zc::Own<ArrayBindingPattern> createArrayBindingPattern(
     zc::Vector<zc::Own<BindingElement>>&& elements) {
-  return zc::heap<ArrayBindingPattern>(zc::mv(elements));
+  return allocate<ArrayBindingPattern>(zc::mv(elements));
 }
 
 zc::Own<ObjectBindingPattern> createObjectBindingPattern(
     zc::Vector<zc::Own<BindingElement>>&& elements) {
-  return zc::heap<ObjectBindingPattern>(zc::mv(elements));
+  return allocate<ObjectBindingPattern>(zc::mv(elements));
 }
 
 // Token node factory functions for operators
-zc::Own<TokenNode> createTokenNode(SyntaxKind kind) { return zc::heap<TokenNode>(kind); }
+zc::Own<TokenNode> createTokenNode(SyntaxKind kind) { return allocate<TokenNode>(kind); }
 
 zc::Own<HeritageClause> createHeritageClause(
     SyntaxKind token, zc::Vector<zc::Own<ExpressionWithTypeArguments>>&& types) {
-  return zc::heap<HeritageClause>(token, zc::mv(types));
+  return allocate<HeritageClause>(token, zc::mv(types));
 }
 
 zc::Own<PropertyDeclaration> createPropertyDeclaration(zc::Vector<ast::SyntaxKind> modifiers,
                                                        zc::Own<Identifier> name,
                                                        zc::Maybe<zc::Own<TypeNode>> type,
                                                        zc::Maybe<zc::Own<Expression>> initializer) {
-  return zc::heap<PropertyDeclaration>(zc::mv(modifiers), zc::mv(name), zc::mv(type),
+  return allocate<PropertyDeclaration>(zc::mv(modifiers), zc::mv(name), zc::mv(type),
                                        zc::mv(initializer));
 }
 
@@ -139,7 +139,8 @@ class ArrayBindingPattern;
 class ObjectBindingPattern;
 
 namespace factory {
-/// Create a new SourceFile Node.
+/// Create a new SourceFile Node. The node itself always lives on the heap, so that it can adopt the
+/// arena its children were allocated from.
 zc::Own<SourceFile> createSourceFile(zc::String&& fileName,
                                      zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration,
                                      zc::Vector<zc::Own<ast::Statement>>&& statements);
@@ -153,7 +154,7 @@ const ast::NodeList<Node> createNodeList(zc::Vector<zc::Own<Node>>&& list) {
 template <typename Node, typename... Args>
   requires std::is_base_of_v<ast::Node, Node>
 zc::Own<Node> createNodeWithRange(const source::SourceRange& range, Args&&... args) {
-  zc::Own<Node> node = zc::heap<Node>(zc::fwd<Args>(args)...);
+  zc::Own<Node> node = allocate<Node>(zc::fwd<Args>(args)...);
   node->setSourceRange(range);
   return node;  // NRVO optimization
 }
@@ -206,6 +207,12 @@ zc::Own<FunctionDeclaration> createFunctionDeclaration(
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Own<Statement> body);
 
+zc::Own<FunctionDeclaration> createFunctionDeclaration(
+    zc::Own<Identifier> name,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body);
+
 zc::Own<MethodDeclaration> createMethodDeclaration(
     zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
     zc::Maybe<zc::Own<ast::TokenNode>> optional,
@@ -213,6 +220,13 @@ zc::Own<MethodDeclaration> createMethodDeclaration(
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body);
 
+zc::Own<MethodDeclaration> createMethodDeclaration(
+    zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
+    zc::Maybe<zc::Own<ast::TokenNode>> optional,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body);
+
 zc::Own<GetAccessor> createGetAccessorDeclaration(
     zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
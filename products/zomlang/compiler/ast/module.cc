@@ -29,26 +29,19 @@ namespace ast {
 
 // ================================================================================
 // SourceFile::Impl
-struct SourceFile::Impl : private NodeImpl {
+struct SourceFile::Impl {
   Impl(zc::String&& fileName, zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration,
        zc::Vector<zc::Own<ast::Statement>>&& statements) noexcept
-      : NodeImpl(SyntaxKind::SourceFile),
-        fileName(zc::mv(fileName)),
+      : fileName(zc::mv(fileName)),
         moduleDeclaration(zc::mv(moduleDeclaration)),
         statements(zc::mv(statements)) {}
 
   /// Identifier of the module buffer.
   const zc::String fileName;
   /// Module declaration.
-  const zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration;
+  zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration;
   /// List of toplevel statements in the module.
-  const NodeList<ast::Statement> statements;
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  NodeList<ast::Statement> statements;
 };
 
 // ================================================================================
@@ -56,8 +49,8 @@ struct SourceFile::Impl : private NodeImpl {
 SourceFile::SourceFile(zc::String&& fileName,
                        zc::Maybe<zc::Own<ModuleDeclaration>> moduleDeclaration,
                        zc::Vector<zc::Own<ast::Statement>>&& statements) noexcept
-    : Node(),
-      impl(zc::heap<Impl>(zc::mv(fileName), zc::mv(moduleDeclaration), zc::mv(statements))) {}
+    : Node(SyntaxKind::SourceFile),
+      impl(allocate<Impl>(zc::mv(fileName), zc::mv(moduleDeclaration), zc::mv(statements))) {}
 
 SourceFile::~SourceFile() noexcept(false) = default;
 
@@ -70,108 +63,79 @@ const NodeList<Statement>& SourceFile::getStatements() const { return impl->stat
 
 zc::StringPtr SourceFile::getFileName() const { return impl->fileName; }
 
-SyntaxKind SourceFile::getKind() const { return SyntaxKind::SourceFile; }
+void SourceFile::adoptArena(zc::Own<zc::Arena> arena) { arenas.add(zc::mv(arena)); }
 
-NodeFlags SourceFile::getFlags() const { return NodeFlags::None; }
-void SourceFile::setFlags(NodeFlags flags) {}
+size_t SourceFile::getArenaBytes() const {
+  size_t total = 0;
+  for (const zc::Own<zc::Arena>& arena : arenas) { total += arena->getChunkBytes(); }
+  return total;
+}
 
-void SourceFile::accept(Visitor& visitor) const { visitor.visit(*this); }
+basic::MemoryUsage SourceFile::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addVector(arenas);
+  for (const zc::Own<zc::Arena>& arena : arenas) {
+    usage.addObject<zc::Arena>();
+    usage.addArena(*arena);
+  }
+  return usage;
+}
 
-void SourceFile::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
+zc::Maybe<zc::Own<ModuleDeclaration>> SourceFile::releaseModuleDeclaration() {
+  return zc::mv(impl->moduleDeclaration);
 }
 
-const source::SourceRange& SourceFile::getSourceRange() const { return impl->getSourceRange(); }
+zc::Vector<zc::Own<Statement>> SourceFile::releaseStatements() {
+  return impl->statements.release();
+}
 
-struct ModuleDeclaration::Impl : private NodeImpl {
-  explicit Impl(zc::Own<ModulePath>&& modulePath) noexcept
-      : NodeImpl(SyntaxKind::ModuleDeclaration), modulePath(zc::mv(modulePath)) {}
+zc::Vector<zc::Own<zc::Arena>> SourceFile::releaseArenas() { return zc::mv(arenas); }
 
-  const zc::Own<ModulePath> modulePath;
+void SourceFile::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+struct ModuleDeclaration::Impl {
+  explicit Impl(zc::Own<ModulePath>&& modulePath) noexcept : modulePath(zc::mv(modulePath)) {}
+
+  const zc::Own<ModulePath> modulePath;
 };
 
 ModuleDeclaration::ModuleDeclaration(zc::Own<ModulePath>&& modulePath) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(modulePath))) {}
+    : Statement(SyntaxKind::ModuleDeclaration), impl(allocate<Impl>(zc::mv(modulePath))) {}
 
 ModuleDeclaration::~ModuleDeclaration() noexcept(false) = default;
 
 const ModulePath& ModuleDeclaration::getModulePath() const { return *impl->modulePath; }
 
-SyntaxKind ModuleDeclaration::getKind() const { return impl->getKind(); }
-
-NodeFlags ModuleDeclaration::getFlags() const { return impl->getFlags(); }
-void ModuleDeclaration::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void ModuleDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ModuleDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ModuleDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-struct ModulePath::Impl : private NodeImpl {
+struct ModulePath::Impl {
   explicit Impl(zc::Vector<zc::Own<ast::Identifier>>&& segments) noexcept
-      : NodeImpl(SyntaxKind::ModulePath), segments(zc::mv(segments)) {}
+      : segments(zc::mv(segments)) {}
 
   const NodeList<ast::Identifier> segments;
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 ModulePath::ModulePath(zc::Vector<zc::Own<ast::Identifier>>&& segments) noexcept
-    : Node(), impl(zc::heap<Impl>(zc::mv(segments))) {}
+    : Node(SyntaxKind::ModulePath), impl(allocate<Impl>(zc::mv(segments))) {}
 
 ModulePath::~ModulePath() noexcept(false) = default;
 
 const NodeList<ast::Identifier>& ModulePath::getSegments() const { return impl->segments; }
 
-SyntaxKind ModulePath::getKind() const { return SyntaxKind::ModulePath; }
-
-NodeFlags ModulePath::getFlags() const { return NodeFlags::None; }
-void ModulePath::setFlags(NodeFlags flags) {}
-
 void ModulePath::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void ModulePath::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ModulePath::getSourceRange() const { return impl->getSourceRange(); }
-
-struct ImportSpecifier::Impl : private NodeImpl {
+struct ImportSpecifier::Impl {
   Impl(zc::Own<ast::Identifier>&& importedName, zc::Maybe<zc::Own<ast::Identifier>> alias) noexcept
-      : NodeImpl(SyntaxKind::ImportSpecifier),
-        importedName(zc::mv(importedName)),
-        alias(zc::mv(alias)) {}
+      : importedName(zc::mv(importedName)), alias(zc::mv(alias)) {}
 
   const zc::Own<ast::Identifier> importedName;
   const zc::Maybe<zc::Own<ast::Identifier>> alias;
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 ImportSpecifier::ImportSpecifier(zc::Own<ast::Identifier>&& importedName,
                                  zc::Maybe<zc::Own<ast::Identifier>> alias) noexcept
-    : Node(), impl(zc::heap<Impl>(zc::mv(importedName), zc::mv(alias))) {}
+    : Node(SyntaxKind::ImportSpecifier),
+      impl(allocate<Impl>(zc::mv(importedName), zc::mv(alias))) {}
 
 ImportSpecifier::~ImportSpecifier() noexcept(false) = default;
 
@@ -182,44 +146,23 @@ zc::Maybe<const ast::Identifier&> ImportSpecifier::getAlias() const {
   return zc::none;
 }
 
-SyntaxKind ImportSpecifier::getKind() const { return impl->getKind(); }
-
-NodeFlags ImportSpecifier::getFlags() const { return impl->getFlags(); }
-void ImportSpecifier::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void ImportSpecifier::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ImportSpecifier::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ImportSpecifier::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-struct ImportDeclaration::Impl : private NodeImpl {
+struct ImportDeclaration::Impl {
   Impl(zc::Own<ModulePath>&& modulePath, zc::Maybe<zc::Own<ast::Identifier>> alias,
        zc::Vector<zc::Own<ImportSpecifier>>&& specifiers) noexcept
-      : NodeImpl(SyntaxKind::ImportDeclaration),
-        modulePath(zc::mv(modulePath)),
-        alias(zc::mv(alias)),
-        specifiers(zc::mv(specifiers)) {}
+      : modulePath(zc::mv(modulePath)), alias(zc::mv(alias)), specifiers(zc::mv(specifiers)) {}
 
   const zc::Own<ModulePath> modulePath;
   const zc::Maybe<zc::Own<ast::Identifier>> alias;
   const NodeList<ImportSpecifier> specifiers;
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 ImportDeclaration::ImportDeclaration(zc::Own<ModulePath>&& modulePath,
                                      zc::Maybe<zc::Own<ast::Identifier>> alias,
                                      zc::Vector<zc::Own<ImportSpecifier>>&& specifiers) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(modulePath), zc::mv(alias), zc::mv(specifiers))) {}
+    : Statement(SyntaxKind::ImportDeclaration),
+      impl(allocate<Impl>(zc::mv(modulePath), zc::mv(alias), zc::mv(specifiers))) {}
 
 ImportDeclaration::~ImportDeclaration() noexcept(false) = default;
 
@@ -238,42 +181,20 @@ bool ImportDeclaration::isModuleImport() const { return impl->specifiers.size()
 
 bool ImportDeclaration::isNamedImport() const { return impl->specifiers.size() > 0; }
 
-SyntaxKind ImportDeclaration::getKind() const { return impl->getKind(); }
-
-NodeFlags ImportDeclaration::getFlags() const { return impl->getFlags(); }
-void ImportDeclaration::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void ImportDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ImportDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ImportDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-struct ExportSpecifier::Impl : private NodeImpl {
+struct ExportSpecifier::Impl {
   Impl(zc::Own<ast::Identifier>&& exportedName, zc::Maybe<zc::Own<ast::Identifier>> alias) noexcept
-      : NodeImpl(SyntaxKind::ExportSpecifier),
-        exportedName(zc::mv(exportedName)),
-        alias(zc::mv(alias)) {}
+      : exportedName(zc::mv(exportedName)), alias(zc::mv(alias)) {}
 
   const zc::Own<ast::Identifier> exportedName;
   const zc::Maybe<zc::Own<ast::Identifier>> alias;
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 ExportSpecifier::ExportSpecifier(zc::Own<ast::Identifier>&& exportedName,
                                  zc::Maybe<zc::Own<ast::Identifier>> alias) noexcept
-    : Node(), impl(zc::heap<Impl>(zc::mv(exportedName), zc::mv(alias))) {}
+    : Node(SyntaxKind::ExportSpecifier),
+      impl(allocate<Impl>(zc::mv(exportedName), zc::mv(alias))) {}
 
 ExportSpecifier::~ExportSpecifier() noexcept(false) = default;
 
@@ -284,45 +205,25 @@ zc::Maybe<const ast::Identifier&> ExportSpecifier::getAlias() const {
   return zc::none;
 }
 
-SyntaxKind ExportSpecifier::getKind() const { return impl->getKind(); }
-
-NodeFlags ExportSpecifier::getFlags() const { return impl->getFlags(); }
-void ExportSpecifier::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void ExportSpecifier::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ExportSpecifier::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ExportSpecifier::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-struct ExportDeclaration::Impl : private NodeImpl {
+struct ExportDeclaration::Impl {
   Impl(zc::Maybe<zc::Own<ModulePath>> modulePath, zc::Vector<zc::Own<ExportSpecifier>>&& specifiers,
        zc::Maybe<zc::Own<ast::Statement>> declaration) noexcept
-      : NodeImpl(SyntaxKind::ExportDeclaration),
-        modulePath(zc::mv(modulePath)),
+      : modulePath(zc::mv(modulePath)),
         specifiers(zc::mv(specifiers)),
         declaration(zc::mv(declaration)) {}
 
   const zc::Maybe<zc::Own<ModulePath>> modulePath;
   const NodeList<ExportSpecifier> specifiers;
   const zc::Maybe<zc::Own<ast::Statement>> declaration;
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 ExportDeclaration::ExportDeclaration(zc::Maybe<zc::Own<ModulePath>> modulePath,
                                      zc::Vector<zc::Own<ExportSpecifier>>&& specifiers,
                                      zc::Maybe<zc::Own<ast::Statement>> declaration) noexcept
-    : Statement(),
-      impl(zc::heap<Impl>(zc::mv(modulePath), zc::mv(specifiers), zc::mv(declaration))) {}
+    : Statement(SyntaxKind::ExportDeclaration),
+      impl(allocate<Impl>(zc::mv(modulePath), zc::mv(specifiers), zc::mv(declaration))) {}
 
 ExportDeclaration::~ExportDeclaration() noexcept(false) = default;
 
@@ -348,21 +249,6 @@ bool ExportDeclaration::isReExport() const { return impl->modulePath != zc::none
 
 bool ExportDeclaration::isDeclarationExport() const { return impl->declaration != zc::none; }
 
-SyntaxKind ExportDeclaration::getKind() const { return impl->getKind(); }
-
-NodeFlags ExportDeclaration::getFlags() const { return impl->getFlags(); }
-void ExportDeclaration::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void ExportDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ExportDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ExportDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 }  // namespace ast
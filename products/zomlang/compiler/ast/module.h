@@ -18,6 +18,7 @@
 #include "zc/core/memory.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 #include "zomlang/compiler/ast/ast.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/statement.h"
@@ -55,11 +56,32 @@ public:
   const NodeList<Statement>& getStatements() const;
   zc::StringPtr getFileName() const;
 
+  /// \brief Take ownership of an arena this tree's nodes were allocated from, so that dropping
+  /// the SourceFile destroys the nodes and then frees the arenas in one go. A tree parsed in
+  /// chunks has one arena per chunk.
+  void adoptArena(zc::Own<zc::Arena> arena);
+  /// \brief Heap bytes held by the adopted arenas.
+  size_t getArenaBytes() const;
+  /// \brief Measure the adopted arenas, which hold the nodes and their implementation objects.
+  /// Child lists grow on the heap and a tree parsed without an arena lives there entirely; neither
+  /// is counted, but `AllocationStats` covers both when recorded during the parse.
+  basic::MemoryUsage getMemoryUsage() const;
+
+  /// \brief Move the module declaration, the statements and the adopted arenas out, leaving an
+  /// empty file. The nodes still live in the arenas, so whoever takes them must keep both.
+  /// Incremental reparsing carries unchanged statements over to the new tree this way.
+  zc::Maybe<zc::Own<ModuleDeclaration>> releaseModuleDeclaration();
+  zc::Vector<zc::Own<Statement>> releaseStatements();
+  zc::Vector<zc::Own<zc::Arena>> releaseArenas();
+
   NODE_METHOD_DECLARE();
 
   ZC_DISALLOW_COPY_AND_MOVE(SourceFile);
 
 private:
+  /// Declared before `impl` so that it outlives every node in the tree.
+  zc::Vector<zc::Own<zc::Arena>> arenas;
+
   struct Impl;
   zc::Own<Impl> impl;
 };
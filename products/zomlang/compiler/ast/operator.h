@@ -14,8 +14,12 @@
 
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 
+#include "zomlang/compiler/ast/kinds.h"
+
 namespace zomlang {
 namespace compiler {
 
@@ -61,6 +65,64 @@ enum class OperatorType { kBinary, kUnary, kAssignment, kUpdate };
 // Unary operators: +, -, !, ~, ++, --
 // Assignment operators: =, +=, -=, *=, /=, %=, &=, |=, ^=, <<=, >>=
 
+/// \brief How the binary expression parser treats a token in operator position.
+struct BinaryOperatorInfo {
+  /// kLowest for tokens that do not continue a binary expression
+  OperatorPrecedence precedence = OperatorPrecedence::kLowest;
+  OperatorAssociativity associativity = OperatorAssociativity::kNone;
+  /// Kind of the node the operator builds, SyntaxKind::Unknown for non-operators
+  SyntaxKind nodeKind = SyntaxKind::Unknown;
+};
+
+namespace _ {  // Private implementation details
+
+constexpr std::array<BinaryOperatorInfo, static_cast<size_t>(SyntaxKind::Count)>
+makeBinaryOperatorTable() {
+  std::array<BinaryOperatorInfo, static_cast<size_t>(SyntaxKind::Count)> table{};
+  auto set = [&](SyntaxKind kind, OperatorPrecedence precedence,
+                 OperatorAssociativity associativity = OperatorAssociativity::kLeft,
+                 SyntaxKind nodeKind = SyntaxKind::BinaryExpression) {
+    table[static_cast<size_t>(kind)] = {precedence, associativity, nodeKind};
+  };
+
+  set(SyntaxKind::BarBar, OperatorPrecedence::kLogicalOr);
+  set(SyntaxKind::QuestionQuestion, OperatorPrecedence::kLogicalOr);
+  set(SyntaxKind::AmpersandAmpersand, OperatorPrecedence::kLogicalAnd);
+  set(SyntaxKind::Bar, OperatorPrecedence::kBitwiseOr);
+  set(SyntaxKind::Caret, OperatorPrecedence::kBitwiseXor);
+  set(SyntaxKind::Ampersand, OperatorPrecedence::kBitwiseAnd);
+  set(SyntaxKind::EqualsEquals, OperatorPrecedence::kEquality);
+  set(SyntaxKind::ExclamationEquals, OperatorPrecedence::kEquality);
+  set(SyntaxKind::LessThan, OperatorPrecedence::kRelational);
+  set(SyntaxKind::GreaterThan, OperatorPrecedence::kRelational);
+  set(SyntaxKind::LessThanEquals, OperatorPrecedence::kRelational);
+  set(SyntaxKind::GreaterThanEquals, OperatorPrecedence::kRelational);
+  // `as` binds like a relational operator but takes a type, building one of the cast nodes.
+  set(SyntaxKind::AsKeyword, OperatorPrecedence::kRelational, OperatorAssociativity::kLeft,
+      SyntaxKind::AsExpression);
+  set(SyntaxKind::LessThanLessThan, OperatorPrecedence::kShift);
+  set(SyntaxKind::GreaterThanGreaterThan, OperatorPrecedence::kShift);
+  set(SyntaxKind::GreaterThanGreaterThanGreaterThan, OperatorPrecedence::kShift);
+  set(SyntaxKind::Plus, OperatorPrecedence::kAdditive);
+  set(SyntaxKind::Minus, OperatorPrecedence::kAdditive);
+  set(SyntaxKind::Asterisk, OperatorPrecedence::kMultiplicative);
+  set(SyntaxKind::Slash, OperatorPrecedence::kMultiplicative);
+  set(SyntaxKind::Percent, OperatorPrecedence::kMultiplicative);
+  set(SyntaxKind::AsteriskAsterisk, OperatorPrecedence::kExponentiation,
+      OperatorAssociativity::kRight);
+  return table;
+}
+
+inline constexpr auto kBinaryOperatorTable = makeBinaryOperatorTable();
+
+}  // namespace _
+
+/// \brief Binary operator properties of a token kind, built at compile time so the expression
+/// parser looks them up with a single load.
+constexpr const BinaryOperatorInfo& getBinaryOperatorInfo(SyntaxKind kind) {
+  return _::kBinaryOperatorTable[static_cast<size_t>(kind)];
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,8 +14,6 @@
 
 #include "zomlang/compiler/ast/serializer.h"
 
-#include <cstdio>
-
 #include "zc/core/debug.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
@@ -26,22 +24,60 @@ namespace zomlang {
 namespace compiler {
 namespace ast {
 
+namespace {
+
+constexpr char kIndentSpaces[] = "                                ";
+
+/// Buffered sink shared by the serializers. Fragments are copied straight into one reusable
+/// buffer, so a dump neither formats temporary strings nor issues a write to the underlying
+/// stream per fragment.
+class StreamWriter {
+public:
+  explicit StreamWriter(zc::OutputStream& output) : buffered(output) {}
+
+  template <typename... Rest>
+  void write(zc::StringPtr first, Rest&&... rest) {
+    buffered.write(first.asBytes());
+    if constexpr (sizeof...(rest) > 0) { write(zc::fwd<Rest>(rest)...); }
+  }
+
+  void writeIndent(int level) {
+    size_t width = level > 0 ? static_cast<size_t>(level) * 2 : 0;
+    while (width > 0) {
+      size_t chunk = zc::min(width, sizeof(kIndentSpaces) - 1);
+      buffered.write(zc::arrayPtr(kIndentSpaces, chunk).asBytes());
+      width -= chunk;
+    }
+  }
+
+  void writeJsonEscaped(zc::StringPtr text) { basic::writeJsonEscaped(buffered, text); }
+  void writeXmlEscaped(zc::StringPtr text) { basic::writeXmlEscaped(buffered, text); }
+
+  void flush() { buffered.flush(); }
+
+private:
+  zc::BufferedOutputStreamWrapper buffered;
+};
+
+}  // namespace
+
 // JSONSerializer implementation
 struct JSONSerializer::Impl {
-  zc::OutputStream& output;
+  StreamWriter writer;
   int indentLevel = 0;
   zc::Vector<bool> firstPropertyStack;  // Stack to track firstProperty state for nested objects
 
-  explicit Impl(zc::OutputStream& out) : output(out) {
+  explicit Impl(zc::OutputStream& out) : writer(out) {
     firstPropertyStack.add(true);  // Root level starts as first property
   }
 
-  void write(zc::StringPtr str) { output.write(str.asBytes()); }
-
-  void writeIndent() {
-    for (int i = 0; i < indentLevel; ++i) { write("  "); }
+  template <typename... Params>
+  void write(Params&&... params) {
+    writer.write(zc::fwd<Params>(params)...);
   }
 
+  void writeIndent() { writer.writeIndent(indentLevel); }
+
   bool& currentFirstProperty() {
     ZC_ASSERT(!firstPropertyStack.empty(), "firstPropertyStack should never be empty");
     return firstPropertyStack.back();
@@ -84,15 +120,16 @@ void JSONSerializer::writeProperty(const zc::StringPtr name, const zc::StringPtr
   if (!impl->currentFirstProperty()) { impl->write(",\n"); }
   impl->currentFirstProperty() = false;
   impl->writeIndent();
-  zc::String escapedValue = basic::escapeJsonString(value);
-  impl->write(zc::str("\"", name, "\": \"", escapedValue, "\""));
+  impl->write("\"", name, "\": \"");
+  impl->writer.writeJsonEscaped(value);
+  impl->write("\"");
 }
 
 void JSONSerializer::writeChildStart(const zc::StringPtr name) {
   if (!impl->currentFirstProperty()) { impl->write(",\n"); }
   impl->currentFirstProperty() = false;
   impl->writeIndent();
-  impl->write(zc::str("\"", name, "\": "));
+  impl->write("\"", name, "\": ");
   // Child value will be written immediately after this
 }
 
@@ -104,7 +141,7 @@ void JSONSerializer::writeArrayStart(const zc::StringPtr name, size_t count) {
   if (!impl->currentFirstProperty()) { impl->write(",\n"); }
   impl->currentFirstProperty() = false;
   impl->writeIndent();
-  impl->write(zc::str("\"", name, "\": [\n"));
+  impl->write("\"", name, "\": [\n");
   impl->indentLevel++;
   impl->pushScope();  // Enter array scope - reset firstProperty for array elements
 }
@@ -128,70 +165,75 @@ void JSONSerializer::writeArrayElement() {
 
 void JSONSerializer::writeNull() { impl->write("null"); }
 
+void JSONSerializer::flush() { impl->writer.flush(); }
+
 void JSONSerializer::increaseIndent() { impl->indentLevel++; }
 
 void JSONSerializer::decreaseIndent() { impl->indentLevel--; }
 
 // XMLSerializer implementation
 struct XMLSerializer::Impl {
-  zc::OutputStream& output;
+  StreamWriter writer;
   int indentLevel = 0;
 
-  explicit Impl(zc::OutputStream& out) : output(out) {}
-
-  void write(zc::StringPtr str) { output.write(str.asBytes()); }
+  explicit Impl(zc::OutputStream& out) : writer(out) {}
 
-  void writeIndent() {
-    for (int i = 0; i < indentLevel; ++i) { write("  "); }
+  template <typename... Params>
+  void write(Params&&... params) {
+    writer.write(zc::fwd<Params>(params)...);
   }
+
+  void writeIndent() { writer.writeIndent(indentLevel); }
 };
 
-XMLSerializer::XMLSerializer(zc::OutputStream& output) noexcept : impl(zc::heap<Impl>(output)) {
-  impl->write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+XMLSerializer::XMLSerializer(zc::OutputStream& output, bool writeDeclaration) noexcept
+    : impl(zc::heap<Impl>(output)) {
+  if (writeDeclaration) { impl->write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"); }
 }
 
 XMLSerializer::~XMLSerializer() noexcept(false) = default;
 
 void XMLSerializer::writeNodeStart(const zc::StringPtr nodeType) {
   impl->writeIndent();
-  impl->write(zc::str("<", nodeType, ">\n"));
+  impl->write("<", nodeType, ">\n");
   impl->indentLevel++;
 }
 
 void XMLSerializer::writeNodeEnd(const zc::StringPtr nodeType) {
   impl->indentLevel--;
   impl->writeIndent();
-  impl->write(zc::str("</", nodeType, ">\n"));
+  impl->write("</", nodeType, ">\n");
 }
 
 void XMLSerializer::writeProperty(const zc::StringPtr name, const zc::StringPtr value) {
   impl->writeIndent();
-  auto escapedValue = basic::escapeXmlString(value);
-  impl->write(zc::str("<", name, ">", escapedValue, "</", name, ">\n"));
+  impl->write("<", name, ">");
+  impl->writer.writeXmlEscaped(value);
+  impl->write("</", name, ">\n");
 }
 
 void XMLSerializer::writeChildStart(const zc::StringPtr name) {
   impl->writeIndent();
-  impl->write(zc::str("<", name, ">\n"));
+  impl->write("<", name, ">\n");
   impl->indentLevel++;
 }
 
 void XMLSerializer::writeChildEnd(const zc::StringPtr name) {
   impl->indentLevel--;
   impl->writeIndent();
-  impl->write(zc::str("</", name, ">\n"));
+  impl->write("</", name, ">\n");
 }
 
 void XMLSerializer::writeArrayStart(const zc::StringPtr name, size_t count) {
   impl->writeIndent();
-  impl->write(zc::str("<", name, ">\n"));
+  impl->write("<", name, ">\n");
   impl->indentLevel++;
 }
 
 void XMLSerializer::writeArrayEnd(const zc::StringPtr name) {
   impl->indentLevel--;
   impl->writeIndent();
-  impl->write(zc::str("</", name, ">\n"));
+  impl->write("</", name, ">\n");
 }
 
 void XMLSerializer::writeArrayElement() {
@@ -200,22 +242,25 @@ void XMLSerializer::writeArrayElement() {
 
 void XMLSerializer::writeNull() { impl->write("<null/>"); }
 
+void XMLSerializer::flush() { impl->writer.flush(); }
+
 void XMLSerializer::increaseIndent() { impl->indentLevel++; }
 
 void XMLSerializer::decreaseIndent() { impl->indentLevel--; }
 
 // TextSerializer implementation
 struct TextSerializer::Impl {
-  zc::OutputStream& output;
+  StreamWriter writer;
   int indentLevel = 0;
 
-  explicit Impl(zc::OutputStream& out) : output(out) {}
-
-  void write(zc::StringPtr str) { output.write(str.asBytes()); }
+  explicit Impl(zc::OutputStream& out) : writer(out) {}
 
-  void writeIndent() {
-    for (int i = 0; i < indentLevel; ++i) { write("  "); }
+  template <typename... Params>
+  void write(Params&&... params) {
+    writer.write(zc::fwd<Params>(params)...);
   }
+
+  void writeIndent() { writer.writeIndent(indentLevel); }
 };
 
 TextSerializer::TextSerializer(zc::OutputStream& output) noexcept : impl(zc::heap<Impl>(output)) {}
@@ -224,7 +269,7 @@ TextSerializer::~TextSerializer() noexcept(false) = default;
 
 void TextSerializer::writeNodeStart(const zc::StringPtr nodeType) {
   impl->writeIndent();
-  impl->write(zc::str(nodeType, " {\n"));
+  impl->write(nodeType, " {\n");
   impl->indentLevel++;
 }
 
@@ -236,12 +281,12 @@ void TextSerializer::writeNodeEnd(const zc::StringPtr nodeType) {
 
 void TextSerializer::writeProperty(const zc::StringPtr name, const zc::StringPtr value) {
   impl->writeIndent();
-  impl->write(zc::str(name, ": ", value, "\n"));
+  impl->write(name, ": ", value, "\n");
 }
 
 void TextSerializer::writeChildStart(const zc::StringPtr name) {
   impl->writeIndent();
-  impl->write(zc::str(name, ":\n"));
+  impl->write(name, ":\n");
   impl->indentLevel++;
 }
 
@@ -249,7 +294,7 @@ void TextSerializer::writeChildEnd(const zc::StringPtr name) { impl->indentLevel
 
 void TextSerializer::writeArrayStart(const zc::StringPtr name, size_t count) {
   impl->writeIndent();
-  impl->write(zc::str(name, ": [\n"));
+  impl->write(name, ": [\n");
   impl->indentLevel++;
 }
 
@@ -268,6 +313,8 @@ void TextSerializer::writeNull() {
   impl->write("null\n");
 }
 
+void TextSerializer::flush() { impl->writer.flush(); }
+
 void TextSerializer::increaseIndent() { impl->indentLevel++; }
 
 void TextSerializer::decreaseIndent() { impl->indentLevel--; }
@@ -43,6 +43,10 @@ public:
   virtual void writeArrayElement() = 0;
   virtual void writeNull() = 0;
 
+  /// Output is buffered; flush() hands everything written so far to the underlying stream.
+  /// Required before writing to that stream directly. Destroying the serializer also flushes.
+  virtual void flush() = 0;
+
   // Indentation management
   virtual void increaseIndent() = 0;
   virtual void decreaseIndent() = 0;
@@ -68,6 +72,7 @@ public:
   void writeArrayEnd(const zc::StringPtr name) final;
   void writeArrayElement() final;
   void writeNull() final;
+  void flush() final;
   void increaseIndent() final;
   void decreaseIndent() final;
 
@@ -79,7 +84,9 @@ private:
 /// XML serializer implementation
 class XMLSerializer final : public Serializer {
 public:
-  explicit XMLSerializer(zc::OutputStream& output) noexcept;
+  /// `writeDeclaration` is false for all but the first part of a document serialized in pieces,
+  /// so that the XML declaration is written once.
+  explicit XMLSerializer(zc::OutputStream& output, bool writeDeclaration = true) noexcept;
   ~XMLSerializer() noexcept(false);
 
   ZC_DISALLOW_COPY_AND_MOVE(XMLSerializer);
@@ -93,6 +100,7 @@ public:
   void writeArrayEnd(const zc::StringPtr name) final;
   void writeArrayElement() final;
   void writeNull() final;
+  void flush() final;
   void increaseIndent() final;
   void decreaseIndent() final;
 
@@ -118,6 +126,7 @@ public:
   void writeArrayEnd(const zc::StringPtr name) final;
   void writeArrayElement() final;
   void writeNull() final;
+  void flush() final;
   void increaseIndent() final;
   void decreaseIndent() final;
 
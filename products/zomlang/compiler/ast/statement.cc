@@ -14,8 +14,11 @@
 
 #include "zomlang/compiler/ast/statement.h"
 
+#include <atomic>
+
 #include "zc/core/common.h"
 #include "zc/core/memory.h"
+#include "zc/core/mutex.h"
 #include "zc/core/one-of.h"
 #include "zomlang/compiler/ast/ast.h"
 #include "zomlang/compiler/ast/cast.h"
@@ -35,7 +38,7 @@ struct DeclarationImpl::Impl {
   zc::Maybe<const symbol::Symbol&> symbol = zc::none;
 };
 
-DeclarationImpl::DeclarationImpl() noexcept : impl(zc::heap<Impl>()) {}
+DeclarationImpl::DeclarationImpl() noexcept : impl(allocate<Impl>()) {}
 DeclarationImpl::~DeclarationImpl() noexcept(false) = default;
 
 zc::Maybe<const symbol::Symbol&> DeclarationImpl::getSymbol() const { return impl->symbol; }
@@ -51,7 +54,7 @@ struct NamedDeclarationImpl::Impl {
 
 NamedDeclarationImpl::NamedDeclarationImpl(
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> name) noexcept
-    : DeclarationImpl(), impl(zc::heap<Impl>(zc::mv(name))) {}
+    : DeclarationImpl(), impl(allocate<Impl>(zc::mv(name))) {}
 
 NamedDeclarationImpl::~NamedDeclarationImpl() noexcept(false) = default;
 
@@ -71,7 +74,7 @@ NamedDeclarationImpl::getName() const {
 // ================================================================================
 // BindingElement::Impl
 
-struct BindingElement::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct BindingElement::Impl : private NamedDeclarationImpl {
   const zc::Maybe<zc::Own<TokenNode>> dotDotDotToken;
   const zc::Maybe<zc::Own<Identifier>> propertyName;
   const zc::Maybe<zc::Own<Expression>> initializer;
@@ -80,7 +83,6 @@ struct BindingElement::Impl : private NamedDeclarationImpl, private NodeImpl {
        zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> nameOrPattern,
        zc::Maybe<zc::Own<Expression>> init)
       : NamedDeclarationImpl(zc::mv(nameOrPattern)),
-        NodeImpl(SyntaxKind::BindingElement),
         dotDotDotToken(zc::mv(dotDotDotToken)),
         propertyName(zc::mv(propertyName)),
         initializer(zc::mv(init)) {}
@@ -88,10 +90,6 @@ struct BindingElement::Impl : private NamedDeclarationImpl, private NodeImpl {
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -102,30 +100,20 @@ BindingElement::BindingElement(
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> nameOrPattern,
     zc::Maybe<zc::Own<Expression>> initializer) noexcept
     : NamedDeclaration(),
-      impl(zc::heap<Impl>(zc::mv(dotDotDotToken), zc::mv(propertyName), zc::mv(nameOrPattern),
+      Node(SyntaxKind::BindingElement),
+      impl(allocate<Impl>(zc::mv(dotDotDotToken), zc::mv(propertyName), zc::mv(nameOrPattern),
                           zc::mv(initializer))) {}
 
 BindingElement::~BindingElement() noexcept(false) = default;
 
 zc::Maybe<const Expression&> BindingElement::getInitializer() const { return impl->initializer; }
 
-SyntaxKind BindingElement::getKind() const { return SyntaxKind::BindingElement; }
-
-NodeFlags BindingElement::getFlags() const { return NodeFlags::None; }
-void BindingElement::setFlags(NodeFlags flags) {}
-
 void BindingElement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> BindingElement::getSymbol() const { return impl->getSymbol(); }
 
 void BindingElement::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) { impl->setSymbol(symbol); }
 
-void BindingElement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& BindingElement::getSourceRange() const { return impl->getSourceRange(); }
-
 zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> BindingElement::getName()
     const {
   return impl->getName();
@@ -143,7 +131,7 @@ zc::Maybe<const BindingPattern&> BindingElement::getBindingPattern() const {
 // ================================================================================
 // ParameterDeclaration::Impl
 
-struct ParameterDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct ParameterDeclaration::Impl : private NamedDeclarationImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<TokenNode>> dotDotDotToken;
   const zc::Maybe<zc::Own<TokenNode>> questionToken;
@@ -154,7 +142,6 @@ struct ParameterDeclaration::Impl : private NamedDeclarationImpl, private NodeIm
        zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> n, zc::Maybe<zc::Own<TokenNode>> qt,
        zc::Maybe<zc::Own<TypeNode>> t, zc::Maybe<zc::Own<Expression>> init)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::ParameterDeclaration),
         modifiers(zc::mv(mods)),
         dotDotDotToken(zc::mv(ddd)),
         questionToken(zc::mv(qt)),
@@ -164,10 +151,6 @@ struct ParameterDeclaration::Impl : private NamedDeclarationImpl, private NodeIm
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -179,7 +162,8 @@ ParameterDeclaration::ParameterDeclaration(
     zc::Maybe<zc::Own<TokenNode>> questionToken, zc::Maybe<zc::Own<TypeNode>> type,
     zc::Maybe<zc::Own<Expression>> initializer) noexcept
     : NamedDeclaration(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(dotDotDotToken), zc::mv(name),
+      Node(SyntaxKind::ParameterDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(dotDotDotToken), zc::mv(name),
                           zc::mv(questionToken), zc::mv(type), zc::mv(initializer))) {}
 
 ParameterDeclaration::~ParameterDeclaration() noexcept(false) = default;
@@ -207,11 +191,6 @@ zc::Maybe<const Expression&> ParameterDeclaration::getInitializer() const {
   return impl->initializer;
 }
 
-SyntaxKind ParameterDeclaration::getKind() const { return SyntaxKind::ParameterDeclaration; }
-
-NodeFlags ParameterDeclaration::getFlags() const { return NodeFlags::None; }
-void ParameterDeclaration::setFlags(NodeFlags flags) {}
-
 void ParameterDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> ParameterDeclaration::getSymbol() const {
@@ -222,14 +201,6 @@ void ParameterDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void ParameterDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ParameterDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 zc::Maybe<const BindingPattern&> ParameterDeclaration::getBindingPattern() const {
   auto name = impl->getName();
   ZC_SWITCH_ONEOF(name) {
@@ -242,24 +213,17 @@ zc::Maybe<const BindingPattern&> ParameterDeclaration::getBindingPattern() const
 // ================================================================================
 // VariableDeclaration::Impl
 
-struct VariableDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct VariableDeclaration::Impl : private NamedDeclarationImpl {
   const zc::Maybe<zc::Own<TypeNode>> type;
   const zc::Maybe<zc::Own<Expression>> initializer;
 
   Impl(zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> n, zc::Maybe<zc::Own<TypeNode>> t,
        zc::Maybe<zc::Own<Expression>> init)
-      : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::VariableDeclaration),
-        type(zc::mv(t)),
-        initializer(zc::mv(init)) {}
+      : NamedDeclarationImpl(zc::mv(n)), type(zc::mv(t)), initializer(zc::mv(init)) {}
 
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -268,7 +232,9 @@ struct VariableDeclaration::Impl : private NamedDeclarationImpl, private NodeImp
 VariableDeclaration::VariableDeclaration(
     zc::OneOf<zc::Own<Identifier>, zc::Own<BindingPattern>> name, zc::Maybe<zc::Own<TypeNode>> type,
     zc::Maybe<zc::Own<Expression>> initializer) noexcept
-    : NamedDeclaration(), impl(zc::heap<Impl>(zc::mv(name), zc::mv(type), zc::mv(initializer))) {}
+    : NamedDeclaration(),
+      Node(SyntaxKind::VariableDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(type), zc::mv(initializer))) {}
 
 VariableDeclaration::~VariableDeclaration() noexcept(false) = default;
 
@@ -292,11 +258,6 @@ zc::Maybe<const Expression&> VariableDeclaration::getInitializer() const {
   return impl->initializer;
 }
 
-SyntaxKind VariableDeclaration::getKind() const { return SyntaxKind::VariableDeclaration; }
-
-NodeFlags VariableDeclaration::getFlags() const { return NodeFlags::None; }
-void VariableDeclaration::setFlags(NodeFlags flags) {}
-
 void VariableDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> VariableDeclaration::getSymbol() const {
@@ -307,28 +268,13 @@ void VariableDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void VariableDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& VariableDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // VariableDeclarationList::Impl
 
-struct VariableDeclarationList::Impl : private NodeImpl {
+struct VariableDeclarationList::Impl {
   const NodeList<VariableDeclaration> bindings;
 
-  explicit Impl(zc::Vector<zc::Own<VariableDeclaration>>&& b)
-      : NodeImpl(SyntaxKind::VariableDeclarationList), bindings(zc::mv(b)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<VariableDeclaration>>&& b) : bindings(zc::mv(b)) {}
 };
 
 // ================================================================================
@@ -336,7 +282,7 @@ struct VariableDeclarationList::Impl : private NodeImpl {
 
 VariableDeclarationList::VariableDeclarationList(
     zc::Vector<zc::Own<VariableDeclaration>>&& bindings) noexcept
-    : Node(), impl(zc::heap<Impl>(zc::mv(bindings))) {}
+    : Node(SyntaxKind::VariableDeclarationList), impl(allocate<Impl>(zc::mv(bindings))) {}
 
 VariableDeclarationList::~VariableDeclarationList() noexcept(false) = default;
 
@@ -344,42 +290,22 @@ const NodeList<VariableDeclaration>& VariableDeclarationList::getBindings() cons
   return impl->bindings;
 }
 
-SyntaxKind VariableDeclarationList::getKind() const { return SyntaxKind::VariableDeclarationList; }
-
-NodeFlags VariableDeclarationList::getFlags() const { return NodeFlags::None; }
-void VariableDeclarationList::setFlags(NodeFlags flags) {}
-
 void VariableDeclarationList::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void VariableDeclarationList::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& VariableDeclarationList::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // VariableStatement::Impl
 
-struct VariableStatement::Impl : private NodeImpl {
+struct VariableStatement::Impl {
   const zc::Own<VariableDeclarationList> declarations;
 
-  explicit Impl(zc::Own<VariableDeclarationList> d)
-      : NodeImpl(SyntaxKind::VariableStatement), declarations(zc::mv(d)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Own<VariableDeclarationList> d) : declarations(zc::mv(d)) {}
 };
 
 // ================================================================================
 // VariableStatement
 
 VariableStatement::VariableStatement(zc::Own<VariableDeclarationList> declarations) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(declarations))) {}
+    : Statement(SyntaxKind::VariableStatement), impl(allocate<Impl>(zc::mv(declarations))) {}
 
 VariableStatement::~VariableStatement() noexcept(false) = default;
 
@@ -387,49 +313,66 @@ const VariableDeclarationList& VariableStatement::getDeclarations() const {
   return *impl->declarations;
 }
 
-SyntaxKind VariableStatement::getKind() const { return SyntaxKind::VariableStatement; }
+void VariableStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-NodeFlags VariableStatement::getFlags() const { return NodeFlags::None; }
-void VariableStatement::setFlags(NodeFlags flags) {}
+// ================================================================================
+// FunctionBody
 
-void VariableStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
+namespace {
 
-void VariableStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
+/// Body of a function-like declaration, either parsed up front or deferred until first requested.
+class FunctionBody {
+public:
+  explicit FunctionBody(zc::Maybe<zc::Own<Statement>> body) : body(zc::mv(body)) {}
+  explicit FunctionBody(DeferredBody deferred) : deferred(zc::mv(deferred.parse)) {}
 
-const source::SourceRange& VariableStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
+  ZC_DISALLOW_COPY_AND_MOVE(FunctionBody);
+
+  zc::Maybe<const Statement&> get() const {
+    ZC_IF_SOME(b, body) { return *b; }
+    ZC_IF_SOME(parse, deferred) {
+      return *lazy.get([&](zc::SpaceFor<zc::Own<Statement>>& space) {
+        auto result = space.construct(parse());
+        parsed.store(true, std::memory_order_release);
+        return result;
+      });
+    }
+    return zc::none;
+  }
+
+  bool isDeferred() const {
+    return deferred != zc::none && !parsed.load(std::memory_order_acquire);
+  }
+
+private:
+  const zc::Maybe<zc::Own<Statement>> body;
+  mutable zc::Maybe<zc::Function<zc::Own<Statement>()>> deferred;
+  zc::Lazy<zc::Own<Statement>> lazy;
+  mutable std::atomic<bool> parsed{false};
+};
+
+}  // namespace
 
 // ================================================================================
 // FunctionDeclaration::Impl
 
-struct FunctionDeclaration::Impl : private NamedDeclarationImpl,
-                                   private LocalsContainerImpl,
-                                   private NodeImpl {
+struct FunctionDeclaration::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
   const zc::Maybe<zc::Own<ReturnTypeNode>> returnType;
-  const zc::Own<Statement> body;
+  const FunctionBody body;
 
+  template <typename Body>
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Vector<zc::Own<ParameterDeclaration>>&& p, zc::Maybe<zc::Own<ReturnTypeNode>> r,
-       zc::Own<Statement> b)
+       Body b)
       : NamedDeclarationImpl(zc::mv(n)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::FunctionDeclaration),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         parameters(zc::mv(p)),
         returnType(zc::mv(r)),
         body(zc::mv(b)) {}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
@@ -450,9 +393,19 @@ FunctionDeclaration::FunctionDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Own<Statement> body) noexcept
-    : DeclarationStatement(),
+    : DeclarationStatement(SyntaxKind::FunctionDeclaration),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
+                          zc::mv(returnType), zc::mv(body))) {}
+
+FunctionDeclaration::FunctionDeclaration(
+    zc::Own<Identifier> name,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) noexcept
+    : DeclarationStatement(SyntaxKind::FunctionDeclaration),
+      LocalsContainer(),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(parameters),
                           zc::mv(returnType), zc::mv(body))) {}
 
 FunctionDeclaration::~FunctionDeclaration() noexcept(false) = default;
@@ -474,7 +427,11 @@ zc::Maybe<const ReturnTypeNode&> FunctionDeclaration::getReturnType() const {
   return impl->returnType;
 }
 
-const Statement& FunctionDeclaration::getBody() const { return *impl->body; }
+const Statement& FunctionDeclaration::getBody() const {
+  return ZC_ASSERT_NONNULL(impl->body.get());
+}
+
+bool FunctionDeclaration::isBodyDeferred() const { return impl->body.isDeferred(); }
 
 zc::Maybe<const symbol::SymbolTable&> FunctionDeclaration::getLocals() const {
   return impl->getLocals();
@@ -492,11 +449,6 @@ void FunctionDeclaration::setNextContainer(zc::Maybe<const LocalsContainer&> nex
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind FunctionDeclaration::getKind() const { return SyntaxKind::FunctionDeclaration; }
-
-NodeFlags FunctionDeclaration::getFlags() const { return NodeFlags::None; }
-void FunctionDeclaration::setFlags(NodeFlags flags) {}
-
 void FunctionDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> FunctionDeclaration::getSymbol() const {
@@ -507,18 +459,10 @@ void FunctionDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void FunctionDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& FunctionDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // ClassDeclaration::Impl
 
-struct ClassDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct ClassDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<HeritageClause> heritageClauses;
   const NodeList<ClassElement> members;
@@ -526,17 +470,10 @@ struct ClassDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> hc, zc::Vector<zc::Own<ClassElement>>&& m)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::ClassDeclaration),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         heritageClauses(zc::mv(hc).orDefault(zc::Vector<zc::Own<HeritageClause>>())),
         members(zc::mv(m)) {}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
@@ -551,8 +488,8 @@ ClassDeclaration::ClassDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<ClassElement>>&& members) noexcept
-    : DeclarationStatement(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
+    : DeclarationStatement(SyntaxKind::ClassDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
                           zc::mv(members))) {}
 
 ClassDeclaration::~ClassDeclaration() noexcept(false) = default;
@@ -572,11 +509,6 @@ const NodeList<HeritageClause>& ClassDeclaration::getHeritageClauses() const {
 
 const NodeList<ClassElement>& ClassDeclaration::getMembers() const { return impl->members; }
 
-SyntaxKind ClassDeclaration::getKind() const { return SyntaxKind::ClassDeclaration; }
-
-NodeFlags ClassDeclaration::getFlags() const { return NodeFlags::None; }
-void ClassDeclaration::setFlags(NodeFlags flags) {}
-
 void ClassDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> ClassDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -585,18 +517,10 @@ void ClassDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void ClassDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ClassDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // InterfaceDeclaration::Impl
 
-struct InterfaceDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct InterfaceDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<HeritageClause> heritageClauses;
   const NodeList<InterfaceElement> members;
@@ -604,17 +528,10 @@ struct InterfaceDeclaration::Impl : private NamedDeclarationImpl, private NodeIm
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> hc, zc::Vector<zc::Own<InterfaceElement>>&& m)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::InterfaceDeclaration),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         heritageClauses(zc::mv(hc).orDefault(zc::Vector<zc::Own<HeritageClause>>())),
         members(zc::mv(m)) {}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
@@ -629,8 +546,8 @@ InterfaceDeclaration::InterfaceDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<InterfaceElement>>&& members) noexcept
-    : DeclarationStatement(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
+    : DeclarationStatement(SyntaxKind::InterfaceDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
                           zc::mv(members))) {}
 
 InterfaceDeclaration::~InterfaceDeclaration() noexcept(false) = default;
@@ -650,11 +567,6 @@ const NodeList<HeritageClause>& InterfaceDeclaration::getHeritageClauses() const
 
 const NodeList<InterfaceElement>& InterfaceDeclaration::getMembers() const { return impl->members; }
 
-SyntaxKind InterfaceDeclaration::getKind() const { return SyntaxKind::InterfaceDeclaration; }
-
-NodeFlags InterfaceDeclaration::getFlags() const { return NodeFlags::None; }
-void InterfaceDeclaration::setFlags(NodeFlags flags) {}
-
 void InterfaceDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> InterfaceDeclaration::getSymbol() const {
@@ -665,18 +577,10 @@ void InterfaceDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void InterfaceDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& InterfaceDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // StructDeclaration::Impl
 
-struct StructDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct StructDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<HeritageClause> heritageClauses;
   const NodeList<ClassElement> members;
@@ -684,17 +588,10 @@ struct StructDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> hc, zc::Vector<zc::Own<ClassElement>>&& m)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::StructDeclaration),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         heritageClauses(zc::mv(hc).orDefault(zc::Vector<zc::Own<HeritageClause>>())),
         members(zc::mv(m)) {}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
@@ -709,8 +606,8 @@ StructDeclaration::StructDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Maybe<zc::Vector<zc::Own<HeritageClause>>> heritageClauses,
     zc::Vector<zc::Own<ClassElement>>&& members) noexcept
-    : DeclarationStatement(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
+    : DeclarationStatement(SyntaxKind::StructDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(heritageClauses),
                           zc::mv(members))) {}
 
 StructDeclaration::~StructDeclaration() noexcept(false) = default;
@@ -730,11 +627,6 @@ const NodeList<HeritageClause>& StructDeclaration::getHeritageClauses() const {
 
 const NodeList<ClassElement>& StructDeclaration::getMembers() const { return impl->members; }
 
-SyntaxKind StructDeclaration::getKind() const { return SyntaxKind::StructDeclaration; }
-
-NodeFlags StructDeclaration::getFlags() const { return NodeFlags::None; }
-void StructDeclaration::setFlags(NodeFlags flags) {}
-
 void StructDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> StructDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -743,35 +635,20 @@ void StructDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void StructDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& StructDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // EnumMember::Impl
 
-struct EnumMember::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct EnumMember::Impl : private NamedDeclarationImpl {
   const zc::Maybe<zc::Own<Expression>> initializer;
   const zc::Maybe<zc::Own<TupleTypeNode>> tupleType;
 
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Own<Expression>> init,
        zc::Maybe<zc::Own<TupleTypeNode>> tuple)
-      : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::EnumMember),
-        initializer(zc::mv(init)),
-        tupleType(zc::mv(tuple)) {}
+      : NamedDeclarationImpl(zc::mv(n)), initializer(zc::mv(init)), tupleType(zc::mv(tuple)) {}
 
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -779,8 +656,8 @@ struct EnumMember::Impl : private NamedDeclarationImpl, private NodeImpl {
 
 EnumMember::EnumMember(zc::Own<Identifier> name, zc::Maybe<zc::Own<Expression>> initializer,
                        zc::Maybe<zc::Own<TupleTypeNode>> tupleType) noexcept
-    : DeclarationStatement(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(initializer), zc::mv(tupleType))) {}
+    : DeclarationStatement(SyntaxKind::EnumMember),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(initializer), zc::mv(tupleType))) {}
 
 EnumMember::~EnumMember() noexcept(false) = default;
 
@@ -793,39 +670,20 @@ zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> EnumMe
   return impl->getName();
 }
 
-SyntaxKind EnumMember::getKind() const { return SyntaxKind::EnumMember; }
-
-NodeFlags EnumMember::getFlags() const { return NodeFlags::None; }
-void EnumMember::setFlags(NodeFlags flags) {}
-
 void EnumMember::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> EnumMember::getSymbol() const { return impl->getSymbol(); }
 
 void EnumMember::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) { impl->setSymbol(symbol); }
 
-void EnumMember::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& EnumMember::getSourceRange() const { return impl->getSourceRange(); }
-
 // ================================================================================
 // EnumDeclaration::Impl
 
-struct EnumDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct EnumDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<EnumMember> members;
 
   Impl(zc::Own<Identifier> n, zc::Vector<zc::Own<EnumMember>>&& m)
-      : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::EnumDeclaration),
-        members(zc::mv(m)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : NamedDeclarationImpl(zc::mv(n)), members(zc::mv(m)) {}
 
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
@@ -838,7 +696,8 @@ struct EnumDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
 
 EnumDeclaration::EnumDeclaration(zc::Own<Identifier> name,
                                  zc::Vector<zc::Own<EnumMember>>&& members) noexcept
-    : DeclarationStatement(), impl(zc::heap<Impl>(zc::mv(name), zc::mv(members))) {}
+    : DeclarationStatement(SyntaxKind::EnumDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(members))) {}
 
 EnumDeclaration::~EnumDeclaration() noexcept(false) = default;
 
@@ -849,11 +708,6 @@ zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> EnumDe
 
 const NodeList<EnumMember>& EnumDeclaration::getMembers() const { return impl->members; }
 
-SyntaxKind EnumDeclaration::getKind() const { return SyntaxKind::EnumDeclaration; }
-
-NodeFlags EnumDeclaration::getFlags() const { return NodeFlags::None; }
-void EnumDeclaration::setFlags(NodeFlags flags) {}
-
 void EnumDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> EnumDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -862,30 +716,14 @@ void EnumDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void EnumDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& EnumDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // ErrorDeclaration::Impl
 
-struct ErrorDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct ErrorDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<Statement> members;
 
   Impl(zc::Own<Identifier> n, zc::Vector<zc::Own<Statement>>&& m)
-      : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::ErrorDeclaration),
-        members(zc::mv(m)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : NamedDeclarationImpl(zc::mv(n)), members(zc::mv(m)) {}
 
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
@@ -898,7 +736,8 @@ struct ErrorDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
 
 ErrorDeclaration::ErrorDeclaration(zc::Own<Identifier> name,
                                    zc::Vector<zc::Own<Statement>>&& members) noexcept
-    : DeclarationStatement(), impl(zc::heap<Impl>(zc::mv(name), zc::mv(members))) {}
+    : DeclarationStatement(SyntaxKind::ErrorDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(members))) {}
 
 ErrorDeclaration::~ErrorDeclaration() noexcept(false) = default;
 
@@ -909,11 +748,6 @@ ErrorDeclaration::getName() const {
 
 const NodeList<Statement>& ErrorDeclaration::getMembers() const { return impl->members; }
 
-SyntaxKind ErrorDeclaration::getKind() const { return SyntaxKind::ErrorDeclaration; }
-
-NodeFlags ErrorDeclaration::getFlags() const { return NodeFlags::None; }
-void ErrorDeclaration::setFlags(NodeFlags flags) {}
-
 void ErrorDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> ErrorDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -922,34 +756,19 @@ void ErrorDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void ErrorDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ErrorDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // AliasDeclaration::Impl
 
-struct AliasDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct AliasDeclaration::Impl : private NamedDeclarationImpl {
   const NodeList<TypeParameterDeclaration> typeParameters;
   const zc::Own<TypeNode> type;
 
   Impl(zc::Own<Identifier> n, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tps,
        zc::Own<TypeNode> t)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::AliasDeclaration),
         typeParameters(zc::mv(tps).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         type(zc::mv(t)) {}
 
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
@@ -964,8 +783,8 @@ AliasDeclaration::AliasDeclaration(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Own<TypeNode> type) noexcept
     : NamedDeclaration(),
-      Statement(),
-      impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(type))) {}
+      Statement(SyntaxKind::AliasDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeParameters), zc::mv(type))) {}
 
 AliasDeclaration::~AliasDeclaration() noexcept(false) = default;
 
@@ -980,19 +799,6 @@ const NodeList<TypeParameterDeclaration>& AliasDeclaration::getTypeParameters()
 
 const TypeNode& AliasDeclaration::getType() const { return *impl->type; }
 
-void AliasDeclaration::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& AliasDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind AliasDeclaration::getKind() const { return SyntaxKind::AliasDeclaration; }
-
-NodeFlags AliasDeclaration::getFlags() const { return NodeFlags::None; }
-void AliasDeclaration::setFlags(NodeFlags flags) {}
-
 void AliasDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> AliasDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -1004,56 +810,25 @@ void AliasDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
 // ================================================================================
 // DebuggerStatement::Impl
 
-struct DebuggerStatement::Impl : private NodeImpl {
-  Impl() : NodeImpl(SyntaxKind::DebuggerStatement) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-};
-
 // ================================================================================
 // DebuggerStatement
 
-DebuggerStatement::DebuggerStatement() noexcept : Statement(), impl(zc::heap<Impl>()) {}
+DebuggerStatement::DebuggerStatement() noexcept : Statement(SyntaxKind::DebuggerStatement) {}
 
 DebuggerStatement::~DebuggerStatement() noexcept(false) = default;
 
-void DebuggerStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& DebuggerStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind DebuggerStatement::getKind() const { return impl->getKind(); }
-
-NodeFlags DebuggerStatement::getFlags() const { return impl->getFlags(); }
-void DebuggerStatement::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
 void DebuggerStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // MatchClause::Impl
 
-struct MatchClause::Impl : private NodeImpl {
+struct MatchClause::Impl {
   const zc::Own<Pattern> pattern;
   const zc::Maybe<zc::Own<Expression>> guard;
   const zc::Own<Statement> body;
 
   Impl(zc::Own<Pattern> p, zc::Maybe<zc::Own<Expression>> g, zc::Own<Statement> b)
-      : NodeImpl(SyntaxKind::MatchClause), pattern(zc::mv(p)), guard(zc::mv(g)), body(zc::mv(b)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : pattern(zc::mv(p)), guard(zc::mv(g)), body(zc::mv(b)) {}
 };
 
 // ================================================================================
@@ -1061,7 +836,8 @@ struct MatchClause::Impl : private NodeImpl {
 
 MatchClause::MatchClause(zc::Own<Pattern> pattern, zc::Maybe<zc::Own<Expression>> guard,
                          zc::Own<Statement> body) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(pattern), zc::mv(guard), zc::mv(body))) {}
+    : Statement(SyntaxKind::MatchClause),
+      impl(allocate<Impl>(zc::mv(pattern), zc::mv(guard), zc::mv(body))) {}
 
 MatchClause::~MatchClause() noexcept(false) = default;
 
@@ -1071,108 +847,57 @@ zc::Maybe<const Expression&> MatchClause::getGuard() const { return impl->guard;
 
 const Statement& MatchClause::getBody() const { return *impl->body; }
 
-void MatchClause::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& MatchClause::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind MatchClause::getKind() const { return SyntaxKind::MatchClause; }
-
-NodeFlags MatchClause::getFlags() const { return NodeFlags::None; }
-void MatchClause::setFlags(NodeFlags flags) {}
-
 void MatchClause::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // DefaultClause::Impl
 
-struct DefaultClause::Impl : private NodeImpl {
+struct DefaultClause::Impl {
   const NodeList<Statement> statements;
 
-  explicit Impl(zc::Vector<zc::Own<Statement>>&& s)
-      : NodeImpl(SyntaxKind::DefaultClause), statements(zc::mv(s)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<Statement>>&& s) : statements(zc::mv(s)) {}
 };
 
 // ================================================================================
 // DefaultClause
 
 DefaultClause::DefaultClause(zc::Vector<zc::Own<Statement>>&& statements) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(statements))) {}
+    : Statement(SyntaxKind::DefaultClause), impl(allocate<Impl>(zc::mv(statements))) {}
 
 DefaultClause::~DefaultClause() noexcept(false) = default;
 
 const NodeList<Statement>& DefaultClause::getStatements() const { return impl->statements; }
 
-SyntaxKind DefaultClause::getKind() const { return SyntaxKind::DefaultClause; }
-
-NodeFlags DefaultClause::getFlags() const { return NodeFlags::None; }
-void DefaultClause::setFlags(NodeFlags flags) {}
-
 void DefaultClause::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void DefaultClause::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& DefaultClause::getSourceRange() const { return impl->getSourceRange(); }
-
 // ================================================================================
 // ArrayBindingPattern::Impl
 
-struct ArrayBindingPattern::Impl : private NodeImpl {
+struct ArrayBindingPattern::Impl {
   const NodeList<BindingElement> elements;
 
-  explicit Impl(zc::Vector<zc::Own<BindingElement>>&& e)
-      : NodeImpl(SyntaxKind::ArrayBindingPattern), elements(zc::mv(e)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<BindingElement>>&& e) : elements(zc::mv(e)) {}
 };
 
 // ================================================================================
 // ArrayBindingPattern
 
 ArrayBindingPattern::ArrayBindingPattern(zc::Vector<zc::Own<BindingElement>>&& elements) noexcept
-    : BindingPattern(), impl(zc::heap<Impl>(zc::mv(elements))) {}
+    : BindingPattern(SyntaxKind::ArrayBindingPattern), impl(allocate<Impl>(zc::mv(elements))) {}
 
 ArrayBindingPattern::~ArrayBindingPattern() noexcept(false) = default;
 
 const NodeList<BindingElement>& ArrayBindingPattern::getElements() const { return impl->elements; }
 
-void ArrayBindingPattern::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ArrayBindingPattern::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind ArrayBindingPattern::getKind() const { return SyntaxKind::ArrayBindingPattern; }
-
-NodeFlags ArrayBindingPattern::getFlags() const { return NodeFlags::None; }
-void ArrayBindingPattern::setFlags(NodeFlags flags) {}
-
 void ArrayBindingPattern::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // ObjectBindingPattern::Impl
 
-struct ObjectBindingPattern::Impl : private NodeImpl {
+struct ObjectBindingPattern::Impl {
   const NodeList<BindingElement> properties;
 
-  explicit Impl(zc::Vector<zc::Own<BindingElement>>&& p)
-      : NodeImpl(SyntaxKind::ObjectBindingPattern), properties(zc::mv(p)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<BindingElement>>&& p) : properties(zc::mv(p)) {}
 };
 
 // ================================================================================
@@ -1180,7 +905,7 @@ struct ObjectBindingPattern::Impl : private NodeImpl {
 
 ObjectBindingPattern::ObjectBindingPattern(
     zc::Vector<zc::Own<BindingElement>>&& properties) noexcept
-    : BindingPattern(), impl(zc::heap<Impl>(zc::mv(properties))) {}
+    : BindingPattern(SyntaxKind::ObjectBindingPattern), impl(allocate<Impl>(zc::mv(properties))) {}
 
 ObjectBindingPattern::~ObjectBindingPattern() noexcept(false) = default;
 
@@ -1192,35 +917,15 @@ const NodeList<BindingElement>& ObjectBindingPattern::getProperties() const {
   return impl->properties;
 }
 
-void ObjectBindingPattern::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ObjectBindingPattern::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind ObjectBindingPattern::getKind() const { return SyntaxKind::ObjectBindingPattern; }
-
-NodeFlags ObjectBindingPattern::getFlags() const { return NodeFlags::None; }
-void ObjectBindingPattern::setFlags(NodeFlags flags) {}
-
 void ObjectBindingPattern::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // BlockStatement::Impl
 
-struct BlockStatement::Impl : private NodeImpl, private LocalsContainerImpl {
+struct BlockStatement::Impl : private LocalsContainerImpl {
   const NodeList<Statement> statements;
 
-  Impl(zc::Vector<zc::Own<Statement>>&& s)
-      : NodeImpl(SyntaxKind::BlockStatement), LocalsContainerImpl(), statements(zc::mv(s)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  Impl(zc::Vector<zc::Own<Statement>>&& s) : LocalsContainerImpl(), statements(zc::mv(s)) {}
 
   // Forward LocalsContainerImpl methods
   using LocalsContainerImpl::getLocals;
@@ -1233,23 +938,14 @@ struct BlockStatement::Impl : private NodeImpl, private LocalsContainerImpl {
 // BlockStatement
 
 BlockStatement::BlockStatement(zc::Vector<zc::Own<Statement>>&& statements) noexcept
-    : Statement(), LocalsContainer(), impl(zc::heap<Impl>(zc::mv(statements))) {}
+    : Statement(SyntaxKind::BlockStatement),
+      LocalsContainer(),
+      impl(allocate<Impl>(zc::mv(statements))) {}
 
 BlockStatement::~BlockStatement() noexcept(false) = default;
 
 const NodeList<Statement>& BlockStatement::getStatements() const { return impl->statements; }
 
-void BlockStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& BlockStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind BlockStatement::getKind() const { return SyntaxKind::BlockStatement; }
-
-NodeFlags BlockStatement::getFlags() const { return NodeFlags::None; }
-void BlockStatement::setFlags(NodeFlags flags) {}
-
 void BlockStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::SymbolTable&> BlockStatement::getLocals() const {
@@ -1271,62 +967,34 @@ void BlockStatement::setNextContainer(zc::Maybe<const LocalsContainer&> nextCont
 // ================================================================================
 // ExpressionStatement::Impl
 
-struct ExpressionStatement::Impl : private NodeImpl {
+struct ExpressionStatement::Impl {
   const zc::Own<Expression> expression;
 
-  Impl(zc::Own<Expression> e) : NodeImpl(SyntaxKind::ExpressionStatement), expression(zc::mv(e)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  Impl(zc::Own<Expression> e) : expression(zc::mv(e)) {}
 };
 
 // ================================================================================
 // ExpressionStatement
 
 ExpressionStatement::ExpressionStatement(zc::Own<Expression> expression) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(expression))) {}
+    : Statement(SyntaxKind::ExpressionStatement), impl(allocate<Impl>(zc::mv(expression))) {}
 
 ExpressionStatement::~ExpressionStatement() noexcept(false) = default;
 
 const Expression& ExpressionStatement::getExpression() const { return *impl->expression; }
 
-void ExpressionStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ExpressionStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind ExpressionStatement::getKind() const { return SyntaxKind::ExpressionStatement; }
-
-NodeFlags ExpressionStatement::getFlags() const { return NodeFlags::None; }
-void ExpressionStatement::setFlags(NodeFlags flags) {}
-
 void ExpressionStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // IfStatement::Impl
 
-struct IfStatement::Impl : private NodeImpl {
+struct IfStatement::Impl {
   const zc::Own<Expression> condition;
   const zc::Own<Statement> thenStatement;
   const zc::Maybe<zc::Own<Statement>> elseStatement;
 
   Impl(zc::Own<Expression> c, zc::Own<Statement> t, zc::Maybe<zc::Own<Statement>> e)
-      : NodeImpl(SyntaxKind::IfStatement),
-        condition(zc::mv(c)),
-        thenStatement(zc::mv(t)),
-        elseStatement(zc::mv(e)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : condition(zc::mv(c)), thenStatement(zc::mv(t)), elseStatement(zc::mv(e)) {}
 };
 
 // ================================================================================
@@ -1334,8 +1002,8 @@ struct IfStatement::Impl : private NodeImpl {
 
 IfStatement::IfStatement(zc::Own<Expression> condition, zc::Own<Statement> thenStatement,
                          zc::Maybe<zc::Own<Statement>> elseStatement) noexcept
-    : Statement(),
-      impl(zc::heap<Impl>(zc::mv(condition), zc::mv(thenStatement), zc::mv(elseStatement))) {}
+    : Statement(SyntaxKind::IfStatement),
+      impl(allocate<Impl>(zc::mv(condition), zc::mv(thenStatement), zc::mv(elseStatement))) {}
 
 IfStatement::~IfStatement() noexcept(false) = default;
 
@@ -1345,39 +1013,24 @@ const Statement& IfStatement::getThenStatement() const { return *impl->thenState
 
 zc::Maybe<const Statement&> IfStatement::getElseStatement() const { return impl->elseStatement; }
 
-void IfStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& IfStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind IfStatement::getKind() const { return SyntaxKind::IfStatement; }
-
-NodeFlags IfStatement::getFlags() const { return NodeFlags::None; }
-void IfStatement::setFlags(NodeFlags flags) {}
-
 void IfStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // LabeledStatement::Impl
 
-struct LabeledStatement::Impl : private NodeImpl {
+struct LabeledStatement::Impl {
   const zc::Own<Identifier> label;
   const zc::Own<Statement> statement;
 
-  Impl(zc::Own<Identifier> l, zc::Own<Statement> s)
-      : NodeImpl(SyntaxKind::LabeledStatement), label(zc::mv(l)), statement(zc::mv(s)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  Impl(zc::Own<Identifier> l, zc::Own<Statement> s) : label(zc::mv(l)), statement(zc::mv(s)) {}
 };
 
 // ================================================================================
 // LabeledStatement
 
 LabeledStatement::LabeledStatement(zc::Own<Identifier> label, zc::Own<Statement> statement) noexcept
-    : impl(zc::heap<Impl>(zc::mv(label), zc::mv(statement))) {}
+    : Statement(SyntaxKind::LabeledStatement),
+      impl(allocate<Impl>(zc::mv(label), zc::mv(statement))) {}
 
 LabeledStatement::~LabeledStatement() noexcept(false) = default;
 
@@ -1385,121 +1038,66 @@ const Identifier& LabeledStatement::getLabel() const { return *impl->label; }
 
 const Statement& LabeledStatement::getStatement() const { return *impl->statement; }
 
-void LabeledStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& LabeledStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind LabeledStatement::getKind() const { return SyntaxKind::LabeledStatement; }
-
-NodeFlags LabeledStatement::getFlags() const { return NodeFlags::None; }
-void LabeledStatement::setFlags(NodeFlags flags) {}
-
 void LabeledStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // BreakStatement::Impl
 
-struct BreakStatement::Impl : private NodeImpl {
+struct BreakStatement::Impl {
   const zc::Maybe<zc::Own<Identifier>> label;
 
-  explicit Impl(zc::Maybe<zc::Own<Identifier>> l)
-      : NodeImpl(SyntaxKind::BreakStatement), label(zc::mv(l)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Maybe<zc::Own<Identifier>> l) : label(zc::mv(l)) {}
 };
 
 // ================================================================================
 // BreakStatement
 
 BreakStatement::BreakStatement(zc::Maybe<zc::Own<Identifier>> label) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(label))) {}
+    : Statement(SyntaxKind::BreakStatement), impl(allocate<Impl>(zc::mv(label))) {}
 
 BreakStatement::~BreakStatement() noexcept(false) = default;
 
 zc::Maybe<const Identifier&> BreakStatement::getLabel() const { return impl->label; }
 
-void BreakStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& BreakStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind BreakStatement::getKind() const { return SyntaxKind::BreakStatement; }
-
-NodeFlags BreakStatement::getFlags() const { return NodeFlags::None; }
-void BreakStatement::setFlags(NodeFlags flags) {}
-
 void BreakStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // ContinueStatement::Impl
 
-struct ContinueStatement::Impl : private NodeImpl {
+struct ContinueStatement::Impl {
   const zc::Maybe<zc::Own<Identifier>> label;
 
-  explicit Impl(zc::Maybe<zc::Own<Identifier>> l)
-      : NodeImpl(SyntaxKind::ContinueStatement), label(zc::mv(l)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Maybe<zc::Own<Identifier>> l) : label(zc::mv(l)) {}
 };
 
 // ================================================================================
 // ContinueStatement
 
 ContinueStatement::ContinueStatement(zc::Maybe<zc::Own<Identifier>> label) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(label))) {}
+    : Statement(SyntaxKind::ContinueStatement), impl(allocate<Impl>(zc::mv(label))) {}
 
 ContinueStatement::~ContinueStatement() noexcept(false) = default;
 
 zc::Maybe<const Identifier&> ContinueStatement::getLabel() const { return impl->label; }
 
-void ContinueStatement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ContinueStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind ContinueStatement::getKind() const { return SyntaxKind::ContinueStatement; }
-
-NodeFlags ContinueStatement::getFlags() const { return NodeFlags::None; }
-void ContinueStatement::setFlags(NodeFlags flags) {}
-
 void ContinueStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // WhileStatement::Impl
 
-struct WhileStatement::Impl : private NodeImpl {
+struct WhileStatement::Impl {
   const zc::Own<Expression> condition;
   const zc::Own<Statement> body;
 
-  Impl(zc::Own<Expression> c, zc::Own<Statement> b)
-      : NodeImpl(SyntaxKind::WhileStatement), condition(zc::mv(c)), body(zc::mv(b)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  Impl(zc::Own<Expression> c, zc::Own<Statement> b) : condition(zc::mv(c)), body(zc::mv(b)) {}
 };
 
 // ================================================================================
 // WhileStatement
 
 WhileStatement::WhileStatement(zc::Own<Expression> condition, zc::Own<Statement> body) noexcept
-    : IterationStatement(), impl(zc::heap<Impl>(zc::mv(condition), zc::mv(body))) {}
+    : IterationStatement(SyntaxKind::WhileStatement),
+      impl(allocate<Impl>(zc::mv(condition), zc::mv(body))) {}
 
 WhileStatement::~WhileStatement() noexcept(false) = default;
 
@@ -1507,39 +1105,22 @@ const Expression& WhileStatement::getCondition() const { return *impl->condition
 
 const Statement& WhileStatement::getBody() const { return *impl->body; }
 
-void WhileStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& WhileStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind WhileStatement::getKind() const { return SyntaxKind::WhileStatement; }
-
-NodeFlags WhileStatement::getFlags() const { return NodeFlags::None; }
-void WhileStatement::setFlags(NodeFlags flags) {}
-
 void WhileStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // ReturnStatement::Impl
 
-struct ReturnStatement::Impl : private NodeImpl {
+struct ReturnStatement::Impl {
   const zc::Maybe<zc::Own<Expression>> expression;
 
-  explicit Impl(zc::Maybe<zc::Own<Expression>> e)
-      : NodeImpl(SyntaxKind::ReturnStatement), expression(zc::mv(e)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Maybe<zc::Own<Expression>> e) : expression(zc::mv(e)) {}
 };
 
 // ================================================================================
 // ReturnStatement
 
 ReturnStatement::ReturnStatement(zc::Maybe<zc::Own<Expression>> expression) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(expression))) {}
+    : Statement(SyntaxKind::ReturnStatement), impl(allocate<Impl>(zc::mv(expression))) {}
 
 ReturnStatement::~ReturnStatement() noexcept(false) = default;
 
@@ -1548,65 +1129,29 @@ zc::Maybe<const Expression&> ReturnStatement::getExpression() const {
   return zc::none;
 }
 
-void ReturnStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ReturnStatement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind ReturnStatement::getKind() const { return SyntaxKind::ReturnStatement; }
-
-NodeFlags ReturnStatement::getFlags() const { return NodeFlags::None; }
-void ReturnStatement::setFlags(NodeFlags flags) {}
-
 void ReturnStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // EmptyStatement::Impl
 
-struct EmptyStatement::Impl : private NodeImpl {
-  Impl() : NodeImpl(SyntaxKind::EmptyStatement) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
-};
-
 // ================================================================================
 // EmptyStatement
 
-EmptyStatement::EmptyStatement() noexcept : Statement(), impl(zc::heap<Impl>()) {}
+EmptyStatement::EmptyStatement() noexcept : Statement(SyntaxKind::EmptyStatement) {}
 
 EmptyStatement::~EmptyStatement() noexcept(false) = default;
 
-void EmptyStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& EmptyStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind EmptyStatement::getKind() const { return SyntaxKind::EmptyStatement; }
-
-NodeFlags EmptyStatement::getFlags() const { return NodeFlags::None; }
-void EmptyStatement::setFlags(NodeFlags flags) {}
-
 void EmptyStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // MatchStatement::Impl
 
-struct MatchStatement::Impl : private NodeImpl {
+struct MatchStatement::Impl {
   const zc::Own<Expression> discriminant;
   const NodeList<Statement> clauses;
 
   Impl(zc::Own<Expression> d, zc::Vector<zc::Own<Statement>>&& c)
-      : NodeImpl(SyntaxKind::MatchStatement), discriminant(zc::mv(d)), clauses(zc::mv(c)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : discriminant(zc::mv(d)), clauses(zc::mv(c)) {}
 };
 
 // ================================================================================
@@ -1614,7 +1159,8 @@ struct MatchStatement::Impl : private NodeImpl {
 
 MatchStatement::MatchStatement(zc::Own<Expression> discriminant,
                                zc::Vector<zc::Own<Statement>>&& clauses) noexcept
-    : Statement(), impl(zc::heap<Impl>(zc::mv(discriminant), zc::mv(clauses))) {}
+    : Statement(SyntaxKind::MatchStatement),
+      impl(allocate<Impl>(zc::mv(discriminant), zc::mv(clauses))) {}
 
 MatchStatement::~MatchStatement() noexcept(false) = default;
 
@@ -1622,23 +1168,12 @@ const Expression& MatchStatement::getDiscriminant() const { return *impl->discri
 
 const NodeList<Statement>& MatchStatement::getClauses() const { return impl->clauses; }
 
-void MatchStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& MatchStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind MatchStatement::getKind() const { return SyntaxKind::MatchStatement; }
-
-NodeFlags MatchStatement::getFlags() const { return NodeFlags::None; }
-void MatchStatement::setFlags(NodeFlags flags) {}
-
 void MatchStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ================================================================================
 // ForStatement::Impl
 
-struct ForStatement::Impl : private NodeImpl, private LocalsContainerImpl {
+struct ForStatement::Impl : private LocalsContainerImpl {
   const zc::Maybe<zc::Own<Statement>> init;
   const zc::Maybe<zc::Own<Expression>> condition;
   const zc::Maybe<zc::Own<Expression>> update;
@@ -1646,16 +1181,11 @@ struct ForStatement::Impl : private NodeImpl, private LocalsContainerImpl {
 
   Impl(zc::Maybe<zc::Own<Statement>> i, zc::Maybe<zc::Own<Expression>> c,
        zc::Maybe<zc::Own<Expression>> u, zc::Own<Statement> b)
-      : NodeImpl(SyntaxKind::ForStatement),
-        LocalsContainerImpl(),
+      : LocalsContainerImpl(),
         init(zc::mv(i)),
         condition(zc::mv(c)),
         update(zc::mv(u)),
         body(zc::mv(b)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 
   // Forward LocalsContainerImpl methods
   using LocalsContainerImpl::getLocals;
@@ -1670,9 +1200,9 @@ struct ForStatement::Impl : private NodeImpl, private LocalsContainerImpl {
 ForStatement::ForStatement(zc::Maybe<zc::Own<Statement>> init,
                            zc::Maybe<zc::Own<Expression>> condition,
                            zc::Maybe<zc::Own<Expression>> update, zc::Own<Statement> body) noexcept
-    : IterationStatement(),
+    : IterationStatement(SyntaxKind::ForStatement),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(init), zc::mv(condition), zc::mv(update), zc::mv(body))) {}
+      impl(allocate<Impl>(zc::mv(init), zc::mv(condition), zc::mv(update), zc::mv(body))) {}
 
 ForStatement::~ForStatement() noexcept(false) = default;
 
@@ -1693,17 +1223,6 @@ zc::Maybe<const Expression&> ForStatement::getUpdate() const {
 
 const Statement& ForStatement::getBody() const { return *impl->body; }
 
-void ForStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ForStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind ForStatement::getKind() const { return SyntaxKind::ForStatement; }
-
-NodeFlags ForStatement::getFlags() const { return NodeFlags::None; }
-void ForStatement::setFlags(NodeFlags flags) {}
-
 void ForStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::SymbolTable&> ForStatement::getLocals() const { return impl->getLocals(); }
@@ -1723,21 +1242,13 @@ void ForStatement::setNextContainer(zc::Maybe<const LocalsContainer&> nextContai
 // ================================================================================
 // ForInStatement::Impl
 
-struct ForInStatement::Impl : private NodeImpl, private LocalsContainerImpl {
+struct ForInStatement::Impl : private LocalsContainerImpl {
   const zc::Own<Statement> initializer;
   const zc::Own<Expression> expression;
   const zc::Own<Statement> body;
 
   Impl(zc::Own<Statement> i, zc::Own<Expression> e, zc::Own<Statement> b)
-      : NodeImpl(SyntaxKind::ForInStatement),
-        LocalsContainerImpl(),
-        initializer(zc::mv(i)),
-        expression(zc::mv(e)),
-        body(zc::mv(b)) {}
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : LocalsContainerImpl(), initializer(zc::mv(i)), expression(zc::mv(e)), body(zc::mv(b)) {}
 
   // Forward LocalsContainerImpl methods
   using LocalsContainerImpl::getLocals;
@@ -1751,9 +1262,9 @@ struct ForInStatement::Impl : private NodeImpl, private LocalsContainerImpl {
 
 ForInStatement::ForInStatement(zc::Own<Statement> initializer, zc::Own<Expression> expression,
                                zc::Own<Statement> body) noexcept
-    : IterationStatement(),
+    : IterationStatement(SyntaxKind::ForInStatement),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(initializer), zc::mv(expression), zc::mv(body))) {}
+      impl(allocate<Impl>(zc::mv(initializer), zc::mv(expression), zc::mv(body))) {}
 
 ForInStatement::~ForInStatement() noexcept(false) = default;
 
@@ -1763,17 +1274,6 @@ const Expression& ForInStatement::getExpression() const { return *impl->expressi
 
 const Statement& ForInStatement::getBody() const { return *impl->body; }
 
-void ForInStatement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ForInStatement::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind ForInStatement::getKind() const { return SyntaxKind::ForInStatement; }
-
-NodeFlags ForInStatement::getFlags() const { return NodeFlags::None; }
-void ForInStatement::setFlags(NodeFlags flags) {}
-
 void ForInStatement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::SymbolTable&> ForInStatement::getLocals() const {
@@ -1795,17 +1295,12 @@ void ForInStatement::setNextContainer(zc::Maybe<const LocalsContainer&> nextCont
 // ================================================================================
 // HeritageClause::Impl
 
-struct HeritageClause::Impl : private NodeImpl {
+struct HeritageClause::Impl {
   const ast::SyntaxKind token;
   const zc::Vector<zc::Own<ExpressionWithTypeArguments>> types;
 
   Impl(ast::SyntaxKind t, zc::Vector<zc::Own<ExpressionWithTypeArguments>>&& list)
-      : NodeImpl(SyntaxKind::HeritageClause), token(t), types(zc::mv(list)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : token(t), types(zc::mv(list)) {}
 };
 
 // ================================================================================
@@ -1813,7 +1308,7 @@ struct HeritageClause::Impl : private NodeImpl {
 
 HeritageClause::HeritageClause(ast::SyntaxKind token,
                                zc::Vector<zc::Own<ExpressionWithTypeArguments>>&& types) noexcept
-    : Node(), impl(zc::heap<Impl>(token, zc::mv(types))) {}
+    : Node(SyntaxKind::HeritageClause), impl(allocate<Impl>(token, zc::mv(types))) {}
 
 HeritageClause::~HeritageClause() noexcept(false) = default;
 
@@ -1823,23 +1318,12 @@ const zc::Vector<zc::Own<ExpressionWithTypeArguments>>& HeritageClause::getTypes
   return impl->types;
 }
 
-SyntaxKind HeritageClause::getKind() const { return SyntaxKind::HeritageClause; }
-
-NodeFlags HeritageClause::getFlags() const { return NodeFlags::None; }
-void HeritageClause::setFlags(NodeFlags flags) {}
-
 void HeritageClause::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void HeritageClause::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& HeritageClause::getSourceRange() const { return impl->getSourceRange(); }
-
 // ================================================================================
 // PropertySignature::Impl
 
-struct PropertySignature::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct PropertySignature::Impl : private NamedDeclarationImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<ast::TokenNode>> optional;
   const zc::Maybe<zc::Own<TypeNode>> type;
@@ -1848,7 +1332,6 @@ struct PropertySignature::Impl : private NamedDeclarationImpl, private NodeImpl
   Impl(zc::Vector<ast::SyntaxKind> m, zc::Own<Identifier> n, zc::Maybe<zc::Own<ast::TokenNode>> opt,
        zc::Maybe<zc::Own<TypeNode>> t, zc::Maybe<zc::Own<Expression>> init)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::PropertySignature),
         modifiers(zc::mv(m)),
         optional(zc::mv(opt)),
         type(zc::mv(t)),
@@ -1857,10 +1340,6 @@ struct PropertySignature::Impl : private NamedDeclarationImpl, private NodeImpl
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 PropertySignature::PropertySignature(zc::Vector<ast::SyntaxKind> modifiers,
@@ -1868,7 +1347,8 @@ PropertySignature::PropertySignature(zc::Vector<ast::SyntaxKind> modifiers,
                                      zc::Maybe<zc::Own<ast::TokenNode>> optional,
                                      zc::Maybe<zc::Own<TypeNode>> type,
                                      zc::Maybe<zc::Own<Expression>> initializer) noexcept
-    : impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(type),
+    : Node(SyntaxKind::PropertySignature),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(type),
                           zc::mv(initializer))) {}
 
 PropertySignature::~PropertySignature() noexcept(false) = default;
@@ -1888,11 +1368,6 @@ zc::Maybe<const TypeNode&> PropertySignature::getType() const { return impl->typ
 
 zc::Maybe<const Expression&> PropertySignature::getInitializer() const { return impl->initializer; }
 
-SyntaxKind PropertySignature::getKind() const { return SyntaxKind::PropertySignature; }
-
-NodeFlags PropertySignature::getFlags() const { return NodeFlags::None; }
-void PropertySignature::setFlags(NodeFlags flags) {}
-
 void PropertySignature::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> PropertySignature::getSymbol() const { return impl->getSymbol(); }
@@ -1901,20 +1376,10 @@ void PropertySignature::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void PropertySignature::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& PropertySignature::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 // ================================================================================
 // MethodSignature::Impl
 
-struct MethodSignature::Impl : private NamedDeclarationImpl,
-                               private LocalsContainerImpl,
-                               private NodeImpl {
+struct MethodSignature::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<ast::TokenNode>> optional;
   const NodeList<TypeParameterDeclaration> typeParameters;
@@ -1926,7 +1391,6 @@ struct MethodSignature::Impl : private NamedDeclarationImpl,
        zc::Vector<zc::Own<ParameterDeclaration>>&& p, zc::Maybe<zc::Own<ReturnTypeNode>> r)
       : NamedDeclarationImpl(zc::mv(n)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::MethodSignature),
         modifiers(zc::mv(m)),
         optional(zc::mv(opt)),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
@@ -1940,10 +1404,6 @@ struct MethodSignature::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 MethodSignature::MethodSignature(
@@ -1952,7 +1412,8 @@ MethodSignature::MethodSignature(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType) noexcept
-    : impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(typeParameters),
+    : Node(SyntaxKind::MethodSignature),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(typeParameters),
                           zc::mv(parameters), zc::mv(returnType))) {}
 
 MethodSignature::~MethodSignature() noexcept(false) = default;
@@ -1978,11 +1439,6 @@ const NodeList<ParameterDeclaration>& MethodSignature::getParameters() const {
 
 zc::Maybe<const ReturnTypeNode&> MethodSignature::getReturnType() const { return impl->returnType; }
 
-SyntaxKind MethodSignature::getKind() const { return SyntaxKind::MethodSignature; }
-
-NodeFlags MethodSignature::getFlags() const { return NodeFlags::None; }
-void MethodSignature::setFlags(NodeFlags flags) {}
-
 void MethodSignature::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> MethodSignature::getSymbol() const { return impl->getSymbol(); }
@@ -1991,14 +1447,6 @@ void MethodSignature::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void MethodSignature::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& MethodSignature::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 zc::Maybe<const symbol::SymbolTable&> MethodSignature::getLocals() const {
   return impl->getLocals();
 }
@@ -2015,42 +1463,21 @@ void MethodSignature::setNextContainer(zc::Maybe<const LocalsContainer&> nextCon
   impl->setNextContainer(nextContainer);
 }
 
-struct SemicolonInterfaceElement::Impl : private NamedDeclarationImpl, private NodeImpl {
-  Impl()
-      : NamedDeclarationImpl(zc::heap<Identifier>(zc::str(";"))),
-        NodeImpl(SyntaxKind::SemicolonInterfaceElement) {}
+struct SemicolonInterfaceElement::Impl : private NamedDeclarationImpl {
+  Impl() : NamedDeclarationImpl(allocate<Identifier>(zc::str(";"))) {}
 
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 SemicolonInterfaceElement::SemicolonInterfaceElement() noexcept
-    : InterfaceElement(), impl(zc::heap<Impl>()) {}
+    : InterfaceElement(), Node(SyntaxKind::SemicolonInterfaceElement), impl(allocate<Impl>()) {}
 
 SemicolonInterfaceElement::~SemicolonInterfaceElement() noexcept(false) = default;
 
-SyntaxKind SemicolonInterfaceElement::getKind() const {
-  return SyntaxKind::SemicolonInterfaceElement;
-}
-
-NodeFlags SemicolonInterfaceElement::getFlags() const { return NodeFlags::None; }
-void SemicolonInterfaceElement::setFlags(NodeFlags flags) {}
-
 void SemicolonInterfaceElement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void SemicolonInterfaceElement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& SemicolonInterfaceElement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>>
 SemicolonInterfaceElement::getName() const {
   return impl->getName();
@@ -2067,42 +1494,24 @@ void SemicolonInterfaceElement::setSymbol(zc::Maybe<const symbol::Symbol&> symbo
 // ================================================================================
 // SemicolonClassElement::Impl
 
-struct SemicolonClassElement::Impl : private NamedDeclarationImpl, private NodeImpl {
-  Impl()
-      : NamedDeclarationImpl(zc::heap<Identifier>(zc::str(";"))),
-        NodeImpl(SyntaxKind::SemicolonClassElement) {}
+struct SemicolonClassElement::Impl : private NamedDeclarationImpl {
+  Impl() : NamedDeclarationImpl(allocate<Identifier>(zc::str(";"))) {}
 
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
 // SemicolonClassElement
 
-SemicolonClassElement::SemicolonClassElement() noexcept : ClassElement(), impl(zc::heap<Impl>()) {}
+SemicolonClassElement::SemicolonClassElement() noexcept
+    : ClassElement(), Node(SyntaxKind::SemicolonClassElement), impl(allocate<Impl>()) {}
 
 SemicolonClassElement::~SemicolonClassElement() noexcept(false) = default;
 
-SyntaxKind SemicolonClassElement::getKind() const { return SyntaxKind::SemicolonClassElement; }
-
-NodeFlags SemicolonClassElement::getFlags() const { return NodeFlags::None; }
-void SemicolonClassElement::setFlags(NodeFlags flags) {}
-
 void SemicolonClassElement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void SemicolonClassElement::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& SemicolonClassElement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>>
 SemicolonClassElement::getName() const {
   return impl->getName();
@@ -2119,23 +1528,21 @@ void SemicolonClassElement::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
 // ================================================================================
 // MethodDeclaration::Impl
 
-struct MethodDeclaration::Impl : private NamedDeclarationImpl,
-                                 private LocalsContainerImpl,
-                                 private NodeImpl {
+struct MethodDeclaration::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<ast::TokenNode>> optional;
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
   const zc::Maybe<zc::Own<ReturnTypeNode>> returnType;
-  const zc::Maybe<zc::Own<Statement>> body;
+  const FunctionBody body;
 
+  template <typename Body>
   Impl(zc::Vector<ast::SyntaxKind> m, zc::Own<Identifier> n, zc::Maybe<zc::Own<ast::TokenNode>> opt,
        zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Vector<zc::Own<ParameterDeclaration>>&& p, zc::Maybe<zc::Own<ReturnTypeNode>> r,
-       zc::Maybe<zc::Own<Statement>> b)
+       Body b)
       : NamedDeclarationImpl(zc::mv(n)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::MethodDeclaration),
         modifiers(zc::mv(m)),
         optional(zc::mv(opt)),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
@@ -2150,10 +1557,6 @@ struct MethodDeclaration::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -2167,7 +1570,20 @@ MethodDeclaration::MethodDeclaration(
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) noexcept
     : ClassElement(),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(typeParameters),
+      Node(SyntaxKind::MethodDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(typeParameters),
+                          zc::mv(parameters), zc::mv(returnType), zc::mv(body))) {}
+
+MethodDeclaration::MethodDeclaration(
+    zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
+    zc::Maybe<zc::Own<ast::TokenNode>> optional,
+    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) noexcept
+    : ClassElement(),
+      LocalsContainer(),
+      Node(SyntaxKind::MethodDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(optional), zc::mv(typeParameters),
                           zc::mv(parameters), zc::mv(returnType), zc::mv(body))) {}
 
 MethodDeclaration::~MethodDeclaration() noexcept(false) = default;
@@ -2195,7 +1611,9 @@ zc::Maybe<const ReturnTypeNode&> MethodDeclaration::getReturnType() const {
   return impl->returnType;
 }
 
-zc::Maybe<const Statement&> MethodDeclaration::getBody() const { return impl->body; }
+zc::Maybe<const Statement&> MethodDeclaration::getBody() const { return impl->body.get(); }
+
+bool MethodDeclaration::isBodyDeferred() const { return impl->body.isDeferred(); }
 
 zc::Maybe<const symbol::SymbolTable&> MethodDeclaration::getLocals() const {
   return impl->getLocals();
@@ -2213,11 +1631,6 @@ void MethodDeclaration::setNextContainer(zc::Maybe<const LocalsContainer&> nextC
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind MethodDeclaration::getKind() const { return SyntaxKind::MethodDeclaration; }
-
-NodeFlags MethodDeclaration::getFlags() const { return NodeFlags::None; }
-void MethodDeclaration::setFlags(NodeFlags flags) {}
-
 void MethodDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> MethodDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -2226,17 +1639,7 @@ void MethodDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void MethodDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& MethodDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-struct InitDeclaration::Impl : private NamedDeclarationImpl,
-                               private LocalsContainerImpl,
-                               private NodeImpl {
+struct InitDeclaration::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
@@ -2246,9 +1649,8 @@ struct InitDeclaration::Impl : private NamedDeclarationImpl,
   Impl(zc::Vector<ast::SyntaxKind> m, zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> tp,
        zc::Vector<zc::Own<ParameterDeclaration>>&& p, zc::Maybe<zc::Own<ReturnTypeNode>> r,
        zc::Maybe<zc::Own<Statement>> b)
-      : NamedDeclarationImpl(zc::heap<Identifier>("init"_zc)),
+      : NamedDeclarationImpl(allocate<Identifier>("init"_zc)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::InitDeclaration),
         modifiers(zc::mv(m)),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         parameters(zc::mv(p)),
@@ -2262,10 +1664,6 @@ struct InitDeclaration::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 InitDeclaration::InitDeclaration(
@@ -2275,7 +1673,8 @@ InitDeclaration::InitDeclaration(
     zc::Maybe<zc::Own<ReturnTypeNode>> returnType, zc::Maybe<zc::Own<Statement>> body) noexcept
     : ClassElement(),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(typeParameters), zc::mv(parameters),
+      Node(SyntaxKind::InitDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(typeParameters), zc::mv(parameters),
                           zc::mv(returnType), zc::mv(body))) {}
 
 InitDeclaration::~InitDeclaration() noexcept(false) = default;
@@ -2317,11 +1716,6 @@ void InitDeclaration::setNextContainer(zc::Maybe<const LocalsContainer&> nextCon
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind InitDeclaration::getKind() const { return SyntaxKind::InitDeclaration; }
-
-NodeFlags InitDeclaration::getFlags() const { return NodeFlags::None; }
-void InitDeclaration::setFlags(NodeFlags flags) {}
-
 void InitDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> InitDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -2330,24 +1724,13 @@ void InitDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void InitDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& InitDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-struct DeinitDeclaration::Impl : private NamedDeclarationImpl,
-                                 private LocalsContainerImpl,
-                                 private NodeImpl {
+struct DeinitDeclaration::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<Statement>> body;
 
   Impl(zc::Vector<ast::SyntaxKind> m, zc::Maybe<zc::Own<Statement>> b)
-      : NamedDeclarationImpl(zc::heap<Identifier>("deinit"_zc)),
+      : NamedDeclarationImpl(allocate<Identifier>("deinit"_zc)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::DeinitDeclaration),
         modifiers(zc::mv(m)),
         body(zc::mv(b)) {}
 
@@ -2358,15 +1741,14 @@ struct DeinitDeclaration::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 DeinitDeclaration::DeinitDeclaration(zc::Vector<ast::SyntaxKind> modifiers,
                                      zc::Maybe<zc::Own<Statement>> body) noexcept
-    : ClassElement(), LocalsContainer(), impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(body))) {}
+    : ClassElement(),
+      LocalsContainer(),
+      Node(SyntaxKind::DeinitDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(body))) {}
 
 DeinitDeclaration::~DeinitDeclaration() noexcept(false) = default;
 
@@ -2397,11 +1779,6 @@ void DeinitDeclaration::setNextContainer(zc::Maybe<const LocalsContainer&> nextC
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind DeinitDeclaration::getKind() const { return SyntaxKind::DeinitDeclaration; }
-
-NodeFlags DeinitDeclaration::getFlags() const { return NodeFlags::None; }
-void DeinitDeclaration::setFlags(NodeFlags flags) {}
-
 void DeinitDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> DeinitDeclaration::getSymbol() const { return impl->getSymbol(); }
@@ -2410,17 +1787,7 @@ void DeinitDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) {
   impl->setSymbol(symbol);
 }
 
-void DeinitDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& DeinitDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-struct GetAccessor::Impl : private NamedDeclarationImpl,
-                           private LocalsContainerImpl,
-                           private NodeImpl {
+struct GetAccessor::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
@@ -2433,7 +1800,6 @@ struct GetAccessor::Impl : private NamedDeclarationImpl,
        zc::Maybe<zc::Own<Statement>> b)
       : NamedDeclarationImpl(zc::mv(n)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::GetAccessor),
         modifiers(zc::mv(m)),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         parameters(zc::mv(p)),
@@ -2447,10 +1813,6 @@ struct GetAccessor::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -2463,7 +1825,8 @@ GetAccessor::GetAccessor(zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifi
                          zc::Maybe<zc::Own<Statement>> body) noexcept
     : ClassElement(),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
+      Node(SyntaxKind::GetAccessor),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
                           zc::mv(parameters), zc::mv(returnType), zc::mv(body))) {}
 
 GetAccessor::~GetAccessor() noexcept(false) = default;
@@ -2501,29 +1864,16 @@ void GetAccessor::setNextContainer(zc::Maybe<const LocalsContainer&> nextContain
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind GetAccessor::getKind() const { return SyntaxKind::GetAccessor; }
-
-NodeFlags GetAccessor::getFlags() const { return NodeFlags::None; }
-void GetAccessor::setFlags(NodeFlags flags) {}
-
 void GetAccessor::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> GetAccessor::getSymbol() const { return impl->getSymbol(); }
 
 void GetAccessor::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) { impl->setSymbol(symbol); }
 
-void GetAccessor::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& GetAccessor::getSourceRange() const { return impl->getSourceRange(); }
-
 // ================================================================================
 // SetAccessor::Impl
 
-struct SetAccessor::Impl : private NamedDeclarationImpl,
-                           private LocalsContainerImpl,
-                           private NodeImpl {
+struct SetAccessor::Impl : private NamedDeclarationImpl, private LocalsContainerImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const NodeList<TypeParameterDeclaration> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
@@ -2536,7 +1886,6 @@ struct SetAccessor::Impl : private NamedDeclarationImpl,
        zc::Maybe<zc::Own<Statement>> b)
       : NamedDeclarationImpl(zc::mv(n)),
         LocalsContainerImpl(),
-        NodeImpl(SyntaxKind::SetAccessor),
         modifiers(zc::mv(m)),
         typeParameters(zc::mv(tp).orDefault(zc::Vector<zc::Own<TypeParameterDeclaration>>())),
         parameters(zc::mv(p)),
@@ -2550,10 +1899,6 @@ struct SetAccessor::Impl : private NamedDeclarationImpl,
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -2566,7 +1911,8 @@ SetAccessor::SetAccessor(zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifi
                          zc::Maybe<zc::Own<Statement>> body) noexcept
     : ClassElement(),
       LocalsContainer(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
+      Node(SyntaxKind::SetAccessor),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(typeParameters),
                           zc::mv(parameters), zc::mv(returnType), zc::mv(body))) {}
 
 SetAccessor::~SetAccessor() noexcept(false) = default;
@@ -2604,27 +1950,16 @@ void SetAccessor::setNextContainer(zc::Maybe<const LocalsContainer&> nextContain
   impl->setNextContainer(nextContainer);
 }
 
-SyntaxKind SetAccessor::getKind() const { return SyntaxKind::SetAccessor; }
-
-NodeFlags SetAccessor::getFlags() const { return NodeFlags::None; }
-void SetAccessor::setFlags(NodeFlags flags) {}
-
 void SetAccessor::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> SetAccessor::getSymbol() const { return impl->getSymbol(); }
 
 void SetAccessor::setSymbol(zc::Maybe<const symbol::Symbol&> symbol) { impl->setSymbol(symbol); }
 
-void SetAccessor::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& SetAccessor::getSourceRange() const { return impl->getSourceRange(); }
-
 // ================================================================================
 // PropertyDeclaration::Impl
 
-struct PropertyDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct PropertyDeclaration::Impl : private NamedDeclarationImpl {
   const zc::Vector<ast::SyntaxKind> modifiers;
   const zc::Maybe<zc::Own<TypeNode>> type;
   const zc::Maybe<zc::Own<Expression>> initializer;
@@ -2632,7 +1967,6 @@ struct PropertyDeclaration::Impl : private NamedDeclarationImpl, private NodeImp
   Impl(zc::Vector<ast::SyntaxKind> mods, zc::Own<Identifier> n, zc::Maybe<zc::Own<TypeNode>> t,
        zc::Maybe<zc::Own<Expression>> initializer)
       : NamedDeclarationImpl(zc::mv(n)),
-        NodeImpl(SyntaxKind::PropertyDeclaration),
         modifiers(zc::mv(mods)),
         type(zc::mv(t)),
         initializer(zc::mv(initializer)) {}
@@ -2640,10 +1974,6 @@ struct PropertyDeclaration::Impl : private NamedDeclarationImpl, private NodeImp
   using NamedDeclarationImpl::getName;
   using NamedDeclarationImpl::getSymbol;
   using NamedDeclarationImpl::setSymbol;
-  using NodeImpl::getFlags;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 // ================================================================================
@@ -2654,7 +1984,8 @@ PropertyDeclaration::PropertyDeclaration(zc::Vector<ast::SyntaxKind> modifiers,
                                          zc::Maybe<zc::Own<TypeNode>> type,
                                          zc::Maybe<zc::Own<Expression>> initializer) noexcept
     : ClassElement(),
-      impl(zc::heap<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(type), zc::mv(initializer))) {}
+      Node(SyntaxKind::PropertyDeclaration),
+      impl(allocate<Impl>(zc::mv(modifiers), zc::mv(name), zc::mv(type), zc::mv(initializer))) {}
 
 PropertyDeclaration::~PropertyDeclaration() noexcept(false) = default;
 
@@ -2673,21 +2004,8 @@ zc::Maybe<const Expression&> PropertyDeclaration::getInitializer() const {
   return impl->initializer;
 }
 
-SyntaxKind PropertyDeclaration::getKind() const { return SyntaxKind::PropertyDeclaration; }
-
-NodeFlags PropertyDeclaration::getFlags() const { return NodeFlags::None; }
-void PropertyDeclaration::setFlags(NodeFlags flags) {}
-
 void PropertyDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void PropertyDeclaration::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& PropertyDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 zc::Maybe<const symbol::Symbol&> PropertyDeclaration::getSymbol() const {
   return impl->getSymbol();
 }
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "zc/core/common.h"
+#include "zc/core/function.h"
 #include "zc/core/memory.h"
 #include "zc/core/one-of.h"
 #include "zomlang/compiler/ast/ast.h"
@@ -41,14 +42,10 @@ public:
   /// This is a pure virtual method that must be implemented by concrete Statement subclasses
   virtual void accept(Visitor& visitor) const = 0;
 
-  /// \brief Get the syntax kind of this statement
-  /// This is a pure virtual method that must be implemented by concrete Statement subclasses
-  virtual SyntaxKind getKind() const = 0;
-
   GENERATE_CLASSOF_IMPL(Statement);
 
 protected:
-  Statement() noexcept = default;
+  explicit Statement(SyntaxKind kind) noexcept : Node(kind) {}
 };
 
 // Base implementation class for Statement nodes
@@ -70,7 +67,7 @@ public:
   virtual const Statement& getBody() const = 0;
 
 protected:
-  IterationStatement() noexcept = default;
+  explicit IterationStatement(SyntaxKind kind) noexcept : Statement(kind) {}
 };
 
 class IterationStatementImpl : public StatementImpl {
@@ -167,7 +164,7 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(DeclarationStatement);
 
 protected:
-  DeclarationStatement() noexcept = default;
+  explicit DeclarationStatement(SyntaxKind kind) noexcept : Statement(kind) {}
 };
 
 class BindingElement final : public NamedDeclaration, public Node {
@@ -299,6 +296,14 @@ private:
   zc::Own<Impl> impl;
 };
 
+/// \brief A function body that was skipped while parsing and is parsed when first requested.
+///
+/// `parse` runs at most once, on the first call to the declaration's `getBody()`; concurrent first
+/// calls block until it returns. If it throws, the next call tries again.
+struct DeferredBody {
+  zc::Function<zc::Own<Statement>()> parse;
+};
+
 class FunctionDeclaration final : public DeclarationStatement, public LocalsContainer {
 public:
   FunctionDeclaration(zc::Own<Identifier> name,
@@ -306,6 +311,10 @@ public:
                       zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
                       zc::Maybe<zc::Own<ReturnTypeNode>> returnType,
                       zc::Own<Statement> body) noexcept;
+  FunctionDeclaration(zc::Own<Identifier> name,
+                      zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+                      zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+                      zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) noexcept;
   ~FunctionDeclaration() noexcept(false);
 
   ZC_DISALLOW_COPY_AND_MOVE(FunctionDeclaration);
@@ -319,9 +328,12 @@ public:
   /// \brief Get the return type of this function
   zc::Maybe<const ReturnTypeNode&> getReturnType() const;
 
-  /// \brief Get the body of this function
+  /// \brief Get the body of this function, parsing it first if it was deferred
   const Statement& getBody() const;
 
+  /// \brief True if the body was deferred and `getBody()` has not parsed it yet
+  bool isBodyDeferred() const;
+
   NODE_METHOD_DECLARE();
   NAMED_DECLARATION_METHOD_DECL();
   LOCALS_CONTAINER_METHOD_DECL();
@@ -491,10 +503,6 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(EmptyStatement);
 
   NODE_METHOD_DECLARE();
-
-private:
-  struct Impl;
-  zc::Own<Impl> impl;
 };
 
 class ForStatement final : public IterationStatement, public LocalsContainer {
@@ -611,10 +619,6 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(DebuggerStatement);
 
   NODE_METHOD_DECLARE();
-
-private:
-  struct Impl;
-  zc::Own<Impl> impl;
 };
 
 // ImportDeclaration and ExportDeclaration are defined in module.h
@@ -780,7 +784,7 @@ public:
   GENERATE_CLASSOF_IMPL(BindingPattern);
 
 protected:
-  BindingPattern() noexcept = default;
+  explicit BindingPattern(SyntaxKind kind) noexcept : Node(kind) {}
 };
 
 #define BINDING_PATTERN_METHOD_DECLARE() \
@@ -906,6 +910,11 @@ public:
                     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
                     zc::Maybe<zc::Own<ReturnTypeNode>> returnType = zc::none,
                     zc::Maybe<zc::Own<Statement>> body = zc::none) noexcept;
+  MethodDeclaration(zc::Vector<ast::SyntaxKind> modifiers, zc::Own<Identifier> name,
+                    zc::Maybe<zc::Own<ast::TokenNode>> optional,
+                    zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
+                    zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
+                    zc::Maybe<zc::Own<ReturnTypeNode>> returnType, DeferredBody body) noexcept;
   ~MethodDeclaration() noexcept(false);
 
   ZC_DISALLOW_COPY_AND_MOVE(MethodDeclaration);
@@ -916,6 +925,7 @@ public:
   const NodeList<ParameterDeclaration>& getParameters() const;
   zc::Maybe<const ReturnTypeNode&> getReturnType() const;
   zc::Maybe<const Statement&> getBody() const;
+  bool isBodyDeferred() const;
 
   NODE_METHOD_DECLARE();
   NAMED_DECLARATION_METHOD_DECL();
@@ -0,0 +1,90 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/type.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace _ {  // Private implementation details
+
+/// Kinds listed in ast-nodes.def whose class is only declared, or does not derive from Node, are
+/// never produced and fall through to ZC_UNREACHABLE.
+template <typename T>
+concept DispatchableNode = requires(const Node& node) { static_cast<const T&>(node); };
+
+}  // namespace _
+
+/// \brief Compile-time dispatched visitor for internal passes.
+///
+/// `dispatch()` switches on the node kind and calls `Derived::visit()` with the concrete node
+/// type, so a final visitor traverses the tree without the double virtual call of
+/// `Node::accept()` and `Visitor::visit()`, and its handlers can be inlined. Handlers are found by
+/// ordinary overload resolution, so a derived class may leave out node types and fall back on an
+/// overload for a base such as `visit(const Expression&)`. Token nodes carry their token kind
+/// rather than `SyntaxKind::TokenNode` and are dispatched as `TokenNode`.
+///
+/// The virtual `Visitor` stays the extension point for visitors that are not known here, such as
+/// plugins; a class may implement both and route its own traversal through `dispatch()`.
+///
+/// \code
+/// class Counter final : public StaticVisitor<Counter, size_t> {
+/// public:
+///   size_t visit(const BinaryExpression& node) {
+///     return 1 + dispatch(node.getLeft()) + dispatch(node.getRight());
+///   }
+///   size_t visit(const Node&) { return 1; }
+/// };
+/// \endcode
+template <typename Derived, typename Result = void>
+class StaticVisitor {
+public:
+  Result dispatch(const Node& node) {
+    switch (node.getKind()) {
+#define AST_ELEMENT_NODE(ClassName, ...) \
+  case SyntaxKind::ClassName:            \
+    return visitAs<ClassName>(node);
+#include "zomlang/compiler/ast/ast-nodes.def"
+#undef AST_ELEMENT_NODE
+      default:
+        return visitAs<TokenNode>(node);
+    }
+  }
+
+protected:
+  StaticVisitor() = default;
+
+private:
+  template <typename T>
+  Result visitAs(const Node& node) {
+    if constexpr (_::DispatchableNode<T>) {
+      return static_cast<Derived&>(*this).visit(static_cast<const T&>(node));
+    } else {
+      ZC_UNREACHABLE;
+    }
+  }
+};
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,151 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/statistics.h"
+
+#include <algorithm>
+
+#include "zc/core/vector.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/walker.h"
+#include "zomlang/compiler/basic/string-escape.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+/// Token nodes carry their token kind; statistics count them all as `TokenNode`.
+SyntaxKind statisticsKind(SyntaxKind kind) {
+  switch (kind) {
+#define AST_ELEMENT_NODE(ClassName, ...) case SyntaxKind::ClassName:
+#include "zomlang/compiler/ast/ast-nodes.def"
+#undef AST_ELEMENT_NODE
+      return kind;
+    default:
+      return SyntaxKind::TokenNode;
+  }
+}
+
+class NodeCounter final : public NodeWalker {
+public:
+  explicit NodeCounter(TreeStatistics& statistics) : statistics(statistics) {}
+
+private:
+  TreeStatistics& statistics;
+
+  void enter(const Node& node) override {
+    ++statistics.kinds[static_cast<size_t>(statisticsKind(node.getKind()))].nodes;
+  }
+};
+
+void addAllocations(TreeStatistics& statistics, const AllocationStats& allocations) {
+  for (size_t i = 0; i < statistics.kinds.size(); ++i) {
+    const AllocationStats::Entry& entry = allocations.get(static_cast<SyntaxKind>(i));
+    TreeStatistics::KindEntry& kind =
+        statistics.kinds[static_cast<size_t>(statisticsKind(static_cast<SyntaxKind>(i)))];
+    kind.allocatedNodes += entry.nodes;
+    kind.bytes += entry.bytes;
+  }
+  statistics.unattributedBytes += allocations.getUnattributedBytes();
+}
+
+}  // namespace
+
+TreeStatistics::KindEntry TreeStatistics::getTotal() const {
+  KindEntry total;
+  for (const KindEntry& kind : kinds) {
+    total.nodes += kind.nodes;
+    total.allocatedNodes += kind.allocatedNodes;
+    total.bytes += kind.bytes;
+  }
+  return total;
+}
+
+double TreeStatistics::getBytesPerLine() const {
+  if (sourceLines == 0) { return 0; }
+  return static_cast<double>(getTotal().bytes) / static_cast<double>(sourceLines);
+}
+
+TreeStatistics collectTreeStatistics(const Node& root, zc::ArrayPtr<const zc::byte> source,
+                                     const AllocationStats& allocations) {
+  TreeStatistics statistics;
+  statistics.sourceBytes = source.size();
+  for (zc::byte c : source) {
+    if (c == '\n') { ++statistics.sourceLines; }
+  }
+  if (source.size() != 0 && source.back() != '\n') { ++statistics.sourceLines; }
+
+  ZC_IF_SOME(sourceFile, dyn_cast<SourceFile>(root)) {
+    statistics.fileName = zc::str(sourceFile.getFileName());
+    statistics.arenaBytes = sourceFile.getArenaBytes();
+  }
+
+  AllocationStats deferred;
+  {
+    AllocationStatsScope scope(deferred);
+    NodeCounter(statistics).walk(root);
+  }
+  addAllocations(statistics, allocations);
+  addAllocations(statistics, deferred);
+  return statistics;
+}
+
+zc::String statisticsToJson(zc::ArrayPtr<const TreeStatistics> files) {
+  zc::Vector<zc::String> fileObjects;
+  for (const TreeStatistics& file : files) {
+    zc::Vector<SyntaxKind> kinds;
+    for (size_t i = 0; i < file.kinds.size(); ++i) {
+      const TreeStatistics::KindEntry& kind = file.kinds[i];
+      if (kind.nodes != 0 || kind.allocatedNodes != 0) { kinds.add(static_cast<SyntaxKind>(i)); }
+    }
+    std::sort(kinds.begin(), kinds.end(), [&](SyntaxKind a, SyntaxKind b) {
+      const size_t aBytes = file.kinds[static_cast<size_t>(a)].bytes;
+      const size_t bBytes = file.kinds[static_cast<size_t>(b)].bytes;
+      return aBytes != bBytes ? aBytes > bBytes : a < b;
+    });
+
+    zc::Vector<zc::String> kindObjects;
+    for (SyntaxKind kind : kinds) {
+      const TreeStatistics::KindEntry& entry = file.kinds[static_cast<size_t>(kind)];
+      kindObjects.add(zc::str("        {\"kind\": \"", _::syntaxKindToString(kind),
+                              "\", \"nodes\": ", entry.nodes,
+                              ", \"allocatedNodes\": ", entry.allocatedNodes,
+                              ", \"bytes\": ", entry.bytes, "}"));
+    }
+
+    const TreeStatistics::KindEntry total = file.getTotal();
+    fileObjects.add(zc::str(
+        "    {\n"
+        "      \"file\": \"", basic::escapeJsonString(file.fileName), "\",\n"
+        "      \"sourceBytes\": ", file.sourceBytes, ",\n"
+        "      \"lines\": ", file.sourceLines, ",\n"
+        "      \"nodes\": ", total.nodes, ",\n"
+        "      \"allocatedNodes\": ", total.allocatedNodes, ",\n"
+        "      \"allocatedBytes\": ", total.bytes, ",\n"
+        "      \"unattributedBytes\": ", file.unattributedBytes, ",\n"
+        "      \"arenaBytes\": ", file.arenaBytes, ",\n"
+        "      \"parseMicroseconds\": ", file.parseTime / zc::MICROSECONDS, ",\n"
+        "      \"bytesPerLine\": ", file.getBytesPerLine(), ",\n"
+        "      \"kinds\": [\n", zc::strArray(kindObjects, ",\n"), "\n      ]\n"
+        "    }"));
+  }
+  return zc::str("{\n  \"files\": [\n", zc::strArray(fileObjects, ",\n"), "\n  ]\n}\n");
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,74 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <array>
+
+#include "zc/core/array.h"
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/time.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/kinds.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+/// \brief Memory profile of one parsed tree, as reported by `zomc --stats=ast`.
+///
+/// Live node counts come from walking the finished tree. Allocation counts and bytes come from the
+/// `AllocationStats` recorded while it was parsed, so they also cover nodes that were discarded.
+/// Token nodes of every token kind are folded into `SyntaxKind::TokenNode`.
+struct TreeStatistics {
+  struct KindEntry {
+    /// Nodes of this kind in the tree
+    size_t nodes = 0;
+    /// Nodes of this kind allocated while parsing, discarded ones included
+    size_t allocatedNodes = 0;
+    /// Bytes of those nodes, with their implementation objects and child lists
+    size_t bytes = 0;
+  };
+
+  zc::String fileName;
+  size_t sourceBytes = 0;
+  size_t sourceLines = 0;
+  /// Heap bytes held by the arenas the tree lives in; they only grow, so this is their peak
+  size_t arenaBytes = 0;
+  /// Bytes allocated outside the construction of any node
+  size_t unattributedBytes = 0;
+  /// Wall time the driver spent lexing and parsing the file, left zero when not measured
+  zc::Duration parseTime = 0 * zc::NANOSECONDS;
+  std::array<KindEntry, static_cast<size_t>(SyntaxKind::Count)> kinds{};
+
+  KindEntry getTotal() const;
+  /// \brief Allocated node bytes per line of source.
+  double getBytesPerLine() const;
+};
+
+/// \brief Gather the statistics of the tree rooted at `root`.
+/// \param source Text the tree was parsed from
+/// \param allocations What was recorded while parsing it. Deferred function bodies are parsed by
+/// the walk and added on top.
+TreeStatistics collectTreeStatistics(const Node& root, zc::ArrayPtr<const zc::byte> source,
+                                     const AllocationStats& allocations);
+
+/// \brief Render the statistics of several files as one JSON document, with the kinds of each
+/// file ordered by bytes.
+zc::String statisticsToJson(zc::ArrayPtr<const TreeStatistics> files);
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,63 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/type-interner.h"
+
+#include "zc/core/map.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+struct TypeKey {
+  const TypeNode* type;
+
+  uint32_t hashCode() const { return type->hashCode(); }
+  bool operator==(const TypeKey& other) const { return isStructurallyEqual(*type, *other.type); }
+};
+
+}  // namespace
+
+struct TypeInterner::Impl {
+  zc::HashSet<TypeKey> types;
+  zc::Vector<zc::Own<TypeNode>> owned;
+};
+
+TypeInterner::TypeInterner() noexcept : impl(zc::heap<Impl>()) {}
+
+TypeInterner::~TypeInterner() noexcept(false) = default;
+
+const TypeNode& TypeInterner::intern(const TypeNode& type) {
+  return *impl->types.findOrCreate(TypeKey{&type}, [&]() { return TypeKey{&type}; }).type;
+}
+
+const TypeNode& TypeInterner::intern(zc::Own<TypeNode> type) {
+  const TypeNode& canonical = intern(*type);
+  if (&canonical == type.get()) { impl->owned.add(zc::mv(type)); }
+  return canonical;
+}
+
+zc::Maybe<const TypeNode&> TypeInterner::find(const TypeNode& type) const {
+  ZC_IF_SOME(key, impl->types.find(TypeKey{&type})) { return *key.type; }
+  return zc::none;
+}
+
+size_t TypeInterner::size() const { return impl->types.size(); }
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
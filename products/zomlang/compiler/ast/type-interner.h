@@ -0,0 +1,59 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zomlang/compiler/ast/type.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+/// \brief Table of canonical type nodes, one per distinct structure.
+///
+/// Annotations such as `i32` or `str | null` are spelled many times; interning maps every
+/// occurrence to one shared instance, so later stages compare types by address and keep a single
+/// copy of the ones they retain. Equality is `isStructurallyEqual()`, keyed on the cached
+/// `TypeNode::hashCode()`. Canonical instances are immutable.
+class TypeInterner {
+public:
+  TypeInterner() noexcept;
+  ~TypeInterner() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(TypeInterner);
+
+  /// \brief Get the canonical instance structurally equal to `type`. If there is none, `type`
+  /// becomes canonical and must outlive the interner.
+  const TypeNode& intern(const TypeNode& type);
+
+  /// \brief Like the overload above, but the interner takes ownership of `type`. If an equal
+  /// instance already exists, `type` is destroyed.
+  const TypeNode& intern(zc::Own<TypeNode> type);
+
+  /// \brief Find the canonical instance structurally equal to `type` without registering it.
+  zc::Maybe<const TypeNode&> find(const TypeNode& type) const;
+
+  /// \brief Number of distinct types interned.
+  size_t size() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,7 +14,9 @@
 
 #include "zomlang/compiler/ast/type.h"
 
+#include "zc/core/hash.h"
 #include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/cast.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/statement.h"
 #include "zomlang/compiler/ast/visitor.h"
@@ -37,429 +39,177 @@ struct NamedDeclarationImpl::Impl {
 };
 
 // TypeReference
-struct TypeReferenceNode::Impl : private NodeImpl {
+struct TypeReferenceNode::Impl {
   zc::Own<Identifier> name;
   zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments;
 
   explicit Impl(zc::Own<Identifier> name, zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments)
-      : NodeImpl(SyntaxKind::TypeReferenceNode),
-        name(zc::mv(name)),
-        typeArguments(zc::mv(typeArguments)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : name(zc::mv(name)), typeArguments(zc::mv(typeArguments)) {}
 };
 
 TypeReferenceNode::TypeReferenceNode(
     zc::Own<Identifier> name, zc::Maybe<zc::Vector<zc::Own<TypeNode>>> typeArguments) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(name), zc::mv(typeArguments))) {}
+    : TypeNode(SyntaxKind::TypeReferenceNode),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(typeArguments))) {}
 
 TypeReferenceNode::~TypeReferenceNode() noexcept(false) = default;
 
 const ast::Identifier& TypeReferenceNode::getName() const { return *impl->name; }
 
-void TypeReferenceNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& TypeReferenceNode::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind TypeReferenceNode::getKind() const { return impl->getKind(); }
-
-NodeFlags TypeReferenceNode::getFlags() const { return impl->getFlags(); }
-void TypeReferenceNode::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
+zc::Maybe<zc::ArrayPtr<const zc::Own<TypeNode>>> TypeReferenceNode::getTypeArguments() const {
+  return impl->typeArguments.map([](auto& typeArguments) { return typeArguments.asPtr(); });
 }
 
 void TypeReferenceNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ArrayTypeNode
-struct ArrayTypeNode::Impl : private NodeImpl {
+struct ArrayTypeNode::Impl {
   zc::Own<TypeNode> elementType;
 
-  explicit Impl(zc::Own<TypeNode> elementType)
-      : NodeImpl(SyntaxKind::ArrayTypeNode), elementType(zc::mv(elementType)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Own<TypeNode> elementType) : elementType(zc::mv(elementType)) {}
 };
 
 ArrayTypeNode::ArrayTypeNode(zc::Own<TypeNode> elementType) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(elementType))) {}
+    : TypeNode(SyntaxKind::ArrayTypeNode), impl(allocate<Impl>(zc::mv(elementType))) {}
 
 ArrayTypeNode::~ArrayTypeNode() noexcept(false) = default;
 
 const TypeNode& ArrayTypeNode::getElementType() const { return *impl->elementType; }
 
-SyntaxKind ArrayTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags ArrayTypeNode::getFlags() const { return impl->getFlags(); }
-void ArrayTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void ArrayTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ArrayTypeNode::getSourceRange() const { return impl->getSourceRange(); }
-
 void ArrayTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // UnionTypeNode
-struct UnionTypeNode::Impl : private NodeImpl {
+struct UnionTypeNode::Impl {
   NodeList<TypeNode> types;
 
-  explicit Impl(zc::Vector<zc::Own<TypeNode>>&& types)
-      : NodeImpl(SyntaxKind::UnionTypeNode), types(zc::mv(types)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<TypeNode>>&& types) : types(zc::mv(types)) {}
 };
 
 UnionTypeNode::UnionTypeNode(zc::Vector<zc::Own<TypeNode>>&& types) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(types))) {}
+    : TypeNode(SyntaxKind::UnionTypeNode), impl(allocate<Impl>(zc::mv(types))) {}
 
 UnionTypeNode::~UnionTypeNode() noexcept(false) = default;
 
 const NodeList<TypeNode>& UnionTypeNode::getTypes() const { return impl->types; }
 
-SyntaxKind UnionTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags UnionTypeNode::getFlags() const { return impl->getFlags(); }
-void UnionTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void UnionTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& UnionTypeNode::getSourceRange() const { return impl->getSourceRange(); }
-
 void UnionTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // IntersectionTypeNode
-struct IntersectionTypeNode::Impl : private NodeImpl {
+struct IntersectionTypeNode::Impl {
   NodeList<TypeNode> types;
 
-  explicit Impl(zc::Vector<zc::Own<TypeNode>>&& types)
-      : NodeImpl(SyntaxKind::IntersectionTypeNode), types(zc::mv(types)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Vector<zc::Own<TypeNode>>&& types) : types(zc::mv(types)) {}
 };
 
 IntersectionTypeNode::IntersectionTypeNode(zc::Vector<zc::Own<TypeNode>>&& types) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(types))) {}
+    : TypeNode(SyntaxKind::IntersectionTypeNode), impl(allocate<Impl>(zc::mv(types))) {}
 
 IntersectionTypeNode::~IntersectionTypeNode() noexcept(false) = default;
 
 const NodeList<TypeNode>& IntersectionTypeNode::getTypes() const { return impl->types; }
 
-SyntaxKind IntersectionTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags IntersectionTypeNode::getFlags() const { return impl->getFlags(); }
-void IntersectionTypeNode::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void IntersectionTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& IntersectionTypeNode::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void IntersectionTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ParenthesizedTypeNode
-struct ParenthesizedTypeNode::Impl : private NodeImpl {
+struct ParenthesizedTypeNode::Impl {
   zc::Own<TypeNode> type;
 
-  explicit Impl(zc::Own<TypeNode> type)
-      : NodeImpl(SyntaxKind::ParenthesizedTypeNode), type(zc::mv(type)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Own<TypeNode> type) : type(zc::mv(type)) {}
 };
 
 ParenthesizedTypeNode::ParenthesizedTypeNode(zc::Own<TypeNode> type) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(type))) {}
+    : TypeNode(SyntaxKind::ParenthesizedTypeNode), impl(allocate<Impl>(zc::mv(type))) {}
 
 ParenthesizedTypeNode::~ParenthesizedTypeNode() noexcept(false) = default;
 
 const TypeNode& ParenthesizedTypeNode::getType() const { return *impl->type; }
 
-SyntaxKind ParenthesizedTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags ParenthesizedTypeNode::getFlags() const { return impl->getFlags(); }
-void ParenthesizedTypeNode::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void ParenthesizedTypeNode::setSourceRange(const source::SourceRange&& range) {
-  impl->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ParenthesizedTypeNode::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void ParenthesizedTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // PredefinedType implementations
-BoolTypeNode::BoolTypeNode() noexcept : PredefinedTypeNode() {}
+BoolTypeNode::BoolTypeNode() noexcept : PredefinedTypeNode(SyntaxKind::BoolTypeNode) {}
 BoolTypeNode::~BoolTypeNode() noexcept(false) = default;
 zc::StringPtr BoolTypeNode::getName() const { return "bool"_zc; }
-SyntaxKind BoolTypeNode::getKind() const { return SyntaxKind::BoolTypeNode; }
-
-NodeFlags BoolTypeNode::getFlags() const { return NodeFlags::None; }
-void BoolTypeNode::setFlags(NodeFlags flags) {}
 
 void BoolTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void BoolTypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& BoolTypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-I8TypeNode::I8TypeNode() noexcept : PredefinedTypeNode() {}
+I8TypeNode::I8TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::I8TypeNode) {}
 I8TypeNode::~I8TypeNode() noexcept(false) = default;
 zc::StringPtr I8TypeNode::getName() const { return "i8"_zc; }
-SyntaxKind I8TypeNode::getKind() const { return SyntaxKind::I8TypeNode; }
-
-NodeFlags I8TypeNode::getFlags() const { return NodeFlags::None; }
-void I8TypeNode::setFlags(NodeFlags flags) {}
 
 void I8TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void I8TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& I8TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-I16TypeNode::I16TypeNode() noexcept : PredefinedTypeNode() {}
+I16TypeNode::I16TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::I16TypeNode) {}
 I16TypeNode::~I16TypeNode() noexcept(false) = default;
 zc::StringPtr I16TypeNode::getName() const { return "i16"_zc; }
-SyntaxKind I16TypeNode::getKind() const { return SyntaxKind::I16TypeNode; }
-
-NodeFlags I16TypeNode::getFlags() const { return NodeFlags::None; }
-void I16TypeNode::setFlags(NodeFlags flags) {}
 
 void I16TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void I16TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& I16TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-I32TypeNode::I32TypeNode() noexcept : PredefinedTypeNode() {}
+I32TypeNode::I32TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::I32TypeNode) {}
 I32TypeNode::~I32TypeNode() noexcept(false) = default;
 zc::StringPtr I32TypeNode::getName() const { return "i32"_zc; }
-SyntaxKind I32TypeNode::getKind() const { return SyntaxKind::I32TypeNode; }
-
-NodeFlags I32TypeNode::getFlags() const { return NodeFlags::None; }
-void I32TypeNode::setFlags(NodeFlags flags) {}
 
 void I32TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void I32TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& I32TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-I64TypeNode::I64TypeNode() noexcept : PredefinedTypeNode() {}
+I64TypeNode::I64TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::I64TypeNode) {}
 I64TypeNode::~I64TypeNode() noexcept(false) = default;
 zc::StringPtr I64TypeNode::getName() const { return "i64"_zc; }
-SyntaxKind I64TypeNode::getKind() const { return SyntaxKind::I64TypeNode; }
-
-NodeFlags I64TypeNode::getFlags() const { return NodeFlags::None; }
-void I64TypeNode::setFlags(NodeFlags flags) {}
 
 void I64TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void I64TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& I64TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-U8TypeNode::U8TypeNode() noexcept : PredefinedTypeNode() {}
+U8TypeNode::U8TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::U8TypeNode) {}
 U8TypeNode::~U8TypeNode() noexcept(false) = default;
 zc::StringPtr U8TypeNode::getName() const { return "u8"_zc; }
-SyntaxKind U8TypeNode::getKind() const { return SyntaxKind::U8TypeNode; }
-
-NodeFlags U8TypeNode::getFlags() const { return NodeFlags::None; }
-void U8TypeNode::setFlags(NodeFlags flags) {}
 
 void U8TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void U8TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& U8TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-U16TypeNode::U16TypeNode() noexcept : PredefinedTypeNode() {}
+U16TypeNode::U16TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::U16TypeNode) {}
 U16TypeNode::~U16TypeNode() noexcept(false) = default;
 zc::StringPtr U16TypeNode::getName() const { return "u16"_zc; }
-SyntaxKind U16TypeNode::getKind() const { return SyntaxKind::U16TypeNode; }
-
-NodeFlags U16TypeNode::getFlags() const { return NodeFlags::None; }
-void U16TypeNode::setFlags(NodeFlags flags) {}
 
 void U16TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void U16TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& U16TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-U32TypeNode::U32TypeNode() noexcept : PredefinedTypeNode() {}
+U32TypeNode::U32TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::U32TypeNode) {}
 U32TypeNode::~U32TypeNode() noexcept(false) = default;
 zc::StringPtr U32TypeNode::getName() const { return "u32"_zc; }
-SyntaxKind U32TypeNode::getKind() const { return SyntaxKind::U32TypeNode; }
-
-NodeFlags U32TypeNode::getFlags() const { return NodeFlags::None; }
-void U32TypeNode::setFlags(NodeFlags flags) {}
 
 void U32TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void U32TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& U32TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-U64TypeNode::U64TypeNode() noexcept : PredefinedTypeNode() {}
+U64TypeNode::U64TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::U64TypeNode) {}
 U64TypeNode::~U64TypeNode() noexcept(false) = default;
 zc::StringPtr U64TypeNode::getName() const { return "u64"_zc; }
-SyntaxKind U64TypeNode::getKind() const { return SyntaxKind::U64TypeNode; }
-
-NodeFlags U64TypeNode::getFlags() const { return NodeFlags::None; }
-void U64TypeNode::setFlags(NodeFlags flags) {}
 
 void U64TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void U64TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& U64TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-F32TypeNode::F32TypeNode() noexcept : PredefinedTypeNode() {}
+F32TypeNode::F32TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::F32TypeNode) {}
 F32TypeNode::~F32TypeNode() noexcept(false) = default;
 zc::StringPtr F32TypeNode::getName() const { return "f32"_zc; }
-SyntaxKind F32TypeNode::getKind() const { return SyntaxKind::F32TypeNode; }
-
-NodeFlags F32TypeNode::getFlags() const { return NodeFlags::None; }
-void F32TypeNode::setFlags(NodeFlags flags) {}
 
 void F32TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void F32TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& F32TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-F64TypeNode::F64TypeNode() noexcept : PredefinedTypeNode() {}
+F64TypeNode::F64TypeNode() noexcept : PredefinedTypeNode(SyntaxKind::F64TypeNode) {}
 F64TypeNode::~F64TypeNode() noexcept(false) = default;
 zc::StringPtr F64TypeNode::getName() const { return "f64"_zc; }
-SyntaxKind F64TypeNode::getKind() const { return SyntaxKind::F64TypeNode; }
-
-NodeFlags F64TypeNode::getFlags() const { return NodeFlags::None; }
-void F64TypeNode::setFlags(NodeFlags flags) {}
 
 void F64TypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void F64TypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& F64TypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-StrTypeNode::StrTypeNode() noexcept : PredefinedTypeNode() {}
+StrTypeNode::StrTypeNode() noexcept : PredefinedTypeNode(SyntaxKind::StrTypeNode) {}
 StrTypeNode::~StrTypeNode() noexcept(false) = default;
 zc::StringPtr StrTypeNode::getName() const { return "str"_zc; }
-SyntaxKind StrTypeNode::getKind() const { return SyntaxKind::StrTypeNode; }
-
-NodeFlags StrTypeNode::getFlags() const { return NodeFlags::None; }
-void StrTypeNode::setFlags(NodeFlags flags) {}
 
 void StrTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void StrTypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& StrTypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-UnitTypeNode::UnitTypeNode() noexcept : PredefinedTypeNode() {}
+UnitTypeNode::UnitTypeNode() noexcept : PredefinedTypeNode(SyntaxKind::UnitTypeNode) {}
 UnitTypeNode::~UnitTypeNode() noexcept(false) = default;
 zc::StringPtr UnitTypeNode::getName() const { return "unit"_zc; }
-SyntaxKind UnitTypeNode::getKind() const { return SyntaxKind::UnitTypeNode; }
-
-NodeFlags UnitTypeNode::getFlags() const { return NodeFlags::None; }
-void UnitTypeNode::setFlags(NodeFlags flags) {}
 
 void UnitTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void UnitTypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& UnitTypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
-NullTypeNode::NullTypeNode() noexcept : PredefinedTypeNode() {}
+NullTypeNode::NullTypeNode() noexcept : PredefinedTypeNode(SyntaxKind::NullTypeNode) {}
 NullTypeNode::~NullTypeNode() noexcept(false) = default;
 zc::StringPtr NullTypeNode::getName() const { return "null"_zc; }
-SyntaxKind NullTypeNode::getKind() const { return SyntaxKind::NullTypeNode; }
-
-NodeFlags NullTypeNode::getFlags() const { return NodeFlags::None; }
-void NullTypeNode::setFlags(NodeFlags flags) {}
 
 void NullTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
-void NullTypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for predefined types
-}
-const source::SourceRange& NullTypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
 
 // ObjectTypeNode
 struct ObjectTypeNode::Impl {
@@ -469,45 +219,24 @@ struct ObjectTypeNode::Impl {
 };
 
 ObjectTypeNode::ObjectTypeNode(zc::Vector<zc::Own<Node>>&& members) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(members))) {}
+    : TypeNode(SyntaxKind::ObjectTypeNode), impl(allocate<Impl>(zc::mv(members))) {}
 
 ObjectTypeNode::~ObjectTypeNode() noexcept(false) = default;
 
 const NodeList<Node>& ObjectTypeNode::getMembers() const { return impl->members; }
 
-SyntaxKind ObjectTypeNode::getKind() const { return SyntaxKind::ObjectTypeNode; }
-
-NodeFlags ObjectTypeNode::getFlags() const { return NodeFlags::None; }
-void ObjectTypeNode::setFlags(NodeFlags flags) {}
-
 void ObjectTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
-void ObjectTypeNode::setSourceRange(const source::SourceRange&& range) {
-  // TODO: Implement source range tracking for ObjectTypeNode
-}
-
-const source::SourceRange& ObjectTypeNode::getSourceRange() const {
-  static source::SourceRange empty;
-  return empty;
-}
-
 // NamedTupleElement
-struct NamedTupleElement::Impl : private NodeImpl {
+struct NamedTupleElement::Impl {
   zc::Own<Identifier> name;
   zc::Own<TypeNode> type;
 
-  Impl(zc::Own<Identifier> name, zc::Own<TypeNode> type)
-      : NodeImpl(SyntaxKind::NamedTupleElement), name(zc::mv(name)), type(zc::mv(type)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  Impl(zc::Own<Identifier> name, zc::Own<TypeNode> type) : name(zc::mv(name)), type(zc::mv(type)) {}
 };
 
 NamedTupleElement::NamedTupleElement(zc::Own<Identifier> name, zc::Own<TypeNode> type) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(name), zc::mv(type))) {}
+    : TypeNode(SyntaxKind::NamedTupleElement), impl(allocate<Impl>(zc::mv(name), zc::mv(type))) {}
 
 NamedTupleElement::~NamedTupleElement() noexcept(false) = default;
 
@@ -515,75 +244,37 @@ const Identifier& NamedTupleElement::getName() const { return *impl->name; }
 
 const TypeNode& NamedTupleElement::getType() const { return *impl->type; }
 
-SyntaxKind NamedTupleElement::getKind() const { return impl->getKind(); }
-
-NodeFlags NamedTupleElement::getFlags() const { return impl->getFlags(); }
-void NamedTupleElement::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
-void NamedTupleElement::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& NamedTupleElement::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void NamedTupleElement::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // TupleTypeNode
-struct TupleTypeNode::Impl : private NodeImpl {
+struct TupleTypeNode::Impl {
   NodeList<TypeNode> elementTypes;
 
   explicit Impl(zc::Vector<zc::Own<TypeNode>>&& elementTypes)
-      : NodeImpl(SyntaxKind::TupleTypeNode), elementTypes(zc::mv(elementTypes)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : elementTypes(zc::mv(elementTypes)) {}
 };
 
 TupleTypeNode::TupleTypeNode(zc::Vector<zc::Own<TypeNode>>&& elementTypes) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(elementTypes))) {}
+    : TypeNode(SyntaxKind::TupleTypeNode), impl(allocate<Impl>(zc::mv(elementTypes))) {}
 
 TupleTypeNode::~TupleTypeNode() noexcept(false) = default;
 
 const NodeList<TypeNode>& TupleTypeNode::getElementTypes() const { return impl->elementTypes; }
 
-SyntaxKind TupleTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags TupleTypeNode::getFlags() const { return impl->getFlags(); }
-void TupleTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void TupleTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& TupleTypeNode::getSourceRange() const { return impl->getSourceRange(); }
-
 void TupleTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // ReturnTypeNode
-struct ReturnTypeNode::Impl : private NodeImpl {
+struct ReturnTypeNode::Impl {
   zc::Own<TypeNode> type;
   zc::Maybe<zc::Own<TypeNode>> errorType;
 
   Impl(zc::Own<TypeNode> type, zc::Maybe<zc::Own<TypeNode>> errorType)
-      : NodeImpl(SyntaxKind::ReturnTypeNode), type(zc::mv(type)), errorType(zc::mv(errorType)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : type(zc::mv(type)), errorType(zc::mv(errorType)) {}
 };
 
 ReturnTypeNode::ReturnTypeNode(zc::Own<TypeNode> type,
                                zc::Maybe<zc::Own<TypeNode>> errorType) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(type), zc::mv(errorType))) {}
+    : TypeNode(SyntaxKind::ReturnTypeNode), impl(allocate<Impl>(zc::mv(type), zc::mv(errorType))) {}
 
 ReturnTypeNode::~ReturnTypeNode() noexcept(false) = default;
 
@@ -591,45 +282,27 @@ const TypeNode& ReturnTypeNode::getType() const { return *impl->type; }
 
 zc::Maybe<const TypeNode&> ReturnTypeNode::getErrorType() const { return impl->errorType; }
 
-void ReturnTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& ReturnTypeNode::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind ReturnTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags ReturnTypeNode::getFlags() const { return impl->getFlags(); }
-void ReturnTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
 void ReturnTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // FunctionTypeNode
-struct FunctionTypeNode::Impl : private NodeImpl {
+struct FunctionTypeNode::Impl {
   const zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters;
   const NodeList<ParameterDeclaration> parameters;
   const zc::Own<ReturnTypeNode> returnType;
 
   Impl(zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
        zc::Vector<zc::Own<ParameterDeclaration>>&& parameters, zc::Own<ReturnTypeNode> returnType)
-      : NodeImpl(SyntaxKind::FunctionTypeNode),
-        typeParameters(zc::mv(typeParameters)),
+      : typeParameters(zc::mv(typeParameters)),
         parameters(zc::mv(parameters)),
         returnType(zc::mv(returnType)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
 };
 
 FunctionTypeNode::FunctionTypeNode(
     zc::Maybe<zc::Vector<zc::Own<TypeParameterDeclaration>>> typeParameters,
     zc::Vector<zc::Own<ParameterDeclaration>>&& parameters,
     zc::Own<ReturnTypeNode> returnType) noexcept
-    : TypeNode(),
-      impl(zc::heap<Impl>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType))) {}
+    : TypeNode(SyntaxKind::FunctionTypeNode),
+      impl(allocate<Impl>(zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType))) {}
 
 FunctionTypeNode::~FunctionTypeNode() noexcept(false) = default;
 
@@ -644,106 +317,46 @@ const NodeList<ParameterDeclaration>& FunctionTypeNode::getParameters() const {
 
 const ReturnTypeNode& FunctionTypeNode::getReturnType() const { return *impl->returnType; }
 
-SyntaxKind FunctionTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags FunctionTypeNode::getFlags() const { return impl->getFlags(); }
-void FunctionTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void FunctionTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& FunctionTypeNode::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void FunctionTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // OptionalTypeNode
-struct OptionalTypeNode::Impl : private NodeImpl {
+struct OptionalTypeNode::Impl {
   zc::Own<TypeNode> type;
 
-  explicit Impl(zc::Own<TypeNode> type)
-      : NodeImpl(SyntaxKind::OptionalTypeNode), type(zc::mv(type)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Own<TypeNode> type) : type(zc::mv(type)) {}
 };
 
 OptionalTypeNode::OptionalTypeNode(zc::Own<TypeNode> type) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(type))) {}
+    : TypeNode(SyntaxKind::OptionalTypeNode), impl(allocate<Impl>(zc::mv(type))) {}
 
 OptionalTypeNode::~OptionalTypeNode() noexcept(false) = default;
 
 const TypeNode& OptionalTypeNode::getType() const { return *impl->type; }
 
-SyntaxKind OptionalTypeNode::getKind() const { return impl->getKind(); }
-
-NodeFlags OptionalTypeNode::getFlags() const { return impl->getFlags(); }
-void OptionalTypeNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
-void OptionalTypeNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& OptionalTypeNode::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
 void OptionalTypeNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // TypeQueryNode
-struct TypeQueryNode::Impl : private NodeImpl {
+struct TypeQueryNode::Impl {
   const zc::Own<Expression> expr;
 
-  explicit Impl(zc::Own<Expression> expr)
-      : NodeImpl(SyntaxKind::TypeQueryNode), expr(zc::mv(expr)) {}
-
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+  explicit Impl(zc::Own<Expression> expr) : expr(zc::mv(expr)) {}
 };
 
 TypeQueryNode::TypeQueryNode(zc::Own<Expression> expr) noexcept
-    : TypeNode(), impl(zc::heap<Impl>(zc::mv(expr))) {}
+    : TypeNode(SyntaxKind::TypeQueryNode), impl(allocate<Impl>(zc::mv(expr))) {}
 
 TypeQueryNode::~TypeQueryNode() noexcept(false) = default;
 
 const Expression& TypeQueryNode::getExpression() const { return *impl->expr; }
 
-void TypeQueryNode::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& TypeQueryNode::getSourceRange() const { return impl->getSourceRange(); }
-
-SyntaxKind TypeQueryNode::getKind() const { return impl->getKind(); }
-
-NodeFlags TypeQueryNode::getFlags() const { return impl->getFlags(); }
-void TypeQueryNode::setFlags(NodeFlags flags) { const_cast<Impl*>(impl.get())->setFlags(flags); }
-
 void TypeQueryNode::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 // TypeParameterDeclaration
-struct TypeParameterDeclaration::Impl : private NamedDeclarationImpl, private NodeImpl {
+struct TypeParameterDeclaration::Impl : private NamedDeclarationImpl {
   zc::Maybe<zc::Own<TypeNode>> constraint;
 
   Impl(zc::Own<Identifier> name, zc::Maybe<zc::Own<TypeNode>> constraint)
-      : NamedDeclarationImpl(zc::mv(name)),
-        NodeImpl(SyntaxKind::TypeParameterDeclaration),
-        constraint(zc::mv(constraint)) {}
-
-  // Forward NodeImpl methods
-  using NodeImpl::getFlags;
-  using NodeImpl::getKind;
-  using NodeImpl::getSourceRange;
-  using NodeImpl::setFlags;
-  using NodeImpl::setSourceRange;
+      : NamedDeclarationImpl(zc::mv(name)), constraint(zc::mv(constraint)) {}
 
   // Forward NamedDeclarationImpl methods
   using NamedDeclarationImpl::getName;
@@ -753,7 +366,8 @@ struct TypeParameterDeclaration::Impl : private NamedDeclarationImpl, private No
 
 TypeParameterDeclaration::TypeParameterDeclaration(zc::Own<Identifier> name,
                                                    zc::Maybe<zc::Own<TypeNode>> constraint) noexcept
-    : impl(zc::heap<Impl>(zc::mv(name), zc::mv(constraint))) {}
+    : Node(SyntaxKind::TypeParameterDeclaration),
+      impl(allocate<Impl>(zc::mv(name), zc::mv(constraint))) {}
 
 TypeParameterDeclaration::~TypeParameterDeclaration() noexcept(false) = default;
 
@@ -766,21 +380,6 @@ zc::Maybe<const TypeNode&> TypeParameterDeclaration::getConstraint() const {
   return impl->constraint;
 }
 
-void TypeParameterDeclaration::setSourceRange(const source::SourceRange&& range) {
-  const_cast<Impl*>(impl.get())->setSourceRange(zc::mv(range));
-}
-
-const source::SourceRange& TypeParameterDeclaration::getSourceRange() const {
-  return impl->getSourceRange();
-}
-
-SyntaxKind TypeParameterDeclaration::getKind() const { return impl->getKind(); }
-
-NodeFlags TypeParameterDeclaration::getFlags() const { return impl->getFlags(); }
-void TypeParameterDeclaration::setFlags(NodeFlags flags) {
-  const_cast<Impl*>(impl.get())->setFlags(flags);
-}
-
 void TypeParameterDeclaration::accept(Visitor& visitor) const { visitor.visit(*this); }
 
 zc::Maybe<const symbol::Symbol&> TypeParameterDeclaration::getSymbol() const {
@@ -791,6 +390,299 @@ void TypeParameterDeclaration::setSymbol(zc::Maybe<const symbol::Symbol&> symbol
   const_cast<Impl*>(impl.get())->setSymbol(symbol);
 }
 
+// ================================================================================
+// Structural hashing and equality
+
+namespace {
+
+using DeclarationName = zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>>;
+
+uint32_t hashPart(const Node& node);
+bool equalParts(const Node& a, const Node& b);
+
+uint32_t combine(uint32_t seed, uint32_t value) { return zc::hashCode(seed, value); }
+
+template <typename T>
+const T& deref(const T& node) {
+  return node;
+}
+
+template <typename T>
+const T& deref(const zc::Own<T>& node) {
+  return *node;
+}
+
+template <typename T>
+zc::ArrayPtr<const zc::Own<T>> orEmpty(zc::Maybe<zc::ArrayPtr<const zc::Own<T>>> list) {
+  return list.orDefault(nullptr);
+}
+
+template <typename T>
+uint32_t hashMaybe(zc::Maybe<const T&> node) {
+  ZC_IF_SOME(n, node) { return combine(1, hashPart(n)); }
+  return 0;
+}
+
+template <typename T>
+bool equalMaybes(zc::Maybe<const T&> a, zc::Maybe<const T&> b) {
+  ZC_IF_SOME(x, a) {
+    ZC_IF_SOME(y, b) { return equalParts(x, y); }
+    return false;
+  }
+  return b == zc::none;
+}
+
+template <typename List>
+uint32_t hashList(const List& list) {
+  uint32_t hash = zc::hashCode(list.size());
+  for (size_t i = 0; i < list.size(); ++i) { hash = combine(hash, hashPart(deref(list[i]))); }
+  return hash;
+}
+
+template <typename List>
+bool equalLists(const List& a, const List& b) {
+  if (a.size() != b.size()) { return false; }
+  for (size_t i = 0; i < a.size(); ++i) {
+    if (!equalParts(deref(a[i]), deref(b[i]))) { return false; }
+  }
+  return true;
+}
+
+uint32_t hashName(const DeclarationName& name) {
+  ZC_SWITCH_ONEOF(name) {
+    ZC_CASE_ONEOF(identifier, zc::Maybe<const Identifier&>) { return hashMaybe(identifier); }
+    ZC_CASE_ONEOF(pattern, zc::Maybe<const BindingPattern&>) {
+      return combine(2, hashMaybe(pattern));
+    }
+  }
+  ZC_UNREACHABLE;
+}
+
+bool equalNames(const DeclarationName& a, const DeclarationName& b) {
+  if (a.is<zc::Maybe<const Identifier&>>() && b.is<zc::Maybe<const Identifier&>>()) {
+    return equalMaybes(a.get<zc::Maybe<const Identifier&>>(),
+                       b.get<zc::Maybe<const Identifier&>>());
+  }
+  if (a.is<zc::Maybe<const BindingPattern&>>() && b.is<zc::Maybe<const BindingPattern&>>()) {
+    return equalMaybes(a.get<zc::Maybe<const BindingPattern&>>(),
+                       b.get<zc::Maybe<const BindingPattern&>>());
+  }
+  return false;
+}
+
+/// Hash of a node that may appear inside a type. Kinds without a structural encoding hash by
+/// identity, matching `equalParts()`.
+uint32_t hashPart(const Node& node) {
+  if (isa<TypeNode>(node)) { return cast<TypeNode>(node).hashCode(); }
+
+  const uint32_t kind = zc::hashCode(node.getKind());
+  switch (node.getKind()) {
+    case SyntaxKind::Identifier:
+      return combine(kind, zc::hashCode(cast<Identifier>(node).getText()));
+    case SyntaxKind::PropertyAccessExpression: {
+      const auto& access = cast<PropertyAccessExpression>(node);
+      return zc::hashCode(kind, hashPart(access.getExpression()), hashPart(access.getName()),
+                          access.isQuestionDot());
+    }
+    case SyntaxKind::ParameterDeclaration: {
+      const auto& parameter = cast<ParameterDeclaration>(node);
+      return zc::hashCode(kind, parameter.getModifiers(),
+                          parameter.getDotDotDotToken() != zc::none, hashName(parameter.getName()),
+                          parameter.getQuestionToken() != zc::none, hashMaybe(parameter.getType()),
+                          hashMaybe(parameter.getInitializer()));
+    }
+    case SyntaxKind::TypeParameterDeclaration: {
+      const auto& parameter = cast<TypeParameterDeclaration>(node);
+      return zc::hashCode(kind, hashName(parameter.getName()),
+                          hashMaybe(parameter.getConstraint()));
+    }
+    case SyntaxKind::PropertySignature: {
+      const auto& property = cast<PropertySignature>(node);
+      return zc::hashCode(kind, property.getModifiers(), hashName(property.getName()),
+                          property.isOptional(), hashMaybe(property.getType()),
+                          hashMaybe(property.getInitializer()));
+    }
+    case SyntaxKind::MethodSignature: {
+      const auto& method = cast<MethodSignature>(node);
+      return zc::hashCode(kind, method.getModifiers(), hashName(method.getName()),
+                          method.isOptional(), hashList(method.getTypeParameters()),
+                          hashList(method.getParameters()), hashMaybe(method.getReturnType()));
+    }
+    default:
+      return zc::hashCode(&node);
+  }
+}
+
+bool equalParts(const Node& a, const Node& b) {
+  if (&a == &b) { return true; }
+  if (a.getKind() != b.getKind()) { return false; }
+  if (isa<TypeNode>(a)) { return isStructurallyEqual(cast<TypeNode>(a), cast<TypeNode>(b)); }
+
+  switch (a.getKind()) {
+    case SyntaxKind::Identifier:
+      return cast<Identifier>(a).getText() == cast<Identifier>(b).getText();
+    case SyntaxKind::PropertyAccessExpression: {
+      const auto& x = cast<PropertyAccessExpression>(a);
+      const auto& y = cast<PropertyAccessExpression>(b);
+      return x.isQuestionDot() == y.isQuestionDot() &&
+             equalParts(x.getExpression(), y.getExpression()) &&
+             equalParts(x.getName(), y.getName());
+    }
+    case SyntaxKind::ParameterDeclaration: {
+      const auto& x = cast<ParameterDeclaration>(a);
+      const auto& y = cast<ParameterDeclaration>(b);
+      return x.getModifiers() == y.getModifiers() &&
+             (x.getDotDotDotToken() == zc::none) == (y.getDotDotDotToken() == zc::none) &&
+             (x.getQuestionToken() == zc::none) == (y.getQuestionToken() == zc::none) &&
+             equalNames(x.getName(), y.getName()) && equalMaybes(x.getType(), y.getType()) &&
+             equalMaybes(x.getInitializer(), y.getInitializer());
+    }
+    case SyntaxKind::TypeParameterDeclaration: {
+      const auto& x = cast<TypeParameterDeclaration>(a);
+      const auto& y = cast<TypeParameterDeclaration>(b);
+      return equalNames(x.getName(), y.getName()) &&
+             equalMaybes(x.getConstraint(), y.getConstraint());
+    }
+    case SyntaxKind::PropertySignature: {
+      const auto& x = cast<PropertySignature>(a);
+      const auto& y = cast<PropertySignature>(b);
+      return x.getModifiers() == y.getModifiers() && x.isOptional() == y.isOptional() &&
+             equalNames(x.getName(), y.getName()) && equalMaybes(x.getType(), y.getType()) &&
+             equalMaybes(x.getInitializer(), y.getInitializer());
+    }
+    case SyntaxKind::MethodSignature: {
+      const auto& x = cast<MethodSignature>(a);
+      const auto& y = cast<MethodSignature>(b);
+      return x.getModifiers() == y.getModifiers() && x.isOptional() == y.isOptional() &&
+             equalNames(x.getName(), y.getName()) &&
+             equalLists(x.getTypeParameters(), y.getTypeParameters()) &&
+             equalLists(x.getParameters(), y.getParameters()) &&
+             equalMaybes(x.getReturnType(), y.getReturnType());
+    }
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+uint32_t TypeNode::hashCode() const {
+  if (cachedHash != 0) { return cachedHash; }
+
+  const uint32_t kind = zc::hashCode(getKind());
+  uint32_t hash = kind;
+  switch (getKind()) {
+    case SyntaxKind::TypeReferenceNode: {
+      const auto& node = cast<TypeReferenceNode>(*this);
+      hash = zc::hashCode(kind, hashPart(node.getName()),
+                          hashList(orEmpty(node.getTypeArguments())));
+      break;
+    }
+    case SyntaxKind::ArrayTypeNode:
+      hash = combine(kind, cast<ArrayTypeNode>(*this).getElementType().hashCode());
+      break;
+    case SyntaxKind::UnionTypeNode:
+      hash = combine(kind, hashList(cast<UnionTypeNode>(*this).getTypes()));
+      break;
+    case SyntaxKind::IntersectionTypeNode:
+      hash = combine(kind, hashList(cast<IntersectionTypeNode>(*this).getTypes()));
+      break;
+    case SyntaxKind::ParenthesizedTypeNode:
+      hash = combine(kind, cast<ParenthesizedTypeNode>(*this).getType().hashCode());
+      break;
+    case SyntaxKind::OptionalTypeNode:
+      hash = combine(kind, cast<OptionalTypeNode>(*this).getType().hashCode());
+      break;
+    case SyntaxKind::ObjectTypeNode:
+      hash = combine(kind, hashList(cast<ObjectTypeNode>(*this).getMembers()));
+      break;
+    case SyntaxKind::NamedTupleElement: {
+      const auto& node = cast<NamedTupleElement>(*this);
+      hash = zc::hashCode(kind, hashPart(node.getName()), node.getType().hashCode());
+      break;
+    }
+    case SyntaxKind::TupleTypeNode:
+      hash = combine(kind, hashList(cast<TupleTypeNode>(*this).getElementTypes()));
+      break;
+    case SyntaxKind::ReturnTypeNode: {
+      const auto& node = cast<ReturnTypeNode>(*this);
+      hash = zc::hashCode(kind, node.getType().hashCode(), hashMaybe(node.getErrorType()));
+      break;
+    }
+    case SyntaxKind::FunctionTypeNode: {
+      const auto& node = cast<FunctionTypeNode>(*this);
+      hash = zc::hashCode(kind, hashList(orEmpty(node.getTypeParameters())),
+                          hashList(node.getParameters()), node.getReturnType().hashCode());
+      break;
+    }
+    case SyntaxKind::TypeQueryNode:
+      hash = combine(kind, hashPart(cast<TypeQueryNode>(*this).getExpression()));
+      break;
+    default:
+      // Predefined types are fully described by their kind.
+      break;
+  }
+
+  cachedHash = hash == 0 ? 1 : hash;
+  return cachedHash;
+}
+
+bool isStructurallyEqual(const TypeNode& a, const TypeNode& b) {
+  if (&a == &b) { return true; }
+  if (a.getKind() != b.getKind() || a.hashCode() != b.hashCode()) { return false; }
+
+  switch (a.getKind()) {
+    case SyntaxKind::TypeReferenceNode: {
+      const auto& x = cast<TypeReferenceNode>(a);
+      const auto& y = cast<TypeReferenceNode>(b);
+      return equalParts(x.getName(), y.getName()) &&
+             equalLists(orEmpty(x.getTypeArguments()), orEmpty(y.getTypeArguments()));
+    }
+    case SyntaxKind::ArrayTypeNode:
+      return isStructurallyEqual(cast<ArrayTypeNode>(a).getElementType(),
+                                 cast<ArrayTypeNode>(b).getElementType());
+    case SyntaxKind::UnionTypeNode:
+      return equalLists(cast<UnionTypeNode>(a).getTypes(), cast<UnionTypeNode>(b).getTypes());
+    case SyntaxKind::IntersectionTypeNode:
+      return equalLists(cast<IntersectionTypeNode>(a).getTypes(),
+                        cast<IntersectionTypeNode>(b).getTypes());
+    case SyntaxKind::ParenthesizedTypeNode:
+      return isStructurallyEqual(cast<ParenthesizedTypeNode>(a).getType(),
+                                 cast<ParenthesizedTypeNode>(b).getType());
+    case SyntaxKind::OptionalTypeNode:
+      return isStructurallyEqual(cast<OptionalTypeNode>(a).getType(),
+                                 cast<OptionalTypeNode>(b).getType());
+    case SyntaxKind::ObjectTypeNode:
+      return equalLists(cast<ObjectTypeNode>(a).getMembers(), cast<ObjectTypeNode>(b).getMembers());
+    case SyntaxKind::NamedTupleElement: {
+      const auto& x = cast<NamedTupleElement>(a);
+      const auto& y = cast<NamedTupleElement>(b);
+      return equalParts(x.getName(), y.getName()) && isStructurallyEqual(x.getType(), y.getType());
+    }
+    case SyntaxKind::TupleTypeNode:
+      return equalLists(cast<TupleTypeNode>(a).getElementTypes(),
+                        cast<TupleTypeNode>(b).getElementTypes());
+    case SyntaxKind::ReturnTypeNode: {
+      const auto& x = cast<ReturnTypeNode>(a);
+      const auto& y = cast<ReturnTypeNode>(b);
+      return isStructurallyEqual(x.getType(), y.getType()) &&
+             equalMaybes(x.getErrorType(), y.getErrorType());
+    }
+    case SyntaxKind::FunctionTypeNode: {
+      const auto& x = cast<FunctionTypeNode>(a);
+      const auto& y = cast<FunctionTypeNode>(b);
+      return equalLists(orEmpty(x.getTypeParameters()), orEmpty(y.getTypeParameters())) &&
+             equalLists(x.getParameters(), y.getParameters()) &&
+             isStructurallyEqual(x.getReturnType(), y.getReturnType());
+    }
+    case SyntaxKind::TypeQueryNode:
+      return equalParts(cast<TypeQueryNode>(a).getExpression(),
+                        cast<TypeQueryNode>(b).getExpression());
+    default:
+      return true;
+  }
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
@@ -40,10 +40,26 @@ public:
   /// \brief Check if a node is a TypeNode
   GENERATE_CLASSOF_IMPL(TypeNode)
 
+  /// \brief Structural hash of this type, ignoring source ranges. Computed on first use and
+  /// cached, so the type must not change afterwards. Types that are `isStructurallyEqual()` hash
+  /// the same, which lets `zc::HashMap` and `TypeInterner` key on them.
+  uint32_t hashCode() const;
+
 protected:
-  using Node::Node;
+  explicit TypeNode(SyntaxKind kind) noexcept : Node(kind) {}
+
+private:
+  /// Zero until computed; a computed hash of zero is stored as one.
+  mutable uint32_t cachedHash = 0;
 };
 
+/// \brief Check whether two types are spelled with the same structure, ignoring source ranges.
+///
+/// Types compare by kind, names, modifiers and their component types. Parts with no structural
+/// encoding, such as binding-pattern parameter names, default values and non-name `typeof`
+/// operands, only match themselves.
+bool isStructurallyEqual(const TypeNode& a, const TypeNode& b);
+
 // ================================================================================
 // PredefinedTypeNode
 
@@ -58,7 +74,7 @@ public:
   GENERATE_CLASSOF_IMPL(PredefinedTypeNode)
 
 protected:
-  PredefinedTypeNode() noexcept = default;
+  explicit PredefinedTypeNode(SyntaxKind kind) noexcept : TypeNode(kind) {}
 };
 
 // ================================================================================
@@ -73,6 +89,7 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(TypeReferenceNode);
 
   const Identifier& getName() const;
+  zc::Maybe<zc::ArrayPtr<const zc::Own<TypeNode>>> getTypeArguments() const;
 
   NODE_METHOD_DECLARE();
 
@@ -35,7 +35,8 @@ namespace ast {
 ///
 /// The visitor pattern allows for separation of concerns between the AST structure
 /// and the operations performed on it, making it easier to add new operations
-/// without modifying the AST node classes.
+/// without modifying the AST node classes. Passes inside the compiler that traverse whole trees
+/// can use `StaticVisitor` from static-visitor.h to avoid the virtual dispatch.
 class Visitor {
 public:
   ZC_DISALLOW_COPY_AND_MOVE(Visitor);
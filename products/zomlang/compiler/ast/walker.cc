@@ -0,0 +1,892 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/walker.h"
+
+#include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/type.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+void visitName(NodeWalker& walker,
+               zc::OneOf<zc::Maybe<const Identifier&>, zc::Maybe<const BindingPattern&>> name) {
+  ZC_SWITCH_ONEOF(name) {
+    ZC_CASE_ONEOF(maybeId, zc::Maybe<const Identifier&>) {
+      ZC_IF_SOME(id, maybeId) { walker.dispatch(id); }
+    }
+    ZC_CASE_ONEOF(maybePattern, zc::Maybe<const BindingPattern&>) {
+      ZC_IF_SOME(pattern, maybePattern) { walker.dispatch(pattern); }
+    }
+  }
+}
+
+void visitName(NodeWalker& walker, const Identifier& name) { walker.dispatch(name); }
+
+}  // namespace
+
+void NodeWalker::visit(const SourceFile& node) {
+  enter(node);
+  ZC_IF_SOME(moduleDeclaration, node.getModuleDeclaration()) { dispatch(moduleDeclaration); }
+  const auto& statements = node.getStatements();
+  for (const auto& stmt : statements) { dispatch(stmt); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ModuleDeclaration& node) {
+  enter(node);
+  dispatch(node.getModulePath());
+  leave(node);
+}
+
+void NodeWalker::visit(const ImportDeclaration& node) {
+  enter(node);
+  dispatch(node.getModulePath());
+  const auto& specifiers = node.getSpecifiers();
+  for (const auto& specifier : specifiers) { dispatch(specifier); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ImportSpecifier& node) {
+  enter(node);
+  dispatch(node.getImportedName());
+  ZC_IF_SOME(alias, node.getAlias()) { dispatch(alias); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ExportDeclaration& node) {
+  enter(node);
+  ZC_IF_SOME(modulePath, node.getModulePath()) { dispatch(modulePath); }
+  const auto& specifiers = node.getSpecifiers();
+  for (const auto& specifier : specifiers) { dispatch(specifier); }
+  ZC_IF_SOME(declaration, node.getDeclaration()) { dispatch(declaration); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ExportSpecifier& node) {
+  enter(node);
+  dispatch(node.getExportedName());
+  ZC_IF_SOME(alias, node.getAlias()) { dispatch(alias); }
+  leave(node);
+}
+
+void NodeWalker::visit(const VariableDeclarationList& node) {
+  enter(node);
+  const auto& bindings = node.getBindings();
+  for (const auto& binding : bindings) { dispatch(binding); }
+  leave(node);
+}
+
+void NodeWalker::visit(const VariableStatement& node) {
+  enter(node);
+  dispatch(node.getDeclarations());
+  leave(node);
+}
+
+void NodeWalker::visit(const FunctionDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& params = node.getParameters();
+  for (const auto& param : params) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const BlockStatement& node) {
+  enter(node);
+  const auto& statements = node.getStatements();
+  for (const auto& stmt : statements) { dispatch(stmt); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ExpressionStatement& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const EmptyStatement& node) { leaf(node); }
+
+void NodeWalker::visit(const BinaryExpression& node) {
+  enter(node);
+  dispatch(node.getLeft());
+  dispatch(node.getOperator());
+  dispatch(node.getRight());
+  leave(node);
+}
+
+void NodeWalker::visit(const StringLiteral& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const TemplateLiteralExpression& node) {
+  enter(node);
+  dispatch(node.getHead());
+  const auto& spans = node.getSpans();
+  for (const auto& span : spans) { dispatch(span); }
+  leave(node);
+}
+
+void NodeWalker::visit(const TemplateSpan& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  dispatch(node.getLiteral());
+  leave(node);
+}
+
+void NodeWalker::visit(const IntegerLiteral& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const FloatLiteral& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const BigIntLiteral& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const BooleanLiteral& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const NullLiteral& node) { leaf(node); }
+
+void NodeWalker::visit(const Identifier& node) {
+  enter(node);
+  leave(node);
+}
+
+void NodeWalker::visit(const PatternProperty& node) {
+  enter(node);
+  dispatch(node.getName());
+  ZC_IF_SOME(pattern, node.getPattern()) { dispatch(pattern); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ParenthesizedExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const Node& node) { dispatch(node); }
+
+void NodeWalker::visit(const Statement& node) { dispatch(node); }
+
+void NodeWalker::visit(const IterationStatement& node) { dispatch(node); }
+
+void NodeWalker::visit(const DeclarationStatement& node) {
+  dispatch(static_cast<const Statement&>(node));
+}
+
+void NodeWalker::visit(const Expression& node) { dispatch(node); }
+
+void NodeWalker::visit(const BindingElement& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(pattern, node.getBindingPattern()) { dispatch(pattern); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ClassElement& node) { node.accept(*this); }
+
+void NodeWalker::visit(const InterfaceElement& node) { node.accept(*this); }
+
+void NodeWalker::visit(const ModulePath& node) {
+  enter(node);
+  const auto& segments = node.getSegments();
+  for (const auto& segment : segments) { dispatch(segment); }
+  leave(node);
+}
+
+void NodeWalker::visit(const TypeParameterDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(constraint, node.getConstraint()) { dispatch(constraint); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ClassDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& heritageClauses = node.getHeritageClauses();
+  for (const auto& clause : heritageClauses) { dispatch(clause); }
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { member.accept(*this); }
+  leave(node);
+}
+
+void NodeWalker::visit(const InterfaceDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& heritageClauses = node.getHeritageClauses();
+  for (const auto& clause : heritageClauses) { dispatch(clause); }
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { member.accept(*this); }
+  leave(node);
+}
+
+void NodeWalker::visit(const StructDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& heritageClauses = node.getHeritageClauses();
+  for (const auto& clause : heritageClauses) { dispatch(clause); }
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { member.accept(*this); }
+  leave(node);
+}
+
+void NodeWalker::visit(const EnumMember& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(initializer, node.getInitializer()) { dispatch(initializer); }
+  ZC_IF_SOME(tupleType, node.getTupleType()) { dispatch(tupleType); }
+  leave(node);
+}
+
+void NodeWalker::visit(const EnumDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { dispatch(member); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ErrorDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { dispatch(member); }
+  leave(node);
+}
+
+void NodeWalker::visit(const AliasDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  dispatch(node.getType());
+  leave(node);
+}
+
+void NodeWalker::visit(const IfStatement& node) {
+  enter(node);
+  dispatch(node.getCondition());
+  dispatch(node.getThenStatement());
+  ZC_IF_SOME(elseStatement, node.getElseStatement()) { dispatch(elseStatement); }
+  leave(node);
+}
+
+void NodeWalker::visit(const WhileStatement& node) {
+  enter(node);
+  dispatch(node.getCondition());
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const ForStatement& node) {
+  enter(node);
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  ZC_IF_SOME(cond, node.getCondition()) { dispatch(cond); }
+  ZC_IF_SOME(upd, node.getUpdate()) { dispatch(upd); }
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const ForInStatement& node) {
+  enter(node);
+  dispatch(node.getInitializer());
+  dispatch(node.getExpression());
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const LabeledStatement& node) {
+  enter(node);
+  dispatch(node.getLabel());
+  dispatch(node.getStatement());
+  leave(node);
+}
+
+void NodeWalker::visit(const BreakStatement& node) {
+  enter(node);
+  ZC_IF_SOME(label, node.getLabel()) { dispatch(label); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ContinueStatement& node) {
+  enter(node);
+  ZC_IF_SOME(label, node.getLabel()) { dispatch(label); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ReturnStatement& node) {
+  enter(node);
+  ZC_IF_SOME(expr, node.getExpression()) { dispatch(expr); }
+  leave(node);
+}
+
+void NodeWalker::visit(const MatchStatement& node) {
+  enter(node);
+  dispatch(node.getDiscriminant());
+  const auto& clauses = node.getClauses();
+  for (const auto& clause : clauses) { dispatch(clause); }
+  leave(node);
+}
+
+void NodeWalker::visit(const MatchClause& node) {
+  enter(node);
+  dispatch(node.getPattern());
+  ZC_IF_SOME(guard, node.getGuard()) { dispatch(guard); }
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const DefaultClause& node) {
+  enter(node);
+  const auto& statements = node.getStatements();
+  for (const auto& stmt : statements) { dispatch(stmt); }
+  leave(node);
+}
+
+void NodeWalker::visit(const DebuggerStatement& node) { leaf(node); }
+
+void NodeWalker::visit(const UnaryExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const UpdateExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const PrefixUnaryExpression& node) {
+  enter(node);
+  dispatch(node.getOperand());
+  leave(node);
+}
+
+void NodeWalker::visit(const PostfixUnaryExpression& node) {
+  enter(node);
+  dispatch(node.getOperand());
+  leave(node);
+}
+
+void NodeWalker::visit(const LeftHandSideExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const MemberExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const PrimaryExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const PropertyAccessExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  visitName(*this, node.getName());
+  leave(node);
+}
+
+void NodeWalker::visit(const ElementAccessExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  dispatch(node.getIndex());
+  leave(node);
+}
+
+void NodeWalker::visit(const NewExpression& node) {
+  enter(node);
+  dispatch(node.getCallee());
+  ZC_IF_SOME(args, node.getArguments()) {
+    for (const auto& arg : args) { dispatch(*arg); }
+  }
+  leave(node);
+}
+
+void NodeWalker::visit(const ConditionalExpression& node) {
+  enter(node);
+  dispatch(node.getTest());
+  dispatch(node.getConsequent());
+  dispatch(node.getAlternate());
+  leave(node);
+}
+
+void NodeWalker::visit(const CallExpression& node) {
+  enter(node);
+  dispatch(node.getCallee());
+  const auto& args = node.getArguments();
+  for (const auto& arg : args) { dispatch(arg); }
+  leave(node);
+}
+
+void NodeWalker::visit(const LiteralExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const CastExpression& node) { dispatch(node); }
+
+void NodeWalker::visit(const AsExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
+  leave(node);
+}
+
+void NodeWalker::visit(const ForcedAsExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
+  leave(node);
+}
+
+void NodeWalker::visit(const ConditionalAsExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
+  leave(node);
+}
+
+void NodeWalker::visit(const NonNullExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const ExpressionWithTypeArguments& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  const auto& typeArguments = node.getTypeArguments();
+  ZC_IF_SOME(args, typeArguments) {
+    for (const auto& typeArg : args) { dispatch(typeArg); }
+  }
+  leave(node);
+}
+
+void NodeWalker::visit(const HeritageClause& node) {
+  enter(node);
+  const auto& types = node.getTypes();
+  for (const auto& t : types) { dispatch(*t); }
+  leave(node);
+}
+
+void NodeWalker::visit(const VoidExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const TypeOfExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const AwaitExpression& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const FunctionExpression& node) {
+  enter(node);
+  ZC_IF_SOME(typeParams, node.getTypeParameters()) {
+    for (const auto& param : typeParams) { dispatch(*param); }
+  }
+  const auto& params = node.getParameters();
+  for (const auto& param : params) { dispatch(param); }
+  const auto& captures = node.getCaptures();
+  for (const auto& capture : captures) { dispatch(capture); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  dispatch(node.getBody());
+  leave(node);
+}
+
+void NodeWalker::visit(const ArrayLiteralExpression& node) {
+  enter(node);
+  const auto& elements = node.getElements();
+  for (const auto& element : elements) { dispatch(element); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ObjectLiteralExpression& node) {
+  enter(node);
+  const auto& properties = node.getProperties();
+  for (const auto& prop : properties) { prop.accept(*this); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ObjectLiteralElement& node) { node.accept(*this); }
+
+void NodeWalker::visit(const PropertyAssignment& node) {
+  enter(node);
+  dispatch(node.getNameIdentifier());
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  ZC_IF_SOME(questionToken, node.getQuestionToken()) { dispatch(questionToken); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ShorthandPropertyAssignment& node) {
+  enter(node);
+  dispatch(node.getNameIdentifier());
+  ZC_IF_SOME(init, node.getObjectAssignmentInitializer()) { dispatch(init); }
+  ZC_IF_SOME(equalsToken, node.getEqualsToken()) { dispatch(equalsToken); }
+  leave(node);
+}
+
+void NodeWalker::visit(const SpreadAssignment& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const SpreadElement& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const TypeNode& node) { dispatch(node); }
+
+void NodeWalker::visit(const TokenNode& node) { leaf(node); }
+
+void NodeWalker::visit(const TypeReferenceNode& node) {
+  enter(node);
+  dispatch(node.getName());
+  leave(node);
+}
+
+void NodeWalker::visit(const ArrayTypeNode& node) {
+  enter(node);
+  dispatch(node.getElementType());
+  leave(node);
+}
+
+void NodeWalker::visit(const UnionTypeNode& node) {
+  enter(node);
+  const auto& types = node.getTypes();
+  for (const auto& type : types) { dispatch(type); }
+  leave(node);
+}
+
+void NodeWalker::visit(const IntersectionTypeNode& node) {
+  enter(node);
+  const auto& types = node.getTypes();
+  for (const auto& type : types) { dispatch(type); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ParenthesizedTypeNode& node) {
+  enter(node);
+  dispatch(node.getType());
+  leave(node);
+}
+
+void NodeWalker::visit(const PredefinedTypeNode& node) { dispatch(node); }
+
+void NodeWalker::visit(const Declaration& node) { node.accept(*this); }
+
+void NodeWalker::visit(const NamedDeclaration& node) { node.accept(*this); }
+
+void NodeWalker::visit(const Pattern& node) { dispatch(node); }
+
+void NodeWalker::visit(const PrimaryPattern& node) { dispatch(node); }
+
+void NodeWalker::visit(const BindingPattern& node) { dispatch(node); }
+
+void NodeWalker::visit(const ObjectTypeNode& node) {
+  enter(node);
+  const auto& members = node.getMembers();
+  for (const auto& member : members) { dispatch(member); }
+  leave(node);
+}
+
+void NodeWalker::visit(const TupleTypeNode& node) {
+  enter(node);
+  const auto& elementTypes = node.getElementTypes();
+  for (const auto& elementType : elementTypes) { dispatch(elementType); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ReturnTypeNode& node) {
+  enter(node);
+  dispatch(node.getType());
+  ZC_IF_SOME(errorType, node.getErrorType()) { dispatch(errorType); }
+  leave(node);
+}
+
+void NodeWalker::visit(const FunctionTypeNode& node) {
+  enter(node);
+  ZC_IF_SOME(typeParams, node.getTypeParameters()) {
+    for (const auto& param : typeParams) { dispatch(*param); }
+  }
+  const auto& params = node.getParameters();
+  for (const auto& param : params) { dispatch(param); }
+  dispatch(node.getReturnType());
+  leave(node);
+}
+
+void NodeWalker::visit(const OptionalTypeNode& node) {
+  enter(node);
+  dispatch(node.getType());
+  leave(node);
+}
+
+void NodeWalker::visit(const TypeQueryNode& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const NamedTupleElement& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  dispatch(node.getType());
+  leave(node);
+}
+
+void NodeWalker::visit(const MethodDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& parameters = node.getParameters();
+  for (const auto& param : parameters) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
+  leave(node);
+}
+
+void NodeWalker::visit(const GetAccessor& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& parameters = node.getParameters();
+  for (const auto& param : parameters) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
+  leave(node);
+}
+
+void NodeWalker::visit(const SetAccessor& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& parameters = node.getParameters();
+  for (const auto& param : parameters) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
+  leave(node);
+}
+
+void NodeWalker::visit(const InitDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& parameters = node.getParameters();
+  for (const auto& param : parameters) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
+  leave(node);
+}
+
+void NodeWalker::visit(const DeinitDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ParameterDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  leave(node);
+}
+
+void NodeWalker::visit(const PropertyDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  leave(node);
+}
+
+void NodeWalker::visit(const MissingDeclaration& node) {}
+
+void NodeWalker::visit(const SemicolonClassElement& node) { leaf(node); }
+
+void NodeWalker::visit(const SemicolonInterfaceElement& node) { leaf(node); }
+
+void NodeWalker::visit(const InterfaceBody& node) {}
+
+void NodeWalker::visit(const StructBody& node) {}
+
+void NodeWalker::visit(const ErrorBody& node) {}
+
+void NodeWalker::visit(const EnumBody& node) {}
+
+void NodeWalker::visit(const ArrayBindingPattern& node) {
+  enter(node);
+  const auto& elements = node.getElements();
+  for (const auto& element : elements) { dispatch(element); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ObjectBindingPattern& node) {
+  enter(node);
+  const auto& properties = node.getProperties();
+  for (const auto& prop : properties) { dispatch(prop); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ThisExpression& node) { leaf(node); }
+
+void NodeWalker::visit(const SuperExpression& node) {}
+
+void NodeWalker::visit(const BoolTypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const I8TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const I16TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const I32TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const I64TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const U8TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const U16TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const U32TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const U64TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const F32TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const F64TypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const StrTypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const UnitTypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const NullTypeNode& node) { leaf(node); }
+
+void NodeWalker::visit(const PropertySignature& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  leave(node);
+}
+
+void NodeWalker::visit(const MethodSignature& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  const auto& typeParameters = node.getTypeParameters();
+  for (const auto& param : typeParameters) { dispatch(param); }
+  const auto& parameters = node.getParameters();
+  for (const auto& param : parameters) { dispatch(param); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ClassBody& node) {}
+
+void NodeWalker::visit(const VariableDeclaration& node) {
+  enter(node);
+  visitName(*this, node.getName());
+  ZC_IF_SOME(type, node.getType()) { dispatch(type); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+  leave(node);
+}
+
+void NodeWalker::visit(const WildcardPattern& node) {
+  enter(node);
+  ZC_IF_SOME(type, node.getTypeAnnotation()) { dispatch(type); }
+  leave(node);
+}
+
+void NodeWalker::visit(const IdentifierPattern& node) {
+  enter(node);
+  dispatch(node.getIdentifier());
+  ZC_IF_SOME(type, node.getTypeAnnotation()) { dispatch(type); }
+  leave(node);
+}
+
+void NodeWalker::visit(const TuplePattern& node) {
+  enter(node);
+  const auto& elements = node.getElements();
+  for (const auto& element : elements) { dispatch(element); }
+  leave(node);
+}
+
+void NodeWalker::visit(const StructurePattern& node) {
+  enter(node);
+  const auto& properties = node.getProperties();
+  for (const auto& prop : properties) { dispatch(prop); }
+  leave(node);
+}
+
+void NodeWalker::visit(const ArrayPattern& node) {
+  enter(node);
+  const auto& elements = node.getElements();
+  for (const auto& element : elements) { dispatch(element); }
+  leave(node);
+}
+
+void NodeWalker::visit(const IsPattern& node) {
+  enter(node);
+  dispatch(node.getType());
+  leave(node);
+}
+
+void NodeWalker::visit(const ExpressionPattern& node) {
+  enter(node);
+  dispatch(node.getExpression());
+  leave(node);
+}
+
+void NodeWalker::visit(const EnumPattern& node) {
+  enter(node);
+  ZC_IF_SOME(typeReference, node.getTypeReference()) { dispatch(typeReference); }
+  dispatch(node.getPropertyName());
+  dispatch(node.getTuplePattern());
+  leave(node);
+}
+
+void NodeWalker::visit(const CaptureElement& node) {
+  enter(node);
+  ZC_IF_SOME(id, node.getIdentifier()) { dispatch(id); }
+  leave(node);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
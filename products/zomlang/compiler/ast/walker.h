@@ -0,0 +1,58 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/static-visitor.h"
+#include "zomlang/compiler/ast/visitor.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+/// \brief Depth-first walk over every node of a tree.
+///
+/// `enter()` is called for a node before any of its children and `leave()` after the last of
+/// them. Children are visited in source order, which is also the order ASTDumper writes them in.
+/// Deferred function bodies are parsed when the walk reaches them.
+class NodeWalker : public Visitor, public StaticVisitor<NodeWalker> {
+public:
+  ZC_DISALLOW_COPY_AND_MOVE(NodeWalker);
+
+  void walk(const Node& root) { dispatch(root); }
+
+#define AST_INTERFACE_NODE(ClassName, Parent) void visit(const ClassName& node) final;
+#define AST_ELEMENT_NODE(ClassName, ...) void visit(const ClassName& node) final;
+#include "zomlang/compiler/ast/ast-nodes.def"
+#undef AST_ELEMENT_NODE
+#undef AST_INTERFACE_NODE
+
+protected:
+  NodeWalker() = default;
+
+  virtual void enter(const Node& node) = 0;
+  virtual void leave(const Node&) {}
+
+private:
+  void leaf(const Node& node) {
+    enter(node);
+    leave(node);
+  }
+};
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -23,7 +23,8 @@ namespace basic {
 
 /// \brief Configuration options for the compiler frontend and backend.
 /// This class encapsulates all compiler-specific options that control
-/// compilation behavior, separate from language-specific options.
+/// compilation behavior, separate from language-specific options. An option that changes what
+/// the compiler produces must also be added to `basic::fingerprint()`.
 struct CompilerOptions {
   /// \brief Output and emission options
   struct EmissionOptions {
@@ -44,6 +45,19 @@ struct CompilerOptions {
     OutputType outputType = OutputType::Binary;
     /// Syntax only compilation
     bool syntaxOnly = false;
+    /// Directory receiving binary AST images, keyed by a hash of each source's content
+    zc::Maybe<zc::String> astCacheDir;
+    /// Record AST allocations per node kind while parsing, for `--stats=ast`
+    bool astStatisticsEnabled = false;
+    /// Report phase times and memory use after compiling, for `--time-report`; also records AST
+    /// allocations
+    bool timeReportEnabled = false;
+    /// Type check function bodies after binding, for `--type-check`
+    bool typeCheckEnabled = false;
+    /// Bind each top-level statement as soon as it is parsed, while its nodes are still in
+    /// cache, for `--bind-while-parsing`. `bindSources()` then skips the files already bound, and
+    /// binding diagnostics are reported with those of parsing.
+    bool bindWhileParsing = false;
 
     EmissionOptions() = default;
   };
@@ -68,9 +82,19 @@ struct CompilerOptions {
     DiagnosticOptions() = default;
   };
 
+  /// \brief Options for the worker threads the phases run on
+  struct ParallelOptions {
+    /// Where the workers run: anywhere, one per CPU, or spread over the NUMA nodes
+    enum class ThreadPlacement { kNone, kCores, kNodes };
+    ThreadPlacement threadPlacement = ThreadPlacement::kNone;
+
+    ParallelOptions() = default;
+  };
+
   EmissionOptions emission;
   OptimizationOptions optimization;
   DiagnosticOptions diagnostics;
+  ParallelOptions parallel;
 
   CompilerOptions() = default;
 };
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/basic/fingerprint.h"
+
+#include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+// A field added to the options changes their size and stops the build here. Add it to the
+// fingerprint below if it changes what the compiler produces, and update the size either way.
+static_assert(sizeof(LangOptions) == 16, "a language option is missing from fingerprint()");
+static_assert(sizeof(void*) != 8 || sizeof(CompilerOptions::EmissionOptions) == 88,
+              "an emission option is missing from fingerprint()");
+static_assert(sizeof(CompilerOptions::OptimizationOptions) == 8,
+              "an optimization option is missing from fingerprint()");
+static_assert(sizeof(CompilerOptions::DiagnosticOptions) == 8,
+              "a diagnostic option is missing from fingerprint()");
+static_assert(sizeof(CompilerOptions::ParallelOptions) == 4,
+              "a parallel option is missing from fingerprint()");
+
+uint64_t fingerprint(const LangOptions& options) {
+  return Fingerprint()
+      .add(options.useUnicode)
+      .add(options.allowDollarIdentifiers)
+      .add(options.supportRegexLiterals)
+      .get();
+}
+
+uint64_t fingerprint(const CompilerOptions& options) {
+  const auto& emission = options.emission;
+  return Fingerprint()
+      .add(emission.dumpASTEnabled)
+      .add(emission.serializerType)
+      .add(emission.outputType)
+      .add(emission.syntaxOnly)
+      .add(emission.typeCheckEnabled)
+      .add(options.optimization.level)
+      .add(options.optimization.enableDebugInfo)
+      .add(options.diagnostics.warningsAsErrors)
+      .add(options.diagnostics.maxErrors)
+      .get();
+}
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,72 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+struct LangOptions;
+struct CompilerOptions;
+
+/// \brief A 64-bit FNV-1a hash that is the same on every platform and in every run, for keying
+/// results that outlive the process, such as cache entries on disk.
+///
+/// Integers are hashed as eight little-endian bytes whatever their type, and strings with their
+/// length, so that adjacent values cannot run into each other.
+class Fingerprint {
+public:
+  Fingerprint& add(zc::ArrayPtr<const zc::byte> bytes) {
+    for (zc::byte b : bytes) { hash = (hash ^ b) * 0x100000001b3ull; }
+    return *this;
+  }
+
+  template <typename T>
+    requires std::is_integral_v<T> || std::is_enum_v<T>
+  Fingerprint& add(T value) {
+    const uint64_t bits = static_cast<uint64_t>(value);
+    zc::byte bytes[8];
+    for (int i = 0; i < 8; ++i) { bytes[i] = static_cast<zc::byte>(bits >> (i * 8)); }
+    return add(zc::arrayPtr(bytes));
+  }
+
+  Fingerprint& add(zc::StringPtr text) { return add(text.size()).add(text.asBytes()); }
+
+  uint64_t get() const { return hash; }
+
+private:
+  uint64_t hash = 0xcbf29ce484222325ull;
+};
+
+/// \brief The fingerprint of every language option that changes what lexing and parsing produce.
+/// Options that only change how they run, such as the AST arena or parallel parsing, are left
+/// out, so that changing them keeps the cached results.
+uint64_t fingerprint(const LangOptions& options);
+
+/// \brief The fingerprint of every compiler option that changes what the compiler produces: the
+/// output kind and format, optimization, and which diagnostics are reported. Where the output
+/// goes, what is reported about the compilation itself, and how its threads are placed are left
+/// out.
+uint64_t fingerprint(const CompilerOptions& options);
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
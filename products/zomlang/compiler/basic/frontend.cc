@@ -14,13 +14,25 @@
 
 #include "zomlang/compiler/basic/frontend.h"
 
+#include <thread>
+
+#include "zc/core/array.h"
+#include "zc/core/debug.h"
+#include "zc/core/vector.h"
 #include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/factory.h"
 #include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/walker.h"
 #include "zomlang/compiler/basic/string-pool.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/binder/binder.h"
+#include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 #include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/compiler/lexer/outline-scan.h"
 #include "zomlang/compiler/parser/parser.h"
 #include "zomlang/compiler/source/manager.h"
 #include "zomlang/compiler/symbol/symbol-table.h"
@@ -29,19 +41,176 @@ namespace zomlang {
 namespace compiler {
 namespace basic {
 
+namespace {
+
+/// Counts the diagnostics an engine emits.
+class DiagnosticCounter final : public diagnostics::DiagnosticConsumer {
+public:
+  explicit DiagnosticCounter(size_t& count) : count(count) {}
+
+  void handleDiagnostic(const source::SourceManager&, const diagnostics::Diagnostic&) override {
+    ++count;
+  }
+
+private:
+  size_t& count;
+};
+
+/// Parse `bufferId` in chunks on `threadPool`, each chunk reporting to an engine of its own.
+/// Returns none, having reported nothing, if the buffer cannot be split or any chunk reported
+/// something.
+zc::Maybe<zc::Own<ast::SourceFile>> parseInChunks(source::SourceManager& sm,
+                                                  const LangOptions& langOpts,
+                                                  basic::StringPool& stringPool,
+                                                  const source::BufferId& bufferId,
+                                                  ThreadPool& threadPool) {
+  zc::Vector<uint32_t> boundaries;
+  {
+    // The fast table lex finds the boundaries; the chunk parsers lex their part again.
+    size_t reported = 0;
+    diagnostics::DiagnosticEngine scanEngine(sm);
+    scanEngine.addConsumer(zc::heap<DiagnosticCounter>(reported));
+    lexer::Lexer lexer(sm, scanEngine, langOpts, stringPool, bufferId);
+    lexer::TokenTable tokens = lexer.lexAll();
+    if (reported != 0) { return zc::none; }
+    const uint32_t maxChunks = langOpts.parallelParseMaxChunks;
+    boundaries = parser::findChunkBoundaries(
+        tokens, maxChunks != 0 ? maxChunks : std::thread::hardware_concurrency());
+  }
+  if (boundaries.size() < 2) { return zc::none; }
+
+  struct ChunkParse {
+    size_t reported = 0;
+    zc::Maybe<parser::SourceChunk> chunk;
+    ast::AllocationStats allocations;
+  };
+  zc::Maybe<ast::AllocationStats&> stats = ast::getCurrentAllocationStats();
+  const uint32_t bufferSize = sm.getEntireTextForBuffer(bufferId).size();
+  zc::Array<ChunkParse> parses = zc::heapArray<ChunkParse>(boundaries.size());
+  {
+    // Joined from a task of the same pool when the driver parses, so forked rather than queued:
+    // the join runs chunks itself instead of blocking its worker.
+    TaskGroup group(threadPool);
+    for (size_t i = 0; i < boundaries.size(); ++i) {
+      const uint32_t begin = boundaries[i];
+      const uint32_t end = i + 1 < boundaries.size() ? boundaries[i + 1] : bufferSize;
+      group.fork([&, i, begin, end]() {
+        diagnostics::DiagnosticEngine engine(sm);
+        engine.addConsumer(zc::heap<DiagnosticCounter>(parses[i].reported));
+        parser::Parser parser(sm, engine, langOpts, stringPool, bufferId);
+        // Statistics are thread-local, so every chunk records its own and they are merged below.
+        zc::Maybe<ast::AllocationStatsScope> scope;
+        if (stats != zc::none) { scope.emplace(parses[i].allocations); }
+        parses[i].chunk = parser.parseChunk(begin, end);
+      });
+    }
+    // A chunk that threw is left without a tree, and the buffer parsed as a whole.
+    auto maybeException = zc::runCatchingExceptions([&]() { group.join(); });
+    ZC_IF_SOME(exception, maybeException) {
+      ZC_LOG(WARNING, "Chunk parse failed", exception);
+    }
+  }
+  ZC_IF_SOME(s, stats) {
+    for (const ChunkParse& parse : parses) { s.merge(parse.allocations); }
+  }
+
+  zc::Vector<parser::SourceChunk> chunks;
+  chunks.reserve(parses.size());
+  for (ChunkParse& parse : parses) {
+    if (parse.reported != 0) { return zc::none; }
+    ZC_IF_SOME(chunk, parse.chunk) { chunks.add(zc::mv(chunk)); }
+    else { return zc::none; }
+  }
+  return parser::joinSourceChunks(sm.getIdentifierForBuffer(bufferId), zc::mv(chunks));
+}
+
+/// Moves the source ranges of a subtree by `shift` bytes from the buffer starting at `from` to the
+/// one starting at `to`.
+class RangeRebaser final : public ast::NodeWalker {
+public:
+  RangeRebaser(source::SourceLoc from, source::SourceLoc to, int32_t shift)
+      : from(from), to(to), shift(shift) {}
+
+  source::SourceLoc rebase(source::SourceLoc loc) const {
+    return to.getAdvancedLoc(loc.getOpaqueValue() - from.getOpaqueValue() + shift);
+  }
+
+private:
+  source::SourceLoc from;
+  source::SourceLoc to;
+  int32_t shift;
+
+  void enter(const ast::Node& node) override {
+    const source::SourceRange& range = node.getSourceRange();
+    if (range.isInvalid()) { return; }
+    const_cast<ast::Node&>(node).setSourceRange(
+        source::SourceRange(rebase(range.getStart()), rebase(range.getEnd())));
+  }
+};
+
+/// Top-level statements that findChunkBoundaries may cut before.
+bool startsChunk(const ast::Statement& statement) {
+  switch (statement.getKind()) {
+    case ast::SyntaxKind::VariableStatement:
+    case ast::SyntaxKind::FunctionDeclaration:
+    case ast::SyntaxKind::ClassDeclaration:
+    case ast::SyntaxKind::StructDeclaration:
+    case ast::SyntaxKind::EnumDeclaration:
+    case ast::SyntaxKind::AliasDeclaration:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// True if `after` parses the same whether it follows `before` or starts the text. A `;` always
+/// ends a statement, but a `}` can close an object literal that `after` might continue, so that
+/// takes a statement starting with a declaration keyword, as for chunk boundaries.
+bool canFollow(const source::SourceManager& sm, const ast::Statement& before,
+               const ast::Statement& after) {
+  const source::SourceRange& range = before.getSourceRange();
+  if (range.isInvalid() || range.getLength() == 0) { return false; }
+  const zc::byte last = sm.getCharacterData(range.getEnd())[-1];
+  return last == ';' || (last == '}' && startsChunk(after));
+}
+
+/// Reparsing keeps every arena of the trees it reuses, so a file edited many times is parsed in
+/// full now and then to let the dropped statements go.
+constexpr size_t kMaxReparseArenas = 64;
+
+}  // namespace
+
 /// Implementation of performParse
-zc::Maybe<zc::Own<ast::Node>> performParse(const source::SourceManager& sm,
-                                           diagnostics::DiagnosticEngine& diagnosticEngine,
-                                           const LangOptions& langOpts,
-                                           basic::StringPool& stringPool,
-                                           const source::BufferId& bufferId) {
+zc::Maybe<zc::Own<ast::Node>> performParse(
+    source::SourceManager& sm, diagnostics::DiagnosticEngine& diagnosticEngine,
+    const LangOptions& langOpts, basic::StringPool& stringPool, const source::BufferId& bufferId,
+    zc::Maybe<parser::StatementListener&> statementListener,
+    zc::Maybe<ThreadPool&> threadPool) {
+  // Chunks report into engines of their own that are gone by the time a deferred body is parsed,
+  // and parse on other threads, out of order with each other.
+  const uint32_t minBytes = langOpts.lazyFunctionBodies || statementListener != zc::none
+                                ? 0
+                                : langOpts.parallelParseMinBytes;
+  ZC_IF_SOME(pool, threadPool) {
+    if (minBytes != 0 && sm.getEntireTextForBuffer(bufferId).size() >= minBytes) {
+      ZC_IF_SOME(sourceFile, parseInChunks(sm, langOpts, stringPool, bufferId, pool)) {
+        if (diagnosticEngine.hasErrors()) { return zc::none; }
+        return zc::Own<ast::Node>(zc::mv(sourceFile));
+      }
+    }
+  }
+
   // Create a Parser instance
   parser::Parser parser(sm, diagnosticEngine, langOpts, stringPool, bufferId);
+  ZC_IF_SOME(listener, statementListener) { parser.setStatementListener(listener); }
   // Assuming Parser::parse now returns the AST or null on failure
   zc::Maybe<zc::Own<ast::Node>> ast = parser.parse();
 
   // Check for parsing errors
   if (diagnosticEngine.hasErrors()) {
+    ZC_IF_SOME(listener, statementListener) {
+      ZC_IF_SOME(tree, ast) { listener.parseFailed(zc::mv(tree)); }
+    }
     return zc::none;  // Return none if parsing reported errors
   }
 
@@ -49,6 +218,158 @@ zc::Maybe<zc::Own<ast::Node>> performParse(const source::SourceManager& sm,
   return ast;  // NRVO optimization
 }
 
+/// Implementation of performOutline
+lexer::Outline performOutline(const source::SourceManager& sm,
+                              diagnostics::DiagnosticEngine& diagnosticEngine,
+                              const LangOptions& langOpts, basic::StringPool& stringPool,
+                              const source::BufferId& bufferId, bool classifyTokens) {
+  return lexer::scanOutline(sm, diagnosticEngine, langOpts, stringPool, bufferId, classifyTokens);
+}
+
+/// Implementation of performReparse
+zc::Maybe<zc::Own<ast::Node>> performReparse(source::SourceManager& sm,
+                                             diagnostics::DiagnosticEngine& diagnosticEngine,
+                                             const LangOptions& langOpts,
+                                             basic::StringPool& stringPool,
+                                             const source::BufferId& bufferId,
+                                             zc::Own<ast::Node> previous,
+                                             const source::BufferId& previousBufferId,
+                                             const lexer::TextEdit& edit) {
+  ZC_REQUIRE(ast::isa<ast::SourceFile>(*previous), "only a SourceFile can be reparsed");
+  zc::Own<ast::SourceFile> file = previous.downcast<ast::SourceFile>();
+
+  const source::SourceLoc oldBase = sm.getLocForBufferStart(previousBufferId);
+  const source::SourceLoc newBase = sm.getLocForBufferStart(bufferId);
+  const zc::ArrayPtr<const zc::byte> text = sm.getEntireTextForBuffer(bufferId);
+  const int32_t shift =
+      static_cast<int32_t>(edit.insertedLength) - static_cast<int32_t>(edit.removedLength);
+  const size_t editBegin = edit.offset;
+  const size_t editEnd = edit.offset + edit.removedLength;
+  auto parseAll = [&]() {
+    return performParse(sm, diagnosticEngine, langOpts, stringPool, bufferId);
+  };
+
+  // Declared first so that the nodes released into them go before they do.
+  zc::Vector<zc::Own<zc::Arena>> arenas = file->releaseArenas();
+  zc::Maybe<zc::Own<ast::ModuleDeclaration>> moduleDeclaration =
+      file->releaseModuleDeclaration();
+  zc::Vector<zc::Own<ast::Statement>> statements = file->releaseStatements();
+  const source::SourceRange previousRange = file->getSourceRange();
+  file = nullptr;
+  if (arenas.size() >= kMaxReparseArenas || previousRange.isInvalid()) { return parseAll(); }
+
+  const size_t count = statements.size();
+  for (const auto& statement : statements) {
+    if (statement->getSourceRange().isInvalid()) { return parseAll(); }
+  }
+  auto startOf = [oldBase](const ast::Node& node) -> size_t {
+    return node.getSourceRange().getStart().getOpaqueValue() - oldBase.getOpaqueValue();
+  };
+  auto endOf = [oldBase](const ast::Node& node) -> size_t {
+    return node.getSourceRange().getEnd().getOpaqueValue() - oldBase.getOpaqueValue();
+  };
+
+  // Statements [first, last) are reparsed: those the edit touches, widened until the ones kept on
+  // either side can follow what comes before them.
+  size_t first = 0;
+  while (first < count && endOf(*statements[first]) < editBegin) { ++first; }
+  while (first > 0 && first < count && !canFollow(sm, *statements[first - 1], *statements[first])) {
+    --first;
+  }
+  size_t last = first;
+  while (last < count && startOf(*statements[last]) <= editEnd) { ++last; }
+  while (last > 0 && last < count && !canFollow(sm, *statements[last - 1], *statements[last])) {
+    ++last;
+  }
+
+  // A module declaration the edit touches is reparsed along with everything after it.
+  ZC_IF_SOME(module, moduleDeclaration) {
+    if (editBegin <= endOf(*module) ||
+        (first < count && !canFollow(sm, *module, *statements[first]))) {
+      first = 0;
+      moduleDeclaration = zc::none;
+    }
+  }
+
+  uint32_t begin = 0;
+  if (first > 0) {
+    begin = static_cast<uint32_t>(endOf(*statements[first - 1]));
+  } else {
+    ZC_IF_SOME(module, moduleDeclaration) { begin = static_cast<uint32_t>(endOf(*module)); }
+  }
+  const uint32_t end = last < count ? static_cast<uint32_t>(startOf(*statements[last]) + shift)
+                                    : static_cast<uint32_t>(text.size());
+
+  // Parse the chunk on the side, falling back to a full parse that reports everything if it
+  // reports anything. Its bodies are never deferred, since deferred parses would report to the
+  // side engine.
+  parser::SourceChunk chunk;
+  {
+    size_t reported = 0;
+    diagnostics::DiagnosticEngine chunkEngine(sm);
+    chunkEngine.addConsumer(zc::heap<DiagnosticCounter>(reported));
+    LangOptions chunkOpts = langOpts;
+    chunkOpts.lazyFunctionBodies = false;
+    parser::Parser chunkParser(sm, chunkEngine, chunkOpts, stringPool, bufferId);
+    chunk = chunkParser.parseChunk(begin, end);
+    if (reported != 0) { return parseAll(); }
+  }
+
+  // The reparsed statements must join the kept ones as they would in a full parse.
+  zc::Maybe<const ast::Statement&> before;
+  if (first > 0) {
+    before = *statements[first - 1];
+  } else {
+    ZC_IF_SOME(module, moduleDeclaration) { before = *module; }
+    else {
+      ZC_IF_SOME(module, chunk.moduleDeclaration) { before = *module; }
+    }
+  }
+  for (const auto& statement : chunk.statements) {
+    ZC_IF_SOME(b, before) {
+      if (!canFollow(sm, b, *statement)) { return parseAll(); }
+    }
+    before = *statement;
+  }
+  if (last < count) {
+    ZC_IF_SOME(b, before) {
+      if (!canFollow(sm, b, *statements[last])) { return parseAll(); }
+    }
+  }
+
+  // Keep the statements on either side, moved onto the new buffer.
+  RangeRebaser prefix(oldBase, newBase, 0);
+  RangeRebaser suffix(oldBase, newBase, shift);
+  zc::Vector<zc::Own<ast::Statement>> joined;
+  joined.reserve(count - (last - first) + chunk.statements.size());
+  for (size_t i = 0; i < first; ++i) {
+    prefix.walk(*statements[i]);
+    joined.add(zc::mv(statements[i]));
+  }
+  for (auto& statement : chunk.statements) { joined.add(zc::mv(statement)); }
+  for (size_t i = last; i < count; ++i) {
+    suffix.walk(*statements[i]);
+    joined.add(zc::mv(statements[i]));
+  }
+  ZC_IF_SOME(module, moduleDeclaration) { prefix.walk(*module); }
+  else { moduleDeclaration = zc::mv(chunk.moduleDeclaration); }
+
+  // The file starts where it used to unless its first statement was reparsed, and ends where it
+  // used to, moved by the edit, unless its last one was.
+  const source::SourceLoc fileStart =
+      begin > 0 ? prefix.rebase(previousRange.getStart()) : chunk.start;
+  const source::SourceLoc fileEnd =
+      last < count ? suffix.rebase(previousRange.getEnd()) : chunk.end;
+
+  zc::StringPtr fileName = sm.getIdentifierForBuffer(bufferId);
+  zc::Own<ast::SourceFile> sourceFile = ast::factory::createSourceFile(
+      zc::str(fileName), zc::mv(moduleDeclaration), zc::mv(joined));
+  sourceFile->setSourceRange(source::SourceRange(fileStart, fileEnd));
+  ZC_IF_SOME(arena, chunk.arena) { sourceFile->adoptArena(zc::mv(arena)); }
+  for (auto& arena : arenas) { sourceFile->adoptArena(zc::mv(arena)); }
+  return zc::Own<ast::Node>(zc::mv(sourceFile));
+}
+
 /// Implementation of performBind
 bool performBind(symbol::SymbolTable& symbolTable, diagnostics::DiagnosticEngine& diagnosticEngine,
                  ast::Node& ast) {
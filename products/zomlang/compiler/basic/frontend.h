@@ -32,26 +32,84 @@ namespace ast {
 class Node;
 }
 
+namespace lexer {
+struct TextEdit;
+struct Outline;
+}
+
 namespace symbol {
 class SymbolTable;
 }
 
+namespace parser {
+class StatementListener;
+}
+
 namespace basic {
 
 class StringPool;
+class ThreadPool;
 struct LangOptions;
 
 /// \brief Perform parsing on a single source buffer
+///
+/// Given a thread pool, buffers of at least `LangOptions::parallelParseMinBytes` are split at
+/// top-level declarations and the pieces parsed concurrently on it. That result is only kept if no piece reported a
+/// diagnostic; otherwise the buffer is parsed again as a whole, so that diagnostics are always
+/// the same, and in the same order, as for a serial parse.
 /// \param sm Source manager containing the source buffer
 /// \param diagnosticEngine Diagnostic engine for error reporting
 /// \param langOpts Language options for parsing
 /// \param bufferId Buffer ID of the source to parse
+/// \param statementListener Told about each top-level statement as it is parsed, on this thread
+/// and in source order, so the buffer is then always parsed as a whole. It is handed the tree if
+/// parsing fails.
+/// \param threadPool Workers to parse the chunks of a large buffer on, normally those of the
+/// driver, which may be running this parse as one of their tasks. Without one, every buffer is
+/// parsed as a whole on this thread.
+/// \return Parsed AST node or none if parsing failed
+zc::Maybe<zc::Own<ast::Node>> performParse(
+    source::SourceManager& sm, diagnostics::DiagnosticEngine& diagnosticEngine,
+    const LangOptions& langOpts, basic::StringPool& stringPool, const source::BufferId& bufferId,
+    zc::Maybe<parser::StatementListener&> statementListener = zc::none,
+    zc::Maybe<ThreadPool&> threadPool = zc::none);
+
+/// \brief Outline a source buffer without parsing it
+///
+/// Lexes the buffer and scans its tokens for declarations: names, kinds and ranges of the
+/// top-level declarations and of the members of types, as `lexer::scanOutline()` describes. No
+/// tree is built and nothing is reported, so this suits editor requests such as an outline view
+/// or highlighting, which would otherwise pay for a full parse on every keystroke.
+/// \param sm Source manager containing the source buffer
+/// \param diagnosticEngine Diagnostic engine whose lexer diagnostics are suppressed
+/// \param langOpts Language options for lexing
+/// \param bufferId Buffer ID of the source to outline
+/// \param classifyTokens Also list every token with its highlighting class
+/// \return The declarations of the buffer in source order
+lexer::Outline performOutline(const source::SourceManager& sm,
+                              diagnostics::DiagnosticEngine& diagnosticEngine,
+                              const LangOptions& langOpts, basic::StringPool& stringPool,
+                              const source::BufferId& bufferId, bool classifyTokens = false);
+
+/// \brief Parse a source buffer again after an edit, reusing what it cannot have changed
+///
+/// `edit` turned the text of `previousBufferId`, which `previous` was parsed from, into the text
+/// of `bufferId`. Only the top-level statements around the edit are parsed again, as a chunk like
+/// those of a parallel parse; the others are taken out of `previous` and their source ranges moved
+/// onto the new buffer. The buffer is parsed as a whole instead, as by performParse, when the edit
+/// could change how the kept statements join the new ones or the chunk reports a diagnostic, so
+/// the tree is the one performParse would build. Diagnostics of kept statements are not reported
+/// again, and symbols bound on them must be bound again.
+/// \param previous Tree of the previous text, consumed either way
 /// \return Parsed AST node or none if parsing failed
-zc::Maybe<zc::Own<ast::Node>> performParse(const source::SourceManager& sm,
-                                           diagnostics::DiagnosticEngine& diagnosticEngine,
-                                           const LangOptions& langOpts,
-                                           basic::StringPool& stringPool,
-                                           const source::BufferId& bufferId);
+zc::Maybe<zc::Own<ast::Node>> performReparse(source::SourceManager& sm,
+                                             diagnostics::DiagnosticEngine& diagnosticEngine,
+                                             const LangOptions& langOpts,
+                                             basic::StringPool& stringPool,
+                                             const source::BufferId& bufferId,
+                                             zc::Own<ast::Node> previous,
+                                             const source::BufferId& previousBufferId,
+                                             const lexer::TextEdit& edit);
 
 /// \brief Perform binding on a parsed AST to create symbols
 /// \param symbolTable Symbol table for managing symbols and scopes
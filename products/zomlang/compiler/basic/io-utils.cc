@@ -24,10 +24,9 @@ namespace basic {
 // FileOutputStream::Impl
 
 struct FileOutputStream::Impl {
-  zc::Own<const zc::File> file;
-  uint64_t position;
+  zc::MappedFileOutputStream stream;
 
-  explicit Impl(zc::Own<const zc::File> file) : file(zc::mv(file)), position(0) {}
+  explicit Impl(zc::Own<const zc::File> file) : stream(zc::mv(file)) {}
 };
 
 // ================================================================================
@@ -38,10 +37,7 @@ FileOutputStream::FileOutputStream(zc::Own<const zc::File> file)
 
 FileOutputStream::~FileOutputStream() noexcept(false) = default;
 
-void FileOutputStream::write(zc::ArrayPtr<const zc::byte> data) {
-  impl->file->write(impl->position, data);
-  impl->position += data.size();
-}
+void FileOutputStream::write(zc::ArrayPtr<const zc::byte> data) { impl->stream.write(data); }
 
 }  // namespace basic
 }  // namespace compiler
@@ -28,6 +28,10 @@ namespace basic {
 /// This class provides a synchronous OutputStream implementation that writes
 /// to a file using the zc::File interface. Unlike zc::async::FileOutputStream,
 /// this implementation is designed for synchronous compiler operations.
+///
+/// Output goes through a zc::MappedFileOutputStream, so writing is a copy into
+/// a mapping of the file rather than a syscall. The file is truncated to the
+/// written size when the stream is destroyed.
 class FileOutputStream : public zc::OutputStream {
 public:
   explicit FileOutputStream(zc::Own<const zc::File> file);
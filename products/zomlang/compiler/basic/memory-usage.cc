@@ -0,0 +1,32 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/basic/memory-usage.h"
+
+#include "zc/core/arena.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+void MemoryUsage::addArena(const zc::Arena& arena) {
+  const size_t used = arena.getUsedBytes();
+  const size_t reserved = arena.getChunkBytes();
+  add(used, reserved);
+  arenaSlackBytes += reserved - used;
+}
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
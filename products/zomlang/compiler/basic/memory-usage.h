@@ -0,0 +1,81 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+
+namespace zc {
+class Arena;
+}  // namespace zc
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+/// \brief Memory held by a compiler subsystem, as returned by its `getMemoryUsage()`.
+///
+/// Covers what the subsystem allocated: the objects behind its handles, the containers and arenas
+/// they live in, and the text they copied, but not the object `getMemoryUsage()` is called on.
+/// Objects a subsystem only points at are counted by their owner, e.g. the symbols of a scope by
+/// the symbol table. Hash tables count their rows but not their index buckets, which take a few
+/// bytes per row.
+struct MemoryUsage {
+  /// Bytes holding data, arena chunk headers and alignment padding included
+  size_t usedBytes = 0;
+  /// Bytes taken from the heap or mapped: `usedBytes`, spare container capacity and arena slack
+  size_t reservedBytes = 0;
+  /// The part of `reservedBytes` left unallocated in arena chunks
+  size_t arenaSlackBytes = 0;
+
+  MemoryUsage& operator+=(const MemoryUsage& other) {
+    usedBytes += other.usedBytes;
+    reservedBytes += other.reservedBytes;
+    arenaSlackBytes += other.arenaSlackBytes;
+    return *this;
+  }
+
+  /// \brief Count `used` bytes of `reserved` ones taken from the heap.
+  void add(size_t used, size_t reserved) {
+    usedBytes += used;
+    reservedBytes += reserved;
+  }
+  /// \brief Count a heap object of type `T`.
+  template <typename T>
+  void addObject() {
+    add(sizeof(T), sizeof(T));
+  }
+  void addArena(const zc::Arena& arena);
+  /// \brief Count the heap copy of a string, terminating NUL included.
+  void addString(const zc::String& string) {
+    const size_t bytes = string.size() == 0 ? 0 : string.size() + 1;
+    add(bytes, bytes);
+  }
+  template <typename T>
+  void addVector(const zc::Vector<T>& vector) {
+    add(vector.size() * sizeof(T), vector.capacity() * sizeof(T));
+  }
+  /// \brief Count the rows of a `zc::Table`, `zc::HashMap` or `zc::HashSet`.
+  template <typename Table>
+  void addTable(const Table& table) {
+    using Row = zc::Decay<decltype(*table.begin())>;
+    add(table.size() * sizeof(Row), table.capacity() * sizeof(Row));
+  }
+};
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
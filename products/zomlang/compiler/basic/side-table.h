@@ -0,0 +1,82 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/basic/memory-usage.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+/// \brief Per-entity data for entities with dense ids, stored in an array indexed by the id.
+///
+/// `Key` is an id type with an `index()` method, such as `symbol::SymbolId` or `ast::NodeId`,
+/// whose indexes are handed out from a counter and so stay small. Looking an entry up is an
+/// array access rather than a hash, and a pass over every entry is a scan of contiguous memory.
+/// Ids without an entry read as a default-constructed `T`; writing one grows the table to it.
+template <typename Key, typename T>
+class SideTable {
+public:
+  SideTable() = default;
+  ZC_DISALLOW_COPY(SideTable);
+  SideTable(SideTable&&) = default;
+  SideTable& operator=(SideTable&&) = default;
+
+  /// \brief The entry for `key`, or a default `T` if it has none.
+  const T& get(Key key) const {
+    const size_t index = key.index();
+    if (index < entries.size()) { return entries[index]; }
+    static const T empty{};
+    return empty;
+  }
+
+  /// \brief The entry for `key`, added as a default `T` if it has none.
+  T& at(Key key) {
+    const size_t index = key.index();
+    // Not resize(), which leaves trivially constructible entries uninitialized.
+    while (entries.size() <= index) { entries.add(T()); }
+    return entries[index];
+  }
+
+  void set(Key key, T value) { at(key) = zc::mv(value); }
+
+  /// \brief Make room for ids with indexes below `count` up front.
+  void reserve(size_t count) { entries.reserve(count); }
+
+  /// \brief One past the highest index written, which is the length of `asPtr()`.
+  size_t size() const { return entries.size(); }
+
+  /// \brief Every entry, indexed by id. Index 0 is never a valid id, and ids without an entry
+  /// have a default `T`.
+  zc::ArrayPtr<const T> asPtr() const { return entries.asPtr(); }
+  zc::ArrayPtr<T> asPtr() { return entries.asPtr(); }
+
+  void clear() { entries.clear(); }
+
+  MemoryUsage getMemoryUsage() const {
+    MemoryUsage usage;
+    usage.addVector(entries);
+    return usage;
+  }
+
+private:
+  zc::Vector<T> entries;
+};
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
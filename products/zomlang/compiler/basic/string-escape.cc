@@ -14,81 +14,160 @@
 
 #include "zomlang/compiler/basic/string-escape.h"
 
+#include <cstring>
+
 #include "zc/core/string.h"
-#include "zc/core/vector.h"
 
 namespace zomlang {
 namespace compiler {
 namespace basic {
 
-zc::String escapeJsonString(zc::StringPtr str) {
-  zc::Vector<char> result;
+namespace {
+
+void writeRun(zc::OutputStream& output, const char* begin, const char* end) {
+  if (begin != end) { output.write(zc::arrayPtr(begin, end).asBytes()); }
+}
+
+// Finding the characters to escape is done a 64-bit word at a time, four words per step: almost
+// every string escaped is free of them, and the runs between them are written in one call each.
+// Each classifier sets the top bit of a byte for the bytes it looks for, and may set it for bytes
+// after a match as well, so it only says whether a word holds one.
+
+constexpr uint64_t kLowBits = 0x0101010101010101ull;
+constexpr uint64_t kHighBits = 0x8080808080808080ull;
+
+inline uint64_t loadWord(const char* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+/// Bytes below `n`, for `n` at most 0x80.
+inline uint64_t bytesBelow(uint64_t word, uint8_t n) {
+  return (word - kLowBits * n) & ~word & kHighBits;
+}
+
+inline uint64_t bytesEqual(uint64_t word, char c) {
+  return bytesBelow(word ^ (kLowBits * static_cast<uint8_t>(c)), 1);
+}
+
+inline uint64_t jsonEscapes(uint64_t word) {
+  return bytesBelow(word, 0x20) | bytesEqual(word, '"') | bytesEqual(word, '\\');
+}
+
+inline uint64_t xmlEscapes(uint64_t word) {
+  return bytesEqual(word, '&') | bytesEqual(word, '<') | bytesEqual(word, '>') |
+         bytesEqual(word, '"') | bytesEqual(word, '\'');
+}
+
+inline bool needsJsonEscape(char c) {
+  return static_cast<unsigned char>(c) < 0x20 || c == '"' || c == '\\';
+}
+
+inline bool needsXmlEscape(char c) {
+  return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
+
+/// The first character in [p, end) that `needsEscape` accepts, or `end`.
+template <uint64_t (*wordEscapes)(uint64_t), bool (*needsEscape)(char)>
+const char* findEscape(const char* p, const char* end) {
+  constexpr size_t kStep = 4 * sizeof(uint64_t);
+  while (static_cast<size_t>(end - p) >= kStep) {
+    uint64_t found = wordEscapes(loadWord(p)) | wordEscapes(loadWord(p + 8)) |
+                     wordEscapes(loadWord(p + 16)) | wordEscapes(loadWord(p + 24));
+    if (found != 0) { break; }
+    p += kStep;
+  }
+  while (p != end && !needsEscape(*p)) { ++p; }
+  return p;
+}
+
+const char* findJsonEscape(const char* p, const char* end) {
+  return findEscape<jsonEscapes, needsJsonEscape>(p, end);
+}
+
+const char* findXmlEscape(const char* p, const char* end) {
+  return findEscape<xmlEscapes, needsXmlEscape>(p, end);
+}
+
+zc::String escapeWith(void (*write)(zc::OutputStream&, zc::StringPtr), zc::StringPtr str) {
+  zc::VectorOutputStream output(str.size() + 16);
+  write(output, str);
+  return zc::heapString(output.getArray().asChars());
+}
+
+}  // namespace
+
+zc::String escapeJsonString(zc::StringPtr str) { return escapeWith(writeJsonEscaped, str); }
 
-  for (char c : str) {
-    switch (c) {
+zc::String escapeXmlString(zc::StringPtr str) { return escapeWith(writeXmlEscaped, str); }
+
+void writeJsonEscaped(zc::OutputStream& output, zc::StringPtr str) {
+  const char* run = str.begin();
+  const char* end = str.end();
+  for (const char* p = findJsonEscape(run, end); p != end; p = findJsonEscape(run, end)) {
+    writeRun(output, run, p);
+    run = p + 1;
+    switch (*p) {
       case '"':
-        result.addAll("\\\""_zc.asArray());
+        output.write("\\\""_zc.asBytes());
         break;
       case '\\':
-        result.addAll("\\\\"_zc.asArray());
+        output.write("\\\\"_zc.asBytes());
         break;
       case '\b':
-        result.addAll("\\b"_zc.asArray());
+        output.write("\\b"_zc.asBytes());
         break;
       case '\f':
-        result.addAll("\\f"_zc.asArray());
+        output.write("\\f"_zc.asBytes());
         break;
       case '\n':
-        result.addAll("\\n"_zc.asArray());
+        output.write("\\n"_zc.asBytes());
         break;
       case '\r':
-        result.addAll("\\r"_zc.asArray());
+        output.write("\\r"_zc.asBytes());
         break;
       case '\t':
-        result.addAll("\\t"_zc.asArray());
+        output.write("\\t"_zc.asBytes());
         break;
-      default:
-        if (static_cast<unsigned char>(c) < 0x20) {
-          // Control characters need to be escaped as \uXXXX
-          result.addAll("\\u00"_zc.asArray());
-          result.addAll(zc::hex(static_cast<unsigned char>(c)));
-        } else {
-          result.add(c);
-        }
+      default: {
+        // Control characters need to be escaped as \uXXXX, with all four digits.
+        constexpr char kHexDigits[] = "0123456789abcdef";
+        const auto c = static_cast<unsigned char>(*p);
+        const char escape[] = {'\\', 'u', '0', '0', kHexDigits[c >> 4], kHexDigits[c & 0xf]};
+        output.write(zc::arrayPtr(escape, sizeof(escape)).asBytes());
         break;
+      }
     }
   }
-
-  return zc::str(result.asPtr());
+  writeRun(output, run, end);
 }
 
-zc::String escapeXmlString(zc::StringPtr str) {
-  zc::Vector<char> result;
-
-  for (char c : str) {
-    switch (c) {
+void writeXmlEscaped(zc::OutputStream& output, zc::StringPtr str) {
+  const char* run = str.begin();
+  const char* end = str.end();
+  for (const char* p = findXmlEscape(run, end); p != end; p = findXmlEscape(run, end)) {
+    writeRun(output, run, p);
+    run = p + 1;
+    switch (*p) {
       case '&':
-        result.addAll("&amp;"_zc.asArray());
+        output.write("&amp;"_zc.asBytes());
         break;
       case '<':
-        result.addAll("&lt;"_zc.asArray());
+        output.write("&lt;"_zc.asBytes());
         break;
       case '>':
-        result.addAll("&gt;"_zc.asArray());
+        output.write("&gt;"_zc.asBytes());
         break;
       case '"':
-        result.addAll("&quot;"_zc.asArray());
-        break;
-      case '\'':
-        result.addAll("&apos;"_zc.asArray());
+        output.write("&quot;"_zc.asBytes());
         break;
       default:
-        result.add(c);
+        output.write("&apos;"_zc.asBytes());
         break;
     }
   }
-
-  return zc::str(result.asPtr());
+  writeRun(output, run, end);
 }
 
 }  // namespace basic
@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include "zc/core/io.h"
 #include "zc/core/string.h"
 
 namespace zomlang {
@@ -54,6 +55,17 @@ zc::String escapeJsonString(zc::StringPtr str);
 /// \return A new string with all necessary characters escaped
 zc::String escapeXmlString(zc::StringPtr str);
 
+/// \brief Write `str` to `output` escaped as by escapeJsonString()
+///
+/// No escaped copy is built: runs of characters that need no escaping are written with a single
+/// call, so `output` should be buffered.
+void writeJsonEscaped(zc::OutputStream& output, zc::StringPtr str);
+
+/// \brief Write `str` to `output` escaped as by escapeXmlString()
+///
+/// See writeJsonEscaped().
+void writeXmlEscaped(zc::OutputStream& output, zc::StringPtr str);
+
 }  // namespace basic
 }  // namespace compiler
 }  // namespace zomlang
\ No newline at end of file
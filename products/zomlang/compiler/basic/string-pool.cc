@@ -23,64 +23,169 @@ namespace zomlang {
 namespace compiler {
 namespace basic {
 
-StringPool::StringPool() {}
+namespace {
 
-zc::StringPtr StringPool::intern(zc::StringPtr str) {
-  auto locked = state.lockExclusive();
-  ZC_IF_SOME(s, locked->strings.find(str)) { return s; }
+/// Source of pool generations; 0 is never handed out, so an empty cache entry matches no pool.
+std::atomic<uint64_t> nextGeneration{1};
 
-  zc::StringPtr copy = locked->arena.copyString(str);
-  locked->strings.insert(copy);
-  return copy;
+/// Direct-mapped cache of the strings this thread interned last, across all pools. An entry is
+/// only used while its pool still has the generation it was interned in.
+struct FrontCache {
+  static constexpr uint32_t kSize = 256;
+
+  struct Entry {
+    uint64_t generation = 0;
+    const InternedString::Header* header = nullptr;
+  };
+
+  Entry entries[kSize];
+};
+
+thread_local FrontCache frontCache;
+
+}  // namespace
+
+StringPool::StringPool() : generation(nextGeneration.fetch_add(1, std::memory_order_relaxed)) {
+  // A shard is held for one hash lookup and at most one small arena allocation, far shorter than
+  // a trip through the kernel, so contended interns are better off spinning than sleeping.
+  for (Shard& shard : shards) { shard.state.setAdaptiveSpinning(); }
+}
+
+InternedString StringPool::intern(zc::StringPtr str) { return intern(str.asArray()); }
+
+InternedString StringPool::intern(zc::ArrayPtr<const char> str) {
+  const uint32_t hash = zc::hashCode(str);
+  const uint64_t current = generation.load(std::memory_order_relaxed);
+
+  FrontCache::Entry& entry = frontCache.entries[hash % FrontCache::kSize];
+  if (entry.generation == current) {
+    const InternedString cached(entry.header);
+    if (cached.hashCode() == hash && cached.asString().asArray() == str) { return cached; }
+  }
+
+  const InternedString interned = internInShard(str, hash);
+  entry = {current, interned.header};
+  return interned;
 }
 
-zc::StringPtr StringPool::intern(zc::ArrayPtr<const char> str) {
-  auto locked = state.lockExclusive();
-  ZC_IF_SOME(s, locked->strings.find(str)) { return s; }
+InternedString StringPool::internInShard(zc::ArrayPtr<const char> str, const uint32_t hash) {
+  const uint32_t shard = getShard(hash);
+  auto locked = shards[shard].state.lockExclusive();
+  return internLocked(*locked, str, hash, shard);
+}
 
-  // Manually copy string to arena
-  char* buffer = locked->arena.allocateArray<char>(str.size() + 1).begin();
-  memcpy(buffer, str.begin(), str.size());
+InternedString StringPool::internLocked(PoolState& state, const zc::ArrayPtr<const char> str,
+                                        const uint32_t hash, const uint32_t shard) {
+  ZC_IF_SOME(s, state.strings.find(str)) { return s; }
+
+  // The header and the NUL-terminated text are one allocation, in units of the header's
+  // alignment.
+  using Header = InternedString::Header;
+  constexpr size_t kUnit = alignof(Header);
+  const size_t units = (sizeof(Header) + str.size() + 1 + kUnit - 1) / kUnit;
+  auto* header = reinterpret_cast<Header*>(state.arena.allocateArray<uint32_t>(units).begin());
+  header->hash = hash;
+  header->length = str.size();
+  header->id = (state.strings.size() + 1) << kShardBits | shard;
+  char* buffer = reinterpret_cast<char*>(header + 1);
+  if (str.size() > 0) { memcpy(buffer, str.begin(), str.size()); }
   buffer[str.size()] = '\0';
 
-  zc::StringPtr copy(buffer, str.size());
-  locked->strings.insert(copy);
-  return copy;
+  const InternedString interned(header);
+  state.strings.insert(interned);
+  return interned;
+}
+
+zc::Array<InternedString> StringPool::internBatch(
+    const zc::ArrayPtr<const zc::ArrayPtr<const zc::byte>> strs) {
+  const size_t count = strs.size();
+  zc::Array<uint32_t> hashes = zc::heapArray<uint32_t>(count);
+  for (size_t i = 0; i < count; ++i) { hashes[i] = zc::hashCode(strs[i]); }
+
+  // Order the entries by shard, so that each shard is locked once for all of its strings.
+  uint32_t shardStarts[kShardCount + 1] = {};
+  for (const uint32_t hash : hashes) { ++shardStarts[getShard(hash) + 1]; }
+  for (uint32_t shard = 0; shard < kShardCount; ++shard) {
+    shardStarts[shard + 1] += shardStarts[shard];
+  }
+  uint32_t shardEnds[kShardCount];
+  memcpy(shardEnds, shardStarts, sizeof(shardEnds));
+  zc::Array<uint32_t> order = zc::heapArray<uint32_t>(count);
+  for (size_t i = 0; i < count; ++i) { order[shardEnds[getShard(hashes[i])]++] = i; }
+
+  zc::Array<const InternedString::Header*> headers =
+      zc::heapArray<const InternedString::Header*>(count);
+  for (uint32_t shard = 0; shard < kShardCount; ++shard) {
+    if (shardStarts[shard] == shardEnds[shard]) { continue; }
+    auto locked = shards[shard].state.lockExclusive();
+    for (uint32_t j = shardStarts[shard]; j < shardEnds[shard]; ++j) {
+      const uint32_t i = order[j];
+      headers[i] = internLocked(*locked, strs[i].asChars(), hashes[i], shard).header;
+    }
+  }
+
+  zc::ArrayBuilder<InternedString> results = zc::heapArrayBuilder<InternedString>(count);
+  for (const InternedString::Header* header : headers) { results.add(InternedString(header)); }
+  return results.finish();
 }
 
-zc::StringPtr StringPool::intern(zc::ArrayPtr<const zc::byte> str) {
+InternedString StringPool::intern(zc::ArrayPtr<const zc::byte> str) {
   return intern(zc::arrayPtr(reinterpret_cast<const char*>(str.begin()), str.size()));
 }
 
-zc::StringPtr StringPool::intern(char c) {
+InternedString StringPool::intern(char c) {
   const char s[1] = {c};
   return intern(zc::arrayPtr(s, 1));
 }
 
-zc::StringPtr StringPool::intern(zc::byte c) { return intern(static_cast<char>(c)); }
+InternedString StringPool::intern(zc::byte c) { return intern(static_cast<char>(c)); }
 
-zc::StringPtr StringPool::intern(const char* str) { return intern(zc::StringPtr(str)); }
+InternedString StringPool::intern(const char* str) { return intern(zc::StringPtr(str)); }
 
-zc::StringPtr StringPool::intern(const zc::String& str) { return intern(zc::StringPtr(str)); }
+InternedString StringPool::intern(const zc::String& str) { return intern(zc::StringPtr(str)); }
 
-zc::StringPtr StringPool::intern(const char* str, size_t len) {
+InternedString StringPool::intern(const char* str, size_t len) {
   return intern(zc::arrayPtr(str, len));
 }
 
-zc::StringPtr StringPool::intern(const zc::byte* str, size_t len) {
+InternedString StringPool::intern(const zc::byte* str, size_t len) {
   return intern(zc::arrayPtr(reinterpret_cast<const char*>(str), len));
 }
 
-zc::StringPtr StringPool::intern(const zc::byte* start, const zc::byte* end) {
+InternedString StringPool::intern(const zc::byte* start, const zc::byte* end) {
   return intern(zc::arrayPtr(reinterpret_cast<const char*>(start), end - start));
 }
 
 void StringPool::clear() {
-  auto locked = state.lockExclusive();
-  locked->strings.clear();
+  generation.store(nextGeneration.fetch_add(1, std::memory_order_relaxed),
+                   std::memory_order_relaxed);
+  for (Shard& shard : shards) {
+    auto locked = shard.state.lockExclusive();
+    locked->strings.clear();
+
+    locked->arena.~Arena();
+    new (&locked->arena) zc::Arena();
+  }
+}
+
+StringPool::Usage StringPool::getUsage() const {
+  Usage usage;
+  for (const Shard& shard : shards) {
+    auto locked = shard.state.lockShared();
+    usage.strings += locked->strings.size();
+    for (const InternedString& string : locked->strings) { usage.bytes += string.size() + 1; }
+  }
+  return usage;
+}
 
-  locked->arena.~Arena();
-  new (&locked->arena) zc::Arena();
+MemoryUsage StringPool::getMemoryUsage() const {
+  MemoryUsage usage;
+  for (const Shard& shard : shards) {
+    auto locked = shard.state.lockShared();
+    usage.addArena(locked->arena);
+    usage.addTable(locked->strings);
+  }
+  return usage;
 }
 
 }  // namespace basic
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstring>
 #include <type_traits>
 
 #include "zc/core/arena.h"
@@ -22,11 +24,56 @@
 #include "zc/core/mutex.h"
 #include "zc/core/string.h"
 #include "zc/core/table.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 
 namespace zomlang {
 namespace compiler {
 namespace basic {
 
+/// \brief Handle to a string interned by a `StringPool`.
+///
+/// Points at a header the pool keeps in front of the characters, holding the string's hash,
+/// length and id, so hashing is a field load and handles to one string are the same pointer.
+/// Handles from different pools (see `LangOptions::perBufferStringPools`) that hold equal text
+/// still compare equal, by hash, length and then bytes.
+class InternedString {
+public:
+  struct Header {
+    uint32_t hash;
+    uint32_t length;
+    /// Unique within the string's pool, and never 0.
+    uint32_t id;
+  };
+
+  zc::StringPtr asString() const { return zc::StringPtr(chars(), header->length); }
+  operator zc::StringPtr() const { return asString(); }
+  zc::StringPtr toString() const { return asString(); }
+
+  size_t size() const { return header->length; }
+  const char* cStr() const { return chars(); }
+  uint32_t hashCode() const { return header->hash; }
+  uint32_t getId() const { return header->id; }
+
+  bool operator==(const InternedString& other) const {
+    return header == other.header ||
+           (header->hash == other.header->hash && header->length == other.header->length &&
+            memcmp(chars(), other.chars(), header->length) == 0);
+  }
+  bool operator==(zc::StringPtr other) const { return asString() == other; }
+  bool operator==(const zc::String& other) const { return asString() == other; }
+
+private:
+  const Header* header;
+
+  explicit InternedString(const Header* header) : header(header) {}
+  const char* chars() const { return reinterpret_cast<const char*>(header + 1); }
+
+  friend class StringPool;
+};
+
+/// Interns strings for any number of threads. Strings are spread by hash over independently
+/// locked shards, each with its own arena, and every thread keeps a small cache of the strings it
+/// interned last, so repeated identifiers are found without taking a lock.
 class StringPool {
 public:
   // Creates a new string pool.
@@ -34,26 +81,26 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(StringPool);
 
   // Interns a string into the pool.
-  // Returns a pointer to the interned string.
+  // Returns a handle to the interned string, which converts to zc::StringPtr.
   // If the string is already in the pool, the existing instance is returned.
-  zc::StringPtr intern(zc::StringPtr str);
+  InternedString intern(zc::StringPtr str);
 
   // Interns a string from an ArrayPtr (not necessarily NUL-terminated).
-  zc::StringPtr intern(zc::ArrayPtr<const char> str);
+  InternedString intern(zc::ArrayPtr<const char> str);
 
-  zc::StringPtr intern(zc::ArrayPtr<const zc::byte> str);
+  InternedString intern(zc::ArrayPtr<const zc::byte> str);
 
   // Interns a single character.
-  zc::StringPtr intern(char c);
-  zc::StringPtr intern(zc::byte c);
+  InternedString intern(char c);
+  InternedString intern(zc::byte c);
 
   // Overloads to prevent template recursion and unnecessary allocations
-  zc::StringPtr intern(const char* str);
-  zc::StringPtr intern(const zc::String& str);
-  zc::StringPtr intern(const char* start, size_t len);
+  InternedString intern(const char* str);
+  InternedString intern(const zc::String& str);
+  InternedString intern(const char* start, size_t len);
 
-  zc::StringPtr intern(const zc::byte* start, size_t len);
-  zc::StringPtr intern(const zc::byte* start, const zc::byte* end);
+  InternedString intern(const zc::byte* start, size_t len);
+  InternedString intern(const zc::byte* start, const zc::byte* end);
 
   // Interns a concatenation of multiple values or a single non-string value.
   // Uses zc::str() formatting.
@@ -69,30 +116,64 @@ public:
               !std::is_same_v<std::decay_t<T>, const zc::byte*> &&
               !std::is_same_v<std::decay_t<T>, zc::String>) ||
              sizeof...(Args) > 0)
-  zc::StringPtr intern(T&& first, Args&&... args) {
+  InternedString intern(T&& first, Args&&... args) {
     return intern(zc::str(zc::fwd<T>(first), zc::fwd<Args>(args)...).asPtr());
   }
 
+  // Interns every string of `strs`, locking each shard at most once rather than once per string.
+  // Returns the handles in the order of `strs`.
+  zc::Array<InternedString> internBatch(zc::ArrayPtr<const zc::ArrayPtr<const zc::byte>> strs);
+
   // Clears the pool, freeing all strings.
   void clear();
 
+  struct Usage {
+    size_t strings = 0;
+    // Text bytes of the strings, terminating NULs included
+    size_t bytes = 0;
+  };
+  // Counts the strings the pool holds. Takes every shard's lock in turn.
+  Usage getUsage() const;
+  // Measures the shards' arenas and tables, taking every shard's lock in turn.
+  MemoryUsage getMemoryUsage() const;
+
 private:
   struct StringHash {
-    zc::StringPtr keyForRow(zc::StringPtr s) const { return s; }
+    InternedString keyForRow(InternedString s) const { return s; }
 
-    bool matches(zc::StringPtr a, zc::StringPtr b) const { return a == b; }
-    bool matches(zc::StringPtr a, zc::ArrayPtr<const char> b) const { return a.asArray() == b; }
+    bool matches(InternedString a, InternedString b) const { return a == b; }
+    bool matches(InternedString a, zc::ArrayPtr<const char> b) const {
+      return a.asString().asArray() == b;
+    }
 
-    uint32_t hashCode(zc::StringPtr s) const { return zc::hashCode(s); }
+    uint32_t hashCode(InternedString s) const { return s.hashCode(); }
     uint32_t hashCode(zc::ArrayPtr<const char> s) const { return zc::hashCode(s); }
   };
 
   struct PoolState {
     zc::Arena arena;
-    zc::Table<zc::StringPtr, zc::HashIndex<StringHash>> strings;
+    zc::Table<InternedString, zc::HashIndex<StringHash>> strings;
   };
 
-  zc::MutexGuarded<PoolState> state;
+  static constexpr uint32_t kShardBits = 4;
+  static constexpr uint32_t kShardCount = 1u << kShardBits;
+
+  /// Padded to a cache line so that threads locking neighbouring shards do not contend.
+  struct alignas(64) Shard {
+    zc::MutexGuarded<PoolState> state;
+  };
+
+  Shard shards[kShardCount];
+  /// Names this pool's current contents to the per-thread caches; clear() takes a new one.
+  std::atomic<uint64_t> generation;
+
+  /// The low bits of a hash pick the front cache entry and the table bucket, so shards use the
+  /// high bits.
+  static uint32_t getShard(uint32_t hash) { return hash >> (32 - kShardBits); }
+
+  InternedString internInShard(zc::ArrayPtr<const char> str, uint32_t hash);
+  static InternedString internLocked(PoolState& state, zc::ArrayPtr<const char> str, uint32_t hash,
+                                     uint32_t shard);
 };
 
 }  // namespace basic
@@ -14,91 +14,518 @@
 
 #include "zomlang/compiler/basic/thread-pool.h"
 
-#include "zc/core/arena.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+
+#if __linux__
+#include <sched.h>
+#endif
+
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
 #include "zc/core/exception.h"
+#include "zc/core/filesystem.h"
 #include "zc/core/list.h"
+#include "zc/core/memory.h"
 #include "zc/core/mutex.h"
 #include "zc/core/thread.h"
+#include "zc/core/tuple.h"
 #include "zc/core/vector.h"
 
 namespace zomlang {
 namespace compiler {
 namespace basic {
 
+namespace {
+
+struct Task {
+  zc::Function<void()> func;
+  zc::ListLink<Task> link;
+
+  explicit Task(zc::Function<void()> f) : func(zc::mv(f)) {}
+};
+
+/// Queues hold raw pointers; a task is owned by whichever thread took it off a queue.
+Task* releaseTask(zc::Own<Task> task) { return task.disown(&zc::_::HeapDisposer<Task>::instance); }
+
+zc::Own<Task> adoptTask(Task* task) {
+  return zc::Own<Task>(task, zc::_::HeapDisposer<Task>::instance);
+}
+
+/// Chase-Lev work-stealing deque, with the memory orderings of Lê et al., "Correct and Efficient
+/// Work-Stealing for Weak Memory Models" (PPoPP 2013). Only the owning worker pushes and pops, at
+/// the bottom; any thread may steal from the top.
+class WorkDeque {
+public:
+  WorkDeque() { ring.store(addRing(kInitialCapacity), std::memory_order_relaxed); }
+
+  ~WorkDeque() noexcept(false) {
+    while (true) {
+      ZC_IF_SOME(task, pop()) { adoptTask(&task); }
+      else { break; }
+    }
+  }
+
+  ZC_DISALLOW_COPY_AND_MOVE(WorkDeque);
+
+  void push(Task& task) {
+    const int64_t b = bottom.load(std::memory_order_relaxed);
+    const int64_t t = top.load(std::memory_order_acquire);
+    Ring* r = ring.load(std::memory_order_relaxed);
+    if (b - t >= static_cast<int64_t>(r->mask)) { r = grow(*r, t, b); }
+    r->at(b).store(&task, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+  }
+
+  zc::Maybe<Task&> pop() {
+    const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Ring* r = ring.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+    if (t > b) {
+      // Empty
+      bottom.store(b + 1, std::memory_order_relaxed);
+      return zc::none;
+    }
+    Task* task = r->at(b).load(std::memory_order_relaxed);
+    if (t == b) {
+      // Last task: race the thieves for it
+      if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+        task = nullptr;
+      }
+      bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    if (task == nullptr) { return zc::none; }
+    return *task;
+  }
+
+  zc::Maybe<Task&> steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t b = bottom.load(std::memory_order_acquire);
+    if (t >= b) { return zc::none; }
+    Task* task = ring.load(std::memory_order_acquire)->at(t).load(std::memory_order_relaxed);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                     std::memory_order_relaxed)) {
+      // Lost to the owner or another thief
+      return zc::none;
+    }
+    return *task;
+  }
+
+  bool isEmpty() const {
+    return top.load(std::memory_order_seq_cst) >= bottom.load(std::memory_order_seq_cst);
+  }
+
+private:
+  static constexpr size_t kInitialCapacity = 256;
+
+  struct Ring {
+    zc::Array<std::atomic<Task*>> slots;
+    size_t mask;
+
+    explicit Ring(size_t capacity)
+        : slots(zc::heapArray<std::atomic<Task*>>(capacity)), mask(capacity - 1) {}
+
+    std::atomic<Task*>& at(int64_t index) { return slots[static_cast<size_t>(index) & mask]; }
+  };
+
+  alignas(64) std::atomic<int64_t> top{0};
+  alignas(64) std::atomic<int64_t> bottom{0};
+  std::atomic<Ring*> ring;
+
+  // Every ring the deque has used. A thief may still be reading an outgrown ring, so they are only
+  // freed with the deque.
+  zc::Vector<zc::Own<Ring>> rings;
+
+  Ring* addRing(size_t capacity) {
+    rings.add(zc::heap<Ring>(capacity));
+    return rings.back().get();
+  }
+
+  Ring* grow(Ring& old, int64_t t, int64_t b) {
+    Ring* bigger = addRing(old.slots.size() * 2);
+    for (int64_t i = t; i < b; ++i) {
+      bigger->at(i).store(old.at(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    ring.store(bigger, std::memory_order_release);
+    return bigger;
+  }
+};
+
+/// Parse a Linux CPU list such as "0-3,8-11".
+zc::Vector<int> parseCpuList(zc::StringPtr text) {
+  zc::Vector<int> cpus;
+  const char* p = text.begin();
+  auto parseNumber = [&]() -> zc::Maybe<int> {
+    if (p == text.end() || *p < '0' || *p > '9') { return zc::none; }
+    int value = 0;
+    while (p != text.end() && *p >= '0' && *p <= '9') { value = value * 10 + (*p++ - '0'); }
+    return value;
+  };
+  while (true) {
+    ZC_IF_SOME(first, parseNumber()) {
+      int last = first;
+      if (p != text.end() && *p == '-') {
+        ++p;
+        ZC_IF_SOME(end, parseNumber()) { last = end; }
+        else { break; }
+      }
+      for (int cpu = first; cpu <= last; ++cpu) { cpus.add(cpu); }
+    }
+    else { break; }
+    if (p == text.end() || *p != ',') { break; }
+    ++p;
+  }
+  return cpus;
+}
+
+/// CPUs the process may run on, grouped by NUMA node in node order. A node of its own holds them
+/// all when the topology cannot be read, and there are none off Linux.
+zc::Vector<zc::Vector<int>> getCpusByNode() {
+  zc::Vector<zc::Vector<int>> nodes;
+#if __linux__
+  cpu_set_t allowed;
+  CPU_ZERO(&allowed);
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) { return nodes; }
+
+  auto maybeException = zc::runCatchingExceptions([&]() {
+    auto filesystem = zc::newDiskFilesystem();
+    ZC_IF_SOME(nodeDir, filesystem->getRoot().tryOpenSubdir(
+                            zc::Path({"sys", "devices", "system", "node"}))) {
+      zc::Vector<zc::Tuple<int, zc::Vector<int>>> numbered;
+      for (const zc::String& name : nodeDir->listNames()) {
+        if (!name.startsWith("node")) { continue; }
+        const zc::Vector<int> number = parseCpuList(name.slice(4));
+        if (number.size() != 1) { continue; }
+        ZC_IF_SOME(file, nodeDir->tryOpenFile(zc::Path({name, "cpulist"}))) {
+          zc::Vector<int> cpus;
+          for (int cpu : parseCpuList(file->readAllText())) {
+            if (cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) { cpus.add(cpu); }
+          }
+          if (!cpus.empty()) { numbered.add(zc::tuple(number[0], zc::mv(cpus))); }
+        }
+      }
+      std::sort(numbered.begin(), numbered.end(),
+                [](const auto& a, const auto& b) { return zc::get<0>(a) < zc::get<0>(b); });
+      for (auto& node : numbered) { nodes.add(zc::mv(zc::get<1>(node))); }
+    }
+  });
+  ZC_IF_SOME(exception, maybeException) {
+    ZC_LOG(WARNING, "Failed to read the NUMA topology", exception);
+    nodes.clear();
+  }
+
+  if (nodes.empty()) {
+    zc::Vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &allowed)) { cpus.add(cpu); }
+    }
+    if (!cpus.empty()) { nodes.add(zc::mv(cpus)); }
+  }
+#endif
+  return nodes;
+}
+
+/// Restrict the calling thread to `cpus`, if any.
+void pinCurrentThread(zc::ArrayPtr<const int> cpus) {
+#if __linux__
+  if (cpus.size() == 0) { return; }
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (int cpu : cpus) { CPU_SET(cpu, &set); }
+  if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+    ZC_LOG(WARNING, "Failed to pin a worker thread", errno);
+  }
+#else
+  (void)cpus;
+#endif
+}
+
+}  // namespace
+
 struct ThreadPool::Impl {
-  zc::Arena arena;
+  struct Worker {
+    Impl& pool;
+    WorkDeque deque;
+    // Picks steal victims
+    uint64_t randomState;
+    // NUMA node the worker is placed on, and the CPUs it is pinned to, if any
+    size_t node = 0;
+    zc::Vector<int> cpus;
+    zc::Own<zc::Thread> thread;
 
-  struct Task {
-    zc::Function<void()> func;
-    zc::ListLink<Task> link;
+    Worker(Impl& pool, uint64_t seed) : pool(pool), randomState(seed) {}
 
-    explicit Task(zc::Function<void()> f) : func(zc::mv(f)) {}
+    size_t nextVictim(size_t count) {
+      // xorshift64
+      randomState ^= randomState << 13;
+      randomState ^= randomState >> 7;
+      randomState ^= randomState << 17;
+      return static_cast<size_t>(randomState % count);
+    }
   };
 
-  zc::Vector<zc::Own<zc::Thread>> workers;
-  zc::MutexGuarded<zc::List<Task, &Task::link>> tasks;
-  bool stop = false;
+  /// Worker running on the calling thread, if it is one of some pool's
+  static thread_local Worker* currentWorker;
+
+  zc::Vector<zc::Own<Worker>> workers;
+  // Distinct nodes the workers are placed on
+  size_t nodeCount = 1;
+
+  // Tasks queued from outside the pool, run in order
+  zc::MutexGuarded<zc::List<Task, &Task::link>> injected;
+  std::atomic<size_t> injectedCount{0};
 
-  Impl(size_t numThreads) {
+  // Tasks queued and not yet finished
+  std::atomic<size_t> outstanding{0};
+
+  // Parking. Queueing bumps the epoch and, if anyone is parked, releases the lot's lock so that
+  // they re-check it. A worker parks only if the epoch did not move since it began searching.
+  std::atomic<uint64_t> epoch{0};
+  std::atomic<size_t> parked{0};
+  std::atomic<bool> stopped{false};
+  zc::MutexGuarded<bool> parkingLot{false};
+
+  Impl(size_t numThreads, Placement placement) {
     ZC_ASSERT(numThreads > 0);
     for (size_t i = 0; i < numThreads; ++i) {
-      workers.add(zc::heap<zc::Thread>([this] { workerLoop(); }));
+      workers.add(zc::heap<Worker>(*this, 0x9E3779B97F4A7C15ull * (i + 1)));
+    }
+    if (placement != Placement::kNone) { place(placement); }
+    // Start the threads only once every deque exists, since they steal from each other
+    for (auto& worker : workers) {
+      Worker& self = *worker;
+      self.thread = zc::heap<zc::Thread>([this, &self] { workerLoop(self); });
     }
   }
 
+  void place(Placement placement) {
+    const zc::Vector<zc::Vector<int>> nodes = getCpusByNode();
+    if (nodes.empty()) { return; }
+
+    if (placement == Placement::kNodes) {
+      for (size_t i = 0; i < workers.size(); ++i) {
+        Worker& worker = *workers[i];
+        worker.node = i % nodes.size();
+        worker.cpus.addAll(nodes[worker.node]);
+      }
+      nodeCount = zc::min(nodes.size(), workers.size());
+      return;
+    }
+
+    // Consecutive workers share a node, so that a small pool stays on one
+    zc::Vector<zc::Tuple<size_t, int>> cpus;
+    for (size_t node = 0; node < nodes.size(); ++node) {
+      for (int cpu : nodes[node]) { cpus.add(zc::tuple(node, cpu)); }
+    }
+    for (size_t i = 0; i < workers.size(); ++i) {
+      Worker& worker = *workers[i];
+      const auto& cpu = cpus[i % cpus.size()];
+      worker.node = zc::get<0>(cpu);
+      worker.cpus.add(zc::get<1>(cpu));
+    }
+    nodeCount = zc::get<0>(cpus[zc::min(workers.size(), cpus.size()) - 1]) + 1;
+  }
+
   ~Impl() noexcept(false) {
-    {  // Lock scope to set stop flag and wait for completion
-      auto lockedTasks = tasks.lockExclusive();
-      stop = true;
-      // Wait until all tasks are completed before stopping
-      lockedTasks.wait([](const auto& taskList) { return taskList.empty(); }, zc::none);
+    waitIdle();
+    {  // Wake the workers to exit
+      auto locked = parkingLot.lockExclusive();
+      stopped.store(true, std::memory_order_release);
+      *locked = true;
+    }
+    for (auto& worker : workers) { worker->thread = nullptr; }  // Join all threads
+  }
+
+  void waitIdle() {
+    Worker* worker = currentWorker;
+    ZC_REQUIRE(worker == nullptr || &worker->pool != this,
+               "waitIdle() called from a task of the same pool");
+    while (outstanding.load(std::memory_order_acquire) > 0) {
+      if (runPendingTask()) { continue; }
+      // The rest are running on the workers
+      parkingLot.lockExclusive().wait(
+          [this](const bool&) { return outstanding.load(std::memory_order_acquire) == 0; },
+          zc::none);
     }
-    workers.clear();  // Join all threads
   }
 
   void enqueue(zc::Function<void()> task) {
-    auto lockedTasks = tasks.lockExclusive();
-    if (stop) {
+    if (stopped.load(std::memory_order_acquire)) {
       ZC_FAIL_ASSERT("enqueue on stopped ThreadPool");
       return;
     }
-    lockedTasks->add(arena.allocate<Task>(zc::mv(task)));
+    Task& queued = *releaseTask(zc::heap<Task>(zc::mv(task)));
+    outstanding.fetch_add(1, std::memory_order_relaxed);
+
+    Worker* worker = currentWorker;
+    if (worker != nullptr && &worker->pool == this) {
+      worker->deque.push(queued);
+    } else {
+      injected.lockExclusive()->add(queued);
+      injectedCount.fetch_add(1, std::memory_order_seq_cst);
+    }
+    notify();
   }
 
-  void workerLoop() {
-    while (true) {
-      zc::Maybe<Task&> taskToRun;
-      auto lockedTasks = tasks.lockExclusive();
+  void notify() {
+    epoch.fetch_add(1, std::memory_order_seq_cst);
+    if (parked.load(std::memory_order_seq_cst) > 0) { parkingLot.lockExclusive(); }
+  }
+
+  /// Take a task for `self`, or for a thread outside the pool if null: its own newest task first,
+  /// then the oldest injected one, then one stolen from a random victim, on its own node first.
+  zc::Maybe<Task&> findTask(Worker* self) {
+    if (self != nullptr) {
+      ZC_IF_SOME(task, self->deque.pop()) { return task; }
+    }
+    if (injectedCount.load(std::memory_order_seq_cst) > 0) {
+      auto locked = injected.lockExclusive();
+      if (!locked->empty()) {
+        Task& task = locked->front();
+        locked->remove(task);
+        injectedCount.fetch_sub(1, std::memory_order_relaxed);
+        return task;
+      }
+    }
+    const size_t count = workers.size();
+    const size_t start = self != nullptr ? self->nextVictim(count) : 0;
+    // A local victim's tasks most likely use memory first touched on this node
+    const bool localFirst = self != nullptr && nodeCount > 1;
+    for (int pass = localFirst ? 0 : 1; pass < 2; ++pass) {
+      for (size_t i = 0; i < count; ++i) {
+        Worker& victim = *workers[(start + i) % count];
+        if (&victim == self) { continue; }
+        if (localFirst && (victim.node == self->node) != (pass == 0)) { continue; }
+        ZC_IF_SOME(task, victim.deque.steal()) { return task; }
+      }
+    }
+    return zc::none;
+  }
 
-      lockedTasks.wait([this](const auto& taskList) { return stop || !taskList.empty(); },
-                       zc::none);
+  bool hasQueuedTasks() const {
+    if (injectedCount.load(std::memory_order_seq_cst) > 0) { return true; }
+    for (const auto& worker : workers) {
+      if (!worker->deque.isEmpty()) { return true; }
+    }
+    return false;
+  }
+
+  void run(Task& task) {
+    {
+      zc::Own<Task> owned = adoptTask(&task);
+      zc::Maybe<zc::Exception> exception = zc::runCatchingExceptions([&]() { owned->func(); });
+      ZC_IF_SOME(e, exception) {
+        ZC_LOG(ERROR, "Task executed with exception: ", e.getDescription());
+      }
+    }
+    // The last task lets the destructor go on
+    if (outstanding.fetch_sub(1, std::memory_order_acq_rel) == 1) { parkingLot.lockExclusive(); }
+  }
 
-      if (stop && lockedTasks->empty()) { return; }
+  bool runPendingTask() {
+    Worker* worker = currentWorker;
+    ZC_IF_SOME(task, findTask(worker != nullptr && &worker->pool == this ? worker : nullptr)) {
+      run(task);
+      return true;
+    }
+    return false;
+  }
 
-      if (!lockedTasks->empty()) {
-        Task& taskRef = lockedTasks->front();
-        lockedTasks->remove(taskRef);
-        taskToRun = taskRef;
+  void workerLoop(Worker& self) {
+    currentWorker = &self;
+    pinCurrentThread(self.cpus);
+    while (true) {
+      const uint64_t seen = epoch.load(std::memory_order_seq_cst);
+      ZC_IF_SOME(task, findTask(&self)) {
+        run(task);
+        continue;
       }
 
-      ZC_IF_SOME(taskRef, taskToRun) {
-        zc::Maybe<zc::Exception> exception = zc::runCatchingExceptions([&]() { taskRef.func(); });
-        ZC_IF_SOME(e, exception) {
-          ZC_LOG(ERROR, "Task executed with exception: ", e.getDescription());
-        }
+      auto locked = parkingLot.lockExclusive();
+      if (*locked) { return; }
+      parked.fetch_add(1, std::memory_order_seq_cst);
+      // A task queued after the search but before `parked` went up did not wake anyone
+      if (!hasQueuedTasks()) {
+        locked.wait(
+            [&](const bool& stop) {
+              return stop || epoch.load(std::memory_order_seq_cst) != seen;
+            },
+            zc::none);
       }
+      parked.fetch_sub(1, std::memory_order_seq_cst);
+      if (*locked) { return; }
     }
   }
 };
 
-ThreadPool::ThreadPool(size_t numThreads) : impl(zc::heap<Impl>(numThreads)) {}
+thread_local ThreadPool::Impl::Worker* ThreadPool::Impl::currentWorker = nullptr;
+
+ThreadPool::ThreadPool(size_t numThreads, Placement placement)
+    : impl(zc::heap<Impl>(numThreads, placement)) {}
 
-ThreadPool::~ThreadPool() noexcept(false) {}
+ThreadPool::~ThreadPool() noexcept(false) {
+  // Drain while `impl` is still set: tasks still running may enqueue more through this pool, and
+  // disposing an Own clears it before the destructor of what it owns runs.
+  impl->waitIdle();
+}
 
 void ThreadPool::enqueue(zc::Function<void()> task) { impl->enqueue(zc::mv(task)); }
 
+bool ThreadPool::runPendingTask() { return impl->runPendingTask(); }
+
+void ThreadPool::waitIdle() { impl->waitIdle(); }
+
+// ================================================================================
+// TaskGroup
+
+TaskGroup::TaskGroup(ThreadPool& pool) : pool(pool) {}
+
+TaskGroup::~TaskGroup() noexcept(false) {
+  wait();
+  ZC_IF_SOME(exception, state.lockExclusive()->exception) {
+    ZC_LOG(ERROR, "Forked task threw, and the group was not joined: ", exception.getDescription());
+  }
+}
+
+void TaskGroup::fork(zc::Function<void()> task) {
+  ++state.lockExclusive()->pending;
+  pool.enqueue([this, task = zc::mv(task)]() mutable {
+    zc::Maybe<zc::Exception> exception;
+    if (!isCancelled()) { exception = zc::runCatchingExceptions([&]() { task(); }); }
+    auto locked = state.lockExclusive();
+    ZC_IF_SOME(e, exception) {
+      cancel();
+      if (locked->exception == zc::none) { locked->exception = zc::mv(e); }
+    }
+    --locked->pending;
+  });
+}
+
+void TaskGroup::cancel() { cancelled.store(true, std::memory_order_release); }
+
+bool TaskGroup::isCancelled() const { return cancelled.load(std::memory_order_acquire); }
+
+void TaskGroup::join() {
+  wait();
+  zc::Maybe<zc::Exception> exception = zc::mv(state.lockExclusive()->exception);
+  ZC_IF_SOME(e, exception) { zc::throwFatalException(zc::mv(e)); }
+}
+
+void TaskGroup::wait() {
+  while (state.lockShared()->pending > 0) {
+    if (pool.runPendingTask()) { continue; }
+    // The rest are running on other threads; any they fork, those threads run or share
+    state.lockExclusive().wait([](const State& s) { return s.pending == 0; }, zc::none);
+  }
+}
+
 }  // namespace basic
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,9 +14,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <thread>  // For std::thread::hardware_concurrency()
 
+#include "zc/core/array.h"
+#include "zc/core/exception.h"
 #include "zc/core/function.h"
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
 
 ZC_BEGIN_HEADER
 
@@ -24,22 +29,127 @@ namespace zomlang {
 namespace compiler {
 namespace basic {
 
+/// \brief Work-stealing pool of worker threads.
+///
+/// Every worker owns a Chase-Lev deque. A task queued from a worker goes onto that worker's deque,
+/// which the worker pops LIFO, so follow-up work runs while its data is still in cache; idle
+/// workers steal from the other end of a random victim's deque. Tasks queued from other threads go
+/// through a shared injection queue. Workers with nothing to run or steal park until more work is
+/// queued.
+///
+/// The pool is meant to outlive many batches of work: waitIdle() is the barrier between them.
+/// Destruction waits as waitIdle() does.
+///
+/// Workers can be pinned to CPUs or to NUMA nodes. Memory is placed on the node of the thread that
+/// first touches it, so a pinned worker's allocations stay on its node, and with several nodes an
+/// idle worker steals from the workers of its own node before remote ones. Pinning is only
+/// implemented on Linux; elsewhere the placement is ignored.
 class ThreadPool {
 public:
-  explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency());
+  /// \brief Where the workers run.
+  enum class Placement {
+    /// Wherever the OS schedules them
+    kNone,
+    /// Each worker on one CPU the process may run on, filling one node before the next
+    kCores,
+    /// Workers dealt round-robin over the NUMA nodes, each free to run on any CPU of its node
+    kNodes,
+  };
+
+  explicit ThreadPool(size_t numThreads = std::thread::hardware_concurrency(),
+                      Placement placement = Placement::kNone);
   ~ThreadPool() noexcept(false);
 
   /// Disallow copy and move operations
   ZC_DISALLOW_COPY_AND_MOVE(ThreadPool);
 
-  /// Enqueue a task to the thread pool
+  /// Enqueue a task to the thread pool. Exceptions escaping the task are logged.
   void enqueue(zc::Function<void()> task);
 
+  /// Run one queued task on the calling thread, if any can be taken. Lets a thread waiting for
+  /// tasks help run them instead of blocking.
+  /// \return True if a task was run
+  bool runPendingTask();
+
+  /// Block until every queued task has run, including tasks queued by running tasks, helping run
+  /// them meanwhile. Must not be called from inside one of the pool's tasks, which would wait for
+  /// itself; a task waits for the work it forks with a TaskGroup instead.
+  void waitIdle();
+
 private:
   struct Impl;
   zc::Own<Impl> impl;
 };
 
+/// \brief Tasks forked onto a pool and joined together, for parallelism nested inside a task.
+///
+/// fork() queues a task, from a worker onto its own deque, where it runs next unless an idle
+/// worker steals it first. join() runs queued tasks on the calling thread until the group's are
+/// done, so waiting inside a task does not idle its worker. The destructor waits as join() does
+/// but does not rethrow.
+///
+/// cancel() skips the tasks that have not started; the ones running finish, or stop early if they
+/// poll isCancelled(). A task that throws cancels its group.
+class TaskGroup {
+public:
+  explicit TaskGroup(ThreadPool& pool);
+  ~TaskGroup() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(TaskGroup);
+
+  /// Queue `task` as part of the group. May be called from the group's own tasks.
+  void fork(zc::Function<void()> task);
+
+  /// Wait for every forked task, then rethrow the first exception any of them threw.
+  void join();
+
+  void cancel();
+  bool isCancelled() const;
+
+private:
+  struct State {
+    size_t pending = 0;
+    zc::Maybe<zc::Exception> exception;
+  };
+
+  ThreadPool& pool;
+  zc::MutexGuarded<State> state;
+  std::atomic<bool> cancelled{false};
+
+  void wait();
+};
+
+/// \brief TaskGroup whose tasks each compute a value, collected in fork order.
+template <typename T>
+class ResultGroup {
+public:
+  explicit ResultGroup(ThreadPool& pool) : group(pool) {}
+
+  ZC_DISALLOW_COPY_AND_MOVE(ResultGroup);
+
+  void fork(zc::Function<T()> task) {
+    zc::Maybe<T>& slot = *slots.add(zc::heap<zc::Maybe<T>>());
+    group.fork([&slot, task = zc::mv(task)]() mutable { slot = task(); });
+  }
+
+  /// Wait for every task and rethrow the first exception any of them threw. Otherwise returns
+  /// the results in fork order, none for the tasks cancel() skipped.
+  zc::Array<zc::Maybe<T>> join() {
+    group.join();
+    auto results = zc::heapArrayBuilder<zc::Maybe<T>>(slots.size());
+    for (auto& slot : slots) { results.add(zc::mv(*slot)); }
+    return results.finish();
+  }
+
+  void cancel() { group.cancel(); }
+  bool isCancelled() const { return group.isCancelled(); }
+
+private:
+  // Written by the tasks, so declared before the group whose destructor waits for them
+  zc::Vector<zc::Own<zc::Maybe<T>>> slots;
+  TaskGroup group;
+};
+
 }  // namespace basic
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <cstdint>
+
 namespace zomlang {
 namespace compiler {
 namespace basic {
@@ -22,9 +24,33 @@ struct LangOptions {
   bool useUnicode;
   bool allowDollarIdentifiers;
   bool supportRegexLiterals;
-  // more...
+  /// Allocate each SourceFile's AST from an arena that is freed along with the tree
+  bool useAstArena;
+  /// Parse buffers of at least this many bytes in chunks on the thread pool given to
+  /// `performParse()`; 0 disables it
+  uint32_t parallelParseMinBytes;
+  /// Most chunks to parse one buffer in; 0 means one per hardware thread
+  uint32_t parallelParseMaxChunks;
+  /// Skip function and method bodies by brace matching and parse each one when its declaration's
+  /// getBody() is first called. Diagnostics inside a body are reported only then, and the tree
+  /// must not outlive the source manager, diagnostic engine and string pool it was parsed with.
+  bool lazyFunctionBodies;
+  /// Give each buffer the driver parses a string pool of its own, kept alive with the driver,
+  /// rather than have all workers intern into the shared pool. Strings from different buffers
+  /// are then equal by content but not by address.
+  bool perBufferStringPools;
+  // more... A new option must be added to basic::fingerprint() if it changes what parsing
+  // produces.
 
-  LangOptions() : useUnicode(true), allowDollarIdentifiers(false), supportRegexLiterals(true) {}
+  LangOptions()
+      : useUnicode(true),
+        allowDollarIdentifiers(false),
+        supportRegexLiterals(true),
+        useAstArena(true),
+        parallelParseMinBytes(1u << 20),
+        parallelParseMaxChunks(0),
+        lazyFunctionBodies(false),
+        perBufferStringPools(false) {}
 };
 
 }  // namespace basic
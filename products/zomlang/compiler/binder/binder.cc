@@ -18,6 +18,8 @@
 
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
+#include "zc/core/hash.h"
+#include "zc/core/map.h"
 #include "zc/core/memory.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
@@ -60,6 +62,32 @@ static zc::StringPtr getIdentifierName(const ast::NamedDeclaration& decl) {
   return name;
 }
 
+namespace {
+
+/// A name resolved from a scope, as looked up. Hashes like the ResolutionKey it matches, so a
+/// cache hit does not copy the name.
+struct ResolutionQuery {
+  const symbol::Scope* scope;
+  zc::StringPtr name;
+
+  zc::uint hashCode() const { return zc::hashCode(scope, name); }
+};
+
+struct ResolutionKey {
+  const symbol::Scope* scope;
+  zc::String name;
+
+  bool operator==(const ResolutionKey& other) const {
+    return scope == other.scope && name == other.name;
+  }
+  bool operator==(const ResolutionQuery& query) const {
+    return scope == query.scope && name == query.name;
+  }
+  zc::uint hashCode() const { return zc::hashCode(scope, name); }
+};
+
+}  // namespace
+
 // Implementation details for Binder class
 struct Binder::Impl {
   symbol::SymbolTable& symbolTable;
@@ -74,12 +102,52 @@ struct Binder::Impl {
   // Scope stack for tracking nested scopes
   zc::Vector<zc::Maybe<symbol::Scope&>> scopeStack;
 
-  zc::Vector<zc::String> ownedScopeNames;
+  // Reused to format scope names before they are interned
+  zc::Vector<char> scopeNameBuffer;
   uint32_t nextScopeId = 1;
 
   // Current symbol counter for unique IDs
   uint32_t nextSymbolId = 1;
 
+  // Scope-chain resolutions, including misses, made at resolutionGeneration of the symbol
+  // table. Any declaration, entry or drop moves the table on and empties the cache.
+  mutable zc::HashMap<ResolutionKey, zc::Maybe<symbol::Symbol&>> resolutions;
+  mutable uint64_t resolutionGeneration = 0;
+
+  // Symbols declared by the nodes bound so far, indexed by the ids the binder gives the nodes.
+  // Ids run on across source files, so one table serves every file this binder binds.
+  ast::NodeSideTable<symbol::SymbolId> nodeSymbols;
+  uint32_t nextNodeId = 1;
+
+  /// The node's id, numbering it first if it has none. A node numbered by another binder keeps
+  /// its id, and ours continue after it.
+  ast::NodeId identify(ast::Node& node) {
+    ast::NodeId id = node.getId();
+    if (id.isValid()) {
+      nextNodeId = zc::max(nextNodeId, id.index() + 1);
+    } else {
+      id = ast::NodeId::create(nextNodeId++);
+      node.setId(id);
+    }
+    return id;
+  }
+
+  /// Name for a new scope, "<kind>#<id>" or "<kind>#<id>:<name>", interned in the symbol table so
+  /// that it lives as long as the scope. Formatted in a reused buffer, so no temporary string is
+  /// allocated.
+  zc::StringPtr makeScopeName(zc::StringPtr kind, zc::Maybe<zc::StringPtr> name = zc::none) {
+    auto id = zc::toCharSequence(nextScopeId++);
+    scopeNameBuffer.clear();
+    scopeNameBuffer.addAll(kind);
+    scopeNameBuffer.add('#');
+    scopeNameBuffer.addAll(id);
+    ZC_IF_SOME(declared, name) {
+      scopeNameBuffer.add(':');
+      scopeNameBuffer.addAll(declared);
+    }
+    return symbolTable.internName(scopeNameBuffer.asPtr());
+  }
+
   explicit Impl(symbol::SymbolTable& symbolTable, diagnostics::DiagnosticEngine& diagEng) noexcept
       : symbolTable(symbolTable), diagEng(diagEng) {
     // Initialize with global scope using mutable version
@@ -106,12 +174,19 @@ Binder::Binder(symbol::SymbolTable& symbolTable, diagnostics::DiagnosticEngine&
 Binder::~Binder() noexcept(false) = default;
 
 void Binder::bindSourceFile(ast::SourceFile& sourceFile) {
+  beginSourceFile();
+
+  // Visit the source file to bind all its contents
+  dispatch(sourceFile);
+}
+
+void Binder::beginSourceFile() {
   // Reset binding context for new source file
   impl->context = BindingContext{};
   impl->containerStack.clear();
   impl->scopeStack.clear();
-  impl->ownedScopeNames.clear();
   impl->nextScopeId = 1;
+  impl->resolutions.clear();
 
   // Initialize with global scope
   auto& scopeManager = impl->symbolTable.getScopeManager();
@@ -121,17 +196,23 @@ void Binder::bindSourceFile(ast::SourceFile& sourceFile) {
     impl->symbolTable.setCurrentScope(globalScope);
   }
   else { ZC_FAIL_REQUIRE("Global scope not found"); }
-
-  // Visit the source file to bind all its contents
-  sourceFile.accept(*this);
 }
 
-void Binder::bind(ast::Node& node) { node.accept(*this); }
+void Binder::bindStatement(ast::Statement& statement) { dispatch(statement); }
+
+void Binder::bind(ast::Node& node) { dispatch(node); }
+
+zc::Maybe<const symbol::Symbol&> Binder::getSymbol(const ast::Node& node) const {
+  const ast::NodeId id = node.getId();
+  if (!id.isValid()) { return zc::none; }
+  return impl->symbolTable.getSymbol(impl->nodeSymbols.get(id));
+}
 
 void Binder::addDeclarationToSymbol(symbol::Symbol& symbol, ast::Node& node,
                                     symbol::SymbolFlags flags) {
   // Add flags to symbol
   symbol.addFlag(flags);
+  impl->nodeSymbols.set(impl->identify(node), symbol.getId());
 
   // For nodes that implement Declaration interface, we need to cast to the specific type first
   // then access the Declaration interface through that type
@@ -226,12 +307,12 @@ void Binder::visit(const ast::VariableDeclaration& node) { bindVariableDeclarati
 
 void Binder::visit(const ast::VariableDeclarationList& node) {
   // Visit all variable declarations in the list
-  for (const auto& binding : node.getBindings()) { binding.accept(*this); }
+  for (const auto& binding : node.getBindings()) { dispatch(binding); }
 }
 
 void Binder::visit(const ast::VariableStatement& node) {
   // Visit the variable declaration list
-  node.getDeclarations().accept(*this);
+  dispatch(node.getDeclarations());
 }
 
 void Binder::visit(const ast::FunctionDeclaration& node) { bindFunctionDeclaration(node); }
@@ -260,76 +341,76 @@ void Binder::visit(const ast::BlockStatement& node) { bindBlockStatement(node);
 
 void Binder::visit(const ast::ExpressionStatement& node) {
   // Visit the expression
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
 }
 
 void Binder::visit(const ast::IfStatement& node) {
   // Visit condition and branches
-  node.getCondition().accept(*this);
-  node.getThenStatement().accept(*this);
+  dispatch(node.getCondition());
+  dispatch(node.getThenStatement());
 
   // Visit else statement if it exists
-  ZC_IF_SOME(elseStmt, node.getElseStatement()) { elseStmt.accept(*this); }
+  ZC_IF_SOME(elseStmt, node.getElseStatement()) { dispatch(elseStmt); }
 }
 
 void Binder::visit(const ast::WhileStatement& node) {
   // Visit condition and body
-  node.getCondition().accept(*this);
-  node.getBody().accept(*this);
+  dispatch(node.getCondition());
+  dispatch(node.getBody());
 }
 
 void Binder::visit(const ast::ForStatement& node) {
   // Visit initialization if present
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
 
   // Visit condition if present
-  ZC_IF_SOME(condition, node.getCondition()) { condition.accept(*this); }
+  ZC_IF_SOME(condition, node.getCondition()) { dispatch(condition); }
 
   // Visit update if present
-  ZC_IF_SOME(update, node.getUpdate()) { update.accept(*this); }
+  ZC_IF_SOME(update, node.getUpdate()) { dispatch(update); }
 
   // Visit body
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
 }
 
 void Binder::visit(const ast::ForInStatement& node) {
   // Visit initializer
-  node.getInitializer().accept(*this);
+  dispatch(node.getInitializer());
 
   // Visit expression
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
 
   // Visit body
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
 }
 
 void Binder::visit(const ast::ReturnStatement& node) {
   // Visit return expression if present
-  ZC_IF_SOME(expr, node.getExpression()) { expr.accept(*this); }
+  ZC_IF_SOME(expr, node.getExpression()) { dispatch(expr); }
 }
 
 void Binder::visit(const ast::MatchStatement& node) {
   // Visit discriminant
-  node.getDiscriminant().accept(*this);
+  dispatch(node.getDiscriminant());
 
   // Visit all clauses
-  for (const auto& clause : node.getClauses()) { clause.accept(*this); }
+  for (const auto& clause : node.getClauses()) { dispatch(clause); }
 }
 
 void Binder::visit(const ast::MatchClause& node) {
   // Visit pattern
-  node.getPattern().accept(*this);
+  dispatch(node.getPattern());
 
   // Visit guard if present
-  ZC_IF_SOME(guard, node.getGuard()) { guard.accept(*this); }
+  ZC_IF_SOME(guard, node.getGuard()) { dispatch(guard); }
 
   // Visit body
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
 }
 
 void Binder::visit(const ast::DefaultClause& node) {
   // Visit all statements
-  for (const auto& stmt : node.getStatements()) { stmt.accept(*this); }
+  for (const auto& stmt : node.getStatements()) { dispatch(stmt); }
 }
 
 void Binder::visit(const ast::IterationStatement& node) {
@@ -348,15 +429,15 @@ void Binder::visit(const ast::Identifier& node) {
 
 void Binder::visit(const ast::BinaryExpression& node) {
   // Visit left and right operands
-  node.getLeft().accept(*this);
-  node.getRight().accept(*this);
+  dispatch(node.getLeft());
+  dispatch(node.getRight());
 }
 
 void Binder::visit(const ast::CallExpression& node) {
   // Visit callee and arguments
-  node.getCallee().accept(*this);
+  dispatch(node.getCallee());
 
-  for (auto& arg : node.getArguments()) { arg.accept(*this); }
+  for (auto& arg : node.getArguments()) { dispatch(arg); }
 }
 
 void Binder::visit(const ast::MemberExpression& node) {
@@ -367,25 +448,25 @@ void Binder::visit(const ast::MemberExpression& node) {
 // Module visitors
 void Binder::visit(const ast::SourceFile& sourceFile) {
   // Visit all top-level declarations
-  for (auto& stmt : sourceFile.getStatements()) { stmt.accept(*this); }
+  for (auto& stmt : sourceFile.getStatements()) { dispatch(stmt); }
 }
 
 void Binder::visit(const ast::ModuleDeclaration& moduleDecl) {
-  moduleDecl.getModulePath().accept(*this);
+  dispatch(moduleDecl.getModulePath());
 }
 
 void Binder::visit(const ast::ImportDeclaration& importDecl) { bindImportDeclaration(importDecl); }
 
 void Binder::visit(const ast::ImportSpecifier& importSpecifier) {
-  importSpecifier.getImportedName().accept(*this);
-  ZC_IF_SOME(alias, importSpecifier.getAlias()) { alias.accept(*this); }
+  dispatch(importSpecifier.getImportedName());
+  ZC_IF_SOME(alias, importSpecifier.getAlias()) { dispatch(alias); }
 }
 
 void Binder::visit(const ast::ExportDeclaration& exportDecl) { bindExportDeclaration(exportDecl); }
 
 void Binder::visit(const ast::ExportSpecifier& exportSpecifier) {
-  exportSpecifier.getExportedName().accept(*this);
-  ZC_IF_SOME(alias, exportSpecifier.getAlias()) { alias.accept(*this); }
+  dispatch(exportSpecifier.getExportedName());
+  ZC_IF_SOME(alias, exportSpecifier.getAlias()) { dispatch(alias); }
 }
 
 // Type visitors
@@ -397,23 +478,23 @@ void Binder::visit(const ast::TypeReferenceNode& typeRef) {
 
 void Binder::visit(const ast::ArrayTypeNode& arrayType) {
   // Visit element type
-  arrayType.getElementType().accept(*this);
+  dispatch(arrayType.getElementType());
 }
 
 void Binder::visit(const ast::FunctionTypeNode& functionType) {
   // Visit parameter types and return type
-  for (auto& param : functionType.getParameters()) { param.accept(*this); }
+  for (auto& param : functionType.getParameters()) { dispatch(param); }
 
   // Visit return type directly - getReturnType() returns const ReturnTypeNode&
-  functionType.getReturnType().accept(*this);
+  dispatch(functionType.getReturnType());
 }
 
 // Default implementations for other required visitors
 void Binder::visit(const ast::TypeParameterDeclaration& node) {}
 void Binder::visit(const ast::BindingElement& node) {
   ZC_IF_SOME(pattern, node.getBindingPattern()) {
-    for (auto& element : pattern.getElements()) { element.accept(*this); }
-    ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+    for (auto& element : pattern.getElements()) { dispatch(element); }
+    ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
     return;
   }
 
@@ -440,11 +521,11 @@ void Binder::visit(const ast::BindingElement& node) {
         }
       }
       ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) {
-        ZC_IF_SOME(pattern, maybePattern) { pattern.accept(*this); }
+        ZC_IF_SOME(pattern, maybePattern) { dispatch(pattern); }
       }
     }
 
-    ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+    ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   }
 }
 
@@ -464,19 +545,19 @@ void Binder::visit(const ast::EnumMember& node) {
     symbol::SymbolFlags flags = symbol::SymbolFlags::Property | symbol::SymbolFlags::Immutable;
     addDeclarationToSymbol(symbol, const_cast<ast::EnumMember&>(node), flags);
 
-    ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
-    ZC_IF_SOME(type, node.getTupleType()) { type.accept(*this); }
+    ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
+    ZC_IF_SOME(type, node.getTupleType()) { dispatch(type); }
   }
 }
 
 void Binder::visit(const ast::ErrorDeclaration& node) {
   // Error declaration doesn't bind symbols but might have children
-  for (const auto& member : node.getMembers()) { member.accept(*this); }
+  for (const auto& member : node.getMembers()) { dispatch(member); }
 }
 void Binder::visit(const ast::EmptyStatement& node) {}
 void Binder::visit(const ast::LabeledStatement& node) {
-  node.getLabel().accept(*this);
-  node.getStatement().accept(*this);
+  dispatch(node.getLabel());
+  dispatch(node.getStatement());
 }
 void Binder::visit(const ast::BreakStatement& node) {}
 void Binder::visit(const ast::ContinueStatement& node) {}
@@ -489,8 +570,8 @@ void Binder::visit(const ast::UpdateExpression& node) {
   // UpdateExpression is a base class, no specific members to visit
   // Derived classes like PrefixUnaryExpression and PostfixUnaryExpression handle specifics
 }
-void Binder::visit(const ast::PrefixUnaryExpression& node) { node.getOperand().accept(*this); }
-void Binder::visit(const ast::PostfixUnaryExpression& node) { node.getOperand().accept(*this); }
+void Binder::visit(const ast::PrefixUnaryExpression& node) { dispatch(node.getOperand()); }
+void Binder::visit(const ast::PostfixUnaryExpression& node) { dispatch(node.getOperand()); }
 void Binder::visit(const ast::LeftHandSideExpression& node) {
   // LeftHandSideExpression is a base class, no specific members to visit
 }
@@ -498,24 +579,24 @@ void Binder::visit(const ast::PrimaryExpression& node) {
   // PrimaryExpression is a base class, no specific members to visit
 }
 void Binder::visit(const ast::PropertyAccessExpression& node) {
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   // Property name is an identifier, no need to visit
 }
 void Binder::visit(const ast::ElementAccessExpression& node) {
-  node.getExpression().accept(*this);
-  node.getIndex().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getIndex());
 }
 void Binder::visit(const ast::NewExpression& node) {
-  node.getCallee().accept(*this);
+  dispatch(node.getCallee());
   ZC_IF_SOME(args, node.getArguments()) {
-    for (const auto& arg : args) { arg->accept(*this); }
+    for (const auto& arg : args) { dispatch(*arg); }
   }
 }
-void Binder::visit(const ast::ParenthesizedExpression& node) { node.getExpression().accept(*this); }
+void Binder::visit(const ast::ParenthesizedExpression& node) { dispatch(node.getExpression()); }
 void Binder::visit(const ast::ConditionalExpression& node) {
-  node.getTest().accept(*this);
-  node.getConsequent().accept(*this);
-  node.getAlternate().accept(*this);
+  dispatch(node.getTest());
+  dispatch(node.getConsequent());
+  dispatch(node.getAlternate());
 }
 void Binder::visit(const ast::LiteralExpression& node) {
   // LiteralExpression is a base class, no specific members to visit
@@ -527,65 +608,65 @@ void Binder::visit(const ast::BooleanLiteral& node) {}
 void Binder::visit(const ast::NullLiteral& node) {}
 
 void Binder::visit(const ast::TemplateSpan& node) {
-  node.getExpression().accept(*this);
-  node.getLiteral().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getLiteral());
 }
 
 void Binder::visit(const ast::TemplateLiteralExpression& node) {
-  node.getHead().accept(*this);
-  for (const auto& span : node.getSpans()) { span.accept(*this); }
+  dispatch(node.getHead());
+  for (const auto& span : node.getSpans()) { dispatch(span); }
 }
 
 void Binder::visit(const ast::CastExpression& node) {
-  node.getExpression().accept(*this);
-  node.getTargetType().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
 }
 void Binder::visit(const ast::AsExpression& node) {
-  node.getExpression().accept(*this);
-  node.getTargetType().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
 }
 void Binder::visit(const ast::ForcedAsExpression& node) {
-  node.getExpression().accept(*this);
-  node.getTargetType().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
 }
 void Binder::visit(const ast::ConditionalAsExpression& node) {
-  node.getExpression().accept(*this);
-  node.getTargetType().accept(*this);
+  dispatch(node.getExpression());
+  dispatch(node.getTargetType());
 }
-void Binder::visit(const ast::NonNullExpression& node) { node.getExpression().accept(*this); }
+void Binder::visit(const ast::NonNullExpression& node) { dispatch(node.getExpression()); }
 void Binder::visit(const ast::ExpressionWithTypeArguments& node) {
-  node.getExpression().accept(*this);
+  dispatch(node.getExpression());
   ZC_IF_SOME(typeArgs, node.getTypeArguments()) {
-    for (const auto& typeArg : typeArgs) { typeArg.accept(*this); }
+    for (const auto& typeArg : typeArgs) { dispatch(typeArg); }
   }
 }
-void Binder::visit(const ast::VoidExpression& node) { node.getExpression().accept(*this); }
-void Binder::visit(const ast::TypeOfExpression& node) { node.getExpression().accept(*this); }
-void Binder::visit(const ast::AwaitExpression& node) { node.getExpression().accept(*this); }
+void Binder::visit(const ast::VoidExpression& node) { dispatch(node.getExpression()); }
+void Binder::visit(const ast::TypeOfExpression& node) { dispatch(node.getExpression()); }
+void Binder::visit(const ast::AwaitExpression& node) { dispatch(node.getExpression()); }
 void Binder::visit(const ast::FunctionExpression& node) {
   // Function expressions are anonymous functions that need special handling
   // They create their own scope and bind parameters and body
 
   ZC_IF_SOME(typeParameters, node.getTypeParameters()) {
-    for (const auto& typeParam : typeParameters) { typeParam->accept(*this); }
+    for (const auto& typeParam : typeParameters) { dispatch(*typeParam); }
   }
 
   // Visit parameters
-  for (const auto& param : node.getParameters()) { param.accept(*this); }
+  for (const auto& param : node.getParameters()) { dispatch(param); }
 
   // Visit return type if present
-  ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
+  ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
 
   // Visit function body
-  node.getBody().accept(*this);
+  dispatch(node.getBody());
 }
 
 void Binder::visit(const ast::CaptureElement& node) {
-  ZC_IF_SOME(id, node.getIdentifier()) { id.accept(*this); }
+  ZC_IF_SOME(id, node.getIdentifier()) { dispatch(id); }
 }
 
 void Binder::visit(const ast::ArrayLiteralExpression& node) {
-  for (auto& element : node.getElements()) { element.accept(*this); }
+  for (auto& element : node.getElements()) { dispatch(element); }
 }
 void Binder::visit(const ast::ObjectLiteralExpression& node) {
   // Visit all property assignments
@@ -597,15 +678,15 @@ void Binder::visit(const ast::ObjectLiteralElement& node) {
 }
 
 void Binder::visit(const ast::PropertyAssignment& node) {
-  node.getNameIdentifier().accept(*this);
-  ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+  dispatch(node.getNameIdentifier());
+  ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
 }
 
 void Binder::visit(const ast::ShorthandPropertyAssignment& node) {
-  node.getNameIdentifier().accept(*this);
+  dispatch(node.getNameIdentifier());
 }
 
-void Binder::visit(const ast::SpreadAssignment& node) { node.getExpression().accept(*this); }
+void Binder::visit(const ast::SpreadAssignment& node) { dispatch(node.getExpression()); }
 
 void Binder::visit(const ast::ModulePath& node) {
   // Module paths are just identifiers, no special binding needed
@@ -622,16 +703,15 @@ void Binder::visit(const ast::GetAccessor& node) {
 
     // Create scope for the accessor
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("get_accessor#", impl->nextScopeId++, ":", name));
     symbol::Scope& scope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Function, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Function, impl->makeScopeName("get_accessor"_zc, name), scopeParent);
 
     enterScope(scope);
 
-    for (auto& typeParam : node.getTypeParameters()) { typeParam.accept(*this); }
-    for (auto& param : node.getParameters()) { param.accept(*this); }
-    ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
-    ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+    for (auto& typeParam : node.getTypeParameters()) { dispatch(typeParam); }
+    for (auto& param : node.getParameters()) { dispatch(param); }
+    ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+    ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
 
     exitScope();
   }
@@ -643,16 +723,15 @@ void Binder::visit(const ast::SetAccessor& node) {
 
     // Create scope for the accessor
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("set_accessor#", impl->nextScopeId++, ":", name));
     symbol::Scope& scope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Function, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Function, impl->makeScopeName("set_accessor"_zc, name), scopeParent);
 
     enterScope(scope);
 
-    for (auto& typeParam : node.getTypeParameters()) { typeParam.accept(*this); }
-    for (auto& param : node.getParameters()) { param.accept(*this); }
-    ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
-    ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+    for (auto& typeParam : node.getTypeParameters()) { dispatch(typeParam); }
+    for (auto& param : node.getParameters()) { dispatch(param); }
+    ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+    ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
 
     exitScope();
   }
@@ -662,16 +741,15 @@ void Binder::visit(const ast::InitDeclaration& node) {
   ZC_IF_SOME(parentScope, impl->context.currentScope) {
     // Create scope for init
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("init#", impl->nextScopeId++));
     symbol::Scope& scope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Function, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Function, impl->makeScopeName("init"_zc), scopeParent);
 
     enterScope(scope);
 
-    for (auto& typeParam : node.getTypeParameters()) { typeParam.accept(*this); }
-    for (auto& param : node.getParameters()) { param.accept(*this); }
-    ZC_IF_SOME(returnType, node.getReturnType()) { returnType.accept(*this); }
-    ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+    for (auto& typeParam : node.getTypeParameters()) { dispatch(typeParam); }
+    for (auto& param : node.getParameters()) { dispatch(param); }
+    ZC_IF_SOME(returnType, node.getReturnType()) { dispatch(returnType); }
+    ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
 
     exitScope();
   }
@@ -681,13 +759,12 @@ void Binder::visit(const ast::DeinitDeclaration& node) {
   ZC_IF_SOME(parentScope, impl->context.currentScope) {
     // Create scope for deinit
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("deinit#", impl->nextScopeId++));
     symbol::Scope& scope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Function, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Function, impl->makeScopeName("deinit"_zc), scopeParent);
 
     enterScope(scope);
 
-    ZC_IF_SOME(body, node.getBody()) { body.accept(*this); }
+    ZC_IF_SOME(body, node.getBody()) { dispatch(body); }
 
     exitScope();
   }
@@ -714,12 +791,12 @@ void Binder::visit(const ast::ParameterDeclaration& node) {
         }
       }
       ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) {
-        ZC_IF_SOME(pattern, maybePattern) { pattern.accept(*this); }
+        ZC_IF_SOME(pattern, maybePattern) { dispatch(pattern); }
       }
     }
 
-    ZC_IF_SOME(type, node.getType()) { type.accept(*this); }
-    ZC_IF_SOME(init, node.getInitializer()) { init.accept(*this); }
+    ZC_IF_SOME(type, node.getType()) { dispatch(type); }
+    ZC_IF_SOME(init, node.getInitializer()) { dispatch(init); }
   }
 }
 
@@ -758,13 +835,13 @@ void Binder::visit(const ast::EnumBody& node) {
 }
 
 void Binder::visit(const ast::UnionTypeNode& unionType) {
-  for (auto& type : unionType.getTypes()) { type.accept(*this); }
+  for (auto& type : unionType.getTypes()) { dispatch(type); }
 }
 void Binder::visit(const ast::IntersectionTypeNode& intersectionType) {
-  for (auto& type : intersectionType.getTypes()) { type.accept(*this); }
+  for (auto& type : intersectionType.getTypes()) { dispatch(type); }
 }
 void Binder::visit(const ast::ParenthesizedTypeNode& parenType) {
-  parenType.getType().accept(*this);
+  dispatch(parenType.getType());
 }
 void Binder::visit(const ast::PredefinedTypeNode& predefinedType) {}
 
@@ -796,17 +873,17 @@ void Binder::visit(const ast::ClassElement& node) {}
 void Binder::visit(const ast::InterfaceElement& node) {}
 void Binder::visit(const ast::ObjectTypeNode& objectType) {}
 void Binder::visit(const ast::TupleTypeNode& tupleType) {
-  for (auto& element : tupleType.getElementTypes()) { element.accept(*this); }
+  for (auto& element : tupleType.getElementTypes()) { dispatch(element); }
 }
-void Binder::visit(const ast::ReturnTypeNode& returnType) { returnType.getType().accept(*this); }
+void Binder::visit(const ast::ReturnTypeNode& returnType) { dispatch(returnType.getType()); }
 void Binder::visit(const ast::OptionalTypeNode& optionalType) {
-  optionalType.getType().accept(*this);
+  dispatch(optionalType.getType());
 }
-void Binder::visit(const ast::TypeQueryNode& typeQuery) { typeQuery.getExpression().accept(*this); }
+void Binder::visit(const ast::TypeQueryNode& typeQuery) { dispatch(typeQuery.getExpression()); }
 
 void Binder::visit(const ast::NamedTupleElement& node) {
   // Visit type
-  node.getType().accept(*this);
+  dispatch(node.getType());
 }
 
 // Predefined type visitors - these are leaf nodes with no children to visit
@@ -828,16 +905,16 @@ void Binder::visit(const ast::NullTypeNode& node) {}
 // Binding pattern visitors
 void Binder::visit(const ast::ArrayBindingPattern& node) {
   // TODO: Implement array binding pattern binding
-  for (const auto& element : node.getElements()) { element.accept(*this); }
+  for (const auto& element : node.getElements()) { dispatch(element); }
 }
 
 void Binder::visit(const ast::ObjectBindingPattern& node) {
   // TODO: Implement object binding pattern binding
-  for (const auto& property : node.getProperties()) { property.accept(*this); }
+  for (const auto& property : node.getProperties()) { dispatch(property); }
 }
 
 void Binder::visit(const ast::PatternProperty& node) {
-  ZC_IF_SOME(pattern, node.getPattern()) { pattern.accept(*this); }
+  ZC_IF_SOME(pattern, node.getPattern()) { dispatch(pattern); }
 }
 
 // Expression visitors
@@ -849,7 +926,7 @@ void Binder::visit(const ast::SuperExpression& node) {
   // TODO: Implement super expression binding
 }
 
-void Binder::visit(const ast::SpreadElement& node) { node.getExpression().accept(*this); }
+void Binder::visit(const ast::SpreadElement& node) { dispatch(node.getExpression()); }
 
 // Pattern visitors
 void Binder::visit(const ast::WildcardPattern& node) {
@@ -910,7 +987,7 @@ void Binder::visit(const ast::ClassBody& node) {
 
 void Binder::visit(const ast::HeritageClause& node) {
   // Heritage clause contains type references, visit them
-  for (const auto& t : node.getTypes()) { t->accept(*this); }
+  for (const auto& t : node.getTypes()) { dispatch(*t); }
 }
 
 void Binder::enterScope(symbol::Scope& scope) {
@@ -1001,19 +1078,28 @@ zc::Maybe<const symbol::Symbol&> Binder::lookupSymbol(zc::StringPtr name) const
 
 zc::Maybe<symbol::Symbol&> Binder::lookupSymbolInScope(zc::StringPtr name,
                                                        symbol::Scope& scope) const {
-  return impl->symbolTable.lookupRecursive(name, scope);
+  const uint64_t generation = impl->symbolTable.getGeneration();
+  if (generation != impl->resolutionGeneration) {
+    impl->resolutions.clear();
+    impl->resolutionGeneration = generation;
+  }
+
+  ZC_IF_SOME(cached, impl->resolutions.find(ResolutionQuery{&scope, name})) { return cached; }
+  auto resolved = impl->symbolTable.lookupRecursive(name, scope);
+  impl->resolutions.insert(ResolutionKey{&scope, zc::heapString(name)}, resolved);
+  return resolved;
 }
 
 void Binder::bindImportDeclaration(const ast::ImportDeclaration& importDecl) {
-  importDecl.getModulePath().accept(*this);
-  for (const auto& specifier : importDecl.getSpecifiers()) { specifier.accept(*this); }
-  ZC_IF_SOME(alias, importDecl.getAlias()) { alias.accept(*this); }
+  dispatch(importDecl.getModulePath());
+  for (const auto& specifier : importDecl.getSpecifiers()) { dispatch(specifier); }
+  ZC_IF_SOME(alias, importDecl.getAlias()) { dispatch(alias); }
 }
 
 void Binder::bindExportDeclaration(const ast::ExportDeclaration& exportDecl) {
-  ZC_IF_SOME(modulePath, exportDecl.getModulePath()) { modulePath.accept(*this); }
-  for (const auto& specifier : exportDecl.getSpecifiers()) { specifier.accept(*this); }
-  ZC_IF_SOME(declaration, exportDecl.getDeclaration()) { declaration.accept(*this); }
+  ZC_IF_SOME(modulePath, exportDecl.getModulePath()) { dispatch(modulePath); }
+  for (const auto& specifier : exportDecl.getSpecifiers()) { dispatch(specifier); }
+  ZC_IF_SOME(declaration, exportDecl.getDeclaration()) { dispatch(declaration); }
 }
 
 void Binder::bindVariableDeclaration(const ast::VariableDeclaration& varDecl) {
@@ -1041,12 +1127,12 @@ void Binder::bindVariableDeclaration(const ast::VariableDeclaration& varDecl) {
         }
       }
       ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) {
-        ZC_IF_SOME(pattern, maybePattern) { pattern.accept(*this); }
+        ZC_IF_SOME(pattern, maybePattern) { dispatch(pattern); }
       }
     }
 
-    ZC_IF_SOME(type, varDecl.getType()) { type.accept(*this); }
-    ZC_IF_SOME(init, varDecl.getInitializer()) { init.accept(*this); }
+    ZC_IF_SOME(type, varDecl.getType()) { dispatch(type); }
+    ZC_IF_SOME(init, varDecl.getInitializer()) { dispatch(init); }
   }
 }
 
@@ -1069,20 +1155,19 @@ void Binder::bindFunctionDeclaration(const ast::FunctionDeclaration& funcDecl) {
     addDeclarationToSymbol(symbol, const_cast<ast::FunctionDeclaration&>(funcDecl), storageFlag);
 
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("function#", impl->nextScopeId++, ":", name));
     symbol::Scope& funcScope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Function, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Function, impl->makeScopeName("function"_zc, name), scopeParent);
 
     enterScope(funcScope);
 
     const_cast<ast::FunctionDeclaration&>(funcDecl).setLocals(impl->symbolTable);
 
     const auto& typeParameters = funcDecl.getTypeParameters();
-    for (const auto& typeParam : typeParameters) { typeParam.accept(*this); }
-    for (const auto& param : funcDecl.getParameters()) { param.accept(*this); }
-    ZC_IF_SOME(returnType, funcDecl.getReturnType()) { returnType.accept(*this); }
+    for (const auto& typeParam : typeParameters) { dispatch(typeParam); }
+    for (const auto& param : funcDecl.getParameters()) { dispatch(param); }
+    ZC_IF_SOME(returnType, funcDecl.getReturnType()) { dispatch(returnType); }
 
-    funcDecl.getBody().accept(*this);
+    dispatch(funcDecl.getBody());
 
     exitScope();
   }
@@ -1107,19 +1192,18 @@ void Binder::bindClassDeclaration(const ast::ClassDeclaration& classDecl) {
     addDeclarationToSymbol(symbol, const_cast<ast::ClassDeclaration&>(classDecl), storageFlag);
 
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("class#", impl->nextScopeId++, ":", name));
     symbol::Scope& classScope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Class, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Class, impl->makeScopeName("class"_zc, name), scopeParent);
 
     enterScope(classScope);
 
     const auto& typeParameters = classDecl.getTypeParameters();
-    for (const auto& typeParam : typeParameters) { typeParam.accept(*this); }
+    for (const auto& typeParam : typeParameters) { dispatch(typeParam); }
 
     const auto& heritageClauses = classDecl.getHeritageClauses();
-    for (const auto& clause : heritageClauses) { clause.accept(*this); }
+    for (const auto& clause : heritageClauses) { dispatch(clause); }
     for (const auto& member : classDecl.getMembers()) {
-      if (auto* node = dynamic_cast<const ast::Node*>(&member)) { node->accept(*this); }
+      if (auto* node = dynamic_cast<const ast::Node*>(&member)) { dispatch(*node); }
     }
 
     exitScope();
@@ -1146,14 +1230,13 @@ void Binder::bindInterfaceDeclaration(const ast::InterfaceDeclaration& interface
                            storageFlag);
 
     zc::Maybe<symbol::Scope&> scopeParent = parentScope;
-    impl->ownedScopeNames.add(zc::str("interface#", impl->nextScopeId++, ":", name));
     symbol::Scope& interfaceScope = impl->symbolTable.getScopeManager().createScope(
-        symbol::Scope::Kind::Interface, impl->ownedScopeNames.back(), scopeParent);
+        symbol::Scope::Kind::Interface, impl->makeScopeName("interface"_zc, name), scopeParent);
 
     enterScope(interfaceScope);
 
     for (const auto& member : interfaceDecl.getMembers()) {
-      if (auto* node = dynamic_cast<const ast::Node*>(&member)) { node->accept(*this); }
+      if (auto* node = dynamic_cast<const ast::Node*>(&member)) { dispatch(*node); }
     }
 
     exitScope();
@@ -1165,15 +1248,14 @@ void Binder::bindBlockStatement(const ast::Node& block) {
 
   zc::Maybe<symbol::Scope&> parentScope = impl->context.currentScope;
 
-  impl->ownedScopeNames.add(zc::str("block#", impl->nextScopeId++));
   symbol::Scope& scope = impl->symbolTable.getScopeManager().createScope(
-      symbol::Scope::Kind::Block, impl->ownedScopeNames.back(), parentScope);
+      symbol::Scope::Kind::Block, impl->makeScopeName("block"_zc), parentScope);
 
   enterScope(scope);
 
   const_cast<ast::BlockStatement&>(blockStmt).setLocals(impl->symbolTable);
 
-  for (const auto& stmt : blockStmt.getStatements()) { stmt.accept(*this); }
+  for (const auto& stmt : blockStmt.getStatements()) { dispatch(stmt); }
 
   exitScope();
 }
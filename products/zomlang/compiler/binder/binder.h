@@ -20,6 +20,7 @@
 #include "zomlang/compiler/ast/ast.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/ast/static-visitor.h"
 #include "zomlang/compiler/ast/visitor.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 #include "zomlang/compiler/symbol/scope.h"
@@ -173,7 +174,7 @@ struct BindingContext {
 /// 3. Binding AST nodes to their corresponding symbols
 /// 4. Handling symbol conflicts and error reporting
 /// 5. Managing symbol tables and scope hierarchies
-class Binder : public ast::Visitor {
+class Binder : public ast::Visitor, public ast::StaticVisitor<Binder> {
 public:
   /// \brief Constructor
   /// \param symbolTable Symbol table for managing symbols
@@ -191,6 +192,15 @@ public:
   /// \param sourceFile Source file to bind
   void bindSourceFile(ast::SourceFile& sourceFile);
 
+  /// \brief Start binding a source file statement by statement, as its parser completes them
+  /// \see bindStatement
+  void beginSourceFile();
+
+  /// \brief Bind a top-level statement of the file begun last. Binding every statement in order
+  /// is the same as binding the whole file with `bindSourceFile()`.
+  /// \param statement Top-level statement to bind
+  void bindStatement(ast::Statement& statement);
+
   /// \brief Bind a single AST node
   /// \param node AST node to bind
   void bind(ast::Node& node);
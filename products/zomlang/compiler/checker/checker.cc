@@ -15,14 +15,1255 @@
 #include "zomlang/compiler/checker/checker.h"
 
 #include "zc/core/common.h"
+#include "zc/core/map.h"
 #include "zc/core/string.h"
+#include "zc/core/vector.h"
 #include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/cast.h"
 #include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/static-visitor.h"
 #include "zomlang/compiler/ast/statement.h"
 #include "zomlang/compiler/ast/type.h"
 
 namespace zomlang {
 namespace compiler {
-namespace checker {}  // namespace checker
+namespace checker {
+
+using diagnostics::DiagID;
+
+namespace {
+
+const Type& errorType() { return Type::get(TypeKind::kError); }
+
+zc::String getModuleName(const ast::ModulePath& path) {
+  zc::Vector<zc::StringPtr> segments;
+  for (const auto& segment : path.getSegments()) { segments.add(segment.getText()); }
+  return zc::strArray(segments, ".");
+}
+
+zc::Maybe<const ast::Identifier&> getIdentifier(const ast::NamedDeclaration& declaration) {
+  ZC_SWITCH_ONEOF(declaration.getName()) {
+    ZC_CASE_ONEOF(maybeIdentifier, zc::Maybe<const ast::Identifier&>) { return maybeIdentifier; }
+    ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) { return zc::none; }
+  }
+  ZC_UNREACHABLE;
+}
+
+source::SourceLoc getLoc(const ast::Node& node) { return node.getSourceRange().getStart(); }
+
+/// Module-level declarations of the files of one module.
+struct ModuleScope {
+  zc::String name;
+  /// Functions and global variables
+  zc::HashMap<zc::StringPtr, const Type*> values;
+  /// Classes, interfaces, structs, enums, errors and aliases
+  zc::HashMap<zc::StringPtr, const Type*> types;
+
+  explicit ModuleScope(zc::String name) : name(zc::mv(name)) {}
+};
+
+/// What a file sees at module level besides its module's declarations.
+struct FileScope {
+  const ast::SourceFile& file;
+  ModuleScope& module;
+  /// Import aliases, to the module they name if it is part of the program
+  zc::HashMap<zc::StringPtr, zc::Maybe<const ModuleScope&>> imports;
+  /// Names imported one by one, e.g. `f` after `import a.b { f }`
+  zc::HashMap<zc::StringPtr, const Type*> importedValues;
+
+  FileScope(const ast::SourceFile& file, ModuleScope& module) : file(file), module(module) {}
+};
+
+/// Resolves type annotations against a file's types and the type parameters in scope.
+class TypeResolver {
+public:
+  TypeResolver(const FileScope& scope, TypeInterner& types,
+               zc::ArrayPtr<const Type* const> typeParameters)
+      : scope(scope), types(types), typeParameters(typeParameters) {}
+
+  const Type& resolve(zc::Maybe<const ast::TypeNode&> maybeNode) {
+    ZC_IF_SOME(node, maybeNode) { return resolve(node); }
+    return errorType();
+  }
+
+  const Type& resolve(const ast::TypeNode& node) {
+    switch (node.getKind()) {
+      case ast::SyntaxKind::BoolTypeNode:
+        return Type::get(TypeKind::kBool);
+      case ast::SyntaxKind::StrTypeNode:
+        return Type::get(TypeKind::kStr);
+      case ast::SyntaxKind::UnitTypeNode:
+        return Type::get(TypeKind::kUnit);
+      case ast::SyntaxKind::NullTypeNode:
+        return Type::get(TypeKind::kNull);
+      case ast::SyntaxKind::I8TypeNode:
+        return Type::get(TypeKind::kI8);
+      case ast::SyntaxKind::I16TypeNode:
+        return Type::get(TypeKind::kI16);
+      case ast::SyntaxKind::I32TypeNode:
+        return Type::get(TypeKind::kI32);
+      case ast::SyntaxKind::I64TypeNode:
+        return Type::get(TypeKind::kI64);
+      case ast::SyntaxKind::U8TypeNode:
+        return Type::get(TypeKind::kU8);
+      case ast::SyntaxKind::U16TypeNode:
+        return Type::get(TypeKind::kU16);
+      case ast::SyntaxKind::U32TypeNode:
+        return Type::get(TypeKind::kU32);
+      case ast::SyntaxKind::U64TypeNode:
+        return Type::get(TypeKind::kU64);
+      case ast::SyntaxKind::F32TypeNode:
+        return Type::get(TypeKind::kF32);
+      case ast::SyntaxKind::F64TypeNode:
+        return Type::get(TypeKind::kF64);
+      case ast::SyntaxKind::ArrayTypeNode:
+        return types.array(resolve(ast::cast<ast::ArrayTypeNode>(node).getElementType()));
+      case ast::SyntaxKind::OptionalTypeNode:
+        return types.optional(resolve(ast::cast<ast::OptionalTypeNode>(node).getType()));
+      case ast::SyntaxKind::ParenthesizedTypeNode:
+        return resolve(ast::cast<ast::ParenthesizedTypeNode>(node).getType());
+      case ast::SyntaxKind::ReturnTypeNode:
+        return resolve(ast::cast<ast::ReturnTypeNode>(node).getType());
+      case ast::SyntaxKind::FunctionTypeNode: {
+        const auto& function = ast::cast<ast::FunctionTypeNode>(node);
+        // A generic function type would need inference at every call
+        if (function.getTypeParameters() != zc::none) { return errorType(); }
+        return resolveSignature(function.getParameters(), function.getReturnType(), nullptr);
+      }
+      case ast::SyntaxKind::UnionTypeNode: {
+        zc::Vector<const Type*> members;
+        for (const auto& member : ast::cast<ast::UnionTypeNode>(node).getTypes()) {
+          members.add(&resolve(member));
+        }
+        return types.unionOf(members.asPtr().asConst());
+      }
+      case ast::SyntaxKind::TypeReferenceNode:
+        return resolveReference(ast::cast<ast::TypeReferenceNode>(node));
+      default:
+        // Intersections, tuples, object types and type queries are not checked yet
+        return errorType();
+    }
+  }
+
+  /// \param ownTypeParameters The type parameters the function declares, which must be in scope
+  /// of the resolver already
+  const Type& resolveSignature(const ast::NodeList<ast::ParameterDeclaration>& parameters,
+                               zc::Maybe<const ast::TypeNode&> returnType,
+                               zc::ArrayPtr<const Type* const> ownTypeParameters) {
+    zc::Vector<const Type*> parameterTypes(parameters.size());
+    size_t requiredParameters = 0;
+    bool optionalSeen = false;
+    bool variadic = false;
+    for (const auto& parameter : parameters) {
+      parameterTypes.add(&resolve(parameter.getType()));
+      variadic = parameter.getDotDotDotToken() != zc::none;
+      optionalSeen = optionalSeen || variadic || parameter.getInitializer() != zc::none ||
+                     parameter.getQuestionToken() != zc::none;
+      if (!optionalSeen) { ++requiredParameters; }
+    }
+    return types.function(parameterTypes.asPtr().asConst(), requiredParameters, variadic,
+                          resolve(returnType), ownTypeParameters);
+  }
+
+private:
+  const FileScope& scope;
+  TypeInterner& types;
+  zc::ArrayPtr<const Type* const> typeParameters;
+
+  const Type& resolveReference(const ast::TypeReferenceNode& reference) {
+    const zc::StringPtr name = reference.getName().getText();
+    for (size_t i = typeParameters.size(); i > 0; --i) {
+      if (typeParameters[i - 1]->getName() == name) { return *typeParameters[i - 1]; }
+    }
+    ZC_IF_SOME(type, scope.module.types.find(name)) {
+      ZC_IF_SOME(arguments, reference.getTypeArguments()) {
+        // Only named types are generic; aliases of other types take no arguments
+        if (type->getKind() == TypeKind::kNamed) {
+          zc::Vector<const Type*> resolved(arguments.size());
+          for (const auto& argument : arguments) { resolved.add(&resolve(*argument)); }
+          return types.named(type->getName(), resolved.asPtr().asConst());
+        }
+      }
+      return *type;
+    }
+    return errorType();
+  }
+};
+
+/// Checks the statements and expressions of one function body, or of a file's top level.
+///
+/// Locals live on one stack that every block truncates back to its size at entry, so that
+/// entering a scope allocates nothing.
+class BodyChecker : public ast::StaticVisitor<BodyChecker, const Type&> {
+public:
+  BodyChecker(const FileScope& scope, TypeInterner& types,
+              zc::Maybe<const AssignabilityCache&> relations,
+              diagnostics::DiagnosticEngine& diagnosticEngine)
+      : scope(scope), types(types), relations(relations), diagnosticEngine(diagnosticEngine) {}
+
+  ZC_DISALLOW_COPY_AND_MOVE(BodyChecker);
+
+  /// Check a body against its resolved signature, with the signature's type parameters in scope.
+  void checkFunction(const ast::NodeList<ast::ParameterDeclaration>& parameters,
+                     const Type& signature, const ast::Statement& body) {
+    const size_t typeParameterMark = typeParameters.size();
+    typeParameters.addAll(signature.getTypeParameters());
+    const Type* enclosingReturnType = returnType;
+    returnType = &signature.getResult();
+    const size_t mark = locals.size();
+
+    auto parameterTypes = signature.getParameters();
+    size_t index = 0;
+    for (const auto& parameter : parameters) {
+      const Type& type = *parameterTypes[index++];
+      ZC_IF_SOME(initializer, parameter.getInitializer()) {
+        expectAssignable(initializer, checkExpression(initializer, type), type);
+      }
+      declare(parameter, type);
+    }
+    checkStatement(body);
+
+    locals.truncate(mark);
+    returnType = enclosingReturnType;
+    typeParameters.truncate(typeParameterMark);
+  }
+
+  /// Check a variable declaration's initializer against its annotation, without declaring it.
+  /// \return The declared type, or the initializer's type if there is no annotation
+  const Type& checkVariable(const ast::VariableDeclaration& declaration) {
+    zc::Maybe<const Type&> annotated;
+    ZC_IF_SOME(typeNode, declaration.getType()) { annotated = resolveType(typeNode); }
+    ZC_IF_SOME(initializer, declaration.getInitializer()) {
+      const Type& initialized = checkExpression(initializer, annotated);
+      ZC_IF_SOME(type, annotated) {
+        expectAssignable(initializer, initialized, type);
+        return type;
+      }
+      return initialized;
+    }
+    return annotated.orDefault(errorType());
+  }
+
+  void checkStatement(const ast::Statement& statement) {
+    switch (statement.getKind()) {
+      case ast::SyntaxKind::BlockStatement: {
+        const size_t mark = locals.size();
+        for (const auto& child : ast::cast<ast::BlockStatement>(statement).getStatements()) {
+          checkStatement(child);
+        }
+        locals.truncate(mark);
+        return;
+      }
+      case ast::SyntaxKind::VariableStatement: {
+        const auto& variables = ast::cast<ast::VariableStatement>(statement);
+        for (const auto& declaration : variables.getDeclarations().getBindings()) {
+          declare(declaration, checkVariable(declaration));
+        }
+        return;
+      }
+      case ast::SyntaxKind::ExpressionStatement:
+        checkExpression(ast::cast<ast::ExpressionStatement>(statement).getExpression());
+        return;
+      case ast::SyntaxKind::ReturnStatement: {
+        ZC_IF_SOME(expression, ast::cast<ast::ReturnStatement>(statement).getExpression()) {
+          expectAssignable(expression, checkExpression(expression, *returnType), *returnType);
+        } else {
+          expectAssignable(statement, Type::get(TypeKind::kUnit), *returnType);
+        }
+        return;
+      }
+      case ast::SyntaxKind::IfStatement: {
+        const auto& ifStatement = ast::cast<ast::IfStatement>(statement);
+        checkCondition(ifStatement.getCondition());
+        checkNested(ifStatement.getThenStatement());
+        ZC_IF_SOME(elseStatement, ifStatement.getElseStatement()) { checkNested(elseStatement); }
+        return;
+      }
+      case ast::SyntaxKind::WhileStatement: {
+        const auto& whileStatement = ast::cast<ast::WhileStatement>(statement);
+        checkCondition(whileStatement.getCondition());
+        checkNested(whileStatement.getBody());
+        return;
+      }
+      case ast::SyntaxKind::ForStatement: {
+        const auto& forStatement = ast::cast<ast::ForStatement>(statement);
+        const size_t mark = locals.size();
+        ZC_IF_SOME(initializer, forStatement.getInitializer()) { checkStatement(initializer); }
+        ZC_IF_SOME(condition, forStatement.getCondition()) { checkCondition(condition); }
+        ZC_IF_SOME(update, forStatement.getUpdate()) { checkExpression(update); }
+        checkNested(forStatement.getBody());
+        locals.truncate(mark);
+        return;
+      }
+      case ast::SyntaxKind::ForInStatement: {
+        const auto& forIn = ast::cast<ast::ForInStatement>(statement);
+        const size_t mark = locals.size();
+        checkExpression(forIn.getExpression());
+        checkStatement(forIn.getInitializer());
+        checkNested(forIn.getBody());
+        locals.truncate(mark);
+        return;
+      }
+      case ast::SyntaxKind::LabeledStatement:
+        checkStatement(ast::cast<ast::LabeledStatement>(statement).getStatement());
+        return;
+      case ast::SyntaxKind::MatchStatement: {
+        const auto& match = ast::cast<ast::MatchStatement>(statement);
+        checkExpression(match.getDiscriminant());
+        for (const auto& clause : match.getClauses()) { checkNested(clause); }
+        return;
+      }
+      case ast::SyntaxKind::MatchClause: {
+        const auto& clause = ast::cast<ast::MatchClause>(statement);
+        const size_t mark = locals.size();
+        declare(clause.getPattern());
+        ZC_IF_SOME(guard, clause.getGuard()) { checkCondition(guard); }
+        checkStatement(clause.getBody());
+        locals.truncate(mark);
+        return;
+      }
+      case ast::SyntaxKind::DefaultClause: {
+        const size_t mark = locals.size();
+        for (const auto& child : ast::cast<ast::DefaultClause>(statement).getStatements()) {
+          checkStatement(child);
+        }
+        locals.truncate(mark);
+        return;
+      }
+      case ast::SyntaxKind::FunctionDeclaration: {
+        const auto& function = ast::cast<ast::FunctionDeclaration>(statement);
+        const size_t typeParameterMark = typeParameters.size();
+        for (const auto& typeParameter : function.getTypeParameters()) {
+          ZC_IF_SOME(name, getIdentifier(typeParameter)) {
+            typeParameters.add(&types.typeParameter(name.getText()));
+          }
+        }
+        const Type& signature = resolver().resolveSignature(
+            function.getParameters(), getReturnTypeNode(function.getReturnType()),
+            typeParameters.slice(typeParameterMark, typeParameters.size()).asConst());
+        typeParameters.truncate(typeParameterMark);
+
+        // Declared first, so that the body may call itself
+        declare(function, signature);
+        checkFunction(function.getParameters(), signature, function.getBody());
+        return;
+      }
+      default:
+        // Type declarations, imports and jumps have nothing to check inside a body yet
+        return;
+    }
+  }
+
+  const Type& checkExpression(const ast::Expression& expression,
+                              zc::Maybe<const Type&> expectedType = zc::none) {
+    expected = expectedType;
+    return dispatch(expression);
+  }
+
+  // Expressions, dispatched by `checkExpression()`. Each reads `expected` before checking
+  // anything else, since checking its operands overwrites it.
+
+  template <typename T>
+  const Type& visit(const T& node) {
+    // Not typed yet, e.g. `this` and members of classes
+    return errorType();
+  }
+
+  const Type& visit(const ast::Identifier& identifier) {
+    const zc::StringPtr name = identifier.getText();
+    ZC_IF_SOME(type, lookup(name)) { return type; }
+    diagnosticEngine.diagnose<DiagID::UndefinedIdentifier>(getLoc(identifier), name);
+    return errorType();
+  }
+
+  const Type& visit(const ast::IntegerLiteral& literal) {
+    ZC_IF_SOME(type, getNumericContext()) { return type; }
+    const int64_t value = literal.getValue();
+    const bool fitsI32 = value >= INT32_MIN && value <= INT32_MAX;
+    return Type::get(fitsI32 ? TypeKind::kI32 : TypeKind::kI64);
+  }
+
+  const Type& visit(const ast::FloatLiteral& literal) {
+    ZC_IF_SOME(type, getNumericContext()) {
+      if (type.isFloat()) { return type; }
+    }
+    return Type::get(TypeKind::kF64);
+  }
+
+  const Type& visit(const ast::StringLiteral& literal) { return Type::get(TypeKind::kStr); }
+
+  const Type& visit(const ast::TemplateLiteralExpression& literal) {
+    for (const auto& span : literal.getSpans()) { checkExpression(span.getExpression()); }
+    return Type::get(TypeKind::kStr);
+  }
+
+  const Type& visit(const ast::BooleanLiteral& literal) { return Type::get(TypeKind::kBool); }
+
+  const Type& visit(const ast::NullLiteral& literal) {
+    ZC_IF_SOME(type, expected) {
+      if (type.getKind() == TypeKind::kOptional) { return type; }
+    }
+    return Type::get(TypeKind::kNull);
+  }
+
+  const Type& visit(const ast::ArrayLiteralExpression& literal) {
+    const Type* element = nullptr;
+    ZC_IF_SOME(type, expected) {
+      if (type.getKind() == TypeKind::kArray) { element = &type.getElement(); }
+    }
+    for (const auto& item : literal.getElements()) {
+      if (ast::isa<ast::SpreadElement>(item)) {
+        checkExpression(item);
+      } else if (element == nullptr) {
+        element = &checkExpression(item);
+      } else {
+        expectAssignable(item, checkExpression(item, *element), *element);
+      }
+    }
+    if (element == nullptr) { return errorType(); }
+    return types.array(*element);
+  }
+
+  const Type& visit(const ast::ObjectLiteralExpression& literal) {
+    for (const auto& element : literal.getProperties()) {
+      const auto* property = dynamic_cast<const ast::Node*>(&element);
+      if (property == nullptr) { continue; }
+      if (ast::isa<ast::PropertyAssignment>(*property)) {
+        ZC_IF_SOME(initializer, ast::cast<ast::PropertyAssignment>(*property).getInitializer()) {
+          checkExpression(initializer);
+        }
+      } else if (ast::isa<ast::ShorthandPropertyAssignment>(*property)) {
+        checkExpression(
+            ast::cast<ast::ShorthandPropertyAssignment>(*property).getNameIdentifier());
+      } else if (ast::isa<ast::SpreadAssignment>(*property)) {
+        checkExpression(ast::cast<ast::SpreadAssignment>(*property).getExpression());
+      }
+    }
+    return errorType();
+  }
+
+  const Type& visit(const ast::SpreadElement& spread) {
+    checkExpression(spread.getExpression());
+    return errorType();
+  }
+
+  const Type& visit(const ast::ParenthesizedExpression& parenthesized) {
+    return checkExpression(parenthesized.getExpression(), expected);
+  }
+
+  const Type& visit(const ast::PrefixUnaryExpression& unary) {
+    const zc::Maybe<const Type&> context = expected;
+    const ast::Expression& operand = unary.getOperand();
+    switch (unary.getOperator()) {
+      case ast::SyntaxKind::Exclamation:
+        checkCondition(operand);
+        return Type::get(TypeKind::kBool);
+      case ast::SyntaxKind::Tilde:
+        return expectInteger(operand, checkExpression(operand, context));
+      case ast::SyntaxKind::Plus:
+      case ast::SyntaxKind::Minus:
+      case ast::SyntaxKind::PlusPlus:
+      case ast::SyntaxKind::MinusMinus:
+        return expectNumeric(operand, checkExpression(operand, context));
+      default:
+        checkExpression(operand);
+        return errorType();
+    }
+  }
+
+  const Type& visit(const ast::PostfixUnaryExpression& unary) {
+    return expectNumeric(unary.getOperand(), checkExpression(unary.getOperand()));
+  }
+
+  const Type& visit(const ast::BinaryExpression& binary) {
+    const zc::Maybe<const Type&> context = expected;
+    const ast::Expression& left = binary.getLeft();
+    const ast::Expression& right = binary.getRight();
+
+    switch (binary.getOperator().getKind()) {
+      case ast::SyntaxKind::Equals: {
+        const Type& target = checkExpression(left);
+        expectAssignable(right, checkExpression(right, target), target);
+        return target;
+      }
+      case ast::SyntaxKind::AmpersandAmpersand:
+      case ast::SyntaxKind::BarBar:
+        checkCondition(left);
+        checkCondition(right);
+        return Type::get(TypeKind::kBool);
+      case ast::SyntaxKind::QuestionQuestion: {
+        const Type& optional = checkExpression(left);
+        const Type& value =
+            optional.getKind() == TypeKind::kOptional ? optional.getElement() : optional;
+        checkExpression(right, value);
+        return value;
+      }
+      case ast::SyntaxKind::EqualsEquals:
+      case ast::SyntaxKind::ExclamationEquals:
+      case ast::SyntaxKind::EqualsEqualsEquals:
+      case ast::SyntaxKind::ExclamationEqualsEquals: {
+        auto operands = checkOperands(binary, zc::none);
+        if (!assignable(*operands.right, *operands.left) &&
+            !assignable(*operands.left, *operands.right)) {
+          reportMismatch(right, operands.left->toString(), *operands.right);
+        }
+        return Type::get(TypeKind::kBool);
+      }
+      case ast::SyntaxKind::LessThan:
+      case ast::SyntaxKind::GreaterThan:
+      case ast::SyntaxKind::LessThanEquals:
+      case ast::SyntaxKind::GreaterThanEquals:
+        checkArithmetic(binary, zc::none, /*allowStrings=*/true, /*integersOnly=*/false);
+        return Type::get(TypeKind::kBool);
+      case ast::SyntaxKind::Plus:
+        return checkArithmetic(binary, context, /*allowStrings=*/true, /*integersOnly=*/false);
+      case ast::SyntaxKind::PlusEquals:
+        return checkArithmetic(binary, zc::none, /*allowStrings=*/true, /*integersOnly=*/false);
+      case ast::SyntaxKind::Minus:
+      case ast::SyntaxKind::Asterisk:
+      case ast::SyntaxKind::AsteriskAsterisk:
+      case ast::SyntaxKind::Slash:
+      case ast::SyntaxKind::Percent:
+        return checkArithmetic(binary, context, /*allowStrings=*/false, /*integersOnly=*/false);
+      case ast::SyntaxKind::MinusEquals:
+      case ast::SyntaxKind::AsteriskEquals:
+      case ast::SyntaxKind::AsteriskAsteriskEquals:
+      case ast::SyntaxKind::SlashEquals:
+      case ast::SyntaxKind::PercentEquals:
+        return checkArithmetic(binary, zc::none, /*allowStrings=*/false, /*integersOnly=*/false);
+      case ast::SyntaxKind::Ampersand:
+      case ast::SyntaxKind::Bar:
+      case ast::SyntaxKind::Caret:
+      case ast::SyntaxKind::LessThanLessThan:
+      case ast::SyntaxKind::GreaterThanGreaterThan:
+      case ast::SyntaxKind::GreaterThanGreaterThanGreaterThan:
+        return checkArithmetic(binary, context, /*allowStrings=*/false, /*integersOnly=*/true);
+      case ast::SyntaxKind::AmpersandEquals:
+      case ast::SyntaxKind::BarEquals:
+      case ast::SyntaxKind::CaretEquals:
+      case ast::SyntaxKind::LessThanLessThanEquals:
+      case ast::SyntaxKind::GreaterThanGreaterThanEquals:
+      case ast::SyntaxKind::GreaterThanGreaterThanGreaterThanEquals:
+        return checkArithmetic(binary, zc::none, /*allowStrings=*/false, /*integersOnly=*/true);
+      default:
+        checkExpression(left);
+        checkExpression(right);
+        return errorType();
+    }
+  }
+
+  const Type& visit(const ast::ConditionalExpression& conditional) {
+    const zc::Maybe<const Type&> context = expected;
+    checkCondition(conditional.getTest());
+    const Type& consequent = checkExpression(conditional.getConsequent(), context);
+    const Type& alternate = checkExpression(conditional.getAlternate(), consequent);
+    if (assignable(alternate, consequent)) { return consequent; }
+    if (assignable(consequent, alternate)) { return alternate; }
+    reportMismatch(conditional.getAlternate(), consequent.toString(), alternate);
+    return errorType();
+  }
+
+  const Type& visit(const ast::CallExpression& call) {
+    const Type& callee = checkExpression(call.getCallee());
+    const auto& arguments = call.getArguments();
+    if (callee.getKind() != TypeKind::kFunction) {
+      for (const auto& argument : arguments) { checkExpression(argument); }
+      if (!callee.isError()) {
+        diagnosticEngine.diagnose<DiagID::NotCallable>(getLoc(call), callee.toString());
+      }
+      return errorType();
+    }
+
+    auto parameters = callee.getParameters();
+    const size_t count = arguments.size();
+    if (count < callee.getRequiredParameterCount() ||
+        (!callee.isVariadic() && count > parameters.size())) {
+      diagnosticEngine.diagnose<DiagID::ArgumentCountMismatch>(
+          getLoc(call), describeArity(callee), zc::str(count));
+    }
+
+    if (callee.getTypeParameters().size() > 0) { return checkGenericCall(call, callee); }
+
+    size_t index = 0;
+    for (const auto& argument : arguments) {
+      ZC_IF_SOME(parameter, getParameter(callee, index++)) {
+        expectAssignable(argument, checkExpression(argument, parameter), parameter);
+      } else {
+        checkExpression(argument);
+      }
+    }
+    return callee.getResult();
+  }
+
+  const Type& visit(const ast::ExpressionWithTypeArguments& expression) {
+    const Type& type = checkExpression(expression.getExpression());
+    ZC_IF_SOME(arguments, expression.getTypeArguments()) {
+      zc::Vector<const Type*> resolved(arguments.size());
+      for (const auto& argument : arguments) { resolved.add(&resolveType(argument)); }
+      if (type.getKind() == TypeKind::kFunction &&
+          type.getTypeParameters().size() == resolved.size()) {
+        return types.instantiate(type, resolved.asPtr().asConst());
+      }
+    }
+    return type;
+  }
+
+  const Type& visit(const ast::PropertyAccessExpression& access) {
+    const ast::LeftHandSideExpression& object = access.getExpression();
+    if (ast::isa<ast::Identifier>(object)) {
+      const zc::StringPtr name = ast::cast<ast::Identifier>(object).getText();
+      if (!isDeclaredBeforeImports(name)) {
+        ZC_IF_SOME(imported, scope.imports.find(name)) {
+          ZC_IF_SOME(module, imported) {
+            const zc::StringPtr member = access.getName().getText();
+            ZC_IF_SOME(type, module.values.find(member)) { return *type; }
+            if (module.types.find(member) == zc::none) {
+              diagnosticEngine.diagnose<DiagID::UndefinedIdentifier>(
+                  getLoc(access.getName()), zc::str(name, ".", member));
+            }
+          }
+          return errorType();
+        }
+      }
+    }
+    checkExpression(object);
+    return errorType();
+  }
+
+  const Type& visit(const ast::ElementAccessExpression& access) {
+    const Type& object = checkExpression(access.getExpression());
+    const Type& index = checkExpression(access.getIndex());
+    if (object.getKind() != TypeKind::kArray) { return errorType(); }
+    expectInteger(access.getIndex(), index);
+    return object.getElement();
+  }
+
+  const Type& visit(const ast::NewExpression& expression) {
+    ZC_IF_SOME(arguments, expression.getArguments()) {
+      for (const auto& argument : arguments) { checkExpression(*argument); }
+    }
+    const ast::Expression& callee = expression.getCallee();
+    if (ast::isa<ast::Identifier>(callee)) {
+      const zc::StringPtr name = ast::cast<ast::Identifier>(callee).getText();
+      ZC_IF_SOME(type, scope.module.types.find(name)) { return *type; }
+    }
+    checkExpression(callee);
+    return errorType();
+  }
+
+  const Type& visit(const ast::AsExpression& cast) {
+    checkExpression(cast.getExpression());
+    return resolveType(cast.getTargetType());
+  }
+
+  const Type& visit(const ast::ForcedAsExpression& cast) {
+    checkExpression(cast.getExpression());
+    return resolveType(cast.getTargetType());
+  }
+
+  const Type& visit(const ast::ConditionalAsExpression& cast) {
+    checkExpression(cast.getExpression());
+    return types.optional(resolveType(cast.getTargetType()));
+  }
+
+  const Type& visit(const ast::NonNullExpression& expression) {
+    const Type& type = checkExpression(expression.getExpression());
+    return type.getKind() == TypeKind::kOptional ? type.getElement() : type;
+  }
+
+  const Type& visit(const ast::AwaitExpression& expression) {
+    checkExpression(expression.getExpression());
+    return errorType();
+  }
+
+  const Type& visit(const ast::VoidExpression& expression) {
+    checkExpression(expression.getExpression());
+    return Type::get(TypeKind::kUnit);
+  }
+
+  const Type& visit(const ast::TypeOfExpression& expression) {
+    checkExpression(expression.getExpression());
+    return Type::get(TypeKind::kStr);
+  }
+
+  const Type& visit(const ast::FunctionExpression& function) {
+    const size_t typeParameterMark = typeParameters.size();
+    ZC_IF_SOME(declarations, function.getTypeParameters()) {
+      for (const auto& typeParameter : declarations) {
+        ZC_IF_SOME(name, getIdentifier(*typeParameter)) {
+          typeParameters.add(&types.typeParameter(name.getText()));
+        }
+      }
+    }
+    const Type& signature = resolver().resolveSignature(
+        function.getParameters(), function.getReturnType(),
+        typeParameters.slice(typeParameterMark, typeParameters.size()).asConst());
+    typeParameters.truncate(typeParameterMark);
+
+    checkFunction(function.getParameters(), signature, function.getBody());
+    return signature;
+  }
+
+private:
+  struct Local {
+    zc::StringPtr name;
+    const Type* type;
+  };
+
+  struct Operands {
+    const Type* left;
+    const Type* right;
+  };
+
+  const FileScope& scope;
+  TypeInterner& types;
+  zc::Maybe<const AssignabilityCache&> relations;
+  diagnostics::DiagnosticEngine& diagnosticEngine;
+
+  zc::Vector<Local> locals;
+  /// Type parameters in scope, innermost last
+  zc::Vector<const Type*> typeParameters;
+  /// What `return` is checked against; top-level code may return anything
+  const Type* returnType = &errorType();
+  /// The type the expression being dispatched is expected to have, if known
+  zc::Maybe<const Type&> expected;
+
+  TypeResolver resolver() { return TypeResolver(scope, types, typeParameters.asPtr().asConst()); }
+
+  const Type& resolveType(const ast::TypeNode& node) { return resolver().resolve(node); }
+
+  static zc::Maybe<const ast::TypeNode&> getReturnTypeNode(
+      zc::Maybe<const ast::ReturnTypeNode&> returnType) {
+    ZC_IF_SOME(node, returnType) { return node.getType(); }
+    return zc::none;
+  }
+
+  zc::Maybe<const Type&> lookup(zc::StringPtr name) const {
+    for (size_t i = locals.size(); i > 0; --i) {
+      if (locals[i - 1].name == name) { return *locals[i - 1].type; }
+    }
+    ZC_IF_SOME(type, scope.module.values.find(name)) { return *type; }
+    ZC_IF_SOME(type, scope.importedValues.find(name)) { return *type; }
+    // Modules and types used as values, e.g. for their static members, are not typed yet
+    if (scope.imports.find(name) != zc::none || scope.module.types.find(name) != zc::none) {
+      return errorType();
+    }
+    return zc::none;
+  }
+
+  /// True if `name` is a local or a module-level value, which hide import aliases of that name.
+  bool isDeclaredBeforeImports(zc::StringPtr name) const {
+    for (const Local& local : locals) {
+      if (local.name == name) { return true; }
+    }
+    return scope.module.values.find(name) != zc::none;
+  }
+
+  void declare(const ast::NamedDeclaration& declaration, const Type& type) {
+    ZC_SWITCH_ONEOF(declaration.getName()) {
+      ZC_CASE_ONEOF(maybeIdentifier, zc::Maybe<const ast::Identifier&>) {
+        ZC_IF_SOME(identifier, maybeIdentifier) { locals.add(Local{identifier.getText(), &type}); }
+      }
+      ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) {
+        ZC_IF_SOME(pattern, maybePattern) {
+          // Destructuring is not typed yet, so every name it binds has the error type
+          for (const auto& element : pattern.getElements()) {
+            ZC_IF_SOME(initializer, element.getInitializer()) { checkExpression(initializer); }
+            declare(element, errorType());
+          }
+        }
+      }
+    }
+  }
+
+  /// Declare the names a match pattern binds.
+  void declare(const ast::Pattern& pattern) {
+    switch (pattern.getKind()) {
+      case ast::SyntaxKind::IdentifierPattern: {
+        const auto& identifier = ast::cast<ast::IdentifierPattern>(pattern);
+        const Type* type = &errorType();
+        ZC_IF_SOME(annotation, identifier.getTypeAnnotation()) { type = &resolveType(annotation); }
+        locals.add(Local{identifier.getIdentifier().getText(), type});
+        return;
+      }
+      case ast::SyntaxKind::TuplePattern:
+        for (const auto& element : ast::cast<ast::TuplePattern>(pattern).getElements()) {
+          declare(element);
+        }
+        return;
+      case ast::SyntaxKind::ArrayPattern:
+        for (const auto& element : ast::cast<ast::ArrayPattern>(pattern).getElements()) {
+          declare(element);
+        }
+        return;
+      case ast::SyntaxKind::StructurePattern:
+        for (const auto& property : ast::cast<ast::StructurePattern>(pattern).getProperties()) {
+          declare(property);
+        }
+        return;
+      case ast::SyntaxKind::PatternProperty: {
+        const auto& property = ast::cast<ast::PatternProperty>(pattern);
+        ZC_IF_SOME(inner, property.getPattern()) {
+          declare(inner);
+        } else {
+          locals.add(Local{property.getName().getText(), &errorType()});
+        }
+        return;
+      }
+      case ast::SyntaxKind::EnumPattern:
+        declare(ast::cast<ast::EnumPattern>(pattern).getTuplePattern());
+        return;
+      case ast::SyntaxKind::ExpressionPattern:
+        checkExpression(ast::cast<ast::ExpressionPattern>(pattern).getExpression());
+        return;
+      default:
+        return;
+    }
+  }
+
+  /// Check a statement that gets a scope of its own even when it is not a block, e.g. the body
+  /// of `if (x) let y = 1;`.
+  void checkNested(const ast::Statement& statement) {
+    const size_t mark = locals.size();
+    checkStatement(statement);
+    locals.truncate(mark);
+  }
+
+  void checkCondition(const ast::Expression& condition) {
+    const Type& boolType = Type::get(TypeKind::kBool);
+    expectAssignable(condition, checkExpression(condition, boolType), boolType);
+  }
+
+  zc::Maybe<const Type&> getNumericContext() const {
+    ZC_IF_SOME(type, expected) {
+      const Type& value = type.getKind() == TypeKind::kOptional ? type.getElement() : type;
+      if (value.isNumeric()) { return value; }
+    }
+    return zc::none;
+  }
+
+  static bool isNumericLiteral(const ast::Expression& expression) {
+    if (ast::isa<ast::PrefixUnaryExpression>(expression)) {
+      return isNumericLiteral(ast::cast<ast::PrefixUnaryExpression>(expression).getOperand());
+    }
+    return ast::isa<ast::IntegerLiteral>(expression) || ast::isa<ast::FloatLiteral>(expression);
+  }
+
+  /// Check both operands of a binary operator. A literal operand takes the other operand's type,
+  /// so that `2 * x` and `x * 2` are both fine for an `i64` named `x`.
+  Operands checkOperands(const ast::BinaryExpression& binary, zc::Maybe<const Type&> context) {
+    const ast::Expression& left = binary.getLeft();
+    const ast::Expression& right = binary.getRight();
+    if (isNumericLiteral(left) && !isNumericLiteral(right)) {
+      const Type& rightType = checkExpression(right, context);
+      return Operands{&checkExpression(left, rightType), &rightType};
+    }
+    const Type& leftType = checkExpression(left, context);
+    return Operands{&leftType, &checkExpression(right, leftType)};
+  }
+
+  const Type& checkArithmetic(const ast::BinaryExpression& binary, zc::Maybe<const Type&> context,
+                              bool allowStrings, bool integersOnly) {
+    auto operands = checkOperands(binary, context);
+    const Type& left = *operands.left;
+    if (left.isError() || operands.right->isError()) { return errorType(); }
+
+    if (integersOnly ? !left.isInteger()
+                     : !left.isNumeric() && !(allowStrings && left.getKind() == TypeKind::kStr)) {
+      const zc::StringPtr expectedKind = integersOnly   ? "an integer type"_zc
+                                         : allowStrings ? "a numeric type or str"_zc
+                                                        : "a numeric type"_zc;
+      reportMismatch(binary.getLeft(), zc::heapString(expectedKind), left);
+      return errorType();
+    }
+    expectAssignable(binary.getRight(), *operands.right, left);
+    return left;
+  }
+
+  const Type& expectNumeric(const ast::Node& node, const Type& type) {
+    if (type.isError() || type.isNumeric()) { return type; }
+    reportMismatch(node, zc::str("a numeric type"), type);
+    return errorType();
+  }
+
+  const Type& expectInteger(const ast::Node& node, const Type& type) {
+    if (type.isError() || type.isInteger()) { return type; }
+    reportMismatch(node, zc::str("an integer type"), type);
+    return errorType();
+  }
+
+  bool assignable(const Type& source, const Type& target) const {
+    ZC_IF_SOME(cache, relations) { return isAssignable(source, target, cache); }
+    return isAssignable(source, target);
+  }
+
+  void expectAssignable(const ast::Node& node, const Type& source, const Type& target) {
+    if (!assignable(source, target)) { reportMismatch(node, target.toString(), source); }
+  }
+
+  void reportMismatch(const ast::Node& node, zc::String expectedType, const Type& actual) {
+    diagnosticEngine.diagnose<DiagID::TypeMismatch>(getLoc(node), zc::mv(expectedType),
+                                                    actual.toString());
+  }
+
+  /// The parameter an argument at `index` is passed to, if any.
+  static zc::Maybe<const Type&> getParameter(const Type& function, size_t index) {
+    auto parameters = function.getParameters();
+    if (function.isVariadic() && index + 1 >= parameters.size()) {
+      const Type& rest = *parameters.back();
+      return rest.getKind() == TypeKind::kArray ? rest.getElement() : rest;
+    }
+    if (index < parameters.size()) { return *parameters[index]; }
+    return zc::none;
+  }
+
+  /// Check a call of a generic function, inferring its type arguments from the arguments. Numeric
+  /// literals are checked last, so that in `max(x, 1)` the literal takes the type of `x`.
+  const Type& checkGenericCall(const ast::CallExpression& call, const Type& callee) {
+    auto typeParameters = callee.getTypeParameters();
+    const auto& arguments = call.getArguments();
+    auto argumentTypes = zc::heapArray<const Type*>(arguments.size());
+    auto bindings = zc::heapArray<const Type*>(typeParameters.size());
+    for (auto& binding : bindings) { binding = nullptr; }
+
+    for (bool literals : {false, true}) {
+      for (size_t i = 0; i < arguments.size(); ++i) {
+        const ast::Expression& argument = arguments[i];
+        if (isNumericLiteral(argument) != literals) { continue; }
+        zc::Maybe<const Type&> parameter = getParameter(callee, i);
+        zc::Maybe<const Type&> context;
+        ZC_IF_SOME(p, parameter) {
+          // Only a parameter whose type arguments are all inferred gives its argument a context
+          const Type& bound = types.substitute(p, typeParameters,
+                                               bindingsOrSelf(bindings, typeParameters));
+          if (!bound.isGeneric()) { context = bound; }
+        }
+        argumentTypes[i] = &checkExpression(argument, context);
+        ZC_IF_SOME(p, parameter) { infer(p, *argumentTypes[i], typeParameters, bindings); }
+      }
+    }
+
+    // Whatever could not be inferred accepts anything
+    for (auto& binding : bindings) {
+      if (binding == nullptr) { binding = &errorType(); }
+    }
+    const Type& instance = types.instantiate(callee, bindings.asPtr().asConst());
+    for (size_t i = 0; i < arguments.size(); ++i) {
+      ZC_IF_SOME(parameter, getParameter(instance, i)) {
+        expectAssignable(arguments[i], *argumentTypes[i], parameter);
+      }
+    }
+    return instance.getResult();
+  }
+
+  /// The type arguments inferred so far, with the type parameters that are not inferred yet.
+  static zc::Array<const Type*> bindingsOrSelf(zc::ArrayPtr<const Type* const> bindings,
+                                               zc::ArrayPtr<const Type* const> typeParameters) {
+    auto result = zc::heapArray<const Type*>(bindings.size());
+    for (size_t i = 0; i < bindings.size(); ++i) {
+      result[i] = bindings[i] != nullptr ? bindings[i] : typeParameters[i];
+    }
+    return result;
+  }
+
+  /// Bind the type parameters that `parameter` mentions by matching it against `argument`. The
+  /// first binding of a type parameter wins; later arguments are checked against it.
+  static void infer(const Type& parameter, const Type& argument,
+                    zc::ArrayPtr<const Type* const> typeParameters,
+                    zc::ArrayPtr<const Type*> bindings) {
+    if (!parameter.isGeneric() || argument.isError()) { return; }
+    switch (parameter.getKind()) {
+      case TypeKind::kTypeParameter:
+        for (size_t i = 0; i < typeParameters.size(); ++i) {
+          if (typeParameters[i] == &parameter && bindings[i] == nullptr) {
+            bindings[i] = &argument;
+          }
+        }
+        return;
+      case TypeKind::kArray:
+        if (argument.getKind() == TypeKind::kArray) {
+          infer(parameter.getElement(), argument.getElement(), typeParameters, bindings);
+        }
+        return;
+      case TypeKind::kOptional:
+        if (argument.getKind() == TypeKind::kNull) { return; }
+        infer(parameter.getElement(),
+              argument.getKind() == TypeKind::kOptional ? argument.getElement() : argument,
+              typeParameters, bindings);
+        return;
+      case TypeKind::kFunction: {
+        if (argument.getKind() != TypeKind::kFunction) { return; }
+        auto parameters = parameter.getParameters();
+        auto arguments = argument.getParameters();
+        for (size_t i = 0; i < parameters.size() && i < arguments.size(); ++i) {
+          infer(*parameters[i], *arguments[i], typeParameters, bindings);
+        }
+        infer(parameter.getResult(), argument.getResult(), typeParameters, bindings);
+        return;
+      }
+      case TypeKind::kNamed: {
+        if (argument.getKind() != TypeKind::kNamed || argument.getName() != parameter.getName()) {
+          return;
+        }
+        auto parameters = parameter.getTypeArguments();
+        auto arguments = argument.getTypeArguments();
+        for (size_t i = 0; i < parameters.size() && i < arguments.size(); ++i) {
+          infer(*parameters[i], *arguments[i], typeParameters, bindings);
+        }
+        return;
+      }
+      default:
+        // Unions would need to pick a member to match against
+        return;
+    }
+  }
+
+  static zc::String describeArity(const Type& function) {
+    const size_t required = function.getRequiredParameterCount();
+    if (function.isVariadic()) { return zc::str("at least ", required); }
+    if (required == function.getParameters().size()) { return zc::str(required); }
+    return zc::str(required, " to ", function.getParameters().size());
+  }
+};
+
+/// A function body checked in the second phase, with what it was resolved against in the first.
+struct BodyTask {
+  const ast::FunctionDeclaration& function;
+  const FileScope& scope;
+  const Type& signature;
+};
+
+}  // namespace
+
+struct TypeChecker::Impl {
+  diagnostics::DiagnosticEngine& diagnosticEngine;
+  basic::ThreadPool& threadPool;
+
+  /// Signatures and the other types of module-level declarations, written only in the first
+  /// phase
+  zc::Own<TypeInterner> globalTypes;
+  zc::Vector<zc::Own<ModuleScope>> modules;
+  zc::HashMap<zc::StringPtr, ModuleScope*> modulesByName;
+  zc::Vector<zc::Own<FileScope>> files;
+  zc::Vector<BodyTask> bodies;
+
+  Impl(diagnostics::DiagnosticEngine& diagnosticEngine, basic::ThreadPool& threadPool)
+      : diagnosticEngine(diagnosticEngine), threadPool(threadPool) {}
+
+  ModuleScope& getModule(zc::String name) {
+    ZC_IF_SOME(module, modulesByName.find(name)) { return *module; }
+    auto& module = *modules.add(zc::heap<ModuleScope>(zc::mv(name)));
+    modulesByName.insert(module.name, &module);
+    return module;
+  }
+
+  void addFile(const ast::SourceFile& file) {
+    zc::String moduleName = zc::heapString(file.getFileName());
+    ZC_IF_SOME(declaration, file.getModuleDeclaration()) {
+      moduleName = getModuleName(declaration.getModulePath());
+    }
+    files.add(zc::heap<FileScope>(file, getModule(zc::mv(moduleName))));
+  }
+
+  void declareImports(FileScope& scope) {
+    for (const auto& statement : scope.file.getStatements()) {
+      if (!ast::isa<ast::ImportDeclaration>(statement)) { continue; }
+      const auto& import = ast::cast<ast::ImportDeclaration>(statement);
+      const zc::String moduleName = getModuleName(import.getModulePath());
+      zc::Maybe<const ModuleScope&> module;
+      ZC_IF_SOME(found, modulesByName.find(moduleName)) { module = *found; }
+
+      for (const auto& specifier : import.getSpecifiers()) {
+        const zc::StringPtr importedName = specifier.getImportedName().getText();
+        zc::StringPtr localName = importedName;
+        ZC_IF_SOME(alias, specifier.getAlias()) { localName = alias.getText(); }
+        const Type* type = &errorType();
+        ZC_IF_SOME(m, module) {
+          ZC_IF_SOME(found, m.values.find(importedName)) { type = found; }
+        }
+        scope.importedValues.upsert(localName, type);
+      }
+
+      // Without an alias, the module is known by the last segment of its path
+      zc::StringPtr alias;
+      ZC_IF_SOME(identifier, import.getAlias()) {
+        alias = identifier.getText();
+      } else {
+        const auto& segments = import.getModulePath().getSegments();
+        if (segments.size() == 0) { continue; }
+        alias = segments[segments.size() - 1].getText();
+      }
+      scope.imports.upsert(alias, module);
+    }
+  }
+
+  void declareTypes(FileScope& scope) {
+    for (const auto& statement : scope.file.getStatements()) {
+      switch (statement.getKind()) {
+        case ast::SyntaxKind::ClassDeclaration:
+        case ast::SyntaxKind::InterfaceDeclaration:
+        case ast::SyntaxKind::StructDeclaration:
+        case ast::SyntaxKind::EnumDeclaration:
+        case ast::SyntaxKind::ErrorDeclaration: {
+          const auto& declaration = static_cast<const ast::DeclarationStatement&>(statement);
+          ZC_IF_SOME(name, getIdentifier(declaration)) {
+            // Redeclarations are the binder's to report; the first one wins
+            scope.module.types.upsert(name.getText(), &globalTypes->named(name.getText()),
+                                      [](const Type*&, const Type*&&) {});
+          }
+          break;
+        }
+        case ast::SyntaxKind::AliasDeclaration: {
+          ZC_IF_SOME(name, getIdentifier(ast::cast<ast::AliasDeclaration>(statement))) {
+            scope.module.types.upsert(name.getText(), &errorType(),
+                                      [](const Type*&, const Type*&&) {});
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+
+  void declareValues(FileScope& scope) {
+    for (const auto& statement : scope.file.getStatements()) {
+      switch (statement.getKind()) {
+        case ast::SyntaxKind::AliasDeclaration: {
+          const auto& alias = ast::cast<ast::AliasDeclaration>(statement);
+          // Generic aliases would need substitution at every use
+          if (alias.getTypeParameters().size() > 0) { break; }
+          ZC_IF_SOME(name, getIdentifier(alias)) {
+            const Type& type = TypeResolver(scope, *globalTypes, nullptr).resolve(alias.getType());
+            scope.module.types.upsert(name.getText(), &type);
+          }
+          break;
+        }
+        case ast::SyntaxKind::FunctionDeclaration:
+          declareFunction(scope, ast::cast<ast::FunctionDeclaration>(statement));
+          break;
+        case ast::SyntaxKind::VariableStatement: {
+          const auto& variables = ast::cast<ast::VariableStatement>(statement);
+          for (const auto& declaration : variables.getDeclarations().getBindings()) {
+            ZC_IF_SOME(name, getIdentifier(declaration)) {
+              // Unannotated variables are typed once their initializers are checked
+              const Type& type =
+                  TypeResolver(scope, *globalTypes, nullptr).resolve(declaration.getType());
+              scope.module.values.upsert(name.getText(), &type,
+                                         [](const Type*&, const Type*&&) {});
+            }
+          }
+          break;
+        }
+        default:
+          break;
+      }
+    }
+  }
+
+  void declareFunction(FileScope& scope, const ast::FunctionDeclaration& function) {
+    zc::Vector<const Type*> typeParameters(function.getTypeParameters().size());
+    for (const auto& typeParameter : function.getTypeParameters()) {
+      ZC_IF_SOME(name, getIdentifier(typeParameter)) {
+        typeParameters.add(&globalTypes->typeParameter(name.getText()));
+      }
+    }
+    zc::Maybe<const ast::TypeNode&> returnType;
+    ZC_IF_SOME(node, function.getReturnType()) { returnType = node.getType(); }
+    const Type& signature = TypeResolver(scope, *globalTypes, typeParameters.asPtr().asConst())
+                                .resolveSignature(function.getParameters(), returnType,
+                                                  typeParameters.asPtr().asConst());
+
+    ZC_IF_SOME(name, getIdentifier(function)) {
+      scope.module.values.upsert(name.getText(), &signature, [](const Type*&, const Type*&&) {});
+    }
+    bodies.add(BodyTask{function, scope, signature});
+  }
+
+  /// Check the top level of a file: global initializers, typing the unannotated variables as it
+  /// goes, and any statements outside of declarations.
+  void checkTopLevel(FileScope& scope) {
+    // The global types are still being made, so there is nothing to cache relations between yet
+    BodyChecker checker(scope, *globalTypes, zc::none, diagnosticEngine);
+    for (const auto& statement : scope.file.getStatements()) {
+      switch (statement.getKind()) {
+        case ast::SyntaxKind::VariableStatement: {
+          const auto& variables = ast::cast<ast::VariableStatement>(statement);
+          for (const auto& declaration : variables.getDeclarations().getBindings()) {
+            const Type& type = checker.checkVariable(declaration);
+            if (declaration.getType() != zc::none) { continue; }
+            ZC_IF_SOME(name, getIdentifier(declaration)) {
+              scope.module.values.upsert(name.getText(), &type);
+            }
+          }
+          break;
+        }
+        case ast::SyntaxKind::FunctionDeclaration:
+          // Checked in parallel in the second phase
+          break;
+        default:
+          checker.checkStatement(statement);
+          break;
+      }
+    }
+  }
+
+  void checkBodies() {
+    diagnosticEngine.beginBuffering();
+    // Shared by every task, for the relations between the signatures' types
+    const AssignabilityCache relations(*globalTypes);
+    basic::TaskGroup group(threadPool);
+    for (const BodyTask& body : bodies) {
+      group.fork([this, &body, &relations]() {
+        // Reads the global interner, which no task writes to, before interning anything new
+        TypeInterner types{zc::Maybe<const TypeInterner&>(*globalTypes)};
+        BodyChecker checker(body.scope, types, relations, diagnosticEngine);
+        checker.checkFunction(body.function.getParameters(), body.signature,
+                              body.function.getBody());
+      });
+    }
+
+    auto maybeException = zc::runCatchingExceptions([&]() { group.join(); });
+    diagnosticEngine.flushBuffered();
+    ZC_IF_SOME(exception, maybeException) { zc::throwFatalException(zc::mv(exception)); }
+  }
+};
+
+TypeChecker::TypeChecker(diagnostics::DiagnosticEngine& diagnosticEngine,
+                         basic::ThreadPool& threadPool) noexcept
+    : impl(zc::heap<Impl>(diagnosticEngine, threadPool)) {}
+
+TypeChecker::~TypeChecker() noexcept(false) = default;
+
+bool TypeChecker::check(zc::ArrayPtr<const ast::SourceFile* const> files) {
+  impl->bodies.clear();
+  impl->files.clear();
+  impl->modulesByName.clear();
+  impl->modules.clear();
+  impl->globalTypes = zc::heap<TypeInterner>();
+
+  // First phase: module-level signatures, on this thread
+  for (const ast::SourceFile* file : files) { impl->addFile(*file); }
+  for (auto& scope : impl->files) { impl->declareTypes(*scope); }
+  for (auto& scope : impl->files) { impl->declareValues(*scope); }
+  for (auto& scope : impl->files) { impl->declareImports(*scope); }
+  for (auto& scope : impl->files) { impl->checkTopLevel(*scope); }
+
+  // Second phase: function bodies, in parallel, against the now read-only signatures
+  impl->checkBodies();
+  return !impl->diagnosticEngine.hasErrors();
+}
+
+zc::Maybe<const Type&> TypeChecker::getGlobalType(zc::StringPtr moduleName,
+                                                  zc::StringPtr name) const {
+  ZC_IF_SOME(module, impl->modulesByName.find(moduleName)) {
+    ZC_IF_SOME(type, module->values.find(name)) { return *type; }
+  }
+  return zc::none;
+}
+
+size_t TypeChecker::getCheckedBodyCount() const { return impl->bodies.size(); }
+
+}  // namespace checker
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,26 +14,55 @@
 
 #pragma once
 
-#include "zomlang/compiler/ast/ast.h"
-#include "zomlang/compiler/symbol/symbol-table.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+#include "zomlang/compiler/checker/types.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 
 namespace zomlang {
 namespace compiler {
 namespace checker {
 
-// class TypeChecker : public CompilerStage<zc::Own<ast::AST>,
-// zc::String> {
-//  protected:
-//   void process(const zc::Own<ast::AST>& input,
-//                zc::Vector<zc::String>& outputs) override;
-//
-//  private:
-//   SymbolTable symbol_table_;
-//
-//  public:
-//   TypeChecker() = default;
-//   ~TypeChecker() noexcept override = default;
-// };
+/// \brief Checks the types of a program's source files.
+///
+/// Checking runs in two phases. The module-level signatures, i.e. the types of functions, global
+/// variables and the classes, interfaces and other types the files declare, are resolved first on
+/// the calling thread, and global initializers checked against them. After that they are only
+/// read: each function body is checked as a task of its own on the thread pool, with local scopes
+/// and a type interner of its own on top of the frozen global one, so that bodies are checked in
+/// parallel. The only state they share is a cache of which global types are assignable to which, a
+/// lookup in which takes one shard's lock.
+///
+/// A file sees the declarations of every file declaring the same module, and the modules it
+/// imports under their alias, e.g. `m.f()` after `import a.b as m;`. Whatever the checker cannot
+/// type yet, such as members of classes, has the error type and is accepted anywhere.
+class TypeChecker {
+public:
+  TypeChecker(diagnostics::DiagnosticEngine& diagnosticEngine,
+              basic::ThreadPool& threadPool) noexcept;
+  ~TypeChecker() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(TypeChecker);
+
+  /// \brief Check the given files as one program. The diagnostics of the function bodies are
+  /// buffered while they are checked, and reported in source order once all are done.
+  /// \return True if no errors were reported
+  bool check(zc::ArrayPtr<const ast::SourceFile* const> files);
+
+  /// \brief The type of a module-level function or variable after `check()`.
+  /// \param moduleName The module as declared, e.g. `a.b`, or the file name of a file that
+  /// declares no module
+  zc::Maybe<const Type&> getGlobalType(zc::StringPtr moduleName, zc::StringPtr name) const;
+
+  /// \brief Function bodies checked by the last `check()`.
+  size_t getCheckedBodyCount() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
 
 }  // namespace checker
 }  // namespace compiler
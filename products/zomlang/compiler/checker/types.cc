@@ -0,0 +1,572 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/checker/types.h"
+
+#include <algorithm>
+
+#include "zc/core/arena.h"
+#include "zc/core/debug.h"
+#include "zc/core/hash.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace checker {
+
+namespace {
+
+constexpr Type kPrimitives[] = {
+    Type(TypeKind::kError), Type(TypeKind::kUnit), Type(TypeKind::kBool), Type(TypeKind::kStr),
+    Type(TypeKind::kNull),  Type(TypeKind::kI8),   Type(TypeKind::kI16),  Type(TypeKind::kI32),
+    Type(TypeKind::kI64),   Type(TypeKind::kU8),   Type(TypeKind::kU16),  Type(TypeKind::kU32),
+    Type(TypeKind::kU64),   Type(TypeKind::kF32),  Type(TypeKind::kF64),
+};
+
+zc::StringPtr getPrimitiveName(TypeKind kind) {
+  switch (kind) {
+    case TypeKind::kError:
+      return "<error>"_zc;
+    case TypeKind::kUnit:
+      return "unit"_zc;
+    case TypeKind::kBool:
+      return "bool"_zc;
+    case TypeKind::kStr:
+      return "str"_zc;
+    case TypeKind::kNull:
+      return "null"_zc;
+    case TypeKind::kI8:
+      return "i8"_zc;
+    case TypeKind::kI16:
+      return "i16"_zc;
+    case TypeKind::kI32:
+      return "i32"_zc;
+    case TypeKind::kI64:
+      return "i64"_zc;
+    case TypeKind::kU8:
+      return "u8"_zc;
+    case TypeKind::kU16:
+      return "u16"_zc;
+    case TypeKind::kU32:
+      return "u32"_zc;
+    case TypeKind::kU64:
+      return "u64"_zc;
+    case TypeKind::kF32:
+      return "f32"_zc;
+    case TypeKind::kF64:
+      return "f64"_zc;
+    default:
+      ZC_UNREACHABLE;
+  }
+}
+
+/// Spell a type that is an operand of `[]`, `?` or `|`, parenthesized if it would bind looser.
+zc::String spellOperand(const Type& type) {
+  if (type.getKind() == TypeKind::kFunction || type.getKind() == TypeKind::kUnion) {
+    return zc::str("(", type, ")");
+  }
+  return type.toString();
+}
+
+zc::String spellAll(zc::ArrayPtr<const Type* const> types, zc::StringPtr separator) {
+  zc::Vector<zc::String> spelled(types.size());
+  for (const Type* type : types) { spelled.add(spellOperand(*type)); }
+  return zc::strArray(spelled, separator.cStr());
+}
+
+}  // namespace
+
+Type::Type(uint32_t id, TypeKind kind, const Type* element,
+           zc::ArrayPtr<const Type* const> members,
+           zc::ArrayPtr<const Type* const> typeParameters, zc::StringPtr name,
+           size_t requiredParameters, bool variadic)
+    : kind(kind),
+      variadic(variadic),
+      generic(kind == TypeKind::kTypeParameter),
+      id(id),
+      requiredParameters(static_cast<uint32_t>(requiredParameters)),
+      element(element),
+      members(members),
+      typeParameters(typeParameters),
+      name(name) {
+  if (element != nullptr && element->generic) { generic = true; }
+  for (const Type* member : members) {
+    if (member->generic) { generic = true; }
+  }
+}
+
+const Type& Type::get(TypeKind kind) {
+  ZC_REQUIRE(kind <= TypeKind::kF64, "not a primitive type kind");
+  return kPrimitives[static_cast<size_t>(kind)];
+}
+
+const Type& Type::getElement() const {
+  ZC_REQUIRE(kind == TypeKind::kArray || kind == TypeKind::kOptional, "type has no element");
+  return *element;
+}
+
+zc::ArrayPtr<const Type* const> Type::getParameters() const {
+  ZC_REQUIRE(kind == TypeKind::kFunction, "not a function type");
+  return members;
+}
+
+const Type& Type::getResult() const {
+  ZC_REQUIRE(kind == TypeKind::kFunction, "not a function type");
+  return *element;
+}
+
+zc::ArrayPtr<const Type* const> Type::getMembers() const {
+  ZC_REQUIRE(kind == TypeKind::kUnion, "not a union type");
+  return members;
+}
+
+zc::ArrayPtr<const Type* const> Type::getTypeArguments() const {
+  ZC_REQUIRE(kind == TypeKind::kNamed, "not a named type");
+  return members;
+}
+
+zc::StringPtr Type::getName() const {
+  ZC_REQUIRE(kind == TypeKind::kNamed || kind == TypeKind::kTypeParameter, "type has no name");
+  return name;
+}
+
+zc::String Type::toString() const {
+  switch (kind) {
+    case TypeKind::kArray:
+    case TypeKind::kOptional: {
+      const zc::StringPtr suffix = kind == TypeKind::kArray ? "[]"_zc : "?"_zc;
+      return zc::str(spellOperand(*element), suffix);
+    }
+    case TypeKind::kFunction: {
+      zc::Vector<zc::String> spelled(members.size());
+      for (size_t i = 0; i < members.size(); ++i) {
+        const bool rest = variadic && i + 1 == members.size();
+        spelled.add(zc::str(rest ? "..." : "", *members[i]));
+      }
+      zc::String prefix;
+      if (typeParameters.size() > 0) { prefix = zc::str("<", spellAll(typeParameters, ", "), ">"); }
+      return zc::str(prefix, "(", zc::strArray(spelled, ", "), ") -> ", *element);
+    }
+    case TypeKind::kUnion:
+      return spellAll(members, " | ");
+    case TypeKind::kNamed:
+      if (members.size() > 0) { return zc::str(name, "<", spellAll(members, ", "), ">"); }
+      return zc::heapString(name);
+    case TypeKind::kTypeParameter:
+      return zc::heapString(name);
+    default:
+      return zc::heapString(getPrimitiveName(kind));
+  }
+}
+
+zc::String ZC_STRINGIFY(const Type& type) { return type.toString(); }
+
+namespace {
+
+/// Decides assignability one pair at a time, remembering the pairs being decided so that a type
+/// that refers to itself is assumed assignable where it recurs instead of being followed forever.
+class Relation {
+public:
+  explicit Relation(zc::Maybe<const AssignabilityCache&> cache) : cache(cache) {}
+
+  bool isAssignable(const Type& source, const Type& target) {
+    if (source.isError() || target.isError()) { return true; }
+    if (&source == &target) { return true; }
+    // Distinct primitive types are never assignable to each other
+    if (target.getKind() <= TypeKind::kF64 && source.getKind() <= TypeKind::kF64) { return false; }
+
+    zc::Maybe<const AssignabilityCache&> shared;
+    ZC_IF_SOME(c, cache) {
+      if (c.covers(source, target)) {
+        ZC_IF_SOME(result, c.find(source, target)) { return result; }
+        shared = c;
+      }
+    }
+
+    for (size_t i = 0; i < inProgress.size(); ++i) {
+      if (inProgress[i].source == &source && inProgress[i].target == &target) {
+        lowestAssumption = zc::min(lowestAssumption, i);
+        return true;
+      }
+    }
+
+    const size_t depth = inProgress.size();
+    const size_t enclosingAssumption = lowestAssumption;
+    inProgress.add(Pair{&source, &target});
+    lowestAssumption = SIZE_MAX;
+    const bool result = decide(source, target);
+    inProgress.removeLast();
+
+    // A success that assumed an enclosing pair holds only if that pair does, so only the
+    // outermost of them is recorded. A failure holds regardless.
+    const bool assumedEnclosing = lowestAssumption < depth;
+    ZC_IF_SOME(c, shared) {
+      if (!assumedEnclosing || !result) { c.insert(source, target, result); }
+    }
+    lowestAssumption = assumedEnclosing ? zc::min(enclosingAssumption, lowestAssumption)
+                                        : enclosingAssumption;
+    return result;
+  }
+
+private:
+  struct Pair {
+    const Type* source;
+    const Type* target;
+  };
+
+  zc::Maybe<const AssignabilityCache&> cache;
+  zc::Vector<Pair> inProgress;
+  /// The outermost pair in progress that a recursion was assumed to hold for
+  size_t lowestAssumption = SIZE_MAX;
+
+  bool decide(const Type& source, const Type& target) {
+    if (source.getKind() == TypeKind::kUnion) {
+      for (const Type* member : source.getMembers()) {
+        if (!isAssignable(*member, target)) { return false; }
+      }
+      return true;
+    }
+
+    switch (target.getKind()) {
+      case TypeKind::kOptional:
+        if (source.getKind() == TypeKind::kNull) { return true; }
+        if (source.getKind() == TypeKind::kOptional) {
+          return isAssignable(source.getElement(), target.getElement());
+        }
+        return isAssignable(source, target.getElement());
+      case TypeKind::kUnion:
+        for (const Type* member : target.getMembers()) {
+          if (isAssignable(source, *member)) { return true; }
+        }
+        return false;
+      case TypeKind::kArray:
+        return source.getKind() == TypeKind::kArray &&
+               isAssignable(source.getElement(), target.getElement());
+      case TypeKind::kFunction: {
+        if (source.getKind() != TypeKind::kFunction) { return false; }
+        auto sourceParameters = source.getParameters();
+        auto targetParameters = target.getParameters();
+        if (sourceParameters.size() != targetParameters.size()) { return false; }
+        for (size_t i = 0; i < sourceParameters.size(); ++i) {
+          if (!isAssignable(*targetParameters[i], *sourceParameters[i])) { return false; }
+        }
+        return isAssignable(source.getResult(), target.getResult());
+      }
+      default:
+        // Interned, so anything else is only assignable to itself
+        return false;
+    }
+  }
+};
+
+}  // namespace
+
+bool isAssignable(const Type& source, const Type& target) {
+  return Relation(zc::none).isAssignable(source, target);
+}
+
+bool isAssignable(const Type& source, const Type& target, const AssignabilityCache& cache) {
+  return Relation(cache).isAssignable(source, target);
+}
+
+namespace {
+
+/// Everything that makes one interned type distinct from another. Its components are interned
+/// already, so they are compared by identity.
+struct Shape {
+  TypeKind kind;
+  bool variadic = false;
+  uint32_t requiredParameters = 0;
+  const Type* element = nullptr;
+  zc::ArrayPtr<const Type* const> members;
+  zc::ArrayPtr<const Type* const> typeParameters;
+  zc::StringPtr name;
+
+  bool operator==(const Shape& other) const {
+    return kind == other.kind && variadic == other.variadic &&
+           requiredParameters == other.requiredParameters && element == other.element &&
+           members == other.members && typeParameters == other.typeParameters &&
+           name == other.name;
+  }
+
+  zc::uint hashCode() const {
+    return zc::hashCode(kind, variadic, requiredParameters, element, members, typeParameters,
+                        name);
+  }
+};
+
+/// A generic function type with the type arguments it was instantiated with.
+struct Instantiation {
+  const Type* generic;
+  zc::ArrayPtr<const Type* const> arguments;
+
+  bool operator==(const Instantiation& other) const {
+    return generic == other.generic && arguments == other.arguments;
+  }
+
+  zc::uint hashCode() const { return zc::hashCode(generic, arguments); }
+};
+
+/// The first id after the primitive types'.
+constexpr uint32_t kFirstId = static_cast<uint32_t>(TypeKind::kF64) + 1;
+
+}  // namespace
+
+struct TypeInterner::Impl {
+  zc::Maybe<const TypeInterner&> parent;
+  zc::Arena arena;
+  uint32_t firstId;
+  uint32_t nextId;
+  zc::HashMap<Shape, const Type*> types;
+  zc::HashMap<Instantiation, const Type*> instantiations;
+
+  explicit Impl(zc::Maybe<const TypeInterner&> parent) : parent(parent), arena(4096) {
+    firstId = kFirstId;
+    ZC_IF_SOME(p, parent) { firstId = p.impl->nextId; }
+    nextId = firstId;
+  }
+
+  zc::Maybe<const Type&> find(const Shape& shape) const {
+    ZC_IF_SOME(p, parent) {
+      ZC_IF_SOME(type, p.impl->find(shape)) { return type; }
+    }
+    ZC_IF_SOME(type, types.find(shape)) { return *type; }
+    return zc::none;
+  }
+
+  zc::Maybe<const Type&> find(const Instantiation& instantiation) const {
+    ZC_IF_SOME(p, parent) {
+      ZC_IF_SOME(type, p.impl->find(instantiation)) { return type; }
+    }
+    ZC_IF_SOME(type, instantiations.find(instantiation)) { return *type; }
+    return zc::none;
+  }
+
+  zc::ArrayPtr<const Type* const> copy(zc::ArrayPtr<const Type* const> types) {
+    if (types.size() == 0) { return nullptr; }
+    zc::ArrayPtr<const Type*> copy = arena.allocateArray<const Type*>(types.size());
+    for (size_t i = 0; i < types.size(); ++i) { copy[i] = types[i]; }
+    return copy.asConst();
+  }
+
+  const Type& make(const Shape& shape) {
+    return arena.allocate<Type>(nextId++, shape.kind, shape.element, shape.members,
+                                shape.typeParameters, shape.name, shape.requiredParameters,
+                                shape.variadic);
+  }
+
+  const Type& intern(const Shape& shape) {
+    ZC_IF_SOME(type, find(shape)) { return type; }
+    Shape owned = shape;
+    owned.members = copy(shape.members);
+    owned.typeParameters = copy(shape.typeParameters);
+    const Type& type = make(owned);
+    types.insert(owned, &type);
+    return type;
+  }
+};
+
+TypeInterner::TypeInterner(zc::Maybe<const TypeInterner&> parent) noexcept
+    : impl(zc::heap<Impl>(parent)) {}
+
+TypeInterner::~TypeInterner() noexcept(false) = default;
+
+const Type& TypeInterner::array(const Type& element) {
+  return impl->intern(Shape{.kind = TypeKind::kArray, .element = &element});
+}
+
+const Type& TypeInterner::optional(const Type& element) {
+  switch (element.getKind()) {
+    case TypeKind::kError:
+    case TypeKind::kNull:
+    case TypeKind::kOptional:
+      return element;
+    default:
+      return impl->intern(Shape{.kind = TypeKind::kOptional, .element = &element});
+  }
+}
+
+const Type& TypeInterner::unionOf(zc::ArrayPtr<const Type* const> types) {
+  zc::Vector<const Type*> members(types.size());
+  bool optional = false;
+  for (const Type* type : types) {
+    switch (type->getKind()) {
+      case TypeKind::kError:
+        return *type;
+      case TypeKind::kNull:
+        optional = true;
+        continue;
+      case TypeKind::kOptional:
+        optional = true;
+        type = &type->getElement();
+        break;
+      default:
+        break;
+    }
+    if (type->getKind() == TypeKind::kUnion) {
+      members.addAll(type->getMembers());
+    } else {
+      members.add(type);
+    }
+  }
+
+  // Canonical order, so that `i32 | str` and `str | i32` are one type
+  std::sort(members.begin(), members.end(),
+            [](const Type* a, const Type* b) { return a->getId() < b->getId(); });
+  const Type** end = std::unique(members.begin(), members.end());
+  members.truncate(end - members.begin());
+
+  const Type* result;
+  if (members.size() == 0) {
+    return Type::get(optional ? TypeKind::kNull : TypeKind::kError);
+  } else if (members.size() == 1) {
+    result = members[0];
+  } else {
+    result = &impl->intern(Shape{.kind = TypeKind::kUnion, .members = members.asPtr().asConst()});
+  }
+  return optional ? this->optional(*result) : *result;
+}
+
+const Type& TypeInterner::function(zc::ArrayPtr<const Type* const> parameters,
+                                   size_t requiredParameters, bool variadic,
+                                   const Type& result,
+                                   zc::ArrayPtr<const Type* const> typeParameters) {
+  return impl->intern(Shape{.kind = TypeKind::kFunction,
+                            .variadic = variadic,
+                            .requiredParameters = static_cast<uint32_t>(requiredParameters),
+                            .element = &result,
+                            .members = parameters,
+                            .typeParameters = typeParameters});
+}
+
+const Type& TypeInterner::named(zc::StringPtr name,
+                                zc::ArrayPtr<const Type* const> typeArguments) {
+  return impl->intern(Shape{.kind = TypeKind::kNamed, .members = typeArguments, .name = name});
+}
+
+const Type& TypeInterner::typeParameter(zc::StringPtr name) {
+  // Never looked up: every declaration of a type parameter is a type of its own
+  return impl->make(Shape{.kind = TypeKind::kTypeParameter, .name = name});
+}
+
+const Type& TypeInterner::instantiate(const Type& generic,
+                                      zc::ArrayPtr<const Type* const> typeArguments) {
+  ZC_REQUIRE(generic.getKind() == TypeKind::kFunction, "only functions are instantiated");
+  auto typeParameters = generic.getTypeParameters();
+  ZC_REQUIRE(typeArguments.size() == typeParameters.size(), "wrong number of type arguments");
+  if (typeParameters.size() == 0) { return generic; }
+
+  const Instantiation key{&generic, typeArguments};
+  ZC_IF_SOME(type, impl->find(key)) { return type; }
+
+  zc::Vector<const Type*> parameters(generic.getParameters().size());
+  for (const Type* parameter : generic.getParameters()) {
+    parameters.add(&substitute(*parameter, typeParameters, typeArguments));
+  }
+  const Type& result = substitute(generic.getResult(), typeParameters, typeArguments);
+  const Type& instance = function(parameters.asPtr().asConst(), generic.getRequiredParameterCount(),
+                                  generic.isVariadic(), result);
+  impl->instantiations.insert(Instantiation{&generic, impl->copy(typeArguments)}, &instance);
+  return instance;
+}
+
+const Type& TypeInterner::substitute(const Type& type, zc::ArrayPtr<const Type* const> parameters,
+                                     zc::ArrayPtr<const Type* const> arguments) {
+  if (!type.isGeneric()) { return type; }
+
+  auto substituteAll = [&](zc::ArrayPtr<const Type* const> types) {
+    zc::Vector<const Type*> result(types.size());
+    for (const Type* member : types) { result.add(&substitute(*member, parameters, arguments)); }
+    return result;
+  };
+
+  switch (type.getKind()) {
+    case TypeKind::kTypeParameter:
+      for (size_t i = 0; i < parameters.size(); ++i) {
+        if (parameters[i] == &type) { return *arguments[i]; }
+      }
+      return type;
+    case TypeKind::kArray:
+      return array(substitute(type.getElement(), parameters, arguments));
+    case TypeKind::kOptional:
+      return optional(substitute(type.getElement(), parameters, arguments));
+    case TypeKind::kUnion:
+      return unionOf(substituteAll(type.getMembers()).asPtr().asConst());
+    case TypeKind::kFunction:
+      return function(substituteAll(type.getParameters()).asPtr().asConst(),
+                      type.getRequiredParameterCount(), type.isVariadic(),
+                      substitute(type.getResult(), parameters, arguments),
+                      type.getTypeParameters());
+    case TypeKind::kNamed:
+      return named(type.getName(), substituteAll(type.getTypeArguments()).asPtr().asConst());
+    default:
+      return type;
+  }
+}
+
+size_t TypeInterner::size() const { return impl->nextId - impl->firstId; }
+
+uint32_t TypeInterner::getNextId() const { return impl->nextId; }
+
+struct AssignabilityCache::Impl {
+  static constexpr uint32_t kShardBits = 4;
+  static constexpr uint32_t kShardCount = 1u << kShardBits;
+
+  /// Padded to a cache line so that threads locking neighbouring shards do not contend.
+  struct alignas(64) Shard {
+    zc::MutexGuarded<zc::HashMap<uint64_t, bool>> relations;
+  };
+
+  Shard shards[kShardCount];
+
+  static uint64_t getKey(const Type& source, const Type& target) {
+    return static_cast<uint64_t>(source.getId()) << 32 | target.getId();
+  }
+
+  const Shard& getShard(uint64_t key) const {
+    // The high bits, since the table buckets use the low ones
+    return shards[zc::hashCode(key) >> (32 - kShardBits)];
+  }
+};
+
+AssignabilityCache::AssignabilityCache(const TypeInterner& types) noexcept
+    : idLimit(types.getNextId()), impl(zc::heap<Impl>()) {}
+
+AssignabilityCache::~AssignabilityCache() noexcept(false) = default;
+
+zc::Maybe<bool> AssignabilityCache::find(const Type& source, const Type& target) const {
+  const uint64_t key = Impl::getKey(source, target);
+  auto locked = impl->getShard(key).relations.lockShared();
+  ZC_IF_SOME(assignable, locked->find(key)) { return assignable; }
+  return zc::none;
+}
+
+void AssignabilityCache::insert(const Type& source, const Type& target, bool assignable) const {
+  ZC_REQUIRE(covers(source, target), "type is newer than the cache");
+  const uint64_t key = Impl::getKey(source, target);
+  // Another thread may have decided the same pair meanwhile, and decided it the same way
+  impl->getShard(key).relations.lockExclusive()->upsert(key, assignable);
+}
+
+size_t AssignabilityCache::size() const {
+  size_t size = 0;
+  for (const auto& shard : impl->shards) { size += shard.relations.lockShared()->size(); }
+  return size;
+}
+
+}  // namespace checker
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,222 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace checker {
+
+enum class TypeKind : uint8_t {
+  /// What an expression that could not be typed has. It converts to and from every type, so that
+  /// one error is not reported again at every use of its result.
+  kError,
+  kUnit,
+  kBool,
+  kStr,
+  kNull,
+  kI8,
+  kI16,
+  kI32,
+  kI64,
+  kU8,
+  kU16,
+  kU32,
+  kU64,
+  kF32,
+  kF64,
+  kArray,
+  kOptional,
+  kFunction,
+  /// A class, interface, struct, enum or error type by name, with its type arguments if generic
+  kNamed,
+  /// A type parameter of a generic function, equal only to itself
+  kTypeParameter,
+  /// Two or more types, none of them a union, optional, null or the error type
+  kUnion,
+};
+
+/// \brief A semantic type, as the checker reasons about it.
+///
+/// Unlike `ast::TypeNode`, a type has no source location and no syntax: `i32[]` spelled twice is
+/// two nodes but one type. Types are hash-consed: primitive types are shared singletons, and
+/// every other type is made by a `TypeInterner`, which makes each distinct type once. Two types
+/// are therefore the same exactly if they are the same object.
+class Type {
+public:
+  constexpr explicit Type(TypeKind kind) : kind(kind), id(static_cast<uint32_t>(kind)) {}
+  /// Only for `TypeInterner`, which passes canonical components and arrays it owns.
+  Type(uint32_t id, TypeKind kind, const Type* element, zc::ArrayPtr<const Type* const> members,
+       zc::ArrayPtr<const Type* const> typeParameters, zc::StringPtr name,
+       size_t requiredParameters, bool variadic);
+
+  ZC_DISALLOW_COPY_AND_MOVE(Type);
+
+  /// \brief The singleton of a primitive kind, from `kError` to `kF64`.
+  static const Type& get(TypeKind kind);
+
+  TypeKind getKind() const { return kind; }
+  bool isError() const { return kind == TypeKind::kError; }
+  bool isInteger() const { return kind >= TypeKind::kI8 && kind <= TypeKind::kU64; }
+  bool isFloat() const { return kind == TypeKind::kF32 || kind == TypeKind::kF64; }
+  bool isNumeric() const { return isInteger() || isFloat(); }
+
+  /// \brief Unique among the types of one interner and its parents, in order of creation.
+  uint32_t getId() const { return id; }
+
+  /// \brief The element type of an array or optional type.
+  const Type& getElement() const;
+
+  /// \brief The parameter types of a function type.
+  zc::ArrayPtr<const Type* const> getParameters() const;
+  /// \brief Parameters that have no default and are not variadic.
+  size_t getRequiredParameterCount() const { return requiredParameters; }
+  /// \brief True if the last parameter takes any number of arguments.
+  bool isVariadic() const { return variadic; }
+  /// \brief The result type of a function type.
+  const Type& getResult() const;
+  /// \brief The type parameters a generic function type declares, empty once instantiated.
+  zc::ArrayPtr<const Type* const> getTypeParameters() const { return typeParameters; }
+
+  /// \brief The members of a union type, ordered by id.
+  zc::ArrayPtr<const Type* const> getMembers() const;
+  /// \brief The type arguments of a named type, e.g. `i32` for `Box<i32>`.
+  zc::ArrayPtr<const Type* const> getTypeArguments() const;
+
+  /// \brief The name of a named type or type parameter.
+  zc::StringPtr getName() const;
+
+  /// \brief True if this type mentions a type parameter anywhere. Computed once, when the type
+  /// is interned.
+  bool isGeneric() const { return generic; }
+
+  /// \brief The type as it is spelled in source, e.g. `(i32, str) -> bool?`.
+  zc::String toString() const;
+
+private:
+  TypeKind kind;
+  bool variadic = false;
+  bool generic = false;
+  uint32_t id;
+  uint32_t requiredParameters = 0;
+  /// Element of an array or optional, or result of a function
+  const Type* element = nullptr;
+  /// Parameters of a function, members of a union, or type arguments of a named type
+  zc::ArrayPtr<const Type* const> members;
+  zc::ArrayPtr<const Type* const> typeParameters;
+  zc::StringPtr name;
+};
+
+zc::String ZC_STRINGIFY(const Type& type);
+
+/// \brief True if the two types are the same, which for interned types is identity.
+inline bool isSameType(const Type& a, const Type& b) { return &a == &b; }
+
+class AssignabilityCache;
+
+/// \brief True if a value of `source` may be used where `target` is expected: the same type,
+/// `null` or an element value for an optional, a member of a union, or anything involving the
+/// error type.
+bool isAssignable(const Type& source, const Type& target);
+/// \brief `isAssignable()`, looking up and recording the relations between the cache's types,
+/// including those between their components, in `cache`.
+bool isAssignable(const Type& source, const Type& target, const AssignabilityCache& cache);
+
+/// \brief Makes every type that is not primitive, each distinct one once.
+///
+/// An interner is not thread-safe, but it may have a parent that it only reads: a type is looked
+/// up in the parent before it is made in the child, so the child's types are identical to the
+/// parent's wherever they are the same. The checker interns the module-level signatures into one
+/// interner in its first phase, and gives each function body checked in the second a child of
+/// that one, which is then frozen. Instantiations of generic functions are cached the same way.
+class TypeInterner {
+public:
+  explicit TypeInterner(zc::Maybe<const TypeInterner&> parent = zc::none) noexcept;
+  ~TypeInterner() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(TypeInterner);
+
+  const Type& array(const Type& element);
+  /// \brief `T?`. An optional of an optional, of `null` or of the error type is that type.
+  const Type& optional(const Type& element);
+  /// \brief The union of the given types, flattened and without duplicates. `null` makes the
+  /// union optional, and a single type is its own union.
+  const Type& unionOf(zc::ArrayPtr<const Type* const> types);
+  /// \param typeParameters The function's own type parameters, if it is generic
+  const Type& function(zc::ArrayPtr<const Type* const> parameters, size_t requiredParameters,
+                       bool variadic, const Type& result,
+                       zc::ArrayPtr<const Type* const> typeParameters = nullptr);
+  /// \param name Must outlive the interner, e.g. a name in the AST
+  const Type& named(zc::StringPtr name, zc::ArrayPtr<const Type* const> typeArguments = nullptr);
+  /// \brief A new type parameter, distinct from every other one even of the same name.
+  /// \param name Must outlive the interner, e.g. a name in the AST
+  const Type& typeParameter(zc::StringPtr name);
+
+  /// \brief A generic function type with its type parameters replaced by the given arguments,
+  /// made once per distinct list of arguments.
+  const Type& instantiate(const Type& generic, zc::ArrayPtr<const Type* const> typeArguments);
+
+  /// \brief `type` with each of `parameters` replaced by the argument at the same index.
+  const Type& substitute(const Type& type, zc::ArrayPtr<const Type* const> parameters,
+                         zc::ArrayPtr<const Type* const> arguments);
+
+  /// \brief Types made by this interner, not counting its parent's.
+  size_t size() const;
+  /// \brief The id of the next type made. Every type this interner or its parents made so far
+  /// has a smaller one.
+  uint32_t getNextId() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+/// \brief Remembers which types of a frozen interner are assignable to which, for any number of
+/// threads at once.
+///
+/// Relations are keyed by the ids of the two types, so only the types the interner had made when
+/// the cache was created are cached: the children of the interner give their own types ids that
+/// overlap with each other's. The cache is sharded by key, each shard behind its own lock.
+class AssignabilityCache {
+public:
+  explicit AssignabilityCache(const TypeInterner& types) noexcept;
+  ~AssignabilityCache() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(AssignabilityCache);
+
+  /// \brief True if both types are old enough to be cached.
+  bool covers(const Type& source, const Type& target) const {
+    return source.getId() < idLimit && target.getId() < idLimit;
+  }
+
+  zc::Maybe<bool> find(const Type& source, const Type& target) const;
+  void insert(const Type& source, const Type& target, bool assignable) const;
+
+  /// \brief Relations cached so far. Takes every shard's lock in turn.
+  size_t size() const;
+
+private:
+  struct Impl;
+
+  uint32_t idLimit;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace checker
+}  // namespace compiler
+}  // namespace zomlang
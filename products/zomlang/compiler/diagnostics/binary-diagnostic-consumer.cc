@@ -0,0 +1,319 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/diagnostics/binary-diagnostic-consumer.h"
+
+#include <cstring>
+
+#include "zc/core/debug.h"
+#include "zc/core/one-of.h"
+#include "zomlang/compiler/diagnostics/diagnostic-info.h"
+#include "zomlang/compiler/diagnostics/diagnostic.h"
+#include "zomlang/compiler/source/location.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace diagnostics {
+
+namespace {
+
+struct StreamHeader {
+  char magic[4];
+  uint16_t version;
+  uint16_t reserved;
+  uint32_t byteOrder;
+};
+
+constexpr char kStreamMagic[4] = {'Z', 'D', 'I', 'A'};
+constexpr uint16_t kStreamVersion = 1;
+constexpr uint32_t kByteOrderMark = 0x01020304;
+
+constexpr uint8_t kFileRecord = 1;
+constexpr uint8_t kDiagnosticRecord = 2;
+
+/// Records are written once this much is pending.
+constexpr size_t kFlushThreshold = 64 * 1024;
+/// A record larger than this is taken as a corrupt stream rather than allocated.
+constexpr uint32_t kMaxRecordBytes = 1u << 26;
+
+template <typename T>
+void put(zc::Vector<zc::byte>& out, T value) {
+  out.addAll(zc::arrayPtr(&value, 1).asBytes());
+}
+
+void putString(zc::Vector<zc::byte>& out, zc::ArrayPtr<const zc::byte> text) {
+  put<uint32_t>(out, static_cast<uint32_t>(text.size()));
+  out.addAll(text);
+}
+
+/// Reads the fields of one record, failing on anything running past its end.
+class RecordReader {
+public:
+  explicit RecordReader(zc::ArrayPtr<const zc::byte> bytes) : rest(bytes) {}
+
+  template <typename T>
+  T get() {
+    ZC_REQUIRE(rest.size() >= sizeof(T), "diagnostic record is truncated");
+    T value;
+    memcpy(&value, rest.begin(), sizeof(T));
+    rest = rest.slice(sizeof(T), rest.size());
+    return value;
+  }
+
+  zc::String getString() {
+    const uint32_t size = get<uint32_t>();
+    ZC_REQUIRE(rest.size() >= size, "diagnostic record is truncated");
+    zc::String result = zc::heapString(rest.first(size).asChars());
+    rest = rest.slice(size, rest.size());
+    return result;
+  }
+
+  DecodedRange getRange() {
+    const uint32_t bufferId = get<uint32_t>();
+    const uint32_t offset = get<uint32_t>();
+    return DecodedRange{bufferId, offset, get<uint32_t>()};
+  }
+
+  DecodedDiagnostic getDiagnostic() {
+    DecodedDiagnostic result;
+    result.id = static_cast<DiagID>(get<uint32_t>());
+    result.severity = static_cast<DiagSeverity>(get<uint8_t>());
+    ZC_REQUIRE(result.severity <= DiagSeverity::kFatal, "unknown diagnostic severity");
+    result.bufferId = get<uint32_t>();
+    result.offset = get<uint32_t>();
+    result.line = get<uint32_t>();
+    result.column = get<uint32_t>();
+    for (uint16_t n = get<uint16_t>(); n > 0; --n) { result.args.add(getString()); }
+    for (uint16_t n = get<uint16_t>(); n > 0; --n) { result.ranges.add(getRange()); }
+    for (uint16_t n = get<uint16_t>(); n > 0; --n) {
+      DecodedRange range = getRange();
+      result.fixIts.add(DecodedFixIt{range, getString()});
+    }
+    for (uint16_t n = get<uint16_t>(); n > 0; --n) { result.children.add(getDiagnostic()); }
+    return result;
+  }
+
+  bool atEnd() const { return rest.size() == 0; }
+
+private:
+  zc::ArrayPtr<const zc::byte> rest;
+};
+
+}  // namespace
+
+// ================================================================================
+// BinaryDiagnosticConsumer::Impl
+
+struct BinaryDiagnosticConsumer::Impl {
+  explicit Impl(zc::Own<zc::OutputStream> output) : output(zc::mv(output)) {
+    StreamHeader header;
+    memcpy(header.magic, kStreamMagic, sizeof(kStreamMagic));
+    header.version = kStreamVersion;
+    header.reserved = 0;
+    header.byteOrder = kByteOrderMark;
+    pending.addAll(zc::arrayPtr(&header, 1).asBytes());
+  }
+
+  zc::Own<zc::OutputStream> output;
+  /// Records not written yet
+  zc::Vector<zc::byte> pending;
+  /// Buffers whose file record was written
+  zc::HashSet<uint32_t> announcedBuffers;
+
+  void flush() {
+    if (pending.empty()) { return; }
+    output->write(pending.asPtr());
+    pending.clear();
+  }
+
+  /// Start a record of `kind`, returning where its size goes.
+  size_t beginRecord(uint8_t kind) {
+    const size_t start = pending.size();
+    put<uint32_t>(pending, 0);
+    put<uint8_t>(pending, kind);
+    return start;
+  }
+
+  void endRecord(size_t start) {
+    const uint32_t size = static_cast<uint32_t>(pending.size() - start - sizeof(uint32_t));
+    memcpy(pending.begin() + start, &size, sizeof(size));
+  }
+
+  /// The buffer holding `loc`, announced with a file record if this is its first use, or zero.
+  uint32_t getBufferId(const source::SourceManager& sm, source::SourceLoc loc) {
+    if (loc.isInvalid()) { return 0; }
+    ZC_IF_SOME(bufferId, sm.findBufferContainingLoc(loc)) {
+      const uint32_t id = static_cast<uint32_t>(static_cast<uint64_t>(bufferId));
+      if (!announcedBuffers.contains(id)) {
+        announcedBuffers.insert(id);
+        const size_t start = beginRecord(kFileRecord);
+        put<uint32_t>(pending, id);
+        putString(pending, sm.getIdentifierForBuffer(bufferId).asBytes());
+        endRecord(start);
+      }
+      return id;
+    }
+    return 0;
+  }
+
+  /// The fields of a range, after announcing its buffer.
+  void collectRange(const source::SourceManager& sm, const source::CharSourceRange& range,
+                    zc::Vector<zc::byte>& out) {
+    const source::SourceLoc start = range.getStart();
+    const uint32_t bufferId = getBufferId(sm, start);
+    put<uint32_t>(out, bufferId);
+    put<uint32_t>(out,
+                  bufferId == 0 ? 0 : sm.getLocOffsetInBuffer(start, source::BufferId(bufferId)));
+    put<uint32_t>(out, range.length());
+  }
+
+  /// Add the location of `diagnostic` and those of its children, in the order they are written.
+  static void collectLocs(const Diagnostic& diagnostic, zc::Vector<source::SourceLoc>& locs) {
+    locs.add(diagnostic.getLoc());
+    for (const zc::Own<Diagnostic>& child : diagnostic.getChildDiagnostics()) {
+      collectLocs(*child, locs);
+    }
+  }
+
+  /// The fields of `diagnostic`. Built apart from `pending`, since file records for the buffers
+  /// it names are written there while building it.
+  /// \param resolved Lines and columns of the locations `collectLocs()` lists; those of
+  /// `diagnostic` and its children are taken from the front.
+  void collectDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic,
+                         zc::ArrayPtr<const source::LineAndColumn>& resolved,
+                         zc::Vector<zc::byte>& out) {
+    const source::LineAndColumn lineAndColumn = resolved.front();
+    resolved = resolved.slice(1, resolved.size());
+    put<uint32_t>(out, static_cast<uint32_t>(diagnostic.getId()));
+    put<uint8_t>(out, static_cast<uint8_t>(getDiagnosticInfo(diagnostic.getId()).severity));
+
+    const source::SourceLoc loc = diagnostic.getLoc();
+    const uint32_t bufferId = getBufferId(sm, loc);
+    put<uint32_t>(out, bufferId);
+    if (bufferId == 0) {
+      put<uint32_t>(out, 0);
+      put<uint32_t>(out, 0);
+      put<uint32_t>(out, 0);
+    } else {
+      put<uint32_t>(out, sm.getLocOffsetInBuffer(loc, source::BufferId(bufferId)));
+      put<uint32_t>(out, lineAndColumn.line);
+      put<uint32_t>(out, lineAndColumn.column);
+    }
+
+    put<uint16_t>(out, static_cast<uint16_t>(diagnostic.getArgs().size()));
+    for (const DiagnosticArgument& arg : diagnostic.getArgs()) {
+      ZC_SWITCH_ONEOF(arg) {
+        ZC_CASE_ONEOF(strPtr, zc::StringPtr) { putString(out, strPtr.asBytes()); }
+        ZC_CASE_ONEOF(str, zc::String) { putString(out, str.asBytes()); }
+        ZC_CASE_ONEOF(token, lexer::Token) { putString(out, token.getValue().asBytes()); }
+      }
+    }
+
+    put<uint16_t>(out, static_cast<uint16_t>(diagnostic.getRanges().size()));
+    for (const source::CharSourceRange& range : diagnostic.getRanges()) {
+      collectRange(sm, range, out);
+    }
+
+    put<uint16_t>(out, static_cast<uint16_t>(diagnostic.getFixIts().size()));
+    for (const zc::Own<FixIt>& fixIt : diagnostic.getFixIts()) {
+      collectRange(sm, fixIt->range, out);
+      putString(out, fixIt->replacementText.asBytes());
+    }
+
+    put<uint16_t>(out, static_cast<uint16_t>(diagnostic.getChildDiagnostics().size()));
+    for (const zc::Own<Diagnostic>& child : diagnostic.getChildDiagnostics()) {
+      collectDiagnostic(sm, *child, resolved, out);
+    }
+  }
+};
+
+// ================================================================================
+// BinaryDiagnosticConsumer
+
+BinaryDiagnosticConsumer::BinaryDiagnosticConsumer(zc::Own<zc::OutputStream> output)
+    : impl(zc::heap<Impl>(zc::mv(output))) {}
+
+BinaryDiagnosticConsumer::~BinaryDiagnosticConsumer() noexcept(false) { impl->flush(); }
+
+void BinaryDiagnosticConsumer::handleDiagnostic(const source::SourceManager& sm,
+                                                const Diagnostic& diagnostic) {
+  const Diagnostic* const diagnostics[] = {&diagnostic};
+  handleDiagnostics(sm, diagnostics);
+}
+
+void BinaryDiagnosticConsumer::handleDiagnostics(
+    const source::SourceManager& sm, zc::ArrayPtr<const Diagnostic* const> diagnostics) {
+  zc::Vector<source::SourceLoc> locs;
+  for (const Diagnostic* diagnostic : diagnostics) { Impl::collectLocs(*diagnostic, locs); }
+  const zc::Array<source::LineAndColumn> resolved = sm.resolveLineColumns(locs);
+
+  zc::ArrayPtr<const source::LineAndColumn> remaining = resolved;
+  for (const Diagnostic* diagnostic : diagnostics) {
+    zc::Vector<zc::byte> body;
+    impl->collectDiagnostic(sm, *diagnostic, remaining, body);
+
+    const size_t start = impl->beginRecord(kDiagnosticRecord);
+    impl->pending.addAll(body);
+    impl->endRecord(start);
+    if (impl->pending.size() >= kFlushThreshold) { impl->flush(); }
+  }
+}
+
+// ================================================================================
+// readBinaryDiagnostics
+
+DecodedDiagnostics readBinaryDiagnostics(zc::InputStream& input) {
+  StreamHeader header;
+  input.read(zc::arrayPtr(&header, 1).asBytes());
+  ZC_REQUIRE(memcmp(header.magic, kStreamMagic, sizeof(kStreamMagic)) == 0,
+             "not a zomlang diagnostics stream");
+  ZC_REQUIRE(header.byteOrder == kByteOrderMark,
+             "diagnostics stream was written with another byte order");
+  ZC_REQUIRE(header.version == kStreamVersion, "unsupported diagnostics stream version",
+             header.version);
+
+  DecodedDiagnostics result;
+  zc::Vector<zc::byte> record;
+  while (true) {
+    uint32_t size;
+    const size_t n = input.tryRead(zc::arrayPtr(&size, 1).asBytes(), sizeof(size));
+    if (n == 0) { break; }
+    ZC_REQUIRE(n == sizeof(size), "diagnostics stream is truncated");
+    ZC_REQUIRE(size > 0 && size <= kMaxRecordBytes, "diagnostic record size out of range", size);
+    record.resize(size);
+    input.read(record.asPtr());
+
+    RecordReader reader(record.asPtr());
+    switch (reader.get<uint8_t>()) {
+      case kFileRecord: {
+        const uint32_t bufferId = reader.get<uint32_t>();
+        result.files.upsert(bufferId, reader.getString());
+        break;
+      }
+      case kDiagnosticRecord:
+        result.diagnostics.add(reader.getDiagnostic());
+        break;
+      default:
+        // Records of kinds added later are skipped, so that old readers keep working.
+        continue;
+    }
+    ZC_REQUIRE(reader.atEnd(), "diagnostic record has trailing bytes");
+  }
+  return result;
+}
+
+}  // namespace diagnostics
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,96 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "zc/core/common.h"
+#include "zc/core/io.h"
+#include "zc/core/map.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
+#include "zomlang/compiler/diagnostics/diagnostic-ids.h"
+
+namespace zomlang {
+namespace compiler {
+namespace diagnostics {
+
+/// \brief Writes diagnostics as a binary stream for build tools to read back with
+/// readBinaryDiagnostics(), rather than parsing console text.
+///
+/// The stream starts with a header of magic "ZDIA", a format version and a byte order mark, all
+/// in the writer's byte order. Then come records, each a uint32_t byte count, a kind byte and the
+/// body. A file record (kind 1) introduces a buffer id with the file's name, before the first
+/// diagnostic referring to it. A diagnostic record (kind 2) holds the ID, severity, buffer id (0
+/// if unknown), offset, line and column, the arguments as text, the highlighted ranges, the
+/// fix-its and the child diagnostics. Strings are a uint32_t length and the bytes.
+///
+/// Records are written to `output` in batches, and the last one when the consumer is destroyed.
+class BinaryDiagnosticConsumer final : public DiagnosticConsumer {
+public:
+  explicit BinaryDiagnosticConsumer(zc::Own<zc::OutputStream> output);
+  ~BinaryDiagnosticConsumer() noexcept(false) override;
+
+  void handleDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic) override;
+  void handleDiagnostics(const source::SourceManager& sm,
+                         zc::ArrayPtr<const Diagnostic* const> diagnostics) override;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+/// A range of text that a decoded diagnostic refers to.
+struct DecodedRange {
+  uint32_t bufferId;
+  uint32_t offset;
+  uint32_t length;
+};
+
+struct DecodedFixIt {
+  DecodedRange range;
+  zc::String replacement;
+};
+
+/// A diagnostic as read back from a BinaryDiagnosticConsumer stream.
+struct DecodedDiagnostic {
+  DiagID id;
+  DiagSeverity severity;
+  /// Zero when the diagnostic has no location
+  uint32_t bufferId;
+  uint32_t offset;
+  uint32_t line;
+  uint32_t column;
+  zc::Vector<zc::String> args;
+  zc::Vector<DecodedRange> ranges;
+  zc::Vector<DecodedFixIt> fixIts;
+  zc::Vector<DecodedDiagnostic> children;
+};
+
+struct DecodedDiagnostics {
+  /// The name of each file by buffer id
+  zc::HashMap<uint32_t, zc::String> files;
+  zc::Vector<DecodedDiagnostic> diagnostics;
+};
+
+/// \brief Read a whole stream written by BinaryDiagnosticConsumer.
+/// Throws if the stream is malformed, truncated, or from a writer of another byte order.
+DecodedDiagnostics readBinaryDiagnostics(zc::InputStream& input);
+
+}  // namespace diagnostics
+}  // namespace compiler
+}  // namespace zomlang
@@ -52,6 +52,12 @@ constexpr zc::StringPtr getColorForSeverity(DiagSeverity severity) {
 constexpr zc::StringPtr RESET_COLOR = "\033[0m"_zc;
 constexpr zc::StringPtr GRAY_COLOR = "\033[90m"_zc;
 
+/// Add the location of `diagnostic` and those of its children, in the order they are printed.
+void collectLocs(const Diagnostic& diagnostic, zc::Vector<source::SourceLoc>& locs) {
+  locs.add(diagnostic.getLoc());
+  for (const auto& child : diagnostic.getChildDiagnostics()) { collectLocs(*child, locs); }
+}
+
 }  // namespace
 
 // ================================================================================
@@ -67,10 +73,76 @@ struct ConsolingDiagnosticConsumer::Impl {
   explicit Impl(bool coloredOutput)
       : stdOut(::std::cout), stdErr(::std::cerr), useColors(coloredOutput) {}
 
+  /// Print `diagnostic` and its children, taking their lines and columns from the front of
+  /// `resolved`, as resolved for the locations `collectLocs()` lists.
+  void printDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic,
+                       zc::ArrayPtr<const source::LineAndColumn>& resolved);
   void printSourceLine(zc::OutputStream& output, const source::SourceManager& sm,
                        const Diagnostic& diagnostic, unsigned int lineNum);
 };
 
+void ConsolingDiagnosticConsumer::Impl::printDiagnostic(
+    const source::SourceManager& sm, const Diagnostic& diagnostic,
+    zc::ArrayPtr<const source::LineAndColumn>& resolved) {
+  const DiagnosticInfo& info = getDiagnosticInfo(diagnostic.getId());
+  const source::LineAndColumn lineAndCol = resolved.front();
+  resolved = resolved.slice(1, resolved.size());
+
+  if (info.severity == DiagSeverity::kError || info.severity == DiagSeverity::kFatal) {
+    numErrors++;
+  } else if (info.severity == DiagSeverity::kWarning) {
+    numWarnings++;
+  }
+
+  zc::std::StdOutputStream& output = info.severity >= DiagSeverity::kError ? stdErr : stdOut;
+
+  // 1. Output diagnostic level (with color) + Error Code + Message
+  if (useColors) { output.write(getColorForSeverity(info.severity).asBytes()); }
+  output.write(zc::str(toString(info.severity)).asBytes());
+
+  if (useColors) { output.write(RESET_COLOR.asBytes()); }
+
+  // Output error code
+  if (useColors) { output.write(GRAY_COLOR.asBytes()); }
+  output.write(zc::str(" [ZOM", static_cast<int>(diagnostic.getId()), "]").asBytes());
+  if (useColors) { output.write(RESET_COLOR.asBytes()); }
+  output.write(": "_zcb);
+
+  // Output formatted messages
+  DiagnosticEngine::formatDiagnosticMessage(sm, output, info, diagnostic.getArgs());
+  output.write("\n"_zcb);
+
+  // 2. Output location information and source snippet (if any)
+  if (diagnostic.getLoc().isValid()) {
+    ZC_IF_SOME(bufferId, sm.findBufferContainingLoc(diagnostic.getLoc())) {
+      // Arrow and Path
+      if (useColors) output.write("\033[1;34m"_zcb);  // Blue
+      output.write("  --> "_zcb);
+      if (useColors) output.write(RESET_COLOR.asBytes());
+
+      output.write(
+          zc::str(sm.getIdentifierForBuffer(bufferId), ":", lineAndCol.line, ":", lineAndCol.column)
+              .asBytes());
+      output.write("\n"_zcb);
+
+      // Source Snippet
+      printSourceLine(output, sm, diagnostic, lineAndCol.line);
+    }
+    else {
+      // Fallback if buffer not found or other issues
+      diagnostic.getLoc().print(output, sm);
+      output.write("\n"_zcb);
+    }
+  }
+
+  // Handle child diagnostics (related information)
+  for (const auto& child : diagnostic.getChildDiagnostics()) {
+    printDiagnostic(sm, *child, resolved);
+  }
+
+  output.write("\n"_zcb);
+}
+
 void ConsolingDiagnosticConsumer::Impl::printSourceLine(zc::OutputStream& output,
                                                         const source::SourceManager& sm,
                                                         const Diagnostic& diagnostic,
@@ -83,7 +155,7 @@ void ConsolingDiagnosticConsumer::Impl::printSourceLine(zc::OutputStream& output
   const zc::ArrayPtr<const zc::byte> buffer = sm.getEntireTextForBuffer(bufferId);
   const zc::byte* bufStart = buffer.begin();
   const zc::byte* bufEnd = buffer.end();
-  const zc::byte* ptr = loc.getOpaqueValue();
+  const zc::byte* ptr = bufStart + sm.getLocOffsetInBuffer(loc, bufferId);
 
   // 2. Position the beginning and end of the line
   const zc::byte* lineStart = ptr;
@@ -130,9 +202,9 @@ void ConsolingDiagnosticConsumer::Impl::printSourceLine(zc::OutputStream& output
   if (diagnostic.getRanges().size() != 0) {
     zc::Vector<zc::ArrayPtr<const zc::byte>> underline;
     for (const auto& range : diagnostic.getRanges()) {
-      const auto start = range.getStart().getOpaqueValue() - lineStart;
-      const auto end = range.getEnd().getOpaqueValue() - lineStart;
-      for (int i = 0; i < end - start; ++i) { underline.add((i == 0) ? "^"_zcb : "~"_zcb); }
+      for (unsigned i = 0; i < range.length(); ++i) {
+        underline.add((i == 0) ? "^"_zcb : "~"_zcb);
+      }
     }
     if (underline.size() > 0) {
       output.write(underline.asPtr());
@@ -176,62 +248,20 @@ void ConsolingDiagnosticConsumer::printSummary() {
 
 void ConsolingDiagnosticConsumer::handleDiagnostic(const source::SourceManager& sm,
                                                    const Diagnostic& diagnostic) {
-  const DiagnosticInfo& info = getDiagnosticInfo(diagnostic.getId());
-
-  if (info.severity == DiagSeverity::kError || info.severity == DiagSeverity::kFatal) {
-    impl->numErrors++;
-  } else if (info.severity == DiagSeverity::kWarning) {
-    impl->numWarnings++;
-  }
-
-  zc::std::StdOutputStream& output =
-      info.severity >= DiagSeverity::kError ? impl->stdErr : impl->stdOut;
-
-  // 1. Output diagnostic level (with color) + Error Code + Message
-  if (impl->useColors) { output.write(getColorForSeverity(info.severity).asBytes()); }
-  output.write(zc::str(toString(info.severity)).asBytes());
-
-  if (impl->useColors) { output.write(RESET_COLOR.asBytes()); }
-
-  // Output error code
-  if (impl->useColors) { output.write(GRAY_COLOR.asBytes()); }
-  output.write(zc::str(" [ZOM", static_cast<int>(diagnostic.getId()), "]").asBytes());
-  if (impl->useColors) { output.write(RESET_COLOR.asBytes()); }
-  output.write(": "_zcb);
-
-  // Output formatted messages
-  DiagnosticEngine::formatDiagnosticMessage(sm, output, info.message, diagnostic.getArgs());
-  output.write("\n"_zcb);
-
-  // 2. Output location information and source snippet (if any)
-  if (diagnostic.getLoc().isValid()) {
-    ZC_IF_SOME(bufferId, sm.findBufferContainingLoc(diagnostic.getLoc())) {
-      auto lineAndCol = sm.getPresumedLineAndColumnForLoc(diagnostic.getLoc(), bufferId);
+  const Diagnostic* const diagnostics[] = {&diagnostic};
+  handleDiagnostics(sm, diagnostics);
+}
 
-      // Arrow and Path
-      if (impl->useColors) output.write("\033[1;34m"_zcb);  // Blue
-      output.write("  --> "_zcb);
-      if (impl->useColors) output.write(RESET_COLOR.asBytes());
+void ConsolingDiagnosticConsumer::handleDiagnostics(
+    const source::SourceManager& sm, zc::ArrayPtr<const Diagnostic* const> diagnostics) {
+  zc::Vector<source::SourceLoc> locs;
+  for (const Diagnostic* diagnostic : diagnostics) { collectLocs(*diagnostic, locs); }
+  const zc::Array<source::LineAndColumn> resolved = sm.resolveLineColumns(locs);
 
-      output.write(
-          zc::str(sm.getIdentifierForBuffer(bufferId), ":", lineAndCol.line, ":", lineAndCol.column)
-              .asBytes());
-      output.write("\n"_zcb);
-
-      // Source Snippet
-      impl->printSourceLine(output, sm, diagnostic, lineAndCol.line);
-    }
-    else {
-      // Fallback if buffer not found or other issues
-      diagnostic.getLoc().print(output, sm);
-      output.write("\n"_zcb);
-    }
+  zc::ArrayPtr<const source::LineAndColumn> remaining = resolved;
+  for (const Diagnostic* diagnostic : diagnostics) {
+    impl->printDiagnostic(sm, *diagnostic, remaining);
   }
-
-  // Handle child diagnostics (related information)
-  for (const auto& child : diagnostic.getChildDiagnostics()) { handleDiagnostic(sm, *child); }
-
-  output.write("\n"_zcb);
 }
 
 }  // namespace diagnostics
@@ -27,6 +27,8 @@ public:
   ~ConsolingDiagnosticConsumer() noexcept(false) override;
 
   void handleDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic) override;
+  void handleDiagnostics(const source::SourceManager& sm,
+                         zc::ArrayPtr<const Diagnostic* const> diagnostics) override;
 
 private:
   void printSummary();
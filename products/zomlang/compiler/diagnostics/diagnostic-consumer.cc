@@ -20,6 +20,11 @@ namespace diagnostics {
 
 DiagnosticConsumer::~DiagnosticConsumer() noexcept(false) = default;
 
+void DiagnosticConsumer::handleDiagnostics(const source::SourceManager& sm,
+                                           zc::ArrayPtr<const Diagnostic* const> diagnostics) {
+  for (const Diagnostic* diagnostic : diagnostics) { handleDiagnostic(sm, *diagnostic); }
+}
+
 }  // namespace diagnostics
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "zc/core/common.h"
+
 namespace zomlang {
 namespace compiler {
 
@@ -30,6 +32,12 @@ public:
   virtual ~DiagnosticConsumer() noexcept(false);
 
   virtual void handleDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic) = 0;
+
+  /// Handle diagnostics released together, in order, e.g. when the engine flushes its buffers.
+  /// Consumers that resolve locations override it to resolve the whole batch at once; by default
+  /// each is passed to `handleDiagnostic()`.
+  virtual void handleDiagnostics(const source::SourceManager& sm,
+                                 zc::ArrayPtr<const Diagnostic* const> diagnostics);
 };
 
 }  // namespace diagnostics
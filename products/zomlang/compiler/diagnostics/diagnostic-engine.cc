@@ -14,6 +14,12 @@
 
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
 #include "zc/core/one-of.h"
 #include "zc/core/vector.h"
 #include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
@@ -25,13 +31,53 @@ namespace zomlang {
 namespace compiler {
 namespace diagnostics {
 
+namespace {
+
+/// Tells engines apart in the per-thread cache even when one is allocated where another was.
+std::atomic<uint64_t> nextEngineId{1};
+
+/// Its address tells threads apart.
+thread_local char threadMarker;
+
+}  // namespace
+
 struct DiagnosticEngine::Impl {
   explicit Impl(source::SourceManager& sm) : sourceManager(sm) {}
 
+  /// What one thread reported. Only that thread touches it until the buffers are flushed, and
+  /// each has cache lines of its own, so a thread speculating or reporting does not slow the
+  /// others.
+  struct alignas(64) ThreadState {
+    size_t suppressionDepth = 0;
+    /// Diagnostics held back while buffering, in the order the thread reported them
+    zc::Vector<Diagnostic> buffered;
+  };
+
+  const uint64_t id = nextEngineId.fetch_add(1, std::memory_order_relaxed);
   source::SourceManager& sourceManager;
   zc::Vector<zc::Own<DiagnosticConsumer>> consumers;
   DiagnosticState state;
-  size_t suppressionDepth = 0;
+  std::atomic<bool> buffering{false};
+  /// Every thread that reported, by the address of its threadMarker. The lock is only taken the
+  /// first time a thread uses this engine, and to flush.
+  zc::MutexGuarded<zc::HashMap<uintptr_t, zc::Own<ThreadState>>> threads;
+
+  ThreadState& getThreadState() const {
+    struct Cache {
+      uint64_t engineId = 0;
+      ThreadState* state = nullptr;
+    };
+    static thread_local Cache cache;
+    if (cache.engineId == id) { return *cache.state; }
+
+    auto lockedThreads = threads.lockExclusive();
+    const uintptr_t thread = reinterpret_cast<uintptr_t>(&threadMarker);
+    ThreadState& result = *lockedThreads->findOrCreate(thread, [&]() {
+      return zc::HashMap<uintptr_t, zc::Own<ThreadState>>::Entry{thread, zc::heap<ThreadState>()};
+    });
+    cache = Cache{id, &result};
+    return result;
+  }
 };
 
 DiagnosticEngine::DiagnosticEngine(source::SourceManager& sourceManager)
@@ -42,20 +88,58 @@ void DiagnosticEngine::addConsumer(zc::Own<DiagnosticConsumer> consumer) {
   impl->consumers.add(zc::mv(consumer));
 }
 
-void DiagnosticEngine::emit(const Diagnostic& diagnostic) {
-  if (impl->suppressionDepth > 0) { return; }
+void DiagnosticEngine::emit(Diagnostic&& diagnostic) {
+  if (!isEnabled(diagnostic.getId())) { return; }
 
   // Check if this is an error-level diagnostic and update state
   const DiagnosticInfo& info = getDiagnosticInfo(diagnostic.getId());
   if (info.severity >= DiagSeverity::kError) { impl->state.setHadAnyError(); }
+  if (info.severity == DiagSeverity::kFatal) { impl->state.setHadFatalError(); }
+
+  if (impl->buffering.load(std::memory_order_relaxed)) {
+    impl->getThreadState().buffered.add(zc::mv(diagnostic));
+    return;
+  }
 
   for (auto& consumer : impl->consumers) {
     consumer->handleDiagnostic(impl->sourceManager, diagnostic);
   }
 }
 
+void DiagnosticEngine::beginBuffering() { impl->buffering.store(true, std::memory_order_relaxed); }
+
+void DiagnosticEngine::flushBuffered() {
+  impl->buffering.store(false, std::memory_order_relaxed);
+
+  zc::Vector<zc::Vector<Diagnostic>> batches;
+  {
+    auto lockedThreads = impl->threads.lockExclusive();
+    for (auto& entry : *lockedThreads) {
+      if (!entry.value->buffered.empty()) { batches.add(zc::mv(entry.value->buffered)); }
+    }
+  }
+
+  zc::Vector<const Diagnostic*> ordered;
+  for (const zc::Vector<Diagnostic>& batch : batches) {
+    for (const Diagnostic& diagnostic : batch) { ordered.add(&diagnostic); }
+  }
+  // Locations grow with the order the buffers were added in, so this sorts by file, then offset.
+  std::stable_sort(ordered.begin(), ordered.end(), [](const Diagnostic* a, const Diagnostic* b) {
+    const uint32_t aLoc = a->getLoc().getOpaqueValue();
+    const uint32_t bLoc = b->getLoc().getOpaqueValue();
+    if (aLoc != bLoc) { return aLoc < bLoc; }
+    return static_cast<uint32_t>(a->getId()) < static_cast<uint32_t>(b->getId());
+  });
+
+  for (auto& consumer : impl->consumers) {
+    consumer->handleDiagnostics(impl->sourceManager, ordered);
+  }
+}
+
 bool DiagnosticEngine::hasErrors() const { return impl->state.getHadAnyError(); }
 
+bool DiagnosticEngine::hasFatalErrors() const { return impl->state.getHadFatalError(); }
+
 source::SourceManager& DiagnosticEngine::getSourceManager() const { return impl->sourceManager; }
 
 DiagnosticState& DiagnosticEngine::getState() { return impl->state; }
@@ -64,68 +148,59 @@ const DiagnosticState& DiagnosticEngine::getState() const { return impl->state;
 
 // static
 void DiagnosticEngine::formatDiagnosticMessage(const source::SourceManager& sm,
-                                               zc::OutputStream& out, zc::StringPtr format,
+                                               zc::OutputStream& out, const DiagnosticInfo& info,
                                                zc::ArrayPtr<const DiagnosticArgument> args) {
-  struct ParamPos {
-    size_t start;
-    size_t end;
-    size_t index;
-  };
-  zc::Vector<ParamPos> params;
-
-  // Preprocessing finds all parameter locations
-  for (size_t i = 0; i < format.size(); ++i) {
-    if (format[i] == '{' && i + 1 < format.size()) {
-      size_t j = i + 1;
-      while (j < format.size() && format[j] != '}') { ++j; }
-
-      if (j < format.size() && j > i + 1) {
-        size_t argIndex = 0;
-        for (size_t k = i + 1; k < j; ++k) {
-          ZC_IREQUIRE(format[k] >= '0' && format[k] <= '9', "Invalid parameter index format");
-          argIndex = argIndex * 10 + (format[k] - '0');
-        }
-
-        ParamPos param{i, j, argIndex};
-        params.add(zc::mv(param));
-        i = j;  // Skip the current '}'
-      }
+  ZC_IREQUIRE(args.size() == info.argCount, "Parameter count mismatch");
+
+  // Each segment gives its text and at most one argument
+  ZC_STACK_ARRAY(zc::ArrayPtr<const zc::byte>, pieces, info.segments.size() * 2, 8, 32);
+  size_t count = 0;
+  for (const MessageSegment& segment : info.segments) {
+    if (segment.textSize > 0) {
+      pieces[count++] = info.message.slice(segment.textStart, segment.textStart + segment.textSize)
+                            .asBytes();
     }
-  }
-
-  // Check the number and order of parameters
-  ZC_IREQUIRE(params.size() == args.size(), "Parameter count mismatch");
-  for (size_t i = 0; i < params.size(); ++i) {
-    ZC_IREQUIRE(params[i].index == i, "Parameter indices must be consecutive starting from 0");
-  }
+    if (segment.argIndex == MessageSegment::kNoArgument) { continue; }
 
-  // Unified output
-  size_t lastPos = 0;
-  for (const auto& param : params) {
-    // Output the text before the argument
-    if (param.start > lastPos) { out.write(format.slice(lastPos, param.start).asBytes()); }
-
-    // Output parameters
-    const auto& arg = args[param.index];
-    ZC_SWITCH_ONEOF(arg) {
-      ZC_CASE_ONEOF(strPtr, zc::StringPtr) { out.write(strPtr.asBytes()); }
-      ZC_CASE_ONEOF(str, zc::String) { out.write(str.asBytes()); }
-      ZC_CASE_ONEOF(token, lexer::Token) { out.write(token.getValue().asBytes()); }
+    ZC_SWITCH_ONEOF(args[segment.argIndex]) {
+      ZC_CASE_ONEOF(strPtr, zc::StringPtr) { pieces[count++] = strPtr.asBytes(); }
+      ZC_CASE_ONEOF(str, zc::String) { pieces[count++] = str.asBytes(); }
+      ZC_CASE_ONEOF(token, lexer::Token) { pieces[count++] = token.getValue().asBytes(); }
     }
-    lastPos = param.end + 1;
   }
-
-  // Output the remaining text
-  if (lastPos < format.size()) { out.write(format.slice(lastPos, format.size()).asBytes()); }
+  out.write(pieces.first(count));
 }
 
-void DiagnosticEngine::suppress() { ++impl->suppressionDepth; }
+void DiagnosticEngine::suppress() { ++impl->getThreadState().suppressionDepth; }
 
 void DiagnosticEngine::unsuppress() {
-  if (impl->suppressionDepth > 0) { --impl->suppressionDepth; }
+  Impl::ThreadState& thread = impl->getThreadState();
+  if (thread.suppressionDepth > 0) { --thread.suppressionDepth; }
+}
+
+bool DiagnosticEngine::isSuppressed() const { return impl->getThreadState().suppressionDepth > 0; }
+
+bool DiagnosticEngine::isEnabled(DiagID id) const {
+  if (isSuppressed() || impl->state.isDiagnosticIgnored(id)) { return false; }
+  return !impl->state.getSuppressWarnings() ||
+         getDiagnosticInfo(id).severity != DiagSeverity::kWarning;
 }
 
-bool DiagnosticEngine::isSuppressed() const { return impl->suppressionDepth > 0; }
+basic::MemoryUsage DiagnosticEngine::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  usage.addVector(impl->consumers);
+  auto lockedThreads = impl->threads.lockShared();
+  usage.addTable(*lockedThreads);
+  for (const auto& entry : *lockedThreads) {
+    usage.addObject<Impl::ThreadState>();
+    usage.addVector(entry.value->buffered);
+    for (const Diagnostic& diagnostic : entry.value->buffered) {
+      usage += diagnostic.getMemoryUsage();
+    }
+  }
+  return usage;
+}
 
 }  // namespace diagnostics
 }  // namespace compiler
@@ -49,9 +49,23 @@ public:
   ZC_DISALLOW_COPY_AND_MOVE(DiagnosticEngine);
 
   void addConsumer(zc::Own<DiagnosticConsumer> consumer);
-  void emit(const Diagnostic& diagnostic);
+  /// \brief Hand a diagnostic to the consumers, or to the emitting thread's buffer while
+  /// buffering. Without buffering, only one thread may emit at a time.
+  void emit(Diagnostic&& diagnostic);
+
+  /// \brief Hold diagnostics back in a buffer per emitting thread until flushBuffered(), so that
+  /// workers report without contending on each other or on the consumers.
+  void beginBuffering();
+  /// \brief Stop buffering and hand the buffered diagnostics to the consumers on this thread,
+  /// ordered by location so that the output does not depend on how the workers interleaved.
+  /// Diagnostics at the same location keep the order they were reported in by their thread. Must
+  /// not run while other threads still emit.
+  void flushBuffered();
 
   ZC_NODISCARD bool hasErrors() const;
+  /// \brief Whether a diagnostic of fatal severity was emitted, after which work still queued
+  /// should be abandoned.
+  ZC_NODISCARD bool hasFatalErrors() const;
   ZC_NODISCARD source::SourceManager& getSourceManager() const;
   ZC_NODISCARD const DiagnosticState& getState() const;
 
@@ -60,10 +74,21 @@ public:
   // Speculative parse support.
   // suppress() prevents emit() from forwarding diagnostics to consumers or setting hadAnyError.
   // unsuppress() restores normal emission. Nestable: suppression is active while depth > 0.
+  // The depth is kept per thread, so a speculative parse on one worker does not silence another.
   void suppress();
   void unsuppress();
   ZC_NODISCARD bool isSuppressed() const;
 
+  /// \brief Whether a diagnostic with `id` reported from this thread now would reach the
+  /// consumers, rather than being dropped for suppression, being ignored, or being a warning while
+  /// warnings are suppressed.
+  ZC_NODISCARD bool isEnabled(DiagID id) const;
+
+  /// \brief Measure the state of the threads that reported and the diagnostics they hold back
+  /// while buffering. What consumers keep is theirs to account for. Must not run while other
+  /// threads emit.
+  ZC_NODISCARD basic::MemoryUsage getMemoryUsage() const;
+
   /// \brief Report a diagnostic at the given location.
   /// \param loc The location of the diagnostic.
   /// \param id The diagnostic ID.
@@ -73,11 +98,15 @@ public:
   InFlightDiagnostic diagnose(source::SourceLoc loc, Args&&... args) {
     static_assert(sizeof...(args) == DiagnosticTraits<ID>::argCount,
                   "Incorrect number of diagnostic arguments");
+    // A dropped diagnostic does not even keep its arguments.
+    if (!isEnabled(ID)) { return InFlightDiagnostic(*this); }
     return InFlightDiagnostic(*this, Diagnostic(ID, loc, zc::fwd<Args>(args)...));
   }
 
+  /// \brief Write the message of `info` with `args` in place of its placeholders, in a single
+  /// write to `out`.
   static void formatDiagnosticMessage(const source::SourceManager& sm, zc::OutputStream& out,
-                                      zc::StringPtr message,
+                                      const DiagnosticInfo& info,
                                       zc::ArrayPtr<const DiagnosticArgument> args);
 
 private:
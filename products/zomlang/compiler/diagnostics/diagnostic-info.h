@@ -14,6 +14,9 @@
 
 #pragma once
 
+#include <array>
+
+#include "zc/core/common.h"
 #include "zc/core/string.h"
 #include "zomlang/compiler/diagnostics/diagnostic-ids.h"
 
@@ -21,22 +24,95 @@ namespace zomlang {
 namespace compiler {
 namespace diagnostics {
 
+/// \brief A piece of a diagnostic message: literal text, then the argument printed after it.
+///
+/// Messages are split into these at compile time, so that formatting one is a run of appends
+/// rather than a search for `{N}` placeholders.
+struct MessageSegment {
+  /// Where the text starts in the message, and its length
+  size_t textStart;
+  size_t textSize;
+  /// Index of the argument following the text, or kNoArgument for the text ending the message
+  size_t argIndex;
+
+  static constexpr size_t kNoArgument = ~size_t(0);
+};
+
 struct DiagnosticInfo {
   DiagID id;
   DiagSeverity severity;
   zc::StringPtr message;
   size_t argCount;
+  zc::ArrayPtr<const MessageSegment> segments;
 };
 
+namespace detail {
+
+/// Calls `placeholder(start, end, index)` for each `{N}` in `message`, `end` being the offset of
+/// its closing brace, and returns how many there are. A brace not followed by digits and a
+/// closing brace is text.
+template <typename Func>
+constexpr size_t forEachPlaceholder(zc::StringPtr message, Func&& placeholder) {
+  size_t count = 0;
+  for (size_t i = 0; i < message.size(); ++i) {
+    if (message[i] != '{') { continue; }
+    size_t j = i + 1;
+    size_t index = 0;
+    while (j < message.size() && message[j] >= '0' && message[j] <= '9') {
+      index = index * 10 + (message[j] - '0');
+      ++j;
+    }
+    if (j == i + 1 || j == message.size() || message[j] != '}') { continue; }
+    placeholder(i, j, index);
+    ++count;
+    i = j;
+  }
+  return count;
+}
+
+constexpr size_t countPlaceholders(zc::StringPtr message) {
+  return forEachPlaceholder(message, [](size_t, size_t, size_t) {});
+}
+
+/// Whether the placeholders of `message` are `{0}` to `{argCount - 1}`, in order.
+constexpr bool hasConsecutivePlaceholders(zc::StringPtr message, size_t argCount) {
+  size_t expected = 0;
+  bool consecutive = true;
+  forEachPlaceholder(message, [&](size_t, size_t, size_t index) {
+    consecutive = consecutive && index == expected++;
+  });
+  return consecutive && expected == argCount;
+}
+
+template <size_t Count>
+constexpr std::array<MessageSegment, Count> splitMessage(zc::StringPtr message) {
+  std::array<MessageSegment, Count> segments{};
+  size_t segment = 0;
+  size_t textStart = 0;
+  forEachPlaceholder(message, [&](size_t start, size_t end, size_t index) {
+    segments[segment++] = MessageSegment{textStart, start - textStart, index};
+    textStart = end + 1;
+  });
+  segments[segment] =
+      MessageSegment{textStart, message.size() - textStart, MessageSegment::kNoArgument};
+  return segments;
+}
+
+}  // namespace detail
+
 template <DiagID Id>
 struct DiagnosticTraits;
 
-#define DIAG(Name, Severity, Message, Args)                          \
-  template <>                                                        \
-  struct DiagnosticTraits<DiagID::Name> {                            \
-    static constexpr DiagSeverity severity = DiagSeverity::Severity; \
-    static constexpr zc::StringPtr message = Message##_zcc;          \
-    static constexpr size_t argCount = Args;                         \
+#define DIAG(Name, Severity, Message, Args)                                                    \
+  template <>                                                                                  \
+  struct DiagnosticTraits<DiagID::Name> {                                                      \
+    static constexpr DiagSeverity severity = DiagSeverity::Severity;                           \
+    static constexpr zc::StringPtr message = Message##_zcc;                                    \
+    static constexpr size_t argCount = Args;                                                   \
+    static_assert(detail::hasConsecutivePlaceholders(message, argCount),                       \
+                  "diagnostic " #Name " needs one placeholder per argument, numbered in order"); \
+    static constexpr auto segments =                                                           \
+        detail::splitMessage<detail::countPlaceholders(message) + 1>(message);                 \
   };
 #include "zomlang/compiler/diagnostics/diagnostics-common.def"
 #include "zomlang/compiler/diagnostics/diagnostics-parse.def"
@@ -52,9 +128,13 @@ constexpr DiagnosticInfo getDiagnosticInfoImpl() {
       DiagnosticTraits<Id>::severity,
       DiagnosticTraits<Id>::message,
       DiagnosticTraits<Id>::argCount,
+      zc::arrayPtr(DiagnosticTraits<Id>::segments.data(), DiagnosticTraits<Id>::segments.size()),
   };
 }
 
+constexpr MessageSegment kUnknownDiagnosticSegments[] = {
+    {0, "Unknown diagnostic"_zcc.size(), MessageSegment::kNoArgument}};
+
 }  // namespace detail
 
 constexpr DiagnosticInfo getDiagnosticInfo(const DiagID id) {
@@ -69,7 +149,8 @@ constexpr DiagnosticInfo getDiagnosticInfo(const DiagID id) {
 #undef DIAG
     default:
       // Handle unknown DiagID
-      return DiagnosticInfo{id, DiagSeverity::kError, "Unknown diagnostic"_zcc, 0};
+      return DiagnosticInfo{id, DiagSeverity::kError, "Unknown diagnostic"_zcc, 0,
+                            detail::kUnknownDiagnosticSegments};
   }
 }
 
@@ -22,6 +22,22 @@ namespace diagnostics {
 
 DiagnosticState::DiagnosticState() {}
 
+DiagnosticState::DiagnosticState(DiagnosticState&& other) noexcept
+    : showDiagnosticsAfterFatalError(other.showDiagnosticsAfterFatalError),
+      suppressWarnings(other.suppressWarnings),
+      hadAnyError(other.getHadAnyError()),
+      hadFatalError(other.getHadFatalError()),
+      ignoredDiagnostics(zc::mv(other.ignoredDiagnostics)) {}
+
+DiagnosticState& DiagnosticState::operator=(DiagnosticState&& other) noexcept {
+  showDiagnosticsAfterFatalError = other.showDiagnosticsAfterFatalError;
+  suppressWarnings = other.suppressWarnings;
+  hadAnyError.store(other.getHadAnyError(), std::memory_order_relaxed);
+  hadFatalError.store(other.getHadFatalError(), std::memory_order_relaxed);
+  ignoredDiagnostics = zc::mv(other.ignoredDiagnostics);
+  return *this;
+}
+
 void DiagnosticState::ignoreDiagnostic(DiagID diagId) { ignoredDiagnostics.upsert(diagId, true); }
 
 bool DiagnosticState::isDiagnosticIgnored(DiagID diagId) const {
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "zc/core/common.h"
 #include "zc/core/map.h"
 #include "zomlang/compiler/source/location.h"
@@ -32,11 +34,11 @@ enum class DiagID : uint32_t;
 class DiagnosticState {
 public:
   DiagnosticState();
-  DiagnosticState(DiagnosticState&&) noexcept = default;
+  DiagnosticState(DiagnosticState&& other) noexcept;
 
   ZC_DISALLOW_COPY(DiagnosticState);
 
-  DiagnosticState& operator=(DiagnosticState&&) noexcept = default;
+  DiagnosticState& operator=(DiagnosticState&& other) noexcept;
 
   bool getShowDiagnosticsAfterFatalError() const { return showDiagnosticsAfterFatalError; }
   void setShowDiagnosticsAfterFatalError(bool value) { showDiagnosticsAfterFatalError = value; }
@@ -47,8 +49,24 @@ public:
   void ignoreDiagnostic(DiagID diag_id);
   bool isDiagnosticIgnored(DiagID diag_id) const;
 
-  bool getHadAnyError() const { return hadAnyError; }
-  void setHadAnyError() { hadAnyError = true; }
+  // The error flags are set by whichever worker reports, and read by the others. Setting a flag
+  // that is already set does not write, so that workers reporting many errors keep sharing the
+  // cache line instead of taking it from each other.
+  bool getHadAnyError() const { return hadAnyError.load(std::memory_order_relaxed); }
+  void setHadAnyError() {
+    if (!getHadAnyError()) { hadAnyError.store(true, std::memory_order_relaxed); }
+  }
+
+  bool getHadFatalError() const { return hadFatalError.load(std::memory_order_relaxed); }
+  void setHadFatalError() {
+    if (!getHadFatalError()) { hadFatalError.store(true, std::memory_order_relaxed); }
+  }
+
+  /// Forget the errors reported so far, e.g. before recompiling the files they were reported in.
+  void resetErrors() {
+    hadAnyError.store(false, std::memory_order_relaxed);
+    hadFatalError.store(false, std::memory_order_relaxed);
+  }
 
   static source::CharSourceRange toCharSourceRange(const source::SourceManager& sm,
                                                    source::SourceRange range);
@@ -57,7 +75,8 @@ public:
 private:
   bool showDiagnosticsAfterFatalError = false;
   bool suppressWarnings = false;
-  bool hadAnyError = false;
+  std::atomic<bool> hadAnyError{false};
+  std::atomic<bool> hadFatalError{false};
   zc::HashMap<DiagID, bool> ignoredDiagnostics;
 };
 
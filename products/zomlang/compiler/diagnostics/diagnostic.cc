@@ -41,6 +41,26 @@ zc::ArrayPtr<const DiagnosticArgument> Diagnostic::getArgs() const {
 }
 zc::ArrayPtr<const source::CharSourceRange> Diagnostic::getRanges() const { return ranges.asPtr(); }
 
+basic::MemoryUsage Diagnostic::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addVector(diagnosticArgs);
+  for (const DiagnosticArgument& arg : diagnosticArgs) {
+    if (arg.is<zc::String>()) { usage.addString(arg.get<zc::String>()); }
+  }
+  usage.addVector(childDiagnostics);
+  for (const zc::Own<Diagnostic>& child : childDiagnostics) {
+    usage.addObject<Diagnostic>();
+    usage += child->getMemoryUsage();
+  }
+  usage.addVector(fixIts);
+  for (const zc::Own<FixIt>& fixIt : fixIts) {
+    usage.addObject<FixIt>();
+    usage.addString(fixIt->replacementText);
+  }
+  usage.addVector(ranges);
+  return usage;
+}
+
 void Diagnostic::addChildDiagnostic(zc::Own<Diagnostic> child) {
   childDiagnostics.add(zc::mv(child));
 }
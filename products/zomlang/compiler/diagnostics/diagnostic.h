@@ -19,6 +19,7 @@
 #include "zc/core/one-of.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 #include "zomlang/compiler/diagnostics/diagnostic-ids.h"
 #include "zomlang/compiler/lexer/token.h"
 #include "zomlang/compiler/source/location.h"
@@ -57,6 +58,8 @@ public:
   ZC_NODISCARD const source::SourceLoc& getLoc() const;
   ZC_NODISCARD zc::ArrayPtr<const DiagnosticArgument> getArgs() const;
   ZC_NODISCARD zc::ArrayPtr<const source::CharSourceRange> getRanges() const;
+  /// \brief Heap memory of the arguments, child diagnostics, fix-its and ranges.
+  ZC_NODISCARD basic::MemoryUsage getMemoryUsage() const;
 
   void addChildDiagnostic(zc::Own<Diagnostic> child);
   void addFixIt(zc::Own<FixIt> fixIt);
@@ -23,49 +23,41 @@ namespace zomlang {
 namespace compiler {
 namespace diagnostics {
 
-// ================================================================================
-// InflightDiagnostic::Impl
-
-struct InFlightDiagnostic::Impl {
-  Impl(DiagnosticEngine& engine, Diagnostic&& diag)
-      : engine(engine), diag(zc::mv(diag)), emitted(false) {}
-
-  DiagnosticEngine& engine;
-  Diagnostic diag;
-  bool emitted;
-};
-
 // ================================================================================
 // InFlightDiagnostic
 
 InFlightDiagnostic::InFlightDiagnostic(DiagnosticEngine& engine, Diagnostic&& diag)
-    : impl(zc::heap<Impl>(engine, zc::mv(diag))) {}
+    : engine(engine), diag(zc::mv(diag)) {}
 
-InFlightDiagnostic::InFlightDiagnostic(InFlightDiagnostic&& other) noexcept = default;
+InFlightDiagnostic::InFlightDiagnostic(DiagnosticEngine& engine) : engine(engine) {}
 
-InFlightDiagnostic::~InFlightDiagnostic() {
-  if (!impl->emitted) { emit(); }
+InFlightDiagnostic::InFlightDiagnostic(InFlightDiagnostic&& other) noexcept
+    : engine(other.engine), diag(zc::mv(other.diag)) {
+  other.diag = zc::none;
 }
 
+InFlightDiagnostic::~InFlightDiagnostic() { emit(); }
+
 void InFlightDiagnostic::emit() {
-  if (!impl->emitted) {
-    impl->engine.emit(impl->diag);
-    impl->emitted = true;
+  ZC_IF_SOME(d, diag) {
+    Diagnostic emitted = zc::mv(d);
+    diag = zc::none;
+    engine.emit(zc::mv(emitted));
   }
 }
 
 InFlightDiagnostic& InFlightDiagnostic::addFixIt(zc::Own<FixIt> fixit) {
-  impl->diag.addFixIt(zc::mv(fixit));
+  ZC_IF_SOME(d, diag) { d.addFixIt(zc::mv(fixit)); }
   return *this;
 }
 
 InFlightDiagnostic& InFlightDiagnostic::addRange(const source::CharSourceRange& range) {
-  impl->diag.addRange(range);
+  ZC_IF_SOME(d, diag) { d.addRange(range); }
   return *this;
 }
 
 InFlightDiagnostic& InFlightDiagnostic::addChild(zc::Own<Diagnostic> child) {
-  impl->diag.addChildDiagnostic(zc::mv(child));
+  ZC_IF_SOME(d, diag) { d.addChildDiagnostic(zc::mv(child)); }
   return *this;
 }
 
@@ -16,6 +16,7 @@
 
 #include "zc/core/common.h"
 #include "zc/core/memory.h"
+#include "zomlang/compiler/diagnostics/diagnostic.h"
 
 namespace zomlang {
 namespace compiler {
@@ -27,12 +28,18 @@ namespace diagnostics {
 
 struct FixIt;
 
-class Diagnostic;
 class DiagnosticEngine;
 
+/// \brief A diagnostic being built, emitted when it goes out of scope.
+///
+/// Holds only the ID, arguments and locations; the message and line and column are worked out by
+/// the consumers that print it. A diagnostic the engine would drop, e.g. while a speculative
+/// parse suppresses diagnostics, holds nothing and ignores what is added to it.
 class InFlightDiagnostic {
 public:
   InFlightDiagnostic(DiagnosticEngine& engine, Diagnostic&& diag);
+  /// A diagnostic that is dropped.
+  explicit InFlightDiagnostic(DiagnosticEngine& engine);
   ~InFlightDiagnostic();
 
   InFlightDiagnostic(InFlightDiagnostic&& other) noexcept;
@@ -48,8 +55,9 @@ public:
   InFlightDiagnostic& addChild(zc::Own<Diagnostic> child);
 
 private:
-  struct Impl;
-  zc::Own<Impl> impl;
+  DiagnosticEngine& engine;
+  /// None once emitted, or if dropped from the start
+  zc::Maybe<Diagnostic> diag;
 };
 
 }  // namespace diagnostics
@@ -0,0 +1,216 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/cache-manager.h"
+
+#include "zc/core/debug.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
+#include "zc/core/refcount.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/ast/compact.h"
+#include "zomlang/compiler/symbol/module-index.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+struct CacheManager::Impl {
+  /// An image in memory, on the heap or mapped, shared with the trees and indexes viewing it.
+  struct Image final : public zc::AtomicRefcounted {
+    explicit Image(zc::Array<const zc::byte> bytes) : bytes(zc::mv(bytes)) {}
+    zc::Array<const zc::byte> bytes;
+  };
+
+  struct Entry {
+    zc::Own<const Image> image;
+    uint64_t lastUse;
+    /// The spill directory holds the image already, so evicting the entry writes nothing
+    bool spilled;
+  };
+
+  /// An entry taken out of memory whose image is still to be written to the spill directory.
+  struct Evicted {
+    zc::String name;
+    zc::Own<const Image> image;
+  };
+
+  struct State {
+    zc::HashMap<zc::String, Entry> hot;
+    /// Names of the hot entries by when they were last used, least recently used first. They
+    /// point into the keys of `hot`.
+    zc::TreeMap<uint64_t, zc::StringPtr> byLastUse;
+    uint64_t clock = 0;
+    Statistics statistics;
+  };
+
+  Impl(size_t budgetBytes, zc::Maybe<zc::Own<const zc::Directory>> spillDir)
+      : budgetBytes(budgetBytes), spillDir(zc::mv(spillDir)) {}
+
+  const size_t budgetBytes;
+  const zc::Maybe<zc::Own<const zc::Directory>> spillDir;
+  zc::MutexGuarded<State> state;
+
+  /// The bytes of `image`, keeping it alive for as long as they are.
+  static zc::Array<const zc::byte> view(const Image& image) {
+    if (image.bytes.size() == 0) { return nullptr; }
+    return image.bytes.asPtr().attach(zc::atomicAddRef(image));
+  }
+
+  static void touch(State& s, zc::HashMap<zc::String, Entry>::Entry& entry) {
+    s.byLastUse.erase(entry.value.lastUse);
+    entry.value.lastUse = s.clock++;
+    s.byLastUse.insert(entry.value.lastUse, entry.key);
+  }
+
+  /// Make `image` the most recently used entry under `name`, then evict the least recently used
+  /// entries until the rest fit the budget. Those still to be written are added to `evicted`.
+  void insert(State& s, zc::StringPtr name, zc::Own<const Image> image, bool spilled,
+              zc::Vector<Evicted>& evicted) {
+    ZC_IF_SOME(old, s.hot.findEntry(name)) {
+      s.statistics.hotBytes -= old.value.image->bytes.size();
+      s.byLastUse.erase(old.value.lastUse);
+      s.hot.erase(old);
+    }
+    s.statistics.hotBytes += image->bytes.size();
+    auto& entry = s.hot.insert(zc::heapString(name), Entry{zc::mv(image), s.clock++, spilled});
+    s.byLastUse.insert(entry.value.lastUse, entry.key);
+
+    while (s.statistics.hotBytes > budgetBytes) {
+      auto& oldest = *s.byLastUse.begin();
+      auto& victim = ZC_ASSERT_NONNULL(s.hot.findEntry(oldest.value));
+      s.statistics.hotBytes -= victim.value.image->bytes.size();
+      ++s.statistics.evictions;
+      if (!victim.value.spilled && spillDir != zc::none) {
+        evicted.add(Evicted{zc::heapString(victim.key), zc::mv(victim.value.image)});
+      }
+      s.byLastUse.erase(oldest);
+      s.hot.erase(victim);
+    }
+    s.statistics.hotEntries = s.hot.size();
+  }
+
+  /// Write evicted images to the spill directory. Runs without the lock: a lookup of an entry
+  /// still being written misses, while the others go on.
+  void spill(zc::ArrayPtr<Evicted> evicted) {
+    ZC_IF_SOME(dir, spillDir) {
+      for (Evicted& entry : evicted) {
+        // Spilling is an optimization; failing to write an entry only loses it.
+        auto maybeException = zc::runCatchingExceptions([&]() {
+          const zc::Path path(zc::mv(entry.name));
+          if (dir->exists(path)) { return; }
+          auto replacer = dir->replaceFile(path, zc::WriteMode::CREATE | zc::WriteMode::MODIFY);
+          replacer->get().writeAll(entry.image->bytes);
+          replacer->commit();
+        });
+        ZC_IF_SOME(exception, maybeException) {
+          ZC_LOG(WARNING, "Failed to spill cache entry", exception);
+        }
+      }
+    }
+  }
+
+  void put(zc::StringPtr name, zc::Array<const zc::byte> bytes) {
+    zc::Vector<Evicted> evicted;
+    insert(*state.lockExclusive(), name, zc::atomicRefcounted<Image>(zc::mv(bytes)),
+           /*spilled*/ false, evicted);
+    spill(evicted);
+  }
+
+  zc::Maybe<zc::Array<const zc::byte>> get(zc::StringPtr name) {
+    {
+      auto s = state.lockExclusive();
+      ZC_IF_SOME(entry, s->hot.findEntry(name)) {
+        touch(*s, entry);
+        ++s->statistics.hits;
+        return view(*entry.value.image);
+      }
+    }
+
+    ZC_IF_SOME(dir, spillDir) {
+      ZC_IF_SOME(file, dir->tryOpenFile(zc::Path(name))) {
+        zc::Own<const Image> image =
+            zc::atomicRefcounted<Image>(file->mmap(0, file->stat().size));
+        zc::Array<const zc::byte> result = view(*image);
+        zc::Vector<Evicted> evicted;
+        {
+          auto s = state.lockExclusive();
+          ++s->statistics.reloads;
+          insert(*s, name, zc::mv(image), /*spilled*/ true, evicted);
+        }
+        spill(evicted);
+        return zc::mv(result);
+      }
+    }
+
+    ++state.lockExclusive()->statistics.misses;
+    return zc::none;
+  }
+};
+
+CacheManager::CacheManager(size_t budgetBytes, zc::Maybe<zc::Own<const zc::Directory>> spillDir)
+    : impl(zc::heap<Impl>(budgetBytes, zc::mv(spillDir))) {}
+CacheManager::~CacheManager() noexcept(false) = default;
+
+bool CacheManager::contains(zc::StringPtr name) const {
+  if (impl->state.lockShared()->hot.find(name) != zc::none) { return true; }
+  ZC_IF_SOME(dir, impl->spillDir) { return dir->exists(zc::Path(name)); }
+  return false;
+}
+
+void CacheManager::putAST(zc::StringPtr name, const ast::CompactTree& tree) {
+  impl->put(name, tree.serialize());
+}
+
+zc::Maybe<ast::CompactTree> CacheManager::getAST(zc::StringPtr name, source::SourceLoc base) {
+  ZC_IF_SOME(image, impl->get(name)) {
+    return ast::CompactTree::deserialize(zc::mv(image), base);
+  }
+  return zc::none;
+}
+
+void CacheManager::putModuleIndex(zc::StringPtr name, const symbol::ModuleIndex& index) {
+  impl->put(name, index.serialize());
+}
+
+zc::Maybe<symbol::ModuleIndex> CacheManager::getModuleIndex(zc::StringPtr name,
+                                                            source::SourceLoc base) {
+  ZC_IF_SOME(image, impl->get(name)) {
+    return symbol::ModuleIndex::deserialize(zc::mv(image), base);
+  }
+  return zc::none;
+}
+
+CacheManager::Statistics CacheManager::getStatistics() const {
+  return impl->state.lockShared()->statistics;
+}
+
+basic::MemoryUsage CacheManager::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  auto s = impl->state.lockShared();
+  usage.addTable(s->hot);
+  usage.addTable(s->byLastUse);
+  for (const auto& entry : s->hot) {
+    usage.addString(entry.key);
+    usage.addObject<Impl::Image>();
+    usage.add(entry.value.image->bytes.size(), entry.value.image->bytes.size());
+  }
+  return usage;
+}
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,106 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zomlang/compiler/basic/memory-usage.h"
+#include "zomlang/compiler/source/location.h"
+
+namespace zc {
+class Directory;
+}  // namespace zc
+
+namespace zomlang {
+namespace compiler {
+
+namespace ast {
+class CompactTree;
+}  // namespace ast
+
+namespace symbol {
+class ModuleIndex;
+}  // namespace symbol
+
+namespace driver {
+
+/// \brief Keeps the binary images of ASTs and module indexes that a long-lived compiler reuses in
+/// memory, up to a budget, and moves the least recently used ones to disk.
+///
+/// Entries are `ast::CompactTree` and `symbol::ModuleIndex` images, in the formats their
+/// `serialize()` writes, so an entry does not depend on the source manager of the compilation
+/// that stored it: every lookup views the image in place, rebased on a location of the caller's.
+/// Once the images in memory exceed the budget, the least recently used are written to the spill
+/// directory, under their names, and dropped. Looking one up again maps its file and makes it hot.
+/// Name entries by what they were built from, as `CompilerDriver` does with the content hash of a
+/// buffer, since a stored entry is never checked against its source.
+///
+/// Safe to use from several threads at once. Trees and indexes returned keep their image alive,
+/// so evicting an entry never invalidates them.
+class CacheManager {
+public:
+  /// \param budgetBytes Bytes the images held in memory may take
+  /// \param spillDir Directory evicted entries are written to and reloaded from. Without one they
+  /// are dropped.
+  CacheManager(size_t budgetBytes, zc::Maybe<zc::Own<const zc::Directory>> spillDir);
+  ~CacheManager() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(CacheManager);
+
+  /// \brief Counters since the manager was created, and what it holds now.
+  struct Statistics {
+    /// Lookups served from memory
+    size_t hits = 0;
+    /// Lookups served by mapping an evicted entry back in
+    size_t reloads = 0;
+    /// Lookups that found no entry
+    size_t misses = 0;
+    /// Entries moved out of memory to stay within the budget
+    size_t evictions = 0;
+    size_t hotEntries = 0;
+    size_t hotBytes = 0;
+  };
+
+  /// \brief Whether an entry named `name` is in memory or can be reloaded from the spill
+  /// directory.
+  bool contains(zc::StringPtr name) const;
+
+  /// \brief Keep the image of `tree` under `name`, a file name, replacing any entry of that name.
+  void putAST(zc::StringPtr name, const ast::CompactTree& tree);
+  /// \brief The tree stored under `name`, with source offsets rebased on `base`.
+  /// \return None if there is no such entry or its image is malformed
+  zc::Maybe<ast::CompactTree> getAST(zc::StringPtr name, source::SourceLoc base);
+
+  /// \brief Keep the image of `index` under `name`, a file name, replacing any entry of that name.
+  void putModuleIndex(zc::StringPtr name, const symbol::ModuleIndex& index);
+  /// \brief The index stored under `name`, with source offsets rebased on `base`.
+  /// \return None if there is no such entry or its image is malformed
+  zc::Maybe<symbol::ModuleIndex> getModuleIndex(zc::StringPtr name, source::SourceLoc base);
+
+  Statistics getStatistics() const;
+
+  /// \brief Measure the images in memory and the tables tracking them. Mapped images are counted
+  /// in full, though the kernel may have paged some of them out.
+  basic::MemoryUsage getMemoryUsage() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,30 +14,270 @@
 
 #include "zomlang/compiler/driver/driver.h"
 
+#include <algorithm>
+
 #include "zc/core/filesystem.h"
 #include "zc/core/map.h"
 #include "zc/core/mutex.h"
+#include "zc/core/time.h"
 #include "zomlang/compiler/ast/ast.h"
 #include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/compact.h"
+#include "zomlang/compiler/ast/debug-table.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/module.h"
 #include "zomlang/compiler/ast/type.h"
 #include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/fingerprint.h"
 #include "zomlang/compiler/basic/frontend.h"
 #include "zomlang/compiler/basic/string-pool.h"
 #include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
 #include "zomlang/compiler/binder/binder.h"
+#include "zomlang/compiler/checker/checker.h"
 #include "zomlang/compiler/diagnostics/consoling-diagnostic-consumer.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 #include "zomlang/compiler/diagnostics/diagnostic-ids.h"
+#include "zomlang/compiler/diagnostics/diagnostic-state.h"
+#include "zomlang/compiler/driver/cache-manager.h"
+#include "zomlang/compiler/driver/time-report.h"
+#include "zomlang/compiler/lexer/import-scan.h"
+#include "zomlang/compiler/lowering/pipeline.h"
+#include "zomlang/compiler/parser/parser.h"
 #include "zomlang/compiler/source/manager.h"
+#include "zomlang/compiler/symbol/scope.h"
 #include "zomlang/compiler/symbol/symbol-table.h"
 
 namespace zomlang {
 namespace compiler {
 namespace driver {
 
+namespace {
+
+/// Name of the AST cache entry for a source buffer: a fingerprint of the image format version,
+/// the language options, and the hash the source manager keeps of the buffer's content, so that
+/// naming an entry does not read the text again.
+zc::String getASTCacheEntryName(const uint64_t contentHash, const basic::LangOptions& langOpts) {
+  const uint64_t hash = basic::Fingerprint()
+                            .add(ast::CompactTree::kFormatVersion)
+                            .add(basic::fingerprint(langOpts))
+                            .add(contentHash)
+                            .get();
+  return zc::str(zc::hex(hash), ".zast");
+}
+
+/// Name of the module index cached for a buffer's content, stored next to its tree by a
+/// `CacheManager`.
+zc::String getModuleIndexEntryName(const uint64_t contentHash,
+                                   const basic::LangOptions& langOpts) {
+  const uint64_t hash = basic::Fingerprint()
+                            .add(symbol::ModuleIndex::kFormatVersion)
+                            .add(basic::fingerprint(langOpts))
+                            .add(contentHash)
+                            .get();
+  return zc::str(zc::hex(hash), ".zidx");
+}
+
+/// Dotted name of the module a path names, e.g. "math.geometry".
+zc::String getModuleName(const ast::ModulePath& path) {
+  zc::Vector<zc::StringPtr> segments;
+  for (const auto& segment : path.getSegments()) { segments.add(segment.getText()); }
+  return zc::strArray(segments, ".");
+}
+
+/// The modules a source file declares and imports, which is all binding it waits on.
+using ModuleInterface = lexer::ModuleImports;
+
+ModuleInterface getModuleInterface(const ast::SourceFile& sourceFile) {
+  ModuleInterface interface;
+  ZC_IF_SOME(declaration, sourceFile.getModuleDeclaration()) {
+    interface.declared = getModuleName(declaration.getModulePath());
+  }
+  for (const auto& statement : sourceFile.getStatements()) {
+    if (ast::isa<ast::ImportDeclaration>(statement)) {
+      interface.imports.add(
+          getModuleName(ast::cast<ast::ImportDeclaration>(statement).getModulePath()));
+    }
+  }
+  return interface;
+}
+
+/// What a tree the driver keeps holds, as measured by its source file.
+basic::MemoryUsage measureAST(const ast::Node& ast) {
+  ZC_IF_SOME(sourceFile, ast::dyn_cast<ast::SourceFile>(ast)) {
+    return sourceFile.getMemoryUsage();
+  }
+  return {};
+}
+
+/// Decides when each file of a pipelined build may be bound.
+///
+/// A file is ready once it is parsed and every module it imports is ready. A module is ready once
+/// the files declaring it that have been parsed are all bound. A module no file declares is ready
+/// once every file is parsed, since only then is it known to come from outside the build. When
+/// nothing is left running but files still wait, they import each other in a cycle and are all
+/// released together.
+class BindSchedule {
+public:
+  explicit BindSchedule(size_t fileCount) {
+    auto locked = state.lockExclusive();
+    for (size_t i = 0; i < fileCount; ++i) { locked->files.add(); }
+    locked->inFlight = fileCount;
+  }
+
+  /// Record that file `index` was parsed, or failed to parse if `interface` is none. Returns the
+  /// files that became ready to bind.
+  zc::Vector<size_t> parsed(size_t index, zc::Maybe<ModuleInterface> interface) {
+    zc::Vector<size_t> ready;
+    auto locked = state.lockExclusive();
+    State& s = *locked;
+    --s.inFlight;
+    ++s.parsedCount;
+    File& file = s.files[index];
+    file.parsed = true;
+
+    ZC_IF_SOME(parsedInterface, interface) {
+      file.interface = zc::mv(parsedInterface);
+      ZC_IF_SOME(declared, file.interface.declared) {
+        Module& module = s.getModule(declared);
+        module.declared = true;
+        ++module.unbound;
+      }
+      tryRelease(s, index, ready);
+    }
+    else {
+      // Nothing to bind
+      file.released = true;
+    }
+
+    if (s.parsedCount == s.files.size()) {
+      // Modules nobody declared are now known to be external
+      for (size_t i = 0; i < s.files.size(); ++i) {
+        if (!s.files[i].released) { tryRelease(s, i, ready); }
+      }
+    }
+    breakCycles(s, ready);
+    return ready;
+  }
+
+  /// Record that file `index` was bound. Returns the files that became ready to bind.
+  zc::Vector<size_t> bound(size_t index) {
+    zc::Vector<size_t> ready;
+    auto locked = state.lockExclusive();
+    State& s = *locked;
+    --s.inFlight;
+
+    ZC_IF_SOME(declared, s.files[index].interface.declared) {
+      Module& module = s.getModule(declared);
+      if (--module.unbound == 0) {
+        zc::Vector<size_t> waiters = zc::mv(module.waiters);
+        for (size_t waiter : waiters) {
+          if (!s.files[waiter].released) { tryRelease(s, waiter, ready); }
+        }
+      }
+    }
+    breakCycles(s, ready);
+    return ready;
+  }
+
+private:
+  struct File {
+    ModuleInterface interface;
+    bool parsed = false;
+    // Handed out to be bound, or nothing to bind
+    bool released = false;
+  };
+
+  struct Module {
+    bool declared = false;
+    // Parsed files declaring the module that are not bound yet
+    size_t unbound = 0;
+    // Files to look at again once the module is ready
+    zc::Vector<size_t> waiters;
+  };
+
+  struct State {
+    zc::Vector<File> files;
+    zc::HashMap<zc::String, Module> modules;
+    size_t parsedCount = 0;
+    // Parses queued or running, plus binds released and not yet finished
+    size_t inFlight = 0;
+
+    Module& getModule(zc::StringPtr name) {
+      return modules.findOrCreate(
+          name, [&]() { return zc::HashMap<zc::String, Module>::Entry{zc::heapString(name), {}}; });
+    }
+
+    bool isReady(zc::StringPtr name) const {
+      ZC_IF_SOME(module, modules.find(name)) {
+        if (module.declared) { return module.unbound == 0; }
+      }
+      return parsedCount == files.size();
+    }
+  };
+
+  zc::MutexGuarded<State> state;
+
+  static void release(State& s, size_t index, zc::Vector<size_t>& ready) {
+    s.files[index].released = true;
+    ++s.inFlight;
+    ready.add(index);
+  }
+
+  /// Release file `index` if all its imports are ready, or wait on the first one that is not.
+  static void tryRelease(State& s, size_t index, zc::Vector<size_t>& ready) {
+    const ModuleInterface& interface = s.files[index].interface;
+    for (const zc::String& import : interface.imports) {
+      // A file importing its own module does not wait for itself
+      bool isOwnModule = false;
+      ZC_IF_SOME(declared, interface.declared) { isOwnModule = declared == import; }
+      if (isOwnModule || s.isReady(import)) { continue; }
+      s.getModule(import).waiters.add(index);
+      return;
+    }
+    release(s, index, ready);
+  }
+
+  static void breakCycles(State& s, zc::Vector<size_t>& ready) {
+    if (s.inFlight > 0) { return; }
+    for (size_t i = 0; i < s.files.size(); ++i) {
+      if (s.files[i].parsed && !s.files[i].released) { release(s, i, ready); }
+    }
+  }
+};
+
+/// Adds the wall and process CPU time from its construction to its destruction to a phase of the
+/// time report.
+class PhaseTimer {
+public:
+  PhaseTimer(zc::Vector<TimeReport::Phase>& phases, zc::StringPtr name)
+      : phases(phases),
+        name(name),
+        wallStart(zc::systemPreciseMonotonicClock().now()),
+        cpuStart(getProcessCpuTime()) {}
+
+  ~PhaseTimer() noexcept(false) {
+    TimeReport::Phase* phase = nullptr;
+    for (TimeReport::Phase& existing : phases) {
+      if (existing.name == name) { phase = &existing; }
+    }
+    if (phase == nullptr) { phase = &phases.add(TimeReport::Phase{name}); }
+    phase->wallTime += zc::systemPreciseMonotonicClock().now() - wallStart;
+    phase->cpuTime += getProcessCpuTime() - cpuStart;
+    ++phase->runs;
+  }
+
+  ZC_DISALLOW_COPY_AND_MOVE(PhaseTimer);
+
+private:
+  zc::Vector<TimeReport::Phase>& phases;
+  zc::StringPtr name;
+  zc::TimePoint wallStart;
+  zc::Duration cpuStart;
+};
+
+}  // namespace
+
 // ================================================================================
 // CompilerDriver::Impl
 
@@ -51,7 +291,12 @@ struct CompilerDriver::Impl {
         symbolTable(zc::heap<symbol::SymbolTable>()) {
     diagnosticEngine->addConsumer(zc::heap<diagnostics::ConsolingDiagnosticConsumer>());
   }
-  ~Impl() noexcept(false) = default;
+  ~Impl() noexcept(false) {
+    if (!compilerOpts.optimization.enableDebugInfo) { return; }
+    for (const auto& entry : *astMutex.lockShared()) {
+      ast::removeFromDebugNodeTable(*entry.value);
+    }
+  }
 
   ZC_DISALLOW_COPY_AND_MOVE(Impl);
 
@@ -77,8 +322,420 @@ struct CompilerDriver::Impl {
   zc::Own<diagnostics::DiagnosticEngine> diagnosticEngine;
   /// Symbol table to manage symbols and scopes.
   zc::Own<symbol::SymbolTable> symbolTable;
+  /// String pools of the buffers parsed with `LangOptions::perBufferStringPools`, declared before
+  /// the ASTs whose strings they hold so that they are destroyed after them.
+  zc::MutexGuarded<zc::Vector<zc::Own<basic::StringPool>>> bufferStringPools;
   /// Mutex-guarded map from BufferId to parsed AST.
   zc::MutexGuarded<zc::HashMap<source::BufferId, zc::Own<ast::Node>>> astMutex;
+  /// Trees replaced by `update()`. Dropped symbols may still point at their nodes, so they are
+  /// kept as long as the driver.
+  zc::Vector<zc::Own<ast::Node>> retiredASTs;
+  /// Buffers bound as they were parsed, which `bindSources()` skips.
+  zc::MutexGuarded<zc::HashSet<source::BufferId>> boundWhileParsing;
+  /// Buffers whose symbols were restored from the module index cached for their content, which
+  /// are never bound.
+  zc::MutexGuarded<zc::HashSet<source::BufferId>> restoredFromIndex;
+  /// Trees of buffers that were bound as they were parsed but then failed to parse. Their symbols
+  /// are dropped once the phase is over, and the trees retired.
+  zc::MutexGuarded<zc::HashMap<source::BufferId, zc::Own<ast::Node>>> failedBoundASTs;
+  /// Mutex-guarded map from BufferId to what parsing it allocated, when statistics are enabled.
+  zc::MutexGuarded<zc::HashMap<source::BufferId, zc::Own<ast::AllocationStats>>> allocationStats;
+  /// Mutex-guarded map from BufferId to the wall time spent lexing and parsing it.
+  zc::MutexGuarded<zc::HashMap<source::BufferId, zc::Duration>> parseTimes;
+  /// Mutex-guarded map from BufferId to the wall time spent binding it.
+  zc::MutexGuarded<zc::HashMap<source::BufferId, zc::Duration>> bindTimes;
+  /// Time spent in each phase so far. Phases run one at a time, so it needs no lock.
+  zc::Vector<TimeReport::Phase> phases;
+  /// Directory binary AST images are cached in, opened on first use.
+  zc::Maybe<zc::Own<const zc::Directory>> astCacheDir;
+  /// Workers shared by every phase, started on first use. Declared last so that its threads are
+  /// joined before anything they use is destroyed.
+  zc::Maybe<zc::Own<basic::ThreadPool>> threadPool;
+  /// Workers owned by whoever created the driver, used instead of starting its own.
+  zc::Maybe<basic::ThreadPool&> sharedThreadPool;
+  /// Cache of binary AST images and module indexes owned by whoever created the driver.
+  zc::Maybe<CacheManager&> cache;
+
+  basic::ThreadPool::Placement getThreadPlacement() const {
+    using ThreadPlacement = basic::CompilerOptions::ParallelOptions::ThreadPlacement;
+    switch (compilerOpts.parallel.threadPlacement) {
+      case ThreadPlacement::kNone:
+        return basic::ThreadPool::Placement::kNone;
+      case ThreadPlacement::kCores:
+        return basic::ThreadPool::Placement::kCores;
+      case ThreadPlacement::kNodes:
+        return basic::ThreadPool::Placement::kNodes;
+    }
+    ZC_UNREACHABLE;
+  }
+
+  basic::ThreadPool& getThreadPool() {
+    ZC_IF_SOME(pool, sharedThreadPool) { return pool; }
+    ZC_IF_SOME(pool, threadPool) { return *pool; }
+    return *threadPool.emplace(zc::heap<basic::ThreadPool>(std::thread::hardware_concurrency(),
+                                                           getThreadPlacement()));
+  }
+
+  zc::Maybe<const zc::Directory&> getASTCacheDir() {
+    if (astCacheDir == zc::none) {
+      ZC_IF_SOME(dir, compilerOpts.emission.astCacheDir) {
+        auto filesystem = zc::newDiskFilesystem();
+        astCacheDir = filesystem->getRoot().openSubdir(
+            filesystem->getCurrentPath().eval(dir),
+            zc::WriteMode::CREATE | zc::WriteMode::MODIFY | zc::WriteMode::CREATE_PARENT);
+      }
+    }
+    ZC_IF_SOME(dir, astCacheDir) { return *dir; }
+    return zc::none;
+  }
+
+  /// Get the managed buffers, largest first. Parse time grows with size, so starting the long
+  /// parses first keeps one big file enqueued last from stretching the phase while the other
+  /// workers sit idle.
+  zc::Vector<source::BufferId> getBufferIdsLargestFirst() const {
+    zc::Vector<source::BufferId> bufferIds = sourceManager->getManagedBufferIds();
+    zc::Vector<zc::Tuple<size_t, source::BufferId>> sized(bufferIds.size());
+    for (const source::BufferId& bufferId : bufferIds) {
+      sized.add(zc::tuple(sourceManager->getEntireTextForBuffer(bufferId).size(), bufferId));
+    }
+    // Stable, so that equal sizes keep the order the files were added in.
+    std::stable_sort(sized.begin(), sized.end(), [](const auto& a, const auto& b) {
+      return zc::get<0>(a) > zc::get<0>(b);
+    });
+    bufferIds.clear();
+    for (const auto& entry : sized) { bufferIds.add(zc::get<1>(entry)); }
+    return bufferIds;
+  }
+
+  /// Binds each top-level statement of a buffer as soon as it is parsed, while its nodes are
+  /// still in cache, instead of walking the finished tree again.
+  class StatementBinder final : public parser::StatementListener {
+  public:
+    StatementBinder(symbol::SymbolTable& symbolTable,
+                    diagnostics::DiagnosticEngine& diagnosticEngine)
+        : binder(symbolTable, diagnosticEngine) {
+      binder.beginSourceFile();
+    }
+
+    void statementParsed(ast::Statement& statement) override { binder.bindStatement(statement); }
+    void parseFailed(zc::Own<ast::Node> tree) override { failedTree = zc::mv(tree); }
+
+    zc::Maybe<zc::Own<ast::Node>> failedTree;
+
+  private:
+    binder::Binder binder;
+  };
+
+  /// Lex and parse one buffer and store its AST. A tree cached for the same content is decoded
+  /// instead of parsing the text again. Safe to call from several workers at once.
+  /// \param bindStatements Bind the buffer while parsing it, as for
+  /// `EmissionOptions::bindWhileParsing`. A tree taken from the cache is left to `bindSources()`,
+  /// unless the cache manager also restores its symbols.
+  /// \return The stored AST, or none if the buffer did not parse
+  zc::Maybe<ast::Node&> parseBuffer(source::BufferId bufferId,
+                                    zc::Maybe<const zc::Directory&> astCacheDir,
+                                    bool bindStatements = false) {
+    zc::Maybe<zc::Own<ast::AllocationStats>> stats;
+    zc::Maybe<ast::AllocationStatsScope> statsScope;
+    if (compilerOpts.emission.astStatisticsEnabled || compilerOpts.emission.timeReportEnabled) {
+      statsScope.emplace(*stats.emplace(zc::heap<ast::AllocationStats>()));
+    }
+
+    const zc::MonotonicClock& clock = zc::systemPreciseMonotonicClock();
+    const zc::TimePoint parseStart = clock.now();
+    // Only trees that parsed without diagnostics are cached, so a hit has none to report.
+    zc::Maybe<zc::Own<ast::Node>> maybeAst = decodeASTCache(astCacheDir, bufferId);
+    const bool fromCache = maybeAst != zc::none;
+    zc::Maybe<StatementBinder> statementBinder;
+    if (!fromCache) {
+      // A pool of the buffer's own saves this worker from contending with the others on every
+      // identifier; it is kept alive for as long as the shared one.
+      basic::StringPool* bufferStringPool = stringPool.get();
+      if (langOpts.perBufferStringPools) {
+        zc::Own<basic::StringPool> bufferPool = zc::heap<basic::StringPool>();
+        bufferStringPool = bufferPool.get();
+        bufferStringPools.lockExclusive()->add(zc::mv(bufferPool));
+      }
+
+      // Perform lexing and parsing for the buffer.
+      zc::Maybe<parser::StatementListener&> listener;
+      if (bindStatements) { listener = statementBinder.emplace(*symbolTable, *diagnosticEngine); }
+      // The phase already started the workers, so large files are split over them too.
+      maybeAst = basic::performParse(*sourceManager, *diagnosticEngine, langOpts,
+                                     *bufferStringPool, bufferId, listener, getThreadPool());
+    }
+    parseTimes.lockExclusive()->upsert(bufferId, clock.now() - parseStart);
+    ZC_IF_SOME(b, statementBinder) {
+      ZC_IF_SOME(tree, b.failedTree) {
+        failedBoundASTs.lockExclusive()->upsert(bufferId, zc::mv(tree));
+      }
+      else if (maybeAst != zc::none) { boundWhileParsing.lockExclusive()->insert(bufferId); }
+    }
+    statsScope = zc::none;
+    ZC_IF_SOME(s, stats) { allocationStats.lockExclusive()->upsert(bufferId, zc::mv(s)); }
+
+    // Store the result if successful
+    ZC_IF_SOME(ast, maybeAst) {
+      if (fromCache && restoreModuleIndex(bufferId, ast::cast<ast::SourceFile>(*ast))) {
+        restoredFromIndex.lockExclusive()->insert(bufferId);
+      }
+      // The caches are an optimization; failing to write them must not fail the build.
+      if (!fromCache && (astCacheDir != zc::none || cache != zc::none)) {
+        auto maybeException =
+            zc::runCatchingExceptions([&]() { writeASTCache(astCacheDir, bufferId, *ast); });
+        ZC_IF_SOME(exception, maybeException) {
+          ZC_LOG(WARNING, "Failed to write AST cache entry", exception);
+        }
+      }
+
+      // The node stays where it is when the map grows, so the reference outlives the lock.
+      ast::Node& result = *ast;
+      if (compilerOpts.optimization.enableDebugInfo) {
+        ast::addToDebugNodeTable(result, sourceManager->getEntireTextForBuffer(bufferId),
+                                 sourceManager->getLocForBufferStart(bufferId));
+      }
+      astMutex.lockExclusive()->upsert(bufferId, zc::mv(ast));
+      return result;
+    }
+    // Errors during parsing should be reported via the DiagnosticEngine
+    return zc::none;
+  }
+
+  /// Lex and parse one buffer for its diagnostics alone, dropping the tree as soon as it is
+  /// built. Safe to call from several workers at once.
+  /// \param pool Interns the buffer's strings, which its buffered diagnostics may point into
+  void checkBufferSyntax(source::BufferId bufferId, basic::StringPool& pool) {
+    basic::performParse(*sourceManager, *diagnosticEngine, langOpts, pool, bufferId, zc::none,
+                        getThreadPool());
+  }
+
+  /// Bind one parsed source file. Safe to call from several workers at once.
+  void bindSourceFile(source::BufferId bufferId, ast::SourceFile& sourceFile) {
+    const zc::MonotonicClock& clock = zc::systemPreciseMonotonicClock();
+    const zc::TimePoint bindStart = clock.now();
+    // Create a binder for this thread
+    binder::Binder binder(*symbolTable, *diagnosticEngine);
+    // Perform binding for the source file
+    binder.bindSourceFile(sourceFile);
+    // Errors during binding should be reported via the DiagnosticEngine
+    bindTimes.lockExclusive()->upsert(bufferId, clock.now() - bindStart);
+  }
+
+  /// Drop the symbols declared in any of `ranges` from the symbol table, so that binding their
+  /// files again does not declare them twice.
+  void dropSymbolsDeclaredIn(zc::ArrayPtr<const source::CharSourceRange> ranges) {
+    auto isDeclaredIn = [&](const symbol::Symbol& symbol) {
+      for (const auto& declaration : symbol.getDeclarationNodes()) {
+        ZC_IF_SOME(node, declaration) {
+          const source::SourceLoc start = node.getSourceRange().getStart();
+          for (const source::CharSourceRange& range : ranges) {
+            if (range.contains(start)) { return true; }
+          }
+          return false;
+        }
+      }
+      return false;
+    };
+
+    // Collected first, since dropping updates the index being iterated. The table only hands out
+    // its symbols as const.
+    zc::Vector<symbol::Symbol*> dropped;
+    for (const symbol::Symbol& symbol : symbolTable->getAllSymbols()) {
+      if (isDeclaredIn(symbol)) { dropped.add(const_cast<symbol::Symbol*>(&symbol)); }
+    }
+    const symbol::Scope& globalScope =
+        ZC_ASSERT_NONNULL(symbolTable->getScopeManager().getGlobalScope());
+    for (symbol::Symbol* symbol : dropped) {
+      ZC_IF_SOME(scope, symbol->getScope()) { symbolTable->dropSymbol(*symbol, scope); }
+      else { symbolTable->dropSymbol(*symbol, globalScope); }
+    }
+  }
+
+  /// Drop the symbols bound from trees that then failed to parse, and retire the trees. Only call
+  /// between phases, since it walks every symbol.
+  void dropFailedBoundASTs() {
+    zc::Vector<source::CharSourceRange> ranges;
+    zc::Vector<zc::Own<ast::Node>> trees;
+    {
+      auto locked = failedBoundASTs.lockExclusive();
+      for (auto& entry : *locked) {
+        ranges.add(sourceManager->getRangeForBuffer(entry.key));
+        trees.add(zc::mv(entry.value));
+      }
+      locked->clear();
+    }
+    if (ranges.empty()) { return; }
+    dropSymbolsDeclaredIn(ranges);
+    for (auto& tree : trees) { retiredASTs.add(zc::mv(tree)); }
+  }
+
+  /// Queue the files of a pipelined build that `schedule` released for binding. Each bind queues
+  /// the files it releases in turn.
+  void bindWhenReady(basic::TaskGroup& group, BindSchedule& schedule,
+                     zc::ArrayPtr<const source::BufferId> bufferIds,
+                     zc::ArrayPtr<zc::Maybe<ast::SourceFile&>> sourceFiles,
+                     zc::Vector<size_t> ready) {
+    for (size_t index : ready) {
+      group.fork([this, &group, &schedule, bufferIds, sourceFiles, index]() -> void {
+        if (!restoredFromIndex.lockShared()->contains(bufferIds[index])) {
+          bindSourceFile(bufferIds[index], ZC_ASSERT_NONNULL(sourceFiles[index]));
+        }
+        stopOnFatalError(group);
+        bindWhenReady(group, schedule, bufferIds, sourceFiles, schedule.bound(index));
+      });
+    }
+  }
+
+  /// Skip the phase's remaining tasks once a fatal error is reported.
+  void stopOnFatalError(basic::TaskGroup& group) {
+    if (diagnosticEngine->hasFatalErrors()) { group.cancel(); }
+  }
+
+  /// Wait for a phase's tasks, then report what they buffered since the phase began. A task that
+  /// threw cancelled the ones not yet started, so the phase fails without finishing them.
+  /// \return True if no task threw and no errors were reported
+  bool finishPhase(basic::TaskGroup& group) {
+    auto maybeException = zc::runCatchingExceptions([&]() { group.join(); });
+    diagnosticEngine->flushBuffered();
+    ZC_IF_SOME(exception, maybeException) {
+      ZC_LOG(ERROR, "Compilation task failed with exception: ", exception.getDescription());
+      return false;
+    }
+    return !diagnosticEngine->hasErrors();
+  }
+
+  /// The binary image cached for a buffer's content, looked up in the cache manager and then in
+  /// `dir`. Thread-safe, as long as `dir` was opened up front.
+  zc::Maybe<ast::CompactTree> loadASTCache(zc::Maybe<const zc::Directory&> dir,
+                                           source::BufferId bufferId) {
+    const zc::String name =
+        getASTCacheEntryName(sourceManager->getContentHash(bufferId), langOpts);
+    const source::SourceLoc base = sourceManager->getLocForBufferStart(bufferId);
+    ZC_IF_SOME(c, cache) {
+      ZC_IF_SOME(tree, c.getAST(name, base)) { return zc::mv(tree); }
+    }
+    ZC_IF_SOME(d, dir) {
+      ZC_IF_SOME(file, d.tryOpenFile(zc::Path(name))) {
+        return ast::CompactTree::deserialize(file->mmap(0, file->stat().size), base);
+      }
+    }
+    return zc::none;
+  }
+
+  /// The tree cached for a buffer's content, rebuilt as an object model. A cache that cannot be
+  /// read, or holds an image that does not decode, counts as a miss.
+  zc::Maybe<zc::Own<ast::Node>> decodeASTCache(zc::Maybe<const zc::Directory&> dir,
+                                               source::BufferId bufferId) {
+    if (dir == zc::none && cache == zc::none) { return zc::none; }
+    zc::Maybe<zc::Own<ast::Node>> result;
+    auto maybeException = zc::runCatchingExceptions([&]() {
+      ZC_IF_SOME(tree, loadASTCache(dir, bufferId)) {
+        // Entries are keyed by content, so the image may come from a file of another name.
+        ZC_IF_SOME(sourceFile,
+                   tree.decodeSourceFile(sourceManager->getIdentifierForBuffer(bufferId))) {
+          result = zc::Own<ast::Node>(zc::mv(sourceFile));
+        }
+      }
+    });
+    ZC_IF_SOME(exception, maybeException) {
+      ZC_LOG(WARNING, "Failed to read AST cache entry", exception);
+    }
+    return result;
+  }
+
+  /// Make the symbols of a file whose tree came from the cache resolvable from the module index
+  /// the cache manager keeps for its content, instead of binding the tree again. Thread-safe.
+  /// \return True if the file declares a module and its index was restored
+  bool restoreModuleIndex(source::BufferId bufferId, const ast::SourceFile& sourceFile) {
+    bool restored = false;
+    ZC_IF_SOME(c, cache) {
+      ZC_IF_SOME(declaration, sourceFile.getModuleDeclaration()) {
+        const zc::String moduleName = getModuleName(declaration.getModulePath());
+        auto maybeException = zc::runCatchingExceptions([&]() {
+          ZC_IF_SOME(index, c.getModuleIndex(getModuleIndexEntryName(
+                                                 sourceManager->getContentHash(bufferId), langOpts),
+                                             sourceManager->getLocForBufferStart(bufferId))) {
+            if (index.getModuleName() != moduleName) { return; }
+            symbolTable->addModuleIndex(zc::mv(index));
+            restored = true;
+          }
+        });
+        ZC_IF_SOME(exception, maybeException) {
+          ZC_LOG(WARNING, "Failed to read module index cache entry", exception);
+        }
+      }
+    }
+    return restored;
+  }
+
+  /// Store in the cache manager the module index of each bound file that declares a module and
+  /// has none stored for its content, so that a later compilation restores the file's symbols
+  /// along with its tree. Only call once every file is bound without errors, since it walks the
+  /// global scope, where the binder declares the symbols of all files.
+  void writeModuleIndexes() {
+    ZC_IF_SOME(c, cache) {
+      zc::Vector<zc::String> names;
+      zc::Vector<zc::String> moduleNames;
+      zc::Vector<symbol::SymbolTable::ModuleExtent> extents;
+      {
+        auto lockedAsts = astMutex.lockShared();
+        auto restored = restoredFromIndex.lockShared();
+        for (const auto& entry : *lockedAsts) {
+          if (restored->contains(entry.key)) { continue; }
+          ZC_IF_SOME(sourceFile, ast::dyn_cast<ast::SourceFile>(*entry.value)) {
+            ZC_IF_SOME(declaration, sourceFile.getModuleDeclaration()) {
+              zc::String name =
+                  getModuleIndexEntryName(sourceManager->getContentHash(entry.key), langOpts);
+              if (c.contains(name)) { continue; }
+              names.add(zc::mv(name));
+              // The string stays where it is when the vector grows, so the extent may point at it.
+              const zc::String& moduleName =
+                  moduleNames.add(getModuleName(declaration.getModulePath()));
+              extents.add(symbol::SymbolTable::ModuleExtent{
+                  moduleName, sourceManager->getRangeForBuffer(entry.key),
+                  sourceManager->getLocForBufferStart(entry.key)});
+            }
+          }
+        }
+      }
+      if (extents.empty()) { return; }
+
+      // The caches are an optimization; failing to write them must not fail the build.
+      auto maybeException = zc::runCatchingExceptions([&]() {
+        const symbol::Scope& globalScope =
+            ZC_ASSERT_NONNULL(symbolTable->getScopeManager().getGlobalScope());
+        zc::Vector<symbol::ModuleIndex> indexes =
+            symbolTable->exportModuleIndexes(globalScope, extents);
+        for (size_t i = 0; i < indexes.size(); ++i) { c.putModuleIndex(names[i], indexes[i]); }
+      });
+      ZC_IF_SOME(exception, maybeException) {
+        ZC_LOG(WARNING, "Failed to write module index cache entry", exception);
+      }
+    }
+  }
+
+  /// Write the binary image of a freshly parsed AST to `dir` and to the cache manager, to each
+  /// unless it holds an image for the same content already.
+  void writeASTCache(zc::Maybe<const zc::Directory&> dir, source::BufferId bufferId,
+                     const ast::Node& ast) {
+    const zc::String name =
+        getASTCacheEntryName(sourceManager->getContentHash(bufferId), langOpts);
+    const zc::Path entry(name);
+    bool writeDir = false;
+    ZC_IF_SOME(d, dir) { writeDir = !d.exists(entry); }
+    bool writeCache = false;
+    ZC_IF_SOME(c, cache) { writeCache = !c.contains(name); }
+    if (!writeDir && !writeCache) { return; }
+
+    const ast::CompactTree tree(ast, sourceManager->getLocForBufferStart(bufferId));
+    if (writeCache) { ZC_ASSERT_NONNULL(cache).putAST(name, tree); }
+    if (writeDir) {
+      auto replacer =
+          ZC_ASSERT_NONNULL(dir).replaceFile(entry, zc::WriteMode::CREATE | zc::WriteMode::MODIFY);
+      replacer->get().writeAll(tree.serialize());
+      replacer->commit();
+    }
+  }
 };
 
 // ================================================================================
@@ -87,15 +744,36 @@ struct CompilerDriver::Impl {
 CompilerDriver::CompilerDriver(const basic::LangOptions& langOpts,
                                const basic::CompilerOptions& compilerOpts) noexcept
     : impl(zc::heap<Impl>(langOpts, compilerOpts)) {}
+CompilerDriver::CompilerDriver(const basic::LangOptions& langOpts,
+                               const basic::CompilerOptions& compilerOpts,
+                               basic::ThreadPool& threadPool) noexcept
+    : impl(zc::heap<Impl>(langOpts, compilerOpts)) {
+  impl->sharedThreadPool = threadPool;
+}
+CompilerDriver::CompilerDriver(const basic::LangOptions& langOpts,
+                               const basic::CompilerOptions& compilerOpts,
+                               basic::ThreadPool& threadPool, CacheManager& cache) noexcept
+    : CompilerDriver(langOpts, compilerOpts, threadPool) {
+  impl->cache = cache;
+}
 CompilerDriver::~CompilerDriver() noexcept(false) = default;
 
 zc::Maybe<source::BufferId> CompilerDriver::addSourceFile(const zc::StringPtr file) {
-  const zc::Maybe<source::BufferId> bufferId =
-      impl->sourceManager->getFileSystemSourceBufferID(file);
-  if (bufferId == zc::none) {
-    impl->diagnosticEngine->diagnose<diagnostics::DiagID::InvalidPath>(source::SourceLoc(), file);
+  return addSourceFiles(zc::arrayPtr(&file, 1))[0];
+}
+
+zc::Vector<zc::Maybe<source::BufferId>> CompilerDriver::addSourceFiles(
+    const zc::ArrayPtr<const zc::StringPtr> files) {
+  PhaseTimer timer(impl->phases, "read");
+  zc::Vector<zc::Maybe<source::BufferId>> bufferIds =
+      impl->sourceManager->getFileSystemSourceBufferIDs(files, impl->getThreadPool());
+  for (size_t i = 0; i < files.size(); ++i) {
+    if (bufferIds[i] == zc::none) {
+      impl->diagnosticEngine->diagnose<diagnostics::DiagID::InvalidPath>(source::SourceLoc(),
+                                                                         files[i]);
+    }
   }
-  return bufferId;
+  return bufferIds;
 }
 
 const diagnostics::DiagnosticEngine& CompilerDriver::getDiagnosticEngine() const {
@@ -111,36 +789,137 @@ const zc::HashMap<source::BufferId, zc::Own<ast::Node>>& CompilerDriver::getASTs
   return *lockedAsts;
 }
 
+zc::Array<zc::String> CompilerDriver::serializeASTs(
+    zc::ConstFunction<zc::String(source::BufferId, const ast::Node&)> serialize) {
+  PhaseTimer timer(impl->phases, "serialize");
+
+  // Slots in the order the files were added, filled largest first like the parse.
+  struct Parsed {
+    source::BufferId bufferId;
+    const ast::Node& ast;
+  };
+  zc::Vector<Parsed> parsed;
+  {
+    auto lockedAsts = impl->astMutex.lockShared();
+    for (const source::BufferId& bufferId : impl->sourceManager->getManagedBufferIds()) {
+      ZC_IF_SOME(ast, lockedAsts->find(bufferId)) { parsed.add(Parsed{bufferId, *ast}); }
+    }
+  }
+  zc::HashMap<source::BufferId, size_t> slots;
+  for (size_t i = 0; i < parsed.size(); ++i) { slots.insert(parsed[i].bufferId, i); }
+
+  zc::Array<zc::String> results = zc::heapArray<zc::String>(parsed.size());
+  basic::TaskGroup group(impl->getThreadPool());
+  for (const source::BufferId& bufferId : impl->getBufferIdsLargestFirst()) {
+    ZC_IF_SOME(slot, slots.find(bufferId)) {
+      group.fork([&serialize, &parsed, &results, slot]() -> void {
+        results[slot] = serialize(parsed[slot].bufferId, parsed[slot].ast);
+      });
+    }
+  }
+  group.join();
+  return results;
+}
+
+zc::Maybe<const ast::AllocationStats&> CompilerDriver::getAllocationStats(
+    source::BufferId bufferId) const {
+  auto lockedStats = impl->allocationStats.lockShared();
+  ZC_IF_SOME(stats, lockedStats->find(bufferId)) { return *stats; }
+  return zc::none;
+}
+
+zc::Maybe<zc::Duration> CompilerDriver::getParseTime(source::BufferId bufferId) const {
+  auto lockedTimes = impl->parseTimes.lockShared();
+  ZC_IF_SOME(time, lockedTimes->find(bufferId)) { return time; }
+  return zc::none;
+}
+
+bool CompilerDriver::checkSyntaxStreaming(const zc::ArrayPtr<const zc::StringPtr> files,
+                                          const size_t window) {
+  ZC_REQUIRE(window > 0, "the streaming window must hold at least one file");
+  bool succeeded = true;
+  for (size_t begin = 0; begin < files.size(); begin += window) {
+    if (impl->diagnosticEngine->hasFatalErrors()) { return false; }
+
+    zc::Vector<source::BufferId> bufferIds;
+    for (const zc::Maybe<source::BufferId>& bufferId :
+         addSourceFiles(files.slice(begin, zc::min(begin + window, files.size())))) {
+      ZC_IF_SOME(id, bufferId) { bufferIds.add(id); }
+      else { succeeded = false; }
+    }
+
+    {
+      PhaseTimer timer(impl->phases, "parse");
+      // The window's strings are pooled apart from the driver's, so that they go with its files.
+      // Buffered diagnostics point into the pool and the text, so both outlive the flush.
+      basic::StringPool windowPool;
+      impl->diagnosticEngine->beginBuffering();
+      basic::TaskGroup group(impl->getThreadPool());
+      for (const source::BufferId& bufferId : bufferIds) {
+        group.fork([this, &group, &windowPool, bufferId]() -> void {
+          impl->checkBufferSyntax(bufferId, windowPool);
+          impl->stopOnFatalError(group);
+        });
+      }
+      succeeded = impl->finishPhase(group) && succeeded;
+    }
+    for (const source::BufferId& bufferId : bufferIds) {
+      impl->sourceManager->releaseBuffer(bufferId);
+    }
+  }
+  return succeeded;
+}
+
+zc::HashMap<source::BufferId, lexer::ModuleImports> CompilerDriver::scanModuleImports() {
+  PhaseTimer timer(impl->phases, "scan-imports");
+  zc::Vector<source::BufferId> bufferIds = impl->getBufferIdsLargestFirst();
+
+  basic::ResultGroup<lexer::ModuleImports> group(impl->getThreadPool());
+  for (const source::BufferId& bufferId : bufferIds) {
+    group.fork([this, bufferId]() {
+      return lexer::scanModuleImports(*impl->sourceManager, *impl->diagnosticEngine,
+                                      impl->langOpts, *impl->stringPool, bufferId);
+    });
+  }
+
+  zc::HashMap<source::BufferId, lexer::ModuleImports> result;
+  zc::Array<zc::Maybe<lexer::ModuleImports>> scanned = group.join();
+  for (size_t i = 0; i < bufferIds.size(); ++i) {
+    result.insert(bufferIds[i], ZC_ASSERT_NONNULL(zc::mv(scanned[i])));
+  }
+  return result;
+}
+
 bool CompilerDriver::parseSources() {
-  // Get BufferIds directly from SourceManager
-  zc::Vector<source::BufferId> bufferIds = impl->sourceManager->getManagedBufferIds();
+  PhaseTimer timer(impl->phases, "parse");
+  zc::Vector<source::BufferId> bufferIds = impl->getBufferIdsLargestFirst();
 
-  basic::ThreadPool threadPool;
+  // Open the cache directory up front so that the workers only read it.
+  zc::Maybe<const zc::Directory&> astCacheDir = impl->getASTCacheDir();
 
+  impl->diagnosticEngine->beginBuffering();
+  basic::TaskGroup group(impl->getThreadPool());
+
+  const bool bindWhileParsing = impl->compilerOpts.emission.bindWhileParsing;
   for (const source::BufferId& bufferId : bufferIds) {  // Iterate over the retrieved vector
-    // Create a thread for each buffer ID
-    threadPool.enqueue([this, bufferId]() -> void {
-      // Perform lexing and parsing for the buffer.
-      zc::Maybe<zc::Own<ast::Node>> maybeAst =
-          basic::performParse(*impl->sourceManager, *impl->diagnosticEngine, impl->langOpts,
-                              *impl->stringPool, bufferId);
-
-      // Store the result if successful
-      ZC_IF_SOME(ast, maybeAst) {
-        // Lock the mutex to safely access the shared map
-        auto lockedAsts = impl->astMutex.lockExclusive();
-        // Insert or update the AST in the map
-        lockedAsts->upsert(bufferId, zc::mv(ast));
-      }
-      // Errors during parsing should be reported via the DiagnosticEngine
+    // Create a task for each buffer ID
+    group.fork([this, &group, bufferId, astCacheDir, bindWhileParsing]() -> void {
+      impl->parseBuffer(bufferId, astCacheDir, bindWhileParsing);
+      impl->stopOnFatalError(group);
     });
   }
 
-  // Return true if no errors were reported
-  return !impl->diagnosticEngine->hasErrors();
+  const bool succeeded = impl->finishPhase(group);
+  impl->dropFailedBoundASTs();
+  return succeeded;
+}
+
+zc::Maybe<ast::CompactTree> CompilerDriver::loadCachedAST(source::BufferId bufferId) {
+  return impl->loadASTCache(impl->getASTCacheDir(), bufferId);
 }
 
 bool CompilerDriver::bindSources() {
+  PhaseTimer timer(impl->phases, "bind");
   // Create a vector of buffer IDs and AST references for binding
   zc::Vector<zc::Tuple<source::BufferId, zc::Maybe<ast::Node&>>> bindingTasks;
 
@@ -156,28 +935,319 @@ bool CompilerDriver::bindSources() {
     // Lock is automatically released when lockedAsts goes out of scope
   }
 
-  basic::ThreadPool threadPool;
+  impl->diagnosticEngine->beginBuffering();
+  basic::TaskGroup group(impl->getThreadPool());
 
   for (const auto& task : bindingTasks) {
-    const source::BufferId& bufferId = zc::get<0>(task);
+    const source::BufferId bufferId = zc::get<0>(task);
     const zc::Maybe<ast::Node&>& maybeAstNode = zc::get<1>(task);
+    if (impl->boundWhileParsing.lockExclusive()->eraseMatch(bufferId) ||
+        impl->restoredFromIndex.lockShared()->contains(bufferId)) {
+      continue;
+    }
 
-    // Create a thread for each AST binding
-    threadPool.enqueue([this, bufferId, &maybeAstNode]() -> void {
+    // Create a task for each AST binding
+    group.fork([this, &group, bufferId, &maybeAstNode]() -> void {
       ZC_IF_SOME(astNode, maybeAstNode) {
         // Cast to SourceFile for binding using type-safe cast
+        impl->bindSourceFile(bufferId, ast::cast<ast::SourceFile>(astNode));
+      }
+      impl->stopOnFatalError(group);
+    });
+  }
+
+  const bool succeeded = impl->finishPhase(group);
+  if (succeeded) { impl->writeModuleIndexes(); }
+  return succeeded;
+}
+
+bool CompilerDriver::parseAndBindSources() {
+  PhaseTimer timer(impl->phases, "parse-and-bind");
+  zc::Vector<source::BufferId> bufferIds = impl->getBufferIdsLargestFirst();
+
+  // Open the cache directory up front so that the workers only read it.
+  zc::Maybe<const zc::Directory&> astCacheDir = impl->getASTCacheDir();
+
+  // Each parse writes its own slot before telling the schedule, which hands the slot to the bind.
+  zc::Array<zc::Maybe<ast::SourceFile&>> sourceFiles =
+      zc::heapArray<zc::Maybe<ast::SourceFile&>>(bufferIds.size());
+  BindSchedule schedule(bufferIds.size());
+  impl->diagnosticEngine->beginBuffering();
+  basic::TaskGroup group(impl->getThreadPool());
+
+  for (size_t index = 0; index < bufferIds.size(); ++index) {
+    const source::BufferId bufferId = bufferIds[index];
+    group.fork([this, &group, &schedule, &bufferIds, &sourceFiles, bufferId, astCacheDir,
+                index]() -> void {
+      zc::Maybe<ModuleInterface> interface;
+      ZC_IF_SOME(astNode, impl->parseBuffer(bufferId, astCacheDir)) {
         auto& sourceFile = ast::cast<ast::SourceFile>(astNode);
-        // Create a binder for this thread
-        binder::Binder binder(*impl->symbolTable, *impl->diagnosticEngine);
-        // Perform binding for the source file
-        binder.bindSourceFile(sourceFile);
+        sourceFiles[index] = sourceFile;
+        interface = getModuleInterface(sourceFile);
+      }
+      impl->stopOnFatalError(group);
+      impl->bindWhenReady(group, schedule, bufferIds, sourceFiles,
+                          schedule.parsed(index, zc::mv(interface)));
+    });
+  }
+
+  // The binds are forked by the tasks before them, so the group finishes only once all are done.
+  const bool succeeded = impl->finishPhase(group);
+  if (succeeded) { impl->writeModuleIndexes(); }
+  return succeeded;
+}
+
+bool CompilerDriver::checkSources() {
+  PhaseTimer timer(impl->phases, "check");
+  zc::Vector<const ast::SourceFile*> files;
+  {
+    auto lockedAsts = impl->astMutex.lockShared();
+    for (const auto& entry : *lockedAsts) {
+      files.add(&ast::cast<ast::SourceFile>(*entry.value));
+    }
+  }
+
+  checker::TypeChecker checker(*impl->diagnosticEngine, impl->getThreadPool());
+  bool succeeded = false;
+  ZC_IF_SOME(exception,
+             zc::runCatchingExceptions([&]() { succeeded = checker.check(files.asPtr()); })) {
+    ZC_LOG(ERROR, "Type checking failed with exception: ", exception.getDescription());
+    return false;
+  }
+  return succeeded;
+}
+
+bool CompilerDriver::lowerSources(lowering::FunctionLowering& lowering,
+                                  lowering::ObjectSink& sink) {
+  PhaseTimer timer(impl->phases, "lower");
+  zc::Vector<zc::String> moduleNames;
+  zc::Vector<lowering::FunctionUnit> units;
+  {
+    auto lockedAsts = impl->astMutex.lockShared();
+    for (const auto& entry : *lockedAsts) {
+      const auto& file = ast::cast<ast::SourceFile>(*entry.value);
+      zc::String moduleName = zc::heapString(file.getFileName());
+      ZC_IF_SOME(declaration, file.getModuleDeclaration()) {
+        zc::Vector<zc::StringPtr> segments;
+        for (const auto& segment : declaration.getModulePath().getSegments()) {
+          segments.add(segment.getText());
+        }
+        moduleName = zc::strArray(segments, ".");
+      }
+      const zc::StringPtr name = moduleNames.add(zc::mv(moduleName));
+      for (const auto& statement : file.getStatements()) {
+        if (ast::isa<ast::FunctionDeclaration>(statement)) {
+          units.add(lowering::FunctionUnit{ast::cast<ast::FunctionDeclaration>(statement), name});
+        }
+      }
+    }
+  }
+
+  lowering::LoweringPipeline pipeline(impl->getThreadPool(), lowering, sink);
+  ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() { pipeline.run(units.asPtr()); })) {
+    ZC_LOG(ERROR, "Lowering failed with exception: ", exception.getDescription());
+    return false;
+  }
+  return true;
+}
+
+bool CompilerDriver::update(zc::ArrayPtr<const zc::StringPtr> changedPaths) {
+  // Reread the files; those whose content is the same are left alone.
+  zc::Vector<source::BufferId> replaced;
+  zc::Vector<source::BufferId> reparsed;
+  zc::Maybe<PhaseTimer> readTimer;
+  readTimer.emplace(impl->phases, "read");
+  for (const zc::StringPtr path : changedPaths) {
+    const zc::Maybe<source::BufferId> before =
+        impl->sourceManager->findFileSystemSourceBufferID(path);
+    const zc::Maybe<source::BufferId> after =
+        impl->sourceManager->reloadFileSystemSourceBuffer(path);
+    if (before == after) { continue; }
+    ZC_IF_SOME(bufferId, before) { replaced.add(bufferId); }
+    ZC_IF_SOME(bufferId, after) { reparsed.add(bufferId); }
+  }
+  readTimer = zc::none;
+  if (replaced.empty() && reparsed.empty()) { return true; }
+
+  // Errors reported so far were reported against the trees being replaced or already shown.
+  impl->diagnosticEngine->getState().resetErrors();
+
+  // Modules whose symbols may change; files importing them are rebound.
+  zc::HashSet<zc::String> changedModules;
+  auto addChangedModule = [&](zc::String name) {
+    if (!changedModules.contains(name)) { changedModules.insert(zc::mv(name)); }
+  };
+  zc::Vector<source::CharSourceRange> droppedRanges;
+  {
+    auto lockedAsts = impl->astMutex.lockExclusive();
+    for (const source::BufferId& bufferId : replaced) {
+      droppedRanges.add(impl->sourceManager->getRangeForBuffer(bufferId));
+      ZC_IF_SOME(entry, lockedAsts->findEntry(bufferId)) {
+        ModuleInterface interface = getModuleInterface(ast::cast<ast::SourceFile>(*entry.value));
+        ZC_IF_SOME(declared, interface.declared) { addChangedModule(zc::mv(declared)); }
+        if (impl->compilerOpts.optimization.enableDebugInfo) {
+          ast::removeFromDebugNodeTable(*entry.value);
+        }
+        auto released = lockedAsts->release(entry);
+        impl->retiredASTs.add(zc::mv(released.value));
       }
-      // Errors during binding should be reported via the DiagnosticEngine
+      impl->allocationStats.lockExclusive()->erase(bufferId);
+      impl->parseTimes.lockExclusive()->erase(bufferId);
+      impl->bindTimes.lockExclusive()->erase(bufferId);
+    }
+  }
+
+  const zc::Maybe<const zc::Directory&> astCacheDir = impl->getASTCacheDir();
+  bool succeeded;
+  {
+    PhaseTimer timer(impl->phases, "parse");
+    impl->diagnosticEngine->beginBuffering();
+    basic::TaskGroup group(impl->getThreadPool());
+    for (const source::BufferId& bufferId : reparsed) {
+      group.fork([this, &group, bufferId, astCacheDir]() -> void {
+        impl->parseBuffer(bufferId, astCacheDir);
+        impl->stopOnFatalError(group);
+      });
+    }
+    succeeded = impl->finishPhase(group);
+  }
+
+  // The new trees are bound, and so is every file importing a changed module, directly or
+  // through other such files.
+  zc::Vector<zc::Tuple<source::BufferId, ast::SourceFile*>> rebound;
+  {
+    struct Unchanged {
+      ast::SourceFile& sourceFile;
+      source::BufferId bufferId;
+      ModuleInterface interface;
+      bool affected = false;
+    };
+    zc::Vector<Unchanged> unchanged;
+    auto lockedAsts = impl->astMutex.lockShared();
+    for (const auto& entry : *lockedAsts) {
+      auto& sourceFile = ast::cast<ast::SourceFile>(const_cast<ast::Node&>(*entry.value));
+      ModuleInterface interface = getModuleInterface(sourceFile);
+      if (std::find(reparsed.begin(), reparsed.end(), entry.key) != reparsed.end()) {
+        ZC_IF_SOME(declared, interface.declared) { addChangedModule(zc::mv(declared)); }
+        rebound.add(zc::tuple(entry.key, &sourceFile));
+      } else {
+        unchanged.add(Unchanged{sourceFile, entry.key, zc::mv(interface)});
+      }
+    }
+
+    for (bool grew = true; grew;) {
+      grew = false;
+      for (Unchanged& file : unchanged) {
+        if (file.affected) { continue; }
+        for (const zc::String& import : file.interface.imports) {
+          if (changedModules.contains(import)) {
+            file.affected = true;
+            break;
+          }
+        }
+        if (!file.affected) { continue; }
+        grew = true;
+        ZC_IF_SOME(declared, file.interface.declared) { addChangedModule(zc::mv(declared)); }
+        droppedRanges.add(impl->sourceManager->getRangeForBuffer(file.bufferId));
+        rebound.add(zc::tuple(file.bufferId, &file.sourceFile));
+      }
+    }
+  }
+
+  PhaseTimer timer(impl->phases, "bind");
+  impl->dropSymbolsDeclaredIn(droppedRanges);
+
+  impl->diagnosticEngine->beginBuffering();
+  basic::TaskGroup group(impl->getThreadPool());
+  for (const auto& file : rebound) {
+    const source::BufferId bufferId = zc::get<0>(file);
+    ast::SourceFile* sourceFile = zc::get<1>(file);
+    group.fork([this, &group, bufferId, sourceFile]() -> void {
+      impl->bindSourceFile(bufferId, *sourceFile);
+      impl->stopOnFatalError(group);
     });
   }
+  return impl->finishPhase(group) && succeeded;
+}
+
+TimeReport CompilerDriver::getTimeReport() const {
+  TimeReport report;
+  for (const TimeReport::Phase& phase : impl->phases) { report.phases.add(phase); }
+
+  {
+    auto lockedStats = impl->allocationStats.lockShared();
+    auto lockedParseTimes = impl->parseTimes.lockShared();
+    auto lockedBindTimes = impl->bindTimes.lockShared();
+    for (const source::BufferId& bufferId : impl->sourceManager->getManagedBufferIds()) {
+      TimeReport::File& file = report.files.add();
+      file.name = zc::str(impl->sourceManager->getIdentifierForBuffer(bufferId));
+      file.sourceBytes = impl->sourceManager->getEntireTextForBuffer(bufferId).size();
+      file.parseTime = lockedParseTimes->find(bufferId);
+      file.bindTime = lockedBindTimes->find(bufferId);
+      ZC_IF_SOME(stats, lockedStats->find(bufferId)) {
+        const size_t bytes = stats->getTotal().bytes + stats->getUnattributedBytes();
+        file.astBytes = bytes;
+        report.astBytes += bytes;
+      }
+    }
+  }
+
+  basic::StringPool::Usage usage = impl->stringPool->getUsage();
+  for (const zc::Own<basic::StringPool>& pool : *impl->bufferStringPools.lockShared()) {
+    const basic::StringPool::Usage bufferUsage = pool->getUsage();
+    usage.strings += bufferUsage.strings;
+    usage.bytes += bufferUsage.bytes;
+  }
+  report.internedStrings = usage.strings;
+  report.internedBytes = usage.bytes;
+  report.symbols = impl->symbolTable->getSymbolCount();
+  report.peakResidentBytes = getPeakResidentBytes();
+  return report;
+}
+
+MemoryReport CompilerDriver::getMemoryUsage() const {
+  MemoryReport report;
+  report.stringPools = impl->stringPool->getMemoryUsage();
+  {
+    auto lockedPools = impl->bufferStringPools.lockShared();
+    report.stringPools.addVector(*lockedPools);
+    for (const zc::Own<basic::StringPool>& pool : *lockedPools) {
+      report.stringPools.addObject<basic::StringPool>();
+      report.stringPools += pool->getMemoryUsage();
+    }
+  }
+  report.sources = impl->sourceManager->getMemoryUsage();
+  report.diagnostics = impl->diagnosticEngine->getMemoryUsage();
+  report.symbols = impl->symbolTable->getMemoryUsage();
+  report.scopes = impl->symbolTable->getScopeManager().getMemoryUsage();
+
+  {
+    auto lockedASTs = impl->astMutex.lockShared();
+    report.asts.addTable(*lockedASTs);
+    for (const source::BufferId& bufferId : impl->sourceManager->getManagedBufferIds()) {
+      ZC_IF_SOME(ast, lockedASTs->find(bufferId)) {
+        MemoryReport::File& file = report.files.add();
+        file.name = zc::str(impl->sourceManager->getIdentifierForBuffer(bufferId));
+        file.ast = measureAST(*ast);
+      }
+    }
+    // Every tree counts toward the total; those of buffers no longer managed have no file.
+    for (const auto& entry : *lockedASTs) { report.asts += measureAST(*entry.value); }
+  }
+  report.asts.addVector(impl->retiredASTs);
+  for (const zc::Own<ast::Node>& ast : impl->retiredASTs) { report.asts += measureAST(*ast); }
+  {
+    auto lockedFailed = impl->failedBoundASTs.lockShared();
+    report.asts.addTable(*lockedFailed);
+    for (const auto& entry : *lockedFailed) { report.asts += measureAST(*entry.value); }
+  }
+  return report;
+}
 
-  // Return true if no errors were reported
-  return !impl->diagnosticEngine->hasErrors();
+zc::Maybe<basic::MemoryUsage> CompilerDriver::getASTMemoryUsage(source::BufferId bufferId) const {
+  auto lockedASTs = impl->astMutex.lockShared();
+  ZC_IF_SOME(ast, lockedASTs->find(bufferId)) { return measureAST(*ast); }
+  return zc::none;
 }
 
 const symbol::SymbolTable& CompilerDriver::getSymbolTable() const { return *impl->symbolTable; }
@@ -14,11 +14,15 @@
 
 #pragma once
 
+#include "zc/core/function.h"
 #include "zc/core/map.h"
 #include "zc/core/memory.h"
 #include "zc/core/string.h"
+#include "zc/core/time.h"
 #include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/driver/time-report.h"
 
 namespace zomlang {
 namespace compiler {
@@ -33,24 +37,79 @@ class DiagnosticEngine;
 }  // namespace diagnostics
 
 namespace ast {
+class AllocationStats;
+class CompactTree;
 class Node;
 class SourceFile;
 }  // namespace ast
 
+namespace lexer {
+struct ModuleImports;
+}  // namespace lexer
+
+namespace lowering {
+class FunctionLowering;
+class ObjectSink;
+}  // namespace lowering
+
 namespace symbol {
 class SymbolTable;
 }
 
 namespace basic {
 class StringPool;
+class ThreadPool;
 }  // namespace basic
 
 namespace driver {
 
+class CacheManager;
+
+/// \brief What the subsystems of a driver hold, as returned by `CompilerDriver::getMemoryUsage()`.
+struct MemoryReport {
+  struct File {
+    zc::String name;
+    basic::MemoryUsage ast;
+  };
+
+  /// The shared pool and those of buffers parsed with `LangOptions::perBufferStringPools`
+  basic::MemoryUsage stringPools;
+  basic::MemoryUsage sources;
+  basic::MemoryUsage diagnostics;
+  /// The symbol table, without its scopes
+  basic::MemoryUsage symbols;
+  basic::MemoryUsage scopes;
+  /// Every tree the driver keeps, those replaced by `update()` included
+  basic::MemoryUsage asts;
+  /// The tree of each parsed buffer, in the order the files were added
+  zc::Vector<File> files;
+
+  basic::MemoryUsage getTotal() const {
+    basic::MemoryUsage total = stringPools;
+    total += sources;
+    total += diagnostics;
+    total += symbols;
+    total += scopes;
+    total += asts;
+    return total;
+  }
+};
+
 class CompilerDriver {
 public:
   CompilerDriver(const basic::LangOptions& langOpts,
                  const basic::CompilerOptions& compilerOpts) noexcept;
+  /// Runs the phases on `threadPool` instead of starting workers of its own, so that a
+  /// long-lived process keeps them across compilations.
+  CompilerDriver(const basic::LangOptions& langOpts, const basic::CompilerOptions& compilerOpts,
+                 basic::ThreadPool& threadPool) noexcept;
+  /// Like the overload above, and also stores the binary image of every tree it parses in
+  /// `cache`, where `parseSources()` and `loadCachedAST()` look first, so that later compilations
+  /// find them. Binding stores the symbols of each file declaring a module there too, as a
+  /// `symbol::ModuleIndex`; a file whose tree and index are both found is neither parsed nor
+  /// bound, and its symbols are resolved by qualified name from the index.
+  CompilerDriver(const basic::LangOptions& langOpts, const basic::CompilerOptions& compilerOpts,
+                 basic::ThreadPool& threadPool, CacheManager& cache) noexcept;
   ~CompilerDriver() noexcept(false);
 
   /// Add a source file to the compiler.
@@ -58,23 +117,111 @@ public:
   /// \return The buffer ID of the added file, or none if the file could not be added
   zc::Maybe<source::BufferId> addSourceFile(zc::StringPtr file);
 
+  /// Add several source files, reading them in parallel.
+  /// \param files The paths to the source files to add
+  /// \return The buffer ID of each file, in the order of `files`, or none for those that could not
+  /// be added
+  zc::Vector<zc::Maybe<source::BufferId>> addSourceFiles(zc::ArrayPtr<const zc::StringPtr> files);
+
   /// Get the diagnostic engine used by the compiler.
   /// \return A reference to the diagnostic engine
   const diagnostics::DiagnosticEngine& getDiagnosticEngine() const;
   diagnostics::DiagnosticEngine& getDiagnosticEngine();
 
-  /// Parses all added source files into ASTs.
+  /// Checks the syntax of `files` without keeping them, for validating more files than fit in
+  /// memory at once. `window` files at a time are read, parsed in parallel and have their
+  /// diagnostics reported, after which their text, trees and strings are released before the next
+  /// ones are read, so peak memory follows the window rather than the number of files. The files
+  /// must not have been added before, and are not listed by `getASTs()` or the time report after.
+  /// \return True if every file was read and parsed without errors, false otherwise.
+  bool checkSyntaxStreaming(zc::ArrayPtr<const zc::StringPtr> files, size_t window);
+
+  /// Finds the module each added file declares and the modules it imports from their tokens
+  /// alone, lexing the files in parallel without parsing any of them. This gives the whole module
+  /// graph before parsing starts, e.g. to order the files or to tell which import a changed one.
+  /// See `lexer::scanModuleImports()`.
+  /// \return The declared and imported modules of each added buffer
+  zc::HashMap<source::BufferId, lexer::ModuleImports> scanModuleImports();
+
+  /// Parses all added source files into ASTs, largest first so that the longest parses do not
+  /// start last. A file whose content has a tree in the `CacheManager` or
+  /// `EmissionOptions::astCacheDir` is rebuilt from it instead of being parsed.
+  /// With `EmissionOptions::bindWhileParsing`, each file is also bound as it is parsed; the
+  /// symbols of a file that then fails to parse are dropped.
   /// \return True if parsing succeeded without fatal errors, false otherwise.
   bool parseSources();
 
-  /// Binds all parsed ASTs to create symbols and perform semantic analysis.
+  /// Loads the binary AST image cached for a source buffer by an earlier `parseSources()` run with
+  /// a `CacheManager` or `EmissionOptions::astCacheDir` set. The image is viewed in place, in
+  /// memory or memory-mapped.
+  /// \param bufferId The buffer whose content keys the cache entry
+  /// \return The cached tree, or none if caching is off or no valid image matches the content
+  zc::Maybe<ast::CompactTree> loadCachedAST(source::BufferId bufferId);
+
+  /// Binds all parsed ASTs to create symbols and perform semantic analysis. Files bound while
+  /// they were parsed, or whose symbols were restored from a `CacheManager`, are skipped.
   /// \return True if binding succeeded without fatal errors, false otherwise.
   bool bindSources();
 
+  /// Parses and binds all added source files as one pipeline, with no barrier between the phases.
+  /// A file is bound as soon as it is parsed and the modules it imports are bound, while other
+  /// files are still being parsed. Import cycles are bound together once nothing else can run.
+  /// \return True if parsing and binding succeeded without fatal errors, false otherwise.
+  bool parseAndBindSources();
+
+  /// Type checks the parsed and bound ASTs as one program: the module-level signatures first,
+  /// then every function body in parallel. See `checker::TypeChecker`.
+  /// \return True if checking succeeded without errors, false otherwise.
+  bool checkSources();
+
+  /// Lowers the module-level functions of the parsed ASTs with `lowering`, each in parallel with
+  /// the others, and streams their objects to `sink` as they are emitted. See
+  /// `lowering::LoweringPipeline`.
+  /// \return True if every function was lowered and the sink finished, false otherwise.
+  bool lowerSources(lowering::FunctionLowering& lowering, lowering::ObjectSink& sink);
+
+  /// Brings the parsed and bound files up to date after some changed on disk, e.g. as reported
+  /// by a `FileWatcher`. Each file whose content changed is reread, reparsed and bound again once
+  /// its old symbols are dropped; so is every file importing a module it declares, directly or
+  /// through other such files. Paths never added before are added, and deleted files dropped.
+  /// \return True if the files reparsed and rebound had no errors, false otherwise.
+  bool update(zc::ArrayPtr<const zc::StringPtr> changedPaths);
+
   /// Get the parsed ASTs
   /// \return A reference to the map of buffer IDs to AST nodes
   const zc::HashMap<source::BufferId, zc::Own<ast::Node>>& getASTs() const;
 
+  /// Runs `serialize` on every parsed AST, in parallel with the others and the largest first, e.g.
+  /// to dump each into a buffer of its own. `serialize` is called from several threads at once.
+  /// \return What `serialize` returned for each parsed buffer, in the order the files were added,
+  /// so output concatenated from it does not depend on which file finished first
+  zc::Array<zc::String> serializeASTs(
+      zc::ConstFunction<zc::String(source::BufferId, const ast::Node&)> serialize);
+
+  /// Get what was allocated while parsing a buffer.
+  /// \return The statistics, or none unless `EmissionOptions::astStatisticsEnabled` was set when
+  /// the buffer was parsed
+  zc::Maybe<const ast::AllocationStats&> getAllocationStats(source::BufferId bufferId) const;
+
+  /// Get the wall time spent lexing and parsing a buffer, to find the files that dominate the
+  /// parse phase.
+  /// \return The time, or none if the buffer has not been parsed
+  zc::Maybe<zc::Duration> getParseTime(source::BufferId bufferId) const;
+
+  /// Get where the phases run so far spent their time, with per-file times and memory use. AST
+  /// bytes are only known with `EmissionOptions::timeReportEnabled` or `astStatisticsEnabled`
+  /// set during parsing.
+  TimeReport getTimeReport() const;
+
+  /// Measure what the string pools, source manager, diagnostic engine, symbol table, scopes and
+  /// ASTs hold, e.g. to decide what to evict under a memory budget. See `basic::MemoryUsage` and
+  /// `ast::SourceFile::getMemoryUsage()` for what is left out. Must not run during a phase.
+  MemoryReport getMemoryUsage() const;
+
+  /// Measure the AST of one buffer, as counted in `getMemoryUsage()`.
+  /// \return The usage, or none if the buffer has no AST
+  zc::Maybe<basic::MemoryUsage> getASTMemoryUsage(source::BufferId bufferId) const;
+
   /// Get the symbol table used by the compiler.
   /// \return A reference to the symbol table
   const symbol::SymbolTable& getSymbolTable() const;
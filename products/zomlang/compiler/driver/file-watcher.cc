@@ -0,0 +1,139 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/file-watcher.h"
+
+#if __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#include "zc/async/async-unix.h"
+#include "zc/core/debug.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/map.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+#if __linux__
+
+struct FileWatcher::Impl {
+  zc::OwnFd fd;
+  zc::UnixEventPort::FdObserver observer;
+  zc::Own<zc::Filesystem> filesystem = zc::newDiskFilesystem();
+
+  /// Absolute path of each watched file, to the path it was watched under
+  zc::HashMap<zc::String, zc::String> files;
+  /// Watched directories by watch descriptor, and the other way around
+  zc::HashMap<int, zc::String> directories;
+  zc::HashMap<zc::String, int> descriptors;
+
+  /// Changes read but not reported yet, in the order they were seen
+  zc::Vector<zc::String> pending;
+
+  Impl(zc::UnixEventPort& eventPort, int fd)
+      : fd(fd), observer(eventPort, fd, zc::UnixEventPort::FdObserver::OBSERVE_READ) {}
+
+  static int openInotify() {
+    int fd;
+    ZC_SYSCALL(fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+    return fd;
+  }
+
+  void watch(zc::StringPtr path) {
+    const zc::Path absolute = filesystem->getCurrentPath().evalNative(path);
+    const zc::String directory = absolute.parent().toString(true);
+    if (descriptors.find(directory) == zc::none) {
+      int wd;
+      ZC_SYSCALL(wd = inotify_add_watch(fd, directory.cStr(),
+                                        IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+                                            IN_MOVED_TO | IN_ONLYDIR),
+                 directory);
+      directories.upsert(wd, zc::heapString(directory));
+      descriptors.upsert(zc::heapString(directory), wd);
+    }
+    files.upsert(absolute.toString(true), zc::heapString(path));
+  }
+
+  /// Read every queued event, noting the watched files they concern.
+  void drain() {
+    alignas(struct inotify_event) char buffer[4096];
+    while (true) {
+      ssize_t n;
+      ZC_NONBLOCKING_SYSCALL(n = read(fd, buffer, sizeof(buffer)));
+      if (n <= 0) { return; }  // EAGAIN once the queue is empty
+
+      for (const char* p = buffer; p < buffer + n;) {
+        const auto& event = *reinterpret_cast<const struct inotify_event*>(p);
+        p += sizeof(struct inotify_event) + event.len;
+        if (event.len == 0) { continue; }
+        ZC_IF_SOME(directory, directories.find(event.wd)) {
+          ZC_IF_SOME(original, files.find(zc::str(directory, '/', event.name))) {
+            bool seen = false;
+            for (const zc::String& change : pending) { seen = seen || change == original; }
+            if (!seen) { pending.add(zc::heapString(original)); }
+          }
+        }
+      }
+    }
+  }
+};
+
+FileWatcher::FileWatcher(zc::UnixEventPort& eventPort)
+    : impl(zc::heap<Impl>(eventPort, Impl::openInotify())) {}
+
+#else
+
+struct FileWatcher::Impl {
+  void watch(zc::StringPtr path) {}
+  void drain() {}
+  zc::Vector<zc::String> pending;
+};
+
+FileWatcher::FileWatcher(zc::UnixEventPort& eventPort) {
+  ZC_UNIMPLEMENTED("FileWatcher is only implemented on Linux");
+}
+
+#endif
+
+FileWatcher::~FileWatcher() noexcept(false) = default;
+
+void FileWatcher::watch(zc::StringPtr path) { impl->watch(path); }
+
+zc::Promise<zc::Vector<zc::String>> FileWatcher::whenChanged(zc::Timer& timer,
+                                                             zc::Duration settle) {
+#if __linux__
+  return impl->observer.whenBecomesReadable().then(
+      [this, &timer, settle]() -> zc::Promise<zc::Vector<zc::String>> {
+        impl->drain();
+        // Only other files in the watched directories changed
+        if (impl->pending.empty()) { return whenChanged(timer, settle); }
+        return timer.afterDelay(settle).then([this]() {
+          impl->drain();
+          return zc::mv(impl->pending);
+        });
+      });
+#else
+  return zc::Vector<zc::String>();
+#endif
+}
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,63 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/async/async.h"
+#include "zc/async/timer.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/core/time.h"
+#include "zc/core/vector.h"
+
+namespace zc {
+class UnixEventPort;
+}  // namespace zc
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+/// \brief Reports changes to source files, for feeding `CompilerDriver::update()`.
+///
+/// Uses inotify on the directories holding the watched files rather than on the files, so that an
+/// editor saving by renaming a new file over the old one is seen too. Events arrive through the
+/// `zc::UnixEventPort` of the thread's event loop. Only available on Linux; constructing one
+/// elsewhere throws.
+class FileWatcher {
+public:
+  explicit FileWatcher(zc::UnixEventPort& eventPort);
+  ~FileWatcher() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(FileWatcher);
+
+  /// Report changes to the file at `path`, relative to the working directory. The file need not
+  /// exist yet, but its directory must.
+  void watch(zc::StringPtr path);
+
+  /// Wait until a watched file is written, created, renamed over or deleted, then for `settle` to
+  /// pass, so that a save or a checkout touching several files is reported once.
+  /// \return The changed files, as passed to `watch()`
+  zc::Promise<zc::Vector<zc::String>> whenChanged(zc::Timer& timer,
+                                                  zc::Duration settle = 20 * zc::MILLISECONDS);
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,169 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/time-report.h"
+
+#if !_WIN32
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include <algorithm>
+
+#include "zc/core/debug.h"
+#include "zomlang/compiler/basic/string-escape.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+namespace {
+
+/// Milliseconds with three decimals, e.g. "12.045".
+zc::String formatMilliseconds(zc::Duration duration) {
+  const int64_t us = duration / zc::MICROSECONDS;
+  const int64_t fraction = us % 1000;
+  return zc::str(us / 1000, '.', fraction < 100 ? "0" : "", fraction < 10 ? "0" : "", fraction);
+}
+
+zc::String padLeft(zc::StringPtr text, size_t width) {
+  if (text.size() >= width) { return zc::str(text); }
+  return zc::str(zc::repeat(' ', width - text.size()), text);
+}
+
+zc::String padRight(zc::StringPtr text, size_t width) {
+  if (text.size() >= width) { return zc::str(text); }
+  return zc::str(text, zc::repeat(' ', width - text.size()));
+}
+
+zc::Duration getTotalTime(const TimeReport::File& file) {
+  return file.parseTime.orDefault(0 * zc::NANOSECONDS) +
+         file.bindTime.orDefault(0 * zc::NANOSECONDS);
+}
+
+zc::String formatMaybeMilliseconds(const zc::Maybe<zc::Duration>& duration) {
+  ZC_IF_SOME(d, duration) { return formatMilliseconds(d); }
+  return zc::str("-");
+}
+
+zc::String formatMaybeMicroseconds(const zc::Maybe<zc::Duration>& duration) {
+  ZC_IF_SOME(d, duration) { return zc::str(d / zc::MICROSECONDS); }
+  return zc::str("null");
+}
+
+}  // namespace
+
+zc::Duration getProcessCpuTime() {
+#if !_WIN32
+  struct timespec ts;
+  ZC_SYSCALL(clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts));
+  return ts.tv_sec * zc::SECONDS + ts.tv_nsec * zc::NANOSECONDS;
+#else
+  return 0 * zc::NANOSECONDS;
+#endif
+}
+
+size_t getPeakResidentBytes() {
+#if !_WIN32
+  struct rusage usage;
+  ZC_SYSCALL(getrusage(RUSAGE_SELF, &usage));
+#if __APPLE__
+  return usage.ru_maxrss;
+#else
+  // Reported in kilobytes
+  return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+zc::String timeReportToText(const TimeReport& report) {
+  zc::Vector<zc::String> lines;
+  lines.add(zc::str("===== Time report ====="));
+  lines.add(zc::str(padRight("Phase", 16), padLeft("Wall (ms)", 12), padLeft("CPU (ms)", 12),
+                    padLeft("Runs", 6)));
+  for (const TimeReport::Phase& phase : report.phases) {
+    lines.add(zc::str(padRight(phase.name, 16), padLeft(formatMilliseconds(phase.wallTime), 12),
+                      padLeft(formatMilliseconds(phase.cpuTime), 12),
+                      padLeft(zc::str(phase.runs), 6)));
+  }
+
+  zc::Vector<const TimeReport::File*> files;
+  for (const TimeReport::File& file : report.files) { files.add(&file); }
+  std::stable_sort(files.begin(), files.end(), [](const auto* a, const auto* b) {
+    return getTotalTime(*a) > getTotalTime(*b);
+  });
+
+  // The name column fits the longest name
+  size_t nameWidth = 4;
+  for (const TimeReport::File* file : files) { nameWidth = zc::max(nameWidth, file->name.size()); }
+  nameWidth += 2;
+
+  lines.add(zc::str());
+  lines.add(zc::str(padRight("File", nameWidth), padLeft("Bytes", 10), padLeft("Parse (ms)", 12),
+                    padLeft("Bind (ms)", 12), padLeft("AST bytes", 12)));
+  for (const TimeReport::File* file : files) {
+    zc::String astBytes = zc::str("-");
+    ZC_IF_SOME(bytes, file->astBytes) { astBytes = zc::str(bytes); }
+    lines.add(zc::str(padRight(file->name, nameWidth), padLeft(zc::str(file->sourceBytes), 10),
+                      padLeft(formatMaybeMilliseconds(file->parseTime), 12),
+                      padLeft(formatMaybeMilliseconds(file->bindTime), 12),
+                      padLeft(astBytes, 12)));
+  }
+
+  lines.add(zc::str());
+  lines.add(zc::str("Interned strings: ", report.internedStrings, " (", report.internedBytes,
+                    " bytes)"));
+  lines.add(zc::str("AST bytes:        ", report.astBytes));
+  lines.add(zc::str("Symbols:          ", report.symbols));
+  lines.add(zc::str("Peak RSS:         ", report.peakResidentBytes, " bytes"));
+  return zc::str(zc::strArray(lines, "\n"), "\n");
+}
+
+zc::String timeReportToJson(const TimeReport& report) {
+  zc::Vector<zc::String> phases;
+  for (const TimeReport::Phase& phase : report.phases) {
+    phases.add(zc::str("    {\"name\": \"", phase.name,
+                       "\", \"wallMicroseconds\": ", phase.wallTime / zc::MICROSECONDS,
+                       ", \"cpuMicroseconds\": ", phase.cpuTime / zc::MICROSECONDS,
+                       ", \"runs\": ", phase.runs, "}"));
+  }
+
+  zc::Vector<zc::String> files;
+  for (const TimeReport::File& file : report.files) {
+    zc::String astBytes = zc::str("null");
+    ZC_IF_SOME(bytes, file.astBytes) { astBytes = zc::str(bytes); }
+    files.add(zc::str("    {\"file\": \"", basic::escapeJsonString(file.name),
+                      "\", \"sourceBytes\": ", file.sourceBytes,
+                      ", \"parseMicroseconds\": ", formatMaybeMicroseconds(file.parseTime),
+                      ", \"bindMicroseconds\": ", formatMaybeMicroseconds(file.bindTime),
+                      ", \"astBytes\": ", astBytes, "}"));
+  }
+
+  return zc::str(
+      "{\n"
+      "  \"phases\": [\n", zc::strArray(phases, ",\n"), "\n  ],\n"
+      "  \"files\": [\n", zc::strArray(files, ",\n"), "\n  ],\n"
+      "  \"internedStrings\": ", report.internedStrings, ",\n"
+      "  \"internedBytes\": ", report.internedBytes, ",\n"
+      "  \"astBytes\": ", report.astBytes, ",\n"
+      "  \"symbols\": ", report.symbols, ",\n"
+      "  \"peakResidentBytes\": ", report.peakResidentBytes, "\n"
+      "}\n");
+}
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,73 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/time.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+/// \brief Where a compilation spent its time and memory, as printed by `zomc --time-report`.
+struct TimeReport {
+  struct Phase {
+    /// "read", "parse", "bind", or "parse-and-bind" when the two are pipelined. Lexing runs
+    /// inside the parse, as the parser pulls tokens.
+    zc::StringPtr name;
+    zc::Duration wallTime = 0 * zc::NANOSECONDS;
+    /// CPU time of the whole process, summed over every worker
+    zc::Duration cpuTime = 0 * zc::NANOSECONDS;
+    /// Times the phase ran, e.g. once more per `CompilerDriver::update()`
+    size_t runs = 0;
+  };
+
+  struct File {
+    zc::String name;
+    size_t sourceBytes = 0;
+    /// Wall time of lexing and parsing the file, and of binding it, on the worker that did it
+    zc::Maybe<zc::Duration> parseTime;
+    zc::Maybe<zc::Duration> bindTime;
+    /// Bytes allocated for the file's AST, or none when allocations were not recorded
+    zc::Maybe<size_t> astBytes;
+  };
+
+  zc::Vector<Phase> phases;
+  zc::Vector<File> files;
+  size_t internedStrings = 0;
+  size_t internedBytes = 0;
+  size_t astBytes = 0;
+  size_t symbols = 0;
+  /// Peak resident set size of the process, 0 where unknown
+  size_t peakResidentBytes = 0;
+};
+
+/// \brief CPU time the process has used so far, over all its threads.
+zc::Duration getProcessCpuTime();
+
+/// \brief Peak resident set size of the process so far, or 0 where unknown.
+size_t getPeakResidentBytes();
+
+/// \brief Render a report as aligned plain text, files slowest first.
+zc::String timeReportToText(const TimeReport& report);
+
+/// \brief Render a report as a JSON document, times in microseconds.
+zc::String timeReportToJson(const TimeReport& report);
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
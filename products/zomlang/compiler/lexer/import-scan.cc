@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/import-scan.h"
+
+#include "zomlang/compiler/ast/utilities.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/compiler/lexer/token.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+ModuleImports scanModuleImports(const source::SourceManager& sourceMgr,
+                                diagnostics::DiagnosticEngine& diagnosticEngine,
+                                const basic::LangOptions& options, basic::StringPool& stringPool,
+                                const source::BufferId& bufferId) {
+  Lexer lexer(sourceMgr, diagnosticEngine, options, stringPool, bufferId);
+  diagnosticEngine.suppress();
+  ZC_DEFER(diagnosticEngine.unsuppress());
+
+  ModuleImports result;
+  Token token;
+  lexer.lex(token);
+
+  bool atFileStart = true;
+  bool atStatementStart = true;
+  uint32_t depth = 0;
+  // Brace depths at which an open template substitution resumes its literal on `}`
+  zc::Vector<uint32_t> templateDepths;
+
+  while (!token.is(ast::SyntaxKind::EndOfFile)) {
+    const ast::SyntaxKind kind = token.getKind();
+    const bool isModule = kind == ast::SyntaxKind::ModuleKeyword && atFileStart;
+    atFileStart = false;
+    if (depth == 0 && (atStatementStart || token.hasPrecedingLineBreak()) &&
+        (isModule || kind == ast::SyntaxKind::ImportKeyword)) {
+      // The path, up to the alias, the `.{` of a list of names, or whatever ends the declaration.
+      // `import(...)` is a call and has none.
+      zc::Vector<zc::StringPtr> segments;
+      lexer.lex(token);
+      while (ast::isIdentifierOrKeyword(token.getKind())) {
+        segments.add(token.getValue());
+        lexer.lex(token);
+        if (!token.is(ast::SyntaxKind::Period)) { break; }
+        lexer.lex(token);
+      }
+      if (!segments.empty()) {
+        zc::String name = zc::strArray(segments, ".");
+        if (isModule) {
+          result.declared = zc::mv(name);
+        } else {
+          result.imports.add(zc::mv(name));
+        }
+      }
+      atStatementStart = false;
+      continue;
+    }
+
+    atStatementStart = depth == 0 && kind == ast::SyntaxKind::Semicolon;
+    if (kind == ast::SyntaxKind::LeftBrace) {
+      ++depth;
+    } else if (kind == ast::SyntaxKind::TemplateHead) {
+      templateDepths.add(depth);
+    } else if (kind == ast::SyntaxKind::RightBrace) {
+      if (!templateDepths.empty() && templateDepths.back() == depth) {
+        if (lexer.reScanTemplateToken() == ast::SyntaxKind::TemplateTail) {
+          templateDepths.removeLast();
+        }
+      } else if (depth > 0) {
+        atStatementStart = --depth == 0;
+      }
+    }
+    lexer.lex(token);
+  }
+  return result;
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+
+namespace source {
+class BufferId;
+class SourceManager;
+}  // namespace source
+
+namespace diagnostics {
+class DiagnosticEngine;
+}  // namespace diagnostics
+
+namespace basic {
+struct LangOptions;
+class StringPool;
+}  // namespace basic
+
+namespace lexer {
+
+/// \brief The module a file declares and the modules it imports, by dotted name, e.g. `a.b`.
+struct ModuleImports {
+  zc::Maybe<zc::String> declared;
+  zc::Vector<zc::String> imports;
+};
+
+/// \brief Find the `module` and `import` declarations of a buffer from its tokens alone.
+///
+/// Much cheaper than parsing: no node is allocated, and everything between braces, such as
+/// function and class bodies, is only lexed. The result is what the parser would find for a file
+/// that parses: the module declaration heading the file, and every import declaration outside of
+/// braces, whether its path is followed by an alias or by a list of imported names. Lexer
+/// diagnostics are suppressed on the calling thread while scanning, since parsing reports them.
+ModuleImports scanModuleImports(const source::SourceManager& sourceMgr,
+                                diagnostics::DiagnosticEngine& diagnosticEngine,
+                                const basic::LangOptions& options, basic::StringPool& stringPool,
+                                const source::BufferId& bufferId);
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
@@ -29,6 +29,8 @@
 #include "zomlang/compiler/diagnostics/diagnostic-ids.h"
 #include "zomlang/compiler/diagnostics/in-flight-diagnostic.h"
 #include "zomlang/compiler/lexer/bigint.h"
+#include "zomlang/compiler/lexer/number-parsing.h"
+#include "zomlang/compiler/lexer/scan-kernels.h"
 #include "zomlang/compiler/lexer/token.h"
 #include "zomlang/compiler/lexer/utils.h"
 #include "zomlang/compiler/source/location.h"
@@ -72,6 +74,16 @@ constexpr bool hasFlag(EscapeSequenceScanningFlags flags, EscapeSequenceScanning
   return (static_cast<uint8_t>(flags) & static_cast<uint8_t>(flag)) != 0;
 }
 
+namespace {
+
+/// Parse a decimal float literal, exactly through the fast path when it applies.
+double parseFloatLiteral(zc::StringPtr text) {
+  ZC_IF_SOME(value, parseDecimalFloat(text)) { return value; }
+  return text.parseAs<double>();
+}
+
+}  // namespace
+
 struct Lexer::Impl {
   /// Reference members
   const source::SourceManager& sourceMgr;
@@ -87,16 +99,27 @@ struct Lexer::Impl {
   const zc::byte* bufferStart;
   /// End of text
   const zc::byte* bufferEnd;
+  /// Location of `bufferStart`
+  source::SourceLoc bufferStartLoc;
   /// Embedded lexer state
   LexerState state;
+  /// Bulk scanning kernels for whitespace, comments and ASCII identifiers
+  const ScanKernels& scanKernels;
 
   /// Collected comment directives
   zc::Vector<CommentDirective> commentDirectives;
+  /// Reused buffer for cooking string and template literal values
+  zc::Vector<char> scratch;
 
   Impl(const source::SourceManager& sourceMgr, diagnostics::DiagnosticEngine& diagnosticEngine,
        const basic::LangOptions& options, basic::StringPool& stringPool,
        const source::BufferId& bufferId);
 
+  /// \brief Get the location of a position in the buffer.
+  source::SourceLoc getLoc(const zc::byte* pos) const {
+    return bufferStartLoc.getAdvancedLoc(pos - bufferStart);
+  }
+
   /// \brief Get the current byte at the cursor position.
   /// \note Even though this returns a rune (int32_t), it only decodes the current byte. It must be
   /// checked against < 0x80 to verify that a call to charWithSize is not needed.
@@ -157,8 +180,9 @@ struct Lexer::Impl {
   void lexNumber();
 
   /// \brief Lex a number fragment.
-  /// \return The lexed number fragment as a string.
-  zc::StringPtr lexNumberFragment();
+  /// \return The digits of the fragment. This is a view into the buffer unless the fragment
+  /// contains separators, in which case it is the interned digits with the separators removed.
+  zc::ArrayPtr<const char> lexNumberFragment();
 
   /// \brief Lex digits.
   /// \return A pair containing the lexed digits as a string and a boolean indicating if a decimal
@@ -224,11 +248,13 @@ Lexer::Impl::Impl(const source::SourceManager& sourceMgr,
       diagnosticEngine(diagnosticEngine),
       langOpts(options),
       stringPool(stringPool),
-      bufferId(bufferId) {
+      bufferId(bufferId),
+      scanKernels(getScanKernels()) {
   // Initialize buffer pointers
   zc::ArrayPtr<const zc::byte> buffer = sourceMgr.getEntireTextForBuffer(bufferId);
   bufferStart = buffer.begin();
   bufferEnd = buffer.end();
+  bufferStartLoc = sourceMgr.getLocForBufferStart(bufferId);
 
   // Initialize embedded state
   state.curPtr = bufferStart;
@@ -252,14 +278,23 @@ std::pair<uint32_t, uint32_t> Lexer::Impl::charWithSize() const {
 }
 
 void Lexer::Impl::formToken(ast::SyntaxKind kind, zc::Maybe<zc::StringPtr> value) {
-  source::SourceLoc startLoc(state.tokenStartPtr);
-  source::SourceLoc endLoc(state.curPtr);
-  source::SourceRange range(startLoc, endLoc);
+  source::SourceRange range(getLoc(state.tokenStartPtr), getLoc(state.curPtr));
+
+  // Only intern the token text when the caller has no value for it. Tokens spelled exactly like
+  // the static text of their kind (punctuators, mostly) keep an empty value, which
+  // Token::getValue() resolves to that text without touching the pool.
+  zc::StringPtr tokenValue = ""_zc;
+  ZC_IF_SOME(v, value) { tokenValue = v; }
+  else {
+    bool isStaticSpelling = false;
+    ZC_IF_SOME(text, Token::getStaticTextForTokenKind(kind)) {
+      isStaticSpelling = text.size() == range.getLength();
+    }
+    if (!isStaticSpelling) { tokenValue = stringPool.intern(state.tokenStartPtr, state.curPtr); }
+  }
 
   // Create token
-  state.token =
-      Token(kind, range, value.orDefault(stringPool.intern(state.tokenStartPtr, state.curPtr)),
-            state.tokenFlags);
+  state.token = Token(kind, range, tokenValue, state.tokenFlags);
 }
 
 void Lexer::Impl::processCommentDirective(const zc::byte* start, const zc::byte* end,
@@ -296,7 +331,7 @@ void Lexer::Impl::processCommentDirective(const zc::byte* start, const zc::byte*
     return;
   }
 
-  CommentDirective directive = {source::SourceRange(start, end), kind};
+  CommentDirective directive = {source::SourceRange(getLoc(start), getLoc(end)), kind};
   commentDirectives.add(zc::mv(directive));
 }
 
@@ -397,15 +432,15 @@ void Lexer::Impl::lex() {
     switch (c) {
       case '\r':
       case '\n':
-        state.tokenFlags |= TokenFlags::PrecedingLineBreak;
-        state.curPtr++;
-        continue;
       case ' ':   // space
       case '\t':  // tab
       case '\v':  // vertical tab
-      case '\f':  // form feed
-        state.curPtr++;
+      case '\f': {  // form feed
+        bool sawLineBreak = false;
+        state.curPtr = scanKernels.skipWhitespace(state.curPtr, bufferEnd, sawLineBreak);
+        if (sawLineBreak) { state.tokenFlags |= TokenFlags::PrecedingLineBreak; }
         continue;
+      }
       case '!':
         if (charAt(1) == '=') {
           if (charAt(2) == '=') {
@@ -518,6 +553,7 @@ void Lexer::Impl::lex() {
           state.curPtr += 2;
 
           while (true) {
+            state.curPtr = scanKernels.findLineCommentStop(state.curPtr, bufferEnd);
             auto [code, size] = charWithSize();
             if (size == 0 || isLineBreak(code)) { break; }
             state.curPtr += size;
@@ -535,6 +571,7 @@ void Lexer::Impl::lex() {
           const zc::byte* lastLineStartPtr = state.tokenStartPtr;
 
           while (true) {
+            state.curPtr = scanKernels.findBlockCommentStop(state.curPtr, bufferEnd);
             auto [code, size] = charWithSize();
             if (size == 0) { break; }
 
@@ -576,7 +613,8 @@ void Lexer::Impl::lex() {
           }
           zc::StringPtr tokenValue = stringPool.intern("0x", digits);
           state.tokenFlags |= TokenFlags::HexSpecifier;
-          return formToken(lexBigIntSuffix(tokenValue), tokenValue);
+          ast::SyntaxKind kind = lexBigIntSuffix(tokenValue);
+          return formToken(kind, tokenValue);
         }
         if (charAt(1) == 'B' || charAt(1) == 'b') {
           state.curPtr += 2;
@@ -587,7 +625,8 @@ void Lexer::Impl::lex() {
           }
           zc::StringPtr tokenValue = stringPool.intern("0b", digits);
           state.tokenFlags |= TokenFlags::BinarySpecifier;
-          return formToken(lexBigIntSuffix(tokenValue), tokenValue);
+          ast::SyntaxKind kind = lexBigIntSuffix(tokenValue);
+          return formToken(kind, tokenValue);
         }
         if (charAt(1) == 'O' || charAt(1) == 'o') {
           state.curPtr += 2;
@@ -598,7 +637,8 @@ void Lexer::Impl::lex() {
           }
           zc::StringPtr tokenValue = stringPool.intern("0o", digits);
           state.tokenFlags |= TokenFlags::OctalSpecifier;
-          return formToken(lexBigIntSuffix(tokenValue), tokenValue);
+          ast::SyntaxKind kind = lexBigIntSuffix(tokenValue);
+          return formToken(kind, tokenValue);
         }
         ZC_FALLTHROUGH;
       case '1' ... '9':
@@ -816,15 +856,9 @@ zc::Maybe<zc::StringPtr> Lexer::Impl::lexIdentifier(int32_t prefixLength) {
 
   // Fast path for simple ASCII identifiers
   if (isASCIILetter(ch) || ch == '_' || ch == '$') {
-    while (true) {
-      state.curPtr++;
-      ch = this->ch();
-      if (!((ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') ||
-            ch == '_' || ch == '$')) {
-        break;
-      }
-    }
-    if (ch < 0x80 && ch != '\\') { return stringPool.intern(start, state.curPtr); }
+    state.curPtr = scanKernels.skipAsciiIdentifierPart(state.curPtr + 1, bufferEnd);
+    ch = this->ch();
+    if (ch < 0x80 && ch != '\\') { return stringPool.intern(start, state.curPtr).asString(); }
     state.curPtr = start + prefixLength;
   }
 
@@ -862,7 +896,7 @@ int32_t Lexer::Impl::peekUnicodeEscape() {
 
 void Lexer::Impl::lexNumber() {
   const zc::byte* start = state.curPtr;
-  zc::StringPtr fixedPart;
+  zc::ArrayPtr<const char> fixedPart;
 
   if (ch() == '0') {
     state.curPtr++;
@@ -911,9 +945,9 @@ void Lexer::Impl::lexNumber() {
   }
 
   const zc::byte* fixedPartEnd = state.curPtr;
-  zc::StringPtr fractionalPart = ""_zc;
-  zc::StringPtr exponentPart = ""_zc;
-  zc::StringPtr exponentPreamble = ""_zc;
+  zc::ArrayPtr<const char> fractionalPart;
+  zc::ArrayPtr<const char> exponentPart;
+  zc::ArrayPtr<const char> exponentPreamble;
 
   if (ch() == '.') {
     state.curPtr++;
@@ -927,22 +961,27 @@ void Lexer::Impl::lexNumber() {
     if (ch() == '+' || ch() == '-') { state.curPtr++; }
     const zc::byte* startNumericPart = state.curPtr;
     exponentPart = lexNumberFragment();
-    if (exponentPart == ""_zc) {
+    if (exponentPart.size() == 0) {
       error<diagnostics::DiagID::DigitExpected>();
     } else {
-      exponentPreamble = stringPool.intern(end, startNumericPart);
+      exponentPreamble = zc::arrayPtr(end, startNumericPart).asChars();
       end = state.curPtr;
     }
   }
 
+  // The fragments are views into the buffer, so the literal is interned once here. Only a literal
+  // with separators has to be put back together from its separator-free fragments.
   zc::StringPtr tokenValue;
   if (hasFlag(state.tokenFlags, TokenFlags::ContainsSeparator)) {
-    tokenValue = fixedPart;
-    if (fractionalPart != ""_zc) {
-      tokenValue = stringPool.intern(tokenValue, ".", fractionalPart);
-    }
-    if (exponentPart != ""_zc) {
-      tokenValue = stringPool.intern(tokenValue, exponentPreamble, exponentPart);
+    if (fractionalPart.size() != 0 && exponentPart.size() != 0) {
+      tokenValue =
+          stringPool.intern(fixedPart, ".", fractionalPart, exponentPreamble, exponentPart);
+    } else if (fractionalPart.size() != 0) {
+      tokenValue = stringPool.intern(fixedPart, ".", fractionalPart);
+    } else if (exponentPart.size() != 0) {
+      tokenValue = stringPool.intern(fixedPart, exponentPreamble, exponentPart);
+    } else {
+      tokenValue = stringPool.intern(fixedPart);
     }
   } else {
     tokenValue = stringPool.intern(start, end);
@@ -953,9 +992,9 @@ void Lexer::Impl::lexNumber() {
                                                                         state.curPtr - start);
     // Normalize the value by parsing as number and converting back to string
     // This removes leading zeros while preserving the numeric value
-    if (fractionalPart != ""_zc || hasFlag(state.tokenFlags, TokenFlags::Scientific)) {
+    if (fractionalPart.size() != 0 || hasFlag(state.tokenFlags, TokenFlags::Scientific)) {
       // For floating point numbers, parse as double
-      double floatValue = tokenValue.parseAs<double>();
+      double floatValue = parseFloatLiteral(tokenValue);
       tokenValue = stringPool.intern(floatValue);
     } else {
       // For integers, parse as int64_t
@@ -970,9 +1009,9 @@ void Lexer::Impl::lexNumber() {
   } else {
     // Additional characters consumed (fractional part or scientific notation)
     // Normalize the token value and set appropriate result type
-    if (fractionalPart != ""_zc || hasFlag(state.tokenFlags, TokenFlags::Scientific)) {
+    if (fractionalPart.size() != 0 || hasFlag(state.tokenFlags, TokenFlags::Scientific)) {
       result = ast::SyntaxKind::FloatLiteral;
-      tokenValue = stringPool.intern(tokenValue.parseAs<double>());
+      tokenValue = stringPool.intern(parseFloatLiteral(tokenValue));
     } else {
       result = ast::SyntaxKind::IntegerLiteral;
       tokenValue = stringPool.intern(tokenValue.parseAs<int64_t>());
@@ -1006,7 +1045,7 @@ void Lexer::Impl::lexNumber() {
   return formToken(result, tokenValue);
 }
 
-zc::StringPtr Lexer::Impl::lexNumberFragment() {
+zc::ArrayPtr<const char> Lexer::Impl::lexNumberFragment() {
   const zc::byte* start = state.curPtr;
   bool allowSeparator = false;
   bool isPreviousTokenSeparator = false;
@@ -1047,8 +1086,9 @@ zc::StringPtr Lexer::Impl::lexNumberFragment() {
     errorAt<diagnostics::DiagID::NumericSeparatorsAreNotAllowedHere>(state.curPtr - 1, 1);
   }
 
+  if (result.empty()) { return zc::arrayPtr(start, state.curPtr).asChars(); }
   result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
-  return stringPool.intern(result.releaseAsArray());
+  return stringPool.intern(result.releaseAsArray()).asString().asArray();
 }
 
 std::pair<zc::StringPtr, bool> Lexer::Impl::lexDigits() {
@@ -1074,8 +1114,29 @@ ast::SyntaxKind Lexer::Impl::lexBigIntSuffix(zc::StringPtr& tokenValue) {
     return ast::SyntaxKind::BigIntLiteral;
   }
 
-  // Parse integer value to normalize it (e.g. remove leading zeros)
-  // Only if not already processed above (BinaryOrOctalSpecifier)
+  // Most literals fit in 64 bits and go through the fast digit conversions. A plain decimal
+  // literal that fits is already in normal form and keeps its text.
+  const bool isDecimal = !hasFlag(state.tokenFlags, TokenFlags::WithSpecifier);
+  zc::Maybe<uint64_t> fastValue;
+  if (hasFlag(state.tokenFlags, TokenFlags::BinarySpecifier)) {
+    fastValue = parseRadixDigits(tokenValue.slice(2), 1);
+  } else if (hasFlag(state.tokenFlags, TokenFlags::OctalSpecifier)) {
+    fastValue = parseRadixDigits(tokenValue.slice(2), 3);
+  } else if (hasFlag(state.tokenFlags, TokenFlags::HexSpecifier)) {
+    fastValue = parseRadixDigits(tokenValue.slice(2), 4);
+  } else {
+    fastValue = parseDecimalDigits(tokenValue);
+  }
+  ZC_IF_SOME(value, fastValue) {
+    if (value <= uint64_t(INT64_MAX)) {
+      if (!isDecimal || (tokenValue.size() > 1 && tokenValue[0] == '0')) {
+        tokenValue = stringPool.intern(int64_t(value));
+      }
+      return ast::SyntaxKind::IntegerLiteral;
+    }
+  }
+
+  // Out of range: keep the general conversion and its clamping and errors.
   int64_t intValue = hasFlag(state.tokenFlags, TokenFlags::BinarySpecifier)
                          ? strtoll(tokenValue.slice(2).cStr(), nullptr, 2)
                      : hasFlag(state.tokenFlags, TokenFlags::OctalSpecifier)
@@ -1093,14 +1154,17 @@ ast::SyntaxKind Lexer::Impl::lexTemplateAndRetTokenValue(bool shouldEmitInvalidE
   const bool startedWithBacktick = ch() == '`';
 
   state.curPtr++;
+  // Only a segment with escapes or CRs needs cooking, which is done in the reused scratch buffer;
+  // any other segment is interned straight from the source buffer.
+  scratch.clear();
+  bool needsCooking = false;
   const zc::byte* start = state.curPtr;
-
-  zc::Vector<char> result;
+  const zc::byte* contentEnd;
   ast::SyntaxKind tokenKind = ast::SyntaxKind::Unknown;
 
   while (true) {
     if (state.curPtr >= bufferEnd) {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      contentEnd = state.curPtr;
       state.tokenFlags |= TokenFlags::Unterminated;
       error<diagnostics::DiagID::UnterminatedTemplateLiteral>();
       tokenKind = startedWithBacktick ? ast::SyntaxKind::NoSubstitutionTemplateLiteral
@@ -1110,7 +1174,7 @@ ast::SyntaxKind Lexer::Impl::lexTemplateAndRetTokenValue(bool shouldEmitInvalidE
 
     const zc::byte c = ch();
     if (c == '`') {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      contentEnd = state.curPtr;
       state.curPtr++;
       tokenKind = startedWithBacktick ? ast::SyntaxKind::NoSubstitutionTemplateLiteral
                                       : ast::SyntaxKind::TemplateTail;
@@ -1118,7 +1182,7 @@ ast::SyntaxKind Lexer::Impl::lexTemplateAndRetTokenValue(bool shouldEmitInvalidE
     }
 
     if (c == '$' && state.curPtr + 1 < bufferEnd && *(state.curPtr + 1) == '{') {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      contentEnd = state.curPtr;
       state.curPtr += 2;
       tokenKind =
           startedWithBacktick ? ast::SyntaxKind::TemplateHead : ast::SyntaxKind::TemplateMiddle;
@@ -1126,20 +1190,22 @@ ast::SyntaxKind Lexer::Impl::lexTemplateAndRetTokenValue(bool shouldEmitInvalidE
     }
 
     if (c == '\\') {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      needsCooking = true;
+      scratch.addAll(zc::arrayPtr(start, state.curPtr).asChars());
       EscapeSequenceScanningFlags flags = EscapeSequenceScanningFlags::String;
       if (shouldEmitInvalidEscapeError) { flags |= EscapeSequenceScanningFlags::ReportErrors; }
       zc::StringPtr esc = lexEscapeSequence(flags);
-      result.addAll(esc.asArray());
+      scratch.addAll(esc.asArray());
       start = state.curPtr;
       continue;
     }
 
     if (c == '\r') {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      needsCooking = true;
+      scratch.addAll(zc::arrayPtr(start, state.curPtr).asChars());
       state.curPtr++;
       if (state.curPtr < bufferEnd && ch() == '\n') { state.curPtr++; }
-      result.add('\n');
+      scratch.add('\n');
       start = state.curPtr;
       continue;
     }
@@ -1149,7 +1215,12 @@ ast::SyntaxKind Lexer::Impl::lexTemplateAndRetTokenValue(bool shouldEmitInvalidE
 
   ZC_DASSERT(tokenKind != ast::SyntaxKind::Unknown);
 
-  outValue = stringPool.intern(result.releaseAsArray());
+  if (!needsCooking) {
+    outValue = stringPool.intern(start, contentEnd);
+  } else {
+    scratch.addAll(zc::arrayPtr(start, contentEnd).asChars());
+    outValue = stringPool.intern(scratch.asPtr().asConst());
+  }
   return tokenKind;
 }
 
@@ -1183,39 +1254,48 @@ zc::StringPtr Lexer::Impl::lexIdentifierParts() {
 zc::StringPtr Lexer::Impl::lexString() {
   zc::byte quoteChar = ch();
   state.curPtr++;
-  zc::Vector<char> result;
+  // Only a string with escapes needs a decoded copy, built in the reused scratch buffer; any other
+  // string is interned straight from the buffer.
+  scratch.clear();
+  bool hasEscapes = false;
   const zc::byte* start = state.curPtr;
+  const zc::byte* contentEnd;
 
   while (true) {
+    // Everything up to the closing quote, an escape or a line break is taken verbatim, so skip it
+    // a vector at a time; large embedded JSON or base64 blobs are mostly such runs.
+    state.curPtr = scanKernels.findStringLiteralStop(state.curPtr, bufferEnd, quoteChar);
     if (state.curPtr >= bufferEnd) {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      contentEnd = state.curPtr;
       state.tokenFlags |= TokenFlags::Unterminated;
       error<diagnostics::DiagID::UnterminatedString>();
       break;
     }
     const zc::byte c = ch();
     if (c == quoteChar) {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      contentEnd = state.curPtr;
       state.curPtr++;
       break;
     }
     if (c == '\\') {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
+      hasEscapes = true;
+      scratch.addAll(zc::arrayPtr(start, state.curPtr).asChars());
       zc::StringPtr esc = lexEscapeSequence(EscapeSequenceScanningFlags::String |
                                             EscapeSequenceScanningFlags::ReportErrors);
-      result.addAll(esc.asArray());
+      scratch.addAll(esc.asArray());
       start = state.curPtr;
       continue;
     }
-    if ((c == '\n' || c == '\r')) {
-      result.addAll(zc::arrayPtr(start, state.curPtr).asChars());
-      state.tokenFlags |= TokenFlags::Unterminated;
-      error<diagnostics::DiagID::UnterminatedString>();
-      break;
-    }
-    state.curPtr++;
+    // Otherwise the kernel stopped at a line break
+    contentEnd = state.curPtr;
+    state.tokenFlags |= TokenFlags::Unterminated;
+    error<diagnostics::DiagID::UnterminatedString>();
+    break;
   }
-  return stringPool.intern(result.releaseAsArray());
+
+  if (!hasEscapes) { return stringPool.intern(start, contentEnd); }
+  scratch.addAll(zc::arrayPtr(start, contentEnd).asChars());
+  return stringPool.intern(scratch.asPtr().asConst());
 }
 
 zc::StringPtr Lexer::Impl::lexEscapeSequence(EscapeSequenceScanningFlags flags) {
@@ -1269,7 +1349,7 @@ zc::StringPtr Lexer::Impl::lexEscapeSequence(EscapeSequenceScanningFlags flags)
               formatHexValue(c - '0'));
         } else {
           error<diagnostics::DiagID::EscapeSequenceNotAllowed>(
-              stringPool.intern(start, state.curPtr));
+              stringPool.intern(start, state.curPtr).asString());
         }
         return stringPool.intern(encodeUtf8(c));
       }
@@ -1296,7 +1376,7 @@ zc::StringPtr Lexer::Impl::lexEscapeSequence(EscapeSequenceScanningFlags flags)
       state.curPtr -= 2;
       uint32_t codePoint =
           lexUnicodeEscape(hasFlag(flags, EscapeSequenceScanningFlags::ReportInvalidEscapeErrors));
-      if (codePoint < 0) { return stringPool.intern(start, state.curPtr); }
+      if (codePoint < 0) { return stringPool.intern(start, state.curPtr).asString(); }
       return stringPool.intern(encodeUtf8(codePoint));
     }
     case 'x': {
@@ -1388,22 +1468,66 @@ void Lexer::Impl::lexInvalidCharacter() {
   auto [code, size] = charWithSize();
   errorAt<diagnostics::DiagID::InvalidCharacter>(start, size);
   state.curPtr += size;
-  return formToken(ast::SyntaxKind::Unknown, stringPool.intern(start, size));
+  return formToken(ast::SyntaxKind::Unknown, stringPool.intern(start, size).asString());
 }
 
 template <diagnostics::DiagID ID, typename... Args>
 void Lexer::Impl::errorAt(const zc::byte* pos, uint32_t length, Args&&... args) {
-  source::SourceLoc loc(pos);
+  source::SourceLoc loc = getLoc(pos);
   source::CharSourceRange range(loc, length);
   diagnosticEngine.diagnose<ID>(loc, zc::fwd<Args>(args)...).addRange(range);
 }
 
 template <diagnostics::DiagID ID, typename... Args>
 void Lexer::Impl::error(Args&&... args) {
-  source::SourceLoc loc = sourceMgr.getLocForOffset(bufferId, state.tokenStartPtr - bufferStart);
+  source::SourceLoc loc = getLoc(state.tokenStartPtr);
   diagnosticEngine.diagnose<ID>(loc, zc::fwd<Args>(args)...);
 }
 
+void TokenTable::add(const Token& token) {
+  const source::SourceRange range = token.getRange();
+  const zc::StringPtr value = token.getValue();
+
+  kinds.add(token.getKind());
+  flags.add(token.getFlags());
+  starts.add(range.getStart().getOpaqueValue() - bufferStart.getOpaqueValue());
+  lengths.add(range.getLength());
+
+  uint32_t valueIndex = kNoValue;
+  ZC_IF_SOME(text, Token::getStaticTextForTokenKind(token.getKind())) {
+    if (text != value) { valueIndex = values.size(); }
+  }
+  else { valueIndex = values.size(); }
+  if (valueIndex != kNoValue) { values.add(value); }
+  valueIndices.add(valueIndex);
+}
+
+Token TokenTable::getToken(size_t index) const {
+  const source::SourceLoc start = bufferStart + starts[index];
+  const uint32_t valueIndex = valueIndices[index];
+  return Token(kinds[index], source::SourceRange(start, start + lengths[index]),
+               valueIndex == kNoValue ? ""_zc : values[valueIndex], flags[index]);
+}
+
+namespace {
+
+/// Append row `index` of `from` to `to`, moving its start by `shift` bytes.
+void copyTokenRow(TokenTable& to, const TokenTable& from, size_t index, int64_t shift) {
+  to.kinds.add(from.kinds[index]);
+  to.flags.add(from.flags[index]);
+  to.starts.add(static_cast<uint32_t>(from.starts[index] + shift));
+  to.lengths.add(from.lengths[index]);
+
+  uint32_t valueIndex = from.valueIndices[index];
+  if (valueIndex != TokenTable::kNoValue) {
+    to.values.add(from.values[valueIndex]);
+    valueIndex = to.values.size() - 1;
+  }
+  to.valueIndices.add(valueIndex);
+}
+
+}  // namespace
+
 Lexer::Lexer(const source::SourceManager& sourceMgr,
              diagnostics::DiagnosticEngine& diagnosticEngine, const basic::LangOptions& options,
              basic::StringPool& stringPool, const source::BufferId& bufferId)
@@ -1416,10 +1540,75 @@ void Lexer::lex(Token& outToken) {
   outToken = impl->state.token;
 }
 
+TokenTable Lexer::lexAll() {
+  TokenTable table;
+  table.bufferStart = impl->bufferStartLoc;
+  do {
+    impl->lex();
+    table.add(impl->state.token);
+  } while (!impl->state.token.is(ast::SyntaxKind::EndOfFile));
+  return table;
+}
+
+TokenTable Lexer::relex(const TokenTable& previous, const TextEdit& edit) {
+  TokenTable table;
+  table.bufferStart = impl->bufferStartLoc;
+
+  // A token boundary carries nothing into the next token except the cursor, so everything up to
+  // the end of the last token that stops short of the edit can be kept. Stopping short (rather
+  // than touching the edit) keeps tokens that the edit could extend, like `ab|`, on the relex side.
+  size_t kept = 0;
+  while (kept < previous.size() && previous.kinds[kept] != ast::SyntaxKind::EndOfFile &&
+         previous.starts[kept] + previous.lengths[kept] < edit.offset) {
+    copyTokenRow(table, previous, kept, 0);
+    ++kept;
+  }
+  if (kept > 0) {
+    const zc::byte* resume =
+        impl->bufferStart + previous.starts[kept - 1] + previous.lengths[kept - 1];
+    restoreState(LexerState(resume, resume, resume));
+  }
+
+  const uint32_t editEnd = edit.offset + edit.insertedLength;
+  const int64_t shift = int64_t(edit.insertedLength) - int64_t(edit.removedLength);
+  size_t old = kept;
+  do {
+    impl->lex();
+    const Token& token = impl->state.token;
+    const uint32_t start =
+        token.getRange().getStart().getOpaqueValue() - impl->bufferStartLoc.getOpaqueValue();
+
+    if (start >= editEnd) {
+      // Past the edit the text is unchanged, so once a token matches the previous one at the same
+      // place, every later token would match too.
+      const int64_t oldStart = start - shift;
+      while (old < previous.size() && previous.starts[old] < oldStart) { ++old; }
+      if (old < previous.size() && previous.starts[old] == oldStart &&
+          previous.kinds[old] == token.getKind() && previous.flags[old] == token.getFlags() &&
+          previous.lengths[old] == token.getRange().getLength() &&
+          previous.getToken(old).getValue() == token.getValue()) {
+        for (; old < previous.size(); ++old) { copyTokenRow(table, previous, old, shift); }
+        return table;
+      }
+    }
+    table.add(token);
+  } while (!impl->state.token.is(ast::SyntaxKind::EndOfFile));
+  return table;
+}
+
 ast::SyntaxKind Lexer::reScanGreaterToken() { return impl->reScanGreaterToken(); }
 
 ast::SyntaxKind Lexer::reScanTemplateToken() { return impl->reScanTemplateToken(); }
 
+void Lexer::restrictToRange(uint32_t begin, uint32_t end) {
+  ZC_REQUIRE(begin <= end && impl->bufferStart + end <= impl->bufferEnd);
+  impl->bufferEnd = impl->bufferStart + end;
+  impl->state.curPtr = impl->bufferStart + begin;
+  impl->state.fullStartPtr = impl->state.curPtr;
+  impl->state.tokenStartPtr = impl->state.curPtr;
+  impl->state.tokenFlags = TokenFlags::None;
+}
+
 void Lexer::restoreState(LexerState s, bool enableDiagnostics) {
   impl->state.curPtr = s.curPtr;
   impl->state.fullStartPtr = s.fullStartPtr;
@@ -1431,13 +1620,15 @@ void Lexer::restoreState(LexerState s, bool enableDiagnostics) {
 const LexerState Lexer::getCurrentState() const { return impl->state; }
 
 const source::SourceLoc Lexer::getFullStartLoc() const {
-  return source::SourceLoc(impl->state.fullStartPtr);
+  return impl->getLoc(impl->state.fullStartPtr);
 }
 
 const source::SourceLoc Lexer::getTokenStartLoc() const {
-  return source::SourceLoc(impl->state.tokenStartPtr);
+  return impl->getLoc(impl->state.tokenStartPtr);
 }
 
+source::SourceLoc Lexer::getLoc(const zc::byte* pos) const { return impl->getLoc(pos); }
+
 const zc::Vector<CommentDirective>& Lexer::getCommentDirectives() const {
   return impl->commentDirectives;
 }
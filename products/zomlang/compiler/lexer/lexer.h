@@ -51,6 +51,41 @@ struct CommentDirective {
   CommentDirectiveKind kind;
 };
 
+/// \brief Every token of a buffer in struct-of-arrays form, as produced by `Lexer::lexAll()`.
+///
+/// Row `i` of each column describes the i-th token, and the last row is always EndOfFile. Offsets
+/// are in bytes from the start of the buffer. Keywords and punctuators are fully described by
+/// their kind; every other token carries its interned value in the `values` side table.
+struct TokenTable {
+  /// `valueIndices` entry for tokens whose value is the static spelling of their kind.
+  static constexpr uint32_t kNoValue = UINT32_MAX;
+
+  zc::Vector<ast::SyntaxKind> kinds;
+  zc::Vector<TokenFlags> flags;
+  zc::Vector<uint32_t> starts;
+  zc::Vector<uint32_t> lengths;
+  zc::Vector<uint32_t> valueIndices;
+  zc::Vector<zc::StringPtr> values;
+
+  /// Location of the start of the buffer that `starts` are relative to.
+  source::SourceLoc bufferStart;
+
+  ZC_NODISCARD size_t size() const { return kinds.size(); }
+
+  /// \brief Append a row for `token`.
+  void add(const Token& token);
+
+  /// \brief Rebuild the token in row `index`.
+  ZC_NODISCARD Token getToken(size_t index) const;
+};
+
+/// \brief A single replacement of `removedLength` bytes at `offset` by `insertedLength` bytes.
+struct TextEdit {
+  uint32_t offset;
+  uint32_t removedLength;
+  uint32_t insertedLength;
+};
+
 struct LexerState {
   // Core position pointers
   const zc::byte* curPtr;         // Current position (end position of text of current token)
@@ -87,6 +122,28 @@ public:
   /// \param outToken The token to output.
   void lex(Token& outToken);
 
+  /// \brief Lex from the current position to the end of the buffer in one pass.
+  /// \return A table with a row per token, ending with EndOfFile.
+  ZC_NODISCARD TokenTable lexAll();
+
+  /// \brief Update the table of a buffer's previous text after `edit`, relexing as little as
+  /// possible.
+  ///
+  /// The lexer must be freshly created over the edited buffer, and `previous` must come from
+  /// `lexAll()` or `relex()` over the text before the edit with the same string pool. Rows that end
+  /// before the edit are kept as is. Lexing resumes after the last of them and stops as soon as it
+  /// produces a token identical to a previous one past the edit, whose remaining rows are then
+  /// shifted into place.
+  /// \return The same table `lexAll()` would return for the edited buffer.
+  ZC_NODISCARD TokenTable relex(const TokenTable& previous, const TextEdit& edit);
+
+  /// \brief Lex only bytes [begin, end) of the buffer from now on, as if they were all of it.
+  ///
+  /// The lexer moves to `begin` and reports EndOfFile at `end`. Locations stay relative to the
+  /// whole buffer, so tokens are the same as when lexing it in full as long as neither offset falls
+  /// inside a token.
+  void restrictToRange(uint32_t begin, uint32_t end);
+
   ZC_NODISCARD ast::SyntaxKind reScanGreaterToken();
   ZC_NODISCARD ast::SyntaxKind reScanTemplateToken();
 
@@ -107,6 +164,9 @@ public:
   /// \return The source location of the token start.
   ZC_NODISCARD const source::SourceLoc getTokenStartLoc() const;
 
+  /// \brief Get the location of a position held by a `LexerState` of this lexer.
+  ZC_NODISCARD source::SourceLoc getLoc(const zc::byte* pos) const;
+
   /// \brief Get the list of comment directives found so far.
   /// \return The list of comment directives.
   ZC_NODISCARD const zc::Vector<CommentDirective>& getCommentDirectives() const;
@@ -0,0 +1,153 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/number-parsing.h"
+
+#include <cfloat>
+#include <cstring>
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+/// Convert eight ASCII digits to their value with three multiplies instead of eight.
+uint64_t parseEightDigits(const char* text) {
+  uint64_t value;
+  memcpy(&value, text, sizeof(value));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  value = __builtin_bswap64(value);
+#endif
+  // Each byte now holds one digit, least significant byte first. Fold neighbouring bytes into
+  // two-digit values, then 16-bit lanes into four-digit values, then combine the two halves.
+  value -= 0x3030303030303030;
+  value = (value * 10) + (value >> 8);
+  value = (((value & 0x000000FF000000FF) * (100 + (1000000ull << 32))) +
+           (((value >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >>
+          32;
+  return value;
+}
+
+/// Skip leading '0' characters, keeping the array empty if it only held zeros.
+zc::ArrayPtr<const char> stripLeadingZeros(zc::ArrayPtr<const char> digits) {
+  size_t i = 0;
+  while (i < digits.size() && digits[i] == '0') { ++i; }
+  return digits.slice(i, digits.size());
+}
+
+constexpr double kExactPowersOfTen[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+constexpr int kMaxExactPowerOfTen = 22;
+constexpr uint64_t kMaxExactSignificand = uint64_t(1) << 53;
+
+}  // namespace
+
+zc::Maybe<uint64_t> parseDecimalDigits(zc::ArrayPtr<const char> digits) {
+  digits = stripLeadingZeros(digits);
+  // UINT64_MAX has 20 digits.
+  if (digits.size() > 20) { return zc::none; }
+
+  // Sixteen digits always fit, so the SWAR steps need no overflow checks.
+  uint64_t value = 0;
+  size_t i = 0;
+  for (; i + 8 <= digits.size() && i < 16; i += 8) {
+    value = value * 100000000 + parseEightDigits(digits.begin() + i);
+  }
+  for (; i < digits.size(); ++i) {
+    if (__builtin_mul_overflow(value, 10, &value) ||
+        __builtin_add_overflow(value, uint64_t(digits[i] - '0'), &value)) {
+      return zc::none;
+    }
+  }
+  return value;
+}
+
+zc::Maybe<uint64_t> parseRadixDigits(zc::ArrayPtr<const char> digits, uint32_t log2Radix) {
+  digits = stripLeadingZeros(digits);
+
+  uint64_t value = 0;
+  for (char c : digits) {
+    if (value >> (64 - log2Radix) != 0) { return zc::none; }
+    const uint64_t digit = c <= '9' ? c - '0' : c - 'a' + 10;
+    value = (value << log2Radix) | digit;
+  }
+  return value;
+}
+
+zc::Maybe<double> parseDecimalFloat(zc::ArrayPtr<const char> text) {
+#if FLT_EVAL_METHOD != 0
+  // With excess precision the multiplication below would be rounded twice.
+  return zc::none;
+#else
+  const char* ptr = text.begin();
+  const char* const end = text.end();
+
+  uint64_t significand = 0;
+  int significantDigits = 0;
+  int64_t exponent = 0;
+
+  auto takeDigit = [&](char c) {
+    if (significantDigits == 0 && c == '0') { return; }
+    significand = significand * 10 + (c - '0');
+    ++significantDigits;
+  };
+
+  for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) { takeDigit(*ptr); }
+  if (ptr < end && *ptr == '.') {
+    for (++ptr; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+      takeDigit(*ptr);
+      --exponent;
+    }
+  }
+  if (significantDigits > 19) { return zc::none; }
+
+  if (ptr < end && (*ptr == 'e' || *ptr == 'E')) {
+    ++ptr;
+    bool negative = false;
+    if (ptr < end && (*ptr == '+' || *ptr == '-')) { negative = *ptr++ == '-'; }
+    if (ptr == end) { return zc::none; }
+    int64_t written = 0;
+    for (; ptr < end && *ptr >= '0' && *ptr <= '9'; ++ptr) {
+      // Anything this large is far outside the fast path anyway.
+      if (written > 100000) { return zc::none; }
+      written = written * 10 + (*ptr - '0');
+    }
+    exponent += negative ? -written : written;
+  }
+  if (ptr != end) { return zc::none; }
+
+  if (significand == 0) { return 0.0; }
+  if (significand > kMaxExactSignificand) { return zc::none; }
+
+  if (exponent < 0) {
+    if (exponent < -kMaxExactPowerOfTen) { return zc::none; }
+    return double(significand) / kExactPowersOfTen[-exponent];
+  }
+  if (exponent > kMaxExactPowerOfTen) {
+    // Move the excess into the significand while it stays exactly representable, e.g. 1e25.
+    while (exponent > kMaxExactPowerOfTen) {
+      if (significand > kMaxExactSignificand / 10) { return zc::none; }
+      significand *= 10;
+      --exponent;
+    }
+  }
+  return double(significand) * kExactPowersOfTen[exponent];
+#endif
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
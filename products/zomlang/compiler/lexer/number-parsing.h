@@ -0,0 +1,50 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "zc/core/common.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+// Fast paths for turning the digits of a numeric literal into its value. Each function handles
+// only the inputs it can convert exactly and cheaply, and returns none for everything else so
+// the caller can fall back to the general conversion.
+
+/// \brief Parse ASCII decimal digits, eight at a time.
+/// \param digits Only the characters '0'-'9'; leading zeros are allowed.
+/// \return The value, or none if it does not fit in 64 bits.
+zc::Maybe<uint64_t> parseDecimalDigits(zc::ArrayPtr<const char> digits);
+
+/// \brief Parse the digits of a binary, octal or hexadecimal literal.
+/// \param digits Digits valid in the radix, without prefix; hex digits must be lowercase.
+/// \param log2Radix 1, 3 or 4.
+/// \return The value, or none if it does not fit in 64 bits.
+zc::Maybe<uint64_t> parseRadixDigits(zc::ArrayPtr<const char> digits, uint32_t log2Radix);
+
+/// \brief Parse a decimal float literal such as "10.25", "1e-3" or "1.5E+10".
+///
+/// Succeeds only when the significand has at most 19 digits and fits in a double's 53 bits and the
+/// decimal exponent is small enough that the value is a single correctly rounded multiplication
+/// or division of two exactly representable doubles (Clinger's fast path).
+/// \return The correctly rounded value, or none if the fast path does not apply.
+zc::Maybe<double> parseDecimalFloat(zc::ArrayPtr<const char> text);
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
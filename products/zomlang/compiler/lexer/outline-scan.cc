@@ -0,0 +1,424 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+
+#include "zomlang/compiler/lexer/outline-scan.h"
+
+#include "zomlang/compiler/ast/utilities.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/compiler/lexer/token.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+/// What the declarations directly in a body are.
+enum class BodyKind : uint8_t { kFile, kClass, kInterface, kEnum };
+
+/// The file, or the body of a type, whose declarations are outlined.
+struct Body {
+  BodyKind kind;
+  /// Nesting depth of the tokens directly in the body
+  uint32_t depth;
+  /// Entry of the type the body belongs to
+  zc::Maybe<uint32_t> owner;
+  /// Entries of the declaration being scanned in the body, which end once it does
+  zc::Vector<uint32_t> pending;
+  /// The declaration being scanned ends with the first braced block it has, e.g. a function body.
+  /// Otherwise a brace may be part of an initializer or a type, and it ends with a `;` or when
+  /// the next declaration starts.
+  bool pendingEndsAtBrace = false;
+  /// The declaration being scanned declares variables, more of which may follow a `,`.
+  bool pendingIsVariableList = false;
+  /// The kind of body the next brace at this depth opens, for a type declaration being scanned.
+  zc::Maybe<BodyKind> opens;
+};
+
+bool isModifier(ast::SyntaxKind kind) {
+  switch (kind) {
+    case ast::SyntaxKind::AbstractKeyword:
+    case ast::SyntaxKind::AccessorKeyword:
+    case ast::SyntaxKind::AsyncKeyword:
+    case ast::SyntaxKind::DeclareKeyword:
+    case ast::SyntaxKind::DefaultKeyword:
+    case ast::SyntaxKind::ExportKeyword:
+    case ast::SyntaxKind::MutatingKeyword:
+    case ast::SyntaxKind::OverrideKeyword:
+    case ast::SyntaxKind::PrivateKeyword:
+    case ast::SyntaxKind::ProtectedKeyword:
+    case ast::SyntaxKind::PublicKeyword:
+    case ast::SyntaxKind::ReadonlyKeyword:
+    case ast::SyntaxKind::StaticKeyword:
+      return true;
+    default:
+      return false;
+  }
+}
+
+/// True if a token can start a declaration of a body; only these start one on a new line without
+/// a `;` before them.
+bool canStartDeclaration(ast::SyntaxKind kind) {
+  switch (kind) {
+    case ast::SyntaxKind::AliasKeyword:
+    case ast::SyntaxKind::ClassKeyword:
+    case ast::SyntaxKind::ConstKeyword:
+    case ast::SyntaxKind::DeinitKeyword:
+    case ast::SyntaxKind::EnumKeyword:
+    case ast::SyntaxKind::ErrorKeyword:
+    case ast::SyntaxKind::FunKeyword:
+    case ast::SyntaxKind::GetKeyword:
+    case ast::SyntaxKind::InitKeyword:
+    case ast::SyntaxKind::InterfaceKeyword:
+    case ast::SyntaxKind::LetKeyword:
+    case ast::SyntaxKind::SetKeyword:
+    case ast::SyntaxKind::StructKeyword:
+      return true;
+    default:
+      return isModifier(kind);
+  }
+}
+
+TokenClass classify(ast::SyntaxKind kind) {
+  switch (kind) {
+    case ast::SyntaxKind::Identifier:
+      return TokenClass::kIdentifier;
+    case ast::SyntaxKind::IntegerLiteral:
+    case ast::SyntaxKind::FloatLiteral:
+    case ast::SyntaxKind::BigIntLiteral:
+      return TokenClass::kNumber;
+    case ast::SyntaxKind::StringLiteral:
+    case ast::SyntaxKind::CharacterLiteral:
+    case ast::SyntaxKind::NoSubstitutionTemplateLiteral:
+    case ast::SyntaxKind::TemplateHead:
+    case ast::SyntaxKind::TemplateMiddle:
+    case ast::SyntaxKind::TemplateTail:
+      return TokenClass::kString;
+    default:
+      break;
+  }
+  if (ast::isKeyword(kind)) { return TokenClass::kKeyword; }
+  if (ast::isPunctuation(kind)) { return TokenClass::kPunctuation; }
+  return TokenClass::kOperator;
+}
+
+class OutlineScanner {
+public:
+  OutlineScanner(Lexer& lexer, bool classifyTokens)
+      : lexer(lexer), classifyTokens(classifyTokens) {}
+
+  Outline scan() {
+    bodies.add(Body{.kind = BodyKind::kFile,
+                    .depth = 0,
+                    .owner = zc::none,
+                    .pending = {},
+                    .pendingEndsAtBrace = false,
+                    .pendingIsVariableList = false,
+                    .opens = zc::none});
+    next();
+
+    bool atStatementStart = true;
+    while (!token.is(ast::SyntaxKind::EndOfFile)) {
+      Body& body = bodies.back();
+      const ast::SyntaxKind kind = token.getKind();
+
+      if (depth == body.depth) {
+        if (body.kind == BodyKind::kEnum) {
+          if (atStatementStart && ast::isIdentifierOrKeyword(kind)) {
+            startEntry(body, ast::SyntaxKind::EnumMember, token.getLocation(), previousEnd);
+            takeName();
+            atStatementStart = false;
+            continue;
+          }
+        } else if ((atStatementStart || (token.hasPrecedingLineBreak() &&
+                                         canStartDeclaration(kind))) &&
+                   scanDeclaration(body)) {
+          atStatementStart = false;
+          continue;
+        }
+      }
+
+      atStatementStart = false;
+      switch (kind) {
+        case ast::SyntaxKind::LeftBrace:
+          ++depth;
+          if (depth == body.depth + 1) {
+            ZC_IF_SOME(opened, body.opens) {
+              const zc::Maybe<uint32_t> owner = body.pending.back();
+              body.opens = zc::none;
+              bodies.add(Body{.kind = opened,
+                              .depth = depth,
+                              .owner = owner,
+                              .pending = {},
+                              .pendingEndsAtBrace = false,
+                              .pendingIsVariableList = false,
+                              .opens = zc::none});
+              atStatementStart = true;
+            }
+          }
+          break;
+        case ast::SyntaxKind::LeftParen:
+        case ast::SyntaxKind::LeftBracket:
+          ++depth;
+          break;
+        case ast::SyntaxKind::TemplateHead:
+          templateDepths.add(++depth);
+          break;
+        case ast::SyntaxKind::RightBrace:
+          if (!templateDepths.empty() && templateDepths.back() == depth) {
+            (void)lexer.reScanTemplateToken();
+            token = lexer.getCurrentState().token;
+            if (classifyTokens) {
+              outline.tokens.back() = ClassifiedToken{token.getRange(), TokenClass::kString};
+            }
+            if (token.is(ast::SyntaxKind::TemplateTail)) {
+              templateDepths.removeLast();
+              --depth;
+            }
+          } else if (depth > 0) {
+            --depth;
+            atStatementStart = closeBrace(atStatementStart);
+          }
+          break;
+        case ast::SyntaxKind::RightParen:
+        case ast::SyntaxKind::RightBracket:
+          if (depth > body.depth) { --depth; }
+          break;
+        case ast::SyntaxKind::Semicolon:
+          if (depth == body.depth) {
+            finishPending(body, token.getRange().getEnd());
+            atStatementStart = body.kind != BodyKind::kEnum;
+          }
+          break;
+        case ast::SyntaxKind::Comma:
+          if (depth == body.depth) {
+            if (body.kind == BodyKind::kEnum) {
+              finishPending(body, previousEnd);
+              atStatementStart = true;
+            } else if (body.pendingIsVariableList) {
+              // Each variable spans the whole statement, as the first does.
+              const source::SourceLoc start = outline.entries[body.pending[0]].range.getStart();
+              next();
+              if (token.is(ast::SyntaxKind::Identifier)) {
+                body.pending.add(addEntry(body, ast::SyntaxKind::VariableDeclaration, start));
+                takeName();
+              }
+              continue;
+            }
+          }
+          break;
+        default:
+          break;
+      }
+      next();
+    }
+
+    // Whatever is still open ends with the file.
+    while (!bodies.empty()) {
+      finishPending(bodies.back(), previousEnd);
+      bodies.removeLast();
+    }
+    return zc::mv(outline);
+  }
+
+private:
+  Lexer& lexer;
+  const bool classifyTokens;
+  Outline outline;
+  Token token;
+  /// End of the token before `token`
+  source::SourceLoc previousEnd;
+  /// Braces, parentheses, brackets and template substitutions open at `token`
+  uint32_t depth = 0;
+  /// Depths of the open template substitutions, which a `}` at that depth resumes the literal of
+  zc::Vector<uint32_t> templateDepths;
+  /// The file, and the type bodies open at `token`, innermost last
+  zc::Vector<Body> bodies;
+
+  void next() {
+    previousEnd = token.getRange().getEnd();
+    lexer.lex(token);
+    if (classifyTokens && !token.is(ast::SyntaxKind::EndOfFile)) {
+      outline.tokens.add(ClassifiedToken{token.getRange(), classify(token.getKind())});
+    }
+  }
+
+  /// Handle a `}` that closed a brace, not a template substitution, leaving `depth` lower.
+  /// \return Whether a declaration can start after it
+  bool closeBrace(bool atStatementStart) {
+    Body& body = bodies.back();
+    if (bodies.size() > 1 && depth < body.depth) {
+      // The end of a type body, which ends the type as well.
+      finishPending(body, previousEnd);
+      bodies.removeLast();
+      Body& parent = bodies.back();
+      finishPending(parent, token.getRange().getEnd());
+      return parent.kind != BodyKind::kEnum;
+    }
+    if (depth == body.depth && body.pendingEndsAtBrace) {
+      finishPending(body, token.getRange().getEnd());
+      return body.kind != BodyKind::kEnum;
+    }
+    return atStatementStart;
+  }
+
+  uint32_t addEntry(Body& body, ast::SyntaxKind kind, source::SourceLoc start) {
+    const uint32_t index = outline.entries.size();
+    outline.entries.add(OutlineEntry{kind, ""_zc, source::SourceRange(),
+                                     source::SourceRange(start, start), body.owner});
+    return index;
+  }
+
+  /// Start the first entry of a declaration of `body`, ending the one before at `before`.
+  void startEntry(Body& body, ast::SyntaxKind kind, source::SourceLoc start,
+                  source::SourceLoc before) {
+    finishPending(body, before);
+    body.pending.add(addEntry(body, kind, start));
+  }
+
+  /// Name the last entry after `token`, if it is a name, and move past it.
+  void takeName() {
+    if (!ast::isIdentifierOrKeyword(token.getKind())) { return; }
+    OutlineEntry& entry = outline.entries.back();
+    entry.name = token.getValue();
+    entry.nameRange = token.getRange();
+    if (classifyTokens) { outline.tokens.back().tokenClass = TokenClass::kDeclarationName; }
+    next();
+  }
+
+  /// End the entries of the declaration being scanned in `body` at `end`.
+  void finishPending(Body& body, source::SourceLoc end) {
+    for (uint32_t index : body.pending) {
+      OutlineEntry& entry = outline.entries[index];
+      entry.range = source::SourceRange(entry.range.getStart(), end);
+    }
+    body.pending.clear();
+    body.pendingEndsAtBrace = false;
+    body.pendingIsVariableList = false;
+    body.opens = zc::none;
+  }
+
+  /// Scan the head of a declaration of `body` starting at `token`, up to and including its name.
+  /// \return False if `token` does not start a declaration, after skipping any modifiers
+  bool scanDeclaration(Body& body) {
+    const source::SourceLoc start = token.getLocation();
+    const source::SourceLoc before = previousEnd;
+    // `export` may start an export declaration instead, which the main loop then goes through.
+    while (isModifier(token.getKind())) { next(); }
+
+    const bool inType = body.kind == BodyKind::kClass || body.kind == BodyKind::kInterface;
+    const bool inInterface = body.kind == BodyKind::kInterface;
+    ast::SyntaxKind kind;
+    bool endsAtBrace = true;
+    zc::Maybe<BodyKind> opens;
+    switch (token.getKind()) {
+      case ast::SyntaxKind::FunKeyword:
+        kind = inInterface ? ast::SyntaxKind::MethodSignature
+               : inType    ? ast::SyntaxKind::MethodDeclaration
+                           : ast::SyntaxKind::FunctionDeclaration;
+        endsAtBrace = !inInterface;
+        break;
+      case ast::SyntaxKind::LetKeyword:
+      case ast::SyntaxKind::ConstKeyword:
+        kind = inInterface ? ast::SyntaxKind::PropertySignature
+               : inType    ? ast::SyntaxKind::PropertyDeclaration
+                           : ast::SyntaxKind::VariableDeclaration;
+        endsAtBrace = false;
+        break;
+      case ast::SyntaxKind::InitKeyword:
+      case ast::SyntaxKind::DeinitKeyword:
+        if (body.kind != BodyKind::kClass) { return false; }
+        startEntry(body,
+                   token.is(ast::SyntaxKind::InitKeyword) ? ast::SyntaxKind::InitDeclaration
+                                                          : ast::SyntaxKind::DeinitDeclaration,
+                   start, before);
+        body.pendingEndsAtBrace = true;
+        // The keyword is the name.
+        takeName();
+        return true;
+      case ast::SyntaxKind::GetKeyword:
+      case ast::SyntaxKind::SetKeyword:
+        if (body.kind != BodyKind::kClass) { return false; }
+        kind = token.is(ast::SyntaxKind::GetKeyword) ? ast::SyntaxKind::GetAccessor
+                                                     : ast::SyntaxKind::SetAccessor;
+        break;
+      case ast::SyntaxKind::ClassKeyword:
+        kind = ast::SyntaxKind::ClassDeclaration;
+        opens = BodyKind::kClass;
+        break;
+      case ast::SyntaxKind::StructKeyword:
+        kind = ast::SyntaxKind::StructDeclaration;
+        opens = BodyKind::kClass;
+        break;
+      case ast::SyntaxKind::InterfaceKeyword:
+        kind = ast::SyntaxKind::InterfaceDeclaration;
+        opens = BodyKind::kInterface;
+        break;
+      case ast::SyntaxKind::EnumKeyword:
+        kind = ast::SyntaxKind::EnumDeclaration;
+        opens = BodyKind::kEnum;
+        break;
+      case ast::SyntaxKind::ErrorKeyword:
+        kind = ast::SyntaxKind::ErrorDeclaration;
+        break;
+      case ast::SyntaxKind::AliasKeyword:
+        kind = ast::SyntaxKind::AliasDeclaration;
+        endsAtBrace = false;
+        break;
+      default:
+        return false;
+    }
+    // Types and aliases are only declared at the top level.
+    if (body.kind != BodyKind::kFile &&
+        (opens != zc::none || kind == ast::SyntaxKind::ErrorDeclaration ||
+         kind == ast::SyntaxKind::AliasDeclaration)) {
+      return false;
+    }
+
+    const bool declaresVariables =
+        token.is(ast::SyntaxKind::LetKeyword) || token.is(ast::SyntaxKind::ConstKeyword);
+    next();
+    if (declaresVariables && !token.is(ast::SyntaxKind::Identifier)) {
+      // Variables declared by destructuring, which are left out.
+      finishPending(body, before);
+      return true;
+    }
+
+    startEntry(body, kind, start, before);
+    body.pendingEndsAtBrace = endsAtBrace && opens == zc::none;
+    body.pendingIsVariableList = declaresVariables && body.kind == BodyKind::kFile;
+    body.opens = opens;
+    takeName();
+    return true;
+  }
+};
+
+}  // namespace
+
+Outline scanOutline(const source::SourceManager& sourceMgr,
+                    diagnostics::DiagnosticEngine& diagnosticEngine,
+                    const basic::LangOptions& options, basic::StringPool& stringPool,
+                    const source::BufferId& bufferId, bool classifyTokens) {
+  Lexer lexer(sourceMgr, diagnosticEngine, options, stringPool, bufferId);
+  diagnosticEngine.suppress();
+  ZC_DEFER(diagnosticEngine.unsuppress());
+
+  return OutlineScanner(lexer, classifyTokens).scan();
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
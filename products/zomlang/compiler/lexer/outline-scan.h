@@ -0,0 +1,99 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/source/location.h"
+
+namespace zomlang {
+namespace compiler {
+
+namespace source {
+class BufferId;
+class SourceManager;
+}  // namespace source
+
+namespace diagnostics {
+class DiagnosticEngine;
+}  // namespace diagnostics
+
+namespace basic {
+struct LangOptions;
+class StringPool;
+}  // namespace basic
+
+namespace lexer {
+
+/// \brief A declaration found by `scanOutline()`.
+struct OutlineEntry {
+  /// Kind of the node the parser builds for the declaration, e.g. `ClassDeclaration` or
+  /// `MethodDeclaration`
+  ast::SyntaxKind kind;
+  /// Empty, with an invalid range, if the declaration is missing its name
+  zc::StringPtr name;
+  source::SourceRange nameRange;
+  /// From the first modifier to the end of the declaration. Variables declared by one statement
+  /// all have the range of the statement.
+  source::SourceRange range;
+  /// Index of the entry of the type declaring this one, none at the top level
+  zc::Maybe<uint32_t> parent;
+};
+
+/// \brief How to highlight a token.
+enum class TokenClass : uint8_t {
+  kKeyword,
+  kIdentifier,
+  /// The name of an outlined declaration
+  kDeclarationName,
+  kNumber,
+  /// String, character and template literals, template pieces included
+  kString,
+  kOperator,
+  kPunctuation,
+};
+
+struct ClassifiedToken {
+  source::SourceRange range;
+  TokenClass tokenClass;
+};
+
+struct Outline {
+  /// Declarations in source order, a type before its members
+  zc::Vector<OutlineEntry> entries;
+  /// Every token of the buffer, if asked for
+  zc::Vector<ClassifiedToken> tokens;
+};
+
+/// \brief Find the top-level declarations of a buffer, and the members of its types, from its
+/// tokens alone.
+///
+/// Much cheaper than parsing: no node is allocated, and expressions, types and function bodies are
+/// only lexed. For a file that parses, the entries are the declarations the parser would build:
+/// functions, variables, types and aliases at the top level, properties, methods, accessors and
+/// `init`/`deinit` in classes and structs, signatures in interfaces, and enum members. Variables
+/// declared by destructuring are left out. Lexer diagnostics are suppressed on the calling thread
+/// while scanning, since parsing reports them.
+/// \param classifyTokens Also list every token with its class, e.g. for highlighting
+Outline scanOutline(const source::SourceManager& sourceMgr,
+                    diagnostics::DiagnosticEngine& diagnosticEngine,
+                    const basic::LangOptions& options, basic::StringPool& stringPool,
+                    const source::BufferId& bufferId, bool classifyTokens = false);
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
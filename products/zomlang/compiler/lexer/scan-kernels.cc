@@ -0,0 +1,391 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/scan-kernels.h"
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define ZOM_SCAN_HAS_SSE2 1
+#if defined(__GNUC__) || defined(__clang__)
+#define ZOM_SCAN_HAS_AVX2 1
+#endif
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define ZOM_SCAN_HAS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+// =======================================================================================
+// Scalar kernels
+//
+// These are the reference semantics; the vector kernels process whole blocks and hand the tail
+// (anything shorter than one vector) to these.
+
+inline bool isBlank(zc::byte c) { return c == ' ' || (c >= '\t' && c <= '\r'); }
+
+inline bool isAsciiIdentifierPart(zc::byte c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+         c == '$';
+}
+
+const zc::byte* scalarSkipWhitespace(const zc::byte* ptr, const zc::byte* end,
+                                     bool& sawLineBreak) {
+  for (; ptr < end && isBlank(*ptr); ++ptr) {
+    if (*ptr == '\n' || *ptr == '\r') { sawLineBreak = true; }
+  }
+  return ptr;
+}
+
+const zc::byte* scalarFindLineCommentStop(const zc::byte* ptr, const zc::byte* end) {
+  while (ptr < end && *ptr != '\n' && *ptr != '\r' && *ptr < 0x80) { ++ptr; }
+  return ptr;
+}
+
+const zc::byte* scalarFindBlockCommentStop(const zc::byte* ptr, const zc::byte* end) {
+  while (ptr < end && *ptr != '*' && *ptr != '\n' && *ptr != '\r' && *ptr < 0x80) { ++ptr; }
+  return ptr;
+}
+
+const zc::byte* scalarSkipAsciiIdentifierPart(const zc::byte* ptr, const zc::byte* end) {
+  while (ptr < end && isAsciiIdentifierPart(*ptr)) { ++ptr; }
+  return ptr;
+}
+
+const zc::byte* scalarFindStringLiteralStop(const zc::byte* ptr, const zc::byte* end,
+                                            zc::byte quote) {
+  while (ptr < end && *ptr != quote && *ptr != '\\' && *ptr != '\n' && *ptr != '\r') { ++ptr; }
+  return ptr;
+}
+
+constexpr ScanKernels kScalarKernels = {scalarSkipWhitespace,        scalarFindLineCommentStop,
+                                        scalarFindBlockCommentStop,  scalarSkipAsciiIdentifierPart,
+                                        scalarFindStringLiteralStop, "scalar"_zc};
+
+// =======================================================================================
+// Vector kernels
+//
+// Every instruction set provides an `Isa` traits type whose static functions classify one block
+// of `kWidth` bytes into a bitmask of "stop" bytes, `kBitsPerByte` bits per byte in memory order.
+// Each instruction set lives in its own namespace, where ZOM_DEFINE_SCAN_KERNELS turns the
+// classifiers of the local `Isa` type into the five ScanKernels entry points and `kKernels`.
+// The drivers are stamped out by a macro rather than a template so that they can carry the same
+// target attribute as the classifiers they inline.
+
+inline uint32_t countTrailingZeros(uint64_t mask) { return __builtin_ctzll(mask); }
+
+#define ZOM_DEFINE_SCAN_KERNELS(Name, TARGET)                                                      \
+  TARGET const zc::byte* skipWhitespace(const zc::byte* ptr, const zc::byte* end,                  \
+                                        bool& sawLineBreak) {                                      \
+    while (static_cast<size_t>(end - ptr) >= Isa::kWidth) {                                        \
+      uint64_t lineBreaks;                                                                         \
+      uint64_t stops = Isa::whitespaceStops(ptr, lineBreaks);                                      \
+      if (stops != 0) {                                                                            \
+        if ((lineBreaks & ((stops & -stops) - 1)) != 0) { sawLineBreak = true; }                   \
+        return ptr + countTrailingZeros(stops) / Isa::kBitsPerByte;                                \
+      }                                                                                            \
+      if (lineBreaks != 0) { sawLineBreak = true; }                                                \
+      ptr += Isa::kWidth;                                                                          \
+    }                                                                                              \
+    return scalarSkipWhitespace(ptr, end, sawLineBreak);                                           \
+  }                                                                                                \
+                                                                                                   \
+  TARGET const zc::byte* findLineCommentStop(const zc::byte* ptr, const zc::byte* end) {           \
+    while (static_cast<size_t>(end - ptr) >= Isa::kWidth) {                                        \
+      uint64_t stops = Isa::lineCommentStops(ptr);                                                 \
+      if (stops != 0) { return ptr + countTrailingZeros(stops) / Isa::kBitsPerByte; }              \
+      ptr += Isa::kWidth;                                                                          \
+    }                                                                                              \
+    return scalarFindLineCommentStop(ptr, end);                                                    \
+  }                                                                                                \
+                                                                                                   \
+  TARGET const zc::byte* findBlockCommentStop(const zc::byte* ptr, const zc::byte* end) {          \
+    while (static_cast<size_t>(end - ptr) >= Isa::kWidth) {                                        \
+      uint64_t stops = Isa::blockCommentStops(ptr);                                                \
+      if (stops != 0) { return ptr + countTrailingZeros(stops) / Isa::kBitsPerByte; }              \
+      ptr += Isa::kWidth;                                                                          \
+    }                                                                                              \
+    return scalarFindBlockCommentStop(ptr, end);                                                   \
+  }                                                                                                \
+                                                                                                   \
+  TARGET const zc::byte* skipAsciiIdentifierPart(const zc::byte* ptr, const zc::byte* end) {       \
+    while (static_cast<size_t>(end - ptr) >= Isa::kWidth) {                                        \
+      uint64_t stops = Isa::identifierStops(ptr);                                                  \
+      if (stops != 0) { return ptr + countTrailingZeros(stops) / Isa::kBitsPerByte; }              \
+      ptr += Isa::kWidth;                                                                          \
+    }                                                                                              \
+    return scalarSkipAsciiIdentifierPart(ptr, end);                                                \
+  }                                                                                                \
+                                                                                                   \
+  TARGET const zc::byte* findStringLiteralStop(const zc::byte* ptr, const zc::byte* end,           \
+                                               zc::byte quote) {                                   \
+    while (static_cast<size_t>(end - ptr) >= Isa::kWidth) {                                        \
+      uint64_t stops = Isa::stringLiteralStops(ptr, quote);                                        \
+      if (stops != 0) { return ptr + countTrailingZeros(stops) / Isa::kBitsPerByte; }              \
+      ptr += Isa::kWidth;                                                                          \
+    }                                                                                              \
+    return scalarFindStringLiteralStop(ptr, end, quote);                                           \
+  }                                                                                                \
+                                                                                                   \
+  constexpr ScanKernels kKernels = {skipWhitespace,        findLineCommentStop,                    \
+                                    findBlockCommentStop,  skipAsciiIdentifierPart,                \
+                                    findStringLiteralStop, Name##_zc};
+
+#if ZOM_SCAN_HAS_SSE2
+
+namespace sse2 {
+
+struct Isa {
+  static constexpr size_t kWidth = 16;
+  static constexpr uint32_t kBitsPerByte = 1;
+
+  static uint64_t toMask(__m128i matches) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(matches));
+  }
+
+  static uint64_t stopsFrom(__m128i matches) { return ~toMask(matches) & 0xffff; }
+
+  // Unsigned `lo <= v && v <= lo + span`, using wrap-around and saturation.
+  static __m128i inRange(__m128i v, char lo, char span) {
+    __m128i shifted = _mm_sub_epi8(v, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_subs_epu8(shifted, _mm_set1_epi8(span)), _mm_setzero_si128());
+  }
+
+  static uint64_t whitespaceStops(const zc::byte* ptr, uint64_t& lineBreaks) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+    lineBreaks = toMask(_mm_or_si128(lf, cr));
+    __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')), inRange(v, '\t', 4));
+    return stopsFrom(blank);
+  }
+
+  static uint64_t lineCommentStops(const zc::byte* ptr) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+    // The sign bit of each byte is exactly the non-ASCII test.
+    return toMask(_mm_or_si128(_mm_or_si128(lf, cr), v));
+  }
+
+  static uint64_t blockCommentStops(const zc::byte* ptr) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    __m128i star = _mm_cmpeq_epi8(v, _mm_set1_epi8('*'));
+    __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+    return toMask(_mm_or_si128(_mm_or_si128(star, lf), _mm_or_si128(cr, v)));
+  }
+
+  static uint64_t identifierStops(const zc::byte* ptr) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    __m128i alpha = inRange(_mm_or_si128(v, _mm_set1_epi8(0x20)), 'a', 25);
+    __m128i digit = inRange(v, '0', 9);
+    __m128i underscore = _mm_cmpeq_epi8(v, _mm_set1_epi8('_'));
+    __m128i dollar = _mm_cmpeq_epi8(v, _mm_set1_epi8('$'));
+    return stopsFrom(_mm_or_si128(_mm_or_si128(alpha, digit), _mm_or_si128(underscore, dollar)));
+  }
+
+  static uint64_t stringLiteralStops(const zc::byte* ptr, zc::byte quote) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+    __m128i q = _mm_cmpeq_epi8(v, _mm_set1_epi8(static_cast<char>(quote)));
+    __m128i backslash = _mm_cmpeq_epi8(v, _mm_set1_epi8('\\'));
+    __m128i lf = _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'));
+    __m128i cr = _mm_cmpeq_epi8(v, _mm_set1_epi8('\r'));
+    return toMask(_mm_or_si128(_mm_or_si128(q, backslash), _mm_or_si128(lf, cr)));
+  }
+};
+
+ZOM_DEFINE_SCAN_KERNELS("sse2", )
+
+}  // namespace sse2
+
+#endif  // ZOM_SCAN_HAS_SSE2
+
+#if ZOM_SCAN_HAS_AVX2
+
+#define ZOM_SCAN_TARGET_AVX2 __attribute__((target("avx2")))
+
+namespace avx2 {
+
+struct Isa {
+  static constexpr size_t kWidth = 32;
+  static constexpr uint32_t kBitsPerByte = 1;
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t toMask(__m256i matches) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(matches));
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t stopsFrom(__m256i matches) {
+    return ~toMask(matches) & 0xffffffffu;
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static __m256i inRange(__m256i v, char lo, char span) {
+    __m256i shifted = _mm256_sub_epi8(v, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_subs_epu8(shifted, _mm256_set1_epi8(span)),
+                             _mm256_setzero_si256());
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t whitespaceStops(const zc::byte* ptr,
+                                                       uint64_t& lineBreaks) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i lf = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+    lineBreaks = toMask(_mm256_or_si256(lf, cr));
+    __m256i blank =
+        _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')), inRange(v, '\t', 4));
+    return stopsFrom(blank);
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t lineCommentStops(const zc::byte* ptr) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i lf = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+    return toMask(_mm256_or_si256(_mm256_or_si256(lf, cr), v));
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t blockCommentStops(const zc::byte* ptr) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i star = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('*'));
+    __m256i lf = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+    return toMask(_mm256_or_si256(_mm256_or_si256(star, lf), _mm256_or_si256(cr, v)));
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t identifierStops(const zc::byte* ptr) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i alpha = inRange(_mm256_or_si256(v, _mm256_set1_epi8(0x20)), 'a', 25);
+    __m256i digit = inRange(v, '0', 9);
+    __m256i underscore = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('_'));
+    __m256i dollar = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('$'));
+    return stopsFrom(
+        _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_or_si256(underscore, dollar)));
+  }
+
+  ZOM_SCAN_TARGET_AVX2 static uint64_t stringLiteralStops(const zc::byte* ptr, zc::byte quote) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    __m256i q = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(static_cast<char>(quote)));
+    __m256i backslash = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\\'));
+    __m256i lf = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n'));
+    __m256i cr = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'));
+    return toMask(_mm256_or_si256(_mm256_or_si256(q, backslash), _mm256_or_si256(lf, cr)));
+  }
+};
+
+ZOM_DEFINE_SCAN_KERNELS("avx2", ZOM_SCAN_TARGET_AVX2)
+
+}  // namespace avx2
+
+#endif  // ZOM_SCAN_HAS_AVX2
+
+#if ZOM_SCAN_HAS_NEON
+
+namespace neon {
+
+struct Isa {
+  static constexpr size_t kWidth = 16;
+  // NEON has no movemask; narrowing each 16-bit lane by 4 leaves one nibble per byte.
+  static constexpr uint32_t kBitsPerByte = 4;
+
+  static uint64_t toMask(uint8x16_t matches) {
+    uint8x8_t narrowed = vshrn_n_u16(vreinterpretq_u16_u8(matches), 4);
+    return vget_lane_u64(vreinterpret_u64_u8(narrowed), 0);
+  }
+
+  static uint64_t whitespaceStops(const zc::byte* ptr, uint64_t& lineBreaks) {
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t lf = vceqq_u8(v, vdupq_n_u8('\n'));
+    uint8x16_t cr = vceqq_u8(v, vdupq_n_u8('\r'));
+    lineBreaks = toMask(vorrq_u8(lf, cr));
+    uint8x16_t control = vcleq_u8(vsubq_u8(v, vdupq_n_u8('\t')), vdupq_n_u8(4));
+    uint8x16_t blank = vorrq_u8(vceqq_u8(v, vdupq_n_u8(' ')), control);
+    return toMask(vmvnq_u8(blank));
+  }
+
+  static uint64_t lineCommentStops(const zc::byte* ptr) {
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t lf = vceqq_u8(v, vdupq_n_u8('\n'));
+    uint8x16_t cr = vceqq_u8(v, vdupq_n_u8('\r'));
+    uint8x16_t nonAscii = vcgeq_u8(v, vdupq_n_u8(0x80));
+    return toMask(vorrq_u8(vorrq_u8(lf, cr), nonAscii));
+  }
+
+  static uint64_t blockCommentStops(const zc::byte* ptr) {
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t star = vceqq_u8(v, vdupq_n_u8('*'));
+    uint8x16_t lf = vceqq_u8(v, vdupq_n_u8('\n'));
+    uint8x16_t cr = vceqq_u8(v, vdupq_n_u8('\r'));
+    uint8x16_t nonAscii = vcgeq_u8(v, vdupq_n_u8(0x80));
+    return toMask(vorrq_u8(vorrq_u8(star, lf), vorrq_u8(cr, nonAscii)));
+  }
+
+  static uint64_t identifierStops(const zc::byte* ptr) {
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t lower = vorrq_u8(v, vdupq_n_u8(0x20));
+    uint8x16_t alpha = vcleq_u8(vsubq_u8(lower, vdupq_n_u8('a')), vdupq_n_u8(25));
+    uint8x16_t digit = vcleq_u8(vsubq_u8(v, vdupq_n_u8('0')), vdupq_n_u8(9));
+    uint8x16_t underscore = vceqq_u8(v, vdupq_n_u8('_'));
+    uint8x16_t dollar = vceqq_u8(v, vdupq_n_u8('$'));
+    uint8x16_t part = vorrq_u8(vorrq_u8(alpha, digit), vorrq_u8(underscore, dollar));
+    return toMask(vmvnq_u8(part));
+  }
+
+  static uint64_t stringLiteralStops(const zc::byte* ptr, zc::byte quote) {
+    uint8x16_t v = vld1q_u8(ptr);
+    uint8x16_t q = vceqq_u8(v, vdupq_n_u8(quote));
+    uint8x16_t backslash = vceqq_u8(v, vdupq_n_u8('\\'));
+    uint8x16_t lf = vceqq_u8(v, vdupq_n_u8('\n'));
+    uint8x16_t cr = vceqq_u8(v, vdupq_n_u8('\r'));
+    return toMask(vorrq_u8(vorrq_u8(q, backslash), vorrq_u8(lf, cr)));
+  }
+};
+
+ZOM_DEFINE_SCAN_KERNELS("neon", )
+
+}  // namespace neon
+
+#endif  // ZOM_SCAN_HAS_NEON
+
+#undef ZOM_DEFINE_SCAN_KERNELS
+
+const ScanKernels& selectScanKernels() {
+#if ZOM_SCAN_HAS_AVX2
+  if (__builtin_cpu_supports("avx2")) { return avx2::kKernels; }
+#endif
+#if ZOM_SCAN_HAS_SSE2
+  return sse2::kKernels;
+#elif ZOM_SCAN_HAS_NEON
+  return neon::kKernels;
+#else
+  return kScalarKernels;
+#endif
+}
+
+}  // namespace
+
+const ScanKernels& getScanKernels() {
+  static const ScanKernels& kernels = selectScanKernels();
+  return kernels;
+}
+
+const ScanKernels& getScalarScanKernels() { return kScalarKernels; }
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
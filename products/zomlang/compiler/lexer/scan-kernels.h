@@ -0,0 +1,60 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+/// \brief Bulk byte-scanning kernels used by the lexer's hot loops.
+///
+/// Each kernel only ever skips plain ASCII bytes that the lexer would have consumed one at a time
+/// anyway, and stops at the first byte that needs the lexer's attention (including any non-ASCII
+/// byte, which the caller decodes as before, except in string literals, which take such bytes
+/// verbatim). All kernels return `end` when nothing stops them.
+struct ScanKernels {
+  /// \brief Skip spaces, tabs, vertical tabs, form feeds, CR and LF.
+  /// \param sawLineBreak Set to true if a CR or LF was skipped; never reset to false.
+  const zc::byte* (*skipWhitespace)(const zc::byte* ptr, const zc::byte* end, bool& sawLineBreak);
+
+  /// \brief Find the first CR, LF or non-ASCII byte in a line comment body.
+  const zc::byte* (*findLineCommentStop)(const zc::byte* ptr, const zc::byte* end);
+
+  /// \brief Find the first '*', CR, LF or non-ASCII byte in a block comment body.
+  const zc::byte* (*findBlockCommentStop)(const zc::byte* ptr, const zc::byte* end);
+
+  /// \brief Skip a run of ASCII identifier characters: [A-Za-z0-9_$].
+  const zc::byte* (*skipAsciiIdentifierPart)(const zc::byte* ptr, const zc::byte* end);
+
+  /// \brief Find the first `quote`, backslash, CR or LF in a string literal body.
+  const zc::byte* (*findStringLiteralStop)(const zc::byte* ptr, const zc::byte* end,
+                                           zc::byte quote);
+
+  /// \brief Name of the instruction set these kernels were built for, e.g. "avx2".
+  zc::StringPtr name;
+};
+
+/// \brief Get the fastest kernels supported by the running CPU. Chosen once, on first use.
+const ScanKernels& getScanKernels();
+
+/// \brief Get the portable byte-at-a-time kernels.
+const ScanKernels& getScalarScanKernels();
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
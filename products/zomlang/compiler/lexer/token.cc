@@ -14,102 +14,22 @@
 
 #include "zomlang/compiler/lexer/token.h"
 
-#include "zc/core/memory.h"
 #include "zomlang/compiler/source/manager.h"
 
 namespace zomlang {
 namespace compiler {
 namespace lexer {
 
-// ================================================================================
-// Token::Impl
-
-struct Token::Impl {
-  ast::SyntaxKind kind;
-  source::SourceRange range;
-  zc::StringPtr value;
-  TokenFlags flags;
-
-  Impl() : kind(ast::SyntaxKind::Unknown), value(""_zc), flags(TokenFlags::None) {}
-  Impl(ast::SyntaxKind k, source::SourceRange r, zc::StringPtr text,
-       TokenFlags f = TokenFlags::None)
-      : kind(k), range(r), value(text), flags(f) {}
-};
-
 // ================================================================================
 // Token
 
-Token::Token() noexcept : impl(zc::heap<Impl>()) {}
-
-Token::Token(ast::SyntaxKind k, source::SourceRange r, zc::StringPtr value,
-             TokenFlags flags) noexcept
-    : impl(zc::heap<Impl>(k, r, zc::mv(value), flags)) {}
-
-Token::Token(const Token& other) noexcept : impl(zc::heap<Impl>()) {
-  impl->kind = other.impl->kind;
-  impl->range = other.impl->range;
-  impl->flags = other.impl->flags;
-  impl->value = other.impl->value;
-}
-
-Token::Token(Token&& other) noexcept : impl(zc::mv(other.impl)) {}
-
-Token::~Token() noexcept(false) = default;
-
-Token& Token::operator=(const Token& other) noexcept {
-  if (this != &other) {
-    impl->kind = other.impl->kind;
-    impl->range = other.impl->range;
-    impl->flags = other.impl->flags;
-    impl->value = other.impl->value;
-  }
-  return *this;
-}
-
-Token& Token::operator=(Token&& other) noexcept {
-  if (this != &other) {
-    impl->kind = other.impl->kind;
-    impl->range = zc::mv(other.impl->range);
-    impl->flags = other.impl->flags;
-    impl->value = other.impl->value;
-  }
-  return *this;
-}
-
-void Token::setKind(ast::SyntaxKind k) { impl->kind = k; }
-
-void Token::setRange(source::SourceRange r) { impl->range = r; }
-
-void Token::setValue(zc::StringPtr value) { impl->value = zc::mv(value); }
-
-void Token::setFlags(TokenFlags flags) { impl->flags = flags; }
-
-void Token::addFlag(TokenFlags flag) {
-  impl->flags =
-      static_cast<TokenFlags>(static_cast<uint16_t>(impl->flags) | static_cast<uint16_t>(flag));
-}
-
-bool Token::is(ast::SyntaxKind k) const { return impl->kind == k; }
-
-ast::SyntaxKind Token::getKind() const { return impl->kind; }
-
-source::SourceLoc Token::getLocation() const { return impl->range.getStart(); }
-
-source::SourceRange Token::getRange() const { return impl->range; }
-
-TokenFlags Token::getFlags() const { return impl->flags; }
-
 zc::StringPtr Token::getValue() const {
-  if (impl->value.size() == 0) {
-    ZC_IF_SOME(text, getStaticTextForTokenKind(impl->kind)) { return text; }
+  if (value.size() == 0) {
+    ZC_IF_SOME(text, getStaticTextForTokenKind(kind)) { return text; }
   }
-  return impl->value;
+  return value;
 }
 
-bool Token::hasFlag(TokenFlags flag) const { return (impl->flags & flag) != TokenFlags::None; }
-
-bool Token::hasPrecedingLineBreak() const { return hasFlag(TokenFlags::PrecedingLineBreak); }
-
 namespace {
 constexpr zc::StringPtr getStaticTextForTokenKindImpl(ast::SyntaxKind kind) {
   switch (kind) {
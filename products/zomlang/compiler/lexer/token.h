@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include <type_traits>
+
 #include "zc/core/common.h"
 #include "zc/core/string.h"
 #include "zomlang/compiler/ast/kinds.h"
@@ -91,51 +93,49 @@ constexpr bool hasFlag(TokenFlags flags, TokenFlags flag) {
   return (flags & flag) != TokenFlags::None;
 }
 
+/// \brief A lexed token.
+///
+/// Tokens are plain values: the spelling is an interned `StringPtr` owned by the StringPool and
+/// the range is a pair of SourceManager locations, so copying a token (parser lookahead, lexer
+/// state snapshots) is a trivial memberwise copy with no allocation.
 class Token {
 public:
-  Token() noexcept;
+  Token() noexcept = default;
   Token(ast::SyntaxKind k, source::SourceRange r, zc::StringPtr value = ""_zc,
-        TokenFlags flags = TokenFlags::None) noexcept;
-
-  // Copy constructor
-  Token(const Token& other) noexcept;
-
-  // Move constructor
-  Token(Token&& other) noexcept;
-
-  ~Token() noexcept(false);
+        TokenFlags flags = TokenFlags::None) noexcept
+      : range(r), value(value), kind(k), flags(flags) {}
 
-  // Copy assignment operator
-  Token& operator=(const Token& other) noexcept;
+  void setKind(ast::SyntaxKind k) { kind = k; }
+  void setRange(source::SourceRange r) { range = r; }
+  void setValue(zc::StringPtr v) { value = v; }
+  void setFlags(TokenFlags f) { flags = f; }
+  void addFlag(TokenFlags flag) { flags |= flag; }
 
-  // Move assignment operator
-  Token& operator=(Token&& other) noexcept;
+  ZC_NODISCARD bool is(ast::SyntaxKind k) const { return kind == k; }
 
-  void setKind(ast::SyntaxKind k);
-  void setRange(source::SourceRange r);
-  void setValue(zc::StringPtr value);
-  void setFlags(TokenFlags flags);
-  void addFlag(TokenFlags flag);
-
-  ZC_NODISCARD bool is(ast::SyntaxKind k) const;
-
-  ZC_NODISCARD ast::SyntaxKind getKind() const;
-  ZC_NODISCARD source::SourceLoc getLocation() const;
-  ZC_NODISCARD source::SourceRange getRange() const;
-  ZC_NODISCARD TokenFlags getFlags() const;
+  ZC_NODISCARD ast::SyntaxKind getKind() const { return kind; }
+  ZC_NODISCARD source::SourceLoc getLocation() const { return range.getStart(); }
+  ZC_NODISCARD source::SourceRange getRange() const { return range; }
+  ZC_NODISCARD TokenFlags getFlags() const { return flags; }
 
   ZC_NODISCARD zc::StringPtr getValue() const;
-  ZC_NODISCARD bool hasFlag(TokenFlags flag) const;
-  ZC_NODISCARD bool hasPrecedingLineBreak() const;
+  ZC_NODISCARD bool hasFlag(TokenFlags flag) const { return (flags & flag) != TokenFlags::None; }
+  ZC_NODISCARD bool hasPrecedingLineBreak() const {
+    return hasFlag(TokenFlags::PrecedingLineBreak);
+  }
 
   /// Get static text for common keywords and operators
   static zc::Maybe<zc::StringPtr> getStaticTextForTokenKind(ast::SyntaxKind kind);
 
 private:
-  struct Impl;
-  zc::Own<Impl> impl;
+  source::SourceRange range;
+  zc::StringPtr value = ""_zc;
+  ast::SyntaxKind kind = ast::SyntaxKind::Unknown;
+  TokenFlags flags = TokenFlags::None;
 };
 
+static_assert(std::is_trivially_copyable_v<Token>, "Token must stay a plain value type");
+
 }  // namespace lexer
 }  // namespace compiler
 }  // namespace zomlang
@@ -388,9 +388,136 @@ constexpr zc::ArrayPtr<const UnicodeRange> ID_START_RANGES = zc::arrayPtr(ID_STA
 
 constexpr zc::ArrayPtr<const UnicodeRange> ID_PART_RANGES = zc::arrayPtr(ID_PART_RANGES_DATA);
 
-bool isIdStart(const uint32_t codePoint) { return isInUnicodeRange(codePoint, ID_START_RANGES); }
+namespace {
 
-bool isIdPart(const uint32_t codePoint) { return isInUnicodeRange(codePoint, ID_PART_RANGES); }
+// The range tables above stay the source of truth; isIdStart/isIdPart read a two-level table
+// generated from them at compile time. The high bits of a code point select a 256-bit block and
+// the low 8 bits select a bit within it. Identical neighbouring blocks are stored once, and so are
+// the all-clear and all-set blocks that cover most of the code space (including the CJK ideograph
+// blocks), which keeps each table to a few tens of kilobytes.
+constexpr uint32_t kUnicodeBlockBits = 8;
+constexpr uint32_t kUnicodeBlockSize = 1u << kUnicodeBlockBits;
+constexpr uint32_t kUnicodeBlockWords = kUnicodeBlockSize / 64;
+constexpr uint32_t kUnicodeCodePointLimit = 0x110000;
+constexpr uint32_t kUnicodeBlockCount = kUnicodeCodePointLimit >> kUnicodeBlockBits;
+
+struct UnicodeBlock {
+  uint64_t words[kUnicodeBlockWords] = {};
+
+  constexpr bool operator==(const UnicodeBlock& other) const = default;
+};
+
+/// Walks a sorted range table one block at a time, producing the bitmap of each block in turn.
+class UnicodeBlockScanner {
+public:
+  constexpr explicit UnicodeBlockScanner(zc::ArrayPtr<const UnicodeRange> ranges)
+      : ranges(ranges) {}
+
+  /// Skip the blocks no range touches and return the index of the block `next()` produces.
+  /// Returns kUnicodeBlockCount once every range has been consumed.
+  constexpr uint32_t skipEmpty() {
+    while (cursor < ranges.size() && ranges[cursor].end < (blockIndex << kUnicodeBlockBits)) {
+      ++cursor;
+    }
+    if (cursor == ranges.size()) { return blockIndex = kUnicodeBlockCount; }
+    const uint32_t start = ranges[cursor].start >> kUnicodeBlockBits;
+    if (start > blockIndex) { blockIndex = start; }
+    return blockIndex;
+  }
+
+  constexpr UnicodeBlock next() {
+    UnicodeBlock block;
+    const uint32_t first = blockIndex++ << kUnicodeBlockBits;
+    const uint32_t last = first + kUnicodeBlockSize - 1;
+
+    for (size_t i = cursor; i < ranges.size() && ranges[i].start <= last; ++i) {
+      const uint32_t lo = (ranges[i].start > first ? ranges[i].start : first) - first;
+      const uint32_t hi = (ranges[i].end < last ? ranges[i].end : last) - first;
+      for (uint32_t w = lo / 64; w <= hi / 64; ++w) {
+        const uint32_t from = w == lo / 64 ? lo % 64 : 0;
+        const uint32_t to = w == hi / 64 ? hi % 64 : 63;
+        block.words[w] |= (~uint64_t(0) >> (63 - to)) & (~uint64_t(0) << from);
+      }
+    }
+    return block;
+  }
+
+private:
+  const zc::ArrayPtr<const UnicodeRange> ranges;
+  size_t cursor = 0;
+  uint32_t blockIndex = 0;
+};
+
+/// Assign the blocks of `ranges` slots in the deduplicated block array, calling
+/// `assign(blockIndex, slot, block)` for each block with a bit set, and return the number of slots
+/// used. Slot 0 is the all-clear block, left implicit for the blocks skipped here, and slot 1 the
+/// all-set block.
+template <typename Func>
+constexpr size_t assignUnicodeBlocks(zc::ArrayPtr<const UnicodeRange> ranges, Func&& assign) {
+  UnicodeBlock full;
+  for (auto& word : full.words) { word = ~uint64_t(0); }
+
+  UnicodeBlockScanner scanner(ranges);
+  UnicodeBlock previous;
+  size_t count = 2;
+  for (uint32_t i = scanner.skipEmpty(); i < kUnicodeBlockCount; i = scanner.skipEmpty()) {
+    const UnicodeBlock block = scanner.next();
+    size_t slot;
+    if (block == full) {
+      slot = 1;
+    } else {
+      if (count == 2 || !(block == previous)) {
+        previous = block;
+        ++count;
+      }
+      slot = count - 1;
+    }
+    assign(i, slot, block);
+  }
+  return count;
+}
+
+constexpr size_t countUnicodeBlocks(zc::ArrayPtr<const UnicodeRange> ranges) {
+  return assignUnicodeBlocks(ranges, [](uint32_t, size_t, const UnicodeBlock&) {});
+}
+
+template <size_t BlockCount>
+struct UnicodeTable {
+  static_assert(BlockCount <= 0x10000, "block slot must fit in uint16_t");
+
+  uint16_t index[kUnicodeBlockCount] = {};
+  UnicodeBlock blocks[BlockCount] = {};
+
+  constexpr bool contains(uint32_t codePoint) const {
+    if (codePoint >= kUnicodeCodePointLimit) { return false; }
+    const UnicodeBlock& block = blocks[index[codePoint >> kUnicodeBlockBits]];
+    return (block.words[(codePoint >> 6) & (kUnicodeBlockWords - 1)] >> (codePoint & 63)) & 1;
+  }
+};
+
+template <size_t BlockCount>
+constexpr UnicodeTable<BlockCount> buildUnicodeTable(zc::ArrayPtr<const UnicodeRange> ranges) {
+  UnicodeTable<BlockCount> table;
+  assignUnicodeBlocks(ranges, [&table](uint32_t i, size_t slot, const UnicodeBlock& block) {
+    table.index[i] = static_cast<uint16_t>(slot);
+    table.blocks[slot] = block;
+  });
+  return table;
+}
+
+constexpr auto kIdStartTable =
+    buildUnicodeTable<countUnicodeBlocks(ID_START_RANGES)>(ID_START_RANGES);
+
+constexpr auto kIdPartTable = buildUnicodeTable<countUnicodeBlocks(ID_PART_RANGES)>(ID_PART_RANGES);
+
+static_assert(kIdStartTable.contains(0x4E00) && !kIdStartTable.contains(0x0030));
+static_assert(kIdPartTable.contains(0x0030) && kIdPartTable.contains(0xE01EF));
+
+}  // namespace
+
+bool isIdStart(const uint32_t codePoint) { return kIdStartTable.contains(codePoint); }
+
+bool isIdPart(const uint32_t codePoint) { return kIdPartTable.contains(codePoint); }
 
 bool isInUnicodeRange(const uint32_t codePoint, const zc::ArrayPtr<const UnicodeRange>& ranges) {
   size_t left = 0;
@@ -14,6 +14,8 @@
 
 #include "zomlang/compiler/lexer/utils.h"
 
+#include <cstring>
+
 #include "zomlang/compiler/lexer/unicode-data.h"
 
 namespace zomlang {
@@ -163,112 +165,95 @@ bool isValidIdentifier(zc::StringPtr s) {
   return true;
 }
 
+namespace {
+
+// Keyword recognition runs on every identifier the lexer produces, so it is backed by a perfect
+// hash built at compile time from keywords.def: one hash and at most one compare per lookup.
+
+struct KeywordEntry {
+  const char* text;
+  size_t size;
+  ast::SyntaxKind kind;
+};
+
+constexpr KeywordEntry kKeywords[] = {
+#define ZOM_KEYWORD(Kind, Text) {Text, sizeof(Text) - 1, ast::SyntaxKind::Kind},
+#include "zomlang/compiler/lexer/keywords.def"
+};
+
+constexpr size_t kKeywordCount = sizeof(kKeywords) / sizeof(kKeywords[0]);
+constexpr size_t kKeywordSlotCount = 2048;
+constexpr uint8_t kEmptyKeywordSlot = 0xff;
+static_assert(kKeywordCount < kEmptyKeywordSlot, "keyword index must fit in a slot");
+static_assert((kKeywordSlotCount & (kKeywordSlotCount - 1)) == 0, "slot count must be 2^n");
+
+constexpr size_t keywordLengthBound(bool wantMax) {
+  size_t bound = kKeywords[0].size;
+  for (const auto& entry : kKeywords) {
+    if (wantMax ? entry.size > bound : entry.size < bound) { bound = entry.size; }
+  }
+  return bound;
+}
+
+constexpr size_t kMinKeywordLength = keywordLengthBound(false);
+constexpr size_t kMaxKeywordLength = keywordLengthBound(true);
+
+template <typename Char>
+constexpr uint32_t hashKeyword(const Char* text, size_t size, uint32_t seed) {
+  // FNV-1a with a searchable seed; keywords are short, so hashing every byte is cheap.
+  uint32_t h = seed ^ static_cast<uint32_t>(size);
+  for (size_t i = 0; i < size; ++i) { h = (h ^ static_cast<uint8_t>(text[i])) * 16777619u; }
+  h ^= h >> 15;
+  return h & (kKeywordSlotCount - 1);
+}
+
+struct KeywordTable {
+  uint32_t seed = 0;
+  uint8_t slots[kKeywordSlotCount] = {};
+};
+
+constexpr KeywordTable buildKeywordTable() {
+  // Search for a seed under which every keyword lands in its own slot. Duplicate spellings in
+  // keywords.def can never satisfy this and leave `seed` at 0, which trips the assert below.
+  KeywordTable table;
+  for (uint32_t seed = 2166136261u; seed < 2166136261u + 4096; ++seed) {
+    for (auto& slot : table.slots) { slot = kEmptyKeywordSlot; }
+
+    bool collided = false;
+    for (size_t i = 0; i < kKeywordCount && !collided; ++i) {
+      uint32_t slot = hashKeyword(kKeywords[i].text, kKeywords[i].size, seed);
+      if (table.slots[slot] != kEmptyKeywordSlot) {
+        collided = true;
+      } else {
+        table.slots[slot] = static_cast<uint8_t>(i);
+      }
+    }
+
+    if (!collided) {
+      table.seed = seed;
+      return table;
+    }
+  }
+  return table;
+}
+
+constexpr KeywordTable kKeywordTable = buildKeywordTable();
+static_assert(kKeywordTable.seed != 0, "no perfect hash seed found for keywords.def");
+
+}  // namespace
+
 ast::SyntaxKind getKeywordKind(zc::ArrayPtr<const zc::byte> text) {
-  if (text == "abstract"_zcb) return ast::SyntaxKind::AbstractKeyword;
-  if (text == "accessor"_zcb) return ast::SyntaxKind::AccessorKeyword;
-  if (text == "any"_zcb) return ast::SyntaxKind::AnyKeyword;
-  if (text == "as"_zcb) return ast::SyntaxKind::AsKeyword;
-  if (text == "asserts"_zcb) return ast::SyntaxKind::AssertsKeyword;
-  if (text == "assert"_zcb) return ast::SyntaxKind::AssertKeyword;
-  if (text == "async"_zcb) return ast::SyntaxKind::AsyncKeyword;
-  if (text == "await"_zcb) return ast::SyntaxKind::AwaitKeyword;
-  if (text == "bigint"_zcb) return ast::SyntaxKind::BigIntKeyword;
-  if (text == "bool"_zcb) return ast::SyntaxKind::BoolKeyword;
-  if (text == "break"_zcb) return ast::SyntaxKind::BreakKeyword;
-  if (text == "case"_zcb) return ast::SyntaxKind::CaseKeyword;
-  if (text == "catch"_zcb) return ast::SyntaxKind::CatchKeyword;
-  if (text == "class"_zcb) return ast::SyntaxKind::ClassKeyword;
-  if (text == "continue"_zcb) return ast::SyntaxKind::ContinueKeyword;
-  if (text == "const"_zcb) return ast::SyntaxKind::ConstKeyword;
-  if (text == "constructor"_zcb) return ast::SyntaxKind::ConstructorKeyword;
-  if (text == "debugger"_zcb) return ast::SyntaxKind::DebuggerKeyword;
-  if (text == "declare"_zcb) return ast::SyntaxKind::DeclareKeyword;
-  if (text == "default"_zcb) return ast::SyntaxKind::DefaultKeyword;
-  if (text == "delete"_zcb) return ast::SyntaxKind::DeleteKeyword;
-  if (text == "do"_zcb) return ast::SyntaxKind::DoKeyword;
-  if (text == "extends"_zcb) return ast::SyntaxKind::ExtendsKeyword;
-  if (text == "export"_zcb) return ast::SyntaxKind::ExportKeyword;
-  if (text == "false"_zcb) return ast::SyntaxKind::FalseKeyword;
-  if (text == "finally"_zcb) return ast::SyntaxKind::FinallyKeyword;
-  if (text == "from"_zcb) return ast::SyntaxKind::FromKeyword;
-  if (text == "fun"_zcb) return ast::SyntaxKind::FunKeyword;
-  if (text == "get"_zcb) return ast::SyntaxKind::GetKeyword;
-  if (text == "global"_zcb) return ast::SyntaxKind::GlobalKeyword;
-  if (text == "if"_zcb) return ast::SyntaxKind::IfKeyword;
-  if (text == "immediate"_zcb) return ast::SyntaxKind::ImmediateKeyword;
-  if (text == "implements"_zcb) return ast::SyntaxKind::ImplementsKeyword;
-  if (text == "import"_zcb) return ast::SyntaxKind::ImportKeyword;
-  if (text == "in"_zcb) return ast::SyntaxKind::InKeyword;
-  if (text == "infer"_zcb) return ast::SyntaxKind::InferKeyword;
-  if (text == "instanceof"_zcb) return ast::SyntaxKind::InstanceOfKeyword;
-  if (text == "interface"_zcb) return ast::SyntaxKind::InterfaceKeyword;
-  if (text == "intrinsic"_zcb) return ast::SyntaxKind::IntrinsicKeyword;
-  if (text == "is"_zcb) return ast::SyntaxKind::IsKeyword;
-  if (text == "keyof"_zcb) return ast::SyntaxKind::KeyOfKeyword;
-  if (text == "let"_zcb) return ast::SyntaxKind::LetKeyword;
-  if (text == "match"_zcb) return ast::SyntaxKind::MatchKeyword;
-  if (text == "module"_zcb) return ast::SyntaxKind::ModuleKeyword;
-  if (text == "mutating"_zcb) return ast::SyntaxKind::MutatingKeyword;
-  if (text == "namespace"_zcb) return ast::SyntaxKind::NamespaceKeyword;
-  if (text == "never"_zcb) return ast::SyntaxKind::NeverKeyword;
-  if (text == "new"_zcb) return ast::SyntaxKind::NewKeyword;
-  if (text == "null"_zcb) return ast::SyntaxKind::NullKeyword;
-  if (text == "object"_zcb) return ast::SyntaxKind::ObjectKeyword;
-  if (text == "of"_zcb) return ast::SyntaxKind::OfKeyword;
-  if (text == "optional"_zcb) return ast::SyntaxKind::OptionalKeyword;
-  if (text == "out"_zcb) return ast::SyntaxKind::OutKeyword;
-  if (text == "override"_zcb) return ast::SyntaxKind::OverrideKeyword;
-  if (text == "package"_zcb) return ast::SyntaxKind::PackageKeyword;
-  if (text == "private"_zcb) return ast::SyntaxKind::PrivateKeyword;
-  if (text == "protected"_zcb) return ast::SyntaxKind::ProtectedKeyword;
-  if (text == "public"_zcb) return ast::SyntaxKind::PublicKeyword;
-  if (text == "readonly"_zcb) return ast::SyntaxKind::ReadonlyKeyword;
-  if (text == "require"_zcb) return ast::SyntaxKind::RequireKeyword;
-  if (text == "return"_zcb) return ast::SyntaxKind::ReturnKeyword;
-  if (text == "satisfies"_zcb) return ast::SyntaxKind::SatisfiesKeyword;
-  if (text == "set"_zcb) return ast::SyntaxKind::SetKeyword;
-  if (text == "static"_zcb) return ast::SyntaxKind::StaticKeyword;
-  if (text == "super"_zcb) return ast::SyntaxKind::SuperKeyword;
-  if (text == "symbol"_zcb) return ast::SyntaxKind::SymbolKeyword;
-  if (text == "this"_zcb) return ast::SyntaxKind::ThisKeyword;
-  if (text == "throw"_zcb) return ast::SyntaxKind::ThrowKeyword;
-  if (text == "true"_zcb) return ast::SyntaxKind::TrueKeyword;
-  if (text == "try"_zcb) return ast::SyntaxKind::TryKeyword;
-  if (text == "typeof"_zcb) return ast::SyntaxKind::TypeOfKeyword;
-  if (text == "undefined"_zcb) return ast::SyntaxKind::UndefinedKeyword;
-  if (text == "unique"_zcb) return ast::SyntaxKind::UniqueKeyword;
-  if (text == "using"_zcb) return ast::SyntaxKind::UsingKeyword;
-  if (text == "when"_zcb) return ast::SyntaxKind::WhenKeyword;
-  if (text == "with"_zcb) return ast::SyntaxKind::WithKeyword;
-  if (text == "yield"_zcb) return ast::SyntaxKind::YieldKeyword;
-
-  if (text == "bool"_zcb) return ast::SyntaxKind::BoolKeyword;
-  if (text == "i8"_zcb) return ast::SyntaxKind::I8Keyword;
-  if (text == "i16"_zcb) return ast::SyntaxKind::I16Keyword;
-  if (text == "i32"_zcb) return ast::SyntaxKind::I32Keyword;
-  if (text == "i64"_zcb) return ast::SyntaxKind::I64Keyword;
-  if (text == "u8"_zcb) return ast::SyntaxKind::U8Keyword;
-  if (text == "u16"_zcb) return ast::SyntaxKind::U16Keyword;
-  if (text == "u32"_zcb) return ast::SyntaxKind::U32Keyword;
-  if (text == "u64"_zcb) return ast::SyntaxKind::U64Keyword;
-  if (text == "f32"_zcb) return ast::SyntaxKind::F32Keyword;
-  if (text == "f64"_zcb) return ast::SyntaxKind::F64Keyword;
-  if (text == "str"_zcb) return ast::SyntaxKind::StrKeyword;
-  if (text == "unit"_zcb) return ast::SyntaxKind::UnitKeyword;
-  if (text == "null"_zcb) return ast::SyntaxKind::NullKeyword;
-  if (text == "else"_zcb) return ast::SyntaxKind::ElseKeyword;
-  if (text == "for"_zcb) return ast::SyntaxKind::ForKeyword;
-  if (text == "while"_zcb) return ast::SyntaxKind::WhileKeyword;
-  if (text == "struct"_zcb) return ast::SyntaxKind::StructKeyword;
-  if (text == "enum"_zcb) return ast::SyntaxKind::EnumKeyword;
-  if (text == "error"_zcb) return ast::SyntaxKind::ErrorKeyword;
-  if (text == "alias"_zcb) return ast::SyntaxKind::AliasKeyword;
-  if (text == "init"_zcb) return ast::SyntaxKind::InitKeyword;
-  if (text == "deinit"_zcb) return ast::SyntaxKind::DeinitKeyword;
-  if (text == "raises"_zcb) return ast::SyntaxKind::RaisesKeyword;
-  if (text == "type"_zcb) return ast::SyntaxKind::TypeKeyword;
-
-  return ast::SyntaxKind::Identifier;
+  size_t size = text.size();
+  if (size < kMinKeywordLength || size > kMaxKeywordLength) { return ast::SyntaxKind::Identifier; }
+
+  uint8_t index = kKeywordTable.slots[hashKeyword(text.begin(), size, kKeywordTable.seed)];
+  if (index == kEmptyKeywordSlot) { return ast::SyntaxKind::Identifier; }
+
+  const KeywordEntry& entry = kKeywords[index];
+  if (entry.size != size || memcmp(entry.text, text.begin(), size) != 0) {
+    return ast::SyntaxKind::Identifier;
+  }
+  return entry.kind;
 }
 
 // =======================================================================================
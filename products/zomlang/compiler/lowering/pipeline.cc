@@ -0,0 +1,105 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lowering/pipeline.h"
+
+#include "zc/core/mutex.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lowering {
+
+struct LoweringPipeline::Impl {
+  struct Queue {
+    zc::Vector<ObjectFragment> fragments;
+    /// True while a task is handing fragments to the sink
+    bool draining = false;
+    size_t maxQueued = 0;
+  };
+
+  basic::ThreadPool& threadPool;
+  FunctionLowering& lowering;
+  ObjectSink& sink;
+  zc::MutexGuarded<Queue> queue;
+
+  Impl(basic::ThreadPool& threadPool, FunctionLowering& lowering, ObjectSink& sink)
+      : threadPool(threadPool), lowering(lowering), sink(sink) {}
+
+  void lowerUnit(const FunctionUnit& unit, size_t index) {
+    zc::Own<LoweredFunction> function = lowering.lower(unit);
+    lowering.optimize(*function);
+    ObjectFragment fragment = lowering.emit(zc::mv(function));
+    fragment.index = index;
+    deliver(zc::mv(fragment));
+  }
+
+  /// Queue a fragment, and drain the queue into the sink unless another task already is.
+  void deliver(ObjectFragment fragment) {
+    {
+      auto locked = queue.lockExclusive();
+      locked->fragments.add(zc::mv(fragment));
+      locked->maxQueued = zc::max(locked->maxQueued, locked->fragments.size());
+      if (locked->draining) { return; }
+      locked->draining = true;
+    }
+    drain();
+  }
+
+  /// Hand queued fragments to the sink, outside of the lock, until the queue stays empty.
+  void drain() {
+    zc::Vector<ObjectFragment> batch;
+    for (;;) {
+      {
+        auto locked = queue.lockExclusive();
+        if (locked->fragments.empty()) {
+          locked->draining = false;
+          return;
+        }
+        batch = zc::mv(locked->fragments);
+      }
+      // Should the sink throw, draining stays set, so that nothing more reaches it
+      for (auto& fragment : batch) { sink.add(zc::mv(fragment)); }
+    }
+  }
+};
+
+LoweringPipeline::LoweringPipeline(basic::ThreadPool& threadPool, FunctionLowering& lowering,
+                                   ObjectSink& sink) noexcept
+    : impl(zc::heap<Impl>(threadPool, lowering, sink)) {}
+
+LoweringPipeline::~LoweringPipeline() noexcept(false) = default;
+
+void LoweringPipeline::run(zc::ArrayPtr<const FunctionUnit> units) {
+  *impl->queue.lockExclusive() = Impl::Queue();
+
+  basic::TaskGroup group(impl->threadPool);
+  for (size_t i = 0; i < units.size(); ++i) {
+    group.fork([this, &unit = units[i], i]() { impl->lowerUnit(unit, i); });
+  }
+  group.join();
+
+  // Every task drained what it queued before finishing, unless another task was draining then,
+  // in which case that one picked it up
+  ZC_ASSERT(impl->queue.lockShared()->fragments.empty());
+  impl->sink.finish();
+}
+
+size_t LoweringPipeline::getMaxQueuedFragments() const {
+  return impl->queue.lockShared()->maxQueued;
+}
+
+}  // namespace lowering
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/array.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lowering {
+
+/// \brief One function to lower.
+struct FunctionUnit {
+  const ast::FunctionDeclaration& function;
+  /// The module the function belongs to, e.g. `a.b`, or its file's name if it declares none
+  zc::StringPtr moduleName;
+};
+
+/// \brief A function part way through lowering, in whatever form the code generator gives it.
+class LoweredFunction {
+public:
+  virtual ~LoweredFunction() noexcept(false) = default;
+};
+
+/// \brief The code of one function, ready for the linker.
+struct ObjectFragment {
+  /// Index of the unit the fragment was emitted from. Fragments arrive in the order they are
+  /// emitted, which varies from run to run; the linker lays them out by index.
+  size_t index = 0;
+  zc::String symbol;
+  zc::Array<zc::byte> bytes;
+};
+
+/// \brief The stages every function goes through, implemented by a code generator.
+///
+/// Each is called for one function at a time but from any thread, and concurrently for
+/// different functions, so an implementation keeps whatever state a function needs in its
+/// `LoweredFunction`.
+class FunctionLowering {
+public:
+  virtual ~FunctionLowering() noexcept(false) = default;
+
+  virtual zc::Own<LoweredFunction> lower(const FunctionUnit& unit) = 0;
+  virtual void optimize(LoweredFunction& function) = 0;
+  virtual ObjectFragment emit(zc::Own<LoweredFunction> function) = 0;
+};
+
+/// \brief Where object fragments go as they are emitted, e.g. a linker.
+///
+/// Called by one thread at a time, though not always the same one.
+class ObjectSink {
+public:
+  virtual ~ObjectSink() noexcept(false) = default;
+
+  virtual void add(ObjectFragment fragment) = 0;
+  /// \brief Called once, after the last fragment.
+  virtual void finish() = 0;
+};
+
+/// \brief Lowers functions in parallel, streaming their objects to a sink as they are emitted.
+///
+/// Each function is a task of its own on the thread pool, going through lower, optimize and emit
+/// in turn, so that while one function is being optimized others are being lowered or emitted.
+/// An emitted fragment is queued, and whichever task finds the sink idle drains the queue into
+/// it. The sink thus consumes fragments while the rest are still being generated rather than in
+/// a serial stage after the last one, and no task ever waits for it.
+class LoweringPipeline {
+public:
+  LoweringPipeline(basic::ThreadPool& threadPool, FunctionLowering& lowering,
+                   ObjectSink& sink) noexcept;
+  ~LoweringPipeline() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(LoweringPipeline);
+
+  /// \brief Lower every unit, then finish the sink. Must not be called from one of the pool's
+  /// tasks. If a stage or the sink throws, the functions not started yet are skipped, the sink
+  /// is not finished, and the first exception is rethrown.
+  void run(zc::ArrayPtr<const FunctionUnit> units);
+
+  /// \brief The most fragments that were waiting for the sink at once during the last `run()`,
+  /// which stays low as long as the sink keeps up with code generation.
+  size_t getMaxQueuedFragments() const;
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+};
+
+}  // namespace lowering
+}  // namespace compiler
+}  // namespace zomlang
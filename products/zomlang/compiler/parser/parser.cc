@@ -14,9 +14,11 @@
 
 #include "zomlang/compiler/parser/parser.h"
 
+#include "zc/core/arena.h"
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
 #include "zc/core/function.h"
+#include "zc/core/map.h"
 #include "zc/core/memory.h"
 #include "zc/core/one-of.h"
 #include "zc/core/string.h"
@@ -49,48 +51,6 @@ namespace parser {
 
 namespace {
 
-// Get AST binary operator precedence directly from token
-ast::OperatorPrecedence getBinaryOperatorPrecedence(ast::SyntaxKind tokenKind) {
-  switch (tokenKind) {
-    case ast::SyntaxKind::BarBar:
-      return ast::OperatorPrecedence::kLogicalOr;
-    case ast::SyntaxKind::AmpersandAmpersand:
-      return ast::OperatorPrecedence::kLogicalAnd;
-    case ast::SyntaxKind::Bar:
-      return ast::OperatorPrecedence::kBitwiseOr;
-    case ast::SyntaxKind::Caret:
-      return ast::OperatorPrecedence::kBitwiseXor;
-    case ast::SyntaxKind::Ampersand:
-      return ast::OperatorPrecedence::kBitwiseAnd;
-    case ast::SyntaxKind::EqualsEquals:
-    case ast::SyntaxKind::ExclamationEquals:
-      return ast::OperatorPrecedence::kEquality;
-    case ast::SyntaxKind::LessThan:
-    case ast::SyntaxKind::GreaterThan:
-    case ast::SyntaxKind::LessThanEquals:
-    case ast::SyntaxKind::GreaterThanEquals:
-    case ast::SyntaxKind::AsKeyword:
-      return ast::OperatorPrecedence::kRelational;
-    case ast::SyntaxKind::LessThanLessThan:
-    case ast::SyntaxKind::GreaterThanGreaterThan:
-    case ast::SyntaxKind::GreaterThanGreaterThanGreaterThan:
-      return ast::OperatorPrecedence::kShift;
-    case ast::SyntaxKind::QuestionQuestion:
-      return ast::OperatorPrecedence::kLogicalOr;
-    case ast::SyntaxKind::Plus:
-    case ast::SyntaxKind::Minus:
-      return ast::OperatorPrecedence::kAdditive;
-    case ast::SyntaxKind::Asterisk:
-    case ast::SyntaxKind::Slash:
-    case ast::SyntaxKind::Percent:
-      return ast::OperatorPrecedence::kMultiplicative;
-    case ast::SyntaxKind::AsteriskAsterisk:
-      return ast::OperatorPrecedence::kExponentiation;
-    default:
-      return ast::OperatorPrecedence::kLowest;
-  }
-}
-
 // Check if token is an assignment operator
 bool isAssignmentOperator(ast::SyntaxKind tokenKind) {
   switch (tokenKind) {
@@ -166,6 +126,21 @@ void markNonNullOptionalChain(ast::Expression& expression) {
   markNonNullOptionalChain(next);
 }
 
+/// First chunk size of a SourceFile's AST arena; later chunks grow from there. The chunks come
+/// from the process-wide pool, so that a long-running process which reparses files reuses the
+/// chunks of the trees it dropped.
+constexpr size_t kAstArenaChunkSize = 64 * 1024;
+
+zc::Own<zc::Arena> newAstArena() {
+  return zc::heap<zc::Arena>(zc::ArenaChunkPool::getGlobal(), kAstArenaChunkSize);
+}
+
+/// Speculative parses whose outcome at a token position is remembered for the rest of the parse.
+enum class SpeculationRule : uint8_t {
+  UnambiguouslyStartOfFunctionType,
+  TypeArgumentsInExpression,
+};
+
 }  // namespace
 
 // ================================================================================
@@ -179,13 +154,137 @@ struct Parser::Impl {
         sourceMgr(sourceMgr),
         diagnosticEngine(diagnosticEngine),
         stringPool(stringPool),
-        lexer(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId) {}
+        useAstArena(langOpts.useAstArena),
+        langOpts(langOpts),
+        lexer(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId) {
+    tokens.add(BufferedToken{lexer.getCurrentState(), false});
+  }
   ~Impl() noexcept(false) = default;
 
   ZC_DISALLOW_COPY_AND_MOVE(Impl);
 
-  /// Helper to get the next token from the lexer
-  void nextToken() { lexer.lex(token); }
+  /// A token the lexer has produced, stored as the lexer state right after lexing it.
+  struct BufferedToken {
+    lexer::LexerState state;
+    /// True if it was lexed while diagnostics were suppressed, so its lexer errors were dropped.
+    bool lexedWhileSuppressed;
+  };
+
+  /// Helper to get the next token, from the buffer when it has already been lexed
+  void nextToken() {
+    ++position;
+    if (position == tokens.size()) {
+      lexAtEnd();
+    } else if (tokens[position].lexedWhileSuppressed && !diagnosticEngine.isSuppressed()) {
+      // First seen during a speculative parse; lex it again so its diagnostics get reported.
+      relexForDiagnostics();
+    }
+    token = tokens[position].state.token;
+  }
+
+  /// Lex the current token again with diagnostics on. The tokens buffered after it are kept
+  /// unless it comes out differently, which only a re-scan can cause; dropping them every time
+  /// would relex the whole lookahead of each failed speculation once per token.
+  void relexForDiagnostics() {
+    const lexer::LexerState buffered = tokens[position].state;
+    lexer.restoreState(tokens[position - 1].state);
+    lexer::Token relexed;
+    lexer.lex(relexed);
+    const lexer::LexerState state = lexer.getCurrentState();
+    if (state.curPtr == buffered.curPtr && relexed.getKind() == buffered.token.getKind()) {
+      tokens[position] = BufferedToken{state, false};
+      lexer.restoreState(tokens.back().state);
+    } else {
+      truncate(position);
+      tokens.add(BufferedToken{state, false});
+      speculations.clear();
+    }
+  }
+
+  /// Helper to look `n` tokens past the current one without moving
+  const lexer::Token& peekAhead(unsigned n) {
+    while (tokens.size() <= position + n) { lexAtEnd(); }
+    return tokens[position + n].state.token;
+  }
+
+  /// Lex one more token onto the end of the buffer. The lexer always sits at `tokens.back()`.
+  void lexAtEnd() {
+    lexer::Token next;
+    lexer.lex(next);
+    tokens.add(BufferedToken{lexer.getCurrentState(), diagnosticEngine.isSuppressed()});
+  }
+
+  /// Drop every buffered token from `size` on, along with any re-scans recorded for them.
+  void truncate(size_t size) {
+    tokens.truncate(size);
+    while (!rescans.empty() && rescans.back() >= size) { rescans.removeLast(); }
+  }
+
+  /// Re-scan the current token in place with `rescan`, which runs against the lexer.
+  template <typename Func>
+  ast::SyntaxKind rescanCurrent(Func&& rescan) {
+    const bool atEnd = position + 1 == tokens.size();
+    if (!atEnd) { lexer.restoreState(tokens[position].state); }
+    const lexer::LexerState before = tokens[position].state;
+    ast::SyntaxKind kind = rescan();
+    const lexer::LexerState after = lexer.getCurrentState();
+    tokens[position].state = after;
+    token = after.token;
+    if (after.curPtr == before.curPtr && after.token.getKind() == before.token.getKind()) {
+      // The token is unchanged, so the ones buffered after it still hold. Keeping them is what
+      // stops every `>` in nested lookahead from relexing the rest of the lookahead.
+      if (!atEnd) { lexer.restoreState(tokens.back().state); }
+      return kind;
+    }
+    truncate(position + 1);
+    if (rescans.empty() || rescans.back() != position) { rescans.add(position); }
+    speculations.clear();
+    return kind;
+  }
+
+  /// Move back to a position taken by `Parser::mark()`.
+  void rewind(const ParserState& state) {
+    position = state.position;
+    ZC_DASSERT(position < tokens.size(), "Rewinding past a token that was re-scanned away.");
+    if (!rescans.empty() && rescans.back() >= position) {
+      // Tokens from here on were lexed after a re-scan that the caller is now undoing.
+      bool suppressed = tokens[position].lexedWhileSuppressed;
+      truncate(position);
+      tokens.add(BufferedToken{state.lexerState, suppressed});
+      lexer.restoreState(state.lexerState);
+      speculations.clear();
+    }
+    token = tokens[position].state.token;
+  }
+
+  /// Start over on bytes [begin, end) of the buffer, before the first token is read.
+  void restrictTo(uint32_t begin, uint32_t end) {
+    lexer.restrictToRange(begin, end);
+    truncate(0);
+    tokens.add(BufferedToken{lexer.getCurrentState(), false});
+    position = 0;
+    speculations.clear();
+  }
+
+  /// Outcome of an earlier speculative parse of `rule` at the current token, if there was one.
+  zc::Maybe<bool> findSpeculation(SpeculationRule rule) const {
+    ZC_IF_SOME(outcome, speculations.find(speculationKey(rule))) { return outcome; }
+    return zc::none;
+  }
+
+  void recordSpeculation(SpeculationRule rule, bool outcome) {
+    speculations.upsert(speculationKey(rule), outcome);
+  }
+
+  /// Some speculative parses observe whether diagnostics are being reported, so that is part of
+  /// the key along with the rule and the token position.
+  uint64_t speculationKey(SpeculationRule rule) const {
+    return static_cast<uint64_t>(position) << 8 | static_cast<uint64_t>(rule) << 1 |
+           static_cast<uint64_t>(diagnosticEngine.isSuppressed());
+  }
+
+  /// Helper to get the lexer state of the current token
+  const lexer::LexerState& currentState() const { return tokens[position].state; }
 
   /// Helper to look at the current token
   const lexer::Token& peekToken() const { return token; }
@@ -197,9 +296,28 @@ struct Parser::Impl {
   const source::SourceManager& sourceMgr;
   diagnostics::DiagnosticEngine& diagnosticEngine;
   basic::StringPool& stringPool;
+  /// Whether parseSourceFile() allocates the tree from an arena owned by the SourceFile
+  const bool useAstArena;
+  /// Copied so that deferred function bodies can be parsed after this parser is gone
+  const basic::LangOptions langOpts;
   lexer::Lexer lexer;
   lexer::Token token;
 
+  /// Every token lexed so far, in source order; `tokens[position]` is the current token. Entry 0
+  /// is the lexer's initial state. Lookahead and rewind just move `position` through the buffer.
+  zc::Vector<BufferedToken> tokens;
+  size_t position = 0;
+  /// Positions whose token was re-scanned in place, ascending. Tokens after such a position
+  /// depend on the re-scan, so rewinding to or before it discards them.
+  zc::Vector<size_t> rescans;
+  /// Outcomes of speculative parses by `speculationKey()`. Re-scans change the tokens that they
+  /// were based on, so the table is cleared whenever one takes effect or is undone.
+  zc::HashMap<uint64_t, bool> speculations;
+  /// Children of the lists being parsed, innermost list on top; see `Parser::ListScratch`.
+  zc::Vector<zc::Own<ast::Node>> listScratch;
+  /// Told about each top-level statement as `parseSourceFile()` completes it.
+  zc::Maybe<StatementListener&> statementListener;
+
   ParsingContexts context;
 };
 
@@ -216,15 +334,9 @@ Parser::~Parser() noexcept(false) = default;
 // ================================================================================
 // Parser State Management (tryParse implementation)
 
-ParserState Parser::mark() {
-  auto lexerState = impl->lexer.getCurrentState();
-  return ParserState{lexerState, impl->token};
-}
+ParserState Parser::mark() { return ParserState{impl->position, impl->currentState()}; }
 
-void Parser::rewind(const ParserState& state) {
-  impl->lexer.restoreState(state.lexerState);
-  impl->token = state.token;
-}
+void Parser::rewind(const ParserState& state) { impl->rewind(state); }
 
 ParsingContexts Parser::getContext() const { return impl->context; }
 
@@ -492,25 +604,32 @@ void Parser::parsingContextErrors(ParsingContext context) {
 void Parser::initializeState() {
   // Set initial context
   impl->context = 0;
+  impl->listScratch.clear();
+}
+
+zc::Vector<zc::Own<ast::Node>>& Parser::getListScratch() { return impl->listScratch; }
+
+void Parser::setStatementListener(StatementListener& listener) {
+  impl->statementListener = listener;
 }
 
 zc::Maybe<zc::Own<ast::Node>> Parser::parse() {
-  trace::FunctionTracer functionTracer(trace::TraceCategory::kParser, __FUNCTION__);
+  ZOM_TRACE_FUNCTION(trace::TraceCategory::kParser);
 
   initializeState();
 
   ZC_IF_SOME(sourceFileNode, parseSourceFile()) {
-    trace::traceEvent(trace::TraceCategory::kParser, "Parse completed successfully");
+    ZOM_TRACE_EVENT(trace::TraceCategory::kParser, "Parse completed successfully");
     return zc::mv(sourceFileNode);
   }
 
-  trace::traceEvent(trace::TraceCategory::kParser, "Parse failed");
+  ZOM_TRACE_EVENT(trace::TraceCategory::kParser, "Parse failed");
 
   return zc::none;
 }
 
 zc::Maybe<zc::Own<ast::TypeQueryNode>> Parser::parseTypeQuery() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeQuery");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeQuery");
 
   // Parse type query according to the grammar rule:
   // typeQuery: TYPEOF typeQueryExpression
@@ -531,7 +650,7 @@ zc::Maybe<zc::Own<ast::TypeQueryNode>> Parser::parseTypeQuery() {
 }
 
 zc::Maybe<zc::Own<ast::Expression>> Parser::parseTypeQueryExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeQueryExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeQueryExpression");
 
   // Parse type query expression according to the grammar rule:
   // typeQueryExpression: identifier (PERIOD identifier)*
@@ -555,7 +674,7 @@ zc::Maybe<zc::Own<ast::Expression>> Parser::parseTypeQueryExpression() {
 }
 
 zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseRaisesClause() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseRaisesClause");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseRaisesClause");
 
   // Parse raises clause according to the grammar rule:
   // raisesClause: RAISES type
@@ -569,10 +688,19 @@ zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseRaisesClause() {
 }
 
 zc::Maybe<zc::Own<ast::SourceFile>> Parser::parseSourceFile() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseSourceFile");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseSourceFile");
 
   // sourceFile: moduleDeclaration? moduleBody?;
 
+  // Build the whole tree in one arena, which the SourceFile adopts once it exists. The arena is
+  // declared first so that it outlives any partial tree dropped on an error.
+  zc::Maybe<zc::Own<zc::Arena>> arena;
+  zc::Maybe<ast::ArenaScope> arenaScope;
+  if (impl->useAstArena) {
+    zc::Own<zc::Arena>& owned = arena.emplace(newAstArena());
+    arenaScope.emplace(*owned);
+  }
+
   // Prim lexer to get the first token
   nextToken();
 
@@ -581,11 +709,16 @@ zc::Maybe<zc::Own<ast::SourceFile>> Parser::parseSourceFile() {
   // Parse Module Declaration
   auto moduleDeclaration = parseModuleDeclaration(/*isStartOfSourceFile*/ true);
   // Parse Module Body
-  auto statements = parseList<ast::Statement>(ParsingContext::SourceElements,
-                                              ZC_BIND_METHOD(*this, parseStatement));
+  auto statements = parseList<ast::Statement>(
+      ParsingContext::SourceElements, [this]() -> zc::Maybe<zc::Own<ast::Statement>> {
+        zc::Maybe<zc::Own<ast::Statement>> statement = parseStatement();
+        ZC_IF_SOME(listener, impl->statementListener) {
+          ZC_IF_SOME(s, statement) { listener.statementParsed(*s); }
+        }
+        return statement;
+      });
 
-  trace::traceCounter(trace::TraceCategory::kParser, "Module items parsed"_zc,
-                      zc::str(statements.size()));
+  ZOM_TRACE_COUNTER(trace::TraceCategory::kParser, "Module items parsed"_zc, statements.size());
 
   // Create the source file node
   zc::StringPtr fileName = getSourceManager().getIdentifierForBuffer(impl->bufferId);
@@ -593,14 +726,189 @@ zc::Maybe<zc::Own<ast::SourceFile>> Parser::parseSourceFile() {
       finishNode(ast::factory::createSourceFile(zc::str(fileName), zc::mv(moduleDeclaration),
                                                 zc::mv(statements)),
                  loc);
+  ZC_IF_SOME(a, arena) { sourceFile->adoptArena(zc::mv(a)); }
 
-  trace::traceEvent(trace::TraceCategory::kParser, "Source file created"_zc, fileName);
+  ZOM_TRACE_EVENT(trace::TraceCategory::kParser, "Source file created"_zc, fileName);
   return finishNode(zc::mv(sourceFile), loc);
 }
 
+SourceChunk Parser::parseChunk(uint32_t begin, uint32_t end) {
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseChunk");
+
+  initializeState();
+  impl->restrictTo(begin, end);
+
+  SourceChunk chunk;
+  zc::Maybe<ast::ArenaScope> arenaScope;
+  if (impl->useAstArena) {
+    zc::Own<zc::Arena>& owned = chunk.arena.emplace(newAstArena());
+    arenaScope.emplace(*owned);
+  }
+
+  nextToken();
+  chunk.start = currentLoc();
+  if (begin == 0) {
+    chunk.moduleDeclaration = parseModuleDeclaration(/*isStartOfSourceFile*/ true);
+  }
+  chunk.statements = parseList<ast::Statement>(ParsingContext::SourceElements,
+                                               ZC_BIND_METHOD(*this, parseStatement));
+  chunk.end = getFullStartLoc();
+  return chunk;
+}
+
+zc::Own<ast::BlockStatement> Parser::parseFunctionBody(uint32_t begin, uint32_t end) {
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionBody");
+
+  initializeState();
+  impl->restrictTo(begin, end);
+
+  zc::Maybe<zc::Own<zc::Arena>> arena;
+  zc::Maybe<ast::ArenaScope> arenaScope;
+  if (impl->useAstArena) {
+    zc::Own<zc::Arena>& owned = arena.emplace(newAstArena());
+    arenaScope.emplace(*owned);
+  }
+
+  nextToken();
+  zc::Own<ast::BlockStatement> body = parseFunctionBlock();
+  arenaScope = zc::none;
+  ZC_IF_SOME(owned, arena) { return body.attach(zc::mv(owned)); }
+  return body;
+}
+
+zc::Maybe<ast::DeferredBody> Parser::skipFunctionBody() {
+  if (!impl->langOpts.lazyFunctionBodies || !expectToken(ast::SyntaxKind::LeftBrace)) {
+    return zc::none;
+  }
+
+  const ParserState start = mark();
+  const uint32_t begin =
+      getSourceManager().getLocOffsetInBuffer(getTokenStartLoc(), impl->bufferId);
+
+  // Skipped tokens are lexed with diagnostics suppressed; parsing the body reports them.
+  getDiagnosticEngine().suppress();
+  uint32_t depth = 0;
+  // Brace depths at which an open template substitution resumes its literal on `}`.
+  zc::Vector<uint32_t> templateDepths;
+  while (true) {
+    const ast::SyntaxKind kind = currentKind();
+    if (kind == ast::SyntaxKind::EndOfFile) {
+      // Unbalanced; parse it now so that recovery sees the rest of the file.
+      getDiagnosticEngine().unsuppress();
+      rewind(start);
+      return zc::none;
+    }
+    if (kind == ast::SyntaxKind::LeftBrace) {
+      ++depth;
+    } else if (kind == ast::SyntaxKind::TemplateHead) {
+      templateDepths.add(depth);
+    } else if (kind == ast::SyntaxKind::RightBrace) {
+      if (!templateDepths.empty() && templateDepths.back() == depth) {
+        if (reScanTemplateToken() == ast::SyntaxKind::TemplateTail) { templateDepths.removeLast(); }
+      } else if (--depth == 0) {
+        break;
+      }
+    }
+    nextToken();
+  }
+  getDiagnosticEngine().unsuppress();
+
+  const uint32_t end =
+      getSourceManager().getLocOffsetInBuffer(currentToken().getRange().getEnd(), impl->bufferId);
+  nextToken();
+
+  const source::SourceManager& sourceMgr = getSourceManager();
+  diagnostics::DiagnosticEngine& diagnosticEngine = getDiagnosticEngine();
+  basic::StringPool& stringPool = impl->stringPool;
+  const basic::LangOptions langOpts = impl->langOpts;
+  const source::BufferId bufferId = impl->bufferId;
+  return ast::DeferredBody{[&sourceMgr, &diagnosticEngine, &stringPool, langOpts, bufferId, begin,
+                            end]() -> zc::Own<ast::Statement> {
+    Parser parser(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId);
+    return parser.parseFunctionBody(begin, end);
+  }};
+}
+
+zc::Vector<uint32_t> findChunkBoundaries(const lexer::TokenTable& tokens, size_t maxChunks) {
+  zc::Vector<uint32_t> boundaries;
+  boundaries.add(0);
+  if (maxChunks <= 1 || tokens.size() < 2) { return boundaries; }
+
+  const uint32_t bufferSize = tokens.starts.back();
+  const uint32_t target = bufferSize / maxChunks;
+  uint32_t nextCut = target;
+  uint32_t depth = 0;
+
+  for (size_t i = 1; i + 1 < tokens.size() && boundaries.size() < maxChunks; ++i) {
+    switch (tokens.kinds[i - 1]) {
+      case ast::SyntaxKind::LeftBrace:
+      case ast::SyntaxKind::LeftParen:
+      case ast::SyntaxKind::LeftBracket:
+        ++depth;
+        break;
+      case ast::SyntaxKind::RightBrace:
+      case ast::SyntaxKind::RightParen:
+      case ast::SyntaxKind::RightBracket:
+        if (depth > 0) { --depth; }
+        break;
+      case ast::SyntaxKind::TemplateHead:
+        return boundaries;
+      default:
+        break;
+    }
+
+    if (depth != 0 || tokens.starts[i] < nextCut) { continue; }
+    const ast::SyntaxKind previous = tokens.kinds[i - 1];
+    if (previous != ast::SyntaxKind::Semicolon && previous != ast::SyntaxKind::RightBrace) {
+      continue;
+    }
+    switch (tokens.kinds[i]) {
+      case ast::SyntaxKind::LetKeyword:
+      case ast::SyntaxKind::ConstKeyword:
+      case ast::SyntaxKind::FunKeyword:
+      case ast::SyntaxKind::ClassKeyword:
+      case ast::SyntaxKind::StructKeyword:
+      case ast::SyntaxKind::EnumKeyword:
+      case ast::SyntaxKind::AliasKeyword: {
+        // Cut where the previous token ends, so that the trivia in between goes with its chunk.
+        const uint32_t cut = tokens.starts[i - 1] + tokens.lengths[i - 1];
+        boundaries.add(cut);
+        nextCut = cut + target;
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  return boundaries;
+}
+
+zc::Own<ast::SourceFile> joinSourceChunks(zc::StringPtr fileName,
+                                          zc::Vector<SourceChunk>&& chunks) {
+  ZC_REQUIRE(!chunks.empty());
+
+  size_t statementCount = 0;
+  for (const SourceChunk& chunk : chunks) { statementCount += chunk.statements.size(); }
+  zc::Vector<zc::Own<ast::Statement>> statements;
+  statements.reserve(statementCount);
+  for (SourceChunk& chunk : chunks) {
+    for (zc::Own<ast::Statement>& statement : chunk.statements) {
+      statements.add(zc::mv(statement));
+    }
+  }
+
+  zc::Own<ast::SourceFile> sourceFile = ast::factory::createSourceFile(
+      zc::str(fileName), zc::mv(chunks.front().moduleDeclaration), zc::mv(statements));
+  sourceFile->setSourceRange(source::SourceRange(chunks.front().start, chunks.back().end));
+  for (SourceChunk& chunk : chunks) {
+    ZC_IF_SOME(arena, chunk.arena) { sourceFile->adoptArena(zc::mv(arena)); }
+  }
+  return sourceFile;
+}
+
 zc::Maybe<zc::Own<ast::ModuleDeclaration>> Parser::parseModuleDeclaration(
     bool isStartOfSourceFile) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseModuleDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseModuleDeclaration");
 
   const lexer::Token& token = currentToken();
 
@@ -622,7 +930,7 @@ zc::Maybe<zc::Own<ast::ModuleDeclaration>> Parser::parseModuleDeclaration(
 }
 
 zc::Maybe<zc::Own<ast::ImportDeclaration>> Parser::parseImportDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseImportDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseImportDeclaration");
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::ImportKeyword)) { return zc::none; }
 
@@ -631,7 +939,7 @@ zc::Maybe<zc::Own<ast::ImportDeclaration>> Parser::parseImportDeclaration() {
 
   ZC_IF_SOME(modulePath, parseModulePath()) {
     zc::Maybe<zc::Own<ast::Identifier>> alias = zc::none;
-    zc::Vector<zc::Own<ast::ImportSpecifier>> specifiers;
+    ListScratch<ast::ImportSpecifier> specifiers(*this);
 
     if (currentToken().is(ast::SyntaxKind::AsKeyword)) {
       nextToken();
@@ -653,7 +961,7 @@ zc::Maybe<zc::Own<ast::ImportDeclaration>> Parser::parseImportDeclaration() {
 
     parseSemicolon();
     return finishNode(ast::factory::createImportDeclaration(zc::mv(modulePath), zc::mv(alias),
-                                                            zc::mv(specifiers)),
+                                                            specifiers.finish()),
                       loc);
   }
 
@@ -661,11 +969,11 @@ zc::Maybe<zc::Own<ast::ImportDeclaration>> Parser::parseImportDeclaration() {
 }
 
 zc::Maybe<zc::Own<ast::ModulePath>> Parser::parseModulePath() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseModulePath");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseModulePath");
   if (!tokenIsIdentifierOrKeyword(currentToken())) { return zc::none; }
 
   source::SourceLoc loc = currentLoc();
-  zc::Vector<zc::Own<ast::Identifier>> segments;
+  ListScratch<ast::Identifier> segments(*this);
   segments.add(parseIdentifierName());
 
   while (currentToken().is(ast::SyntaxKind::Period) && tokenIsIdentifierOrKeyword(lookAhead(1))) {
@@ -673,11 +981,11 @@ zc::Maybe<zc::Own<ast::ModulePath>> Parser::parseModulePath() {
     segments.add(parseIdentifierName());
   }
 
-  return finishNode(ast::factory::createModulePath(zc::mv(segments)), loc);
+  return finishNode(ast::factory::createModulePath(segments.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::ImportSpecifier>> Parser::parseImportSpecifier() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseImportSpecifier");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseImportSpecifier");
   if (!tokenIsIdentifierOrKeyword(currentToken())) { return zc::none; }
 
   source::SourceLoc loc = currentLoc();
@@ -694,7 +1002,7 @@ zc::Maybe<zc::Own<ast::ImportSpecifier>> Parser::parseImportSpecifier() {
 }
 
 zc::Maybe<zc::Own<ast::ExportSpecifier>> Parser::parseExportSpecifier() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseExportSpecifier");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseExportSpecifier");
   if (!tokenIsIdentifierOrKeyword(currentToken())) { return zc::none; }
 
   source::SourceLoc loc = currentLoc();
@@ -711,7 +1019,7 @@ zc::Maybe<zc::Own<ast::ExportSpecifier>> Parser::parseExportSpecifier() {
 }
 
 zc::Maybe<zc::Own<ast::ExportDeclaration>> Parser::parseExportDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseExportDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseExportDeclaration");
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::ExportKeyword)) { return zc::none; }
 
@@ -728,7 +1036,7 @@ zc::Maybe<zc::Own<ast::ExportDeclaration>> Parser::parseExportDeclaration() {
   }
 
   zc::Maybe<zc::Own<ast::ModulePath>> modulePath = zc::none;
-  zc::Vector<zc::Own<ast::ExportSpecifier>> specifiers;
+  ListScratch<ast::ExportSpecifier> specifiers(*this);
 
   if (currentToken().is(ast::SyntaxKind::LeftBrace)) {
     nextToken();
@@ -757,11 +1065,12 @@ zc::Maybe<zc::Own<ast::ExportDeclaration>> Parser::parseExportDeclaration() {
 
   parseSemicolon();
   return finishNode(
-      ast::factory::createExportDeclaration(zc::mv(modulePath), zc::mv(specifiers), zc::none), loc);
+      ast::factory::createExportDeclaration(zc::mv(modulePath), specifiers.finish(), zc::none),
+      loc);
 }
 
 zc::Maybe<zc::Own<ast::Statement>> Parser::parseStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseStatement");
 
   // Check for labeled statement
   if (currentToken().is(ast::SyntaxKind::Identifier) && isLookAhead(1, ast::SyntaxKind::Colon)) {
@@ -985,15 +1294,11 @@ ZC_ALWAYS_INLINE(const source::SourceLoc Parser::currentLoc() const) {
 ZC_ALWAYS_INLINE(ast::SyntaxKind Parser::currentKind() const) { return currentToken().getKind(); }
 
 ast::SyntaxKind Parser::reScanGreaterToken() {
-  ast::SyntaxKind kind = impl->lexer.reScanGreaterToken();
-  impl->token = impl->lexer.getCurrentState().token;
-  return kind;
+  return impl->rescanCurrent([this]() { return impl->lexer.reScanGreaterToken(); });
 }
 
 ast::SyntaxKind Parser::reScanTemplateToken() {
-  ast::SyntaxKind kind = impl->lexer.reScanTemplateToken();
-  impl->token = impl->lexer.getCurrentState().token;
-  return kind;
+  return impl->rescanCurrent([this]() { return impl->lexer.reScanTemplateToken(); });
 }
 
 ZC_ALWAYS_INLINE(void Parser::nextToken()) { impl->nextToken(); }
@@ -1070,7 +1375,7 @@ bool Parser::isModifier() const {
 }
 
 bool Parser::isBinaryOperator() const {
-  return getBinaryOperatorPrecedence(currentKind()) > ast::OperatorPrecedence::kLowest;
+  return ast::getBinaryOperatorInfo(currentKind()).precedence > ast::OperatorPrecedence::kLowest;
 }
 
 bool Parser::isIdentifierOrKeyword() const {
@@ -1099,8 +1404,15 @@ bool Parser::nextIsParenthesizedOrFunctionType() {
 
 bool Parser::isStartOfFunctionType() {
   if (expectToken(ast::SyntaxKind::LessThan)) { return true; }
-  return expectToken(ast::SyntaxKind::LeftParen) &&
-         lookAhead<bool>(ZC_BIND_METHOD(*this, isUnambiguouslyStartOfFunctionType));
+  if (!expectToken(ast::SyntaxKind::LeftParen)) { return false; }
+
+  // Nested parenthesized types ask this again at the same `(`, and each answer may scan to the
+  // matching `)`.
+  const SpeculationRule rule = SpeculationRule::UnambiguouslyStartOfFunctionType;
+  ZC_IF_SOME(outcome, impl->findSpeculation(rule)) { return outcome; }
+  const bool outcome = lookAhead<bool>(ZC_BIND_METHOD(*this, isUnambiguouslyStartOfFunctionType));
+  impl->recordSpeculation(rule, outcome);
+  return outcome;
 }
 
 bool Parser::skipFunctionTypeParameterStart() {
@@ -1341,11 +1653,7 @@ bool Parser::isValidHeritageClauseObjectLiteral() {
 lexer::Token Parser::lookAhead(unsigned n) {
   if (n == 0) { return currentToken(); }
 
-  ParserState state = mark();
-  for (unsigned i = 0; i < n; ++i) { nextToken(); }
-  lexer::Token token = currentToken();
-  rewind(state);
-  return token;
+  return impl->peekAhead(n);
 }
 
 bool Parser::canLookAhead(unsigned n) { return true; }
@@ -1353,7 +1661,7 @@ bool Parser::canLookAhead(unsigned n) { return true; }
 bool Parser::isLookAhead(unsigned n, ast::SyntaxKind kind) { return lookAhead(n).is(kind); }
 
 template <typename T>
-T Parser::lookAhead(zc::Function<T()> callback) {
+T Parser::lookAhead(zc::FunctionParam<T()> callback) {
   ParserState state = mark();
   T result = callback();
   rewind(state);
@@ -1361,16 +1669,11 @@ T Parser::lookAhead(zc::Function<T()> callback) {
 }
 
 bool Parser::nextTokenIsTokenStringLiteral() {
-  // Check if next token is string literal by saving state and trying to parse
-  ParserState state = mark();
-  nextToken();
-  bool result = currentToken().is(ast::SyntaxKind::StringLiteral);
-  rewind(state);
-  return result;
+  return impl->peekAhead(1).is(ast::SyntaxKind::StringLiteral);
 }
 
 zc::Maybe<zc::Vector<zc::Own<ast::Expression>>> Parser::parseArgumentList() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArgumentList");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArgumentList");
 
   // argumentList:
   //   (assignmentExpression | ELLIPSIS assignmentExpression) (
@@ -1381,7 +1684,7 @@ zc::Maybe<zc::Vector<zc::Own<ast::Expression>>> Parser::parseArgumentList() {
 
   nextToken();  // consume '('
 
-  zc::Vector<zc::Own<ast::Expression>> arguments;
+  ListScratch<ast::Expression> arguments(*this);
 
   if (!expectToken(ast::SyntaxKind::RightParen)) {
     do {
@@ -1392,12 +1695,11 @@ zc::Maybe<zc::Vector<zc::Own<ast::Expression>>> Parser::parseArgumentList() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightParen)) { return zc::none; }
 
-  return zc::mv(arguments);
+  return arguments.finish();
 }
 
 zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> Parser::tryParseTypeArgumentsInExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser,
-                                 "tryParseTypeArgumentsInExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "tryParseTypeArgumentsInExpression");
 
   // typeArguments: LT typeArgumentList GT;
   // typeArgumentList: type (COMMA type)*;
@@ -1408,6 +1710,12 @@ zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> Parser::tryParseTypeArgumentsInExp
   // operator, not a type argument opener).
 
   if (!expectToken(ast::SyntaxKind::LessThan)) { return zc::none; }
+
+  // A failure is final, so an enclosing speculation that runs again over the same `<` does not
+  // redo it. Successes produce nodes and are not remembered.
+  const SpeculationRule rule = SpeculationRule::TypeArgumentsInExpression;
+  if (impl->findSpeculation(rule) != zc::none) { return zc::none; }
+
   // Save current parser state
   ParserState state = mark();
 
@@ -1420,7 +1728,7 @@ zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> Parser::tryParseTypeArgumentsInExp
     nextToken();
 
     // Parse the type argument list
-    zc::Vector<zc::Own<ast::TypeNode>> typeArguments;
+    ListScratch<ast::TypeNode> typeArguments(*this);
 
     if (!expectToken(ast::SyntaxKind::GreaterThan)) {
       do { typeArguments.add(parseType()); } while (consumeExpectedToken(ast::SyntaxKind::Comma));
@@ -1430,6 +1738,7 @@ zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> Parser::tryParseTypeArgumentsInExp
     if (!consumeExpectedToken(ast::SyntaxKind::GreaterThan)) {
       impl->diagnosticEngine.unsuppress();
       rewind(state);
+      impl->recordSpeculation(rule, false);
       return zc::none;
     }
 
@@ -1439,13 +1748,14 @@ zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> Parser::tryParseTypeArgumentsInExp
     // it as a relational expression.
     if (canFollowTypeArgumentsInExpression()) {
       impl->diagnosticEngine.unsuppress();
-      return zc::mv(typeArguments);
+      return typeArguments.finish();
     }
   }
 
   // Parsing failed or doesn't follow expected pattern, restore state
   impl->diagnosticEngine.unsuppress();
   rewind(state);
+  impl->recordSpeculation(rule, false);
   return zc::none;
 }
 
@@ -1569,7 +1879,7 @@ zc::Own<ast::TokenNode> Parser::parseTokenNode() {
 }
 
 zc::Own<ast::Identifier> Parser::createIdentifier(bool isIdentifier) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "createIdentifier");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "createIdentifier");
 
   // bindingIdentifier: identifier
   // identifier: identifierName
@@ -1595,7 +1905,7 @@ zc::Own<ast::Identifier> Parser::createIdentifier(bool isIdentifier) {
 }
 
 zc::Own<ast::Identifier> Parser::parsePropertyName() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePropertyName");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePropertyName");
 
   if (expectToken(ast::SyntaxKind::LeftBracket)) {
     const source::SourceLoc loc = currentLoc();
@@ -1620,18 +1930,17 @@ zc::Own<ast::Identifier> Parser::parsePropertyName() {
 }
 
 zc::Own<ast::Identifier> Parser::parseIdentifier() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIdentifier");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIdentifier");
   return createIdentifier(isIdentifier());
 }
 
 zc::Own<ast::Identifier> Parser::parseIdentifierName() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIdentifierName");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIdentifierName");
   return createIdentifier(lexer::isIdentifierOrKeyword(currentKind()));
 }
 
 zc::Own<ast::Identifier> Parser::parseIdentifierNameErrorOnUnicodeEscapeSequence() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser,
-                                 "parseIdentifierNameErrorOnUnicodeEscapeSequence");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIdentifierNameErrorOnUnicodeEscapeSequence");
 
   if (currentToken().hasFlag(lexer::TokenFlags::UnicodeEscape) ||
       currentToken().hasFlag(lexer::TokenFlags::ExtendedUnicodeEscape)) {
@@ -1642,12 +1951,12 @@ zc::Own<ast::Identifier> Parser::parseIdentifierNameErrorOnUnicodeEscapeSequence
 }
 
 zc::Own<ast::Identifier> Parser::parseBindingIdentifier() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBindingIdentifier");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBindingIdentifier");
   return createIdentifier(isBindingIdentifier());
 }
 
 zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseBindingElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBindingElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBindingElement");
 
   // bindingElement:
   //   bindingIdentifier initializer?
@@ -1678,7 +1987,7 @@ zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseBindingElement() {
 }
 
 zc::Maybe<zc::Own<ast::VariableDeclaration>> Parser::parseVariableDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseVariableDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseVariableDeclaration");
 
   // variableDeclaration:
   //   bindingIdentifier typeAnnotation? initializer?
@@ -1701,7 +2010,7 @@ zc::Maybe<zc::Own<ast::VariableDeclaration>> Parser::parseVariableDeclaration()
 // Statement parsing implementations
 
 zc::Maybe<zc::Own<ast::BlockStatement>> Parser::parseBlockStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBlockStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBlockStatement");
 
   source::SourceLoc loc = currentLoc();
   source::SourceLoc openBraceLoc = getTokenStartLoc();
@@ -1730,7 +2039,7 @@ zc::Maybe<zc::Own<ast::BlockStatement>> Parser::parseBlockStatement() {
 }
 
 zc::Own<ast::BlockStatement> Parser::parseFunctionBlock() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFunctionBlock");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionBlock");
 
   ZC_IF_SOME(block, parseBlockStatement()) { return zc::mv(block); }
   return finishNode(ast::factory::createBlockStatement(parseEmptyNodeList<ast::Statement>()),
@@ -1758,7 +2067,7 @@ void Parser::parseExpectedMatchingBrackets(ast::SyntaxKind openKind, ast::Syntax
 }
 
 zc::Maybe<zc::Own<ast::EmptyStatement>> Parser::parseEmptyStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseEmptyStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseEmptyStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::Semicolon)) { return zc::none; }
@@ -1768,7 +2077,7 @@ zc::Maybe<zc::Own<ast::EmptyStatement>> Parser::parseEmptyStatement() {
 }
 
 zc::Maybe<zc::Own<ast::ExpressionStatement>> Parser::parseExpressionStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseExpressionStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseExpressionStatement");
 
   // expressionStatement: expression ";"
   //   where first token is not one of:
@@ -1933,7 +2242,7 @@ void Parser::parseErrorForMissingSemicolonAfter(const ast::Expression& expr) {
 }
 
 zc::Maybe<zc::Own<ast::IfStatement>> Parser::parseIfStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIfStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIfStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::IfKeyword)) { return zc::none; }
@@ -1960,7 +2269,7 @@ zc::Maybe<zc::Own<ast::IfStatement>> Parser::parseIfStatement() {
 }
 
 zc::Maybe<zc::Own<ast::WhileStatement>> Parser::parseWhileStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseWhileStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseWhileStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::WhileKeyword)) { return zc::none; }
@@ -1978,7 +2287,7 @@ zc::Maybe<zc::Own<ast::WhileStatement>> Parser::parseWhileStatement() {
 }
 
 zc::Maybe<zc::Own<ast::IterationStatement>> Parser::parseForStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseForStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseForStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::ForKeyword)) { return zc::none; }
@@ -2045,7 +2354,7 @@ zc::Maybe<zc::Own<ast::IterationStatement>> Parser::parseForStatement() {
 }
 
 zc::Maybe<zc::Own<ast::LabeledStatement>> Parser::parseLabeledStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseLabeledStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseLabeledStatement");
 
   source::SourceLoc loc = currentLoc();
   auto label = parseIdentifier();
@@ -2060,7 +2369,7 @@ zc::Maybe<zc::Own<ast::LabeledStatement>> Parser::parseLabeledStatement() {
 }
 
 zc::Maybe<zc::Own<ast::BreakStatement>> Parser::parseBreakStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBreakStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBreakStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::BreakKeyword)) { return zc::none; }
@@ -2075,7 +2384,7 @@ zc::Maybe<zc::Own<ast::BreakStatement>> Parser::parseBreakStatement() {
 }
 
 zc::Maybe<zc::Own<ast::ContinueStatement>> Parser::parseContinueStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseContinueStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseContinueStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::ContinueKeyword)) { return zc::none; }
@@ -2090,7 +2399,7 @@ zc::Maybe<zc::Own<ast::ContinueStatement>> Parser::parseContinueStatement() {
 }
 
 zc::Maybe<zc::Own<ast::ReturnStatement>> Parser::parseReturnStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseReturnStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseReturnStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::ReturnKeyword)) { return zc::none; }
@@ -2106,7 +2415,7 @@ zc::Maybe<zc::Own<ast::ReturnStatement>> Parser::parseReturnStatement() {
 }
 
 zc::Maybe<zc::Own<ast::MatchStatement>> Parser::parseMatchStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseMatchStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseMatchStatement");
 
   if (!consumeExpectedToken(ast::SyntaxKind::MatchKeyword)) { return zc::none; }
 
@@ -2115,7 +2424,7 @@ zc::Maybe<zc::Own<ast::MatchStatement>> Parser::parseMatchStatement() {
   auto expr = parseExpression();
   if (!consumeExpectedToken(ast::SyntaxKind::RightParen)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::Statement>> clauses;
+  ListScratch<ast::Statement> clauses(*this);
   if (!consumeExpectedToken(ast::SyntaxKind::LeftBrace)) { return zc::none; }
 
   while (!expectToken(ast::SyntaxKind::RightBrace)) {
@@ -2147,14 +2456,14 @@ zc::Maybe<zc::Own<ast::MatchStatement>> Parser::parseMatchStatement() {
   if (!consumeExpectedToken(ast::SyntaxKind::RightBrace)) { return zc::none; }
 
   source::SourceLoc loc = currentLoc();
-  return finishNode(ast::factory::createMatchStatement(zc::mv(expr), zc::mv(clauses)), loc);
+  return finishNode(ast::factory::createMatchStatement(zc::mv(expr), clauses.finish()), loc);
 }
 
 // ================================================================================
 // Declaration parsing implementations
 
 zc::Maybe<zc::Own<ast::Statement>> Parser::parseDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseDeclaration");
 
   // declaration:
   //   functionDeclaration
@@ -2198,7 +2507,7 @@ zc::Maybe<zc::Own<ast::Statement>> Parser::parseDeclaration() {
 }
 
 zc::Own<ast::VariableDeclarationList> Parser::parseVariableDeclarationList() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseVariableDeclarationList");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseVariableDeclarationList");
 
   // variableDeclarationList: LET_OR_CONST bindingList;
   // bindingList: bindingElement (COMMA bindingElement)*;
@@ -2218,7 +2527,7 @@ zc::Own<ast::VariableDeclarationList> Parser::parseVariableDeclarationList() {
 }
 
 zc::Maybe<zc::Own<ast::FunctionDeclaration>> Parser::parseFunctionDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFunctionDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionDeclaration");
 
   // functionDeclaration:
   //   FUN bindingIdentifier callSignature LBRACE functionBody RBRACE;
@@ -2231,6 +2540,12 @@ zc::Maybe<zc::Own<ast::FunctionDeclaration>> Parser::parseFunctionDeclaration()
   auto parameters = parseParameters();
   zc::Maybe<zc::Own<ast::ReturnTypeNode>> returnType = parseReturnType();
 
+  ZC_IF_SOME(deferred, skipFunctionBody()) {
+    return finishNode(ast::factory::createFunctionDeclaration(zc::mv(name), zc::mv(typeParameters),
+                                                              zc::mv(parameters),
+                                                              zc::mv(returnType), zc::mv(deferred)),
+                      loc);
+  }
   ZC_IF_SOME(body, parseBlockStatement()) {
     return finishNode(ast::factory::createFunctionDeclaration(zc::mv(name), zc::mv(typeParameters),
                                                               zc::mv(parameters),
@@ -2242,7 +2557,7 @@ zc::Maybe<zc::Own<ast::FunctionDeclaration>> Parser::parseFunctionDeclaration()
 }
 
 zc::Own<ast::ClassDeclaration> Parser::parseClassDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseClassDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseClassDeclaration");
 
   source::SourceLoc classLoc = currentLoc();
   parseExpected(ast::SyntaxKind::ClassKeyword);
@@ -2263,7 +2578,7 @@ zc::Own<ast::ClassDeclaration> Parser::parseClassDeclaration() {
 }
 
 zc::Maybe<zc::Own<ast::InterfaceDeclaration>> Parser::parseInterfaceDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseInterfaceDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseInterfaceDeclaration");
 
   source::SourceLoc loc = currentLoc();
 
@@ -2281,7 +2596,7 @@ zc::Maybe<zc::Own<ast::InterfaceDeclaration>> Parser::parseInterfaceDeclaration(
 }
 
 zc::Own<ast::StructDeclaration> Parser::parseStructDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseStructDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseStructDeclaration");
 
   source::SourceLoc loc = currentLoc();
   parseExpected(ast::SyntaxKind::StructKeyword);
@@ -2303,7 +2618,7 @@ zc::Own<ast::StructDeclaration> Parser::parseStructDeclaration() {
 }
 
 zc::Maybe<zc::Own<ast::EnumMember>> Parser::parseEnumMember() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseEnumMember");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseEnumMember");
 
   if (!isIdentifier()) { return zc::none; }
 
@@ -2328,7 +2643,7 @@ zc::Maybe<zc::Own<ast::EnumMember>> Parser::parseEnumMember() {
 }
 
 zc::Maybe<zc::Own<ast::EnumDeclaration>> Parser::parseEnumDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseEnumDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseEnumDeclaration");
 
   if (!consumeExpectedToken(ast::SyntaxKind::EnumKeyword)) { return zc::none; }
 
@@ -2337,7 +2652,7 @@ zc::Maybe<zc::Own<ast::EnumDeclaration>> Parser::parseEnumDeclaration() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::LeftBrace)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::EnumMember>> members;
+  ListScratch<ast::EnumMember> members(*this);
   while (!expectToken(ast::SyntaxKind::RightBrace)) {
     ZC_IF_SOME(member, parseEnumMember()) { members.add(zc::mv(member)); }
     else {
@@ -2351,18 +2666,18 @@ zc::Maybe<zc::Own<ast::EnumDeclaration>> Parser::parseEnumDeclaration() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightBrace)) { return zc::none; }
 
-  return finishNode(ast::factory::createEnumDeclaration(zc::mv(name), zc::mv(members)), loc);
+  return finishNode(ast::factory::createEnumDeclaration(zc::mv(name), members.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::ErrorDeclaration>> Parser::parseErrorDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseErrorDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseErrorDeclaration");
 
   if (!consumeExpectedToken(ast::SyntaxKind::ErrorKeyword)) { return zc::none; }
 
   auto name = parseIdentifier();
   source::SourceLoc loc = currentLoc();
 
-  zc::Vector<zc::Own<ast::Statement>> fields;
+  ListScratch<ast::Statement> fields(*this);
   if (expectToken(ast::SyntaxKind::LeftBrace)) {
     nextToken();
 
@@ -2373,11 +2688,11 @@ zc::Maybe<zc::Own<ast::ErrorDeclaration>> Parser::parseErrorDeclaration() {
     if (!consumeExpectedToken(ast::SyntaxKind::RightBrace)) { return zc::none; }
   }
 
-  return finishNode(ast::factory::createErrorDeclaration(zc::mv(name), zc::mv(fields)), loc);
+  return finishNode(ast::factory::createErrorDeclaration(zc::mv(name), fields.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::AliasDeclaration>> Parser::parseAliasDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseAliasDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseAliasDeclaration");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::AliasKeyword)) { return zc::none; }
@@ -2403,7 +2718,7 @@ zc::Maybe<zc::Own<ast::AliasDeclaration>> Parser::parseAliasDeclaration() {
 // Expression parsing implementations
 
 zc::Own<ast::Expression> Parser::parseExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseExpression");
 
   // expression: assignmentExpression (COMMA assignmentExpression)*;
   //
@@ -2430,8 +2745,7 @@ zc::Maybe<zc::Own<ast::Expression>> Parser::parseInitializer() {
 
 // Assignment expression parsing
 zc::Own<ast::Expression> Parser::parseAssignmentExpressionOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser,
-                                 "parseAssignmentExpressionOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseAssignmentExpressionOrHigher");
 
   // assignmentExpression:
   //   conditionalExpression
@@ -2463,7 +2777,7 @@ zc::Own<ast::Expression> Parser::parseAssignmentExpressionOrHigher() {
 // conditional expression rest parsing
 zc::Own<ast::Expression> Parser::parseConditionalExpressionRest(
     zc::Own<ast::Expression> leftOperand, source::SourceLoc loc) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseConditionalExpressionRest");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseConditionalExpressionRest");
 
   // conditionalExpression:
   //   shortCircuitExpression (QUESTION assignmentExpression COLON assignmentExpression)?
@@ -2493,7 +2807,7 @@ zc::Own<ast::Expression> Parser::parseConditionalExpressionRest(
 
 // Binary expression parsing
 zc::Own<ast::Expression> Parser::parseBinaryExpressionOrHigher(ast::OperatorPrecedence precedence) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBinaryExpressionOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBinaryExpressionOrHigher");
 
   // Handles all binary expressions with precedence:
   //   bitwiseORExpression | bitwiseXORExpression | bitwiseANDExpression
@@ -2513,14 +2827,13 @@ zc::Own<ast::Expression> Parser::parseBinaryExpressionOrHigher(ast::OperatorPrec
 zc::Own<ast::Expression> Parser::parseBinaryExpressionRest(zc::Own<ast::Expression> leftOperand,
                                                            ast::OperatorPrecedence precedence,
                                                            source::SourceLoc loc) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBinaryExpressionRest");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBinaryExpressionRest");
 
   zc::Own<ast::Expression> expr = zc::mv(leftOperand);
 
   while (true) {
-    const lexer::Token& token = currentToken();
-
-    ast::OperatorPrecedence newPrecedence = getBinaryOperatorPrecedence(token.getKind());
+    const ast::BinaryOperatorInfo& info = ast::getBinaryOperatorInfo(currentKind());
+    const ast::OperatorPrecedence newPrecedence = info.precedence;
 
     // Check the precedence to see if we should "take" this operator
     // - For left associative operator (all operator but **), consume the ,
@@ -2530,13 +2843,13 @@ zc::Own<ast::Expression> Parser::parseBinaryExpressionRest(zc::Own<ast::Expressi
     // - For right associative operator (**), consume the , recursively call the function
     //   and parse binaryExpression as a rightOperand of the caller if the new precedence of
     //   the operator is greater than or equal to the current precedence
-    bool isRightAssociative = token.is(ast::SyntaxKind::AsteriskAsterisk);
+    bool isRightAssociative = info.associativity == ast::OperatorAssociativity::kRight;
     bool consumeCurrentOperator =
         isRightAssociative ? newPrecedence >= precedence : newPrecedence > precedence;
 
     if (!consumeCurrentOperator) { break; }
 
-    if (expectToken(ast::SyntaxKind::AsKeyword)) {
+    if (info.nodeKind == ast::SyntaxKind::AsExpression) {
       const bool hasLineBreakBeforeAs = currentToken().hasPrecedingLineBreak();
       if (hasLineBreakBeforeAs) {
         parseErrorAtCurrentToken<diagnostics::DiagID::LineBreakNotAllowedBeforeAsCast>();
@@ -2576,7 +2889,7 @@ zc::Own<ast::Expression> Parser::parseBinaryExpressionRest(zc::Own<ast::Expressi
 
 // Unary expression parsing
 zc::Own<ast::Expression> Parser::parseUnaryExpressionOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseUnaryExpressionOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseUnaryExpressionOrHigher");
 
   // postfixUnaryExpression:
   //   leftHandSideExpression (
@@ -2604,7 +2917,8 @@ zc::Own<ast::Expression> Parser::parseUnaryExpressionOrHigher() {
     auto updateExpression = parseUpdateExpression();
     return expectToken(ast::SyntaxKind::AsteriskAsterisk)
                ? parseBinaryExpressionRest(zc::mv(updateExpression),
-                                           getBinaryOperatorPrecedence(currentKind()), loc)
+                                           ast::getBinaryOperatorInfo(currentKind()).precedence,
+                                           loc)
                : zc::mv(updateExpression);
   }
 
@@ -2622,7 +2936,7 @@ zc::Own<ast::Expression> Parser::parseUnaryExpressionOrHigher() {
 
 // Simple unary expression parsing
 zc::Own<ast::UnaryExpression> Parser::parseSimpleUnaryExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseSimpleUnaryExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseSimpleUnaryExpression");
 
   switch (currentKind()) {
     case ast::SyntaxKind::Plus:
@@ -2647,7 +2961,7 @@ zc::Own<ast::UnaryExpression> Parser::parseSimpleUnaryExpression() {
 
 // Prefix unary expression parsing
 zc::Own<ast::UnaryExpression> Parser::parsePrefixUnaryExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePrefixUnaryExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePrefixUnaryExpression");
 
   // prefixUnaryExpression:
   //   PLUS unaryExpression
@@ -2668,7 +2982,7 @@ zc::Own<ast::UnaryExpression> Parser::parsePrefixUnaryExpression() {
 
 // TypeOf expression parsing
 zc::Own<ast::TypeOfExpression> Parser::parseTypeOfExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeOfExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeOfExpression");
 
   // typeOfExpression:
   //   TYPEOF unaryExpression;
@@ -2686,8 +3000,7 @@ zc::Own<ast::TypeOfExpression> Parser::parseTypeOfExpression() {
 
 // Left-hand side expression parsing
 zc::Own<ast::LeftHandSideExpression> Parser::parseLeftHandSideExpressionOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser,
-                                 "parseLeftHandSideExpressionOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseLeftHandSideExpressionOrHigher");
 
   // leftHandSideExpression:
   //   newExpression
@@ -2721,7 +3034,7 @@ zc::Own<ast::LeftHandSideExpression> Parser::parseLeftHandSideExpressionOrHigher
 
 // Helper method to parse member expression or higher
 zc::Own<ast::LeftHandSideExpression> Parser::parseMemberExpressionOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseMemberExpressionOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseMemberExpressionOrHigher");
 
   // memberExpression:
   //   (primaryExpression | superProperty | NEW memberExpression arguments)
@@ -2741,7 +3054,7 @@ zc::Own<ast::LeftHandSideExpression> Parser::parseMemberExpressionOrHigher() {
 // Helper method to parse call expression rest
 zc::Own<ast::LeftHandSideExpression> Parser::parseCallExpressionRest(
     source::SourceLoc loc, zc::Own<ast::LeftHandSideExpression> expression) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseCallExpressionRest");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseCallExpressionRest");
 
   // callExpression:
   //   (memberExpression arguments | superCall | importCall)
@@ -2797,7 +3110,7 @@ zc::Own<ast::LeftHandSideExpression> Parser::parseCallExpressionRest(
 }
 
 zc::Own<ast::UpdateExpression> Parser::parseUpdateExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseUpdateExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseUpdateExpression");
 
   // updateExpression:
   //   leftHandSideExpression
@@ -2836,7 +3149,7 @@ zc::Own<ast::UpdateExpression> Parser::parseUpdateExpression() {
 }
 
 zc::Own<ast::LeftHandSideExpression> Parser::parseLeftHandSideExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseLeftHandSideExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseLeftHandSideExpression");
 
   // leftHandSideExpression:
   //   newExpression
@@ -2850,7 +3163,7 @@ zc::Own<ast::LeftHandSideExpression> Parser::parseLeftHandSideExpression() {
 }
 
 zc::Own<ast::PrimaryExpression> Parser::parsePrimaryExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePrimaryExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePrimaryExpression");
 
   // primaryExpression:
   //   THIS
@@ -2897,7 +3210,7 @@ zc::Own<ast::PrimaryExpression> Parser::parsePrimaryExpression() {
 }
 
 zc::Own<ast::LiteralExpression> Parser::parseLiteralExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseLiteralExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseLiteralExpression");
 
   // literal:
   //   nullLiteral
@@ -2935,7 +3248,7 @@ zc::Own<ast::LiteralExpression> Parser::parseLiteralExpression() {
     }
     case ast::SyntaxKind::BigIntLiteral: {
       nextToken();
-      return finishNode(zc::heap<ast::BigIntLiteral>(value), loc);
+      return finishNode(ast::allocate<ast::BigIntLiteral>(value), loc);
     }
     case ast::SyntaxKind::TrueKeyword:
       ZC_FALLTHROUGH;
@@ -2956,7 +3269,7 @@ zc::Own<ast::LiteralExpression> Parser::parseLiteralExpression() {
 }
 
 zc::Own<ast::TemplateLiteralExpression> Parser::parseTemplateLiteralExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTemplateLiteralExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTemplateLiteralExpression");
 
   const source::SourceLoc loc = currentLoc();
   const lexer::Token headToken = currentToken();
@@ -2965,7 +3278,7 @@ zc::Own<ast::TemplateLiteralExpression> Parser::parseTemplateLiteralExpression()
   auto head = finishNode(ast::factory::createStringLiteral(headToken.getValue()),
                          headToken.getRange().getStart(), headToken.getRange().getEnd());
 
-  zc::Vector<zc::Own<ast::TemplateSpan>> spans;
+  ListScratch<ast::TemplateSpan> spans(*this);
   while (true) {
     const source::SourceLoc spanLoc = currentLoc();
     auto expression = parseExpression();
@@ -2993,12 +3306,12 @@ zc::Own<ast::TemplateLiteralExpression> Parser::parseTemplateLiteralExpression()
     if (literalKind == ast::SyntaxKind::TemplateTail) { break; }
   }
 
-  return finishNode(ast::factory::createTemplateLiteralExpression(zc::mv(head), zc::mv(spans)),
+  return finishNode(ast::factory::createTemplateLiteralExpression(zc::mv(head), spans.finish()),
                     loc);
 }
 
 zc::Own<ast::Expression> Parser::parseSpreadElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseSpreadElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseSpreadElement");
 
   // spreadElement:
   //   DOTDOTDOT expression;
@@ -3012,7 +3325,7 @@ zc::Own<ast::Expression> Parser::parseSpreadElement() {
 }
 
 zc::Maybe<zc::Own<ast::Expression>> Parser::parseArrayLiteralElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayLiteralElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayLiteralElement");
 
   // arrayLiteralElement:
   //   expression
@@ -3025,7 +3338,7 @@ zc::Maybe<zc::Own<ast::Expression>> Parser::parseArrayLiteralElement() {
 }
 
 zc::Own<ast::ArrayLiteralExpression> Parser::parseArrayLiteralExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayLiteralExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayLiteralExpression");
 
   // arrayLiteral:
   //   LBRACK RBRACK
@@ -3048,7 +3361,7 @@ zc::Own<ast::ArrayLiteralExpression> Parser::parseArrayLiteralExpression() {
 }
 
 zc::Own<ast::ObjectLiteralExpression> Parser::parseObjectLiteralExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseObjectLiteralExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseObjectLiteralExpression");
 
   // objectLiteral:
   //   LBRACE RBRACE
@@ -3073,7 +3386,7 @@ zc::Own<ast::ObjectLiteralExpression> Parser::parseObjectLiteralExpression() {
 }
 
 zc::Maybe<zc::Own<ast::ObjectLiteralElement>> Parser::parseObjectLiteralElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseObjectLiteralElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseObjectLiteralElement");
 
   const source::SourceLoc pos = currentLoc();
 
@@ -3112,7 +3425,7 @@ zc::Maybe<zc::Own<ast::ObjectLiteralElement>> Parser::parseObjectLiteralElement(
 // Type parsing implementations
 
 zc::Own<ast::TypeNode> Parser::parseType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseType");
 
   // type: unionType;
   //
@@ -3156,14 +3469,14 @@ zc::Own<ast::TypeNode> Parser::parseType() {
 }
 
 zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseTypeAnnotation() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeAnnotation");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeAnnotation");
 
   if (!parseOptional(ast::SyntaxKind::Colon)) { return zc::none; }
   return parseType();
 }
 
 zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseFunctionTypeToError(bool isUnionType) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFunctionTypeToError");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionTypeToError");
 
   if (!isStartOfFunctionType()) { return zc::none; }
 
@@ -3185,7 +3498,7 @@ zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseFunctionTypeToError(bool isUnionT
 
 zc::Own<ast::TypeNode> Parser::parseUnionOrIntersectionType(
     ast::SyntaxKind operatorToken, zc::Function<zc::Own<ast::TypeNode>()> parseConstituentType) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseUnionOrIntersectionType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseUnionOrIntersectionType");
   const source::SourceLoc loc = currentLoc();
   const bool isUnionType = operatorToken == ast::SyntaxKind::Bar;
   const bool hasLeadingOperator = parseOptional(operatorToken);
@@ -3196,7 +3509,7 @@ zc::Own<ast::TypeNode> Parser::parseUnionOrIntersectionType(
                                  : parseConstituentType();
 
   if (expectToken(operatorToken) || hasLeadingOperator) {
-    zc::Vector<zc::Own<ast::TypeNode>> types;
+    ListScratch<ast::TypeNode> types(*this);
     types.add(zc::mv(type));
 
     while (parseOptional(operatorToken)) {
@@ -3207,9 +3520,9 @@ zc::Own<ast::TypeNode> Parser::parseUnionOrIntersectionType(
 
     switch (operatorToken) {
       case ast::SyntaxKind::Bar:
-        return finishNode(ast::factory::createUnionType(zc::mv(types)), loc);
+        return finishNode(ast::factory::createUnionType(types.finish()), loc);
       case ast::SyntaxKind::Ampersand:
-        return finishNode(ast::factory::createIntersectionType(zc::mv(types)), loc);
+        return finishNode(ast::factory::createIntersectionType(types.finish()), loc);
       default:
         ZC_UNREACHABLE;
     }
@@ -3219,7 +3532,7 @@ zc::Own<ast::TypeNode> Parser::parseUnionOrIntersectionType(
 }
 
 zc::Own<ast::TypeNode> Parser::parseUnionTypeOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseUnionTypeOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseUnionTypeOrHigher");
 
   // unionTypeOrHigher:
   //   intersectionTypeOrHigher (PIPE intersectionTypeOrHigher)*;
@@ -3231,7 +3544,7 @@ zc::Own<ast::TypeNode> Parser::parseUnionTypeOrHigher() {
 }
 
 zc::Own<ast::TypeNode> Parser::parseIntersectionTypeOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIntersectionTypeOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIntersectionTypeOrHigher");
 
   // intersectionTypeOrHigher:
   //   postfixTypeOrHigher (AMPERSAND postfixTypeOrHigher)*;
@@ -3243,7 +3556,7 @@ zc::Own<ast::TypeNode> Parser::parseIntersectionTypeOrHigher() {
 }
 
 zc::Own<ast::TypeNode> Parser::parsePostfixTypeOrHigher() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePostfixTypeOrHigher");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePostfixTypeOrHigher");
 
   ZC_IF_SOME(type, parsePostfixType()) { return zc::mv(type); }
 
@@ -3252,7 +3565,7 @@ zc::Own<ast::TypeNode> Parser::parsePostfixTypeOrHigher() {
 }
 
 zc::Maybe<zc::Own<ast::TypeNode>> Parser::parsePostfixType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePostfixType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePostfixType");
 
   // Parse postfix type according to the grammar rule:
   //
@@ -3320,7 +3633,7 @@ zc::Maybe<zc::Own<ast::TypeNode>> Parser::parsePostfixType() {
 }
 
 zc::Maybe<zc::Own<ast::ArrayTypeNode>> Parser::parseArrayType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayType");
 
   // Parse array type according to the grammar rule:
   // arrayType: postfixType LBRACK RBRACK
@@ -3347,7 +3660,7 @@ zc::Maybe<zc::Own<ast::ArrayTypeNode>> Parser::parseArrayType() {
 }
 
 zc::Own<ast::FunctionTypeNode> Parser::parseFunctionType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFunctionType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionType");
 
   // Parse function type according to the grammar rule:
   //
@@ -3369,7 +3682,7 @@ zc::Own<ast::FunctionTypeNode> Parser::parseFunctionType() {
 }
 
 zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseParenthesizedOrTupleType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseParenthesizedOrTupleType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseParenthesizedOrTupleType");
 
   // Parses either a parenthesized type (T) or a tuple type (T, U) or (name: T, other: U).
   // Disambiguation: if there is exactly one element with no comma and no named prefix,
@@ -3439,7 +3752,7 @@ zc::Maybe<zc::Own<ast::TypeNode>> Parser::parseParenthesizedOrTupleType() {
 }
 
 zc::Maybe<zc::Own<ast::ObjectTypeNode>> Parser::parseObjectType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseObjectType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseObjectType");
 
   // objectType:
   //   LBRACE typeMemberList? RBRACE;
@@ -3450,7 +3763,7 @@ zc::Maybe<zc::Own<ast::ObjectTypeNode>> Parser::parseObjectType() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::LeftBrace)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::Node>> members;
+  ListScratch<ast::Node> members(*this);
 
   // Parse object type members
   if (!expectToken(ast::SyntaxKind::RightBrace)) {
@@ -3499,11 +3812,11 @@ zc::Maybe<zc::Own<ast::ObjectTypeNode>> Parser::parseObjectType() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightBrace)) { return zc::none; }
 
-  return finishNode(ast::factory::createObjectType(zc::mv(members)), loc);
+  return finishNode(ast::factory::createObjectType(members.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::TupleTypeNode>> Parser::parseTupleType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTupleType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTupleType");
 
   // Parse tuple type according to the grammar rule:
   //
@@ -3516,7 +3829,7 @@ zc::Maybe<zc::Own<ast::TupleTypeNode>> Parser::parseTupleType() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::LeftParen)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::TypeNode>> elements;
+  ListScratch<ast::TypeNode> elements(*this);
 
   if (!expectToken(ast::SyntaxKind::RightParen)) {
     do {
@@ -3546,11 +3859,11 @@ zc::Maybe<zc::Own<ast::TupleTypeNode>> Parser::parseTupleType() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightParen)) { return zc::none; }
 
-  return finishNode(ast::factory::createTupleType(zc::mv(elements)), loc);
+  return finishNode(ast::factory::createTupleType(elements.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::TypeReferenceNode>> Parser::parseTypeReference() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeReference");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeReference");
 
   // typeReference: typeName typeArguments?
   //
@@ -3564,7 +3877,7 @@ zc::Maybe<zc::Own<ast::TypeReferenceNode>> Parser::parseTypeReference() {
 
   zc::Maybe<zc::Vector<zc::Own<ast::TypeNode>>> typeArguments = zc::none;
   if (expectToken(ast::SyntaxKind::LessThan)) {
-    zc::Vector<zc::Own<ast::TypeNode>> args;
+    ListScratch<ast::TypeNode> args(*this);
     nextToken();  // consume '<'
     while (!expectToken(ast::SyntaxKind::GreaterThan)) {
       args.add(parseType());
@@ -3574,7 +3887,7 @@ zc::Maybe<zc::Own<ast::TypeReferenceNode>> Parser::parseTypeReference() {
       }
     }
     if (!consumeExpectedToken(ast::SyntaxKind::GreaterThan)) { return zc::none; }
-    typeArguments = zc::mv(args);
+    typeArguments = args.finish();
   }
 
   return finishNode(ast::factory::createTypeReference(zc::mv(typeName), zc::mv(typeArguments)),
@@ -3582,7 +3895,7 @@ zc::Maybe<zc::Own<ast::TypeReferenceNode>> Parser::parseTypeReference() {
 }
 
 zc::Maybe<zc::Own<ast::PredefinedTypeNode>> Parser::parsePredefinedType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePredefinedType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePredefinedType");
 
   // Parse predefined type according to the grammar rule:
   // predefinedType: I8 | I16 | I32 | I64 | U8 | U16 | U32 | U64 | F32 | F64 | STR | BOOL | NIL |
@@ -3617,7 +3930,7 @@ zc::Maybe<zc::Own<ast::PredefinedTypeNode>> Parser::parsePredefinedType() {
 }
 
 zc::Maybe<zc::Own<ast::Pattern>> Parser::parsePattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePattern");
 
   switch (currentKind()) {
     case ast::SyntaxKind::Underscore:
@@ -3715,7 +4028,7 @@ zc::Maybe<zc::Own<ast::Pattern>> Parser::parseIdentifierPattern() {
 zc::Maybe<zc::Own<ast::Pattern>> Parser::parseTuplePattern() {
   if (!consumeExpectedToken(ast::SyntaxKind::LeftParen)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::Pattern>> elements;
+  ListScratch<ast::Pattern> elements(*this);
   while (!expectToken(ast::SyntaxKind::RightParen)) {
     ZC_IF_SOME(pattern, parsePattern()) { elements.add(zc::mv(pattern)); }
     if (!expectToken(ast::SyntaxKind::RightParen) &&
@@ -3725,16 +4038,16 @@ zc::Maybe<zc::Own<ast::Pattern>> Parser::parseTuplePattern() {
   }
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightParen)) { return zc::none; }
-  return ast::factory::createTuplePattern(zc::mv(elements));
+  return ast::factory::createTuplePattern(elements.finish());
 }
 
 zc::Maybe<zc::Own<ast::Pattern>> Parser::parseStructurePattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseStructurePattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseStructurePattern");
   source::SourceLoc loc = currentLoc();
 
   if (!consumeExpectedToken(ast::SyntaxKind::LeftBrace)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::Pattern>> properties;
+  ListScratch<ast::Pattern> properties(*this);
   while (!expectToken(ast::SyntaxKind::RightBrace)) {
     source::SourceLoc propStartLoc = currentLoc();
     auto name = parseIdentifier();
@@ -3758,16 +4071,16 @@ zc::Maybe<zc::Own<ast::Pattern>> Parser::parseStructurePattern() {
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightBrace)) { return zc::none; }
 
-  return finishNode(ast::factory::createStructurePattern(zc::mv(properties)), loc);
+  return finishNode(ast::factory::createStructurePattern(properties.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::Pattern>> Parser::parseArrayPattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayPattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayPattern");
   source::SourceLoc loc = currentLoc();
 
   if (!consumeExpectedToken(ast::SyntaxKind::LeftBracket)) { return zc::none; }
 
-  zc::Vector<zc::Own<ast::Pattern>> elements;
+  ListScratch<ast::Pattern> elements(*this);
   while (!expectToken(ast::SyntaxKind::RightBracket)) {
     ZC_IF_SOME(pattern, parsePattern()) { elements.add(zc::mv(pattern)); }
     if (!expectToken(ast::SyntaxKind::RightBracket) &&
@@ -3777,11 +4090,11 @@ zc::Maybe<zc::Own<ast::Pattern>> Parser::parseArrayPattern() {
   }
 
   if (!consumeExpectedToken(ast::SyntaxKind::RightBracket)) { return zc::none; }
-  return finishNode(ast::factory::createArrayPattern(zc::mv(elements)), loc);
+  return finishNode(ast::factory::createArrayPattern(elements.finish()), loc);
 }
 
 zc::Maybe<zc::Own<ast::Pattern>> Parser::parseIsPattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIsPattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIsPattern");
   source::SourceLoc loc = currentLoc();
 
   if (!consumeExpectedToken(ast::SyntaxKind::IsKeyword)) { return zc::none; }
@@ -3797,7 +4110,7 @@ Parser::parseIdentifierOrBindingPattern() {
 }
 
 zc::Maybe<zc::Own<ast::BindingPattern>> Parser::parseBindingPattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBindingPattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBindingPattern");
 
   switch (currentKind()) {
     case ast::SyntaxKind::LeftBracket:
@@ -3810,7 +4123,7 @@ zc::Maybe<zc::Own<ast::BindingPattern>> Parser::parseBindingPattern() {
 }
 
 zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseArrayBindingElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayBindingElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayBindingElement");
 
   const source::SourceLoc pos = currentLoc();
 
@@ -3824,7 +4137,7 @@ zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseArrayBindingElement() {
 }
 
 zc::Own<ast::BindingPattern> Parser::parseArrayBindingPattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseArrayBindingPattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseArrayBindingPattern");
 
   const source::SourceLoc loc = currentLoc();
 
@@ -3839,7 +4152,7 @@ zc::Own<ast::BindingPattern> Parser::parseArrayBindingPattern() {
 }
 
 zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseObjectBindingElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseObjectBindingElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseObjectBindingElement");
 
   const source::SourceLoc loc = currentLoc();
   auto dotDotDotToken = parseOptionalToken(ast::SyntaxKind::DotDotDot);
@@ -3863,7 +4176,7 @@ zc::Maybe<zc::Own<ast::BindingElement>> Parser::parseObjectBindingElement() {
 }
 
 zc::Own<ast::BindingPattern> Parser::parseObjectBindingPattern() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseObjectBindingPattern");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseObjectBindingPattern");
   const source::SourceLoc pos = currentLoc();
 
   parseExpected(ast::SyntaxKind::LeftBrace);
@@ -3876,7 +4189,7 @@ zc::Own<ast::BindingPattern> Parser::parseObjectBindingPattern() {
 }
 
 zc::Own<ast::AwaitExpression> Parser::parseAwaitExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseAwaitExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseAwaitExpression");
 
   // awaitExpression: AWAIT unaryExpression;
 
@@ -3888,7 +4201,7 @@ zc::Own<ast::AwaitExpression> Parser::parseAwaitExpression() {
 }
 
 zc::Maybe<zc::Own<ast::DebuggerStatement>> Parser::parseDebuggerStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseDebuggerStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseDebuggerStatement");
 
   source::SourceLoc loc = currentLoc();
   if (!consumeExpectedToken(ast::SyntaxKind::DebuggerKeyword)) { return zc::none; }
@@ -3899,7 +4212,7 @@ zc::Maybe<zc::Own<ast::DebuggerStatement>> Parser::parseDebuggerStatement() {
 }
 
 zc::Own<ast::NewExpression> Parser::parseNewExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseNewExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseNewExpression");
 
   // newExpression: memberExpression | NEW newExpression;
   // memberExpression: (primaryExpression | superProperty | NEW memberExpression arguments)
@@ -3932,7 +4245,7 @@ zc::Own<ast::NewExpression> Parser::parseNewExpression() {
 }
 
 zc::Own<ast::ParenthesizedExpression> Parser::parseParenthesizedExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseParenthesizedExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseParenthesizedExpression");
 
   // parenthesizedExpression: LPAREN expression RPAREN;
 
@@ -3950,7 +4263,7 @@ zc::Own<ast::ParenthesizedExpression> Parser::parseParenthesizedExpression() {
 zc::Own<ast::LeftHandSideExpression> Parser::parseMemberExpressionRest(
     zc::Own<ast::LeftHandSideExpression> expression, source::SourceLoc pos,
     bool allowOptionalChain) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseMemberExpressionRest");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseMemberExpressionRest");
 
   while (true) {
     bool questionDotToken = false;
@@ -4001,7 +4314,7 @@ zc::Own<ast::LeftHandSideExpression> Parser::parseMemberExpressionRest(
 }
 
 zc::Own<ast::MemberExpression> Parser::parseSuperExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseSuperExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseSuperExpression");
 
   const lexer::Token token = currentToken();
   const source::SourceLoc loc = token.getLocation();
@@ -4045,7 +4358,7 @@ zc::Own<ast::MemberExpression> Parser::parseSuperExpression() {
 }
 
 zc::Own<ast::MemberExpression> Parser::parseImportCallExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseImportCallExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseImportCallExpression");
 
   const lexer::Token token = currentToken();
   const source::SourceLoc loc = token.getLocation();
@@ -4086,17 +4399,23 @@ zc::Own<ast::MemberExpression> Parser::parseImportCallExpression() {
   return finishNode(zc::mv(expression), loc);
 }
 
-source::SourceLoc Parser::getFullStartLoc() const { return impl->lexer.getFullStartLoc(); }
+source::SourceLoc Parser::getFullStartLoc() const {
+  return impl->lexer.getLoc(impl->currentState().fullStartPtr);
+}
 
-source::SourceLoc Parser::getTokenStartLoc() const { return impl->lexer.getTokenStartLoc(); }
+source::SourceLoc Parser::getTokenStartLoc() const {
+  return impl->lexer.getLoc(impl->currentState().tokenStartPtr);
+}
 
-bool Parser::hasPrecedingLineBreak() const { return impl->lexer.hasPrecedingLineBreak(); }
+bool Parser::hasPrecedingLineBreak() const {
+  return static_cast<bool>(impl->currentState().tokenFlags & lexer::TokenFlags::PrecedingLineBreak);
+}
 
 // ================================================================================
 // Literal parsing implementations
 
 zc::Maybe<zc::Own<ast::StringLiteral>> Parser::parseStringLiteral() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseStringLiteral");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseStringLiteral");
 
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::StringLiteral)) { return zc::none; }
@@ -4109,7 +4428,7 @@ zc::Maybe<zc::Own<ast::StringLiteral>> Parser::parseStringLiteral() {
 }
 
 zc::Maybe<zc::Own<ast::IntegerLiteral>> Parser::parseIntegerLiteral() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseIntegerLiteral");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseIntegerLiteral");
 
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::IntegerLiteral)) { return zc::none; }
@@ -4123,7 +4442,7 @@ zc::Maybe<zc::Own<ast::IntegerLiteral>> Parser::parseIntegerLiteral() {
 }
 
 zc::Maybe<zc::Own<ast::FloatLiteral>> Parser::parseFloatLiteral() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFloatLiteral");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFloatLiteral");
 
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::FloatLiteral)) { return zc::none; }
@@ -4137,7 +4456,7 @@ zc::Maybe<zc::Own<ast::FloatLiteral>> Parser::parseFloatLiteral() {
 }
 
 zc::Maybe<zc::Own<ast::BooleanLiteral>> Parser::parseBooleanLiteral() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseBooleanLiteral");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseBooleanLiteral");
 
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::TrueKeyword) && !token.is(ast::SyntaxKind::FalseKeyword)) {
@@ -4152,7 +4471,7 @@ zc::Maybe<zc::Own<ast::BooleanLiteral>> Parser::parseBooleanLiteral() {
 }
 
 zc::Maybe<zc::Own<ast::NullLiteral>> Parser::parseNullLiteral() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseNullLiteral");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseNullLiteral");
 
   const lexer::Token& token = currentToken();
   if (!token.is(ast::SyntaxKind::NullKeyword)) { return zc::none; }
@@ -4164,7 +4483,7 @@ zc::Maybe<zc::Own<ast::NullLiteral>> Parser::parseNullLiteral() {
 }
 
 zc::Own<ast::FunctionExpression> Parser::parseFunctionExpression() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseFunctionExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseFunctionExpression");
 
   // functionExpression:
   //   FUN callSignature LBRACE functionBody RBRACE;
@@ -4195,7 +4514,7 @@ zc::Own<ast::FunctionExpression> Parser::parseFunctionExpression() {
 }
 
 zc::Maybe<zc::Own<ast::TypeParameterDeclaration>> Parser::parseTypeParameter() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeParameter");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeParameter");
 
   // typeParameter: identifier constraint?;
   // constraint: EXTENDS type;
@@ -4216,7 +4535,7 @@ zc::Maybe<zc::Own<ast::TypeParameterDeclaration>> Parser::parseTypeParameter() {
 }
 
 zc::Maybe<zc::Vector<zc::Own<ast::TypeParameterDeclaration>>> Parser::parseTypeParameters() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseTypeParameters");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseTypeParameters");
 
   if (!expectToken(ast::SyntaxKind::LessThan)) { return zc::none; }
 
@@ -4226,7 +4545,7 @@ zc::Maybe<zc::Vector<zc::Own<ast::TypeParameterDeclaration>>> Parser::parseTypeP
 }
 
 zc::Maybe<zc::Own<ast::ParameterDeclaration>> Parser::parseParameterDeclaration() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseParameterDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseParameterDeclaration");
 
   const source::SourceLoc loc = currentLoc();
 
@@ -4241,7 +4560,7 @@ zc::Maybe<zc::Own<ast::ParameterDeclaration>> Parser::parseParameterDeclaration(
 }
 
 zc::Vector<zc::Own<ast::ParameterDeclaration>> Parser::parseParameters() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseParameters");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseParameters");
 
   if (ZC_LIKELY(parseExpected(ast::SyntaxKind::LeftParen))) {
     auto parameters = parseDelimitedList<ast::ParameterDeclaration>(
@@ -4254,8 +4573,8 @@ zc::Vector<zc::Own<ast::ParameterDeclaration>> Parser::parseParameters() {
 }
 
 zc::Vector<zc::Own<ast::CaptureElement>> Parser::parseCaptureClause() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseCaptureClause");
-  zc::Vector<zc::Own<ast::CaptureElement>> captures;
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseCaptureClause");
+  ListScratch<ast::CaptureElement> captures(*this);
 
   if (expectToken(ast::SyntaxKind::Identifier) && currentToken().getValue() == "use"_zc) {
     nextToken();  // consume 'use'
@@ -4273,11 +4592,11 @@ zc::Vector<zc::Own<ast::CaptureElement>> Parser::parseCaptureClause() {
       consumeExpectedToken(ast::SyntaxKind::RightBracket);
     }
   }
-  return captures;
+  return captures.finish();
 }
 
 zc::Maybe<zc::Own<ast::CaptureElement>> Parser::parseCaptureElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseCaptureElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseCaptureElement");
   bool isByReference = false;
   source::SourceLoc loc = currentLoc();
 
@@ -4300,14 +4619,14 @@ zc::Maybe<zc::Own<ast::CaptureElement>> Parser::parseCaptureElement() {
 }
 
 zc::Maybe<zc::Own<ast::ReturnTypeNode>> Parser::parseReturnType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseReturnType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseReturnType");
 
   if (expectToken(ast::SyntaxKind::Arrow)) { return parseRequiredReturnType(); }
   return zc::none;
 }
 
 zc::Own<ast::ReturnTypeNode> Parser::parseRequiredReturnType() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseRequiredReturnType");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseRequiredReturnType");
 
   // Parse optional return type or error return clause
   //
@@ -4328,7 +4647,7 @@ zc::Own<ast::ReturnTypeNode> Parser::parseRequiredReturnType() {
 }
 
 zc::Own<ast::VariableStatement> Parser::parseVariableStatement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseVariableStatement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseVariableStatement");
 
   // variableStatement: variableDeclarationList ';'
   // This handles variable declarations like: let x = 5; or const y: i32 = 10;
@@ -4385,8 +4704,7 @@ zc::Own<ast::Identifier> Parser::parseRightSideOfDot(
 
 zc::Own<ast::PropertyAccessExpression> Parser::parsePropertyAccessExpressionRest(
     zc::Own<ast::LeftHandSideExpression> expression, bool questionDot, source::SourceLoc pos) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser,
-                                 "parsePropertyAccessExpressionRest");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePropertyAccessExpressionRest");
 
   auto name = parseRightSideOfDot(/*allowIdentifierNames*/ true,
                                   /*allowUnicodeEscapeSequenceInIdentifierName*/ true);
@@ -4425,7 +4743,7 @@ bool Parser::tryReparseOptionalChain(ast::LeftHandSideExpression& node) {
 
 zc::Own<ast::ElementAccessExpression> Parser::parseElementAccessExpressionRest(
     zc::Own<ast::LeftHandSideExpression> expression, bool questionDot, source::SourceLoc pos) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseElementAccessExpression");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseElementAccessExpression");
 
   zc::Maybe<zc::Own<ast::Expression>> assignmentExpression;
   if (expectToken(ast::SyntaxKind::RightBracket)) {
@@ -4444,7 +4762,7 @@ zc::Own<ast::ElementAccessExpression> Parser::parseElementAccessExpressionRest(
 }
 
 zc::Maybe<zc::Own<ast::TokenNode>> Parser::parseExpectedToken(ast::SyntaxKind kind) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseExpectedToken");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseExpectedToken");
 
   // parseExpectedToken: consume a token of the expected kind and create a TokenNode
   // This is used when we need to parse a specific token and create an AST node for it
@@ -4461,7 +4779,7 @@ zc::Maybe<zc::Own<ast::TokenNode>> Parser::parseExpectedToken(ast::SyntaxKind ki
 }
 
 bool Parser::parseOptional(ast::SyntaxKind kind) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseOptional");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseOptional");
 
   // parseOptional: consume a token of the expected kind if it exists
   // This is used when we want to parse a token if it exists, but don't care about the result
@@ -4490,7 +4808,7 @@ bool Parser::parseExpected(ast::SyntaxKind kind, bool shouldAdvance) {
 }
 
 zc::Own<ast::ClassElement> Parser::parseClassElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseClassElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseClassElement");
 
   const source::SourceLoc loc = currentLoc();
 
@@ -4557,7 +4875,7 @@ zc::Vector<ast::SyntaxKind> Parser::parseModifiers(bool allowDecorators, bool pe
 
 zc::Own<ast::ClassElement> Parser::parsePropertyOrMethodDeclaration(
     source::SourceLoc loc, zc::Vector<ast::SyntaxKind> modifiers) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePropertyOrMethodDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePropertyOrMethodDeclaration");
 
   auto name = parseIdentifierName();
   zc::Maybe<zc::Own<ast::TokenNode>> questionToken = parseOptionalToken(ast::SyntaxKind::Question);
@@ -4572,7 +4890,7 @@ zc::Own<ast::ClassElement> Parser::parsePropertyOrMethodDeclaration(
 zc::Own<ast::ClassElement> Parser::parsePropertyDeclaration(
     source::SourceLoc loc, zc::Vector<ast::SyntaxKind> modifiers, zc::Own<ast::Identifier> name,
     zc::Maybe<zc::Own<ast::TokenNode>> questionToken) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePropertyDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePropertyDeclaration");
 
   zc::Maybe<zc::Own<ast::TypeNode>> type = zc::none;
   type = parseTypeAnnotation();
@@ -4587,12 +4905,19 @@ zc::Own<ast::ClassElement> Parser::parsePropertyDeclaration(
 zc::Own<ast::ClassElement> Parser::parseMethodDeclaration(
     source::SourceLoc loc, zc::Vector<ast::SyntaxKind> modifiers, zc::Own<ast::Identifier> name,
     zc::Maybe<zc::Own<ast::TokenNode>> questionToken) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseMethodDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseMethodDeclaration");
 
   auto typeParameters = parseTypeParameters();
   auto parameters = parseParameters();
   auto returnType = parseReturnType();
 
+  ZC_IF_SOME(deferred, skipFunctionBody()) {
+    return finishNode(ast::factory::createMethodDeclaration(
+                          zc::mv(modifiers), zc::mv(name), zc::mv(questionToken),
+                          zc::mv(typeParameters), zc::mv(parameters), zc::mv(returnType),
+                          zc::mv(deferred)),
+                      loc);
+  }
   auto body = parseFunctionBlockOrSemicolon();
   return finishNode(
       ast::factory::createMethodDeclaration(zc::mv(modifiers), zc::mv(name), zc::mv(questionToken),
@@ -4603,7 +4928,7 @@ zc::Own<ast::ClassElement> Parser::parseMethodDeclaration(
 
 zc::Own<ast::ClassElement> Parser::parseInitDeclaration(source::SourceLoc loc,
                                                         zc::Vector<ast::SyntaxKind> modifiers) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseInitDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseInitDeclaration");
 
   nextToken();
 
@@ -4620,7 +4945,7 @@ zc::Own<ast::ClassElement> Parser::parseInitDeclaration(source::SourceLoc loc,
 
 zc::Own<ast::ClassElement> Parser::parseDeinitDeclaration(source::SourceLoc loc,
                                                           zc::Vector<ast::SyntaxKind> modifiers) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseDeinitDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseDeinitDeclaration");
 
   nextToken();
   auto body = parseFunctionBlockOrSemicolon();
@@ -4631,7 +4956,7 @@ zc::Own<ast::ClassElement> Parser::parseDeinitDeclaration(source::SourceLoc loc,
 zc::Own<ast::ClassElement> Parser::parseAccessorDeclaration(source::SourceLoc loc,
                                                             zc::Vector<ast::SyntaxKind> modifiers,
                                                             ast::SyntaxKind accessorKind) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseAccessorDeclaration");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseAccessorDeclaration");
 
   nextToken();
 
@@ -4672,7 +4997,7 @@ zc::Vector<zc::Own<ast::InterfaceElement>> Parser::parseInterfaceMembers() {
 }
 
 zc::Maybe<zc::Own<ast::InterfaceElement>> Parser::parseInterfaceElement() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseInterfaceElement");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseInterfaceElement");
 
   const source::SourceLoc loc = currentLoc();
 
@@ -4730,7 +5055,7 @@ zc::Maybe<zc::Own<ast::InterfaceElement>> Parser::parsePropertyOrMethodSignature
 zc::Maybe<zc::Own<ast::InterfaceElement>> Parser::parsePropertySignature(
     source::SourceLoc start, zc::Vector<ast::SyntaxKind> modifiers, zc::Own<ast::Identifier> name,
     zc::Maybe<zc::Own<ast::TokenNode>> questionToken) {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parsePropertySignature");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parsePropertySignature");
 
   auto type = parseTypeAnnotation();
   auto initializer = parseInitializer();
@@ -4745,7 +5070,7 @@ zc::Maybe<zc::Own<ast::InterfaceElement>> Parser::parsePropertySignature(
 }
 
 zc::Maybe<zc::Own<ast::InterfaceElement>> Parser::parseMethodSignature() {
-  trace::ScopeTracer scopeTracer(trace::TraceCategory::kParser, "parseMethodSignature");
+  ZOM_TRACE_SCOPE(trace::TraceCategory::kParser, "parseMethodSignature");
 
   const source::SourceLoc loc = currentLoc();
 
@@ -14,12 +14,15 @@
 
 #pragma once
 
+#include "zc/core/arena.h"
 #include "zc/core/common.h"
 #include "zc/core/function.h"
 #include "zc/core/memory.h"
+#include "zc/core/vector.h"
 #include "zomlang/compiler/ast/ast.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/ast/module.h"
 #include "zomlang/compiler/ast/statement.h"
 #include "zomlang/compiler/ast/type.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
@@ -139,11 +142,56 @@ inline ParsingContexts operator<<(ParsingContexts a, ParsingContext b) {
 /// \brief Parser state for tryParse operations
 /// Similar to TypeScript's speculationHelper and tsgo's ParserState
 struct ParserState {
+  /// Index of the current token in the parser's token buffer.
+  size_t position;
   lexer::LexerState lexerState;
-  lexer::Token token;
 
-  ParserState(lexer::LexerState lexerState, lexer::Token token)
-      : lexerState(lexerState), token(token) {}
+  ParserState(size_t position, lexer::LexerState lexerState)
+      : position(position), lexerState(lexerState) {}
+};
+
+/// \brief The top level of a byte range of a buffer, parsed by `Parser::parseChunk()`.
+struct SourceChunk {
+  /// Arena the nodes were allocated from, if `LangOptions::useAstArena` is set. Declared first so
+  /// that it outlives the nodes.
+  zc::Maybe<zc::Own<zc::Arena>> arena;
+  /// Only the chunk at the start of the buffer can have one.
+  zc::Maybe<zc::Own<ast::ModuleDeclaration>> moduleDeclaration;
+  zc::Vector<zc::Own<ast::Statement>> statements;
+  /// Start of the first token and end of the last one.
+  source::SourceLoc start;
+  source::SourceLoc end;
+};
+
+/// \brief Pick offsets at which a buffer can be cut into chunks that parse independently.
+///
+/// Cuts are made right after a top-level `;` or `}` that is followed by a keyword that can only
+/// start a declaration, preferring the first such place after each multiple of the buffer size
+/// divided by `maxChunks`. Nothing past the first template literal with substitutions is cut,
+/// since `tokens` does not re-scan the `}` that resumes the template.
+/// \param tokens The buffer's tokens, from `lexer::Lexer::lexAll()`.
+/// \return The start offset of each chunk, beginning with 0.
+zc::Vector<uint32_t> findChunkBoundaries(const lexer::TokenTable& tokens, size_t maxChunks);
+
+/// \brief Assemble the chunks of one buffer, in source order, into a single SourceFile that owns
+/// their arenas.
+zc::Own<ast::SourceFile> joinSourceChunks(zc::StringPtr fileName,
+                                          zc::Vector<SourceChunk>&& chunks);
+
+/// \brief Receives each top-level statement of a file as soon as the parser completes it, while
+/// its nodes are still in cache, e.g. to bind its declarations without a second pass over the tree.
+class StatementListener {
+public:
+  virtual ~StatementListener() noexcept(false) = default;
+
+  /// \brief `statement` is complete, source ranges included. The parser keeps it, and puts it
+  /// into the source file once the rest are parsed.
+  virtual void statementParsed(ast::Statement& statement) = 0;
+
+  /// \brief The file the statements are in failed to parse, so its tree is not returned. It is
+  /// handed over instead, statements included, for whatever refers to them to be undone before it
+  /// goes. The default drops it.
+  virtual void parseFailed(zc::Own<ast::Node> tree) {}
 };
 
 /// \brief The parser class.
@@ -160,6 +208,17 @@ public:
   /// \return The AST if parsing succeeded, zc::Nothing otherwise.
   zc::Maybe<zc::Own<ast::Node>> parse();
 
+  /// \brief Hand each top-level statement `parse()` completes to `listener`, in source order.
+  void setStatementListener(StatementListener& listener);
+
+  /// \brief Parse the top-level statements in bytes [begin, end) of the buffer, which must start
+  /// and end between top-level statements, instead of the whole of it. Use instead of `parse()`.
+  SourceChunk parseChunk(uint32_t begin, uint32_t end);
+
+  /// \brief Parse the function body whose braces span bytes [begin, end) of the buffer. Bodies
+  /// skipped under `LangOptions::lazyFunctionBodies` are parsed this way when first requested.
+  zc::Own<ast::BlockStatement> parseFunctionBody(uint32_t begin, uint32_t end);
+
   /// \brief Look ahead n tokens without consuming them
   /// \param n The number of tokens to look ahead (1-based, 1 means next token)
   /// \return The token at position n, or EOF token if beyond end
@@ -176,9 +235,10 @@ public:
   /// \return true if the nth token matches the kind, false otherwise
   bool isLookAhead(unsigned n, ast::SyntaxKind kind);
 
-  // Lookahead functions
+  /// \brief Run `callback` speculatively and rewind the parser afterwards
+  /// \return What `callback` returned
   template <typename T>
-  T lookAhead(zc::Function<T()> callback);
+  T lookAhead(zc::FunctionParam<T()> callback);
 
 private:
   ZC_ALWAYS_INLINE(diagnostics::DiagnosticEngine& getDiagnosticEngine() const);
@@ -236,6 +296,10 @@ private:
   bool parseSemicolon();
   zc::Own<ast::BlockStatement> parseFunctionBlock();
   zc::Maybe<zc::Own<ast::BlockStatement>> parseFunctionBlockOrSemicolon();
+  /// \brief Under `LangOptions::lazyFunctionBodies`, move past the braced body at the current
+  /// token by brace matching and return a deferred parse of it. Returns none, without moving, when
+  /// lazy bodies are off, the current token is not `{` or the braces are unbalanced.
+  zc::Maybe<ast::DeferredBody> skipFunctionBody();
   void parseSemicolonAfterPropertyName(const zc::Own<ast::Identifier>& name,
                                        const zc::Maybe<zc::Own<ast::TypeNode>>& typeNode,
                                        const zc::Maybe<zc::Own<ast::Expression>>& initializer);
@@ -252,6 +316,59 @@ private:
     return zc::mv(node);
   }
 
+  /// \brief Children of one list under construction, kept on the parser's scratch stack.
+  ///
+  /// Elements are pushed onto a stack shared by every list being parsed; nested lists push
+  /// above their parent's elements and pop them again before the parent continues. `finish()`
+  /// moves the elements into a vector allocated at their exact count, so building a node's
+  /// children neither regrows a vector nor leaves spare capacity in the node.
+  template <ast::NodeLike T>
+  class ListScratch {
+  public:
+    explicit ListScratch(Parser& parser) : stack(parser.getListScratch()), base(stack.size()) {}
+    ~ListScratch() { stack.truncate(base); }
+
+    ZC_DISALLOW_COPY_AND_MOVE(ListScratch);
+
+    void add(zc::Own<T> node) { stack.add(zc::mv(node)); }
+    size_t size() const { return stack.size() - base; }
+    bool empty() const { return stack.size() == base; }
+
+    /// \brief Pop this list's elements into an exactly sized vector.
+    zc::Vector<zc::Own<T>> finish() {
+      zc::Vector<zc::Own<T>> result(size());
+      for (size_t i = base; i < stack.size(); ++i) { result.add(stack[i].template downcast<T>()); }
+      stack.truncate(base);
+      return result;
+    }
+
+  private:
+    zc::Vector<zc::Own<ast::Node>>& stack;
+    const size_t base;
+  };
+
+  /// Declaration-only element kinds such as `ClassElement` cannot be held as `ast::Node`, so
+  /// their lists grow locally and are trimmed to size by `finish()`.
+  template <ast::NodeLike T>
+    requires(!std::is_base_of_v<ast::Node, T>)
+  class ListScratch<T> {
+  public:
+    explicit ListScratch(Parser&) {}
+
+    ZC_DISALLOW_COPY_AND_MOVE(ListScratch);
+
+    void add(zc::Own<T> node) { nodes.add(zc::mv(node)); }
+    size_t size() const { return nodes.size(); }
+    bool empty() const { return nodes.empty(); }
+
+    zc::Vector<zc::Own<T>> finish() { return nodes.releaseAsArray(); }
+
+  private:
+    zc::Vector<zc::Own<T>> nodes;
+  };
+
+  zc::Vector<zc::Own<ast::Node>>& getListScratch();
+
   bool isListTerminator(ParsingContext context) const;
   bool isListElement(ParsingContext context, bool inErrorRecovery);
   bool abortParsingListOrMoveToNextToken(ParsingContext context);
@@ -261,7 +378,7 @@ private:
                                    zc::Function<zc::Maybe<zc::Own<T>>()> parseElement) {
     const ParsingContexts saveContext = getContext();
     setContext(saveContext | (1ul << context));
-    zc::Vector<zc::Own<T>> result;
+    ListScratch<T> result(*this);
 
     while (!isListTerminator(context)) {
       if (isListElement(context, /*inErrorRecovery*/ false)) {
@@ -273,7 +390,7 @@ private:
     }
 
     setContext(saveContext);
-    return result;
+    return result.finish();
   }
 
   template <ast::NodeLike T>
@@ -281,7 +398,7 @@ private:
                                             zc::Function<zc::Maybe<zc::Own<T>>()> parseElement) {
     const ParsingContexts saveContext = getContext();
     setContext(saveContext | (1ull << context));
-    zc::Vector<zc::Own<T>> list;
+    ListScratch<T> list(*this);
 
     while (true) {
       if (isListElement(context, /*inErrorRecovery*/ false)) {
@@ -312,7 +429,7 @@ private:
     }
 
     setContext(saveContext);
-    return list;
+    return list.finish();
   }
 
   template <ast::NodeLike T>
@@ -36,8 +36,8 @@ ZC_NODISCARD zc::String SourceLoc::toString(const SourceManager& sm, uint64_t& l
 
   auto lineAndCol = sm.getPresumedLineAndColumnForLoc(*this, bufferId);
 
-  return zc::str("SourceLoc(", prefix, ":", lineAndCol.line, ":", lineAndCol.column, " @ 0x",
-                 zc::hex(reinterpret_cast<uintptr_t>(ptr)), ")");
+  return zc::str("SourceLoc(", prefix, ":", lineAndCol.line, ":", lineAndCol.column, " @ ", offset,
+                 ")");
 }
 
 void SourceLoc::print(zc::OutputStream& os, const SourceManager& sm) const {
@@ -24,42 +24,53 @@ namespace source {
 
 class SourceManager;
 
+/// \brief A position in the location space of a `SourceManager`.
+///
+/// Every buffer added to a source manager is given a contiguous range of 32-bit offsets, one per
+/// byte plus one for its end, so a location is a plain integer: comparing, advancing and measuring
+/// locations never touches the buffer, and the buffer holding a location is found by comparing
+/// offsets. Offset 0 is the invalid location. `SourceManager::getCharacterData()` maps a location
+/// back to its text.
 class SourceLoc {
 public:
-  SourceLoc() : ptr(nullptr) {}
-  explicit SourceLoc(const zc::byte* p) : ptr(p) {}
+  constexpr SourceLoc() : offset(0) {}
 
-  ZC_NODISCARD bool isValid() const { return ptr != nullptr; }
+  ZC_NODISCARD bool isValid() const { return offset != 0; }
   ZC_NODISCARD bool isInvalid() const { return !isValid(); }
 
-  ZC_NODISCARD const zc::byte* getOpaqueValue() const { return ptr; }
-  static SourceLoc getFromOpaqueValue(const zc::byte* ptr) { return SourceLoc(ptr); }
+  ZC_NODISCARD uint32_t getOpaqueValue() const { return offset; }
+  static SourceLoc getFromOpaqueValue(uint32_t offset) {
+    SourceLoc loc;
+    loc.offset = offset;
+    return loc;
+  }
 
-  ZC_NODISCARD SourceLoc getAdvancedLoc(unsigned offset) const {
-    return getFromOpaqueValue(getOpaqueValue() + offset);
+  ZC_NODISCARD SourceLoc getAdvancedLoc(int32_t distance) const {
+    return getFromOpaqueValue(offset + distance);
   }
 
   ZC_NODISCARD zc::String toString(const SourceManager& sm, uint64_t& lastBufferId) const;
   void print(zc::OutputStream& os, const SourceManager& sm) const;
 
-  bool operator==(const SourceLoc& rhs) const { return ptr == rhs.ptr; }
+  bool operator==(const SourceLoc& rhs) const { return offset == rhs.offset; }
   bool operator!=(const SourceLoc& rhs) const { return !operator==(rhs); }
-  bool operator<(const SourceLoc& rhs) const { return ptr < rhs.ptr; }
-  bool operator<=(const SourceLoc& rhs) const { return ptr <= rhs.ptr; }
-  bool operator>(const SourceLoc& rhs) const { return ptr > rhs.ptr; }
-  bool operator>=(const SourceLoc& rhs) const { return ptr >= rhs.ptr; }
-  const zc::byte* operator-(unsigned offset) const { return ptr - offset; }
-  const zc::byte* operator+(unsigned offset) const { return ptr + offset; }
+  bool operator<(const SourceLoc& rhs) const { return offset < rhs.offset; }
+  bool operator<=(const SourceLoc& rhs) const { return offset <= rhs.offset; }
+  bool operator>(const SourceLoc& rhs) const { return offset > rhs.offset; }
+  bool operator>=(const SourceLoc& rhs) const { return offset >= rhs.offset; }
+  SourceLoc operator-(unsigned distance) const { return getFromOpaqueValue(offset - distance); }
+  SourceLoc operator+(unsigned distance) const { return getFromOpaqueValue(offset + distance); }
 
 private:
-  const zc::byte* ptr;
+  uint32_t offset;
 };
 
+static_assert(sizeof(SourceLoc) == 4);
+
 class SourceRange {
 public:
   SourceRange() = default;
   SourceRange(const SourceLoc start, const SourceLoc end) : start(start), end(end) {}
-  SourceRange(const zc::byte* start, const zc::byte* end) : start(start), end(end) {}
 
   ZC_NODISCARD SourceLoc getStart() const { return start; }
   ZC_NODISCARD SourceLoc getEnd() const { return end; }
@@ -100,6 +111,8 @@ private:
   SourceLoc end;
 };
 
+static_assert(sizeof(SourceRange) == 8);
+
 class CharSourceRange {
 public:
   CharSourceRange() = default;
@@ -154,15 +167,14 @@ private:
 
   static SourceLoc computeEnd(const SourceLoc start, const unsigned length) {
     ZC_IREQUIRE(!start.isInvalid(), "Invalid start location.");
-    ZC_IREQUIRE(length >= 0, "Length must be greater than or equal to zero.");
 
-    const zc::byte* startvalue = start.getOpaqueValue();
-    const zc::byte* endvalue = startvalue + length;
+    const uint32_t startValue = start.getOpaqueValue();
+    const uint32_t endValue = startValue + length;
 
-    // Check only pointer overflows (such as reverse offsets)
-    ZC_IREQUIRE(endvalue >= startvalue, "Overflow in length calculation.");
+    // Check only offset overflows (such as reverse offsets)
+    ZC_IREQUIRE(endValue >= startValue, "Overflow in length calculation.");
 
-    return SourceLoc::getFromOpaqueValue(endvalue);
+    return SourceLoc::getFromOpaqueValue(endValue);
   }
 };
 
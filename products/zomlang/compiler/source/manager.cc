@@ -15,15 +15,20 @@
 #include "zomlang/compiler/source/manager.h"
 
 #include <algorithm>
-#include <functional>
+#include <atomic>
+#include <bit>
+#include <cstring>
 
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
 #include "zc/core/filesystem.h"
 #include "zc/core/map.h"
 #include "zc/core/memory.h"
+#include "zc/core/mutex.h"
+#include "zc/core/refcount.h"
 #include "zc/core/string.h"
 #include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/source/location.h"
 
 namespace zomlang {
@@ -72,76 +77,269 @@ struct GeneratedSourceInfo {
   CharSourceRange generatedSourceRange;
 };
 
+namespace {
+
+/// Files at least this large are mapped rather than read.
+constexpr uint64_t kMinMappedFileSize = 16 * 1024;
+/// Every page size in use is a multiple of this.
+constexpr uint64_t kMinPageSize = 4096;
+
+/// Copy `text` into storage that is followed by a NUL byte.
+zc::Array<const zc::byte> copyWithSentinel(zc::ArrayPtr<const zc::byte> text) {
+  zc::Array<zc::byte> storage = zc::heapArray<zc::byte>(text.size() + 1);
+  if (text.size() != 0) { memcpy(storage.begin(), text.begin(), text.size()); }
+  storage[text.size()] = 0;
+  return storage.first(text.size()).attach(zc::mv(storage));
+}
+
+/// Map or read a source file so that its text is followed by a NUL byte.
+zc::Array<const zc::byte> loadSourceFile(const zc::ReadableFile& file) {
+  const zc::FsNode::Metadata metadata = file.stat();
+  if (metadata.type == zc::FsNode::Type::FILE) {
+    const uint64_t size = metadata.size;
+    // The OS zero-fills the last page of a mapping past the end of the file, which provides the
+    // sentinel without a copy unless the file ends exactly on a page boundary.
+    if (size >= kMinMappedFileSize && size % kMinPageSize != 0) { return file.mmap(0, size); }
+
+    zc::Array<zc::byte> storage = zc::heapArray<zc::byte>(size + 1);
+    if (file.read(0, storage.first(size)) == size) {
+      storage[size] = 0;
+      return storage.first(size).attach(zc::mv(storage));
+    }
+    // The file shrank since stat(); read whatever is there now.
+  }
+  // Pipes and other streams have no size to go by.
+  return copyWithSentinel(file.readAllBytes());
+}
+
+/// Offsets of the first byte of each line. memchr is vectorized by the C library, so the scan
+/// skips a word or more at a time between newlines rather than testing every byte.
+zc::Vector<unsigned> findLineStarts(const zc::ArrayPtr<const zc::byte> text) {
+  zc::Vector<unsigned> offsets;
+  offsets.add(0);
+  const zc::byte* const end = text.end();
+  for (const zc::byte* pos = text.begin(); pos != end;) {
+    const void* newline = memchr(pos, '\n', end - pos);
+    if (newline == nullptr) { break; }
+    pos = static_cast<const zc::byte*>(newline) + 1;
+    offsets.add(static_cast<unsigned>(pos - text.begin()));
+  }
+  return offsets;
+}
+
+/// 64-bit MurmurHash2 (MurmurHash64A) of `text`, eight bytes at a time. A 32-bit CRC would
+/// collide too often to name entries in a cache shared across many builds.
+uint64_t hashContent(const zc::ArrayPtr<const zc::byte> text) {
+  constexpr uint64_t m = 0xc6a4a7935bd1e995ull;
+  constexpr int r = 47;
+  uint64_t h = text.size() * m;
+  const zc::byte* data = text.begin();
+  size_t len = text.size();
+  for (; len >= 8; data += 8, len -= 8) {
+    uint64_t k;
+    memcpy(&k, data, sizeof(k));
+    k *= m;
+    k ^= k >> r;
+    k *= m;
+    h ^= k;
+    h *= m;
+  }
+  switch (len) {
+    case 7:
+      h ^= uint64_t(data[6]) << 48;
+      ZC_FALLTHROUGH;
+    case 6:
+      h ^= uint64_t(data[5]) << 40;
+      ZC_FALLTHROUGH;
+    case 5:
+      h ^= uint64_t(data[4]) << 32;
+      ZC_FALLTHROUGH;
+    case 4:
+      h ^= uint64_t(data[3]) << 24;
+      ZC_FALLTHROUGH;
+    case 3:
+      h ^= uint64_t(data[2]) << 16;
+      ZC_FALLTHROUGH;
+    case 2:
+      h ^= uint64_t(data[1]) << 8;
+      ZC_FALLTHROUGH;
+    case 1:
+      h ^= uint64_t(data[0]);
+      h *= m;
+  }
+  h ^= h >> r;
+  h *= m;
+  h ^= h >> r;
+  return h;
+}
+
+/// Source managers are told apart in the extracted text cache by a number that is never reused,
+/// so that a manager created where a destroyed one was does not see that one's entries.
+std::atomic<uint64_t> nextManagerKey{1};
+
+/// Text the calling thread extracted lately, by the manager and the locations it lies between.
+/// The dumper and diagnostics ask for the same ranges again and again; a hit gives back the
+/// interned string without hashing the text or locking the pool. Direct-mapped, so a miss only
+/// costs overwriting one entry.
+struct ExtractedTextCache {
+  struct Entry {
+    uint64_t manager = 0;
+    uint32_t start = 0;
+    uint32_t end = 0;
+    zc::StringPtr text;
+  };
+
+  static constexpr uint kIndexBits = 7;
+  Entry entries[size_t(1) << kIndexBits];
+
+  Entry& find(const uint64_t manager, const uint32_t start, const uint32_t end) {
+    const uint64_t key = (uint64_t(start) << 32 | end) * 0x9E3779B97F4A7C15ull + manager;
+    return entries[key >> (64 - kIndexBits)];
+  }
+};
+
+}  // namespace
+
 struct Buffer {
-  /// Unique Id
-  const BufferId id;
+  /// Unique Id, assigned when the buffer is registered
+  BufferId id{0};
   /// Path in file system
   zc::String identifier;
-  /// Content of buffer
-  zc::Array<zc::byte> data;
+  /// Content of buffer, either mapped or on the heap, followed by a NUL byte. Empty once the
+  /// buffer is released.
+  zc::Array<const zc::byte> data;
+  /// Size of the content, which the buffer's locations keep covering after it is released.
+  const size_t size;
+  /// Location of the first byte, assigned when the buffer is registered; the buffer holds the
+  /// locations up to and including its end.
+  uint32_t startOffset = 0;
   /// The original source location of this buffer.
   GeneratedSourceInfo generatedInfo;
-  /// The offset in bytes of the first character in the buffer.
-  mutable zc::Vector<unsigned> lineStartOffsets;
-
-  Buffer(const BufferId id, zc::String identifier, zc::Array<zc::byte> data)
-      : id(id), identifier(zc::mv(identifier)), data(zc::mv(data)) {}
+  /// The offset in bytes of the first character of each line. Built with the buffer, on the
+  /// thread that loaded it, so line and column queries never wait on a scan. A released buffer
+  /// keeps only the first line.
+  zc::Vector<unsigned> lineStartOffsets;
+  /// Hash of `data`, computed along with the line table.
+  const uint64_t contentHash;
+  /// Set once a reload registered newer content for the same file.
+  mutable std::atomic<bool> superseded{false};
+
+  Buffer(zc::String identifier, zc::Array<const zc::byte> data)
+      : identifier(zc::mv(identifier)),
+        data(zc::mv(data)),
+        size(this->data.size()),
+        lineStartOffsets(findLineStarts(this->data)),
+        contentHash(hashContent(this->data)) {}
 
   const zc::byte* getBufferStart() const { return data.begin(); }
   const zc::byte* getBufferEnd() const { return data.end(); }
 
-  ZC_NODISCARD size_t getBufferSize() const { return data.size(); }
-};
-
-/// Compare the source location ranges for two impl->buffers, as an ordering to
-/// use for fast searches.
-struct BufferIDRangeComparator {
-  const SourceManager& sourceManager;
-
-  bool operator()(BufferId lhsID, BufferId rhsID) const {
-    auto lhsRange = sourceManager.getRangeForBuffer(lhsID);
-    auto rhsRange = sourceManager.getRangeForBuffer(rhsID);
+  ZC_NODISCARD size_t getBufferSize() const { return size; }
 
-    // If the source impl->buffers are identical, we want the higher-numbered
-    // source impl->buffers to occur first. This is important when uniquing.
-    if (lhsRange == rhsRange) return lhsID > rhsID;
+  void addMemoryUsage(basic::MemoryUsage& usage) const {
+    usage.addObject<Buffer>();
+    usage.addString(identifier);
+    usage.add(data.size(), data.size());
+    usage.addVector(lineStartOffsets);
+  }
 
-    std::less<const zc::byte*> pointerCompare;
-    return pointerCompare(lhsRange.getStart().getOpaqueValue(),
-                          rhsRange.getStart().getOpaqueValue());
+  /// Free the text and the line table, keeping the range of locations the buffer holds.
+  void release() {
+    data = nullptr;
+    lineStartOffsets.clear();
+    lineStartOffsets.add(0);
   }
 
-  bool operator()(BufferId lhsID, SourceLoc rhsLoc) const {
-    auto lhsRange = sourceManager.getRangeForBuffer(lhsID);
+  ZC_NODISCARD SourceLoc getStartLoc() const { return SourceLoc::getFromOpaqueValue(startOffset); }
 
-    std::less<const zc::byte*> pointerCompare;
-    return pointerCompare(lhsRange.getEnd().getOpaqueValue(), rhsLoc.getOpaqueValue());
+  ZC_NODISCARD bool contains(const SourceLoc loc) const {
+    return loc.getOpaqueValue() >= startOffset &&
+           loc.getOpaqueValue() - startOffset <= getBufferSize();
   }
 
-  bool operator()(SourceLoc lhsLoc, BufferId rhsID) const {
-    auto rhsRange = sourceManager.getRangeForBuffer(rhsID);
+  /// The text between two locations, or none if they are not an ordered pair in this buffer.
+  ZC_NODISCARD zc::Maybe<zc::ArrayPtr<const zc::byte>> slice(const SourceLoc start,
+                                                             const SourceLoc end) const {
+    if (!contains(start) || !contains(end) || start > end) { return zc::none; }
+    // Nothing is left of a released buffer's text
+    if (end.getOpaqueValue() - startOffset > data.size()) { return zc::none; }
+    return data.slice(start.getOpaqueValue() - startOffset, end.getOpaqueValue() - startOffset);
+  }
 
-    std::less<const zc::byte*> pointerCompare;
-    return pointerCompare(lhsLoc.getOpaqueValue(), rhsRange.getStart().getOpaqueValue());
+  /// The 1-based line holding `offset`. Diagnostics tend to be reported in source order, so the
+  /// line this thread resolved last and its neighbours are tried before the binary search.
+  ZC_NODISCARD unsigned getLineNumber(const unsigned offset) const {
+    struct LastLine {
+      const Buffer* buffer = nullptr;
+      unsigned line = 0;
+    };
+    static thread_local LastLine last;
+
+    const zc::Vector<unsigned>& starts = lineStartOffsets;
+    // Line n spans [starts[n - 1], starts[n]).
+    auto holds = [&](const unsigned line) {
+      return line >= 1 && line <= starts.size() && starts[line - 1] <= offset &&
+             (line == starts.size() || offset < starts[line]);
+    };
+    if (last.buffer == this) {
+      for (const unsigned line : {last.line, last.line + 1, last.line - 1}) {
+        if (holds(line)) {
+          last.line = line;
+          return line;
+        }
+      }
+    }
+    const unsigned line = std::upper_bound(starts.begin(), starts.end(), offset) - starts.begin();
+    last = {this, line};
+    return line;
   }
 };
 
-/// Determine whether the source ranges for two impl->buffers are equivalent.
-struct BufferIDSameRange {
-  const SourceManager& sourceMgr;
+/// Append-only table of the registered buffers, indexed by BufferId - 1. Lookups take no lock:
+/// entries are never moved or removed, and `size()` only counts an entry once it is fully written.
+/// Segment k holds 2^k entries, so growing the table leaves earlier entries in place.
+class BufferTable {
+public:
+  ZC_NODISCARD size_t size() const { return count.load(std::memory_order_acquire); }
+
+  /// \param index Must be below a value `size()` returned.
+  const Buffer& operator[](const size_t index) const {
+    const size_t segment = std::bit_width(index + 1) - 1;
+    return *segments[segment][index + 1 - (size_t(1) << segment)];
+  }
+  /// Callers serialize changes to an entry with additions and with lookups of that entry.
+  Buffer& operator[](const size_t index) {
+    const size_t segment = std::bit_width(index + 1) - 1;
+    return *segments[segment][index + 1 - (size_t(1) << segment)];
+  }
 
-  bool operator()(BufferId lhsID, BufferId rhsID) const {
-    auto lhsRange = sourceMgr.getRangeForBuffer(lhsID);
-    auto rhsRange = sourceMgr.getRangeForBuffer(rhsID);
+  /// Callers serialize additions among themselves.
+  void add(zc::Own<Buffer> buffer) {
+    const size_t index = count.load(std::memory_order_relaxed);
+    const size_t segment = std::bit_width(index + 1) - 1;
+    ZC_REQUIRE(segment < kSegmentCount, "too many source buffers");
+    const size_t position = index + 1 - (size_t(1) << segment);
+    if (position == 0) {
+      segments[segment] = zc::heapArray<zc::Own<Buffer>>(size_t(1) << segment);
+    }
+    segments[segment][position] = zc::mv(buffer);
+    count.store(index + 1, std::memory_order_release);
+  }
 
-    return lhsRange == rhsRange;
+  /// Callers serialize this with additions.
+  void addMemoryUsage(basic::MemoryUsage& usage) const {
+    const size_t count = size();
+    size_t allocated = 0;
+    for (const zc::Array<zc::Own<Buffer>>& segment : segments) { allocated += segment.size(); }
+    usage.add(count * sizeof(zc::Own<Buffer>), allocated * sizeof(zc::Own<Buffer>));
+    for (size_t i = 0; i < count; ++i) { (*this)[i].addMemoryUsage(usage); }
   }
-};
 
-struct BufferLocCache {
-  zc::Vector<BufferId> sortedBuffers;
-  uint64_t numBuffersOriginal = 0;
-  zc::Maybe<BufferId> lastBufferId;
+private:
+  static constexpr size_t kSegmentCount = 32;
+
+  zc::Array<zc::Own<Buffer>> segments[kSegmentCount];
+  std::atomic<size_t> count{0};
 };
 
 struct SourceManager::Impl {
@@ -152,17 +350,16 @@ struct SourceManager::Impl {
 
   /// The filesystem to use for reading files.
   zc::Own<const zc::Filesystem> fs;
-  /// File a path to BufferID mapping cache
-  zc::HashMap<zc::String, BufferId> pathToBufferId;
   /// Whether to open in volatile mode (disallow memory mappings)
   bool openAsVolatile = false;
 
   zc::Vector<VirtualFile> virtualFiles;
   zc::Vector<SourceLoc> regexLiteralStartLocs;
 
-  zc::Vector<zc::Own<Buffer>> buffers;
-  /// Fast lookup from buffer ID to buffer.
-  zc::HashMap<BufferId, const Buffer&> idToBuffer;
+  /// Registered buffers, in ascending order of `startOffset`.
+  BufferTable buffers;
+  /// Index of the buffer the last lookup found. Locations tend to come from the same buffer.
+  mutable std::atomic<size_t> lastBufferIndex{0};
 
   mutable basic::StringPool ownedExtractedTextPool;
   mutable zc::Maybe<basic::StringPool&> externalExtractedTextPool;
@@ -172,7 +369,220 @@ struct SourceManager::Impl {
     return ownedExtractedTextPool;
   }
 
-  mutable BufferLocCache locCache;
+  /// Tells this manager's entries in the extracted text cache apart.
+  const uint64_t managerKey = nextManagerKey.fetch_add(1, std::memory_order_relaxed);
+
+  /// The text between the ends of `range`, interned, or found interned in this thread's cache.
+  zc::StringPtr internExtractedText(const SourceRange& range,
+                                    const zc::ArrayPtr<const zc::byte> bytes) const {
+    static thread_local ExtractedTextCache cache;
+    const uint32_t start = range.getStart().getOpaqueValue();
+    const uint32_t end = range.getEnd().getOpaqueValue();
+    ExtractedTextCache::Entry& entry = cache.find(managerKey, start, end);
+    if (entry.manager != managerKey || entry.start != start || entry.end != end) {
+      entry = {managerKey, start, end, getExtractedTextPool().intern(bytes.asChars())};
+    }
+    return entry.text;
+  }
+
+  /// Text of an overlay, shared by the overlay and the buffers made from it.
+  struct OverlayText final : public zc::AtomicRefcounted {
+    explicit OverlayText(zc::String text) : text(zc::mv(text)) {}
+    const zc::String text;
+  };
+
+  struct Overlay {
+    /// None once the overlay is removed. The entry stays, so that the removal counts as a change.
+    zc::Maybe<zc::Own<const OverlayText>> text;
+    uint64_t version;
+  };
+
+  /// State that registering a buffer changes.
+  struct Registry {
+    /// File a path to BufferID mapping cache
+    zc::HashMap<zc::String, BufferId> pathToBufferId;
+    /// Location the next buffer starts at; 0 is reserved for the invalid location.
+    uint32_t nextOffset = 1;
+    /// Unsaved text standing in for files, by the same paths as `pathToBufferId`.
+    zc::HashMap<zc::String, Overlay> overlays;
+    /// Version stamp handed out last, when an overlay was set or removed.
+    uint64_t overlayVersion = 0;
+  };
+  /// Serializes registration; lookups read `buffers` without it.
+  zc::MutexGuarded<Registry> registry;
+
+  BufferId addBuffer(zc::String identifier, zc::Array<const zc::byte> data) {
+    auto lockedRegistry = registry.lockExclusive();
+    return addBuffer(*lockedRegistry, zc::heap<Buffer>(zc::mv(identifier), zc::mv(data)));
+  }
+
+  BufferId addBuffer(Registry& locked, zc::Own<Buffer> buffer) {
+    ZC_REQUIRE(buffer->getBufferSize() < UINT32_MAX - locked.nextOffset,
+               "source location space exhausted", buffer->identifier);
+    const BufferId bufferId(buffers.size() + 1);
+    buffer->id = bufferId;
+    buffer->startOffset = locked.nextOffset;
+    locked.nextOffset += buffer->getBufferSize() + 1;
+    buffers.add(zc::mv(buffer));
+    return bufferId;
+  }
+
+  /// Register a buffer read from `path`, unless another thread registered the path first.
+  BufferId addFileBuffer(const zc::StringPtr path, zc::Own<Buffer> buffer) {
+    auto lockedRegistry = registry.lockExclusive();
+    ZC_IF_SOME(bufferId, lockedRegistry->pathToBufferId.find(path)) { return bufferId; }
+    const BufferId bufferId = addBuffer(*lockedRegistry, zc::mv(buffer));
+    lockedRegistry->pathToBufferId.insert(zc::str(path), bufferId);
+    return bufferId;
+  }
+
+  zc::Maybe<BufferId> findFileBuffer(const zc::StringPtr path) const {
+    return registry.lockShared()->pathToBufferId.find(path);
+  }
+
+  /// Register `buffer` as the current content of `path`, retiring the buffer it replaces.
+  /// Returns the old buffer instead if the content is the same.
+  BufferId replaceFileBuffer(const zc::StringPtr path, zc::Own<Buffer> buffer) {
+    auto lockedRegistry = registry.lockExclusive();
+    return replaceFileBuffer(*lockedRegistry, path, zc::mv(buffer));
+  }
+
+  BufferId replaceFileBuffer(Registry& locked, const zc::StringPtr path, zc::Own<Buffer> buffer) {
+    ZC_IF_SOME(oldId, locked.pathToBufferId.find(path)) {
+      const Buffer& old = ZC_ASSERT_NONNULL(getBuffer(oldId));
+      if (old.contentHash == buffer->contentHash && old.data == buffer->data) { return oldId; }
+      old.superseded.store(true, std::memory_order_relaxed);
+    }
+    const BufferId bufferId = addBuffer(locked, zc::mv(buffer));
+    locked.pathToBufferId.upsert(zc::str(path), bufferId);
+    return bufferId;
+  }
+
+  /// Forget the file at `path`, retiring its buffer.
+  void removeFileBuffer(const zc::StringPtr path) {
+    auto lockedRegistry = registry.lockExclusive();
+    removeFileBuffer(*lockedRegistry, path);
+  }
+
+  void removeFileBuffer(Registry& locked, const zc::StringPtr path) {
+    ZC_IF_SOME(oldId, locked.pathToBufferId.find(path)) {
+      ZC_ASSERT_NONNULL(getBuffer(oldId)).superseded.store(true, std::memory_order_relaxed);
+      locked.pathToBufferId.erase(path);
+    }
+  }
+
+  /// A buffer over the text of an overlay, without copying it: the string's NUL terminator is the
+  /// buffer's sentinel.
+  static zc::Own<Buffer> makeOverlayBuffer(const zc::StringPtr path, const OverlayText& text) {
+    return zc::heap<Buffer>(zc::str(path), text.text.asBytes().attach(zc::atomicAddRef(text)));
+  }
+
+  /// A buffer over the overlay of `path`, or none if it has none.
+  zc::Maybe<zc::Own<Buffer>> loadOverlay(const zc::StringPtr path) const {
+    zc::Maybe<zc::Own<const OverlayText>> text;
+    {
+      auto lockedRegistry = registry.lockShared();
+      ZC_IF_SOME(overlay, lockedRegistry->overlays.find(path)) {
+        ZC_IF_SOME(overlayText, overlay.text) { text = zc::atomicAddRef(*overlayText); }
+      }
+    }
+    // The line table is built outside the lock.
+    ZC_IF_SOME(overlayText, text) { return makeOverlayBuffer(path, *overlayText); }
+    return zc::none;
+  }
+
+  /// Make `text` the overlay of `path` and its buffer the file's current one.
+  uint64_t setOverlay(zc::String path, zc::Own<const OverlayText> text) {
+    zc::Own<Buffer> buffer = makeOverlayBuffer(path, *text);
+    auto lockedRegistry = registry.lockExclusive();
+    replaceFileBuffer(*lockedRegistry, path, zc::mv(buffer));
+    const uint64_t version = ++lockedRegistry->overlayVersion;
+    lockedRegistry->overlays.upsert(zc::mv(path), Overlay{zc::mv(text), version});
+    return version;
+  }
+
+  /// Drop the overlay of `path`, forgetting the file so that it is read from disk again.
+  void removeOverlay(const zc::StringPtr path) {
+    auto lockedRegistry = registry.lockExclusive();
+    ZC_IF_SOME(overlay, lockedRegistry->overlays.find(path)) {
+      if (overlay.text == zc::none) { return; }
+      overlay.text = zc::none;
+      overlay.version = ++lockedRegistry->overlayVersion;
+      removeFileBuffer(*lockedRegistry, path);
+    }
+  }
+
+  /// Free the text of a buffer and retire it. A file's path is forgotten, so that asking for the
+  /// file again reads it again.
+  void releaseBuffer(const BufferId bufferId) {
+    const uint64_t index = bufferId;
+    ZC_REQUIRE(index != 0 && index <= buffers.size(), "unknown source buffer");
+    auto lockedRegistry = registry.lockExclusive();
+    Buffer& buffer = buffers[index - 1];
+    ZC_IF_SOME(fileId, lockedRegistry->pathToBufferId.find(buffer.identifier)) {
+      if (fileId == bufferId) { lockedRegistry->pathToBufferId.erase(buffer.identifier); }
+    }
+    buffer.superseded.store(true, std::memory_order_relaxed);
+    buffer.release();
+  }
+
+  struct ResolvedPath {
+    const zc::ReadableDirectory& dir;
+    zc::Path path;
+  };
+
+  /// Resolve `path` against the working directory. Returns none for an empty path.
+  zc::Maybe<ResolvedPath> resolvePath(const zc::StringPtr path) const {
+    if (path.size() == 0) { return zc::none; }
+
+    const zc::PathPtr cwd = fs->getCurrentPath();
+    zc::Path nativePath = cwd.evalNative(path);
+    if (nativePath.startsWith(cwd)) {
+      return ResolvedPath{fs->getCurrent(),
+                          nativePath.slice(cwd.size(), nativePath.size()).clone()};
+    }
+    return ResolvedPath{fs->getRoot(), zc::mv(nativePath)};
+  }
+
+  /// Read a file and build its line table without registering it, so that it can run on any
+  /// thread. Returns none if the file does not exist.
+  zc::Maybe<zc::Own<Buffer>> loadFile(const zc::ReadableDirectory& dir,
+                                      const zc::PathPtr path) const {
+    ZC_IF_SOME(file, dir.tryOpenFile(path)) {
+      return zc::heap<Buffer>(path.toString(), loadSourceFile(*file));
+    }
+    return zc::none;
+  }
+
+  zc::Maybe<const Buffer&> getBuffer(const BufferId bufferId) const {
+    const uint64_t index = bufferId;
+    if (index == 0 || index > buffers.size()) { return zc::none; }
+    return buffers[index - 1];
+  }
+
+  zc::Maybe<const Buffer&> findBuffer(const SourceLoc loc) const {
+    const size_t count = buffers.size();
+    if (loc.isInvalid() || count == 0) { return zc::none; }
+
+    // Check the last buffer we looked in.
+    const size_t last = lastBufferIndex.load(std::memory_order_relaxed);
+    if (last < count && buffers[last].contains(loc)) { return buffers[last]; }
+
+    // Find the last buffer starting at or before `loc`.
+    size_t low = 0;
+    size_t high = count;
+    while (low < high) {
+      const size_t mid = low + (high - low) / 2;
+      if (buffers[mid].startOffset <= loc.getOpaqueValue()) {
+        low = mid + 1;
+      } else {
+        high = mid;
+      }
+    }
+    if (low == 0 || !buffers[low - 1].contains(loc)) { return zc::none; }
+    lastBufferIndex.store(low - 1, std::memory_order_relaxed);
+    return buffers[low - 1];
+  }
 };
 
 // ================================================================================
@@ -193,23 +603,15 @@ LineAndColumn SourceManager::getPresumedLineAndColumnForLoc(SourceLoc loc,
 
   // Get the actual buffer ID
   ZC_IF_SOME(actualBufferId, bufferId.isValid() ? bufferId : findBufferContainingLoc(loc)) {
-    const Buffer& buffer = ZC_ASSERT_NONNULL(impl->idToBuffer.find(actualBufferId));
+    const Buffer& buffer = ZC_ASSERT_NONNULL(impl->getBuffer(actualBufferId));
 
     // Calculate the row number and column number
-    unsigned line = 1;
-    unsigned column = 1;
-    const zc::byte* ptr = buffer.getBufferStart();
-    const zc::byte* locPtr = loc.getOpaqueValue();
-
-    while (ptr < locPtr && ptr < buffer.getBufferEnd()) {
-      if (*ptr == '\n') {
-        ++line;
-        column = 1;
-      } else {
-        ++column;
-      }
-      ++ptr;
-    }
+    const unsigned offset = static_cast<unsigned>(
+        loc.getOpaqueValue() <= buffer.startOffset
+            ? 0
+            : zc::min(size_t(loc.getOpaqueValue() - buffer.startOffset), buffer.getBufferSize()));
+    const unsigned line = buffer.getLineNumber(offset);
+    const unsigned column = offset - buffer.lineStartOffsets[line - 1] + 1;
 
     ZC_ASSERT(line + lineOffset > 0, "bogus line offset");
 
@@ -220,23 +622,62 @@ LineAndColumn SourceManager::getPresumedLineAndColumnForLoc(SourceLoc loc,
   ZC_UNREACHABLE;
 }
 
+zc::Array<LineAndColumn> SourceManager::resolveLineColumns(
+    const zc::ArrayPtr<const SourceLoc> locs) const {
+  auto builder = zc::heapArrayBuilder<LineAndColumn>(locs.size());
+  for (size_t i = 0; i < locs.size(); ++i) { builder.add(0, 0); }
+  zc::Array<LineAndColumn> result = builder.finish();
+
+  zc::Vector<uint32_t> order(locs.size());
+  for (uint32_t i = 0; i < locs.size(); ++i) { order.add(i); }
+  std::sort(order.begin(), order.end(), [&](const uint32_t a, const uint32_t b) {
+    return locs[a].getOpaqueValue() < locs[b].getOpaqueValue();
+  });
+
+  const Buffer* buffer = nullptr;
+  // Index of the line holding the previous location, which the next one cannot precede
+  size_t line = 0;
+  for (const uint32_t i : order) {
+    const SourceLoc loc = locs[i];
+    if (loc.isInvalid()) { continue; }
+    if (buffer == nullptr || !buffer->contains(loc)) {
+      ZC_IF_SOME(found, impl->findBuffer(loc)) {
+        buffer = &found;
+        line = 0;
+      }
+      else { continue; }
+    }
+
+    const unsigned offset = static_cast<unsigned>(
+        zc::min(size_t(loc.getOpaqueValue() - buffer->startOffset), buffer->getBufferSize()));
+    const zc::Vector<unsigned>& starts = buffer->lineStartOffsets;
+    // Double the stride until it overshoots, then search the last stride.
+    size_t low = line;
+    size_t stride = 1;
+    while (low + stride < starts.size() && starts[low + stride] <= offset) {
+      low += stride;
+      stride *= 2;
+    }
+    const size_t high = zc::min(low + stride, starts.size());
+    line = std::upper_bound(starts.begin() + low + 1, starts.begin() + high, offset) -
+           starts.begin() - 1;
+
+    int lineOffset = 0;
+    ZC_IF_SOME(vf, getVirtualFile(loc)) { lineOffset = vf.lineOffset; }
+    result[i] = LineAndColumn(static_cast<uint32_t>(line + 1 + lineOffset),
+                              offset - starts[line] + 1);
+  }
+  return result;
+}
+
 BufferId SourceManager::addNewSourceBuffer(zc::Array<zc::byte> inputData,
                                            const zc::StringPtr bufIdentifier) {
-  const BufferId bufferId(impl->buffers.size() + 1);
-  zc::Own<Buffer> buffer = zc::heap<Buffer>(bufferId, zc::str(bufIdentifier), zc::mv(inputData));
-  impl->buffers.add(zc::mv(buffer));
-  impl->idToBuffer.insert(bufferId, *impl->buffers.back());
-  return bufferId;
+  return impl->addBuffer(zc::str(bufIdentifier), copyWithSentinel(inputData));
 }
 
 BufferId SourceManager::addMemBufferCopy(const zc::ArrayPtr<const zc::byte> inputData,
                                          const zc::StringPtr bufIdentifier) {
-  const BufferId bufferId(impl->buffers.size() + 1);
-  zc::Own<Buffer> buffer =
-      zc::heap<Buffer>(bufferId, zc::str(bufIdentifier), zc::heapArray(inputData));
-  impl->buffers.add(zc::mv(buffer));
-  impl->idToBuffer.insert(bufferId, *impl->buffers.back());
-  return bufferId;
+  return impl->addBuffer(zc::str(bufIdentifier), copyWithSentinel(inputData));
 }
 
 void SourceManager::createVirtualFile(const SourceLoc& loc, zc::StringPtr name, int lineOffset,
@@ -259,12 +700,19 @@ const zc::Maybe<const VirtualFile&> SourceManager::getVirtualFile(const SourceLo
 }
 
 SourceLoc SourceManager::getLocForBufferStart(BufferId bufferId) const {
-  return getRangeForBuffer(bufferId).getStart();
+  return ZC_ASSERT_NONNULL(impl->getBuffer(bufferId)).getStartLoc();
 }
 
 unsigned SourceManager::getLocOffsetInBuffer(SourceLoc loc, BufferId bufferId) const {
   ZC_ASSERT(loc.isValid(), "invalid loc");
-  return 0;
+  const Buffer& buffer = ZC_ASSERT_NONNULL(impl->getBuffer(bufferId));
+  ZC_ASSERT(buffer.contains(loc), "location outside buffer");
+  return loc.getOpaqueValue() - buffer.startOffset;
+}
+
+const zc::byte* SourceManager::getCharacterData(SourceLoc loc) const {
+  const Buffer& buffer = ZC_ASSERT_NONNULL(impl->findBuffer(loc), "location outside any buffer");
+  return buffer.getBufferStart() + (loc.getOpaqueValue() - buffer.startOffset);
 }
 
 SourceLoc SourceManager::getLocForOffset(BufferId bufferId, unsigned offset) const {
@@ -282,71 +730,15 @@ zc::StringPtr SourceManager::getDisplayNameForLoc(const SourceLoc& loc) const {
 }
 
 zc::ArrayPtr<const zc::byte> SourceManager::getEntireTextForBuffer(BufferId bufferId) const {
-  return ZC_ASSERT_NONNULL(impl->idToBuffer.find(bufferId)).data;
+  return ZC_ASSERT_NONNULL(impl->getBuffer(bufferId)).data;
 }
 
-zc::Maybe<BufferId> SourceManager::findBufferContainingLoc(const SourceLoc& loc) const {
-  if (loc.isInvalid()) return zc::none;
-
-  const zc::byte* ptr = loc.getOpaqueValue();
-  const uint64_t numBuffers = impl->buffers.size();
-
-  // If the cache is out-of-date, update it now.
-  if (numBuffers != impl->locCache.numBuffersOriginal) {
-    impl->locCache.sortedBuffers.clear();
-    for (const zc::Own<Buffer>& buf : impl->buffers) { impl->locCache.sortedBuffers.add(buf->id); }
-    impl->locCache.numBuffersOriginal = numBuffers;
-
-    // Sort the buffer IDs by source range.
-    std::sort(impl->locCache.sortedBuffers.begin(), impl->locCache.sortedBuffers.end(),
-              BufferIDRangeComparator{*this});
-
-    // Remove lower-numbered impl->buffers with the same source ranges as higher-
-    // numbered impl->buffers. We want later alias impl->buffers to be found first.
-    BufferId* newEnd = std::unique(impl->locCache.sortedBuffers.begin(),
-                                   impl->locCache.sortedBuffers.end(), BufferIDSameRange{*this});
-    // Calculate the number of unique elements (i.e., the new size)
-    auto newSize = std::distance(impl->locCache.sortedBuffers.begin(), newEnd);
-    // Truncate the vector to the new size
-    impl->locCache.sortedBuffers.truncate(newSize);
-    // Forget the last buffer we looked at; it might have been replaced.
-    impl->locCache.lastBufferId = zc::none;
-  }
-
-  // Check the last buffer we looked in.
-  ZC_IF_SOME(lastId, impl->locCache.lastBufferId) {
-    const Buffer& lastBuf = ZC_ASSERT_NONNULL(impl->idToBuffer.find(lastId));
-    if (ptr >= lastBuf.data.begin() && ptr <= lastBuf.data.end()) { return lastId; }
-  }
-
-  // Search the sorted list of buffer IDs.
-  auto it =
-      std::upper_bound(impl->locCache.sortedBuffers.begin(), impl->locCache.sortedBuffers.end(),
-                       loc, BufferIDRangeComparator{*this});
-
-  // upper_bound returns the first element that is greater than loc.
-  // We need to check the previous element (if it exists) to see if it contains loc.
-  if (it != impl->locCache.sortedBuffers.begin()) {
-    const BufferId candidateId = *(it - 1);
-    ZC_IF_SOME(candidate, impl->idToBuffer.find(candidateId)) {
-      if (ptr >= candidate.data.begin() && ptr <= candidate.data.end()) {
-        impl->locCache.lastBufferId = candidateId;
-        return candidateId;
-      }
-    }
-  }
-  // If upper_bound returned begin(), it means all buffers are greater than loc,
-  // but we should still check if the first buffer contains loc.
-  else if (!impl->locCache.sortedBuffers.empty()) {
-    const BufferId candidateId = *impl->locCache.sortedBuffers.begin();
-    ZC_IF_SOME(candidate, impl->idToBuffer.find(candidateId)) {
-      if (ptr >= candidate.data.begin() && ptr <= candidate.data.end()) {
-        impl->locCache.lastBufferId = candidateId;
-        return candidateId;
-      }
-    }
-  }
+uint64_t SourceManager::getContentHash(BufferId bufferId) const {
+  return ZC_ASSERT_NONNULL(impl->getBuffer(bufferId)).contentHash;
+}
 
+zc::Maybe<BufferId> SourceManager::findBufferContainingLoc(const SourceLoc& loc) const {
+  ZC_IF_SOME(buffer, impl->findBuffer(loc)) { return buffer.id; }
   return zc::none;
 }
 
@@ -370,44 +762,180 @@ zc::Maybe<unsigned> SourceManager::resolveFromLineCol(BufferId bufferId, unsigne
   return zc::none;
 }
 
+void SourceManager::releaseBuffer(BufferId bufferId) { impl->releaseBuffer(bufferId); }
+
 zc::StringPtr SourceManager::getIdentifierForBuffer(BufferId bufferId) const {
-  return ZC_ASSERT_NONNULL(impl->idToBuffer.find(bufferId)).identifier;
+  return ZC_ASSERT_NONNULL(impl->getBuffer(bufferId)).identifier;
 }
 
 CharSourceRange SourceManager::getRangeForBuffer(BufferId bufferId) const {
-  const Buffer& buffer = ZC_ASSERT_NONNULL(impl->idToBuffer.find(bufferId));
-  const SourceLoc start{buffer.getBufferStart()};
-  return CharSourceRange(start, buffer.getBufferSize());
+  const Buffer& buffer = ZC_ASSERT_NONNULL(impl->getBuffer(bufferId));
+  return CharSourceRange(buffer.getStartLoc(), buffer.getBufferSize());
 }
 
 zc::Maybe<BufferId> SourceManager::getFileSystemSourceBufferID(const zc::StringPtr path) {
-  // Return none for empty paths
-  if (path.size() == 0) { return zc::none; }
-
-  const zc::PathPtr cwd = impl->fs->getCurrentPath();
-  zc::Path nativePath = cwd.evalNative(path);
-  ZC_REQUIRE(path.size() > 0);
-
-  const zc::ReadableDirectory& dir =
-      nativePath.startsWith(cwd) ? impl->fs->getCurrent() : impl->fs->getRoot();
-  const zc::Path sourcePath = nativePath.startsWith(cwd)
-                                  ? nativePath.slice(cwd.size(), nativePath.size()).clone()
-                                  : zc::mv(nativePath);
-
-  // Check if the path is already in the cache
-  ZC_IF_SOME(bufferId, impl->pathToBufferId.find(path)) { return bufferId; }
-
-  ZC_IF_SOME(file, dir.tryOpenFile(sourcePath)) {
-    zc::Array<zc::byte> data = file->readAllBytes();
-    const BufferId bufferId = addNewSourceBuffer(zc::mv(data), sourcePath.toString());
-    impl->pathToBufferId.insert(sourcePath.toString(), bufferId);
-    return bufferId;
+  ZC_IF_SOME(resolved, impl->resolvePath(path)) {
+    const zc::String key = resolved.path.toString();
+    // Check if the path is already in the cache
+    ZC_IF_SOME(bufferId, impl->findFileBuffer(key)) { return bufferId; }
+
+    ZC_IF_SOME(buffer, impl->loadOverlay(key)) { return impl->addFileBuffer(key, zc::mv(buffer)); }
+    ZC_IF_SOME(buffer, impl->loadFile(resolved.dir, resolved.path)) {
+      return impl->addFileBuffer(key, zc::mv(buffer));
+    }
+  }
+
+  // If the path is empty or the file is not found, return none
+  return zc::none;
+}
+
+zc::Maybe<BufferId> SourceManager::findFileSystemSourceBufferID(const zc::StringPtr path) const {
+  ZC_IF_SOME(resolved, impl->resolvePath(path)) {
+    return impl->findFileBuffer(resolved.path.toString());
+  }
+  return zc::none;
+}
+
+zc::Maybe<BufferId> SourceManager::reloadFileSystemSourceBuffer(const zc::StringPtr path) {
+  ZC_IF_SOME(resolved, impl->resolvePath(path)) {
+    const zc::String key = resolved.path.toString();
+    ZC_IF_SOME(buffer, impl->loadOverlay(key)) {
+      return impl->replaceFileBuffer(key, zc::mv(buffer));
+    }
+    ZC_IF_SOME(buffer, impl->loadFile(resolved.dir, resolved.path)) {
+      return impl->replaceFileBuffer(key, zc::mv(buffer));
+    }
+    impl->removeFileBuffer(key);
+  }
+  return zc::none;
+}
+
+uint64_t SourceManager::setOverlay(const zc::StringPtr path, zc::String text) {
+  auto resolved = ZC_REQUIRE_NONNULL(impl->resolvePath(path), "an overlay needs a path");
+  return impl->setOverlay(resolved.path.toString(),
+                          zc::atomicRefcounted<Impl::OverlayText>(zc::mv(text)));
+}
+
+void SourceManager::removeOverlay(const zc::StringPtr path) {
+  ZC_IF_SOME(resolved, impl->resolvePath(path)) {
+    impl->removeOverlay(resolved.path.toString());
   }
+}
 
-  // If the file is not found, return none
+zc::Maybe<uint64_t> SourceManager::getOverlayVersion(const zc::StringPtr path) const {
+  ZC_IF_SOME(resolved, impl->resolvePath(path)) {
+    auto lockedRegistry = impl->registry.lockShared();
+    ZC_IF_SOME(overlay, lockedRegistry->overlays.find(resolved.path.toString())) {
+      if (overlay.text != zc::none) { return overlay.version; }
+    }
+  }
   return zc::none;
 }
 
+uint64_t SourceManager::getLatestOverlayVersion() const {
+  return impl->registry.lockShared()->overlayVersion;
+}
+
+zc::Vector<zc::String> SourceManager::getOverlaysChangedSince(const uint64_t version) const {
+  zc::Vector<zc::String> paths;
+  auto lockedRegistry = impl->registry.lockShared();
+  for (const auto& entry : lockedRegistry->overlays) {
+    if (entry.value.version > version) { paths.add(zc::str(entry.key)); }
+  }
+  return paths;
+}
+
+zc::Vector<zc::Maybe<BufferId>> SourceManager::getFileSystemSourceBufferIDs(
+    const zc::ArrayPtr<const zc::StringPtr> paths, basic::ThreadPool& threadPool) {
+  if (paths.size() == 1) {
+    zc::Vector<zc::Maybe<BufferId>> bufferIds;
+    bufferIds.add(getFileSystemSourceBufferID(paths[0]));
+    return bufferIds;
+  }
+
+  struct Load {
+    zc::String key;
+    zc::Maybe<BufferId> cached;
+    zc::Maybe<zc::Own<Buffer>> buffer;
+    zc::Maybe<zc::Exception> exception;
+  };
+  zc::Array<Load> loads = zc::heapArray<Load>(paths.size());
+
+  /// Uncached files, grouped by the directory they resolve against.
+  struct DirectoryLoads {
+    const zc::ReadableDirectory& dir;
+    zc::Vector<zc::Path> paths;
+    zc::Vector<Load*> loads;
+  };
+  zc::Vector<DirectoryLoads> groups;
+
+  for (size_t i = 0; i < paths.size(); ++i) {
+    Load& load = loads[i];
+    ZC_IF_SOME(resolved, impl->resolvePath(paths[i])) {
+      load.key = resolved.path.toString();
+      load.cached = impl->findFileBuffer(load.key);
+      if (load.cached != zc::none) { continue; }
+      load.buffer = impl->loadOverlay(load.key);
+      if (load.buffer != zc::none) { continue; }
+
+      DirectoryLoads* group = nullptr;
+      for (DirectoryLoads& g : groups) {
+        if (&g.dir == &resolved.dir) { group = &g; }
+      }
+      if (group == nullptr) { group = &groups.add(DirectoryLoads{resolved.dir, {}, {}}); }
+      group->paths.add(zc::mv(resolved.path));
+      group->loads.add(&load);
+    }
+  }
+
+  {
+    basic::TaskGroup reads(threadPool);
+    for (DirectoryLoads& group : groups) {
+      // Where the kernel takes a whole batch of reads at once, submit them together and only build
+      // the line tables on the pool. On network filesystems this turns thousands of round trips
+      // into a few.
+      const zc::Array<zc::PathPtr> pathPtrs =
+          ZC_MAP(path, group.paths) { return zc::PathPtr(path); };
+      ZC_IF_SOME(contents, zc::tryReadFilesBatched(group.dir, pathPtrs, 1)) {
+        for (size_t i = 0; i < contents.size(); ++i) {
+          ZC_IF_SOME(data, contents[i]) {
+            reads.fork([&load = *group.loads[i], identifier = group.paths[i].toString(),
+                        data = zc::mv(data)]() mutable {
+              load.exception = zc::runCatchingExceptions(
+                  [&]() { load.buffer = zc::heap<Buffer>(zc::mv(identifier), zc::mv(data)); });
+            });
+          }
+        }
+        continue;
+      }
+
+      for (size_t i = 0; i < group.paths.size(); ++i) {
+        reads.fork([this, &load = *group.loads[i], &dir = group.dir,
+                    path = zc::mv(group.paths[i])]() {
+          load.exception =
+              zc::runCatchingExceptions([&]() { load.buffer = impl->loadFile(dir, path); });
+        });
+      }
+    }
+    // Each read keeps its own exception, so the join has none to rethrow.
+    reads.join();
+  }
+
+  // Register in argument order, so that buffer ids and locations do not depend on which read
+  // finished first.
+  zc::Vector<zc::Maybe<BufferId>> bufferIds;
+  bufferIds.reserve(loads.size());
+  for (Load& load : loads) {
+    ZC_IF_SOME(exception, load.exception) { zc::throwFatalException(zc::mv(exception)); }
+    ZC_IF_SOME(buffer, load.buffer) {
+      bufferIds.add(impl->addFileBuffer(load.key, zc::mv(buffer)));
+    } else {
+      bufferIds.add(load.cached);
+    }
+  }
+  return bufferIds;
+}
+
 SourceLoc SourceManager::getLocFromExternalSource(const zc::StringPtr path, const unsigned line,
                                                   const unsigned col) {
   ZC_IF_SOME(bufferId, getFileSystemSourceBufferID(path)) {
@@ -422,47 +950,13 @@ zc::ArrayPtr<const zc::byte> SourceManager::extractText(const SourceRange& range
                                                         zc::Maybe<BufferId> bufferId) const {
   if (range.isInvalid()) { return zc::ArrayPtr<const zc::byte>(); }
 
-  const SourceLoc start = range.getStart();
-  const SourceLoc end = range.getEnd();
-
-  // Find the buffer containing the range
-  ZC_IF_SOME(providedBufferId, bufferId) {
-    // Use the provided buffer ID
-    ZC_IF_SOME(buffer, impl->idToBuffer.find(providedBufferId)) {
-      const zc::byte* bufferStart = buffer.getBufferStart();
-      const zc::byte* bufferEnd = buffer.getBufferEnd();
-      const zc::byte* rangeStart = start.getOpaqueValue();
-      const zc::byte* rangeEnd = end.getOpaqueValue();
-
-      // Validate that the range is within the buffer
-      if (rangeStart < bufferStart || rangeEnd > bufferEnd || rangeStart > rangeEnd) {
-        return zc::ArrayPtr<const zc::byte>();
-      }
+  // Use the provided buffer ID, or find the buffer containing the range
+  zc::Maybe<const Buffer&> buffer;
+  ZC_IF_SOME(providedBufferId, bufferId) { buffer = impl->getBuffer(providedBufferId); }
+  else { buffer = impl->findBuffer(range.getStart()); }
 
-      // Return the text slice
-      const size_t length = rangeEnd - rangeStart;
-      return zc::ArrayPtr<const zc::byte>(rangeStart, length);
-    }
-    return zc::ArrayPtr<const zc::byte>();
-  }
-
-  // Find buffer automatically
-  ZC_IF_SOME(foundBufferId, findBufferContainingLoc(start)) {
-    ZC_IF_SOME(buffer, impl->idToBuffer.find(foundBufferId)) {
-      const zc::byte* bufferStart = buffer.getBufferStart();
-      const zc::byte* bufferEnd = buffer.getBufferEnd();
-      const zc::byte* rangeStart = start.getOpaqueValue();
-      const zc::byte* rangeEnd = end.getOpaqueValue();
-
-      // Validate that the range is within the buffer
-      if (rangeStart < bufferStart || rangeEnd > bufferEnd || rangeStart > rangeEnd) {
-        return zc::ArrayPtr<const zc::byte>();
-      }
-
-      // Return the text slice
-      const size_t length = rangeEnd - rangeStart;
-      return zc::ArrayPtr<const zc::byte>(rangeStart, length);
-    }
+  ZC_IF_SOME(b, buffer) {
+    ZC_IF_SOME(text, b.slice(range.getStart(), range.getEnd())) { return text; }
   }
   return zc::ArrayPtr<const zc::byte>();
 }
@@ -471,24 +965,9 @@ zc::ArrayPtr<const zc::byte> SourceManager::extractTextFast(const SourceRange& r
                                                             BufferId bufferId) const {
   if (range.isInvalid()) { return zc::ArrayPtr<const zc::byte>(); }
 
-  const SourceLoc start = range.getStart();
-  const SourceLoc end = range.getEnd();
-
   // Fast path: directly use the provided buffer ID without lookup
-  ZC_IF_SOME(buffer, impl->idToBuffer.find(bufferId)) {
-    const zc::byte* bufferStart = buffer.getBufferStart();
-    const zc::byte* bufferEnd = buffer.getBufferEnd();
-    const zc::byte* rangeStart = start.getOpaqueValue();
-    const zc::byte* rangeEnd = end.getOpaqueValue();
-
-    // Validate that the range is within the buffer
-    if (rangeStart < bufferStart || rangeEnd > bufferEnd || rangeStart > rangeEnd) {
-      return zc::ArrayPtr<const zc::byte>();
-    }
-
-    // Return the text slice
-    const size_t length = rangeEnd - rangeStart;
-    return zc::ArrayPtr<const zc::byte>(rangeStart, length);
+  ZC_IF_SOME(buffer, impl->getBuffer(bufferId)) {
+    ZC_IF_SOME(text, buffer.slice(range.getStart(), range.getEnd())) { return text; }
   }
 
   return zc::ArrayPtr<const zc::byte>();
@@ -498,20 +977,47 @@ zc::StringPtr SourceManager::extractTextAsStringPtr(const SourceRange& range,
                                                     zc::Maybe<BufferId> bufferId) const {
   auto bytes = extractText(range, bufferId);
   if (bytes.size() == 0) { return ""_zc; }
-  return impl->getExtractedTextPool().intern(bytes.asChars());
+  return impl->internExtractedText(range, bytes);
 }
 
 zc::StringPtr SourceManager::extractTextFastAsStringPtr(const SourceRange& range,
                                                         BufferId bufferId) const {
   auto bytes = extractTextFast(range, bufferId);
   if (bytes.size() == 0) { return ""_zc; }
-  return impl->getExtractedTextPool().intern(bytes.asChars());
+  return impl->internExtractedText(range, bytes);
+}
+
+basic::MemoryUsage SourceManager::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  usage.addVector(impl->virtualFiles);
+  usage.addVector(impl->regexLiteralStartLocs);
+  {
+    auto lockedRegistry = impl->registry.lockShared();
+    impl->buffers.addMemoryUsage(usage);
+    usage.addTable(lockedRegistry->pathToBufferId);
+    for (const auto& entry : lockedRegistry->pathToBufferId) { usage.addString(entry.key); }
+    usage.addTable(lockedRegistry->overlays);
+    for (const auto& entry : lockedRegistry->overlays) {
+      usage.addString(entry.key);
+      // The text itself is counted with the buffers made from it.
+      if (entry.value.text != zc::none) { usage.addObject<Impl::OverlayText>(); }
+    }
+  }
+  if (impl->externalExtractedTextPool == zc::none) {
+    usage += impl->ownedExtractedTextPool.getMemoryUsage();
+  }
+  return usage;
 }
 
 const zc::Vector<BufferId> SourceManager::getManagedBufferIds() const {
+  const size_t count = impl->buffers.size();
   zc::Vector<BufferId> ids;
-  ids.reserve(impl->buffers.size());
-  for (const auto& buffer : impl->buffers) { ids.add(buffer->id); }
+  ids.reserve(count);
+  for (size_t i = 0; i < count; ++i) {
+    const Buffer& buffer = impl->buffers[i];
+    if (!buffer.superseded.load(std::memory_order_relaxed)) { ids.add(buffer.id); }
+  }
   return ids;
 }
 
@@ -18,6 +18,7 @@
 #include "zc/core/memory.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 #include "zomlang/compiler/source/location.h"
 
 namespace zomlang {
@@ -25,6 +26,7 @@ namespace compiler {
 
 namespace basic {
 class StringPool;
+class ThreadPool;
 }
 
 namespace source {
@@ -80,7 +82,10 @@ public:
 
   ZC_DISALLOW_COPY_AND_MOVE(SourceManager);
 
-  /// Buffer management
+  /// Buffer management. The text of every buffer is followed by a NUL byte, so these copy their
+  /// input into storage with room for it; files are mapped when they are large enough.
+  /// Buffers may be added while other threads look up locations, text and lines: registration
+  /// is serialized, and lookups read the append-only buffer table without taking a lock.
   BufferId addNewSourceBuffer(zc::Array<zc::byte> inputData, zc::StringPtr bufIdentifier);
   BufferId addMemBufferCopy(zc::ArrayPtr<const zc::byte> inputData, zc::StringPtr bufIdentifier);
 
@@ -102,10 +107,19 @@ public:
   /// Returns the offset in bytes for the given valid source location.
   unsigned getLocOffsetInBuffer(SourceLoc Loc, BufferId bufferId) const;
 
+  /// Returns a pointer to the text at the given valid source location.
+  const zc::byte* getCharacterData(SourceLoc loc) const;
+
   /// Location and range operations
   SourceLoc getLocForOffset(BufferId bufferId, unsigned offset) const;
   LineAndColumn getLineAndColumn(const SourceLoc& loc) const;
   LineAndColumn getPresumedLineAndColumnForLoc(SourceLoc Loc, BufferId bufferId) const;
+  /// Resolve many locations at once, each as `getLineAndColumn()` would, e.g. for a batch of
+  /// diagnostics. The locations are visited in order, so a buffer's line table is swept once,
+  /// galloping over the lines between one location and the next rather than searching the whole
+  /// table for each. Invalid locations and those outside any buffer resolve to line 0, column 0.
+  /// \return The line and column of each location, in the order given
+  zc::Array<LineAndColumn> resolveLineColumns(zc::ArrayPtr<const SourceLoc> locs) const;
   unsigned getLineNumber(const SourceLoc& loc) const;
   bool isBefore(const SourceLoc& first, const SourceLoc& second) const;
   bool isAtOrBefore(const SourceLoc& first, const SourceLoc& second) const;
@@ -115,15 +129,21 @@ public:
   /// Returns a buffer identifier for the given location.
   zc::StringPtr getDisplayNameForLoc(const SourceLoc& loc) const;
 
-  /// Content retrieval
+  /// Content retrieval. The returned text is followed by a NUL byte that is not part of it, so a
+  /// scan over the whole buffer may stop at that sentinel rather than check for the end.
   zc::ArrayPtr<const zc::byte> getEntireTextForBuffer(BufferId bufferId) const;
+  /// 64-bit hash of the buffer's text, computed when the buffer is added. Buffers with equal text
+  /// have equal hashes, in this process or any other, so it can key on-disk caches.
+  uint64_t getContentHash(BufferId bufferId) const;
   zc::ArrayPtr<const zc::byte> extractText(const SourceRange& range,
                                            zc::Maybe<BufferId> bufferId) const;
 
   /// Fast path for extracting text when buffer is known
   zc::ArrayPtr<const zc::byte> extractTextFast(const SourceRange& range, BufferId bufferId) const;
 
-  /// Returns a NUL-terminated view of the extracted text by interning into an internal pool.
+  /// Returns a NUL-terminated view of the extracted text by interning into an internal pool. A
+  /// range the calling thread extracted lately is served from a small per-thread cache, without
+  /// hashing the text or locking the pool.
   zc::StringPtr extractTextAsStringPtr(const SourceRange& range,
                                        zc::Maybe<BufferId> bufferId = zc::none) const;
 
@@ -142,7 +162,46 @@ public:
 
   /// External source support
   zc::Maybe<BufferId> getFileSystemSourceBufferID(zc::StringPtr path);
+  /// Like `getFileSystemSourceBufferID()` for several paths, whose files are read in parallel:
+  /// as one batch of kernel submissions where io_uring is available, else on `threadPool`, which
+  /// also builds the line tables of batched reads. Buffers are registered in the order of `paths`
+  /// once every read is done.
+  zc::Vector<zc::Maybe<BufferId>> getFileSystemSourceBufferIDs(
+      zc::ArrayPtr<const zc::StringPtr> paths, basic::ThreadPool& threadPool);
   SourceLoc getLocFromExternalSource(zc::StringPtr path, unsigned line, unsigned col);
+  /// The buffer a file was registered under, without reading it.
+  zc::Maybe<BufferId> findFileSystemSourceBufferID(zc::StringPtr path) const;
+  /// Reread a file from disk. If its content changed, it is registered anew, with a new BufferId
+  /// and locations, and the old buffer stops being managed but stays readable, so that trees
+  /// pointing into it remain valid. A file that was never registered is registered.
+  /// \return The file's buffer, the same one if the content did not change, or none if the file
+  /// no longer exists
+  zc::Maybe<BufferId> reloadFileSystemSourceBuffer(zc::StringPtr path);
+
+  /// Unsaved editor buffers. While `path` has an overlay, its text stands in for the file's:
+  /// setting it registers the text as the file's buffer, as a reload would, and the file
+  /// functions above load it rather than the disk. The text is taken without a copy, its NUL
+  /// terminator serving as the buffer's sentinel.
+  /// \return The overlay's version stamp. Stamps increase with every overlay set or removed.
+  uint64_t setOverlay(zc::StringPtr path, zc::String text);
+  /// Drop the overlay of `path`, if any. The file is forgotten, so it is read from disk when next
+  /// asked for.
+  void removeOverlay(zc::StringPtr path);
+  /// Version stamp of the overlay of `path`, or none if it has none.
+  zc::Maybe<uint64_t> getOverlayVersion(zc::StringPtr path) const;
+  /// The stamp handed out last, to remember at a compile and pass to getOverlaysChangedSince()
+  /// at the next one.
+  uint64_t getLatestOverlayVersion() const;
+  /// Paths, relative to the working directory where they are under it, whose overlay was set or
+  /// removed after `version` was handed out.
+  zc::Vector<zc::String> getOverlaysChangedSince(uint64_t version) const;
+
+  /// Free the text and line table of a buffer that nothing reads any more, e.g. once a file is
+  /// parsed and its diagnostics reported. The buffer stops being managed, and a file buffer's
+  /// path is forgotten, so that asking for the file again reads it anew. Locations in the buffer
+  /// still resolve to it, but its text is empty and every location is on its first line. Must
+  /// not run while another thread reads the buffer.
+  void releaseBuffer(BufferId bufferId);
 
   zc::StringPtr getIdentifierForBuffer(BufferId bufferId) const;
 
@@ -155,8 +214,15 @@ public:
   void recordRegexLiteralStartLoc(const SourceLoc& loc);
   bool isRegexLiteralStart(const SourceLoc& loc) const;
 
+  /// Buffers registered and not replaced by `reloadFileSystemSourceBuffer()`.
   const zc::Vector<BufferId> getManagedBufferIds() const;
 
+  /// Measure the buffers' text and line tables, released and superseded buffers included, the
+  /// path and overlay maps, and the pool of extracted text unless it was given to the constructor.
+  /// A mapped file's text counts as reserved memory although it is not on the heap. Must not run
+  /// while a buffer is being released.
+  basic::MemoryUsage getMemoryUsage() const;
+
 private:
   struct Impl;
   zc::Own<Impl> impl;
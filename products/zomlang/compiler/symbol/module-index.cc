@@ -0,0 +1,313 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/symbol/module-index.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "zc/core/debug.h"
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace symbol {
+
+namespace {
+
+constexpr uint32_t kNoOffset = UINT32_MAX;
+
+// SymbolKind::Module is the last kind
+constexpr uint16_t kSymbolKindLimit = static_cast<uint16_t>(SymbolKind::Module) + 1;
+
+/// Header of a serialized index. The columns follow in declaration order of `Impl`'s views, each
+/// padded to 8 bytes so that every column is naturally aligned when the image is. The module name
+/// is the first text in the text column.
+struct ImageHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t byteOrder;
+  uint32_t entryCount;
+  uint32_t textBytes;
+  uint32_t reserved;
+};
+
+constexpr char kImageMagic[4] = {'Z', 'S', 'Y', 'M'};
+constexpr uint32_t kByteOrderMark = 0x01020304;
+constexpr size_t kImageAlignment = 8;
+
+static_assert(sizeof(ImageHeader) % kImageAlignment == 0);
+
+size_t alignImageOffset(size_t offset) {
+  return (offset + kImageAlignment - 1) & ~(kImageAlignment - 1);
+}
+
+template <typename T>
+void appendColumn(zc::Vector<zc::byte>& out, zc::ArrayPtr<const T> column) {
+  out.addAll(column.asBytes());
+  out.resize(alignImageOffset(out.size()));
+}
+
+template <typename T>
+bool takeColumn(zc::ArrayPtr<const zc::byte>& rest, size_t count, zc::ArrayPtr<const T>& column) {
+  const size_t bytes = count * sizeof(T);
+  if (rest.size() < bytes) { return false; }
+  column = zc::arrayPtr(reinterpret_cast<const T*>(rest.begin()), count);
+  rest = rest.slice(zc::min(alignImageOffset(bytes), rest.size()), rest.size());
+  return true;
+}
+
+}  // namespace
+
+struct ModuleIndex::Impl {
+  // Columns, one entry per symbol in name order. They view either `owned` or a serialized image.
+  zc::ArrayPtr<const uint64_t> flags;
+  zc::ArrayPtr<const uint32_t> nameOffsets;  // Into `textData`, increasing.
+  zc::ArrayPtr<const uint32_t> starts;       // Offset from `base`, or kNoOffset without a range.
+  zc::ArrayPtr<const uint32_t> lengths;
+  zc::ArrayPtr<const uint16_t> kinds;
+  zc::ArrayPtr<const char> textData;  // Module name, then one NUL-terminated name per entry.
+
+  source::SourceLoc base;
+
+  /// Columns of an index built in this process.
+  struct Storage {
+    zc::Vector<uint64_t> flags;
+    zc::Vector<uint32_t> nameOffsets;
+    zc::Vector<uint32_t> starts;
+    zc::Vector<uint32_t> lengths;
+    zc::Vector<uint16_t> kinds;
+    zc::Vector<char> textData;
+  };
+  Storage owned;
+
+  /// Serialized image adopted by `deserialize()`, if the caller handed over ownership.
+  zc::Array<const zc::byte> image;
+
+  void viewOwned() {
+    flags = owned.flags.asPtr();
+    nameOffsets = owned.nameOffsets.asPtr();
+    starts = owned.starts.asPtr();
+    lengths = owned.lengths.asPtr();
+    kinds = owned.kinds.asPtr();
+    textData = owned.textData.asPtr();
+  }
+
+  /// Point the columns into `bytes` after checking that every offset they hold stays in bounds and
+  /// that names are sorted, so that accessors never read outside the image and find() is sound.
+  bool viewImage(zc::ArrayPtr<const zc::byte> bytes);
+
+  /// Text starting at `begin`, which ends at the next text or at the end of the column.
+  zc::StringPtr textAt(size_t begin, size_t end) const {
+    return zc::StringPtr(textData.begin() + begin, end - begin - 1);
+  }
+
+  zc::StringPtr nameAt(EntryIndex index) const {
+    const size_t end = index + 1 < nameOffsets.size() ? nameOffsets[index + 1] : textData.size();
+    return textAt(nameOffsets[index], end);
+  }
+};
+
+bool ModuleIndex::Impl::viewImage(zc::ArrayPtr<const zc::byte> bytes) {
+  if (bytes.size() < sizeof(ImageHeader) ||
+      reinterpret_cast<uintptr_t>(bytes.begin()) % kImageAlignment != 0) {
+    return false;
+  }
+  ImageHeader header;
+  memcpy(&header, bytes.begin(), sizeof(header));
+  if (memcmp(header.magic, kImageMagic, sizeof(kImageMagic)) != 0 ||
+      header.version != kFormatVersion || header.byteOrder != kByteOrderMark) {
+    return false;
+  }
+
+  auto rest = bytes.slice(sizeof(ImageHeader), bytes.size());
+  const size_t n = header.entryCount;
+  if (!takeColumn(rest, n, flags) || !takeColumn(rest, n, nameOffsets) ||
+      !takeColumn(rest, n, starts) || !takeColumn(rest, n, lengths) ||
+      !takeColumn(rest, n, kinds) || !takeColumn(rest, header.textBytes, textData)) {
+    return false;
+  }
+
+  // Every text, the module name included, is terminated where the next one starts.
+  if (textData.size() == 0 || textData.back() != '\0') { return false; }
+  uint32_t previous = 0;
+  for (EntryIndex i = 0; i < n; ++i) {
+    const uint32_t offset = nameOffsets[i];
+    if (offset <= previous || offset >= textData.size() || textData[offset - 1] != '\0') {
+      return false;
+    }
+    if (kinds[i] >= kSymbolKindLimit) { return false; }
+    previous = offset;
+  }
+  for (EntryIndex i = 1; i < n; ++i) {
+    if (!(nameAt(i - 1) < nameAt(i))) { return false; }
+  }
+  return true;
+}
+
+ModuleIndex::ModuleIndex(zc::StringPtr moduleName, zc::ArrayPtr<const ExportedSymbol> symbols,
+                         source::SourceLoc base)
+    : impl(zc::heap<Impl>()) {
+  ZC_REQUIRE(symbols.size() < UINT32_MAX, "too many symbols for a module index");
+
+  zc::Vector<const ExportedSymbol*> sorted(symbols.size());
+  for (const auto& symbol : symbols) { sorted.add(&symbol); }
+  std::sort(sorted.begin(), sorted.end(), [](const ExportedSymbol* a, const ExportedSymbol* b) {
+    return a->qualifiedName < b->qualifiedName;
+  });
+
+  // Like CompactTree, default the base to the lowest start so images of the same text match.
+  if (base.isInvalid()) {
+    for (const auto& symbol : symbols) {
+      if (symbol.range.isInvalid()) { continue; }
+      if (base.isInvalid() || symbol.range.getStart() < base) { base = symbol.range.getStart(); }
+    }
+  }
+  impl->base = base;
+
+  Impl::Storage& owned = impl->owned;
+  owned.textData.addAll(moduleName.begin(), moduleName.end() + 1);
+  for (size_t i = 0; i < sorted.size(); ++i) {
+    const ExportedSymbol* symbol = sorted[i];
+    ZC_REQUIRE(i == 0 || sorted[i - 1]->qualifiedName != symbol->qualifiedName,
+               "symbol recorded twice in a module index", symbol->qualifiedName);
+    owned.flags.add(static_cast<uint64_t>(symbol->flags));
+    owned.nameOffsets.add(static_cast<uint32_t>(owned.textData.size()));
+    owned.textData.addAll(symbol->qualifiedName.begin(), symbol->qualifiedName.end() + 1);
+    owned.kinds.add(static_cast<uint16_t>(symbol->kind));
+
+    const source::SourceRange& range = symbol->range;
+    if (range.isInvalid()) {
+      owned.starts.add(kNoOffset);
+      owned.lengths.add(0);
+      continue;
+    }
+    ZC_REQUIRE(range.getStart() >= base, "symbol starts before the module index's base");
+    const uint32_t offset = range.getStart().getOpaqueValue() - base.getOpaqueValue();
+    ZC_REQUIRE(offset < kNoOffset, "source too large for a module index");
+    owned.starts.add(offset);
+    owned.lengths.add(range.getLength());
+  }
+  ZC_REQUIRE(owned.textData.size() < UINT32_MAX, "names too large for a module index");
+  impl->viewOwned();
+}
+
+ModuleIndex::ModuleIndex(zc::Own<Impl> impl) noexcept : impl(zc::mv(impl)) {}
+
+ModuleIndex::~ModuleIndex() noexcept(false) = default;
+
+ModuleIndex::ModuleIndex(ModuleIndex&&) noexcept = default;
+ModuleIndex& ModuleIndex::operator=(ModuleIndex&&) noexcept = default;
+
+zc::StringPtr ModuleIndex::getModuleName() const {
+  const size_t end = impl->nameOffsets.size() > 0 ? impl->nameOffsets[0] : impl->textData.size();
+  return impl->textAt(0, end);
+}
+
+size_t ModuleIndex::size() const { return impl->kinds.size(); }
+
+zc::StringPtr ModuleIndex::getQualifiedName(EntryIndex index) const {
+  ZC_REQUIRE(index < size(), "module index entry out of range");
+  return impl->nameAt(index);
+}
+
+SymbolKind ModuleIndex::getKind(EntryIndex index) const {
+  return static_cast<SymbolKind>(impl->kinds[index]);
+}
+
+SymbolFlags ModuleIndex::getFlags(EntryIndex index) const {
+  return static_cast<SymbolFlags>(impl->flags[index]);
+}
+
+source::SourceRange ModuleIndex::getSourceRange(EntryIndex index) const {
+  const uint32_t start = impl->starts[index];
+  if (start == kNoOffset) { return source::SourceRange(); }
+  const source::SourceLoc begin = impl->base + start;
+  return source::SourceRange(begin, begin + impl->lengths[index]);
+}
+
+zc::Maybe<ModuleIndex::EntryIndex> ModuleIndex::find(zc::StringPtr qualifiedName) const {
+  EntryIndex low = 0;
+  EntryIndex high = static_cast<EntryIndex>(size());
+  while (low < high) {
+    const EntryIndex mid = low + (high - low) / 2;
+    const zc::StringPtr name = impl->nameAt(mid);
+    if (name == qualifiedName) { return mid; }
+    if (name < qualifiedName) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return zc::none;
+}
+
+source::SourceLoc ModuleIndex::getBase() const { return impl->base; }
+
+basic::MemoryUsage ModuleIndex::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  usage.addVector(impl->owned.flags);
+  usage.addVector(impl->owned.nameOffsets);
+  usage.addVector(impl->owned.starts);
+  usage.addVector(impl->owned.lengths);
+  usage.addVector(impl->owned.kinds);
+  usage.addVector(impl->owned.textData);
+  usage.add(impl->image.size(), impl->image.size());
+  return usage;
+}
+
+zc::Array<zc::byte> ModuleIndex::serialize() const {
+  ImageHeader header;
+  memcpy(header.magic, kImageMagic, sizeof(kImageMagic));
+  header.version = kFormatVersion;
+  header.byteOrder = kByteOrderMark;
+  header.entryCount = static_cast<uint32_t>(impl->kinds.size());
+  header.textBytes = static_cast<uint32_t>(impl->textData.size());
+  header.reserved = 0;
+
+  const size_t columnBytes = impl->flags.asBytes().size() + impl->nameOffsets.asBytes().size() +
+                             impl->starts.asBytes().size() + impl->lengths.asBytes().size() +
+                             impl->kinds.asBytes().size() + impl->textData.size();
+  zc::Vector<zc::byte> out(sizeof(ImageHeader) + columnBytes + 6 * kImageAlignment);
+  out.addAll(zc::arrayPtr(&header, 1).asBytes());
+  appendColumn(out, impl->flags);
+  appendColumn(out, impl->nameOffsets);
+  appendColumn(out, impl->starts);
+  appendColumn(out, impl->lengths);
+  appendColumn(out, impl->kinds);
+  appendColumn(out, impl->textData);
+  return out.releaseAsArray();
+}
+
+zc::Maybe<ModuleIndex> ModuleIndex::deserialize(zc::ArrayPtr<const zc::byte> image,
+                                                source::SourceLoc base) {
+  auto impl = zc::heap<Impl>();
+  if (!impl->viewImage(image)) { return zc::none; }
+  impl->base = base;
+  return ModuleIndex(zc::mv(impl));
+}
+
+zc::Maybe<ModuleIndex> ModuleIndex::deserialize(zc::Array<const zc::byte> image,
+                                                source::SourceLoc base) {
+  auto impl = zc::heap<Impl>();
+  if (!impl->viewImage(image)) { return zc::none; }
+  impl->image = zc::mv(image);
+  impl->base = base;
+  return ModuleIndex(zc::mv(impl));
+}
+
+}  // namespace symbol
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,111 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+
+#include "zc/core/array.h"
+#include "zc/core/common.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zomlang/compiler/basic/memory-usage.h"
+#include "zomlang/compiler/source/location.h"
+#include "zomlang/compiler/symbol/symbol-flags.h"
+#include "zomlang/compiler/symbol/symbol.h"
+
+namespace zomlang {
+namespace compiler {
+namespace symbol {
+
+/// \brief ModuleIndex - Symbols a module exports, detached from the ASTs they were bound from
+///
+/// Each entry records a symbol's qualified name, kind, flags and source range, the range stored
+/// relative to a base location like CompactTree's. Entries are sorted by qualified name, so
+/// find() is a binary search. Text is copied into the index.
+///
+/// `serialize()` writes a versioned image that `deserialize()` can view in place, so a
+/// memory-mapped index of a module that did not change is consulted without rebinding its
+/// sources. SymbolTable::exportModuleIndex() produces one; SymbolTable::addModuleIndex() makes
+/// its symbols resolvable.
+class ModuleIndex {
+public:
+  using EntryIndex = uint32_t;
+
+  /// \brief Version of the serialized image, bumped whenever its layout changes.
+  static constexpr uint32_t kFormatVersion = 1;
+
+  /// \brief One symbol to record.
+  struct ExportedSymbol {
+    zc::StringPtr qualifiedName;
+    SymbolKind kind;
+    SymbolFlags flags;
+    source::SourceRange range;
+  };
+
+  /// \brief Build the index of module `moduleName` from `symbols`, in any order.
+  /// \param base Location source offsets are stored relative to, normally the start of the
+  /// module's source buffer.
+  ModuleIndex(zc::StringPtr moduleName, zc::ArrayPtr<const ExportedSymbol> symbols,
+              source::SourceLoc base = source::SourceLoc());
+  ~ModuleIndex() noexcept(false);
+
+  ZC_DISALLOW_COPY(ModuleIndex);
+  ModuleIndex(ModuleIndex&&) noexcept;
+  ModuleIndex& operator=(ModuleIndex&&) noexcept;
+
+  /// \brief Dotted name of the module, e.g. "math.geometry".
+  zc::StringPtr getModuleName() const;
+
+  /// \brief Number of recorded symbols.
+  size_t size() const;
+
+  /// \brief Name relative to the module, e.g. "Point" for "math.geometry.Point".
+  zc::StringPtr getQualifiedName(EntryIndex index) const;
+  SymbolKind getKind(EntryIndex index) const;
+  SymbolFlags getFlags(EntryIndex index) const;
+  source::SourceRange getSourceRange(EntryIndex index) const;
+
+  /// \brief Entry named `qualifiedName` relative to the module, if any.
+  zc::Maybe<EntryIndex> find(zc::StringPtr qualifiedName) const;
+
+  /// \brief Location that source offsets are relative to.
+  source::SourceLoc getBase() const;
+
+  /// \brief Measure the columns of an index built in this process, or the image it owns. An image
+  /// viewed in place is the caller's.
+  basic::MemoryUsage getMemoryUsage() const;
+
+  /// \brief Write the index as a self-contained binary image.
+  zc::Array<zc::byte> serialize() const;
+
+  /// \brief View a serialized image in place. The image must be 8-byte aligned and outlive the
+  /// index. Returns none if the image is malformed or from another format version.
+  static zc::Maybe<ModuleIndex> deserialize(zc::ArrayPtr<const zc::byte> image,
+                                            source::SourceLoc base);
+  /// \brief Like the overload above, but the index takes ownership of the image, e.g. a mapping
+  /// returned by `zc::ReadableFile::mmap()`.
+  static zc::Maybe<ModuleIndex> deserialize(zc::Array<const zc::byte> image,
+                                            source::SourceLoc base);
+
+private:
+  struct Impl;
+  zc::Own<Impl> impl;
+
+  explicit ModuleIndex(zc::Own<Impl> impl) noexcept;
+};
+
+}  // namespace symbol
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,11 +14,15 @@
 
 #include "zomlang/compiler/symbol/scope.h"
 
+#include <cstdint>
+
+#include "zc/core/arena.h"
 #include "zc/core/array.h"
 #include "zc/core/common.h"
 #include "zc/core/debug.h"
 #include "zc/core/map.h"
 #include "zc/core/memory.h"
+#include "zc/core/mutex.h"
 #include "zc/core/string.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/type.h"
@@ -28,6 +32,133 @@ namespace zomlang {
 namespace compiler {
 namespace symbol {
 
+namespace {
+
+/// Symbols declared directly in one scope, keyed by name.
+///
+/// Most block and loop scopes declare a handful of names, so up to kInlineCapacity symbols are
+/// kept in an inline array and found by a linear scan over their hashes. Larger scopes move to a
+/// linear-probing table of (hash, symbol) slots sized to a power of two. Either way a probe
+/// compares the cached hash before touching the symbol, so a miss costs no string comparison.
+class SymbolMap {
+public:
+  static constexpr uint32_t kInlineCapacity = 8;
+
+  zc::Maybe<Symbol&> find(zc::StringPtr name, uint32_t hash) {
+    if (slots.size() == 0) {
+      for (uint32_t i = 0; i < count; ++i) {
+        if (matches(small[i], name, hash)) { return *small[i].symbol; }
+      }
+      return zc::none;
+    }
+    ZC_IF_SOME(index, findSlot(name, hash)) { return *slots[index].symbol; }
+    return zc::none;
+  }
+
+  void insert(zc::Own<Symbol> symbol) {
+    const zc::StringPtr name = symbol->getName();
+    const uint32_t hash = zc::hashCode(name);
+    ZC_REQUIRE(find(name, hash) == zc::none, "symbol already declared in scope", name);
+
+    if (slots.size() == 0 && count < kInlineCapacity) {
+      small[count++] = {hash, zc::mv(symbol)};
+      return;
+    }
+    // Keep the table at most 3/4 full so probe sequences stay short.
+    if (slots.size() == 0 || (count + 1) * 4 > slots.size() * 3) { grow(); }
+    place({hash, zc::mv(symbol)});
+    ++count;
+  }
+
+  void erase(zc::StringPtr name) {
+    const uint32_t hash = zc::hashCode(name);
+    if (slots.size() == 0) {
+      for (uint32_t i = 0; i < count; ++i) {
+        if (matches(small[i], name, hash)) {
+          small[i] = zc::mv(small[--count]);
+          small[count] = {};
+          return;
+        }
+      }
+      return;
+    }
+
+    ZC_IF_SOME(found, findSlot(name, hash)) {
+      // Backward-shift deletion: pull later entries of the probe run into the hole so that
+      // lookups never need tombstones.
+      const uint32_t mask = slots.size() - 1;
+      uint32_t hole = found;
+      slots[hole] = {};
+      for (uint32_t next = (hole + 1) & mask; slots[next].isOccupied(); next = (next + 1) & mask) {
+        const uint32_t home = slots[next].hash & mask;
+        const bool stays =
+            hole <= next ? (hole < home && home <= next) : (hole < home || home <= next);
+        if (!stays) {
+          slots[hole] = zc::mv(slots[next]);
+          slots[next] = {};
+          hole = next;
+        }
+      }
+      --count;
+    }
+  }
+
+  size_t size() const { return count; }
+
+  /// The inline entries are part of the map; only the probing table is extra.
+  void addMemoryUsage(basic::MemoryUsage& usage) const {
+    usage.add(slots.size() == 0 ? 0 : count * sizeof(Entry), slots.size() * sizeof(Entry));
+  }
+
+private:
+  struct Entry {
+    uint32_t hash = 0;
+    zc::Own<Symbol> symbol;
+
+    bool isOccupied() const { return symbol.get() != nullptr; }
+  };
+
+  Entry small[kInlineCapacity];
+  zc::Array<Entry> slots;
+  uint32_t count = 0;
+
+  static bool matches(const Entry& entry, zc::StringPtr name, uint32_t hash) {
+    return entry.hash == hash && entry.isOccupied() && entry.symbol->getName() == name;
+  }
+
+  zc::Maybe<uint32_t> findSlot(zc::StringPtr name, uint32_t hash) const {
+    const uint32_t mask = slots.size() - 1;
+    for (uint32_t i = hash & mask; slots[i].isOccupied(); i = (i + 1) & mask) {
+      if (matches(slots[i], name, hash)) { return i; }
+    }
+    return zc::none;
+  }
+
+  void place(Entry entry) {
+    const uint32_t mask = slots.size() - 1;
+    uint32_t i = entry.hash & mask;
+    while (slots[i].isOccupied()) { i = (i + 1) & mask; }
+    slots[i] = zc::mv(entry);
+  }
+
+  void grow() {
+    zc::Array<Entry> old = zc::mv(slots);
+    slots = zc::heapArray<Entry>(old.size() == 0 ? kInlineCapacity * 4 : old.size() * 2);
+    if (old.size() == 0) {
+      for (uint32_t i = 0; i < count; ++i) { place(zc::mv(small[i])); }
+    } else {
+      for (Entry& entry : old) {
+        if (entry.isOccupied()) { place(zc::mv(entry)); }
+      }
+    }
+  }
+};
+
+/// First chunk size of a ScopeManager's scope arena; later chunks grow from there.
+constexpr size_t kScopeArenaChunkSize = 8 * 1024;
+
+}  // namespace
+
 // Scope implementation using pimpl pattern
 struct Scope::Impl {
   Impl(Kind kind, zc::StringPtr name, zc::Maybe<Scope&> parent)
@@ -39,7 +170,7 @@ struct Scope::Impl {
   zc::Maybe<Scope&> parent;
 
   // Symbol storage
-  zc::HashMap<zc::StringPtr, zc::Own<Symbol>> symbols;
+  SymbolMap symbols;
 
   // Child scope storage
   zc::HashMap<zc::StringPtr, zc::Own<Scope>> children;
@@ -72,24 +203,24 @@ zc::Maybe<const Scope&> Scope::getParent() const { return impl->parent; }
 bool Scope::isRoot() const { return impl->parent == zc::none; }
 
 // Symbol management
-void Scope::addSymbol(zc::Own<Symbol> symbol) {
-  impl->symbols.insert(symbol->getName(), zc::mv(symbol));
-}
+void Scope::addSymbol(zc::Own<Symbol> symbol) { impl->symbols.insert(zc::mv(symbol)); }
 
 void Scope::removeSymbol(zc::StringPtr name) { impl->symbols.erase(name); }
 
 zc::Maybe<Symbol&> Scope::lookupSymbol(zc::StringPtr name) { return lookupSymbolRecursively(name); }
 
 zc::Maybe<Symbol&> Scope::lookupSymbolLocally(zc::StringPtr name) {
-  auto it = impl->symbols.find(name);
-  ZC_IF_SOME(symbol, it) { return *symbol; }
-  return zc::none;
+  return impl->symbols.find(name, zc::hashCode(name));
 }
 
 zc::Maybe<Symbol&> Scope::lookupSymbolRecursively(zc::StringPtr name) {
-  ZC_IF_SOME(symbol, impl->symbols.find(name)) { return *symbol; }
-  ZC_IF_SOME(parent, impl->parent) { return parent.lookupSymbolRecursively(name); }
-  return zc::none;
+  // Hash once for the whole parent chain.
+  const uint32_t hash = zc::hashCode(name);
+  for (Scope* scope = this;;) {
+    ZC_IF_SOME(symbol, scope->impl->symbols.find(name, hash)) { return symbol; }
+    ZC_IF_SOME(parent, scope->impl->parent) { scope = &parent; }
+    else { return zc::none; }
+  }
 }
 
 bool Scope::hasSymbol(zc::StringPtr name) { return lookupSymbolLocally(name) != zc::none; }
@@ -97,7 +228,9 @@ bool Scope::hasSymbol(zc::StringPtr name) { return lookupSymbolLocally(name) !=
 size_t Scope::getSymbolCount() const { return impl->symbols.size(); }
 
 void Scope::addChild(zc::Own<Scope> child) {
-  impl->children.insert(child->getName(), zc::mv(child));
+  // Read the name before the argument list can move `child` away.
+  const zc::StringPtr name = child->getName();
+  impl->children.insert(name, zc::mv(child));
 }
 
 void Scope::removeChild(Scope& child) { impl->children.erase(child.getName()); }
@@ -212,6 +345,18 @@ zc::String Scope::toString() const {
   return zc::str("Scope[", impl->name, ":", static_cast<int>(impl->kind), "]");
 }
 
+basic::MemoryUsage Scope::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  impl->symbols.addMemoryUsage(usage);
+  usage.addTable(impl->children);
+  for (const auto& entry : impl->children) {
+    usage.addObject<Scope>();
+    usage += entry.value->getMemoryUsage();
+  }
+  return usage;
+}
+
 // Scope creation helpers
 zc::Own<Scope> Scope::createGlobalScope() { return zc::heap<Scope>(Kind::Global, "global"); }
 
@@ -235,19 +380,28 @@ zc::Own<Scope> Scope::createBlockScope(zc::StringPtr name, Scope& parent) {
 struct ScopeManager::Impl {
   Impl() : currentScope(zc::none) {}
 
-  // All scopes managed by this manager - stored as owned pointers to avoid reference invalidation
-  zc::Vector<zc::Own<Scope>> ownedScopes;
+  // Scopes and their lookup caches, shared by binders running in parallel
+  struct Registry {
+    // Backs every scope created here. Declared first so that it outlives the Own<> handles
+    // pointing into it; destroying a scope runs its destructor and the memory goes with the arena.
+    zc::Arena arena{kScopeArenaChunkSize};
+
+    // All scopes managed by this manager - stored as owned pointers to avoid reference
+    // invalidation
+    zc::Vector<zc::Own<Scope>> ownedScopes;
+
+    // Scope lookup caches - store references to scopes in the vector
+    zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> packageScopes;
+    zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> classScopes;
+    zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> functionScopes;
+  };
+  zc::MutexGuarded<Registry> registry;
 
   // Current scope stack
   zc::Vector<zc::Maybe<const Scope&>> scopeStack;
 
   // Current active scope
   zc::Maybe<const Scope&> currentScope;
-
-  // Scope lookup caches - store references to scopes in the vector
-  zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> packageScopes;
-  zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> classScopes;
-  zc::HashMap<zc::StringPtr, zc::Maybe<Scope&>> functionScopes;
 };
 
 // ScopeManager constructor
@@ -262,14 +416,16 @@ ScopeManager::~ScopeManager() noexcept(false) = default;
 
 // Scope lifecycle
 Scope& ScopeManager::createScope(Scope::Kind kind, zc::StringPtr name, zc::Maybe<Scope&> parent) {
-  // Use heap allocation to avoid reference invalidation when vector grows
-  auto scopePtr = zc::heap<Scope>(kind, name, parent);
+  // Allocate from the arena so the scope keeps its address when the vector grows
+  auto locked = impl->registry.lockExclusive();
+  auto scopePtr = locked->arena.allocateOwn<Scope>(kind, name, parent);
   Scope& scope = *scopePtr;
 
   // Store the owned pointer in a vector to manage lifetime
-  impl->ownedScopes.add(zc::mv(scopePtr));
+  locked->ownedScopes.add(zc::mv(scopePtr));
 
-  // Add this scope as a child to its parent if it has one
+  // Add this scope as a child to its parent if it has one. The parent is usually shared with
+  // other binders, so this happens under the registry lock too.
   ZC_IF_SOME(parentScope, parent) {
     // We need to create a separate owned pointer for the parent's children collection
     // This is necessary because the parent needs to own its children
@@ -280,13 +436,13 @@ Scope& ScopeManager::createScope(Scope::Kind kind, zc::StringPtr name, zc::Maybe
   // Update lookup caches - store references to the heap-allocated scopes
   switch (kind) {
     case Scope::Kind::Package:
-      impl->packageScopes.insert(name, scope);
+      locked->packageScopes.insert(name, scope);
       break;
     case Scope::Kind::Class:
-      impl->classScopes.insert(name, scope);
+      locked->classScopes.insert(name, scope);
       break;
     case Scope::Kind::Function:
-      impl->functionScopes.insert(name, scope);
+      locked->functionScopes.insert(name, scope);
       break;
     default:
       break;
@@ -299,17 +455,18 @@ void ScopeManager::destroyScope(Scope& scope) {
   // Save scope information before destruction
   Scope::Kind scopeKind = scope.getKind();
   zc::String scopeName = zc::heapString(scope.getName());
+  auto locked = impl->registry.lockExclusive();
 
   // Remove from lookup caches first (while scope is still valid)
   switch (scopeKind) {
     case Scope::Kind::Package:
-      impl->packageScopes.erase(scopeName);
+      locked->packageScopes.erase(scopeName);
       break;
     case Scope::Kind::Class:
-      impl->classScopes.erase(scopeName);
+      locked->classScopes.erase(scopeName);
       break;
     case Scope::Kind::Function:
-      impl->functionScopes.erase(scopeName);
+      locked->functionScopes.erase(scopeName);
       break;
     default:
       break;
@@ -342,11 +499,11 @@ void ScopeManager::destroyScope(Scope& scope) {
 
   // Remove from ownedScopes array (this will destroy the scope)
   zc::Vector<zc::Own<Scope>> newOwnedScopes;
-  newOwnedScopes.reserve(impl->ownedScopes.size());
-  for (auto& ownedScope : impl->ownedScopes) {
+  newOwnedScopes.reserve(locked->ownedScopes.size());
+  for (auto& ownedScope : locked->ownedScopes) {
     if (*ownedScope != scope) { newOwnedScopes.add(zc::mv(ownedScope)); }
   }
-  impl->ownedScopes = zc::mv(newOwnedScopes);
+  locked->ownedScopes = zc::mv(newOwnedScopes);
 }
 
 zc::Maybe<const Scope&> ScopeManager::getCurrentScope() const { return impl->currentScope; }
@@ -372,65 +529,74 @@ void ScopeManager::popScope() {
 }
 
 zc::Maybe<const Scope&> ScopeManager::getGlobalScope() const {
-  for (const auto& ownedScope : impl->ownedScopes) {
+  auto locked = impl->registry.lockShared();
+  for (const auto& ownedScope : locked->ownedScopes) {
     if (ownedScope->isRoot()) { return *ownedScope; }
   }
   return zc::none;
 }
 
 zc::Maybe<const Scope&> ScopeManager::getPackageScope(zc::StringPtr name) const {
-  ZC_IF_SOME(pkgScope, impl->packageScopes.find(name)) { return pkgScope; }
+  auto locked = impl->registry.lockShared();
+  ZC_IF_SOME(pkgScope, locked->packageScopes.find(name)) { return pkgScope; }
   return zc::none;
 }
 
 zc::Maybe<const Scope&> ScopeManager::getClassScope(zc::StringPtr name) const {
-  ZC_IF_SOME(clsScope, impl->classScopes.find(name)) { return clsScope; }
+  auto locked = impl->registry.lockShared();
+  ZC_IF_SOME(clsScope, locked->classScopes.find(name)) { return clsScope; }
   return zc::none;
 }
 
 zc::Maybe<const Scope&> ScopeManager::getFunctionScope(zc::StringPtr name) const {
-  ZC_IF_SOME(funcScope, impl->functionScopes.find(name)) { return funcScope; }
+  auto locked = impl->registry.lockShared();
+  ZC_IF_SOME(funcScope, locked->functionScopes.find(name)) { return funcScope; }
   return zc::none;
 }
 
 // Mutable scope lookup methods
 zc::Maybe<Scope&> ScopeManager::getGlobalScopeMutable() {
-  for (auto& ownedScope : impl->ownedScopes) {
+  auto locked = impl->registry.lockExclusive();
+  for (auto& ownedScope : locked->ownedScopes) {
     if (ownedScope->isRoot()) { return *ownedScope; }
   }
   return zc::none;
 }
 
 zc::Maybe<Scope&> ScopeManager::getPackageScopeMutable(zc::StringPtr name) {
-  ZC_IF_SOME(pkgScope, impl->packageScopes.find(name)) { return pkgScope; }
+  auto locked = impl->registry.lockExclusive();
+  ZC_IF_SOME(pkgScope, locked->packageScopes.find(name)) { return pkgScope; }
   return zc::none;
 }
 
 zc::Maybe<Scope&> ScopeManager::getClassScopeMutable(zc::StringPtr name) {
-  ZC_IF_SOME(clsScope, impl->classScopes.find(name)) { return clsScope; }
+  auto locked = impl->registry.lockExclusive();
+  ZC_IF_SOME(clsScope, locked->classScopes.find(name)) { return clsScope; }
   return zc::none;
 }
 
 zc::Maybe<Scope&> ScopeManager::getFunctionScopeMutable(zc::StringPtr name) {
-  ZC_IF_SOME(funcScope, impl->functionScopes.find(name)) { return funcScope; }
+  auto locked = impl->registry.lockExclusive();
+  ZC_IF_SOME(funcScope, locked->functionScopes.find(name)) { return funcScope; }
   return zc::none;
 }
 
 // Scope enumeration
 zc::ArrayPtr<const zc::Own<Scope>> ScopeManager::getAllScopes() const {
-  return impl->ownedScopes.asPtr();
+  return impl->registry.lockShared()->ownedScopes.asPtr();
 }
 
 zc::Array<zc::Maybe<const Scope&>> ScopeManager::getScopesOfKind(Scope::Kind kind) const {
   // First count how many scopes match the kind to avoid ArrayBuilder overflow
+  auto locked = impl->registry.lockShared();
   size_t count = 0;
-  for (const auto& ownedScope : impl->ownedScopes) {
+  for (const auto& ownedScope : locked->ownedScopes) {
     if (ownedScope->getKind() == kind) { count++; }
   }
 
   // Create ArrayBuilder with the exact capacity needed
   auto result = zc::heapArrayBuilder<zc::Maybe<const Scope&>>(count);
-  for (const auto& ownedScope : impl->ownedScopes) {
+  for (const auto& ownedScope : locked->ownedScopes) {
     if (ownedScope->getKind() == kind) { result.add(*ownedScope); }
   }
   return result.finish();
@@ -438,23 +604,41 @@ zc::Array<zc::Maybe<const Scope&>> ScopeManager::getScopesOfKind(Scope::Kind kin
 
 // Scope validation
 bool ScopeManager::isValidScope(const Scope& scope) const {
-  for (const auto& ownedScope : impl->ownedScopes) {
+  auto locked = impl->registry.lockShared();
+  for (const auto& ownedScope : locked->ownedScopes) {
     if (ownedScope.get() == &scope) { return scope.isValid(); }
   }
   return false;
 }
 
 void ScopeManager::validateAllScopes() const {
-  for (const auto& ownedScope : impl->ownedScopes) { ownedScope->validate(); }
+  auto locked = impl->registry.lockShared();
+  for (const auto& ownedScope : locked->ownedScopes) { ownedScope->validate(); }
 }
 
 void ScopeManager::clear() {
-  impl->ownedScopes.clear();
+  auto locked = impl->registry.lockExclusive();
+  locked->ownedScopes.clear();
   impl->scopeStack.clear();
   impl->currentScope = zc::none;
-  impl->packageScopes.clear();
-  impl->classScopes.clear();
-  impl->functionScopes.clear();
+  locked->packageScopes.clear();
+  locked->classScopes.clear();
+  locked->functionScopes.clear();
+}
+
+basic::MemoryUsage ScopeManager::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  usage.addVector(impl->scopeStack);
+  auto locked = impl->registry.lockShared();
+  // The scopes themselves are in the arena.
+  usage.addArena(locked->arena);
+  usage.addVector(locked->ownedScopes);
+  for (const zc::Own<Scope>& scope : locked->ownedScopes) { usage += scope->getMemoryUsage(); }
+  usage.addTable(locked->packageScopes);
+  usage.addTable(locked->classScopes);
+  usage.addTable(locked->functionScopes);
+  return usage;
 }
 
 // ScopeGuard implementation using pimpl pattern
@@ -16,6 +16,7 @@
 
 #include "zc/core/common.h"
 #include "zc/core/string.h"
+#include "zomlang/compiler/basic/memory-usage.h"
 
 namespace zomlang {
 namespace compiler {
@@ -88,6 +89,9 @@ public:
 
   /// \brief Utility functions
   zc::String toString() const;
+  /// \brief Measure the scope's symbol map and its children, but not the symbols, which live in
+  /// the arena of the table that created them.
+  basic::MemoryUsage getMemoryUsage() const;
 
   /// \brief Operator overloads
   zc::Maybe<Symbol&> operator[](zc::StringPtr name);
@@ -110,6 +114,10 @@ private:
 ///
 /// The ScopeManager provides centralized management of all scopes
 /// in the compilation unit, supporting scope creation, lookup, and cleanup.
+///
+/// Creating, destroying and looking up scopes is safe from binders running in parallel. The
+/// current scope and scope stack are navigation state for a single traversal and are not.
+/// getAllScopes() returns a view that is only stable while no scopes are being created.
 class ScopeManager {
 public:
   ScopeManager() noexcept;
@@ -147,6 +155,8 @@ public:
 
   /// \brief Utility functions
   void clear();
+  /// \brief Measure the scope arena, the scopes' own memory and the lookup caches.
+  basic::MemoryUsage getMemoryUsage() const;
 
 private:
   struct Impl;
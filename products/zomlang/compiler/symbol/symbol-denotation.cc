@@ -30,20 +30,32 @@ struct SymbolDenotation::Impl {
   const Scope* scope;
   bool isAbsent = false;
   uint32_t validFromPhase = 0;
+  uint32_t validUntilPhase = kOpenPeriod;
   zc::Maybe<const TypeSymbol&> cachedType;
 
-  Impl(SymbolDenotation::Kind k, zc::StringPtr n, const Scope& s)
-      : kind(k), name(zc::heapString(n)), scope(&s) {}
+  // Next denotation of the same symbol in phase order; the last points back to the first
+  SymbolDenotation* nextInRun;
+
+  Impl(SymbolDenotation::Kind k, zc::StringPtr n, const Scope& s, SymbolDenotation& self)
+      : kind(k), name(zc::heapString(n)), scope(&s), nextInRun(&self) {}
 };
 
 // SymbolDenotation implementation
 SymbolDenotation::SymbolDenotation(Kind kind, zc::StringPtr name, const Scope& scope) noexcept
-    : impl(zc::heap<Impl>(kind, name, scope)) {}
+    : impl(zc::heap<Impl>(kind, name, scope, *this)) {}
 
-SymbolDenotation::~SymbolDenotation() noexcept(false) = default;
+SymbolDenotation::SymbolDenotation(SymbolDenotation& previous, uint32_t phase) noexcept
+    : impl(zc::heap<Impl>(previous.impl->kind, previous.impl->name, *previous.impl->scope, *this)) {
+  impl->isAbsent = previous.impl->isAbsent;
+  impl->cachedType = previous.impl->cachedType;
+  impl->validFromPhase = phase;
 
-SymbolDenotation::SymbolDenotation(SymbolDenotation&&) noexcept = default;
-SymbolDenotation& SymbolDenotation::operator=(SymbolDenotation&&) noexcept = default;
+  previous.impl->validUntilPhase = phase;
+  impl->nextInRun = previous.impl->nextInRun;
+  previous.impl->nextInRun = this;
+}
+
+SymbolDenotation::~SymbolDenotation() noexcept(false) = default;
 
 SymbolDenotation::Kind SymbolDenotation::getKind() const { return impl->kind; }
 
@@ -65,6 +77,28 @@ uint32_t SymbolDenotation::getValidFromPhase() const { return impl->validFromPha
 
 void SymbolDenotation::setValidFromPhase(uint32_t phase) { impl->validFromPhase = phase; }
 
+uint32_t SymbolDenotation::getValidUntilPhase() const { return impl->validUntilPhase; }
+
+bool SymbolDenotation::isValidAt(uint32_t phase) const {
+  return impl->validFromPhase <= phase && phase < impl->validUntilPhase;
+}
+
+zc::Maybe<SymbolDenotation&> SymbolDenotation::atPhase(uint32_t phase) {
+  // Rings are short, one entry per phase that changed the symbol, so walk them in full.
+  SymbolDenotation* current = this;
+  do {
+    if (current->isValidAt(phase)) { return *current; }
+    current = current->impl->nextInRun;
+  } while (current != this);
+  return zc::none;
+}
+
+zc::Maybe<const SymbolDenotation&> SymbolDenotation::atPhase(uint32_t phase) const {
+  return const_cast<SymbolDenotation&>(*this).atPhase(phase);
+}
+
+const SymbolDenotation& SymbolDenotation::getNextInRun() const { return *impl->nextInRun; }
+
 zc::Maybe<const TypeSymbol&> SymbolDenotation::getCachedType() const { return impl->cachedType; }
 
 void SymbolDenotation::setCachedType(const TypeSymbol& type) { impl->cachedType = &type; }
@@ -43,6 +43,11 @@ class TypeSymbol;
 /// 2. Phase awareness: supports multi-phase compilation where symbols can have different meanings
 /// at different phases
 /// 3. Type caching: caches symbol type information for improved query efficiency
+///
+/// Each denotation is valid for a period of phases [validFrom, validUntil). The denotations of one
+/// symbol across phases form a ring in phase order, so any of them can reach the one valid at a
+/// given phase. A phase that changes a symbol appends a successor to the ring instead of
+/// overwriting state; phases that leave it alone share the existing denotation.
 /// 4. Absence marking: supports marking symbols as "absent" for error recovery
 class SymbolDenotation {
 public:
@@ -52,14 +57,20 @@ public:
     PACKAGE  // Packages and modules
   };
 
+  /// \brief Sentinel validUntil of a period that has not been closed by a later phase
+  static constexpr uint32_t kOpenPeriod = UINT32_MAX;
+
   SymbolDenotation(Kind kind, zc::StringPtr name, const Scope& scope) noexcept;
-  ~SymbolDenotation() noexcept(false);
 
-  // Non-copyable, movable
-  ZC_DISALLOW_COPY(SymbolDenotation);
+  /// \brief Successor of `previous` from `phase` on. Copies its state, closes its period at
+  /// `phase` and links the new denotation after it. `previous` must be the last in its ring and
+  /// `phase` must come after the start of its period.
+  SymbolDenotation(SymbolDenotation& previous, uint32_t phase) noexcept;
+
+  ~SymbolDenotation() noexcept(false);
 
-  SymbolDenotation(SymbolDenotation&&) noexcept;
-  SymbolDenotation& operator=(SymbolDenotation&&) noexcept;
+  // Non-copyable, non-movable: the ring links denotations by address
+  ZC_DISALLOW_COPY_AND_MOVE(SymbolDenotation);
 
   /// \brief Get the kind of the symbol
   Kind getKind() const;
@@ -98,6 +109,20 @@ public:
   /// \brief Set the compilation phase from which this symbol is valid
   void setValidFromPhase(uint32_t phase);
 
+  /// \brief Get the first compilation phase at which this symbol is no longer valid, or
+  /// kOpenPeriod
+  uint32_t getValidUntilPhase() const;
+
+  /// \brief Check if `phase` falls within this denotation's period
+  bool isValidAt(uint32_t phase) const;
+
+  /// \brief Get the denotation of the same symbol valid at `phase`, if any
+  zc::Maybe<SymbolDenotation&> atPhase(uint32_t phase);
+  zc::Maybe<const SymbolDenotation&> atPhase(uint32_t phase) const;
+
+  /// \brief Get the next denotation in the ring; the last wraps around to the first
+  const SymbolDenotation& getNextInRun() const;
+
   // Type information caching
 
   /// \brief Get cached type information
@@ -17,6 +17,8 @@
 #include <cstddef>
 #include <cstdint>
 
+#include "zomlang/compiler/basic/side-table.h"
+
 namespace zomlang {
 namespace compiler {
 namespace symbol {
@@ -72,6 +74,10 @@ private:
   IdType raw;
 };
 
+/// \brief Per-symbol data in an array indexed by SymbolId, since ids are handed out densely
+template <typename T>
+using SymbolSideTable = basic::SideTable<SymbolId, T>;
+
 }  // namespace symbol
 }  // namespace compiler
 }  // namespace zomlang
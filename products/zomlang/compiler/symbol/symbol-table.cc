@@ -14,15 +14,22 @@
 
 #include "zomlang/compiler/symbol/symbol-table.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 
+#include "zc/core/arena.h"
 #include "zc/core/array.h"
 #include "zc/core/common.h"
+#include "zc/core/debug.h"
 #include "zc/core/map.h"
+#include "zc/core/mutex.h"
 #include "zc/core/string.h"
 #include "zc/core/vector.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/type.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/symbol/module-index.h"
 #include "zomlang/compiler/symbol/package-symbol.h"
 #include "zomlang/compiler/symbol/scope.h"
 #include "zomlang/compiler/symbol/symbol-denotation.h"
@@ -35,59 +42,360 @@ namespace zomlang {
 namespace compiler {
 namespace symbol {
 
+namespace {
+
+/// A name being looked up and the name of the scope it is looked up in. Hashes like the NameKey
+/// it matches, so a lookup neither interns nor copies the name.
+struct NameQuery {
+  zc::StringPtr name;
+  zc::StringPtr scope;
+
+  uint hashCode() const { return zc::hashCode(name, scope); }
+};
+
+/// A declared name and the name of its scope, both interned, so hashing a key while the table
+/// grows is two field loads.
+struct NameKey {
+  basic::InternedString name;
+  basic::InternedString scope;
+
+  bool operator==(const NameKey& other) const {
+    return name == other.name && scope == other.scope;
+  }
+  bool operator==(const NameQuery& query) const {
+    return name == query.name && scope == query.scope;
+  }
+  uint hashCode() const { return zc::hashCode(name, scope); }
+};
+
+/// First chunk size of a table's symbol arena; later chunks grow from there.
+constexpr size_t kSymbolArenaChunkSize = 16 * 1024;
+
+constexpr uint kSymbolKindCount = static_cast<uint>(SymbolKind::Module) + 1;
+
+/// Registered symbols in registration order. Dropping a symbol clears its entry instead of
+/// shifting the rest; once more than half of the entries are cleared they are compacted.
+class SymbolIndex {
+public:
+  void add(const Symbol& symbol) {
+    entries.add(symbol);
+    ++live;
+  }
+
+  void remove(const Symbol& symbol) {
+    // Search from the back: the symbols dropped are usually the ones entered last.
+    for (size_t i = entries.size(); i-- > 0;) {
+      ZC_IF_SOME(entry, entries[i]) {
+        if (&entry == &symbol) {
+          entries[i] = zc::none;
+          --live;
+          if (live * 2 < entries.size()) { compact(); }
+          return;
+        }
+      }
+    }
+  }
+
+  SymbolRange range(zc::Maybe<SymbolKind> kind = zc::none) const {
+    return SymbolRange(entries.asPtr(), live, kind);
+  }
+
+  void addMemoryUsage(basic::MemoryUsage& usage) const { usage.addVector(entries); }
+
+private:
+  zc::Vector<SymbolRange::Entry> entries;
+  size_t live = 0;
+
+  void compact() {
+    zc::Vector<SymbolRange::Entry> kept(live);
+    for (const auto& entry : entries) {
+      if (entry != zc::none) { kept.add(entry); }
+    }
+    entries = zc::mv(kept);
+  }
+};
+
+/// The entry a module index keeps for `symbol`, or none for the private and compiler-internal
+/// symbols an index leaves out. Its source range is that of the first declaration.
+zc::Maybe<ModuleIndex::ExportedSymbol> toExportedSymbol(const Symbol& symbol) {
+  if (symbol.isPrivate() || symbol.getName().startsWith(INTERNAL_SYMBOL_NAME_PREFIX)) {
+    return zc::none;
+  }
+  source::SourceRange range;
+  for (const auto& declaration : symbol.getDeclarationNodes()) {
+    ZC_IF_SOME(node, declaration) {
+      range = node.getSourceRange();
+      break;
+    }
+  }
+  return ModuleIndex::ExportedSymbol{symbol.getName(), symbol.getKind(), symbol.getFlags(), range};
+}
+
+}  // namespace
+
 // SymbolTable::Impl definition
+//
+// Binders for different files run in parallel against one table. Name lookups, which dominate,
+// go to one of kStripeCount independently locked stripes chosen by the key's hash, so binders
+// declaring different names rarely meet on a lock and lookups take it shared. Symbol and
+// denotation storage sits behind its own lock and is append-only, so a reference handed out by a
+// lookup stays valid after the lock is released. Symbols, their default types and denotations are
+// carved out of one arena under that lock rather than heap-allocated one by one, and the arena
+// releases their memory in bulk when the table goes away.
 struct SymbolTable::Impl {
-  // Internal symbol storage
-  zc::Vector<zc::Own<Symbol>> symbols;
+  static constexpr uint kStripeBits = 4;
+  static constexpr uint kStripeCount = 1u << kStripeBits;
+
+  struct StripeState {
+    // Fast lookup by (name, scope) pair
+    zc::HashMap<NameKey, zc::Vector<zc::Maybe<Symbol&>>> symbolsByName;
+
+    // First denotation of the symbol named by a (name, scope) pair; later phases' denotations
+    // are reached through its ring
+    zc::HashMap<NameKey, zc::Maybe<SymbolDenotation&>> denotationsByName;
+  };
+
+  struct alignas(64) Stripe {
+    zc::MutexGuarded<StripeState> state;
+  };
+
+  struct Storage {
+    // Backs everything below that the table creates. Declared first so that it outlives the
+    // Own<> handles pointing into it.
+    zc::Arena arena{kSymbolArenaChunkSize};
+
+    // Internal symbol storage
+    zc::Vector<zc::Own<Symbol>> symbols;
+
+    // Denotation storage
+    zc::Vector<zc::Own<SymbolDenotation>> denotations;
+
+    // Implicit symbols by scope name
+    zc::HashMap<basic::InternedString, zc::Vector<zc::Maybe<Symbol&>>> implicitsByScope;
+
+    // Registered symbols, overall, by kind and by scope, for enumeration without a scan
+    SymbolIndex allIndex;
+    SymbolIndex kindIndex[kSymbolKindCount];
+    zc::HashMap<const Scope*, SymbolIndex> scopeIndex;
+
+    // Symbols by id, and the uses recorded of each, so that per-symbol lookups are an array
+    // access and whole-table passes a linear scan
+    SymbolSideTable<zc::Maybe<Symbol&>> byId;
+    SymbolSideTable<uint32_t> useCounts;
+
+    void index(const Symbol& symbol) {
+      allIndex.add(symbol);
+      kindIndex[static_cast<uint>(symbol.getKind())].add(symbol);
+      ZC_IF_SOME(scope, symbol.getScope()) {
+        scopeIndex
+            .findOrCreate(&scope,
+                          [&]() {
+                            return zc::HashMap<const Scope*, SymbolIndex>::Entry{&scope, {}};
+                          })
+            .add(symbol);
+      }
+    }
 
-  // Denotation storage
-  zc::Vector<zc::Own<SymbolDenotation>> denotations;
+    void unindex(const Symbol& symbol) {
+      allIndex.remove(symbol);
+      kindIndex[static_cast<uint>(symbol.getKind())].remove(symbol);
+      ZC_IF_SOME(scope, symbol.getScope()) {
+        ZC_IF_SOME(scoped, scopeIndex.find(&scope)) { scoped.remove(symbol); }
+      }
+    }
+  };
 
-  // Fast lookup by (name, scope) pair
-  zc::HashMap<zc::String, zc::Vector<zc::Maybe<Symbol&>>> symbolsByName;
+  // Names and scope names of registered symbols, backing the lookup keys
+  basic::StringPool names;
 
-  // Denotation lookup by (name, scope) pair
-  zc::HashMap<zc::String, zc::Vector<zc::Maybe<SymbolDenotation&>>> denotationsByName;
+  Stripe stripes[kStripeCount];
 
-  // Implicit symbols by scope
-  zc::HashMap<zc::String, zc::Vector<zc::Maybe<Symbol&>>> implicitsByScope;
+  zc::MutexGuarded<Storage> storage;
+
+  struct IndexedModule {
+    ModuleIndex index;
+    // Scope the module's symbols are created in, each the first time it is resolved
+    const Scope* scope;
+  };
+
+  // Modules not bound in this build but known from their index. Taken before any stripe and
+  // before the storage lock, never under them.
+  zc::MutexGuarded<zc::Vector<IndexedModule>> indexedModules;
 
   // Current scope for relative lookups
-  zc::Maybe<const Scope&> currentScope = zc::none;
+  std::atomic<const Scope*> currentScope{nullptr};
 
   // ScopeManager for managing scopes
   zc::Own<ScopeManager> scopeManager;
 
   // Current compilation phase
-  uint32_t currentPhase = 0;
+  std::atomic<uint32_t> currentPhase{0};
 
   // Symbol ID generation
-  uint32_t nextSymbolId = 1;
+  std::atomic<uint32_t> nextSymbolId{1};
+
+  // Bumped on every change to the name maps
+  std::atomic<uint64_t> generation{0};
+
+  /// Resolve `qualifiedName` against the indexed modules, creating the symbol it names in the
+  /// module's scope if this is the first time.
+  zc::Maybe<Symbol&> resolveIndexed(SymbolTable& table, zc::StringPtr qualifiedName) {
+    auto locked = indexedModules.lockExclusive();
+    for (IndexedModule& module : *locked) {
+      const zc::StringPtr moduleName = module.index.getModuleName();
+      if (qualifiedName.size() <= moduleName.size() + 1 || !qualifiedName.startsWith(moduleName) ||
+          qualifiedName[moduleName.size()] != '.') {
+        continue;
+      }
+      const zc::StringPtr member = qualifiedName.slice(moduleName.size() + 1);
+      ZC_IF_SOME(symbol, table.lookup(member, *module.scope)) { return symbol; }
+      ZC_IF_SOME(entry, module.index.find(member)) {
+        return createIndexed(table, module.index, entry, *module.scope);
+      }
+    }
+    return zc::none;
+  }
+
+  static zc::Maybe<Symbol&> createIndexed(SymbolTable& table, const ModuleIndex& index,
+                                          ModuleIndex::EntryIndex entry, const Scope& scope) {
+    const zc::StringPtr name = index.getQualifiedName(entry);
+    Symbol* symbol = nullptr;
+    switch (index.getKind(entry)) {
+      case SymbolKind::Variable:
+        symbol = &table.createVariable(name, scope);
+        break;
+      case SymbolKind::Parameter:
+        symbol = &table.createParameter(name, scope);
+        break;
+      case SymbolKind::Function:
+        symbol = &table.createFunction(name, scope);
+        break;
+      case SymbolKind::Class:
+        symbol = &table.createClass(name, scope);
+        break;
+      case SymbolKind::Interface:
+        symbol = &table.createInterface(name, scope);
+        break;
+      case SymbolKind::Package:
+        symbol = &table.createPackage(name, scope);
+        break;
+      default:
+        // No symbol class to stand in for it yet
+        return zc::none;
+    }
+    symbol->addFlag(index.getFlags(entry));
+    return *symbol;
+  }
 
   // Internal helpers
-  zc::String makeKey(zc::StringPtr name, const Scope& scope) const {
-    return zc::str(name, "@", scope.getName());
+  static NameQuery makeQuery(zc::StringPtr name, const Scope& scope) {
+    return {name, scope.getName()};
+  }
+
+  NameKey makeKey(zc::StringPtr name, const Scope& scope) {
+    return {names.intern(name), names.intern(scope.getName())};
   }
 
-  zc::String makeKey(const Symbol& symbol) const {
-    ZC_IF_SOME(scope, symbol.getScope()) { return zc::str(symbol.getName(), "@", scope.getName()); }
-    else { return zc::str(symbol.getName(), "@global"); }
+  NameKey makeKey(const Symbol& symbol) {
+    ZC_IF_SOME(scope, symbol.getScope()) { return makeKey(symbol.getName(), scope); }
+    else { return {names.intern(symbol.getName()), names.intern("global"_zc)}; }
+  }
+
+  template <typename Key>
+  Stripe& getStripe(const Key& key) {
+    return stripes[key.hashCode() >> (32 - kStripeBits)];
+  }
+  template <typename Key>
+  const Stripe& getStripe(const Key& key) const {
+    return stripes[key.hashCode() >> (32 - kStripeBits)];
   }
 
   void registerSymbol(Symbol& symbol) {
-    zc::String key = makeKey(symbol);
+    NameKey key = makeKey(symbol);
+    auto locked = getStripe(key).state.lockExclusive();
 
-    ZC_IF_SOME(existingList, symbolsByName.find(key)) { existingList.add(symbol); }
+    ZC_IF_SOME(existingList, locked->symbolsByName.find(key)) { existingList.add(symbol); }
     else {
       zc::Vector<zc::Maybe<Symbol&>> newList;
       newList.add(symbol);
-      symbolsByName.insert(zc::mv(key), zc::mv(newList));
+      locked->symbolsByName.insert(zc::mv(key), zc::mv(newList));
+    }
+    bumpGeneration();
+  }
+
+  void bumpGeneration() { generation.fetch_add(1, std::memory_order_release); }
+
+  /// Create a symbol in the arena, place it in `scope` and register it for lookup.
+  template <typename T, typename... Params>
+  T& createSymbol(const Scope& scope, Params&&... params) {
+    T* result;
+    {
+      auto locked = storage.lockExclusive();
+      zc::Own<T> symbol = locked->arena.allocateOwn<T>(zc::fwd<Params>(params)...);
+      symbol->setScope(scope);
+      result = symbol.get();
+      locked->index(*result);
+      locked->byId.set(result->getId(), *result);
+      locked->symbols.add(zc::mv(symbol));
     }
+    registerSymbol(*result);
+    return *result;
+  }
+
+  /// The unit type given to value symbols created without one, allocated like the symbol.
+  zc::Own<TypeSymbol> createDefaultType() {
+    return storage.lockExclusive()->arena.allocateOwn<BuiltInTypeSymbol>(
+        SymbolId::create(generateSymbolId()), "unit"_zc,
+        SymbolFlags::TypeKind | SymbolFlags::Builtin, source::SourceLoc{});
   }
 
-  uint32_t generateSymbolId() { return nextSymbolId++; }
+  uint32_t generateSymbolId() { return nextSymbolId.fetch_add(1, std::memory_order_relaxed); }
 };
 
+// SymbolRange implementation
+SymbolRange::Iterator::Iterator(const Entry* pos, const Entry* end, zc::Maybe<SymbolKind> kind)
+    : pos(pos), end(end), kind(kind) {
+  skipToMatch();
+}
+
+const Symbol& SymbolRange::Iterator::operator*() const { return ZC_ASSERT_NONNULL(*pos); }
+
+SymbolRange::Iterator& SymbolRange::Iterator::operator++() {
+  ++pos;
+  skipToMatch();
+  return *this;
+}
+
+void SymbolRange::Iterator::skipToMatch() {
+  for (; pos != end; ++pos) {
+    ZC_IF_SOME(symbol, *pos) {
+      ZC_IF_SOME(wanted, kind) {
+        if (symbol.getKind() == wanted) { return; }
+      }
+      else { return; }
+    }
+  }
+}
+
+SymbolRange::SymbolRange(zc::ArrayPtr<const Entry> entries, size_t liveCount,
+                         zc::Maybe<SymbolKind> kind)
+    : entries(entries), liveCount(liveCount), kind(kind) {}
+
+SymbolRange::Iterator SymbolRange::begin() const {
+  return Iterator(entries.begin(), entries.end(), kind);
+}
+
+SymbolRange::Iterator SymbolRange::end() const {
+  return Iterator(entries.end(), entries.end(), kind);
+}
+
+size_t SymbolRange::size() const {
+  if (kind == zc::none) { return liveCount; }
+  size_t count = 0;
+  for (auto it = begin(); it != end(); ++it) { ++count; }
+  return count;
+}
+
 SymbolTable::SymbolTable() noexcept : impl(zc::heap<Impl>()) {
   impl->scopeManager = zc::heap<ScopeManager>();
 }
@@ -99,120 +407,49 @@ SymbolTable& SymbolTable::operator=(SymbolTable&&) noexcept = default;
 
 VariableSymbol& SymbolTable::createVariable(zc::StringPtr name, const Scope& scope) {
   // Create a default type for testing purposes
-  auto defaultType = BuiltInTypeSymbol::createUnit(SymbolId::create(impl->generateSymbolId()),
-                                                   source::SourceLoc{});
-
-  auto symbol = zc::heap<VariableSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                                         SymbolFlags::Variable | SymbolFlags::TermKind,
-                                         source::SourceLoc{}, zc::mv(defaultType));
-
-  VariableSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  auto defaultType = impl->createDefaultType();
+  return impl->createSymbol<VariableSymbol>(scope, SymbolId::create(impl->generateSymbolId()),
+                                            name, SymbolFlags::Variable | SymbolFlags::TermKind,
+                                            source::SourceLoc{}, zc::mv(defaultType));
 }
 
 ParameterSymbol& SymbolTable::createParameter(zc::StringPtr name, const Scope& scope) {
   // Create a default type for testing purposes
-  auto defaultType = BuiltInTypeSymbol::createUnit(SymbolId::create(impl->generateSymbolId()),
-                                                   source::SourceLoc{});
-
-  auto symbol = zc::heap<ParameterSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                                          SymbolFlags::Parameter | SymbolFlags::TermKind,
-                                          source::SourceLoc{}, zc::mv(defaultType));
-
-  ParameterSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  auto defaultType = impl->createDefaultType();
+  return impl->createSymbol<ParameterSymbol>(scope, SymbolId::create(impl->generateSymbolId()),
+                                             name, SymbolFlags::Parameter | SymbolFlags::TermKind,
+                                             source::SourceLoc{}, zc::mv(defaultType));
 }
 
 FunctionSymbol& SymbolTable::createFunction(zc::StringPtr name, const Scope& scope) {
   // Create a default type for testing purposes
-  auto defaultType = BuiltInTypeSymbol::createUnit(SymbolId::create(impl->generateSymbolId()),
-                                                   source::SourceLoc{});
-
-  auto symbol = zc::heap<FunctionSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                                         SymbolFlags::Function | SymbolFlags::TermKind,
-                                         source::SourceLoc{}, zc::mv(defaultType));
-
-  FunctionSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  auto defaultType = impl->createDefaultType();
+  return impl->createSymbol<FunctionSymbol>(scope, SymbolId::create(impl->generateSymbolId()),
+                                            name, SymbolFlags::Function | SymbolFlags::TermKind,
+                                            source::SourceLoc{}, zc::mv(defaultType));
 }
 
 ClassSymbol& SymbolTable::createClass(zc::StringPtr name, const Scope& scope) {
-  auto symbol =
-      zc::heap<ClassSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                            SymbolFlags::Class | SymbolFlags::TypeKind, source::SourceLoc{});
-
-  ClassSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  return impl->createSymbol<ClassSymbol>(scope, SymbolId::create(impl->generateSymbolId()), name,
+                                         SymbolFlags::Class | SymbolFlags::TypeKind,
+                                         source::SourceLoc{});
 }
 
 InterfaceSymbol& SymbolTable::createInterface(zc::StringPtr name, const Scope& scope) {
-  auto symbol = zc::heap<InterfaceSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                                          SymbolFlags::Interface | SymbolFlags::TypeKind,
-                                          source::SourceLoc{});
-
-  InterfaceSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  return impl->createSymbol<InterfaceSymbol>(scope, SymbolId::create(impl->generateSymbolId()),
+                                             name, SymbolFlags::Interface | SymbolFlags::TypeKind,
+                                             source::SourceLoc{});
 }
 
 PackageSymbol& SymbolTable::createPackage(zc::StringPtr name, const Scope& scope) {
-  auto symbol = zc::heap<PackageSymbol>(SymbolId::create(impl->generateSymbolId()), name,
-                                        SymbolFlags::Package, source::SourceLoc{});
-
-  PackageSymbol& result = *symbol;
-  result.setScope(scope);
-
-  // Store in symbols collection
-  impl->symbols.add(zc::mv(symbol));
-
-  // Register for lookup
-  impl->registerSymbol(result);
-
-  return result;
+  return impl->createSymbol<PackageSymbol>(scope, SymbolId::create(impl->generateSymbolId()), name,
+                                           SymbolFlags::Package, source::SourceLoc{});
 }
 
 zc::Maybe<Symbol&> SymbolTable::lookup(zc::StringPtr name, const Scope& scope) const {
-  zc::String key = impl->makeKey(name, scope);
-  ZC_IF_SOME(symbolList, impl->symbolsByName.find(key)) {
+  const NameQuery query = Impl::makeQuery(name, scope);
+  auto locked = impl->getStripe(query).state.lockShared();
+  ZC_IF_SOME(symbolList, locked->symbolsByName.find(query)) {
     if (symbolList.size() > 0) {
       ZC_IF_SOME(symbol, symbolList[0]) { return symbol; }
     }
@@ -221,18 +458,18 @@ zc::Maybe<Symbol&> SymbolTable::lookup(zc::StringPtr name, const Scope& scope) c
 }
 
 zc::Maybe<Symbol&> SymbolTable::lookupInCurrentScope(zc::StringPtr name) const {
-  ZC_IF_SOME(scope, impl->currentScope) { return lookup(name, scope); }
+  const Scope* scope = impl->currentScope.load(std::memory_order_acquire);
+  if (scope != nullptr) { return lookup(name, *scope); }
   return zc::none;
 }
 
 zc::Maybe<Symbol&> SymbolTable::lookupRecursive(zc::StringPtr name, const Scope& scope) const {
-  // Try current scope first
-  ZC_IF_SOME(symbol, lookup(name, scope)) { return symbol; }
-
-  // Try parent scopes
-  ZC_IF_SOME(parent, scope.getParent()) { return lookupRecursive(name, parent); }
-
-  return zc::none;
+  // Try the scope itself, then each parent outwards
+  for (const Scope* current = &scope;;) {
+    ZC_IF_SOME(symbol, lookup(name, *current)) { return symbol; }
+    ZC_IF_SOME(parent, current->getParent()) { current = &parent; }
+    else { return zc::none; }
+  }
 }
 
 zc::Maybe<SymbolDenotation&> SymbolTable::lookupDenotation(zc::StringPtr name, const Scope& scope) {
@@ -257,28 +494,57 @@ zc::Maybe<SymbolDenotation&> SymbolTable::lookupDenotation(zc::StringPtr name, c
         break;
     }
 
-    // Create a new denotation and store it
-    auto denotation = zc::heap<SymbolDenotation>(denotationKind, name, scope);
-    SymbolDenotation& result = *denotation;
-
-    // Store in denotations collection
-    impl->denotations.add(zc::mv(denotation));
+    // Reuse the denotation already made for this name, as of the current phase
+    const NameQuery query = Impl::makeQuery(name, scope);
+    {
+      auto locked = impl->getStripe(query).state.lockShared();
+      ZC_IF_SOME(first, locked->denotationsByName.find(query)) {
+        ZC_IF_SOME(denotation, first) { return denotation.atPhase(getCurrentPhase()); }
+      }
+    }
 
-    // Register in denotation lookup table
-    zc::String key = impl->makeKey(name, scope);
-    auto& mutableMap = impl->denotationsByName;
-    ZC_IF_SOME(existingList, mutableMap.find(key)) { existingList.add(result); }
-    else {
-      zc::Vector<zc::Maybe<SymbolDenotation&>> newList;
-      newList.add(result);
-      mutableMap.insert(zc::mv(key), zc::mv(newList));
+    // Create a new denotation in the arena and store it
+    SymbolDenotation* denotation;
+    {
+      auto locked = impl->storage.lockExclusive();
+      auto owned = locked->arena.allocateOwn<SymbolDenotation>(denotationKind, name, scope);
+      denotation = owned.get();
+      locked->denotations.add(zc::mv(owned));
     }
 
-    return result;
+    // Register in denotation lookup table, unless another binder got there first
+    NameKey key = impl->makeKey(name, scope);
+    auto locked = impl->getStripe(key).state.lockExclusive();
+    SymbolDenotation& first =
+        ZC_ASSERT_NONNULL(locked->denotationsByName
+                              .findOrCreate(key,
+                                            [&]() {
+                                              return zc::HashMap<NameKey,
+                                                                 zc::Maybe<SymbolDenotation&>>::
+                                                  Entry{zc::mv(key), *denotation};
+                                            }));
+    return first.atPhase(getCurrentPhase());
   }
   return zc::none;
 }
 
+SymbolDenotation& SymbolTable::updateDenotation(SymbolDenotation& denotation) {
+  const uint32_t phase = getCurrentPhase();
+  SymbolDenotation& current =
+      ZC_REQUIRE_NONNULL(denotation.atPhase(phase), "no denotation valid at the current phase",
+                         denotation.getName(), phase);
+  if (current.getValidFromPhase() == phase) { return current; }
+  ZC_REQUIRE(current.getValidUntilPhase() == SymbolDenotation::kOpenPeriod,
+             "phase is behind the latest denotation", denotation.getName(), phase);
+
+  // Copy on write: only now does the symbol get a denotation of its own for this phase
+  auto locked = impl->storage.lockExclusive();
+  auto owned = locked->arena.allocateOwn<SymbolDenotation>(current, phase);
+  SymbolDenotation& result = *owned;
+  locked->denotations.add(zc::mv(owned));
+  return result;
+}
+
 zc::Maybe<SymbolDenotation&> SymbolTable::lookupDenotationRecursive(zc::StringPtr name,
                                                                     const Scope& scope) {
   // Try current scope first
@@ -292,6 +558,10 @@ zc::Maybe<SymbolDenotation&> SymbolTable::lookupDenotationRecursive(zc::StringPt
 
 zc::Maybe<Symbol&> SymbolTable::resolveQualified(zc::StringPtr qualifiedName,
                                                  const Scope& scope) const {
+  // Symbols of indexed modules are created on first use, as if they had been there all along
+  SymbolTable& table = const_cast<SymbolTable&>(*this);
+  ZC_IF_SOME(symbol, table.impl->resolveIndexed(table, qualifiedName)) { return symbol; }
+
   // Split the qualified name by '.'
   zc::Vector<zc::String> parts;
   zc::StringPtr remaining = qualifiedName;
@@ -345,127 +615,188 @@ zc::Maybe<Symbol&> SymbolTable::resolveQualified(zc::StringPtr qualifiedName,
   return lookup(finalPart, *currentScope);
 }
 
-zc::Array<zc::Maybe<const Symbol&>> SymbolTable::getAllSymbols() const {
-  auto builder = zc::heapArrayBuilder<zc::Maybe<const Symbol&>>(impl->symbols.size());
-  for (const auto& symbol : impl->symbols) { builder.add(*symbol); }
-  return builder.finish();
+ModuleIndex SymbolTable::exportModuleIndex(zc::StringPtr moduleName, const Scope& scope,
+                                           source::SourceLoc base) const {
+  zc::Vector<ModuleIndex::ExportedSymbol> exported;
+  for (const Symbol& symbol : getSymbolsInScope(scope)) {
+    ZC_IF_SOME(entry, toExportedSymbol(symbol)) { exported.add(entry); }
+  }
+  return ModuleIndex(moduleName, exported, base);
 }
 
-zc::Array<zc::Maybe<const Symbol&>> SymbolTable::getSymbolsInScope(const Scope& scope) const {
-  // Count matching symbols first
-  size_t count = 0;
-  for (const auto& symbol : impl->symbols) {
-    ZC_IF_SOME(symbolScope, symbol->getScope()) {
-      if (symbolScope == scope) { count++; }
+zc::Vector<ModuleIndex> SymbolTable::exportModuleIndexes(
+    const Scope& scope, zc::ArrayPtr<const ModuleExtent> modules) const {
+  // Modules by where their text starts, to find the one holding a declaration by binary search.
+  zc::Vector<size_t> byStart(modules.size());
+  for (size_t i = 0; i < modules.size(); ++i) { byStart.add(i); }
+  std::sort(byStart.begin(), byStart.end(), [&](size_t a, size_t b) {
+    return modules[a].range.getStart() < modules[b].range.getStart();
+  });
+
+  zc::Array<zc::Vector<ModuleIndex::ExportedSymbol>> exported =
+      zc::heapArray<zc::Vector<ModuleIndex::ExportedSymbol>>(modules.size());
+  for (const Symbol& symbol : getSymbolsInScope(scope)) {
+    ZC_IF_SOME(entry, toExportedSymbol(symbol)) {
+      const source::SourceLoc start = entry.range.getStart();
+      // The last module starting at or before the declaration is the only one that may hold it.
+      auto after = std::upper_bound(byStart.begin(), byStart.end(), start,
+                                    [&](source::SourceLoc loc, size_t module) {
+                                      return loc < modules[module].range.getStart();
+                                    });
+      if (after == byStart.begin()) { continue; }
+      const size_t module = *(after - 1);
+      if (modules[module].range.contains(start)) { exported[module].add(entry); }
     }
   }
 
-  auto builder = zc::heapArrayBuilder<zc::Maybe<const Symbol&>>(count);
-  for (const auto& symbol : impl->symbols) {
-    ZC_IF_SOME(symbolScope, symbol->getScope()) {
-      if (symbolScope == scope) { builder.add(*symbol); }
-    }
+  zc::Vector<ModuleIndex> indexes(modules.size());
+  for (size_t i = 0; i < modules.size(); ++i) {
+    indexes.add(ModuleIndex(modules[i].moduleName, exported[i], modules[i].base));
   }
-  return builder.finish();
+  return indexes;
 }
 
-zc::Array<zc::Maybe<const Symbol&>> SymbolTable::getSymbolsOfType(SymbolKind kind) const {
-  // Count matching symbols first
-  size_t count = 0;
-  for (const auto& symbol : impl->symbols) {
-    if (symbol->getKind() == kind) { count++; }
-  }
+void SymbolTable::addModuleIndex(ModuleIndex index) {
+  zc::StringPtr moduleName = internName(index.getModuleName());
+  Scope& scope = impl->scopeManager->createScope(Scope::Kind::Module, moduleName,
+                                                 impl->scopeManager->getGlobalScopeMutable());
+  impl->indexedModules.lockExclusive()->add(Impl::IndexedModule{zc::mv(index), &scope});
+}
 
-  auto builder = zc::heapArrayBuilder<zc::Maybe<const Symbol&>>(count);
-  for (const auto& symbol : impl->symbols) {
-    if (symbol->getKind() == kind) { builder.add(*symbol); }
-  }
-  return builder.finish();
+SymbolRange SymbolTable::getAllSymbols() const {
+  return impl->storage.lockShared()->allIndex.range();
 }
 
-zc::Array<zc::Maybe<const Symbol&>> SymbolTable::getSymbolsOfType(SymbolKind kind,
-                                                                  const Scope& scope) const {
-  // Count matching symbols first
-  size_t count = 0;
-  for (const auto& symbol : impl->symbols) {
-    ZC_IF_SOME(symbolScope, symbol->getScope()) {
-      if (symbolScope == scope && symbol->getKind() == kind) { count++; }
-    }
-  }
+zc::Maybe<Symbol&> SymbolTable::getSymbol(SymbolId id) const {
+  ZC_IF_SOME(symbol, impl->storage.lockShared()->byId.get(id)) { return symbol; }
+  return zc::none;
+}
 
-  auto builder = zc::heapArrayBuilder<zc::Maybe<const Symbol&>>(count);
-  for (const auto& symbol : impl->symbols) {
-    ZC_IF_SOME(symbolScope, symbol->getScope()) {
-      if (symbolScope == scope && symbol->getKind() == kind) { builder.add(*symbol); }
-    }
-  }
-  return builder.finish();
+void SymbolTable::recordUse(const Symbol& symbol) {
+  ++impl->storage.lockExclusive()->useCounts.at(symbol.getId());
 }
 
-void SymbolTable::setCurrentScope(const Scope& scope) { impl->currentScope = scope; }
+uint32_t SymbolTable::getUseCount(const Symbol& symbol) const {
+  return impl->storage.lockShared()->useCounts.get(symbol.getId());
+}
 
-zc::Maybe<const Scope&> SymbolTable::getCurrentScope() const { return impl->currentScope; }
+zc::ArrayPtr<const uint32_t> SymbolTable::getUseCounts() const {
+  return impl->storage.lockShared()->useCounts.asPtr();
+}
+
+SymbolRange SymbolTable::getSymbolsInScope(const Scope& scope) const {
+  auto locked = impl->storage.lockShared();
+  ZC_IF_SOME(scoped, locked->scopeIndex.find(&scope)) { return scoped.range(); }
+  return {};
+}
+
+SymbolRange SymbolTable::getSymbolsOfType(SymbolKind kind) const {
+  return impl->storage.lockShared()->kindIndex[static_cast<uint>(kind)].range();
+}
+
+SymbolRange SymbolTable::getSymbolsOfType(SymbolKind kind, const Scope& scope) const {
+  auto locked = impl->storage.lockShared();
+  ZC_IF_SOME(scoped, locked->scopeIndex.find(&scope)) { return scoped.range(kind); }
+  return {};
+}
+
+void SymbolTable::setCurrentScope(const Scope& scope) {
+  impl->currentScope.store(&scope, std::memory_order_release);
+}
+
+zc::Maybe<const Scope&> SymbolTable::getCurrentScope() const {
+  return impl->currentScope.load(std::memory_order_acquire);
+}
 
 ScopeManager& SymbolTable::getScopeManager() { return *impl->scopeManager; }
 
 const ScopeManager& SymbolTable::getScopeManager() const { return *impl->scopeManager; }
 
-uint32_t SymbolTable::getCurrentPhase() const { return impl->currentPhase; }
+basic::InternedString SymbolTable::internName(zc::ArrayPtr<const char> name) {
+  return impl->names.intern(name);
+}
+
+void SymbolTable::setCurrentPhase(uint32_t phase) {
+  impl->currentPhase.store(phase, std::memory_order_release);
+}
+
+uint32_t SymbolTable::getCurrentPhase() const {
+  return impl->currentPhase.load(std::memory_order_acquire);
+}
 
 void SymbolTable::enterSymbol(Symbol& symbol, const Scope& scope) {
   // Set the symbol's scope
   symbol.setScope(scope);
 
   // Register the symbol for lookup - check if it already exists first
-  zc::String key = impl->makeKey(symbol);
-  ZC_IF_SOME(existingList, impl->symbolsByName.find(key)) {
-    // Check if this symbol is already in the list
-    bool found = false;
-    for (size_t i = 0; i < existingList.size(); ++i) {
-      ZC_IF_SOME(existingSym, existingList[i]) {
-        if (&existingSym == &symbol) {
+  NameKey key = impl->makeKey(symbol);
+  bool entered = true;
+  {
+    auto locked = impl->getStripe(key).state.lockExclusive();
+    ZC_IF_SOME(existingList, locked->symbolsByName.find(key)) {
+      // Check if this symbol is already in the list
+      bool found = false;
+      for (size_t i = 0; i < existingList.size(); ++i) {
+        ZC_IF_SOME(existingSym, existingList[i]) {
+          if (&existingSym == &symbol) {
+            found = true;
+            entered = false;
+            break;
+          }
+        }
+        else {
+          // Found an empty slot, reuse it
+          existingList[i] = symbol;
           found = true;
           break;
         }
       }
-      else {
-        // Found an empty slot, reuse it
-        existingList[i] = symbol;
-        found = true;
-        break;
-      }
+      if (!found) { existingList.add(symbol); }
+    }
+    else {
+      // Create new list for this key
+      zc::Vector<zc::Maybe<Symbol&>> newList;
+      newList.add(symbol);
+      locked->symbolsByName.insert(zc::mv(key), zc::mv(newList));
     }
-    if (!found) { existingList.add(symbol); }
-  }
-  else {
-    // Create new list for this key
-    zc::Vector<zc::Maybe<Symbol&>> newList;
-    newList.add(symbol);
-    impl->symbolsByName.insert(zc::mv(key), zc::mv(newList));
   }
+  impl->bumpGeneration();
+
+  // Index it once the stripe is released; storage is never locked while holding a stripe
+  if (entered) { impl->storage.lockExclusive()->index(symbol); }
 }
 
 void SymbolTable::dropSymbol(Symbol& symbol, const Scope& scope) {
   // Only remove from lookup tables, don't destroy the symbol object
   // This allows the symbol to remain valid for external references
-  zc::String key = impl->makeKey(symbol);
-  ZC_IF_SOME(symbolList, impl->symbolsByName.find(key)) {
-    for (size_t i = 0; i < symbolList.size(); ++i) {
-      ZC_IF_SOME(sym, symbolList[i]) {
-        if (&sym == &symbol) {
-          // Mark as none instead of removing to avoid shifting elements
-          symbolList[i] = zc::none;
-          break;
+  NameKey key = impl->makeKey(symbol);
+  bool dropped = false;
+  {
+    auto locked = impl->getStripe(key).state.lockExclusive();
+    ZC_IF_SOME(symbolList, locked->symbolsByName.find(key)) {
+      for (size_t i = 0; i < symbolList.size(); ++i) {
+        ZC_IF_SOME(sym, symbolList[i]) {
+          if (&sym == &symbol) {
+            // Mark as none instead of removing to avoid shifting elements
+            symbolList[i] = zc::none;
+            dropped = true;
+            break;
+          }
         }
       }
     }
   }
+
+  if (dropped) {
+    impl->bumpGeneration();
+    impl->storage.lockExclusive()->unindex(symbol);
+  }
 }
 
 zc::Array<zc::Maybe<Symbol&>> SymbolTable::getImplicitSymbols(const Scope& scope) const {
   // Look up implicit symbols for this scope
-  zc::String scopeKey = zc::str("implicit@", scope.getName());
-  ZC_IF_SOME(implicitList, impl->implicitsByScope.find(scopeKey)) {
+  auto locked = impl->storage.lockShared();
+  ZC_IF_SOME(implicitList, locked->implicitsByScope.find(scope.getName())) {
     // Return a copy of the implicit symbols
     auto builder = zc::heapArrayBuilder<zc::Maybe<Symbol&>>(implicitList.size());
     for (const auto& maybeSymbol : implicitList) {
@@ -483,31 +814,77 @@ zc::Array<zc::Maybe<Symbol&>> SymbolTable::getImplicitSymbols(const Scope& scope
 
 void SymbolTable::registerImplicitSymbol(Symbol& symbol, const Scope& scope) {
   // Register the symbol as implicit for this scope
-  zc::String scopeKey = zc::str("implicit@", scope.getName());
+  basic::InternedString scopeKey = impl->names.intern(scope.getName());
 
-  ZC_IF_SOME(existingList, impl->implicitsByScope.find(scopeKey)) { existingList.add(symbol); }
+  auto locked = impl->storage.lockExclusive();
+  ZC_IF_SOME(existingList, locked->implicitsByScope.find(scopeKey)) { existingList.add(symbol); }
   else {
     zc::Vector<zc::Maybe<Symbol&>> newList;
     newList.add(symbol);
-    impl->implicitsByScope.insert(zc::mv(scopeKey), zc::mv(newList));
+    locked->implicitsByScope.insert(zc::mv(scopeKey), zc::mv(newList));
   }
 }
 
+uint64_t SymbolTable::getGeneration() const {
+  return impl->generation.load(std::memory_order_acquire);
+}
+
 size_t SymbolTable::getSymbolCount() const {
   // Count symbols that are actually registered in the lookup table
   size_t count = 0;
-  for (const auto& entry : impl->symbolsByName) {
-    for (const auto& maybeSymbol : entry.value) {
-      ZC_IF_SOME(symbol, maybeSymbol) {
-        (void)symbol;  // Mark as used
-        count++;
+  for (const auto& stripe : impl->stripes) {
+    auto locked = stripe.state.lockShared();
+    for (const auto& entry : locked->symbolsByName) {
+      for (const auto& maybeSymbol : entry.value) {
+        ZC_IF_SOME(symbol, maybeSymbol) {
+          (void)symbol;  // Mark as used
+          count++;
+        }
       }
     }
   }
   return count;
 }
 
-size_t SymbolTable::getDenotationCount() const { return impl->denotations.size(); }
+size_t SymbolTable::getDenotationCount() const {
+  return impl->storage.lockShared()->denotations.size();
+}
+
+basic::MemoryUsage SymbolTable::getMemoryUsage() const {
+  basic::MemoryUsage usage;
+  usage.addObject<Impl>();
+  usage += impl->names.getMemoryUsage();
+
+  for (const auto& stripe : impl->stripes) {
+    auto locked = stripe.state.lockShared();
+    usage.addTable(locked->symbolsByName);
+    for (const auto& entry : locked->symbolsByName) { usage.addVector(entry.value); }
+    usage.addTable(locked->denotationsByName);
+  }
+
+  {
+    auto locked = impl->storage.lockShared();
+    usage.addArena(locked->arena);
+    usage.addVector(locked->symbols);
+    usage.addVector(locked->denotations);
+    usage.addTable(locked->implicitsByScope);
+    for (const auto& entry : locked->implicitsByScope) { usage.addVector(entry.value); }
+    locked->allIndex.addMemoryUsage(usage);
+    for (const SymbolIndex& index : locked->kindIndex) { index.addMemoryUsage(usage); }
+    usage.addTable(locked->scopeIndex);
+    for (const auto& entry : locked->scopeIndex) { entry.value.addMemoryUsage(usage); }
+    usage += locked->byId.getMemoryUsage();
+    usage += locked->useCounts.getMemoryUsage();
+  }
+
+  {
+    auto locked = impl->indexedModules.lockShared();
+    usage.addVector(*locked);
+    for (const Impl::IndexedModule& module : *locked) { usage += module.index.getMemoryUsage(); }
+  }
+  usage.addObject<ScopeManager>();
+  return usage;
+}
 
 void SymbolTable::dumpSymbols() const {
   // Implementation for dumping symbols
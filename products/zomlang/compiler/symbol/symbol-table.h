@@ -19,6 +19,10 @@
 #include "zc/core/array.h"
 #include "zc/core/common.h"
 #include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/basic/memory-usage.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/symbol/module-index.h"
 #include "zomlang/compiler/symbol/symbol-denotation.h"
 #include "zomlang/compiler/symbol/symbol.h"
 
@@ -39,6 +43,49 @@ class InterfaceSymbol;
 class PackageSymbol;
 class SymbolDenotation;
 
+/// \brief SymbolRange - Lazy view over the symbols in one of SymbolTable's indexes
+///
+/// Iterates the index in registration order, skipping dropped entries and, if a kind is given,
+/// symbols of other kinds. Nothing is copied. Like ScopeManager::getAllScopes(), the view is only
+/// stable while no symbols are being created, entered or dropped.
+class SymbolRange {
+public:
+  using Entry = zc::Maybe<const Symbol&>;
+
+  class Iterator {
+  public:
+    Iterator(const Entry* pos, const Entry* end, zc::Maybe<SymbolKind> kind);
+
+    const Symbol& operator*() const;
+    Iterator& operator++();
+    bool operator==(const Iterator& other) const { return pos == other.pos; }
+    bool operator!=(const Iterator& other) const { return pos != other.pos; }
+
+  private:
+    const Entry* pos;
+    const Entry* end;
+    zc::Maybe<SymbolKind> kind;
+
+    void skipToMatch();
+  };
+
+  SymbolRange() = default;
+  SymbolRange(zc::ArrayPtr<const Entry> entries, size_t liveCount,
+              zc::Maybe<SymbolKind> kind = zc::none);
+
+  Iterator begin() const;
+  Iterator end() const;
+
+  /// \brief Number of symbols the range yields. Constant time unless narrowed to a kind.
+  size_t size() const;
+  bool empty() const { return begin() == end(); }
+
+private:
+  zc::ArrayPtr<const Entry> entries;
+  size_t liveCount = 0;
+  zc::Maybe<SymbolKind> kind;
+};
+
 /// \brief SymbolTable - Enhanced symbol management with distributed architecture
 ///
 /// This enhanced symbol table:
@@ -48,6 +95,7 @@ class SymbolDenotation;
 /// 4. Type-safe symbol creation with denotation support
 /// 5. Phase-aware compilation support
 /// 6. Symbol uniqueness guarantees
+/// 7. Symbol creation, entry and lookup safe from binders running in parallel
 class SymbolTable {
 public:
   SymbolTable() noexcept;
@@ -72,20 +120,67 @@ public:
   zc::Maybe<Symbol&> lookupInCurrentScope(zc::StringPtr name) const;
   zc::Maybe<Symbol&> lookupRecursive(zc::StringPtr name, const Scope& scope) const;
 
-  /// \brief Denotation-based lookup
+  /// \brief Denotation-based lookup, as of the current phase. A name's denotation is made on
+  /// first lookup and shared by later ones; use atPhase() on it for other phases.
   zc::Maybe<SymbolDenotation&> lookupDenotation(zc::StringPtr name, const Scope& scope);
   zc::Maybe<SymbolDenotation&> lookupDenotationRecursive(zc::StringPtr name, const Scope& scope);
 
-  /// \brief Qualified name resolution
+  /// \brief Denotation to modify in the current phase for the symbol `denotation` belongs to.
+  /// Returns the denotation valid now if its period starts at this phase; otherwise closes that
+  /// period and links a copy valid from this phase on, so earlier phases keep their view. Phases
+  /// advance between passes: do not update denotations while another thread reads them.
+  SymbolDenotation& updateDenotation(SymbolDenotation& denotation);
+
+  /// \brief Qualified name resolution. Names inside a module added with addModuleIndex() are
+  /// resolved from its index.
   zc::Maybe<Symbol&> resolveQualified(zc::StringPtr qualifiedName, const Scope& scope) const;
 
-  /// \brief Symbol enumeration
-  zc::Array<zc::Maybe<const Symbol&>> getAllSymbols() const;
-  zc::Array<zc::Maybe<const Symbol&>> getSymbolsInScope(const Scope& scope) const;
+  /// \brief Record the symbols declared directly in `scope` as the index of module `moduleName`,
+  /// leaving out private and compiler-internal ones. A symbol's source range is that of its first
+  /// declaration, stored relative to `base`.
+  ModuleIndex exportModuleIndex(zc::StringPtr moduleName, const Scope& scope,
+                                source::SourceLoc base = source::SourceLoc()) const;
+
+  /// \brief Where a module shares a scope with others, e.g. a file whose top-level symbols the
+  /// binder declares in the global scope.
+  struct ModuleExtent {
+    zc::StringPtr moduleName;
+    /// Text holding the declarations of the module's symbols
+    source::CharSourceRange range;
+    /// What the module's source ranges are stored relative to
+    source::SourceLoc base;
+  };
+
+  /// \brief Like exportModuleIndex(), for several modules declared in `scope` at once. A symbol
+  /// goes to the module whose range holds its first declaration, if any, in a single pass over the
+  /// scope. The ranges must not overlap.
+  /// \return The index of each module, in the order of `modules`
+  zc::Vector<ModuleIndex> exportModuleIndexes(const Scope& scope,
+                                              zc::ArrayPtr<const ModuleExtent> modules) const;
+
+  /// \brief Make the symbols of a module that is not bound in this build resolvable by
+  /// resolveQualified(), e.g. from an index deserialized out of a previous build. Each symbol is
+  /// created the first time it is resolved, in a module scope under the global scope.
+  void addModuleIndex(ModuleIndex index);
+
+  /// \brief Symbol enumeration over the registered symbols, served from indexes kept up to date
+  /// by symbol creation, enterSymbol and dropSymbol
+  SymbolRange getAllSymbols() const;
+  SymbolRange getSymbolsInScope(const Scope& scope) const;
 
   /// \brief Get symbols of specific type using SymbolKind
-  zc::Array<zc::Maybe<const Symbol&>> getSymbolsOfType(SymbolKind kind) const;
-  zc::Array<zc::Maybe<const Symbol&>> getSymbolsOfType(SymbolKind kind, const Scope& scope) const;
+  SymbolRange getSymbolsOfType(SymbolKind kind) const;
+  SymbolRange getSymbolsOfType(SymbolKind kind, const Scope& scope) const;
+
+  /// \brief The symbol this table created with id `id`, found by indexing rather than hashing
+  zc::Maybe<Symbol&> getSymbol(SymbolId id) const;
+
+  /// \brief Uses of symbols, counted per symbol id for checks and tools such as unused
+  /// declaration warnings. getUseCounts() is indexed by SymbolId::index(), ends after the highest
+  /// id used and, like a SymbolRange, is only stable while no uses are being recorded.
+  void recordUse(const Symbol& symbol);
+  uint32_t getUseCount(const Symbol& symbol) const;
+  zc::ArrayPtr<const uint32_t> getUseCounts() const;
 
   /// \brief Scope management
   void setCurrentScope(const Scope& scope);
@@ -95,6 +190,10 @@ public:
   ScopeManager& getScopeManager();
   const ScopeManager& getScopeManager() const;
 
+  /// \brief Intern a name in the table's pool. The handle stays valid as long as the table, so it
+  /// can name scopes kept by the table's ScopeManager.
+  basic::InternedString internName(zc::ArrayPtr<const char> name);
+
   /// \brief Phase management (for multi-phase compilation)
   void setCurrentPhase(uint32_t phase);
   uint32_t getCurrentPhase() const;
@@ -111,9 +210,18 @@ public:
   zc::Array<zc::Maybe<Symbol&>> getImplicitSymbols(const Scope& scope) const;
   void registerImplicitSymbol(Symbol& symbol, const Scope& scope);
 
+  /// \brief Counter that changes whenever a name is declared, entered or dropped, so callers
+  /// caching resolutions can tell when they are stale.
+  uint64_t getGeneration() const;
+
   /// \brief Statistics and debugging
   size_t getSymbolCount() const;
   size_t getDenotationCount() const;
+  /// \brief Measure the symbol arena, the lookup and enumeration indexes, the pool of names and
+  /// the module indexes. Symbols and denotations are counted by the arena they live in; memory a
+  /// symbol allocates for itself, e.g. for its members, is not counted. The ScopeManager reports
+  /// its own.
+  basic::MemoryUsage getMemoryUsage() const;
   void dumpSymbols() const;
   void dumpDenotations() const;
 
@@ -186,6 +186,8 @@ BuiltInTypeSymbol::BuiltInTypeSymbol(SymbolId id, zc::StringPtr name, SymbolFlag
                                      const source::SourceLoc& location) noexcept
     : TypeSymbol(id, name, flags, location), impl(zc::heap<Impl>()) {}
 
+BuiltInTypeSymbol::~BuiltInTypeSymbol() noexcept(false) = default;
+
 zc::Own<BuiltInTypeSymbol> BuiltInTypeSymbol::createI32(SymbolId id,
                                                         const source::SourceLoc& location) {
   return zc::heap<BuiltInTypeSymbol>(id, "i32"_zc, SymbolFlags::TypeKind | SymbolFlags::Builtin,
@@ -109,6 +109,7 @@ class BuiltInTypeSymbol final : public TypeSymbol {
 public:
   BuiltInTypeSymbol(SymbolId id, zc::StringPtr name, SymbolFlags flags,
                     const source::SourceLoc& location) noexcept;
+  ~BuiltInTypeSymbol() noexcept(false);
 
   ZC_DISALLOW_COPY(BuiltInTypeSymbol);
 
@@ -38,6 +38,11 @@ const char* RuntimeConfig::getOutputFileFromEnvironment() {
   return std::getenv("ZOM_TRACE_OUTPUT");
 }
 
+bool RuntimeConfig::shouldSampleFromEnvironment() {
+  const char* env = std::getenv("ZOM_TRACE_MODE");
+  return env != nullptr && std::strcmp(env, "sampling") == 0;
+}
+
 uint32_t RuntimeConfig::getCategoryMaskFromEnvironment() {
   const char* env = std::getenv("ZOM_TRACE_CATEGORIES");
   if (env == nullptr) { return static_cast<uint32_t>(TraceCategory::kAll); }
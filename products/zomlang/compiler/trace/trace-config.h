@@ -22,11 +22,9 @@
 /// These macros can be overridden via CMake or compiler flags
 
 #ifndef ZOM_TRACE_ENABLED
-#ifdef NDEBUG
-#define ZOM_TRACE_ENABLED 0  // Disabled in release builds by default
-#else
-#define ZOM_TRACE_ENABLED 1  // Enabled in debug builds by default
-#endif
+// Compiled in by default, release builds included: until tracing is configured at runtime, a
+// trace point costs a load and a branch.
+#define ZOM_TRACE_ENABLED 1
 #endif
 
 #ifndef ZOM_TRACE_MAX_DEPTH
@@ -34,7 +32,7 @@
 #endif
 
 #ifndef ZOM_TRACE_BUFFER_SIZE
-#define ZOM_TRACE_BUFFER_SIZE 1000000  // Default maximum events
+#define ZOM_TRACE_BUFFER_SIZE 65536  // Default events kept per thread
 #endif
 
 namespace zomlang {
@@ -52,6 +50,9 @@ struct RuntimeConfig {
   /// Get trace category mask from environment variable
   static uint32_t getCategoryMaskFromEnvironment();
 
+  /// Check if the environment asks for sampling rather than recording every event
+  static bool shouldSampleFromEnvironment();
+
 private:
   /// Helper to process individual category name
   static void processCategoryName(const zc::StringPtr category, uint32_t& mask);
@@ -14,11 +14,25 @@
 
 #include "zomlang/compiler/trace/trace.h"
 
+#if !_WIN32
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#if __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
-#include <thread>
+#include <cstring>
 
 #include "zc/core/debug.h"
 #include "zc/core/filesystem.h"
+#include "zc/core/io.h"
 #include "zc/core/map.h"
 #include "zc/core/mutex.h"
 #include "zc/core/vector.h"
@@ -30,54 +44,437 @@ namespace compiler {
 namespace trace {
 
 // ================================================================================
-// TraceEvent
+// Cached runtime state
+
+std::atomic<uint32_t> _::activeCategoryMask{0};
+
+namespace {
+
+/// Scopes deeper than this are left out of samples
+constexpr uint32_t kMaxSampledDepth = 64;
+
+/// Distinct sampled stacks of one thread and how often each was seen. Only the profiling signal
+/// handler on the owning thread writes it, so it takes no lock and never allocates; readers load a
+/// slot's count with acquire ordering before reading its stack, which never changes once the
+/// count is published.
+struct SampleTable {
+  static constexpr size_t kSlots = 4096;
+  static constexpr size_t kArenaWords = 1 << 16;
+
+  struct Slot {
+    std::atomic<uint32_t> count{0};
+    uint32_t hash = 0;
+    uint32_t offset = 0;  // Of the stack in `arena`
+    uint32_t depth = 0;
+  };
+
+  Slot slots[kSlots];
+  uint32_t arena[kArenaWords];
+  uint32_t arenaUsed = 0;
+  /// Samples of new stacks that found the table or the arena full
+  std::atomic<uint64_t> dropped{0};
+
+  /// Count a sample of `stack`. Async-signal-safe.
+  void record(const uint32_t* stack, uint32_t depth) {
+    uint32_t hash = 2166136261u;  // FNV-1a over the name ids
+    for (uint32_t i = 0; i < depth; ++i) { hash = (hash ^ stack[i]) * 16777619u; }
+
+    for (size_t probe = 0; probe < kSlots; ++probe) {
+      Slot& slot = slots[(hash + probe) & (kSlots - 1)];
+      const uint32_t count = slot.count.load(std::memory_order_relaxed);
+      if (count == 0) {
+        if (arenaUsed + depth > kArenaWords) { break; }
+        std::memcpy(arena + arenaUsed, stack, depth * sizeof(uint32_t));
+        slot.hash = hash;
+        slot.offset = arenaUsed;
+        slot.depth = depth;
+        arenaUsed += depth;
+        slot.count.store(1, std::memory_order_release);
+        return;
+      }
+      if (slot.hash == hash && slot.depth == depth &&
+          std::memcmp(arena + slot.offset, stack, depth * sizeof(uint32_t)) == 0) {
+        slot.count.store(count + 1, std::memory_order_relaxed);
+        return;
+      }
+    }
+    dropped.store(dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+};
+
+constexpr size_t kHardwareCounterCount = 4;
+const char* const kHardwareCounterNames[kHardwareCounterCount] = {"instructions", "cycles",
+                                                                  "cacheMisses", "branchMisses"};
+
+/// A perf_event counter group of one thread, counting its user-space work. The counters share a
+/// group so that one read returns all of them, measured over the same time.
+struct HardwareCounters {
+  /// The group leader first
+  zc::Vector<zc::OwnFd> fds;
+  uint32_t nameIds[kHardwareCounterCount] = {};
+  /// Counts at the entry of each scope the thread is in, as far as `kMaxSampledDepth`, and
+  /// whether they were taken
+  uint64_t starts[kMaxSampledDepth][kHardwareCounterCount] = {};
+  bool started[kMaxSampledDepth] = {};
+
+  /// Open the counters for the calling thread, or return none if the kernel refuses, e.g. under a
+  /// strict perf_event_paranoid or in a VM without a PMU.
+  static zc::Maybe<zc::Own<HardwareCounters>> open() {
+#if __linux__
+    static constexpr uint64_t kConfigs[kHardwareCounterCount] = {
+        PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    auto counters = zc::heap<HardwareCounters>();
+    for (uint64_t config : kConfigs) {
+      struct perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      const int group = counters->fds.empty() ? -1 : counters->fds[0].get();
+      const long fd = syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+      if (fd < 0) { return zc::none; }
+      counters->fds.add(zc::OwnFd(static_cast<int>(fd)));
+    }
+    return zc::mv(counters);
+#else
+    return zc::none;
+#endif
+  }
+
+  bool read(uint64_t (&values)[kHardwareCounterCount]) const {
+#if __linux__
+    struct {
+      uint64_t count;
+      uint64_t values[kHardwareCounterCount];
+    } group;
+    if (::read(fds[0], &group, sizeof(group)) != sizeof(group)) { return false; }
+    std::memcpy(values, group.values, sizeof(values));
+    return true;
+#else
+    return false;
+#endif
+  }
+};
+
+/// Events recorded by one thread, oldest overwritten first. Only the owning thread writes `ring`,
+/// `head`, `depth` and `ids`, without locking; readers load `head`, copy the events before it,
+/// then load it again and drop the copies the owner may have overwritten in the meantime.
+struct alignas(64) ThreadRing {
+  ThreadRing(uint32_t threadId, size_t capacity)
+      : threadId(threadId), ring(zc::heapArray<TraceEvent>(capacity)) {}
+
+  const uint32_t threadId;
+  /// Event `i` is at `ring[i & (ring.size() - 1)]`; the size is a power of two
+  zc::Array<TraceEvent> ring;
+  /// Events recorded so far
+  std::atomic<uint64_t> head{0};
+  /// Events before this one were cleared. Written by readers only.
+  std::atomic<uint64_t> start{0};
+  std::atomic<uint32_t> depth{0};
+  /// Name ids of the scopes the thread is in, outermost first, as far as `kMaxSampledDepth`
+  uint32_t stack[kMaxSampledDepth] = {};
+  /// Allocated by the owner when it first enters a scope while sampling, and read by the profiling
+  /// signal handler on the same thread
+  std::atomic<SampleTable*> samples{nullptr};
+  zc::Own<SampleTable> ownedSamples;
+  /// Opened on the first scope entry that wants them; none if that failed
+  zc::Maybe<zc::Own<HardwareCounters>> counters;
+  bool countersOpened = false;
+  /// Ids this thread already interned, so that only new text takes the lock
+  zc::HashMap<zc::StringPtr, uint32_t> ids;
+
+  /// Index of the oldest event still readable when `end` events were recorded
+  uint64_t firstReadable(uint64_t end) const {
+    const uint64_t cleared = start.load(std::memory_order_relaxed);
+    return end > ring.size() ? zc::max(cleared, end - ring.size()) : cleared;
+  }
+};
+
+thread_local ThreadRing* currentRing = nullptr;
+
+void onProfilingSignal(int) {
+  const int savedErrno = errno;
+  const ThreadRing* ring = currentRing;
+  if (ring != nullptr) {
+    SampleTable* samples = ring->samples.load(std::memory_order_relaxed);
+    const uint32_t depth = ring->depth.load(std::memory_order_relaxed);
+    std::atomic_signal_fence(std::memory_order_acquire);
+    if (samples != nullptr && depth > 0) {
+      samples->record(ring->stack, zc::min(depth, kMaxSampledDepth));
+    }
+  }
+  errno = savedErrno;
+}
 
-TraceEvent::TraceEvent(TraceEventType t, TraceCategory cat, zc::StringPtr n, zc::StringPtr d,
-                       uint32_t dep) noexcept
-    : type(t), category(cat), name(zc::str(n)), depth(dep) {
-  if (d != nullptr) { details = zc::str(d); }
+struct ThreadEvents {
+  uint32_t threadId;
+  zc::Vector<TraceEvent> events;
+};
 
-  // Get current timestamp in nanoseconds
-  auto now = std::chrono::high_resolution_clock::now();
-  auto epoch = now.time_since_epoch();
-  timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(epoch).count();
+size_t roundUpToPowerOfTwo(size_t n) {
+  size_t result = 1;
+  while (result < n) { result <<= 1; }
+  return result;
+}
 
-  // Get thread ID
-  auto tid = std::this_thread::get_id();
-  threadId = std::hash<std::thread::id>{}(tid);
+uint64_t now() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+const char* getPhase(TraceEventType type) {
+  switch (type) {
+    case TraceEventType::kEnter:
+      return "B";  // Begin
+    case TraceEventType::kExit:
+      return "E";  // End
+    case TraceEventType::kInstant:
+      return "i";  // Instant
+    case TraceEventType::kCounter:
+      return "C";  // Counter
+    case TraceEventType::kMetadata:
+      return "M";  // Metadata
+  }
+  return "i";
+}
+
+const char* getCategoryName(TraceCategory category) {
+  switch (category) {
+    case TraceCategory::kLexer:
+      return "lexer";
+    case TraceCategory::kParser:
+      return "parser";
+    case TraceCategory::kChecker:
+      return "checker";
+    case TraceCategory::kDriver:
+      return "driver";
+    case TraceCategory::kDiagnostics:
+      return "diagnostics";
+    case TraceCategory::kMemory:
+      return "memory";
+    case TraceCategory::kPerformance:
+      return "performance";
+    default:
+      return "unknown";
+  }
 }
 
+}  // namespace
+
 // ================================================================================
 // TraceManager::Impl
 
 struct TraceManager::Impl {
   TraceConfig config;
-  mutable zc::MutexGuarded<zc::Vector<TraceEvent>> events;
-  mutable zc::MutexGuarded<zc::HashMap<uint32_t, uint32_t>> threadDepths;
-
-  Impl() {
-    // Initialize with default config
-    config.enabled = false;
-    config.categoryMask = TraceCategory::kAll;
-    config.maxEvents = 1000000;
-    config.enableTimestamps = true;
-    config.enableThreadInfo = true;
+
+  /// Interned text, by id - 1; `ids` points into it
+  struct Names {
+    zc::Vector<zc::String> texts;
+    zc::HashMap<zc::StringPtr, uint32_t> ids;
+  };
+  zc::MutexGuarded<Names> names;
+
+  /// Every thread that recorded an event, in order of its first one. Rings live as long as the
+  /// manager, so the events of threads that have exited are still flushed.
+  zc::MutexGuarded<zc::Vector<zc::Own<ThreadRing>>> rings;
+  /// Capacity of rings created from now on
+  std::atomic<size_t> ringCapacity{roundUpToPowerOfTwo(ZOM_TRACE_BUFFER_SIZE)};
+
+  /// Interval the profiling timer runs at, 0 while stopped
+  uint32_t timerInterval = 0;
+  bool signalHandlerInstalled = false;
+
+  void setSamplingTimer(uint32_t intervalUs) {
+#if !_WIN32
+    // Installed once and left in place: a signal still pending when the timer stops would
+    // otherwise terminate the process
+    if (intervalUs > 0 && !signalHandlerInstalled) {
+      struct sigaction action;
+      std::memset(&action, 0, sizeof(action));
+      action.sa_handler = &onProfilingSignal;
+      action.sa_flags = SA_RESTART;
+      sigemptyset(&action.sa_mask);
+      ZC_SYSCALL(sigaction(SIGPROF, &action, nullptr));
+      signalHandlerInstalled = true;
+    }
+
+    struct itimerval timer;
+    std::memset(&timer, 0, sizeof(timer));
+    timer.it_interval.tv_sec = intervalUs / 1000000;
+    timer.it_interval.tv_usec = intervalUs % 1000000;
+    timer.it_value = timer.it_interval;
+    ZC_SYSCALL(setitimer(ITIMER_PROF, &timer, nullptr));
+#else
+    ZC_REQUIRE(intervalUs == 0, "sampling needs SIGPROF, which this platform lacks");
+#endif
+    timerInterval = intervalUs;
+  }
+
+  void allocateSamples(ThreadRing& ring) {
+    ring.ownedSamples = zc::heap<SampleTable>();
+    std::atomic_signal_fence(std::memory_order_release);
+    ring.samples.store(ring.ownedSamples.get(), std::memory_order_relaxed);
+  }
+
+  ThreadRing& getRing() {
+    if (ZC_UNLIKELY(currentRing == nullptr)) {
+      auto locked = rings.lockExclusive();
+      const auto threadId = static_cast<uint32_t>(locked->size() + 1);
+      currentRing = locked->add(
+          zc::heap<ThreadRing>(threadId, ringCapacity.load(std::memory_order_relaxed))).get();
+    }
+    return *currentRing;
+  }
+
+  uint32_t intern(zc::StringPtr text) {
+    ThreadRing& ring = getRing();
+    ZC_IF_SOME(id, ring.ids.find(text)) { return id; }
+
+    auto locked = names.lockExclusive();
+    uint32_t id;
+    ZC_IF_SOME(existing, locked->ids.find(text)) {
+      id = existing;
+    } else {
+      const zc::String& copy = locked->texts.add(zc::heapString(text));
+      id = static_cast<uint32_t>(locked->texts.size());
+      locked->ids.insert(copy, id);
+    }
+    ring.ids.insert(locked->texts[id - 1], id);
+    return id;
   }
 
-  uint32_t getCurrentThreadId() const {
-    std::thread::id tid = std::this_thread::get_id();
-    return std::hash<std::thread::id>{}(tid);
+  void record(TraceEventType type, TraceCategory category, uint32_t nameId, uint32_t detailsId,
+              uint64_t value = 0, bool hasValue = false) {
+    ThreadRing& ring = getRing();
+    const uint64_t index = ring.head.load(std::memory_order_relaxed);
+    ring.ring[index & (ring.ring.size() - 1)] =
+        TraceEvent{now(),    value, nameId, detailsId, ring.depth.load(std::memory_order_relaxed),
+                   category, type,  hasValue};
+    ring.head.store(index + 1, std::memory_order_release);
   }
 
-  uint32_t getDepthForThread(uint32_t threadId) const {
-    auto locked = threadDepths.lockShared();
-    ZC_IF_SOME(depth, locked->find(threadId)) { return depth; }
-    return 0;
+  bool wantsHardwareCounters(TraceCategory category) const {
+    return config.mode == TraceMode::kEvents &&
+           (static_cast<uint32_t>(config.hardwareCounterMask) & static_cast<uint32_t>(category)) !=
+               0;
   }
 
-  void setDepthForThread(uint32_t threadId, uint32_t depth) {
-    auto locked = threadDepths.lockExclusive();
-    locked->upsert(threadId, depth);
+  zc::Maybe<HardwareCounters&> getHardwareCounters(ThreadRing& ring) {
+    if (!ring.countersOpened) {
+      ring.countersOpened = true;
+      ring.counters = HardwareCounters::open();
+      ZC_IF_SOME(counters, ring.counters) {
+        for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+          counters->nameIds[i] = intern(kHardwareCounterNames[i]);
+        }
+      }
+      else {
+        static std::atomic<bool> warned{false};
+        if (!warned.exchange(true, std::memory_order_relaxed)) {
+          ZC_LOG(WARNING, "hardware counters are unavailable; tracing without them");
+        }
+      }
+    }
+    ZC_IF_SOME(counters, ring.counters) { return *counters; }
+    return zc::none;
+  }
+
+  /// Copy the events of every thread, leaving them in place
+  zc::Vector<ThreadEvents> snapshot() const {
+    zc::Vector<ThreadEvents> result;
+    auto locked = rings.lockShared();
+    for (const zc::Own<ThreadRing>& ring : *locked) {
+      const uint64_t end = ring->head.load(std::memory_order_acquire);
+      const uint64_t begin = ring->firstReadable(end);
+      const uint64_t mask = ring->ring.size() - 1;
+      ThreadEvents copied{ring->threadId, {}};
+      copied.events.reserve(end - begin);
+      for (uint64_t i = begin; i < end; ++i) { copied.events.add(ring->ring[i & mask]); }
+
+      // The owner may be overwriting the slot after `head` while we copy
+      std::atomic_thread_fence(std::memory_order_acquire);
+      const uint64_t after = ring->head.load(std::memory_order_relaxed) + 1;
+      const uint64_t overwritten = after > ring->ring.size() ? after - ring->ring.size() : 0;
+      if (overwritten > begin) {
+        const size_t drop = zc::min(overwritten - begin, copied.events.size());
+        ThreadEvents kept{ring->threadId, {}};
+        kept.events.addAll(copied.events.asPtr().slice(drop));
+        copied = zc::mv(kept);
+      }
+      if (!copied.events.empty()) { result.add(zc::mv(copied)); }
+    }
+    return result;
+  }
+
+  void clearEvents(bool resetDepths) {
+    auto locked = rings.lockExclusive();
+    for (zc::Own<ThreadRing>& ring : *locked) {
+      ring->start.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+      if (resetDepths) { ring->depth.store(0, std::memory_order_relaxed); }
+    }
+  }
+
+  zc::String formatEventAsJson(const TraceEvent& event, uint32_t threadId,
+                               const Names& names) const {
+    // Convert timestamp from nanoseconds to microseconds (Chrome format)
+    const uint64_t timestampUs = event.timestamp / 1000;
+
+    zc::String baseJson = zc::str(
+        "  {", "\"name\":\"", basic::escapeJsonString(names.texts[event.nameId - 1]), "\",",
+        "\"cat\":\"", getCategoryName(event.category), "\",", "\"ph\":\"", getPhase(event.type),
+        "\",", "\"ts\":", timestampUs, ",", "\"pid\":1,", "\"tid\":", threadId);
+
+    // A hardware counter adds to the track of its scope, as a series named after the counter
+    if (event.hasValue) {
+      return zc::str(baseJson, ",\"args\":{\"",
+                     basic::escapeJsonString(names.texts[event.detailsId - 1]),
+                     "\":", event.value, "}}");
+    }
+
+    // Add details if present
+    if (event.detailsId != 0) {
+      return zc::str(baseJson, ",\"args\":{\"details\":\"",
+                     basic::escapeJsonString(names.texts[event.detailsId - 1]), "\"}}");
+    }
+
+    return zc::str(baseJson, "}");
+  }
+
+  zc::String generateChromeTracingJson(zc::ArrayPtr<const ThreadEvents> threads) const {
+    zc::Vector<char> json;
+    json.addAll(zc::StringPtr("{\"traceEvents\":[\n"));
+
+    auto locked = names.lockShared();
+    bool first = true;
+    for (const ThreadEvents& thread : threads) {
+      for (const TraceEvent& event : thread.events) {
+        if (!first) { json.addAll(zc::StringPtr(",\n")); }
+        first = false;
+        json.addAll(formatEventAsJson(event, thread.threadId, *locked));
+      }
+    }
+
+    json.addAll(zc::StringPtr("\n]}"));
+    return zc::str(json.releaseAsArray());
+  }
+
+  zc::Maybe<zc::Exception> writeTraceToFile(zc::StringPtr filename,
+                                            zc::StringPtr content) const {
+    return zc::runCatchingExceptions([&]() {
+      auto fs = zc::newDiskFilesystem();
+
+      // Use Path::eval to handle both absolute and relative paths correctly
+      zc::Path outputPath = zc::Path(nullptr).eval(filename);
+      auto file = fs->getCurrent().openFile(
+          outputPath, zc::WriteMode::CREATE | zc::WriteMode::MODIFY | zc::WriteMode::CREATE_PARENT);
+      file->writeAll(content);
+      file->datasync();
+    });
   }
 };
 
@@ -94,11 +491,19 @@ TraceManager& TraceManager::getInstance() {
 void TraceManager::configure(const TraceConfig& config) {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  zc::Locked<zc::Vector<TraceEvent>> lock = impl->events.lockExclusive();
   impl->config = config;
+  impl->ringCapacity.store(roundUpToPowerOfTwo(zc::max(config.maxEvents, size_t(1))),
+                           std::memory_order_relaxed);
+  _::activeCategoryMask.store(config.enabled ? static_cast<uint32_t>(config.categoryMask) : 0,
+                              std::memory_order_relaxed);
 
   // Clear existing events if disabled
-  if (!config.enabled) { lock->clear(); }
+  if (!config.enabled) { impl->clearEvents(false); }
+
+  const uint32_t interval = config.enabled && config.mode == TraceMode::kSampling
+                                ? zc::max(config.samplingIntervalUs, 1u)
+                                : 0;
+  if (interval != impl->timerInterval) { impl->setSamplingTimer(interval); }
 }
 
 bool TraceManager::isEnabled(TraceCategory category) const {
@@ -109,193 +514,180 @@ bool TraceManager::isEnabled(TraceCategory category) const {
   return (static_cast<uint32_t>(impl->config.categoryMask) & static_cast<uint32_t>(category)) != 0;
 }
 
+uint32_t TraceManager::intern(zc::StringPtr text) {
+  ZC_REQUIRE(impl.get() != nullptr);
+  return impl->intern(text);
+}
+
 void TraceManager::addEvent(TraceEventType type, TraceCategory category, zc::StringPtr name,
                             zc::StringPtr details) {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  if (!isEnabled(category)) { return; }
+  if (!isEnabled(category) || impl->config.mode != TraceMode::kEvents) { return; }
 
-  zc::Locked<zc::Vector<TraceEvent>> lock = impl->events.lockExclusive();
+  impl->record(type, category, impl->intern(name), details != nullptr ? impl->intern(details) : 0);
+}
 
-  // Check if we've exceeded the maximum number of events
-  if (lock->size() >= impl->config.maxEvents) {
-    // Remove oldest events (simple FIFO)
-    size_t removeCount = lock->size() / 10;  // Remove 10%
-    // Move remaining events to front and truncate
-    for (size_t i = removeCount; i < lock->size(); ++i) {
-      (*lock)[i - removeCount] = zc::mv((*lock)[i]);
-    }
-    lock->truncate(lock->size() - removeCount);
-  }
+void TraceManager::addEvent(TraceEventType type, TraceCategory category, uint32_t nameId,
+                            uint32_t detailsId) {
+  ZC_REQUIRE(impl.get() != nullptr);
 
-  // Get current depth
-  uint32_t depth = getCurrentDepth();
+  if (!isEnabled(category) || impl->config.mode != TraceMode::kEvents) { return; }
 
-  lock->add(TraceEvent(type, category, name, details, depth));
+  impl->record(type, category, nameId, detailsId);
 }
 
-void TraceManager::flush() {
+void TraceManager::enterScope(TraceCategory category, uint32_t nameId, uint32_t detailsId) {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  zc::Locked<zc::Vector<TraceEvent>> lock = impl->events.lockExclusive();
+  ThreadRing& ring = impl->getRing();
+  if (impl->config.mode == TraceMode::kSampling &&
+      ring.samples.load(std::memory_order_relaxed) == nullptr) {
+    impl->allocateSamples(ring);
+  }
 
-  if (impl->config.outputFile != nullptr) {
-    ZC_IF_SOME(exception, writeTraceToFile(impl->config.outputFile, *lock)) {
-      ZC_LOG(ERROR, "Failed to write trace file", impl->config.outputFile, exception);
+  // The profiling signal handler reads the stack on this thread, up to the published depth
+  const uint32_t depth = ring.depth.load(std::memory_order_relaxed);
+  if (depth < kMaxSampledDepth) { ring.stack[depth] = nameId; }
+  std::atomic_signal_fence(std::memory_order_release);
+  ring.depth.store(depth + 1, std::memory_order_relaxed);
+
+  addEvent(TraceEventType::kEnter, category, nameId, detailsId);
+
+  // Read last, so that the scope's counts leave out the recording of its entry
+  if (depth < kMaxSampledDepth && impl->wantsHardwareCounters(category)) {
+    ZC_IF_SOME(counters, impl->getHardwareCounters(ring)) {
+      counters.started[depth] = counters.read(counters.starts[depth]);
     }
   }
 }
 
-zc::Maybe<zc::Exception> TraceManager::writeTraceToFile(zc::StringPtr filename,
-                                                        const zc::Vector<TraceEvent>& events) {
-  // Create Chrome tracing JSON format
-  zc::String json = generateChromeTracingJson(events);
-
-  // Write to file using zc::runCatchingExceptions for proper error handling
-  return zc::runCatchingExceptions([&]() {
-    // Use zc filesystem to write the file
-    auto fs = zc::newDiskFilesystem();
-
-    // Use Path::eval to handle both absolute and relative paths correctly
-    zc::Path outputPath = zc::Path(nullptr).eval(filename);
-    auto file = fs->getCurrent().openFile(
-        outputPath, zc::WriteMode::CREATE | zc::WriteMode::MODIFY | zc::WriteMode::CREATE_PARENT);
-    file->writeAll(json);
-    file->datasync();
-  });
-}
-
-zc::String TraceManager::generateChromeTracingJson(const zc::Vector<TraceEvent>& events) {
-  zc::Vector<char> json;
-
-  // Start JSON array
-  json.addAll(zc::StringPtr("{\"traceEvents\":[\n"));
+void TraceManager::exitScope(TraceCategory category, uint32_t nameId, uint32_t detailsId) {
+  ZC_REQUIRE(impl.get() != nullptr);
 
-  bool first = true;
-  for (const auto& event : events) {
-    if (!first) { json.addAll(zc::StringPtr(",\n")); }
-    first = false;
+  // Read first, for the same reason as on entry
+  ThreadRing& ring = impl->getRing();
+  const uint32_t depth = ring.depth.load(std::memory_order_relaxed);
+  uint64_t ends[kHardwareCounterCount];
+  zc::Maybe<HardwareCounters&> counted;
+  if (depth > 0 && depth <= kMaxSampledDepth) {
+    ZC_IF_SOME(counters, ring.counters) {
+      if (counters->started[depth - 1] && counters->read(ends)) { counted = *counters; }
+      counters->started[depth - 1] = false;
+    }
+  }
 
-    // Convert event to Chrome tracing format
-    zc::String eventJson = formatEventAsJson(event);
-    json.addAll(eventJson);
+  addEvent(TraceEventType::kExit, category, nameId, detailsId);
+  ZC_IF_SOME(counters, counted) {
+    if (isEnabled(category)) {
+      for (size_t i = 0; i < kHardwareCounterCount; ++i) {
+        impl->record(TraceEventType::kCounter, category, nameId, counters.nameIds[i],
+                     ends[i] - counters.starts[depth - 1][i], true);
+      }
+    }
   }
+  decrementDepth();
+}
 
-  // End JSON
-  json.addAll(zc::StringPtr("\n]}"));
+void TraceManager::flush() {
+  ZC_REQUIRE(impl.get() != nullptr);
 
-  return zc::str(json.releaseAsArray());
+  if (impl->config.outputFile != nullptr) {
+    zc::String content;
+    if (impl->config.mode == TraceMode::kSampling) {
+      content = getFoldedStacks();
+    } else {
+      // Only the copy holds the lock; threads keep recording while the JSON is built and written
+      zc::Vector<ThreadEvents> threads = impl->snapshot();
+      content = impl->generateChromeTracingJson(threads);
+    }
+    ZC_IF_SOME(exception, impl->writeTraceToFile(impl->config.outputFile, content)) {
+      ZC_LOG(ERROR, "Failed to write trace file", impl->config.outputFile, exception);
+    }
+  }
 }
 
-zc::String TraceManager::formatEventAsJson(const TraceEvent& event) {
-  // Map our event types to Chrome tracing format
-  const char* phase;
-  switch (event.type) {
-    case TraceEventType::kEnter:
-      phase = "B";  // Begin
-      break;
-    case TraceEventType::kExit:
-      phase = "E";  // End
-      break;
-    case TraceEventType::kInstant:
-      phase = "i";  // Instant
-      break;
-    case TraceEventType::kCounter:
-      phase = "C";  // Counter
-      break;
-    case TraceEventType::kMetadata:
-      phase = "M";  // Metadata
-      break;
-    default:
-      phase = "i";
-      break;
-  }
+zc::String TraceManager::getFoldedStacks() const {
+  ZC_REQUIRE(impl.get() != nullptr);
 
-  // Convert category to string
-  const char* categoryStr;
-  switch (event.category) {
-    case TraceCategory::kLexer:
-      categoryStr = "lexer";
-      break;
-    case TraceCategory::kParser:
-      categoryStr = "parser";
-      break;
-    case TraceCategory::kChecker:
-      categoryStr = "checker";
-      break;
-    case TraceCategory::kDriver:
-      categoryStr = "driver";
-      break;
-    case TraceCategory::kDiagnostics:
-      categoryStr = "diagnostics";
-      break;
-    case TraceCategory::kMemory:
-      categoryStr = "memory";
-      break;
-    case TraceCategory::kPerformance:
-      categoryStr = "performance";
-      break;
-    default:
-      categoryStr = "unknown";
-      break;
+  zc::HashMap<zc::String, uint64_t> counts;
+  uint64_t dropped = 0;
+  {
+    auto lockedRings = impl->rings.lockShared();
+    auto lockedNames = impl->names.lockShared();
+    for (const zc::Own<ThreadRing>& ring : *lockedRings) {
+      const SampleTable* samples = ring->samples.load(std::memory_order_acquire);
+      if (samples == nullptr) { continue; }
+      dropped += samples->dropped.load(std::memory_order_relaxed);
+
+      for (const SampleTable::Slot& slot : samples->slots) {
+        const uint32_t count = slot.count.load(std::memory_order_acquire);
+        if (count == 0) { continue; }
+
+        zc::Vector<char> stack;
+        for (uint32_t i = 0; i < slot.depth; ++i) {
+          if (i > 0) { stack.add(';'); }
+          // Separators inside a name would split it into frames
+          for (char c : lockedNames->texts[samples->arena[slot.offset + i] - 1]) {
+            stack.add(c == ';' || c == '\n' ? '_' : c);
+          }
+        }
+        counts.upsert(zc::str(stack.releaseAsArray()), count,
+                      [](uint64_t& existing, uint64_t added) { existing += added; });
+      }
+    }
   }
 
-  // Convert timestamp from nanoseconds to microseconds (Chrome format)
-  uint64_t timestampUs = event.timestamp / 1000;
+  zc::Vector<const zc::HashMap<zc::String, uint64_t>::Entry*> entries;
+  for (const auto& entry : counts) { entries.add(&entry); }
+  std::sort(entries.begin(), entries.end(),
+            [](const auto* a, const auto* b) { return a->key < b->key; });
 
-  // Build JSON object
-  zc::String baseJson =
-      zc::str("  {", "\"name\":\"", basic::escapeJsonString(event.name), "\",", "\"cat\":\"",
-              categoryStr, "\",", "\"ph\":\"", phase, "\",", "\"ts\":", timestampUs, ",",
-              "\"pid\":1,", "\"tid\":", event.threadId);
-
-  // Add details if present
-  if (event.details.size() > 0) {
-    return zc::str(baseJson, ",\"args\":{\"details\":\"", basic::escapeJsonString(event.details),
-                   "\"}}");
+  zc::Vector<char> result;
+  for (const auto* entry : entries) {
+    result.addAll(zc::str(entry->key, ' ', entry->value, '\n'));
   }
-
-  return zc::str(baseJson, "}");
+  if (dropped > 0) { result.addAll(zc::str("[dropped samples] ", dropped, '\n')); }
+  return zc::str(result.releaseAsArray());
 }
 
 uint32_t TraceManager::getCurrentDepth() const {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  uint32_t threadId = impl->getCurrentThreadId();
-  return impl->getDepthForThread(threadId);
+  if (currentRing == nullptr) { return 0; }
+  return currentRing->depth.load(std::memory_order_relaxed);
 }
 
 void TraceManager::incrementDepth() {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  uint32_t threadId = impl->getCurrentThreadId();
-  uint32_t currentDepth = impl->getDepthForThread(threadId);
-  impl->setDepthForThread(threadId, currentDepth + 1);
+  std::atomic<uint32_t>& depth = impl->getRing().depth;
+  depth.store(depth.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
 }
 
 void TraceManager::decrementDepth() {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  uint32_t threadId = impl->getCurrentThreadId();
-  uint32_t currentDepth = impl->getDepthForThread(threadId);
-  if (currentDepth > 0) { impl->setDepthForThread(threadId, currentDepth - 1); }
+  std::atomic<uint32_t>& depth = impl->getRing().depth;
+  const uint32_t currentDepth = depth.load(std::memory_order_relaxed);
+  if (currentDepth > 0) { depth.store(currentDepth - 1, std::memory_order_relaxed); }
 }
 
 void TraceManager::clear() {
   ZC_REQUIRE(impl.get() != nullptr);
-
-  zc::Locked<zc::Vector<TraceEvent>> lock = impl->events.lockExclusive();
-  lock->clear();
-
-  auto depthLock = impl->threadDepths.lockExclusive();
-  depthLock->clear();
+  impl->clearEvents(true);
 }
 
 size_t TraceManager::getEventCount() const {
   ZC_REQUIRE(impl.get() != nullptr);
 
-  auto lock = impl->events.lockShared();
-  return lock->size();
+  size_t count = 0;
+  auto locked = impl->rings.lockShared();
+  for (const zc::Own<ThreadRing>& ring : *locked) {
+    const uint64_t end = ring->head.load(std::memory_order_acquire);
+    count += end - ring->firstReadable(end);
+  }
+  return count;
 }
 
 uint32_t TraceManager::getMaxRecursionDepth() const {
@@ -311,7 +703,7 @@ constexpr bool kTraceEnabled = ZOM_TRACE_ENABLED;
 
 void traceEvent(TraceCategory category, zc::StringPtr name, zc::StringPtr details) {
   if constexpr (kTraceEnabled) {
-    if (TraceManager::getInstance().isEnabled(category)) {
+    if (isCategoryActive(category)) {
       TraceManager::getInstance().addEvent(TraceEventType::kInstant, category, name, details);
     }
   }
@@ -319,78 +711,38 @@ void traceEvent(TraceCategory category, zc::StringPtr name, zc::StringPtr detail
 
 void traceCounter(TraceCategory category, zc::StringPtr name, zc::StringPtr details) {
   if constexpr (kTraceEnabled) {
-    if (TraceManager::getInstance().isEnabled(category)) {
+    if (isCategoryActive(category)) {
       TraceManager::getInstance().addEvent(TraceEventType::kCounter, category, name, details);
     }
   }
 }
 
-// ================================================================================
-// ScopeTracer::Impl
-
-struct ScopeTracer::Impl {
-  bool enabled;
-  TraceCategory category;
-  zc::String name;
-  zc::String details;
-
-  Impl(TraceCategory cat, zc::StringPtr n, zc::StringPtr d)
-      : enabled(false), category(cat), name(zc::str(n)) {
-    if (d != nullptr) { details = zc::str(d); }
-
-    if constexpr (kTraceEnabled) {
-      if (TraceManager::getInstance().isEnabled(category)) {
-        // Check recursion depth before incrementing
-        uint32_t currentDepth = TraceManager::getInstance().getCurrentDepth();
-        uint32_t maxDepth = TraceManager::getInstance().getMaxRecursionDepth();
-
-        if (currentDepth >= maxDepth) {
-          ZC_FAIL_REQUIRE("Trace recursion depth exceeded maximum limit", currentDepth,
-                          ">=", maxDepth, "category:", static_cast<uint32_t>(category),
-                          "name:", name);
-        }
-
-        enabled = true;
-        TraceManager::getInstance().incrementDepth();
-        TraceManager::getInstance().addEvent(TraceEventType::kEnter, category, name, details);
-      }
-    }
-  }
-
-  ~Impl() {
-    if constexpr (kTraceEnabled) {
-      if (enabled) {
-        TraceManager::getInstance().addEvent(TraceEventType::kExit, category, name, details);
-        TraceManager::getInstance().decrementDepth();
-      }
-    }
-  }
-};
-
 // ================================================================================
 // ScopeTracer
 
-ScopeTracer::ScopeTracer(TraceCategory category, zc::StringPtr name, zc::StringPtr details) noexcept
-    : impl(zc::heap<Impl>(category, name, details)) {}
-
-ScopeTracer::~ScopeTracer() noexcept(false) = default;
-
-// ================================================================================
-// FunctionTracer::Impl
-
-struct FunctionTracer::Impl {
-  ScopeTracer scopeTracer;
-
-  Impl(TraceCategory category, zc::StringPtr functionName) : scopeTracer(category, functionName) {}
-};
+void ScopeTracer::begin(zc::StringPtr n, zc::StringPtr d) noexcept {
+  if constexpr (kTraceEnabled) {
+    // Check recursion depth before incrementing
+    uint32_t currentDepth = TraceManager::getInstance().getCurrentDepth();
+    uint32_t maxDepth = TraceManager::getInstance().getMaxRecursionDepth();
 
-// ================================================================================
-// FunctionTracer
+    if (currentDepth >= maxDepth) {
+      ZC_FAIL_REQUIRE("Trace recursion depth exceeded maximum limit", currentDepth, ">=", maxDepth,
+                      "category:", static_cast<uint32_t>(category), "name:", n);
+    }
 
-FunctionTracer::FunctionTracer(TraceCategory category, zc::StringPtr functionName)
-    : impl(zc::heap<Impl>(category, functionName)) {}
+    active = true;
+    nameId = TraceManager::getInstance().intern(n);
+    if (d != nullptr) { detailsId = TraceManager::getInstance().intern(d); }
+    TraceManager::getInstance().enterScope(category, nameId, detailsId);
+  }
+}
 
-FunctionTracer::~FunctionTracer() = default;
+void ScopeTracer::end() {
+  if constexpr (kTraceEnabled) {
+    TraceManager::getInstance().exitScope(category, nameId, detailsId);
+  }
+}
 
 }  // namespace trace
 }  // namespace compiler
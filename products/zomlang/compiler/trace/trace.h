@@ -14,13 +14,13 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 
 #include "zc/core/common.h"
-#include "zc/core/exception.h"
 #include "zc/core/memory.h"
 #include "zc/core/string.h"
-#include "zc/core/vector.h"
+#include "zomlang/compiler/trace/trace-config.h"
 
 namespace zomlang {
 namespace compiler {
@@ -48,32 +48,51 @@ enum class TraceCategory : uint32_t {
   kAll = 0xFFFFFFFF,
 };
 
+/// What enabled tracing records
+enum class TraceMode : uint8_t {
+  /// Every scope entry and exit, and every instant and counter event
+  kEvents = 0,
+  /// Only the stack of trace scopes a thread is in, sampled on a timer of process CPU time
+  kSampling,
+};
+
 /// Trace configuration
 struct TraceConfig {
   bool enabled = false;
   TraceCategory categoryMask = TraceCategory::kAll;
-  size_t maxEvents = 1000000;  // Maximum events to store
+  TraceMode mode = TraceMode::kEvents;
+  /// Interval of the profiling timer in `kSampling` mode, in microseconds of CPU time
+  uint32_t samplingIntervalUs = 1000;
+  /// Events kept per thread; once a thread's ring is full, its oldest events are overwritten.
+  /// Takes effect for threads that record their first event afterwards.
+  size_t maxEvents = ZOM_TRACE_BUFFER_SIZE;
   bool enableTimestamps = true;
   bool enableThreadInfo = true;
   zc::StringPtr outputFile = nullptr;
   uint32_t maxRecursionDepth = 1000;  // Maximum recursion depth to prevent stack overflow
+  /// Scopes of these categories also record the instructions, cycles, cache misses and branch
+  /// misses of their thread between entry and exit, as `kCounter` events at their exit. Linux
+  /// only, through perf_event_open; a thread the kernel refuses counters traces without them.
+  TraceCategory hardwareCounterMask = TraceCategory::kNone;
 };
 
-/// Individual trace event
+/// Individual trace event, as kept in the ring of the thread that recorded it. Names and details
+/// are interned, so recording copies no strings.
 struct TraceEvent {
-  TraceEventType type;
+  uint64_t timestamp;  // Nanoseconds on the steady clock
+  uint64_t value;      // Of a hardware counter event, whose details name the counter
+  uint32_t nameId;
+  uint32_t detailsId;  // 0 without details
+  uint32_t depth;      // Call stack depth
   TraceCategory category;
-  zc::String name;
-  zc::String details;
-  uint64_t timestamp;  // Nanoseconds since epoch
-  uint32_t threadId;
-  uint32_t depth;  // Call stack depth
-
-  TraceEvent(TraceEventType t, TraceCategory cat, zc::StringPtr n, zc::StringPtr d = nullptr,
-             uint32_t dep = 0) noexcept;
+  TraceEventType type;
+  bool hasValue;
 };
 
 /// Main trace manager - singleton pattern
+///
+/// Each thread records into a fixed-size ring of its own, without locks; the rings are only read
+/// by `flush()` and `getEventCount()`, which can run while other threads keep recording.
 class TraceManager {
 public:
   static TraceManager& getInstance();
@@ -84,13 +103,31 @@ public:
   /// Check if tracing is enabled for a category
   bool isEnabled(TraceCategory category) const;
 
+  /// Id naming `text` in events, the same for equal text on every thread. Never 0.
+  uint32_t intern(zc::StringPtr text);
+
   /// Add trace event
   void addEvent(TraceEventType type, TraceCategory category, zc::StringPtr name,
                 zc::StringPtr details = nullptr);
+  /// Add trace event with interned name and details, `detailsId` being 0 for none
+  void addEvent(TraceEventType type, TraceCategory category, uint32_t nameId, uint32_t detailsId);
+
+  /// Enter or leave a trace scope of the calling thread: adjust its depth and the scope stack that
+  /// sampling reads, and record `kEnter`/`kExit` events when recording events.
+  void enterScope(TraceCategory category, uint32_t nameId, uint32_t detailsId);
+  void exitScope(TraceCategory category, uint32_t nameId, uint32_t detailsId);
 
-  /// Flush events to output
+  /// Write what was recorded so far to the configured file and keep it: events in Chrome tracing
+  /// JSON format, or samples as folded stacks in `kSampling` mode.
   void flush();
 
+  /// Samples taken so far as folded stacks, the input format of flame graph tools: one line per
+  /// distinct stack, outermost scope first, names separated by ';' and followed by a space and the
+  /// number of samples. Lines are sorted; stacks of all threads are merged.
+  ///
+  /// Samples accumulate from the first time sampling is enabled; `clear()` leaves them.
+  zc::String getFoldedStacks() const;
+
   /// Get current call depth for thread
   uint32_t getCurrentDepth() const;
 
@@ -98,7 +135,8 @@ public:
   void incrementDepth();
   void decrementDepth();
 
-  /// Clear all events
+  /// Clear all events, and the call depth of every thread. Meant for when no thread is inside a
+  /// traced scope.
   void clear();
 
   /// Get event count
@@ -113,23 +151,29 @@ private:
 
   ZC_DISALLOW_COPY_AND_MOVE(TraceManager);
 
-  /// Write trace events to file in Chrome tracing JSON format
-  /// Returns zc::none on success, or the exception on failure
-  zc::Maybe<zc::Exception> writeTraceToFile(zc::StringPtr filename,
-                                            const zc::Vector<TraceEvent>& events);
+  struct Impl;
+  zc::Own<Impl> impl;
+};
 
-  /// Generate Chrome tracing JSON from events
-  zc::String generateChromeTracingJson(const zc::Vector<TraceEvent>& events);
+namespace _ {  // private
 
-  /// Format single event as JSON
-  zc::String formatEventAsJson(const TraceEvent& event);
+/// Category mask of the active configuration, or 0 while tracing is off. Mirrored here by
+/// `TraceManager::configure()` so the hot-path check is a single relaxed load that touches neither
+/// the singleton nor its lock.
+extern std::atomic<uint32_t> activeCategoryMask;
 
-  /// Escape string for JSON
-  zc::String escapeJsonString(zc::StringPtr str);
+}  // namespace _
 
-  struct Impl;
-  zc::Own<Impl> impl;
-};
+/// Cheap check for whether events of `category` are currently recorded. Always false when
+/// tracing is compiled out.
+inline bool isCategoryActive(TraceCategory category) {
+  if constexpr (ZOM_TRACE_ENABLED) {
+    return ZC_UNLIKELY((_::activeCategoryMask.load(std::memory_order_relaxed) &
+                        static_cast<uint32_t>(category)) != 0);
+  } else {
+    return false;
+  }
+}
 
 /// Trace event function
 void traceEvent(TraceCategory category, zc::StringPtr name, zc::StringPtr details = nullptr);
@@ -138,32 +182,93 @@ void traceEvent(TraceCategory category, zc::StringPtr name, zc::StringPtr detail
 void traceCounter(TraceCategory category, zc::StringPtr name, zc::StringPtr details = nullptr);
 
 /// Scope tracer with RAII
+///
+/// Construction and destruction are inline and only test the cached category mask, so an inactive
+/// tracer costs a load and a branch; names are interned and events recorded only while active.
 class ScopeTracer {
 public:
   explicit ScopeTracer(TraceCategory category, zc::StringPtr name,
-                       zc::StringPtr details = nullptr) noexcept;
-  ~ScopeTracer() noexcept(false);
+                       zc::StringPtr details = nullptr) noexcept
+      : category(category) {
+    if (isCategoryActive(category)) { begin(name, details); }
+  }
+  ~ScopeTracer() noexcept(false) {
+    if (ZC_UNLIKELY(active)) { end(); }
+  }
 
   ZC_DISALLOW_COPY_AND_MOVE(ScopeTracer);
 
 private:
-  struct Impl;
-  zc::Own<Impl> impl;
+  TraceCategory category;
+  bool active = false;
+  uint32_t nameId = 0;
+  uint32_t detailsId = 0;
+
+  void begin(zc::StringPtr name, zc::StringPtr details) noexcept;
+  void end();
 };
 
 /// Function tracer helper
 class FunctionTracer {
 public:
-  explicit FunctionTracer(TraceCategory category, zc::StringPtr functionName);
-  ~FunctionTracer();
+  explicit FunctionTracer(TraceCategory category, zc::StringPtr functionName)
+      : scopeTracer(category, functionName) {}
 
   ZC_DISALLOW_COPY_AND_MOVE(FunctionTracer);
 
 private:
-  struct Impl;
-  zc::Own<Impl> impl;
+  ScopeTracer scopeTracer;
 };
 
 }  // namespace trace
 }  // namespace compiler
 }  // namespace zomlang
+
+// ================================================================================
+// Trace macros
+//
+// Preferred over the classes above in compiler code: with ZOM_TRACE_ENABLED set to 0 they expand
+// to nothing and their arguments are not evaluated.
+
+#if ZOM_TRACE_ENABLED
+
+#define ZOM_TRACE_CATEGORY_ENABLED(category) \
+  (::zomlang::compiler::trace::isCategoryActive(category))
+
+#define ZOM_TRACE_SCOPE(category, name, ...)                              \
+  ::zomlang::compiler::trace::ScopeTracer ZC_UNIQUE_NAME(_zomTraceScope)( \
+      category, name, ##__VA_ARGS__)
+
+#define ZOM_TRACE_FUNCTION(category) ZOM_TRACE_SCOPE(category, __FUNCTION__)
+
+#define ZOM_TRACE_EVENT(category, name, ...)                                 \
+  do {                                                                       \
+    if (ZOM_TRACE_CATEGORY_ENABLED(category)) {                              \
+      ::zomlang::compiler::trace::traceEvent(category, name, ##__VA_ARGS__); \
+    }                                                                        \
+  } while (false)
+
+#define ZOM_TRACE_COUNTER(category, name, value)                                  \
+  do {                                                                            \
+    if (ZOM_TRACE_CATEGORY_ENABLED(category)) {                                   \
+      ::zomlang::compiler::trace::traceCounter(category, name, ::zc::str(value)); \
+    }                                                                             \
+  } while (false)
+
+#else
+
+#define ZOM_TRACE_CATEGORY_ENABLED(category) false
+#define ZOM_TRACE_SCOPE(category, name, ...) \
+  do {                                       \
+  } while (false)
+#define ZOM_TRACE_FUNCTION(category) \
+  do {                               \
+  } while (false)
+#define ZOM_TRACE_EVENT(category, name, ...) \
+  do {                                       \
+  } while (false)
+#define ZOM_TRACE_COUNTER(category, name, value) \
+  do {                                           \
+  } while (false)
+
+#endif
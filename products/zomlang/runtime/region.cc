@@ -0,0 +1,66 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/runtime/region.h"
+
+#include "zc/core/debug.h"
+
+namespace zomlang {
+namespace runtime {
+
+// ================================================================================
+// Region
+
+Region::Region(size_t chunkSizeHint)
+    : depth(0), arena(zc::ArenaChunkPool::getGlobal(), chunkSizeHint) {}
+
+Region::Region(Region& parent, size_t chunkSizeHint)
+    : parent(parent), depth(parent.depth + 1),
+      arena(zc::ArenaChunkPool::getGlobal(), chunkSizeHint) {}
+
+Region::~Region() noexcept(false) {}
+
+bool Region::outlives(const Region& other) const {
+  // Only an ancestor can be as shallow as this region, so walk `other` up to this depth.
+  if (other.depth < depth) { return false; }
+  const Region* region = &other;
+  while (region->depth > depth) { region = &ZC_ASSERT_NONNULL(region->parent); }
+  return region == this;
+}
+
+// ================================================================================
+// RegionScope
+
+namespace {
+
+thread_local Region* currentRegion = nullptr;
+
+}  // namespace
+
+RegionScope::RegionScope(Region& region) noexcept : previous(getCurrentRegion()) {
+  currentRegion = &region;
+}
+
+RegionScope::~RegionScope() noexcept {
+  currentRegion = nullptr;
+  ZC_IF_SOME(region, previous) { currentRegion = &region; }
+}
+
+zc::Maybe<Region&> getCurrentRegion() {
+  if (currentRegion == nullptr) { return zc::none; }
+  return *currentRegion;
+}
+
+}  // namespace runtime
+}  // namespace zomlang
@@ -0,0 +1,111 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/arena.h"
+#include "zc/core/common.h"
+
+namespace zomlang {
+namespace runtime {
+
+/// \brief Memory for the values of one task, such as a request, freed all at once when it ends.
+///
+/// Allocation bumps a pointer in the region's current chunk and nothing is freed on its own;
+/// destroying or resetting the region runs the destructors of what it holds and gives its chunks
+/// back to the process-wide `zc::ArenaChunkPool`, where the next task's region picks them up.
+///
+/// Regions form a tree: a task's region has the region of the task that spawned it as parent,
+/// and must be destroyed first. A value the task hands back, or stores into something the parent
+/// owns, escapes its region and has to be promoted into the parent's with `promote()`; values
+/// that stay inside the task are never copied. Like `zc::Arena`, a region is used by one thread
+/// at a time.
+class Region {
+public:
+  /// \brief A root region, for values that live as long as the program or its caller.
+  explicit Region(size_t chunkSizeHint = 1024);
+  /// \brief A region for a task running under the one owning `parent`.
+  explicit Region(Region& parent, size_t chunkSizeHint = 1024);
+  ~Region() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(Region);
+
+  /// \brief Allocate an object or array in the region. Non-trivial destructors are run when the
+  /// region is reset or destroyed, in reverse order of allocation.
+  template <typename T, typename... Params>
+  T& allocate(Params&&... params) {
+    return arena.allocate<T>(zc::fwd<Params>(params)...);
+  }
+  template <typename T>
+  zc::ArrayPtr<T> allocateArray(size_t size) {
+    return arena.allocateArray<T>(size);
+  }
+  template <typename T>
+  T& copy(T&& value) {
+    return arena.copy(zc::fwd<T>(value));
+  }
+
+  /// \brief Copy `value`, which escapes this region, into the region it escapes to: the parent,
+  /// or this region itself at the root.
+  template <typename T>
+  T& promote(T&& value) {
+    return getEscapeRegion().copy(zc::fwd<T>(value));
+  }
+
+  /// \brief The parent, or this region at the root.
+  Region& getEscapeRegion() {
+    ZC_IF_SOME(p, parent) { return p; }
+    return *this;
+  }
+  zc::Maybe<Region&> getParent() { return parent; }
+  /// \brief Zero at the root, one for its tasks, and so on.
+  uint getDepth() const { return depth; }
+
+  /// \brief Whether values in this region live at least as long as those in `other`, i.e. this is
+  /// `other` or one of its ancestors. A value of `other` may refer to one of this region without
+  /// promoting it only if so.
+  bool outlives(const Region& other) const;
+
+  /// \brief Free everything allocated so far, keeping the largest chunk for reuse, e.g. between
+  /// requests served by one long-lived task.
+  void reset() { arena.reset(); }
+
+  /// \brief Bytes of the chunks the region holds, which is its peak footprint since the last
+  /// `reset()`.
+  size_t getChunkBytes() const { return arena.getChunkBytes(); }
+
+private:
+  zc::Maybe<Region&> parent;
+  uint depth;
+  zc::Arena arena;
+};
+
+/// \brief Make `region` the current one on this thread, e.g. while a task runs. Scopes nest,
+/// restoring the previous region on exit.
+class RegionScope {
+public:
+  explicit RegionScope(Region& region) noexcept;
+  ~RegionScope() noexcept;
+
+  ZC_DISALLOW_COPY_AND_MOVE(RegionScope);
+
+private:
+  zc::Maybe<Region&> previous;
+};
+
+/// \brief Get the region of the task running on this thread, if any.
+zc::Maybe<Region&> getCurrentRegion();
+
+}  // namespace runtime
+}  // namespace zomlang
@@ -0,0 +1,117 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/runtime/string.h"
+
+#include "zc/core/debug.h"
+
+namespace zomlang {
+namespace runtime {
+
+// ================================================================================
+// Str
+
+Str Str::makeInline(zc::ArrayPtr<const char> chars) {
+  Str result;
+  memcpy(result.bytes, chars.begin(), chars.size());
+  result.bytes[15] = static_cast<char>(chars.size());
+  return result;
+}
+
+Str Str::makeOutOfLine(Kind kind, const char* pointer, size_t length, uint depth) {
+  ZC_REQUIRE(length <= UINT32_MAX, "string too long", length);
+  ZC_REQUIRE(depth <= UINT16_MAX, "regions nested too deeply", depth);
+  const uint32_t length32 = static_cast<uint32_t>(length);
+  const uint16_t depth16 = static_cast<uint16_t>(depth);
+
+  Str result;
+  memcpy(result.bytes, &pointer, sizeof(pointer));
+  memcpy(result.bytes + 8, &length32, sizeof(length32));
+  memcpy(result.bytes + 12, &depth16, sizeof(depth16));
+  result.bytes[15] = static_cast<char>(static_cast<uint8_t>(kind) << kKindShift);
+  return result;
+}
+
+Str Str::make(Region& region, zc::ArrayPtr<const char> chars) {
+  if (chars.size() <= kInlineCapacity) { return makeInline(chars); }
+  auto copy = region.allocateArray<char>(chars.size());
+  memcpy(copy.begin(), chars.begin(), chars.size());
+  return makeOutOfLine(Kind::REGION, copy.begin(), copy.size(), region.getDepth());
+}
+
+Str Str::fromStatic(zc::StringPtr chars) {
+  if (chars.size() <= kInlineCapacity) { return makeInline(chars.asArray()); }
+  return makeOutOfLine(Kind::STATIC, chars.begin(), chars.size());
+}
+
+Str Str::concat(Region& region, const Str& a, const Str& b) {
+  if (b.empty()) { return a; }
+  if (a.empty()) { return b; }
+
+  auto left = a.asArray();
+  auto right = b.asArray();
+  const size_t size = left.size() + right.size();
+  if (size <= kInlineCapacity) {
+    Str result = makeInline(left);
+    memcpy(result.bytes + left.size(), right.begin(), right.size());
+    result.bytes[15] = static_cast<char>(size);
+    return result;
+  }
+
+  auto chars = region.allocateArray<char>(size);
+  memcpy(chars.begin(), left.begin(), left.size());
+  memcpy(chars.begin() + left.size(), right.begin(), right.size());
+  return makeOutOfLine(Kind::REGION, chars.begin(), size, region.getDepth());
+}
+
+Str Str::escapeTo(Region& target) const {
+  if (getKind() != Kind::REGION || getDepth() <= target.getDepth()) { return *this; }
+  return make(target, asArray());
+}
+
+// ================================================================================
+// Interner
+
+Interner::Interner() {}
+
+Interner::~Interner() noexcept(false) {}
+
+Str Interner::intern(zc::ArrayPtr<const char> chars) {
+  if (chars.size() <= Str::kInlineCapacity) { return Str::makeInline(chars); }
+
+  auto lock = state.lockExclusive();
+  ZC_IF_SOME(existing, lock->strings.find(chars)) {
+    return Str::makeOutOfLine(Str::Kind::INTERNED, existing.begin(), existing.size());
+  }
+
+  auto copy = lock->arena.allocateArray<char>(chars.size());
+  memcpy(copy.begin(), chars.begin(), chars.size());
+  lock->strings.insert(copy.asConst());
+  return Str::makeOutOfLine(Str::Kind::INTERNED, copy.begin(), copy.size());
+}
+
+Str Interner::intern(const Str& str) {
+  if (str.isInline() || str.isInterned()) { return str; }
+  return intern(str.asArray());
+}
+
+size_t Interner::size() const { return state.lockShared()->strings.size(); }
+
+Interner& Interner::getGlobal() {
+  static Interner* interner = new Interner();
+  return *interner;
+}
+
+}  // namespace runtime
+}  // namespace zomlang
@@ -0,0 +1,151 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "zc/core/arena.h"
+#include "zc/core/common.h"
+#include "zc/core/map.h"
+#include "zc/core/mutex.h"
+#include "zc/core/string.h"
+#include "zomlang/runtime/region.h"
+
+namespace zomlang {
+namespace runtime {
+
+/// \brief String value of zomlang programs, 16 bytes and passed by value.
+///
+/// Strings of up to `kInlineCapacity` bytes are kept inside the value itself, so most keys,
+/// names and small fields of a request take no allocation and compare as two words. Longer
+/// strings point at their bytes, which live in one of:
+///
+/// - a `Region`, for strings built by a task. They are copied by `escapeTo()` when they outlive
+///   it; the value records the depth of its region to tell.
+/// - static storage, for literals of the program, which are never copied.
+/// - an `Interner`, for strings kept for the rest of the program, which are never copied and
+///   compare by pointer to each other.
+///
+/// Bytes are not NUL-terminated.
+class Str {
+public:
+  static constexpr size_t kInlineCapacity = 15;
+
+  /// \brief The empty string.
+  Str() noexcept { memset(bytes, 0, sizeof(bytes)); }
+
+  /// \brief `chars`, inline if short enough and copied into `region` otherwise.
+  static Str make(Region& region, zc::ArrayPtr<const char> chars);
+  /// \brief `chars`, which must live as long as the program, such as a literal.
+  static Str fromStatic(zc::StringPtr chars);
+  /// \brief `a` followed by `b`, allocated in `region` if not short enough to be inline.
+  static Str concat(Region& region, const Str& a, const Str& b);
+
+  size_t size() const { return isInline() ? tag() & kSizeMask : getLength(); }
+  bool empty() const { return size() == 0; }
+  zc::ArrayPtr<const char> asArray() const {
+    if (isInline()) { return zc::arrayPtr(bytes, tag() & kSizeMask); }
+    return zc::arrayPtr(getPointer(), getLength());
+  }
+
+  bool isInline() const { return getKind() == Kind::INLINE; }
+  bool isInterned() const { return getKind() == Kind::INTERNED; }
+
+  bool operator==(const Str& other) const {
+    // Short strings are always inline and zero-padded, so inline strings are equal exactly when
+    // their bytes are, and never equal to one that is not inline.
+    if (isInline() || other.isInline()) { return memcmp(bytes, other.bytes, sizeof(bytes)) == 0; }
+    if (getPointer() == other.getPointer()) { return getLength() == other.getLength(); }
+    return asArray() == other.asArray();
+  }
+  bool operator==(zc::StringPtr other) const { return asArray() == other.asArray(); }
+
+  uint hashCode() const { return zc::hashCode(asArray()); }
+
+  /// \brief This string, made to live as long as values of `target`. Only strings in a region
+  /// deeper than `target` are copied, into `target`.
+  ///
+  /// Relies on values only flowing between a region and its ancestors: a task sees strings of
+  /// its own region and those of its ancestors, and promotes what it hands back.
+  Str escapeTo(Region& target) const;
+
+private:
+  enum class Kind : uint8_t { INLINE, REGION, STATIC, INTERNED };
+
+  static constexpr uint8_t kSizeMask = 0x0f;
+  static constexpr uint kKindShift = 6;
+
+  // Inline, the bytes come first. Otherwise bytes [0, 8) hold the pointer, [8, 12) the length and
+  // [12, 14) the region depth. The last byte is the tag, with the kind in the top bits and the
+  // size of an inline string in the bottom ones.
+  alignas(8) char bytes[16];
+
+  uint8_t tag() const { return static_cast<uint8_t>(bytes[15]); }
+  Kind getKind() const { return static_cast<Kind>(tag() >> kKindShift); }
+
+  const char* getPointer() const {
+    const char* pointer;
+    memcpy(&pointer, bytes, sizeof(pointer));
+    return pointer;
+  }
+  uint32_t getLength() const {
+    uint32_t length;
+    memcpy(&length, bytes + 8, sizeof(length));
+    return length;
+  }
+  uint16_t getDepth() const {
+    uint16_t depth;
+    memcpy(&depth, bytes + 12, sizeof(depth));
+    return depth;
+  }
+
+  static Str makeInline(zc::ArrayPtr<const char> chars);
+  static Str makeOutOfLine(Kind kind, const char* pointer, size_t length, uint depth = 0);
+
+  friend class Interner;
+};
+
+/// \brief Strings kept for the rest of the program, one copy per distinct text.
+///
+/// Interning costs a hash lookup under a lock, so it suits strings that are compared or used as
+/// keys many times, such as header names or enum-like values. Strings short enough to be inline
+/// are returned as they are, without taking the lock.
+class Interner {
+public:
+  Interner();
+  ~Interner() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(Interner);
+
+  Str intern(zc::ArrayPtr<const char> chars);
+  Str intern(const Str& str);
+
+  /// \brief Number of strings held, inline ones not included.
+  size_t size() const;
+
+  /// \brief The process-wide interner. It is never destroyed.
+  static Interner& getGlobal();
+
+private:
+  struct State {
+    zc::Arena arena;
+    zc::HashSet<zc::ArrayPtr<const char>> strings;
+  };
+  zc::MutexGuarded<State> state;
+};
+
+}  // namespace runtime
+}  // namespace zomlang
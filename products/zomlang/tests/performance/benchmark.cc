@@ -0,0 +1,238 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/tests/performance/benchmark.h"
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "zc/core/debug.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/vector.h"
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};
+
+void* allocate(size_t size) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(size == 0 ? 1 : size)) { return p; }
+  throw std::bad_alloc();
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+  allocationCount.fetch_add(1, std::memory_order_relaxed);
+  const size_t align = static_cast<size_t>(alignment);
+  // aligned_alloc() wants a multiple of the alignment
+  if (void* p = std::aligned_alloc(align, (std::max(size, size_t(1)) + align - 1) & ~(align - 1))) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+}  // namespace
+
+// Every allocation of the benchmark executables goes through these, so that a benchmark can count
+// the allocations of the work it times.
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) {
+  return allocateAligned(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+  return allocateAligned(size, alignment);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+namespace {
+
+size_t countLines(zc::StringPtr text) {
+  size_t lines = 0;
+  for (char c : text) { lines += c == '\n'; }
+  return lines;
+}
+
+/// Functions whose bodies nest blocks and parenthesised expressions 48 deep.
+zc::String makeDeepNesting() {
+  constexpr size_t kDepth = 48;
+  zc::Vector<zc::String> parts;
+  for (size_t i = 0; i < 64; ++i) {
+    parts.add(zc::str("fun nested", i, "(x: i32) -> i32 {\n"));
+    for (size_t depth = 1; depth <= kDepth; ++depth) {
+      parts.add(zc::str(zc::repeat(' ', depth * 2), "if (x > ", depth, ") {\n"));
+    }
+    parts.add(zc::str(zc::repeat(' ', kDepth * 2 + 2), "return ", zc::repeat('(', kDepth), "x"));
+    for (size_t depth = 0; depth < kDepth; ++depth) { parts.add(zc::str(" + ", depth, ")")); }
+    parts.add(zc::str(";\n"));
+    for (size_t depth = kDepth; depth >= 1; --depth) {
+      parts.add(zc::str(zc::repeat(' ', depth * 2), "}\n"));
+    }
+    parts.add(zc::str("  return 0;\n}\n"));
+  }
+  return zc::strArray(parts, "");
+}
+
+/// Long string, template, numeric and array literals.
+zc::String makeHugeLiterals() {
+  zc::Vector<zc::String> parts;
+  for (size_t i = 0; i < 16; ++i) {
+    parts.add(zc::str("let text", i, " = \"", zc::repeat('a', 64 * 1024), "\";\n"));
+    parts.add(zc::str("let template", i, " = `", zc::repeat('b', 16 * 1024), "${text", i, "}",
+                      zc::repeat('c', 16 * 1024), "`;\n"));
+    parts.add(zc::str("let number", i, " = ", zc::repeat('7', 4096), ";\n"));
+    zc::Vector<zc::String> elements;
+    for (size_t element = 0; element < 4096; ++element) {
+      elements.add(zc::str(element * 7919, ".", element));
+    }
+    parts.add(zc::str("let numbers", i, " = [", zc::strArray(elements, ", "), "];\n"));
+  }
+  return zc::strArray(parts, "");
+}
+
+/// Thousands of small top-level declarations.
+zc::String makeWideModule() {
+  zc::Vector<zc::String> parts;
+  for (size_t i = 0; i < 4000; ++i) {
+    parts.add(zc::str("let constant", i, ": i32 = ", i, ";\n"));
+    parts.add(zc::str("fun function", i, "(a: i32, b: str) -> i32 {\n",
+                      "  let value = a + constant", i, ";\n", "  return value * 2;\n}\n"));
+    if (i % 8 == 0) {
+      parts.add(zc::str("class Type", i, " {\n  public let field: i32;\n\n",
+                        "  public fun get() -> i32 {\n    return this.field;\n  }\n}\n"));
+    }
+  }
+  return zc::strArray(parts, "");
+}
+
+/// Generic functions and interfaces over nested generic types.
+zc::String makeGenericsHeavy() {
+  zc::Vector<zc::String> parts;
+  for (size_t i = 0; i < 1000; ++i) {
+    parts.add(zc::str("interface Container", i, "<T> {\n", "  fun get(index: i32) -> T;\n",
+                      "  fun map<U>(f: (x: T) -> U) -> Container", i, "<U>;\n}\n"));
+    parts.add(zc::str("fun transform", i, "<K, V, R>(", "entries: Map<K, List<Pair<K, V>>>, ",
+                      "f: <T>(x: T) -> R raises Err) -> Map<K, List<R>>? {\n",
+                      "  let result: Map<K, List<R>>? = null;\n", "  return result;\n}\n"));
+  }
+  return zc::strArray(parts, "");
+}
+
+void collectLanguageTests(const zc::ReadableDirectory& dir, zc::Vector<zc::String>& parts) {
+  zc::Array<zc::ReadableDirectory::Entry> entries = dir.listEntries();
+  std::sort(entries.begin(), entries.end());
+  for (const auto& entry : entries) {
+    if (entry.type == zc::FsNode::Type::DIRECTORY) {
+      // Code that is meant to be rejected is not what compiles in practice
+      if (entry.name != "errors") {
+        collectLanguageTests(*dir.openSubdir(zc::Path(zc::heapString(entry.name))), parts);
+      }
+    } else if (entry.name.endsWith(".zom")) {
+      const zc::String text = dir.openFile(zc::Path(zc::heapString(entry.name)))->readAllText();
+      // Leave out the RUN and CHECK lines, which outweigh the code
+      for (zc::ArrayPtr<const char> rest = text.asArray(); rest.size() > 0;) {
+        const char* newline = std::find(rest.begin(), rest.end(), '\n');
+        const size_t length = newline == rest.end() ? rest.size() : newline - rest.begin() + 1;
+        const zc::ArrayPtr<const char> line = rest.first(length);
+        if (!zc::StringPtr(line.begin(), length).startsWith("//")) {
+          parts.add(zc::heapString(line));
+        }
+        rest = rest.slice(length);
+      }
+      parts.add(zc::str("\n"));
+    }
+  }
+}
+
+/// The language tests, repeated to a size worth timing.
+zc::String makeRealWorld() {
+  zc::Vector<zc::String> parts;
+  auto filesystem = zc::newDiskFilesystem();
+  collectLanguageTests(
+      *filesystem->getRoot().openSubdir(filesystem->getCurrentPath().evalNative(
+          ZOM_LANGUAGE_TESTS_DIR)),
+      parts);
+  const zc::String once = zc::strArray(parts, "");
+  zc::Vector<zc::String> copies;
+  for (size_t i = 0; i < 20; ++i) { copies.add(zc::heapString(once)); }
+  return zc::strArray(copies, "");
+}
+
+zc::Array<Corpus> makeCorpora() {
+  auto corpora = zc::heapArrayBuilder<Corpus>(5);
+  auto add = [&](zc::StringPtr name, zc::String text) {
+    const size_t lines = countLines(text);
+    corpora.add(Corpus{name, zc::mv(text), lines});
+  };
+  add("deep-nesting"_zc, makeDeepNesting());
+  add("huge-literals"_zc, makeHugeLiterals());
+  add("wide-module"_zc, makeWideModule());
+  add("generics-heavy"_zc, makeGenericsHeavy());
+  add("real-world"_zc, makeRealWorld());
+  return corpora.finish();
+}
+
+}  // namespace
+
+zc::ArrayPtr<const Corpus> getCorpora() {
+  static const zc::Array<Corpus> corpora = makeCorpora();
+  return corpora;
+}
+
+uint64_t getAllocationCount() { return allocationCount.load(std::memory_order_relaxed); }
+
+void Meter::report() const {
+  ZC_REQUIRE(runs > 0, "nothing was timed", component, inputName);
+  const double seconds = static_cast<double>(elapsed / zc::NANOSECONDS) / 1e9;
+  const double megabytesPerSecond =
+      static_cast<double>(bytes) * static_cast<double>(runs) / 1e6 / seconds;
+  const double allocationsPerLine =
+      static_cast<double>(allocations) / static_cast<double>(runs * std::max(lines, size_t(1)));
+
+  const zc::String line = zc::str(component, " ", inputName, ": ", megabytesPerSecond,
+                                  " MB/s, ", allocationsPerLine, " allocations/line over ", runs,
+                                  " runs\n");
+  zc::FdOutputStream(STDOUT_FILENO).write(line.asBytes());
+
+  if (const char* resultsFile = std::getenv(kResultsFileEnv)) {
+    const zc::String json = zc::str(
+        "{\"component\":\"", component, "\",\"corpus\":\"", inputName,
+        "\",\"megabytesPerSecond\":", megabytesPerSecond, ",\"allocationsPerLine\":",
+        allocationsPerLine, ",\"runs\":", runs, "}\n");
+    auto filesystem = zc::newDiskFilesystem();
+    filesystem->getRoot()
+        .appendFile(filesystem->getCurrentPath().evalNative(resultsFile),
+                    zc::WriteMode::CREATE | zc::WriteMode::MODIFY)
+        ->write(json.asBytes());
+  }
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
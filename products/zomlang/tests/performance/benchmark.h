@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/time.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+/// \brief Environment variable naming a file that every benchmark appends its result to, as one
+/// JSON object per line, for comparing runs against a baseline.
+constexpr char kResultsFileEnv[] = "ZOM_BENCHMARK_RESULTS";
+
+/// \brief A source text that benchmarks run over.
+struct Corpus {
+  zc::StringPtr name;
+  zc::String text;
+  size_t lines;
+};
+
+/// \brief The corpora every benchmark runs over: synthetic ones that each stress one dimension
+/// (deep nesting, huge literals, wide modules, generics-heavy code), and the language tests
+/// concatenated as real-world code. Built on first use.
+zc::ArrayPtr<const Corpus> getCorpora();
+
+/// \brief Heap allocations made by the process so far, through any form of `operator new`.
+uint64_t getAllocationCount();
+
+/// \brief Measures the work a benchmark times over its input, and reports its throughput and
+/// allocations.
+///
+/// Only what runs inside `time()` counts, so that a benchmark can prepare each run, e.g. parse
+/// the tree a binder run needs, outside of it.
+class Meter {
+public:
+  Meter(zc::StringPtr component, const Corpus& corpus)
+      : Meter(component, corpus.name, corpus.text.size(), corpus.lines) {}
+  /// Over input that is not a single corpus, such as a program of several files
+  Meter(zc::StringPtr component, zc::StringPtr inputName, size_t bytes, size_t lines)
+      : component(component), inputName(inputName), bytes(bytes), lines(lines) {}
+
+  ZC_DISALLOW_COPY_AND_MOVE(Meter);
+
+  /// Run `func` once as one pass over the corpus.
+  template <typename Func>
+  void time(Func&& func) {
+    const uint64_t allocationsBefore = getAllocationCount();
+    const auto start = std::chrono::steady_clock::now();
+    func();
+    const auto end = std::chrono::steady_clock::now();
+    allocations += getAllocationCount() - allocationsBefore;
+    elapsed += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() *
+               zc::NANOSECONDS;
+    ++runs;
+  }
+
+  /// Print the throughput in MB/s and the allocations per line of the runs so far, and append
+  /// them to the file named by `kResultsFileEnv` if it is set.
+  void report() const;
+
+private:
+  zc::StringPtr component;
+  zc::StringPtr inputName;
+  size_t bytes;
+  size_t lines;
+  zc::Duration elapsed = 0 * zc::NANOSECONDS;
+  uint64_t allocations = 0;
+  size_t runs = 0;
+};
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,57 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/binder/binder.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+#include "zomlang/compiler/symbol/symbol-table.h"
+#include "zomlang/tests/performance/benchmark.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+ZC_TEST("benchmark: Binder") {
+  const basic::LangOptions langOpts;
+  for (const Corpus& corpus : getCorpora()) {
+    source::SourceManager sourceManager;
+    const source::BufferId bufferId =
+        sourceManager.addMemBufferCopy(corpus.text.asBytes(), corpus.name);
+    Meter meter("Binder"_zc, corpus);
+    doBenchmark([&]() {
+      // Binding records symbols on the tree, so every run binds a tree of its own
+      diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+      basic::StringPool stringPool;
+      parser::Parser parser(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+      zc::Own<ast::Node> tree = ZC_ASSERT_NONNULL(parser.parse());
+      symbol::SymbolTable symbolTable;
+      meter.time([&]() {
+        binder::Binder binder(symbolTable, diagnosticEngine);
+        binder.bindSourceFile(ast::cast<ast::SourceFile>(*tree));
+      });
+    });
+    meter.report();
+  }
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,60 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include <unistd.h>
+
+#include "zc/core/filesystem.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/driver/driver.h"
+#include "zomlang/tests/performance/benchmark.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+ZC_TEST("benchmark: CompilerDriver") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-driver-benchmark-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  const basic::LangOptions langOpts;
+  const basic::CompilerOptions compilerOpts;
+  for (const Corpus& corpus : getCorpora()) {
+    const zc::Path path = root.append(zc::str(corpus.name, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(corpus.text);
+    const zc::String file = path.toString(true);
+
+    Meter meter("CompilerDriver"_zc, corpus);
+    doBenchmark([&]() {
+      // From reading the file to its symbols, as `zomc compile` does
+      meter.time([&]() {
+        driver::CompilerDriver driver(langOpts, compilerOpts);
+        ZC_ASSERT(driver.addSourceFile(file) != zc::none);
+        driver.parseAndBindSources();
+      });
+    });
+    meter.report();
+  }
+
+  rootDir.remove(root);
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/basic/frontend.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/lexer/outline-scan.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+#include "zomlang/tests/performance/benchmark.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+ZC_TEST("benchmark: Parser") {
+  const basic::LangOptions langOpts;
+  for (const Corpus& corpus : getCorpora()) {
+    source::SourceManager sourceManager;
+    const source::BufferId bufferId =
+        sourceManager.addMemBufferCopy(corpus.text.asBytes(), corpus.name);
+    Meter meter("Parser"_zc, corpus);
+    doBenchmark([&]() {
+      diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+      basic::StringPool stringPool;
+      zc::Maybe<zc::Own<ast::Node>> tree;
+      // Lexing happens as the parser asks for tokens, so it is part of the time
+      meter.time([&]() {
+        parser::Parser parser(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+        tree = parser.parse();
+      });
+      ZC_ASSERT(tree != zc::none);
+    });
+    meter.report();
+  }
+}
+
+// What editor requests that only need the declarations pay instead of the parse above
+ZC_TEST("benchmark: Outline") {
+  const basic::LangOptions langOpts;
+  for (const Corpus& corpus : getCorpora()) {
+    source::SourceManager sourceManager;
+    const source::BufferId bufferId =
+        sourceManager.addMemBufferCopy(corpus.text.asBytes(), corpus.name);
+    Meter meter("Outline"_zc, corpus);
+    doBenchmark([&]() {
+      diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+      basic::StringPool stringPool;
+      meter.time([&]() {
+        lexer::Outline outline =
+            basic::performOutline(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+        ZC_ASSERT(!outline.entries.empty());
+      });
+    });
+    meter.report();
+  }
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,126 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <stdlib.h>
+
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/benchmark.h"
+#include "zomlang/runtime/region.h"
+#include "zomlang/runtime/string.h"
+
+namespace zomlang {
+namespace runtime {
+namespace {
+
+/// A node of the object graph a request builds and drops, such as a parsed header list.
+struct Node {
+  Node* next;
+  uint64_t value;
+};
+
+constexpr uint kNodeCount = 1000;
+
+ZC_BENCHMARK("Request allocation") {
+  benchmark.setItemsPerIteration(kNodeCount);
+
+  benchmark.run("malloc", [&]() {
+    Node* head = nullptr;
+    for (uint i = 0; i < kNodeCount; i++) {
+      Node* node = static_cast<Node*>(malloc(sizeof(Node)));
+      *node = Node{head, i};
+      head = node;
+    }
+    zc::doNotOptimize(head);
+    while (head != nullptr) {
+      Node* next = head->next;
+      free(head);
+      head = next;
+    }
+  });
+
+  benchmark.run("region", [&]() {
+    Region region;
+    Node* head = nullptr;
+    for (uint i = 0; i < kNodeCount; i++) { head = &region.allocate<Node>(Node{head, i}); }
+    zc::doNotOptimize(head);
+  });
+
+  // A long-lived task serving one request after another.
+  Region task;
+  benchmark.run("region/reset", [&]() {
+    Node* head = nullptr;
+    for (uint i = 0; i < kNodeCount; i++) { head = &task.allocate<Node>(Node{head, i}); }
+    zc::doNotOptimize(head);
+    task.reset();
+  });
+}
+
+constexpr zc::StringPtr kFields[] = {"host"_zc, "accept-encoding"_zc, "user-agent"_zc,
+                                     "x-request-id"_zc, "content-type"_zc,
+                                     "a header value too long to be stored inline"_zc};
+
+ZC_BENCHMARK("Request strings") {
+  benchmark.setItemsPerIteration(kNodeCount);
+
+  benchmark.run("zc::String", [&]() {
+    zc::Vector<zc::String> strings(kNodeCount);
+    for (uint i = 0; i < kNodeCount; i++) {
+      strings.add(zc::heapString(kFields[i % zc::size(kFields)]));
+    }
+    zc::doNotOptimize(strings);
+  });
+
+  benchmark.run("Str", [&]() {
+    Region region;
+    auto strings = region.allocateArray<Str>(kNodeCount);
+    for (uint i = 0; i < kNodeCount; i++) {
+      strings[i] = Str::make(region, kFields[i % zc::size(kFields)].asArray());
+    }
+    zc::doNotOptimize(strings);
+  });
+}
+
+ZC_BENCHMARK("String comparison") {
+  Region region;
+  auto& interner = Interner::getGlobal();
+  const auto text = "a header value too long to be stored inline"_zc;
+  Str built = Str::make(region, text.asArray());
+  Str copy = Str::make(region, text.asArray());
+  Str interned = interner.intern(built);
+  Str internedAgain = interner.intern(copy);
+  benchmark.setItemsPerIteration(kNodeCount);
+
+  benchmark.run("bytes", [&]() {
+    uint equal = 0;
+    for (uint i = 0; i < kNodeCount; i++) {
+      zc::doNotOptimize(built);
+      equal += built == copy;
+    }
+    zc::doNotOptimize(equal);
+  });
+
+  benchmark.run("interned", [&]() {
+    uint equal = 0;
+    for (uint i = 0; i < kNodeCount; i++) {
+      zc::doNotOptimize(interned);
+      equal += interned == internedAgain;
+    }
+    zc::doNotOptimize(equal);
+  });
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace zomlang
@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include <unistd.h>
+
+#include <algorithm>
+
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/driver/driver.h"
+#include "zomlang/tests/performance/benchmark.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+namespace {
+
+/// A program written by tests/tools/gen-program.py, one of a series growing in size.
+struct GeneratedProgram {
+  zc::String name;
+  zc::Vector<zc::String> files;
+  size_t bytes = 0;
+  size_t lines = 0;
+};
+
+zc::Vector<GeneratedProgram> loadGeneratedPrograms() {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().evalNative(ZOM_SCALING_PROGRAMS_DIR);
+  auto programsDir = filesystem->getRoot().openSubdir(root);
+
+  zc::Vector<GeneratedProgram> programs;
+  zc::Array<zc::String> names = programsDir->listNames();
+  // Named so that this is increasing size
+  std::sort(names.begin(), names.end());
+  for (const zc::String& name : names) {
+    const zc::Path programPath = root.append(name);
+    auto programDir = filesystem->getRoot().openSubdir(programPath);
+    if (!programDir->exists(zc::Path("m0.zom"))) { continue; }
+
+    GeneratedProgram program;
+    program.name = zc::heapString(name);
+    for (const zc::String& file : programDir->listNames()) {
+      if (!file.endsWith(".zom")) { continue; }
+      const zc::String text = programDir->openFile(zc::Path(zc::heapString(file)))->readAllText();
+      program.bytes += text.size();
+      program.lines += std::count(text.begin(), text.end(), '\n');
+      program.files.add(programPath.append(file).toString(true));
+    }
+    programs.add(zc::mv(program));
+  }
+  return programs;
+}
+
+}  // namespace
+
+ZC_TEST("benchmark: CompilerDriver over growing programs") {
+  const basic::LangOptions langOpts;
+  basic::CompilerOptions compilerOpts;
+  compilerOpts.emission.timeReportEnabled = true;
+
+  const zc::Vector<GeneratedProgram> programs = loadGeneratedPrograms();
+  ZC_ASSERT(programs.size() > 0, "no generated programs", ZOM_SCALING_PROGRAMS_DIR);
+  for (const GeneratedProgram& program : programs) {
+    zc::Vector<zc::StringPtr> files;
+    for (const zc::String& file : program.files) { files.add(file); }
+
+    // Throughput that falls as programs grow shows work superlinear in their size
+    Meter meter("CompilerDriver"_zc, program.name, program.bytes, program.lines);
+    driver::TimeReport report;
+    doBenchmark([&]() {
+      meter.time([&]() {
+        driver::CompilerDriver driver(langOpts, compilerOpts);
+        driver.addSourceFiles(files);
+        driver.parseAndBindSources();
+        report = driver.getTimeReport();
+      });
+    });
+    meter.report();
+
+    const double lines = static_cast<double>(std::max(program.lines, size_t(1)));
+    const zc::String memory =
+        zc::str("CompilerDriver ", program.name, ": ", program.files.size(), " files, ",
+                static_cast<double>(report.astBytes) / lines, " AST bytes/line, ",
+                static_cast<double>(report.internedBytes) / lines, " string bytes/line, ",
+                report.symbols, " symbols\n");
+    zc::FdOutputStream(STDOUT_FILENO).write(memory.asBytes());
+  }
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
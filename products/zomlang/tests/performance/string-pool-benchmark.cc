@@ -0,0 +1,64 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/tests/performance/benchmark.h"
+
+namespace zomlang {
+namespace compiler {
+namespace performance {
+
+namespace {
+
+bool isIdentifierChar(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+/// The identifier-like words of `text`, in order, which is what the lexer interns.
+zc::Vector<zc::ArrayPtr<const char>> splitWords(zc::StringPtr text) {
+  zc::Vector<zc::ArrayPtr<const char>> words;
+  const char* start = nullptr;
+  for (const char& c : text) {
+    if (isIdentifierChar(c)) {
+      if (start == nullptr) { start = &c; }
+    } else if (start != nullptr) {
+      words.add(zc::arrayPtr(start, &c));
+      start = nullptr;
+    }
+  }
+  if (start != nullptr) { words.add(zc::arrayPtr(start, text.end())); }
+  return words;
+}
+
+}  // namespace
+
+ZC_TEST("benchmark: StringPool") {
+  for (const Corpus& corpus : getCorpora()) {
+    const zc::Vector<zc::ArrayPtr<const char>> words = splitWords(corpus.text);
+    Meter meter("StringPool"_zc, corpus);
+    doBenchmark([&]() {
+      basic::StringPool stringPool;
+      meter.time([&]() {
+        for (const zc::ArrayPtr<const char> word : words) { stringPool.intern(word); }
+      });
+    });
+    meter.report();
+  }
+}
+
+}  // namespace performance
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+"""
+Synthetic program generator for ZomLang scaling tests.
+
+This tool writes a multi-module ZOM program of a chosen shape, so that frontend
+time and memory can be measured as functions of input size. The output only
+depends on the parameters and the seed.
+"""
+
+import argparse
+import random
+import sys
+from pathlib import Path
+from typing import List
+
+
+class ProgramShape:
+    """Parameters of a generated program."""
+
+    def __init__(
+        self,
+        modules: int,
+        functions: int,
+        depth: int,
+        fanout: int,
+        generic_density: float,
+        seed: int,
+    ):
+        self.modules = modules
+        self.functions = functions
+        self.depth = depth
+        self.fanout = fanout
+        self.generic_density = generic_density
+        self.seed = seed
+
+
+class ProgramGenerator:
+    """Generates the modules of a program of a given shape."""
+
+    def __init__(self, shape: ProgramShape):
+        self.shape = shape
+        self.random = random.Random(shape.seed)
+
+    def module_name(self, index: int) -> str:
+        return f"gen.m{index}"
+
+    def imported_modules(self, index: int) -> List[int]:
+        """Earlier modules that module `index` imports, so that imports never cycle."""
+        count = min(self.shape.fanout, index)
+        return sorted(self.random.sample(range(index), count))
+
+    def generate_function(self, index: int, imports: List[int]) -> List[str]:
+        generic = self.random.random() < self.shape.generic_density
+        if generic:
+            lines = [f"fun f{index}<T, U>(x: i32, value: T, pairs: Map<T, List<U>>) -> T {{"]
+        else:
+            lines = [f"fun f{index}(x: i32, name: str) -> i32 {{"]
+        lines.append("  let total = x;")
+
+        indent = "  "
+        for level in range(self.shape.depth):
+            keyword = "if" if level % 2 == 0 else "while"
+            lines.append(f"{indent}{keyword} (total > {level}) {{")
+            indent += "  "
+            lines.append(f"{indent}total = total - {level + 1};")
+
+        # Calls into imported modules, and into this module's earlier functions
+        for imported in imports:
+            callee = self.random.randrange(self.shape.functions)
+            lines.append(f"{indent}total = total + m{imported}.f{callee}(total, \"call\");")
+        if index > 0:
+            lines.append(f"{indent}total = total + f{index - 1}(total, \"local\");")
+
+        for _ in range(self.shape.depth):
+            indent = indent[:-2]
+            lines.append(f"{indent}}}")
+
+        lines.append("  return value;" if generic else "  return total;")
+        lines.append("}")
+        return lines
+
+    def generate_module(self, index: int) -> str:
+        imports = self.imported_modules(index)
+        lines = [f"module {self.module_name(index)};", ""]
+        for imported in imports:
+            lines.append(f"import {self.module_name(imported)} as m{imported};")
+        if imports:
+            lines.append("")
+
+        if self.random.random() < self.shape.generic_density:
+            lines.extend(
+                [
+                    f"interface Container{index}<T> {{",
+                    "  fun get(index: i32) -> T;",
+                    f"  fun map<U>(f: (x: T) -> U) -> Container{index}<U>;",
+                    "}",
+                    "",
+                ]
+            )
+
+        for function in range(self.shape.functions):
+            lines.extend(self.generate_function(function, imports))
+            lines.append("")
+        return "\n".join(lines)
+
+    def write(self, output_dir: Path) -> List[Path]:
+        output_dir.mkdir(parents=True, exist_ok=True)
+        paths = []
+        for index in range(self.shape.modules):
+            path = output_dir / f"m{index}.zom"
+            path.write_text(self.generate_module(index), encoding="utf-8")
+            paths.append(path)
+        return paths
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Generate a synthetic multi-module ZomLang program for scaling tests"
+    )
+    parser.add_argument("output_dir", help="Directory to write the modules to")
+    parser.add_argument("--modules", type=int, default=16, help="Number of modules")
+    parser.add_argument(
+        "--functions", type=int, default=32, help="Functions per module"
+    )
+    parser.add_argument(
+        "--depth", type=int, default=4, help="Nesting depth of each function body"
+    )
+    parser.add_argument(
+        "--fanout",
+        type=int,
+        default=4,
+        help="Earlier modules each module imports and calls into",
+    )
+    parser.add_argument(
+        "--generic-density",
+        type=float,
+        default=0.25,
+        help="Fraction of functions and modules that are generic, from 0 to 1",
+    )
+    parser.add_argument("--seed", type=int, default=1, help="Random seed")
+
+    args = parser.parse_args()
+
+    if args.modules < 1 or args.functions < 1 or args.depth < 0 or args.fanout < 0:
+        print("Error: modules and functions must be positive, depth and fanout non-negative")
+        sys.exit(1)
+    if not 0.0 <= args.generic_density <= 1.0:
+        print("Error: --generic-density must be between 0 and 1")
+        sys.exit(1)
+
+    shape = ProgramShape(
+        args.modules,
+        args.functions,
+        args.depth,
+        args.fanout,
+        args.generic_density,
+        args.seed,
+    )
+    paths = ProgramGenerator(shape).write(Path(args.output_dir))
+    total_bytes = sum(path.stat().st_size for path in paths)
+    print(f"Wrote {len(paths)} modules, {total_bytes} bytes, to {args.output_dir}")
+
+
+if __name__ == "__main__":
+    main()
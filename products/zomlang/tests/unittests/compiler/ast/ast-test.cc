@@ -17,6 +17,8 @@
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/factory.h"
 #include "zomlang/compiler/ast/kinds.h"
+#include "zomlang/compiler/ast/type.h"
+#include "zomlang/compiler/source/location.h"
 
 namespace zomlang {
 namespace compiler {
@@ -422,6 +424,28 @@ ZC_TEST("TokenNode.DotDotDotToken") {
   ZC_EXPECT(token->getKind() == SyntaxKind::DotDotDot);
 }
 
+ZC_TEST("Node.SourceRangeStoredOnEveryNode") {
+  using namespace zomlang::compiler::ast::factory;
+
+  // i32 {}
+  const auto text = source::SourceLoc::getFromOpaqueValue(1);
+  auto predefined = createPredefinedType("i32"_zc);
+  predefined->setSourceRange(source::SourceRange(text, text + 3));
+  ZC_EXPECT(predefined->getSourceRange().getLength() == 3);
+
+  auto objectType = createObjectType(zc::Vector<zc::Own<Node>>());
+  objectType->setSourceRange(source::SourceRange(text + 4, text + 6));
+  ZC_EXPECT(objectType->getSourceRange().getLength() == 2);
+  ZC_EXPECT(objectType->getKind() == SyntaxKind::ObjectTypeNode);
+}
+
+ZC_TEST("Node.CarriesFlagsByKind") {
+  ZC_EXPECT(carriesFlags(SyntaxKind::Identifier));
+  ZC_EXPECT(carriesFlags(SyntaxKind::CallExpression));
+  ZC_EXPECT(!carriesFlags(SyntaxKind::IfStatement));
+  ZC_EXPECT(!carriesFlags(SyntaxKind::I32TypeNode));
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
@@ -0,0 +1,318 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/compact.h"
+
+#include "zc/core/io.h"
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/dumper.h"
+#include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/factory.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/serializer.h"
+#include "zomlang/compiler/ast/statement.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+using namespace factory;
+
+namespace {
+
+class StringOutputStream final : public zc::OutputStream {
+public:
+  void write(zc::ArrayPtr<const zc::byte> data) override { buffer.addAll(data); }
+
+  zc::String getText() const {
+    return zc::heapString(reinterpret_cast<const char*>(buffer.begin()), buffer.size());
+  }
+
+private:
+  zc::Vector<zc::byte> buffer;
+};
+
+/// Text the AST dumper writes while `run` feeds it nodes.
+template <typename Func>
+zc::String dumpWith(Func&& run) {
+  StringOutputStream output;
+  {
+    ASTDumper dumper(zc::heap<TextSerializer>(output));
+    run(dumper);
+  }
+  return output.getText();
+}
+
+// Covers declarations, statements, expressions, types and patterns that carry extra words.
+constexpr zc::StringPtr kVisitorSample = R"(module graphics;
+import math.geometry as geo;
+import math.geometry.{Point as GeoPoint, distance};
+export {GeoPoint, distance as calcDistance};
+
+interface Shape {
+  fun area() -> f64;
+  readonly let name: str;
+}
+
+class Animal {
+  public let name: str;
+  init(n: str) {
+    this.name = n;
+  }
+  public fun makeSound() -> str {
+    return "noise";
+  }
+}
+
+class Dog extends Animal {
+  private let breed: str;
+  init(n: str, b: str) {
+    super.init(n);
+    this.breed = b;
+  }
+}
+
+struct Pair<T> {
+  let left: T;
+  const right: T
+}
+
+let [a, b] = [1, 2];
+let {x, y} = {x: 10, y: 20};
+let [first, ...rest] = [1, 2, 3];
+let c: (i32 | str)[] = xs;
+let t: (i32, name: str) = tup;
+let q: typeof foo.bar = v;
+let o = {x: 1, ...rest};
+let big = 0x1fn;
+
+fun main(count: i32) -> i32 {
+  let i = 0;
+  while (i < count) {
+    i += 1;
+  }
+  for (let j = 0; j < 10; j = j + 1) {
+    i = i + j * 2.5;
+  }
+  for (let item in [1, 2, 3]) {
+    if (item > 1 && !done) { i = -i; } else { i++; }
+  }
+  let o = obj?.field?.[0];
+  let z = new Point(1, 2) as Base;
+  return i > 0 ? i : 0;
+}
+)"_zc;
+
+}  // namespace
+
+ZC_TEST("CompactTree.PreorderWithSubtreeRanges") {
+  // f(a + 1, "s", 2.5, true);
+  zc::Vector<zc::Own<Expression>> arguments;
+  arguments.add(createBinaryExpression(createIdentifier("a"_zc), createTokenNode(SyntaxKind::Plus),
+                                       createIntegerLiteral(1)));
+  arguments.add(createStringLiteral("s"_zc));
+  arguments.add(createFloatLiteral(2.5));
+  arguments.add(createBooleanLiteral(true));
+  auto call =
+      createCallExpression(createIdentifier("f"_zc), zc::none, zc::none, zc::mv(arguments));
+  auto statement = createExpressionStatement(zc::mv(call));
+
+  CompactTree tree(*statement);
+  ZC_ASSERT(tree.size() == 10);
+
+  const SyntaxKind expected[] = {SyntaxKind::ExpressionStatement,
+                                 SyntaxKind::CallExpression,
+                                 SyntaxKind::Identifier,
+                                 SyntaxKind::BinaryExpression,
+                                 SyntaxKind::Identifier,
+                                 SyntaxKind::Plus,
+                                 SyntaxKind::IntegerLiteral,
+                                 SyntaxKind::StringLiteral,
+                                 SyntaxKind::FloatLiteral,
+                                 SyntaxKind::BooleanLiteral};
+  for (CompactTree::NodeIndex i = 0; i < tree.size(); ++i) {
+    ZC_EXPECT(tree.getKind(i) == expected[i], i);
+  }
+
+  ZC_EXPECT(tree.getSubtreeEnd(0) == 10);
+  ZC_EXPECT(tree.getSubtreeEnd(1) == 10);
+  ZC_EXPECT(tree.getSubtreeEnd(3) == 7);
+  ZC_EXPECT(tree.getSubtreeEnd(9) == 10);
+  ZC_EXPECT(tree.getChildCount(0) == 1);
+  ZC_EXPECT(tree.getChildCount(1) == 5);
+  ZC_EXPECT(tree.getChildCount(3) == 3);
+  ZC_EXPECT(tree.getChildCount(6) == 0);
+
+  zc::Vector<CompactTree::NodeIndex> children;
+  for (auto child = 2u; child < tree.getSubtreeEnd(1); child = tree.getSubtreeEnd(child)) {
+    children.add(child);
+  }
+  ZC_EXPECT(children.size() == 5);
+  ZC_EXPECT(children[1] == 3 && children[2] == 7 && children[4] == 9);
+
+  ZC_EXPECT(tree.getText(2) == "f"_zc);
+  ZC_EXPECT(tree.getText(4) == "a"_zc);
+  ZC_EXPECT(tree.getText(7) == "s"_zc);
+  ZC_EXPECT(tree.getText(1) == zc::none);
+  ZC_EXPECT(tree.getInteger(6) == 1);
+  ZC_EXPECT(tree.getInteger(7) == zc::none);
+  ZC_EXPECT(tree.getFloat(8) == 2.5);
+  ZC_EXPECT(tree.getBoolean(9) == true);
+}
+
+ZC_TEST("CompactTree.PacksSourceRanges") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  const zc::StringPtr code = "let value = a.b + 42;\nfun f(x: i32) { return x; }\n"_zc;
+  auto bufferId = sourceManager->addMemBufferCopy(code.asBytes(), "compact.zom");
+  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+  const Node& root = *ZC_ASSERT_NONNULL(result);
+
+  CompactTree tree(root);
+  ZC_EXPECT(tree.getKind(0) == SyntaxKind::SourceFile);
+  ZC_EXPECT(tree.getSubtreeEnd(0) == tree.size());
+  ZC_EXPECT(tree.getChildCount(0) == 2);
+
+  const source::SourceLoc bufferStart = sourceManager->getLocForBufferStart(bufferId);
+  bool sawValue = false;
+  for (CompactTree::NodeIndex i = 0; i < tree.size(); ++i) {
+    if (tree.getSourceRange(i).isValid()) {
+      ZC_EXPECT(tree.getSourceRange(i).getStart() >= bufferStart);
+    }
+    ZC_IF_SOME(text, tree.getText(i)) {
+      if (text == "value"_zc) {
+        sawValue = true;
+        auto range = tree.getSourceRange(i);
+        ZC_EXPECT(range.getStart() == bufferStart + 4);
+        ZC_EXPECT(range.getLength() == 5);
+      }
+    }
+  }
+  ZC_EXPECT(sawValue);
+  ZC_EXPECT(tree.getMemoryUsage() > 0);
+}
+
+ZC_TEST("CompactTree.KeepsNodeFlags") {
+  auto access = createPropertyAccessExpression(createIdentifier("o"_zc), createIdentifier("p"_zc),
+                                               /*questionDot*/ true, /*isOptionalChain*/ true);
+  CompactTree tree(*access);
+  ZC_ASSERT(tree.size() == 3);
+  ZC_EXPECT(hasFlag(tree.getFlags(0), NodeFlags::OptionalChain));
+  ZC_EXPECT(tree.getFlags(1) == NodeFlags::None);
+  ZC_EXPECT(tree.getSourceRange(0).isInvalid());
+}
+
+ZC_TEST("CompactTree.SerializedImageIsViewedInPlace") {
+  zc::Vector<zc::Own<Expression>> arguments;
+  arguments.add(createIntegerLiteral(7));
+  arguments.add(createStringLiteral("seven"_zc));
+  auto call =
+      createCallExpression(createIdentifier("g"_zc), zc::none, zc::none, zc::mv(arguments));
+  CompactTree original(*call);
+
+  zc::Array<zc::byte> image = original.serialize();
+  auto maybeTree = CompactTree::deserialize(image.asPtr().asConst(), original.getBase());
+  ZC_ASSERT(maybeTree != zc::none);
+  auto& tree = ZC_ASSERT_NONNULL(maybeTree);
+
+  ZC_ASSERT(tree.size() == original.size());
+  for (CompactTree::NodeIndex i = 0; i < tree.size(); ++i) {
+    ZC_EXPECT(tree.getKind(i) == original.getKind(i), i);
+    ZC_EXPECT(tree.getSubtreeEnd(i) == original.getSubtreeEnd(i), i);
+  }
+  ZC_EXPECT(tree.getText(1) == "g"_zc);
+  ZC_EXPECT(tree.getInteger(2) == 7);
+  ZC_EXPECT(tree.getText(3) == "seven"_zc);
+  ZC_EXPECT(tree.getMemoryUsage() == original.getMemoryUsage());
+
+  // The columns point into the image rather than into a copy.
+  ZC_IF_SOME(text, tree.getText(3)) {
+    ZC_EXPECT(text.begin() >= reinterpret_cast<const char*>(image.begin()) &&
+              text.end() < reinterpret_cast<const char*>(image.end()));
+  }
+
+  // Truncated or foreign images are rejected.
+  ZC_EXPECT(CompactTree::deserialize(image.first(image.size() - 8).asConst(), {}) == zc::none);
+  image[4] ^= 0xff;
+  ZC_EXPECT(CompactTree::deserialize(image.asPtr().asConst(), {}) == zc::none);
+}
+
+ZC_TEST("CompactTree.VisitorSeesTheSameTree") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  auto bufferId = sourceManager->addMemBufferCopy(kVisitorSample.asBytes(), "visitor.zom");
+  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+  ZC_ASSERT(!diagnosticEngine->hasErrors());
+  const Node& root = *ZC_ASSERT_NONNULL(result);
+
+  CompactTree tree(root, sourceManager->getLocForBufferStart(bufferId));
+  const zc::String expected = dumpWith([&](ASTDumper& dumper) { dumper.dump(root); });
+  ZC_EXPECT(expected.size() > 0);
+  ZC_EXPECT(dumpWith([&](ASTDumper& dumper) { tree.accept(dumper); }) == expected);
+
+  auto decoded = ZC_ASSERT_NONNULL(tree.decodeSourceFile());
+  ZC_EXPECT(dumpWith([&](ASTDumper& dumper) { dumper.dump(*decoded); }) == expected);
+
+  // Encoding the decoded tree again gives back the same image.
+  zc::Array<zc::byte> image = tree.serialize();
+  ZC_EXPECT(CompactTree(*decoded, tree.getBase()).serialize() == image);
+
+  auto viewed =
+      ZC_ASSERT_NONNULL(CompactTree::deserialize(image.asPtr().asConst(), tree.getBase()));
+  ZC_EXPECT(dumpWith([&](ASTDumper& dumper) { viewed.accept(dumper); }) == expected);
+}
+
+ZC_TEST("CompactTree.UsesAQuarterOfThePointerTreeMemory") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  auto bufferId = sourceManager->addMemBufferCopy(kVisitorSample.asBytes(), "memory.zom");
+  AllocationStats stats;
+  zc::Maybe<zc::Own<Node>> result;
+  {
+    AllocationStatsScope scope(stats);
+    parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+    result = parser.parse();
+  }
+  const Node& root = *ZC_ASSERT_NONNULL(result);
+
+  CompactTree tree(root);
+  const size_t pointerBytes = stats.getTotal().bytes;
+  const size_t compactBytes = tree.getMemoryUsage();
+  ZC_EXPECT(compactBytes * 4 <= pointerBytes, pointerBytes, compactBytes);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
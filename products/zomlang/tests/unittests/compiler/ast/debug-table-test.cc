@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/compiler/ast/debug-table.h"
+
+#include <cstring>
+
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+zc::Maybe<const DebugTreeRecord&> findTree(const Node& root) {
+  const DebugNodeTable& table = getDebugNodeTable();
+  for (uint64_t i = 0; i < table.treeCount; ++i) {
+    if (table.trees[i].root == &root) { return table.trees[i]; }
+  }
+  return zc::none;
+}
+
+}  // namespace
+
+ZC_TEST("DebugNodeTable.ListsEveryNodeInWalkOrder") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  const zc::StringPtr code = "let a = b + c;\n"_zc;
+  auto bufferId = sourceManager->addMemBufferCopy(code.asBytes(), "table.zom");
+  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  zc::Own<Node> root = ZC_ASSERT_NONNULL(parser.parse());
+
+  const DebugNodeTable& table = getDebugNodeTable();
+  const uint64_t generation = table.generation;
+  const uint64_t treeCount = table.treeCount;
+  addToDebugNodeTable(*root, sourceManager->getEntireTextForBuffer(bufferId),
+                      sourceManager->getLocForBufferStart(bufferId));
+  ZC_EXPECT(table.magic == DebugNodeTable::kMagic);
+  ZC_EXPECT(table.nodeRecordSize == sizeof(DebugNodeRecord));
+  ZC_EXPECT(table.generation != generation);
+  ZC_EXPECT(table.treeCount == treeCount + 1);
+
+  const DebugTreeRecord& tree = ZC_ASSERT_NONNULL(findTree(*root));
+  ZC_EXPECT(zc::StringPtr(tree.fileName) == "table.zom"_zc);
+  ZC_ASSERT(tree.nodeCount > 4);
+
+  const DebugNodeRecord& first = tree.nodes[0];
+  ZC_EXPECT(first.node == root.get());
+  ZC_EXPECT(first.parent == nullptr);
+  ZC_EXPECT(first.depth == 0);
+  ZC_EXPECT(first.kind == static_cast<uint32_t>(SyntaxKind::SourceFile));
+
+  bool sawIdentifierB = false;
+  for (uint64_t i = 1; i < tree.nodeCount; ++i) {
+    const DebugNodeRecord& record = tree.nodes[i];
+    ZC_EXPECT(record.parent != nullptr);
+    ZC_EXPECT(record.depth > 0);
+    ZC_EXPECT(record.kind == static_cast<uint32_t>(record.node->getKind()));
+    if (record.node->getKind() == SyntaxKind::Identifier && record.textBegin != nullptr &&
+        *record.textBegin == 'b') {
+      sawIdentifierB = true;
+    }
+  }
+  ZC_EXPECT(sawIdentifierB);
+
+  // The names are in kind order, each ended by a NUL
+  const char* name = table.kindNames;
+  for (uint32_t i = 0; i < static_cast<uint32_t>(SyntaxKind::SourceFile); ++i) {
+    name += strlen(name) + 1;
+  }
+  ZC_EXPECT(zc::StringPtr(name) == _::syntaxKindToString(SyntaxKind::SourceFile));
+
+  // Listing a tree again replaces it
+  addToDebugNodeTable(*root, sourceManager->getEntireTextForBuffer(bufferId),
+                      sourceManager->getLocForBufferStart(bufferId));
+  ZC_EXPECT(table.treeCount == treeCount + 1);
+
+  removeFromDebugNodeTable(*root);
+  ZC_EXPECT(table.treeCount == treeCount);
+  ZC_EXPECT(findTree(*root) == zc::none);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
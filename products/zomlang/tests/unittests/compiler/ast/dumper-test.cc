@@ -10,6 +10,7 @@
 #include "zomlang/compiler/ast/module.h"
 #include "zomlang/compiler/ast/serializer.h"
 #include "zomlang/compiler/ast/type.h"
+#include "zomlang/compiler/basic/string-escape.h"
 
 namespace zomlang {
 namespace compiler {
@@ -21,8 +22,11 @@ class MockOutputStream : public zc::OutputStream {
 public:
   void write(zc::ArrayPtr<const zc::byte> data) override {
     buffer.addAll(data.begin(), data.end());
+    ++writeCount;
   }
 
+  size_t getWriteCount() const { return writeCount; }
+
   zc::String getBuffer() const {
     if (buffer.size() == 0) { return zc::str(""); }
     // Create a null-terminated string from the buffer
@@ -35,6 +39,7 @@ public:
 
 private:
   zc::Vector<zc::byte> buffer;
+  size_t writeCount = 0;
 };
 
 enum class TestSerializerType { kTEXT, kJSON, kXML };
@@ -1367,6 +1372,30 @@ ZC_TEST("ASTDumper.DumpSetAccessorText") {
   ZC_ASSERT(result.contains("mySetter"));
 }
 
+ZC_TEST("ASTDumper.StreamsEscapedValuesInOneWrite") {
+  const zc::StringPtr value = "say \"hi\"\n\t<&>'\x01"_zc;
+  auto expr = ast::factory::createStringLiteral(value);
+
+  MockOutputStream jsonOutput;
+  ASTDumper jsonDumper(createTestSerializer(jsonOutput, TestSerializerType::kJSON));
+  jsonDumper.dump(*expr);
+  ZC_EXPECT(jsonOutput.getWriteCount() == 1);
+  ZC_EXPECT(jsonOutput.getBuffer().contains(
+      zc::str("\"value\": \"", basic::escapeJsonString(value), "\"")));
+
+  MockOutputStream xmlOutput;
+  ASTDumper xmlDumper(createTestSerializer(xmlOutput, TestSerializerType::kXML));
+  xmlDumper.dump(*expr);
+  ZC_EXPECT(xmlOutput.getBuffer().contains(
+      zc::str("<value>", basic::escapeXmlString(value), "</value>")));
+
+  auto number = ast::factory::createFloatLiteral(2.5);
+  MockOutputStream textOutput;
+  ASTDumper textDumper(createTestSerializer(textOutput, TestSerializerType::kTEXT));
+  textDumper.dump(*number);
+  ZC_EXPECT(textOutput.getBuffer().contains("value: 2.5\n"));
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
@@ -20,6 +20,7 @@
 
 #include "zomlang/compiler/ast/factory.h"
 
+#include "zc/core/arena.h"
 #include "zc/core/common.h"
 #include "zc/core/one-of.h"
 #include "zc/core/string.h"
@@ -249,6 +250,49 @@ ZC_TEST("ASTFactory: Alias and Debugger Creation") {
             "DebuggerStatement should have correct kind");
 }
 
+ZC_TEST("ASTFactory: Arena Allocation") {
+  using namespace zomlang::compiler::ast::factory;
+
+  ZC_EXPECT(getCurrentArena() == zc::none);
+
+  // A scratch-backed arena makes it observable where the nodes were placed.
+  zc::Array<zc::byte> scratch = zc::heapArray<zc::byte>(64 * 1024);
+  zc::ArrayPtr<zc::byte> scratchRange = scratch.asPtr();
+  auto inScratch = [&](const void* ptr) {
+    auto byte = reinterpret_cast<const zc::byte*>(ptr);
+    return byte >= scratchRange.begin() && byte < scratchRange.end();
+  };
+
+  auto arena = zc::heap<zc::Arena>(scratchRange);
+  zc::Own<SourceFile> sourceFile = [&]() {
+    ArenaScope scope(*arena);
+    ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentArena()) == arena.get());
+
+    {
+      zc::Arena inner;
+      ArenaScope innerScope(inner);
+      ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentArena()) == &inner);
+    }
+    ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentArena()) == arena.get());
+
+    zc::Vector<zc::Own<Statement>> statements;
+    statements.add(createExpressionStatement(createIdentifier("x"_zc)));
+    return createSourceFile(zc::str("arena.zom"), zc::none, zc::mv(statements));
+  }();
+  ZC_EXPECT(getCurrentArena() == zc::none);
+
+  // The SourceFile itself stays on the heap so it can own the arena its children live in.
+  ZC_EXPECT(!inScratch(sourceFile.get()));
+  ZC_EXPECT(inScratch(&sourceFile->getStatements()[0]));
+  sourceFile->adoptArena(zc::mv(arena));
+
+  // Outside a scope, nodes come from the heap again.
+  auto identifier = createIdentifier("y"_zc);
+  ZC_EXPECT(!inScratch(identifier.get()));
+
+  ZC_EXPECT(sourceFile->getStatements().size() == 1);
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
@@ -14,9 +14,8 @@ namespace ast {
 namespace {
 
 source::SourceRange makeTestSourceRange(unsigned start, unsigned end) {
-  static const char kText[] = "module-range";
-  auto bytes = reinterpret_cast<const zc::byte*>(kText);
-  return source::SourceRange(source::SourceLoc(bytes + start), source::SourceLoc(bytes + end));
+  return source::SourceRange(source::SourceLoc::getFromOpaqueValue(1 + start),
+                             source::SourceLoc::getFromOpaqueValue(1 + end));
 }
 
 void expectMutableFlagsRoundTrip(Node& node) {
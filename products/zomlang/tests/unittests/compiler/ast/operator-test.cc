@@ -18,7 +18,10 @@
 /// This file contains ztest-based unit tests for the AST operator classes,
 /// testing operator creation, properties, and precedence rules.
 
+#include "zomlang/compiler/ast/operator.h"
+
 #include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/kinds.h"
 
 namespace zomlang {
 namespace compiler {
@@ -66,6 +69,27 @@ ZC_TEST("OperatorTest: TokenNodeVariousTypes") {
   ZC_EXPECT(true, "TokenNode-based various types test placeholder");
 }
 
+ZC_TEST("OperatorTest: BinaryOperatorTable") {
+  static_assert(getBinaryOperatorInfo(SyntaxKind::Plus).precedence ==
+                OperatorPrecedence::kAdditive);
+  static_assert(getBinaryOperatorInfo(SyntaxKind::Identifier).nodeKind == SyntaxKind::Unknown);
+
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::Asterisk).precedence >
+            getBinaryOperatorInfo(SyntaxKind::Minus).precedence);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::BarBar).precedence ==
+            getBinaryOperatorInfo(SyntaxKind::QuestionQuestion).precedence);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::AsteriskAsterisk).associativity ==
+            OperatorAssociativity::kRight);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::Slash).associativity ==
+            OperatorAssociativity::kLeft);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::LessThan).nodeKind == SyntaxKind::BinaryExpression);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::AsKeyword).nodeKind == SyntaxKind::AsExpression);
+
+  // Assignments end a binary expression and are handled by the assignment rule.
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::Equals).precedence == OperatorPrecedence::kLowest);
+  ZC_EXPECT(getBinaryOperatorInfo(SyntaxKind::PlusEquals).nodeKind == SyntaxKind::Unknown);
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
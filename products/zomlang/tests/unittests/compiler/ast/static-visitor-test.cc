@@ -0,0 +1,72 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/static-visitor.h"
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/factory.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+using namespace factory;
+
+namespace {
+
+/// Counts nodes, falling back on the Expression overload for everything but the visited kinds.
+class NodeCounter final : public StaticVisitor<NodeCounter, int> {
+public:
+  int visit(const BinaryExpression& node) {
+    return 1 + dispatch(node.getLeft()) + dispatch(node.getOperator()) + dispatch(node.getRight());
+  }
+  int visit(const TokenNode& node) {
+    lastToken = node.getKind();
+    return 1;
+  }
+  int visit(const Expression&) {
+    ++expressionFallbacks;
+    return 1;
+  }
+  int visit(const Node&) { return 1; }
+
+  SyntaxKind lastToken = SyntaxKind::Unknown;
+  int expressionFallbacks = 0;
+};
+
+}  // namespace
+
+ZC_TEST("StaticVisitor.DispatchesOnConcreteKind") {
+  // a + 1
+  auto expression = createBinaryExpression(
+      createIdentifier("a"_zc), createTokenNode(SyntaxKind::Plus), createIntegerLiteral(1));
+
+  NodeCounter counter;
+  ZC_EXPECT(counter.dispatch(*expression) == 4);
+  ZC_EXPECT(counter.lastToken == SyntaxKind::Plus);
+  ZC_EXPECT(counter.expressionFallbacks == 2);
+}
+
+ZC_TEST("StaticVisitor.StatementsUseNodeFallback") {
+  auto statement = createExpressionStatement(createIdentifier("x"_zc));
+
+  NodeCounter counter;
+  ZC_EXPECT(counter.dispatch(*statement) == 1);
+  ZC_EXPECT(counter.expressionFallbacks == 0);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,95 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/statistics.h"
+
+#include "zc/core/memory.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/factory.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+using namespace factory;
+
+ZC_TEST("AllocationStats.ChargesNodesToTheirKind") {
+  AllocationStats stats;
+  {
+    AllocationStatsScope scope(stats);
+    auto expression = createBinaryExpression(
+        createIdentifier("a"_zc), createTokenNode(SyntaxKind::Plus), createIdentifier("b"_zc));
+  }
+  auto untracked = createIdentifier("c"_zc);
+
+  ZC_EXPECT(stats.get(SyntaxKind::Identifier).nodes == 2);
+  ZC_EXPECT(stats.get(SyntaxKind::Identifier).bytes >= 2 * sizeof(Identifier));
+  ZC_EXPECT(stats.get(SyntaxKind::Plus).nodes == 1);
+  ZC_EXPECT(stats.get(SyntaxKind::BinaryExpression).nodes == 1);
+  ZC_EXPECT(stats.getTotal().nodes == 4);
+  ZC_EXPECT(getCurrentAllocationStats() == zc::none);
+}
+
+ZC_TEST("TreeStatistics.ParsedSource") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  const zc::StringPtr code = "let a = b + c;\nfun f(x) { return x; }\n"_zc;
+  auto bufferId = sourceManager->addMemBufferCopy(code.asBytes(), "statistics.zom");
+  AllocationStats allocations;
+  zc::Maybe<zc::Own<Node>> result;
+  {
+    AllocationStatsScope scope(allocations);
+    parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+    result = parser.parse();
+  }
+  const Node& root = *ZC_ASSERT_NONNULL(result);
+
+  TreeStatistics statistics =
+      collectTreeStatistics(root, sourceManager->getEntireTextForBuffer(bufferId), allocations);
+  ZC_EXPECT(statistics.fileName == "statistics.zom"_zc);
+  ZC_EXPECT(statistics.sourceLines == 2);
+  ZC_EXPECT(statistics.sourceBytes == code.size());
+
+  const TreeStatistics::KindEntry& identifiers =
+      statistics.kinds[static_cast<size_t>(SyntaxKind::Identifier)];
+  ZC_EXPECT(identifiers.nodes == 6);
+  ZC_EXPECT(identifiers.allocatedNodes >= identifiers.nodes);
+  ZC_EXPECT(identifiers.bytes >= identifiers.allocatedNodes * sizeof(Identifier));
+
+  const TreeStatistics::KindEntry total = statistics.getTotal();
+  ZC_EXPECT(total.allocatedNodes >= total.nodes);
+  ZC_EXPECT(statistics.kinds[static_cast<size_t>(SyntaxKind::Plus)].nodes == 0);
+  ZC_EXPECT(statistics.kinds[static_cast<size_t>(SyntaxKind::TokenNode)].nodes > 0);
+  ZC_EXPECT(statistics.arenaBytes > 0);
+  ZC_EXPECT(statistics.getBytesPerLine() == total.bytes / 2.0);
+
+  statistics.parseTime = 1500 * zc::MICROSECONDS;
+  zc::String json = statisticsToJson(zc::arrayPtr(&statistics, 1));
+  ZC_EXPECT(json.contains("\"parseMicroseconds\": 1500,"_zc), json);
+  ZC_EXPECT(json.contains("\"file\": \"statistics.zom\""_zc), json);
+  ZC_EXPECT(json.contains("{\"kind\": \"Identifier\", \"nodes\": 6"_zc), json);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,66 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/ast/type-interner.h"
+
+#include "zc/core/memory.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/factory.h"
+#include "zomlang/compiler/ast/type.h"
+
+namespace zomlang {
+namespace compiler {
+namespace ast {
+
+namespace {
+
+zc::Own<TypeNode> makeOptional(zc::StringPtr name) {
+  return factory::createOptionalType(factory::createTypeReference(factory::createIdentifier(name),
+                                                                  zc::none));
+}
+
+}  // namespace
+
+ZC_TEST("TypeInterner.EqualTypesShareOneInstance") {
+  TypeInterner interner;
+  auto first = makeOptional("Point"_zc);
+  auto second = makeOptional("Point"_zc);
+  auto other = makeOptional("Line"_zc);
+
+  const TypeNode& canonical = interner.intern(*first);
+  ZC_EXPECT(&canonical == first.get());
+  ZC_EXPECT(&interner.intern(*second) == &canonical);
+  ZC_EXPECT(&interner.intern(*other) == other.get());
+  ZC_EXPECT(interner.size() == 2);
+
+  ZC_IF_SOME(found, interner.find(*makeOptional("Point"_zc))) { ZC_EXPECT(&found == &canonical); }
+  else { ZC_FAIL_EXPECT("interned type not found"); }
+  ZC_EXPECT(interner.find(*makeOptional("Plane"_zc)) == zc::none);
+}
+
+ZC_TEST("TypeInterner.OwnedDuplicatesAreDropped") {
+  TypeInterner interner;
+  const TypeNode& i32 = interner.intern(factory::createPredefinedType("i32"_zc));
+  for (int i = 0; i < 8; ++i) {
+    ZC_EXPECT(&interner.intern(factory::createPredefinedType("i32"_zc)) == &i32);
+  }
+  ZC_EXPECT(i32.getKind() == SyntaxKind::I32TypeNode);
+  ZC_EXPECT(interner.size() == 1);
+}
+
+}  // namespace ast
+}  // namespace compiler
+}  // namespace zomlang
@@ -1794,6 +1794,59 @@ ZC_TEST("TypeTest.FunctionTypeWithTypeParameters") {
   ZC_EXPECT(funcType->getParameters().size() == 0);
 }
 
+namespace {
+
+zc::Own<TypeNode> makeUnion(zc::StringPtr first, zc::StringPtr second) {
+  zc::Vector<zc::Own<TypeNode>> types;
+  types.add(factory::createPredefinedType(first));
+  types.add(factory::createPredefinedType(second));
+  return factory::createUnionType(zc::mv(types));
+}
+
+zc::Own<TypeNode> makeFunction(bool optionalParameter) {
+  zc::Maybe<zc::Own<TokenNode>> questionToken = zc::none;
+  if (optionalParameter) { questionToken = factory::createTokenNode(SyntaxKind::Question); }
+  zc::Vector<zc::Own<ParameterDeclaration>> params;
+  params.add(factory::createParameterDeclaration({}, zc::none, factory::createIdentifier("x"_zc),
+                                                 zc::mv(questionToken),
+                                                 factory::createPredefinedType("i32"_zc)));
+  auto returnType = factory::createReturnType(factory::createPredefinedType("str"_zc), zc::none);
+  return factory::createFunctionType(zc::none, zc::mv(params), zc::mv(returnType));
+}
+
+}  // namespace
+
+ZC_TEST("TypeTest.StructuralHashIgnoresSourceRange") {
+  auto a = makeUnion("i32"_zc, "str"_zc);
+  auto b = makeUnion("i32"_zc, "str"_zc);
+  b->setSourceRange(source::SourceRange());
+
+  ZC_EXPECT(a->hashCode() == b->hashCode());
+  ZC_EXPECT(a->hashCode() == a->hashCode());
+  ZC_EXPECT(isStructurallyEqual(*a, *b));
+
+  auto swapped = makeUnion("str"_zc, "i32"_zc);
+  ZC_EXPECT(!isStructurallyEqual(*a, *swapped));
+  ZC_EXPECT(!isStructurallyEqual(*factory::createPredefinedType("i32"_zc),
+                                 *factory::createPredefinedType("i64"_zc)));
+}
+
+ZC_TEST("TypeTest.StructuralEqualityComparesNamesAndArguments") {
+  auto reference = [](zc::StringPtr name, zc::StringPtr argument) {
+    zc::Vector<zc::Own<TypeNode>> typeArgs;
+    typeArgs.add(factory::createPredefinedType(argument));
+    return factory::createTypeReference(factory::createIdentifier(name), zc::mv(typeArgs));
+  };
+
+  auto arrayOfI32 = reference("Array"_zc, "i32"_zc);
+  ZC_EXPECT(isStructurallyEqual(*arrayOfI32, *reference("Array"_zc, "i32"_zc)));
+  ZC_EXPECT(!isStructurallyEqual(*arrayOfI32, *reference("List"_zc, "i32"_zc)));
+  ZC_EXPECT(!isStructurallyEqual(*arrayOfI32, *reference("Array"_zc, "f64"_zc)));
+
+  ZC_EXPECT(isStructurallyEqual(*makeFunction(false), *makeFunction(false)));
+  ZC_EXPECT(!isStructurallyEqual(*makeFunction(false), *makeFunction(true)));
+}
+
 }  // namespace ast
 }  // namespace compiler
 }  // namespace zomlang
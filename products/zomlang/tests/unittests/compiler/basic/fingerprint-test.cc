@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/basic/fingerprint.h"
+
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+ZC_TEST("FingerprintTest_IsStable") {
+  // FNV-1a of nothing, and of eight zero bytes, on every platform
+  ZC_EXPECT(Fingerprint().get() == 0xcbf29ce484222325ull);
+  ZC_EXPECT(Fingerprint().add(uint64_t(0)).get() == Fingerprint().add(false).get());
+  ZC_EXPECT(Fingerprint().add(1).add(2).get() != Fingerprint().add(2).add(1).get());
+  ZC_EXPECT(Fingerprint().add("ab").add("c").get() != Fingerprint().add("a").add("bc").get());
+}
+
+ZC_TEST("FingerprintTest_LangOptionsThatChangeParsing") {
+  const LangOptions defaults;
+  const uint64_t base = fingerprint(defaults);
+
+  LangOptions options;
+  options.allowDollarIdentifiers = true;
+  ZC_EXPECT(fingerprint(options) != base);
+  options = defaults;
+  options.supportRegexLiterals = false;
+  ZC_EXPECT(fingerprint(options) != base);
+
+  // How parsing runs does not matter
+  options = defaults;
+  options.useAstArena = false;
+  options.parallelParseMinBytes = 1;
+  options.perBufferStringPools = true;
+  ZC_EXPECT(fingerprint(options) == base);
+}
+
+ZC_TEST("FingerprintTest_CompilerOptionsThatChangeOutput") {
+  const uint64_t base = fingerprint(CompilerOptions());
+  auto changes = [base](auto&& edit) {
+    CompilerOptions options;
+    edit(options);
+    return fingerprint(options) != base;
+  };
+
+  ZC_EXPECT(changes([](CompilerOptions& options) { options.optimization.level = 2; }));
+  ZC_EXPECT(changes([](CompilerOptions& options) {
+    options.emission.outputType = CompilerOptions::EmissionOptions::OutputType::IR;
+  }));
+  ZC_EXPECT(changes([](CompilerOptions& options) { options.diagnostics.warningsAsErrors = true; }));
+
+  // Where the output goes and what is reported about the compilation do not matter
+  ZC_EXPECT(!changes([](CompilerOptions& options) {
+    options.emission.outputPath = zc::str("out.o");
+    options.emission.timeReportEnabled = true;
+    options.parallel.threadPlacement = CompilerOptions::ParallelOptions::ThreadPlacement::kCores;
+  }));
+}
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
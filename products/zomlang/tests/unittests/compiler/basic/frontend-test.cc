@@ -2,9 +2,18 @@
 
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/compact.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/ast/statement.h"
 #include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/compiler/lexer/outline-scan.h"
+#include "zomlang/compiler/parser/parser.h"
 #include "zomlang/compiler/source/manager.h"
 
 namespace zomlang {
@@ -63,6 +72,235 @@ ZC_TEST("FrontendTest: PerformParseFunctionDeclaration") {
   ZC_EXPECT(result != zc::none, "Parse result should not be null");
 }
 
+namespace {
+
+class CountingConsumer final : public diagnostics::DiagnosticConsumer {
+public:
+  explicit CountingConsumer(size_t& count) : count(count) {}
+  void handleDiagnostic(const source::SourceManager&, const diagnostics::Diagnostic&) override {
+    ++count;
+  }
+
+private:
+  size_t& count;
+};
+
+/// Many small top-level declarations, with a syntax error in the middle if `withError`.
+zc::String makeLargeSource(bool withError) {
+  zc::Vector<zc::String> parts;
+  for (int i = 0; i < 64; ++i) {
+    parts.add(zc::str("fun compute", i, "() {\n  let y = ", i, " + 1;\n  return y;\n}\n"));
+    if (withError && i == 40) { parts.add(zc::str("let broken = ;\n")); }
+    parts.add(zc::str("let v", i, " = compute", i, "(", i, "); // trailing comment\n"));
+  }
+  return zc::strArray(parts, "");
+}
+
+struct ParseRun {
+  zc::Maybe<zc::Own<ast::Node>> ast;
+  size_t diagnostics = 0;
+};
+
+ParseRun parseWith(source::SourceManager& sourceMgr, const source::BufferId& bufferId,
+                   StringPool& stringPool, uint32_t parallelParseMinBytes) {
+  ParseRun run;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceMgr);
+  diagnosticEngine.addConsumer(zc::heap<CountingConsumer>(run.diagnostics));
+  LangOptions langOpts;
+  langOpts.parallelParseMinBytes = parallelParseMinBytes;
+  langOpts.parallelParseMaxChunks = 4;
+  ThreadPool threadPool(4);
+  run.ast = performParse(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId, zc::none,
+                         threadPool);
+  return run;
+}
+
+/// Reparse `text` after replacing `removed` bytes at `offset` by `inserted`, and check that the
+/// tree and diagnostics match a full parse of the new text. Returns how many top-level statements
+/// were kept from the previous tree.
+size_t expectReparseMatchesParse(zc::StringPtr text, uint32_t offset, uint32_t removed,
+                                 zc::StringPtr inserted) {
+  source::SourceManager sourceMgr;
+  StringPool stringPool;
+  LangOptions langOpts;
+
+  zc::String after = zc::str(text.slice(0, offset), inserted, text.slice(offset + removed));
+  auto oldBuffer = sourceMgr.addMemBufferCopy(text.asBytes(), "old.zom");
+  auto newBuffer = sourceMgr.addMemBufferCopy(after.asBytes(), "new.zom");
+
+  ParseRun previous = parseWith(sourceMgr, oldBuffer, stringPool, 0);
+  ParseRun expected = parseWith(sourceMgr, newBuffer, stringPool, 0);
+  zc::Own<ast::Node> previousAst = zc::mv(ZC_ASSERT_NONNULL(previous.ast));
+  zc::Vector<const ast::Statement*> previousStatements;
+  for (const auto& statement : ast::cast<ast::SourceFile>(*previousAst).getStatements()) {
+    previousStatements.add(&statement);
+  }
+
+  ParseRun actual;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceMgr);
+  diagnosticEngine.addConsumer(zc::heap<CountingConsumer>(actual.diagnostics));
+  const lexer::TextEdit edit{offset, removed, static_cast<uint32_t>(inserted.size())};
+  actual.ast = performReparse(sourceMgr, diagnosticEngine, langOpts, stringPool, newBuffer,
+                              zc::mv(previousAst), oldBuffer, edit);
+
+  ZC_EXPECT(actual.diagnostics == expected.diagnostics, after);
+  ZC_IF_SOME(expectedAst, expected.ast) {
+    const ast::Node& actualAst = *ZC_ASSERT_NONNULL(actual.ast, after);
+    ast::CompactTree expectedTree(*expectedAst);
+    ast::CompactTree actualTree(actualAst);
+    ZC_ASSERT(actualTree.size() == expectedTree.size(), after);
+    for (ast::CompactTree::NodeIndex i = 0; i < actualTree.size(); ++i) {
+      ZC_EXPECT(actualTree.getKind(i) == expectedTree.getKind(i), after, i);
+      ZC_EXPECT(actualTree.getSubtreeEnd(i) == expectedTree.getSubtreeEnd(i), after, i);
+      const auto actualRange = actualTree.getSourceRange(i);
+      const auto expectedRange = expectedTree.getSourceRange(i);
+      ZC_EXPECT(actualRange.getStart() == expectedRange.getStart(), after, i);
+      ZC_EXPECT(actualRange.getEnd() == expectedRange.getEnd(), after, i);
+      ZC_EXPECT(actualTree.getText(i) == expectedTree.getText(i), after, i);
+    }
+
+    size_t kept = 0;
+    for (const auto& statement : ast::cast<ast::SourceFile>(actualAst).getStatements()) {
+      for (const ast::Statement* old : previousStatements) {
+        if (old == &statement) { ++kept; }
+      }
+    }
+    return kept;
+  }
+  else {
+    ZC_EXPECT(actual.ast == zc::none, after);
+  }
+  return 0;
+}
+
+}  // namespace
+
+ZC_TEST("FrontendTest: FindChunkBoundaries") {
+  source::SourceManager sourceMgr;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceMgr);
+  LangOptions langOpts;
+  StringPool stringPool;
+
+  zc::String code = makeLargeSource(/*withError*/ false);
+  auto bufferId = sourceMgr.addMemBufferCopy(code.asBytes(), "test.zom");
+  lexer::Lexer lexer(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId);
+  lexer::TokenTable tokens = lexer.lexAll();
+
+  zc::Vector<uint32_t> boundaries = parser::findChunkBoundaries(tokens, 4);
+  ZC_ASSERT(boundaries.size() == 4);
+  ZC_EXPECT(boundaries[0] == 0);
+  for (size_t i = 1; i < boundaries.size(); ++i) {
+    ZC_EXPECT(boundaries[i] > boundaries[i - 1]);
+    // Every cut is right after a top-level `}` or `;`, ahead of the trivia before a declaration.
+    const char before = code[boundaries[i] - 1];
+    ZC_EXPECT(before == '}' || before == ';', before);
+  }
+
+  ZC_EXPECT(parser::findChunkBoundaries(tokens, 1).size() == 1);
+
+  // Nothing is cut past a template literal with substitutions.
+  zc::String templated = zc::str("let t = `${1}`;\n", code);
+  auto templatedId = sourceMgr.addMemBufferCopy(templated.asBytes(), "templated.zom");
+  lexer::Lexer templatedLexer(sourceMgr, diagnosticEngine, langOpts, stringPool, templatedId);
+  ZC_EXPECT(parser::findChunkBoundaries(templatedLexer.lexAll(), 4).size() == 1);
+}
+
+ZC_TEST("FrontendTest: ParallelParseMatchesSerialParse") {
+  source::SourceManager sourceMgr;
+  StringPool stringPool;
+
+  zc::String code = makeLargeSource(/*withError*/ false);
+  auto bufferId = sourceMgr.addMemBufferCopy(code.asBytes(), "test.zom");
+
+  ParseRun serial = parseWith(sourceMgr, bufferId, stringPool, 0);
+  ParseRun parallel = parseWith(sourceMgr, bufferId, stringPool, 1);
+  ZC_EXPECT(serial.diagnostics == 0 && parallel.diagnostics == 0);
+
+  const ast::Node& serialAst = *ZC_ASSERT_NONNULL(serial.ast);
+  const ast::Node& parallelAst = *ZC_ASSERT_NONNULL(parallel.ast);
+  ast::CompactTree expected(serialAst);
+  ast::CompactTree actual(parallelAst);
+  ZC_ASSERT(actual.size() == expected.size());
+  for (ast::CompactTree::NodeIndex i = 0; i < actual.size(); ++i) {
+    ZC_EXPECT(actual.getKind(i) == expected.getKind(i), i);
+    ZC_EXPECT(actual.getSubtreeEnd(i) == expected.getSubtreeEnd(i), i);
+    ZC_EXPECT(actual.getSourceRange(i).getStart() == expected.getSourceRange(i).getStart(), i);
+    ZC_EXPECT(actual.getSourceRange(i).getEnd() == expected.getSourceRange(i).getEnd(), i);
+    ZC_EXPECT(actual.getText(i) == expected.getText(i), i);
+  }
+}
+
+ZC_TEST("FrontendTest: ParallelParseReportsLikeSerialParse") {
+  source::SourceManager sourceMgr;
+  StringPool stringPool;
+
+  zc::String code = makeLargeSource(/*withError*/ true);
+  auto bufferId = sourceMgr.addMemBufferCopy(code.asBytes(), "test.zom");
+
+  ParseRun serial = parseWith(sourceMgr, bufferId, stringPool, 0);
+  ParseRun parallel = parseWith(sourceMgr, bufferId, stringPool, 1);
+  ZC_EXPECT(serial.diagnostics > 0);
+  ZC_EXPECT(parallel.diagnostics == serial.diagnostics);
+  ZC_EXPECT(serial.ast == zc::none && parallel.ast == zc::none);
+}
+
+ZC_TEST("FrontendTest: OutlineMatchesParse") {
+  source::SourceManager sourceMgr;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceMgr);
+  LangOptions langOpts;
+  StringPool stringPool;
+
+  zc::String code = makeLargeSource(/*withError*/ false);
+  auto bufferId = sourceMgr.addMemBufferCopy(code.asBytes(), "test.zom");
+
+  lexer::Outline outline =
+      performOutline(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId);
+  zc::Own<ast::Node> tree = ZC_ASSERT_NONNULL(
+      performParse(sourceMgr, diagnosticEngine, langOpts, stringPool, bufferId));
+
+  // A declaration per statement, starting where it does.
+  const auto& statements = ast::cast<ast::SourceFile>(*tree).getStatements();
+  ZC_ASSERT(outline.entries.size() == statements.size(), outline.entries.size());
+  size_t index = 0;
+  for (const ast::Statement& statement : statements) {
+    const lexer::OutlineEntry& entry = outline.entries[index++];
+    const ast::SyntaxKind expected = statement.getKind() == ast::SyntaxKind::VariableStatement
+                                         ? ast::SyntaxKind::VariableDeclaration
+                                         : statement.getKind();
+    ZC_EXPECT(entry.kind == expected, index);
+    ZC_EXPECT(entry.range.getStart() == statement.getSourceRange().getStart(), index);
+    ZC_EXPECT(entry.parent == zc::none);
+  }
+}
+
+ZC_TEST("FrontendTest: ReparseAfterEdit") {
+  zc::StringPtr text =
+      "module app.main;\n"
+      "let alpha = 1;\n"
+      "fun f(x) {\n  return x + alpha;\n}\n"
+      "let beta = f(2); /* note */\n"
+      "class C { fun m() { return 3; } }\n"
+      "let gamma = beta;\n"_zc;
+  const size_t body = text.findFirst('+').orDefault(0);
+  const size_t note = text.findFirst('*').orDefault(0) + 2;
+
+  // Only the statements an edit touches are parsed again; the module declaration is not a
+  // statement.
+  ZC_EXPECT(expectReparseMatchesParse(text, body + 2, 5, "beta * 10") == 4);
+  ZC_EXPECT(expectReparseMatchesParse(text, note, 4, "longer note") == 5);
+  ZC_EXPECT(expectReparseMatchesParse(text, note + 8, 0, "\nlet delta = 4;") == 4);
+  ZC_EXPECT(expectReparseMatchesParse(text, text.size(), 0, "fun g() {}\n") == 5);
+  ZC_EXPECT(expectReparseMatchesParse(text, text.size() - 6, 4, "alpha") == 4);
+  ZC_EXPECT(expectReparseMatchesParse(text, 7, 3, "lib") == 5);
+  ZC_EXPECT(expectReparseMatchesParse(text, 0, 17, "") == 4);
+
+  // Edits that spill into the kept text fall back to a full parse, errors included.
+  expectReparseMatchesParse(text, body - 1, 0, "/*");
+  expectReparseMatchesParse(text, body, 0, "{");
+  expectReparseMatchesParse(text, note - 3, 0, "\"");
+  expectReparseMatchesParse(text, 0, text.size(), "let only = 1;");
+}
+
 }  // namespace basic
 }  // namespace compiler
 }  // namespace zomlang
@@ -0,0 +1,75 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/basic/side-table.h"
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/ast.h"
+#include "zomlang/compiler/symbol/symbol-id.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+namespace {
+
+ZC_TEST("SideTable_ReadsDefaultsAndGrowsOnWrite") {
+  symbol::SymbolSideTable<uint32_t> counts;
+  ZC_EXPECT(counts.size() == 0);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(7)) == 0);
+  ZC_EXPECT(counts.size() == 0);
+
+  counts.set(symbol::SymbolId::create(3), 30);
+  ++counts.at(symbol::SymbolId::create(3));
+  ++counts.at(symbol::SymbolId::create(1));
+  ZC_EXPECT(counts.size() == 4);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(3)) == 31);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(1)) == 1);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(2)) == 0);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(100)) == 0);
+
+  // Entries are laid out by id for scans.
+  auto entries = counts.asPtr();
+  ZC_ASSERT(entries.size() == 4);
+  ZC_EXPECT(entries[0] == 0);
+  ZC_EXPECT(entries[1] == 1);
+  ZC_EXPECT(entries[2] == 0);
+  ZC_EXPECT(entries[3] == 31);
+
+  counts.clear();
+  ZC_EXPECT(counts.size() == 0);
+  ZC_EXPECT(counts.get(symbol::SymbolId::create(3)) == 0);
+}
+
+ZC_TEST("SideTable_ByNodeId") {
+  ast::NodeSideTable<zc::Maybe<zc::StringPtr>> names;
+  ZC_EXPECT(!ast::NodeId().isValid());
+  ZC_EXPECT(names.get(ast::NodeId()) == zc::none);
+
+  for (uint32_t i = 1; i <= 1000; ++i) {
+    if (i % 2 == 0) { names.set(ast::NodeId::create(i), "even"_zc); }
+  }
+  ZC_EXPECT(names.size() == 1001);
+  ZC_EXPECT(names.get(ast::NodeId::create(999)) == zc::none);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(names.get(ast::NodeId::create(1000))) == "even");
+
+  // Moving keeps the entries.
+  ast::NodeSideTable<zc::Maybe<zc::StringPtr>> moved = zc::mv(names);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(moved.get(ast::NodeId::create(2))) == "even");
+}
+
+}  // namespace
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,82 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/compiler/basic/string-escape.h"
+
+#include "zc/core/io.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace compiler {
+namespace basic {
+
+namespace {
+
+/// Escape character by character, as the escapers did before they scanned a word at a time.
+zc::String referenceJsonEscape(zc::StringPtr str) {
+  zc::String result = zc::str("");
+  for (char c : str) {
+    if (c == '"') {
+      result = zc::str(result, "\\\"");
+    } else if (c == '\\') {
+      result = zc::str(result, "\\\\");
+    } else if (c == '\n') {
+      result = zc::str(result, "\\n");
+    } else if (c == '\t') {
+      result = zc::str(result, "\\t");
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      const auto code = static_cast<unsigned char>(c);
+      result = zc::str(result, code < 0x10 ? "\\u000" : "\\u00", zc::hex(code));
+    } else {
+      result = zc::str(result, c);
+    }
+  }
+  return result;
+}
+
+}  // namespace
+
+ZC_TEST("StringEscapeTest.JsonEscapes") {
+  ZC_EXPECT(escapeJsonString("plain"_zc) == "plain"_zc);
+  ZC_EXPECT(escapeJsonString("a\"b\\c\nd\te\x01"_zc) == "a\\\"b\\\\c\\nd\\te\\u0001"_zc);
+  ZC_EXPECT(escapeJsonString("\xe4\xb8\xad"_zc) == "\xe4\xb8\xad"_zc);
+  ZC_EXPECT(escapeJsonString(""_zc) == ""_zc);
+}
+
+ZC_TEST("StringEscapeTest.XmlEscapes") {
+  ZC_EXPECT(escapeXmlString("<a href=\"x\">'&'</a>"_zc) ==
+            "&lt;a href=&quot;x&quot;&gt;&apos;&amp;&apos;&lt;/a&gt;"_zc);
+}
+
+ZC_TEST("StringEscapeTest.EscapesAtEveryOffsetOfLongRuns") {
+  // Put each escaped character at every position of a run several words long, so it is found in
+  // the word-at-a-time loop and in the byte-at-a-time tail alike.
+  for (char special : {'"', '\\', '\n', '\t', '\x01', '\x1f'}) {
+    for (size_t length = 0; length < 80; ++length) {
+      for (size_t at = 0; at < length; ++at) {
+        auto text = zc::heapString(length);
+        for (size_t i = 0; i < length; ++i) { text[i] = i == at ? special : 'a' + i % 26; }
+        ZC_EXPECT(escapeJsonString(text) == referenceJsonEscape(text), length, at);
+
+        zc::VectorOutputStream output;
+        writeJsonEscaped(output, text);
+        ZC_EXPECT(output.getArray().asChars() == referenceJsonEscape(text).asArray(), length, at);
+      }
+    }
+  }
+}
+
+}  // namespace basic
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,6 +14,8 @@
 
 #include "zomlang/compiler/basic/string-pool.h"
 
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 
 namespace zomlang {
@@ -127,6 +129,129 @@ ZC_TEST("StringPool overload priority") {
   ZC_EXPECT(s4 == "world"_zc);
 }
 
+ZC_TEST("StringPool interned handles carry hash, length and id") {
+  StringPool pool;
+  InternedString a = pool.intern("alpha");
+  InternedString b = pool.intern("beta");
+
+  ZC_EXPECT(a.size() == 5);
+  ZC_EXPECT(a.hashCode() == zc::hashCode("alpha"_zc));
+  ZC_EXPECT(a.cStr()[a.size()] == '\0');
+  ZC_EXPECT(a.getId() != 0 && b.getId() != 0 && a.getId() != b.getId());
+
+  // Interning the same text again gives the same handle.
+  ZC_EXPECT(pool.intern("alp", "ha").cStr() == a.cStr());
+  ZC_EXPECT(pool.intern("alpha"_zc).getId() == a.getId());
+  ZC_EXPECT(a == pool.intern("alpha"));
+  ZC_EXPECT(!(a == b));
+  ZC_EXPECT(a == "alpha"_zc);
+  ZC_EXPECT(zc::str(a, "/", b) == "alpha/beta");
+
+  // Equal text from another pool compares equal despite the different address.
+  StringPool other;
+  InternedString elsewhere = other.intern("alpha");
+  ZC_EXPECT(elsewhere.cStr() != a.cStr());
+  ZC_EXPECT(elsewhere == a);
+}
+
+ZC_TEST("StringPool internBatch matches intern") {
+  StringPool pool;
+  InternedString existing = pool.intern("name_7");
+
+  zc::Vector<zc::String> texts;
+  for (int i = 0; i < 300; ++i) { texts.add(zc::str("name_", i % 100)); }
+  zc::Vector<zc::ArrayPtr<const zc::byte>> batch;
+  for (const zc::String& text : texts) { batch.add(text.asBytes()); }
+
+  zc::Array<InternedString> interned = pool.internBatch(batch);
+  ZC_ASSERT(interned.size() == texts.size());
+  for (size_t i = 0; i < texts.size(); ++i) {
+    ZC_EXPECT(interned[i] == texts[i], i);
+    ZC_EXPECT(interned[i].cStr() == pool.intern(texts[i]).cStr(), i);
+    // Repeats within the batch resolve to one string.
+    ZC_EXPECT(interned[i].cStr() == interned[i % 100].cStr(), i);
+  }
+  ZC_EXPECT(interned[7].cStr() == existing.cStr());
+
+  ZC_EXPECT(pool.internBatch(nullptr).size() == 0);
+}
+
+ZC_TEST("StringPool pools do not share interned strings") {
+  StringPool first;
+  StringPool second;
+
+  // The second intern in each pool is answered from this thread's cache.
+  const char* a = first.intern("shared").cStr();
+  const char* b = second.intern("shared").cStr();
+  ZC_EXPECT(a != b);
+  ZC_EXPECT(first.intern("shared").cStr() == a);
+  ZC_EXPECT(second.intern("shared").cStr() == b);
+
+  // Nothing cached before clear() is handed out after it.
+  first.intern("kept");
+  first.clear();
+  zc::StringPtr after = first.intern("kept");
+  ZC_EXPECT(after == "kept"_zc);
+  ZC_EXPECT(first.intern("kept").cStr() == after.cStr());
+}
+
+ZC_TEST("StringPool reports its usage") {
+  StringPool pool;
+  ZC_EXPECT(pool.getUsage().strings == 0);
+
+  pool.intern("alpha");
+  pool.intern("beta");
+  pool.intern("alpha");
+  const StringPool::Usage usage = pool.getUsage();
+  ZC_EXPECT(usage.strings == 2);
+  ZC_EXPECT(usage.bytes == sizeof("alpha") + sizeof("beta"));
+
+  pool.clear();
+  ZC_EXPECT(pool.getUsage().bytes == 0);
+}
+
+ZC_TEST("StringPool measures its memory") {
+  StringPool pool;
+  const MemoryUsage empty = pool.getMemoryUsage();
+  ZC_EXPECT(empty.usedBytes == 0);
+
+  for (int i = 0; i < 1000; ++i) { pool.intern(zc::str("name", i)); }
+  const MemoryUsage usage = pool.getMemoryUsage();
+  // Each string takes at least its text, its NUL and its header.
+  ZC_EXPECT(usage.usedBytes >= 1000 * (sizeof("name0") + sizeof(InternedString::Header)));
+  ZC_EXPECT(usage.reservedBytes >= usage.usedBytes);
+  ZC_EXPECT(usage.arenaSlackBytes <= usage.reservedBytes - usage.usedBytes);
+  ZC_EXPECT(usage.arenaSlackBytes > 0);
+}
+
+ZC_TEST("StringPool interns consistently across threads") {
+  StringPool pool;
+  constexpr int kThreads = 8;
+  constexpr int kNames = 2000;
+
+  zc::Vector<zc::Array<const char*>> results;
+  for (int t = 0; t < kThreads; ++t) { results.add(zc::heapArray<const char*>(kNames)); }
+  {
+    zc::Vector<zc::Own<zc::Thread>> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.add(zc::heap<zc::Thread>([&pool, &out = results[t], t]() {
+        // Each thread walks the names in its own order, twice, to mix shard and cache hits.
+        for (int pass = 0; pass < 2; ++pass) {
+          for (int n = 0; n < kNames; ++n) {
+            const int name = (n * 7 + t * 131) % kNames;
+            out[name] = pool.intern(zc::str("name_", name)).cStr();
+          }
+        }
+      }));
+    }
+  }
+
+  for (int n = 0; n < kNames; ++n) {
+    ZC_EXPECT(zc::StringPtr(results[0][n]) == zc::str("name_", n), n);
+    for (int t = 1; t < kThreads; ++t) { ZC_EXPECT(results[t][n] == results[0][n], t, n); }
+  }
+}
+
 }  // namespace
 }  // namespace basic
 }  // namespace compiler
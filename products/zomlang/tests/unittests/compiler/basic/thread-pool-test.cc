@@ -16,6 +16,10 @@
 
 #include <unistd.h>  // For usleep
 
+#if __linux__
+#include <sched.h>  // For sched_getaffinity
+#endif
+
 #include <atomic>
 #include <cstdlib>  // For rand
 
@@ -143,6 +147,157 @@ ZC_TEST("ThreadPool: Task Exception Handling") {
   // Verification depends on the logging mechanism. ZC_LOG(ERROR, ...) is used in workerLoop.
 }
 
+ZC_TEST("ThreadPool: Destruction Waits for Tasks Queued by Tasks") {
+  std::atomic<int> counter = 0;
+  {
+    ThreadPool pool(4);
+    for (int i = 0; i < 16; ++i) {
+      pool.enqueue([&]() {
+        // Queued from a worker, so onto its own deque; idle workers steal from it.
+        for (int j = 0; j < 16; ++j) {
+          pool.enqueue([&]() { counter++; });
+        }
+      });
+    }
+  }
+  ZC_EXPECT(counter == 16 * 16, counter);
+}
+
+ZC_TEST("ThreadPool: WaitIdle Between Batches") {
+  ThreadPool pool(4);
+  std::atomic<int> counter = 0;
+  for (int batch = 1; batch <= 3; ++batch) {
+    for (int i = 0; i < 32; ++i) {
+      pool.enqueue([&]() {
+        usleep((zc::MILLISECONDS * (rand() % 2)) / zc::MICROSECONDS);
+        pool.enqueue([&]() { counter++; });
+      });
+    }
+    // Follow-up tasks count too, and the same workers serve the next batch.
+    pool.waitIdle();
+    ZC_EXPECT(counter == 32 * batch, counter, batch);
+  }
+}
+
+ZC_TEST("ThreadPool: Nested Fork and Join") {
+  // Sum 1..n by splitting the range in halves; every join waits inside a task.
+  ThreadPool pool(4);
+  struct Summer {
+    ThreadPool& pool;
+    std::atomic<uint64_t>& total;
+
+    void sum(uint64_t begin, uint64_t end) {
+      if (end - begin <= 64) {
+        uint64_t local = 0;
+        for (uint64_t i = begin; i < end; ++i) { local += i; }
+        total += local;
+        return;
+      }
+      const uint64_t middle = begin + (end - begin) / 2;
+      TaskGroup group(pool);
+      group.fork([this, begin, middle]() { sum(begin, middle); });
+      group.fork([this, middle, end]() { sum(middle, end); });
+      group.join();
+    }
+  };
+
+  std::atomic<uint64_t> total = 0;
+  Summer summer{pool, total};
+  summer.sum(1, 100001);
+  ZC_EXPECT(total == 100000ull * 100001 / 2, total);
+
+  // A single worker can join from inside a task only by running the forked tasks itself.
+  ThreadPool single(1);
+  std::atomic<int> ran = 0;
+  zc::MutexGuarded<bool> done(false);
+  single.enqueue([&]() {
+    TaskGroup group(single);
+    for (int i = 0; i < 8; ++i) {
+      group.fork([&]() { ran++; });
+    }
+    group.join();
+    *done.lockExclusive() = true;
+  });
+  done.when([](bool value) { return value; }, [](bool&) {}, zc::none);
+  ZC_EXPECT(ran == 8, ran);
+}
+
+ZC_TEST("ThreadPool: Join Rethrows Forked Exception") {
+  ThreadPool pool(2);
+  TaskGroup group(pool);
+  std::atomic<int> ran = 0;
+  group.fork([&]() { ran++; });
+  group.fork([&]() {
+    ran++;
+    ZC_FAIL_REQUIRE("forked failure");
+  });
+  ZC_EXPECT_THROW_MESSAGE("forked failure", group.join());
+  ZC_EXPECT(ran == 2, ran);
+}
+
+ZC_TEST("ThreadPool: Cancel Skips Tasks Not Started") {
+  ThreadPool pool(1);
+  zc::MutexGuarded<bool> release(false);
+  std::atomic<int> ran = 0;
+  {
+    TaskGroup group(pool);
+    // The only worker is held by the first task, so the rest are still queued when cancelled.
+    group.fork([&]() {
+      release.when([](bool value) { return value; }, [](bool&) {}, zc::none);
+      ran++;
+    });
+    for (int i = 0; i < 8; ++i) {
+      group.fork([&]() { ran++; });
+    }
+    group.cancel();
+    ZC_EXPECT(group.isCancelled());
+    *release.lockExclusive() = true;
+    group.join();
+  }
+  ZC_EXPECT(ran <= 1, ran);
+}
+
+ZC_TEST("ThreadPool: Result Group Collects in Fork Order") {
+  ThreadPool pool(4);
+  ResultGroup<int> group(pool);
+  for (int i = 0; i < 32; ++i) {
+    group.fork([i]() {
+      usleep((zc::MILLISECONDS * (rand() % 2)) / zc::MICROSECONDS);
+      return i * i;
+    });
+  }
+  auto results = group.join();
+  ZC_ASSERT(results.size() == 32);
+  for (int i = 0; i < 32; ++i) { ZC_EXPECT(results[i] == i * i, i); }
+}
+
+ZC_TEST("ThreadPool: Placed Workers Run Every Task") {
+  for (ThreadPool::Placement placement :
+       {ThreadPool::Placement::kCores, ThreadPool::Placement::kNodes}) {
+    ThreadPool pool(4, placement);
+    std::atomic<int> counter{0};
+    std::atomic<bool> pinned{true};
+    TaskGroup group(pool);
+    for (int i = 0; i < 64; ++i) {
+      group.fork([&]() {
+#if __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        ZC_ASSERT(sched_getaffinity(0, sizeof(set), &set) == 0);
+        if (placement == ThreadPool::Placement::kCores && CPU_COUNT(&set) != 1) {
+          pinned.store(false);
+        }
+#endif
+        // Work forked from a placed worker still runs
+        group.fork([&]() { counter.fetch_add(1); });
+      });
+    }
+    group.join();
+    ZC_EXPECT(counter.load() == 64);
+    ZC_EXPECT(pinned.load());
+  }
+}
+
 }  // namespace basic
 }  // namespace compiler
 }  // namespace zomlang
\ No newline at end of file
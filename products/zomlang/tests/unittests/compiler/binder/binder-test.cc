@@ -29,6 +29,7 @@
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 #include "zomlang/compiler/source/manager.h"
 #include "zomlang/compiler/symbol/symbol-table.h"
+#include "zomlang/compiler/symbol/value-symbol.h"
 
 namespace zomlang {
 namespace compiler {
@@ -57,6 +58,7 @@ public:
   using Binder::checkContextualIdentifier;
   using Binder::isBlockScopedContainer;
   using Binder::isContainer;
+  using Binder::lookupSymbolInScope;
 };
 
 ZC_TEST("BinderTest.BindSourceFile_ManyNodes") {
@@ -395,6 +397,13 @@ ZC_TEST("BinderTest.FunctionDeclaration") {
   ZC_EXPECT(!test.diagEngine.hasErrors());
   ZC_EXPECT(funcRef.getSymbol() != zc::none);
   ZC_EXPECT(funcRef.getLocals() != zc::none);
+
+  // The binder finds the symbol from the id it gave the node.
+  ZC_EXPECT(funcRef.getId().isValid());
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(binder.getSymbol(funcRef)) ==
+            &ZC_ASSERT_NONNULL(funcRef.getSymbol()));
+  auto unbound = ast::factory::createIdentifier("bar"_zc);
+  ZC_EXPECT(binder.getSymbol(*unbound) == zc::none);
 }
 
 ZC_TEST("BinderTest.ClassDeclaration") {
@@ -719,6 +728,62 @@ ZC_TEST("BinderTest.ScopeResolution") {
   // exposed we primarily rely on no errors during binding for this unit test level
 }
 
+ZC_TEST("BinderTest.ResolutionCacheFollowsDeclarations") {
+  BinderTest test;
+  TestBinder binder(test.symbolTable, test.diagEngine);
+  auto& scopeManager = test.symbolTable.getScopeManager();
+  symbol::Scope& globalScope = ZC_ASSERT_NONNULL(scopeManager.getGlobalScopeMutable());
+  symbol::Scope& blockScope =
+      scopeManager.createScope(symbol::Scope::Kind::Block, "block", globalScope);
+
+  // A cached miss is dropped once the name is declared.
+  ZC_EXPECT(binder.lookupSymbolInScope("x"_zc, blockScope) == zc::none);
+  symbol::Symbol& outer = test.symbolTable.createVariable("x"_zc, globalScope);
+  ZC_IF_SOME(found, binder.lookupSymbolInScope("x"_zc, blockScope)) {
+    ZC_EXPECT(&found == &outer);
+  }
+  else { ZC_FAIL_EXPECT("outer x not resolved"); }
+
+  // A cached hit is dropped once an inner declaration shadows it, and again once it is dropped.
+  symbol::Symbol& inner = test.symbolTable.createVariable("x"_zc, blockScope);
+  ZC_IF_SOME(found, binder.lookupSymbolInScope("x"_zc, blockScope)) {
+    ZC_EXPECT(&found == &inner);
+  }
+  else { ZC_FAIL_EXPECT("inner x not resolved"); }
+  test.symbolTable.dropSymbol(inner, blockScope);
+  ZC_IF_SOME(found, binder.lookupSymbolInScope("x"_zc, blockScope)) {
+    ZC_EXPECT(&found == &outer);
+  }
+  else { ZC_FAIL_EXPECT("outer x not resolved after drop"); }
+}
+
+ZC_TEST("BinderTest.ScopeNamesOutliveSourceFile") {
+  BinderTest test;
+  Binder binder(test.symbolTable, test.diagEngine);
+
+  auto bindFunction = [&](zc::StringPtr fileName, zc::StringPtr functionName) {
+    zc::Vector<zc::Own<ast::Statement>> statements;
+    statements.add(ast::factory::createFunctionDeclaration(
+        ast::factory::createIdentifier(functionName), {}, {}, zc::none,
+        ast::factory::createBlockStatement({})));
+    auto sourceFile =
+        ast::factory::createSourceFile(zc::str(fileName), zc::none, zc::mv(statements));
+    binder.bindSourceFile(*sourceFile);
+    return sourceFile;
+  };
+
+  // Binding the second file must not invalidate the names of the first file's scopes.
+  auto first = bindFunction("first.zom"_zc, "f"_zc);
+  auto second = bindFunction("second.zom"_zc, "g"_zc);
+
+  auto& scopeManager = test.symbolTable.getScopeManager();
+  ZC_IF_SOME(scope, scopeManager.getFunctionScope("function#1:f"_zc)) {
+    ZC_EXPECT(scope.getName() == "function#1:f");
+  }
+  else { ZC_FAIL_EXPECT("scope of the first file's function not found"); }
+  ZC_EXPECT(scopeManager.getFunctionScope("function#1:g"_zc) != zc::none);
+}
+
 ZC_TEST("BinderTest.VisitModuleNodesDirectly") {
   BinderTest test;
   Binder binder(test.symbolTable, test.diagEngine);
@@ -12,11 +12,17 @@
 // See the License for the specific language governing permissions and limitations under
 // the License.
 
+#include "zomlang/compiler/checker/checker.h"
+
 #include "zc/core/common.h"
 #include "zc/core/string.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/cast.h"
 #include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
 #include "zomlang/compiler/parser/parser.h"
 #include "zomlang/compiler/source/manager.h"
@@ -25,64 +31,210 @@ namespace zomlang {
 namespace compiler {
 namespace checker {
 
-ZC_TEST("CheckerTest_BasicParsingWorks") {
-  auto sourceManager = zc::heap<source::SourceManager>();
-  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+namespace {
+
+using diagnostics::DiagID;
+
+class CaptureConsumer final : public diagnostics::DiagnosticConsumer {
+public:
+  zc::Vector<DiagID> ids;
+
+  void handleDiagnostic(const source::SourceManager& sm,
+                        const diagnostics::Diagnostic& diagnostic) override {
+    ids.add(diagnostic.getId());
+  }
+};
+
+/// Parses the given files and checks them together.
+class CheckerTest {
+public:
+  CheckerTest() : diagnosticEngine(sourceManager), threadPool(4) {
+    auto consumer = zc::heap<CaptureConsumer>();
+    captured = consumer.get();
+    diagnosticEngine.addConsumer(zc::mv(consumer));
+  }
+
+  void addFile(zc::StringPtr name, zc::StringPtr code) {
+    auto bufferId = sourceManager.addMemBufferCopy(code.asBytes(), name);
+    parser::Parser parser(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+    ZC_IF_SOME(ast, parser.parse()) {
+      asts.add(zc::mv(ast));
+    } else {
+      ZC_FAIL_ASSERT("failed to parse", name);
+    }
+  }
+
+  bool check() {
+    zc::Vector<const ast::SourceFile*> files;
+    for (const auto& ast : asts) { files.add(&ast::cast<ast::SourceFile>(*ast)); }
+    return checker.check(files.asPtr());
+  }
+
+  zc::ArrayPtr<const DiagID> getDiagnostics() const { return captured->ids.asPtr(); }
+
+  source::SourceManager sourceManager;
+  diagnostics::DiagnosticEngine diagnosticEngine;
+  basic::ThreadPool threadPool;
+  TypeChecker checker{diagnosticEngine, threadPool};
+
+private:
   basic::LangOptions langOpts;
   basic::StringPool stringPool;
+  zc::Vector<zc::Own<ast::Node>> asts;
+  CaptureConsumer* captured;
+};
 
-  auto bufferId =
-      sourceManager->addMemBufferCopy(zc::str("let x: i32 = 42;").asBytes(), "test.zom");
-  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
-  auto ast = parser.parse();
+}  // namespace
 
-  ZC_EXPECT(ast != zc::none, "Parser should successfully parse valid code");
-  // TODO: Add type checking once Checker implementation is available
+ZC_TEST("CheckerTest_BasicParsingWorks") {
+  CheckerTest test;
+  test.addFile("test.zom", "let x: i32 = 42;\nlet y = x;\n");
+
+  ZC_EXPECT(test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 0);
+  ZC_IF_SOME(type, test.checker.getGlobalType("test.zom", "y")) {
+    ZC_EXPECT(type.getKind() == TypeKind::kI32);
+  } else {
+    ZC_FAIL_EXPECT("y has no type");
+  }
 }
 
 ZC_TEST("CheckerTest_TypeMismatchError") {
-  auto sourceManager = zc::heap<source::SourceManager>();
-  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
-  basic::LangOptions langOpts;
-  basic::StringPool stringPool;
-
-  auto bufferId =
-      sourceManager->addMemBufferCopy(zc::str("let x: i32 = \"string\";").asBytes(), "test.zom");
-  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
-  auto ast = parser.parse();
+  CheckerTest test;
+  test.addFile("test.zom", "let x: i32 = \"string\";");
 
-  ZC_EXPECT(ast != zc::none, "Parser should parse syntactically valid code");
-  // TODO: Add type checking once Checker implementation is available
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 1);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::TypeMismatch);
 }
 
 ZC_TEST("CheckerTest_UndefinedVariableError") {
-  auto sourceManager = zc::heap<source::SourceManager>();
-  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
-  basic::LangOptions langOpts;
-  basic::StringPool stringPool;
-
-  auto bufferId =
-      sourceManager->addMemBufferCopy(zc::str("let x: i32 = y + 1;").asBytes(), "test.zom");
-  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
-  auto ast = parser.parse();
+  CheckerTest test;
+  test.addFile("test.zom", "let x: i32 = y + 1;");
 
-  ZC_EXPECT(ast != zc::none);
-  // TODO: Add type checking once Checker implementation is available
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 1);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::UndefinedIdentifier);
 }
 
 ZC_TEST("CheckerTest_FunctionParameterTypeChecking") {
-  auto sourceManager = zc::heap<source::SourceManager>();
-  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
-  basic::LangOptions langOpts;
-  basic::StringPool stringPool;
+  CheckerTest test;
+  test.addFile("test.zom", "fun add(a: i32, b: str) -> i32 { return a + b; }\n");
+
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.checker.getCheckedBodyCount() == 1);
+  ZC_EXPECT(test.getDiagnostics().size() == 1);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::TypeMismatch);
+}
+
+ZC_TEST("CheckerTest_LiteralsTakeTheExpectedType") {
+  CheckerTest test;
+  test.addFile("test.zom",
+               "fun scale(x: i64, y: f32) -> i64 {\n"
+               "  let z: f32 = y * 2;\n"
+               "  let w: i32? = null;\n"
+               "  return 2 * x + 1;\n"
+               "}\n");
+
+  ZC_EXPECT(test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 0);
+}
+
+ZC_TEST("CheckerTest_CallsAreCheckedAgainstSignatures") {
+  CheckerTest test;
+  test.addFile("test.zom",
+               "fun twice(x: i32) -> i32 { return x * 2; }\n"
+               "fun caller() -> str {\n"
+               "  let a = twice(1, 2);\n"
+               "  let b = twice(\"one\");\n"
+               "  return twice(3);\n"
+               "}\n");
+
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 3);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::ArgumentCountMismatch);
+  ZC_EXPECT(test.getDiagnostics()[1] == DiagID::TypeMismatch);
+  ZC_EXPECT(test.getDiagnostics()[2] == DiagID::TypeMismatch);
+}
+
+ZC_TEST("CheckerTest_LocalsAreScopedToTheirBlock") {
+  CheckerTest test;
+  test.addFile("test.zom",
+               "fun f(x: i32) -> i32 {\n"
+               "  if (x > 0) {\n"
+               "    let inner = x;\n"
+               "  }\n"
+               "  return inner;\n"
+               "}\n");
+
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 1);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::UndefinedIdentifier);
+}
+
+ZC_TEST("CheckerTest_GenericCallsAreInstantiated") {
+  CheckerTest test;
+  test.addFile("test.zom",
+               "fun identity<T>(value: T) -> T { return value; }\n"
+               "fun wrong<T>(value: T) -> T { return 1; }\n"
+               "fun first<T>(values: T[], fallback: T) -> T { return fallback; }\n"
+               "fun use(x: i64) -> i64 {\n"
+               "  let s: str = identity(\"text\");\n"
+               "  let n: str = identity(1);\n"
+               "  let m: i64 = first([x], 0);\n"
+               "  return identity(x);\n"
+               "}\n");
+
+  ZC_EXPECT(!test.check());
+  // Returning an i32 as a T, and an identity of an i32 as a str
+  ZC_EXPECT(test.getDiagnostics().size() == 2);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::TypeMismatch);
+  ZC_EXPECT(test.getDiagnostics()[1] == DiagID::TypeMismatch);
+}
+
+ZC_TEST("CheckerTest_UnionsAcceptEachMember") {
+  CheckerTest test;
+  test.addFile("test.zom",
+               "fun pick(a: i32 | str, b: bool) -> str | i32 { return a; }\n"
+               "let x: i32 | str = 1;\n"
+               "let y: i32 | str = \"one\";\n"
+               "let z: i32 | str = true;\n");
+
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 1);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::TypeMismatch);
+}
+
+ZC_TEST("CheckerTest_ImportedModulesAreVisibleThroughTheirAlias") {
+  CheckerTest test;
+  test.addFile("a.zom", "module gen.a;\n\nfun f(x: i32, name: str) -> i32 { return x; }\n");
+  test.addFile("b.zom",
+               "module gen.b;\n\nimport gen.a as a;\n\n"
+               "fun g(x: i32) -> i32 {\n"
+               "  let y: str = a.f(x, \"call\");\n"
+               "  return a.missing(x);\n"
+               "}\n");
+
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.getDiagnostics().size() == 2);
+  ZC_EXPECT(test.getDiagnostics()[0] == DiagID::TypeMismatch);
+  ZC_EXPECT(test.getDiagnostics()[1] == DiagID::UndefinedIdentifier);
+}
 
-  auto bufferId = sourceManager->addMemBufferCopy(
-      zc::str("fun add(a: i32, b: str) -> i32 { return a + b; }\n").asBytes(), "test.zom");
-  parser::Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
-  auto ast = parser.parse();
+ZC_TEST("CheckerTest_BodiesAreCheckedInParallel") {
+  CheckerTest test;
+  zc::Vector<zc::String> functions;
+  for (size_t i = 0; i < 200; ++i) {
+    // Every other body returns a string from an i32 function
+    functions.add(zc::str("fun f", i, "(x: i32) -> i32 {\n  let y = x + ", i, ";\n  return ",
+                          i % 2 == 0 ? "y" : "\"wrong\"", ";\n}\n"));
+  }
+  test.addFile("test.zom", zc::strArray(functions, ""));
 
-  ZC_EXPECT(ast != zc::none);
-  // TODO: Add type checking once Checker implementation is available
+  ZC_EXPECT(!test.check());
+  ZC_EXPECT(test.checker.getCheckedBodyCount() == 200);
+  ZC_EXPECT(test.getDiagnostics().size() == 100);
+  for (DiagID id : test.getDiagnostics()) { ZC_EXPECT(id == DiagID::TypeMismatch); }
 }
 
 }  // namespace checker
@@ -0,0 +1,195 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/checker/types.h"
+
+#include <atomic>
+
+#include "zc/core/common.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+
+namespace zomlang {
+namespace compiler {
+namespace checker {
+
+namespace {
+
+const Type& i32() { return Type::get(TypeKind::kI32); }
+const Type& str() { return Type::get(TypeKind::kStr); }
+const Type& null() { return Type::get(TypeKind::kNull); }
+
+}  // namespace
+
+ZC_TEST("TypeInternerTest_StructuralTypesAreMadeOnce") {
+  TypeInterner types;
+  const Type* parameters[] = {&i32(), &str()};
+
+  ZC_EXPECT(&types.array(i32()) == &types.array(i32()));
+  ZC_EXPECT(&types.array(i32()) != &types.array(str()));
+  ZC_EXPECT(&types.optional(types.array(i32())) == &types.optional(types.array(i32())));
+  ZC_EXPECT(&types.function(parameters, 2, false, i32()) ==
+            &types.function(parameters, 2, false, i32()));
+  ZC_EXPECT(&types.function(parameters, 2, false, i32()) !=
+            &types.function(parameters, 1, false, i32()));
+  ZC_EXPECT(&types.named("Box") == &types.named("Box"));
+  ZC_EXPECT(types.size() == 6);
+}
+
+ZC_TEST("TypeInternerTest_TypeParametersAreDistinct") {
+  TypeInterner types;
+  const Type& t = types.typeParameter("T");
+  const Type& u = types.typeParameter("T");
+
+  ZC_EXPECT(&t != &u);
+  ZC_EXPECT(t.isGeneric());
+  ZC_EXPECT(types.array(t).isGeneric());
+  ZC_EXPECT(!types.array(i32()).isGeneric());
+}
+
+ZC_TEST("TypeInternerTest_UnionsAreCanonical") {
+  TypeInterner types;
+  const Type* forward[] = {&i32(), &str()};
+  const Type* backward[] = {&str(), &i32(), &str()};
+  const Type& left = types.unionOf(forward);
+  const Type& right = types.unionOf(backward);
+
+  ZC_EXPECT(left.getKind() == TypeKind::kUnion);
+  ZC_EXPECT(&left == &right);
+  ZC_EXPECT(left.getMembers().size() == 2);
+  // Members are ordered by id, and builtin ids follow TypeKind, where str comes before i32.
+  ZC_EXPECT(left.toString() == "str | i32", left.toString());
+
+  const Type* nested[] = {&left, &i32()};
+  ZC_EXPECT(&types.unionOf(nested) == &left);
+
+  const Type* single[] = {&i32(), &i32()};
+  ZC_EXPECT(&types.unionOf(single) == &i32());
+
+  const Type* withNull[] = {&i32(), &null(), &str()};
+  const Type& optional = types.unionOf(withNull);
+  ZC_EXPECT(&optional == &types.optional(left));
+  ZC_EXPECT(optional.toString() == "(str | i32)?", optional.toString());
+}
+
+ZC_TEST("TypeInternerTest_UnionsAreAssignableByMember") {
+  TypeInterner types;
+  const Type* members[] = {&i32(), &str()};
+  const Type& either = types.unionOf(members);
+
+  ZC_EXPECT(isAssignable(i32(), either));
+  ZC_EXPECT(isAssignable(str(), either));
+  ZC_EXPECT(!isAssignable(Type::get(TypeKind::kBool), either));
+  ZC_EXPECT(!isAssignable(either, i32()));
+  ZC_EXPECT(isAssignable(either, types.optional(either)));
+}
+
+ZC_TEST("TypeInternerTest_InstantiationsAreCached") {
+  TypeInterner types;
+  const Type& t = types.typeParameter("T");
+  const Type* typeParameters[] = {&t};
+  const Type* parameters[] = {&types.array(t)};
+  const Type& generic = types.function(parameters, 1, false, types.optional(t), typeParameters);
+  ZC_EXPECT(generic.toString() == "<T>(T[]) -> T?");
+
+  const Type* arguments[] = {&i32()};
+  const Type& instance = types.instantiate(generic, arguments);
+  ZC_EXPECT(!instance.isGeneric());
+  ZC_EXPECT(instance.getTypeParameters().size() == 0);
+  ZC_EXPECT(instance.toString() == "(i32[]) -> i32?");
+
+  const size_t size = types.size();
+  ZC_EXPECT(&types.instantiate(generic, arguments) == &instance);
+  ZC_EXPECT(types.size() == size);
+
+  const Type* others[] = {&str()};
+  ZC_EXPECT(&types.instantiate(generic, others) != &instance);
+}
+
+ZC_TEST("TypeInternerTest_ChildrenShareTheirParentsTypes") {
+  TypeInterner parent;
+  const Type& array = parent.array(i32());
+  const Type& t = parent.typeParameter("T");
+  const Type* typeParameters[] = {&t};
+  const Type* parameters[] = {&t};
+  const Type& generic = parent.function(parameters, 1, false, t, typeParameters);
+  const Type* arguments[] = {&i32()};
+  const Type& instance = parent.instantiate(generic, arguments);
+  const size_t parentSize = parent.size();
+
+  TypeInterner child{zc::Maybe<const TypeInterner&>(parent)};
+  ZC_EXPECT(&child.array(i32()) == &array);
+  ZC_EXPECT(&child.instantiate(generic, arguments) == &instance);
+  ZC_EXPECT(child.size() == 0);
+
+  const Type& fresh = child.array(str());
+  ZC_EXPECT(fresh.getId() > instance.getId());
+  ZC_EXPECT(child.size() == 1);
+  ZC_EXPECT(parent.size() == parentSize);
+}
+
+ZC_TEST("AssignabilityCacheTest_RecordsRelationsBetweenFrozenTypes") {
+  TypeInterner types;
+  const Type* members[] = {&i32(), &str()};
+  const Type& either = types.unionOf(members);
+  const Type& arrays = types.array(either);
+  AssignabilityCache cache(types);
+  ZC_EXPECT(cache.covers(either, arrays));
+
+  const Type& fresh = types.array(i32());
+  ZC_EXPECT(!cache.covers(fresh, arrays));
+  ZC_EXPECT(isAssignable(fresh, arrays, cache));
+  // Only the relation between the elements is old enough to be recorded
+  ZC_EXPECT(cache.size() == 1);
+  ZC_EXPECT(cache.find(i32(), either) == true);
+
+  ZC_EXPECT(!isAssignable(either, i32(), cache));
+  ZC_EXPECT(cache.find(either, i32()) == false);
+  ZC_EXPECT(cache.find(i32(), arrays) == zc::none);
+
+  // The same type and primitive types are decided without the cache
+  ZC_EXPECT(isAssignable(either, either, cache));
+  ZC_EXPECT(!isAssignable(str(), i32(), cache));
+  ZC_EXPECT(cache.size() == 2);
+}
+
+ZC_TEST("AssignabilityCacheTest_IsSharedBetweenThreads") {
+  TypeInterner types;
+  const Type* members[] = {&i32(), &str(), &Type::get(TypeKind::kBool)};
+  const Type& either = types.unionOf(members);
+  const Type& arrays = types.array(either);
+  const Type& nested = types.array(types.optional(either));
+  AssignabilityCache cache(types);
+
+  basic::ThreadPool threadPool(4);
+  basic::TaskGroup group(threadPool);
+  std::atomic<size_t> wrong{0};
+  for (size_t i = 0; i < 64; ++i) {
+    group.fork([&]() {
+      TypeInterner local{zc::Maybe<const TypeInterner&>(types)};
+      if (!isAssignable(arrays, nested, cache)) { ++wrong; }
+      if (isAssignable(nested, arrays, cache)) { ++wrong; }
+      if (!isAssignable(local.array(i32()), nested, cache)) { ++wrong; }
+    });
+  }
+  group.join();
+
+  ZC_EXPECT(wrong == 0);
+  ZC_EXPECT(cache.find(arrays, nested) == true);
+  ZC_EXPECT(cache.find(nested, arrays) == false);
+}
+
+}  // namespace checker
+}  // namespace compiler
+}  // namespace zomlang
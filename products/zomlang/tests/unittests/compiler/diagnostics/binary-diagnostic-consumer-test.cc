@@ -0,0 +1,97 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+/// \file
+/// \brief Unit tests for the binary diagnostic consumer and its reader.
+
+#include "zomlang/compiler/diagnostics/binary-diagnostic-consumer.h"
+
+#include "zc/core/common.h"
+#include "zc/core/debug.h"
+#include "zc/core/io.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/diagnostics/diagnostic-ids.h"
+#include "zomlang/compiler/diagnostics/diagnostic.h"
+#include "zomlang/compiler/source/location.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace diagnostics {
+
+ZC_TEST("BinaryDiagnosticConsumerTest: RoundTrip") {
+  source::SourceManager sourceManager;
+  const source::BufferId bufferId =
+      sourceManager.addMemBufferCopy("let a = 1;\nlet a = 2;\n"_zcb, "redeclare.zom");
+  const source::SourceLoc secondA = sourceManager.getLocForOffset(bufferId, 15);
+
+  zc::VectorOutputStream stream;
+  {
+    DiagnosticEngine engine(sourceManager);
+    engine.addConsumer(zc::heap<BinaryDiagnosticConsumer>(
+        zc::Own<zc::OutputStream>(&stream, zc::NullDisposer::instance)));
+    engine.diagnose<DiagID::RedeclareVariable>(secondA, zc::StringPtr("a"))
+        .addRange(source::CharSourceRange(secondA, 1u))
+        .addChild(zc::heap<Diagnostic>(DiagID::InvalidCharacter, source::SourceLoc()));
+    engine.diagnose<DiagID::InvalidPath>(source::SourceLoc(), zc::StringPtr("missing.zom"));
+  }
+
+  zc::ArrayInputStream input(stream.getArray());
+  DecodedDiagnostics decoded = readBinaryDiagnostics(input);
+  ZC_ASSERT(decoded.diagnostics.size() == 2);
+
+  const DecodedDiagnostic& first = decoded.diagnostics[0];
+  ZC_EXPECT(first.id == DiagID::RedeclareVariable);
+  ZC_EXPECT(first.severity == DiagSeverity::kError);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(decoded.files.find(first.bufferId)) == "redeclare.zom");
+  ZC_EXPECT(first.offset == 15);
+  ZC_EXPECT(first.line == 2);
+  ZC_EXPECT(first.column == 5);
+  ZC_ASSERT(first.args.size() == 1);
+  ZC_EXPECT(first.args[0] == "a");
+  ZC_ASSERT(first.ranges.size() == 1);
+  ZC_EXPECT(first.ranges[0].bufferId == first.bufferId);
+  ZC_EXPECT(first.ranges[0].offset == 15);
+  ZC_EXPECT(first.ranges[0].length == 1);
+  ZC_ASSERT(first.children.size() == 1);
+  ZC_EXPECT(first.children[0].id == DiagID::InvalidCharacter);
+  ZC_EXPECT(first.children[0].bufferId == 0);
+
+  const DecodedDiagnostic& second = decoded.diagnostics[1];
+  ZC_EXPECT(second.id == DiagID::InvalidPath);
+  ZC_EXPECT(second.bufferId == 0);
+  ZC_ASSERT(second.args.size() == 1);
+  ZC_EXPECT(second.args[0] == "missing.zom");
+}
+
+ZC_TEST("BinaryDiagnosticConsumerTest: RejectsOtherStreams") {
+  zc::ArrayInputStream notAStream("ZAST and then some"_zcb);
+  ZC_EXPECT_THROW_MESSAGE("not a zomlang diagnostics stream", readBinaryDiagnostics(notAStream));
+
+  // A stream cut off inside a record
+  source::SourceManager sourceManager;
+  zc::VectorOutputStream stream;
+  {
+    BinaryDiagnosticConsumer consumer(
+        zc::Own<zc::OutputStream>(&stream, zc::NullDisposer::instance));
+    consumer.handleDiagnostic(sourceManager, Diagnostic(DiagID::InvalidCharacter, {}));
+  }
+  zc::ArrayInputStream truncated(stream.getArray().first(stream.getArray().size() - 1));
+  ZC_EXPECT_THROW(FAILED, readBinaryDiagnostics(truncated));
+}
+
+}  // namespace diagnostics
+}  // namespace compiler
+}  // namespace zomlang
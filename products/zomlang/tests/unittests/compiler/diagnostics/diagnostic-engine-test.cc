@@ -0,0 +1,170 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+/// \file
+/// \brief Unit tests for the diagnostic engine.
+///
+/// This file contains ztest-based unit tests for the diagnostic engine, testing buffered
+/// emission from several threads and per-thread suppression.
+
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+
+#include "zc/core/common.h"
+#include "zc/core/debug.h"
+#include "zc/core/io.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+#include "zomlang/compiler/diagnostics/diagnostic-consumer.h"
+#include "zomlang/compiler/diagnostics/diagnostic-ids.h"
+#include "zomlang/compiler/diagnostics/diagnostic-info.h"
+#include "zomlang/compiler/diagnostics/diagnostic-state.h"
+#include "zomlang/compiler/diagnostics/diagnostic.h"
+#include "zomlang/compiler/source/location.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace diagnostics {
+
+namespace {
+
+class RecordingConsumer final : public DiagnosticConsumer {
+public:
+  explicit RecordingConsumer(zc::Vector<uint32_t>& locations) : locations(locations) {}
+
+  void handleDiagnostic(const source::SourceManager& sm, const Diagnostic& diagnostic) override {
+    (void)sm;
+    locations.add(diagnostic.getLoc().getOpaqueValue());
+  }
+
+private:
+  zc::Vector<uint32_t>& locations;
+};
+
+}  // namespace
+
+ZC_TEST("DiagnosticEngineTest: FlushesBufferedDiagnosticsByLocation") {
+  source::SourceManager sourceManager;
+  const source::BufferId first = sourceManager.addMemBufferCopy("let a = 1;\n"_zcb, "first.zom");
+  const source::BufferId second = sourceManager.addMemBufferCopy("let b = 2;\n"_zcb, "second.zom");
+
+  zc::Vector<uint32_t> locations;
+  DiagnosticEngine engine(sourceManager);
+  engine.addConsumer(zc::heap<RecordingConsumer>(locations));
+
+  engine.beginBuffering();
+  {
+    basic::ThreadPool pool(4);
+    basic::TaskGroup group(pool);
+    // Each file reports back to front, and the two files race each other
+    for (source::BufferId bufferId : {second, first}) {
+      group.fork([&engine, &sourceManager, bufferId]() -> void {
+        for (unsigned offset = 10; offset-- > 0;) {
+          engine.diagnose<DiagID::InvalidCharacter>(
+              sourceManager.getLocForOffset(bufferId, offset));
+        }
+      });
+    }
+    group.join();
+  }
+  ZC_EXPECT(locations.empty(), "buffered diagnostics must wait for the flush");
+  ZC_EXPECT(engine.hasErrors());
+
+  engine.flushBuffered();
+  ZC_ASSERT(locations.size() == 20);
+  for (size_t i = 1; i < locations.size(); ++i) { ZC_EXPECT(locations[i - 1] < locations[i]); }
+  ZC_EXPECT(locations[0] == sourceManager.getLocForBufferStart(first).getOpaqueValue());
+
+  // Once flushed, diagnostics reach the consumers right away again
+  engine.diagnose<DiagID::InvalidCharacter>(sourceManager.getLocForBufferStart(first));
+  ZC_EXPECT(locations.size() == 21);
+}
+
+ZC_TEST("DiagnosticEngineTest: SuppressionIsPerThread") {
+  source::SourceManager sourceManager;
+  const source::BufferId bufferId = sourceManager.addMemBufferCopy("let a = 1;\n"_zcb, "a.zom");
+  zc::Vector<uint32_t> locations;
+  DiagnosticEngine engine(sourceManager);
+  engine.addConsumer(zc::heap<RecordingConsumer>(locations));
+
+  engine.suppress();
+  engine.beginBuffering();
+  {
+    basic::ThreadPool pool(1);
+    basic::TaskGroup group(pool);
+    group.fork([&]() -> void {
+      ZC_EXPECT(!engine.isSuppressed());
+      engine.diagnose<DiagID::InvalidCharacter>(sourceManager.getLocForBufferStart(bufferId));
+    });
+    group.join();
+  }
+  engine.diagnose<DiagID::InvalidCharacter>(sourceManager.getLocForBufferStart(bufferId));
+  engine.flushBuffered();
+  engine.unsuppress();
+
+  ZC_EXPECT(!engine.isSuppressed());
+  ZC_EXPECT(locations.size() == 1);
+}
+
+ZC_TEST("DiagnosticEngineTest: FormatsPrecompiledMessages") {
+  static_assert(DiagnosticTraits<DiagID::InvalidPath>::segments.size() == 2);
+  static_assert(DiagnosticTraits<DiagID::InvalidCharacter>::segments.size() == 1);
+
+  source::SourceManager sourceManager;
+  zc::VectorOutputStream output;
+  const DiagnosticArgument args[] = {zc::StringPtr("missing.zom")};
+  DiagnosticEngine::formatDiagnosticMessage(
+      sourceManager, output, getDiagnosticInfo(DiagID::InvalidPath), zc::arrayPtr(args, 1));
+  ZC_EXPECT(output.getArray().asChars() ==
+            "Cannot open file path at 'missing.zom', no such file or directory"_zc);
+
+  output.clear();
+  DiagnosticEngine::formatDiagnosticMessage(
+      sourceManager, output, getDiagnosticInfo(DiagID::InvalidCharacter), nullptr);
+  ZC_EXPECT(output.getArray().asChars() == "Invalid character"_zc);
+}
+
+ZC_TEST("DiagnosticEngineTest: DropsDisabledDiagnosticsUpFront") {
+  source::SourceManager sourceManager;
+  const source::BufferId bufferId = sourceManager.addMemBufferCopy("let a = 1;\n"_zcb, "a.zom");
+  const source::SourceLoc loc = sourceManager.getLocForBufferStart(bufferId);
+  zc::Vector<uint32_t> locations;
+  DiagnosticEngine engine(sourceManager);
+  engine.addConsumer(zc::heap<RecordingConsumer>(locations));
+
+  engine.getState().ignoreDiagnostic(DiagID::InvalidCharacter);
+  ZC_EXPECT(!engine.isEnabled(DiagID::InvalidCharacter));
+  ZC_EXPECT(engine.isEnabled(DiagID::UnterminatedString));
+  engine.diagnose<DiagID::InvalidCharacter>(loc).addRange(source::CharSourceRange(loc, 1u));
+  ZC_EXPECT(locations.empty());
+  ZC_EXPECT(!engine.hasErrors(), "an ignored error does not fail the build");
+
+  engine.suppress();
+  ZC_EXPECT(!engine.isEnabled(DiagID::UnterminatedString));
+  engine.diagnose<DiagID::UnterminatedString>(loc);
+  engine.unsuppress();
+  ZC_EXPECT(locations.empty());
+
+  // Moving a diagnostic emits it once
+  {
+    InFlightDiagnostic first = engine.diagnose<DiagID::UnterminatedString>(loc);
+    InFlightDiagnostic second = zc::mv(first);
+  }
+  ZC_EXPECT(locations.size() == 1);
+}
+
+}  // namespace diagnostics
+}  // namespace compiler
+}  // namespace zomlang
@@ -1,5 +1,8 @@
 #include "zomlang/compiler/diagnostics/diagnostic-state.h"
 
+#include <thread>
+
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/diagnostics/diagnostic-ids.h"
 
@@ -39,6 +42,30 @@ ZC_TEST("DiagState MultipleIgnores") {
   ZC_EXPECT(!state.isDiagnosticIgnored(DiagID::InvalidPath));
 }
 
+ZC_TEST("DiagState ErrorsFromSeveralThreads") {
+  DiagnosticState state;
+  {
+    zc::Vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+      threads.add([&state]() {
+        for (int j = 0; j < 1000; ++j) { state.setHadAnyError(); }
+      });
+    }
+    for (std::thread& thread : threads) { thread.join(); }
+  }
+  ZC_EXPECT(state.getHadAnyError());
+  ZC_EXPECT(!state.getHadFatalError());
+
+  state.setHadFatalError();
+  DiagnosticState moved = zc::mv(state);
+  ZC_EXPECT(moved.getHadAnyError());
+  ZC_EXPECT(moved.getHadFatalError());
+
+  moved.resetErrors();
+  ZC_EXPECT(!moved.getHadAnyError());
+  ZC_EXPECT(!moved.getHadFatalError());
+}
+
 }  // namespace diagnostics
 }  // namespace compiler
 }  // namespace zomlang
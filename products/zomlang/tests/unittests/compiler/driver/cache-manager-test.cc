@@ -0,0 +1,108 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/cache-manager.h"
+
+#include "zc/core/filesystem.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/symbol/module-index.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+namespace {
+
+/// An index of one function, `name` of module `moduleName`, declared 10 bytes past `base`.
+symbol::ModuleIndex makeIndex(zc::StringPtr moduleName, zc::StringPtr name,
+                              source::SourceLoc base) {
+  const symbol::ModuleIndex::ExportedSymbol symbols[] = {
+      {name, symbol::SymbolKind::Function, symbol::SymbolFlags::Function,
+       source::SourceRange(base + 10, base + 20)},
+  };
+  return symbol::ModuleIndex(moduleName, symbols, base);
+}
+
+}  // namespace
+
+ZC_TEST("CacheManagerTest.SpillsLeastRecentlyUsedEntries") {
+  const source::SourceLoc base = source::SourceLoc::getFromOpaqueValue(100);
+  const size_t imageSize = makeIndex("a"_zc, "f"_zc, base).serialize().size();
+  auto spillDir = zc::newInMemoryDirectory(zc::nullClock());
+  const zc::Directory& dir = *spillDir;
+  CacheManager cache(imageSize * 2, zc::mv(spillDir));
+
+  cache.putModuleIndex("a.zidx"_zc, makeIndex("a"_zc, "f"_zc, base));
+  cache.putModuleIndex("b.zidx"_zc, makeIndex("b"_zc, "f"_zc, base));
+  auto maybeA = cache.getModuleIndex("a.zidx"_zc, base);
+  symbol::ModuleIndex& a = ZC_ASSERT_NONNULL(maybeA);
+
+  // "b" was used least recently, so it makes room for "c".
+  cache.putModuleIndex("c.zidx"_zc, makeIndex("c"_zc, "f"_zc, base));
+  CacheManager::Statistics statistics = cache.getStatistics();
+  ZC_EXPECT(statistics.hits == 1, statistics.hits);
+  ZC_EXPECT(statistics.evictions == 1, statistics.evictions);
+  ZC_EXPECT(statistics.hotEntries == 2, statistics.hotEntries);
+  ZC_EXPECT(statistics.hotBytes == imageSize * 2, statistics.hotBytes);
+  ZC_EXPECT(dir.listNames().size() == 1);
+  ZC_EXPECT(dir.exists(zc::Path("b.zidx")));
+  ZC_EXPECT(cache.contains("b.zidx"_zc));
+
+  // Reloading "b" maps its file back in, rebased on the caller's location, and evicts "a", which
+  // was never written before and is now. The index viewing it stays valid.
+  const source::SourceLoc otherBase = source::SourceLoc::getFromOpaqueValue(5000);
+  auto maybeB = cache.getModuleIndex("b.zidx"_zc, otherBase);
+  symbol::ModuleIndex& b = ZC_ASSERT_NONNULL(maybeB);
+  ZC_EXPECT(b.getModuleName() == "b"_zc);
+  auto f = ZC_ASSERT_NONNULL(b.find("f"_zc));
+  ZC_EXPECT(b.getSourceRange(f).getStart() == otherBase + 10);
+  ZC_EXPECT(dir.exists(zc::Path("a.zidx")));
+  ZC_EXPECT(a.getModuleName() == "a"_zc);
+  ZC_EXPECT(a.find("f"_zc) != zc::none);
+
+  statistics = cache.getStatistics();
+  ZC_EXPECT(statistics.reloads == 1, statistics.reloads);
+  ZC_EXPECT(statistics.evictions == 2, statistics.evictions);
+  ZC_EXPECT(cache.getMemoryUsage().usedBytes >= imageSize * 2);
+
+  // Entries reloaded from the spill directory are not written again when evicted.
+  cache.putModuleIndex("d.zidx"_zc, makeIndex("d"_zc, "f"_zc, base));
+  cache.putModuleIndex("e.zidx"_zc, makeIndex("e"_zc, "f"_zc, base));
+  ZC_EXPECT(dir.listNames().size() == 3);
+  ZC_EXPECT(cache.getModuleIndex("missing.zidx"_zc, base) == zc::none);
+  ZC_EXPECT(cache.getStatistics().misses == 1);
+}
+
+ZC_TEST("CacheManagerTest.DropsEvictedEntriesWithoutSpillDir") {
+  const source::SourceLoc base = source::SourceLoc::getFromOpaqueValue(100);
+  const size_t imageSize = makeIndex("a"_zc, "f"_zc, base).serialize().size();
+  CacheManager cache(imageSize, zc::none);
+
+  cache.putModuleIndex("a.zidx"_zc, makeIndex("a"_zc, "f"_zc, base));
+  cache.putModuleIndex("b.zidx"_zc, makeIndex("b"_zc, "f"_zc, base));
+  ZC_EXPECT(!cache.contains("a.zidx"_zc));
+  ZC_EXPECT(cache.getModuleIndex("a.zidx"_zc, base) == zc::none);
+  ZC_EXPECT(cache.getModuleIndex("b.zidx"_zc, base) != zc::none);
+
+  // An entry larger than the whole budget is not kept at all.
+  CacheManager tiny(imageSize - 1, zc::none);
+  tiny.putModuleIndex("a.zidx"_zc, makeIndex("a"_zc, "f"_zc, base));
+  ZC_EXPECT(tiny.getStatistics().hotEntries == 0);
+  ZC_EXPECT(tiny.getStatistics().hotBytes == 0);
+}
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
@@ -14,13 +14,25 @@
 
 #include "zomlang/compiler/driver/driver.h"
 
+#include <unistd.h>
+
 #include "zc/core/filesystem.h"
 #include "zc/core/string.h"
 #include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/compact.h"
+#include "zomlang/compiler/ast/cast.h"
 #include "zomlang/compiler/ast/expression.h"
+#include "zomlang/compiler/ast/module.h"
 #include "zomlang/compiler/ast/type.h"
 #include "zomlang/compiler/basic/compiler-opts.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/driver/cache-manager.h"
+#include "zomlang/compiler/lexer/import-scan.h"
 #include "zomlang/compiler/source/manager.h"
+#include "zomlang/compiler/symbol/scope.h"
+#include "zomlang/compiler/symbol/symbol-table.h"
+#include "zomlang/compiler/symbol/symbol.h"
 
 namespace zomlang {
 namespace compiler {
@@ -88,6 +100,630 @@ ZC_TEST("DriverTest.AddSourceFileEmpty") {
   ZC_EXPECT(result == zc::none);
 }
 
+ZC_TEST("DriverTest.ParsesWithPerBufferStringPools") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-buffer-pools-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  langOpts.perBufferStringPools = true;
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  zc::Vector<source::BufferId> bufferIds;
+  for (int i = 0; i < 4; ++i) {
+    const zc::Path path = root.append(zc::str("pool-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll("let shared = 1;\n"_zc);
+    bufferIds.add(ZC_ASSERT_NONNULL(driver->addSourceFile(path.toString(true))));
+  }
+  ZC_ASSERT(driver->parseSources());
+
+  // Every buffer parsed, and its strings outlive the workers that interned them.
+  const auto& asts = driver->getASTs();
+  ZC_EXPECT(asts.size() == bufferIds.size());
+  for (const source::BufferId& bufferId : bufferIds) {
+    const ast::CompactTree tree(*ZC_ASSERT_NONNULL(asts.find(bufferId)));
+    bool sawShared = false;
+    for (ast::CompactTree::NodeIndex i = 0; i < tree.size(); ++i) {
+      ZC_IF_SOME(text, tree.getText(i)) { sawShared = sawShared || text == "shared"_zc; }
+    }
+    ZC_EXPECT(sawShared);
+  }
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.RecordsParseTimePerFile") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-parse-time-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  // Sizes that differ from the order the files are added in.
+  zc::Vector<source::BufferId> bufferIds;
+  for (int lines : {1, 200, 20}) {
+    zc::Vector<zc::String> declarations;
+    for (int i = 0; i < lines; ++i) { declarations.add(zc::str("let value", i, " = ", i, ";\n")); }
+    const zc::Path path = root.append(zc::str("sized-", lines, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(zc::strArray(declarations, ""));
+    const source::BufferId bufferId = ZC_ASSERT_NONNULL(driver->addSourceFile(path.toString(true)));
+    ZC_EXPECT(driver->getParseTime(bufferId) == zc::none);
+    bufferIds.add(bufferId);
+  }
+  ZC_ASSERT(driver->parseSources());
+
+  ZC_EXPECT(driver->getASTs().size() == bufferIds.size());
+  for (const source::BufferId& bufferId : bufferIds) {
+    ZC_EXPECT(ZC_ASSERT_NONNULL(driver->getParseTime(bufferId)) >= 0 * zc::NANOSECONDS);
+  }
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.ReportsPhaseTimesAndMemory") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-time-report-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  compilerOpts.emission.timeReportEnabled = true;
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  const zc::StringPtr sources[] = {"let first = 1;\nlet second = 2;\n"_zc, "let third = 3;\n"_zc};
+  zc::Vector<zc::String> paths;
+  for (size_t i = 0; i < zc::size(sources); ++i) {
+    const zc::Path path = root.append(zc::str("report-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(sources[i]);
+    paths.add(path.toString(true));
+  }
+  zc::Vector<zc::StringPtr> files;
+  for (const zc::String& path : paths) { files.add(path); }
+  driver->addSourceFiles(files);
+  ZC_ASSERT(driver->parseSources());
+  ZC_ASSERT(driver->bindSources());
+
+  const TimeReport report = driver->getTimeReport();
+  ZC_ASSERT(report.phases.size() == 3);
+  ZC_EXPECT(report.phases[0].name == "read");
+  ZC_EXPECT(report.phases[1].name == "parse");
+  ZC_EXPECT(report.phases[2].name == "bind");
+  for (const TimeReport::Phase& phase : report.phases) { ZC_EXPECT(phase.runs == 1); }
+
+  ZC_ASSERT(report.files.size() == zc::size(sources));
+  size_t astBytes = 0;
+  for (const TimeReport::File& file : report.files) {
+    ZC_EXPECT(file.parseTime != zc::none);
+    ZC_EXPECT(file.bindTime != zc::none);
+    astBytes += ZC_ASSERT_NONNULL(file.astBytes);
+  }
+  ZC_EXPECT(astBytes > 0);
+  ZC_EXPECT(report.astBytes == astBytes);
+  ZC_EXPECT(report.symbols == driver->getSymbolTable().getSymbolCount());
+  ZC_EXPECT(report.internedStrings > 0);
+  ZC_EXPECT(report.peakResidentBytes > 0);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.SerializesASTsInAddedOrder") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-serialize-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  // Sizes that differ from the order the files are added in, so the largest is serialized first.
+  zc::Vector<zc::String> names;
+  for (int lines : {3, 300, 30, 1}) {
+    zc::Vector<zc::String> declarations;
+    for (int i = 0; i < lines; ++i) { declarations.add(zc::str("let value", i, " = ", i, ";\n")); }
+    const zc::Path path = root.append(names.add(zc::str("sized-", lines, ".zom")));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(zc::strArray(declarations, ""));
+    ZC_ASSERT(driver->addSourceFile(path.toString(true)) != zc::none);
+  }
+  ZC_ASSERT(driver->parseSources());
+
+  zc::Array<zc::String> dumps =
+      driver->serializeASTs([](source::BufferId, const ast::Node& node) -> zc::String {
+        return zc::heapString(ast::cast<ast::SourceFile>(node).getFileName());
+      });
+  ZC_ASSERT(dumps.size() == names.size());
+  for (size_t i = 0; i < names.size(); ++i) { ZC_EXPECT(dumps[i].endsWith(names[i]), dumps[i]); }
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.PipelinesBindingAlongImports") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-pipeline-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  // A chain, a cycle, and an import of a module outside the build
+  const zc::StringPtr sources[] = {
+      "module app;\nimport geometry.shapes as shapes;\nlet appValue = 1;\n"_zc,
+      "module geometry.shapes;\nimport geometry.points as points;\nlet shapesValue = 1;\n"_zc,
+      "module geometry.points;\nlet pointsValue = 1;\n"_zc,
+      "module ping;\nimport pong as pong;\nlet pingValue = 1;\n"_zc,
+      "module pong;\nimport ping as ping;\nlet pongValue = 1;\n"_zc,
+      "import std.io as io;\nlet looseValue = 1;\n"_zc,
+  };
+  for (size_t i = 0; i < zc::size(sources); ++i) {
+    const zc::Path path = root.append(zc::str("pipeline-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(sources[i]);
+    ZC_ASSERT(driver->addSourceFile(path.toString(true)) != zc::none);
+  }
+
+  // Every file is both parsed and bound, cycle included.
+  ZC_ASSERT(driver->parseAndBindSources());
+  ZC_EXPECT(driver->getASTs().size() == zc::size(sources));
+  size_t boundCount = 0;
+  for (const symbol::Symbol& symbol : driver->getSymbolTable().getAllSymbols()) {
+    for (zc::StringPtr name : {"appValue"_zc, "shapesValue"_zc, "pointsValue"_zc, "pingValue"_zc,
+                               "pongValue"_zc, "looseValue"_zc}) {
+      if (symbol.getName() == name) { ++boundCount; }
+    }
+  }
+  ZC_EXPECT(boundCount == zc::size(sources));
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.BindsWhileParsing") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-bind-while-parsing-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto countSymbols = [](CompilerDriver& driver, zc::ArrayPtr<const zc::StringPtr> names) {
+    size_t count = 0;
+    for (const symbol::Symbol& symbol : driver.getSymbolTable().getAllSymbols()) {
+      for (zc::StringPtr name : names) {
+        if (symbol.getName() == name) { ++count; }
+      }
+    }
+    return count;
+  };
+  auto addFile = [&](CompilerDriver& driver, zc::StringPtr name, zc::StringPtr source) {
+    const zc::Path path = root.append(name);
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(source);
+    ZC_ASSERT(driver.addSourceFile(path.toString(true)) != zc::none);
+  };
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  compilerOpts.emission.bindWhileParsing = true;
+
+  {
+    // The symbols exist once parsed, and binding the sources does not declare them again.
+    auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+    addFile(*driver, "first.zom", "let firstValue = 1;\nfun firstFunction() {}\n");
+    addFile(*driver, "second.zom", "let secondValue = 2;\n");
+    const zc::StringPtr names[] = {"firstValue"_zc, "firstFunction"_zc, "secondValue"_zc};
+
+    ZC_ASSERT(driver->parseSources());
+    ZC_EXPECT(countSymbols(*driver, names) == zc::size(names));
+    ZC_ASSERT(driver->bindSources());
+    ZC_EXPECT(!driver->getDiagnosticEngine().hasErrors());
+    ZC_EXPECT(countSymbols(*driver, names) == zc::size(names));
+  }
+
+  {
+    // A file that fails to parse leaves none of the symbols bound before the error.
+    auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+    addFile(*driver, "broken.zom", "let brokenValue = 1;\nlet = ;\n");
+    const zc::StringPtr names[] = {"brokenValue"_zc};
+
+    driver->parseSources();
+    ZC_EXPECT(driver->getDiagnosticEngine().hasErrors());
+    ZC_EXPECT(driver->getASTs().size() == 0);
+    ZC_EXPECT(countSymbols(*driver, names) == 0);
+  }
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.ScansModuleImportsWithoutParsing") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-scan-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  const zc::StringPtr sources[] = {
+      "module app;\nimport geometry.shapes as shapes;\nimport std.io.{print};\n"_zc,
+      "module geometry.shapes;\nfun f() -> i32 { return 1; }\n"_zc,
+  };
+  zc::Vector<source::BufferId> bufferIds;
+  for (size_t i = 0; i < zc::size(sources); ++i) {
+    const zc::Path path = root.append(zc::str("scan-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(sources[i]);
+    bufferIds.add(ZC_ASSERT_NONNULL(driver->addSourceFile(path.toString(true))));
+  }
+
+  auto graph = driver->scanModuleImports();
+  ZC_EXPECT(graph.size() == 2);
+  ZC_EXPECT(driver->getASTs().size() == 0);
+  const lexer::ModuleImports& app = ZC_ASSERT_NONNULL(graph.find(bufferIds[0]));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(app.declared) == "app");
+  ZC_EXPECT(zc::strArray(app.imports, " ") == "geometry.shapes std.io");
+  const lexer::ModuleImports& shapes = ZC_ASSERT_NONNULL(graph.find(bufferIds[1]));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(shapes.declared) == "geometry.shapes");
+  ZC_EXPECT(shapes.imports.empty());
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.ChecksSyntaxStreamingAWindowAtATime") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-streaming-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  compilerOpts.emission.syntaxOnly = true;
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  zc::Vector<zc::String> paths;
+  for (size_t i = 0; i < 7; ++i) {
+    const zc::Path path = root.append(zc::str("stream-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(zc::str("fun f", i, "() -> i32 { return ", i, "; }\n"));
+    paths.add(path.toString(true));
+  }
+  zc::Vector<zc::StringPtr> files;
+  for (const zc::String& path : paths) { files.add(path); }
+
+  ZC_EXPECT(driver->checkSyntaxStreaming(files, 3));
+  ZC_EXPECT(!driver->getDiagnosticEngine().hasErrors());
+  // Nothing is kept once a window is done
+  ZC_EXPECT(driver->getSourceManager().getManagedBufferIds().size() == 0);
+  ZC_EXPECT(driver->getASTs().size() == 0);
+
+  // A broken file fails the check without stopping the windows after it
+  rootDir.openFile(root.append("stream-1.zom"), zc::WriteMode::MODIFY)->writeAll("fun (\n"_zc);
+  ZC_EXPECT(!driver->checkSyntaxStreaming(files, 3));
+  ZC_EXPECT(driver->getDiagnosticEngine().hasErrors());
+  ZC_EXPECT(driver->getSourceManager().getManagedBufferIds().size() == 0);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.UpdatesChangedFilesAndDependents") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-update-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  auto writeSource = [&](zc::StringPtr name, zc::StringPtr text) {
+    const zc::Path path = root.append(name);
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::MODIFY |
+                               zc::WriteMode::CREATE_PARENT)
+        ->writeAll(text);
+    return path.toString(true);
+  };
+  const zc::String pointsPath =
+      writeSource("points.zom"_zc, "module geometry.points;\nlet pointsValue = 1;\n"_zc);
+  const zc::String shapesPath = writeSource(
+      "shapes.zom"_zc,
+      "module geometry.shapes;\nimport geometry.points as points;\nlet shapesValue = 1;\n"_zc);
+  const zc::String otherPath =
+      writeSource("other.zom"_zc, "module other;\nlet otherValue = 1;\n"_zc);
+  const zc::StringPtr paths[] = {pointsPath, shapesPath, otherPath};
+  for (const zc::StringPtr path : paths) { ZC_ASSERT(driver->addSourceFile(path) != zc::none); }
+  ZC_ASSERT(driver->parseAndBindSources());
+
+  auto countSymbols = [&](zc::StringPtr name) {
+    size_t count = 0;
+    for (const symbol::Symbol& symbol : driver->getSymbolTable().getAllSymbols()) {
+      if (symbol.getName() == name) { ++count; }
+    }
+    return count;
+  };
+  const source::BufferId otherId =
+      ZC_ASSERT_NONNULL(driver->getSourceManager().findFileSystemSourceBufferID(otherPath));
+  const ast::Node* otherTree = ZC_ASSERT_NONNULL(driver->getASTs().find(otherId)).get();
+
+  // Touching a file without changing it redoes nothing.
+  ZC_EXPECT(driver->update(zc::arrayPtr(&paths[0], 1)));
+  ZC_EXPECT(countSymbols("pointsValue"_zc) == 1);
+
+  writeSource("points.zom"_zc, "module geometry.points;\nlet movedValue = 1;\n"_zc);
+  ZC_ASSERT(driver->update(zc::arrayPtr(&paths[0], 1)));
+
+  // The changed file's symbols are replaced and its importer is rebound once, while the
+  // unrelated file keeps its tree.
+  ZC_EXPECT(countSymbols("pointsValue"_zc) == 0);
+  ZC_EXPECT(countSymbols("movedValue"_zc) == 1);
+  ZC_EXPECT(countSymbols("shapesValue"_zc) == 1);
+  ZC_EXPECT(countSymbols("otherValue"_zc) == 1);
+  ZC_EXPECT(driver->getASTs().size() == zc::size(paths));
+  ZC_EXPECT(driver->getSourceManager().getManagedBufferIds().size() == zc::size(paths));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(driver->getASTs().find(otherId)).get() == otherTree);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.WritesAndLoadsASTCache") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-ast-cache-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  {
+    auto sourceFile = rootDir.openFile(root.append("cached.zom"),
+                                       zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT);
+    sourceFile->writeAll("let answer = 42;\n"_zc);
+  }
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  compilerOpts.emission.astCacheDir = root.append("cache").toString(true);
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+
+  auto bufferId = ZC_ASSERT_NONNULL(driver->addSourceFile(root.append("cached.zom").toString(true)));
+  ZC_EXPECT(driver->loadCachedAST(bufferId) == zc::none);
+  ZC_ASSERT(driver->parseSources());
+  ZC_EXPECT(rootDir.openSubdir(root.append("cache"))->listNames().size() == 1);
+
+  auto tree = ZC_ASSERT_NONNULL(driver->loadCachedAST(bufferId));
+  ZC_EXPECT(tree.getKind(0) == ast::SyntaxKind::SourceFile);
+  bool sawAnswer = false;
+  for (ast::CompactTree::NodeIndex i = 0; i < tree.size(); ++i) {
+    ZC_IF_SOME(text, tree.getText(i)) {
+      if (text == "answer"_zc) {
+        sawAnswer = true;
+        auto range = tree.getSourceRange(i);
+        ZC_EXPECT(range.getStart() == driver->getSourceManager().getLocForOffset(bufferId, 4));
+      }
+    }
+  }
+  ZC_EXPECT(sawAnswer);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.ParsesFromTheASTCacheOnAHit") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-ast-cache-hit-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  // Equal lengths, so that the ranges of either tree fit the other buffer.
+  for (auto name : {"answer"_zc, "apples"_zc}) {
+    rootDir.openFile(root.append(zc::str(name, ".zom")),
+                     zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(zc::str("let ", name, " = 42;\n"));
+  }
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  compilerOpts.emission.astCacheDir = root.append("cache").toString(true);
+  auto parseOnce = [&](zc::StringPtr file) {
+    CompilerDriver driver(langOpts, compilerOpts);
+    ZC_ASSERT(driver.addSourceFile(root.append(file).toString(true)) != zc::none);
+    ZC_ASSERT(driver.parseSources());
+  };
+  parseOnce("answer.zom");
+  const zc::String answerEntry =
+      zc::mv(rootDir.openSubdir(root.append("cache"))->listNames()[0]);
+  parseOnce("apples.zom");
+  auto names = rootDir.openSubdir(root.append("cache"))->listNames();
+  ZC_ASSERT(names.size() == 2);
+  const zc::String applesEntry = zc::mv(names[names[0] == answerEntry ? 1 : 0]);
+
+  // Swap in the image of the other file: only a driver that skips the parser sees it.
+  auto cacheDir = rootDir.openSubdir(root.append("cache"), zc::WriteMode::MODIFY);
+  cacheDir->openFile(zc::Path(applesEntry), zc::WriteMode::MODIFY)
+      ->writeAll(cacheDir->openFile(zc::Path(answerEntry))->readAllBytes());
+
+  CompilerDriver driver(langOpts, compilerOpts);
+  auto bufferId = ZC_ASSERT_NONNULL(driver.addSourceFile(root.append("apples.zom").toString(true)));
+  ZC_ASSERT(driver.parseSources());
+  const ast::Node& sourceFile = *ZC_ASSERT_NONNULL(driver.getASTs().find(bufferId));
+  ZC_EXPECT(ast::cast<ast::SourceFile>(sourceFile).getFileName() ==
+            driver.getSourceManager().getIdentifierForBuffer(bufferId));
+  const ast::CompactTree tree(sourceFile);
+  bool sawAnswer = false;
+  for (ast::CompactTree::NodeIndex i = 1; i < tree.size(); ++i) {
+    ZC_IF_SOME(text, tree.getText(i)) {
+      ZC_EXPECT(text != "apples"_zc);
+      if (text == "answer"_zc) { sawAnswer = true; }
+    }
+  }
+  ZC_EXPECT(sawAnswer);
+  ZC_EXPECT(driver.bindSources());
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.SharesASTsThroughCacheManager") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-cache-manager-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  {
+    auto sourceFile = rootDir.openFile(root.append("cached.zom"),
+                                       zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT);
+    sourceFile->writeAll("let answer = 42;\n"_zc);
+  }
+  const zc::String path = root.append("cached.zom").toString(true);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  basic::ThreadPool threadPool(2);
+  CacheManager cache(1 << 20, zc::none);
+  {
+    CompilerDriver driver(langOpts, compilerOpts, threadPool, cache);
+    auto bufferId = ZC_ASSERT_NONNULL(driver.addSourceFile(path));
+    ZC_EXPECT(driver.loadCachedAST(bufferId) == zc::none);
+    ZC_ASSERT(driver.parseSources());
+  }
+  ZC_EXPECT(cache.getStatistics().hotEntries == 1);
+
+  // A later compilation of the same content finds the tree its predecessor left.
+  CompilerDriver driver(langOpts, compilerOpts, threadPool, cache);
+  auto bufferId = ZC_ASSERT_NONNULL(driver.addSourceFile(path));
+  auto tree = ZC_ASSERT_NONNULL(driver.loadCachedAST(bufferId));
+  ZC_EXPECT(tree.getKind(0) == ast::SyntaxKind::SourceFile);
+  ZC_EXPECT(tree.getSourceRange(0).getStart() ==
+            driver.getSourceManager().getLocForBufferStart(bufferId));
+  ZC_EXPECT(cache.getStatistics().hits == 1);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.RestoresParsedAndBoundModulesFromCacheManager") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-cache-manager-modules-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  // Equal lengths, so that the ranges of either tree fit the other buffer.
+  rootDir.openFile(root.append("alpha.zom"), zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+      ->writeAll("module alpha;\nlet answer = 42;\n"_zc);
+  rootDir.openFile(root.append("gamma.zom"), zc::WriteMode::CREATE)
+      ->writeAll("module gamma;\nlet apples = 42;\n"_zc);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  basic::ThreadPool threadPool(2);
+  // No budget, so that every entry is written to the spill directory at once.
+  const zc::Path spillPath = root.append("spill");
+  CacheManager cache(0, rootDir.openSubdir(spillPath, zc::WriteMode::CREATE));
+  auto compileOnce = [&](zc::StringPtr file) {
+    CompilerDriver driver(langOpts, compilerOpts, threadPool, cache);
+    ZC_ASSERT(driver.addSourceFile(root.append(file).toString(true)) != zc::none);
+    ZC_ASSERT(driver.parseSources());
+    ZC_ASSERT(driver.bindSources());
+  };
+  compileOnce("alpha.zom");
+  zc::Array<zc::String> alphaEntries = rootDir.openSubdir(spillPath)->listNames();
+  ZC_ASSERT(alphaEntries.size() == 2);
+  compileOnce("gamma.zom");
+  zc::Array<zc::String> entries = rootDir.openSubdir(spillPath)->listNames();
+  ZC_ASSERT(entries.size() == 4);
+
+  // Swap in the tree and index of the other file: only a driver that neither parses nor binds
+  // gamma sees them.
+  auto spillDir = rootDir.openSubdir(spillPath, zc::WriteMode::MODIFY);
+  for (const zc::String& alphaEntry : alphaEntries) {
+    for (const zc::String& entry : entries) {
+      if (entry != alphaEntry && entry.endsWith(alphaEntry.slice(alphaEntry.size() - 5))) {
+        spillDir->openFile(zc::Path(entry), zc::WriteMode::MODIFY)
+            ->writeAll(spillDir->openFile(zc::Path(alphaEntry))->readAllBytes());
+      }
+    }
+  }
+
+  CompilerDriver driver(langOpts, compilerOpts, threadPool, cache);
+  auto bufferId = ZC_ASSERT_NONNULL(driver.addSourceFile(root.append("gamma.zom").toString(true)));
+  ZC_ASSERT(driver.parseSources());
+  ZC_ASSERT(driver.bindSources());
+  const ast::CompactTree tree(*ZC_ASSERT_NONNULL(driver.getASTs().find(bufferId)));
+  bool sawAnswer = false;
+  for (ast::CompactTree::NodeIndex i = 1; i < tree.size(); ++i) {
+    ZC_IF_SOME(text, tree.getText(i)) {
+      ZC_EXPECT(text != "apples"_zc);
+      if (text == "answer"_zc) { sawAnswer = true; }
+    }
+  }
+  ZC_EXPECT(sawAnswer);
+
+  // Binding would have declared the symbol in the global scope; the index declares it in its
+  // module.
+  const symbol::SymbolTable& symbolTable = driver.getSymbolTable();
+  const symbol::Scope& globalScope =
+      ZC_ASSERT_NONNULL(symbolTable.getScopeManager().getGlobalScope());
+  ZC_EXPECT(symbolTable.lookup("answer"_zc, globalScope) == zc::none);
+  ZC_EXPECT(symbolTable.resolveQualified("alpha.apples"_zc, globalScope) == zc::none);
+  const symbol::Symbol& answer =
+      ZC_ASSERT_NONNULL(symbolTable.resolveQualified("alpha.answer"_zc, globalScope));
+  ZC_EXPECT(answer.getName() == "answer"_zc);
+  ZC_EXPECT(cache.getStatistics().reloads == 2);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("DriverTest.ReportsMemoryUsage") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-memory-usage-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  const zc::StringPtr source = "let first = 1;\nfun second() { let third = first; }\n"_zc;
+  rootDir
+      .openFile(root.append("measured.zom"), zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+      ->writeAll(source);
+
+  auto langOpts = basic::LangOptions();
+  auto compilerOpts = basic::CompilerOptions();
+  auto driver = zc::heap<CompilerDriver>(langOpts, compilerOpts);
+  auto bufferId =
+      ZC_ASSERT_NONNULL(driver->addSourceFile(root.append("measured.zom").toString(true)));
+  ZC_EXPECT(driver->getASTMemoryUsage(bufferId) == zc::none);
+  ZC_ASSERT(driver->parseSources());
+  ZC_ASSERT(driver->bindSources());
+
+  const MemoryReport report = driver->getMemoryUsage();
+  ZC_EXPECT(report.sources.usedBytes >= source.size());
+  ZC_EXPECT(report.symbols.usedBytes > 0);
+  ZC_EXPECT(report.scopes.usedBytes > 0);
+  ZC_EXPECT(report.asts.arenaSlackBytes > 0);
+
+  ZC_ASSERT(report.files.size() == 1);
+  const basic::MemoryUsage ast = ZC_ASSERT_NONNULL(driver->getASTMemoryUsage(bufferId));
+  ZC_EXPECT(report.files[0].ast.usedBytes == ast.usedBytes);
+  ZC_EXPECT(ast.usedBytes > 0 && ast.usedBytes <= report.asts.usedBytes);
+
+  const basic::MemoryUsage total = report.getTotal();
+  ZC_EXPECT(total.usedBytes == report.stringPools.usedBytes + report.sources.usedBytes +
+                                   report.diagnostics.usedBytes + report.symbols.usedBytes +
+                                   report.scopes.usedBytes + report.asts.usedBytes);
+  ZC_EXPECT(total.reservedBytes >= total.usedBytes + total.arenaSlackBytes);
+
+  rootDir.remove(root);
+}
+
 }  // namespace driver
 }  // namespace compiler
 }  // namespace zomlang
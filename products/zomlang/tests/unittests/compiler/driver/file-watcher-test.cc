@@ -0,0 +1,67 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/file-watcher.h"
+
+#include <unistd.h>
+
+#include "zc/async/async-io.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+
+#if __linux__
+
+ZC_TEST("FileWatcher: Reports Writes and Renames Once") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root = filesystem->getCurrentPath().eval(
+      zc::str("/tmp/zomlang-file-watcher-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  rootDir.openSubdir(root, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT);
+
+  const zc::String watched = root.append("watched.zom").toString(true);
+  const zc::String ignored = root.append("ignored.zom").toString(true);
+
+  zc::AsyncIoContext io = zc::setupAsyncIo();
+  FileWatcher watcher(io.unixEventPort);
+  watcher.watch(watched);
+
+  auto changes = watcher.whenChanged(io.provider->getTimer());
+  rootDir.openFile(root.append("ignored.zom"), zc::WriteMode::CREATE)->writeAll("let a = 1;\n"_zc);
+  rootDir.openFile(root.append("watched.zom"), zc::WriteMode::CREATE)->writeAll("let b = 1;\n"_zc);
+  {
+    // Saved the way editors do, by renaming a new file over the old one
+    auto replacement = rootDir.replaceFile(root.append("watched.zom"),
+                                           zc::WriteMode::CREATE | zc::WriteMode::MODIFY);
+    replacement->get().writeAll("let b = 2;\n"_zc);
+    replacement->commit();
+  }
+
+  zc::Vector<zc::String> changed = changes.wait(io.waitScope);
+  ZC_ASSERT(changed.size() == 1);
+  ZC_EXPECT(changed[0] == watched);
+
+  rootDir.remove(root);
+}
+
+#endif
+
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
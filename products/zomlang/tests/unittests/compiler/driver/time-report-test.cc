@@ -0,0 +1,77 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/driver/time-report.h"
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace compiler {
+namespace driver {
+namespace {
+
+TimeReport makeReport() {
+  TimeReport report;
+  report.phases.add(TimeReport::Phase{"parse", 12045 * zc::MICROSECONDS,
+                                      30 * zc::MILLISECONDS, 1});
+  TimeReport::File& fast = report.files.add();
+  fast.name = zc::str("fast.zom");
+  fast.sourceBytes = 10;
+  fast.parseTime = 1 * zc::MILLISECONDS;
+  TimeReport::File& slow = report.files.add();
+  slow.name = zc::str("dir/\"slow\".zom");
+  slow.sourceBytes = 2000;
+  slow.parseTime = 5 * zc::MILLISECONDS;
+  slow.bindTime = 2 * zc::MILLISECONDS;
+  slow.astBytes = 4096;
+  report.internedStrings = 3;
+  report.internedBytes = 24;
+  report.astBytes = 4096;
+  report.symbols = 7;
+  report.peakResidentBytes = 1 << 20;
+  return report;
+}
+
+ZC_TEST("TimeReportTest.FormatsText") {
+  const zc::String text = timeReportToText(makeReport());
+  ZC_EXPECT(text.contains("12.045"), text);
+  ZC_EXPECT(text.contains("30.000"), text);
+  // Slowest file first, and unknown values as dashes
+  ZC_EXPECT(ZC_ASSERT_NONNULL(text.find("slow")) < ZC_ASSERT_NONNULL(text.find("fast.zom")), text);
+  ZC_EXPECT(text.contains("Symbols:          7"), text);
+}
+
+ZC_TEST("TimeReportTest.FormatsJson") {
+  const zc::String json = timeReportToJson(makeReport());
+  ZC_EXPECT(json.contains("{\"name\": \"parse\", \"wallMicroseconds\": 12045, "
+                          "\"cpuMicroseconds\": 30000, \"runs\": 1}"),
+            json);
+  ZC_EXPECT(json.contains("\"file\": \"dir/\\\"slow\\\".zom\""), json);
+  ZC_EXPECT(json.contains("\"bindMicroseconds\": null, \"astBytes\": null"), json);
+  ZC_EXPECT(json.contains("\"peakResidentBytes\": 1048576"), json);
+}
+
+ZC_TEST("TimeReportTest.MeasuresTheProcess") {
+  const zc::Duration before = getProcessCpuTime();
+  volatile uint64_t sink = 0;
+  for (uint32_t i = 0; i < 10000000; ++i) { sink = sink + i; }
+  ZC_EXPECT(getProcessCpuTime() > before);
+  ZC_EXPECT(getPeakResidentBytes() > 0);
+}
+
+}  // namespace
+}  // namespace driver
+}  // namespace compiler
+}  // namespace zomlang
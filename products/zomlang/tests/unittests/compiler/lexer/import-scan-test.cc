@@ -0,0 +1,89 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/import-scan.h"
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+struct Scanned {
+  /// Empty if the file declares no module
+  zc::String declared;
+  zc::String imports;
+  bool hadErrors;
+};
+
+Scanned scan(zc::StringPtr code) {
+  source::SourceManager sourceManager;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+  basic::StringPool stringPool;
+  basic::LangOptions langOpts;
+  auto bufferId = sourceManager.addMemBufferCopy(code.asBytes(), "test.zom");
+
+  ModuleImports imports =
+      scanModuleImports(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+  return Scanned{zc::mv(imports.declared).orDefault(zc::String()),
+                 zc::strArray(imports.imports, " "),
+                 diagnosticEngine.hasErrors()};
+}
+
+}  // namespace
+
+ZC_TEST("ImportScanTest.FindsTheModuleAndItsImports") {
+  Scanned scanned = scan(
+      "module geometry.shapes;\n"
+      "import geometry.points as points;\n"
+      "import std.math.{sqrt, pow as power};\n"
+      "fun area(r: f64) -> f64 { return 3.14 * r * r; }\n"
+      "import std.io as io;\n");
+  ZC_EXPECT(scanned.declared == "geometry.shapes", scanned.declared);
+  ZC_EXPECT(scanned.imports == "geometry.points std.math std.io", scanned.imports);
+}
+
+ZC_TEST("ImportScanTest.SkipsWhatIsNotADeclaration") {
+  Scanned scanned = scan(
+      "import a as a;\n"
+      "module late;\n"
+      "fun f() {\n"
+      "  import nested as n;\n"
+      "  let s = `${ { import template as t; } }`;\n"
+      "  return x.import;\n"
+      "}\n"
+      "let call = import(\"dynamic\");\n"
+      "let t = `${1} import b`;\n"
+      "import c as c;\n");
+  // Only a module declaration heading the file counts, and imports outside of braces
+  ZC_EXPECT(scanned.declared == "", scanned.declared);
+  ZC_EXPECT(scanned.imports == "a c", scanned.imports);
+}
+
+ZC_TEST("ImportScanTest.ReportsNoLexerErrors") {
+  Scanned scanned = scan("import a as a;\nlet s = \"unterminated\n");
+  ZC_EXPECT(scanned.imports == "a", scanned.imports);
+  ZC_EXPECT(!scanned.hadErrors);
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
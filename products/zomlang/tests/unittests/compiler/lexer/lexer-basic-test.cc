@@ -14,6 +14,8 @@
 
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/compiler/lexer/unicode-data.h"
+#include "zomlang/compiler/lexer/utils.h"
 #include "zomlang/compiler/source/manager.h"
 #include "zomlang/tests/unittests/compiler/lexer/utils.h"
 
@@ -193,6 +195,20 @@ ZC_TEST("LexerBasicTest.UnicodeIdentifiersDefaultCase") {
   }
 }
 
+ZC_TEST("LexerBasicTest.UnicodeIdentifierTables") {
+  // The lookup tables must agree with the range tables they are generated from everywhere.
+  for (uint32_t codePoint = 0; codePoint <= 0x110000; ++codePoint) {
+    if (isIdStart(codePoint) != isInUnicodeRange(codePoint, ID_START_RANGES)) {
+      ZC_FAIL_EXPECT("isIdStart disagrees with ID_START_RANGES", codePoint);
+    }
+    if (isIdPart(codePoint) != isInUnicodeRange(codePoint, ID_PART_RANGES)) {
+      ZC_FAIL_EXPECT("isIdPart disagrees with ID_PART_RANGES", codePoint);
+    }
+  }
+  ZC_EXPECT(!isIdStart(0xFFFFFFFF));
+  ZC_EXPECT(!isIdPart(0xFFFFFFFF));
+}
+
 ZC_TEST("LexerBasicTest.InvalidCharacter") {
   // Null byte \0 should be invalid
   char nullByte[] = {'\0', 0};
@@ -243,6 +259,134 @@ ZC_TEST("LexerBasicTest.TokenTextFastPaths") {
   { ZC_EXPECT(Token::getStaticTextForTokenKind(ast::SyntaxKind::Identifier) == zc::none); }
 }
 
+ZC_TEST("LexerBasicTest.LexAllMatchesLex") {
+  auto& sourceManager = getSourceManager();
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+  auto bufferId = sourceManager.addMemBufferCopy(
+      "let x: i32 = 0x1F + y;\n// comment\nfun f() { return \"a\\tb\" != `t${x}`; }"_zcb,
+      "test.zom");
+
+  Lexer pullLexer(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+  Lexer batchLexer(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+  TokenTable table = batchLexer.lexAll();
+
+  size_t index = 0;
+  Token token;
+  do {
+    pullLexer.lex(token);
+    ZC_ASSERT(index < table.size());
+    Token row = table.getToken(index);
+    ZC_EXPECT(row.getKind() == token.getKind(), index);
+    ZC_EXPECT(row.getFlags() == token.getFlags(), index);
+    ZC_EXPECT(row.getRange().getStart() == token.getRange().getStart(), index);
+    ZC_EXPECT(row.getRange().getEnd() == token.getRange().getEnd(), index);
+    ZC_EXPECT(row.getValue() == token.getValue(), index);
+    ++index;
+  } while (!token.is(ast::SyntaxKind::EndOfFile));
+  ZC_EXPECT(index == table.size());
+
+  // Only identifiers and literals need a side-table value.
+  ZC_EXPECT(table.valueIndices[0] == TokenTable::kNoValue);
+  ZC_EXPECT(table.values[table.valueIndices[1]] == "x"_zc);
+  ZC_EXPECT(table.starts[1] == 4 && table.lengths[1] == 1);
+}
+
+namespace {
+
+/// Relex `before` after replacing `removed` bytes at `offset` by `inserted`, and check the result
+/// against lexing the edited text from scratch.
+void expectRelexMatchesLexAll(zc::StringPtr before, uint32_t offset, uint32_t removed,
+                              zc::StringPtr inserted) {
+  auto& sourceManager = getSourceManager();
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+
+  zc::String after = zc::str(before.first(offset), inserted, before.slice(offset + removed));
+  auto oldBuffer = sourceManager.addMemBufferCopy(before.asBytes(), "old.zom");
+  auto newBuffer = sourceManager.addMemBufferCopy(after.asBytes(), "new.zom");
+
+  Lexer oldLexer(sourceManager, diagnosticEngine, langOpts, stringPool, oldBuffer);
+  TokenTable previous = oldLexer.lexAll();
+
+  Lexer fullLexer(sourceManager, diagnosticEngine, langOpts, stringPool, newBuffer);
+  TokenTable expected = fullLexer.lexAll();
+
+  Lexer incrementalLexer(sourceManager, diagnosticEngine, langOpts, stringPool, newBuffer);
+  TokenTable actual = incrementalLexer.relex(
+      previous, TextEdit{offset, removed, static_cast<uint32_t>(inserted.size())});
+
+  ZC_ASSERT(actual.size() == expected.size(), after, actual.size(), expected.size());
+  for (size_t i = 0; i < expected.size(); ++i) {
+    ZC_EXPECT(actual.kinds[i] == expected.kinds[i], after, i);
+    ZC_EXPECT(actual.flags[i] == expected.flags[i], after, i);
+    ZC_EXPECT(actual.starts[i] == expected.starts[i], after, i);
+    ZC_EXPECT(actual.lengths[i] == expected.lengths[i], after, i);
+    ZC_EXPECT(actual.getToken(i).getValue() == expected.getToken(i).getValue(), after, i);
+  }
+}
+
+}  // namespace
+
+ZC_TEST("LexerBasicTest.RelexAfterEdit") {
+  zc::StringPtr text = "let alpha = 1;\nlet beta = alpha + 2; // note\nfun f() { return beta; }"_zc;
+
+  expectRelexMatchesLexAll(text, 4, 5, "gamma"_zc);         // rename a token
+  expectRelexMatchesLexAll(text, 9, 0, "Suffix"_zc);        // extend the token before the edit
+  expectRelexMatchesLexAll(text, 0, 0, "  "_zc);            // insert at the very start
+  expectRelexMatchesLexAll(text, 14, 1, ""_zc);             // join two lines
+  expectRelexMatchesLexAll(text, 15, 0, "/*"_zc);           // open a comment to the end
+  expectRelexMatchesLexAll(text, 38, 2, "`t${"_zc);         // start a template literal
+  expectRelexMatchesLexAll(text, text.size(), 0, " x"_zc);  // append at the end
+  expectRelexMatchesLexAll(text, 0, text.size(), "1"_zc);   // replace everything
+}
+
+ZC_TEST("LexerBasicTest.KeywordLookup") {
+#define ZOM_KEYWORD(Kind, Text) \
+  ZC_EXPECT(getKeywordKind(zc::StringPtr(Text).asBytes()) == ast::SyntaxKind::Kind, Text);
+#include "zomlang/compiler/lexer/keywords.def"
+
+  // Near misses must fall through to identifiers.
+  ZC_EXPECT(getKeywordKind("le"_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind("lets"_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind("Let"_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind("i128"_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind("x"_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind(""_zcb) == ast::SyntaxKind::Identifier);
+  ZC_EXPECT(getKeywordKind("constructors"_zcb) == ast::SyntaxKind::Identifier);
+}
+
+ZC_TEST("LexerBasicTest.DoesNotAllocatePerToken") {
+  auto countAllocations = [](size_t lines) -> uint64_t {
+    zc::Vector<zc::StringPtr> text;
+    for (size_t i = 0; i < lines; ++i) { text.add("let value = first + second;\n"_zc); }
+    const zc::String source = zc::strArray(text, "");
+
+    source::SourceManager sourceManager;
+    const source::BufferId bufferId =
+        sourceManager.addMemBufferCopy(source.asBytes(), "allocations.zom");
+    diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+    basic::StringPool stringPool;
+    const basic::LangOptions langOpts;
+
+    zc::AllocationTracker tracker;
+    {
+      zc::AllocationScope scope("lexer");
+      Lexer lexer(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+      const TokenTable tokens = lexer.lexAll();
+      ZC_EXPECT(tokens.size() == lines * 7 + 1);
+    }
+    return tracker.getCounts("lexer").allocations();
+  };
+
+  // Ten times the tokens only grows the token table's columns a few more times
+  const uint64_t small = countAllocations(100);
+  const uint64_t large = countAllocations(1000);
+  ZC_EXPECT(large < small + 100, small, large);
+}
+
 }  // namespace lexer
 }  // namespace compiler
 }  // namespace zomlang
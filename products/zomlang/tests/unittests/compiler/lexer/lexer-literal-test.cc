@@ -200,6 +200,22 @@ ZC_TEST("LexerLiteralTest.TemplateLiterals") {
   }
 }
 
+ZC_TEST("LexerLiteralTest.TemplateSegmentsShareScratchBuffer") {
+  // Cooked and uncooked segments alternate, so each value must survive later reuse of the
+  // lexer's scratch buffer.
+  auto tokens = tokenize("`a\\tb ${x} `plain` `crlf\r\nend` `\\u0041\\x42` 'q\\n' `tail`"_zc);
+  ZC_EXPECT(tokens.size() == 9);
+  ZC_EXPECT(tokens[0].is(ast::SyntaxKind::TemplateHead));
+  ZC_EXPECT(tokens[0].getValue() == "a\tb "_zc);
+  ZC_EXPECT(tokens[3].is(ast::SyntaxKind::NoSubstitutionTemplateLiteral));
+  ZC_EXPECT(tokens[3].getValue() == "plain"_zc);
+  ZC_EXPECT(tokens[4].getValue() == "crlf\nend"_zc);
+  ZC_EXPECT(tokens[5].getValue() == "AB"_zc);
+  ZC_EXPECT(tokens[6].is(ast::SyntaxKind::StringLiteral));
+  ZC_EXPECT(tokens[6].getValue() == "q\n"_zc);
+  ZC_EXPECT(tokens[7].getValue() == "tail"_zc);
+}
+
 }  // namespace lexer
 }  // namespace compiler
 }  // namespace zomlang
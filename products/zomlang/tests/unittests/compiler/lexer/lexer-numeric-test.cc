@@ -163,6 +163,21 @@ ZC_TEST("LexerNumericTest.DecimalWithSeparators") {
   ZC_EXPECT(tokens[1].getValue() == "123"_zc);
 }
 
+ZC_TEST("LexerNumericTest.FloatWithSeparators") {
+  auto tokens = tokenize("1_0.2_5 1_0.2_5e1_0 1_0e1 10.25e10"_zc);
+  ZC_EXPECT(tokens.size() == 5);
+
+  ZC_EXPECT(tokens[0].is(ast::SyntaxKind::FloatLiteral));
+  ZC_EXPECT(tokens[0].hasFlag(TokenFlags::ContainsSeparator));
+  ZC_EXPECT(tokens[0].getValue() == "10.25"_zc);
+
+  ZC_EXPECT(tokens[1].is(ast::SyntaxKind::FloatLiteral));
+  ZC_EXPECT(tokens[1].getValue() == tokens[3].getValue());
+
+  ZC_EXPECT(tokens[2].is(ast::SyntaxKind::FloatLiteral));
+  ZC_EXPECT(tokens[2].getValue() == "100"_zc);
+}
+
 ZC_TEST("LexerNumericTest.FloatingPointLiterals") {
   auto tokens = tokenize("3.14 0.123 10.5"_zc);
   ZC_EXPECT(tokens.size() == 4);  // 3 numbers + EOF
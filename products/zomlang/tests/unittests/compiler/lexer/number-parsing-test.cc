@@ -0,0 +1,112 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/number-parsing.h"
+
+#include <cstdlib>
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+zc::Maybe<uint64_t> decimal(zc::StringPtr text) { return parseDecimalDigits(text); }
+zc::Maybe<uint64_t> radix(zc::StringPtr text, uint32_t log2Radix) {
+  return parseRadixDigits(text, log2Radix);
+}
+
+/// A small deterministic generator so failures reproduce.
+uint64_t nextRandom(uint64_t& seed) {
+  seed ^= seed << 13;
+  seed ^= seed >> 7;
+  seed ^= seed << 17;
+  return seed;
+}
+
+}  // namespace
+
+ZC_TEST("NumberParsingTest.DecimalDigits") {
+  ZC_EXPECT(decimal(""_zc) == uint64_t(0));
+  ZC_EXPECT(decimal("0"_zc) == uint64_t(0));
+  ZC_EXPECT(decimal("7"_zc) == uint64_t(7));
+  ZC_EXPECT(decimal("12345678"_zc) == uint64_t(12345678));
+  ZC_EXPECT(decimal("1234567890123456789"_zc) == uint64_t(1234567890123456789));
+  ZC_EXPECT(decimal("0000000000000000000000042"_zc) == uint64_t(42));
+  ZC_EXPECT(decimal("18446744073709551615"_zc) == UINT64_MAX);
+  ZC_EXPECT(decimal("18446744073709551616"_zc) == zc::none);
+  ZC_EXPECT(decimal("99999999999999999999"_zc) == zc::none);
+  ZC_EXPECT(decimal("100000000000000000000"_zc) == zc::none);
+
+  uint64_t seed = 0x9e3779b97f4a7c15;
+  for (int i = 0; i < 10000; ++i) {
+    uint64_t expected = nextRandom(seed) >> (nextRandom(seed) % 64);
+    ZC_EXPECT(decimal(zc::str(expected)) == expected, expected);
+  }
+}
+
+ZC_TEST("NumberParsingTest.RadixDigits") {
+  ZC_EXPECT(radix("101"_zc, 1) == uint64_t(5));
+  ZC_EXPECT(radix("777"_zc, 3) == uint64_t(511));
+  ZC_EXPECT(radix("ff"_zc, 4) == uint64_t(255));
+  ZC_EXPECT(radix("00000000000000000000ff"_zc, 4) == uint64_t(255));
+  ZC_EXPECT(radix("ffffffffffffffff"_zc, 4) == UINT64_MAX);
+  ZC_EXPECT(radix("10000000000000000"_zc, 4) == zc::none);
+  ZC_EXPECT(radix("1777777777777777777777"_zc, 3) == UINT64_MAX);
+  ZC_EXPECT(radix("2000000000000000000000"_zc, 3) == zc::none);
+  ZC_EXPECT(radix(zc::str(zc::repeat('1', 64)), 1) == UINT64_MAX);
+  ZC_EXPECT(radix(zc::str(zc::repeat('1', 65)), 1) == zc::none);
+}
+
+ZC_TEST("NumberParsingTest.DecimalFloatMatchesStrtod") {
+  // Typical literals take the fast path.
+  ZC_EXPECT(parseDecimalFloat("3.14"_zc) == 3.14);
+  ZC_EXPECT(parseDecimalFloat("0.1"_zc) == 0.1);
+  ZC_EXPECT(parseDecimalFloat("1e-3"_zc) == 1e-3);
+  ZC_EXPECT(parseDecimalFloat("1.5E+10"_zc) == 1.5e10);
+  ZC_EXPECT(parseDecimalFloat("1e25"_zc) == 1e25);
+  ZC_EXPECT(parseDecimalFloat("0.000"_zc) == 0.0);
+
+  // Inputs it cannot do exactly are left to the caller.
+  ZC_EXPECT(parseDecimalFloat("1e300"_zc) == zc::none);
+  ZC_EXPECT(parseDecimalFloat("1e-30"_zc) == zc::none);
+  ZC_EXPECT(parseDecimalFloat("9007199254740993"_zc) == zc::none);
+  ZC_EXPECT(parseDecimalFloat("12345678901234567890.5"_zc) == zc::none);
+  ZC_EXPECT(parseDecimalFloat("1e"_zc) == zc::none);
+  ZC_EXPECT(parseDecimalFloat("1x"_zc) == zc::none);
+
+  // Whenever it answers, the answer is the correctly rounded one.
+  uint64_t seed = 0x2545f4914f6cdd1d;
+  for (int i = 0; i < 20000; ++i) {
+    uint64_t digits = nextRandom(seed) % 10000000000000000ull;
+    int point = static_cast<int>(nextRandom(seed) % 17);
+    int exponent = static_cast<int>(nextRandom(seed) % 61) - 30;
+    zc::String text = zc::str(digits);
+    if (point > 0 && size_t(point) < text.size()) {
+      text = zc::str(text.first(text.size() - point), ".", text.slice(text.size() - point));
+    }
+    if (exponent != 0) { text = zc::str(text, "e", exponent); }
+
+    ZC_IF_SOME(value, parseDecimalFloat(text)) {
+      ZC_EXPECT(value == strtod(text.cStr(), nullptr), text);
+    }
+  }
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,185 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+
+#include "zomlang/compiler/lexer/outline-scan.h"
+
+#include "zc/core/string.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+struct Scanned {
+  /// An entry per line: its kind, its name, and the text of its range. Members are indented.
+  zc::String entries;
+  /// The text of every token classified as a declaration name
+  zc::String names;
+  size_t tokenCount;
+  bool hadErrors;
+};
+
+Scanned scan(zc::StringPtr code) {
+  source::SourceManager sourceManager;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+  basic::StringPool stringPool;
+  basic::LangOptions langOpts;
+  auto bufferId = sourceManager.addMemBufferCopy(code.asBytes(), "test.zom");
+
+  Outline outline = scanOutline(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId,
+                                /*classifyTokens*/ true);
+  auto textOf = [&](source::SourceRange range) {
+    const unsigned start = sourceManager.getLocOffsetInBuffer(range.getStart(), bufferId);
+    return code.slice(start, start + range.getLength());
+  };
+
+  zc::Vector<zc::String> entries;
+  for (const OutlineEntry& entry : outline.entries) {
+    zc::StringPtr indent = entry.parent == zc::none ? "" : "  ";
+    entries.add(zc::str(indent, ast::_::syntaxKindToString(entry.kind), " ", entry.name, ": ",
+                        textOf(entry.range)));
+  }
+  zc::Vector<zc::String> names;
+  for (const ClassifiedToken& token : outline.tokens) {
+    if (token.tokenClass == TokenClass::kDeclarationName) {
+      names.add(zc::str(textOf(token.range)));
+    }
+  }
+  return Scanned{zc::strArray(entries, "\n"), zc::strArray(names, " "), outline.tokens.size(),
+                 diagnosticEngine.hasErrors()};
+}
+
+}  // namespace
+
+ZC_TEST("OutlineScanTest.FindsTopLevelDeclarations") {
+  Scanned scanned = scan(
+      "module app;\n"
+      "import std.io as io;\n"
+      "let a: i32 = 1, b = { x: 1 };\n"
+      "const [first, second] = pair;\n"
+      "fun area(r: f64) -> f64 { let inner = 1; return 3.14 * r * r; }\n"
+      "alias Box<T> = { value: T };\n"
+      "error Failure { Code = 404 }\n"
+      "print(a);\n");
+  ZC_EXPECT(scanned.entries ==
+                "VariableDeclaration a: let a: i32 = 1, b = { x: 1 };\n"
+                "VariableDeclaration b: let a: i32 = 1, b = { x: 1 };\n"
+                "FunctionDeclaration area: fun area(r: f64) -> f64 { let inner = 1; return 3.14 "
+                "* r * r; }\n"
+                "AliasDeclaration Box: alias Box<T> = { value: T };\n"
+                "ErrorDeclaration Failure: error Failure { Code = 404 }",
+            scanned.entries);
+  ZC_EXPECT(scanned.names == "a b area Box Failure", scanned.names);
+}
+
+ZC_TEST("OutlineScanTest.FindsMembersOfTypes") {
+  Scanned scanned = scan(
+      "export class Animal extends Base {\n"
+      "  public let name: str;\n"
+      "  init(n: str) { this.name = n; }\n"
+      "  deinit { ; }\n"
+      "  get value() -> i32 { return 1; }\n"
+      "  public static fun makeSound() -> str { return `${name} says ${ { a: 1 }.a }`; }\n"
+      "}\n"
+      "struct Point {\n"
+      "  private const y: i32 = 1\n"
+      "  fun hello() -> unit {\n"
+      "    print(\"hello\")\n"
+      "  }\n"
+      "}\n"
+      "interface Named {\n"
+      "  readonly let name: str;\n"
+      "  fun rename(to: str) -> unit;\n"
+      "}\n"
+      "enum E { A, B = 1, C(i32) }\n");
+  ZC_EXPECT(scanned.entries ==
+                "ClassDeclaration Animal: export class Animal extends Base {\n"
+                "  public let name: str;\n"
+                "  init(n: str) { this.name = n; }\n"
+                "  deinit { ; }\n"
+                "  get value() -> i32 { return 1; }\n"
+                "  public static fun makeSound() -> str { return `${name} says ${ { a: 1 }.a }`; "
+                "}\n"
+                "}\n"
+                "  PropertyDeclaration name: public let name: str;\n"
+                "  InitDeclaration init: init(n: str) { this.name = n; }\n"
+                "  DeinitDeclaration deinit: deinit { ; }\n"
+                "  GetAccessor value: get value() -> i32 { return 1; }\n"
+                "  MethodDeclaration makeSound: public static fun makeSound() -> str { return "
+                "`${name} says ${ { a: 1 }.a }`; }\n"
+                "StructDeclaration Point: struct Point {\n"
+                "  private const y: i32 = 1\n"
+                "  fun hello() -> unit {\n"
+                "    print(\"hello\")\n"
+                "  }\n"
+                "}\n"
+                "  PropertyDeclaration y: private const y: i32 = 1\n"
+                "  MethodDeclaration hello: fun hello() -> unit {\n"
+                "    print(\"hello\")\n"
+                "  }\n"
+                "InterfaceDeclaration Named: interface Named {\n"
+                "  readonly let name: str;\n"
+                "  fun rename(to: str) -> unit;\n"
+                "}\n"
+                "  PropertySignature name: readonly let name: str;\n"
+                "  MethodSignature rename: fun rename(to: str) -> unit;\n"
+                "EnumDeclaration E: enum E { A, B = 1, C(i32) }\n"
+                "  EnumMember A: A\n"
+                "  EnumMember B: B = 1\n"
+                "  EnumMember C: C(i32)",
+            scanned.entries);
+  ZC_EXPECT(!scanned.hadErrors);
+}
+
+ZC_TEST("OutlineScanTest.ClassifiesTokens") {
+  Scanned scanned = scan("fun f() { return \"s\" + 1 + `a${b}c`; }\n");
+  // fun f ( ) { return "s" + 1 + `a${ b }c` ; }
+  ZC_EXPECT(scanned.tokenCount == 15, scanned.tokenCount);
+  ZC_EXPECT(scanned.names == "f", scanned.names);
+
+  source::SourceManager sourceManager;
+  diagnostics::DiagnosticEngine diagnosticEngine(sourceManager);
+  basic::StringPool stringPool;
+  basic::LangOptions langOpts;
+  zc::StringPtr code = "let s = `a${b}c`;"_zc;
+  auto bufferId = sourceManager.addMemBufferCopy(code.asBytes(), "test.zom");
+  Outline outline = scanOutline(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId,
+                                /*classifyTokens*/ true);
+  const TokenClass expected[] = {TokenClass::kKeyword,    TokenClass::kDeclarationName,
+                                 TokenClass::kOperator,   TokenClass::kString,
+                                 TokenClass::kIdentifier, TokenClass::kString,
+                                 TokenClass::kPunctuation};
+  ZC_ASSERT(outline.tokens.size() == zc::size(expected), outline.tokens.size());
+  for (size_t i = 0; i < zc::size(expected); ++i) {
+    ZC_EXPECT(outline.tokens[i].tokenClass == expected[i], i);
+  }
+  // The tail of the template is one token, from the `}` to the closing backquote.
+  ZC_EXPECT(outline.tokens[5].range.getLength() == 3);
+
+  // Tokens are only listed when asked for.
+  ZC_EXPECT(scanOutline(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId)
+                .tokens.empty());
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
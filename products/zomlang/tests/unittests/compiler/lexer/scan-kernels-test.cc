@@ -0,0 +1,101 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lexer/scan-kernels.h"
+
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/lexer/lexer.h"
+#include "zomlang/tests/unittests/compiler/lexer/utils.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lexer {
+
+namespace {
+
+/// Check every kernel against the scalar reference for every start offset and length of `text`,
+/// so both the vector body and the scalar tail are exercised at all alignments.
+void expectKernelsMatchScalar(zc::StringPtr text) {
+  const ScanKernels& fast = getScanKernels();
+  const ScanKernels& scalar = getScalarScanKernels();
+  const zc::byte* base = text.asBytes().begin();
+
+  for (size_t start = 0; start <= text.size(); ++start) {
+    for (size_t end = start; end <= text.size(); ++end) {
+      const zc::byte* b = base + start;
+      const zc::byte* e = base + end;
+
+      bool fastBreak = false;
+      bool scalarBreak = false;
+      ZC_EXPECT(fast.skipWhitespace(b, e, fastBreak) == scalar.skipWhitespace(b, e, scalarBreak),
+                text, start, end);
+      ZC_EXPECT(fastBreak == scalarBreak, text, start, end);
+
+      ZC_EXPECT(fast.findLineCommentStop(b, e) == scalar.findLineCommentStop(b, e), start, end);
+      ZC_EXPECT(fast.findBlockCommentStop(b, e) == scalar.findBlockCommentStop(b, e), start, end);
+      ZC_EXPECT(fast.skipAsciiIdentifierPart(b, e) == scalar.skipAsciiIdentifierPart(b, e), start,
+                end);
+      for (zc::byte quote : {'"', '\''}) {
+        ZC_EXPECT(fast.findStringLiteralStop(b, e, quote) ==
+                      scalar.findStringLiteralStop(b, e, quote),
+                  start, end, quote);
+      }
+    }
+  }
+}
+
+}  // namespace
+
+ZC_TEST("ScanKernelsTest.MatchesScalarReference") {
+  expectKernelsMatchScalar("    \t\t  \v\f      \n    \r\n                   x"_zc);
+  expectKernelsMatchScalar("// a fairly long line comment with no surprises at all\nnext"_zc);
+  expectKernelsMatchScalar("/* block comment spanning ** several\n lines of text */ after"_zc);
+  expectKernelsMatchScalar("// comment with non-ASCII \xe4\xb8\xad\xe6\x96\x87 text\r\n"_zc);
+  expectKernelsMatchScalar("identifier_with_$dollars_and_digits_0123456789ABCDEFGH + rest"_zc);
+  expectKernelsMatchScalar("@[`{/:` separators just outside the identifier ranges"_zc);
+  expectKernelsMatchScalar(
+      "{\\\"key\\\": \"a long string literal body\", 'it''s \xe4\xb8\xad'\r\n"_zc);
+}
+
+ZC_TEST("ScanKernelsTest.LongStringLiteralsLexUnchanged") {
+  auto tokens = tokenize(
+      "let s = \"eyJrZXkiOiAidmFsdWUiLCAibGlzdCI6IFsxLCAyLCAzXX0=\\n\\\"quoted\\\" \xe4\xb8\xad "
+      "and a tail that is longer than a vector\";"_zc);
+  ZC_EXPECT(tokens.size() == 6);
+  ZC_EXPECT(tokens[3].is(ast::SyntaxKind::StringLiteral));
+  ZC_EXPECT(tokens[3].getValue() ==
+            "eyJrZXkiOiAidmFsdWUiLCAibGlzdCI6IFsxLCAyLCAzXX0=\n\"quoted\" \xe4\xb8\xad "
+            "and a tail that is longer than a vector"_zc);
+}
+
+ZC_TEST("ScanKernelsTest.LexerResultsUnchanged") {
+  // Long runs push the lexer through the vector kernels rather than only their scalar tails.
+  auto tokens = tokenize(
+      "let                                  a = 1;"
+      "// line comment that is long enough to cover more than one vector width\n"
+      "/* block comment that is long enough to cover more than one vector width\n"
+      "   and carries on to a second line */ variableNameThatIsLongerThanThirtyTwoBytes"_zc);
+  ZC_EXPECT(tokens.size() == 7);
+  ZC_EXPECT(tokens[0].is(ast::SyntaxKind::LetKeyword));
+  ZC_EXPECT(tokens[1].getValue() == "a"_zc);
+  ZC_EXPECT(!tokens[1].hasPrecedingLineBreak());
+  ZC_EXPECT(tokens[5].is(ast::SyntaxKind::Identifier));
+  ZC_EXPECT(tokens[5].getValue() == "variableNameThatIsLongerThanThirtyTwoBytes"_zc);
+  ZC_EXPECT(tokens[5].hasPrecedingLineBreak());
+}
+
+}  // namespace lexer
+}  // namespace compiler
+}  // namespace zomlang
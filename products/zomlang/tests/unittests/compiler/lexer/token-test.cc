@@ -23,8 +23,8 @@ namespace compiler {
 namespace lexer {
 
 ZC_TEST("TokenTest.ConstructorsAndAssignment") {
-  source::SourceLoc loc1 = source::SourceLoc::getFromOpaqueValue((const zc::byte*)10);
-  source::SourceLoc loc2 = source::SourceLoc::getFromOpaqueValue((const zc::byte*)20);
+  source::SourceLoc loc1 = source::SourceLoc::getFromOpaqueValue(10);
+  source::SourceLoc loc2 = source::SourceLoc::getFromOpaqueValue(20);
   source::SourceRange range(loc1, loc2);
 
   // Default constructor
@@ -91,8 +91,8 @@ ZC_TEST("TokenTest.ConstructorsAndAssignment") {
 
 ZC_TEST("TokenTest.SettersAndGetters") {
   Token t;
-  source::SourceLoc loc1 = source::SourceLoc::getFromOpaqueValue((const zc::byte*)100);
-  source::SourceLoc loc2 = source::SourceLoc::getFromOpaqueValue((const zc::byte*)105);
+  source::SourceLoc loc1 = source::SourceLoc::getFromOpaqueValue(100);
+  source::SourceLoc loc2 = source::SourceLoc::getFromOpaqueValue(105);
   source::SourceRange range(loc1, loc2);
 
   t.setKind(ast::SyntaxKind::IntegerLiteral);
@@ -0,0 +1,170 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/lowering/pipeline.h"
+
+#include <atomic>
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/ast/cast.h"
+#include "zomlang/compiler/ast/module.h"
+#include "zomlang/compiler/basic/string-pool.h"
+#include "zomlang/compiler/basic/thread-pool.h"
+#include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/parser/parser.h"
+#include "zomlang/compiler/source/manager.h"
+
+namespace zomlang {
+namespace compiler {
+namespace lowering {
+
+namespace {
+
+zc::StringPtr getName(const ast::FunctionDeclaration& function) {
+  ZC_SWITCH_ONEOF(function.getName()) {
+    ZC_CASE_ONEOF(maybeIdentifier, zc::Maybe<const ast::Identifier&>) {
+      ZC_IF_SOME(identifier, maybeIdentifier) { return identifier.getText(); }
+    }
+    ZC_CASE_ONEOF(maybePattern, zc::Maybe<const ast::BindingPattern&>) {}
+  }
+  return ""_zc;
+}
+
+class NamedFunction final : public LoweredFunction {
+public:
+  explicit NamedFunction(zc::String name) : name(zc::mv(name)) {}
+
+  zc::String name;
+  bool optimized = false;
+};
+
+/// Lowers a function to its name, and throws for one named `bad`.
+class NameLowering final : public FunctionLowering {
+public:
+  zc::Own<LoweredFunction> lower(const FunctionUnit& unit) override {
+    const zc::StringPtr name = getName(unit.function);
+    if (name == "bad") { ZC_FAIL_REQUIRE("cannot lower", name); }
+    return zc::heap<NamedFunction>(zc::str(unit.moduleName, ".", name));
+  }
+
+  void optimize(LoweredFunction& function) override {
+    static_cast<NamedFunction&>(function).optimized = true;
+  }
+
+  ObjectFragment emit(zc::Own<LoweredFunction> function) override {
+    auto& named = static_cast<NamedFunction&>(*function);
+    ZC_ASSERT(named.optimized);
+    ObjectFragment fragment;
+    fragment.bytes = zc::heapArray(named.name.asBytes());
+    fragment.symbol = zc::mv(named.name);
+    return fragment;
+  }
+};
+
+/// Records the fragments, checking that only one thread is ever inside.
+class RecordingSink final : public ObjectSink {
+public:
+  zc::Vector<ObjectFragment> fragments;
+  size_t finished = 0;
+  std::atomic<size_t> inside{0};
+  bool overlapped = false;
+
+  void add(ObjectFragment fragment) override {
+    if (inside.fetch_add(1) != 0) { overlapped = true; }
+    fragments.add(zc::mv(fragment));
+    inside.fetch_sub(1);
+  }
+
+  void finish() override { ++finished; }
+};
+
+class PipelineTest {
+public:
+  PipelineTest() : diagnosticEngine(sourceManager) {}
+
+  zc::Array<FunctionUnit> parse(zc::StringPtr code) {
+    auto bufferId = sourceManager.addMemBufferCopy(code.asBytes(), "test.zom");
+    parser::Parser parser(sourceManager, diagnosticEngine, langOpts, stringPool, bufferId);
+    ZC_IF_SOME(node, parser.parse()) { ast = zc::mv(node); }
+    auto units = zc::heapArrayBuilder<FunctionUnit>(
+        ast::cast<ast::SourceFile>(*ast).getStatements().size());
+    for (const auto& statement : ast::cast<ast::SourceFile>(*ast).getStatements()) {
+      units.add(FunctionUnit{ast::cast<ast::FunctionDeclaration>(statement), "test"});
+    }
+    return units.finish();
+  }
+
+private:
+  source::SourceManager sourceManager;
+  diagnostics::DiagnosticEngine diagnosticEngine;
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+  zc::Own<ast::Node> ast;
+};
+
+zc::String makeFunctions(size_t count, zc::StringPtr last) {
+  zc::Vector<zc::String> functions;
+  for (size_t i = 0; i < count; ++i) {
+    functions.add(zc::str("fun f", i, "(x: i32) -> i32 { return x; }\n"));
+  }
+  functions.add(zc::str("fun ", last, "() -> i32 { return 0; }\n"));
+  return zc::strArray(functions, "");
+}
+
+}  // namespace
+
+ZC_TEST("LoweringPipelineTest_EveryFunctionReachesTheSinkOnce") {
+  PipelineTest test;
+  auto units = test.parse(makeFunctions(99, "last"));
+  basic::ThreadPool threadPool(4);
+  NameLowering lowering;
+  RecordingSink sink;
+
+  LoweringPipeline(threadPool, lowering, sink).run(units);
+
+  ZC_EXPECT(!sink.overlapped);
+  ZC_EXPECT(sink.finished == 1);
+  ZC_ASSERT(sink.fragments.size() == 100);
+  auto seen = zc::heapArray<bool>(100);
+  for (auto& s : seen) { s = false; }
+  for (const auto& fragment : sink.fragments) {
+    ZC_ASSERT(fragment.index < 100);
+    ZC_EXPECT(!seen[fragment.index]);
+    seen[fragment.index] = true;
+    const zc::StringPtr name = getName(units[fragment.index].function);
+    ZC_EXPECT(fragment.symbol == zc::str("test.", name));
+    ZC_EXPECT(fragment.bytes.asPtr() == fragment.symbol.asBytes());
+  }
+}
+
+ZC_TEST("LoweringPipelineTest_AFailingStageDoesNotFinishTheSink") {
+  PipelineTest test;
+  auto units = test.parse(makeFunctions(20, "bad"));
+  basic::ThreadPool threadPool(4);
+  NameLowering lowering;
+  RecordingSink sink;
+
+  LoweringPipeline pipeline(threadPool, lowering, sink);
+  ZC_EXPECT_THROW_MESSAGE("cannot lower", pipeline.run(units));
+  ZC_EXPECT(sink.finished == 0);
+  ZC_EXPECT(sink.fragments.size() <= 20);
+}
+
+}  // namespace lowering
+}  // namespace compiler
+}  // namespace zomlang
@@ -17,6 +17,7 @@
 #include "zc/core/common.h"
 #include "zc/core/one-of.h"
 #include "zc/core/string.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/ast/cast.h"
 #include "zomlang/compiler/ast/expression.h"
@@ -1144,6 +1145,32 @@ ZC_TEST("ParserTest.ParseTypeArgumentsInExpression") {
   ZC_EXPECT(result != zc::none, "Should parse function call with type arguments");
 }
 
+ZC_TEST("ParserTest.SpeculativeParseAcrossReScannedTokens") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  // Each `<` starts a speculative type-argument parse that re-scans `>` tokens and then rewinds,
+  // so the buffered tokens after the rewind point must come back exactly as first lexed.
+  auto bufferId = sourceManager->addMemBufferCopy(
+      zc::str("let a = f<T>(x);\n"
+              "let b = c < d >> e;\n"
+              "let g = h >= i;\n"
+              "let t = `a${b}c${d}e`;\n"
+              "let k = m < n;")
+          .asBytes(),
+      "test.zom");
+  Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+
+  ZC_IF_SOME(root, parser.parse()) {
+    auto& sourceFile = ::zomlang::compiler::ast::cast<::zomlang::compiler::ast::SourceFile>(*root);
+    ZC_EXPECT(sourceFile.getStatements().size() == 5);
+    ZC_EXPECT(!diagnosticEngine->hasErrors());
+  }
+  else { ZC_EXPECT(false, "Parse should succeed"); }
+}
+
 ZC_TEST("ParserTest.ParseMatchStatement") {
   auto sourceManager = zc::heap<source::SourceManager>();
   auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
@@ -3680,6 +3707,165 @@ ZC_TEST("ParserTest.ParseClassExtendsWithGenerics") {
   ZC_EXPECT(result != zc::none);
 }
 
+/// Covers the speculation memo and relexing tokens first lexed by a failed speculation
+ZC_TEST("ParserTest.NestedFailedSpeculations") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+
+  class MockConsumer final : public diagnostics::DiagnosticConsumer {
+  public:
+    zc::Vector<diagnostics::DiagID> ids;
+    void handleDiagnostic(const source::SourceManager&,
+                          const diagnostics::Diagnostic& diag) override {
+      ids.add(diag.getId());
+    }
+  };
+
+  auto consumer = zc::heap<MockConsumer>();
+  auto consumerPtr = consumer.get();
+  diagnosticEngine->addConsumer(zc::mv(consumer));
+
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  // Every `<` starts a type argument speculation that runs to the innermost `0x` and fails, and
+  // every `(` in it asks whether a function type starts there.
+  zc::Vector<zc::String> parts;
+  for (int i = 0; i < 200; ++i) { parts.add(zc::str("g(a < (b, ")); }
+  parts.add(zc::str("0x"));
+  for (int i = 0; i < 200; ++i) { parts.add(zc::str("))")); }
+  zc::String code = zc::str("let x = ", zc::strArray(parts, ""), ";\nlet y = f<i32>(1);\n");
+
+  auto bufferId = sourceManager->addMemBufferCopy(code.asBytes(), "test.zom");
+  Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+
+  // The lexer error in the speculated region is reported once, by the parse that keeps it.
+  ZC_ASSERT(consumerPtr->ids.size() == 1, consumerPtr->ids.size());
+  ZC_EXPECT(consumerPtr->ids[0] == diagnostics::DiagID::HexadecimalDigitExpected);
+
+  auto& sourceFile = ast::cast<ast::SourceFile>(*ZC_ASSERT_NONNULL(result));
+  ZC_ASSERT(sourceFile.getStatements().size() == 2);
+}
+
+ZC_TEST("ParserTest.LazyFunctionBodies") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+
+  class MockConsumer final : public diagnostics::DiagnosticConsumer {
+  public:
+    zc::Vector<diagnostics::DiagID> ids;
+    void handleDiagnostic(const source::SourceManager&,
+                          const diagnostics::Diagnostic& diag) override {
+      ids.add(diag.getId());
+    }
+  };
+
+  auto consumer = zc::heap<MockConsumer>();
+  auto consumerPtr = consumer.get();
+  diagnosticEngine->addConsumer(zc::mv(consumer));
+
+  basic::LangOptions langOpts;
+  langOpts.lazyFunctionBodies = true;
+  basic::StringPool stringPool;
+
+  // The braces inside the template literal must not end the body early.
+  auto bufferId = sourceManager->addMemBufferCopy(
+      zc::str("fun f() { let s = `a${ {k: 1} }b${y}c`; if (s) { return 1; } return 0x; }\n"
+              "class C { fun m() { let a = 1; } }\n"
+              "let z = 1;\n")
+          .asBytes(),
+      "test.zom");
+  Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+  auto& sourceFile = ast::cast<ast::SourceFile>(*ZC_ASSERT_NONNULL(result));
+  ZC_ASSERT(sourceFile.getStatements().size() == 3);
+
+  // The lexer error in the body is not reported until the body is parsed.
+  ZC_EXPECT(consumerPtr->ids.size() == 0, consumerPtr->ids.size());
+
+  auto& function = ast::cast<ast::FunctionDeclaration>(sourceFile.getStatements()[0]);
+  ZC_EXPECT(function.isBodyDeferred());
+  const auto& body = ast::cast<ast::BlockStatement>(function.getBody());
+  ZC_EXPECT(!function.isBodyDeferred());
+  ZC_EXPECT(body.getStatements().size() == 3);
+  ZC_EXPECT(&function.getBody() == &body);
+  ZC_ASSERT(consumerPtr->ids.size() == 1, consumerPtr->ids.size());
+  ZC_EXPECT(consumerPtr->ids[0] == diagnostics::DiagID::HexadecimalDigitExpected);
+
+  ZC_EXPECT(body.getSourceRange().getStart() == sourceManager->getLocForOffset(bufferId, 8));
+  ZC_EXPECT(function.getSourceRange().getEnd() == body.getSourceRange().getEnd());
+
+  auto& classDecl = ast::cast<ast::ClassDeclaration>(sourceFile.getStatements()[1]);
+  ZC_ASSERT(classDecl.getMembers().size() == 1);
+  const auto& method = static_cast<const ast::MethodDeclaration&>(classDecl.getMembers()[0]);
+  ZC_EXPECT(method.isBodyDeferred());
+  ZC_IF_SOME(methodBody, method.getBody()) {
+    ZC_EXPECT(ast::cast<ast::BlockStatement>(methodBody).getStatements().size() == 1);
+  }
+  else { ZC_FAIL_EXPECT("method body should be parsed"); }
+  ZC_EXPECT(consumerPtr->ids.size() == 1);
+}
+
+ZC_TEST("ParserTest.LazyFunctionBodyUnbalancedParsesEagerly") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  langOpts.lazyFunctionBodies = true;
+  basic::StringPool stringPool;
+
+  auto bufferId =
+      sourceManager->addMemBufferCopy(zc::str("fun f() { let a = 1;").asBytes(), "test.zom");
+  Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+  ZC_EXPECT(diagnosticEngine->hasErrors());
+
+  auto& sourceFile = ast::cast<ast::SourceFile>(*ZC_ASSERT_NONNULL(result));
+  ZC_ASSERT(sourceFile.getStatements().size() == 1);
+  auto& function = ast::cast<ast::FunctionDeclaration>(sourceFile.getStatements()[0]);
+  ZC_EXPECT(!function.isBodyDeferred());
+}
+
+ZC_TEST("ParserTest.NestedListsKeepTheirElements") {
+  auto sourceManager = zc::heap<source::SourceManager>();
+  auto diagnosticEngine = zc::heap<diagnostics::DiagnosticEngine>(*sourceManager);
+  basic::LangOptions langOpts;
+  basic::StringPool stringPool;
+
+  // Inner lists are built on the scratch stack above the outer ones and moved out first.
+  auto bufferId = sourceManager->addMemBufferCopy(
+      zc::str("let v = f(a, g(b, h(), c), [d, k(e, [])], j);").asBytes(), "test.zom");
+  Parser parser(*sourceManager, *diagnosticEngine, langOpts, stringPool, bufferId);
+  auto result = parser.parse();
+  ZC_ASSERT(result != zc::none);
+  ZC_EXPECT(!diagnosticEngine->hasErrors());
+
+  auto& sourceFile = ast::cast<ast::SourceFile>(*ZC_ASSERT_NONNULL(result));
+  ZC_ASSERT(sourceFile.getStatements().size() == 1);
+  auto& variableStatement = ast::cast<ast::VariableStatement>(sourceFile.getStatements()[0]);
+  const auto& declarations = variableStatement.getDeclarations().getBindings();
+  ZC_ASSERT(declarations.size() == 1);
+  const auto& outer =
+      ast::cast<ast::CallExpression>(ZC_ASSERT_NONNULL(declarations[0].getInitializer()));
+  ZC_ASSERT(outer.getArguments().size() == 4);
+  ZC_EXPECT(ast::cast<ast::Identifier>(outer.getArguments()[0]).getText() == "a"_zc);
+  ZC_EXPECT(ast::cast<ast::Identifier>(outer.getArguments()[3]).getText() == "j"_zc);
+
+  const auto& inner = ast::cast<ast::CallExpression>(outer.getArguments()[1]);
+  ZC_ASSERT(inner.getArguments().size() == 3);
+  ZC_EXPECT(ast::cast<ast::CallExpression>(inner.getArguments()[1]).getArguments().empty());
+  ZC_EXPECT(ast::cast<ast::Identifier>(inner.getArguments()[2]).getText() == "c"_zc);
+
+  const auto& array = ast::cast<ast::ArrayLiteralExpression>(outer.getArguments()[2]);
+  ZC_ASSERT(array.getElements().size() == 2);
+  const auto& nested = ast::cast<ast::CallExpression>(array.getElements()[1]);
+  ZC_ASSERT(nested.getArguments().size() == 2);
+  ZC_EXPECT(ast::cast<ast::ArrayLiteralExpression>(nested.getArguments()[1]).getElements().empty());
+}
+
 }  // namespace parser
 }  // namespace compiler
 }  // namespace zomlang
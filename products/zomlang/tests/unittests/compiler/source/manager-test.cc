@@ -14,9 +14,15 @@
 
 #include "zomlang/compiler/source/manager.h"
 
+#include <unistd.h>
+
 #include "zc/core/common.h"
+#include "zc/core/filesystem.h"
 #include "zc/core/string.h"
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/source/location.h"
 
 namespace zomlang {
@@ -56,6 +62,197 @@ ZC_TEST("SourceManager: File System Operations") {
   ZC_EXPECT(id1 != id2);
 }
 
+ZC_TEST("SourceManager: Loaded Text Ends In A Sentinel") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-source-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  SourceManager manager;
+  // Small files are read; large ones are mapped unless they end on a page boundary.
+  for (size_t size : {size_t(5), size_t(16 * 1024), size_t(20000)}) {
+    zc::String content = zc::heapString(size);
+    for (size_t i = 0; i < size; ++i) { content[i] = 'a' + i % 26; }
+    const zc::Path path = root.append(zc::str("source-", size, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(content);
+
+    BufferId bufferId = ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(path.toString(true)));
+    zc::ArrayPtr<const zc::byte> text = manager.getEntireTextForBuffer(bufferId);
+    ZC_EXPECT(text == content.asBytes(), size);
+    ZC_EXPECT(*text.end() == 0, size);
+  }
+
+  BufferId copyId = manager.addMemBufferCopy("copy"_zc.asBytes(), "copy.zom");
+  ZC_EXPECT(*manager.getEntireTextForBuffer(copyId).end() == 0);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("SourceManager: Files Load In Parallel, Register In Order") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-parallel-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+
+  zc::Vector<zc::String> paths;
+  for (size_t i = 0; i < 8; ++i) {
+    const zc::Path path = root.append(zc::str("file-", i, ".zom"));
+    rootDir.openFile(path, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+        ->writeAll(zc::str("let x", i, " = ", i, ";\n"));
+    paths.add(path.toString(true));
+  }
+  const zc::String missing = root.append("missing.zom").toString(true);
+
+  SourceManager manager;
+  BufferId first = ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(paths[0]));
+
+  zc::Vector<zc::StringPtr> batch;
+  for (const zc::String& path : paths) { batch.add(path); }
+  batch.add(missing);
+  batch.add(paths[3]);
+  basic::ThreadPool threadPool(2);
+  zc::Vector<zc::Maybe<BufferId>> ids = manager.getFileSystemSourceBufferIDs(batch, threadPool);
+  ZC_ASSERT(ids.size() == batch.size());
+
+  // Already loaded and repeated paths map to one buffer; the rest are numbered in order.
+  ZC_EXPECT(ZC_ASSERT_NONNULL(ids[0]) == first);
+  for (size_t i = 1; i < paths.size(); ++i) {
+    const BufferId id = ZC_ASSERT_NONNULL(ids[i]);
+    ZC_EXPECT(uint64_t(id) == uint64_t(first) + i, i);
+    ZC_EXPECT(manager.getEntireTextForBuffer(id) == zc::str("let x", i, " = ", i, ";\n").asBytes(),
+              i);
+    ZC_EXPECT(manager.getLocForBufferStart(id) > manager.getLocForBufferStart(first), i);
+  }
+  ZC_EXPECT(ids[paths.size()] == zc::none);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(ids[paths.size() + 1]) == ZC_ASSERT_NONNULL(ids[3]));
+  ZC_EXPECT(manager.getManagedBufferIds().size() == paths.size());
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("SourceManager: Overlays Stand In For Files") {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Path root =
+      filesystem->getCurrentPath().eval(zc::str("/tmp/zomlang-overlay-test-", getpid()));
+  const zc::Directory& rootDir = filesystem->getRoot();
+  rootDir.tryRemove(root);
+  const zc::Path onDisk = root.append("saved.zom");
+  rootDir.openFile(onDisk, zc::WriteMode::CREATE | zc::WriteMode::CREATE_PARENT)
+      ->writeAll("let saved = 1;\n"_zc);
+  const zc::String saved = onDisk.toString(true);
+  const zc::String unsaved = root.append("unsaved.zom").toString(true);
+
+  SourceManager manager;
+  const uint64_t start = manager.getLatestOverlayVersion();
+  const BufferId savedId = ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(saved));
+  ZC_EXPECT(manager.getOverlayVersion(saved) == zc::none);
+
+  // An overlay replaces the file's buffer, and its text is not copied.
+  zc::String text = zc::str("let edited = 2;\n");
+  const char* const chars = text.begin();
+  const uint64_t first = manager.setOverlay(saved, zc::mv(text));
+  ZC_EXPECT(first > start);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(manager.getOverlayVersion(saved)) == first);
+  const BufferId editedId = ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(saved));
+  ZC_EXPECT(editedId != savedId);
+  ZC_EXPECT(manager.getEntireTextForBuffer(editedId).asChars().begin() == chars);
+  ZC_EXPECT(*manager.getEntireTextForBuffer(editedId).end() == 0);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(manager.reloadFileSystemSourceBuffer(saved)) == editedId);
+
+  // Files that exist nowhere but in the editor, read alone or in a batch.
+  const uint64_t second = manager.setOverlay(unsaved, zc::str("let draft = 3;\n"));
+  ZC_EXPECT(second > first);
+  zc::StringPtr batch[] = {unsaved, saved};
+  basic::ThreadPool threadPool(2);
+  auto ids = manager.getFileSystemSourceBufferIDs(batch, threadPool);
+  ZC_EXPECT(manager.getEntireTextForBuffer(ZC_ASSERT_NONNULL(ids[0])) ==
+            "let draft = 3;\n"_zc.asBytes());
+  ZC_EXPECT(ZC_ASSERT_NONNULL(ids[1]) == editedId);
+
+  // Released, an overlay's buffer is made again from the overlay rather than the disk.
+  manager.releaseBuffer(editedId);
+  const BufferId again = ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(saved));
+  ZC_EXPECT(manager.getEntireTextForBuffer(again) == "let edited = 2;\n"_zc.asBytes());
+
+  // Setting the same text keeps the buffer but still counts as a change.
+  ZC_EXPECT(manager.getOverlaysChangedSince(second).size() == 0);
+  manager.setOverlay(saved, zc::str("let edited = 2;\n"));
+  ZC_EXPECT(ZC_ASSERT_NONNULL(manager.getFileSystemSourceBufferID(saved)) == again);
+  auto changed = manager.getOverlaysChangedSince(second);
+  ZC_ASSERT(changed.size() == 1);
+  ZC_EXPECT(changed[0].endsWith("saved.zom"));
+
+  // Removed, the file is read from disk again, and an unsaved one is gone.
+  const uint64_t beforeRemoval = manager.getLatestOverlayVersion();
+  manager.removeOverlay(saved);
+  manager.removeOverlay(unsaved);
+  manager.removeOverlay(unsaved);
+  ZC_EXPECT(manager.getOverlayVersion(saved) == zc::none);
+  ZC_EXPECT(manager.getOverlaysChangedSince(beforeRemoval).size() == 2);
+  ZC_EXPECT(manager.getEntireTextForBuffer(ZC_ASSERT_NONNULL(
+                manager.getFileSystemSourceBufferID(saved))) == "let saved = 1;\n"_zc.asBytes());
+  ZC_EXPECT(manager.getFileSystemSourceBufferID(unsaved) == zc::none);
+  ZC_EXPECT(manager.getOverlaysChangedSince(start).size() == 2);
+
+  rootDir.remove(root);
+}
+
+ZC_TEST("SourceManager: Lookups Run While Buffers Are Added") {
+  SourceManager manager;
+  const zc::StringPtr content = "one\ntwo\nthree\n"_zc;
+  const BufferId fixed = manager.addMemBufferCopy(content.asBytes(), "fixed.zom");
+  const SourceLoc twoLoc = manager.getLocForOffset(fixed, 4);
+
+  {
+    zc::Vector<zc::Own<zc::Thread>> readers;
+    for (int i = 0; i < 4; ++i) {
+      readers.add(zc::heap<zc::Thread>([&]() {
+        for (int n = 0; n < 2000; ++n) {
+          ZC_ASSERT(ZC_ASSERT_NONNULL(manager.findBufferContainingLoc(twoLoc)) == fixed);
+          ZC_ASSERT(manager.getLineAndColumn(twoLoc).line == 2);
+          ZC_ASSERT(manager.getEntireTextForBuffer(fixed) == content.asBytes());
+          for (const BufferId& id : manager.getManagedBufferIds()) {
+            const SourceLoc start = manager.getLocForBufferStart(id);
+            ZC_ASSERT(ZC_ASSERT_NONNULL(manager.findBufferContainingLoc(start)) == id);
+          }
+        }
+      }));
+    }
+    for (int n = 0; n < 500; ++n) {
+      manager.addMemBufferCopy(zc::str("buffer ", n, "\n").asBytes(), zc::str("added-", n));
+    }
+    // Destroying the threads joins them.
+  }
+
+  ZC_EXPECT(manager.getManagedBufferIds().size() == 501);
+}
+
+ZC_TEST("SourceManager: Content Hash Follows Text") {
+  SourceManager manager;
+  SourceManager other;
+
+  const BufferId first = manager.addMemBufferCopy("let x = 1;\n"_zcb, "first.zom");
+  const BufferId renamed = manager.addMemBufferCopy("let x = 1;\n"_zcb, "renamed.zom");
+  const BufferId changed = manager.addMemBufferCopy("let x = 2;\n"_zcb, "first.zom");
+  const BufferId elsewhere = other.addMemBufferCopy("let x = 1;\n"_zcb, "first.zom");
+
+  ZC_EXPECT(manager.getContentHash(first) == manager.getContentHash(renamed));
+  ZC_EXPECT(manager.getContentHash(first) == other.getContentHash(elsewhere));
+  ZC_EXPECT(manager.getContentHash(first) != manager.getContentHash(changed));
+
+  // Every tail length of the word-at-a-time loop contributes to the hash.
+  const zc::StringPtr text = "0123456789abcdef"_zc;
+  for (size_t size = 1; size <= text.size(); ++size) {
+    const BufferId prefix = manager.addMemBufferCopy(text.first(size).asBytes(), "prefix.zom");
+    const BufferId shorter =
+        manager.addMemBufferCopy(text.first(size - 1).asBytes(), "shorter.zom");
+    ZC_EXPECT(manager.getContentHash(prefix) != manager.getContentHash(shorter), size);
+  }
+}
+
 ZC_TEST("SourceManager: Buffer Identification") {
   SourceManager manager;
 
@@ -103,6 +300,30 @@ ZC_TEST("SourceManager: Source Ranges") {
   ZC_EXPECT(range.length() == 11);
 }
 
+ZC_TEST("SourceManager: Location Space") {
+  SourceManager manager;
+
+  BufferId first = manager.addMemBufferCopy("abc"_zc.asBytes(), "first.txt");
+  BufferId second = manager.addMemBufferCopy("defgh"_zc.asBytes(), "second.txt");
+
+  // Each buffer owns its bytes and its end location, so the ranges neither overlap nor touch.
+  SourceLoc firstEnd = manager.getRangeForBuffer(first).getEnd();
+  SourceLoc secondStart = manager.getLocForBufferStart(second);
+  ZC_EXPECT(firstEnd < secondStart);
+  ZC_EXPECT(manager.findBufferContainingLoc(firstEnd) == first);
+  ZC_EXPECT(manager.findBufferContainingLoc(secondStart) == second);
+  ZC_EXPECT(manager.findBufferContainingLoc(manager.getLocForOffset(first, 1)) == first);
+  ZC_EXPECT(manager.findBufferContainingLoc(manager.getRangeForBuffer(second).getEnd() + 1) ==
+            zc::none);
+  ZC_EXPECT(manager.findBufferContainingLoc(SourceLoc()) == zc::none);
+
+  SourceLoc e = manager.getLocForOffset(second, 1);
+  ZC_EXPECT(manager.getLocOffsetInBuffer(e, second) == 1);
+  ZC_EXPECT(*manager.getCharacterData(e) == 'e');
+  ZC_EXPECT(manager.extractText(SourceRange(e, e + 3), zc::none) == "efg"_zc.asBytes());
+  ZC_EXPECT(manager.extractTextFast(SourceRange(e, e + 3), first).size() == 0);
+}
+
 ZC_TEST("SourceManager: Virtual File Layering") {
   SourceManager manager;
 
@@ -171,7 +392,7 @@ ZC_TEST("SourceManager: Edge Cases and Error Handling") {
 
   // Test invalid BufferId
   BufferId invalidId(999999);
-  ZC_EXPECT_THROW_MESSAGE("expected impl->idToBuffer.find(bufferId) != nullptr",
+  ZC_EXPECT_THROW_MESSAGE("expected impl->getBuffer(bufferId) != nullptr",
                           manager.getEntireTextForBuffer(invalidId));
 
   // Test invalid location
@@ -253,6 +474,130 @@ ZC_TEST("SourceManager: Content Comparison") {
   ZC_EXPECT(text1.size() == content1.size());
 }
 
+ZC_TEST("SourceManager: Line Column Matches Byte Scan") {
+  SourceManager manager;
+
+  zc::StringPtr content = "first\r\nsecond\n\n\tthird\nlast"_zc;
+  auto bufferId = manager.addMemBufferCopy(content.asBytes(), "scan.txt");
+
+  unsigned line = 1;
+  unsigned column = 1;
+  for (size_t offset = 0; offset <= content.size(); ++offset) {
+    auto lineCol =
+        manager.getPresumedLineAndColumnForLoc(manager.getLocForOffset(bufferId, offset), bufferId);
+    ZC_EXPECT(lineCol.line == line && lineCol.column == column, offset);
+    if (offset < content.size() && content[offset] == '\n') {
+      ++line;
+      column = 1;
+    } else {
+      ++column;
+    }
+  }
+}
+
+ZC_TEST("SourceManager: Line Lookups In Any Order") {
+  SourceManager manager;
+
+  zc::StringPtr content = "a\nbb\nccc\n\ndddd\n"_zc;
+  auto first = manager.addMemBufferCopy(content.asBytes(), "first.txt");
+  auto second = manager.addMemBufferCopy(content.asBytes(), "second.txt");
+
+  const unsigned lineStarts[] = {0, 2, 5, 9, 10, 15};
+  auto lineAt = [&](BufferId id, unsigned offset) {
+    return manager.getPresumedLineAndColumnForLoc(manager.getLocForOffset(id, offset), id).line;
+  };
+  // Walk backwards, forwards, across gaps and between buffers; the line cache must agree with a
+  // fresh lookup each time.
+  const unsigned lines[] = {6, 5, 4, 3, 2, 1, 2, 3, 6, 1, 4, 4, 5};
+  for (unsigned line : lines) {
+    ZC_EXPECT(lineAt(first, lineStarts[line - 1]) == line, line);
+    ZC_EXPECT(lineAt(second, lineStarts[line - 1]) == line, line);
+  }
+  ZC_EXPECT(lineAt(first, 4) == 2);
+  ZC_EXPECT(lineAt(first, 8) == 3);
+  ZC_EXPECT(lineAt(first, 0) == 1);
+}
+
+ZC_TEST("SourceManager: Batched Line Columns Match Single Lookups") {
+  SourceManager manager;
+
+  // Long enough that a sweep gallops over many lines between two locations.
+  zc::Vector<zc::String> lines;
+  for (int i = 0; i < 200; ++i) { lines.add(zc::str("line ", i, i % 3 == 0 ? " and more" : "")); }
+  const zc::String content = zc::strArray(lines, "\n");
+  auto first = manager.addMemBufferCopy(content.asBytes(), "first.txt");
+  auto second = manager.addMemBufferCopy("a\r\nbb\n"_zcb, "second.txt");
+
+  // Unsorted, repeated, across buffers, at buffer ends, and invalid.
+  zc::Vector<SourceLoc> locs;
+  for (const unsigned offset : {900u, 3u, 1500u, 0u, 901u, 40u, 3u}) {
+    locs.add(manager.getLocForOffset(first, offset));
+  }
+  locs.add(manager.getLocForOffset(first, content.size()));
+  for (const unsigned offset : {5u, 0u, 2u, 3u}) {
+    locs.add(manager.getLocForOffset(second, offset));
+  }
+  locs.add(SourceLoc());
+
+  auto resolved = manager.resolveLineColumns(locs);
+  ZC_ASSERT(resolved.size() == locs.size());
+  for (size_t i = 0; i + 1 < locs.size(); ++i) {
+    const LineAndColumn expected = manager.getLineAndColumn(locs[i]);
+    ZC_EXPECT(resolved[i].line == expected.line && resolved[i].column == expected.column, i,
+              resolved[i].line, resolved[i].column, expected.line, expected.column);
+  }
+  ZC_EXPECT(resolved.back().line == 0 && resolved.back().column == 0);
+  ZC_EXPECT(manager.resolveLineColumns(nullptr).size() == 0);
+}
+
+ZC_TEST("SourceManager: Released Buffers Keep Their Locations") {
+  SourceManager manager;
+
+  auto first = manager.addMemBufferCopy("first\nbuffer\n"_zc.asBytes(), "first.zom");
+  auto second = manager.addMemBufferCopy("second\n"_zc.asBytes(), "second.zom");
+  const SourceLoc inFirst = manager.getLocForOffset(first, 8);
+  const SourceLoc inSecond = manager.getLocForOffset(second, 2);
+
+  manager.releaseBuffer(first);
+  ZC_EXPECT(manager.getEntireTextForBuffer(first).size() == 0);
+  ZC_EXPECT(manager.getRangeForBuffer(first).length() == 13);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(manager.findBufferContainingLoc(inFirst)) == first);
+  const SourceRange range(inFirst, inFirst.getAdvancedLoc(2));
+  ZC_EXPECT(manager.extractText(range, first).size() == 0);
+  ZC_EXPECT(manager.getLineAndColumn(inFirst).line == 1);
+  ZC_EXPECT(manager.getManagedBufferIds().size() == 1);
+
+  // The other buffer is untouched
+  ZC_EXPECT(manager.getEntireTextForBuffer(second).asChars() == "second\n"_zc.asArray());
+  ZC_EXPECT(manager.getLineAndColumn(inSecond).column == 3);
+}
+
+ZC_TEST("SourceManager: Extracted Text Is Cached By Range") {
+  SourceManager manager;
+  auto bufferId = manager.addMemBufferCopy("let x = y;"_zc.asBytes(), "cached.zom");
+  const SourceLoc x = manager.getLocForOffset(bufferId, 4);
+  const SourceRange range(x, x.getAdvancedLoc(5));
+
+  zc::StringPtr text = manager.extractTextAsStringPtr(range);
+  ZC_EXPECT(text == "x = y");
+  ZC_EXPECT(text.cStr()[text.size()] == '\0');
+  ZC_EXPECT(manager.extractTextFastAsStringPtr(range, bufferId).begin() == text.begin());
+  ZC_EXPECT(manager.extractTextAsStringPtr(SourceRange(x, x.getAdvancedLoc(1))) == "x");
+
+  // Another manager hands out the same locations for other text.
+  {
+    SourceManager other;
+    auto otherId = other.addMemBufferCopy("var a = b;"_zc.asBytes(), "other.zom");
+    ZC_EXPECT(other.getLocForOffset(otherId, 4) == x);
+    ZC_EXPECT(other.extractTextAsStringPtr(range) == "a = b");
+  }
+  ZC_EXPECT(manager.extractTextAsStringPtr(range) == "x = y");
+
+  // A released buffer has no text left to extract, cached or not.
+  manager.releaseBuffer(bufferId);
+  ZC_EXPECT(manager.extractTextAsStringPtr(range) == "");
+}
+
 }  // namespace source
 }  // namespace compiler
 }  // namespace zomlang
@@ -0,0 +1,103 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/compiler/symbol/module-index.h"
+
+#include "zc/ztest/test.h"
+#include "zomlang/compiler/symbol/scope.h"
+#include "zomlang/compiler/symbol/symbol-table.h"
+#include "zomlang/compiler/symbol/value-symbol.h"
+
+namespace zomlang {
+namespace compiler {
+namespace symbol {
+
+ZC_TEST("ModuleIndex_SerializeRoundTrip") {
+  const source::SourceLoc base = source::SourceLoc::getFromOpaqueValue(100);
+  const ModuleIndex::ExportedSymbol symbols[] = {
+      {"distance"_zc, SymbolKind::Function, SymbolFlags::Function,
+       source::SourceRange(base + 40, base + 60)},
+      {"Point"_zc, SymbolKind::Class, SymbolFlags::Class, source::SourceRange(base + 2, base + 30)},
+      {"origin"_zc, SymbolKind::Variable, SymbolFlags::Variable, source::SourceRange()},
+  };
+  ModuleIndex original("math.geometry"_zc, symbols, base);
+  ZC_EXPECT(original.getModuleName() == "math.geometry"_zc);
+  ZC_ASSERT(original.size() == 3);
+
+  zc::Array<zc::byte> image = original.serialize();
+  auto maybeIndex = ModuleIndex::deserialize(image.asPtr().asConst(), base);
+  ZC_ASSERT(maybeIndex != zc::none);
+  auto& index = ZC_ASSERT_NONNULL(maybeIndex);
+
+  ZC_EXPECT(index.getModuleName() == "math.geometry"_zc);
+  ZC_ASSERT(index.size() == original.size());
+  const auto point = ZC_ASSERT_NONNULL(index.find("Point"_zc));
+  ZC_EXPECT(index.getKind(point) == SymbolKind::Class);
+  ZC_EXPECT(index.getFlags(point) == SymbolFlags::Class);
+  ZC_EXPECT(index.getSourceRange(point).getStart() == base + 2);
+  ZC_EXPECT(index.getSourceRange(point).getLength() == 28);
+  const auto origin = ZC_ASSERT_NONNULL(index.find("origin"_zc));
+  ZC_EXPECT(index.getSourceRange(origin).isInvalid());
+  ZC_EXPECT(index.find("missing"_zc) == zc::none);
+
+  // The names point into the image rather than into a copy.
+  const zc::StringPtr name = index.getQualifiedName(point);
+  ZC_EXPECT(name.begin() >= reinterpret_cast<const char*>(image.begin()) &&
+            name.end() < reinterpret_cast<const char*>(image.end()));
+
+  // Truncated or foreign images are rejected.
+  ZC_EXPECT(ModuleIndex::deserialize(image.first(image.size() - 8).asConst(), {}) == zc::none);
+  image[4] ^= 0xff;
+  ZC_EXPECT(ModuleIndex::deserialize(image.asPtr().asConst(), {}) == zc::none);
+}
+
+ZC_TEST("ModuleIndex_ResolvesWithoutBinding") {
+  zc::Array<zc::byte> image;
+  {
+    // The build that bound the module
+    SymbolTable table;
+    Scope& moduleScope =
+        table.getScopeManager().createScope(Scope::Kind::Module, "geometry"_zc,
+                                            table.getScopeManager().getGlobalScopeMutable());
+    table.createClass("Point"_zc, moduleScope);
+    table.createFunction("distance"_zc, moduleScope);
+    table.createVariable("hidden"_zc, moduleScope).addFlag(SymbolFlags::Private);
+    image = table.exportModuleIndex("math.geometry"_zc, moduleScope).serialize();
+  }
+
+  // A later build that only has the index
+  SymbolTable table;
+  const Scope& globalScope = ZC_ASSERT_NONNULL(table.getScopeManager().getGlobalScope());
+  auto index = ZC_ASSERT_NONNULL(ModuleIndex::deserialize(image.asPtr().asConst(), {}));
+  ZC_EXPECT(index.size() == 2);
+  table.addModuleIndex(zc::mv(index));
+  ZC_EXPECT(table.getSymbolCount() == 0);
+
+  auto& point = ZC_ASSERT_NONNULL(table.resolveQualified("math.geometry.Point"_zc, globalScope));
+  ZC_EXPECT(point.getName() == "Point"_zc);
+  ZC_EXPECT(point.getKind() == SymbolKind::Class);
+  ZC_EXPECT(table.getSymbolCount() == 1);
+
+  // Resolving again finds the symbol already created.
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.resolveQualified("math.geometry.Point"_zc, globalScope)) ==
+            &point);
+  ZC_EXPECT(table.getSymbolCount() == 1);
+
+  ZC_EXPECT(table.resolveQualified("math.geometry.hidden"_zc, globalScope) == zc::none);
+  ZC_EXPECT(table.resolveQualified("math.geometryPoint"_zc, globalScope) == zc::none);
+}
+
+}  // namespace symbol
+}  // namespace compiler
+}  // namespace zomlang
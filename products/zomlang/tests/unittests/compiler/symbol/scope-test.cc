@@ -15,6 +15,7 @@
 #include "zomlang/compiler/symbol/scope.h"
 
 #include "zc/core/debug.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/type.h"
@@ -103,6 +104,39 @@ ZC_TEST("Scope_SymbolRemoval") {
   ZC_EXPECT(scope.getSymbolCount() == 0);
 }
 
+ZC_TEST("Scope_ManySymbolsAndRemovals") {
+  ScopeManager manager;
+  Scope& globalScope = manager.createScope(Scope::Kind::Global, "global");
+  Scope& blockScope = manager.createScope(Scope::Kind::Block, "block", globalScope);
+  constexpr uint32_t kNames = 100;
+
+  // Enough names to move past the inline array and through several table resizes.
+  zc::Vector<zc::String> names;
+  for (uint32_t n = 0; n < kNames; ++n) { names.add(zc::str("sym_", n)); }
+  for (uint32_t n = 0; n < kNames; ++n) {
+    globalScope.addSymbol(zc::heap<Symbol>(SymbolId::create(n + 1), names[n], SymbolFlags::Public,
+                                           source::SourceLoc{}));
+  }
+  ZC_EXPECT(globalScope.getSymbolCount() == kNames);
+
+  // Remove every third name; the rest must stay reachable through their probe runs.
+  for (uint32_t n = 0; n < kNames; n += 3) { globalScope.removeSymbol(names[n]); }
+  for (uint32_t n = 0; n < kNames; ++n) {
+    ZC_EXPECT(globalScope.hasSymbol(names[n]) == (n % 3 != 0), n);
+    ZC_EXPECT((blockScope.lookupSymbolRecursively(names[n]) != zc::none) == (n % 3 != 0), n);
+  }
+  ZC_EXPECT(globalScope.getSymbolCount() == kNames - (kNames + 2) / 3);
+
+  // A local declaration shadows the outer one.
+  blockScope.addSymbol(zc::heap<Symbol>(SymbolId::create(kNames + 1), names[1],
+                                        SymbolFlags::Private, source::SourceLoc{}));
+  ZC_IF_SOME(found, blockScope.lookupSymbolRecursively(names[1])) {
+    ZC_EXPECT(found.getId() == SymbolId::create(kNames + 1));
+  }
+  else { ZC_FAIL_EXPECT("shadowing symbol not found"); }
+  ZC_EXPECT(blockScope.getSymbolCount() == 1);
+}
+
 ZC_TEST("Scope_ChildManagement") {
   ScopeManager manager;
   Scope& parentScope = manager.createScope(Scope::Kind::Package, "parent");
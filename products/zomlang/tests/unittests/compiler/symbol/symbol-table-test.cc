@@ -14,11 +14,14 @@
 
 #include "zomlang/compiler/symbol/symbol-table.h"
 
+#include "zc/core/thread.h"
+#include "zc/core/vector.h"
 #include "zc/ztest/test.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/type.h"
 #include "zomlang/compiler/symbol/scope.h"
 #include "zomlang/compiler/symbol/symbol.h"
+#include "zomlang/compiler/symbol/type-symbol.h"
 #include "zomlang/compiler/symbol/value-symbol.h"
 
 namespace zomlang {
@@ -393,12 +396,11 @@ ZC_TEST("SymbolTable_PhaseManagement") {
   // Test default phase
   ZC_EXPECT(table.getCurrentPhase() == 0);  // Default phase
 
-  // Note: setCurrentPhase method is not implemented yet
-  // table.setCurrentPhase(1);
-  // ZC_EXPECT(table.getCurrentPhase() == 1);
+  table.setCurrentPhase(1);
+  ZC_EXPECT(table.getCurrentPhase() == 1);
 
-  // table.setCurrentPhase(2);
-  // ZC_EXPECT(table.getCurrentPhase() == 2);
+  table.setCurrentPhase(2);
+  ZC_EXPECT(table.getCurrentPhase() == 2);
 }
 
 ZC_TEST("SymbolTable_DenotationLookup") {
@@ -423,6 +425,36 @@ ZC_TEST("SymbolTable_DenotationLookup") {
   else { ZC_FAIL_EXPECT("Expected to find denotation recursively"); }
 }
 
+ZC_TEST("SymbolTable_DenotationPhases") {
+  SymbolTable table;
+  const Scope& globalScope = ZC_ASSERT_NONNULL(table.getScopeManager().getGlobalScope());
+  table.createVariable("v", globalScope);
+
+  // Lookups share one denotation until a phase changes it.
+  SymbolDenotation& initial = ZC_ASSERT_NONNULL(table.lookupDenotation("v", globalScope));
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.lookupDenotation("v", globalScope)) == &initial);
+  ZC_EXPECT(table.getDenotationCount() == 1);
+
+  // Updating in the phase the denotation starts in changes it in place.
+  ZC_EXPECT(&table.updateDenotation(initial) == &initial);
+
+  // Phase 2 leaves the symbol alone; phase 3 changes it.
+  table.setCurrentPhase(3);
+  SymbolDenotation& changed = table.updateDenotation(initial);
+  ZC_EXPECT(&changed != &initial);
+  changed.markAbsent();
+  ZC_EXPECT(table.getDenotationCount() == 2);
+  ZC_EXPECT(initial.getValidUntilPhase() == 3);
+  ZC_EXPECT(changed.getValidUntilPhase() == SymbolDenotation::kOpenPeriod);
+  ZC_EXPECT(&changed.getNextInRun() == &initial);
+
+  // Every denotation in the ring can answer for any phase.
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(changed.atPhase(2)) == &initial);
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(initial.atPhase(5)) == &changed);
+  ZC_EXPECT(!initial.isAbsent());
+  ZC_EXPECT(ZC_ASSERT_NONNULL(table.lookupDenotation("v", globalScope)).isAbsent());
+}
+
 ZC_TEST("SymbolTable_ImplicitSymbols") {
   SymbolTable table;
 
@@ -458,6 +490,35 @@ ZC_TEST("SymbolTable_EnterDropSymbols") {
   ZC_EXPECT(table.getSymbolCount() == 1);
 }
 
+ZC_TEST("SymbolTable_EnumerationFollowsEnterDrop") {
+  SymbolTable table;
+  ScopeManager& scopeManager = table.getScopeManager();
+  Scope& globalScope = ZC_ASSERT_NONNULL(scopeManager.getGlobalScopeMutable());
+  const Scope& classScope = scopeManager.createScope(Scope::Kind::Class, "MyClass", globalScope);
+
+  VariableSymbol& var = table.createVariable("var", globalScope);
+  table.createFunction("func", globalScope);
+  table.createVariable("field", classScope);
+
+  ZC_EXPECT(table.getAllSymbols().size() == 3);
+  ZC_EXPECT(table.getSymbolsOfType(SymbolKind::Variable).size() == 2);
+  ZC_EXPECT(table.getSymbolsOfType(SymbolKind::Variable, globalScope).size() == 1);
+  ZC_EXPECT(table.getSymbolsOfType(SymbolKind::Interface, globalScope).empty());
+
+  // A dropped symbol leaves every index, and comes back when entered again.
+  table.dropSymbol(var, globalScope);
+  ZC_EXPECT(table.getAllSymbols().size() == 2);
+  ZC_EXPECT(table.getSymbolsInScope(globalScope).size() == 1);
+  for (const Symbol& symbol : table.getSymbolsOfType(SymbolKind::Variable)) {
+    ZC_EXPECT(symbol.getName() == "field");
+  }
+
+  table.enterSymbol(var, globalScope);
+  table.enterSymbol(var, globalScope);
+  ZC_EXPECT(table.getAllSymbols().size() == 3);
+  ZC_EXPECT(table.getSymbolsOfType(SymbolKind::Variable, globalScope).size() == 1);
+}
+
 ZC_TEST("SymbolTable_AllSymbolsRetrieval") {
   SymbolTable table;
 
@@ -501,6 +562,127 @@ ZC_TEST("SymbolTable_LookupInCurrentScope") {
   }
 }
 
+ZC_TEST("SymbolTable_GenerationTracksNameChanges") {
+  SymbolTable table;
+  Scope& globalScope = ZC_ASSERT_NONNULL(table.getScopeManager().getGlobalScopeMutable());
+
+  uint64_t generation = table.getGeneration();
+  VariableSymbol& var = table.createVariable("v", globalScope);
+  ZC_EXPECT(table.getGeneration() != generation);
+
+  generation = table.getGeneration();
+  table.lookup("v", globalScope);
+  table.lookupRecursive("w", globalScope);
+  ZC_EXPECT(table.getGeneration() == generation);
+
+  table.dropSymbol(var, globalScope);
+  ZC_EXPECT(table.getGeneration() != generation);
+  generation = table.getGeneration();
+  table.enterSymbol(var, globalScope);
+  ZC_EXPECT(table.getGeneration() != generation);
+}
+
+ZC_TEST("SymbolTable_SymbolsById") {
+  SymbolTable table;
+  Scope& globalScope = ZC_ASSERT_NONNULL(table.getScopeManager().getGlobalScopeMutable());
+
+  VariableSymbol& var = table.createVariable("v", globalScope);
+  FunctionSymbol& func = table.createFunction("f", globalScope);
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.getSymbol(var.getId())) == &var);
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.getSymbol(func.getId())) == &func);
+  ZC_EXPECT(table.getSymbol(SymbolId()) == zc::none);
+  ZC_EXPECT(table.getSymbol(SymbolId::create(func.getId().index() + 100)) == zc::none);
+
+  // Dropped symbols are still the table's.
+  table.dropSymbol(var, globalScope);
+  ZC_EXPECT(&ZC_ASSERT_NONNULL(table.getSymbol(var.getId())) == &var);
+
+  ZC_EXPECT(table.getUseCount(var) == 0);
+  table.recordUse(func);
+  table.recordUse(func);
+  table.recordUse(var);
+  ZC_EXPECT(table.getUseCount(func) == 2);
+  ZC_EXPECT(table.getUseCount(var) == 1);
+
+  auto counts = table.getUseCounts();
+  ZC_ASSERT(counts.size() > func.getId().index());
+  ZC_EXPECT(counts[func.getId().index()] == 2);
+  ZC_EXPECT(counts[var.getId().index()] == 1);
+}
+
+ZC_TEST("SymbolTable_SymbolsKeepAddressesAcrossArenaChunks") {
+  SymbolTable table;
+  Scope& globalScope = ZC_ASSERT_NONNULL(table.getScopeManager().getGlobalScopeMutable());
+
+  // Enough symbols to spill over several arena chunks.
+  constexpr int kSymbols = 2000;
+  zc::Vector<zc::String> names;
+  zc::Vector<VariableSymbol*> created;
+  for (int i = 0; i < kSymbols; ++i) {
+    names.add(zc::str("v", i));
+    created.add(&table.createVariable(names.back(), globalScope));
+  }
+
+  for (int i = 0; i < kSymbols; ++i) {
+    ZC_IF_SOME(found, table.lookup(names[i], globalScope)) {
+      ZC_EXPECT(&found == created[i]);
+      ZC_EXPECT(created[i]->getName() == names[i]);
+      ZC_EXPECT(created[i]->getType().getName() == "unit");
+    }
+    else { ZC_FAIL_EXPECT("symbol not found", names[i]); }
+  }
+  ZC_EXPECT(table.getAllSymbols().size() == kSymbols);
+}
+
+ZC_TEST("SymbolTable_ConcurrentBinders") {
+  SymbolTable table;
+  ScopeManager& scopeManager = table.getScopeManager();
+  Scope& globalScope = ZC_ASSERT_NONNULL(scopeManager.getGlobalScopeMutable());
+  constexpr int kThreads = 8;
+  constexpr int kNames = 200;
+
+  // Symbols and scopes keep the names they are given, so they outlive the threads.
+  zc::Vector<zc::String> scopeNames;
+  zc::Vector<zc::String> names;
+  for (int t = 0; t < kThreads; ++t) { scopeNames.add(zc::str("file_", t)); }
+  for (int n = 0; n < kNames; ++n) { names.add(zc::str("name_", n)); }
+
+  zc::Vector<zc::Maybe<Scope&>> fileScopes;
+  for (int t = 0; t < kThreads; ++t) { fileScopes.add(zc::none); }
+  {
+    zc::Vector<zc::Own<zc::Thread>> threads;
+    for (int t = 0; t < kThreads; ++t) {
+      threads.add(zc::heap<zc::Thread>([&, t]() {
+        // Like a binder: a scope of its own, names in it that other threads also declare in
+        // theirs, and lookups of names declared concurrently in the shared global scope.
+        Scope& fileScope =
+            scopeManager.createScope(Scope::Kind::Function, scopeNames[t], globalScope);
+        fileScopes[t] = fileScope;
+        for (int n = 0; n < kNames; ++n) {
+          table.createVariable(names[n], fileScope);
+          if (n % kThreads == t) { table.createFunction(names[n], globalScope); }
+          ZC_EXPECT(table.lookup(names[n], fileScope) != zc::none, t, n);
+          table.lookupRecursive(names[(n + 1) % kNames], fileScope);
+        }
+      }));
+    }
+  }
+
+  ZC_EXPECT(table.getSymbolCount() == kThreads * kNames + kNames);
+  ZC_EXPECT(table.getAllSymbols().size() == kThreads * kNames + kNames);
+  for (int n = 0; n < kNames; ++n) {
+    ZC_IF_SOME(symbol, table.lookup(names[n], globalScope)) {
+      ZC_EXPECT(symbol.getKind() == SymbolKind::Function, n);
+    }
+    else { ZC_FAIL_EXPECT("global function missing", n); }
+  }
+  for (int t = 0; t < kThreads; ++t) {
+    Scope& fileScope = ZC_ASSERT_NONNULL(fileScopes[t]);
+    ZC_EXPECT(scopeManager.getFunctionScope(scopeNames[t]) != zc::none, t);
+    ZC_EXPECT(table.getSymbolsInScope(fileScope).size() == kNames, t);
+  }
+}
+
 }  // namespace symbol
 }  // namespace compiler
 }  // namespace zomlang
@@ -25,6 +25,17 @@ ZC_TEST("RuntimeConfig.ShouldEnableFromEnvironment") {
   ZC_ASSERT(!RuntimeConfig::shouldEnableFromEnvironment());
 }
 
+ZC_TEST("RuntimeConfig.ShouldSampleFromEnvironment") {
+  setenv("ZOM_TRACE_MODE", "sampling", 1);
+  ZC_ASSERT(RuntimeConfig::shouldSampleFromEnvironment());
+
+  setenv("ZOM_TRACE_MODE", "events", 1);
+  ZC_ASSERT(!RuntimeConfig::shouldSampleFromEnvironment());
+
+  unsetenv("ZOM_TRACE_MODE");
+  ZC_ASSERT(!RuntimeConfig::shouldSampleFromEnvironment());
+}
+
 ZC_TEST("RuntimeConfig.GetCategoryMaskFromEnvironment") {
   setenv("ZOM_TRACE_CATEGORIES", "lexer,parser", 1);
   uint32_t mask = RuntimeConfig::getCategoryMaskFromEnvironment();
@@ -14,8 +14,10 @@
 
 #include "zomlang/compiler/trace/trace.h"
 
+#include "zc/core/filesystem.h"
 #include "zc/core/string.h"
 #include "zc/ztest/test.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 
 namespace zomlang {
 namespace compiler {
@@ -351,6 +353,159 @@ ZC_TEST("TraceTest_EventTypeVariations") {
   TraceManager::getInstance().clear();
 }
 
+ZC_TEST("TraceTest_MacrosFollowCachedMask") {
+  TraceConfig config;
+  config.enabled = true;
+  config.categoryMask = TraceCategory::kParser;
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+
+  ZC_EXPECT(ZOM_TRACE_CATEGORY_ENABLED(TraceCategory::kParser) == bool(ZOM_TRACE_ENABLED));
+  ZC_EXPECT(!ZOM_TRACE_CATEGORY_ENABLED(TraceCategory::kLexer));
+
+  {
+    ZOM_TRACE_SCOPE(TraceCategory::kParser, "macro_scope");
+    ZOM_TRACE_SCOPE(TraceCategory::kLexer, "filtered_scope");
+    ZOM_TRACE_EVENT(TraceCategory::kParser, "macro_event", "details");
+    ZOM_TRACE_COUNTER(TraceCategory::kParser, "macro_counter", 42);
+  }
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == (ZOM_TRACE_ENABLED ? 4u : 0u));
+
+  // Disabling tracing is observed by subsequent tracers.
+  config.enabled = false;
+  TraceManager::getInstance().configure(config);
+  ZC_EXPECT(!ZOM_TRACE_CATEGORY_ENABLED(TraceCategory::kParser));
+  { ScopeTracer tracer(TraceCategory::kParser, "disabled_scope"); }
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == 0);
+  ZC_EXPECT(TraceManager::getInstance().getCurrentDepth() == 0);
+}
+
+ZC_TEST("TraceTest_ThreadsRecordIndependently") {
+  TraceConfig config;
+  config.enabled = true;
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+
+  {
+    basic::ThreadPool pool(4);
+    basic::TaskGroup group(pool);
+    for (int task = 0; task < 8; ++task) {
+      group.fork([]() -> void {
+        for (int i = 0; i < 50; ++i) {
+          ScopeTracer tracer(TraceCategory::kParser, "worker_scope", "details");
+          traceCounter(TraceCategory::kParser, "worker_counter", zc::str(i));
+        }
+      });
+    }
+    group.join();
+  }
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == 8 * 50 * 3);
+  ZC_EXPECT(TraceManager::getInstance().intern("worker_scope") ==
+            TraceManager::getInstance().intern("worker_scope"));
+  ZC_EXPECT(TraceManager::getInstance().intern("worker_scope") !=
+            TraceManager::getInstance().intern("worker_counter"));
+
+  TraceManager::getInstance().clear();
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == 0);
+}
+
+ZC_TEST("TraceTest_RingKeepsNewestEvents") {
+  TraceConfig config;
+  config.enabled = true;
+  config.maxEvents = 16;
+  config.outputFile = "/tmp/zom_trace_ring_test.json";
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+
+  {
+    // The capacity applies to threads that start recording now
+    basic::ThreadPool pool(1);
+    basic::TaskGroup group(pool);
+    group.fork([]() -> void {
+      for (int i = 0; i < 100; ++i) { traceEvent(TraceCategory::kDriver, zc::str("event_", i)); }
+    });
+    group.join();
+  }
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == 16);
+
+  TraceManager::getInstance().flush();
+  auto fs = zc::newDiskFilesystem();
+  zc::String json = fs->getRoot().openFile(zc::Path::parse("tmp/zom_trace_ring_test.json"))
+                        ->readAllText();
+  ZC_EXPECT(json.contains("\"event_99\""));
+  ZC_EXPECT(json.contains("\"event_84\""));
+  ZC_EXPECT(!json.contains("\"event_83\""));
+
+  config.maxEvents = ZOM_TRACE_BUFFER_SIZE;
+  config.outputFile = nullptr;
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+}
+
+ZC_TEST("TraceTest_ScopesCountHardwareEvents") {
+  TraceConfig config;
+  config.enabled = true;
+  config.hardwareCounterMask = TraceCategory::kLexer;
+  config.outputFile = "/tmp/zom_trace_counters_test.json";
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+
+  { ScopeTracer unmasked(TraceCategory::kParser, "uncounted_scope"); }
+  const size_t uncounted = TraceManager::getInstance().getEventCount();
+  ZC_EXPECT(uncounted == 2);
+
+  {
+    ScopeTracer scope(TraceCategory::kLexer, "counted_scope");
+    volatile uint64_t sink = 0;
+    for (uint32_t i = 0; i < 10000; ++i) { sink = sink + i; }
+  }
+  // Machines without counters, or that forbid them, trace the scope alone
+  const size_t counted = TraceManager::getInstance().getEventCount() - uncounted;
+  ZC_EXPECT(counted == 2 || counted == 6, counted);
+
+  TraceManager::getInstance().flush();
+  auto fs = zc::newDiskFilesystem();
+  zc::String json = fs->getRoot().openFile(zc::Path::parse("tmp/zom_trace_counters_test.json"))
+                        ->readAllText();
+  if (counted == 6) {
+    ZC_EXPECT(json.contains("\"instructions\":"));
+    ZC_EXPECT(json.contains("\"branchMisses\":"));
+  }
+
+  config.hardwareCounterMask = TraceCategory::kNone;
+  config.outputFile = nullptr;
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+}
+
+ZC_TEST("TraceTest_SamplingFoldsScopeStacks") {
+  TraceConfig config;
+  config.enabled = true;
+  config.mode = TraceMode::kSampling;
+  config.samplingIntervalUs = 200;
+  TraceManager::getInstance().configure(config);
+  TraceManager::getInstance().clear();
+
+  // Burn CPU time inside nested scopes until the profiling timer has sampled them
+  bool sampled = false;
+  for (int round = 0; round < 1000 && !sampled; ++round) {
+    ScopeTracer outer(TraceCategory::kDriver, "sampled;outer");
+    ScopeTracer inner(TraceCategory::kParser, "sampled_inner");
+    volatile uint64_t sink = 0;
+    for (uint32_t i = 0; i < 1000000; ++i) { sink = sink + i; }
+    // The ';' inside the outer name must not split it into two frames
+    const zc::String stacks = TraceManager::getInstance().getFoldedStacks();
+    sampled = stacks.contains("sampled_outer;sampled_inner ");
+  }
+  ZC_EXPECT(sampled);
+  // Sampling records no events
+  ZC_EXPECT(TraceManager::getInstance().getEventCount() == 0);
+
+  config.enabled = false;
+  config.mode = TraceMode::kEvents;
+  TraceManager::getInstance().configure(config);
+}
+
 }  // namespace trace
 }  // namespace compiler
 }  // namespace zomlang
@@ -0,0 +1,106 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/runtime/region.h"
+
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace runtime {
+namespace {
+
+struct Counted {
+  explicit Counted(uint& destroyed) : destroyed(destroyed) {}
+  ~Counted() { ++destroyed; }
+  uint& destroyed;
+};
+
+ZC_TEST("Region_AllocatesAndFreesAtOnce") {
+  uint destroyed = 0;
+  {
+    Region region;
+    for (uint i = 0; i < 100; ++i) { region.allocate<Counted>(destroyed); }
+    auto numbers = region.allocateArray<uint64_t>(1000);
+    for (uint i = 0; i < numbers.size(); ++i) { numbers[i] = i; }
+    ZC_EXPECT(numbers[999] == 999);
+    ZC_EXPECT(region.getChunkBytes() >= 1000 * sizeof(uint64_t));
+    ZC_EXPECT(destroyed == 0);
+  }
+  ZC_EXPECT(destroyed == 100);
+}
+
+ZC_TEST("Region_ResetKeepsAChunk") {
+  uint destroyed = 0;
+  Region region;
+  for (uint i = 0; i < 10; ++i) { region.allocate<Counted>(destroyed); }
+  region.allocateArray<char>(64 * 1024);
+  region.reset();
+  ZC_EXPECT(destroyed == 10);
+  const size_t kept = region.getChunkBytes();
+  ZC_EXPECT(kept >= 64 * 1024);
+
+  // The kept chunk is allocated from anew.
+  region.allocateArray<char>(32 * 1024);
+  ZC_EXPECT(region.getChunkBytes() == kept);
+}
+
+ZC_TEST("Region_PromotesEscapingValuesToParent") {
+  Region root;
+  ZC_EXPECT(root.getDepth() == 0);
+  ZC_EXPECT(&root.getEscapeRegion() == &root);
+  ZC_EXPECT(root.getParent() == zc::none);
+
+  uint64_t* escaped;
+  {
+    Region task(root);
+    Region subtask(task);
+    ZC_EXPECT(subtask.getDepth() == 2);
+    ZC_EXPECT(&subtask.getEscapeRegion() == &task);
+
+    auto& local = task.allocate<uint64_t>(42);
+    escaped = &task.promote(local);
+    ZC_EXPECT(escaped != &local);
+
+    ZC_EXPECT(root.outlives(task));
+    ZC_EXPECT(root.outlives(subtask));
+    ZC_EXPECT(task.outlives(task));
+    ZC_EXPECT(!subtask.outlives(task));
+
+    Region sibling(root);
+    ZC_EXPECT(!sibling.outlives(subtask));
+    ZC_EXPECT(!task.outlives(sibling));
+  }
+  // The copy lives in the root region, after the task's has been freed.
+  ZC_EXPECT(*escaped == 42);
+}
+
+ZC_TEST("Region_ScopesNest") {
+  ZC_EXPECT(getCurrentRegion() == zc::none);
+  Region outer;
+  {
+    RegionScope outerScope(outer);
+    ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentRegion()) == &outer);
+    {
+      Region inner(outer);
+      RegionScope innerScope(inner);
+      ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentRegion()) == &inner);
+    }
+    ZC_EXPECT(&ZC_ASSERT_NONNULL(getCurrentRegion()) == &outer);
+  }
+  ZC_EXPECT(getCurrentRegion() == zc::none);
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace zomlang
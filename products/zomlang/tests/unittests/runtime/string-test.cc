@@ -0,0 +1,119 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/runtime/string.h"
+
+#include "zc/core/map.h"
+#include "zc/ztest/test.h"
+
+namespace zomlang {
+namespace runtime {
+namespace {
+
+ZC_TEST("Str_ShortStringsAreInline") {
+  static_assert(sizeof(Str) == 16);
+
+  Region region;
+  Str empty;
+  ZC_EXPECT(empty.empty());
+  ZC_EXPECT(empty.isInline());
+
+  Str name = Str::make(region, "content-type"_zc.asArray());
+  ZC_EXPECT(name.isInline());
+  ZC_EXPECT(name.size() == 12);
+  ZC_EXPECT(name == "content-type"_zc);
+  ZC_EXPECT(region.getChunkBytes() == 0);
+
+  Str full = Str::make(region, "123456789012345"_zc.asArray());
+  ZC_EXPECT(full.isInline());
+  ZC_EXPECT(full.size() == Str::kInlineCapacity);
+
+  Str longer = Str::make(region, "1234567890123456"_zc.asArray());
+  ZC_EXPECT(!longer.isInline());
+  ZC_EXPECT(longer.size() == 16);
+  ZC_EXPECT(longer == "1234567890123456"_zc);
+  ZC_EXPECT(region.getChunkBytes() > 0);
+}
+
+ZC_TEST("Str_EqualityAndHashing") {
+  Region region;
+  Str a = Str::make(region, "a fairly long header value"_zc.asArray());
+  Str b = Str::fromStatic("a fairly long header value"_zc);
+  Str c = Str::make(region, "a fairly long header valuf"_zc.asArray());
+  ZC_EXPECT(a == b);
+  ZC_EXPECT(!(a == c));
+  ZC_EXPECT(a.hashCode() == b.hashCode());
+  ZC_EXPECT(!(Str::fromStatic("short"_zc) == a));
+
+  zc::HashMap<Str, uint> counts;
+  counts.insert(a, 1);
+  counts.insert(Str::fromStatic("short"_zc), 2);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(counts.find(b)) == 1);
+  ZC_EXPECT(ZC_ASSERT_NONNULL(counts.find(Str::make(region, "short"_zc.asArray()))) == 2);
+}
+
+ZC_TEST("Str_Concat") {
+  Region region;
+  Str small = Str::concat(region, Str::fromStatic("key"_zc), Str::fromStatic("=value"_zc));
+  ZC_EXPECT(small.isInline());
+  ZC_EXPECT(small == "key=value"_zc);
+
+  Str big = Str::concat(region, small, Str::fromStatic("; and some more"_zc));
+  ZC_EXPECT(!big.isInline());
+  ZC_EXPECT(big == "key=value; and some more"_zc);
+
+  ZC_EXPECT(Str::concat(region, big, Str()) == big);
+}
+
+ZC_TEST("Str_EscapeCopiesOnlyDeeperRegionStrings") {
+  Region root;
+  Str kept = Str::fromStatic("a literal that is not inline"_zc);
+  Str escaped;
+  Str rootString = Str::make(root, "allocated in the root region"_zc.asArray());
+  {
+    Region task(root);
+    Str local = Str::make(task, "built while serving a request"_zc.asArray());
+    escaped = local.escapeTo(root);
+    ZC_EXPECT(escaped == local);
+    ZC_EXPECT(escaped.asArray().begin() != local.asArray().begin());
+
+    ZC_EXPECT(kept.escapeTo(root).asArray().begin() == kept.asArray().begin());
+    Str fromRoot = rootString.escapeTo(root);
+    ZC_EXPECT(fromRoot.asArray().begin() == rootString.asArray().begin());
+  }
+  ZC_EXPECT(escaped == "built while serving a request"_zc);
+}
+
+ZC_TEST("Interner_SharesOneCopy") {
+  Interner interner;
+  Region region;
+  Str a = interner.intern("x-forwarded-for-header"_zc.asArray());
+  Str b = interner.intern(Str::make(region, "x-forwarded-for-header"_zc.asArray()));
+  ZC_EXPECT(a.isInterned());
+  ZC_EXPECT(b.isInterned());
+  ZC_EXPECT(a.asArray().begin() == b.asArray().begin());
+  ZC_EXPECT(a == b);
+  ZC_EXPECT(interner.size() == 1);
+
+  Str small = interner.intern("host"_zc.asArray());
+  ZC_EXPECT(small.isInline());
+  ZC_EXPECT(interner.size() == 1);
+
+  // Interned strings outlive every region.
+  ZC_EXPECT(a.escapeTo(region).asArray().begin() == a.asArray().begin());
+}
+
+}  // namespace
+}  // namespace runtime
+}  // namespace zomlang
@@ -1,8 +1,22 @@
+import struct
+
 import lldb
 
 
 _ENUM_CACHE = {}
 
+# Layout of the table `zomc -g` keeps, see compiler/ast/debug-table.h
+_TABLE_SYMBOL = "zomlang_debug_node_table"
+_TABLE_MAGIC = 0x4d4f5a44
+_TABLE_VERSION = 1
+_HEADER_FORMAT = "IIIIQQQQQ"
+_NODE_FORMAT = "QQQQII"
+_TREE_FORMAT = "QQQQ"
+_MAX_NODE_TEXT = 256
+
+# The last table read, kept until the process or the table's generation changes
+_TABLE_CACHE = {"key": None, "table": None}
+
 
 def _escape_text(text):
   return text.replace("\\", "\\\\").replace("\n", "\\n").replace("\r", "\\r").replace("\t", "\\t")
@@ -63,6 +77,142 @@ def _read_range_text(process, range_value, max_len=256):
   return _escape_text(text)
 
 
+class _NodeTable(object):
+  """The nodes of every tree the compiler listed, read with one memory read per tree."""
+
+  def __init__(self, process, kind_names):
+    self.process = process
+    self.kind_names = kind_names
+    # Node address -> (tree index, index of its record in the tree)
+    self.index = {}
+    # Per tree: (file name, records, text start address, text bytes or None until read)
+    self.trees = []
+
+  def find(self, address):
+    location = self.index.get(address)
+    if location is None:
+      return None
+    tree, position = location
+    return self.trees[tree][1][position]
+
+  def kind_name(self, record):
+    kind = record[4]
+    if kind < len(self.kind_names):
+      return self.kind_names[kind]
+    return str(kind)
+
+  def text(self, address):
+    location = self.index.get(address)
+    if location is None:
+      return None
+    tree, position = location
+    return self._tree_text(tree, self.trees[tree][1][position])
+
+  def _tree_text(self, tree, record):
+    begin, end = record[2], record[3]
+    if begin == 0 or end <= begin:
+      return ""
+    file_name, records, start, text = self.trees[tree]
+    if text is None:
+      # The whole tree's text at once; every node's text is a slice of it
+      stop = max(r[3] for r in records)
+      text = _read_memory(self.process, start, stop - start) if stop > start else b""
+      self.trees[tree] = (file_name, records, start, text)
+    data = text[begin - start:min(end, begin + _MAX_NODE_TEXT) - start]
+    result = _escape_text(data.decode("utf-8", errors="replace"))
+    if end - begin > _MAX_NODE_TEXT:
+      return result + "…"
+    return result
+
+  def subtree(self, address):
+    """Yield (depth below the node, record, text) for the node and everything under it."""
+    location = self.index.get(address)
+    if location is None:
+      return
+    tree, position = location
+    records = self.trees[tree][1]
+    depth = records[position][5]
+    for i in range(position, len(records)):
+      if i != position and records[i][5] <= depth:
+        break
+      yield records[i][5] - depth, records[i], self._tree_text(tree, records[i])
+
+
+def _read_memory(process, address, size):
+  if size <= 0:
+    return b""
+  error = lldb.SBError()
+  data = process.ReadMemory(address, size, error)
+  if not error.Success():
+    return None
+  return data
+
+
+def _find_table_address(target):
+  symbols = target.FindSymbols(_TABLE_SYMBOL)
+  for i in range(symbols.GetSize()):
+    address = symbols.GetContextAtIndex(i).GetSymbol().GetStartAddress().GetLoadAddress(target)
+    if address != lldb.LLDB_INVALID_ADDRESS:
+      return address
+  return None
+
+
+def _load_node_table(target, process):
+  """The compiler's node table, or None if it has none, e.g. because it was run without -g."""
+  if not process.IsValid() or target.GetAddressByteSize() != 8:
+    return None
+  address = _find_table_address(target)
+  if address is None:
+    return None
+
+  order = "<" if target.GetByteOrder() == lldb.eByteOrderLittle else ">"
+  header_format = struct.Struct(order + _HEADER_FORMAT)
+  node_format = struct.Struct(order + _NODE_FORMAT)
+  tree_format = struct.Struct(order + _TREE_FORMAT)
+
+  header = _read_memory(process, address, header_format.size)
+  if header is None:
+    return None
+  (magic, version, node_size, tree_size, generation, kind_names, kind_names_size, trees,
+   tree_count) = header_format.unpack(header)
+  if (magic != _TABLE_MAGIC or version != _TABLE_VERSION or node_size != node_format.size or
+      tree_size != tree_format.size):
+    return None
+
+  key = (process.GetUniqueID(), generation)
+  if _TABLE_CACHE["key"] == key:
+    return _TABLE_CACHE["table"]
+
+  names = _read_memory(process, kind_names, kind_names_size) if kind_names else b""
+  if names is None:
+    return None
+  table = _NodeTable(process, names.decode("utf-8", errors="replace").split("\0"))
+
+  tree_data = _read_memory(process, trees, tree_count * tree_format.size) if trees else b""
+  if tree_data is None:
+    return None
+  for root, file_name, nodes, node_count in tree_format.iter_unpack(tree_data):
+    node_data = _read_memory(process, nodes, node_count * node_format.size) if nodes else b""
+    if node_data is None:
+      continue
+    records = list(node_format.iter_unpack(node_data))
+    error = lldb.SBError()
+    name = process.ReadCStringFromMemory(file_name, 4096, error) if file_name else ""
+    starts = [r[2] for r in records if r[2] != 0]
+    tree = len(table.trees)
+    table.trees.append((name or "", records, min(starts) if starts else 0, None))
+    for position, record in enumerate(records):
+      table.index[record[0]] = (tree, position)
+
+  _TABLE_CACHE["key"] = key
+  _TABLE_CACHE["table"] = table
+  return table
+
+
+def _node_table_for_value(valobj):
+  return _load_node_table(valobj.GetTarget(), valobj.GetProcess())
+
+
 def _get_value_address(valobj):
   target = valobj.GetTarget()
   val_type = valobj.GetType()
@@ -149,6 +299,11 @@ def _node_kind_name_from_value(node_value):
   addr = _get_value_address(node_value)
   if addr == 0:
     return ""
+  table = _node_table_for_value(node_value)
+  if table is not None:
+    record = table.find(addr)
+    if record is not None:
+      return table.kind_name(record)
   expr = f"((const zomlang::compiler::ast::Node*)0x{addr:x})->getKind()"
   kind_value = node_value.GetFrame().EvaluateExpression(expr)
   if not kind_value.IsValid():
@@ -161,6 +316,11 @@ def _node_text_from_value(node_value):
   addr = _get_value_address(node_value)
   if addr == 0:
     return ""
+  table = _node_table_for_value(node_value)
+  if table is not None:
+    text = table.text(addr)
+    if text is not None:
+      return text
   expr = f"((const zomlang::compiler::ast::Node*)0x{addr:x})->getSourceRange()"
   range_value = node_value.GetFrame().EvaluateExpression(expr)
   if not range_value.IsValid():
@@ -262,6 +422,30 @@ def zominfo(debugger, command, result, internal_dict):
   result.PutCString(_format_summary(kind_name, text))
 
 
+def zomtree(debugger, command, result, internal_dict):
+  target = debugger.GetSelectedTarget()
+  process = target.GetProcess()
+  thread = process.GetSelectedThread()
+  frame = thread.GetSelectedFrame()
+  if not frame.IsValid():
+    return
+  value = _value_from_command_or_default(frame, command, "expression")
+  if value is None:
+    return
+  table = _load_node_table(target, process)
+  if table is None:
+    result.PutCString("no node table; run zomc with -g")
+    return
+  address = _get_value_address(_unwrap_node_value(value))
+  lines = []
+  for depth, record, text in table.subtree(address):
+    lines.append("  " * depth + _format_summary(table.kind_name(record), text))
+  if not lines:
+    result.PutCString("node is not in the table")
+    return
+  result.PutCString("\n".join(lines))
+
+
 def __lldb_init_module(debugger, internal_dict):
   debugger.HandleCommand("type category define zomlang")
   debugger.HandleCommand(
@@ -278,6 +462,8 @@ def __lldb_init_module(debugger, internal_dict):
       '-x "zc::Own<zomlang::compiler::ast::.*>"')
   debugger.HandleCommand("command script add -f zomlang_lldb.zomkind zomkind")
   debugger.HandleCommand("command script add -f zomlang_lldb.zominfo zominfo")
+  debugger.HandleCommand("command script add -f zomlang_lldb.zomtree zomtree")
   debugger.HandleCommand("command alias zk zomkind")
   debugger.HandleCommand("command alias zi zominfo")
+  debugger.HandleCommand("command alias zt zomtree")
   debugger.HandleCommand("type category enable zomlang")
@@ -0,0 +1,224 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/utils/zomc/filecheck.h"
+
+#include <cctype>
+#include <cstring>
+#include <regex>
+#include <string>
+
+#include "zc/core/vector.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+namespace {
+
+enum class CheckKind { kCheck, kNext, kNot };
+
+struct Directive {
+  CheckKind kind;
+  zc::ArrayPtr<const char> pattern;
+  /// Set if the pattern embeds a regular expression
+  zc::Maybe<std::regex> regex;
+};
+
+bool isBlank(char c) { return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+
+zc::ArrayPtr<const char> trim(zc::ArrayPtr<const char> text) {
+  const char* begin = text.begin();
+  const char* end = text.end();
+  while (begin < end && isBlank(*begin)) { ++begin; }
+  while (end > begin && isBlank(end[-1])) { --end; }
+  return zc::arrayPtr(begin, end);
+}
+
+bool startsWith(zc::ArrayPtr<const char> text, zc::StringPtr prefix) {
+  return text.size() >= prefix.size() && memcmp(text.begin(), prefix.begin(), prefix.size()) == 0;
+}
+
+/// The first occurrence of `token` in [from, end), or null.
+const char* find(const char* from, const char* end, zc::StringPtr token) {
+  for (const char* p = from; p + token.size() <= end; ++p) {
+    if (memcmp(p, token.begin(), token.size()) == 0) { return p; }
+  }
+  return nullptr;
+}
+
+/// `text` split at line breaks, without them.
+zc::Vector<zc::ArrayPtr<const char>> splitLines(zc::ArrayPtr<const char> text) {
+  zc::Vector<zc::ArrayPtr<const char>> lines;
+  const char* begin = text.begin();
+  for (const char* p = text.begin(); p != text.end(); ++p) {
+    if (*p != '\n' && *p != '\r') { continue; }
+    lines.add(zc::arrayPtr(begin, p));
+    if (*p == '\r' && p + 1 != text.end() && p[1] == '\n') { ++p; }
+    begin = p + 1;
+  }
+  if (begin != text.end()) { lines.add(zc::arrayPtr(begin, text.end())); }
+  return lines;
+}
+
+void appendEscaped(std::string& regex, zc::ArrayPtr<const char> text) {
+  for (char c : text) {
+    if (strchr("\\^$.|?*+()[]{}", c) != nullptr) { regex += '\\'; }
+    regex += c;
+  }
+}
+
+/// The pattern as a regular expression, or none if it embeds none and matches as a substring.
+zc::Maybe<std::regex> buildRegex(zc::ArrayPtr<const char> pattern) {
+  const char* p = pattern.begin();
+  const char* end = pattern.end();
+  if (find(p, end, "{{"_zc) == nullptr && find(p, end, "[["_zc) == nullptr) { return zc::none; }
+
+  std::string regex;
+  while (p != end) {
+    const char* block = find(p, end, "{{"_zc);
+    const char* variable = find(p, end, "[["_zc);
+    const char* next = block == nullptr ? variable
+                       : variable == nullptr ? block
+                                             : zc::min(block, variable);
+    if (next == nullptr) {
+      appendEscaped(regex, zc::arrayPtr(p, end));
+      break;
+    }
+    appendEscaped(regex, zc::arrayPtr(p, next));
+
+    const char* close = find(next + 2, end, next == block ? "}}"_zc : "]]"_zc);
+    if (close == nullptr) {
+      // Unterminated, so taken literally
+      appendEscaped(regex, zc::arrayPtr(next, end));
+      break;
+    }
+    zc::ArrayPtr<const char> body = zc::arrayPtr(next + 2, close);
+    if (next == block) {
+      regex.append(body.begin(), body.size());
+    } else {
+      const char* colon = static_cast<const char*>(memchr(body.begin(), ':', body.size()));
+      if (colon == nullptr) {
+        appendEscaped(regex, body);
+      } else {
+        regex += "(?:";
+        regex.append(colon + 1, body.end() - (colon + 1));
+        regex += ')';
+      }
+    }
+    p = close + 2;
+  }
+  return std::regex(regex, std::regex::ECMAScript | std::regex::multiline);
+}
+
+bool matches(const Directive& directive, zc::ArrayPtr<const char> text) {
+  ZC_IF_SOME(regex, directive.regex) {
+    return std::regex_search(text.begin(), text.end(), regex);
+  }
+  const zc::ArrayPtr<const char> pattern = directive.pattern;
+  for (const char* p = text.begin(); p + pattern.size() <= text.end(); ++p) {
+    if (memcmp(p, pattern.begin(), pattern.size()) == 0) { return true; }
+  }
+  return false;
+}
+
+/// `input` without the SGR escapes that colour diagnostics.
+zc::String stripColours(zc::StringPtr input) {
+  zc::Vector<char> result(input.size() + 1);
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (input[i] == '\x1b' && i + 1 < input.size() && input[i + 1] == '[') {
+      size_t j = i + 2;
+      while (j < input.size() && (isdigit(input[j]) || input[j] == ';')) { ++j; }
+      if (j < input.size() && input[j] == 'm') {
+        i = j;
+        continue;
+      }
+    }
+    result.add(input[i]);
+  }
+  result.add('\0');
+  return zc::String(result.releaseAsArray());
+}
+
+zc::String joinFrom(zc::ArrayPtr<const zc::ArrayPtr<const char>> lines) {
+  zc::Vector<zc::String> parts;
+  for (zc::ArrayPtr<const char> line : lines) { parts.add(zc::heapString(line)); }
+  return zc::strArray(parts, "\n");
+}
+
+}  // namespace
+
+zc::Maybe<zc::String> fileCheck(zc::StringPtr checkFile, zc::StringPtr input) {
+  zc::Vector<zc::String> checkLines;
+  zc::Vector<Directive> directives;
+  const struct {
+    zc::StringPtr prefix;
+    CheckKind kind;
+  } kPrefixes[] = {{"// CHECK:"_zc, CheckKind::kCheck},
+                   {"// CHECK-NEXT:"_zc, CheckKind::kNext},
+                   {"// CHECK-NOT:"_zc, CheckKind::kNot}};
+  for (zc::ArrayPtr<const char> rawLine : splitLines(checkFile.asArray())) {
+    // Kept so that the patterns can point into them
+    const zc::ArrayPtr<const char> line = trim(checkLines.add(zc::heapString(rawLine)).asArray());
+    for (const auto& prefix : kPrefixes) {
+      if (!startsWith(line, prefix.prefix)) { continue; }
+      const zc::ArrayPtr<const char> pattern = trim(line.slice(prefix.prefix.size()));
+      directives.add(Directive{prefix.kind, pattern, buildRegex(pattern)});
+      break;
+    }
+  }
+
+  const zc::String text = stripColours(input);
+  const zc::Vector<zc::ArrayPtr<const char>> lines = splitLines(text.asArray());
+  size_t current = 0;
+  for (const Directive& directive : directives) {
+    switch (directive.kind) {
+      case CheckKind::kCheck: {
+        bool found = false;
+        for (size_t i = current; i < lines.size(); ++i) {
+          if (matches(directive, lines[i])) {
+            current = i + 1;
+            found = true;
+            break;
+          }
+        }
+        // A pattern spanning lines may still match what is left, without moving on
+        if (!found &&
+            !matches(directive, joinFrom(lines.asPtr().slice(current, lines.size())).asArray())) {
+          return zc::str("CHECK pattern not found: ", directive.pattern);
+        }
+        break;
+      }
+      case CheckKind::kNext:
+        if (current >= lines.size()) {
+          return zc::str("CHECK-NEXT pattern beyond end of file: ", directive.pattern);
+        }
+        if (!matches(directive, lines[current])) {
+          return zc::str("CHECK-NEXT pattern not found on line ", current + 1, ": ",
+                         directive.pattern);
+        }
+        ++current;
+        break;
+      case CheckKind::kNot:
+        if (matches(directive, joinFrom(lines.asPtr().slice(current, lines.size())).asArray())) {
+          return zc::str("CHECK-NOT pattern found (should not exist): ", directive.pattern);
+        }
+        break;
+    }
+  }
+  return zc::none;
+}
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
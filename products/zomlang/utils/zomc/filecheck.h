@@ -0,0 +1,35 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+/// \brief Check `input` against the `// CHECK:`, `// CHECK-NEXT:` and `// CHECK-NOT:` directives
+/// in `checkFile`, as `tests/tools/filecheck.py` does.
+///
+/// Each `CHECK` pattern must match a line at or after the one following the last match, each
+/// `CHECK-NEXT` pattern the very next line, and no `CHECK-NOT` pattern anything that follows.
+/// Patterns match as substrings, except that `{{re}}` embeds a regular expression and
+/// `[[NAME:re]]` one that is not captured. Colour escapes in `input` are ignored.
+/// \return None if `input` passes, or the directive that failed and why
+zc::Maybe<zc::String> fileCheck(zc::StringPtr checkFile, zc::StringPtr input);
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
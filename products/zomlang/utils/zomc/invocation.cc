@@ -0,0 +1,87 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/utils/zomc/invocation.h"
+
+#include <unistd.h>
+
+#include <iostream>
+
+#include "zc/core/debug.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+namespace {
+
+void writeLine(int fd, zc::StringPtr message) {
+  if (message.size() == 0) { return; }
+  zc::FdOutputStream output(fd);
+  output.write(message.asBytes());
+  if (!message.endsWith("\n")) { output.write("\n"_zcb); }
+}
+
+zc::OwnFd duplicate(int fd) {
+  int result;
+  ZC_SYSCALL(result = dup(fd));
+  return zc::OwnFd(result);
+}
+
+}  // namespace
+
+// ================================================================================
+// InProcessContext
+
+void InProcessContext::exit() {
+  throw zc::TopLevelProcessContext::CleanShutdownException{hadErrors ? 1 : 0};
+}
+
+void InProcessContext::warning(zc::StringPtr message) const { writeLine(STDERR_FILENO, message); }
+
+void InProcessContext::error(zc::StringPtr message) const {
+  hadErrors = true;
+  writeLine(STDERR_FILENO, message);
+}
+
+void InProcessContext::exitError(zc::StringPtr message) {
+  error(message);
+  exit();
+}
+
+void InProcessContext::exitInfo(zc::StringPtr message) {
+  writeLine(STDOUT_FILENO, message);
+  exit();
+}
+
+// ================================================================================
+// StdioRedirect
+
+StdioRedirect::StdioRedirect(int out, int err)
+    : savedOut(duplicate(STDOUT_FILENO)), savedErr(duplicate(STDERR_FILENO)) {
+  ZC_SYSCALL(dup2(out, STDOUT_FILENO));
+  ZC_SYSCALL(dup2(err, STDERR_FILENO));
+}
+
+StdioRedirect::~StdioRedirect() noexcept(false) {
+  // Diagnostics are printed through the standard streams, which buffer: flush what they hold to
+  // the redirected descriptors before restoring the saved ones.
+  std::cout.flush();
+  std::cerr.flush();
+  ZC_SYSCALL(dup2(savedOut, STDOUT_FILENO));
+  ZC_SYSCALL(dup2(savedErr, STDERR_FILENO));
+}
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
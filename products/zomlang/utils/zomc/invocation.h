@@ -0,0 +1,65 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/io.h"
+#include "zc/core/main.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+/// \brief Reports to the process's standard output and error, and ends an invocation by
+/// unwinding to its caller rather than exiting the process, so that one process can run many
+/// invocations in turn. `exit()` throws `zc::TopLevelProcessContext::CleanShutdownException`
+/// carrying the exit status.
+class InProcessContext final : public zc::ProcessContext {
+public:
+  explicit InProcessContext(zc::StringPtr programName) : programName(programName) {}
+
+  zc::StringPtr getProgramName() override { return programName; }
+
+  ZC_NORETURN(void exit() override);
+  void warning(zc::StringPtr message) const override;
+  void error(zc::StringPtr message) const override;
+  ZC_NORETURN(void exitError(zc::StringPtr message) override);
+  ZC_NORETURN(void exitInfo(zc::StringPtr message) override);
+
+  // The log level is the process's, shared by every invocation
+  void increaseLoggingVerbosity() override {}
+
+private:
+  zc::StringPtr programName;
+  mutable bool hadErrors = false;
+};
+
+/// \brief Points the process's standard output and error at other descriptors for as long as it
+/// lives, e.g. a client's or a file capturing an invocation's output. Both may be the same.
+class StdioRedirect {
+public:
+  StdioRedirect(int out, int err);
+  ~StdioRedirect() noexcept(false);
+
+  ZC_DISALLOW_COPY_AND_MOVE(StdioRedirect);
+
+private:
+  zc::OwnFd savedOut;
+  zc::OwnFd savedErr;
+};
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
@@ -0,0 +1,168 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include "zomlang/utils/zomc/server.h"
+
+#include <unistd.h>
+
+#include <cstdint>
+
+#include "zc/async/async-io.h"
+#include "zc/core/debug.h"
+#include "zc/core/exception.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/time.h"
+#include "zc/core/vector.h"
+#include "zomlang/utils/zomc/invocation.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+namespace {
+
+// A request is this header, followed by the client's current directory and arguments, each
+// NUL-terminated. The client's standard output and error ride along with the header. The reply
+// is the exit status as an int32_t.
+struct RequestHeader {
+  uint32_t magic;
+  uint32_t version;
+  uint32_t argCount;
+  uint32_t payloadBytes;
+};
+
+constexpr uint32_t kRequestMagic = 0x534d4f5a;  // "ZOMS"
+constexpr uint32_t kProtocolVersion = 1;
+constexpr uint32_t kMaxPayloadBytes = 1u << 24;
+// A client that connects but does not send its request within this keeps the others waiting
+constexpr zc::Duration kRequestTimeout = 10 * zc::SECONDS;
+
+zc::String getSocketAddress(zc::StringPtr socketPath) { return zc::str("unix:", socketPath); }
+
+void serveConnection(zc::AsyncIoContext& io, zc::AsyncCapabilityStream& stream,
+                     ServerHandler& handler) {
+  zc::Timer& timer = io.provider->getTimer();
+
+  RequestHeader header;
+  zc::OwnFd fds[2];
+  auto received = timer
+                      .timeoutAfter(kRequestTimeout,
+                                    stream.tryReadWithFds(&header, sizeof(header), sizeof(header),
+                                                          fds, zc::size(fds)))
+                      .wait(io.waitScope);
+  // A client that went away before asking anything, e.g. one probing for the server
+  if (received.byteCount == 0) { return; }
+  ZC_REQUIRE(received.byteCount == sizeof(header) && header.magic == kRequestMagic,
+             "not a zomc request");
+  ZC_REQUIRE(header.version == kProtocolVersion, "zomc client speaks another protocol version",
+             header.version);
+  ZC_REQUIRE(received.capCount == zc::size(fds),
+             "request did not carry standard output and error");
+  ZC_REQUIRE(header.payloadBytes > 0 && header.payloadBytes <= kMaxPayloadBytes,
+             "request size out of range", header.payloadBytes);
+
+  zc::Array<char> payload = zc::heapArray<char>(header.payloadBytes);
+  timer.timeoutAfter(kRequestTimeout, stream.read(payload.asBytes())).wait(io.waitScope);
+  ZC_REQUIRE(payload.back() == '\0', "request strings are not NUL-terminated");
+
+  zc::Vector<zc::StringPtr> strings;
+  for (const char* p = payload.begin(); p != payload.end();) {
+    const zc::StringPtr string(p);
+    strings.add(string);
+    p += string.size() + 1;
+  }
+  ZC_REQUIRE(strings.size() == header.argCount + 1, "request argument count mismatch");
+  const zc::StringPtr cwd = strings[0];
+  const zc::ArrayPtr<const zc::StringPtr> args = strings.asPtr().slice(1);
+
+  int status;
+  {
+    StdioRedirect redirect(fds[0], fds[1]);
+    InProcessContext context("zomc"_zc);
+    if (chdir(cwd.cStr()) != 0) {
+      context.error(zc::str("zomc server: cannot enter ", cwd));
+      status = 1;
+    } else {
+      status = handler(context, args);
+    }
+  }
+
+  const int32_t reply = status;
+  stream.write(zc::arrayPtr(&reply, 1).asBytes()).wait(io.waitScope);
+}
+
+}  // namespace
+
+void runCompilerServer(zc::StringPtr socketPath, ServerHandler handler) {
+  zc::AsyncIoContext io = zc::setupAsyncIo();
+
+  // A socket left by a server that did not shut down cleanly would make listen() fail
+  unlink(socketPath.cStr());
+  auto address =
+      io.provider->getNetwork().parseAddress(getSocketAddress(socketPath)).wait(io.waitScope);
+  zc::Own<zc::ConnectionReceiver> listener = address->listen();
+
+  while (true) {
+    zc::Own<zc::AsyncIoStream> connection = listener->accept().wait(io.waitScope);
+    // Streams accepted on a Unix socket can carry descriptors
+    auto& stream = zc::downcast<zc::AsyncCapabilityStream>(*connection);
+    ZC_IF_SOME(exception,
+               zc::runCatchingExceptions([&]() { serveConnection(io, stream, handler); })) {
+      ZC_LOG(WARNING, "Failed to serve a forwarded invocation", exception);
+    }
+  }
+}
+
+zc::Maybe<int> forwardToServer(zc::StringPtr socketPath, zc::ArrayPtr<const zc::StringPtr> args) {
+  zc::AsyncIoContext io = zc::setupAsyncIo();
+
+  zc::Own<zc::AsyncIoStream> connection;
+  auto maybeException = zc::runCatchingExceptions([&]() {
+    connection = io.provider->getNetwork()
+                     .parseAddress(getSocketAddress(socketPath))
+                     .wait(io.waitScope)
+                     ->connect()
+                     .wait(io.waitScope);
+  });
+  if (maybeException != zc::none) { return zc::none; }
+  auto& stream = zc::downcast<zc::AsyncCapabilityStream>(*connection);
+
+  const zc::String cwd = zc::newDiskFilesystem()->getCurrentPath().toString(true);
+  zc::Vector<char> payload;
+  payload.addAll(cwd.asArray());
+  payload.add('\0');
+  for (const zc::StringPtr arg : args) {
+    payload.addAll(arg.asArray());
+    payload.add('\0');
+  }
+  ZC_REQUIRE(payload.size() <= kMaxPayloadBytes, "command line too long to forward");
+
+  const RequestHeader header{kRequestMagic, kProtocolVersion, static_cast<uint32_t>(args.size()),
+                             static_cast<uint32_t>(payload.size())};
+  const zc::ArrayPtr<const zc::byte> body = payload.asPtr().asBytes();
+  const int fds[] = {STDOUT_FILENO, STDERR_FILENO};
+  stream.writeWithFds(zc::arrayPtr(&header, 1).asBytes(), zc::arrayPtr(&body, 1), fds)
+      .wait(io.waitScope);
+
+  int32_t status;
+  const size_t n = stream.tryRead(&status, sizeof(status), sizeof(status)).wait(io.waitScope);
+  // Whatever the server already printed cannot be taken back, so there is no falling back here
+  ZC_REQUIRE(n == sizeof(status), "zomc server closed the connection before replying");
+  return static_cast<int>(status);
+}
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
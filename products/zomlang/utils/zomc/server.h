@@ -0,0 +1,51 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/function.h"
+#include "zc/core/main.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+/// \brief Environment variable naming the Unix socket of a `zomc server` that invocations are
+/// forwarded to. Invocations run locally when it is unset or nothing listens there.
+constexpr char kServerSocketEnv[] = "ZOMC_SERVER";
+
+/// \brief Runs one forwarded invocation and returns its exit status.
+///
+/// `args` are the client's arguments without the program name. The process's current directory
+/// and standard output and error are the client's until it returns, and `context` reports to them.
+using ServerHandler =
+    zc::Function<int(zc::ProcessContext& context, zc::ArrayPtr<const zc::StringPtr> args)>;
+
+/// \brief Serve invocations forwarded by forwardToServer() on the Unix socket at `socketPath`
+/// until the process is killed, replacing any socket a previous server left there.
+///
+/// The client passes its standard output and error along with the request, so the handler writes
+/// to the client's terminal or files directly. Requests are handled one at a time, since they
+/// share the process's descriptors and current directory; each one still uses every worker.
+void runCompilerServer(zc::StringPtr socketPath, ServerHandler handler);
+
+/// \brief Forward an invocation to the server listening at `socketPath` and wait for it.
+/// \return The invocation's exit status, or none if no server accepts connections there
+zc::Maybe<int> forwardToServer(zc::StringPtr socketPath, zc::ArrayPtr<const zc::StringPtr> args);
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
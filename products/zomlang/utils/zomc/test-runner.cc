@@ -0,0 +1,197 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#include "zomlang/utils/zomc/test-runner.h"
+
+#include <unistd.h>
+
+#include <cstdio>
+
+#include "zc/core/debug.h"
+#include "zc/core/exception.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/vector.h"
+#include "zomlang/utils/zomc/filecheck.h"
+#include "zomlang/utils/zomc/invocation.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+namespace {
+
+/// The one RUN line of a test, e.g. `! %zomc compile --dump-ast %s 2>&1 | %FileCheck %s`
+struct RunLine {
+  bool expectFailure = false;
+  bool mergeStderr = false;
+  zc::Vector<zc::String> args;
+};
+
+/// Splits `text` at `separator`, keeping empty pieces
+zc::Vector<zc::ArrayPtr<const char>> split(zc::ArrayPtr<const char> text, char separator) {
+  zc::Vector<zc::ArrayPtr<const char>> pieces;
+  size_t start = 0;
+  for (size_t i = 0; i <= text.size(); ++i) {
+    if (i == text.size() || text[i] == separator) {
+      pieces.add(text.slice(start, i));
+      start = i + 1;
+    }
+  }
+  return pieces;
+}
+
+zc::Maybe<RunLine> parseRunLine(zc::StringPtr test, zc::StringPtr path) {
+  static constexpr zc::StringPtr kPrefix = "// RUN:"_zc;
+
+  for (zc::ArrayPtr<const char> line : split(test.asArray(), '\n')) {
+    size_t start = 0;
+    while (start < line.size() && (line[start] == ' ' || line[start] == '\t')) { ++start; }
+    line = line.slice(start);
+    if (line.size() < kPrefix.size() || line.first(kPrefix.size()) != kPrefix.asArray()) {
+      continue;
+    }
+
+    zc::Vector<zc::String> words;
+    for (zc::ArrayPtr<const char> word : split(line.slice(kPrefix.size()), ' ')) {
+      while (word.size() > 0 && (word.back() == '\r' || word.back() == '\t')) {
+        word = word.first(word.size() - 1);
+      }
+      if (word.size() > 0) { words.add(zc::heapString(word)); }
+    }
+
+    RunLine run;
+    size_t i = 0;
+    if (i < words.size() && words[i] == "!") {
+      run.expectFailure = true;
+      ++i;
+    }
+    if (i == words.size() || words[i] != "%zomc") { return zc::none; }
+    for (++i; i < words.size() && words[i] != "|"; ++i) {
+      if (words[i] == "2>&1") {
+        run.mergeStderr = true;
+      } else if (words[i] == "%s") {
+        run.args.add(zc::heapString(path));
+      } else {
+        run.args.add(zc::mv(words[i]));
+      }
+    }
+    // Only a check against the test itself is supported after the pipe
+    if (words.size() != i + 3 || words[i + 1] != "%FileCheck" || words[i + 2] != "%s") {
+      return zc::none;
+    }
+    return zc::mv(run);
+  }
+  return zc::none;
+}
+
+/// A file deleted as soon as it is closed, to capture an invocation's output
+class CaptureFile {
+public:
+  CaptureFile() : file(tmpfile()) { ZC_REQUIRE(file != nullptr, "can't create temporary file"); }
+  ~CaptureFile() noexcept(false) { fclose(file); }
+
+  ZC_DISALLOW_COPY_AND_MOVE(CaptureFile);
+
+  int fd() const { return fileno(file); }
+
+  zc::String read() const {
+    ZC_SYSCALL(lseek(fd(), 0, SEEK_SET));
+    return zc::FdInputStream(fd()).readAllText();
+  }
+
+private:
+  FILE* file;
+};
+
+struct Outcome {
+  zc::Maybe<zc::String> failure;
+  zc::String stderrText;
+};
+
+Outcome runTest(zc::StringPtr path, const zc::Directory& cwd, Invocation& invoke) {
+  zc::String test = cwd.openFile(zc::Path::parse(path))->readAllText();
+
+  RunLine run;
+  ZC_IF_SOME(parsed, parseRunLine(test, path)) { run = zc::mv(parsed); }
+  else { return {zc::str("unsupported or missing RUN line"), zc::String()}; }
+
+  CaptureFile out;
+  zc::Maybe<CaptureFile> err;
+  if (!run.mergeStderr) { err.emplace(); }
+
+  zc::Vector<zc::StringPtr> args;
+  for (const zc::String& arg : run.args) { args.add(arg); }
+
+  int status;
+  {
+    int errFd = out.fd();
+    ZC_IF_SOME(e, err) { errFd = e.fd(); }
+    StdioRedirect redirect(out.fd(), errFd);
+    InProcessContext context("zomc"_zc);
+    status = invoke(context, args.asPtr());
+  }
+
+  Outcome outcome;
+  ZC_IF_SOME(e, err) { outcome.stderrText = e.read(); }
+  zc::String output = out.read();
+  if (run.mergeStderr) { outcome.stderrText = zc::heapString(output); }
+
+  if (run.expectFailure && status == 0) {
+    outcome.failure = zc::str("zomc succeeded, but the test expects it to fail");
+  } else if (!run.expectFailure && status != 0) {
+    outcome.failure = zc::str("zomc exited with status ", status);
+  } else {
+    outcome.failure = fileCheck(test, output);
+  }
+  return outcome;
+}
+
+}  // namespace
+
+size_t runLanguageTests(zc::ArrayPtr<const zc::StringPtr> tests, Invocation& invoke,
+                        bool verbose) {
+  auto filesystem = zc::newDiskFilesystem();
+  const zc::Directory& cwd = filesystem->getCurrent();
+  zc::FdOutputStream output(STDOUT_FILENO);
+
+  size_t failed = 0;
+  for (zc::StringPtr path : tests) {
+    Outcome outcome;
+    ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() {
+                 outcome = runTest(path, cwd, invoke);
+               })) {
+      outcome.failure = zc::str("threw ", exception);
+    }
+
+    ZC_IF_SOME(reason, outcome.failure) {
+      ++failed;
+      zc::String report = zc::str("FAIL: ", path, ": ", reason, "\n");
+      if (outcome.stderrText.size() > 0) {
+        report = zc::str(report, "--- stderr ---\n", outcome.stderrText,
+                         outcome.stderrText.endsWith("\n") ? "" : "\n");
+      }
+      output.write(report.asBytes());
+    }
+    else if (verbose) {
+      output.write(zc::str("PASS: ", path, "\n").asBytes());
+    }
+  }
+
+  output.write(zc::str(tests.size() - failed, " of ", tests.size(), " tests passed\n").asBytes());
+  return failed;
+}
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
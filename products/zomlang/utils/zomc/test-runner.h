@@ -0,0 +1,51 @@
+// Copyright (c) 2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+#pragma once
+
+#include "zc/core/common.h"
+#include "zc/core/function.h"
+#include "zc/core/main.h"
+#include "zc/core/string.h"
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+/// \brief Runs one zomc invocation in this process and returns its exit status. `args` are the
+/// arguments without the program name; `context` reports to the standard output and error.
+using Invocation =
+    zc::Function<int(zc::ProcessContext& context, zc::ArrayPtr<const zc::StringPtr> args)>;
+
+/// \brief Run lit-style language tests without starting a process per test.
+///
+/// Each test is a `.zom` file whose `// RUN:` line pipes one zomc invocation into FileCheck, in
+/// the forms the language suite uses:
+///
+///     // RUN: [!] %zomc <args with %s> [2>&1] | %FileCheck %s
+///
+/// The invocation is run through `invoke` with its standard output, and its standard error when
+/// merged by `2>&1`, written to a temporary file, which is then checked natively against the test's
+/// directives as by `fileCheck()`. A `!` test passes if zomc fails and the check passes. Tests run
+/// one after another, since they share the process's standard streams, but each invocation may
+/// use every worker of the thread pool `invoke` runs it on.
+///
+/// A line is printed to standard output for every failure, or every test if `verbose` is set, and
+/// a summary at the end.
+/// \return The number of tests that failed
+size_t runLanguageTests(zc::ArrayPtr<const zc::StringPtr> tests, Invocation& invoke,
+                        bool verbose);
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
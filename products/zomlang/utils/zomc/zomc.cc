@@ -14,21 +14,32 @@
 
 #include <unistd.h>
 
+#include <cstdlib>
+
+#include "zc/async/async-io.h"
 #include "zc/core/common.h"
 #include "zc/core/filesystem.h"
 #include "zc/core/io.h"
 #include "zc/core/main.h"
 #include "zc/core/string.h"
+#include "zc/core/vector.h"
 #include "zomlang/compiler/ast/dumper.h"
 #include "zomlang/compiler/ast/expression.h"
 #include "zomlang/compiler/ast/serializer.h"
+#include "zomlang/compiler/ast/statistics.h"
 #include "zomlang/compiler/ast/type.h"
 #include "zomlang/compiler/basic/compiler-opts.h"
 #include "zomlang/compiler/basic/io-utils.h"
+#include "zomlang/compiler/basic/thread-pool.h"
 #include "zomlang/compiler/basic/zomlang-opts.h"
+#include "zomlang/compiler/diagnostics/binary-diagnostic-consumer.h"
 #include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/driver/cache-manager.h"
 #include "zomlang/compiler/driver/driver.h"
+#include "zomlang/compiler/driver/file-watcher.h"
 #include "zomlang/compiler/source/manager.h"
+#include "zomlang/utils/zomc/server.h"
+#include "zomlang/utils/zomc/test-runner.h"
 
 #ifndef VERSION
 #define VERSION "(unknown)"
@@ -46,13 +57,44 @@ public:
     driver = driverSpace.construct(langOpts, compilerOpts);
   }
 
+  /// Runs an invocation forwarded to a server, on the server's workers and with its cache.
+  CompilerMain(zc::ProcessContext& context, basic::ThreadPool& threadPool,
+               zc::Maybe<driver::CacheManager&> cache)
+      : context(context), forwarded(true) {
+    ZC_IF_SOME(c, cache) {
+      driver = driverSpace.construct(langOpts, compilerOpts, threadPool, c);
+    }
+    else { driver = driverSpace.construct(langOpts, compilerOpts, threadPool); }
+  }
+
   zc::MainFunc getMain() {
-    return zc::MainBuilder(context, VERSION_STRING, "Command-line tool for Zomlang Compiler.")
+    zc::MainBuilder builder(context, VERSION_STRING, "Command-line tool for Zomlang Compiler.");
+    builder
         .addSubCommand("compile", ZC_BIND_METHOD(*this, getCompileMain),
                        "Compiles source code in one or more target.")
         .addSubCommand("run", ZC_BIND_METHOD(*this, getRunMain),
-                       "Run a zomlang program with project configuration.")
-        .build();
+                       "Run a zomlang program with project configuration.");
+    if (forwarded) { return builder.build(); }
+
+    builder.addSubCommand("server", ZC_BIND_METHOD(*this, getServerMain),
+                          "Keep a compiler running for invocations to be forwarded to.")
+        .addSubCommand("test", ZC_BIND_METHOD(*this, getTestMain),
+                       "Run language tests in this process.");
+    zc::MainFunc main = builder.build();
+
+    const char* socketPath = getenv(kServerSocketEnv);
+    if (socketPath == nullptr || *socketPath == '\0') { return main; }
+    return [this, socketPath, main = zc::mv(main)](
+               zc::StringPtr programName, zc::ArrayPtr<const zc::StringPtr> params) mutable {
+      if (params.size() == 0 || params[0] != "server") {
+        ZC_IF_SOME(status, forwardToServer(socketPath, params)) {
+          if (status == 0) { context.exit(); }
+          // The server already printed why
+          context.exitError("");
+        }
+      }
+      main(programName, params);
+    };
   }
 
   zc::MainFunc getCompileMain() {
@@ -67,6 +109,40 @@ public:
     return builder.build();
   }
 
+  zc::MainFunc getServerMain() {
+    zc::MainBuilder builder(
+        context, VERSION_STRING, "Serves compilations forwarded over the Unix socket <socket>.",
+        zc::str("Any zomc run with ", kServerSocketEnv,
+                "=<socket> in its environment forwards its command line here and prints "
+                "and exits as if it ran itself. The server's workers are started once and kept "
+                "between compilations; every compilation still gets fresh sources, symbols and "
+                "diagnostics."));
+    return builder
+        .addOptionWithArg({"cache-budget"}, ZC_BIND_METHOD(*this, setCacheBudget), "<MiB>",
+                          "Keep binary ASTs of parsed sources between compilations, up to <MiB> "
+                          "mebibytes in memory")
+        .addOptionWithArg({"cache-dir"}, ZC_BIND_METHOD(*this, setCacheDir), "<dir>",
+                          "With --cache-budget, move the least recently used ASTs to <dir> "
+                          "instead of dropping them")
+        .expectArg("<socket>", ZC_BIND_METHOD(*this, serve))
+        .build();
+  }
+
+  zc::MainFunc getTestMain() {
+    zc::MainBuilder builder(
+        context, VERSION_STRING, "Runs the lit-style language tests <test>... in this process.",
+        "Each test's RUN line, e.g. `// RUN: %zomc compile --dump-ast %s | %FileCheck %s`, is run "
+        "as one invocation of this process on workers kept between tests, and its output checked "
+        "against the test's CHECK lines without starting FileCheck. Exits with an error if any "
+        "test fails.");
+    return builder
+        .addOption({'v', "verbose"}, ZC_BIND_METHOD(*this, enableVerboseTests),
+                   "Print a line for every test, not only those that fail")
+        .expectOneOrMoreArgs("<test>", ZC_BIND_METHOD(*this, addTest))
+        .callAfterParsing(ZC_BIND_METHOD(*this, runTests))
+        .build();
+  }
+
   void addCompileOptions(zc::MainBuilder& builder) {
     builder
         .addOptionWithArg({'o', "output"}, ZC_BIND_METHOD(*this, addOutput), "<dir>",
@@ -79,6 +155,24 @@ public:
                    "Dump AST to stdout (shorthand for --emit=ast)")
         .addOption({"syntax-only"}, ZC_BIND_METHOD(*this, enableSyntaxOnly),
                    "Only perform syntax checking, no code generation")
+        .addOptionWithArg({"stream-window"}, ZC_BIND_METHOD(*this, setStreamWindow), "<files>",
+                          "With --syntax-only, read and check <files> files at a time, releasing "
+                          "each batch once its diagnostics are reported")
+        .addOption({"type-check"}, ZC_BIND_METHOD(*this, enableTypeCheck),
+                   "Type check function bodies after binding")
+        .addOption({"bind-while-parsing"}, ZC_BIND_METHOD(*this, enableBindWhileParsing),
+                   "Bind each declaration as soon as it is parsed")
+        .addOptionWithArg({"ast-cache"}, ZC_BIND_METHOD(*this, setASTCacheDir), "<dir>",
+                          "Cache binary ASTs in <dir>, keyed by source content hash")
+        .addOptionWithArg({"stats"}, ZC_BIND_METHOD(*this, setStatistics), "<kind>",
+                          "Print statistics as JSON instead of compiling: ast")
+        .addOptionWithArg({"time-report"}, ZC_BIND_METHOD(*this, setTimeReport), "<format>",
+                          "Print phase times and memory use to stderr after compiling: text, json")
+        .addOptionWithArg({"thread-placement"}, ZC_BIND_METHOD(*this, setThreadPlacement),
+                          "<placement>",
+                          "Pin worker threads: none, cores, nodes (default: none)")
+        .addOption({'g', "debug-info"}, ZC_BIND_METHOD(*this, enableDebugInfo),
+                   "List the parsed trees in a table the LLDB formatters read")
         .addOptionWithArg({'O', "optimize"}, ZC_BIND_METHOD(*this, setOptimizationLevel), "<level>",
                           "Set optimization level: 0, 1, 2, 3 (default: 0)")
         .addOption({"no-unicode"}, ZC_BIND_METHOD(*this, disableUnicode),
@@ -87,20 +181,107 @@ public:
                    "Allow dollar signs in identifiers")
         .addOption({"no-regex-literals"}, ZC_BIND_METHOD(*this, disableRegexLiterals),
                    "Disable regex literal syntax")
+        .addOption({"lazy-function-bodies"}, ZC_BIND_METHOD(*this, enableLazyFunctionBodies),
+                   "Parse function bodies only when they are used")
+        .addOption({"per-buffer-string-pools"},
+                   ZC_BIND_METHOD(*this, enablePerBufferStringPools),
+                   "Intern each source file's strings into a pool of its own")
+        .addOptionWithArg({"diagnostics-fd"}, ZC_BIND_METHOD(*this, setDiagnosticsFd), "<fd>",
+                          "Also write diagnostics to descriptor <fd> in the binary format that "
+                          "zomdiag decodes")
+        .addOption({"watch"}, ZC_BIND_METHOD(*this, enableWatch),
+                   "Check the sources again whenever one of them changes, until interrupted")
         .expectOneOrMoreArgs("<source>", ZC_BIND_METHOD(*this, addSource))
         .callAfterParsing(ZC_BIND_METHOD(*this, emitOutput));
   }
 
+  // =====================================================================================
+  // "server" command
+
+  zc::MainBuilder::Validity setCacheBudget(zc::StringPtr value) {
+    ZC_IF_SOME(mebibytes, value.tryParseAs<size_t>()) {
+      cacheBudgetBytes = mebibytes << 20;
+      return true;
+    }
+    return zc::str("Invalid cache budget: ", value, ". It must be a number of mebibytes");
+  }
+
+  zc::MainBuilder::Validity setCacheDir(zc::StringPtr dir) {
+    cacheDir = dir;
+    return true;
+  }
+
+  zc::MainBuilder::Validity serve(zc::StringPtr socketPath) {
+    basic::ThreadPool threadPool;
+    zc::Maybe<zc::Own<driver::CacheManager>> cache;
+    ZC_IF_SOME(budget, cacheBudgetBytes) {
+      zc::Maybe<zc::Own<const zc::Directory>> spillDir;
+      ZC_IF_SOME(dir, cacheDir) {
+        auto filesystem = zc::newDiskFilesystem();
+        spillDir = filesystem->getRoot().openSubdir(
+            filesystem->getCurrentPath().eval(dir),
+            zc::WriteMode::CREATE | zc::WriteMode::MODIFY | zc::WriteMode::CREATE_PARENT);
+      }
+      cache = zc::heap<driver::CacheManager>(budget, zc::mv(spillDir));
+    }
+    else if (cacheDir != zc::none) { return "--cache-dir requires --cache-budget."; }
+
+    runCompilerServer(socketPath, [&](zc::ProcessContext& requestContext,
+                                      zc::ArrayPtr<const zc::StringPtr> args) {
+      zc::Maybe<driver::CacheManager&> sharedCache;
+      ZC_IF_SOME(c, cache) { sharedCache = *c; }
+      return runForwarded(requestContext, threadPool, sharedCache, args);
+    });
+    return true;
+  }
+
+  static int runForwarded(zc::ProcessContext& requestContext, basic::ThreadPool& threadPool,
+                          zc::Maybe<driver::CacheManager&> cache,
+                          zc::ArrayPtr<const zc::StringPtr> args) {
+    CompilerMain main(requestContext, threadPool, cache);
+    // As zc::runMainAndExit() does, except that the context's exit() unwinds to here
+    try {
+      ZC_IF_SOME(exception, zc::runCatchingExceptions([&]() {
+                   main.getMain()(requestContext.getProgramName(), args);
+                 })) {
+        requestContext.error(zc::str("*** Uncaught exception ***\n", exception));
+      }
+      requestContext.exit();
+    } catch (const zc::TopLevelProcessContext::CleanShutdownException& e) { return e.exitCode; }
+  }
+
+  // =====================================================================================
+  // "test" command
+
+  zc::MainBuilder::Validity enableVerboseTests() {
+    verboseTests = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity addTest(zc::StringPtr file) {
+    testFiles.add(file);
+    return true;
+  }
+
+  zc::MainBuilder::Validity runTests() {
+    basic::ThreadPool threadPool;
+    Invocation invoke = [&](zc::ProcessContext& testContext,
+                            zc::ArrayPtr<const zc::StringPtr> args) {
+      return runForwarded(testContext, threadPool, zc::none, args);
+    };
+    const size_t failed = runLanguageTests(testFiles, invoke, verboseTests);
+    if (failed > 0) { return zc::str(failed, " of ", testFiles.size(), " tests failed."); }
+    context.exit();
+  }
+
   // =====================================================================================
   // "compile" command
 
   zc::MainBuilder::Validity addSource(const zc::StringPtr file) {
     if (!file.endsWith(".zom")) { return "Error: zomc: source file must have .zom extension"; }
 
-    if (const zc::Maybe<source::BufferId> bufferId = driver->addSourceFile(file);
-        bufferId == zc::none) {
-      return zc::str("Failed to load source file.");
-    }
+    // Loaded together once all arguments are known, so that the files are read in parallel.
+    sourceFiles.add(file);
     return true;
   }
 
@@ -151,6 +332,72 @@ public:
     return true;
   }
 
+  zc::MainBuilder::Validity setStreamWindow(zc::StringPtr value) {
+    ZC_IF_SOME(files, value.tryParseAs<size_t>()) {
+      if (files > 0) {
+        streamWindow = files;
+        return true;
+      }
+    }
+    return zc::str("Invalid stream window: ", value, ". It must be a positive number of files");
+  }
+
+  zc::MainBuilder::Validity enableDebugInfo() {
+    compilerOpts.optimization.enableDebugInfo = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity enableTypeCheck() {
+    compilerOpts.emission.typeCheckEnabled = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity enableBindWhileParsing() {
+    compilerOpts.emission.bindWhileParsing = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity setASTCacheDir(zc::StringPtr dir) {
+    compilerOpts.emission.astCacheDir = zc::str(dir);
+    return true;
+  }
+
+  zc::MainBuilder::Validity setStatistics(zc::StringPtr kind) {
+    if (kind == "ast") {
+      compilerOpts.emission.astStatisticsEnabled = true;
+    } else {
+      return zc::str("Invalid statistics kind: ", kind, ". Valid kinds are: ast");
+    }
+    return true;
+  }
+
+  zc::MainBuilder::Validity setTimeReport(zc::StringPtr format) {
+    if (format == "text") {
+      timeReportJson = false;
+    } else if (format == "json") {
+      timeReportJson = true;
+    } else {
+      return zc::str("Invalid time report format: ", format, ". Valid formats are: text, json");
+    }
+    compilerOpts.emission.timeReportEnabled = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity setThreadPlacement(zc::StringPtr placement) {
+    using ThreadPlacement = basic::CompilerOptions::ParallelOptions::ThreadPlacement;
+    if (placement == "none") {
+      compilerOpts.parallel.threadPlacement = ThreadPlacement::kNone;
+    } else if (placement == "cores") {
+      compilerOpts.parallel.threadPlacement = ThreadPlacement::kCores;
+    } else if (placement == "nodes") {
+      compilerOpts.parallel.threadPlacement = ThreadPlacement::kNodes;
+    } else {
+      return zc::str("Invalid thread placement: ", placement,
+                     ". Valid placements are: none, cores, nodes");
+    }
+    return true;
+  }
+
   zc::MainBuilder::Validity setOptimizationLevel(zc::StringPtr level) {
     if (level == "0") {
       compilerOpts.optimization.level = 0;
@@ -181,7 +428,52 @@ public:
     return true;
   }
 
+  zc::MainBuilder::Validity enableLazyFunctionBodies() {
+    langOpts.lazyFunctionBodies = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity enablePerBufferStringPools() {
+    langOpts.perBufferStringPools = true;
+    return true;
+  }
+
+  zc::MainBuilder::Validity setDiagnosticsFd(zc::StringPtr value) {
+    // The number would name one of the server's descriptors, not the client's
+    if (forwarded) { return "--diagnostics-fd cannot be forwarded to a zomc server."; }
+    ZC_IF_SOME(fd, value.tryParseAs<int>()) {
+      if (fd >= 0) {
+        driver->getDiagnosticEngine().addConsumer(
+            zc::heap<diagnostics::BinaryDiagnosticConsumer>(zc::heap<zc::FdOutputStream>(fd)));
+        return true;
+      }
+    }
+    return zc::str("Invalid file descriptor: ", value);
+  }
+
+  zc::MainBuilder::Validity enableWatch() {
+    watchEnabled = true;
+    return true;
+  }
+
   zc::MainBuilder::Validity emitOutput() {
+    if (watchEnabled) { return watchSources(); }
+
+    zc::MainBuilder::Validity result = compile();
+    // Failed compilations are reported too, since they can be slow as well
+    if (compilerOpts.emission.timeReportEnabled) { printTimeReport(); }
+    return result;
+  }
+
+  zc::MainBuilder::Validity compile() {
+    ZC_IF_SOME(window, streamWindow) {
+      if (compilerOpts.emission.syntaxOnly) { return checkSyntaxStreaming(window); }
+    }
+
+    for (const zc::Maybe<source::BufferId>& bufferId : driver->addSourceFiles(sourceFiles)) {
+      if (bufferId == zc::none) { return zc::str("Failed to load source file."); }
+    }
+
     // 1. Parsing
     if (!driver->parseSources() || driver->getDiagnosticEngine().hasErrors()) {
       return zc::str("Compilation failed due to parsing errors.");
@@ -189,6 +481,8 @@ public:
 
     const auto& options = driver->getCompilerOptions();
 
+    if (options.emission.astStatisticsEnabled) { return emitStatistics(); }
+
     // 2. Early AST Emission (skips binding)
     // We handle AST emission here to allow inspecting the syntax tree without requiring a
     // successful binding phase.
@@ -202,13 +496,18 @@ public:
       return zc::str("Compilation failed due to binding errors.");
     }
 
-    // 4. Syntax Only Check
+    // 4. Type Checking
+    if (options.emission.typeCheckEnabled && !driver->checkSources()) {
+      return zc::str("Compilation failed due to type errors.");
+    }
+
+    // 5. Syntax Only Check
     if (options.emission.syntaxOnly) {
       context.warning("Syntax check completed successfully.");
       return true;
     }
 
-    // 5. Final Emission
+    // 6. Final Emission
     switch (options.emission.outputType) {
       case basic::CompilerOptions::EmissionOptions::OutputType::IR:
         return emitIR();
@@ -221,14 +520,87 @@ public:
     }
   }
 
+  /// Check the syntax of the sources a window at a time, never holding more than `window` of them.
+  zc::MainBuilder::Validity checkSyntaxStreaming(size_t window) {
+    if (!driver->checkSyntaxStreaming(sourceFiles, window)) {
+      return zc::str("Compilation failed due to parsing errors.");
+    }
+    context.warning("Syntax check completed successfully.");
+    return true;
+  }
+
+  /// Parse and bind the sources, then redo only what each change to them invalidates, reporting
+  /// the outcome every time. Does not return unless setting up fails.
+  zc::MainBuilder::Validity watchSources() {
+#if __linux__
+    if (forwarded) { return "--watch cannot be forwarded to a zomc server."; }
+    for (const zc::Maybe<source::BufferId>& bufferId : driver->addSourceFiles(sourceFiles)) {
+      if (bufferId == zc::none) { return zc::str("Failed to load source file."); }
+    }
+
+    zc::AsyncIoContext io = zc::setupAsyncIo();
+    driver::FileWatcher watcher(io.unixEventPort);
+    for (const zc::StringPtr file : sourceFiles) { watcher.watch(file); }
+
+    auto report = [&](bool succeeded) {
+      if (succeeded && !driver->getDiagnosticEngine().hasErrors()) {
+        context.warning("Check completed successfully; watching for changes.");
+      } else {
+        context.warning("Check failed; watching for changes.");
+      }
+    };
+    report(driver->parseAndBindSources());
+
+    while (true) {
+      zc::Vector<zc::String> changed =
+          watcher.whenChanged(io.provider->getTimer()).wait(io.waitScope);
+      zc::Vector<zc::StringPtr> paths;
+      for (const zc::String& path : changed) { paths.add(path); }
+      report(driver->update(paths));
+    }
+#else
+    return "--watch is only supported on Linux.";
+#endif
+  }
+
+  void printTimeReport() {
+    const driver::TimeReport report = driver->getTimeReport();
+    const zc::String text =
+        timeReportJson ? driver::timeReportToJson(report) : driver::timeReportToText(report);
+    zc::FdOutputStream(STDERR_FILENO).write(text.asBytes());
+  }
+
   zc::MainBuilder::Validity emitAST() {
-    const auto& asts = driver->getASTs();
     const auto& options = driver->getCompilerOptions();
 
     zc::Maybe<zc::Own<zc::OutputStream>> outputStream =
         createOutputStream(options.emission.outputPath, options.emission.serializerType);
     ZC_IF_SOME(stream, outputStream) {
-      return dumpASTsToStream(*stream, asts, options.emission.serializerType);
+      return dumpASTsToStream(*stream, options.emission.serializerType);
+    }
+
+    return "Failed to create output stream.";
+  }
+
+  zc::MainBuilder::Validity emitStatistics() {
+    const auto& options = driver->getCompilerOptions();
+
+    zc::Vector<ast::TreeStatistics> files;
+    for (const auto& entry : driver->getASTs()) {
+      ZC_IF_SOME(allocations, driver->getAllocationStats(entry.key)) {
+        ast::TreeStatistics& file = files.add(ast::collectTreeStatistics(
+            *entry.value, driver->getSourceManager().getEntireTextForBuffer(entry.key),
+            allocations));
+        ZC_IF_SOME(parseTime, driver->getParseTime(entry.key)) { file.parseTime = parseTime; }
+      }
+    }
+
+    zc::Maybe<zc::Own<zc::OutputStream>> outputStream =
+        createOutputStream(options.emission.outputPath,
+                           basic::CompilerOptions::EmissionOptions::SerializerType::kJSON);
+    ZC_IF_SOME(stream, outputStream) {
+      stream->write(ast::statisticsToJson(files).asBytes());
+      return true;
     }
 
     return "Failed to create output stream.";
@@ -326,34 +698,38 @@ private:
     }
   }
 
-  /// Dumps all ASTs to the given output stream
-  zc::Own<ast::Serializer> createSerializer(
-      basic::CompilerOptions::EmissionOptions::SerializerType type, zc::OutputStream& output) {
+  /// Creates a serializer for one part of the dump. Only the part with `startsDocument` set
+  /// writes what comes before the first tree, such as the XML declaration.
+  static zc::Own<ast::Serializer> createSerializer(
+      basic::CompilerOptions::EmissionOptions::SerializerType type, zc::OutputStream& output,
+      bool startsDocument) {
     switch (type) {
       case basic::CompilerOptions::EmissionOptions::SerializerType::kJSON:
         return zc::heap<ast::JSONSerializer>(output);
       case basic::CompilerOptions::EmissionOptions::SerializerType::kXML:
-        return zc::heap<ast::XMLSerializer>(output);
+        return zc::heap<ast::XMLSerializer>(output, startsDocument);
       case basic::CompilerOptions::EmissionOptions::SerializerType::kTEXT:
       default:
         return zc::heap<ast::TextSerializer>(output);
     }
   }
 
+  /// Dumps all ASTs to the given output stream. Each file is dumped into a buffer of its own on
+  /// the driver's threads, and the buffers are written in the order the files were given.
   zc::MainBuilder::Validity dumpASTsToStream(
-      zc::OutputStream& outputStream, const auto& asts,
+      zc::OutputStream& outputStream,
       basic::CompilerOptions::EmissionOptions::SerializerType format) {
-    auto serializer = createSerializer(format, outputStream);
-    ast::ASTDumper dumper(zc::mv(serializer));
-
-    for (const auto& entry : asts) {
-      const source::BufferId& bufferId = entry.key;
-      const ast::Node& astNode = *entry.value;
-
-      writeBufferHeader(outputStream, bufferId, format);
-      dumper.dump(astNode);
-      writeBufferFooter(outputStream, format);
-    }
+    createSerializer(format, outputStream, true)->flush();
+
+    zc::Array<zc::String> dumps = driver->serializeASTs(
+        [format](source::BufferId bufferId, const ast::Node& astNode) -> zc::String {
+          zc::VectorOutputStream buffer;
+          writeBufferHeader(buffer, bufferId, format);
+          ast::ASTDumper(createSerializer(format, buffer, false)).dump(astNode);
+          writeBufferFooter(buffer, format);
+          return zc::heapString(buffer.getArray().asChars());
+        });
+    for (const zc::String& dump : dumps) { outputStream.write(dump.asBytes()); }
 
     return true;
   }
@@ -385,8 +761,21 @@ private:
 
 private:
   zc::ProcessContext& context;
+  // Whether this runs an invocation forwarded to a server
+  bool forwarded = false;
+  bool watchEnabled = false;
+  bool verboseTests = false;
+  bool timeReportJson = false;
+  // Files in flight at once with --syntax-only, or none to load them all up front
+  zc::Maybe<size_t> streamWindow;
+  // Bytes of ASTs a server keeps in memory between compilations, or none to keep none
+  zc::Maybe<size_t> cacheBudgetBytes;
+  // Directory a server moves evicted ASTs to
+  zc::Maybe<zc::StringPtr> cacheDir;
   zc::Own<driver::CompilerDriver> driver;
   zc::SpaceFor<driver::CompilerDriver> driverSpace;
+  zc::Vector<zc::StringPtr> sourceFiles;
+  zc::Vector<zc::StringPtr> testFiles;
   basic::CompilerOptions compilerOpts;
   basic::LangOptions langOpts;
 };
@@ -0,0 +1,121 @@
+// Copyright (c) 2024-2025 Zode.Z. All rights reserved
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+// WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied. See the
+// License for the specific language governing permissions and limitations under
+// the License.
+
+#include <unistd.h>
+
+#include "zc/core/common.h"
+#include "zc/core/filesystem.h"
+#include "zc/core/io.h"
+#include "zc/core/main.h"
+#include "zc/core/string.h"
+#include "zc/core/vector.h"
+#include "zomlang/compiler/diagnostics/binary-diagnostic-consumer.h"
+#include "zomlang/compiler/diagnostics/diagnostic-engine.h"
+#include "zomlang/compiler/diagnostics/diagnostic-info.h"
+#include "zomlang/compiler/diagnostics/diagnostic.h"
+#include "zomlang/compiler/source/manager.h"
+
+#ifndef VERSION
+#define VERSION "(unknown)"
+#endif
+
+namespace zomlang {
+namespace compiler {
+namespace utils {
+
+static constexpr char VERSION_STRING[] = "ZomLang Version " VERSION;
+
+/// Prints the diagnostics that `zomc --diagnostics-fd` wrote, one per line.
+class DiagnosticDecoderMain {
+public:
+  explicit DiagnosticDecoderMain(zc::ProcessContext& context) : context(context) {}
+
+  zc::MainFunc getMain() {
+    return zc::MainBuilder(context, VERSION_STRING,
+                           "Decodes the binary diagnostics stream written by zomc --diagnostics-fd "
+                           "from <file>, or from standard input if no file is given, and prints "
+                           "each diagnostic as <file>:<line>:<column>: <severity> [ZOM<id>]: "
+                           "<message>.")
+        .expectOptionalArg("<file>", ZC_BIND_METHOD(*this, setInput))
+        .callAfterParsing(ZC_BIND_METHOD(*this, decode))
+        .build();
+  }
+
+  zc::MainBuilder::Validity setInput(zc::StringPtr path) {
+    input = path;
+    return true;
+  }
+
+  zc::MainBuilder::Validity decode() {
+    diagnostics::DecodedDiagnostics decoded;
+    ZC_IF_SOME(path, input) {
+      auto filesystem = zc::newDiskFilesystem();
+      auto file = filesystem->getRoot().openFile(filesystem->getCurrentPath().evalNative(path));
+      const zc::Array<const zc::byte> bytes = file->readAllBytes();
+      zc::ArrayInputStream stream(bytes);
+      decoded = diagnostics::readBinaryDiagnostics(stream);
+    } else {
+      zc::FdInputStream stream(STDIN_FILENO);
+      decoded = diagnostics::readBinaryDiagnostics(stream);
+    }
+
+    zc::FdOutputStream output(STDOUT_FILENO);
+    for (const diagnostics::DecodedDiagnostic& diagnostic : decoded.diagnostics) {
+      print(output, decoded, diagnostic, 0);
+    }
+    return true;
+  }
+
+private:
+  zc::ProcessContext& context;
+  zc::Maybe<zc::StringPtr> input;
+  /// Only there for formatDiagnosticMessage(); the messages need no sources.
+  source::SourceManager sourceManager;
+
+  void print(zc::OutputStream& output, const diagnostics::DecodedDiagnostics& decoded,
+             const diagnostics::DecodedDiagnostic& diagnostic, size_t depth) {
+    zc::Vector<zc::byte> line;
+    for (size_t i = 0; i < depth; ++i) { line.addAll("  "_zcb); }
+    ZC_IF_SOME(file, decoded.files.find(diagnostic.bufferId)) {
+      line.addAll(zc::str(file, ":", diagnostic.line, ":", diagnostic.column, ": ").asBytes());
+    }
+    line.addAll(zc::str(diagnostics::toString(diagnostic.severity), " [ZOM",
+                        static_cast<uint32_t>(diagnostic.id), "]: ")
+                    .asBytes());
+
+    const diagnostics::DiagnosticInfo info = diagnostics::getDiagnosticInfo(diagnostic.id);
+    if (info.argCount == diagnostic.args.size()) {
+      zc::Vector<diagnostics::DiagnosticArgument> args;
+      for (const zc::String& arg : diagnostic.args) { args.add(arg.asPtr()); }
+      zc::VectorOutputStream message;
+      diagnostics::DiagnosticEngine::formatDiagnosticMessage(sourceManager, message, info, args);
+      line.addAll(message.getArray());
+    } else {
+      // Written by a compiler whose message for this ID takes other arguments
+      line.addAll(zc::strArray(diagnostic.args, ", ").asBytes());
+    }
+    line.add('\n');
+    output.write(line.asPtr());
+
+    for (const diagnostics::DecodedDiagnostic& child : diagnostic.children) {
+      print(output, decoded, child, depth + 1);
+    }
+  }
+};
+
+}  // namespace utils
+}  // namespace compiler
+}  // namespace zomlang
+
+ZC_MAIN(zomlang::compiler::utils::DiagnosticDecoderMain)